@@ -0,0 +1,233 @@
+/**
+ * Copyright © 2026 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "batch_reader.hpp"
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <system_error>
+
+namespace phosphor::power::util
+{
+
+/**
+ * Reads a file with pread() and returns the bytes read or the negative
+ * errno.
+ */
+static ssize_t readFile(BatchRead& read)
+{
+    if (read.fd < 0)
+    {
+        return -EBADF;
+    }
+    ssize_t bytes = pread(read.fd, read.buffer.data(), read.buffer.size(), 0);
+    return (bytes < 0) ? -errno : bytes;
+}
+
+/**
+ * Returns the address of a field of a mapped ring.
+ */
+template <typename T>
+static T* ringField(void* ring, uint32_t offset)
+{
+    return reinterpret_cast<T*>(static_cast<char*>(ring) + offset);
+}
+
+BatchReader::BatchReader(unsigned int entries)
+{
+    io_uring_params params{};
+    ringFD.set(
+        static_cast<int>(syscall(__NR_io_uring_setup, entries, &params)));
+    if (!ringFD)
+    {
+        // Not supported or not permitted; use pread()
+        return;
+    }
+
+    sqEntries = params.sq_entries;
+    sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+    cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    bool singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (singleMap)
+    {
+        sqRingSize = cqRingSize = std::max(sqRingSize, cqRingSize);
+    }
+
+    sqRing = mmap(nullptr, sqRingSize, PROT_READ | PROT_WRITE,
+                  MAP_SHARED | MAP_POPULATE, ringFD(), IORING_OFF_SQ_RING);
+    if (sqRing == MAP_FAILED)
+    {
+        sqRing = nullptr;
+        close();
+        return;
+    }
+    if (singleMap)
+    {
+        cqRing = sqRing;
+    }
+    else
+    {
+        cqRing = mmap(nullptr, cqRingSize, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, ringFD(), IORING_OFF_CQ_RING);
+        if (cqRing == MAP_FAILED)
+        {
+            cqRing = nullptr;
+            close();
+            return;
+        }
+    }
+
+    sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+    sqes = mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE,
+                MAP_SHARED | MAP_POPULATE, ringFD(), IORING_OFF_SQES);
+    if (sqes == MAP_FAILED)
+    {
+        sqes = nullptr;
+        close();
+        return;
+    }
+
+    sqTail = ringField<unsigned int>(sqRing, params.sq_off.tail);
+    sqMask = ringField<unsigned int>(sqRing, params.sq_off.ring_mask);
+    sqArray = ringField<unsigned int>(sqRing, params.sq_off.array);
+    cqHead = ringField<unsigned int>(cqRing, params.cq_off.head);
+    cqTail = ringField<unsigned int>(cqRing, params.cq_off.tail);
+    cqMask = ringField<unsigned int>(cqRing, params.cq_off.ring_mask);
+    cqes = ringField<void>(cqRing, params.cq_off.cqes);
+}
+
+BatchReader::~BatchReader()
+{
+    close();
+}
+
+void BatchReader::read(std::span<BatchRead> reads)
+{
+    size_t start{0};
+    while (isAsync() && (start < reads.size()))
+    {
+        auto part = reads.subspan(
+            start, std::min<size_t>(sqEntries, reads.size() - start));
+        if (!submit(part))
+        {
+            // io_uring was closed, so read the rest with pread()
+            break;
+        }
+        start += part.size();
+    }
+
+    for (auto& read : reads.subspan(start))
+    {
+        read.result = readFile(read);
+    }
+}
+
+bool BatchReader::submit(std::span<BatchRead> reads)
+{
+    auto* entries = static_cast<io_uring_sqe*>(sqes);
+    unsigned int tail = *sqTail;
+    unsigned int count{0};
+    for (size_t i = 0; i < reads.size(); ++i)
+    {
+        if (reads[i].fd < 0)
+        {
+            reads[i].result = -EBADF;
+            continue;
+        }
+
+        unsigned int index = tail & *sqMask;
+        io_uring_sqe& sqe = entries[index];
+        std::memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode = IORING_OP_READ;
+        sqe.fd = reads[i].fd;
+        sqe.addr = reinterpret_cast<uint64_t>(reads[i].buffer.data());
+        sqe.len = reads[i].buffer.size();
+        sqe.off = 0;
+        sqe.user_data = i;
+        sqArray[index] = index;
+        ++tail;
+        ++count;
+    }
+    __atomic_store_n(sqTail, tail, __ATOMIC_RELEASE);
+
+    unsigned int toSubmit = count;
+    unsigned int completed{0};
+    while (completed < count)
+    {
+        int rc = static_cast<int>(syscall(__NR_io_uring_enter, ringFD(),
+                                          toSubmit, count - completed,
+                                          IORING_ENTER_GETEVENTS, nullptr, 0));
+        if (rc < 0)
+        {
+            if ((errno == EINTR) || (errno == EAGAIN) || (errno == EBUSY))
+            {
+                continue;
+            }
+            if (toSubmit == count)
+            {
+                // Nothing was submitted.  Take back the entries and stop
+                // using io_uring.
+                __atomic_store_n(sqTail, tail - count, __ATOMIC_RELEASE);
+                close();
+                return false;
+            }
+            throw std::system_error{errno, std::generic_category(),
+                                    "Unable to wait for io_uring reads"};
+        }
+        toSubmit -= std::min(toSubmit, static_cast<unsigned int>(rc));
+
+        auto* completions = static_cast<io_uring_cqe*>(cqes);
+        unsigned int head = *cqHead;
+        unsigned int cqTailValue = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+        for (; head != cqTailValue; ++head, ++completed)
+        {
+            const io_uring_cqe& cqe = completions[head & *cqMask];
+            BatchRead& read = reads[cqe.user_data];
+
+            // Kernels without IORING_OP_READ fail it with EINVAL
+            read.result = (cqe.res == -EINVAL) ? readFile(read) : cqe.res;
+        }
+        __atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+    }
+    return true;
+}
+
+void BatchReader::close()
+{
+    if (sqes != nullptr)
+    {
+        munmap(sqes, sqesSize);
+        sqes = nullptr;
+    }
+    if ((cqRing != nullptr) && (cqRing != sqRing))
+    {
+        munmap(cqRing, cqRingSize);
+    }
+    cqRing = nullptr;
+    if (sqRing != nullptr)
+    {
+        munmap(sqRing, sqRingSize);
+        sqRing = nullptr;
+    }
+    ringFD.close();
+}
+
+} // namespace phosphor::power::util
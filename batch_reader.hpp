@@ -0,0 +1,155 @@
+#pragma once
+
+#include "file_descriptor.hpp"
+
+#include <sys/types.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace phosphor::power::util
+{
+
+/**
+ * @struct BatchRead
+ *
+ * A read of a file from offset 0, done by BatchReader::read().
+ */
+struct BatchRead
+{
+    /**
+     * The open file.  A negative value is not read and fails with EBADF.
+     */
+    int fd{-1};
+
+    /**
+     * Filled in with the data read.
+     */
+    std::span<char> buffer{};
+
+    /**
+     * The number of bytes read, or the negative errno if the read failed.
+     */
+    ssize_t result{0};
+};
+
+/**
+ * @class BatchReader
+ *
+ * Reads many files, such as the sysfs and debugfs files of the PMBus
+ * devices, with one io_uring submission instead of one system call each.
+ *
+ * The reads are submitted together and their completions reaped together.
+ * The kernel runs the reads that block, such as on an I2C transfer, on its
+ * worker threads, so the devices on different buses are read concurrently.
+ *
+ * If io_uring is not available, such as on an older kernel or when it is
+ * disabled by sysctl, each file is read with pread() instead.
+ */
+class BatchReader
+{
+  public:
+    /**
+     * The default number of reads submitted at a time.
+     */
+    static constexpr unsigned int defaultEntries{64};
+
+    BatchReader(const BatchReader&) = delete;
+    BatchReader& operator=(const BatchReader&) = delete;
+    BatchReader(BatchReader&&) = delete;
+    BatchReader& operator=(BatchReader&&) = delete;
+
+    /**
+     * Constructor
+     *
+     * @param[in] entries - the number of reads submitted at a time; larger
+     *                      batches are submitted in parts
+     */
+    explicit BatchReader(unsigned int entries = defaultEntries);
+
+    /**
+     * Destructor
+     */
+    ~BatchReader();
+
+    /**
+     * Returns whether the reads are done with io_uring.
+     *
+     * @return bool - true if io_uring is used, false if pread() is
+     */
+    bool isAsync() const
+    {
+        return ringFD;
+    }
+
+    /**
+     * Reads each file into its buffer from offset 0 and sets the result.
+     *
+     * Returns when all the reads are done.
+     *
+     * @param[in,out] reads - the reads
+     */
+    void read(std::span<BatchRead> reads);
+
+  private:
+    /**
+     * Reads the files with io_uring.
+     *
+     * @param[in,out] reads - the reads; at most sqEntries
+     *
+     * @return bool - false if the reads could not be submitted
+     */
+    bool submit(std::span<BatchRead> reads);
+
+    /**
+     * Unmaps the rings and closes the io_uring, so pread() is used.
+     */
+    void close();
+
+    /**
+     * The io_uring, or not valid if pread() is used.
+     */
+    FileDescriptor ringFD;
+
+    /**
+     * The mapped submission queue ring.
+     */
+    void* sqRing{nullptr};
+    size_t sqRingSize{0};
+
+    /**
+     * The mapped completion queue ring.  The same as sqRing if the kernel
+     * maps both with one mapping.
+     */
+    void* cqRing{nullptr};
+    size_t cqRingSize{0};
+
+    /**
+     * The mapped submission queue entries.
+     */
+    void* sqes{nullptr};
+    size_t sqesSize{0};
+
+    /**
+     * The number of submission queue entries.
+     */
+    unsigned int sqEntries{0};
+
+    /**
+     * The fields of the submission queue ring.
+     */
+    unsigned int* sqTail{nullptr};
+    unsigned int* sqMask{nullptr};
+    unsigned int* sqArray{nullptr};
+
+    /**
+     * The fields of the completion queue ring.
+     */
+    unsigned int* cqHead{nullptr};
+    unsigned int* cqTail{nullptr};
+    unsigned int* cqMask{nullptr};
+    void* cqes{nullptr};
+};
+
+} // namespace phosphor::power::util
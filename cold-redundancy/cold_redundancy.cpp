@@ -14,6 +14,7 @@
 // limitations under the License.
 */
 
+#include "i2c_interface.hpp"
 #include "types.hpp"
 
 #include <boost/algorithm/string/predicate.hpp>
@@ -27,10 +28,15 @@
 #include <sdbusplus/asio/sd_event.hpp>
 #include <sdbusplus/bus/match.hpp>
 
+#include <algorithm>
 #include <array>
+#include <cmath>
+#include <exception>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <map>
+#include <memory>
 #include <regex>
 
 namespace
@@ -39,28 +45,54 @@ constexpr const std::array<const char*, 1> psuInterfaceTypes = {
     "xyz.openbmc_project.Configuration.pmbus"};
 std::string inventoryPath = std::string(INVENTORY_OBJ_PATH) + "/system";
 const constexpr char* eventPath = "/xyz/openbmc_project/State/Decorator";
-std::vector<std::unique_ptr<PowerSupply>> powerSupplies;
+boost::container::flat_map<std::string, std::unique_ptr<PowerSupply>>
+    powerSupplies;
+const constexpr char* powerSensorPath = "/xyz/openbmc_project/sensors/power/";
+
+// PMBus command that sets whether a PSU is active or its rank in cold standby
+constexpr uint8_t pmbusCmdCRConfig = 0xd0;
+constexpr uint8_t crConfigActive = 0x01;
+
+// How often the PSUs are ranked, and how often the primary is rotated
+constexpr std::chrono::seconds schedulePeriod(60);
+constexpr std::chrono::hours rotationPeriod(24 * 7);
+
+// Output power a PSU is rated for, and the load where it is most efficient
+constexpr double psuRatedPower = 1300.0;
+constexpr double peakEfficiencyLoad = 0.5;
+
+// A PSU is only put in standby after the load drops this far below the
+// point where it would be needed, so small load changes don't toggle it
+constexpr double standbyHysteresis = 0.9;
 } // namespace
 
 ColdRedundancy::ColdRedundancy(
     boost::asio::io_service& io, sdbusplus::asio::object_server& objectServer,
     std::shared_ptr<sdbusplus::asio::connection>& systemBus) :
     filterTimer(io),
-    systemBus(systemBus)
+    systemBus(systemBus), scheduleTimer(io),
+    lastRotation(std::chrono::steady_clock::now()),
+    i2cExecutor([&io](std::function<void()> callback) {
+        boost::asio::post(io, std::move(callback));
+    })
 {
     post(io,
          [this, &io, &objectServer, &systemBus]() { createPSU(systemBus); });
+    startScheduler();
+
     std::function<void(sdbusplus::message::message&)> eventHandler =
-        [this, &io, &objectServer,
-         &systemBus](sdbusplus::message::message& message) {
+        [this](sdbusplus::message::message& message) {
             if (message.is_method_error())
             {
                 std::cerr << "callback method error\n";
                 return;
             }
+
+            // Only the object that changed needs to be queried again
+            changedObjects[message.get_path()] = message.get_sender();
+
             filterTimer.expires_after(std::chrono::seconds(1));
-            filterTimer.async_wait([this, &io, &objectServer, &systemBus](
-                                       const boost::system::error_code& ec) {
+            filterTimer.async_wait([this](const boost::system::error_code& ec) {
                 if (ec == boost::asio::error::operation_aborted)
                 {
                     return;
@@ -69,10 +101,68 @@ ColdRedundancy::ColdRedundancy(
                 {
                     std::cerr << "timer error\n";
                 }
-                createPSU(systemBus);
+
+                auto objects = std::move(changedObjects);
+                changedObjects.clear();
+                for (const auto& [path, service] : objects)
+                {
+                    updatePSU(service, path);
+                }
             });
         };
 
+    std::function<void(sdbusplus::message::message&)> interfacesAddedHandler =
+        [this](sdbusplus::message::message& message) {
+            sdbusplus::message::object_path path;
+            boost::container::flat_map<std::string, CR::PropertyMapType>
+                interfaces;
+
+            try
+            {
+                message.read(path, interfaces);
+            }
+            catch (const sdbusplus::exception::exception& e)
+            {
+                std::cerr << "Failed to read InterfacesAdded message\n";
+                return;
+            }
+
+            // The properties are in the signal, so no query is needed
+            for (const char* type : psuInterfaceTypes)
+            {
+                auto iface = interfaces.find(type);
+                if (iface != interfaces.end())
+                {
+                    addPSU(path.str, iface->second);
+                }
+            }
+        };
+
+    std::function<void(sdbusplus::message::message&)> interfacesRemovedHandler =
+        [this](sdbusplus::message::message& message) {
+            sdbusplus::message::object_path path;
+            std::vector<std::string> interfaces;
+
+            try
+            {
+                message.read(path, interfaces);
+            }
+            catch (const sdbusplus::exception::exception& e)
+            {
+                std::cerr << "Failed to read InterfacesRemoved message\n";
+                return;
+            }
+
+            for (const char* type : psuInterfaceTypes)
+            {
+                if (std::find(interfaces.begin(), interfaces.end(), type) !=
+                    interfaces.end())
+                {
+                    removePSU(path.str);
+                }
+            }
+        };
+
     std::function<void(sdbusplus::message::message&)> eventCollect =
         [&](sdbusplus::message::message& message) {
             std::string objectName;
@@ -105,7 +195,8 @@ ColdRedundancy::ColdRedundancy(
                 return;
             }
 
-            for (auto& psu : powerSupplies)
+            bool stateChanged = false;
+            for (auto& [psuPath, psu] : powerSupplies)
             {
                 if (psu->name != psuName)
                 {
@@ -122,16 +213,22 @@ ColdRedundancy::ColdRedundancy(
                         std::cerr << "Unable to get valid functional status\n";
                         continue;
                     }
-                    if (*functional)
-                    {
-                        psu->state = CR::PSUState::normal;
-                    }
-                    else
+                    auto state = *functional ? CR::PSUState::normal
+                                             : CR::PSUState::acLost;
+                    if (psu->state != state)
                     {
-                        psu->state = CR::PSUState::acLost;
+                        psu->state = state;
+                        stateChanged = true;
                     }
                 }
             }
+
+            // Rank the working PSUs again right away, so a standby PSU takes
+            // over the load of one that was lost
+            if (stateChanged)
+            {
+                schedule();
+            }
         };
 
     using namespace sdbusplus::bus::match::rules;
@@ -145,6 +242,16 @@ ColdRedundancy::ColdRedundancy(
         matches.emplace_back(std::move(match));
     }
 
+    matches.emplace_back(std::make_unique<sdbusplus::bus::match::match>(
+        static_cast<sdbusplus::bus::bus&>(*systemBus),
+        interfacesAdded() + argNpath(0, inventoryPath + "/"),
+        interfacesAddedHandler));
+
+    matches.emplace_back(std::make_unique<sdbusplus::bus::match::match>(
+        static_cast<sdbusplus::bus::bus&>(*systemBus),
+        interfacesRemoved() + argNpath(0, inventoryPath + "/"),
+        interfacesRemovedHandler));
+
     for (const char* eventType : psuEventInterface)
     {
         auto eventMatch = std::make_unique<sdbusplus::bus::match::match>(
@@ -162,13 +269,10 @@ static const constexpr int psuDepth = 3;
 void ColdRedundancy::createPSU(
     std::shared_ptr<sdbusplus::asio::connection>& conn)
 {
-    numberOfPSU = 0;
-    powerSupplies.clear();
-
     // call mapper to get matched obj paths
     conn->async_method_call(
-        [this, &conn](const boost::system::error_code ec,
-                      CR::GetSubTreeType subtree) {
+        [this](const boost::system::error_code ec,
+               CR::GetSubTreeType subtree) {
             if (ec)
             {
                 std::cerr << "Exception happened when communicating to "
@@ -177,89 +281,9 @@ void ColdRedundancy::createPSU(
             }
             for (const auto& object : subtree)
             {
-                std::string pathName = object.first;
                 for (const auto& serviceIface : object.second)
                 {
-                    std::string serviceName = serviceIface.first;
-                    for (const auto& interface : serviceIface.second)
-                    {
-                        // only get property of matched interface
-                        bool isIfaceMatched = false;
-                        for (const auto& type : psuInterfaceTypes)
-                        {
-                            if (type == interface)
-                            {
-                                isIfaceMatched = true;
-                                break;
-                            }
-                        }
-                        if (!isIfaceMatched)
-                            continue;
-
-                        conn->async_method_call(
-                            [this, &conn,
-                             interface](const boost::system::error_code ec,
-                                        CR::PropertyMapType propMap) {
-                                if (ec)
-                                {
-                                    std::cerr
-                                        << "Exception happened when get all "
-                                           "properties\n";
-                                    return;
-                                }
-
-                                auto configName =
-                                    std::get_if<std::string>(&propMap["Name"]);
-                                if (configName == nullptr)
-                                {
-                                    std::cerr << "error finding necessary "
-                                                 "entry in configuration\n";
-                                    return;
-                                }
-
-                                auto configBus =
-                                    std::get_if<uint64_t>(&propMap["Bus"]);
-                                auto configAddress =
-                                    std::get_if<uint64_t>(&propMap["Address"]);
-
-                                if (configBus == nullptr ||
-                                    configAddress == nullptr)
-                                {
-                                    std::cerr << "error finding necessary "
-                                                 "entry in configuration\n";
-                                    return;
-                                }
-                                for (auto& psu : powerSupplies)
-                                {
-                                    if ((static_cast<uint8_t>(*configBus) ==
-                                         psu->bus) &&
-                                        (static_cast<uint8_t>(*configAddress) ==
-                                         psu->address))
-                                    {
-                                        return;
-                                    }
-                                }
-
-                                uint8_t order = 0;
-
-                                powerSupplies.emplace_back(
-                                    std::make_unique<PowerSupply>(
-                                        *configName,
-                                        static_cast<uint8_t>(*configBus),
-                                        static_cast<uint8_t>(*configAddress),
-                                        order, conn));
-
-                                numberOfPSU++;
-                                std::vector<uint8_t> orders = {};
-                                for (auto& psu : powerSupplies)
-                                {
-                                    orders.push_back(psu->order);
-                                }
-                            },
-                            serviceName.c_str(), pathName.c_str(),
-                            "org.freedesktop.DBus.Properties", "GetAll",
-                            interface);
-                    }
+                    updatePSU(serviceIface.first, object.first);
                 }
             }
         },
@@ -269,11 +293,330 @@ void ColdRedundancy::createPSU(
         "/xyz/openbmc_project/inventory/system", psuDepth, psuInterfaceTypes);
 }
 
+void ColdRedundancy::updatePSU(const std::string& service,
+                               const std::string& path)
+{
+    for (const char* interface : psuInterfaceTypes)
+    {
+        systemBus->async_method_call(
+            [this, path](const boost::system::error_code ec,
+                         CR::PropertyMapType propMap) {
+                if (ec)
+                {
+                    std::cerr << "Exception happened when get all "
+                                 "properties\n";
+                    return;
+                }
+
+                addPSU(path, propMap);
+            },
+            service.c_str(), path.c_str(), "org.freedesktop.DBus.Properties",
+            "GetAll", interface);
+    }
+}
+
+void ColdRedundancy::addPSU(const std::string& path,
+                            CR::PropertyMapType& propMap)
+{
+    auto configName = std::get_if<std::string>(&propMap["Name"]);
+    if (configName == nullptr)
+    {
+        std::cerr << "error finding necessary entry in configuration\n";
+        return;
+    }
+
+    auto configBus = std::get_if<uint64_t>(&propMap["Bus"]);
+    auto configAddress = std::get_if<uint64_t>(&propMap["Address"]);
+
+    if (configBus == nullptr || configAddress == nullptr)
+    {
+        std::cerr << "error finding necessary entry in configuration\n";
+        return;
+    }
+
+    // Another object may already describe the same device
+    for (auto& [psuPath, psu] : powerSupplies)
+    {
+        if ((psuPath != path) &&
+            (static_cast<uint8_t>(*configBus) == psu->bus) &&
+            (static_cast<uint8_t>(*configAddress) == psu->address))
+        {
+            return;
+        }
+    }
+
+    // Keep the rank and configuration if the device did not change
+    auto existing = powerSupplies.find(path);
+    if ((existing != powerSupplies.end()) &&
+        (existing->second->name == *configName) &&
+        (existing->second->bus == static_cast<uint8_t>(*configBus)) &&
+        (existing->second->address == static_cast<uint8_t>(*configAddress)))
+    {
+        return;
+    }
+
+    uint8_t order = 0;
+
+    // Replaces the PSU if this object was already known
+    powerSupplies[path] = std::make_unique<PowerSupply>(
+        *configName, static_cast<uint8_t>(*configBus),
+        static_cast<uint8_t>(*configAddress), order, systemBus);
+
+    numberOfPSU = static_cast<uint8_t>(powerSupplies.size());
+}
+
+void ColdRedundancy::removePSU(const std::string& path)
+{
+    if (powerSupplies.erase(path) == 0)
+    {
+        return;
+    }
+    changedObjects.erase(path);
+    numberOfPSU = static_cast<uint8_t>(powerSupplies.size());
+
+    // The remaining PSUs may need to take over the load
+    schedule();
+}
+
+void ColdRedundancy::startScheduler()
+{
+    scheduleTimer.expires_after(schedulePeriod);
+    scheduleTimer.async_wait([this](const boost::system::error_code& ec) {
+        if (ec == boost::asio::error::operation_aborted)
+        {
+            return;
+        }
+        else if (ec)
+        {
+            std::cerr << "timer error\n";
+        }
+        readInputPower();
+        startScheduler();
+    });
+}
+
+void ColdRedundancy::readInputPower()
+{
+    // Wait for the reads from the previous period to finish
+    if (pendingPowerReads > 0)
+    {
+        return;
+    }
+
+    for (auto& [path, psu] : powerSupplies)
+    {
+        std::string sensorPath = powerSensorPath + psu->name + "_Input_Power";
+        pendingPowerReads++;
+
+        systemBus->async_method_call(
+            [this, path](const boost::system::error_code ec,
+                         std::variant<double> value) {
+                auto psu = powerSupplies.find(path);
+                if (psu != powerSupplies.end())
+                {
+                    if (ec)
+                    {
+                        psu->second->inputPower = std::nullopt;
+                    }
+                    else
+                    {
+                        psu->second->inputPower = std::get<double>(value);
+                    }
+                }
+
+                if (--pendingPowerReads == 0)
+                {
+                    schedule();
+                }
+            },
+            "xyz.openbmc_project.PSUSensor", sensorPath,
+            "org.freedesktop.DBus.Properties", "Get",
+            "xyz.openbmc_project.Sensor.Value", "Value");
+    }
+}
+
+void ColdRedundancy::schedule()
+{
+    // Only the PSUs that are working can be ranked.  The last input power
+    // of a PSU that was lost is still counted, since the working PSUs take
+    // over its load.
+    std::vector<PowerSupply*> psus;
+    double totalPower = 0;
+    bool powerKnown = true;
+    for (auto& [path, psu] : powerSupplies)
+    {
+        if (psu->inputPower)
+        {
+            totalPower += *psu->inputPower;
+        }
+        if (psu->state != CR::PSUState::normal)
+        {
+            continue;
+        }
+        if (!psu->inputPower)
+        {
+            powerKnown = false;
+        }
+        psus.push_back(psu.get());
+    }
+
+    if (psus.empty())
+    {
+        return;
+    }
+
+    // Rotate the primary PSU to even out wear
+    auto now = std::chrono::steady_clock::now();
+    if ((now - lastRotation) >= rotationPeriod)
+    {
+        rotation++;
+        lastRotation = now;
+    }
+
+    std::sort(psus.begin(), psus.end(), [](const auto& a, const auto& b) {
+        return a->name < b->name;
+    });
+    std::rotate(psus.begin(), psus.begin() + (rotation % psus.size()),
+                psus.end());
+
+    // Keep as few PSUs active as possible, each one loaded close to its
+    // efficiency peak.  Keep all of them active if the load isn't known.
+    size_t needed = psus.size();
+    if (powerKnown)
+    {
+        double psuPower = psuRatedPower * peakEfficiencyLoad;
+        needed = static_cast<size_t>(std::ceil(totalPower / psuPower));
+        if (needed < activePSUs)
+        {
+            needed = static_cast<size_t>(
+                std::ceil(totalPower / (psuPower * standbyHysteresis)));
+        }
+        needed = std::clamp<size_t>(needed, 1, psus.size());
+    }
+    activePSUs = needed;
+
+    for (size_t i = 0; i < psus.size(); i++)
+    {
+        psus[i]->order = static_cast<uint8_t>(i + 1);
+
+        // Standby PSUs are woken up in rank order
+        uint8_t config = crConfigActive;
+        if (i >= activePSUs)
+        {
+            config = static_cast<uint8_t>(crConfigActive + i + 1 - activePSUs);
+        }
+        psus[i]->wantedConfig = config;
+    }
+    programConfigs();
+}
+
+void ColdRedundancy::programConfigs()
+{
+    // Batch the writes by bus, so each worker performs them in one request
+    std::map<uint8_t, std::vector<ConfigWrite>> batches;
+    for (auto& [path, psu] : powerSupplies)
+    {
+        if (psu->writePending || (psu->wantedConfig == 0) ||
+            (psu->wantedConfig == psu->config))
+        {
+            continue;
+        }
+        batches[psu->bus].push_back(
+            ConfigWrite{path, psu->device, psu->wantedConfig, nullptr});
+        psu->writePending = true;
+    }
+
+    for (auto& [bus, writes] : batches)
+    {
+        auto batch = std::make_shared<std::vector<ConfigWrite>>(
+            std::move(writes));
+        bool queued = i2cExecutor.submit(
+            bus, i2c::Priority::high,
+            [batch]() {
+                for (auto& write : *batch)
+                {
+                    try
+                    {
+                        if (!write.device->isOpen())
+                        {
+                            write.device->open();
+                        }
+                        write.device->write(pmbusCmdCRConfig, write.value);
+                    }
+                    catch (...)
+                    {
+                        write.error = std::current_exception();
+                    }
+                }
+            },
+            [this, batch](std::exception_ptr) { configsWritten(*batch); });
+
+        if (!queued)
+        {
+            // Written again at the next schedule period
+            std::cerr << "Cold redundancy config queue of bus "
+                      << static_cast<int>(bus) << " is full\n";
+            for (const auto& write : *batch)
+            {
+                auto psu = powerSupplies.find(write.path);
+                if (psu != powerSupplies.end())
+                {
+                    psu->second->writePending = false;
+                }
+            }
+        }
+    }
+}
+
+void ColdRedundancy::configsWritten(const std::vector<ConfigWrite>& writes)
+{
+    bool rankChanged = false;
+    for (const auto& write : writes)
+    {
+        // Ignore a PSU that was removed or replaced during the write
+        auto it = powerSupplies.find(write.path);
+        if ((it == powerSupplies.end()) ||
+            (it->second->device != write.device))
+        {
+            continue;
+        }
+
+        PowerSupply& psu = *it->second;
+        psu.writePending = false;
+        if (write.error)
+        {
+            // Written again at the next schedule period
+            try
+            {
+                std::rethrow_exception(write.error);
+            }
+            catch (const std::exception& e)
+            {
+                std::cerr << "Failed to set cold redundancy config of "
+                          << psu.name << ": " << e.what() << "\n";
+            }
+            continue;
+        }
+
+        psu.config = write.value;
+        if (psu.wantedConfig != psu.config)
+        {
+            rankChanged = true;
+        }
+    }
+
+    if (rankChanged)
+    {
+        programConfigs();
+    }
+}
+
 PowerSupply::PowerSupply(
     std::string& name, uint8_t bus, uint8_t address, uint8_t order,
     const std::shared_ptr<sdbusplus::asio::connection>& dbusConnection) :
     name(name),
-    bus(bus), address(address), order(order)
+    bus(bus), address(address), order(order),
+    device(i2c::create(bus, address, i2c::I2CInterface::InitialState::CLOSED))
 {
     CR::getPSUEvent(dbusConnection, name, state);
 }
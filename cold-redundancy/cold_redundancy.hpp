@@ -14,10 +14,22 @@
 // limitations under the License.
 */
 
+#include "async_i2c.hpp"
+#include "i2c_interface.hpp"
+
 #include <boost/asio.hpp>
+#include <boost/container/flat_map.hpp>
 #include <sdbusplus/asio/object_server.hpp>
 #include <util.hpp>
 
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
 /**
  * @class ColdRedundancy
  *
@@ -41,12 +53,100 @@ class ColdRedundancy
      * Checking PSU information, adding matches, starting rotation
      * and creating PSU objects
      *
+     * Queries all of the PSU configuration objects.  After this, PSUs
+     * are only added, updated, or removed for the objects that change.
+     *
      * @param[in] dbusConnection - D-Bus connection
      */
     void
         createPSU(std::shared_ptr<sdbusplus::asio::connection>& dbusConnection);
 
   private:
+    /**
+     * Gets the properties of one PSU configuration object and
+     * creates or replaces its PSU object.
+     *
+     * @param[in] service - D-Bus service that owns the object
+     * @param[in] path - D-Bus object path of the configuration
+     */
+    void updatePSU(const std::string& service, const std::string& path);
+
+    /**
+     * Creates or replaces the PSU object for a configuration object.
+     *
+     * @param[in] path - D-Bus object path of the configuration
+     * @param[in] propMap - the configuration interface properties
+     */
+    void addPSU(const std::string& path, CR::PropertyMapType& propMap);
+
+    /**
+     * Removes the PSU object for a configuration object.
+     *
+     * @param[in] path - D-Bus object path of the configuration
+     */
+    void removePSU(const std::string& path);
+
+    /**
+     * Starts the timer that periodically reads the PSU input power
+     * and ranks the PSUs.
+     */
+    void startScheduler();
+
+    /**
+     * Reads the input power sensor of every PSU, then calls schedule()
+     * when all of the reads have finished.
+     */
+    void readInputPower();
+
+    /**
+     * Ranks the working PSUs and decides how many of them must be active.
+     *
+     * Keeps as few PSUs active as the measured input power allows, so each
+     * one runs close to its efficiency peak, and puts the rest in cold
+     * standby.  The primary PSU is rotated every rotation period to even
+     * out wear.  All PSUs stay active if the input power is not known.
+     */
+    void schedule();
+
+    /**
+     * Writes the cold redundancy configuration of the PSUs whose rank
+     * changed.
+     *
+     * The writes are batched into one request per I2C bus, which is
+     * performed by the worker of the bus, so the event loop does not block
+     * on the devices.  PSUs that already have the wanted configuration, or
+     * a write in progress, are not touched.
+     */
+    void programConfigs();
+
+    /**
+     * @struct ConfigWrite
+     *
+     * A cold redundancy configuration write in a batch for one bus.
+     */
+    struct ConfigWrite
+    {
+        /** D-Bus object path of the PSU configuration */
+        std::string path;
+
+        /** The I2C device of the PSU */
+        std::shared_ptr<i2c::I2CInterface> device;
+
+        /** The configuration value */
+        uint8_t value;
+
+        /** The exception thrown by the write, or nullptr if it succeeded */
+        std::exception_ptr error;
+    };
+
+    /**
+     * Records the results of a batch of configuration writes, and writes
+     * the PSUs again whose rank changed while the batch was in progress.
+     *
+     * @param[in] writes - the writes of the batch
+     */
+    void configsWritten(const std::vector<ConfigWrite>& writes);
+
     /**
      * @brief Indicates the count of PSUs
      *
@@ -77,6 +177,50 @@ class ColdRedundancy
      *          by these matches
      */
     std::vector<std::unique_ptr<sdbusplus::bus::match::match>> matches;
+
+    /**
+     * @brief Indicates the changed PSU configuration objects
+     *
+     * @details The object paths and their services that had a
+     *          PropertiesChanged signal during the current delay
+     *          timer period.  Only these are queried again.
+     */
+    boost::container::flat_map<std::string, std::string> changedObjects;
+
+    /**
+     * @brief Indicates the scheduler timer
+     *
+     * @details Expires every schedule period to rank the PSUs again
+     */
+    boost::asio::steady_timer scheduleTimer;
+
+    /**
+     * @brief Indicates the number of input power reads in progress
+     */
+    size_t pendingPowerReads = 0;
+
+    /**
+     * @brief Indicates the number of active PSUs
+     */
+    size_t activePSUs = 0;
+
+    /**
+     * @brief Indicates how many times the primary PSU was rotated
+     */
+    size_t rotation = 0;
+
+    /**
+     * @brief Indicates when the primary PSU was last rotated
+     */
+    std::chrono::steady_clock::time_point lastRotation;
+
+    /**
+     * @brief Indicates the I2C request executor
+     *
+     * @details Performs the configuration writes on one worker thread per
+     *          bus.  The completions run on the event loop.
+     */
+    i2c::AsyncI2CExecutor i2cExecutor;
 };
 
 /**
@@ -125,10 +269,47 @@ class PowerSupply
      * @brief Indicates the ranking order
      *
      * @details The order indicates the sequence entering standby mode.
-     *          the PSU with lower order will enter standby mode first.
+     *          Order 1 is the primary PSU, and the PSU with higher order
+     *          will enter standby mode first.  0 means not ranked yet.
      */
     uint8_t order = 0;
 
+    /**
+     * @brief Indicates the cold redundancy configuration of the PSU
+     *
+     * @details The value last written to the PSU cold redundancy
+     *          configuration command, or 0 if it was not written yet.
+     */
+    uint8_t config = 0;
+
+    /**
+     * @brief Indicates the wanted cold redundancy configuration
+     *
+     * @details The value chosen by the last ranking, or 0 if the PSU was
+     *          not ranked yet.
+     */
+    uint8_t wantedConfig = 0;
+
+    /**
+     * @brief Indicates whether a configuration write is in progress
+     */
+    bool writePending = false;
+
+    /**
+     * @brief Indicates the I2C device of the PSU
+     *
+     * @details Opened by the worker of the bus on the first write.  Shared
+     *          with the writes in progress, so it outlives a removed PSU.
+     */
+    std::shared_ptr<i2c::I2CInterface> device;
+
+    /**
+     * @brief Indicates the input power of the PSU in watts
+     *
+     * @details Not set if the last read of the input power sensor failed
+     */
+    std::optional<double> inputPower;
+
     /**
      * @brief Indicates the status of the PSU
      *
@@ -0,0 +1,105 @@
+/**
+ * Copyright © 2026 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "config_cache.hpp"
+
+#include "utility.hpp"
+
+#include <phosphor-logging/log.hpp>
+
+#include <utility>
+
+namespace phosphor::power::util
+{
+
+using namespace phosphor::logging;
+
+ConfigFile::ConfigFile(nlohmann::json&& contents) :
+    data{std::move(contents)}
+{
+    auto psuDevices = data.find("psuDevices");
+    if ((psuDevices != data.end()) && psuDevices->is_object())
+    {
+        for (const auto& item : psuDevices->items())
+        {
+            if (item.value().is_string())
+            {
+                devices.emplace(item.key(), item.value().get<std::string>());
+            }
+        }
+    }
+
+    auto fruConfigsJSON = data.find("fruConfigs");
+    if ((fruConfigsJSON != data.end()) && fruConfigsJSON->is_array())
+    {
+        for (const auto& fru : *fruConfigsJSON)
+        {
+            if (fru.is_object() && fru.contains("propertyName") &&
+                fru.contains("fileName") && fru.contains("interface"))
+            {
+                fruConfigs.push_back({fru["propertyName"].get<std::string>(),
+                                      fru["fileName"].get<std::string>(),
+                                      fru["interface"].get<std::string>()});
+            }
+        }
+    }
+}
+
+ConfigCache& ConfigCache::getInstance()
+{
+    static ConfigCache cache;
+    return cache;
+}
+
+std::shared_ptr<const ConfigFile> ConfigCache::load(const std::string& path)
+{
+    std::lock_guard<std::mutex> lock{mutex};
+
+    struct stat st
+    {};
+    if (stat(path.c_str(), &st) != 0)
+    {
+        log<level::ERR>(
+            std::string("Unable to open file PATH=" + path).c_str());
+        files.erase(path);
+        return nullptr;
+    }
+
+    auto it = files.find(path);
+    if ((it != files.end()) && (it->second.device == st.st_dev) &&
+        (it->second.inode == st.st_ino) && (it->second.size == st.st_size) &&
+        (it->second.modified.tv_sec == st.st_mtim.tv_sec) &&
+        (it->second.modified.tv_nsec == st.st_mtim.tv_nsec))
+    {
+        return it->second.file;
+    }
+
+    // The file is new or has changed.  Anyone still using the previous
+    // version keeps their handle to it.
+    files.erase(path);
+    parseCount++;
+    auto data = loadJSONFromFile(path.c_str());
+    if (data == nullptr)
+    {
+        return nullptr;
+    }
+
+    auto file = std::make_shared<const ConfigFile>(std::move(data));
+    files.emplace(path, Entry{st.st_dev, st.st_ino, st.st_size, st.st_mtim,
+                              file});
+    return file;
+}
+
+} // namespace phosphor::power::util
@@ -0,0 +1,227 @@
+#pragma once
+
+#include <sys/stat.h>
+
+#include <nlohmann/json.hpp>
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace phosphor::power::util
+{
+
+/**
+ * An entry of the fruConfigs array of the PSU JSON file
+ */
+struct FRUConfig
+{
+    /**
+     * The inventory property, like "Version"
+     */
+    std::string propertyName;
+
+    /**
+     * The PMBus file the property is read from
+     */
+    std::string fileName;
+
+    /**
+     * The inventory interface of the property
+     */
+    std::string interface;
+};
+
+/**
+ * @class ConfigFile
+ *
+ * The parsed contents of a JSON config file.  The objects are shared by
+ * everyone that loaded the same version of the file, and are never changed.
+ *
+ * For the PSU JSON file, the psuDevices and fruConfigs are also extracted,
+ * so they can be used without looking them up in the JSON.
+ */
+class ConfigFile
+{
+  public:
+    ConfigFile() = delete;
+    ConfigFile(const ConfigFile&) = delete;
+    ConfigFile& operator=(const ConfigFile&) = delete;
+    ConfigFile(ConfigFile&&) = delete;
+    ConfigFile& operator=(ConfigFile&&) = delete;
+    ~ConfigFile() = default;
+
+    /**
+     * Constructor
+     *
+     * @param[in] contents - the parsed file
+     */
+    explicit ConfigFile(nlohmann::json&& contents);
+
+    /**
+     * Returns the device path of a PSU from psuDevices.
+     *
+     * @param[in] psuInventoryPath - the inventory path of the PSU
+     *
+     * @return const std::string* - the device path, or nullptr if the PSU
+     *                              is not in psuDevices
+     */
+    const std::string* getDevicePath(const std::string& psuInventoryPath) const
+    {
+        auto it = devices.find(psuInventoryPath);
+        return (it != devices.end()) ? &it->second : nullptr;
+    }
+
+    /**
+     * Returns the entries of fruConfigs that have all of their fields.
+     *
+     * @return const std::vector<FRUConfig>& - the entries, in file order
+     */
+    const std::vector<FRUConfig>& getFRUConfigs() const
+    {
+        return fruConfigs;
+    }
+
+    /**
+     * Returns the parsed file.
+     *
+     * @return const nlohmann::json& - the JSON
+     */
+    const nlohmann::json& getJSON() const
+    {
+        return data;
+    }
+
+    /**
+     * Returns the devices of psuDevices.
+     *
+     * @return const std::map<std::string, std::string>& - the device paths,
+     *                                                      keyed by PSU
+     *                                                      inventory path
+     */
+    const std::map<std::string, std::string>& getPSUDevices() const
+    {
+        return devices;
+    }
+
+  private:
+    /**
+     * The parsed file
+     */
+    const nlohmann::json data;
+
+    /**
+     * The device paths of psuDevices, keyed by PSU inventory path
+     */
+    std::map<std::string, std::string> devices;
+
+    /**
+     * The entries of fruConfigs
+     */
+    std::vector<FRUConfig> fruConfigs;
+};
+
+/**
+ * @class ConfigCache
+ *
+ * Process-wide cache of the parsed JSON config files, keyed by path.
+ *
+ * A file is only parsed again if it was replaced or modified since it was
+ * last loaded, as found from its inode, size and modification time, so a
+ * load is one stat() call while the file does not change.
+ *
+ * All the members are thread safe.
+ */
+class ConfigCache
+{
+  public:
+    ConfigCache() = default;
+    ConfigCache(const ConfigCache&) = delete;
+    ConfigCache& operator=(const ConfigCache&) = delete;
+    ConfigCache(ConfigCache&&) = delete;
+    ConfigCache& operator=(ConfigCache&&) = delete;
+    ~ConfigCache() = default;
+
+    /**
+     * Returns the cache shared by the process.
+     *
+     * @return ConfigCache& - the cache
+     */
+    static ConfigCache& getInstance();
+
+    /**
+     * Loads a JSON config file, from the cache if it has not changed.
+     *
+     * @param[in] path - the path of the file
+     *
+     * @return std::shared_ptr<const ConfigFile> - the file, or nullptr if it
+     *                                             could not be read or parsed
+     */
+    std::shared_ptr<const ConfigFile> load(const std::string& path);
+
+    /**
+     * Returns the number of times a file was parsed.
+     *
+     * @return size_t - the number of parses
+     */
+    size_t getParseCount() const
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        return parseCount;
+    }
+
+    /**
+     * Discards the cached files, so they are parsed again on the next load.
+     */
+    void invalidate()
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        files.clear();
+    }
+
+  private:
+    /**
+     * A cached file and the version of it that was parsed
+     */
+    struct Entry
+    {
+        dev_t device;
+        ino_t inode;
+        off_t size;
+        struct timespec modified;
+        std::shared_ptr<const ConfigFile> file;
+    };
+
+    /**
+     * Protects the members below
+     */
+    mutable std::mutex mutex;
+
+    /**
+     * The number of times a file was parsed
+     */
+    size_t parseCount = 0;
+
+    /**
+     * The cached files, keyed by path
+     */
+    std::map<std::string, Entry> files;
+};
+
+/**
+ * Loads a JSON config file from the cache shared by the process.
+ *
+ * @param[in] path - the path of the file
+ *
+ * @return std::shared_ptr<const ConfigFile> - the file, or nullptr if it
+ *                                             could not be read or parsed
+ */
+inline std::shared_ptr<const ConfigFile> loadConfigFile(const std::string& path)
+{
+    return ConfigCache::getInstance().load(path);
+}
+
+} // namespace phosphor::power::util
@@ -0,0 +1,88 @@
+/**
+ * Copyright © 2026 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "cycle_stats.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace phosphor::power::util
+{
+
+std::chrono::microseconds CycleStatistics::getPercentile(double percent) const
+{
+    if (samples.empty())
+    {
+        return std::chrono::microseconds{0};
+    }
+
+    // Nearest rank: the smallest duration with at least percent of the
+    // samples less than or equal to it
+    percent = std::clamp(percent, 0.0, 100.0);
+    auto rank = static_cast<std::size_t>(
+        std::ceil(percent / 100.0 * static_cast<double>(samples.size())));
+    std::size_t index = (rank > 0) ? (rank - 1) : 0;
+
+    std::vector<std::chrono::microseconds> sorted{samples};
+    std::nth_element(sorted.begin(), sorted.begin() + index, sorted.end());
+    return sorted[index];
+}
+
+bool CycleStatistics::record(std::chrono::microseconds duration)
+{
+    if (samples.size() < sampleCount)
+    {
+        samples.emplace_back(duration);
+    }
+    else
+    {
+        samples[nextSample] = duration;
+        nextSample = (nextSample + 1) % sampleCount;
+    }
+
+    ++count;
+    last = duration;
+    max = std::max(max, duration);
+
+    bool overrun = (interval.count() > 0) && (duration > interval);
+    if (overrun)
+    {
+        ++overrunCount;
+    }
+    return overrun;
+}
+
+void CycleStatistics::reset()
+{
+    samples.clear();
+    nextSample = 0;
+    count = 0;
+    last = std::chrono::microseconds{0};
+    max = std::chrono::microseconds{0};
+    overrunCount = 0;
+}
+
+std::string CycleStatistics::toString() const
+{
+    return "cycles: " + std::to_string(count) +
+           ", last: " + std::to_string(last.count()) +
+           " us, p50: " + std::to_string(getPercentile(50).count()) +
+           " us, p99: " + std::to_string(getPercentile(99).count()) +
+           " us, max: " + std::to_string(max.count()) +
+           " us, interval: " + std::to_string(interval.count()) +
+           " us, overruns: " + std::to_string(overrunCount);
+}
+
+} // namespace phosphor::power::util
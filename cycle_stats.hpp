@@ -0,0 +1,206 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace phosphor::power::util
+{
+
+/**
+ * @class CycleStatistics
+ *
+ * Statistics of the time taken by the cycles of a periodic monitoring loop.
+ *
+ * Records the duration of each cycle and counts the overruns, which are the
+ * cycles that took longer than the loop interval.  The percentiles are
+ * computed from the most recent sampleCount cycles; the other statistics
+ * cover all the cycles since the last reset.
+ */
+class CycleStatistics
+{
+  public:
+    /**
+     * Number of recent cycle durations used for the percentiles.
+     */
+    static constexpr std::size_t sampleCount{1024};
+
+    CycleStatistics(const CycleStatistics&) = delete;
+    CycleStatistics& operator=(const CycleStatistics&) = delete;
+    CycleStatistics(CycleStatistics&&) = delete;
+    CycleStatistics& operator=(CycleStatistics&&) = delete;
+    ~CycleStatistics() = default;
+
+    /**
+     * Constructor
+     *
+     * @param[in] interval - the loop interval; 0 if cycles never overrun
+     */
+    explicit CycleStatistics(
+        std::chrono::microseconds interval = std::chrono::microseconds{0}) :
+        interval{interval}
+    {
+        samples.reserve(sampleCount);
+    }
+
+    /**
+     * Returns the number of cycles recorded.
+     *
+     * @return uint64_t - the number of cycles
+     */
+    uint64_t getCount() const
+    {
+        return count;
+    }
+
+    /**
+     * Returns the loop interval.
+     *
+     * @return microseconds - the interval
+     */
+    std::chrono::microseconds getInterval() const
+    {
+        return interval;
+    }
+
+    /**
+     * Returns the duration of the last cycle.
+     *
+     * @return microseconds - the duration, or 0 if no cycles were recorded
+     */
+    std::chrono::microseconds getLast() const
+    {
+        return last;
+    }
+
+    /**
+     * Returns the duration of the longest cycle.
+     *
+     * @return microseconds - the duration, or 0 if no cycles were recorded
+     */
+    std::chrono::microseconds getMax() const
+    {
+        return max;
+    }
+
+    /**
+     * Returns the number of cycles that took longer than the interval.
+     *
+     * @return uint64_t - the number of overruns
+     */
+    uint64_t getOverrunCount() const
+    {
+        return overrunCount;
+    }
+
+    /**
+     * Returns a percentile of the recent cycle durations.
+     *
+     * Uses the nearest rank method.
+     *
+     * @param[in] percent - the percentile, from 0 to 100
+     *
+     * @return microseconds - the duration, or 0 if no cycles were recorded
+     */
+    std::chrono::microseconds getPercentile(double percent) const;
+
+    /**
+     * Returns whether a journal warning should be logged for each overrun.
+     *
+     * The statistics do not log; the owner of the loop checks this when
+     * record() reports an overrun.
+     *
+     * @return bool - true if warnings are enabled, false otherwise
+     */
+    bool isOverrunWarningEnabled() const
+    {
+        return overrunWarningEnabled;
+    }
+
+    /**
+     * Records the duration of a cycle.
+     *
+     * @param[in] duration - the time the cycle took
+     *
+     * @return bool - true if the cycle overran the interval, false otherwise
+     */
+    bool record(std::chrono::microseconds duration);
+
+    /**
+     * Discards the recorded cycles.  The interval and the warning setting
+     * are kept.
+     */
+    void reset();
+
+    /**
+     * Sets the loop interval.
+     *
+     * @param[in] interval - the interval; 0 if cycles never overrun
+     */
+    void setInterval(std::chrono::microseconds interval)
+    {
+        this->interval = interval;
+    }
+
+    /**
+     * Sets whether a journal warning should be logged for each overrun.
+     *
+     * @param[in] enable - true to enable warnings, false to disable them
+     */
+    void setOverrunWarningEnabled(bool enable)
+    {
+        overrunWarningEnabled = enable;
+    }
+
+    /**
+     * Returns the statistics as one line of text.
+     *
+     * @return string - the statistics
+     */
+    std::string toString() const;
+
+  private:
+    /**
+     * The loop interval.
+     */
+    std::chrono::microseconds interval;
+
+    /**
+     * The recent cycle durations, used as a ring buffer once full.
+     */
+    std::vector<std::chrono::microseconds> samples{};
+
+    /**
+     * The index in samples of the next duration once it is full.
+     */
+    std::size_t nextSample{0};
+
+    /**
+     * The number of cycles recorded.
+     */
+    uint64_t count{0};
+
+    /**
+     * The duration of the last cycle.
+     */
+    std::chrono::microseconds last{0};
+
+    /**
+     * The duration of the longest cycle.
+     */
+    std::chrono::microseconds max{0};
+
+    /**
+     * The number of cycles that took longer than the interval.
+     */
+    uint64_t overrunCount{0};
+
+    /**
+     * Whether a journal warning should be logged for each overrun.
+     */
+    bool overrunWarningEnabled{false};
+};
+
+} // namespace phosphor::power::util
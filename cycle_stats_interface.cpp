@@ -0,0 +1,163 @@
+/**
+ * Copyright © 2026 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "cycle_stats_interface.hpp"
+
+#include <phosphor-logging/log.hpp>
+#include <sdbusplus/exception.hpp>
+#include <sdbusplus/server.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <string>
+
+namespace phosphor::power::util
+{
+
+CycleStatisticsInterface::CycleStatisticsInterface(sdbusplus::bus::bus& bus,
+                                                   const char* path,
+                                                   CycleStatistics& stats) :
+    stats{stats},
+    _serverInterface(bus, path, interface, _vtable, this)
+{}
+
+int CycleStatisticsInterface::callbackEnableOverrunWarning(
+    sd_bus_message* msg, void* context, sd_bus_error* error)
+{
+    if (msg != nullptr && context != nullptr)
+    {
+        try
+        {
+            bool enable{};
+            auto m = sdbusplus::message::message(msg);
+
+            m.read(enable);
+
+            auto obj = static_cast<CycleStatisticsInterface*>(context);
+            obj->stats.setOverrunWarningEnabled(enable);
+
+            auto reply = m.new_method_return();
+
+            reply.method_return();
+        }
+        catch (const sdbusplus::exception_t& e)
+        {
+            return sd_bus_error_set(error, e.name(), e.description());
+        }
+    }
+    else
+    {
+        // The message or context were null
+        using namespace phosphor::logging;
+        log<level::ERR>(
+            "Unable to service EnableOverrunWarning method callback");
+        return -1;
+    }
+
+    return 1;
+}
+
+int CycleStatisticsInterface::callbackGetStatistics(sd_bus_message* msg,
+                                                    void* context,
+                                                    sd_bus_error* error)
+{
+    if (msg != nullptr && context != nullptr)
+    {
+        try
+        {
+            auto m = sdbusplus::message::message(msg);
+
+            auto obj = static_cast<CycleStatisticsInterface*>(context);
+            const CycleStatistics& stats = obj->stats;
+            auto toMicroseconds = [](std::chrono::microseconds time) {
+                return static_cast<uint64_t>(time.count());
+            };
+            std::map<std::string, uint64_t> values{
+                {"Count", stats.getCount()},
+                {"IntervalUs", toMicroseconds(stats.getInterval())},
+                {"LastUs", toMicroseconds(stats.getLast())},
+                {"MaxUs", toMicroseconds(stats.getMax())},
+                {"Overruns", stats.getOverrunCount()},
+                {"P50Us", toMicroseconds(stats.getPercentile(50))},
+                {"P99Us", toMicroseconds(stats.getPercentile(99))}};
+
+            auto reply = m.new_method_return();
+            reply.append(values);
+
+            reply.method_return();
+        }
+        catch (const sdbusplus::exception_t& e)
+        {
+            return sd_bus_error_set(error, e.name(), e.description());
+        }
+    }
+    else
+    {
+        // The message or context were null
+        using namespace phosphor::logging;
+        log<level::ERR>("Unable to service GetStatistics method callback");
+        return -1;
+    }
+
+    return 1;
+}
+
+int CycleStatisticsInterface::callbackReset(sd_bus_message* msg,
+                                            void* context, sd_bus_error* error)
+{
+    if (msg != nullptr && context != nullptr)
+    {
+        try
+        {
+            auto m = sdbusplus::message::message(msg);
+
+            auto obj = static_cast<CycleStatisticsInterface*>(context);
+            obj->stats.reset();
+
+            auto reply = m.new_method_return();
+
+            reply.method_return();
+        }
+        catch (const sdbusplus::exception_t& e)
+        {
+            return sd_bus_error_set(error, e.name(), e.description());
+        }
+    }
+    else
+    {
+        // The message or context were null
+        using namespace phosphor::logging;
+        log<level::ERR>("Unable to service Reset method callback");
+        return -1;
+    }
+
+    return 1;
+}
+
+const sdbusplus::vtable::vtable_t CycleStatisticsInterface::_vtable[] = {
+    sdbusplus::vtable::start(),
+    // EnableOverrunWarning method takes a boolean parameter and returns void
+    sdbusplus::vtable::method("EnableOverrunWarning", "b", "",
+                              callbackEnableOverrunWarning),
+    // No GetStatistics method parameters and returns a dictionary of
+    // statistic names and values
+    sdbusplus::vtable::method("GetStatistics", "", "a{st}",
+                              callbackGetStatistics),
+    // No Reset method parameters and returns void
+    sdbusplus::vtable::method("Reset", "", "", callbackReset),
+    sdbusplus::vtable::end()};
+
+} // namespace phosphor::power::util
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "cycle_stats.hpp"
+
+#include <systemd/sd-bus.h>
+
+#include <sdbusplus/bus.hpp>
+#include <sdbusplus/sdbus.hpp>
+#include <sdbusplus/server/interface.hpp>
+#include <sdbusplus/vtable.hpp>
+
+namespace phosphor::power::util
+{
+
+/**
+ * @class CycleStatisticsInterface
+ *
+ * Debug D-Bus interface that shows the CycleStatistics of a monitoring loop.
+ *
+ * Methods:
+ * - GetStatistics: returns a dictionary of the statistics, with durations in
+ *   microseconds
+ * - Reset: discards the recorded cycles
+ * - EnableOverrunWarning: enables or disables the journal warning logged for
+ *   each overrun
+ */
+class CycleStatisticsInterface
+{
+  public:
+    CycleStatisticsInterface() = delete;
+    CycleStatisticsInterface(const CycleStatisticsInterface&) = delete;
+    CycleStatisticsInterface&
+        operator=(const CycleStatisticsInterface&) = delete;
+    CycleStatisticsInterface(CycleStatisticsInterface&&) = delete;
+    CycleStatisticsInterface& operator=(CycleStatisticsInterface&&) = delete;
+    ~CycleStatisticsInterface() = default;
+
+    /**
+     * @brief Constructor to put the interface onto the bus at a path.
+     *
+     * @param[in] bus - Bus to attach to.
+     * @param[in] path - Path to attach at.
+     * @param[in] stats - Statistics to show.  Must outlive this object.
+     */
+    CycleStatisticsInterface(sdbusplus::bus::bus& bus, const char* path,
+                             CycleStatistics& stats);
+
+    /**
+     * @brief This dbus interface's name
+     */
+    static constexpr auto interface =
+        "xyz.openbmc_project.Power.Debug.CycleStatistics";
+
+  private:
+    /**
+     * @brief Systemd bus callback for the EnableOverrunWarning method
+     */
+    static int callbackEnableOverrunWarning(sd_bus_message* msg,
+                                            void* context,
+                                            sd_bus_error* error);
+
+    /**
+     * @brief Systemd bus callback for the GetStatistics method
+     */
+    static int callbackGetStatistics(sd_bus_message* msg, void* context,
+                                     sd_bus_error* error);
+
+    /**
+     * @brief Systemd bus callback for the Reset method
+     */
+    static int callbackReset(sd_bus_message* msg, void* context,
+                             sd_bus_error* error);
+
+    /**
+     * @brief Systemd vtable structure that contains all the
+     * methods of this interface with their respective systemd attributes
+     */
+    static const sdbusplus::vtable::vtable_t _vtable[];
+
+    /**
+     * @brief The statistics shown by this interface
+     */
+    CycleStatistics& stats;
+
+    /**
+     * @brief Holder for the instance of this interface to be
+     * on dbus
+     */
+    sdbusplus::server::interface::interface _serverInterface;
+};
+
+} // namespace phosphor::power::util
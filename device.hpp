@@ -2,6 +2,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace phosphor
 {
@@ -67,6 +68,27 @@ class Device
      */
     virtual void clearFaults() = 0;
 
+    /**
+     * Returns file descriptors that become readable when the
+     * device signals a fault, such as GPIO event descriptors.
+     * Override if the device has alert lines.
+     *
+     * @return the alert file descriptors, empty if none
+     */
+    virtual std::vector<int> getAlertFDs()
+    {
+        return {};
+    }
+
+    /**
+     * Acknowledges an alert on one of the descriptors returned
+     * by getAlertFDs().  Override if getAlertFDs() is overridden.
+     *
+     * @param[in] fd - the alert file descriptor
+     */
+    virtual void clearAlert(int /*fd*/)
+    {}
+
   private:
     /**
      * the device name
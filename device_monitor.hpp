@@ -1,13 +1,22 @@
 #pragma once
 #include "device.hpp"
 
+#include <sys/epoll.h>
+
 #include <phosphor-logging/log.hpp>
 #include <sdbusplus/bus.hpp>
 #include <sdbusplus/server.hpp>
 #include <sdeventplus/clock.hpp>
 #include <sdeventplus/event.hpp>
+#include <sdeventplus/source/io.hpp>
 #include <sdeventplus/utility/timer.hpp>
 
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <vector>
+
 namespace phosphor
 {
 namespace power
@@ -21,6 +30,11 @@ using namespace phosphor::logging;
  * Monitors a power device for faults by calling Device::analyze()
  * on an interval.  Do the monitoring by calling run().
  * May be overridden to provide more functionality.
+ *
+ * Several devices can share one monitor, and so one event loop and
+ * bus connection.  Each device is still analyzed once per interval,
+ * but the analyses are spread evenly across the interval instead of
+ * all running at once.
  */
 class DeviceMonitor
 {
@@ -41,8 +55,20 @@ class DeviceMonitor
      */
     DeviceMonitor(std::unique_ptr<Device>&& d, const sdeventplus::Event& e,
                   std::chrono::milliseconds i) :
-        device(std::move(d)),
-        timer(e, std::bind(&DeviceMonitor::analyze, this), i)
+        DeviceMonitor(makeDevices(std::move(d)), e, i)
+    {}
+
+    /**
+     * Constructor
+     *
+     * @param[in] d - devices to monitor, at least one
+     * @param[in] e - event object
+     * @param[in] i - polling interval of each device in ms
+     */
+    DeviceMonitor(std::vector<std::unique_ptr<Device>>&& d,
+                  const sdeventplus::Event& e, std::chrono::milliseconds i) :
+        devices(std::move(d)),
+        timer(e, std::bind(&DeviceMonitor::analyze, this), getPhase(i))
     {}
 
     /**
@@ -53,9 +79,41 @@ class DeviceMonitor
         return timer.get_event().loop();
     }
 
+    /**
+     * Analyzes the device when one of its alert file descriptors
+     * becomes readable instead of only on the polling interval.
+     *
+     * If the device has alert descriptors, the timer is changed to
+     * the watchdog interval so faults that don't raise an alert are
+     * still found.  Otherwise the device keeps being polled.
+     *
+     * @param[in] watchdogInterval - poll interval used with alerts
+     */
+    void watchAlerts(std::chrono::milliseconds watchdogInterval)
+    {
+        alertSources.clear();
+
+        for (auto& device : devices)
+        {
+            for (auto fd : device->getAlertFDs())
+            {
+                alertSources.push_back(
+                    std::make_unique<sdeventplus::source::IO>(
+                        timer.get_event(), fd, EPOLLIN,
+                        std::bind(&DeviceMonitor::alertReceived, this,
+                                  std::ref(*device), std::placeholders::_2)));
+            }
+        }
+
+        if (!alertSources.empty())
+        {
+            timer.restart(getPhase(watchdogInterval));
+        }
+    }
+
   protected:
     /**
-     * Analyzes the device for faults
+     * Analyzes the next device for faults
      *
      * Runs in the timer callback
      *
@@ -63,18 +121,66 @@ class DeviceMonitor
      */
     virtual void analyze()
     {
-        device->analyze();
+        devices[next]->analyze();
+        next = (next + 1) % devices.size();
+    }
+
+    /**
+     * Acknowledges the alert and analyzes the device
+     *
+     * Runs in the alert IO source callback
+     *
+     * @param[in] device - the device that raised the alert
+     * @param[in] fd - the alert file descriptor
+     */
+    void alertReceived(Device& device, int fd)
+    {
+        device.clearAlert(fd);
+        device.analyze();
+    }
+
+    /**
+     * Returns the time between the analyses of two devices
+     *
+     * @param[in] i - the interval each device is analyzed on
+     */
+    std::chrono::milliseconds getPhase(std::chrono::milliseconds i) const
+    {
+        return std::max(i / devices.size(), std::chrono::milliseconds{1});
+    }
+
+    /**
+     * Returns a list of just one device
+     *
+     * @param[in] d - the device
+     */
+    static std::vector<std::unique_ptr<Device>>
+        makeDevices(std::unique_ptr<Device>&& d)
+    {
+        std::vector<std::unique_ptr<Device>> list;
+        list.push_back(std::move(d));
+        return list;
     }
 
     /**
-     * The device to run the analysis on
+     * The devices to run the analysis on
      */
-    std::unique_ptr<Device> device;
+    std::vector<std::unique_ptr<Device>> devices;
+
+    /**
+     * The index of the device analyzed on the next timer expiration
+     */
+    size_t next = 0;
 
     /**
      * The timer that runs fault check polls.
      */
     sdeventplus::utility::Timer<sdeventplus::ClockId::Monotonic> timer;
+
+    /**
+     * The IO sources that watch the device alert file descriptors
+     */
+    std::vector<std::unique_ptr<sdeventplus::source::IO>> alertSources;
 };
 
 } // namespace power
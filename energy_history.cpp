@@ -0,0 +1,160 @@
+/**
+ * Copyright © 2026 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "energy_history.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace phosphor::power::history
+{
+
+namespace
+{
+
+// The accumulator, with the rollover count above it, wraps at 2^23 counts
+constexpr uint64_t ENERGY_MODULUS =
+    static_cast<uint64_t>(EnergyHistory::MAX_ACCUMULATOR + 1) * 256;
+
+// The sample count has 24 bits
+constexpr uint64_t SAMPLE_MODULUS = uint64_t{1} << 24;
+
+/**
+ * Returns the total energy of a reading, modulo ENERGY_MODULUS.
+ *
+ * @param[in] reading - the reading
+ *
+ * @return uint64_t - the energy in counts
+ */
+uint64_t getEnergy(const EnergyReading& reading)
+{
+    return static_cast<uint64_t>(reading.rolloverCount) *
+               (EnergyHistory::MAX_ACCUMULATOR + 1) +
+           reading.accumulator;
+}
+
+} // namespace
+
+EnergyHistory::EnergyHistory(size_t maxRecords, size_t samplesPerRecord,
+                             const Coefficients& coefficients) :
+    maxRecords(maxRecords),
+    samplesPerRecord(std::max<size_t>(samplesPerRecord, 1)),
+    coefficients(coefficients)
+{
+    averageRecords.reserve(maxRecords);
+    maximumRecords.reserve(maxRecords);
+}
+
+std::optional<EnergyReading>
+    EnergyHistory::parse(std::span<const uint8_t> data)
+{
+    if (data.size() != RAW_READING_SIZE)
+    {
+        return std::nullopt;
+    }
+
+    // Little endian accumulator, rollover count, then sample count
+    EnergyReading reading;
+    reading.accumulator = static_cast<uint16_t>(data[0] | (data[1] << 8));
+    reading.rolloverCount = data[2];
+    reading.sampleCount = static_cast<uint32_t>(data[3] | (data[4] << 8) |
+                                                (data[5] << 16));
+    if (reading.accumulator > MAX_ACCUMULATOR)
+    {
+        return std::nullopt;
+    }
+    return reading;
+}
+
+bool EnergyHistory::add(std::span<const uint8_t> data, uint64_t timestamp)
+{
+    auto reading = parse(data);
+    if (!reading)
+    {
+        restart();
+        previous.reset();
+        return false;
+    }
+
+    if (!previous)
+    {
+        previous = reading;
+        return false;
+    }
+
+    uint64_t energy =
+        (getEnergy(*reading) + ENERGY_MODULUS - getEnergy(*previous)) %
+        ENERGY_MODULUS;
+    uint64_t samples =
+        (reading->sampleCount + SAMPLE_MODULUS - previous->sampleCount) %
+        SAMPLE_MODULUS;
+    previous = reading;
+    if (samples == 0)
+    {
+        // The device stopped sampling, or was reset
+        restart();
+        return false;
+    }
+
+    recordEnergy += energy;
+    recordSamples += samples;
+    recordMaximum = std::max(
+        recordMaximum, toWatts(static_cast<double>(energy) / samples));
+    if (++recordIntervals < samplesPerRecord)
+    {
+        return false;
+    }
+
+    auto average = toWatts(static_cast<double>(recordEnergy) / recordSamples);
+    averageRecords.emplace(averageRecords.begin(), timestamp,
+                           std::llround(average));
+    maximumRecords.emplace(maximumRecords.begin(), timestamp,
+                           std::llround(recordMaximum));
+    if (averageRecords.size() > maxRecords)
+    {
+        averageRecords.pop_back();
+        maximumRecords.pop_back();
+    }
+    restart();
+    return true;
+}
+
+void EnergyHistory::clear()
+{
+    restart();
+    previous.reset();
+    averageRecords.clear();
+    maximumRecords.clear();
+}
+
+double EnergyHistory::toWatts(double counts) const
+{
+    if (coefficients.m == 0)
+    {
+        return 0.0;
+    }
+    return (counts * std::pow(10.0, -coefficients.R) - coefficients.b) /
+           coefficients.m;
+}
+
+void EnergyHistory::restart()
+{
+    recordEnergy = 0;
+    recordSamples = 0;
+    recordIntervals = 0;
+    recordMaximum = 0.0;
+}
+
+} // namespace phosphor::power::history
@@ -0,0 +1,214 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <tuple>
+#include <vector>
+
+namespace phosphor::power::history
+{
+
+/**
+ * A reading of a PMBus energy accumulator, READ_EIN or READ_EOUT.
+ */
+struct EnergyReading
+{
+    /**
+     * The accumulated power, in direct format counts.  Rolls over after
+     * EnergyHistory::MAX_ACCUMULATOR.
+     */
+    uint16_t accumulator = 0;
+
+    /**
+     * The number of times the accumulator has rolled over, modulo 256
+     */
+    uint8_t rolloverCount = 0;
+
+    /**
+     * The number of power samples accumulated, modulo 2^24
+     */
+    uint32_t sampleCount = 0;
+};
+
+/**
+ * The PMBus direct format coefficients of a value: X = (Y * 10^-R - b) / m,
+ * where Y is the value read and X is the value in watts.
+ */
+struct Coefficients
+{
+    int16_t m = 1;
+    int16_t b = 0;
+    int8_t R = 0;
+};
+
+/**
+ * @class EnergyHistory
+ *
+ * History of the average and maximum power of a device, computed from its
+ * PMBus energy accumulator.
+ *
+ * The device adds every power sample it takes to the accumulator and counts
+ * the samples, so the difference between two readings divided by the
+ * difference in sample counts is the exact average power between them, no
+ * matter how rarely the accumulator is read.  Only the accumulator must be
+ * read often enough for its rollover count not to wrap between readings.
+ *
+ * Each reading added ends an interval.  Each record covers samplesPerRecord
+ * intervals, and holds their average power and the highest average power of
+ * the intervals.  The records are kept newest first in the representation
+ * used by the Average and Maximum D-Bus interfaces, and the oldest ones are
+ * pruned after maxRecords.
+ */
+class EnergyHistory
+{
+  public:
+    static constexpr size_t RAW_READING_SIZE = 6;
+    static constexpr uint16_t MAX_ACCUMULATOR = 0x7FFF;
+
+    using DBusRecord = std::tuple<uint64_t, int64_t>;
+    using DBusRecordList = std::vector<DBusRecord>;
+
+    EnergyHistory() = delete;
+    ~EnergyHistory() = default;
+    EnergyHistory(const EnergyHistory&) = default;
+    EnergyHistory& operator=(const EnergyHistory&) = default;
+    EnergyHistory(EnergyHistory&&) = default;
+    EnergyHistory& operator=(EnergyHistory&&) = default;
+
+    /**
+     * @brief Constructor
+     *
+     * @param[in] maxRecords - the maximum number of records to keep
+     * @param[in] samplesPerRecord - the number of readings, after the first,
+     *                               that make up a record
+     * @param[in] coefficients - the direct format coefficients of the power
+     *                           samples
+     */
+    EnergyHistory(size_t maxRecords, size_t samplesPerRecord,
+                  const Coefficients& coefficients = Coefficients{});
+
+    /**
+     * @brief Parses the raw data of an energy accumulator
+     *
+     * @param[in] data - the bytes of the READ_EIN or READ_EOUT block, without
+     *                   the block count
+     *
+     * @return the reading, or std::nullopt if the data is the wrong length
+     */
+    static std::optional<EnergyReading> parse(std::span<const uint8_t> data);
+
+    /**
+     * @brief Adds a reading of the energy accumulator
+     *
+     * A reading that cannot be parsed, or that shows no new power samples,
+     * discards the partial record, and the interval starts again from the
+     * next valid reading.
+     *
+     * @param[in] data - the raw data read from the device
+     * @param[in] timestamp - the time of the reading, in milliseconds since
+     *                        the epoch
+     *
+     * @return bool - true if a record was added
+     */
+    bool add(std::span<const uint8_t> data, uint64_t timestamp);
+
+    /**
+     * @brief Returns the history of average power, newest first
+     */
+    const DBusRecordList& getAverageRecords() const
+    {
+        return averageRecords;
+    }
+
+    /**
+     * @brief Returns the history of maximum power, newest first
+     */
+    const DBusRecordList& getMaximumRecords() const
+    {
+        return maximumRecords;
+    }
+
+    /**
+     * @brief Returns the number of records
+     */
+    size_t getNumRecords() const
+    {
+        return averageRecords.size();
+    }
+
+    /**
+     * @brief Deletes all records and the partial record, such as when the
+     *        device has been replaced.
+     */
+    void clear();
+
+  private:
+    /**
+     * @brief Converts an average in direct format counts to watts
+     *
+     * @param[in] counts - the average power sample
+     *
+     * @return double - the power in watts
+     */
+    double toWatts(double counts) const;
+
+    /**
+     * @brief Discards the partial record
+     */
+    void restart();
+
+    /**
+     * @brief The maximum number of records to keep
+     */
+    size_t maxRecords;
+
+    /**
+     * @brief The number of intervals in each record
+     */
+    size_t samplesPerRecord;
+
+    /**
+     * @brief The direct format coefficients of the power samples
+     */
+    Coefficients coefficients;
+
+    /**
+     * @brief The reading that started the current interval, if any
+     */
+    std::optional<EnergyReading> previous;
+
+    /**
+     * @brief The energy accumulated in the partial record, in counts
+     */
+    uint64_t recordEnergy = 0;
+
+    /**
+     * @brief The power samples accumulated in the partial record
+     */
+    uint64_t recordSamples = 0;
+
+    /**
+     * @brief The number of intervals in the partial record
+     */
+    size_t recordIntervals = 0;
+
+    /**
+     * @brief The highest interval average power in the partial record, in
+     *        watts
+     */
+    double recordMaximum = 0.0;
+
+    /**
+     * @brief The average power records, newest first
+     */
+    DBusRecordList averageRecords;
+
+    /**
+     * @brief The maximum power records, newest first
+     */
+    DBusRecordList maximumRecords;
+};
+
+} // namespace phosphor::power::history
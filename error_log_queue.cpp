@@ -0,0 +1,151 @@
+/**
+ * Copyright © 2026 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "error_log_queue.hpp"
+
+#include "memfd_file.hpp"
+
+#include <systemd/sd-bus.h>
+
+#include <phosphor-logging/log.hpp>
+#include <xyz/openbmc_project/Logging/Create/server.hpp>
+
+#include <exception>
+#include <functional>
+#include <memory>
+#include <tuple>
+#include <utility>
+
+namespace phosphor::power::util
+{
+
+using namespace phosphor::logging;
+
+constexpr auto loggingService = "xyz.openbmc_project.Logging";
+constexpr auto loggingPath = "/xyz/openbmc_project/logging";
+constexpr auto loggingCreateInterface = "xyz.openbmc_project.Logging.Create";
+
+ErrorLogQueue::ErrorLogQueue(sdbusplus::bus::bus& bus,
+                             const sdeventplus::Event& event,
+                             std::size_t capacity) :
+    bus{bus}, capacity{capacity},
+    retryTimer{event, std::bind(&ErrorLogQueue::sendNext, this)}
+{}
+
+bool ErrorLogQueue::submit(const std::string& message, Level severity,
+                           std::map<std::string, std::string> additionalData,
+                           std::vector<uint8_t> ffdc)
+{
+    if (errors.size() >= capacity)
+    {
+        ++droppedCount;
+        log<level::ERR>("Error log queue is full, dropping error",
+                        entry("ERROR=%s", message.c_str()));
+        return false;
+    }
+
+    errors.push_back(QueuedError{message, severity, std::move(additionalData),
+                                 std::move(ffdc)});
+    sendNext();
+    return true;
+}
+
+void ErrorLogQueue::sendNext()
+{
+    // Only one error is sent at a time, so they are created in order
+    while (!errors.empty() && !call && !retryTimer.isEnabled())
+    {
+        try
+        {
+            send(errors.front());
+        }
+        catch (const std::exception& e)
+        {
+            failed(e.what());
+        }
+    }
+}
+
+void ErrorLogQueue::send(const QueuedError& error)
+{
+    using namespace sdbusplus::xyz::openbmc_project::Logging::server;
+
+    auto handler = [this](sdbusplus::message::message& reply) {
+        replyReceived(reply);
+    };
+
+    if (error.ffdc.empty())
+    {
+        auto method = bus.new_method_call(loggingService, loggingPath,
+                                          loggingCreateInterface, "Create");
+        method.append(error.message, error.severity, error.additionalData);
+        call = std::make_unique<AsyncCall>(bus, method, std::move(handler));
+        return;
+    }
+
+    // The message holds its own copy of the file descriptor, so the file can
+    // be closed once the call is sent.  It is created again for a retry.
+    MemFDFile file{"error_log_ffdc"};
+    file.write(error.ffdc);
+    file.seal();
+
+    std::vector<std::tuple<Create::FFDCFormat, uint8_t, uint8_t,
+                           sdbusplus::message::unix_fd>>
+        ffdc{{Create::FFDCFormat::Custom, 0, 0,
+              sdbusplus::message::unix_fd(file.getFileDescriptor())}};
+
+    auto method = bus.new_method_call(loggingService, loggingPath,
+                                      loggingCreateInterface,
+                                      "CreateWithFFDCFiles");
+    method.append(error.message, error.severity, error.additionalData, ffdc);
+    call = std::make_unique<AsyncCall>(bus, method, std::move(handler));
+}
+
+void ErrorLogQueue::replyReceived(sdbusplus::message::message& reply)
+{
+    // This runs in the handler of the call, so keep the call until the next
+    // reply
+    completedCall = std::move(call);
+
+    if (reply.is_method_error())
+    {
+        const sd_bus_error* error = sd_bus_message_get_error(reply.get());
+        failed((error && error->name) ? error->name : "Method error");
+    }
+    else
+    {
+        errors.pop_front();
+    }
+    sendNext();
+}
+
+void ErrorLogQueue::failed(const std::string& reason)
+{
+    QueuedError& error = errors.front();
+    if (++error.attempts < maxAttempts)
+    {
+        retryTimer.restartOnce(retryDelay);
+        return;
+    }
+
+    ++droppedCount;
+    log<level::ERR>("Unable to create error log",
+                    entry("ERROR=%s", error.message.c_str()),
+                    entry("REASON=%s", reason.c_str()),
+                    entry("ATTEMPTS=%u", error.attempts));
+    errors.pop_front();
+}
+
+} // namespace phosphor::power::util
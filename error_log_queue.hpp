@@ -0,0 +1,197 @@
+#pragma once
+
+#include "utility.hpp"
+
+#include <sdbusplus/bus.hpp>
+#include <sdbusplus/message.hpp>
+#include <sdeventplus/clock.hpp>
+#include <sdeventplus/event.hpp>
+#include <sdeventplus/utility/timer.hpp>
+#include <xyz/openbmc_project/Logging/Entry/server.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace phosphor::power::util
+{
+
+/**
+ * @class ErrorLogQueue
+ *
+ * Creates error logs without blocking the event loop.
+ *
+ * The errors are sent to the xyz.openbmc_project.Logging.Create interface
+ * one at a time, in the order they were submitted, using asynchronous method
+ * calls.  The event loop keeps detecting faults while phosphor-logging is
+ * busy committing the logs, such as during a fault storm.
+ *
+ * If an error cannot be created, it is sent again after a delay, up to
+ * maxAttempts times.  The queue holds at most capacity errors; errors
+ * submitted while it is full are journaled and dropped, so the errors that
+ * describe the first fault are kept.
+ */
+class ErrorLogQueue
+{
+  public:
+    using Level =
+        sdbusplus::xyz::openbmc_project::Logging::server::Entry::Level;
+
+    /**
+     * The default maximum number of queued errors.
+     */
+    static constexpr std::size_t defaultCapacity{64};
+
+    /**
+     * The number of times an error is sent before it is dropped.
+     */
+    static constexpr unsigned int maxAttempts{3};
+
+    /**
+     * The delay before an error is sent again.
+     */
+    static constexpr std::chrono::seconds retryDelay{1};
+
+    ErrorLogQueue() = delete;
+    ~ErrorLogQueue() = default;
+    ErrorLogQueue(const ErrorLogQueue&) = delete;
+    ErrorLogQueue& operator=(const ErrorLogQueue&) = delete;
+    ErrorLogQueue(ErrorLogQueue&&) = delete;
+    ErrorLogQueue& operator=(ErrorLogQueue&&) = delete;
+
+    /**
+     * Constructor
+     *
+     * @param[in] bus - the D-Bus object
+     * @param[in] event - the event loop attached to the bus
+     * @param[in] capacity - the maximum number of queued errors
+     */
+    ErrorLogQueue(sdbusplus::bus::bus& bus, const sdeventplus::Event& event,
+                  std::size_t capacity = defaultCapacity);
+
+    /**
+     * Queues an error log to be created.
+     *
+     * @param[in] message - the message registry entry, such as
+     *                      "xyz.openbmc_project.Power.Error.Shutdown"
+     * @param[in] severity - the severity of the error
+     * @param[in] additionalData - the AdditionalData of the error
+     * @param[in] ffdc - data stored in the error as a custom FFDC file; if
+     *                   empty, the error has no FFDC files
+     *
+     * @return bool - true if the error was queued, false if the queue is full
+     */
+    bool submit(const std::string& message, Level severity,
+                std::map<std::string, std::string> additionalData,
+                std::vector<uint8_t> ffdc = {});
+
+    /**
+     * Returns the number of errors that have not been created yet, including
+     * the one being sent.
+     *
+     * @return size_t - the number of errors
+     */
+    std::size_t size() const
+    {
+        return errors.size();
+    }
+
+    /**
+     * Returns the number of errors dropped because the queue was full or
+     * they could not be created.
+     *
+     * @return size_t - the number of errors
+     */
+    std::size_t getDroppedCount() const
+    {
+        return droppedCount;
+    }
+
+  private:
+    /**
+     * @struct QueuedError
+     *
+     * An error log that has not been created yet.
+     */
+    struct QueuedError
+    {
+        std::string message;
+        Level severity;
+        std::map<std::string, std::string> additionalData;
+        std::vector<uint8_t> ffdc;
+        unsigned int attempts{0};
+    };
+
+    /**
+     * Sends the error at the front of the queue, if there is one and no call
+     * or retry is pending.
+     */
+    void sendNext();
+
+    /**
+     * Starts the method call that creates the error.
+     *
+     * Throws an exception if the call cannot be sent.
+     *
+     * @param[in] error - the error
+     */
+    void send(const QueuedError& error);
+
+    /**
+     * Handles the reply to the method call for the error at the front of
+     * the queue.
+     *
+     * @param[in] reply - the method reply or error reply
+     */
+    void replyReceived(sdbusplus::message::message& reply);
+
+    /**
+     * Schedules the error at the front of the queue to be sent again, or
+     * drops it if it has been sent maxAttempts times.
+     *
+     * @param[in] reason - why the error could not be created
+     */
+    void failed(const std::string& reason);
+
+    /**
+     * The D-Bus object.
+     */
+    sdbusplus::bus::bus& bus;
+
+    /**
+     * The maximum number of queued errors.
+     */
+    std::size_t capacity;
+
+    /**
+     * The errors that have not been created yet, oldest first.
+     */
+    std::deque<QueuedError> errors{};
+
+    /**
+     * The number of errors dropped.
+     */
+    std::size_t droppedCount{0};
+
+    /**
+     * The pending method call for the error at the front of the queue.
+     */
+    AsyncCallPtr call{};
+
+    /**
+     * The call whose reply was handled last.  Kept until the next reply,
+     * since a call cannot be destroyed from within its own handler.
+     */
+    AsyncCallPtr completedCall{};
+
+    /**
+     * The timer to send an error again.
+     */
+    sdeventplus::utility::Timer<sdeventplus::ClockId::Monotonic> retryTimer;
+};
+
+} // namespace phosphor::power::util
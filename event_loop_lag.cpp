@@ -0,0 +1,104 @@
+/**
+ * Copyright © 2026 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "event_loop_lag.hpp"
+
+#include <algorithm>
+#include <bit>
+
+namespace phosphor::power::util
+{
+
+std::chrono::microseconds EventLoopLag::getBucketLimit(std::size_t bucket)
+{
+    if (bucket >= bucketCount - 1)
+    {
+        return std::chrono::microseconds::max();
+    }
+    return std::chrono::milliseconds{int64_t{1} << bucket};
+}
+
+std::optional<EventLoopLag::Blocker>
+    EventLoopLag::record(std::chrono::microseconds lag)
+{
+    lag = std::max(lag, std::chrono::microseconds{0});
+
+    // Bucket 0 is under 1 ms; bucket i is under 2^i ms
+    auto ms = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(lag).count());
+    std::size_t bucket = std::min<std::size_t>(std::bit_width(ms),
+                                               bucketCount - 1);
+    ++histogram[bucket];
+
+    ++count;
+    total += lag;
+    max = std::max(max, lag);
+
+    Blocker blocker{lag, longestHandler, longestHandlerDuration};
+    longestHandler = nullptr;
+    longestHandlerDuration = std::chrono::microseconds{0};
+
+    if (lag < blockThreshold)
+    {
+        return std::nullopt;
+    }
+    ++blockedCount;
+
+    if ((top.size() == topCount) && (lag <= top.back().lag))
+    {
+        return std::nullopt;
+    }
+    auto it = std::upper_bound(
+        top.begin(), top.end(), lag,
+        [](std::chrono::microseconds value, const Blocker& other) {
+            return value > other.lag;
+        });
+    top.insert(it, blocker);
+    if (top.size() > topCount)
+    {
+        top.pop_back();
+    }
+    return blocker;
+}
+
+void EventLoopLag::reset()
+{
+    histogram.fill(0);
+    top.clear();
+    count = 0;
+    blockedCount = 0;
+    total = std::chrono::microseconds{0};
+    max = std::chrono::microseconds{0};
+    longestHandler = nullptr;
+    longestHandlerDuration = std::chrono::microseconds{0};
+}
+
+std::string EventLoopLag::toString() const
+{
+    std::string text = "probes: " + std::to_string(count) +
+                       ", mean: " + std::to_string(getMean().count()) +
+                       " us, max: " + std::to_string(max.count()) +
+                       " us, blocked: " + std::to_string(blockedCount);
+    if (!top.empty())
+    {
+        const Blocker& longest = top.front();
+        text += ", longest: " + std::to_string(longest.lag.count()) +
+                " us in " +
+                ((longest.handler != nullptr) ? longest.handler : "unknown");
+    }
+    return text;
+}
+
+} // namespace phosphor::power::util
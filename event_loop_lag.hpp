@@ -0,0 +1,305 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace phosphor::power::util
+{
+
+/**
+ * @class EventLoopLag
+ *
+ * Statistics of how late an event loop dispatches its timers.
+ *
+ * The lag is recorded by a probe timer, see EventLoopLagMonitor.  Lags are
+ * counted in a histogram with power of two millisecond buckets.  The longest
+ * lags at or above the block threshold are kept with the handler that was
+ * blocking the event loop, so it is visible which handler to make
+ * asynchronous next.
+ *
+ * Handlers mark themselves with a Scope.  The probe cannot fire while a
+ * handler runs, so each lag is attributed to the longest handler that ran
+ * since the previous probe.
+ */
+class EventLoopLag
+{
+  public:
+    /**
+     * Number of histogram buckets.  Bucket 0 counts lags under 1 ms, bucket
+     * i counts lags from 2^(i-1) ms to under 2^i ms, and the last bucket
+     * counts all the longer lags.
+     */
+    static constexpr std::size_t bucketCount{16};
+
+    /**
+     * Number of longest blocking lags kept.
+     */
+    static constexpr std::size_t topCount{8};
+
+    /**
+     * The default lag at which the event loop is considered blocked.
+     */
+    static constexpr std::chrono::microseconds defaultBlockThreshold{10000};
+
+    /**
+     * @struct Blocker
+     *
+     * A lag at or above the block threshold.
+     */
+    struct Blocker
+    {
+        /**
+         * How late the probe fired.
+         */
+        std::chrono::microseconds lag{0};
+
+        /**
+         * The longest handler that ran before the probe, or nullptr if no
+         * handler was marked with a Scope.
+         */
+        const char* handler{nullptr};
+
+        /**
+         * How long that handler ran.
+         */
+        std::chrono::microseconds handlerDuration{0};
+    };
+
+    /**
+     * @class Scope
+     *
+     * Marks an event loop handler while it runs.  Create one at the start of
+     * the handler.
+     */
+    class Scope
+    {
+      public:
+        Scope() = delete;
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+        Scope(Scope&&) = delete;
+        Scope& operator=(Scope&&) = delete;
+
+        /**
+         * Constructor
+         *
+         * @param[in] lag - the statistics of the event loop
+         * @param[in] handler - the handler name; must be a string literal,
+         *                      since only the pointer is kept
+         */
+        Scope(EventLoopLag& lag, const char* handler) :
+            lag{lag}, handler{handler},
+            start{std::chrono::steady_clock::now()}
+        {}
+
+        /**
+         * Destructor.  Records how long the handler ran.
+         */
+        ~Scope()
+        {
+            using std::chrono::microseconds;
+            auto duration = std::chrono::steady_clock::now() - start;
+            lag.handlerDone(handler,
+                            std::chrono::duration_cast<microseconds>(duration));
+        }
+
+      private:
+        EventLoopLag& lag;
+        const char* handler;
+        std::chrono::steady_clock::time_point start;
+    };
+
+    EventLoopLag(const EventLoopLag&) = delete;
+    EventLoopLag& operator=(const EventLoopLag&) = delete;
+    EventLoopLag(EventLoopLag&&) = delete;
+    EventLoopLag& operator=(EventLoopLag&&) = delete;
+    ~EventLoopLag() = default;
+
+    /**
+     * Constructor
+     *
+     * @param[in] blockThreshold - the lag at which the event loop is
+     *                             considered blocked
+     */
+    explicit EventLoopLag(
+        std::chrono::microseconds blockThreshold = defaultBlockThreshold) :
+        blockThreshold{blockThreshold}
+    {}
+
+    /**
+     * Returns the upper limit of a histogram bucket.
+     *
+     * @param[in] bucket - the bucket index
+     *
+     * @return microseconds - the lags in the bucket are below this limit;
+     *                        the maximum duration for the last bucket
+     */
+    static std::chrono::microseconds getBucketLimit(std::size_t bucket);
+
+    /**
+     * Returns the lag at which the event loop is considered blocked.
+     *
+     * @return microseconds - the threshold
+     */
+    std::chrono::microseconds getBlockThreshold() const
+    {
+        return blockThreshold;
+    }
+
+    /**
+     * Returns the number of lags at or above the block threshold.
+     *
+     * @return uint64_t - the number of blocked probes
+     */
+    uint64_t getBlockedCount() const
+    {
+        return blockedCount;
+    }
+
+    /**
+     * Returns the number of lags recorded.
+     *
+     * @return uint64_t - the number of probes
+     */
+    uint64_t getCount() const
+    {
+        return count;
+    }
+
+    /**
+     * Returns the histogram of the lags.  See bucketCount.
+     *
+     * @return the number of lags in each bucket
+     */
+    const std::array<uint64_t, bucketCount>& getHistogram() const
+    {
+        return histogram;
+    }
+
+    /**
+     * Returns the longest lag.
+     *
+     * @return microseconds - the lag, or 0 if no lags were recorded
+     */
+    std::chrono::microseconds getMax() const
+    {
+        return max;
+    }
+
+    /**
+     * Returns the mean lag.
+     *
+     * @return microseconds - the lag, or 0 if no lags were recorded
+     */
+    std::chrono::microseconds getMean() const
+    {
+        if (count == 0)
+        {
+            return std::chrono::microseconds{0};
+        }
+        return total / static_cast<int64_t>(count);
+    }
+
+    /**
+     * Returns the longest lags at or above the block threshold.
+     *
+     * @return the lags, longest first; at most topCount
+     */
+    const std::vector<Blocker>& getTop() const
+    {
+        return top;
+    }
+
+    /**
+     * Records how late a probe fired.
+     *
+     * The lag is attributed to the longest handler that ran since the
+     * previous probe.
+     *
+     * @param[in] lag - the lag
+     *
+     * @return the blocker if the lag is one of the longest blocking lags, so
+     *         the owner can log it, otherwise no value
+     */
+    std::optional<Blocker> record(std::chrono::microseconds lag);
+
+    /**
+     * Discards the recorded lags.  The block threshold is kept.
+     */
+    void reset();
+
+    /**
+     * Returns the statistics as one line of text.
+     *
+     * @return string - the statistics
+     */
+    std::string toString() const;
+
+  private:
+    /**
+     * Records that a handler finished.
+     *
+     * @param[in] handler - the handler name
+     * @param[in] duration - how long it ran
+     */
+    void handlerDone(const char* handler, std::chrono::microseconds duration)
+    {
+        if (duration >= longestHandlerDuration)
+        {
+            longestHandler = handler;
+            longestHandlerDuration = duration;
+        }
+    }
+
+    /**
+     * The lag at which the event loop is considered blocked.
+     */
+    std::chrono::microseconds blockThreshold;
+
+    /**
+     * The number of lags in each bucket.
+     */
+    std::array<uint64_t, bucketCount> histogram{};
+
+    /**
+     * The longest blocking lags, longest first.
+     */
+    std::vector<Blocker> top{};
+
+    /**
+     * The number of lags recorded.
+     */
+    uint64_t count{0};
+
+    /**
+     * The number of lags at or above the block threshold.
+     */
+    uint64_t blockedCount{0};
+
+    /**
+     * The sum of the lags.
+     */
+    std::chrono::microseconds total{0};
+
+    /**
+     * The longest lag.
+     */
+    std::chrono::microseconds max{0};
+
+    /**
+     * The longest handler that ran since the previous probe.
+     */
+    const char* longestHandler{nullptr};
+
+    /**
+     * How long that handler ran.
+     */
+    std::chrono::microseconds longestHandlerDuration{0};
+};
+
+} // namespace phosphor::power::util
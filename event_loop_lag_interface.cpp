@@ -0,0 +1,219 @@
+/**
+ * Copyright © 2026 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "event_loop_lag_interface.hpp"
+
+#include <phosphor-logging/log.hpp>
+#include <sdbusplus/exception.hpp>
+#include <sdbusplus/server.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace phosphor::power::util
+{
+
+/**
+ * Converts a duration to microseconds for a D-Bus reply.
+ */
+static uint64_t toMicroseconds(std::chrono::microseconds time)
+{
+    return static_cast<uint64_t>(time.count());
+}
+
+EventLoopLagInterface::EventLoopLagInterface(sdbusplus::bus::bus& bus,
+                                             const char* path,
+                                             EventLoopLag& lag) :
+    lag{lag},
+    _serverInterface(bus, path, interface, _vtable, this)
+{}
+
+int EventLoopLagInterface::callbackGetBlockers(sd_bus_message* msg,
+                                               void* context,
+                                               sd_bus_error* error)
+{
+    if (msg != nullptr && context != nullptr)
+    {
+        try
+        {
+            auto m = sdbusplus::message::message(msg);
+
+            auto obj = static_cast<EventLoopLagInterface*>(context);
+            std::vector<std::tuple<uint64_t, uint64_t, std::string>> blockers;
+            for (const EventLoopLag::Blocker& blocker : obj->lag.getTop())
+            {
+                blockers.emplace_back(
+                    toMicroseconds(blocker.lag),
+                    toMicroseconds(blocker.handlerDuration),
+                    (blocker.handler != nullptr) ? blocker.handler : "unknown");
+            }
+
+            auto reply = m.new_method_return();
+            reply.append(blockers);
+
+            reply.method_return();
+        }
+        catch (const sdbusplus::exception_t& e)
+        {
+            return sd_bus_error_set(error, e.name(), e.description());
+        }
+    }
+    else
+    {
+        // The message or context were null
+        using namespace phosphor::logging;
+        log<level::ERR>("Unable to service GetBlockers method callback");
+        return -1;
+    }
+
+    return 1;
+}
+
+int EventLoopLagInterface::callbackGetHistogram(sd_bus_message* msg,
+                                                void* context,
+                                                sd_bus_error* error)
+{
+    if (msg != nullptr && context != nullptr)
+    {
+        try
+        {
+            auto m = sdbusplus::message::message(msg);
+
+            auto obj = static_cast<EventLoopLagInterface*>(context);
+            const auto& histogram = obj->lag.getHistogram();
+            std::vector<std::tuple<uint64_t, uint64_t>> buckets;
+            for (std::size_t i = 0; i < histogram.size(); ++i)
+            {
+                buckets.emplace_back(
+                    toMicroseconds(EventLoopLag::getBucketLimit(i)),
+                    histogram[i]);
+            }
+
+            auto reply = m.new_method_return();
+            reply.append(buckets);
+
+            reply.method_return();
+        }
+        catch (const sdbusplus::exception_t& e)
+        {
+            return sd_bus_error_set(error, e.name(), e.description());
+        }
+    }
+    else
+    {
+        // The message or context were null
+        using namespace phosphor::logging;
+        log<level::ERR>("Unable to service GetHistogram method callback");
+        return -1;
+    }
+
+    return 1;
+}
+
+int EventLoopLagInterface::callbackGetStatistics(sd_bus_message* msg,
+                                                 void* context,
+                                                 sd_bus_error* error)
+{
+    if (msg != nullptr && context != nullptr)
+    {
+        try
+        {
+            auto m = sdbusplus::message::message(msg);
+
+            auto obj = static_cast<EventLoopLagInterface*>(context);
+            const EventLoopLag& lag = obj->lag;
+            std::map<std::string, uint64_t> values{
+                {"BlockThresholdUs", toMicroseconds(lag.getBlockThreshold())},
+                {"Blocked", lag.getBlockedCount()},
+                {"Count", lag.getCount()},
+                {"MaxUs", toMicroseconds(lag.getMax())},
+                {"MeanUs", toMicroseconds(lag.getMean())}};
+
+            auto reply = m.new_method_return();
+            reply.append(values);
+
+            reply.method_return();
+        }
+        catch (const sdbusplus::exception_t& e)
+        {
+            return sd_bus_error_set(error, e.name(), e.description());
+        }
+    }
+    else
+    {
+        // The message or context were null
+        using namespace phosphor::logging;
+        log<level::ERR>("Unable to service GetStatistics method callback");
+        return -1;
+    }
+
+    return 1;
+}
+
+int EventLoopLagInterface::callbackReset(sd_bus_message* msg, void* context,
+                                         sd_bus_error* error)
+{
+    if (msg != nullptr && context != nullptr)
+    {
+        try
+        {
+            auto m = sdbusplus::message::message(msg);
+
+            auto obj = static_cast<EventLoopLagInterface*>(context);
+            obj->lag.reset();
+
+            auto reply = m.new_method_return();
+
+            reply.method_return();
+        }
+        catch (const sdbusplus::exception_t& e)
+        {
+            return sd_bus_error_set(error, e.name(), e.description());
+        }
+    }
+    else
+    {
+        // The message or context were null
+        using namespace phosphor::logging;
+        log<level::ERR>("Unable to service Reset method callback");
+        return -1;
+    }
+
+    return 1;
+}
+
+const sdbusplus::vtable::vtable_t EventLoopLagInterface::_vtable[] = {
+    sdbusplus::vtable::start(),
+    // No GetBlockers method parameters and returns an array of the lag, the
+    // handler duration, and the handler name
+    sdbusplus::vtable::method("GetBlockers", "", "a(tts)",
+                              callbackGetBlockers),
+    // No GetHistogram method parameters and returns an array of the bucket
+    // limits and counts
+    sdbusplus::vtable::method("GetHistogram", "", "a(tt)",
+                              callbackGetHistogram),
+    // No GetStatistics method parameters and returns a dictionary of
+    // statistic names and values
+    sdbusplus::vtable::method("GetStatistics", "", "a{st}",
+                              callbackGetStatistics),
+    // No Reset method parameters and returns void
+    sdbusplus::vtable::method("Reset", "", "", callbackReset),
+    sdbusplus::vtable::end()};
+
+} // namespace phosphor::power::util
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "event_loop_lag.hpp"
+
+#include <systemd/sd-bus.h>
+
+#include <sdbusplus/bus.hpp>
+#include <sdbusplus/sdbus.hpp>
+#include <sdbusplus/server/interface.hpp>
+#include <sdbusplus/vtable.hpp>
+
+namespace phosphor::power::util
+{
+
+/**
+ * @class EventLoopLagInterface
+ *
+ * Debug D-Bus interface that shows the EventLoopLag of a daemon.
+ *
+ * Methods:
+ * - GetStatistics: returns a dictionary of the statistics, with durations in
+ *   microseconds
+ * - GetHistogram: returns the upper limit in microseconds and the number of
+ *   lags of each histogram bucket
+ * - GetBlockers: returns the longest blocking lags, longest first, as the
+ *   lag and the handler duration in microseconds and the handler name
+ * - Reset: discards the recorded lags
+ */
+class EventLoopLagInterface
+{
+  public:
+    EventLoopLagInterface() = delete;
+    EventLoopLagInterface(const EventLoopLagInterface&) = delete;
+    EventLoopLagInterface& operator=(const EventLoopLagInterface&) = delete;
+    EventLoopLagInterface(EventLoopLagInterface&&) = delete;
+    EventLoopLagInterface& operator=(EventLoopLagInterface&&) = delete;
+    ~EventLoopLagInterface() = default;
+
+    /**
+     * @brief Constructor to put the interface onto the bus at a path.
+     *
+     * @param[in] bus - Bus to attach to.
+     * @param[in] path - Path to attach at.
+     * @param[in] lag - Statistics to show.  Must outlive this object.
+     */
+    EventLoopLagInterface(sdbusplus::bus::bus& bus, const char* path,
+                          EventLoopLag& lag);
+
+    /**
+     * @brief This dbus interface's name
+     */
+    static constexpr auto interface =
+        "xyz.openbmc_project.Power.Debug.EventLoopLag";
+
+  private:
+    /**
+     * @brief Systemd bus callback for the GetBlockers method
+     */
+    static int callbackGetBlockers(sd_bus_message* msg, void* context,
+                                   sd_bus_error* error);
+
+    /**
+     * @brief Systemd bus callback for the GetHistogram method
+     */
+    static int callbackGetHistogram(sd_bus_message* msg, void* context,
+                                    sd_bus_error* error);
+
+    /**
+     * @brief Systemd bus callback for the GetStatistics method
+     */
+    static int callbackGetStatistics(sd_bus_message* msg, void* context,
+                                     sd_bus_error* error);
+
+    /**
+     * @brief Systemd bus callback for the Reset method
+     */
+    static int callbackReset(sd_bus_message* msg, void* context,
+                             sd_bus_error* error);
+
+    /**
+     * @brief Systemd vtable structure that contains all the
+     * methods of this interface with their respective systemd attributes
+     */
+    static const sdbusplus::vtable::vtable_t _vtable[];
+
+    /**
+     * @brief The statistics shown by this interface
+     */
+    EventLoopLag& lag;
+
+    /**
+     * @brief Holder for the instance of this interface to be
+     * on dbus
+     */
+    sdbusplus::server::interface::interface _serverInterface;
+};
+
+} // namespace phosphor::power::util
@@ -0,0 +1,63 @@
+/**
+ * Copyright © 2026 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "event_loop_lag_monitor.hpp"
+
+#include <phosphor-logging/log.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <optional>
+
+namespace phosphor::power::util
+{
+
+using namespace phosphor::logging;
+
+EventLoopLagMonitor::EventLoopLagMonitor(
+    const sdeventplus::Event& event, std::chrono::milliseconds interval,
+    std::chrono::microseconds blockThreshold) :
+    interval{interval},
+    due{std::chrono::steady_clock::now() + interval}, lag{blockThreshold},
+    // Wake at the due time instead of coalescing with other timers, so the
+    // lag is not hidden by the timer accuracy
+    timer{event, std::bind(&EventLoopLagMonitor::expired, this),
+          std::nullopt, std::chrono::microseconds{1}}
+{
+    timer.restartOnce(interval);
+}
+
+void EventLoopLagMonitor::expired()
+{
+    auto now = std::chrono::steady_clock::now();
+    auto late =
+        std::chrono::duration_cast<std::chrono::microseconds>(now - due);
+    std::optional<EventLoopLag::Blocker> blocker = lag.record(late);
+    if (blocker)
+    {
+        log<level::WARNING>(
+            "Event loop was blocked",
+            entry("LAG_US=%lld", static_cast<long long>(late.count())),
+            entry("HANDLER=%s",
+                  (blocker->handler != nullptr) ? blocker->handler : "unknown"),
+            entry("HANDLER_US=%lld",
+                  static_cast<long long>(blocker->handlerDuration.count())));
+    }
+
+    due = now + interval;
+    timer.restartOnce(interval);
+}
+
+} // namespace phosphor::power::util
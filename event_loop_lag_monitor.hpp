@@ -0,0 +1,104 @@
+#pragma once
+
+#include "event_loop_lag.hpp"
+
+#include <sdeventplus/clock.hpp>
+#include <sdeventplus/event.hpp>
+#include <sdeventplus/utility/timer.hpp>
+
+#include <chrono>
+
+namespace phosphor::power::util
+{
+
+/**
+ * @class EventLoopLagMonitor
+ *
+ * Measures how late an event loop dispatches a high frequency probe timer.
+ *
+ * The timer is restarted each time it fires, and the time from when it was
+ * due until it fired is recorded in an EventLoopLag.  A lag means that a
+ * handler, such as one making a synchronous D-Bus call, blocked the event
+ * loop.  A journal warning is logged for each lag that is one of the
+ * longest blocking lags, with the handler that was running.
+ */
+class EventLoopLagMonitor
+{
+  public:
+    /**
+     * The default time between probes.
+     */
+    static constexpr std::chrono::milliseconds defaultInterval{10};
+
+    EventLoopLagMonitor() = delete;
+    EventLoopLagMonitor(const EventLoopLagMonitor&) = delete;
+    EventLoopLagMonitor& operator=(const EventLoopLagMonitor&) = delete;
+    EventLoopLagMonitor(EventLoopLagMonitor&&) = delete;
+    EventLoopLagMonitor& operator=(EventLoopLagMonitor&&) = delete;
+    ~EventLoopLagMonitor() = default;
+
+    /**
+     * Constructor.  Starts the probe timer.
+     *
+     * @param[in] event - the event loop
+     * @param[in] interval - the time between probes
+     * @param[in] blockThreshold - the lag at which the event loop is
+     *                             considered blocked
+     */
+    explicit EventLoopLagMonitor(
+        const sdeventplus::Event& event,
+        std::chrono::milliseconds interval = defaultInterval,
+        std::chrono::microseconds blockThreshold =
+            EventLoopLag::defaultBlockThreshold);
+
+    /**
+     * Returns the time between probes.
+     *
+     * @return milliseconds - the interval
+     */
+    std::chrono::milliseconds getInterval() const
+    {
+        return interval;
+    }
+
+    /**
+     * Returns the lag statistics.  Handlers mark themselves with an
+     * EventLoopLag::Scope on them.
+     *
+     * @return EventLoopLag& - the statistics
+     */
+    EventLoopLag& getLag()
+    {
+        return lag;
+    }
+
+  private:
+    /**
+     * Records the lag of the probe and restarts the timer.
+     *
+     * Runs in the timer callback.
+     */
+    void expired();
+
+    /**
+     * The time between probes.
+     */
+    std::chrono::milliseconds interval;
+
+    /**
+     * When the probe is due.
+     */
+    std::chrono::steady_clock::time_point due;
+
+    /**
+     * The lag statistics.
+     */
+    EventLoopLag lag;
+
+    /**
+     * The probe timer.
+     */
+    sdeventplus::utility::Timer<sdeventplus::ClockId::Monotonic> timer;
+};
+
+} // namespace phosphor::power::util
@@ -16,14 +16,18 @@
 #include "gpio.hpp"
 
 #include <fcntl.h>
+#include <sys/epoll.h>
 #include <sys/ioctl.h>
+#include <unistd.h>
 
 #include <phosphor-logging/elog-errors.hpp>
 #include <phosphor-logging/elog.hpp>
 #include <phosphor-logging/log.hpp>
 #include <xyz/openbmc_project/Common/error.hpp>
 
+#include <algorithm>
 #include <cassert>
+#include <cstring>
 
 namespace phosphor
 {
@@ -35,24 +39,125 @@ using namespace phosphor::logging;
 using InternalFailure =
     sdbusplus::xyz::openbmc_project::Common::Error::InternalFailure;
 
-Value GPIO::read()
+/**
+ * Opens a GPIO device
+ *
+ * @param[in] device - the GPIO device file
+ *
+ * @return FileDescriptor - the open device
+ */
+static power::util::FileDescriptor openDevice(const std::string& device)
 {
-    assert(direction == Direction::input);
+    power::util::FileDescriptor fd{open(device.c_str(), 0)};
+    if (fd() == -1)
+    {
+        auto e = errno;
+        log<level::ERR>("Failed opening GPIO device",
+                        entry("DEVICE=%s", device.c_str()),
+                        entry("ERRNO=%d", e));
+        elog<InternalFailure>();
+    }
+    return fd;
+}
 
-    requestLine();
+/**
+ * Requests GPIO lines from a GPIO device with one line request
+ *
+ * @param[in] device - the GPIO device file
+ * @param[in] gpios - the GPIO numbers, at most GPIO_V2_LINES_MAX
+ * @param[in] flags - the GPIO_V2_LINE_FLAG_* flags of the lines
+ * @param[in] outputValue - the initial value of output lines
+ * @param[in] debounce - the debounce period, or zero for none
+ *
+ * @return FileDescriptor - the line request, used for the values
+ *                          and events of the lines
+ */
+static power::util::FileDescriptor
+    requestLines(const std::string& device, std::span<const gpioNum_t> gpios,
+                 uint64_t flags, Value outputValue = Value::low,
+                 std::chrono::microseconds debounce = {})
+{
+    assert(!gpios.empty() && (gpios.size() <= GPIO_V2_LINES_MAX));
+
+    auto fd = openDevice(device);
+
+    // Make an ioctl call to request the GPIO lines, which will
+    // return the descriptor to use to access them.
+    gpio_v2_line_request request{};
+    strncpy(request.consumer, "phosphor-power", sizeof(request.consumer));
+    std::copy(gpios.begin(), gpios.end(), request.offsets);
+    request.num_lines = gpios.size();
+    request.config.flags = flags;
+
+    uint64_t allLines = (gpios.size() == GPIO_V2_LINES_MAX)
+                            ? ~uint64_t{0}
+                            : ((uint64_t{1} << gpios.size()) - 1);
+
+    if (flags & GPIO_V2_LINE_FLAG_OUTPUT)
+    {
+        auto& attr = request.config.attrs[request.config.num_attrs++];
+        attr.attr.id = GPIO_V2_LINE_ATTR_ID_OUTPUT_VALUES;
+        attr.attr.values = (outputValue == Value::high) ? allLines : 0;
+        attr.mask = allLines;
+    }
 
-    gpiohandle_data data{};
+    if (debounce.count() > 0)
+    {
+        auto& attr = request.config.attrs[request.config.num_attrs++];
+        attr.attr.id = GPIO_V2_LINE_ATTR_ID_DEBOUNCE;
+        attr.attr.debounce_period_us = debounce.count();
+        attr.mask = allLines;
+    }
+
+    auto rc = ioctl(fd(), GPIO_V2_GET_LINE_IOCTL, &request);
+    if (rc == -1)
+    {
+        auto e = errno;
+        log<level::ERR>("Failed GPIO_V2_GET_LINE ioctl",
+                        entry("GPIO=%d", gpios.front()),
+                        entry("NUM_GPIOS=%zu", gpios.size()),
+                        entry("ERRNO=%d", e));
+        elog<InternalFailure>();
+    }
+
+    return power::util::FileDescriptor{request.fd};
+}
 
-    auto rc = ioctl(lineFD(), GPIOHANDLE_GET_LINE_VALUES_IOCTL, &data);
+/**
+ * Reads the values of requested GPIO lines
+ *
+ * @param[in] fd - the line request descriptor
+ * @param[in] numLines - the number of lines in the request
+ *
+ * @return uint64_t - the values, one bit per line in the order
+ *                    they were requested
+ */
+static uint64_t readLines(int fd, size_t numLines)
+{
+    gpio_v2_line_values data{};
+    data.mask = (numLines == GPIO_V2_LINES_MAX)
+                    ? ~uint64_t{0}
+                    : ((uint64_t{1} << numLines) - 1);
 
+    auto rc = ioctl(fd, GPIO_V2_LINE_GET_VALUES_IOCTL, &data);
     if (rc < 0)
     {
         auto e = errno;
-        log<level::ERR>("Failed GET_LINE_VALUES ioctl", entry("ERRNO=%d", e));
+        log<level::ERR>("Failed GPIO_V2_LINE_GET_VALUES ioctl",
+                        entry("ERRNO=%d", e));
         elog<InternalFailure>();
     }
 
-    return (data.values[0] == 0) ? Value::low : Value::high;
+    return data.bits;
+}
+
+Value GPIO::read()
+{
+    assert(direction == Direction::input);
+
+    requestLine();
+
+    return (readLines(lineFD(), 1) & 1) ? Value::high : Value::low;
 }
 
 void GPIO::set(Value value)
@@ -61,14 +166,16 @@ void GPIO::set(Value value)
 
     requestLine(value);
 
-    gpiohandle_data data{};
-    data.values[0] = static_cast<gpioValue_t>(value);
+    gpio_v2_line_values data{};
+    data.bits = (value == Value::high) ? 1 : 0;
+    data.mask = 1;
 
-    auto rc = ioctl(lineFD(), GPIOHANDLE_SET_LINE_VALUES_IOCTL, &data);
+    auto rc = ioctl(lineFD(), GPIO_V2_LINE_SET_VALUES_IOCTL, &data);
     if (rc == -1)
     {
         auto e = errno;
-        log<level::ERR>("Failed SET_LINE_VALUES ioctl", entry("ERRNO=%d", e));
+        log<level::ERR>("Failed GPIO_V2_LINE_SET_VALUES ioctl",
+                        entry("ERRNO=%d", e));
         elog<InternalFailure>();
     }
 }
@@ -81,43 +188,143 @@ void GPIO::requestLine(Value defaultValue)
         return;
     }
 
-    power::util::FileDescriptor fd{open(device.c_str(), 0)};
-    if (fd() == -1)
+    uint64_t flags = (direction == Direction::input) ? GPIO_V2_LINE_FLAG_INPUT
+                                                     : GPIO_V2_LINE_FLAG_OUTPUT;
+
+    lineFD = requestLines(device, {&gpio, 1}, flags, defaultValue);
+}
+
+int GPIO::requestEvents(std::chrono::microseconds debounce, EventClock clock)
+{
+    assert(direction == Direction::input);
+
+    // Only need to do this once
+    if (eventsRequested)
+    {
+        return lineFD();
+    }
+
+    // The line can only be requested once, so release the line
+    // request if the GPIO was already read.  The new request is
+    // also used to read the value.
+    lineFD.close();
+
+    uint64_t flags = GPIO_V2_LINE_FLAG_INPUT | GPIO_V2_LINE_FLAG_EDGE_RISING |
+                     GPIO_V2_LINE_FLAG_EDGE_FALLING;
+    if (clock == EventClock::realtime)
+    {
+        flags |= GPIO_V2_LINE_FLAG_EVENT_CLOCK_REALTIME;
+    }
+    else if (clock == EventClock::hardware)
+    {
+        flags |= GPIO_V2_LINE_FLAG_EVENT_CLOCK_HTE;
+    }
+
+    lineFD = requestLines(device, {&gpio, 1}, flags, Value::low, debounce);
+    eventsRequested = true;
+    return lineFD();
+}
+
+Event GPIO::readEvent()
+{
+    Event event{};
+    readEvents({&event, 1});
+    return event;
+}
+
+size_t GPIO::readEvents(std::span<Event> events)
+{
+    assert(eventsRequested);
+
+    // The kernel returns as many of the pending events as fit
+    gpio_v2_line_event data[maxEventsPerRead]{};
+    size_t count = std::min(events.size(), maxEventsPerRead);
+
+    auto rc = ::read(lineFD(), data, count * sizeof(data[0]));
+    if ((rc <= 0) || ((rc % sizeof(data[0])) != 0))
     {
         auto e = errno;
-        log<level::ERR>("Failed opening GPIO device",
-                        entry("DEVICE=%s", device.c_str()),
+        log<level::ERR>("Failed reading GPIO event", entry("GPIO=%d", gpio),
                         entry("ERRNO=%d", e));
         elog<InternalFailure>();
     }
 
-    // Make an ioctl call to request the GPIO line, which will
-    // return the descriptor to use to access it.
-    gpiohandle_request request{};
-    strncpy(request.consumer_label, "phosphor-power",
-            sizeof(request.consumer_label));
+    count = rc / sizeof(data[0]);
+    for (size_t i = 0; i < count; i++)
+    {
+        events[i].edge = (data[i].id == GPIO_V2_LINE_EVENT_RISING_EDGE)
+                             ? Edge::rising
+                             : Edge::falling;
+        events[i].timestamp = std::chrono::nanoseconds(data[i].timestamp_ns);
+        events[i].sequence = data[i].line_seqno;
+    }
 
-    request.flags = (direction == Direction::input) ? GPIOHANDLE_REQUEST_INPUT
-                                                    : GPIOHANDLE_REQUEST_OUTPUT;
+    return count;
+}
+
+std::vector<Value> GPIOGroup::read()
+{
+    requestLines();
+
+    auto bits = readLines(lineFD(), gpios.size());
 
-    request.lineoffsets[0] = gpio;
-    request.lines = 1;
+    std::vector<Value> values;
+    values.reserve(gpios.size());
 
-    if (direction == Direction::output)
+    for (size_t i = 0; i < gpios.size(); i++)
     {
-        request.default_values[0] = static_cast<gpioValue_t>(defaultValue);
+        values.push_back(((bits >> i) & 1) ? Value::high : Value::low);
     }
 
-    auto rc = ioctl(fd(), GPIO_GET_LINEHANDLE_IOCTL, &request);
-    if (rc == -1)
+    return values;
+}
+
+void GPIOGroup::requestLines()
+{
+    // Only need to do this once
+    if (lineFD)
     {
-        auto e = errno;
-        log<level::ERR>("Failed GET_LINEHANDLE ioctl", entry("GPIO=%d", gpio),
-                        entry("ERRNO=%d", e));
+        return;
+    }
+
+    if (gpios.empty() || (gpios.size() > GPIO_V2_LINES_MAX))
+    {
+        log<level::ERR>("Invalid number of GPIOs in group",
+                        entry("NUM_GPIOS=%zu", gpios.size()));
         elog<InternalFailure>();
     }
 
-    lineFD.set(request.fd);
+    lineFD = gpio::requestLines(device, gpios, GPIO_V2_LINE_FLAG_INPUT);
+}
+
+GPIOEventSource::GPIOEventSource(const sdeventplus::Event& event,
+                                 const std::string& device, gpioNum_t gpio,
+                                 Callback callback,
+                                 std::chrono::microseconds debounce,
+                                 EventClock clock) :
+    gpio{device, gpio, Direction::input},
+    callback{std::move(callback)}
+{
+    int fd = this->gpio.requestEvents(debounce, clock);
+    source = std::make_unique<sdeventplus::source::IO>(
+        event, fd, EPOLLIN,
+        [this](sdeventplus::source::IO&, int, uint32_t) { eventsReady(); });
+}
+
+Value GPIOEventSource::read()
+{
+    return gpio.read();
+}
+
+void GPIOEventSource::eventsReady()
+{
+    // Any events left over make the descriptor readable again
+    Event events[GPIO::maxEventsPerRead]{};
+    auto count = gpio.readEvents(events);
+    for (size_t i = 0; i < count; i++)
+    {
+        callback(events[i]);
+    }
 }
 
 } // namespace gpio
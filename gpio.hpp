@@ -4,8 +4,18 @@
 
 #include <linux/gpio.h>
 
+#include <sdeventplus/event.hpp>
+#include <sdeventplus/source/io.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <span>
 #include <string>
 #include <type_traits>
+#include <vector>
 
 namespace phosphor
 {
@@ -13,10 +23,7 @@ namespace gpio
 {
 
 typedef std::remove_reference<
-    decltype(gpiohandle_request::lineoffsets[0])>::type gpioNum_t;
-
-typedef std::remove_reference<decltype(gpiohandle_data::values[0])>::type
-    gpioValue_t;
+    decltype(gpio_v2_line_request::offsets[0])>::type gpioNum_t;
 
 /**
  * If the GPIO is an input or output
@@ -36,12 +43,53 @@ enum class Value
     high
 };
 
+/**
+ * The edge of a GPIO event
+ */
+enum class Edge
+{
+    rising,
+    falling
+};
+
+/**
+ * The clock the kernel timestamps GPIO events with
+ */
+enum class EventClock
+{
+    monotonic,
+    realtime,
+    hardware
+};
+
+/**
+ * A GPIO edge event
+ */
+struct Event
+{
+    /**
+     * The edge that was detected
+     */
+    Edge edge;
+
+    /**
+     * The time the kernel saw the edge, on the clock the events
+     * were requested with
+     */
+    std::chrono::nanoseconds timestamp;
+
+    /**
+     * The sequence number of the event on the line, which has
+     * gaps if the kernel dropped events
+     */
+    uint32_t sequence;
+};
+
 /**
  * Represents a GPIO.
  *
- * Currently supports reading a GPIO.
- *
- * Write support may be added in the future.
+ * Supports reading, writing, and edge events, using the
+ * GPIO character device v2 line request interface.
  */
 class GPIO
 {
@@ -53,6 +101,11 @@ class GPIO
     GPIO& operator=(GPIO&&) = default;
     ~GPIO() = default;
 
+    /**
+     * The most events read by one readEvents() system call
+     */
+    static constexpr size_t maxEventsPerRead = 16;
+
     /**
      * Constructor
      *
@@ -82,6 +135,45 @@ class GPIO
      */
     void set(Value value);
 
+    /**
+     * Requests edge events for an input GPIO
+     *
+     * The GPIO can still be read after events are requested.
+     *
+     * @param[in] debounce - the debounce period, or zero for none.
+     *                       Edges are only reported once the line
+     *                       has been stable for this long.
+     * @param[in] clock - the clock the events are timestamped with
+     *
+     * @return int - a file descriptor that is readable while
+     *               an event is pending
+     */
+    int requestEvents(std::chrono::microseconds debounce = {},
+                      EventClock clock = EventClock::monotonic);
+
+    /**
+     * Reads one pending edge event
+     *
+     * Only valid after requestEvents() was called.  Blocks if
+     * no event is pending.
+     *
+     * @return Event - the event
+     */
+    Event readEvent();
+
+    /**
+     * Reads the pending edge events, up to the size of the span,
+     * with one system call
+     *
+     * Only valid after requestEvents() was called.  Blocks if
+     * no event is pending.
+     *
+     * @param[out] events - the events read
+     *
+     * @return size_t - the number of events read
+     */
+    size_t readEvents(std::span<Event> events);
+
   private:
     /**
      * Requests a GPIO line from the GPIO device
@@ -110,6 +202,138 @@ class GPIO
      * File descriptor for the GPIO line
      */
     power::util::FileDescriptor lineFD;
+
+    /**
+     * If lineFD was requested for edge events
+     */
+    bool eventsRequested = false;
+};
+
+/**
+ * Represents a group of input GPIOs on the same GPIO device.
+ *
+ * All of the lines are requested with one handle, so they
+ * can be read together with a single ioctl.
+ */
+class GPIOGroup
+{
+  public:
+    GPIOGroup() = delete;
+    GPIOGroup(const GPIOGroup&) = delete;
+    GPIOGroup(GPIOGroup&&) = default;
+    GPIOGroup& operator=(const GPIOGroup&) = delete;
+    GPIOGroup& operator=(GPIOGroup&&) = default;
+    ~GPIOGroup() = default;
+
+    /**
+     * Constructor
+     *
+     * @param[in] device - the GPIO device file
+     * @param[in] gpios - the GPIO numbers, at most GPIO_V2_LINES_MAX
+     */
+    GPIOGroup(const std::string& device, const std::vector<gpioNum_t>& gpios) :
+        device(device), gpios(gpios)
+    {}
+
+    /**
+     * Reads the GPIO values
+     *
+     * Requests the GPIO lines if it hasn't been done already.
+     *
+     * @return std::vector<Value> - the values, in the same order
+     *                              as the GPIO numbers
+     */
+    std::vector<Value> read();
+
+  private:
+    /**
+     * Requests the GPIO lines from the GPIO device
+     */
+    void requestLines();
+
+    /**
+     * The GPIO device name, like /dev/gpiochip0
+     */
+    const std::string device;
+
+    /**
+     * The GPIO numbers
+     */
+    const std::vector<gpioNum_t> gpios;
+
+    /**
+     * File descriptor for the GPIO lines
+     */
+    power::util::FileDescriptor lineFD;
+};
+
+/**
+ * An input GPIO whose edge events are handled by a callback
+ * from an sdeventplus event loop.
+ *
+ * The events carry the kernel timestamps of the edges, so a
+ * monitor does not need to poll the GPIO, and the time of an
+ * edge does not depend on when the event loop gets to it.
+ */
+class GPIOEventSource
+{
+  public:
+    GPIOEventSource() = delete;
+    GPIOEventSource(const GPIOEventSource&) = delete;
+    GPIOEventSource(GPIOEventSource&&) = delete;
+    GPIOEventSource& operator=(const GPIOEventSource&) = delete;
+    GPIOEventSource& operator=(GPIOEventSource&&) = delete;
+    ~GPIOEventSource() = default;
+
+    /**
+     * The callback, called once for each edge event
+     */
+    using Callback = std::function<void(const Event&)>;
+
+    /**
+     * Constructor
+     *
+     * Requests the edge events right away.
+     *
+     * @param[in] event - the event loop to handle the events on
+     * @param[in] device - the GPIO device file
+     * @param[in] gpio - the GPIO number
+     * @param[in] callback - the callback for the events
+     * @param[in] debounce - the debounce period, or zero for none
+     * @param[in] clock - the clock the events are timestamped with
+     */
+    GPIOEventSource(const sdeventplus::Event& event, const std::string& device,
+                    gpioNum_t gpio, Callback callback,
+                    std::chrono::microseconds debounce = {},
+                    EventClock clock = EventClock::monotonic);
+
+    /**
+     * Reads the GPIO value
+     *
+     * @return Value - the GPIO value
+     */
+    Value read();
+
+  private:
+    /**
+     * Reads the pending events and calls the callback for each one
+     */
+    void eventsReady();
+
+    /**
+     * The GPIO
+     */
+    GPIO gpio;
+
+    /**
+     * The callback for the events
+     */
+    Callback callback;
+
+    /**
+     * The event loop source for the GPIO file descriptor
+     */
+    std::unique_ptr<sdeventplus::source::IO> source;
 };
 
 } // namespace gpio
@@ -0,0 +1,162 @@
+/**
+ * Copyright © 2026 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "hwmon_index.hpp"
+
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include <system_error>
+
+namespace phosphor::pmbus
+{
+
+namespace
+{
+
+/**
+ * Returns the canonical form of a device path, or the path itself if it
+ * cannot be resolved.
+ *
+ * @param[in] path - the device path
+ *
+ * @return string - the path to use as the index key
+ */
+std::string getKey(const fs::path& path)
+{
+    std::error_code ec;
+    fs::path canonical = fs::weakly_canonical(path, ec);
+    return ec ? path.string() : canonical.string();
+}
+
+/**
+ * Scans the hwmon directory of a device for its hwmonN directory.
+ *
+ * @param[in] devicePath - path to the sysfs directory of the device
+ *
+ * @return fs::path - the directory name, or an empty path if not found
+ */
+fs::path scanDevice(const fs::path& devicePath)
+{
+    std::error_code ec;
+    for (const auto& entry :
+         fs::directory_iterator(devicePath / "hwmon", ec))
+    {
+        if ((entry.path().filename().string().find("hwmon") !=
+             std::string::npos) &&
+            fs::is_directory(entry.path(), ec))
+        {
+            return entry.path().filename();
+        }
+    }
+    return fs::path{};
+}
+
+} // namespace
+
+HwmonIndex::HwmonIndex(const fs::path& classPath) :
+    classPath(classPath), inotifyFD(inotify_init1(IN_NONBLOCK | IN_CLOEXEC))
+{
+    if (inotifyFD &&
+        (inotify_add_watch(inotifyFD(), classPath.c_str(),
+                           IN_CREATE | IN_DELETE | IN_MOVED_FROM |
+                               IN_MOVED_TO) < 0))
+    {
+        inotifyFD.close();
+    }
+}
+
+HwmonIndex& HwmonIndex::getInstance()
+{
+    static HwmonIndex index{};
+    return index;
+}
+
+fs::path HwmonIndex::find(const fs::path& devicePath)
+{
+    std::lock_guard<std::mutex> lock{mutex};
+    checkEvents();
+    if (!populated)
+    {
+        scan();
+    }
+
+    // A stat is cheaper than scanning the device directory, and catches
+    // rebinds that inotify did not report
+    std::string key = getKey(devicePath);
+    auto it = dirs.find(key);
+    std::error_code ec;
+    if ((it != dirs.end()) &&
+        fs::is_directory(devicePath / "hwmon" / it->second, ec))
+    {
+        return it->second;
+    }
+
+    fs::path dir = scanDevice(devicePath);
+    if (dir.empty())
+    {
+        dirs.erase(key);
+    }
+    else
+    {
+        dirs.insert_or_assign(key, dir);
+    }
+    return dir;
+}
+
+void HwmonIndex::checkEvents()
+{
+    if (!inotifyFD)
+    {
+        return;
+    }
+
+    // The events themselves are not needed; any change rebuilds the index
+    alignas(inotify_event) char buffer[4096];
+    bool changed{false};
+    while (::read(inotifyFD(), buffer, sizeof(buffer)) > 0)
+    {
+        changed = true;
+    }
+    if (changed)
+    {
+        populated = false;
+        dirs.clear();
+    }
+}
+
+void HwmonIndex::scan()
+{
+    dirs.clear();
+
+    // Each /sys/class/hwmon/hwmonN links to <device>/hwmon/hwmonN
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator(classPath, ec))
+    {
+        std::error_code linkEC;
+        fs::path target = fs::canonical(entry.path(), linkEC);
+        if (linkEC || (target.parent_path().filename() != "hwmon"))
+        {
+            continue;
+        }
+        dirs.insert_or_assign(target.parent_path().parent_path().string(),
+                              target.filename());
+    }
+
+    populated = true;
+    ++scanCount;
+}
+
+} // namespace phosphor::pmbus
@@ -0,0 +1,162 @@
+#pragma once
+
+#include "file_descriptor.hpp"
+
+#include <cstddef>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+
+namespace phosphor::pmbus
+{
+
+namespace fs = std::filesystem;
+
+/**
+ * @class HwmonIndex
+ *
+ * Process-wide index of the hwmon directories of the devices, keyed by
+ * device path, so the PMBus objects do not each scan sysfs to find theirs.
+ *
+ * The index is built from the hwmonN links in /sys/class/hwmon the first
+ * time it is used.  The class directory is watched with inotify, and the
+ * index is built again after a hwmon device is added or removed.  Since
+ * sysfs does not report every change through inotify, each indexed
+ * directory is also checked to still exist before it is returned, and the
+ * device directory is scanned if it does not, such as after the device
+ * driver has been rebound.
+ *
+ * All the members are thread safe.
+ */
+class HwmonIndex
+{
+  public:
+    HwmonIndex(const HwmonIndex&) = delete;
+    HwmonIndex& operator=(const HwmonIndex&) = delete;
+    HwmonIndex(HwmonIndex&&) = delete;
+    HwmonIndex& operator=(HwmonIndex&&) = delete;
+    ~HwmonIndex() = default;
+
+    /**
+     * Constructor
+     *
+     * @param[in] classPath - path to the hwmon class directory
+     */
+    explicit HwmonIndex(const fs::path& classPath = "/sys/class/hwmon");
+
+    /**
+     * Returns the index shared by the process, for /sys/class/hwmon.
+     *
+     * @return HwmonIndex& - the index
+     */
+    static HwmonIndex& getInstance();
+
+    /**
+     * Finds the hwmon directory of a device.
+     *
+     * @param[in] devicePath - path to the sysfs directory of the device
+     *
+     * @return fs::path - the name of the directory under devicePath/hwmon,
+     *                    like "hwmon3", or an empty path if the device has
+     *                    no hwmon directory
+     */
+    fs::path find(const fs::path& devicePath);
+
+    /**
+     * Returns the number of times the index was built from the class
+     * directory.
+     *
+     * @return size_t - the number of scans
+     */
+    size_t getScanCount() const
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        return scanCount;
+    }
+
+    /**
+     * Discards the index, so it is built again on the next find().
+     */
+    void invalidate()
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        populated = false;
+        dirs.clear();
+    }
+
+    /**
+     * Returns the indexed hwmon directories, so they can be handed over to
+     * the next instance of the daemon.
+     *
+     * @return std::map<std::string, fs::path> - the directory names, keyed
+     *                                           by canonical device path
+     */
+    std::map<std::string, fs::path> getEntries() const
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        return dirs;
+    }
+
+    /**
+     * Replaces the index with the directories indexed by a previous instance
+     * of the daemon, so it is not built from the class directory.  Each
+     * directory is still checked to exist before find() returns it.
+     *
+     * @param[in] entries - the directory names, keyed by canonical device
+     *                      path
+     */
+    void restore(std::map<std::string, fs::path> entries)
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        dirs = std::move(entries);
+        populated = true;
+    }
+
+  private:
+    /**
+     * Discards the index if the class directory has changed since the last
+     * call.  Must be called with the mutex locked.
+     */
+    void checkEvents();
+
+    /**
+     * Builds the index from the class directory.  Must be called with the
+     * mutex locked.
+     */
+    void scan();
+
+    /**
+     * The path to the hwmon class directory
+     */
+    const fs::path classPath;
+
+    /**
+     * The inotify instance watching the class directory; not open if the
+     * directory could not be watched.
+     */
+    phosphor::power::util::FileDescriptor inotifyFD;
+
+    /**
+     * Protects the members below
+     */
+    mutable std::mutex mutex;
+
+    /**
+     * Indicates whether the index has been built from the class directory
+     */
+    bool populated = false;
+
+    /**
+     * The number of times the index was built from the class directory
+     */
+    size_t scanCount = 0;
+
+    /**
+     * The hwmon directory names, keyed by canonical device path
+     */
+    std::map<std::string, fs::path> dirs;
+};
+
+} // namespace phosphor::pmbus
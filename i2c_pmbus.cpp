@@ -0,0 +1,361 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "i2c_pmbus.hpp"
+
+#include <phosphor-logging/elog-errors.hpp>
+#include <phosphor-logging/elog.hpp>
+#include <xyz/openbmc_project/Common/Device/error.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <map>
+#include <stdexcept>
+
+namespace phosphor
+{
+namespace pmbus
+{
+
+using namespace phosphor::logging;
+using namespace sdbusplus::xyz::openbmc_project::Common::Device::Error;
+
+/**
+ * PMBus command code for PAGE
+ */
+constexpr uint8_t PAGE = 0x00;
+
+bool I2CPMBus::findCommand(const std::string& name, Command& command,
+                           int& page)
+{
+    // PMBus command codes for the file names used by the device drivers
+    static const std::map<std::string, Command> commands{
+        {ON_OFF_CONFIG, {0x02, Format::Byte}},
+        {STATUS_WORD, {0x79, Format::Word}},
+        {STATUS_VOUT, {0x7A, Format::Byte}},
+        {STATUS_IOUT, {0x7B, Format::Byte}},
+        {STATUS_INPUT, {0x7C, Format::Byte}},
+        {STATUS_TEMPERATURE, {0x7D, Format::Byte}},
+        {STATUS_CML, {0x7E, Format::Byte}},
+        {STATUS_MFR, {0x80, Format::Byte}},
+        {STATUS_FANS_1_2, {0x81, Format::Byte}},
+        {READ_VIN, {0x88, Format::Linear11}}};
+
+    page = -1;
+    auto it = commands.find(name);
+    if (it == commands.end())
+    {
+        // Check for a paged name, such as status3_vout for statusP_vout
+        auto start = name.find_first_of("0123456789");
+        if (start == std::string::npos)
+        {
+            return false;
+        }
+        auto end = name.find_first_not_of("0123456789", start);
+        if (end == std::string::npos)
+        {
+            end = name.size();
+        }
+
+        auto templateName = name;
+        templateName.replace(start, end - start, "P");
+        it = commands.find(templateName);
+        if (it == commands.end())
+        {
+            return false;
+        }
+        page = std::stoi(name.substr(start, end - start));
+    }
+
+    command = it->second;
+    return true;
+}
+
+void I2CPMBus::openIfNeeded()
+{
+    if (!interface->isOpen())
+    {
+        interface->open();
+    }
+}
+
+void I2CPMBus::closeAfterFailure()
+{
+    // Re-open the device on the next access
+    if (interface->isOpen())
+    {
+        try
+        {
+            interface->close();
+        }
+        catch (...)
+        {}
+    }
+}
+
+uint64_t I2CPMBus::readCommand(const Command& command)
+{
+    if (command.format == Format::Byte)
+    {
+        uint8_t value = 0;
+        interface->read(command.code, value);
+        return value;
+    }
+
+    uint16_t value = 0;
+    interface->read(command.code, value);
+    if (command.format == Format::Linear11)
+    {
+        // 5 bit two's complement exponent, 11 bit two's complement mantissa.
+        // Convert to millis.
+        int8_t exponent = static_cast<int8_t>(value >> 8) >> 3;
+        int16_t mantissa = static_cast<int16_t>(value << 5) >> 5;
+        return static_cast<uint64_t>(std::lround(
+            std::ldexp(static_cast<double>(mantissa), exponent) * 1000));
+    }
+    return value;
+}
+
+uint64_t I2CPMBus::read(const std::string& name, Type /*type*/)
+{
+    uint64_t data = 0;
+    Command command{};
+    int page = -1;
+    int rc = 0;
+
+    if (!findCommand(name, command, page))
+    {
+        rc = ENOTSUP;
+    }
+    else
+    {
+        try
+        {
+            openIfNeeded();
+
+            if (page >= 0)
+            {
+                interface->write(PAGE, static_cast<uint8_t>(page));
+            }
+
+            data = readCommand(command);
+        }
+        catch (const i2c::I2CException& e)
+        {
+            rc = (e.errorCode != 0) ? e.errorCode : EIO;
+            closeAfterFailure();
+        }
+    }
+
+    if (rc != 0)
+    {
+        log<level::ERR>((std::string("Failed to read PMBus command "
+                                     "errno=") +
+                         std::to_string(rc) + " NAME=" + name +
+                         " DEVICE_PATH=" + basePath.string())
+                            .c_str());
+
+        using metadata = xyz::openbmc_project::Common::Device::ReadFailure;
+
+        elog<ReadFailure>(metadata::CALLOUT_ERRNO(rc),
+                          metadata::CALLOUT_DEVICE_PATH(basePath.c_str()));
+    }
+
+    return data;
+}
+
+StatusSnapshot
+    I2CPMBus::readStatusSnapshot(const std::vector<std::string>& names,
+                                 Type /*type*/)
+{
+    StatusSnapshot snapshot;
+    snapshot.timestamp = std::chrono::steady_clock::now();
+    snapshot.values.resize(names.size(), 0);
+    snapshot.valid.resize(names.size(), false);
+
+    try
+    {
+        openIfNeeded();
+
+        // Only select a page when it changes, so the status commands of one
+        // page take one transaction each
+        int currentPage = -1;
+        for (size_t i = 0; i < names.size(); i++)
+        {
+            Command command{};
+            int page = -1;
+            if (!findCommand(names[i], command, page))
+            {
+                continue;
+            }
+
+            if ((page >= 0) && (page != currentPage))
+            {
+                interface->write(PAGE, static_cast<uint8_t>(page));
+                currentPage = page;
+            }
+
+            snapshot.values[i] = readCommand(command);
+            snapshot.valid[i] = true;
+        }
+    }
+    catch (const i2c::I2CException& e)
+    {
+        // The device is not responding, so leave the rest of the commands
+        // marked as not valid rather than waiting for each of them to fail
+        closeAfterFailure();
+    }
+
+    return snapshot;
+}
+
+std::string I2CPMBus::readString(const std::string& name, Type type)
+{
+    return std::to_string(read(name, type));
+}
+
+size_t I2CPMBus::readBlock(const std::string& name, Type /*type*/,
+                           std::span<uint8_t> buffer)
+{
+    // PMBus command codes of the block commands
+    static const std::map<std::string, uint8_t> commands{{READ_EIN, 0x86},
+                                                         {READ_EOUT, 0x87}};
+
+    auto it = commands.find(name);
+    if (it == commands.end())
+    {
+        return 0;
+    }
+
+    try
+    {
+        openIfNeeded();
+
+        std::array<uint8_t, 32> data{};
+        uint8_t size = 0;
+        interface->read(it->second, size, data.data(),
+                        i2c::I2CInterface::Mode::SMBUS);
+
+        auto count = std::min<size_t>(size, buffer.size());
+        std::copy_n(data.begin(), count, buffer.begin());
+        return count;
+    }
+    catch (const i2c::I2CException& e)
+    {
+        closeAfterFailure();
+    }
+    return 0;
+}
+
+void I2CPMBus::writeBinary(const std::string& name,
+                           std::span<const uint8_t> data, Type /*type*/)
+{
+    Command command{};
+    int page = -1;
+    int rc = 0;
+
+    if (!findCommand(name, command, page) || data.empty() ||
+        (data.size() > 32))
+    {
+        rc = ENOTSUP;
+    }
+    else
+    {
+        try
+        {
+            openIfNeeded();
+
+            if (page >= 0)
+            {
+                interface->write(PAGE, static_cast<uint8_t>(page));
+            }
+
+            if (data.size() == 1)
+            {
+                interface->write(command.code, data[0]);
+            }
+            else if (data.size() == 2)
+            {
+                // Low-order byte first as required by PMBus
+                uint16_t value = data[0] | (data[1] << 8);
+                interface->write(command.code, value);
+            }
+            else
+            {
+                interface->write(command.code,
+                                 static_cast<uint8_t>(data.size()),
+                                 data.data());
+            }
+        }
+        catch (const i2c::I2CException& e)
+        {
+            rc = (e.errorCode != 0) ? e.errorCode : EIO;
+        }
+    }
+
+    if (rc != 0)
+    {
+        log<level::ERR>((std::string("Failed to write PMBus command "
+                                     "errno=") +
+                         std::to_string(rc) + " NAME=" + name +
+                         " DEVICE_PATH=" + basePath.string())
+                            .c_str());
+
+        using metadata = xyz::openbmc_project::Common::Device::WriteFailure;
+
+        elog<WriteFailure>(metadata::CALLOUT_ERRNO(rc),
+                           metadata::CALLOUT_DEVICE_PATH(basePath.c_str()));
+    }
+}
+
+std::string I2CPMBus::insertPageNum(const std::string& templateName,
+                                    size_t page)
+{
+    auto name = templateName;
+
+    // insert the page where the P was
+    auto pos = name.find('P');
+    if (pos != std::string::npos)
+    {
+        name.replace(pos, 1, std::to_string(page));
+    }
+
+    return name;
+}
+
+std::unique_ptr<PMBusBase> I2CPMBus::create(const std::string& path)
+{
+    // The device directory name is <bus>-<4 digit hex address>
+    auto device = fs::path{path}.filename().string();
+    auto dash = device.find('-');
+    if (dash == std::string::npos)
+    {
+        throw std::invalid_argument{"Invalid I2C device path " + path};
+    }
+
+    auto bus = static_cast<uint8_t>(std::stoul(device.substr(0, dash)));
+    auto address =
+        static_cast<uint8_t>(std::stoul(device.substr(dash + 1), nullptr, 16));
+
+    auto interface =
+        i2c::create(bus, address, i2c::I2CInterface::InitialState::CLOSED);
+    return std::make_unique<I2CPMBus>(path, std::move(interface));
+}
+
+} // namespace pmbus
+} // namespace phosphor
@@ -0,0 +1,226 @@
+#pragma once
+
+#include "i2c_interface.hpp"
+#include "pmbus.hpp"
+
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace phosphor
+{
+namespace pmbus
+{
+
+/**
+ * @class I2CPMBus
+ *
+ * This class is an interface to communicating with PMBus devices by sending
+ * SMBus transactions directly to the device over an i2c::I2CInterface.
+ *
+ * It avoids the overhead of the device driver formatting values as text in
+ * the hwmon and debugfs files, and of parsing that text again.
+ *
+ * The file names used by the PMBus class, such as STATUS_WORD and READ_VIN,
+ * are mapped to the corresponding PMBus commands.  The Type parameter is not
+ * needed to locate a command and is ignored.  Paged names, such as the
+ * STATUS_VOUT name returned by insertPageNum(), select the page with the
+ * PAGE command before the read.
+ */
+class I2CPMBus : public PMBusBase
+{
+  public:
+    I2CPMBus() = delete;
+    virtual ~I2CPMBus() = default;
+    I2CPMBus(const I2CPMBus&) = delete;
+    I2CPMBus& operator=(const I2CPMBus&) = delete;
+    I2CPMBus(I2CPMBus&&) = delete;
+    I2CPMBus& operator=(I2CPMBus&&) = delete;
+
+    /**
+     * Constructor
+     *
+     * @param[in] path - path to the sysfs directory of the device.  Used for
+     *                   error callouts.
+     * @param[in] interface - I2C interface to the device
+     */
+    I2CPMBus(const std::string& path,
+             std::unique_ptr<i2c::I2CInterface> interface) :
+        basePath(path),
+        interface(std::move(interface))
+    {}
+
+    /**
+     * Creates an I2CPMBus for the device with the specified sysfs path.
+     *
+     * The I2C bus and address are obtained from the last element of the
+     * path, such as /sys/bus/i2c/devices/3-0069.
+     *
+     * @param[in] path - path to the sysfs directory of the device
+     *
+     * @return PMBusBase pointer
+     */
+    static std::unique_ptr<PMBusBase> create(const std::string& path);
+
+    /**
+     * Reads the value of a PMBus command.
+     *
+     * @param[in] name - the PMBus file name of the command
+     * @param[in] type - Path type (ignored)
+     *
+     * @return uint64_t - The value read.  READ_VIN is returned in millivolts
+     *                    to match the hwmon file.
+     */
+    uint64_t read(const std::string& name, Type type) override;
+
+    /**
+     * Reads the value of a PMBus command as a decimal string.
+     *
+     * @param[in] name - the PMBus file name of the command
+     * @param[in] type - Path type (ignored)
+     *
+     * @return string - The value read
+     */
+    /**
+     * Reads a set of status commands in one call.
+     *
+     * The device is opened once, and the PAGE command is only sent when the
+     * page changes, so each command takes a single transaction.  Failed
+     * reads are not logged.  If the device stops responding, the remaining
+     * commands are not read.
+     *
+     * @param[in] names - the PMBus file names of the commands
+     * @param[in] type - Path type (ignored)
+     *
+     * @return StatusSnapshot - the values read
+     */
+    StatusSnapshot readStatusSnapshot(const std::vector<std::string>& names,
+                                      Type type) override;
+
+    std::string readString(const std::string& name, Type type) override;
+
+    /**
+     * Reads the raw data of READ_EIN or READ_EOUT with a Block Read.
+     *
+     * @param[in] name - the PMBus file name of the command
+     * @param[in] type - Path type (ignored)
+     * @param[out] buffer - filled in with the data read, without the block
+     *                      count
+     *
+     * @return size_t - The number of bytes read.  Zero if the command is not
+     *                  supported or could not be read.
+     */
+    size_t readBlock(const std::string& name, Type type,
+                     std::span<uint8_t> buffer) override;
+
+    /**
+     * Writes data to a PMBus command.
+     *
+     * One byte of data is sent with a Write Byte, two with a Write Word, and
+     * more with a Block Write.
+     *
+     * @param[in] name - the PMBus file name of the command
+     * @param[in] data - the data to write
+     * @param[in] type - Path type (ignored)
+     */
+    void writeBinary(const std::string& name, std::span<const uint8_t> data,
+                     Type type) override;
+
+    /**
+     * Does nothing, since no hwmon directory is used.
+     */
+    void findHwmonDir() override
+    {}
+
+    /**
+     * Returns the sysfs base path of this device
+     */
+    const fs::path& path() const override
+    {
+        return basePath;
+    }
+
+    /**
+     * Replaces the 'P' in the string passed in with
+     * the page number passed in.
+     *
+     * @param[in] templateName - the name string, with a 'P' in it
+     * @param[in] page - the page number to insert where the P was
+     *
+     * @return string - the new string with the page number in it
+     */
+    std::string insertPageNum(const std::string& templateName,
+                              size_t page) override;
+
+  private:
+    /**
+     * The data format of a PMBus command.
+     */
+    enum class Format
+    {
+        Byte,
+        Word,
+        Linear11
+    };
+
+    /**
+     * A PMBus command that a file name maps to.
+     */
+    struct Command
+    {
+        uint8_t code;
+        Format format;
+    };
+
+    /**
+     * Finds the PMBus command and page for a file name.
+     *
+     * @param[in] name - the PMBus file name
+     * @param[out] command - the command the name maps to
+     * @param[out] page - the page to select, or -1 if the command is not
+     *                    paged
+     *
+     * @return bool - true if the name maps to a command, false otherwise
+     */
+    static bool findCommand(const std::string& name, Command& command,
+                            int& page);
+
+    /**
+     * Reads the value of a command from the selected page.
+     *
+     * @param[in] command - the command
+     *
+     * @return uint64_t - The value read.  Linear11 values are returned in
+     *                    millis.
+     *
+     * @throw I2CException on error
+     */
+    uint64_t readCommand(const Command& command);
+
+    /**
+     * Closes the I2C interface after a failed transaction, so it is opened
+     * again on the next access.
+     */
+    void closeAfterFailure();
+
+    /**
+     * Opens the I2C interface if necessary.
+     *
+     * @throw I2CException on error
+     */
+    void openIfNeeded();
+
+    /**
+     * The sysfs device path
+     */
+    fs::path basePath;
+
+    /**
+     * The I2C interface to the device
+     */
+    std::unique_ptr<i2c::I2CInterface> interface;
+};
+
+} // namespace pmbus
+} // namespace phosphor
@@ -0,0 +1,156 @@
+/**
+ * Copyright © 2026 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "match_dispatcher.hpp"
+
+#include <systemd/sd-bus.h>
+
+#include <phosphor-logging/log.hpp>
+
+#include <exception>
+#include <vector>
+
+namespace phosphor::power::util
+{
+
+using namespace phosphor::logging;
+namespace rules = sdbusplus::bus::match::rules;
+
+MatchDispatcher::MatchDispatcher(sdbusplus::bus::bus& bus,
+                                 const std::string& pathNamespace) :
+    bus{bus},
+    pathNamespace{pathNamespace}
+{}
+
+MatchDispatcher::Registration
+    MatchDispatcher::propertiesChanged(const std::string& path,
+                                       const std::string& interface,
+                                       Callback callback)
+{
+    // Like rules::propertiesChanged(), but for all the objects in the
+    // namespace
+    std::string rule = rules::type::signal() +
+                       rules::path_namespace(pathNamespace) +
+                       rules::member("PropertiesChanged") +
+                       rules::interface("org.freedesktop.DBus.Properties") +
+                       rules::argN(0, interface);
+    return add(rule, PathSource::objectPath, path, std::move(callback));
+}
+
+MatchDispatcher::Registration
+    MatchDispatcher::interfacesAdded(const std::string& path,
+                                     Callback callback)
+{
+    // The signal is sent by the object manager, with the path of the object
+    // as the first argument
+    std::string rule =
+        rules::interfacesAdded() + rules::argNpath(0, pathNamespace + "/");
+    return add(rule, PathSource::firstArgument, path, std::move(callback));
+}
+
+MatchDispatcher::Registration
+    MatchDispatcher::add(const std::string& rule, PathSource pathSource,
+                         const std::string& path, Callback callback)
+{
+    auto [it, added] = matches.try_emplace(rule, Match{pathSource});
+    Match& match = it->second;
+    if (added)
+    {
+        try
+        {
+            match.match = std::make_unique<sdbusplus::bus::match_t>(
+                bus, rule, [this, &match](sdbusplus::message::message& msg) {
+                    dispatch(match, msg);
+                });
+        }
+        catch (...)
+        {
+            matches.erase(it);
+            throw;
+        }
+    }
+
+    uint64_t id = nextID++;
+    match.paths.emplace(path, id);
+    match.callbacks.emplace(id, std::move(callback));
+    return Registration{this, rule, id};
+}
+
+void MatchDispatcher::remove(const std::string& rule, uint64_t id)
+{
+    auto it = matches.find(rule);
+    if (it == matches.end())
+    {
+        return;
+    }
+    Match& match = it->second;
+    match.callbacks.erase(id);
+    for (auto pathIt = match.paths.begin(); pathIt != match.paths.end();
+         ++pathIt)
+    {
+        if (pathIt->second == id)
+        {
+            match.paths.erase(pathIt);
+            break;
+        }
+    }
+}
+
+void MatchDispatcher::dispatch(Match& match, sdbusplus::message::message& msg)
+{
+    std::string path;
+    try
+    {
+        if (match.pathSource == PathSource::objectPath)
+        {
+            path = msg.get_path();
+        }
+        else
+        {
+            sdbusplus::message::object_path objectPath;
+            msg.read(objectPath);
+            path = objectPath.str;
+        }
+    }
+    catch (const std::exception& e)
+    {
+        log<level::ERR>("Unable to read the path of a D-Bus signal",
+                        entry("ERROR=%s", e.what()));
+        return;
+    }
+
+    // A callback may remove itself or the other callbacks, so look each one
+    // up again before calling it
+    std::vector<uint64_t> ids;
+    auto [first, last] = match.paths.equal_range(path);
+    for (auto it = first; it != last; ++it)
+    {
+        ids.emplace_back(it->second);
+    }
+
+    for (uint64_t id : ids)
+    {
+        auto it = match.callbacks.find(id);
+        if (it != match.callbacks.end())
+        {
+            // Copy the callback, since it may be removed while it runs
+            Callback callback = it->second;
+            sd_bus_message_rewind(msg.get(), true);
+            callback(msg);
+        }
+    }
+}
+
+} // namespace phosphor::power::util
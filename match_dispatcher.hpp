@@ -0,0 +1,252 @@
+#pragma once
+
+#include <sdbusplus/bus.hpp>
+#include <sdbusplus/bus/match.hpp>
+#include <sdbusplus/message.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+
+namespace phosphor::power::util
+{
+
+/**
+ * @class MatchDispatcher
+ *
+ * Shares D-Bus signal matches between the objects below a path namespace,
+ * such as the power supplies in the inventory.
+ *
+ * Each type of signal has one path_namespace match, added when the first
+ * callback for it is registered.  The signals are dispatched in-process to
+ * the callbacks registered for the object path of the signal.  This adds far
+ * fewer rules to the D-Bus broker than one match per object.
+ *
+ * The matches are not removed when their last callback is, since a match
+ * cannot be destroyed while it is dispatching.
+ */
+class MatchDispatcher
+{
+  public:
+    using Callback = std::function<void(sdbusplus::message::message& msg)>;
+
+    /**
+     * @class Registration
+     *
+     * A callback registered with the dispatcher.  The callback is removed
+     * when the registration is destroyed.  The dispatcher must outlive it.
+     */
+    class Registration
+    {
+      public:
+        Registration() = default;
+        Registration(const Registration&) = delete;
+        Registration& operator=(const Registration&) = delete;
+
+        Registration(Registration&& other) noexcept :
+            dispatcher{other.dispatcher}, rule{std::move(other.rule)},
+            id{other.id}
+        {
+            other.dispatcher = nullptr;
+        }
+
+        Registration& operator=(Registration&& other) noexcept
+        {
+            if (this != &other)
+            {
+                reset();
+                dispatcher = other.dispatcher;
+                rule = std::move(other.rule);
+                id = other.id;
+                other.dispatcher = nullptr;
+            }
+            return *this;
+        }
+
+        ~Registration()
+        {
+            reset();
+        }
+
+        /**
+         * Removes the callback.  Does nothing if it was already removed.
+         */
+        void reset()
+        {
+            if (dispatcher != nullptr)
+            {
+                dispatcher->remove(rule, id);
+                dispatcher = nullptr;
+            }
+        }
+
+      private:
+        friend class MatchDispatcher;
+
+        Registration(MatchDispatcher* dispatcher, const std::string& rule,
+                     uint64_t id) :
+            dispatcher{dispatcher},
+            rule{rule}, id{id}
+        {}
+
+        /**
+         * The dispatcher, or nullptr if the callback was removed.
+         */
+        MatchDispatcher* dispatcher{nullptr};
+
+        /**
+         * The rule of the match the callback is registered with.
+         */
+        std::string rule{};
+
+        /**
+         * The ID of the callback.
+         */
+        uint64_t id{0};
+    };
+
+    MatchDispatcher() = delete;
+    ~MatchDispatcher() = default;
+    MatchDispatcher(const MatchDispatcher&) = delete;
+    MatchDispatcher& operator=(const MatchDispatcher&) = delete;
+    MatchDispatcher(MatchDispatcher&&) = delete;
+    MatchDispatcher& operator=(MatchDispatcher&&) = delete;
+
+    /**
+     * Constructor
+     *
+     * @param[in] bus - the D-Bus object
+     * @param[in] pathNamespace - the path the objects are below, such as
+     *                            "/xyz/openbmc_project/inventory"
+     */
+    MatchDispatcher(sdbusplus::bus::bus& bus, const std::string& pathNamespace);
+
+    /**
+     * Registers a callback for the PropertiesChanged signals of an interface
+     * of an object.
+     *
+     * @param[in] path - the object path
+     * @param[in] interface - the interface whose properties changed
+     * @param[in] callback - called with the signal
+     *
+     * @return Registration - removes the callback when destroyed
+     */
+    [[nodiscard]] Registration propertiesChanged(const std::string& path,
+                                                 const std::string& interface,
+                                                 Callback callback);
+
+    /**
+     * Registers a callback for the InterfacesAdded signals of an object.
+     *
+     * @param[in] path - the object path
+     * @param[in] callback - called with the signal, which is read from the
+     *                       start
+     *
+     * @return Registration - removes the callback when destroyed
+     */
+    [[nodiscard]] Registration interfacesAdded(const std::string& path,
+                                               Callback callback);
+
+    /**
+     * Returns the number of matches added to the bus.
+     *
+     * @return size_t - the number of matches
+     */
+    std::size_t getMatchCount() const
+    {
+        return matches.size();
+    }
+
+  private:
+    /**
+     * How the object path of a signal is found.
+     */
+    enum class PathSource
+    {
+        objectPath,
+        firstArgument
+    };
+
+    /**
+     * @struct Match
+     *
+     * A match added to the bus and the callbacks registered with it.
+     */
+    struct Match
+    {
+        /**
+         * How the object path of the signals is found.
+         */
+        PathSource pathSource;
+
+        /**
+         * The IDs of the callbacks, by object path.
+         */
+        std::multimap<std::string, uint64_t> paths{};
+
+        /**
+         * The callbacks, by ID.
+         */
+        std::map<uint64_t, Callback> callbacks{};
+
+        /**
+         * The match; added last, after the callbacks it uses.
+         */
+        std::unique_ptr<sdbusplus::bus::match_t> match{};
+    };
+
+    /**
+     * Registers a callback with the match for a rule, adding the match if
+     * needed.
+     *
+     * @param[in] rule - the match rule
+     * @param[in] pathSource - how the object path of a signal is found
+     * @param[in] path - the object path
+     * @param[in] callback - called with the signal
+     *
+     * @return Registration - removes the callback when destroyed
+     */
+    Registration add(const std::string& rule, PathSource pathSource,
+                     const std::string& path, Callback callback);
+
+    /**
+     * Removes a callback.
+     *
+     * @param[in] rule - the match rule
+     * @param[in] id - the ID of the callback
+     */
+    void remove(const std::string& rule, uint64_t id);
+
+    /**
+     * Calls the callbacks registered for the object path of a signal.
+     *
+     * @param[in] match - the match of the signal
+     * @param[in] msg - the signal
+     */
+    void dispatch(Match& match, sdbusplus::message::message& msg);
+
+    /**
+     * The D-Bus object.
+     */
+    sdbusplus::bus::bus& bus;
+
+    /**
+     * The path the objects are below.
+     */
+    std::string pathNamespace;
+
+    /**
+     * The ID of the next callback.
+     */
+    uint64_t nextID{0};
+
+    /**
+     * The matches, by rule.
+     */
+    std::map<std::string, Match> matches{};
+};
+
+} // namespace phosphor::power::util
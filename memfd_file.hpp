@@ -0,0 +1,212 @@
+#pragma once
+
+#include "file_descriptor.hpp"
+
+#include <errno.h>    // for errno
+#include <fcntl.h>    // for fcntl(), open(), and F_SEAL_*
+#include <string.h>   // for strerror()
+#include <sys/mman.h> // for memfd_create()
+#include <unistd.h>   // for write() and lseek()
+
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <string>
+
+namespace phosphor::power::util
+{
+
+/**
+ * @class MemFDFile
+ *
+ * This class manages an anonymous file that is stored in memory.
+ *
+ * The file is created using memfd_create().  It does not exist in the file
+ * system, so writing to it does not cause any flash writes.  This makes it
+ * suitable for passing FFDC (first failure data capture) data to the error
+ * logging system using a file descriptor.
+ *
+ * Write the data using write().  Then call seal() before passing the file
+ * descriptor to another process.  After the file is sealed, its contents can
+ * no longer be changed by any process.
+ *
+ * The file is deleted when close() is called or this object is destroyed and
+ * all other file descriptors for it have been closed.
+ *
+ * MemFDFile objects cannot be copied, but they can be moved.  This enables them
+ * to be stored in containers like std::vector.
+ */
+class MemFDFile
+{
+  public:
+    MemFDFile() = delete;
+    MemFDFile(const MemFDFile&) = delete;
+    MemFDFile(MemFDFile&&) = default;
+    MemFDFile& operator=(const MemFDFile&) = delete;
+    MemFDFile& operator=(MemFDFile&&) = default;
+    ~MemFDFile() = default;
+
+    /**
+     * Constructor.
+     *
+     * Creates the file and opens it for both reading and writing.
+     *
+     * Throws an exception if an error occurs.
+     *
+     * @param[in] name - Name of the file.  Only used for debugging; shown in
+     *                   /proc/<pid>/fd.
+     */
+    explicit MemFDFile(const std::string& name)
+    {
+        int fd = memfd_create(name.c_str(), MFD_CLOEXEC | MFD_ALLOW_SEALING);
+        if (fd == -1)
+        {
+            throw std::runtime_error{
+                std::string{"Unable to create in-memory file: "} +
+                strerror(errno)};
+        }
+        descriptor.set(fd);
+    }
+
+    /**
+     * Returns the file descriptor for the file.
+     *
+     * @return File descriptor.  Returns -1 if the file has been closed.
+     */
+    int getFileDescriptor()
+    {
+        return descriptor();
+    }
+
+    /**
+     * Returns whether the file has been sealed.
+     *
+     * @return true if file has been sealed, false otherwise
+     */
+    bool isSealed() const
+    {
+        return sealed;
+    }
+
+    /**
+     * Appends the specified data to the file.
+     *
+     * Throws an exception if an error occurs, such as when the file has been
+     * sealed.
+     *
+     * @param[in] data - Data to write
+     */
+    void write(const std::string& data)
+    {
+        write(std::span<const uint8_t>{
+            reinterpret_cast<const uint8_t*>(data.data()), data.size()});
+    }
+
+    /**
+     * Appends the specified binary data to the file.
+     *
+     * Throws an exception if an error occurs, such as when the file has been
+     * sealed.
+     *
+     * @param[in] data - Data to write
+     */
+    void write(std::span<const uint8_t> data)
+    {
+        const uint8_t* bufPtr = data.data();
+        size_t count = data.size();
+        while (count > 0)
+        {
+            // Try to write remaining bytes; it might not write all of them
+            ssize_t bytesWritten = ::write(descriptor(), bufPtr, count);
+            if (bytesWritten == -1)
+            {
+                throw std::runtime_error{
+                    std::string{"Unable to write to in-memory file: "} +
+                    strerror(errno)};
+            }
+            bufPtr += bytesWritten;
+            count -= bytesWritten;
+        }
+    }
+
+    /**
+     * Seals the file so that its contents can no longer be changed.
+     *
+     * Also seeks to the beginning of the file so another process can read the
+     * data.
+     *
+     * Throws an exception if an error occurs.
+     */
+    void seal()
+    {
+        if (lseek(descriptor(), 0, SEEK_SET) != 0)
+        {
+            throw std::runtime_error{
+                std::string{"Unable to seek within in-memory file: "} +
+                strerror(errno)};
+        }
+
+        int seals = F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL;
+        if (fcntl(descriptor(), F_ADD_SEALS, seals) == -1)
+        {
+            throw std::runtime_error{
+                std::string{"Unable to seal in-memory file: "} +
+                strerror(errno)};
+        }
+        sealed = true;
+    }
+
+    /**
+     * Opens the file again for reading.
+     *
+     * The new file descriptor has its own file offset, starting at the
+     * beginning of the file, unlike a descriptor created by dup().  Reading
+     * the file through it does not affect any other reader of the file.
+     *
+     * Throws an exception if an error occurs.
+     *
+     * @return new file descriptor for the file
+     */
+    FileDescriptor reopen()
+    {
+        std::string path{"/proc/self/fd/" + std::to_string(descriptor())};
+        int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd == -1)
+        {
+            throw std::runtime_error{
+                std::string{"Unable to reopen in-memory file: "} +
+                strerror(errno)};
+        }
+        return FileDescriptor{fd};
+    }
+
+    /**
+     * Closes the file.
+     *
+     * Does nothing if the file has already been closed.
+     *
+     * Throws an exception if an error occurs.
+     */
+    void close()
+    {
+        if (descriptor.close() == -1)
+        {
+            throw std::runtime_error{
+                std::string{"Unable to close in-memory file: "} +
+                strerror(errno)};
+        }
+    }
+
+  private:
+    /**
+     * File descriptor for reading from/writing to the file.
+     */
+    FileDescriptor descriptor{};
+
+    /**
+     * Indicates whether the file has been sealed.
+     */
+    bool sealed{false};
+};
+
+} // namespace phosphor::power::util
@@ -1,6 +1,12 @@
 #pragma once
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
 #include <sstream>
 #include <string>
+#include <string_view>
 
 namespace phosphor
 {
@@ -105,6 +111,126 @@ class NamesValues
     std::string all;
 };
 
+/**
+ * @class FixedNamesValues
+ *
+ * Builds the same string of name=value pairs as NamesValues, in a buffer
+ * inside the object instead of a std::string, so adding the pairs does not
+ * allocate memory.
+ *
+ * The string is null terminated, so c_str() can be passed directly as error
+ * log metadata:
+ *     FixedNamesValues<> nv;
+ *     nv.add("STATUS_WORD", 0xABCD);
+ *     report<Error>(metadata::RAW_STATUS(nv.c_str()));
+ *
+ * A pair that does not fit in the buffer is left out, and truncated()
+ * returns true.
+ */
+template <size_t Capacity = 256>
+class FixedNamesValues
+{
+    static_assert(Capacity > 1, "No room for the string");
+
+  public:
+    FixedNamesValues() = default;
+    FixedNamesValues(const FixedNamesValues&) = default;
+    FixedNamesValues& operator=(const FixedNamesValues&) = default;
+    FixedNamesValues(FixedNamesValues&&) = default;
+    FixedNamesValues& operator=(FixedNamesValues&&) = default;
+
+    /**
+     * Adds a name/value pair to the object
+     *
+     * @param name - the name to add
+     * @param value - the value to add
+     */
+    void add(std::string_view name, uint64_t value)
+    {
+        // Leave room for the terminating null
+        char* const end = buffer.data() + Capacity - 1;
+        char* pos = buffer.data() + size;
+
+        // The divider, name, '=' and "0x" must fit before the value
+        size_t prefix = ((size == 0) ? 0 : 1) + name.size() + 3;
+        if (static_cast<size_t>(end - pos) <= prefix)
+        {
+            isTruncated = true;
+            return;
+        }
+
+        if (size != 0)
+        {
+            *pos++ = '|';
+        }
+        pos = std::copy(name.begin(), name.end(), pos);
+        *pos++ = '=';
+        *pos++ = '0';
+        *pos++ = 'x';
+
+        auto [ptr, ec] = std::to_chars(pos, end, value, 16);
+        if (ec != std::errc{})
+        {
+            // Remove the partial pair
+            buffer[size] = '\0';
+            isTruncated = true;
+            return;
+        }
+
+        *ptr = '\0';
+        size = ptr - buffer.data();
+    }
+
+    /**
+     * Returns a formatted concatenation of all of the names and
+     * their values.
+     *
+     * @return string_view - "<name1>=<value1>|<name2>=<value2>..etc"
+     */
+    std::string_view get() const
+    {
+        return {buffer.data(), size};
+    }
+
+    /**
+     * Returns the string as a null terminated C string.
+     *
+     * The pointer is valid until the object is changed or destroyed.
+     *
+     * @return const char* - the string
+     */
+    const char* c_str() const
+    {
+        return buffer.data();
+    }
+
+    /**
+     * Returns whether a pair was left out because it did not fit.
+     *
+     * @return bool - true if a pair was left out
+     */
+    bool truncated() const
+    {
+        return isTruncated;
+    }
+
+  private:
+    /**
+     * The null terminated string containing all name/value pairs
+     */
+    std::array<char, Capacity> buffer{};
+
+    /**
+     * The length of the string, without the terminating null
+     */
+    size_t size = 0;
+
+    /**
+     * True if a pair did not fit in the buffer
+     */
+    bool isTruncated = false;
+};
+
 } // namespace util
 } // namespace power
 } // namespace phosphor
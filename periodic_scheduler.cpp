@@ -0,0 +1,118 @@
+/**
+ * Copyright © 2026 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "periodic_scheduler.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+
+namespace phosphor::power::util
+{
+
+PeriodicScheduler::PeriodicScheduler(const sdeventplus::Event& event,
+                                     std::chrono::milliseconds tick) :
+    tick{tick},
+    start{std::chrono::steady_clock::now()},
+    timer{event, std::bind(&PeriodicScheduler::expired, this)}
+{
+    if (tick.count() <= 0)
+    {
+        throw std::invalid_argument{"Scheduler tick must be positive"};
+    }
+}
+
+TimerWheel::Task
+    PeriodicScheduler::add(std::chrono::milliseconds period,
+                           TimerWheel::Callback callback,
+                           std::optional<std::chrono::milliseconds> phase)
+{
+    uint64_t periodTicks = std::max(toTicks(period), uint64_t{1});
+    std::optional<uint64_t> phaseTicks{};
+    if (phase)
+    {
+        phaseTicks = toTicks(*phase) % periodTicks;
+    }
+
+    // Catch up with the elapsed time so the task is placed after now.  When
+    // called from a task the wheel is already current, and the timer is
+    // restarted after the tasks have run.
+    if (advancing)
+    {
+        return wheel.add(periodTicks, std::move(callback), phaseTicks);
+    }
+    catchUp();
+    TimerWheel::Task task =
+        wheel.add(periodTicks, std::move(callback), phaseTicks);
+    schedule();
+    return task;
+}
+
+void PeriodicScheduler::catchUp()
+{
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start);
+    uint64_t now = static_cast<uint64_t>(elapsed / tick);
+    if (now > wheel.getTick())
+    {
+        advancing = true;
+        try
+        {
+            wheel.advance(now - wheel.getTick());
+        }
+        catch (...)
+        {
+            advancing = false;
+            throw;
+        }
+        advancing = false;
+    }
+}
+
+void PeriodicScheduler::expired()
+{
+    catchUp();
+    schedule();
+}
+
+void PeriodicScheduler::schedule()
+{
+    std::optional<uint64_t> ticks = wheel.getTicksUntilNext();
+    if (!ticks)
+    {
+        timer.setEnabled(false);
+        return;
+    }
+
+    // Wake at the start of the due tick, measured from tick 0 so the timer
+    // does not drift
+    auto due =
+        start + tick * static_cast<int64_t>(wheel.getTick() + *ticks);
+    auto delay = std::chrono::duration_cast<std::chrono::milliseconds>(
+        due - std::chrono::steady_clock::now());
+    timer.restartOnce(std::max(delay, std::chrono::milliseconds{0}));
+}
+
+uint64_t PeriodicScheduler::toTicks(std::chrono::milliseconds time) const
+{
+    if (time.count() <= 0)
+    {
+        return 0;
+    }
+    return static_cast<uint64_t>((time + tick / 2) / tick);
+}
+
+} // namespace phosphor::power::util
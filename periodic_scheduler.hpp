@@ -0,0 +1,131 @@
+#pragma once
+
+#include "timer_wheel.hpp"
+
+#include <sdeventplus/clock.hpp>
+#include <sdeventplus/event.hpp>
+#include <sdeventplus/utility/timer.hpp>
+
+#include <chrono>
+#include <optional>
+
+namespace phosphor::power::util
+{
+
+/**
+ * @class PeriodicScheduler
+ *
+ * Runs periodic tasks from the event loop using one timer.
+ *
+ * The tasks are scheduled on a TimerWheel.  The timer is only started for
+ * the ticks where a task is due, so tasks that share a scheduler cause fewer
+ * wakeups than tasks with their own timers.  Tasks added without a phase
+ * are spread across the ticks, so devices are not all polled at once.
+ *
+ * Periods and phases are rounded to a whole number of ticks, with a
+ * minimum of one tick.
+ */
+class PeriodicScheduler
+{
+  public:
+    /**
+     * The default tick.
+     */
+    static constexpr std::chrono::milliseconds defaultTick{100};
+
+    PeriodicScheduler() = delete;
+    ~PeriodicScheduler() = default;
+    PeriodicScheduler(const PeriodicScheduler&) = delete;
+    PeriodicScheduler& operator=(const PeriodicScheduler&) = delete;
+    PeriodicScheduler(PeriodicScheduler&&) = delete;
+    PeriodicScheduler& operator=(PeriodicScheduler&&) = delete;
+
+    /**
+     * Constructor
+     *
+     * @param[in] event - the event loop
+     * @param[in] tick - the time of one tick
+     */
+    explicit PeriodicScheduler(const sdeventplus::Event& event,
+                               std::chrono::milliseconds tick = defaultTick);
+
+    /**
+     * Adds a periodic task.
+     *
+     * @param[in] period - the time between runs
+     * @param[in] callback - called each time the task is due
+     * @param[in] phase - the offset within the period to run at; if not
+     *                    specified, the least used offset is chosen
+     *
+     * @return TimerWheel::Task - the task; it is removed when destroyed
+     */
+    [[nodiscard]] TimerWheel::Task
+        add(std::chrono::milliseconds period, TimerWheel::Callback callback,
+            std::optional<std::chrono::milliseconds> phase = std::nullopt);
+
+    /**
+     * Returns the time of one tick.
+     *
+     * @return milliseconds - the tick
+     */
+    std::chrono::milliseconds getTick() const
+    {
+        return tick;
+    }
+
+  private:
+    /**
+     * Advances the wheel to the current time, running the tasks that are
+     * due.
+     */
+    void catchUp();
+
+    /**
+     * Advances the wheel by the ticks that elapsed and restarts the timer.
+     *
+     * Runs in the timer callback.
+     */
+    void expired();
+
+    /**
+     * Starts the timer for the next tick where a task is due, or disables
+     * it if there are no tasks.
+     */
+    void schedule();
+
+    /**
+     * Converts a time to ticks, rounding to the nearest tick.
+     *
+     * @param[in] time - the time
+     *
+     * @return uint64_t - the number of ticks
+     */
+    uint64_t toTicks(std::chrono::milliseconds time) const;
+
+    /**
+     * The time of one tick.
+     */
+    std::chrono::milliseconds tick;
+
+    /**
+     * The time of tick 0 of the wheel.
+     */
+    std::chrono::steady_clock::time_point start;
+
+    /**
+     * The scheduled tasks.
+     */
+    TimerWheel wheel{};
+
+    /**
+     * Whether the tasks are being run by catchUp().
+     */
+    bool advancing{false};
+
+    /**
+     * The timer that is started for the next tick where a task is due.
+     */
+    sdeventplus::utility::Timer<sdeventplus::ClockId::Monotonic> timer;
+};
+
+} // namespace phosphor::power::util
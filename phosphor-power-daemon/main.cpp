@@ -0,0 +1,172 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "config.h"
+
+#if POWER_DAEMON_REGULATORS
+#include "phosphor-regulators/src/manager.hpp"
+#endif
+#if POWER_DAEMON_PSU_MONITOR
+#include "phosphor-power-supply/psu_manager.hpp"
+#endif
+#if POWER_DAEMON_POWER_CONTROL
+#include "phosphor-power-sequencer/src/power_control.hpp"
+#endif
+
+#include "realtime.hpp"
+#include "startup_times.hpp"
+
+#include <CLI/CLI.hpp>
+#include <phosphor-logging/log.hpp>
+#include <sdbusplus/bus.hpp>
+#include <sdeventplus/event.hpp>
+#include <sdeventplus/source/signal.hpp>
+#include <stdplus/signal.hpp>
+
+#include <exception>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace phosphor::logging;
+using namespace phosphor::power;
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        CLI::App app{"OpenBMC Power Daemon"};
+
+#if POWER_DAEMON_REGULATORS
+        bool noRegulators = false;
+        app.add_flag("--no-regulators", noRegulators,
+                     "Do not run the voltage regulator control");
+#endif
+#if POWER_DAEMON_PSU_MONITOR
+        bool noPSUMonitor = false;
+        app.add_flag("--no-psu-monitor", noPSUMonitor,
+                     "Do not run the power supply monitor");
+        bool eventMode = false;
+        app.add_flag("-e,--event-mode", eventMode,
+                     "Detect power supply faults using hwmon alarm "
+                     "notifications instead of polling every second");
+        bool parallel = false;
+        app.add_flag("-p,--parallel", parallel,
+                     "Read power supplies on different I2C buses in parallel");
+        bool batchDiscovery = false;
+        app.add_flag("-b,--batch-discovery", batchDiscovery,
+                     "Read the power supply configuration from Entity Manager "
+                     "with one GetManagedObjects call");
+        std::string throttleGPIOName{};
+        app.add_option("-t,--throttle-gpio", throttleGPIOName,
+                       "GPIO asserted while a power supply has lost capacity");
+#endif
+#if POWER_DAEMON_POWER_CONTROL
+        bool noPowerControl = false;
+        app.add_flag("--no-power-control", noPowerControl,
+                     "Do not run the power sequencer control");
+#endif
+        util::RealtimeOptions faultPathOptions{};
+        app.add_option("--fault-priority", faultPathOptions.priority,
+                       "SCHED_FIFO priority of the threads that handle power "
+                       "good changes and read the power supply status, or 0 "
+                       "for the normal policy")
+            ->check(CLI::Range(0, 99));
+        std::string faultCPUs{};
+        app.add_option("--fault-cpus", faultCPUs,
+                       "CPUs the fault path threads run on, such as 0,2-3");
+        app.add_flag("--lock-memory", faultPathOptions.lockMemory,
+                     "Lock the memory of the process");
+        CLI11_PARSE(app, argc, argv);
+
+        if (!faultCPUs.empty())
+        {
+            faultPathOptions.cpus = util::parseCPUList(faultCPUs);
+        }
+        try
+        {
+            util::lockProcessMemory(faultPathOptions);
+        }
+        catch (const std::exception& e)
+        {
+            log<level::ERR>(e.what());
+        }
+
+        // All the subsystems share one D-Bus connection and one event loop
+        auto bus = sdbusplus::bus::new_default();
+        auto event = sdeventplus::Event::get_default();
+        bus.attach_event(event.get(), SD_EVENT_PRIORITY_NORMAL);
+
+        // The daemon is ready once all of the subsystems are
+        std::vector<std::pair<std::string, util::StartupTimes*>> startups{};
+
+#if POWER_DAEMON_REGULATORS
+        std::unique_ptr<regulators::Manager> regulatorsManager{};
+        std::optional<sdeventplus::source::Signal> signal{};
+        if (!noRegulators)
+        {
+            regulatorsManager =
+                std::make_unique<regulators::Manager>(bus, event);
+            startups.emplace_back("regulators",
+                                  &regulatorsManager->getStartupTimes());
+
+            // Handle HUP signals
+            stdplus::signal::block(SIGHUP);
+            signal.emplace(event, SIGHUP,
+                           std::bind(&regulators::Manager::sighupHandler,
+                                     regulatorsManager.get(),
+                                     std::placeholders::_1,
+                                     std::placeholders::_2));
+        }
+#endif
+#if POWER_DAEMON_PSU_MONITOR
+        std::unique_ptr<manager::PSUManager> psuManager{};
+        if (!noPSUMonitor)
+        {
+            psuManager = std::make_unique<manager::PSUManager>(
+                bus, event, eventMode, parallel, batchDiscovery, 0,
+                faultPathOptions, throttleGPIOName);
+            startups.emplace_back("psu-monitor",
+                                  &psuManager->getStartupTimes());
+        }
+#endif
+#if POWER_DAEMON_POWER_CONTROL
+        std::unique_ptr<sequencer::PowerControl> powerControl{};
+        if (!noPowerControl)
+        {
+            powerControl = std::make_unique<sequencer::PowerControl>(
+                bus, event, faultPathOptions);
+            startups.emplace_back("power-control",
+                                  &powerControl->getStartupTimes());
+        }
+#endif
+        util::notifyReady(startups);
+
+        return event.loop();
+    }
+    catch (const std::exception& e)
+    {
+        log<level::ERR>(e.what());
+        return -2;
+    }
+    catch (...)
+    {
+        log<level::ERR>("Caught unexpected exception type");
+        return -3;
+    }
+}
@@ -0,0 +1,110 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "logged_fault_reader.hpp"
+
+#include <algorithm>
+
+namespace phosphor::power::sequencer
+{
+
+LoggedFaultReader::LoggedFaultReader(
+    std::unique_ptr<i2c::I2CInterface> interface) :
+    interface{std::move(interface)},
+    buffer((1 + MAX_DETAILS) * (1 + MAX_BLOCK_SIZE))
+{
+    operations.reserve(2 * DETAILS_PER_TRANSFER);
+}
+
+std::span<const uint8_t> LoggedFaultReader::read()
+{
+    size = 0;
+    if (!interface->isOpen())
+    {
+        interface->open();
+    }
+
+    readBlock(LOGGED_FAULTS);
+
+    // Reading the index returns the number of detail entries logged
+    uint16_t count{0};
+    interface->read(LOGGED_FAULT_DETAIL_INDEX, count);
+    size_t details = std::min<size_t>(count, MAX_DETAILS);
+    if (details > 0)
+    {
+        // The first entry gives the size of all of them, so the rest can be
+        // read as fixed size blocks in combined transactions
+        interface->write(LOGGED_FAULT_DETAIL_INDEX, uint16_t{0});
+        size_t blockSize = readBlock(LOGGED_FAULT_DETAIL);
+        for (size_t first = 1; (blockSize > 0) && (first < details);
+             first += DETAILS_PER_TRANSFER)
+        {
+            if (!readDetails(first,
+                             std::min(DETAILS_PER_TRANSFER, details - first),
+                             blockSize))
+            {
+                break;
+            }
+        }
+    }
+
+    return {buffer.data(), size};
+}
+
+size_t LoggedFaultReader::readBlock(uint8_t command)
+{
+    uint8_t blockSize{0};
+    interface->read(command, blockSize, &buffer[size + 1],
+                    i2c::I2CInterface::Mode::SMBUS);
+    blockSize = std::min<uint8_t>(blockSize, MAX_BLOCK_SIZE);
+    buffer[size] = blockSize;
+    size += 1 + blockSize;
+    return blockSize;
+}
+
+bool LoggedFaultReader::readDetails(size_t first, size_t count,
+                                    size_t blockSize)
+{
+    size_t entrySize = 1 + blockSize;
+    operations.clear();
+    for (size_t i = 0; i < count; i++)
+    {
+        size_t index = first + i;
+        indexes[i] = {static_cast<uint8_t>(index & 0xFF),
+                      static_cast<uint8_t>(index >> 8)};
+        operations.push_back(
+            {false, LOGGED_FAULT_DETAIL_INDEX, 2, indexes[i].data()});
+        operations.push_back({true, LOGGED_FAULT_DETAIL,
+                              static_cast<uint8_t>(entrySize),
+                              &buffer[size + i * entrySize]});
+    }
+
+    interface->transfer(operations);
+
+    // Each block starts with its byte count, which must match the first one
+    for (size_t i = 0; i < count; i++)
+    {
+        if (buffer[size + i * entrySize] != blockSize)
+        {
+            size += i * entrySize;
+            return false;
+        }
+    }
+    size += count * entrySize;
+    return true;
+}
+
+} // namespace phosphor::power::sequencer
@@ -0,0 +1,125 @@
+#pragma once
+
+#include "i2c_interface.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace phosphor::power::sequencer
+{
+
+/**
+ * @class LoggedFaultReader
+ * Reads the non-volatile fault log of a UCD90320, the LOGGED_FAULTS summary
+ * and every LOGGED_FAULT_DETAIL entry, for first failure data capture.
+ *
+ * The device driver does not provide the log, so it is read with SMBus
+ * transactions sent directly to the device.  The detail entries are read in
+ * combined transactions of as many index writes and block reads as the
+ * adapter accepts at once, into a buffer allocated up front.
+ *
+ * The data returned by read() is the LOGGED_FAULTS block followed by each
+ * LOGGED_FAULT_DETAIL block, oldest first, each block starting with its byte
+ * count as in the SMBus Block Read protocol.
+ */
+class LoggedFaultReader
+{
+  public:
+    LoggedFaultReader() = delete;
+    LoggedFaultReader(const LoggedFaultReader&) = delete;
+    LoggedFaultReader& operator=(const LoggedFaultReader&) = delete;
+    LoggedFaultReader(LoggedFaultReader&&) = delete;
+    LoggedFaultReader& operator=(LoggedFaultReader&&) = delete;
+    ~LoggedFaultReader() = default;
+
+    /**
+     * PMBus command codes of the fault log
+     */
+    static constexpr uint8_t LOGGED_FAULTS = 0xEA;
+    static constexpr uint8_t LOGGED_FAULT_DETAIL_INDEX = 0xEB;
+    static constexpr uint8_t LOGGED_FAULT_DETAIL = 0xEC;
+
+    /**
+     * The maximum number of detail entries read from the log
+     */
+    static constexpr size_t MAX_DETAILS = 30;
+
+    /**
+     * The maximum size of an SMBus block, not including the byte count
+     */
+    static constexpr size_t MAX_BLOCK_SIZE = 32;
+
+    /**
+     * The number of detail entries read in one combined transaction.  Each
+     * takes a message for the index write and two for the block read, and
+     * the kernel accepts at most 42 messages in one transaction.
+     */
+    static constexpr size_t DETAILS_PER_TRANSFER = 14;
+
+    /**
+     * Constructor
+     * @param[in] interface I2C interface to the device, open or closed
+     */
+    explicit LoggedFaultReader(std::unique_ptr<i2c::I2CInterface> interface);
+
+    /**
+     * Reads the fault log.
+     *
+     * Throws an exception if the log cannot be read.
+     *
+     * @return the data read, which remains valid until the next call
+     */
+    std::span<const uint8_t> read();
+
+  private:
+    /**
+     * Reads a block of the summary or the first detail entry with an SMBus
+     * Block Read, and appends it to the buffer with its byte count.
+     * @param[in] command The command code of the block
+     * @return the size of the block, not including the byte count
+     */
+    size_t readBlock(uint8_t command);
+
+    /**
+     * Reads detail entries in one combined transaction, and appends them to
+     * the buffer.
+     * @param[in] first The index of the first entry
+     * @param[in] count The number of entries, at most DETAILS_PER_TRANSFER
+     * @param[in] blockSize The size of each entry, not including the byte
+     *                      count
+     * @return false if an entry did not have the expected size, and so the
+     *         end of the log was found
+     */
+    bool readDetails(size_t first, size_t count, size_t blockSize);
+
+    /**
+     * I2C interface to the device
+     */
+    std::unique_ptr<i2c::I2CInterface> interface;
+
+    /**
+     * The data read, with room for the summary and every detail entry
+     */
+    std::vector<uint8_t> buffer;
+
+    /**
+     * The number of bytes of the buffer holding the data read
+     */
+    size_t size{0};
+
+    /**
+     * The operations of a combined transaction
+     */
+    std::vector<i2c::I2CInterface::Operation> operations;
+
+    /**
+     * The detail indexes written by a combined transaction, low byte first
+     */
+    std::array<std::array<uint8_t, 2>, DETAILS_PER_TRANSFER> indexes{};
+};
+
+} // namespace phosphor::power::sequencer
@@ -20,6 +20,8 @@
 #include "ucd90320_monitor.hpp"
 
 #include <fmt/format.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
 #include <sys/types.h>
 #include <unistd.h>
 
@@ -27,9 +29,18 @@
 #include <phosphor-logging/elog.hpp>
 #include <phosphor-logging/log.hpp>
 #include <xyz/openbmc_project/Common/error.hpp>
+#include <xyz/openbmc_project/Logging/Entry/server.hpp>
 
+#include <cerrno>
+#include <cstdint>
 #include <exception>
+#include <map>
+#include <optional>
+#include <span>
 #include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
 
 using namespace phosphor::logging;
 
@@ -42,10 +53,18 @@ const std::string busPropertyName = "Bus";
 const std::string namePropertyName = "Name";
 
 PowerControl::PowerControl(sdbusplus::bus::bus& bus,
-                           const sdeventplus::Event& event) :
+                           const sdeventplus::Event& event,
+                           const util::RealtimeOptions& faultPathOptions) :
     PowerObject{bus, POWER_OBJ_PATH, true},
-    bus{bus}, timer{event, std::bind(&PowerControl::pollPgood, this),
-                    pollInterval}
+    bus{bus},
+    railTimer{event, std::bind(&PowerControl::sampleRailStates, this)},
+    timer{event, std::bind(&PowerControl::pgoodTimedOut, this)},
+    waitTimer{event, std::bind(&PowerControl::replyToPgoodWaiters, this)},
+    errorLogQueue{bus, event},
+    faultPathOptions{faultPathOptions},
+    startupTimesInterface{bus, POWER_OBJ_PATH, startupTimes},
+    lagMonitor{event},
+    lagInterface{bus, POWER_OBJ_PATH, lagMonitor.getLag()}
 {
     // Obtain dbus service name
     bus.request_name(POWER_IFACE);
@@ -60,7 +79,13 @@ PowerControl::PowerControl(sdbusplus::bus::bus& bus,
         std::bind(&PowerControl::interfacesAddedHandler, this,
                   std::placeholders::_1));
     setUpDevice();
+    startupTimes.complete(util::StartupTimes::Phase::configLoad);
     setUpGpio();
+
+    // The power good state read from the GPIO is the first check of the
+    // hardware
+    startupTimes.complete(util::StartupTimes::Phase::firstCycle);
+    startupTimes.setReady();
 }
 
 void PowerControl::getDeviceProperties(util::DbusPropertyMap& properties)
@@ -99,7 +124,10 @@ void PowerControl::getDeviceProperties(util::DbusPropertyMap& properties)
                 *name, *i2cBus, *i2cAddress)
                 .c_str());
         // Create device object
-        device = std::make_unique<UCD90320Monitor>(bus, *i2cBus, *i2cAddress);
+        auto newDevice =
+            std::make_unique<UCD90320Monitor>(bus, *i2cBus, *i2cAddress);
+        std::lock_guard<std::mutex> lock{deviceMutex};
+        device = std::move(newDevice);
     }
 }
 
@@ -113,13 +141,31 @@ int PowerControl::getPgoodTimeout() const
     return timeout.count();
 }
 
+int PowerControl::getPowerOffTime() const
+{
+    return powerOffTime.count();
+}
+
+int PowerControl::getPowerOnTime() const
+{
+    return powerOnTime.count();
+}
+
 int PowerControl::getState() const
 {
     return state;
 }
 
+std::vector<TimelineEntry> PowerControl::getTimeline() const
+{
+    return timeline.getTimeline();
+}
+
 void PowerControl::interfacesAddedHandler(sdbusplus::message::message& msg)
 {
+    util::EventLoopLag::Scope lagScope{lagMonitor.getLag(),
+                                       "PowerControl::interfacesAddedHandler"};
+
     // Verify message is valid
     if (!msg)
     {
@@ -149,49 +195,104 @@ void PowerControl::interfacesAddedHandler(sdbusplus::message::message& msg)
     }
 }
 
-void PowerControl::pollPgood()
+void PowerControl::pgoodChanged()
 {
-    if (inStateTransition)
+    util::EventLoopLag::Scope lagScope{lagMonitor.getLag(),
+                                       "PowerControl::pgoodChanged"};
+
+    // Record the edges in the timeline, the current value is read from the
+    // line
+    bool dropped = false;
+    while (pgoodLine.event_wait(std::chrono::nanoseconds(0)))
     {
-        // In transition between power on and off, check for timeout
-        const auto now = std::chrono::steady_clock::now();
-        if (now > pgoodTimeoutTime)
+        auto event = pgoodLine.event_read();
+        bool falling = (event.event_type == gpiod::line_event::FALLING_EDGE);
+        if (falling)
         {
-            log<level::ERR>("ERROR PowerControl: Pgood poll timeout");
-            inStateTransition = false;
+            dropped = true;
+        }
+        timeline.addPgood(falling ? 0 : 1, TimelineRecorder::fromEventTimestamp(
+                                               event.timestamp));
+    }
 
-            try
-            {
-                auto method = bus.new_method_call(
-                    "xyz.openbmc_project.Logging",
-                    "/xyz/openbmc_project/logging",
-                    "xyz.openbmc_project.Logging.Create", "Create");
-
-                std::map<std::string, std::string> additionalData;
-                // Add PID to AdditionalData
-                additionalData.emplace("_PID", std::to_string(getpid()));
-
-                method.append(
-                    state ? "xyz.openbmc_project.Power.Error.PowerOnTimeout"
-                          : "xyz.openbmc_project.Power.Error.PowerOffTimeout",
-                    sdbusplus::xyz::openbmc_project::Logging::server::Entry::
-                        Level::Critical,
-                    additionalData);
-                bus.call_noreply(method);
-            }
-            catch (const std::exception& e)
-            {
-                log<level::ERR>(
-                    fmt::format(
-                        "Unable to log timeout error, state: {}, error {}",
-                        state, e.what())
-                        .c_str());
-            }
+    // Read the sequencer state before anything else if power good dropped
+    // while power is on, while the first fault is still visible
+    if (dropped && (state != 0))
+    {
+        std::lock_guard<std::mutex> lock{deviceMutex};
+        if (device)
+        {
+            device->captureFaultSnapshot();
+        }
+    }
 
-            return;
+    checkPgood();
+}
+
+void PowerControl::pgoodChangedOnFaultPath()
+{
+    std::vector<gpiod::line_event> events;
+    bool dropped = false;
+    while (pgoodLine.event_wait(std::chrono::nanoseconds(0)))
+    {
+        events.emplace_back(pgoodLine.event_read());
+        if (events.back().event_type == gpiod::line_event::FALLING_EDGE)
+        {
+            dropped = true;
+        }
+    }
+
+    // Same as pgoodChanged(), but without waiting for the event loop
+    if (dropped && (state != 0))
+    {
+        std::lock_guard<std::mutex> lock{deviceMutex};
+        if (device)
+        {
+            device->captureFaultSnapshot();
         }
     }
 
+    {
+        std::lock_guard<std::mutex> lock{pgoodEventMutex};
+        pendingPgoodEvents.insert(pendingPgoodEvents.end(), events.begin(),
+                                  events.end());
+    }
+    uint64_t value{1};
+    if (write(pgoodNotifyFD(), &value, sizeof(value)) != sizeof(value))
+    {
+        log<level::ERR>("Unable to notify event loop of pgood change",
+                        entry("ERRNO=%d", errno));
+    }
+}
+
+void PowerControl::pgoodEventsQueued()
+{
+    util::EventLoopLag::Scope lagScope{lagMonitor.getLag(),
+                                       "PowerControl::pgoodEventsQueued"};
+
+    uint64_t value{0};
+    if (read(pgoodNotifyFD(), &value, sizeof(value)) != sizeof(value))
+    {
+        return;
+    }
+
+    std::vector<gpiod::line_event> events;
+    {
+        std::lock_guard<std::mutex> lock{pgoodEventMutex};
+        events.swap(pendingPgoodEvents);
+    }
+    for (const auto& event : events)
+    {
+        bool falling = (event.event_type == gpiod::line_event::FALLING_EDGE);
+        timeline.addPgood(falling ? 0 : 1, TimelineRecorder::fromEventTimestamp(
+                                               event.timestamp));
+    }
+
+    checkPgood();
+}
+
+void PowerControl::checkPgood()
+{
     int pgoodState = pgoodLine.get_value();
     if (pgoodState != pgood)
     {
@@ -206,11 +307,35 @@ void PowerControl::pollPgood()
             emitPowerGoodSignal();
         }
         emitPropertyChangedSignal("pgood");
+        replyToPgoodWaiters();
     }
     if (pgoodState == state)
     {
         // Power good matches requested state
+        if (inStateTransition)
+        {
+            // Measured from the GPIO being set to the power good edge
+            auto time = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - transitionStart);
+            if (state)
+            {
+                powerOnTime = time;
+                emitPropertyChangedSignal("power_on_time");
+            }
+            else
+            {
+                powerOffTime = time;
+                emitPropertyChangedSignal("power_off_time");
+            }
+            log<level::INFO>(
+                fmt::format("Power state {} reached in {}ms", state.load(),
+                            time.count())
+                    .c_str());
+            sampleRailStates();
+            railTimer.setEnabled(false);
+        }
         inStateTransition = false;
+        timer.setEnabled(false);
     }
     else if (!inStateTransition && (pgoodState == 0))
     {
@@ -224,11 +349,117 @@ void PowerControl::pollPgood()
         method.append(util::POWEROFF_TARGET);
         method.append("replace");
         bus.call_noreply(method);
+
+        {
+            std::lock_guard<std::mutex> lock{deviceMutex};
+            if (device)
+            {
+                device->analyzeFaultSnapshot();
+            }
+        }
+        logPgoodFailure();
+    }
+}
+
+void PowerControl::logPgoodFailure()
+{
+    using namespace sdbusplus::xyz::openbmc_project::Logging::server;
+
+    std::map<std::string, std::string> additionalData;
+    // Add PID to AdditionalData
+    additionalData.emplace("_PID", std::to_string(getpid()));
+
+    // Copy the fault log, since the fault path thread may capture a new
+    // snapshot before the error is created.  It is stored in the error as a
+    // binary FFDC file.
+    std::vector<uint8_t> faultLog;
+    {
+        std::lock_guard<std::mutex> lock{deviceMutex};
+        if (device)
+        {
+            std::span<const uint8_t> deviceFaultLog = device->readFaultLog();
+            faultLog.assign(deviceFaultLog.begin(), deviceFaultLog.end());
+        }
+    }
+
+    errorLogQueue.submit("xyz.openbmc_project.Power.Error.Shutdown",
+                         Entry::Level::Critical, std::move(additionalData),
+                         std::move(faultLog));
+}
+
+void PowerControl::pgoodTimedOut()
+{
+    util::EventLoopLag::Scope lagScope{lagMonitor.getLag(),
+                                       "PowerControl::pgoodTimedOut"};
+
+    if (!inStateTransition)
+    {
+        return;
+    }
+
+    // Power good did not reach the requested state in time
+    log<level::ERR>("ERROR PowerControl: Pgood poll timeout");
+    inStateTransition = false;
+    sampleRailStates();
+    railTimer.setEnabled(false);
+
+    std::map<std::string, std::string> additionalData;
+    // Add PID to AdditionalData
+    additionalData.emplace("_PID", std::to_string(getpid()));
+
+    errorLogQueue.submit(
+        state ? "xyz.openbmc_project.Power.Error.PowerOnTimeout"
+              : "xyz.openbmc_project.Power.Error.PowerOffTimeout",
+        sdbusplus::xyz::openbmc_project::Logging::server::Entry::Level::
+            Critical,
+        std::move(additionalData));
+
+    // No longer in transition, so a power good that is off is a failure
+    checkPgood();
+}
+
+void PowerControl::sampleRailStates()
+{
+    util::EventLoopLag::Scope lagScope{lagMonitor.getLag(),
+                                       "PowerControl::sampleRailStates"};
+
+    // Copy the IDs, since the device may be replaced after it is unlocked
+    std::vector<int> values;
+    std::vector<unsigned int> ids;
+    {
+        std::lock_guard<std::mutex> lock{deviceMutex};
+        if (!device)
+        {
+            return;
+        }
+        values = device->readRailStates();
+        std::span<const unsigned int> deviceIds = device->getRailStateIds();
+        ids.assign(deviceIds.begin(), deviceIds.end());
+    }
+
+    timeline.addRailStates(ids, values, TimelineRecorder::Clock::now());
+
+    // Report the changes, so other applications can act as soon as the
+    // rails they need are on
+    if (ids.size() == values.size())
+    {
+        bool first = (railStates.size() != values.size());
+        for (size_t i = 0; i < values.size(); i++)
+        {
+            if (first || (railStates[i] != values[i]))
+            {
+                emitRailStateChangedSignal(ids[i], values[i]);
+            }
+        }
+        railStates = std::move(values);
     }
 }
 
 void PowerControl::setPgoodTimeout(int t)
 {
+    util::EventLoopLag::Scope lagScope{lagMonitor.getLag(),
+                                       "PowerControl::setPgoodTimeout"};
+
     if (timeout.count() != t)
     {
         timeout = std::chrono::seconds(t);
@@ -238,10 +469,14 @@ void PowerControl::setPgoodTimeout(int t)
 
 void PowerControl::setState(int s)
 {
+    util::EventLoopLag::Scope lagScope{lagMonitor.getLag(),
+                                       "PowerControl::setState"};
+
     if (state == s)
     {
         log<level::INFO>(
-            fmt::format("Power already at requested state: {}", state).c_str());
+            fmt::format("Power already at requested state: {}", state.load())
+                .c_str());
         return;
     }
     if (s == 0)
@@ -255,14 +490,80 @@ void PowerControl::setState(int s)
     powerControlLine.request(
         {"phosphor-power-control", gpiod::line_request::DIRECTION_OUTPUT, 0});
     powerControlLine.set_value(s);
+    transitionStart = std::chrono::steady_clock::now();
+
+    // Power good changes are handled as events; time out if the requested
+    // state is not reached.  The deadline is armed as soon as the GPIO is
+    // set, so the timeout and the measured transition time start together.
+    timer.restartOnce(timeout);
     powerControlLine.release();
 
-    pgoodTimeoutTime = std::chrono::steady_clock::now() + timeout;
+    // Sample the rail states until the transition ends, so the timeline shows
+    // the order the rails came up or went down in
+    timeline.startSequence(s, transitionStart);
+    railStates.clear();
+    sampleRailStates();
+    railTimer.restart(railSampleInterval);
+
     inStateTransition = true;
     state = s;
     emitPropertyChangedSignal("state");
 }
 
+void PowerControl::waitForPgood(sdbusplus::message::message&& msg, int s,
+                                std::chrono::milliseconds waitTimeout)
+{
+    util::EventLoopLag::Scope lagScope{lagMonitor.getLag(),
+                                       "PowerControl::waitForPgood"};
+
+    if (pgood == s)
+    {
+        replyToWaitForPgood(msg, true);
+        return;
+    }
+
+    pgoodWaiters.push_back(PgoodWaiter{
+        s, std::chrono::steady_clock::now() + waitTimeout, std::move(msg)});
+    replyToPgoodWaiters();
+}
+
+void PowerControl::replyToPgoodWaiters()
+{
+    util::EventLoopLag::Scope lagScope{lagMonitor.getLag(),
+                                       "PowerControl::replyToPgoodWaiters"};
+
+    auto now = std::chrono::steady_clock::now();
+    std::optional<std::chrono::steady_clock::time_point> nextDeadline;
+    std::erase_if(pgoodWaiters, [&](PgoodWaiter& waiter) {
+        if (waiter.state == pgood)
+        {
+            replyToWaitForPgood(waiter.msg, true);
+            return true;
+        }
+        if (waiter.deadline <= now)
+        {
+            replyToWaitForPgood(waiter.msg, false);
+            return true;
+        }
+        if (!nextDeadline || (waiter.deadline < *nextDeadline))
+        {
+            nextDeadline = waiter.deadline;
+        }
+        return false;
+    });
+
+    if (nextDeadline)
+    {
+        waitTimer.restartOnce(
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                *nextDeadline - now));
+    }
+    else
+    {
+        waitTimer.setEnabled(false);
+    }
+}
+
 void PowerControl::setUpDevice()
 {
     try
@@ -318,12 +619,42 @@ void PowerControl::setUpGpio()
         throw std::runtime_error(errorString);
     }
 
+    // Request events so power good changes are handled right away
     pgoodLine.request(
-        {"phosphor-power-control", gpiod::line_request::DIRECTION_INPUT, 0});
+        {"phosphor-power-control", gpiod::line_request::EVENT_BOTH_EDGES, 0});
     int pgoodState = pgoodLine.get_value();
     pgood = pgoodState;
     state = pgoodState;
     log<level::INFO>(fmt::format("Pgood state: {}", pgoodState).c_str());
+
+    if (faultPathOptions.isThreadRealtime())
+    {
+        // Handle the events on the fault path thread, which wakes the event
+        // loop with an eventfd
+        pgoodNotifyFD = util::FileDescriptor{
+            eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)};
+        if (!pgoodNotifyFD)
+        {
+            throw std::system_error{errno, std::generic_category(),
+                                    "Unable to create eventfd"};
+        }
+        pgoodEventSource = std::make_unique<sdeventplus::source::IO>(
+            timer.get_event(), pgoodNotifyFD(), EPOLLIN,
+            [this](sdeventplus::source::IO&, int, uint32_t) {
+                pgoodEventsQueued();
+            });
+
+        faultPathThread =
+            std::make_unique<util::FaultPathThread>(faultPathOptions);
+        faultPathThread->watch(pgoodLine.event_get_fd(),
+                               [this]() { pgoodChangedOnFaultPath(); });
+        faultPathThread->start();
+        return;
+    }
+
+    pgoodEventSource = std::make_unique<sdeventplus::source::IO>(
+        timer.get_event(), pgoodLine.event_get_fd(), EPOLLIN,
+        [this](sdeventplus::source::IO&, int, uint32_t) { pgoodChanged(); });
 }
 
 } // namespace phosphor::power::sequencer
@@ -1,7 +1,16 @@
 #pragma once
 
 #include "power_interface.hpp"
+#include "error_log_queue.hpp"
+#include "event_loop_lag.hpp"
+#include "event_loop_lag_interface.hpp"
+#include "event_loop_lag_monitor.hpp"
+#include "file_descriptor.hpp"
 #include "power_sequencer_monitor.hpp"
+#include "realtime.hpp"
+#include "startup_times.hpp"
+#include "startup_times_interface.hpp"
+#include "timeline_recorder.hpp"
 #include "utility.hpp"
 
 #include <gpiod.hpp>
@@ -11,9 +20,14 @@
 #include <sdbusplus/server/object.hpp>
 #include <sdeventplus/clock.hpp>
 #include <sdeventplus/event.hpp>
+#include <sdeventplus/source/io.hpp>
 #include <sdeventplus/utility/timer.hpp>
 
+#include <atomic>
 #include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 namespace phosphor::power::sequencer
 {
@@ -37,10 +51,19 @@ class PowerControl : public PowerObject
 
     /**
      * Creates a controller object for power on and off.
+     *
+     * If the fault path options set a priority or CPU affinity, the chassis
+     * power good GPIO line events are handled on a dedicated FaultPathThread
+     * with those options.  The thread captures the power sequencer fault
+     * snapshot as soon as power good drops, and the rest of the handling is
+     * done on the event loop.
+     *
      * @param[in] bus D-Bus bus object
      * @param[in] event event object
+     * @param[in] faultPathOptions scheduling options of the fault path thread
      */
-    PowerControl(sdbusplus::bus::bus& bus, const sdeventplus::Event& event);
+    PowerControl(sdbusplus::bus::bus& bus, const sdeventplus::Event& event,
+                 const util::RealtimeOptions& faultPathOptions = {});
 
     /** @copydoc PowerInterface::getPgood() */
     int getPgood() const override;
@@ -48,9 +71,29 @@ class PowerControl : public PowerObject
     /** @copydoc PowerInterface::getPgoodTimeout() */
     int getPgoodTimeout() const override;
 
+    /** @copydoc PowerInterface::getPowerOffTime() */
+    int getPowerOffTime() const override;
+
+    /** @copydoc PowerInterface::getPowerOnTime() */
+    int getPowerOnTime() const override;
+
     /** @copydoc PowerInterface::getState() */
     int getState() const override;
 
+    /** @copydoc PowerInterface::getTimeline() */
+    std::vector<TimelineEntry> getTimeline() const override;
+
+    /**
+     * Returns the startup times.  The controller is ready once the power
+     * sequencer device has been looked up and the power good GPIO read.
+     *
+     * @return startup times
+     */
+    util::StartupTimes& getStartupTimes()
+    {
+        return startupTimes;
+    }
+
     /**
      * Callback function to handle interfacesAdded D-Bus signals
      * @param msg Expanded sdbusplus message data
@@ -63,6 +106,10 @@ class PowerControl : public PowerObject
     /** @copydoc PowerInterface::setState() */
     void setState(int state) override;
 
+    /** @copydoc PowerInterface::waitForPgood() */
+    void waitForPgood(sdbusplus::message::message&& msg, int state,
+                      std::chrono::milliseconds timeout) override;
+
   private:
     /**
      * The D-Bus bus object
@@ -74,6 +121,12 @@ class PowerControl : public PowerObject
      */
     std::unique_ptr<PowerSequencerMonitor> device;
 
+    /**
+     * Serializes access to the device between the event loop and the fault
+     * path thread
+     */
+    std::mutex deviceMutex;
+
     /**
      * Indicates if a state transistion is taking place
      */
@@ -94,6 +147,28 @@ class PowerControl : public PowerObject
      */
     gpiod::line pgoodLine;
 
+    /**
+     * The eventfd the fault path thread notifies the event loop with
+     */
+    util::FileDescriptor pgoodNotifyFD;
+
+    /**
+     * Event source for chassis power good GPIO line events, or for the
+     * notifications from the fault path thread
+     */
+    std::unique_ptr<sdeventplus::source::IO> pgoodEventSource;
+
+    /**
+     * Serializes access to the pending power good events
+     */
+    std::mutex pgoodEventMutex;
+
+    /**
+     * The power good GPIO line events read by the fault path thread, which
+     * are not yet in the timeline
+     */
+    std::vector<gpiod::line_event> pendingPgoodEvents;
+
     /**
      * Power good timeout constant
      */
@@ -101,25 +176,40 @@ class PowerControl : public PowerObject
         std::chrono::seconds(10)};
 
     /**
-     * Point in time at which power good timeout will take place
+     * GPIO line object for power-on / power-off control
      */
-    std::chrono::time_point<std::chrono::steady_clock> pgoodTimeoutTime;
+    gpiod::line powerControlLine;
 
     /**
-     * Poll interval constant
+     * The measured time of the last power off
      */
-    static constexpr std::chrono::milliseconds pollInterval{
-        std::chrono::milliseconds(3000)};
+    std::chrono::milliseconds powerOffTime{0};
 
     /**
-     * GPIO line object for power-on / power-off control
+     * The measured time of the last power on
      */
-    gpiod::line powerControlLine;
+    std::chrono::milliseconds powerOnTime{0};
+
+    /**
+     * Interval the rail states are sampled on during a state transition
+     */
+    static constexpr std::chrono::milliseconds railSampleInterval{20};
+
+    /**
+     * Timer to sample the rail states during a state transition
+     */
+    sdeventplus::utility::Timer<sdeventplus::ClockId::Monotonic> railTimer;
+
+    /**
+     * The rail states last reported by RailStateChanged signals in the
+     * current state transition
+     */
+    std::vector<int> railStates;
 
     /**
-     * Power state
+     * Power state; also read by the fault path thread
      */
-    int state{0};
+    std::atomic<int> state{0};
 
     /**
      * Power good timeout
@@ -127,10 +217,90 @@ class PowerControl : public PowerObject
     std::chrono::seconds timeout{pgoodTimeout};
 
     /**
-     * Timer to poll the pgood
+     * The time the power control GPIO was set for the state transition
+     */
+    std::chrono::steady_clock::time_point transitionStart;
+
+    /**
+     * The timeline of the last power sequences
+     */
+    TimelineRecorder timeline;
+
+    /**
+     * Timer for the power good timeout during a state transition
      */
     sdeventplus::utility::Timer<sdeventplus::ClockId::Monotonic> timer;
 
+    /**
+     * A waitForPgood method call that has not been replied to
+     */
+    struct PgoodWaiter
+    {
+        /**
+         * The power good state waited for
+         */
+        int state;
+
+        /**
+         * When the wait times out
+         */
+        std::chrono::steady_clock::time_point deadline;
+
+        /**
+         * The method call
+         */
+        sdbusplus::message::message msg;
+    };
+
+    /**
+     * The waitForPgood method calls that have not been replied to
+     */
+    std::vector<PgoodWaiter> pgoodWaiters;
+
+    /**
+     * Timer for the earliest deadline of the waitForPgood method calls
+     */
+    sdeventplus::utility::Timer<sdeventplus::ClockId::Monotonic> waitTimer;
+
+    /**
+     * The error logs waiting to be created, so the event loop does not block
+     * on phosphor-logging
+     */
+    util::ErrorLogQueue errorLogQueue;
+
+    /**
+     * The scheduling options of the fault path thread
+     */
+    util::RealtimeOptions faultPathOptions;
+
+    /**
+     * The times of the startup phases: looking up the power sequencer device
+     * and reading the power good GPIO
+     */
+    util::StartupTimes startupTimes{};
+
+    /**
+     * Debug D-Bus interface that shows the startup times
+     */
+    util::StartupTimesInterface startupTimesInterface;
+
+    /**
+     * Probe that measures how late the event loop dispatches its handlers
+     */
+    util::EventLoopLagMonitor lagMonitor;
+
+    /**
+     * Debug D-Bus interface that shows the event loop lag
+     */
+    util::EventLoopLagInterface lagInterface;
+
+    /**
+     * The thread that handles the power good GPIO line events, if the fault
+     * path options require one.  Declared last, so it is stopped before the
+     * members it uses are destroyed.
+     */
+    std::unique_ptr<util::FaultPathThread> faultPathThread;
+
     /**
      * Get the device properties
      * @param[in] properties A map of property names and values
@@ -138,9 +308,51 @@ class PowerControl : public PowerObject
     void getDeviceProperties(util::DbusPropertyMap& properties);
 
     /**
-     * Polling method for monitoring the system power good
+     * Checks the system power good against the requested state
+     */
+    void checkPgood();
+
+    /**
+     * Creates the error log for a chassis power good failure, with the
+     * fault log of the power sequencer device attached, if any
+     */
+    void logPgoodFailure();
+
+    /**
+     * Callback for chassis power good GPIO line events
+     */
+    void pgoodChanged();
+
+    /**
+     * Called on the fault path thread for chassis power good GPIO line
+     * events.  Captures the fault snapshot if power good dropped while power
+     * is on, and notifies the event loop.
+     */
+    void pgoodChangedOnFaultPath();
+
+    /**
+     * Callback for the notifications from the fault path thread.  Adds the
+     * power good events to the timeline and checks the power good.
+     */
+    void pgoodEventsQueued();
+
+    /**
+     * Callback for the power good timeout during a state transition
+     */
+    void pgoodTimedOut();
+
+    /**
+     * Replies to the waitForPgood method calls that power good reached the
+     * state of, or that timed out, and arms the timer for the next deadline
+     */
+    void replyToPgoodWaiters();
+
+    /**
+     * Adds the rail states of the power sequencer device to the timeline, and
+     * emits a RailStateChanged signal for each rail whose state changed, or
+     * for every rail on the first sample of a state transition
      */
-    void pollPgood();
+    void sampleRailStates();
 
     /**
      * Set up power sequencer device
@@ -15,16 +15,67 @@
  */
 
 #include "power_control.hpp"
+#include "realtime.hpp"
+#include "startup_times.hpp"
 
+#include <CLI/CLI.hpp>
+#include <phosphor-logging/log.hpp>
 #include <sdbusplus/bus.hpp>
 #include <sdeventplus/event.hpp>
 
-int main()
+#include <exception>
+#include <string>
+
+using namespace phosphor::logging;
+using namespace phosphor::power;
+
+int main(int argc, char** argv)
 {
-    auto bus = sdbusplus::bus::new_default();
-    auto event = sdeventplus::Event::get_default();
-    bus.attach_event(event.get(), SD_EVENT_PRIORITY_NORMAL);
+    try
+    {
+        CLI::App app{"OpenBMC Power Control"};
+
+        util::RealtimeOptions faultPathOptions{};
+        app.add_option("--fault-priority", faultPathOptions.priority,
+                       "SCHED_FIFO priority of the thread that handles power "
+                       "good changes, or 0 for the normal policy")
+            ->check(CLI::Range(0, 99));
+        std::string faultCPUs{};
+        app.add_option("--fault-cpus", faultCPUs,
+                       "CPUs the thread that handles power good changes runs "
+                       "on, such as 0,2-3");
+        app.add_flag("--lock-memory", faultPathOptions.lockMemory,
+                     "Lock the memory of the process");
+        CLI11_PARSE(app, argc, argv);
+
+        if (!faultCPUs.empty())
+        {
+            faultPathOptions.cpus = util::parseCPUList(faultCPUs);
+        }
+        try
+        {
+            util::lockProcessMemory(faultPathOptions);
+        }
+        catch (const std::exception& e)
+        {
+            log<level::ERR>(e.what());
+        }
+
+        auto bus = sdbusplus::bus::new_default();
+        auto event = sdeventplus::Event::get_default();
+        bus.attach_event(event.get(), SD_EVENT_PRIORITY_NORMAL);
+
+        sequencer::PowerControl control{bus, event, faultPathOptions};
+
+        // Tell systemd when the power can be controlled
+        util::notifyReady(
+            {{"phosphor-power-control", &control.getStartupTimes()}});
 
-    phosphor::power::sequencer::PowerControl control{bus, event};
-    return event.loop();
+        return event.loop();
+    }
+    catch (const std::exception& e)
+    {
+        log<level::ERR>(e.what());
+        return -2;
+    }
 }
@@ -27,6 +27,7 @@
 
 #include <string>
 #include <tuple>
+#include <utility>
 
 using namespace phosphor::logging;
 
@@ -103,6 +104,74 @@ int PowerInterface::callbackGetPgoodTimeout(sd_bus* /*bus*/,
     return 1;
 }
 
+int PowerInterface::callbackGetPowerOffTime(sd_bus* /*bus*/,
+                                            const char* /*path*/,
+                                            const char* /*interface*/,
+                                            const char* /*property*/,
+                                            sd_bus_message* msg, void* context,
+                                            sd_bus_error* error)
+{
+    if (msg != nullptr && context != nullptr)
+    {
+        try
+        {
+            auto pwrObj = static_cast<PowerInterface*>(context);
+            int time = pwrObj->getPowerOffTime();
+            log<level::INFO>(
+                fmt::format("callbackGetPowerOffTime: {}", time).c_str());
+
+            sdbusplus::message::message(msg).append(time);
+        }
+        catch (const sdbusplus::exception_t& e)
+        {
+            return sd_bus_error_set(error, e.name(), e.description());
+        }
+    }
+    else
+    {
+        // The message or context were null
+        log<level::ERR>(
+            "Unable to service get power off time property callback");
+        return -1;
+    }
+
+    return 1;
+}
+
+int PowerInterface::callbackGetPowerOnTime(sd_bus* /*bus*/,
+                                           const char* /*path*/,
+                                           const char* /*interface*/,
+                                           const char* /*property*/,
+                                           sd_bus_message* msg, void* context,
+                                           sd_bus_error* error)
+{
+    if (msg != nullptr && context != nullptr)
+    {
+        try
+        {
+            auto pwrObj = static_cast<PowerInterface*>(context);
+            int time = pwrObj->getPowerOnTime();
+            log<level::INFO>(
+                fmt::format("callbackGetPowerOnTime: {}", time).c_str());
+
+            sdbusplus::message::message(msg).append(time);
+        }
+        catch (const sdbusplus::exception_t& e)
+        {
+            return sd_bus_error_set(error, e.name(), e.description());
+        }
+    }
+    else
+    {
+        // The message or context were null
+        log<level::ERR>(
+            "Unable to service get power on time property callback");
+        return -1;
+    }
+
+    return 1;
+}
+
 int PowerInterface::callbackGetPowerState(sd_bus_message* msg, void* context,
                                           sd_bus_error* error)
 {
@@ -136,6 +205,38 @@ int PowerInterface::callbackGetPowerState(sd_bus_message* msg, void* context,
     return 1;
 }
 
+int PowerInterface::callbackGetTimeline(sd_bus_message* msg, void* context,
+                                        sd_bus_error* error)
+{
+    if (msg != nullptr && context != nullptr)
+    {
+        try
+        {
+            auto pwrObj = static_cast<PowerInterface*>(context);
+            auto timeline = pwrObj->getTimeline();
+            log<level::INFO>(
+                fmt::format("callbackGetTimeline: {} events", timeline.size())
+                    .c_str());
+
+            auto reply = sdbusplus::message::message(msg).new_method_return();
+            reply.append(timeline);
+            reply.method_return();
+        }
+        catch (const sdbusplus::exception_t& e)
+        {
+            return sd_bus_error_set(error, e.name(), e.description());
+        }
+    }
+    else
+    {
+        // The message or context were null
+        log<level::ERR>("Unable to service getTimeline method callback");
+        return -1;
+    }
+
+    return 1;
+}
+
 int PowerInterface::callbackSetPgoodTimeout(sd_bus* /*bus*/,
                                             const char* /*path*/,
                                             const char* /*interface*/,
@@ -246,6 +347,68 @@ int PowerInterface::callbackSetPowerState(sd_bus_message* msg, void* context,
     return 1;
 }
 
+int PowerInterface::callbackWaitForPgood(sd_bus_message* msg, void* context,
+                                         sd_bus_error* error)
+{
+    if (msg != nullptr && context != nullptr)
+    {
+        try
+        {
+            auto m = sdbusplus::message::message(msg);
+
+            int state{};
+            int timeout{};
+            m.read(state, timeout);
+
+            if ((state != 1 && state != 0) || (timeout <= 0))
+            {
+                return sd_bus_error_set(error,
+                                        "org.openbmc.ControlPower.Error.Failed",
+                                        "Invalid power good state or timeout");
+            }
+
+            auto pwrObj = static_cast<PowerInterface*>(context);
+            log<level::INFO>(fmt::format("callbackWaitForPgood: {} {} ms",
+                                         state, timeout)
+                                 .c_str());
+
+            // The message holds a reference, so the reply can be sent once
+            // the wait is over
+            pwrObj->waitForPgood(std::move(m), state,
+                                 std::chrono::milliseconds{timeout});
+        }
+        catch (const sdbusplus::exception_t& e)
+        {
+            return sd_bus_error_set(error, e.name(), e.description());
+        }
+    }
+    else
+    {
+        // The message or context were null
+        log<level::ERR>("Unable to service waitForPgood method callback");
+        return -1;
+    }
+
+    return 1;
+}
+
+void PowerInterface::replyToWaitForPgood(sdbusplus::message::message& msg,
+                                         bool reached)
+{
+    try
+    {
+        auto reply = msg.new_method_return();
+        reply.append(reached);
+        reply.method_return();
+    }
+    catch (const sdbusplus::exception_t& e)
+    {
+        log<level::ERR>(
+            fmt::format("Unable to reply to waitForPgood: {}", e.what())
+                .c_str());
+    }
+}
+
 void PowerInterface::emitPowerGoodSignal()
 {
     log<level::INFO>("emitPowerGoodSignal");
@@ -258,6 +421,13 @@ void PowerInterface::emitPowerLostSignal()
     _serverInterface.new_signal("PowerLost").signal_send();
 }
 
+void PowerInterface::emitRailStateChangedSignal(uint32_t id, int32_t value)
+{
+    auto msg = _serverInterface.new_signal("RailStateChanged");
+    msg.append(id, value);
+    msg.signal_send();
+}
+
 void PowerInterface::emitPropertyChangedSignal(const char* property)
 {
     log<level::INFO>(
@@ -271,10 +441,21 @@ const sdbusplus::vtable::vtable_t PowerInterface::_vtable[] = {
     sdbusplus::vtable::method("setPowerState", "i", "", callbackSetPowerState),
     // Method getPowerState takes no parameters and returns int
     sdbusplus::vtable::method("getPowerState", "", "i", callbackGetPowerState),
+    // Method getTimeline takes no parameters and returns the events of the
+    // last power sequences: sequence, microseconds since the power request,
+    // event type, GPIO or rail ID, and value
+    sdbusplus::vtable::method("getTimeline", "", "a(utsui)",
+                              callbackGetTimeline),
+    // Method waitForPgood takes the power good state to wait for and a
+    // timeout in milliseconds, and returns true when power good reaches the
+    // state, or false when the timeout expires first
+    sdbusplus::vtable::method("waitForPgood", "ii", "b", callbackWaitForPgood),
     // Signal PowerGood
     sdbusplus::vtable::signal("PowerGood", ""),
     // Signal PowerLost
     sdbusplus::vtable::signal("PowerLost", ""),
+    // Signal RailStateChanged with the rail ID and its new state
+    sdbusplus::vtable::signal("RailStateChanged", "ui"),
     // Property pgood is type int, read only, and uses the emits_change flag
     sdbusplus::vtable::property("pgood", "i", callbackGetPgood,
                                 sdbusplus::vtable::property_::emits_change),
@@ -286,6 +467,14 @@ const sdbusplus::vtable::vtable_t PowerInterface::_vtable[] = {
     sdbusplus::vtable::property("pgood_timeout", "i", callbackGetPgoodTimeout,
                                 callbackSetPgoodTimeout,
                                 sdbusplus::vtable::property_::emits_change),
+    // Property power_on_time is type int, read only, and uses the
+    // emits_change flag
+    sdbusplus::vtable::property("power_on_time", "i", callbackGetPowerOnTime,
+                                sdbusplus::vtable::property_::emits_change),
+    // Property power_off_time is type int, read only, and uses the
+    // emits_change flag
+    sdbusplus::vtable::property("power_off_time", "i", callbackGetPowerOffTime,
+                                sdbusplus::vtable::property_::emits_change),
     sdbusplus::vtable::end()};
 
 } // namespace phosphor::power::sequencer
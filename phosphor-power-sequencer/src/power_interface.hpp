@@ -1,12 +1,18 @@
 #pragma once
 
+#include "timeline_recorder.hpp"
+
 #include <systemd/sd-bus.h>
 
+#include <sdbusplus/message.hpp>
 #include <sdbusplus/sdbus.hpp>
 #include <sdbusplus/server/interface.hpp>
 #include <sdbusplus/vtable.hpp>
 
+#include <chrono>
+#include <cstdint>
 #include <string>
+#include <vector>
 
 namespace phosphor::power::sequencer
 {
@@ -42,6 +48,14 @@ class PowerInterface
      */
     void emitPowerLostSignal();
 
+    /**
+     * Emit the rail state changed signal
+     * @param[in] id the ID of the rail, from
+     *               PowerSequencerMonitor::getRailStateIds()
+     * @param[in] value the new state of the rail, non-zero if it is on
+     */
+    void emitRailStateChangedSignal(uint32_t id, int32_t value);
+
     /**
      * Emit the property changed signal
      * @param[in] property the property that changed
@@ -60,6 +74,26 @@ class PowerInterface
      */
     virtual int getPgoodTimeout() const = 0;
 
+    /**
+     * Returns the measured time of the last power off, from the power off
+     * request to power good turning off
+     * @return power off time in milliseconds, 0 if none has been measured
+     */
+    virtual int getPowerOffTime() const = 0;
+
+    /**
+     * Returns the measured time of the last power on, from the power on
+     * request to power good turning on
+     * @return power on time in milliseconds, 0 if none has been measured
+     */
+    virtual int getPowerOnTime() const = 0;
+
+    /**
+     * Returns the timeline of the last power sequences
+     * @return the events of the sequences, oldest first
+     */
+    virtual std::vector<TimelineEntry> getTimeline() const = 0;
+
     /**
      * Returns the value of the last requested power state
      * @return power state. A power on request is value 1. Power off is 0.
@@ -79,6 +113,28 @@ class PowerInterface
      */
     virtual void setState(int state) = 0;
 
+    /**
+     * Waits for the chassis power good to reach a state.  The method call is
+     * replied to when power good reaches the state or the timeout expires,
+     * with true or false.  Replied to right away if power good is already in
+     * the state.
+     * @param[in] msg the waitForPgood method call to reply to
+     * @param[in] state the power good state to wait for, 1 for on or 0 for
+     * off
+     * @param[in] timeout the time to wait for
+     */
+    virtual void waitForPgood(sdbusplus::message::message&& msg, int state,
+                              std::chrono::milliseconds timeout) = 0;
+
+    /**
+     * Replies to a waitForPgood method call
+     * @param[in] msg the method call
+     * @param[in] reached true if power good reached the state, false if the
+     * wait timed out
+     */
+    static void replyToWaitForPgood(sdbusplus::message::message& msg,
+                                    bool reached);
+
   private:
     /**
      * Holder for the instance of this interface to be on dbus
@@ -109,12 +165,42 @@ class PowerInterface
                                        sd_bus_message* msg, void* context,
                                        sd_bus_error* error);
 
+    /**
+     * Systemd bus callback for getting the power_off_time property
+     */
+    static int callbackGetPowerOffTime(sd_bus* bus, const char* path,
+                                       const char* interface,
+                                       const char* property,
+                                       sd_bus_message* msg, void* context,
+                                       sd_bus_error* error);
+
+    /**
+     * Systemd bus callback for getting the power_on_time property
+     */
+    static int callbackGetPowerOnTime(sd_bus* bus, const char* path,
+                                      const char* interface,
+                                      const char* property,
+                                      sd_bus_message* msg, void* context,
+                                      sd_bus_error* error);
+
     /**
      * Systemd bus callback for the getPowerState method
      */
     static int callbackGetPowerState(sd_bus_message* msg, void* context,
                                      sd_bus_error* error);
 
+    /**
+     * Systemd bus callback for the getTimeline method
+     */
+    static int callbackGetTimeline(sd_bus_message* msg, void* context,
+                                   sd_bus_error* error);
+
+    /**
+     * Systemd bus callback for the waitForPgood method
+     */
+    static int callbackWaitForPgood(sd_bus_message* msg, void* context,
+                                    sd_bus_error* error);
+
     /**
      * Systemd bus callback for getting the state property
      */
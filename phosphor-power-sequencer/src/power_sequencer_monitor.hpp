@@ -1,5 +1,9 @@
 #pragma once
 
+#include <cstdint>
+#include <span>
+#include <vector>
+
 namespace phosphor::power::sequencer
 {
 
@@ -16,6 +20,53 @@ class PowerSequencerMonitor
     PowerSequencerMonitor(PowerSequencerMonitor&&) = delete;
     PowerSequencerMonitor& operator=(PowerSequencerMonitor&&) = delete;
     virtual ~PowerSequencerMonitor() = default;
+
+    /**
+     * Analyzes the device state saved by captureFaultSnapshot(), if any, and
+     * then discards it.  Runs after the power good failure has been handled.
+     */
+    virtual void analyzeFaultSnapshot()
+    {}
+
+    /**
+     * Reads the device state that identifies the first fault, as quickly as
+     * possible, and saves it for analyzeFaultSnapshot().  Called as soon as
+     * the chassis power good drops, before the registers change.  Replaces
+     * any earlier snapshot.
+     */
+    virtual void captureFaultSnapshot()
+    {}
+
+    /**
+     * Returns the IDs of the rail states returned by readRailStates()
+     * @return the IDs, empty if the device has no rail states
+     */
+    virtual std::span<const unsigned int> getRailStateIds() const
+    {
+        return {};
+    }
+
+    /**
+     * Reads the fault history kept by the device, to attach to the power
+     * good failure log.
+     * @return the data read, valid until the next call, or empty if there
+     *         is none
+     */
+    virtual std::span<const uint8_t> readFaultLog()
+    {
+        return {};
+    }
+
+    /**
+     * Reads the states of the rails, such as their enable and power good
+     * GPIOs, for the power sequence timeline
+     * @return the states, in the order of getRailStateIds(), or empty if
+     *         they could not be read
+     */
+    virtual std::vector<int> readRailStates()
+    {
+        return {};
+    }
 };
 
 } // namespace phosphor::power::sequencer
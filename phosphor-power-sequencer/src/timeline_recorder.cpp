@@ -0,0 +1,147 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "timeline_recorder.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace phosphor::power::sequencer
+{
+
+namespace
+{
+
+// The longest time from a GPIO edge to its event being read
+constexpr std::chrono::seconds maxEventAge{10};
+
+/**
+ * Returns the D-Bus name of an event type
+ * @param[in] type The event type
+ * @return the name
+ */
+const char* getTypeName(TimelineRecorder::EventType type)
+{
+    switch (type)
+    {
+        case TimelineRecorder::EventType::powerOnRequest:
+            return "PowerOnRequest";
+        case TimelineRecorder::EventType::powerOffRequest:
+            return "PowerOffRequest";
+        case TimelineRecorder::EventType::pgood:
+            return "Pgood";
+        case TimelineRecorder::EventType::railState:
+            return "RailState";
+    }
+    return "";
+}
+
+} // namespace
+
+TimelineRecorder::Clock::time_point
+    TimelineRecorder::fromEventTimestamp(std::chrono::nanoseconds timestamp)
+{
+    auto now = Clock::now();
+    Clock::time_point time{
+        std::chrono::duration_cast<Clock::duration>(timestamp)};
+    if ((time <= now) && ((now - time) < maxEventAge))
+    {
+        return time;
+    }
+    return now;
+}
+
+void TimelineRecorder::addPgood(int value, Clock::time_point time)
+{
+    add(EventType::pgood, 0, value, time);
+}
+
+void TimelineRecorder::addRailStates(std::span<const unsigned int> ids,
+                                     std::span<const int> values,
+                                     Clock::time_point time)
+{
+    if ((sequence == 0) || (ids.size() != values.size()))
+    {
+        return;
+    }
+
+    bool first = (railStates.size() != values.size());
+    for (size_t i = 0; i < values.size(); i++)
+    {
+        if (first || (railStates[i] != values[i]))
+        {
+            add(EventType::railState, ids[i], values[i], time);
+        }
+    }
+    railStates.assign(values.begin(), values.end());
+}
+
+std::vector<TimelineEntry> TimelineRecorder::getTimeline() const
+{
+    std::vector<TimelineEntry> timeline;
+    uint32_t firstSequence =
+        (sequence > MAX_SEQUENCES) ? (sequence - MAX_SEQUENCES + 1) : 1;
+    size_t oldest = (next + MAX_EVENTS - count) % MAX_EVENTS;
+
+    // Only sequences whose power request is still in the ring are returned,
+    // since the times are relative to it
+    uint32_t current{0};
+    Clock::time_point start{};
+    for (size_t i = 0; i < count; i++)
+    {
+        const Event& event = events[(oldest + i) % MAX_EVENTS];
+        if ((event.type == EventType::powerOnRequest) ||
+            (event.type == EventType::powerOffRequest))
+        {
+            current = event.sequence;
+            start = event.time;
+        }
+        if ((event.sequence != current) || (current < firstSequence))
+        {
+            continue;
+        }
+
+        auto offset = std::chrono::duration_cast<std::chrono::microseconds>(
+            event.time - start);
+        timeline.emplace_back(
+            event.sequence, std::max<int64_t>(offset.count(), 0),
+            getTypeName(event.type), event.id, event.value);
+    }
+    return timeline;
+}
+
+void TimelineRecorder::startSequence(int state, Clock::time_point time)
+{
+    sequence++;
+    railStates.clear();
+    add(state ? EventType::powerOnRequest : EventType::powerOffRequest, 0,
+        state, time);
+}
+
+void TimelineRecorder::add(EventType type, uint32_t id, int32_t value,
+                           Clock::time_point time)
+{
+    if (sequence == 0)
+    {
+        return;
+    }
+
+    events[next] = Event{time, sequence, type, id, value};
+    next = (next + 1) % MAX_EVENTS;
+    count = std::min(count + 1, MAX_EVENTS);
+}
+
+} // namespace phosphor::power::sequencer
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace phosphor::power::sequencer
+{
+
+/**
+ * An event of a power sequence as returned over D-Bus: the sequence number,
+ * the time since the power request in microseconds, the event type, the ID
+ * of the GPIO or rail, and its new value.
+ */
+using TimelineEntry =
+    std::tuple<uint32_t, uint64_t, std::string, uint32_t, int32_t>;
+
+/**
+ * @class TimelineRecorder
+ * Records the timeline of the power on and off sequences: the power request,
+ * the chassis power good edges, and the changes of the rail states of the
+ * power sequencer device.
+ *
+ * The events are kept in a fixed ring of MAX_EVENTS events, and the events
+ * of the last MAX_SEQUENCES sequences whose power request is still in the
+ * ring are returned by getTimeline().  All times are on the monotonic clock.
+ */
+class TimelineRecorder
+{
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * The types of the events in a timeline
+     */
+    enum class EventType : uint8_t
+    {
+        powerOnRequest,
+        powerOffRequest,
+        pgood,
+        railState
+    };
+
+    /**
+     * The number of events kept
+     */
+    static constexpr size_t MAX_EVENTS = 512;
+
+    /**
+     * The number of sequences returned by getTimeline()
+     */
+    static constexpr size_t MAX_SEQUENCES = 8;
+
+    TimelineRecorder() = default;
+    TimelineRecorder(const TimelineRecorder&) = delete;
+    TimelineRecorder& operator=(const TimelineRecorder&) = delete;
+    TimelineRecorder(TimelineRecorder&&) = delete;
+    TimelineRecorder& operator=(TimelineRecorder&&) = delete;
+    ~TimelineRecorder() = default;
+
+    /**
+     * Converts the timestamp of a kernel GPIO line event to a time point.
+     *
+     * Recent kernels timestamp line events with the monotonic clock, older
+     * ones with the real time clock.  A timestamp that is not a recent
+     * monotonic time is replaced by the current time.
+     * @param[in] timestamp The event timestamp
+     * @return the time of the event
+     */
+    static Clock::time_point
+        fromEventTimestamp(std::chrono::nanoseconds timestamp);
+
+    /**
+     * Adds a chassis power good edge to the current sequence
+     * @param[in] value The new power good value
+     * @param[in] time The time of the edge
+     */
+    void addPgood(int value, Clock::time_point time);
+
+    /**
+     * Adds the rail states that changed since the previous call, or all of
+     * them on the first call of a sequence, to the current sequence.
+     * @param[in] ids The IDs of the rails
+     * @param[in] values The states of the rails, in the order of the IDs
+     * @param[in] time The time the states were read
+     */
+    void addRailStates(std::span<const unsigned int> ids,
+                       std::span<const int> values, Clock::time_point time);
+
+    /**
+     * Returns the events of the last sequences, oldest first
+     * @return the events
+     */
+    std::vector<TimelineEntry> getTimeline() const;
+
+    /**
+     * Starts a new sequence with a power request
+     * @param[in] state The requested power state, 1 for on and 0 for off
+     * @param[in] time The time of the request
+     */
+    void startSequence(int state, Clock::time_point time);
+
+  private:
+    /**
+     * An event in the ring
+     */
+    struct Event
+    {
+        Clock::time_point time;
+        uint32_t sequence;
+        EventType type;
+        uint32_t id;
+        int32_t value;
+    };
+
+    /**
+     * Adds an event to the current sequence, replacing the oldest event if
+     * the ring is full.  Does nothing before the first sequence.
+     * @param[in] type The event type
+     * @param[in] id The ID of the GPIO or rail
+     * @param[in] value The new value
+     * @param[in] time The time of the event
+     */
+    void add(EventType type, uint32_t id, int32_t value,
+             Clock::time_point time);
+
+    /**
+     * The ring of events
+     */
+    std::array<Event, MAX_EVENTS> events{};
+
+    /**
+     * The index the next event is written to
+     */
+    size_t next{0};
+
+    /**
+     * The number of events in the ring
+     */
+    size_t count{0};
+
+    /**
+     * The number of the current sequence, 0 before the first one
+     */
+    uint32_t sequence{0};
+
+    /**
+     * The rail states last added in the current sequence
+     */
+    std::vector<int> railStates;
+};
+
+} // namespace phosphor::power::sequencer
@@ -24,6 +24,8 @@
 #include <phosphor-logging/log.hpp>
 #include <sdbusplus/bus.hpp>
 
+#include <exception>
+#include <filesystem>
 #include <map>
 #include <string>
 
@@ -49,12 +51,78 @@ UCD90320Monitor::UCD90320Monitor(sdbusplus::bus::bus& bus, std::uint8_t i2cBus,
     pmbusInterface{
         fmt::format("/sys/bus/i2c/devices/{}-{:04x}", i2cBus, i2cAddress)
             .c_str(),
-        "ucd9000", 0}
-
+        "ucd9000", 0},
+    loggedFaultReader{i2c::create(i2cBus, i2cAddress,
+                                  i2c::I2CInterface::InitialState::CLOSED)}
 {
     // Use the compatible system types information, if already available, to
     // load the configuration file
     findCompatibleSystemTypes();
+
+    setUpSnapshotGpios();
+}
+
+void UCD90320Monitor::analyzeFaultSnapshot()
+{
+    if (!snapshot)
+    {
+        return;
+    }
+
+    auto age = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - snapshot->timestamp);
+    auto toString = [](const std::optional<uint64_t>& value) {
+        return value ? fmt::format("{:#x}", *value) : std::string{"unknown"};
+    };
+
+    log<level::INFO>(
+        fmt::format("Power sequencer state when chassis pgood dropped {}ms "
+                    "ago, STATUS_WORD: {}, MFR_STATUS: {}, GPIOs: {}",
+                    age.count(), toString(snapshot->statusWord),
+                    toString(snapshot->mfrStatus), snapshot->gpioValues)
+            .c_str());
+
+    snapshot.reset();
+}
+
+void UCD90320Monitor::captureFaultSnapshot()
+{
+    static const std::vector<std::string> statusWordNames{pmbus::STATUS_WORD};
+    static const std::vector<std::string> mfrStatusNames{"mfr_status"};
+
+    // Read everything back to back, and only decode it afterwards.  Each
+    // register is one file read, and so one PMBus transaction, and the GPIOs
+    // are read with one request.
+    auto statusWord =
+        pmbusInterface.readStatusSnapshot(statusWordNames, pmbus::Type::Debug);
+    auto mfrStatus = pmbusInterface.readStatusSnapshot(
+        mfrStatusNames, pmbus::Type::HwmonDeviceDebug);
+
+    std::vector<int> gpioValues;
+    if (!gpioLines.empty())
+    {
+        try
+        {
+            gpioValues = gpioLines.get_values();
+        }
+        catch (const std::exception&)
+        {
+            // The snapshot is still useful without the GPIOs
+        }
+    }
+
+    FaultSnapshot data;
+    data.timestamp = statusWord.timestamp;
+    if (statusWord.isValid())
+    {
+        data.statusWord = statusWord.values.front();
+    }
+    if (mfrStatus.isValid())
+    {
+        data.mfrStatus = mfrStatus.values.front();
+    }
+    data.gpioValues = std::move(gpioValues);
+    snapshot = std::move(data);
 }
 
 void UCD90320Monitor::findCompatibleSystemTypes()
@@ -144,4 +212,86 @@ void UCD90320Monitor::interfacesAddedHandler(sdbusplus::message::message& msg)
     }
 }
 
+std::span<const uint8_t> UCD90320Monitor::readFaultLog()
+{
+    try
+    {
+        return loggedFaultReader.read();
+    }
+    catch (const std::exception& e)
+    {
+        log<level::ERR>(
+            fmt::format("Unable to read the power sequencer fault log, "
+                        "error {}",
+                        e.what())
+                .c_str());
+    }
+    return {};
+}
+
+std::vector<int> UCD90320Monitor::readRailStates()
+{
+    if (!gpioLines.empty())
+    {
+        try
+        {
+            return gpioLines.get_values();
+        }
+        catch (const std::exception&)
+        {
+            // A sample is skipped
+        }
+    }
+    return {};
+}
+
+void UCD90320Monitor::setUpSnapshotGpios()
+{
+    try
+    {
+        // The device driver provides a gpiochip under the device directory
+        std::filesystem::path chipPath;
+        for (const auto& entry :
+             std::filesystem::directory_iterator(pmbusInterface.path()))
+        {
+            if (entry.path().filename().string().starts_with("gpiochip"))
+            {
+                chipPath = "/dev" / entry.path().filename();
+                break;
+            }
+        }
+        if (chipPath.empty())
+        {
+            log<level::INFO>("No power sequencer GPIOs for fault snapshots");
+            return;
+        }
+
+        gpiod::chip chip{chipPath.string(), gpiod::chip::OPEN_BY_PATH};
+        for (unsigned int offset = 0; offset < chip.num_lines(); offset++)
+        {
+            auto line = chip.get_line(offset);
+            if (!line.is_used())
+            {
+                gpioLines.append(line);
+                gpioOffsets.push_back(offset);
+            }
+        }
+
+        if (!gpioLines.empty())
+        {
+            gpioLines.request({"phosphor-power-control",
+                               gpiod::line_request::DIRECTION_AS_IS, 0});
+        }
+    }
+    catch (const std::exception& e)
+    {
+        log<level::ERR>(
+            fmt::format("Unable to request power sequencer GPIOs, error {}",
+                        e.what())
+                .c_str());
+        gpioLines.clear();
+        gpioOffsets.clear();
+    }
+}
+
 } // namespace phosphor::power::sequencer
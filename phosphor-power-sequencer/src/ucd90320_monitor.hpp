@@ -1,14 +1,49 @@
 #pragma once
 
+#include "logged_fault_reader.hpp"
 #include "pmbus.hpp"
 #include "power_sequencer_monitor.hpp"
 
+#include <gpiod.hpp>
 #include <sdbusplus/bus.hpp>
 #include <sdbusplus/bus/match.hpp>
 
+#include <chrono>
+#include <optional>
+#include <string>
+#include <vector>
+
 namespace phosphor::power::sequencer
 {
 
+/**
+ * @struct FaultSnapshot
+ * The UCD90320 state read when the chassis power good dropped.
+ */
+struct FaultSnapshot
+{
+    /**
+     * The time the state was read
+     */
+    std::chrono::steady_clock::time_point timestamp;
+
+    /**
+     * STATUS_WORD, if it could be read
+     */
+    std::optional<uint64_t> statusWord;
+
+    /**
+     * MFR_STATUS, which includes the GPI fault bits, if it could be read
+     */
+    std::optional<uint64_t> mfrStatus;
+
+    /**
+     * The values of the device GPIOs, in the order of
+     * UCD90320Monitor::gpioOffsets, or empty if they could not be read
+     */
+    std::vector<int> gpioValues;
+};
+
 /**
  * @class UCD90320Monitor
  * This class implements fault analysis for the UCD90320
@@ -39,6 +74,35 @@ class UCD90320Monitor : public PowerSequencerMonitor
      */
     void interfacesAddedHandler(sdbusplus::message::message& msg);
 
+    /** @copydoc PowerSequencerMonitor::analyzeFaultSnapshot() */
+    void analyzeFaultSnapshot() override;
+
+    /** @copydoc PowerSequencerMonitor::captureFaultSnapshot() */
+    void captureFaultSnapshot() override;
+
+    /**
+     * Returns the offsets of the device GPIOs
+     * @return the offsets of the GPIOs returned by readRailStates()
+     */
+    std::span<const unsigned int> getRailStateIds() const override
+    {
+        return gpioOffsets;
+    }
+
+    /**
+     * Reads the LOGGED_FAULTS summary and the LOGGED_FAULT_DETAIL entries of
+     * the device.  See LoggedFaultReader.
+     * @return the data read, or empty if the log could not be read
+     */
+    std::span<const uint8_t> readFaultLog() override;
+
+    /**
+     * Reads the values of the device GPIOs, which are the rail enables and
+     * power goods, with one request
+     * @return the values, or empty if they could not be read
+     */
+    std::vector<int> readRailStates() override;
+
   private:
     /**
      * The D-Bus bus object
@@ -55,12 +119,40 @@ class UCD90320Monitor : public PowerSequencerMonitor
      */
     pmbus::PMBus pmbusInterface;
 
+    /**
+     * The offsets of the device GPIOs read in a fault snapshot
+     */
+    std::vector<unsigned int> gpioOffsets;
+
+    /**
+     * The device GPIOs read in a fault snapshot, requested once so a
+     * snapshot reads them all with one request
+     */
+    gpiod::line_bulk gpioLines;
+
+    /**
+     * The state read when the chassis power good last dropped, until it
+     * is analyzed
+     */
+    std::optional<FaultSnapshot> snapshot;
+
+    /**
+     * The reader of the non-volatile fault log
+     */
+    LoggedFaultReader loggedFaultReader;
+
     /**
      * Finds the list of compatible system types using D-Bus methods.
      * This list is used to find the correct JSON configuration file for the
      * current system.
      */
     void findCompatibleSystemTypes();
+
+    /**
+     * Requests the device GPIOs that are not used by anyone else, without
+     * changing their direction, so they can be read in fault snapshots.
+     */
+    void setUpSnapshotGpios();
 };
 
 } // namespace phosphor::power::sequencer
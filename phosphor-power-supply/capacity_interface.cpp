@@ -0,0 +1,62 @@
+#include "capacity_interface.hpp"
+
+#include <phosphor-logging/log.hpp>
+#include <sdbusplus/exception.hpp>
+#include <sdbusplus/message.hpp>
+#include <sdbusplus/server.hpp>
+
+namespace phosphor::power::manager
+{
+
+using namespace phosphor::logging;
+
+CapacityInterface::CapacityInterface(sdbusplus::bus::bus& bus,
+                                     const char* path) :
+    _serverInterface(bus, path, interface, _vtable, this)
+{}
+
+void CapacityInterface::capacityReduced(const std::string& psuPath,
+                                        const std::string& reason,
+                                        uint32_t working)
+{
+    try
+    {
+        auto signal = _serverInterface.new_signal("PowerCapacityReduced");
+        signal.append(sdbusplus::message::object_path{psuPath}, reason,
+                      working);
+        signal.signal_send();
+    }
+    catch (const sdbusplus::exception_t& e)
+    {
+        log<level::ERR>("Unable to emit PowerCapacityReduced signal",
+                        entry("ERROR=%s", e.what()));
+    }
+}
+
+void CapacityInterface::capacityRestored(const std::string& psuPath,
+                                         uint32_t working)
+{
+    try
+    {
+        auto signal = _serverInterface.new_signal("PowerCapacityRestored");
+        signal.append(sdbusplus::message::object_path{psuPath}, working);
+        signal.signal_send();
+    }
+    catch (const sdbusplus::exception_t& e)
+    {
+        log<level::ERR>("Unable to emit PowerCapacityRestored signal",
+                        entry("ERROR=%s", e.what()));
+    }
+}
+
+const sdbusplus::vtable::vtable_t CapacityInterface::_vtable[] = {
+    sdbusplus::vtable::start(),
+    // PowerCapacityReduced signal has the power supply inventory path, the
+    // reason, and the number of power supplies still working
+    sdbusplus::vtable::signal("PowerCapacityReduced", "osu"),
+    // PowerCapacityRestored signal has the power supply inventory path and
+    // the number of power supplies working
+    sdbusplus::vtable::signal("PowerCapacityRestored", "ou"),
+    sdbusplus::vtable::end()};
+
+} // namespace phosphor::power::manager
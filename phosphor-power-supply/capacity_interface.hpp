@@ -0,0 +1,84 @@
+#pragma once
+
+#include <systemd/sd-bus.h>
+
+#include <sdbusplus/bus.hpp>
+#include <sdbusplus/sdbus.hpp>
+#include <sdbusplus/server/interface.hpp>
+#include <sdbusplus/vtable.hpp>
+
+#include <cstdint>
+#include <string>
+
+namespace phosphor::power::manager
+{
+
+/**
+ * @class CapacityInterface
+ *
+ * D-Bus interface that signals changes in the power supply capacity, so
+ * host-side power capping can react before the faults are logged.
+ *
+ * Signals:
+ * - PowerCapacityReduced: a power supply lost its input, dropped PGOOD, or
+ *   was removed.  Arguments are the inventory path of the power supply, the
+ *   reason, and the number of power supplies still working.
+ * - PowerCapacityRestored: the power supply is working again.  Arguments
+ *   are the inventory path and the number of power supplies working.
+ */
+class CapacityInterface
+{
+  public:
+    CapacityInterface() = delete;
+    CapacityInterface(const CapacityInterface&) = delete;
+    CapacityInterface& operator=(const CapacityInterface&) = delete;
+    CapacityInterface(CapacityInterface&&) = delete;
+    CapacityInterface& operator=(CapacityInterface&&) = delete;
+    ~CapacityInterface() = default;
+
+    /**
+     * @brief Constructor to put the interface onto the bus at a path.
+     *
+     * @param[in] bus - Bus to attach to.
+     * @param[in] path - Path to attach at.
+     */
+    CapacityInterface(sdbusplus::bus::bus& bus, const char* path);
+
+    /**
+     * @brief This dbus interface's name
+     */
+    static constexpr auto interface = "xyz.openbmc_project.Power.Capacity";
+
+    /**
+     * @brief Emits the PowerCapacityReduced signal.
+     *
+     * @param[in] psuPath - Inventory path of the power supply
+     * @param[in] reason - Why the capacity was lost, such as "InputFault"
+     * @param[in] working - Number of power supplies still working
+     */
+    void capacityReduced(const std::string& psuPath, const std::string& reason,
+                         uint32_t working);
+
+    /**
+     * @brief Emits the PowerCapacityRestored signal.
+     *
+     * @param[in] psuPath - Inventory path of the power supply
+     * @param[in] working - Number of power supplies working
+     */
+    void capacityRestored(const std::string& psuPath, uint32_t working);
+
+  private:
+    /**
+     * @brief Systemd vtable structure that contains all the
+     * signals of this interface with their respective systemd attributes
+     */
+    static const sdbusplus::vtable::vtable_t _vtable[];
+
+    /**
+     * @brief Holder for the instance of this interface to be
+     * on dbus
+     */
+    sdbusplus::server::interface::interface _serverInterface;
+};
+
+} // namespace phosphor::power::manager
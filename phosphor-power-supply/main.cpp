@@ -13,18 +13,25 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include "bus_trace.hpp"
 #include "psu_manager.hpp"
+#include "realtime.hpp"
+#include "startup_times.hpp"
 
 #include <CLI/CLI.hpp>
 #include <phosphor-logging/log.hpp>
 #include <sdbusplus/bus.hpp>
 #include <sdeventplus/event.hpp>
 
+#include <chrono>
+#include <cstdint>
+#include <exception>
 #include <filesystem>
+#include <string>
 
 using namespace phosphor::power;
 
-int main(void)
+int main(int argc, char** argv)
 {
     try
     {
@@ -32,6 +39,82 @@ int main(void)
 
         CLI::App app{"OpenBMC Power Supply Unit Monitor"};
 
+        bool eventMode = false;
+        app.add_flag("-e,--event-mode", eventMode,
+                     "Detect faults using hwmon alarm notifications instead "
+                     "of polling every second");
+        bool parallel = false;
+        app.add_flag("-p,--parallel", parallel,
+                     "Read power supplies on different I2C buses in parallel");
+        bool batchDiscovery = false;
+        app.add_flag("-b,--batch-discovery", batchDiscovery,
+                     "Read the configuration from Entity Manager with one "
+                     "GetManagedObjects call");
+        size_t energyHistoryRecords = 0;
+        app.add_option("-H,--energy-history", energyHistoryRecords,
+                       "Number of 30 second input power history records "
+                       "computed from READ_EIN to keep for each power supply");
+        util::RealtimeOptions faultPathOptions{};
+        app.add_option("--fault-priority", faultPathOptions.priority,
+                       "SCHED_FIFO priority of the threads that read the "
+                       "power supply status, or 0 for the normal policy")
+            ->check(CLI::Range(0, 99));
+        std::string faultCPUs{};
+        app.add_option("--fault-cpus", faultCPUs,
+                       "CPUs the threads that read the power supply status "
+                       "run on, such as 0,2-3");
+        app.add_flag("--lock-memory", faultPathOptions.lockMemory,
+                     "Lock the memory of the process");
+        std::string throttleGPIOName{};
+        app.add_option("-t,--throttle-gpio", throttleGPIOName,
+                       "GPIO asserted while a power supply has lost capacity");
+        uint32_t pollInterval = 1000;
+        app.add_option("-i,--poll-interval", pollInterval,
+                       "Milliseconds between the analyses of each power "
+                       "supply when polling")
+            ->check(CLI::Range(10, 60000));
+        bool stagger = false;
+        app.add_flag("-s,--stagger", stagger,
+                     "Analyze the power supplies one at a time, spread over "
+                     "the poll interval");
+        uint32_t presenceSettle = 0;
+        app.add_option("--presence-settle", presenceSettle,
+                       "Milliseconds a presence GPIO must keep a new value "
+                       "before the change is applied")
+            ->check(CLI::Range(0, 10000));
+        std::string busTrace{};
+        app.add_option("--bus-trace", busTrace,
+                       "File to record the power supply accesses in, so they "
+                       "can be replayed by the benchmarks");
+        CLI11_PARSE(app, argc, argv);
+
+        if (!busTrace.empty())
+        {
+            // Started before the power supplies are created, so their
+            // devices are wrapped to record the accesses
+            try
+            {
+                i2c::startTrace(busTrace);
+            }
+            catch (const std::exception& e)
+            {
+                log<level::ERR>(e.what());
+            }
+        }
+
+        if (!faultCPUs.empty())
+        {
+            faultPathOptions.cpus = util::parseCPUList(faultCPUs);
+        }
+        try
+        {
+            util::lockProcessMemory(faultPathOptions);
+        }
+        catch (const std::exception& e)
+        {
+            log<level::ERR>(e.what());
+        }
+
         auto bus = sdbusplus::bus::new_default();
         auto event = sdeventplus::Event::get_default();
 
@@ -39,9 +122,20 @@ int main(void)
         // handle both sd_events (for the timers) and dbus signals.
         bus.attach_event(event.get(), SD_EVENT_PRIORITY_NORMAL);
 
-        manager::PSUManager manager(bus, event);
+        manager::PSUManager manager(bus, event, eventMode, parallel,
+                                    batchDiscovery, energyHistoryRecords,
+                                    faultPathOptions, throttleGPIOName,
+                                    std::chrono::milliseconds{pollInterval},
+                                    stagger,
+                                    std::chrono::milliseconds{presenceSettle});
+
+        // Tell systemd when the power supplies are being monitored
+        util::notifyReady(
+            {{"phosphor-psu-monitor", &manager.getStartupTimes()}});
 
-        return manager.run();
+        int rc = manager.run();
+        i2c::stopTrace();
+        return rc;
     }
     catch (const std::exception& e)
     {
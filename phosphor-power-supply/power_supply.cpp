@@ -2,6 +2,7 @@
 
 #include "power_supply.hpp"
 
+#include "trace.hpp"
 #include "types.hpp"
 #include "util.hpp"
 
@@ -9,10 +10,17 @@
 
 #include <xyz/openbmc_project/Common/Device/error.hpp>
 
+#include <algorithm>
+#include <array>
+#include <cerrno>
 #include <chrono>  // sleep_for()
 #include <cstdint> // uint8_t...
+#include <filesystem>
 #include <fstream>
+#include <future>
 #include <thread> // sleep_for()
+#include <utility>
+#include <vector>
 
 namespace phosphor::power::psu
 {
@@ -25,9 +33,14 @@ using namespace sdbusplus::xyz::openbmc_project::Common::Device::Error;
 
 PowerSupply::PowerSupply(sdbusplus::bus::bus& bus, const std::string& invpath,
                          std::uint8_t i2cbus, std::uint16_t i2caddr,
-                         const std::string& gpioLineName) :
+                         const std::string& gpioLineName,
+                         util::MatchDispatcher* inventoryMatches,
+                         PSUStateTable* stateTable) :
     bus(bus),
-    inventoryPath(invpath), bindPath("/sys/bus/i2c/drivers/ibm-cffps")
+    ownStates(stateTable ? nullptr : std::make_unique<PSUStateTable>()),
+    states(stateTable ? *stateTable : *ownStates), slot(states.add()),
+    i2cBus(i2cbus), i2cAddr(i2caddr), inventoryPath(invpath),
+    bindPath("/sys/bus/i2c/drivers/ibm-cffps")
 {
     if (inventoryPath.empty())
     {
@@ -66,17 +79,30 @@ PowerSupply::PowerSupply(sdbusplus::bus::bus& bus, const std::string& invpath,
         presenceGPIO = nullptr;
         // Setup the functions to call when the D-Bus inventory path for the
         // Present property changes.
-        presentMatch = std::make_unique<sdbusplus::bus::match_t>(
-            bus,
-            sdbusplus::bus::match::rules::propertiesChanged(inventoryPath,
-                                                            INVENTORY_IFACE),
-            [this](auto& msg) { this->inventoryChanged(msg); });
-
-        presentAddedMatch = std::make_unique<sdbusplus::bus::match_t>(
-            bus,
-            sdbusplus::bus::match::rules::interfacesAdded() +
-                sdbusplus::bus::match::rules::argNpath(0, inventoryPath),
-            [this](auto& msg) { this->inventoryAdded(msg); });
+        if (inventoryMatches != nullptr)
+        {
+            presentRegistration = inventoryMatches->propertiesChanged(
+                inventoryPath, INVENTORY_IFACE,
+                [this](auto& msg) { this->inventoryChanged(msg); });
+
+            presentAddedRegistration = inventoryMatches->interfacesAdded(
+                inventoryPath,
+                [this](auto& msg) { this->inventoryAdded(msg); });
+        }
+        else
+        {
+            presentMatch = std::make_unique<sdbusplus::bus::match_t>(
+                bus,
+                sdbusplus::bus::match::rules::propertiesChanged(
+                    inventoryPath, INVENTORY_IFACE),
+                [this](auto& msg) { this->inventoryChanged(msg); });
+
+            presentAddedMatch = std::make_unique<sdbusplus::bus::match_t>(
+                bus,
+                sdbusplus::bus::match::rules::interfacesAdded() +
+                    sdbusplus::bus::match::rules::argNpath(0, inventoryPath),
+                [this](auto& msg) { this->inventoryAdded(msg); });
+        }
 
         updatePresence();
         updateInventory();
@@ -128,7 +154,7 @@ void PowerSupply::updatePresence()
 {
     try
     {
-        present = getPresence(bus, inventoryPath);
+        setPresent(getPresence(bus, inventoryPath));
     }
     catch (const sdbusplus::exception::exception& e)
     {
@@ -143,17 +169,29 @@ void PowerSupply::updatePresence()
 
 void PowerSupply::updatePresenceGPIO()
 {
-    bool presentOld = present;
+    if (driverWork.valid())
+    {
+        // Apply the presence change once the driver is bound or unbound, and
+        // read the GPIO again on the next call
+        if (driverWorkDone)
+        {
+            driverWork.get();
+            applyPresenceChange(driverWorkPresent);
+        }
+        return;
+    }
+
+    bool newPresent = false;
 
     try
     {
         if (presenceGPIO->read() > 0)
         {
-            present = true;
+            newPresent = true;
         }
         else
         {
-            present = false;
+            newPresent = false;
         }
     }
     catch (const std::exception& e)
@@ -163,30 +201,106 @@ void PowerSupply::updatePresenceGPIO()
         throw;
     }
 
-    if (presentOld != present)
+    auto firstEdge = std::exchange(presenceEdgeSinceRead, std::nullopt);
+    if (newPresent == isPresent())
     {
-        log<level::DEBUG>(
-            fmt::format("presentOld: {} present: {}", presentOld, present)
+        if (pendingPresent)
+        {
+            // Went back before it settled
+            debounceStats.bounces++;
+            pendingPresent.reset();
+        }
+        return;
+    }
+
+    if (presenceSettleTime.count() > 0)
+    {
+        auto now = std::chrono::steady_clock::now();
+        if (!pendingPresent)
+        {
+            // The change started at the first edge since the last read
+            pendingPresent = newPresent;
+            pendingPresentTime = firstEdge.value_or(now);
+        }
+        if (now - std::max(pendingPresentTime, lastPresenceEdge) <
+            presenceSettleTime)
+        {
+            return;
+        }
+
+        auto settleTime = std::chrono::duration_cast<std::chrono::milliseconds>(
+            now - pendingPresentTime);
+        debounceStats.maxSettleTime =
+            std::max(debounceStats.maxSettleTime, settleTime);
+        pendingPresent.reset();
+        log<level::INFO>(
+            fmt::format("PSU {} presence settled to {} after {} ms. edges: {}, "
+                        "bounces: {}, changes: {}",
+                        inventoryPath, newPresent, settleTime.count(),
+                        debounceStats.edges, debounceStats.bounces,
+                        debounceStats.changes + 1)
                 .c_str());
-        if (present)
+    }
+
+    debounceStats.changes++;
+    log<level::DEBUG>(
+        fmt::format("presentOld: {} present: {}", isPresent(), newPresent)
+            .c_str());
+    startDriverWork(newPresent);
+}
+
+void PowerSupply::startDriverWork(bool newPresent)
+{
+    if (!driverWorkCallback)
+    {
+        if (newPresent)
         {
             std::this_thread::sleep_for(std::chrono::milliseconds(bindDelay));
-            bindOrUnbindDriver(present);
-            pmbusIntf->findHwmonDir();
-            onOffConfig(phosphor::pmbus::ON_OFF_CONFIG_CONTROL_PIN_ONLY);
-            clearFaults();
         }
-        else
+        bindOrUnbindDriver(newPresent);
+        applyPresenceChange(newPresent);
+        return;
+    }
+
+    // Only bindPath and bindDevice are used by the worker, and they do not
+    // change
+    driverWorkPresent = newPresent;
+    driverWorkDone = false;
+    driverWork = std::async(std::launch::async, [this, newPresent]() {
+        if (newPresent)
         {
-            bindOrUnbindDriver(present);
+            std::this_thread::sleep_for(std::chrono::milliseconds(bindDelay));
         }
+        bindOrUnbindDriver(newPresent);
+        driverWorkDone = true;
+        driverWorkCallback();
+    });
+}
 
-        auto invpath = inventoryPath.substr(strlen(INVENTORY_OBJ_PATH));
-        auto const lastSlashPos = invpath.find_last_of('/');
-        std::string prettyName = invpath.substr(lastSlashPos + 1);
-        setPresence(bus, invpath, present, prettyName);
-        updateInventory();
+void PowerSupply::applyPresenceChange(bool newPresent)
+{
+    setPresent(newPresent);
+    resetHealth();
+    vinSample.reset();
+    vinSampleTime.reset();
+    statusHistory.clear();
+    clearEnergyHistory();
+    if (isPresent())
+    {
+        pmbusIntf->findHwmonDir();
+        onOffConfig(phosphor::pmbus::ON_OFF_CONFIG_CONTROL_PIN_ONLY);
+        clearFaults();
+    }
+    else
+    {
+        pmbusIntf->clearStringCache();
     }
+
+    auto invpath = inventoryPath.substr(strlen(INVENTORY_OBJ_PATH));
+    auto const lastSlashPos = invpath.find_last_of('/');
+    std::string prettyName = invpath.substr(lastSlashPos + 1);
+    setPresence(bus, invpath, isPresent(), prettyName);
+    updateInventory();
 }
 
 void PowerSupply::determineMFRFault()
@@ -208,234 +322,488 @@ void PowerSupply::determineMFRFault()
         {
             psCS12VFault = true;
         }
+        if (psKillFault || ps12VcsFault || psCS12VFault)
+        {
+            markFaultDetected();
+        }
     }
 }
 
 void PowerSupply::analyze()
 {
-    using namespace phosphor::pmbus;
+    POWER_TRACE_SCOPE("PowerSupply::analyze", getDevicePath(), "");
+
+    analyzePresence();
+    analyzeStatus();
+    commitReadFailure();
+    publishEnergyHistory();
+}
 
+void PowerSupply::analyzePresence()
+{
     if (presenceGPIO)
     {
         updatePresenceGPIO();
     }
+}
+
+void PowerSupply::analyzeStatus()
+{
+    POWER_TRACE_SCOPE("PowerSupply::analyzeStatus", getDevicePath(), "");
 
-    if ((present) && (readFail < LOG_LIMIT))
+    using namespace phosphor::pmbus;
+
+    // Nothing is read while the device driver is being bound or unbound
+    if (isPresent() && !driverWork.valid() && shouldRead())
     {
-        try
+        // Read without the exception of a failed read, whose error log
+        // metadata would be lost since the log is committed on another
+        // thread.  The errno is kept for commitReadFailure() instead.
+        auto result = pmbusIntf->tryRead(STATUS_WORD, Type::Debug);
+        if (!result)
         {
-            statusWord = pmbusIntf->read(STATUS_WORD, Type::Debug);
-            // Read worked, reset the fail count.
-            readFail = 0;
-
-            if (statusWord)
+            statusReadFailed(result.error);
+        }
+        else
+        {
+            try
             {
-                statusInput = pmbusIntf->read(STATUS_INPUT, Type::Debug);
-                statusMFR = pmbusIntf->read(STATUS_MFR, Type::Debug);
-                statusCML = pmbusIntf->read(STATUS_CML, Type::Debug);
-                auto status0Vout = pmbusIntf->insertPageNum(STATUS_VOUT, 0);
-                statusVout = pmbusIntf->read(status0Vout, Type::Debug);
-                statusIout = pmbusIntf->read(STATUS_IOUT, Type::Debug);
-                statusFans12 = pmbusIntf->read(STATUS_FANS_1_2, Type::Debug);
-                statusTemperature =
-                    pmbusIntf->read(STATUS_TEMPERATURE, Type::Debug);
-                if (statusWord & status_word::CML_FAULT)
+                statusWord() = result.value;
+                if (health == Health::unresponsive)
                 {
-                    if (!cmlFault)
-                    {
-                        log<level::ERR>(
-                            fmt::format("CML fault: STATUS_WORD = {:#04x}, "
-                                        "STATUS_CML = {:#02x}",
-                                        statusWord, statusCML)
-                                .c_str());
-                    }
-
-                    cmlFault = true;
+                    log<level::INFO>(
+                        fmt::format("PSU {} is responsive again", inventoryPath)
+                            .c_str());
                 }
+                // Read worked, reset the fail count.
+                setHealth(Health::responsive);
+                probeInterval = 1;
+                readFail() = 0;
 
-                if (statusWord & status_word::INPUT_FAULT_WARN)
+                if (statusWord())
                 {
-                    if (!inputFault)
+                    if (!readStatusRegisters())
                     {
-                        log<level::ERR>(
-                            fmt::format("INPUT fault: STATUS_WORD = {:#04x}, "
-                                        "STATUS_MFR_SPECIFIC = {:#02x}, "
-                                        "STATUS_INPUT = {:#02x}",
-                                        statusWord, statusMFR, statusInput)
-                                .c_str());
+                        return;
                     }
+                    decodeStatusWord();
 
-                    inputFault = true;
-                }
-
-                if (statusWord & status_word::VOUT_OV_FAULT)
-                {
-                    if (!voutOVFault)
+                    if (isPgoodNegated(statusWord()))
                     {
-                        log<level::ERR>(
-                            fmt::format(
-                                "VOUT_OV_FAULT fault: STATUS_WORD = {:#04x}, "
-                                "STATUS_MFR_SPECIFIC = {:#02x}, "
-                                "STATUS_VOUT = {:#02x}",
-                                statusWord, statusMFR, statusVout)
-                                .c_str());
+                        // Deglitching starts from the first PGOOD fault seen
+                        markFaultDetected();
+                        if (pgoodFault() < DEGLITCH_LIMIT)
+                        {
+                            log<level::ERR>(
+                                fmt::format("PGOOD fault: "
+                                            "STATUS_WORD = {:#04x}, "
+                                            "STATUS_MFR_SPECIFIC = {:#02x}",
+                                            statusWord(), statusMFR)
+                                    .c_str());
+                        }
                     }
+                    addStatusSample();
 
-                    voutOVFault = true;
-                }
-
-                if (statusWord & status_word::IOUT_OC_FAULT)
-                {
-                    if (!ioutOCFault)
+                    if (statusWord() & status_word::MFR_SPECIFIC_FAULT)
                     {
-                        log<level::ERR>(
-                            fmt::format("IOUT fault: STATUS_WORD = {:#04x}, "
-                                        "STATUS_MFR_SPECIFIC = {:#02x}, "
-                                        "STATUS_IOUT = {:#02x}",
-                                        statusWord, statusMFR, statusIout)
-                                .c_str());
+                        determineMFRFault();
                     }
-
-                    ioutOCFault = true;
                 }
-
-                if ((statusWord & status_word::VOUT_FAULT) &&
-                    !(statusWord & status_word::VOUT_OV_FAULT))
+                else
                 {
-                    if (!voutUVFault)
-                    {
-                        log<level::ERR>(
-                            fmt::format(
-                                "VOUT_UV_FAULT fault: STATUS_WORD = {:#04x}, "
-                                "STATUS_MFR_SPECIFIC = {:#02x}, "
-                                "STATUS_VOUT = {:#02x}",
-                                statusWord, statusMFR, statusVout)
-                                .c_str());
-                    }
-
-                    voutUVFault = true;
+                    faults().reset();
+                    addStatusSample();
+                    psKillFault = false;
+                    ps12VcsFault = false;
+                    psCS12VFault = false;
                 }
 
-                if (statusWord & status_word::FAN_FAULT)
-                {
-                    if (!fanFault)
-                    {
-                        log<level::ERR>(
-                            fmt::format("FANS fault/warning: "
-                                        "STATUS_WORD = {:#04x}, "
-                                        "STATUS_MFR_SPECIFIC = {:#02x}, "
-                                        "STATUS_FANS_1_2 = {:#02x}",
-                                        statusWord, statusMFR, statusFans12)
-                                .c_str());
-                    }
+                sampleInputVoltage();
+                sampleEnergy();
+            }
+            catch (const ReadFailure& e)
+            {
+                statusReadFailed(EIO);
+            }
+        }
+    }
 
-                    fanFault = true;
-                }
+    // Forget the detection time once no fault remains or is being counted
+    if (!faults().any() && (pgoodFault() == 0) && (readFail() == 0) &&
+        !psKillFault && !ps12VcsFault && !psCS12VFault)
+    {
+        faultDetectedTime.reset();
+    }
+}
 
-                if (statusWord & status_word::TEMPERATURE_FAULT_WARN)
-                {
-                    if (!tempFault)
-                    {
-                        log<level::ERR>(
-                            fmt::format("TEMPERATURE fault/warning: "
-                                        "STATUS_WORD = {:#04x}, "
-                                        "STATUS_MFR_SPECIFIC = {:#02x}, "
-                                        "STATUS_TEMPERATURE = {:#02x}",
-                                        statusWord, statusMFR,
-                                        statusTemperature)
-                                .c_str());
-                    }
+void PowerSupply::addStatusSample()
+{
+    statusHistory.add({static_cast<uint16_t>(statusWord()),
+                       static_cast<uint8_t>(statusMFR),
+                       std::chrono::steady_clock::now()});
 
-                    tempFault = true;
-                }
+    // A PGOOD fault ends with the first good sample after it was deglitched
+    bool negated = isPgoodNegated(statusWord());
+    if (!negated && (pgoodFault() >= DEGLITCH_LIMIT))
+    {
+        pgoodSamples = 0;
+    }
+    pgoodSamples = std::min(pgoodSamples + 1, DEGLITCH_WINDOW);
+
+    bool wasCounting = (pgoodFault() > 0);
+    pgoodFault() = statusHistory.countNewest(
+        pgoodSamples, [](const StatusSample& sample) {
+            return isPgoodNegated(sample.statusWord);
+        });
+    if (wasCounting && (pgoodFault() == 0))
+    {
+        log<level::INFO>(
+            fmt::format("pgoodFault cleared path: {}", inventoryPath).c_str());
+    }
+}
 
-                if ((statusWord & status_word::POWER_GOOD_NEGATED) ||
-                    (statusWord & status_word::UNIT_IS_OFF))
-                {
-                    if (pgoodFault < DEGLITCH_LIMIT)
-                    {
-                        log<level::ERR>(
-                            fmt::format("PGOOD fault: "
-                                        "STATUS_WORD = {:#04x}, "
-                                        "STATUS_MFR_SPECIFIC = {:#02x}",
-                                        statusWord, statusMFR)
-                                .c_str());
-
-                        pgoodFault++;
-                    }
-                }
-                else
-                {
-                    pgoodFault = 0;
-                }
+void PowerSupply::statusReadFailed(int error)
+{
+    markFaultDetected();
+    recordReadFailure(error);
+}
 
-                if (statusWord & status_word::MFR_SPECIFIC_FAULT)
-                {
-                    if (!mfrFault)
-                    {
-                        log<level::ERR>(
-                            fmt::format("MFR fault: "
-                                        "STATUS_WORD = {:#04x} "
-                                        "STATUS_MFR_SPECIFIC = {:#02x}",
-                                        statusWord, statusMFR)
-                                .c_str());
-                    }
+void PowerSupply::sampleInputVoltage()
+{
+    using namespace phosphor::pmbus;
 
-                    mfrFault = true;
-                    determineMFRFault();
-                }
+    auto now = std::chrono::steady_clock::now();
+    if (vinSampleTime && (now - *vinSampleTime < VIN_SAMPLE_INTERVAL))
+    {
+        return;
+    }
 
-                if (statusWord & status_word::VIN_UV_FAULT)
-                {
-                    if (!vinUVFault)
-                    {
-                        log<level::ERR>(
-                            fmt::format("VIN_UV fault: STATUS_WORD = {:#04x}, "
-                                        "STATUS_MFR_SPECIFIC = {:#02x}, "
-                                        "STATUS_INPUT = {:#02x}",
-                                        statusWord, statusMFR, statusInput)
-                                .c_str());
-                    }
+    // A failure only discards the sample; getInputVoltage() then reads the
+    // input voltage itself and logs the error.
+    vinSampleTime = now;
+    try
+    {
+        // Millivolts to volts
+        auto inputVoltageStr = getBulkPMBus().readString(READ_VIN, Type::Hwmon);
+        vinSample = std::stod(inputVoltageStr) / 1000;
+    }
+    catch (const std::exception& e)
+    {
+        vinSample.reset();
+    }
+}
 
-                    vinUVFault = true;
-                }
+bool PowerSupply::shouldRead()
+{
+    if ((health == Health::unresponsive) && (cyclesUntilProbe > 0))
+    {
+        --cyclesUntilProbe;
+        return false;
+    }
+    return true;
+}
+
+void PowerSupply::recordReadFailure(int error)
+{
+    if (health == Health::unresponsive)
+    {
+        // Failed probe, wait twice as long before the next one
+        probeInterval = std::min(probeInterval * 2, MAX_PROBE_INTERVAL);
+        cyclesUntilProbe = probeInterval;
+        return;
+    }
+
+    readFail()++;
+    if (health == Health::responsive)
+    {
+        // One error log for each run of failures
+        readFailPending = true;
+        readFailErrno = error;
+        std::error_code ec;
+        auto devicePath = std::filesystem::canonical(getDevicePath(), ec);
+        readFailDevicePath = ec ? getDevicePath() : devicePath.string();
+        setHealth(Health::failing);
+    }
+    if (readFail() >= LOG_LIMIT)
+    {
+        log<level::INFO>(
+            fmt::format("PSU {} is unresponsive, probing with backoff",
+                        inventoryPath)
+                .c_str());
+        setHealth(Health::unresponsive);
+        probeInterval = 1;
+        cyclesUntilProbe = probeInterval;
+    }
+}
+
+void PowerSupply::setHealth(Health newHealth)
+{
+    if (newHealth != health)
+    {
+        auto now = std::chrono::steady_clock::now();
+        healthTime[static_cast<size_t>(health)] += now - healthSince;
+        healthSince = now;
+        health = newHealth;
+    }
+}
+
+void PowerSupply::resetHealth()
+{
+    setHealth(Health::responsive);
+    readFail() = 0;
+    probeInterval = 1;
+    cyclesUntilProbe = 0;
+}
+
+void PowerSupply::commitReadFailure()
+{
+    if (readFailPending)
+    {
+        using metadata = xyz::openbmc_project::Common::Device::ReadFailure;
+
+        readFailPending = false;
+        report<ReadFailure>(
+            metadata::CALLOUT_ERRNO(readFailErrno),
+            metadata::CALLOUT_DEVICE_PATH(readFailDevicePath.c_str()));
+    }
+}
+
+void PowerSupply::setPMBusScheduler(
+    std::shared_ptr<phosphor::pmbus::PMBusScheduler> scheduler)
+{
+    using namespace phosphor::pmbus;
+
+    // Both classes share the device, which the scheduler accesses from one
+    // thread at a time
+    std::shared_ptr<PMBusBase> device{std::move(pmbusIntf)};
+    pmbusIntf = std::make_unique<ScheduledPMBus>(device, scheduler,
+                                                 Priority::critical);
+    bulkPMBusIntf = std::make_unique<CachedPMBus>(
+        std::make_unique<ScheduledPMBus>(device, scheduler, Priority::bulk),
+        std::map<CachedPMBus::RegisterKey, std::chrono::milliseconds>{
+            {{Type::Hwmon, READ_VIN}, VIN_CACHE_TTL}});
+}
+
+void PowerSupply::enableEnergyHistory(const std::string& objectPath,
+                                      size_t numRecords)
+{
+    using namespace phosphor::power::history;
+
+    energyHistory = std::make_unique<EnergyHistory>(numRecords,
+                                                    ENERGY_SAMPLES_PER_RECORD);
+    energyAverage =
+        std::make_unique<Average>(bus, objectPath + '/' + Average::name);
+    energyMaximum =
+        std::make_unique<Maximum>(bus, objectPath + '/' + Maximum::name);
+}
+
+void PowerSupply::publishEnergyHistory()
+{
+    if (energyHistory && energyHistoryChanged)
+    {
+        energyHistoryChanged = false;
+        energyAverage->values(energyHistory->getAverageRecords());
+        energyMaximum->values(energyHistory->getMaximumRecords());
+    }
+}
+
+void PowerSupply::sampleEnergy()
+{
+    using namespace phosphor::pmbus;
+    using phosphor::power::history::EnergyHistory;
+
+    auto now = std::chrono::steady_clock::now();
+    if (!energyHistory || (energySampleTime &&
+                           (now - *energySampleTime < ENERGY_SAMPLE_INTERVAL)))
+    {
+        return;
+    }
+    energySampleTime = now;
+
+    // A power supply without READ_EIN reads no data, and adds no records
+    std::array<uint8_t, EnergyHistory::RAW_READING_SIZE> data;
+    auto bytes = getBulkPMBus().readBlock(READ_EIN, Type::HwmonDeviceDebug,
+                                          std::span{data});
+    auto timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
+                         std::chrono::system_clock::now().time_since_epoch())
+                         .count();
+    if (energyHistory->add(std::span<const uint8_t>{data.data(), bytes},
+                           timestamp))
+    {
+        energyHistoryChanged = true;
+    }
+}
+
+void PowerSupply::clearEnergyHistory()
+{
+    energySampleTime.reset();
+    if (energyHistory)
+    {
+        energyHistoryChanged = energyHistoryChanged ||
+                               (energyHistory->getNumRecords() > 0);
+        energyHistory->clear();
+    }
+}
+
+void PowerSupply::decodeStatusWord()
+{
+    using namespace phosphor::pmbus;
+
+    struct FaultDescriptor
+    {
+        // The fault decoded
+        StatusWordFault fault;
+
+        // STATUS_WORD bits that indicate the fault
+        uint64_t mask;
+
+        // STATUS_WORD bits that must be off for the fault
+        uint64_t excludeMask;
+
+        // Name used in the journal message
+        const char* name;
+
+        // Register included in the journal message, if any
+        const char* registerName;
+        uint64_t PowerSupply::*registerValue;
+    };
+
+    static constexpr std::array<FaultDescriptor, STATUS_WORD_FAULT_COUNT>
+        descriptors{{
+            {StatusWordFault::cml, status_word::CML_FAULT, 0, "CML fault",
+             "STATUS_CML", &PowerSupply::statusCML},
+            {StatusWordFault::input, status_word::INPUT_FAULT_WARN, 0,
+             "INPUT fault", "STATUS_INPUT", &PowerSupply::statusInput},
+            {StatusWordFault::voutOV, status_word::VOUT_OV_FAULT, 0,
+             "VOUT_OV_FAULT fault", "STATUS_VOUT", &PowerSupply::statusVout},
+            {StatusWordFault::ioutOC, status_word::IOUT_OC_FAULT, 0,
+             "IOUT fault", "STATUS_IOUT", &PowerSupply::statusIout},
+            {StatusWordFault::voutUV, status_word::VOUT_FAULT,
+             status_word::VOUT_OV_FAULT, "VOUT_UV_FAULT fault", "STATUS_VOUT",
+             &PowerSupply::statusVout},
+            {StatusWordFault::fan, status_word::FAN_FAULT, 0,
+             "FANS fault/warning", "STATUS_FANS_1_2",
+             &PowerSupply::statusFans12},
+            {StatusWordFault::temperature, status_word::TEMPERATURE_FAULT_WARN,
+             0, "TEMPERATURE fault/warning", "STATUS_TEMPERATURE",
+             &PowerSupply::statusTemperature},
+            {StatusWordFault::mfr, status_word::MFR_SPECIFIC_FAULT, 0,
+             "MFR fault", nullptr, nullptr},
+            {StatusWordFault::vinUV, status_word::VIN_UV_FAULT, 0,
+             "VIN_UV fault", "STATUS_INPUT", &PowerSupply::statusInput},
+        }};
+
+    std::bitset<STATUS_WORD_FAULT_COUNT> detected;
+    for (const auto& descriptor : descriptors)
+    {
+        if ((statusWord() & descriptor.mask) &&
+            !(statusWord() & descriptor.excludeMask))
+        {
+            detected.set(static_cast<size_t>(descriptor.fault));
+        }
+    }
+
+    // Faults stay set until STATUS_WORD is zero, so only log new ones
+    auto newFaults = detected & ~faults();
+    faults() |= detected;
+    if (newFaults.none())
+    {
+        return;
+    }
+    markFaultDetected();
+
+    for (const auto& descriptor : descriptors)
+    {
+        if (!newFaults.test(static_cast<size_t>(descriptor.fault)))
+        {
+            continue;
+        }
+
+        auto message = fmt::format("{}: STATUS_WORD = {:#04x}, "
+                                   "STATUS_MFR_SPECIFIC = {:#02x}",
+                                   descriptor.name, statusWord(), statusMFR);
+        if (descriptor.registerName != nullptr)
+        {
+            message += fmt::format(", {} = {:#02x}", descriptor.registerName,
+                                   this->*descriptor.registerValue);
+        }
+        log<level::ERR>(message.c_str());
+    }
+}
+
+bool PowerSupply::readStatusRegisters()
+{
+    using namespace phosphor::pmbus;
+
+    struct StatusRegister
+    {
+        const char* name;
+        uint64_t* value;
+        uint64_t summaryBits;
+    };
+
+    // The summary bits in STATUS_WORD for each secondary register.
+    // STATUS_MFR is always read since it is logged with every fault.
+    const std::array<StatusRegister, 7> registers{{
+        {STATUS_INPUT, &statusInput,
+         status_word::INPUT_FAULT_WARN | status_word::VIN_UV_FAULT},
+        {STATUS_MFR, &statusMFR, ~0ull},
+        {STATUS_CML, &statusCML, status_word::CML_FAULT},
+        {STATUS_VOUT, &statusVout,
+         status_word::VOUT_FAULT | status_word::VOUT_OV_FAULT},
+        {STATUS_IOUT, &statusIout,
+         status_word::IOUT_POUT_FAULT | status_word::IOUT_OC_FAULT},
+        {STATUS_FANS_1_2, &statusFans12, status_word::FAN_FAULT},
+        {STATUS_TEMPERATURE, &statusTemperature,
+         status_word::TEMPERATURE_FAULT_WARN},
+    }};
+
+    std::vector<std::string> statusNames;
+    std::vector<uint64_t*> statusValues;
+    for (const auto& reg : registers)
+    {
+        // Without its summary bit, the register has no fault to report
+        *reg.value = 0;
+        if (statusWord() & reg.summaryBits)
+        {
+            if (reg.value == &statusVout)
+            {
+                // Page will need to be set to 0 to read STATUS_VOUT.
+                statusNames.push_back(pmbusIntf->insertPageNum(reg.name, 0));
             }
             else
             {
-                cmlFault = false;
-                inputFault = false;
-                mfrFault = false;
-                vinUVFault = false;
-                voutOVFault = false;
-                ioutOCFault = false;
-                voutUVFault = false;
-                fanFault = false;
-                tempFault = false;
-                if (pgoodFault > 0)
-                {
-                    log<level::INFO>(fmt::format("pgoodFault cleared path: {}",
-                                                 inventoryPath)
-                                         .c_str());
-                    pgoodFault = 0;
-                }
-                psKillFault = false;
-                ps12VcsFault = false;
-                psCS12VFault = false;
+                statusNames.push_back(reg.name);
             }
+            statusValues.push_back(reg.value);
         }
-        catch (const ReadFailure& e)
+    }
+
+    auto snapshot = pmbusIntf->readStatusSnapshot(statusNames, Type::Debug);
+    for (size_t i = 0; i < statusNames.size(); i++)
+    {
+        if (!snapshot.valid[i])
         {
-            readFail++;
-            phosphor::logging::commit<ReadFailure>();
+            // Read it again to get the errno of the failure
+            auto result = pmbusIntf->tryRead(statusNames[i], Type::Debug);
+            if (!result)
+            {
+                statusReadFailed(result.error);
+                return false;
+            }
+            snapshot.values[i] = result.value;
         }
+        *statusValues[i] = snapshot.values[i];
     }
+
+    return true;
 }
 
 void PowerSupply::onOffConfig(uint8_t data)
 {
     using namespace phosphor::pmbus;
 
-    if (present)
+    if (isPresent())
     {
         log<level::INFO>("ON_OFF_CONFIG write", entry("DATA=0x%02X", data));
         try
@@ -457,30 +825,34 @@ void PowerSupply::onOffConfig(uint8_t data)
 
 void PowerSupply::clearFaults()
 {
-    faultLogged = false;
+    states.faultLogged[slot] = 0;
+    faultDetectedTime.reset();
     // The PMBus device driver does not allow for writing CLEAR_FAULTS
     // directly. However, the pmbus hwmon device driver code will send a
     // CLEAR_FAULTS after reading from any of the hwmon "files" in sysfs, so
     // reading in1_input should result in clearing the fault bits in
     // STATUS_BYTE/STATUS_WORD.
     // I do not care what the return value is.
-    if (present)
+    if (isPresent())
     {
-        inputFault = false;
-        mfrFault = false;
+        faults().reset();
         statusMFR = 0;
-        vinUVFault = false;
-        cmlFault = false;
-        voutOVFault = false;
-        ioutOCFault = false;
-        voutUVFault = false;
-        fanFault = false;
-        tempFault = false;
-        pgoodFault = 0;
+        pgoodFault() = 0;
+        pgoodSamples = 0;
         psKillFault = false;
         ps12VcsFault = false;
         psCS12VFault = false;
-        readFail = 0;
+        if (health == Health::unresponsive)
+        {
+            // Probe it once on the next analyze() rather than reading it
+            // LOG_LIMIT more times
+            cyclesUntilProbe = 0;
+        }
+        else
+        {
+            setHealth(Health::responsive);
+            readFail() = 0;
+        }
 
         try
         {
@@ -507,9 +879,13 @@ void PowerSupply::inventoryChanged(sdbusplus::message::message& msg)
     auto valPropMap = msgData.find(PRESENT_PROP);
     if (valPropMap != msgData.end())
     {
+        resetHealth();
+        vinSample.reset();
+        vinSampleTime.reset();
+        clearEnergyHistory();
         if (std::get<bool>(valPropMap->second))
         {
-            present = true;
+            setPresent(true);
             // TODO: Immediately trying to read or write the "files" causes
             // read or write failures.
             using namespace std::chrono_literals;
@@ -521,7 +897,8 @@ void PowerSupply::inventoryChanged(sdbusplus::message::message& msg)
         }
         else
         {
-            present = false;
+            setPresent(false);
+            pmbusIntf->clearStringCache();
 
             // Clear out the now outdated inventory properties
             updateInventory();
@@ -547,10 +924,10 @@ void PowerSupply::inventoryAdded(sdbusplus::message::message& msg)
             auto property = properties->second.find(PRESENT_PROP);
             if (property != properties->second.end())
             {
-                present = std::get<bool>(property->second);
+                setPresent(std::get<bool>(property->second));
 
                 log<level::INFO>(fmt::format("Power Supply {} Present {}",
-                                             inventoryPath, present)
+                                             inventoryPath, isPresent())
                                      .c_str());
 
                 updateInventory();
@@ -564,11 +941,6 @@ void PowerSupply::updateInventory()
     using namespace phosphor::pmbus;
 
 #if IBM_VPD
-    std::string ccin;
-    std::string pn;
-    std::string fn;
-    std::string header;
-    std::string sn;
     using PropertyMap =
         std::map<std::string,
                  std::variant<std::string, std::vector<uint8_t>, bool>>;
@@ -586,83 +958,122 @@ void PowerSupply::updateInventory()
         fmt::format("updateInventory() inventoryPath: {}", inventoryPath)
             .c_str());
 
-    if (present)
+    if (!isPresent())
     {
-        // TODO: non-IBM inventory updates?
+        // The VPD must be read again when a power supply is installed
+        inventoryCurrent = false;
+        return;
+    }
+
+    if (inventoryCurrent)
+    {
+        // Presence has not changed since the inventory was updated
+        log<level::DEBUG>(
+            fmt::format("Inventory already current. inventoryPath: {}",
+                        inventoryPath)
+                .c_str());
+        return;
+    }
+
+    // TODO: non-IBM inventory updates?
 
 #if IBM_VPD
+    // Reads a VPD value, ignoring read failures.  Let the pmbus code
+    // indicate the failure.
+    // TODO - ibm918
+    // https://github.com/openbmc/docs/blob/master/designs/vpd-collection.md
+    // The BMC must log errors if any of the VPD cannot be properly
+    // parsed or fails ECC checks.
+    auto readVPD = [this](const std::string& name) {
+        std::optional<std::string> value;
         try
         {
-            ccin = pmbusIntf->readString(CCIN, Type::HwmonDeviceDebug);
-            assetProps.emplace(MODEL_PROP, ccin);
-            modelName = ccin;
+            // The VPD only changes when the power supply is replaced
+            value = getBulkPMBus().readCachedString(
+                name, Type::HwmonDeviceDebug, false);
         }
         catch (const ReadFailure& e)
-        {
-            // Ignore the read failure, let pmbus code indicate failure,
-            // path...
-            // TODO - ibm918
-            // https://github.com/openbmc/docs/blob/master/designs/vpd-collection.md
-            // The BMC must log errors if any of the VPD cannot be properly
-            // parsed or fails ECC checks.
-        }
+        {}
+        return value;
+    };
+
+    InventoryVPD vpd;
+    vpd.ccin = readVPD(CCIN);
+    vpd.pn = readVPD(PART_NUMBER);
+    vpd.fn = readVPD(FRU_NUMBER);
+    vpd.header = readVPD(SERIAL_HEADER);
+    if (vpd.header)
+    {
+        vpd.sn = readVPD(SERIAL_NUMBER);
+    }
+    vpd.fwVersion = readVPD(FW_VERSION);
 
-        try
-        {
-            pn = pmbusIntf->readString(PART_NUMBER, Type::HwmonDeviceDebug);
-            assetProps.emplace(PN_PROP, pn);
-        }
-        catch (const ReadFailure& e)
-        {
-            // Ignore the read failure, let pmbus code indicate failure,
-            // path...
-        }
+    if (vpd.ccin)
+    {
+        modelName = *vpd.ccin;
+    }
+    if (vpd.fwVersion)
+    {
+        fwVersion = *vpd.fwVersion;
+    }
 
-        try
-        {
-            fn = pmbusIntf->readString(FRU_NUMBER, Type::HwmonDeviceDebug);
-            assetProps.emplace(SPARE_PN_PROP, fn);
-        }
-        catch (const ReadFailure& e)
-        {
-            // Ignore the read failure, let pmbus code indicate failure,
-            // path...
-        }
+    // Only the properties that changed since the last update are published
+    auto changed = [this, &vpd](auto member) {
+        return !publishedVPD || ((*publishedVPD).*member != vpd.*member);
+    };
+    auto toBytes = [](const std::optional<std::string>& value) {
+        std::string s = value.value_or("");
+        return std::vector<uint8_t>(s.begin(), s.end());
+    };
 
-        try
+    if (changed(&InventoryVPD::ccin))
+    {
+        if (vpd.ccin)
         {
-            header =
-                pmbusIntf->readString(SERIAL_HEADER, Type::HwmonDeviceDebug);
-            sn = pmbusIntf->readString(SERIAL_NUMBER, Type::HwmonDeviceDebug);
-            assetProps.emplace(SN_PROP, sn);
+            assetProps.emplace(MODEL_PROP, *vpd.ccin);
         }
-        catch (const ReadFailure& e)
+        ipzvpdVINIProps.emplace("CC", toBytes(vpd.ccin));
+    }
+
+    if (changed(&InventoryVPD::pn))
+    {
+        if (vpd.pn)
         {
-            // Ignore the read failure, let pmbus code indicate failure,
-            // path...
+            assetProps.emplace(PN_PROP, *vpd.pn);
         }
+        ipzvpdVINIProps.emplace("PN", toBytes(vpd.pn));
+    }
 
-        try
+    if (changed(&InventoryVPD::fn))
+    {
+        if (vpd.fn)
         {
-            fwVersion =
-                pmbusIntf->readString(FW_VERSION, Type::HwmonDeviceDebug);
-            versionProps.emplace(VERSION_PROP, fwVersion);
+            assetProps.emplace(SPARE_PN_PROP, *vpd.fn);
         }
-        catch (const ReadFailure& e)
+        ipzvpdVINIProps.emplace("FN", toBytes(vpd.fn));
+    }
+
+    if (changed(&InventoryVPD::header) || changed(&InventoryVPD::sn))
+    {
+        if (vpd.sn)
         {
-            // Ignore the read failure, let pmbus code indicate failure,
-            // path...
+            assetProps.emplace(SN_PROP, *vpd.sn);
         }
-
-        ipzvpdVINIProps.emplace("CC",
-                                std::vector<uint8_t>(ccin.begin(), ccin.end()));
-        ipzvpdVINIProps.emplace("PN",
-                                std::vector<uint8_t>(pn.begin(), pn.end()));
-        ipzvpdVINIProps.emplace("FN",
-                                std::vector<uint8_t>(fn.begin(), fn.end()));
-        std::string header_sn = header + sn + '\0';
+        std::string header_sn =
+            vpd.header.value_or("") + vpd.sn.value_or("") + '\0';
         ipzvpdVINIProps.emplace(
             "SN", std::vector<uint8_t>(header_sn.begin(), header_sn.end()));
+    }
+
+    if (changed(&InventoryVPD::fwVersion) && vpd.fwVersion)
+    {
+        versionProps.emplace(VERSION_PROP, *vpd.fwVersion);
+    }
+
+    // The description and location keywords never change, so they are only
+    // published the first time.
+    if (!publishedVPD)
+    {
         std::string description = "IBM PS";
         ipzvpdVINIProps.emplace(
             "DR", std::vector<uint8_t>(description.begin(), description.end()));
@@ -681,46 +1092,61 @@ void PowerSupply::updateInventory()
         fl.resize(FL_KW_SIZE, ' ');
         ipzvpdDINFProps.emplace("FL",
                                 std::vector<uint8_t>(fl.begin(), fl.end()));
+    }
 
+    if (!assetProps.empty())
+    {
         interfaces.emplace(ASSET_IFACE, std::move(assetProps));
+    }
+    if (!versionProps.empty())
+    {
         interfaces.emplace(VERSION_IFACE, std::move(versionProps));
+    }
+    if (!ipzvpdDINFProps.empty())
+    {
         interfaces.emplace(DINF_IFACE, std::move(ipzvpdDINFProps));
+    }
+    if (!ipzvpdVINIProps.empty())
+    {
         interfaces.emplace(VINI_IFACE, std::move(ipzvpdVINIProps));
+    }
 
-        // Update the Functional
-        operProps.emplace(FUNCTIONAL_PROP, present);
-        interfaces.emplace(OPERATIONAL_STATE_IFACE, std::move(operProps));
+    // Update the Functional.  Always published since presence changed.
+    operProps.emplace(FUNCTIONAL_PROP, isPresent());
+    interfaces.emplace(OPERATIONAL_STATE_IFACE, std::move(operProps));
 
-        auto path = inventoryPath.substr(strlen(INVENTORY_OBJ_PATH));
-        object.emplace(path, std::move(interfaces));
+    auto path = inventoryPath.substr(strlen(INVENTORY_OBJ_PATH));
+    object.emplace(path, std::move(interfaces));
 
-        try
+    try
+    {
+        auto service =
+            util::getService(INVENTORY_OBJ_PATH, INVENTORY_MGR_IFACE, bus);
+
+        if (service.empty())
         {
-            auto service =
-                util::getService(INVENTORY_OBJ_PATH, INVENTORY_MGR_IFACE, bus);
+            log<level::ERR>("Unable to get inventory manager service");
+            return;
+        }
 
-            if (service.empty())
-            {
-                log<level::ERR>("Unable to get inventory manager service");
-                return;
-            }
+        auto method = bus.new_method_call(service.c_str(), INVENTORY_OBJ_PATH,
+                                          INVENTORY_MGR_IFACE, "Notify");
 
-            auto method =
-                bus.new_method_call(service.c_str(), INVENTORY_OBJ_PATH,
-                                    INVENTORY_MGR_IFACE, "Notify");
+        method.append(std::move(object));
 
-            method.append(std::move(object));
+        auto reply = bus.call(method);
 
-            auto reply = bus.call(method);
-        }
-        catch (const std::exception& e)
-        {
-            log<level::ERR>(
-                std::string(e.what() + std::string(" PATH=") + inventoryPath)
-                    .c_str());
-        }
-#endif
+        // Only skip the next update once the values are on D-Bus
+        publishedVPD = std::move(vpd);
+        inventoryCurrent = true;
     }
+    catch (const std::exception& e)
+    {
+        log<level::ERR>(
+            std::string(e.what() + std::string(" PATH=") + inventoryPath)
+                .c_str());
+    }
+#endif
 }
 
 void PowerSupply::getInputVoltage(double& actualInputVoltage,
@@ -731,15 +1157,25 @@ void PowerSupply::getInputVoltage(double& actualInputVoltage,
     actualInputVoltage = in_input::VIN_VOLTAGE_0;
     inputVoltage = in_input::VIN_VOLTAGE_0;
 
-    if (present)
+    if (isPresent())
     {
         try
         {
-            // Read input voltage in millivolts
-            auto inputVoltageStr = pmbusIntf->readString(READ_VIN, Type::Hwmon);
+            if (vinSample && vinSampleTime &&
+                (std::chrono::steady_clock::now() - *vinSampleTime <=
+                 VIN_SAMPLE_MAX_AGE))
+            {
+                actualInputVoltage = *vinSample;
+            }
+            else
+            {
+                // Read input voltage in millivolts
+                auto inputVoltageStr =
+                    getBulkPMBus().readString(READ_VIN, Type::Hwmon);
 
-            // Convert to volts
-            actualInputVoltage = std::stod(inputVoltageStr) / 1000;
+                // Convert to volts
+                actualInputVoltage = std::stod(inputVoltageStr) / 1000;
+            }
 
             // Calculate the voltage based on voltage thresholds
             if (actualInputVoltage < in_input::VIN_VOLTAGE_MIN)
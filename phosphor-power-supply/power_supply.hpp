@@ -1,6 +1,13 @@
 #pragma once
 
+#include "energy_history.hpp"
+#include "match_dispatcher.hpp"
 #include "pmbus.hpp"
+#include "pmbus_cache.hpp"
+#include "pmbus_scheduler.hpp"
+#include "power-supply/average.hpp"
+#include "power-supply/maximum.hpp"
+#include "status_history.hpp"
 #include "types.hpp"
 #include "util.hpp"
 #include "utility.hpp"
@@ -8,8 +15,19 @@
 #include <gpiod.hpp>
 #include <sdbusplus/bus/match.hpp>
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bitset>
+#include <chrono>
+#include <cstddef>
 #include <filesystem>
+#include <functional>
+#include <future>
+#include <memory>
+#include <optional>
 #include <stdexcept>
+#include <vector>
 
 namespace phosphor::power::psu
 {
@@ -37,6 +55,227 @@ static constexpr auto FL_KW_SIZE = 20;
 constexpr auto LOG_LIMIT = 3;
 constexpr auto DEGLITCH_LIMIT = 3;
 
+// Number of the newest status samples checked for DEGLITCH_LIMIT PGOOD faults,
+// so a good sample between faulted ones does not restart the deglitching.
+constexpr size_t DEGLITCH_WINDOW = 5;
+
+// Number of status samples kept in each power supply's status history.
+constexpr size_t STATUS_HISTORY_SIZE = 8;
+
+/**
+ * Faults decoded from the bits in STATUS_WORD.
+ *
+ * The values are bit positions in the PowerSupply fault bitset.
+ */
+enum class StatusWordFault : size_t
+{
+    cml,
+    input,
+    voutOV,
+    ioutOC,
+    voutUV,
+    fan,
+    temperature,
+    mfr,
+    vinUV
+};
+
+// Number of StatusWordFault values.
+constexpr size_t STATUS_WORD_FAULT_COUNT = 9;
+
+/**
+ * Communication health of a power supply.
+ *
+ * A responsive power supply is read on every analyze().  A failing one has
+ * had up to LOG_LIMIT consecutive read failures.  An unresponsive one has
+ * reached LOG_LIMIT, and is only probed with a single read at an interval
+ * that doubles after each failed probe, up to MAX_PROBE_INTERVAL.
+ */
+enum class Health : size_t
+{
+    responsive,
+    failing,
+    unresponsive
+};
+
+// Number of Health values.
+constexpr size_t HEALTH_COUNT = 3;
+
+// Maximum number of analyze() calls between the probes of an unresponsive
+// power supply.
+constexpr size_t MAX_PROBE_INTERVAL = 64;
+
+// Time between the readings of READ_EIN taken by analyzeStatus() for the
+// energy history.
+constexpr auto ENERGY_SAMPLE_INTERVAL = std::chrono::seconds{5};
+
+// Number of READ_EIN readings in each energy history record, making 30 second
+// records like the INPUT_HISTORY ones.
+constexpr size_t ENERGY_SAMPLES_PER_RECORD = 6;
+
+// Time between the samples of the input voltage taken by analyzeStatus().
+constexpr auto VIN_SAMPLE_INTERVAL = std::chrono::seconds{10};
+
+// Age after which getInputVoltage() reads the input voltage instead of using
+// the last sample.
+constexpr auto VIN_SAMPLE_MAX_AGE = std::chrono::seconds{30};
+
+// Time the input voltage read with the bulk PMBus interface is cached, so the
+// power supplies are read once when the configuration is validated.
+constexpr auto VIN_CACHE_TTL = std::chrono::seconds{1};
+
+/**
+ * Statistics of the presence GPIO debouncing of a power supply.
+ */
+struct PresenceDebounceStats
+{
+    // Presence GPIO edge events seen
+    size_t edges = 0;
+
+    // Presence changes that went back before the line settled
+    size_t bounces = 0;
+
+    // Presence changes applied after the line settled
+    size_t changes = 0;
+
+    // Longest time from a presence change until it was applied
+    std::chrono::milliseconds maxSettleTime{0};
+};
+
+/**
+ * @struct PSUStateTable
+ *
+ * @brief The state of the power supplies that is checked on every analysis,
+ * stored as one array per field.
+ *
+ * Each PowerSupply keeps its status and fault state in a slot of a table,
+ * shared by all the power supplies of the PSUManager.  The checks over all
+ * of them, such as counting the present ones and finding the ones that need
+ * an error logged, read a few contiguous arrays instead of every PowerSupply
+ * object with its inventory strings and D-Bus matches.
+ *
+ * The slots of different power supplies are separate memory locations, so
+ * they can be updated by the threads that analyze the power supplies in
+ * parallel.  This is why the flags are not a std::vector<bool>.
+ */
+struct PSUStateTable
+{
+    /**
+     * @brief Adds a slot with the initial state.
+     *
+     * Invalidates references to the fields of the other slots.
+     *
+     * @return size_t - the index of the slot
+     */
+    size_t add()
+    {
+        statusWord.push_back(0);
+        faults.emplace_back();
+        present.push_back(0);
+        faultLogged.push_back(0);
+        pgoodFault.push_back(0);
+        readFail.push_back(0);
+        return statusWord.size() - 1;
+    }
+
+    /**
+     * @brief Resets a slot no longer used by a power supply to the initial
+     * state, so it is not counted by the checks.
+     *
+     * @param[in] slot - the index of the slot
+     */
+    void release(size_t slot)
+    {
+        statusWord[slot] = 0;
+        faults[slot].reset();
+        present[slot] = 0;
+        faultLogged[slot] = 0;
+        pgoodFault[slot] = 0;
+        readFail[slot] = 0;
+    }
+
+    /**
+     * @brief Removes all the slots.
+     *
+     * The power supplies that used them must have been destroyed.
+     */
+    void clear()
+    {
+        statusWord.clear();
+        faults.clear();
+        present.clear();
+        faultLogged.clear();
+        pgoodFault.clear();
+        readFail.clear();
+    }
+
+    /**
+     * @brief Returns the number of slots.
+     */
+    size_t size() const
+    {
+        return statusWord.size();
+    }
+
+    /**
+     * @brief Returns the number of present power supplies.
+     */
+    size_t countPresent() const
+    {
+        return static_cast<size_t>(
+            std::count(present.begin(), present.end(), uint8_t{1}));
+    }
+
+    /**
+     * @brief Returns true if a fault was found, like PowerSupply::isFaulted().
+     *
+     * @param[in] slot - the index of the slot
+     */
+    bool isFaulted(size_t slot) const
+    {
+        // The CML fault that is also a communication fault is in faults
+        return (readFail[slot] >= LOG_LIMIT) || faults[slot].any() ||
+               (pgoodFault[slot] >= DEGLITCH_LIMIT);
+    }
+
+    /**
+     * @brief Returns true if the power supply is missing or faulted and no
+     * error has been logged for it yet, so an error may need to be created.
+     *
+     * @param[in] slot - the index of the slot
+     */
+    bool needsError(size_t slot) const
+    {
+        return !faultLogged[slot] && (!present[slot] || isFaulted(slot));
+    }
+
+    /** @brief The last value read from STATUS_WORD. */
+    std::vector<uint64_t> statusWord;
+
+    /**
+     * @brief The faults decoded from STATUS_WORD, indexed by StatusWordFault.
+     *
+     * A fault stays set until STATUS_WORD reads as zero or the faults are
+     * cleared.
+     */
+    std::vector<std::bitset<STATUS_WORD_FAULT_COUNT>> faults;
+
+    /** @brief 1 if the power supply is present. */
+    std::vector<uint8_t> present;
+
+    /** @brief 1 if an error for a fault has already been logged. */
+    std::vector<uint8_t> faultLogged;
+
+    /**
+     * @brief The number of PGOOD faults in the newest status samples that are
+     * counted.  Considered faulted if reaches DEGLITCH_LIMIT.
+     */
+    std::vector<int> pgoodFault;
+
+    /** @brief Count of the number of read failures. */
+    std::vector<size_t> readFail;
+};
+
 /**
  * @class PowerSupply
  * Represents a PMBus power supply device.
@@ -49,7 +288,11 @@ class PowerSupply
     PowerSupply(PowerSupply&&) = delete;
     PowerSupply& operator=(const PowerSupply&) = delete;
     PowerSupply& operator=(PowerSupply&&) = delete;
-    ~PowerSupply() = default;
+
+    ~PowerSupply()
+    {
+        states.release(slot);
+    }
 
     /**
      * @param[in] invpath - String for inventory path to use
@@ -57,10 +300,27 @@ class PowerSupply
      * @param[in] i2caddr - The 16-bit I2C address of the power supply
      * @param[in] gpioLineName - The gpio-line-name to read for presence. See
      * https://github.com/openbmc/docs/blob/master/designs/device-tree-gpio-naming.md
+     * @param[in] inventoryMatches - Shares the D-Bus matches for the Present
+     * property with the other power supplies; if nullptr, this power supply
+     * adds its own matches
+     * @param[in] stateTable - Holds the status and fault state in a slot
+     * shared with the other power supplies; if nullptr, this power supply
+     * uses its own table
      */
     PowerSupply(sdbusplus::bus::bus& bus, const std::string& invpath,
                 std::uint8_t i2cbus, const std::uint16_t i2caddr,
-                const std::string& gpioLineName);
+                const std::string& gpioLineName,
+                util::MatchDispatcher* inventoryMatches = nullptr,
+                PSUStateTable* stateTable = nullptr);
+
+    /**
+     * @brief Returns the index of the slot in the state table that holds
+     * the status and fault state.
+     */
+    size_t getStateSlot() const
+    {
+        return slot;
+    }
 
     phosphor::pmbus::PMBusBase& getPMBus()
     {
@@ -93,6 +353,197 @@ class PowerSupply
      */
     void analyze();
 
+    /**
+     * Updates the presence of the power supply by reading the presence GPIO.
+     *
+     * The first step of analyze().  A presence change binds or unbinds the
+     * device driver and updates D-Bus, so this must be called on the thread
+     * that owns the D-Bus connection.
+     */
+    void analyzePresence();
+
+    /**
+     * Reads and analyzes the PMBus status registers for faults.
+     *
+     * The second step of analyze().  Does not access D-Bus, so the power
+     * supplies on different I2C buses may be analyzed on separate threads.
+     * A read failure is recorded rather than committed, see
+     * commitReadFailure().
+     */
+    void analyzeStatus();
+
+    /**
+     * Commits the error log for a read failure recorded by analyzeStatus(),
+     * if any, with the errno and device path recorded with the failure.
+     *
+     * The last step of analyze().  Must be called on the thread that owns the
+     * D-Bus connection.
+     */
+    void commitReadFailure();
+
+    /**
+     * Enables the input power history computed from the READ_EIN energy
+     * accumulator, and creates its Average and Maximum D-Bus objects.
+     *
+     * Power supplies that do not provide READ_EIN publish no records.
+     *
+     * @param[in] objectPath - the D-Bus object path of the history.  The
+     *                         average and maximum objects are created under
+     *                         it.
+     * @param[in] numRecords - the number of records to keep
+     */
+    void enableEnergyHistory(const std::string& objectPath, size_t numRecords);
+
+    /**
+     * Binds and unbinds the device driver on a worker thread when the
+     * presence GPIO changes, instead of on the calling thread.
+     *
+     * Binding probes the device, which can take hundreds of milliseconds,
+     * and is preceded by a delay for the power supply to settle.  While the
+     * worker runs, the presence change is not applied, so the power supply
+     * is neither analyzed nor updated in the inventory.  The callback is
+     * called on the worker thread when it is done, and the presence change
+     * is then applied by the next analyzePresence().
+     *
+     * By default the driver is bound on the calling thread.
+     *
+     * @param[in] callback - called from the worker thread after the driver
+     *                       is bound or unbound.  It must be safe to call
+     *                       from another thread.
+     */
+    void setDriverWorkCallback(std::function<void()> callback)
+    {
+        driverWorkCallback = std::move(callback);
+    }
+
+    /**
+     * Schedules the accesses to the power supply with the other devices on
+     * its I2C bus.
+     *
+     * The status reads, writes, and driver work are fault-critical.  The
+     * input voltage, energy, and VPD reads are bulk, so they do not delay
+     * fault detection.  The bulk reads of the input voltage are cached for
+     * VIN_CACHE_TTL.  Must be called once, before the power supply is
+     * analyzed.
+     *
+     * @param[in] scheduler - the scheduler of the I2C bus
+     */
+    void setPMBusScheduler(
+        std::shared_ptr<phosphor::pmbus::PMBusScheduler> scheduler);
+
+    /**
+     * Wraps the interface used to access the power supply, such as to
+     * record the accesses.  Must be called before setPMBusScheduler(), so
+     * both the fault-critical and the bulk accesses go through the wrapper.
+     *
+     * @param[in] wrap - called with the interface; returns the
+     *                   std::unique_ptr<PMBusBase> to use instead
+     */
+    template <typename Wrap>
+    void wrapPMBus(Wrap wrap)
+    {
+        pmbusIntf = wrap(std::move(pmbusIntf));
+    }
+
+    /**
+     * Debounces the presence GPIO.
+     *
+     * A presence change is only applied, and the device driver bound or
+     * unbound, once the GPIO has kept its new value for the settle time
+     * since the change was first read and since the last edge event.  If
+     * it goes back first, the change is counted as a bounce and nothing is
+     * done.  By default the settle time is 0 and changes are applied when
+     * read.
+     *
+     * @param[in] settleTime - the settle time
+     */
+    void setPresenceSettleTime(std::chrono::milliseconds settleTime)
+    {
+        presenceSettleTime = settleTime;
+    }
+
+    /**
+     * Returns the presence settle time.
+     */
+    std::chrono::milliseconds getPresenceSettleTime() const
+    {
+        return presenceSettleTime;
+    }
+
+    /**
+     * Notes an edge event on the presence GPIO, which restarts the settle
+     * time of a presence change.
+     */
+    void presenceEdge()
+    {
+        lastPresenceEdge = std::chrono::steady_clock::now();
+        if (!presenceEdgeSinceRead)
+        {
+            presenceEdgeSinceRead = lastPresenceEdge;
+        }
+        debounceStats.edges++;
+    }
+
+    /**
+     * Returns the presence GPIO debouncing statistics.
+     */
+    const PresenceDebounceStats& getPresenceDebounceStats() const
+    {
+        return debounceStats;
+    }
+
+    /**
+     * Returns whether a presence change is waiting for the GPIO to settle.
+     */
+    bool isPresenceSettling() const
+    {
+        return pendingPresent.has_value();
+    }
+
+    /**
+     * Returns whether the device driver is being bound or unbound on a
+     * worker thread.
+     *
+     * @return bool - true while the presence change is not applied
+     */
+    bool isDriverWorkPending() const
+    {
+        return driverWork.valid();
+    }
+
+    /**
+     * Updates the Average and Maximum D-Bus objects if analyzeStatus() added
+     * an energy history record, or the history was cleared.
+     *
+     * The last step of analyze(), after commitReadFailure().  Must be called
+     * on the thread that owns the D-Bus connection.
+     */
+    void publishEnergyHistory();
+
+    /**
+     * Returns the energy history, or nullptr if it is not enabled.
+     */
+    const phosphor::power::history::EnergyHistory* getEnergyHistory() const
+    {
+        return energyHistory.get();
+    }
+
+    /**
+     * @brief Returns the I2C bus number the power supply is on.
+     */
+    std::uint8_t getI2CBus() const
+    {
+        return i2cBus;
+    }
+
+    /**
+     * @brief Returns the I2C address of the power supply.
+     */
+    std::uint16_t getI2CAddress() const
+    {
+        return i2cAddr;
+    }
+
     /**
      * Write PMBus ON_OFF_CONFIG
      *
@@ -120,7 +571,9 @@ class PowerSupply
      * associated power supply D-Bus inventory object.
      *
      * This needs to be done on startup, and each time the presence
-     * state changes.
+     * state changes.  Does nothing if the inventory was already updated
+     * since the power supply was installed.  Only the properties that
+     * changed since the last update are written.
      *
      * Properties added:
      * - Serial Number
@@ -135,7 +588,7 @@ class PowerSupply
      */
     bool isPresent() const
     {
-        return present;
+        return states.present[slot] != 0;
     }
 
     /**
@@ -143,7 +596,16 @@ class PowerSupply
      */
     uint64_t getStatusWord() const
     {
-        return statusWord;
+        return statusWord();
+    }
+
+    /**
+     * @brief Returns the status samples of the last STATUS_HISTORY_SIZE
+     * successful STATUS_WORD reads.
+     */
+    const StatusHistory<STATUS_HISTORY_SIZE>& getStatusHistory() const
+    {
+        return statusHistory;
     }
 
     /**
@@ -207,9 +669,47 @@ class PowerSupply
      */
     bool isFaulted() const
     {
-        return (hasCommFault() || vinUVFault || inputFault || voutOVFault ||
-                ioutOCFault || voutUVFault || fanFault || tempFault ||
-                (pgoodFault >= DEGLITCH_LIMIT) || mfrFault);
+        return states.isFaulted(slot);
+    }
+
+    /**
+     * @brief Returns when the current fault was first detected.
+     *
+     * Set the first time a fault is seen, including a PGOOD fault that is
+     * still being deglitched and the first of the read failures counted
+     * toward a communication fault.  Kept until no fault remains or the
+     * faults are cleared.
+     *
+     * @return the monotonic time, or std::nullopt if no fault is detected
+     */
+    std::optional<std::chrono::steady_clock::time_point>
+        getFaultDetectedTime() const
+    {
+        return faultDetectedTime;
+    }
+
+    /**
+     * @brief Returns the communication health of the power supply.
+     */
+    Health getHealth() const
+    {
+        return health;
+    }
+
+    /**
+     * @brief Returns the total time the power supply has spent in a health
+     * state, including the time in the current state.
+     *
+     * @param[in] state - the health state
+     */
+    std::chrono::steady_clock::duration getHealthTime(Health state) const
+    {
+        auto time = healthTime[static_cast<size_t>(state)];
+        if (state == health)
+        {
+            time += std::chrono::steady_clock::now() - healthSince;
+        }
+        return time;
     }
 
     /**
@@ -217,7 +717,7 @@ class PowerSupply
      */
     bool isFaultLogged() const
     {
-        return faultLogged;
+        return states.faultLogged[slot] != 0;
     }
 
     /**
@@ -225,7 +725,7 @@ class PowerSupply
      */
     void setFaultLogged()
     {
-        faultLogged = true;
+        states.faultLogged[slot] = 1;
     }
 
     /**
@@ -233,7 +733,7 @@ class PowerSupply
      */
     bool hasInputFault() const
     {
-        return inputFault;
+        return hasFault(StatusWordFault::input);
     }
 
     /**
@@ -241,7 +741,7 @@ class PowerSupply
      */
     bool hasMFRFault() const
     {
-        return mfrFault;
+        return hasFault(StatusWordFault::mfr);
     }
 
     /**
@@ -249,7 +749,7 @@ class PowerSupply
      */
     bool hasVINUVFault() const
     {
-        return vinUVFault;
+        return hasFault(StatusWordFault::vinUV);
     }
 
     /**
@@ -257,7 +757,7 @@ class PowerSupply
      */
     bool hasVoutOVFault() const
     {
-        return voutOVFault;
+        return hasFault(StatusWordFault::voutOV);
     }
 
     /**
@@ -265,7 +765,7 @@ class PowerSupply
      */
     bool hasIoutOCFault() const
     {
-        return ioutOCFault;
+        return hasFault(StatusWordFault::ioutOC);
     }
 
     /**
@@ -273,7 +773,7 @@ class PowerSupply
      */
     bool hasVoutUVFault() const
     {
-        return voutUVFault;
+        return hasFault(StatusWordFault::voutUV);
     }
 
     /**
@@ -281,7 +781,7 @@ class PowerSupply
      */
     bool hasFanFault() const
     {
-        return fanFault;
+        return hasFault(StatusWordFault::fan);
     }
 
     /**
@@ -289,7 +789,7 @@ class PowerSupply
      */
     bool hasTempFault() const
     {
-        return tempFault;
+        return hasFault(StatusWordFault::temperature);
     }
 
     /**
@@ -298,7 +798,20 @@ class PowerSupply
      */
     bool hasPgoodFault() const
     {
-        return (pgoodFault >= DEGLITCH_LIMIT);
+        return (pgoodFault() >= DEGLITCH_LIMIT);
+    }
+
+    /**
+     * @brief Returns true if the last analysis found an input fault or
+     * PGOOD# inactive, without waiting for the fault to be deglitched.
+     *
+     * Used to signal the lost capacity before the fault is logged.
+     */
+    bool isCapacityLost() const
+    {
+        return hasInputFault() || hasVINUVFault() ||
+               (!statusHistory.empty() &&
+                isPgoodNegated(statusHistory[0].statusWord));
     }
 
     /**
@@ -369,12 +882,16 @@ class PowerSupply
      */
     bool hasCommFault() const
     {
-        return ((readFail >= LOG_LIMIT) || (cmlFault));
+        return ((readFail() >= LOG_LIMIT) || hasFault(StatusWordFault::cml));
     }
 
     /**
-     * @brief Reads the pmbus input voltage and returns that actual voltage
-     *        reading and the calculated input voltage based on thresholds.
+     * @brief Returns the pmbus input voltage and the calculated input voltage
+     *        based on thresholds.
+     *
+     * Uses the input voltage sampled by analyzeStatus() if it is newer than
+     * VIN_SAMPLE_MAX_AGE, and only reads it otherwise.
+     *
      * @param[out] actualInputVoltage - The actual voltage reading, in Volts.
      * @param[out] inputVoltage - A rounded up/down value of the actual input
      *             voltage based on thresholds, in Volts.
@@ -385,8 +902,25 @@ class PowerSupply
     /** @brief systemd bus member */
     sdbusplus::bus::bus& bus;
 
+    /** @brief The state table used if none was passed to the constructor. */
+    std::unique_ptr<PSUStateTable> ownStates;
+
+    /** @brief The table holding the status and fault state. */
+    PSUStateTable& states;
+
+    /** @brief The index of the slot of this power supply in states. */
+    const size_t slot;
+
     /** @brief Will be updated to the latest/lastvalue read from STATUS_WORD.*/
-    uint64_t statusWord = 0;
+    uint64_t& statusWord()
+    {
+        return states.statusWord[slot];
+    }
+
+    uint64_t statusWord() const
+    {
+        return states.statusWord[slot];
+    }
 
     /** @brief Will be updated to the latest/lastvalue read from STATUS_INPUT.*/
     uint64_t statusInput = 0;
@@ -411,44 +945,100 @@ class PowerSupply
      * STATUS_TEMPERATURE.*/
     uint64_t statusTemperature = 0;
 
-    /** @brief True if an error for a fault has already been logged. */
-    bool faultLogged = false;
+    /** @brief When the current fault was first detected, if any. */
+    std::optional<std::chrono::steady_clock::time_point> faultDetectedTime;
 
-    /** @brief True if bit 1 of STATUS_WORD low byte is on. */
-    bool cmlFault = false;
+    /**
+     * @brief Records the current time as the fault detection time, unless
+     * a fault was already detected.
+     */
+    void markFaultDetected()
+    {
+        if (!faultDetectedTime)
+        {
+            faultDetectedTime = std::chrono::steady_clock::now();
+        }
+    }
 
-    /** @brief True if bit 5 of STATUS_WORD high byte is on. */
-    bool inputFault = false;
+    /**
+     * @brief The faults decoded from STATUS_WORD, indexed by StatusWordFault.
+     *
+     * A fault stays set until STATUS_WORD reads as zero or the faults are
+     * cleared.
+     */
+    std::bitset<STATUS_WORD_FAULT_COUNT>& faults()
+    {
+        return states.faults[slot];
+    }
 
-    /** @brief True if bit 4 of STATUS_WORD high byte is on. */
-    bool mfrFault = false;
+    /**
+     * @brief Returns true if the specified STATUS_WORD fault is set.
+     *
+     * @param[in] fault - the fault to check
+     */
+    bool hasFault(StatusWordFault fault) const
+    {
+        return states.faults[slot].test(static_cast<size_t>(fault));
+    }
 
-    /** @brief True if bit 3 of STATUS_WORD low byte is on. */
-    bool vinUVFault = false;
+    /**
+     * @brief Decodes the faults in STATUS_WORD.
+     *
+     * Uses a table of the STATUS_WORD bits for each fault and the register
+     * included in its journal message.  Faults that were not already set are
+     * logged, so no messages are formatted when nothing changed.
+     */
+    void decodeStatusWord();
 
-    /** @brief True if bit 5 of STATUS_WORD low byte is on. */
-    bool voutOVFault = false;
+    /**
+     * @brief Returns true if bit 11 or 6 of STATUS_WORD is on.  PGOOD# is
+     * inactive, or the unit is off.
+     *
+     * @param[in] word - the STATUS_WORD value
+     */
+    static bool isPgoodNegated(uint64_t word)
+    {
+        return (word & phosphor::pmbus::status_word::POWER_GOOD_NEGATED) ||
+               (word & phosphor::pmbus::status_word::UNIT_IS_OFF);
+    }
 
-    /** @brief True if bit 4 of STATUS_WORD low byte is on. */
-    bool ioutOCFault = false;
+    /**
+     * @brief Adds the STATUS_WORD just read to the status history and
+     * updates pgoodFault from it.
+     *
+     * pgoodFault counts the PGOOD faults in the newest DEGLITCH_WINDOW
+     * samples, so glitches that are not consecutive are still deglitched.
+     * Once the fault reaches DEGLITCH_LIMIT, the first good sample ends it.
+     */
+    void addStatusSample();
 
-    /** @brief True if bit 7 of STATUS_WORD high byte is on and bit 5 (VOUT_OV)
-     * of low byte is off. */
-    bool voutUVFault = false;
+    /**
+     * @brief The number of PGOOD faults in the newest samples of
+     * statusHistory that are counted, see addStatusSample().
+     *
+     * Considered faulted if reaches DEGLITCH_LIMIT.
+     */
+    int& pgoodFault()
+    {
+        return states.pgoodFault[slot];
+    }
 
-    /** @brief True if FANS fault/warn bit on in STATUS_WORD. */
-    bool fanFault = false;
+    int pgoodFault() const
+    {
+        return states.pgoodFault[slot];
+    }
 
-    /** @brief True if bit 2 of STATUS_WORD low byte is on. */
-    bool tempFault = false;
+    /**
+     * @brief The number of the newest samples of statusHistory counted in
+     * pgoodFault, at most DEGLITCH_WINDOW.
+     */
+    size_t pgoodSamples = 0;
 
     /**
-     * @brief Incremented if bit 11 or 6 of STATUS_WORD is on. PGOOD# is
-     * inactive, or the unit is off.
-     *
-     * Considered faulted if reaches DEGLITCH_LIMIT.
+     * @brief The status samples of the last STATUS_HISTORY_SIZE successful
+     * STATUS_WORD reads, for deglitching and the fault logs.
      */
-    int pgoodFault = 0;
+    StatusHistory<STATUS_HISTORY_SIZE> statusHistory;
 
     /**
      * @brief Power Supply Kill fault.
@@ -466,7 +1056,147 @@ class PowerSupply
     bool psCS12VFault = false;
 
     /** @brief Count of the number of read failures. */
-    size_t readFail = 0;
+    size_t& readFail()
+    {
+        return states.readFail[slot];
+    }
+
+    size_t readFail() const
+    {
+        return states.readFail[slot];
+    }
+
+    /** @brief True if a read failure needs to be committed. */
+    bool readFailPending = false;
+
+    /** @brief The errno of the read failure to commit. */
+    int readFailErrno = 0;
+
+    /** @brief The device path of the read failure to commit.  Recorded with
+     * the failure since the error log is committed on another thread. */
+    std::string readFailDevicePath;
+
+    /** @brief The last input voltage sampled by analyzeStatus(), in Volts.
+     * Empty if the last sample could not be read. */
+    std::optional<double> vinSample;
+
+    /** @brief When the input voltage was last sampled. */
+    std::optional<std::chrono::steady_clock::time_point> vinSampleTime;
+
+    /**
+     * @brief Reads READ_VIN into vinSample if the last sample is older than
+     * VIN_SAMPLE_INTERVAL.
+     */
+    void sampleInputVoltage();
+
+    /** @brief The input power history, if enabled. */
+    std::unique_ptr<phosphor::power::history::EnergyHistory> energyHistory;
+
+    /** @brief The D-Bus object of the average input power history. */
+    std::unique_ptr<phosphor::power::history::Average> energyAverage;
+
+    /** @brief The D-Bus object of the maximum input power history. */
+    std::unique_ptr<phosphor::power::history::Maximum> energyMaximum;
+
+    /** @brief True if the energy history changed since it was published. */
+    bool energyHistoryChanged = false;
+
+    /** @brief When READ_EIN was last read for the energy history. */
+    std::optional<std::chrono::steady_clock::time_point> energySampleTime;
+
+    /**
+     * @brief Reads READ_EIN into the energy history if it is enabled and
+     * the last reading is older than ENERGY_SAMPLE_INTERVAL.
+     */
+    void sampleEnergy();
+
+    /**
+     * @brief Deletes the energy history records, such as when the power
+     * supply has been removed.
+     */
+    void clearEnergyHistory();
+
+    /** @brief The communication health of the power supply. */
+    Health health = Health::responsive;
+
+    /** @brief When the current health state was entered. */
+    std::chrono::steady_clock::time_point healthSince =
+        std::chrono::steady_clock::now();
+
+    /** @brief Time spent in each earlier health state, indexed by Health. */
+    std::array<std::chrono::steady_clock::duration, HEALTH_COUNT> healthTime{};
+
+    /** @brief Number of analyze() calls between the probes while
+     * unresponsive. */
+    size_t probeInterval = 1;
+
+    /** @brief Number of analyze() calls to skip before the next probe while
+     * unresponsive. */
+    size_t cyclesUntilProbe = 0;
+
+    /**
+     * @brief Returns whether analyzeStatus() should read the power supply
+     * this time, counting down to the next probe while unresponsive.
+     */
+    bool shouldRead();
+
+    /**
+     * @brief Records a failure to read STATUS_WORD.
+     *
+     * Counts the failure toward LOG_LIMIT, and requests an error log for the
+     * first failure since the power supply was last responsive.  Once
+     * unresponsive, backs off the probe interval instead and requests no
+     * error log.
+     *
+     * @param[in] error - the errno of the failure
+     */
+    void recordReadFailure(int error);
+
+    /**
+     * @brief Handles a failure to read STATUS_WORD in analyzeStatus().
+     *
+     * Marks the fault as detected, forgets the previous status word and
+     * records the failure.
+     *
+     * @param[in] error - the errno of the failure
+     */
+    void statusReadFailed(int error);
+
+    /**
+     * @brief Sets the health state, accumulating the time spent in the
+     * previous one.
+     *
+     * @param[in] newHealth - the new health state
+     */
+    void setHealth(Health newHealth);
+
+    /**
+     * @brief Makes the power supply responsive again, so it is read on the
+     * next analyze().  Used when its presence changes.
+     */
+    void resetHealth();
+
+    /** @brief The I2C bus number the power supply is on. */
+    std::uint8_t i2cBus = 0;
+
+    /** @brief The I2C address of the power supply. */
+    std::uint16_t i2cAddr = 0;
+
+    /**
+     * @brief Reads the secondary STATUS_* registers summarized by STATUS_WORD.
+     *
+     * Reads the registers whose summary bits are on in STATUS_WORD, along
+     * with STATUS_MFR since it is included in every fault message.  They are
+     * read on every call, since a register can change while its summary bit
+     * stays on.  The registers whose summary bits are off are set to zero
+     * without being read.
+     *
+     * A register that cannot be read is handled as a failure to read the
+     * status, see statusReadFailed().
+     *
+     * @return true if the registers were read, false otherwise
+     */
+    bool readStatusRegisters();
 
     /**
      * @brief Determine possible manufacturer-specific faults from bits in
@@ -488,8 +1218,11 @@ class PowerSupply
      */
     std::unique_ptr<GPIOInterfaceBase> presenceGPIO = nullptr;
 
-    /** @brief True if the power supply is present. */
-    bool present = false;
+    /** @brief Sets whether the power supply is present. */
+    void setPresent(bool newPresent)
+    {
+        states.present[slot] = newPresent ? 1 : 0;
+    }
 
     /** @brief Power supply model name. */
     std::string modelName;
@@ -504,6 +1237,16 @@ class PowerSupply
      */
     std::unique_ptr<sdbusplus::bus::match_t> presentAddedMatch;
 
+    /** @brief Present property changes received through the shared inventory
+     * matches.
+     */
+    util::MatchDispatcher::Registration presentRegistration;
+
+    /** @brief Present property interface added received through the shared
+     * inventory matches.
+     */
+    util::MatchDispatcher::Registration presentAddedRegistration;
+
     /**
      * @brief Pointer to the PMBus interface
      *
@@ -511,9 +1254,50 @@ class PowerSupply
      */
     std::unique_ptr<phosphor::pmbus::PMBusBase> pmbusIntf = nullptr;
 
+    /**
+     * @brief The PMBus interface for bulk reads, or nullptr to use
+     * pmbusIntf.  See setPMBusScheduler().
+     */
+    std::unique_ptr<phosphor::pmbus::PMBusBase> bulkPMBusIntf = nullptr;
+
+    /**
+     * @brief Returns the PMBus interface for the reads that are not needed
+     * for fault detection.
+     */
+    phosphor::pmbus::PMBusBase& getBulkPMBus() const
+    {
+        return bulkPMBusIntf ? *bulkPMBusIntf : *pmbusIntf;
+    }
+
     /** @brief Stored copy of the firmware version/revision string */
     std::string fwVersion;
 
+    /**
+     * @brief True if the inventory has been updated since the power supply
+     * was installed.
+     */
+    bool inventoryCurrent = false;
+
+    /**
+     * @brief The VPD values read from the power supply.
+     *
+     * A value is empty if it could not be read.  Declared whatever the value
+     * of IBM_VPD, since this header does not include config.h and the class
+     * layout must be the same in every translation unit.
+     */
+    struct InventoryVPD
+    {
+        std::optional<std::string> ccin;
+        std::optional<std::string> pn;
+        std::optional<std::string> fn;
+        std::optional<std::string> header;
+        std::optional<std::string> sn;
+        std::optional<std::string> fwVersion;
+    };
+
+    /** @brief The VPD last written to the inventory, if any. */
+    std::optional<InventoryVPD> publishedVPD;
+
     /**
      * @brief The file system path used for binding the device driver.
      */
@@ -536,6 +1320,50 @@ class PowerSupply
      */
     void bindOrUnbindDriver(bool present);
 
+    /**
+     * @brief Called from the worker thread when the device driver has been
+     *        bound or unbound, see setDriverWorkCallback().  When null, the
+     *        driver is bound on the calling thread.
+     */
+    std::function<void()> driverWorkCallback;
+
+    /**
+     * @brief The worker binding or unbinding the device driver, if any.
+     */
+    std::future<void> driverWork;
+
+    /**
+     * @brief Set by the worker when the driver has been bound or unbound.
+     */
+    std::atomic<bool> driverWorkDone = false;
+
+    /**
+     * @brief The presence the worker is binding or unbinding the driver for.
+     */
+    bool driverWorkPresent = false;
+
+    /**
+     * @brief Binds or unbinds the device driver for a presence change, and
+     *        applies the change when done.
+     *
+     * Runs on a worker thread if setDriverWorkCallback() was called, and
+     * otherwise on the calling thread after the bind delay.
+     *
+     * @param[in] newPresent - the new presence
+     */
+    void startDriverWork(bool newPresent);
+
+    /**
+     * @brief Applies a presence change after the device driver was bound or
+     *        unbound.
+     *
+     * Finds the hwmon directory and clears the faults of an installed power
+     * supply, and then updates its presence and VPD in the inventory.
+     *
+     * @param[in] newPresent - the new presence
+     */
+    void applyPresenceChange(bool newPresent);
+
     /**
      *  @brief Updates the presence status by querying D-Bus
      *
@@ -547,9 +1375,43 @@ class PowerSupply
 
     /**
      * @brief Updates the power supply presence by reading the GPIO line.
+     *
+     * Presence changes are debounced, see setPresenceSettleTime().
      */
     void updatePresenceGPIO();
 
+    /**
+     * @brief The time the presence GPIO must keep a new value before the
+     * change is applied.
+     */
+    std::chrono::milliseconds presenceSettleTime{0};
+
+    /**
+     * @brief The presence read from the GPIO that is waiting to settle.
+     */
+    std::optional<bool> pendingPresent;
+
+    /**
+     * @brief When pendingPresent was first read.
+     */
+    std::chrono::steady_clock::time_point pendingPresentTime{};
+
+    /**
+     * @brief When the last presence GPIO edge event was seen.
+     */
+    std::chrono::steady_clock::time_point lastPresenceEdge{};
+
+    /**
+     * @brief When the first presence GPIO edge event since the GPIO was last
+     * read was seen.
+     */
+    std::optional<std::chrono::steady_clock::time_point> presenceEdgeSinceRead;
+
+    /**
+     * @brief The presence GPIO debouncing statistics.
+     */
+    PresenceDebounceStats debounceStats;
+
     /**
      * @brief Callback for inventory property changes
      *
@@ -1,12 +1,29 @@
+#include "config.h"
+
 #include "psu_manager.hpp"
 
+#include "hwmon_index.hpp"
+#include "i2c.hpp"
+#include "pmbus_trace.hpp"
+#include "trace.hpp"
 #include "utility.hpp"
 
+#include <fcntl.h>
 #include <fmt/format.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <map>
+#include <optional>
 #include <regex>
+#include <system_error>
 
 using namespace phosphor::logging;
 
@@ -19,12 +36,37 @@ constexpr auto i2cBusProp = "I2CBus";
 constexpr auto i2cAddressProp = "I2CAddress";
 constexpr auto psuNameProp = "Name";
 constexpr auto presLineName = "NamedPresenceGpio";
+constexpr auto alertLineName = "NamedAlertGpio";
 
 constexpr auto supportedConfIntf =
     "xyz.openbmc_project.Configuration.SupportedConfiguration";
 
-PSUManager::PSUManager(sdbusplus::bus::bus& bus, const sdeventplus::Event& e) :
-    bus(bus)
+constexpr auto entityManagerService = "xyz.openbmc_project.EntityManager";
+
+constexpr auto psuMonitorBusName = "xyz.openbmc_project.Power.PSUMonitor";
+constexpr auto psuMonitorObjPath = "/xyz/openbmc_project/power/psu_monitor";
+constexpr auto faultLatencyObjPath =
+    "/xyz/openbmc_project/power/psu_monitor/fault_latency";
+
+PSUManager::PSUManager(sdbusplus::bus::bus& bus, const sdeventplus::Event& e,
+                       bool eventMode, bool parallel, bool batchDiscovery,
+                       size_t energyHistoryRecords,
+                       const util::RealtimeOptions& faultPathOptions,
+                       const std::string& throttleGPIOName,
+                       std::chrono::milliseconds pollInterval, bool stagger,
+                       std::chrono::milliseconds presenceSettleTime) :
+    bus(bus),
+    errorLogQueue(bus, e),
+    eventMode(eventMode),
+    parallel(parallel || faultPathOptions.isThreadRealtime()),
+    faultPathOptions(faultPathOptions),
+    energyHistoryRecords(energyHistoryRecords), pollInterval(pollInterval),
+    stagger(stagger), presenceSettleTime(presenceSettleTime),
+    analyzeCycleStatsInterface(bus, psuMonitorObjPath, analyzeCycleStats),
+    faultLatencyStatsInterface(bus, faultLatencyObjPath, faultLatencyStats),
+    startupTimesInterface(bus, psuMonitorObjPath, startupTimes),
+    capacityInterface(bus, psuMonitorObjPath), lagMonitor(e),
+    lagInterface(bus, psuMonitorObjPath, lagMonitor.getLag())
 {
     // Subscribe to InterfacesAdded before doing a property read, otherwise
     // the interface could be created after the read attempt but before the
@@ -32,21 +74,78 @@ PSUManager::PSUManager(sdbusplus::bus::bus& bus, const sdeventplus::Event& e) :
     entityManagerIfacesAddedMatch = std::make_unique<sdbusplus::bus::match_t>(
         bus,
         sdbusplus::bus::match::rules::interfacesAdded() +
-            sdbusplus::bus::match::rules::sender(
-                "xyz.openbmc_project.EntityManager"),
+            sdbusplus::bus::match::rules::sender(entityManagerService),
         std::bind(&PSUManager::entityManagerIfaceAdded, this,
                   std::placeholders::_1));
-    getPSUConfiguration();
-    getSystemProperties();
 
     using namespace sdeventplus;
-    auto interval = std::chrono::milliseconds(1000);
     timer = std::make_unique<utility::Timer<ClockId::Monotonic>>(
-        e, std::bind(&PSUManager::analyze, this), interval);
+        e, [this](auto&) { analyzeTick(); }, pollInterval);
+
+    alarmTimer = std::make_unique<utility::Timer<ClockId::Monotonic>>(
+        e, [this](auto&) { analyze(); });
+
+    presenceTimer = std::make_unique<utility::Timer<ClockId::Monotonic>>(
+        e, [this](auto&) { analyze(); });
 
     validationTimer = std::make_unique<utility::Timer<ClockId::Monotonic>>(
         e, std::bind(&PSUManager::validateConfig, this));
 
+    // The power supplies bind their device drivers on worker threads, and
+    // are analyzed again once one is done so the presence change is applied
+    driverWorkFD.set(eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK));
+    if (driverWorkFD() >= 0)
+    {
+        driverWorkSource = std::make_unique<source::IO>(
+            e, driverWorkFD(), EPOLLIN,
+            [this](source::IO&, int fd, uint32_t) {
+                util::EventLoopLag::Scope lagScope{lagMonitor.getLag(),
+                                                   "PSUManager::driverWork"};
+                uint64_t count = 0;
+                if (::read(fd, &count, sizeof(count)) > 0)
+                {
+                    alarmTimer->restartOnce(std::chrono::milliseconds(0));
+                }
+            });
+    }
+    else
+    {
+        log<level::ERR>(
+            fmt::format("Unable to create the driver work eventfd. errno={}",
+                        errno)
+                .c_str());
+    }
+
+    // Resume with the power supplies of the previous instance, if it was
+    // restarted, instead of reading the configuration again
+    std::optional<nlohmann::json> state = stateHandoff.take();
+    if (!state || !restoreState(*state))
+    {
+        if (batchDiscovery)
+        {
+            getManagedObjects();
+        }
+        else
+        {
+            getPSUConfiguration();
+            getSystemProperties();
+        }
+    }
+
+    // There is nothing to wait for if no configuration calls were started
+    if (pendingConfigCalls == 0)
+    {
+        startupTimes.complete(util::StartupTimes::Phase::configLoad);
+        alarmTimer->restartOnce(std::chrono::milliseconds(0));
+    }
+
+    updateAlertWatches();
+
+    // Keep a recent state for the next instance, in case of a crash
+    saveState();
+    stateHandoffTimer = std::make_unique<utility::Timer<ClockId::Monotonic>>(
+        e, [this](auto&) { saveState(); }, stateHandoffInterval);
+
     try
     {
         powerConfigGPIO = createGPIO("power-config-full-load");
@@ -57,51 +156,89 @@ PSUManager::PSUManager(sdbusplus::bus::bus& bus, const sdeventplus::Event& e) :
         powerConfigGPIO = nullptr;
     }
 
+    if (!throttleGPIOName.empty())
+    {
+        try
+        {
+            throttleGPIO = createGPIO(throttleGPIOName);
+            throttleGPIO->write(0, 0);
+        }
+        catch (const std::exception& e)
+        {
+            log<level::ERR>(
+                fmt::format("Unable to use throttle GPIO {}: {}",
+                            throttleGPIOName, e.what())
+                    .c_str());
+            throttleGPIO = nullptr;
+        }
+    }
+
     // Subscribe to power state changes
-    powerService = util::getService(POWER_OBJ_PATH, POWER_IFACE, bus);
-    powerOnMatch = std::make_unique<sdbusplus::bus::match_t>(
-        bus,
-        sdbusplus::bus::match::rules::propertiesChanged(POWER_OBJ_PATH,
-                                                        POWER_IFACE),
-        [this](auto& msg) { this->powerStateChanged(msg); });
+    powerState.addCallback(
+        [this](bool powerOn) { this->powerStateChanged(powerOn); });
 
     initialize();
+
+    if (eventMode)
+    {
+        updateAlarmSources();
+    }
+    updateAnalyzeInterval();
+
+    // Claim a bus name so the debug interfaces can be found
+    bus.request_name(psuMonitorBusName);
 }
 
 void PSUManager::getPSUConfiguration()
 {
     using namespace phosphor::power::util;
     auto depth = 0;
-    auto objects = getSubTree(bus, "/", IBMCFFPSInterface, depth);
 
     psus.clear();
+    psuStates.clear();
+    psuConfigs = nlohmann::json::array();
+    requiredPSUsState.reset();
+
+    // The replies are handled from the event loop, so a slow Entity Manager
+    // does not delay monitoring the power supplies that are already known.
+    startConfigCall(getSubTreeAsync(
+        bus, "/", IBMCFFPSInterface, depth,
+        [this](std::optional<DbusSubtree> objects) {
+            // I should get a map of objects back.
+            // Each object will have a path, a service, and an interface.
+            // The interface should match the one passed into this function.
+            for (const auto& [path, services] : objects.value_or(DbusSubtree{}))
+            {
+                auto service = services.begin()->first;
 
-    // I should get a map of objects back.
-    // Each object will have a path, a service, and an interface.
-    // The interface should match the one passed into this function.
-    for (const auto& [path, services] : objects)
-    {
-        auto service = services.begin()->first;
-
-        if (path.empty() || service.empty())
-        {
-            continue;
-        }
-
-        // For each object in the array of objects, I want to get properties
-        // from the service, path, and interface.
-        auto properties =
-            getAllProperties(bus, path, IBMCFFPSInterface, service);
+                if (path.empty() || service.empty())
+                {
+                    continue;
+                }
 
-        getPSUProperties(properties);
-    }
+                // For each object in the array of objects, I want to get
+                // properties from the service, path, and interface.
+                startConfigCall(getAllPropertiesAsync(
+                    bus, path, IBMCFFPSInterface, service,
+                    [this](std::optional<DbusPropertyMap> properties) {
+                        if (properties)
+                        {
+                            getPSUProperties(*properties);
+                        }
+                        endConfigCall();
+                    }));
+            }
 
-    if (psus.empty())
-    {
-        // Interface or properties not found. Let the Interfaces Added callback
-        // process the information once the interfaces are added to D-Bus.
-        log<level::INFO>(fmt::format("No power supplies to monitor").c_str());
-    }
+            if (!objects || objects->empty())
+            {
+                // Interface or properties not found. Let the Interfaces Added
+                // callback process the information once the interfaces are
+                // added to D-Bus.
+                log<level::INFO>(
+                    fmt::format("No power supplies to monitor").c_str());
+            }
+            endConfigCall();
+        }));
 }
 
 void PSUManager::getPSUProperties(util::DbusPropertyMap& properties)
@@ -115,6 +252,7 @@ void PSUManager::getPSUProperties(util::DbusPropertyMap& properties)
     uint64_t* i2caddr = nullptr;
     std::string* psuname = nullptr;
     std::string* preslineptr = nullptr;
+    std::string* alertlineptr = nullptr;
 
     for (const auto& property : properties)
     {
@@ -137,6 +275,11 @@ void PSUManager::getPSUProperties(util::DbusPropertyMap& properties)
                 preslineptr =
                     std::get_if<std::string>(&properties[presLineName]);
             }
+            else if (property.first == alertLineName)
+            {
+                alertlineptr =
+                    std::get_if<std::string>(&properties[alertLineName]);
+            }
         }
         catch (const std::exception& e)
         {}
@@ -174,17 +317,73 @@ void PSUManager::getPSUProperties(util::DbusPropertyMap& properties)
             fmt::format("make PowerSupply bus: {} addr: {} presline: {}",
                         *i2cbus, *i2caddr, presline)
                 .c_str());
-        auto psu = std::make_unique<PowerSupply>(bus, invpath, *i2cbus,
-                                                 *i2caddr, presline);
+        auto psu = std::make_unique<PowerSupply>(
+            bus, invpath, *i2cbus, *i2caddr, presline, &inventoryMatches,
+            &psuStates);
+        if (i2c::isTracing())
+        {
+            using phosphor::pmbus::PMBusBase;
+            psu->wrapPMBus([bus = *i2cbus, addr = *i2caddr](
+                               std::unique_ptr<PMBusBase> device) {
+                return std::make_unique<phosphor::pmbus::TracedPMBus>(
+                    std::move(device), static_cast<uint8_t>(bus),
+                    static_cast<uint8_t>(addr));
+            });
+        }
+        auto& scheduler = pmbusSchedulers[*i2cbus];
+        if (!scheduler)
+        {
+            scheduler = std::make_shared<phosphor::pmbus::PMBusScheduler>();
+        }
+        psu->setPMBusScheduler(scheduler);
+        psu->setPresenceSettleTime(presenceSettleTime);
+        if (driverWorkSource)
+        {
+            // Binding a device driver probes the device, so do it without
+            // stopping the analysis of the other power supplies
+            psu->setDriverWorkCallback([fd = driverWorkFD()]() {
+                uint64_t count = 1;
+                if (::write(fd, &count, sizeof(count)) < 0)
+                {
+                    log<level::ERR>(
+                        fmt::format("Unable to signal driver work done. "
+                                    "errno={}",
+                                    errno)
+                            .c_str());
+                }
+            });
+        }
+        if (energyHistoryRecords > 0)
+        {
+            auto name = invpath.substr(invpath.find_last_of('/') + 1);
+            psu->enableEnergyHistory(std::string{INPUT_HISTORY_SENSOR_ROOT} +
+                                         '/' + name + "_input_power",
+                                     energyHistoryRecords);
+        }
         psus.emplace_back(std::move(psu));
+        requiredPSUsState.reset();
+        psuConfigs.push_back(
+            {{"bus", *i2cbus},
+             {"address", *i2caddr},
+             {"name", *psuname},
+             {"presenceLine", presline},
+             {"alertLine",
+              (alertlineptr != nullptr) ? *alertlineptr : std::string{}}});
+
+        // Power supplies on one bus can share an SMBALERT# GPIO
+        if ((alertlineptr != nullptr) && !alertlineptr->empty())
+        {
+            alertGPIOs.emplace(*alertlineptr, *i2cbus);
+            if (alarmTimer)
+            {
+                updateAlertWatches();
+            }
+        }
 
         // Subscribe to power supply presence changes
-        auto presenceMatch = std::make_unique<sdbusplus::bus::match_t>(
-            bus,
-            sdbusplus::bus::match::rules::propertiesChanged(invpath,
-                                                            INVENTORY_IFACE),
-            [this](auto& msg) { this->presenceChanged(msg); });
-        presenceMatches.emplace_back(std::move(presenceMatch));
+        presenceMatches.emplace_back(inventoryMatches.propertiesChanged(
+            invpath, INVENTORY_IFACE,
+            [this](auto& msg) { this->presenceChanged(msg); }));
     }
 
     if (psus.empty())
@@ -254,6 +453,7 @@ void PSUManager::populateSysProperties(const util::DbusPropertyMap& properties)
         }
 
         supportedConfigs.emplace(*model, sys);
+        requiredPSUsState.reset();
     }
     catch (const std::exception& e)
     {}
@@ -261,37 +461,248 @@ void PSUManager::populateSysProperties(const util::DbusPropertyMap& properties)
 
 void PSUManager::getSystemProperties()
 {
+    try
+    {
+        startConfigCall(util::getSubTreeAsync(
+            bus, INVENTORY_OBJ_PATH, supportedConfIntf, 0,
+            [this](std::optional<util::DbusSubtree> subtree) {
+                // If the interface or properties are not found, let the
+                // Interfaces Added callback process the information once the
+                // interfaces are added to D-Bus.
+                for (const auto& [objPath, services] :
+                     subtree.value_or(util::DbusSubtree{}))
+                {
+                    std::string service = services.begin()->first;
+                    if (objPath.empty() || service.empty())
+                    {
+                        continue;
+                    }
+                    startConfigCall(util::getAllPropertiesAsync(
+                        bus, objPath, supportedConfIntf, service,
+                        [this](
+                            std::optional<util::DbusPropertyMap> properties) {
+                            if (properties)
+                            {
+                                populateSysProperties(*properties);
+                            }
+                            endConfigCall();
+                        }));
+                }
+                endConfigCall();
+            }));
+    }
+    catch (const std::exception& e)
+    {
+        // Let the Interfaces Added callback process the information once the
+        // interfaces are added to D-Bus.
+    }
+}
+
+void PSUManager::getManagedObjects()
+{
+    psus.clear();
+    psuStates.clear();
+    psuConfigs = nlohmann::json::array();
+    requiredPSUsState.reset();
+
+    try
+    {
+        startConfigCall(util::getManagedObjectsAsync(
+            bus, entityManagerService, "/",
+            [this](std::optional<util::DbusManagedObjects> objects) {
+                if (!objects)
+                {
+                    log<level::INFO>("Unable to get Entity Manager objects, "
+                                     "reading each object");
+                    getPSUConfiguration();
+                    getSystemProperties();
+                    endConfigCall();
+                    return;
+                }
+
+                for (auto& [path, interfaces] : *objects)
+                {
+                    auto itIntf = interfaces.find(IBMCFFPSInterface);
+                    if (itIntf != interfaces.end())
+                    {
+                        getPSUProperties(itIntf->second);
+                    }
+
+                    itIntf = interfaces.find(supportedConfIntf);
+                    if (itIntf != interfaces.end())
+                    {
+                        populateSysProperties(itIntf->second);
+                    }
+                }
 
+                if (psus.empty())
+                {
+                    // Let the Interfaces Added callback process the
+                    // information once the interfaces are added to D-Bus.
+                    log<level::INFO>(
+                        fmt::format("No power supplies to monitor").c_str());
+                }
+                endConfigCall();
+            }));
+    }
+    catch (const std::exception& e)
+    {
+        log<level::INFO>(
+            fmt::format("Unable to get Entity Manager objects: {}", e.what())
+                .c_str());
+        getPSUConfiguration();
+        getSystemProperties();
+    }
+}
+
+bool PSUManager::restoreState(const nlohmann::json& state)
+{
     try
     {
-        util::DbusSubtree subtree =
-            util::getSubTree(bus, INVENTORY_OBJ_PATH, supportedConfIntf, 0);
-        if (subtree.empty())
+        // Convert all the values before creating any power supply
+        std::vector<util::DbusPropertyMap> supplies{};
+        for (const auto& supply : state.at("powerSupplies"))
+        {
+            supplies.push_back(
+                {{i2cBusProp, supply.at("bus").get<uint64_t>()},
+                 {i2cAddressProp, supply.at("address").get<uint64_t>()},
+                 {psuNameProp, supply.at("name").get<std::string>()},
+                 {presLineName, supply.at("presenceLine").get<std::string>()},
+                 {alertLineName, supply.at("alertLine").get<std::string>()}});
+        }
+        if (supplies.empty())
         {
-            throw std::runtime_error("Supported Configuration Not Found");
+            return false;
         }
 
-        for (const auto& [objPath, services] : subtree)
+        std::vector<util::DbusPropertyMap> configs{};
+        for (const auto& config : state.at("supportedConfigs"))
+        {
+            configs.push_back(
+                {{"SupportedType", std::string{"PowerSupply"}},
+                 {"SupportedModel", config.at("model").get<std::string>()},
+                 {"RedundantCount",
+                  config.at("redundantCount").get<uint64_t>()},
+                 {"InputVoltage",
+                  config.at("inputVoltage").get<std::vector<uint64_t>>()},
+                 {"PowerConfigFullLoad", config.at("fullLoad").get<bool>()}});
+        }
+
+        std::map<std::string, std::filesystem::path> hwmonDirs{};
+        for (const auto& [device, dir] :
+             state.at("hwmonDirs").get<std::map<std::string, std::string>>())
+        {
+            hwmonDirs.emplace(device, dir);
+        }
+
+        // The devices find their hwmon directories when they are created
+        phosphor::pmbus::HwmonIndex::getInstance().restore(
+            std::move(hwmonDirs));
+        for (util::DbusPropertyMap& properties : supplies)
+        {
+            getPSUProperties(properties);
+        }
+        for (const util::DbusPropertyMap& properties : configs)
         {
-            std::string service = services.begin()->first;
-            if (objPath.empty() || service.empty())
-            {
-                continue;
-            }
-            auto properties = util::getAllProperties(
-                bus, objPath, supportedConfIntf, service);
             populateSysProperties(properties);
         }
+        log<level::INFO>(
+            fmt::format("Restored {} power supplies of the previous instance",
+                        psus.size())
+                .c_str());
+        return true;
     }
     catch (const std::exception& e)
     {
-        // Interface or property not found. Let the Interfaces Added callback
-        // process the information once the interfaces are added to D-Bus.
+        log<level::ERR>(
+            fmt::format("Unable to restore the state of the previous "
+                        "instance: {}",
+                        e.what())
+                .c_str());
+        return false;
+    }
+}
+
+void PSUManager::saveState()
+{
+    util::EventLoopLag::Scope lagScope{lagMonitor.getLag(),
+                                       "PSUManager::saveState"};
+
+    // A partial configuration would keep the next instance from reading the
+    // rest of it
+    if ((pendingConfigCalls > 0) || psus.empty())
+    {
+        return;
+    }
+
+    nlohmann::json configs = nlohmann::json::array();
+    for (const auto& [model, sys] : supportedConfigs)
+    {
+        configs.push_back(
+            {{"model", model},
+             {"redundantCount", static_cast<uint64_t>(sys.powerSupplyCount)},
+             {"inputVoltage", sys.inputVoltage},
+             {"fullLoad", sys.powerConfigFullLoad}});
+    }
+
+    std::map<std::string, std::string> hwmonDirs{};
+    for (const auto& [device, dir] :
+         phosphor::pmbus::HwmonIndex::getInstance().getEntries())
+    {
+        hwmonDirs.emplace(device, dir.string());
+    }
+
+    stateHandoff.save({{"powerSupplies", psuConfigs},
+                       {"supportedConfigs", configs},
+                       {"hwmonDirs", hwmonDirs}});
+}
+
+void PSUManager::startConfigCall(util::AsyncCallPtr call)
+{
+    configCalls.emplace_back(std::move(call));
+    ++pendingConfigCalls;
+}
+
+void PSUManager::endConfigCall()
+{
+    if (--pendingConfigCalls > 0)
+    {
+        return;
+    }
+
+    // All of the configuration has been read.  Do the work that initialize()
+    // could not do before the power supplies and configurations were known.
+    // The calls are not destroyed here, since this runs from the handler of
+    // one of them.
+    setPowerConfigGPIO();
+    scheduleValidation();
+
+    // Analyze the power supplies right away the first time, instead of on the
+    // next tick, so the manager is ready sooner
+    using Phase = util::StartupTimes::Phase;
+    if (!startupTimes.isComplete(Phase::configLoad))
+    {
+        startupTimes.complete(Phase::configLoad);
+        alarmTimer->restartOnce(std::chrono::milliseconds(0));
+    }
+}
+
+void PSUManager::scheduleValidation()
+{
+    // Call to validate the psu configuration if the power is on and both
+    // the IBMCFFPSConnector and SupportedConfiguration interfaces have been
+    // processed
+    if (powerState.isPoweredOn() && !psus.empty() && !supportedConfigs.empty())
+    {
+        validationTimer->restartOnce(validationTimeout);
     }
 }
 
 void PSUManager::entityManagerIfaceAdded(sdbusplus::message::message& msg)
 {
+    util::EventLoopLag::Scope lagScope{lagMonitor.getLag(),
+                                       "PSUManager::entityManagerIfaceAdded"};
+
     try
     {
         sdbusplus::message::object_path objPath;
@@ -299,6 +710,9 @@ void PSUManager::entityManagerIfaceAdded(sdbusplus::message::message& msg)
             interfaces;
         msg.read(objPath, interfaces);
 
+        // The PSUs or the supported configurations may change
+        requiredPSUsState.reset();
+
         auto itIntf = interfaces.find(supportedConfIntf);
         if (itIntf != interfaces.cend())
         {
@@ -314,13 +728,7 @@ void PSUManager::entityManagerIfaceAdded(sdbusplus::message::message& msg)
             getPSUProperties(itIntf->second);
         }
 
-        // Call to validate the psu configuration if the power is on and both
-        // the IBMCFFPSConnector and SupportedConfiguration interfaces have been
-        // processed
-        if (powerOn && !psus.empty() && !supportedConfigs.empty())
-        {
-            validationTimer->restartOnce(validationTimeout);
-        }
+        scheduleValidation();
     }
     catch (const std::exception& e)
     {
@@ -328,37 +736,30 @@ void PSUManager::entityManagerIfaceAdded(sdbusplus::message::message& msg)
     }
 }
 
-void PSUManager::powerStateChanged(sdbusplus::message::message& msg)
+void PSUManager::powerStateChanged(bool powerOn)
 {
-    int32_t state = 0;
-    std::string msgSensor;
-    std::map<std::string, std::variant<int32_t>> msgData;
-    msg.read(msgSensor, msgData);
+    util::EventLoopLag::Scope lagScope{lagMonitor.getLag(),
+                                       "PSUManager::powerStateChanged"};
 
-    // Check if it was the Present property that changed.
-    auto valPropMap = msgData.find("state");
-    if (valPropMap != msgData.end())
+    // Clear faults when the power turns on
+    if (powerOn)
     {
-        state = std::get<int32_t>(valPropMap->second);
-
-        // Power is on when state=1. Clear faults.
-        if (state)
-        {
-            powerOn = true;
-            validationTimer->restartOnce(validationTimeout);
-            clearFaults();
-            setPowerConfigGPIO();
-        }
-        else
-        {
-            powerOn = false;
-            runValidateConfig = true;
-        }
+        validationTimer->restartOnce(validationTimeout);
+        clearFaults();
+        setPowerConfigGPIO();
+    }
+    else
+    {
+        runValidateConfig = true;
+        resetCapacity();
     }
 }
 
 void PSUManager::presenceChanged(sdbusplus::message::message& msg)
 {
+    util::EventLoopLag::Scope lagScope{lagMonitor.getLag(),
+                                       "PSUManager::presenceChanged"};
+
     std::string msgSensor;
     std::map<std::string, std::variant<uint32_t, bool>> msgData;
     msg.read(msgSensor, msgData);
@@ -367,6 +768,7 @@ void PSUManager::presenceChanged(sdbusplus::message::message& msg)
     auto valPropMap = msgData.find(PRESENT_PROP);
     if (valPropMap != msgData.end())
     {
+        requiredPSUsState.reset();
         if (std::get<bool>(valPropMap->second))
         {
             // A PSU became present, force the PSU validation to run.
@@ -380,248 +782,800 @@ void PSUManager::createError(const std::string& faultName,
                              std::map<std::string, std::string>& additionalData)
 {
     using namespace sdbusplus::xyz::openbmc_project;
-    constexpr auto loggingObjectPath = "/xyz/openbmc_project/logging";
-    constexpr auto loggingCreateInterface =
-        "xyz.openbmc_project.Logging.Create";
-
-    try
-    {
-        additionalData["_PID"] = std::to_string(getpid());
 
-        auto service =
-            util::getService(loggingObjectPath, loggingCreateInterface, bus);
-
-        if (service.empty())
-        {
-            log<level::ERR>("Unable to get logging manager service");
-            return;
-        }
+    additionalData["_PID"] = std::to_string(getpid());
 
-        auto method = bus.new_method_call(service.c_str(), loggingObjectPath,
-                                          loggingCreateInterface, "Create");
+    errorLogQueue.submit(faultName, Logging::server::Entry::Level::Error,
+                         additionalData);
+}
 
-        auto level = Logging::server::Entry::Level::Error;
-        method.append(faultName, level, additionalData);
+void PSUManager::analyzeTick()
+{
+    util::EventLoopLag::Scope lagScope{lagMonitor.getLag(),
+                                       "PSUManager::analyzeTick"};
 
-        auto reply = bus.call(method);
-    }
-    catch (const std::exception& e)
+    if (!staggering || psus.empty())
     {
-        log<level::ERR>(
-            fmt::format(
-                "Failed creating event log for fault {} due to error {}",
-                faultName, e.what())
-                .c_str());
+        analyze();
+        return;
     }
+
+    // The power supplies can change between ticks
+    nextPSU %= psus.size();
+    auto selected = std::span{psus}.subspan(nextPSU, 1);
+    nextPSU++;
+    analyze(selected);
 }
 
 void PSUManager::analyze()
 {
-    for (auto& psu : psus)
+    util::EventLoopLag::Scope lagScope{lagMonitor.getLag(),
+                                       "PSUManager::analyze"};
+
+    analyze(psus);
+}
+
+void PSUManager::analyze(std::span<const std::unique_ptr<PowerSupply>> selected)
+{
+    POWER_TRACE_SCOPE("PSUManager::analyze", "", "");
+    auto start = std::chrono::steady_clock::now();
+
+    // The first analysis of all the power supplies after the configuration
+    // was read completes the startup.  The presence of each one is known
+    // once it is analyzed.
+    using Phase = util::StartupTimes::Phase;
+    bool isFullCycle = startupTimes.isComplete(Phase::configLoad) &&
+                       !startupTimes.isReady() &&
+                       (selected.size() == psus.size());
+
+    if (parallel)
     {
-        psu->analyze();
+        // Presence changes and error commits access D-Bus, so only the status
+        // reads are done on other threads
+        for (auto& psu : selected)
+        {
+            psu->analyzePresence();
+        }
+        if (isFullCycle)
+        {
+            startupTimes.complete(Phase::hardwareDiscovery);
+        }
+        analyzeStatusParallel(selected);
+        for (auto& psu : selected)
+        {
+            psu->commitReadFailure();
+            psu->publishEnergyHistory();
+        }
     }
-
-    if (powerOn)
+    else
     {
-        std::map<std::string, std::string> additionalData;
-
-        for (auto& psu : psus)
+        for (auto& psu : selected)
         {
-            additionalData.clear();
+            psu->analyze();
+        }
+    }
 
-            if (!psu->isFaultLogged() && !psu->isPresent())
+    if (powerState.isPoweredOn())
+    {
+        for (auto& psu : selected)
+        {
+            updateCapacity(*psu);
+        }
+        for (auto& psu : selected)
+        {
+            // Most power supplies are present and working, so check their
+            // state in the table before looking at them
+            if (psuStates.needsError(psu->getStateSlot()))
             {
-                std::map<std::string, std::string> requiredPSUsData;
-                auto requiredPSUsPresent = hasRequiredPSUs(requiredPSUsData);
-                if (!requiredPSUsPresent)
-                {
-                    additionalData.merge(requiredPSUsData);
-                    // Create error for power supply missing.
-                    additionalData["CALLOUT_INVENTORY_PATH"] =
-                        psu->getInventoryPath();
-                    additionalData["CALLOUT_PRIORITY"] = "H";
-                    createError(
-                        "xyz.openbmc_project.Power.PowerSupply.Error.Missing",
-                        additionalData);
-                }
-                psu->setFaultLogged();
+                createErrors(psu.get());
             }
-            else if (!psu->isFaultLogged() && psu->isFaulted())
-            {
-                // Add STATUS_WORD and STATUS_MFR last response, in padded
-                // hexadecimal format.
-                additionalData["STATUS_WORD"] =
-                    fmt::format("{:#04x}", psu->getStatusWord());
-                additionalData["STATUS_MFR"] =
-                    fmt::format("{:#02x}", psu->getMFRFault());
-                // If there are faults being reported, they possibly could be
-                // related to a bug in the firmware version running on the power
-                // supply. Capture that data into the error as well.
-                additionalData["FW_VERSION"] = psu->getFWVersion();
-
-                if (psu->hasCommFault())
-                {
-                    additionalData["STATUS_CML"] =
-                        fmt::format("{:#02x}", psu->getStatusCML());
-                    /* Attempts to communicate with the power supply have
-                     * reached there limit. Create an error. */
-                    additionalData["CALLOUT_DEVICE_PATH"] =
-                        psu->getDevicePath();
-
-                    createError(
-                        "xyz.openbmc_project.Power.PowerSupply.Error.CommFault",
-                        additionalData);
-
-                    psu->setFaultLogged();
-                }
-                else if ((psu->hasInputFault() || psu->hasVINUVFault()))
-                {
-                    // Include STATUS_INPUT for input faults.
-                    additionalData["STATUS_INPUT"] =
-                        fmt::format("{:#02x}", psu->getStatusInput());
-
-                    /* The power supply location might be needed if the input
-                     * fault is due to a problem with the power supply itself.
-                     * Include the inventory path with a call out priority of
-                     * low.
-                     */
-                    additionalData["CALLOUT_INVENTORY_PATH"] =
-                        psu->getInventoryPath();
-                    additionalData["CALLOUT_PRIORITY"] = "L";
-                    createError("xyz.openbmc_project.Power.PowerSupply.Error."
-                                "InputFault",
-                                additionalData);
-                    psu->setFaultLogged();
-                }
-                else if (psu->hasPSKillFault())
-                {
-                    createError(
-                        "xyz.openbmc_project.Power.PowerSupply.Error.PSKillFault",
-                        additionalData);
-                    psu->setFaultLogged();
-                }
-                else if (psu->hasVoutOVFault())
-                {
-                    // Include STATUS_VOUT for Vout faults.
-                    additionalData["STATUS_VOUT"] =
-                        fmt::format("{:#02x}", psu->getStatusVout());
-
-                    additionalData["CALLOUT_INVENTORY_PATH"] =
-                        psu->getInventoryPath();
-
-                    createError(
-                        "xyz.openbmc_project.Power.PowerSupply.Error.Fault",
-                        additionalData);
+        }
+    }
 
-                    psu->setFaultLogged();
-                }
-                else if (psu->hasIoutOCFault())
-                {
-                    // Include STATUS_IOUT for Iout faults.
-                    additionalData["STATUS_IOUT"] =
-                        fmt::format("{:#02x}", psu->getStatusIout());
+    if (eventMode)
+    {
+        // Watch the alarm files again if the power supplies or their presence
+        // changed, since the hwmon files are created when the driver binds
+        bool changed = (alarmSourcePSUs.size() != psus.size());
+        for (size_t i = 0; !changed && (i < psus.size()); i++)
+        {
+            changed = (alarmSourcePSUs[i].first != psus[i].get()) ||
+                      (alarmSourcePSUs[i].second != psus[i]->isPresent());
+        }
 
-                    createError(
-                        "xyz.openbmc_project.Power.PowerSupply.Error.IoutOCFault",
-                        additionalData);
+        if (changed)
+        {
+            updateAlarmSources();
+        }
+    }
+    else if ((presenceSettleTime.count() > 0) &&
+             (presenceSourcePSUs != psus.size()))
+    {
+        // Debounce the presence GPIOs with their edge events when polling
+        updatePresenceSources();
+    }
 
-                    psu->setFaultLogged();
-                }
-                else if (psu->hasVoutUVFault() || psu->hasPS12VcsFault() ||
-                         psu->hasPSCS12VFault())
-                {
-                    // Include STATUS_VOUT for Vout faults.
-                    additionalData["STATUS_VOUT"] =
-                        fmt::format("{:#02x}", psu->getStatusVout());
+    // Validate as soon as all the expected PSUs have reported instead of
+    // waiting for the validation timer
+    if (runValidateConfig && validationTimer->isEnabled() &&
+        allPSUsReported())
+    {
+        validationTimer->setEnabled(false);
+        validateConfig();
+    }
+    updateAnalyzeInterval();
 
-                    additionalData["CALLOUT_INVENTORY_PATH"] =
-                        psu->getInventoryPath();
+    if (isFullCycle)
+    {
+        startupTimes.complete(Phase::firstCycle);
+        startupTimes.setReady();
+    }
 
-                    createError(
-                        "xyz.openbmc_project.Power.PowerSupply.Error.Fault",
-                        additionalData);
+    // Record the cycle time against the current analyze interval
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start);
+    analyzeCycleStats.setInterval(timer->getInterval());
+    if (analyzeCycleStats.record(duration) &&
+        analyzeCycleStats.isOverrunWarningEnabled())
+    {
+        log<level::WARNING>(
+            fmt::format("Power supply analysis cycle overrun: {}",
+                        analyzeCycleStats.toString())
+                .c_str());
+    }
+}
 
-                    psu->setFaultLogged();
-                }
-                // A fan fault should have priority over a temperature fault,
-                // since a failed fan may lead to a temperature problem.
-                else if (psu->hasFanFault())
-                {
-                    // Include STATUS_TEMPERATURE and STATUS_FANS_1_2
-                    additionalData["STATUS_TEMPERATURE"] =
-                        fmt::format("{:#02x}", psu->getStatusTemperature());
-                    additionalData["STATUS_FANS_1_2"] =
-                        fmt::format("{:#02x}", psu->getStatusFans12());
+void PSUManager::updateCapacity(const PowerSupply& psu)
+{
+    bool lost = !psu.isPresent() || psu.isCapacityLost();
+    auto it = capacityLost.find(psu.getInventoryPath());
+    if (it == capacityLost.end())
+    {
+        // Only a power supply that was working can lose capacity
+        if (!lost)
+        {
+            capacityLost.emplace(psu.getInventoryPath(), false);
+        }
+        return;
+    }
+    if (it->second == lost)
+    {
+        return;
+    }
+    it->second = lost;
 
-                    additionalData["CALLOUT_INVENTORY_PATH"] =
-                        psu->getInventoryPath();
+    auto working = static_cast<uint32_t>(
+        std::count_if(capacityLost.begin(), capacityLost.end(),
+                      [](const auto& entry) { return !entry.second; }));
+    if (lost)
+    {
+        // Throttle first; the signal goes out over D-Bus
+        setThrottleGPIO(1);
+
+        std::string reason = !psu.isPresent() ? "Removed"
+                             : (psu.hasInputFault() || psu.hasVINUVFault())
+                                 ? "InputFault"
+                                 : "PGOODFault";
+        log<level::WARNING>(
+            fmt::format("Power supply {} lost capacity: {}, {} working",
+                        psu.getInventoryPath(), reason, working)
+                .c_str());
+        capacityInterface.capacityReduced(psu.getInventoryPath(), reason,
+                                          working);
+    }
+    else
+    {
+        capacityInterface.capacityRestored(psu.getInventoryPath(), working);
+        if (working == capacityLost.size())
+        {
+            setThrottleGPIO(0);
+        }
+    }
+}
 
-                    createError(
-                        "xyz.openbmc_project.Power.PowerSupply.Error.FanFault",
-                        additionalData);
+void PSUManager::resetCapacity()
+{
+    capacityLost.clear();
+    setThrottleGPIO(0);
+}
 
-                    psu->setFaultLogged();
-                }
-                else if (psu->hasTempFault())
-                {
-                    // Include STATUS_TEMPERATURE for temperature faults.
-                    additionalData["STATUS_TEMPERATURE"] =
-                        fmt::format("{:#02x}", psu->getStatusTemperature());
+void PSUManager::setThrottleGPIO(int value)
+{
+    if (!throttleGPIO)
+    {
+        return;
+    }
 
-                    additionalData["CALLOUT_INVENTORY_PATH"] =
-                        psu->getInventoryPath();
+    try
+    {
+        throttleGPIO->write(value, 0);
+    }
+    catch (const std::exception& e)
+    {
+        log<level::ERR>(
+            fmt::format("Unable to write throttle GPIO: {}", e.what())
+                .c_str());
+    }
+}
 
-                    createError(
-                        "xyz.openbmc_project.Power.PowerSupply.Error.Fault",
-                        additionalData);
+void PSUManager::createErrors(PowerSupply* psu)
+{
+    std::map<std::string, std::string> additionalData;
 
-                    psu->setFaultLogged();
-                }
-                else if (psu->hasMFRFault())
-                {
-                    /* This can represent a variety of faults that result in
-                     * calling out the power supply for replacement: Output
-                     * OverCurrent, Output Under Voltage, and potentially other
-                     * faults.
-                     *
-                     * Also plan on putting specific fault in AdditionalData,
-                     * along with register names and register values
-                     * (STATUS_WORD, STATUS_MFR, etc.).*/
-
-                    additionalData["CALLOUT_INVENTORY_PATH"] =
-                        psu->getInventoryPath();
-
-                    createError(
-                        "xyz.openbmc_project.Power.PowerSupply.Error.Fault",
-                        additionalData);
+    if (!psu->isFaultLogged() && !psu->isPresent())
+    {
+        std::map<std::string, std::string> requiredPSUsData;
+        auto requiredPSUsPresent = hasRequiredPSUs(requiredPSUsData);
+        if (!requiredPSUsPresent)
+        {
+            additionalData.merge(requiredPSUsData);
+            // Create error for power supply missing.
+            additionalData["CALLOUT_INVENTORY_PATH"] =
+                psu->getInventoryPath();
+            additionalData["CALLOUT_PRIORITY"] = "H";
+            createError(
+                "xyz.openbmc_project.Power.PowerSupply.Error.Missing",
+                additionalData);
+        }
+        psu->setFaultLogged();
+    }
+    else if (!psu->isFaultLogged() && psu->isFaulted())
+    {
+        // Add STATUS_WORD and STATUS_MFR last response, in padded
+        // hexadecimal format.
+        additionalData["STATUS_WORD"] =
+            fmt::format("{:#04x}", psu->getStatusWord());
+        additionalData["STATUS_MFR"] =
+            fmt::format("{:#02x}", psu->getMFRFault());
+        // The status samples leading up to the fault, to tell a glitch
+        // from a lasting fault
+        additionalData["STATUS_HISTORY"] = psu->getStatusHistory().toString();
+        // If there are faults being reported, they possibly could be
+        // related to a bug in the firmware version running on the power
+        // supply. Capture that data into the error as well.
+        additionalData["FW_VERSION"] = psu->getFWVersion();
+
+        // Time from the first detection of the fault, before any
+        // deglitching, until the error is created
+        std::optional<std::chrono::microseconds> latency;
+        if (auto detected = psu->getFaultDetectedTime())
+        {
+            latency =
+                std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - *detected);
+            additionalData["FAULT_DETECTION_LATENCY_US"] =
+                std::to_string(latency->count());
+        }
 
-                    psu->setFaultLogged();
-                }
-                else if (psu->hasPgoodFault())
-                {
-                    /* POWER_GOOD# is not low, or OFF is on */
-                    additionalData["CALLOUT_INVENTORY_PATH"] =
-                        psu->getInventoryPath();
+        if (psu->hasCommFault())
+        {
+            additionalData["STATUS_CML"] =
+                fmt::format("{:#02x}", psu->getStatusCML());
+            /* Attempts to communicate with the power supply have
+             * reached there limit. Create an error. */
+            additionalData["CALLOUT_DEVICE_PATH"] =
+                psu->getDevicePath();
+
+            createError(
+                "xyz.openbmc_project.Power.PowerSupply.Error.CommFault",
+                additionalData);
 
-                    createError(
-                        "xyz.openbmc_project.Power.PowerSupply.Error.Fault",
+            psu->setFaultLogged();
+        }
+        else if ((psu->hasInputFault() || psu->hasVINUVFault()))
+        {
+            // Include STATUS_INPUT for input faults.
+            additionalData["STATUS_INPUT"] =
+                fmt::format("{:#02x}", psu->getStatusInput());
+
+            /* The power supply location might be needed if the input
+             * fault is due to a problem with the power supply itself.
+             * Include the inventory path with a call out priority of
+             * low.
+             */
+            additionalData["CALLOUT_INVENTORY_PATH"] =
+                psu->getInventoryPath();
+            additionalData["CALLOUT_PRIORITY"] = "L";
+            createError("xyz.openbmc_project.Power.PowerSupply.Error."
+                        "InputFault",
                         additionalData);
+            psu->setFaultLogged();
+        }
+        else if (psu->hasPSKillFault())
+        {
+            createError(
+                "xyz.openbmc_project.Power.PowerSupply.Error.PSKillFault",
+                additionalData);
+            psu->setFaultLogged();
+        }
+        else if (psu->hasVoutOVFault())
+        {
+            // Include STATUS_VOUT for Vout faults.
+            additionalData["STATUS_VOUT"] =
+                fmt::format("{:#02x}", psu->getStatusVout());
+
+            additionalData["CALLOUT_INVENTORY_PATH"] =
+                psu->getInventoryPath();
+
+            createError(
+                "xyz.openbmc_project.Power.PowerSupply.Error.Fault",
+                additionalData);
+
+            psu->setFaultLogged();
+        }
+        else if (psu->hasIoutOCFault())
+        {
+            // Include STATUS_IOUT for Iout faults.
+            additionalData["STATUS_IOUT"] =
+                fmt::format("{:#02x}", psu->getStatusIout());
+
+            createError(
+                "xyz.openbmc_project.Power.PowerSupply.Error.IoutOCFault",
+                additionalData);
+
+            psu->setFaultLogged();
+        }
+        else if (psu->hasVoutUVFault() || psu->hasPS12VcsFault() ||
+                 psu->hasPSCS12VFault())
+        {
+            // Include STATUS_VOUT for Vout faults.
+            additionalData["STATUS_VOUT"] =
+                fmt::format("{:#02x}", psu->getStatusVout());
+
+            additionalData["CALLOUT_INVENTORY_PATH"] =
+                psu->getInventoryPath();
+
+            createError(
+                "xyz.openbmc_project.Power.PowerSupply.Error.Fault",
+                additionalData);
+
+            psu->setFaultLogged();
+        }
+        // A fan fault should have priority over a temperature fault,
+        // since a failed fan may lead to a temperature problem.
+        else if (psu->hasFanFault())
+        {
+            // Include STATUS_TEMPERATURE and STATUS_FANS_1_2
+            additionalData["STATUS_TEMPERATURE"] =
+                fmt::format("{:#02x}", psu->getStatusTemperature());
+            additionalData["STATUS_FANS_1_2"] =
+                fmt::format("{:#02x}", psu->getStatusFans12());
+
+            additionalData["CALLOUT_INVENTORY_PATH"] =
+                psu->getInventoryPath();
+
+            createError(
+                "xyz.openbmc_project.Power.PowerSupply.Error.FanFault",
+                additionalData);
+
+            psu->setFaultLogged();
+        }
+        else if (psu->hasTempFault())
+        {
+            // Include STATUS_TEMPERATURE for temperature faults.
+            additionalData["STATUS_TEMPERATURE"] =
+                fmt::format("{:#02x}", psu->getStatusTemperature());
 
-                    psu->setFaultLogged();
+            additionalData["CALLOUT_INVENTORY_PATH"] =
+                psu->getInventoryPath();
+
+            createError(
+                "xyz.openbmc_project.Power.PowerSupply.Error.Fault",
+                additionalData);
+
+            psu->setFaultLogged();
+        }
+        else if (psu->hasMFRFault())
+        {
+            /* This can represent a variety of faults that result in
+             * calling out the power supply for replacement: Output
+             * OverCurrent, Output Under Voltage, and potentially other
+             * faults.
+             *
+             * Also plan on putting specific fault in AdditionalData,
+             * along with register names and register values
+             * (STATUS_WORD, STATUS_MFR, etc.).*/
+
+            additionalData["CALLOUT_INVENTORY_PATH"] =
+                psu->getInventoryPath();
+
+            createError(
+                "xyz.openbmc_project.Power.PowerSupply.Error.Fault",
+                additionalData);
+
+            psu->setFaultLogged();
+        }
+        else if (psu->hasPgoodFault())
+        {
+            /* POWER_GOOD# is not low, or OFF is on */
+            additionalData["CALLOUT_INVENTORY_PATH"] =
+                psu->getInventoryPath();
+
+            createError(
+                "xyz.openbmc_project.Power.PowerSupply.Error.Fault",
+                additionalData);
+
+            psu->setFaultLogged();
+        }
+
+        if (latency && psu->isFaultLogged())
+        {
+            faultLatencyStats.record(*latency);
+        }
+    }
+}
+
+void PSUManager::analyzeStatusParallel(
+    std::span<const std::unique_ptr<PowerSupply>> selected)
+{
+    // Group the power supplies by I2C bus, keeping their order
+    std::map<uint8_t, std::vector<PowerSupply*>> buses;
+    for (auto& psu : selected)
+    {
+        buses[psu->getI2CBus()].push_back(psu.get());
+    }
+
+    auto analyzeBus = [](const std::vector<PowerSupply*>& busPSUs) {
+        for (auto* psu : busPSUs)
+        {
+            psu->analyzeStatus();
+        }
+    };
+
+    // The fault path threads run with their own scheduling options.  They
+    // still read the power supplies if the options cannot be set.
+    bool realtime = faultPathOptions.isThreadRealtime();
+    auto analyzeBusOnFaultPath =
+        [this, &analyzeBus](const std::vector<PowerSupply*>& busPSUs) {
+            try
+            {
+                util::setThreadRealtime(faultPathOptions);
+            }
+            catch (const std::exception& e)
+            {
+                // The threads are started every cycle; only journal once
+                if (!faultPathErrorLogged.exchange(true))
+                {
+                    log<level::ERR>(e.what());
                 }
             }
+            analyzeBus(busPSUs);
+        };
+
+    // Read the power supplies on this thread if there is only one bus
+    if ((buses.size() <= 1) && !realtime)
+    {
+        for (const auto& [busNumber, busPSUs] : buses)
+        {
+            analyzeBus(busPSUs);
         }
+        return;
+    }
+
+    std::vector<std::future<void>> workers;
+    for (const auto& [busNumber, busPSUs] : buses)
+    {
+        try
+        {
+            if (realtime)
+            {
+                workers.emplace_back(std::async(std::launch::async,
+                                                analyzeBusOnFaultPath,
+                                                std::cref(busPSUs)));
+            }
+            else
+            {
+                workers.emplace_back(std::async(std::launch::async, analyzeBus,
+                                                std::cref(busPSUs)));
+            }
+        }
+        catch (const std::system_error&)
+        {
+            // Unable to start a thread; read this bus after the others
+            workers.emplace_back(std::async(std::launch::deferred, analyzeBus,
+                                            std::cref(busPSUs)));
+        }
+    }
+
+    // Wait for all the workers to finish before any errors are created
+    for (auto& worker : workers)
+    {
+        worker.get();
+    }
+}
+
+void PSUManager::updatePresenceSources()
+{
+    presenceSources.clear();
+    presenceSourcePSUs = psus.size();
+
+    auto event = timer->get_event();
+    for (auto& psu : psus)
+    {
+        // Analyze when the presence GPIO changes instead of waiting for the
+        // next poll.  The GPIO stays requested for events.
+        GPIOInterfaceBase* presenceGPIO = psu->getPresenceGPIO();
+        if (presenceGPIO == nullptr)
+        {
+            continue;
+        }
+
+        try
+        {
+            int fd = presenceGPIO->requestEvents();
+            if (fd >= 0)
+            {
+                presenceSources.emplace_back(
+                    std::make_unique<sdeventplus::source::IO>(
+                        event, fd, EPOLLIN,
+                        [this, presenceGPIO, supply = psu.get()](
+                            sdeventplus::source::IO&, int, uint32_t) {
+                            presenceGPIO->clearEvents();
+                            presenceEdge(*supply);
+                        }));
+            }
+        }
+        catch (const std::exception& e)
+        {
+            log<level::ERR>(
+                fmt::format("Unable to watch presence GPIO {}: {}",
+                            psu->getPresenceGPIOName(), e.what())
+                    .c_str());
+        }
+    }
+}
+
+void PSUManager::presenceEdge(PowerSupply& psu)
+{
+    util::EventLoopLag::Scope lagScope{lagMonitor.getLag(),
+                                       "PSUManager::presenceEdge"};
+
+    psu.presenceEdge();
+    if (presenceSettleTime.count() > 0)
+    {
+        // Analyze once the line has settled.  Each edge restarts the wait.
+        presenceTimer->restartOnce(presenceSettleTime);
+    }
+    else
+    {
+        alarmTimer->restartOnce(std::chrono::milliseconds(0));
+    }
+}
+
+void PSUManager::updateAlarmSources()
+{
+    alarmSources.clear();
+    alarmSourcePSUs.clear();
+    hasUnwatchedPSU = false;
+    updatePresenceSources();
+
+    auto event = timer->get_event();
+    for (auto& psu : psus)
+    {
+        alarmSourcePSUs.emplace_back(psu.get(), psu->isPresent());
+
+        if (!psu->isPresent())
+        {
+            continue;
+        }
+
+        auto files = psu->getPMBus().getAlarmFiles();
+        if (files.empty())
+        {
+            // Fall back to polling this power supply
+            hasUnwatchedPSU = true;
+            continue;
+        }
+
+        for (const auto& file : files)
+        {
+            auto alarm = std::make_unique<AlarmSource>();
+            alarm->fd.set(open(file.c_str(), O_RDONLY | O_CLOEXEC));
+
+            // The file must be read once before sysfs will notify of changes
+            if ((alarm->fd() < 0) || !readAlarm(alarm->fd(), alarm->active))
+            {
+                hasUnwatchedPSU = true;
+                continue;
+            }
+
+            try
+            {
+                AlarmSource* alarmPtr = alarm.get();
+                alarm->source = std::make_unique<sdeventplus::source::IO>(
+                    event, alarm->fd(), EPOLLPRI,
+                    [this, alarmPtr](sdeventplus::source::IO&, int, uint32_t) {
+                        this->alarmChanged(*alarmPtr);
+                    });
+            }
+            catch (const std::exception& e)
+            {
+                log<level::ERR>(
+                    fmt::format("Unable to watch alarm file {}: {}",
+                                file.string(), e.what())
+                        .c_str());
+                hasUnwatchedPSU = true;
+                continue;
+            }
+
+            alarmSources.push_back(std::move(alarm));
+        }
+    }
+}
+
+bool PSUManager::readAlarm(int fd, bool& active)
+{
+    char buffer[16];
+    auto bytes = pread(fd, buffer, sizeof(buffer), 0);
+    if (bytes <= 0)
+    {
+        return false;
+    }
+
+    active = (buffer[0] != '0');
+    return true;
+}
+
+void PSUManager::alarmChanged(AlarmSource& alarm)
+{
+    util::EventLoopLag::Scope lagScope{lagMonitor.getLag(),
+                                       "PSUManager::alarmChanged"};
+
+    if (!readAlarm(alarm.fd(), alarm.active))
+    {
+        // The file was likely removed because the driver was unbound.  Stop
+        // watching it and poll until the alarm sources are created again.
+        alarm.source->set_enabled(sdeventplus::source::Enabled::Off);
+        hasUnwatchedPSU = true;
+        updateAnalyzeInterval();
+        return;
+    }
+
+    // Analyze once after all the notifications in this loop iteration
+    alarmTimer->restartOnce(std::chrono::milliseconds(0));
+}
+
+void PSUManager::updateAlertWatches()
+{
+    auto event = alarmTimer->get_event();
+    for (const auto& [name, busNumber] : alertGPIOs)
+    {
+        if (alertWatches.contains(name))
+        {
+            continue;
+        }
+
+        try
+        {
+            auto watch = std::make_unique<AlertWatch>();
+            watch->gpio = createGPIO(name);
+            int fd = watch->gpio->requestEvents();
+            if (fd < 0)
+            {
+                continue;
+            }
+
+            // The GPIO is requested active low, so 1 means SMBALERT# is
+            // asserted
+            GPIOInterfaceBase* gpio = watch->gpio.get();
+            watch->source = std::make_unique<i2c::AlertSource>(
+                i2c::create(busNumber, i2c::alertResponseAddress,
+                            i2c::I2CInterface::InitialState::CLOSED, 0),
+                [gpio]() { return gpio->read() == 1; });
+
+            AlertWatch* watchPtr = watch.get();
+            watch->event = std::make_unique<sdeventplus::source::IO>(
+                event, fd, EPOLLIN,
+                [this, watchPtr](sdeventplus::source::IO&, int, uint32_t) {
+                    alertAsserted(*watchPtr);
+                });
+            alertWatches.emplace(name, std::move(watch));
+        }
+        catch (const std::exception& e)
+        {
+            log<level::ERR>(
+                fmt::format("Unable to watch SMBALERT# GPIO {}: {}", name,
+                            e.what())
+                    .c_str());
+        }
+    }
+}
+
+void PSUManager::alertAsserted(AlertWatch& watch)
+{
+    util::EventLoopLag::Scope lagScope{lagMonitor.getLag(),
+                                       "PSUManager::alertAsserted"};
+
+    watch.gpio->clearEvents();
+
+    std::vector<uint8_t> addresses;
+    try
+    {
+        addresses = watch.source->getAlertingAddresses();
+    }
+    catch (const std::exception& e)
+    {
+        log<level::ERR>(
+            fmt::format("Unable to read the SMBus alert response on bus {}: "
+                        "{}",
+                        watch.source->getBus(), e.what())
+                .c_str());
+    }
+
+    // Analyze just the power supplies that responded.  If one did not
+    // respond, or is not known, analyze all of them instead.
+    std::vector<PowerSupply*> alerting;
+    for (uint8_t address : addresses)
+    {
+        auto it = std::find_if(psus.begin(), psus.end(), [&](auto& psu) {
+            return (psu->getI2CBus() == watch.source->getBus()) &&
+                   (psu->getI2CAddress() == address);
+        });
+        if (it == psus.end())
+        {
+            alerting.clear();
+            break;
+        }
+        alerting.push_back(it->get());
+    }
+
+    if (alerting.empty())
+    {
+        alarmTimer->restartOnce(std::chrono::milliseconds(0));
+        return;
+    }
+
+    for (auto* psu : alerting)
+    {
+        psu->analyze();
+        if (powerState.isPoweredOn())
+        {
+            updateCapacity(*psu);
+            createErrors(psu);
+        }
+    }
+}
+
+void PSUManager::updateAnalyzeInterval()
+{
+    // In event mode, poll while an alarm is active for fault deglitching and
+    // logging
+    bool poll = !eventMode || hasUnwatchedPSU ||
+                std::any_of(alarmSources.begin(), alarmSources.end(),
+                            [](const auto& alarm) { return alarm->active; });
+
+    // Each power supply is analyzed at its own phase of the poll interval
+    staggering = poll && stagger && (psus.size() > 1);
+
+    std::chrono::microseconds interval = pollInterval;
+    if (!poll)
+    {
+        interval = eventModeInterval;
+    }
+    else if (staggering)
+    {
+        interval = std::chrono::microseconds{pollInterval} / psus.size();
+    }
+    if (timer->getInterval() != interval)
+    {
+        timer->restart(interval);
     }
 }
 
 void PSUManager::validateConfig()
 {
+    util::EventLoopLag::Scope lagScope{lagMonitor.getLag(),
+                                       "PSUManager::validateConfig"};
+
     if (!runValidateConfig || supportedConfigs.empty())
     {
         return;
     }
 
+    // Validation runs after the PSUs have changed, when the input voltage
+    // may not have been valid yet for the cached result, so check again
+    requiredPSUsState.reset();
+
     std::map<std::string, std::string> additionalData;
     auto supported = hasRequiredPSUs(additionalData);
     if (supported)
@@ -640,6 +1594,42 @@ void PSUManager::validateConfig()
 
 bool PSUManager::hasRequiredPSUs(
     std::map<std::string, std::string>& additionalData)
+{
+    // The result only changes with the PSUs, their presence and model names,
+    // and the supported configurations, so it is reused while they stay the
+    // same.  The other changes reset the cached state.
+    bool current = requiredPSUsState &&
+                   (requiredPSUsState->psuStates.size() == psus.size());
+    for (size_t i = 0; current && (i < psus.size()); i++)
+    {
+        const auto& [present, model] = requiredPSUsState->psuStates[i];
+        current = (present == psus[i]->isPresent()) &&
+                  (model == psus[i]->getModelName());
+    }
+
+    if (!current)
+    {
+        RequiredPSUsState state;
+        state.psuStates.reserve(psus.size());
+        for (const auto& psu : psus)
+        {
+            state.psuStates.emplace_back(psu->isPresent(),
+                                         psu->getModelName());
+        }
+        state.present = checkRequiredPSUs(state.additionalData);
+        requiredPSUsState = std::move(state);
+    }
+
+    if (!requiredPSUsState->present)
+    {
+        additionalData.insert(requiredPSUsState->additionalData.begin(),
+                              requiredPSUsState->additionalData.end());
+    }
+    return requiredPSUsState->present;
+}
+
+bool PSUManager::checkRequiredPSUs(
+    std::map<std::string, std::string>& additionalData)
 {
     std::string model{};
     if (!validateModelName(model, additionalData))
@@ -647,15 +1637,14 @@ bool PSUManager::hasRequiredPSUs(
         return false;
     }
 
-    auto presentCount =
-        std::count_if(psus.begin(), psus.end(),
-                      [](const auto& psu) { return psu->isPresent(); });
+    auto presentCount = static_cast<int>(psuStates.countPresent());
 
     // Validate the supported configurations. A system may support more than one
     // power supply model configuration. Since all configurations need to be
     // checked, the additional data would contain only the information of the
     // last configuration that did not match.
     std::map<std::string, std::string> tmpAdditionalData;
+    std::optional<std::vector<std::pair<double, int>>> inputVoltages;
     for (const auto& config : supportedConfigs)
     {
         if (config.first != model)
@@ -671,18 +1660,25 @@ bool PSUManager::hasRequiredPSUs(
             continue;
         }
 
+        // Read the input voltages once, concurrently, and check them in
+        // memory
+        if (!inputVoltages)
+        {
+            inputVoltages = collectInputVoltages();
+        }
+
         bool voltageValidated = true;
-        for (const auto& psu : psus)
+        for (size_t i = 0; i < psus.size(); i++)
         {
+            const auto& psu = psus[i];
             if (!psu->isPresent())
             {
                 // Only present PSUs report a valid input voltage
                 continue;
             }
 
-            double actualInputVoltage;
-            int inputVoltage;
-            psu->getInputVoltage(actualInputVoltage, inputVoltage);
+            const auto& [actualInputVoltage, inputVoltage] =
+                (*inputVoltages)[i];
 
             if (std::find(config.second.inputVoltage.begin(),
                           config.second.inputVoltage.end(),
@@ -715,6 +1711,88 @@ bool PSUManager::hasRequiredPSUs(
     return false;
 }
 
+std::vector<std::pair<double, int>> PSUManager::collectInputVoltages() const
+{
+    std::vector<std::pair<double, int>> voltages(psus.size());
+
+    // Group the present power supplies by I2C bus, since the reads on a bus
+    // are done one at a time by its scheduler anyway
+    std::map<uint8_t, std::vector<size_t>> buses;
+    for (size_t i = 0; i < psus.size(); i++)
+    {
+        if (psus[i]->isPresent())
+        {
+            buses[psus[i]->getI2CBus()].push_back(i);
+        }
+    }
+
+    auto readBus = [this, &voltages](const std::vector<size_t>& indexes) {
+        for (auto i : indexes)
+        {
+            psus[i]->getInputVoltage(voltages[i].first, voltages[i].second);
+        }
+    };
+
+    std::vector<std::future<void>> workers;
+    for (const auto& [busNumber, indexes] : buses)
+    {
+        if (buses.size() <= 1)
+        {
+            readBus(indexes);
+            continue;
+        }
+        try
+        {
+            workers.emplace_back(
+                std::async(std::launch::async, readBus, std::cref(indexes)));
+        }
+        catch (const std::system_error&)
+        {
+            // Unable to start a thread; read this bus after the others
+            workers.emplace_back(
+                std::async(std::launch::deferred, readBus, std::cref(indexes)));
+        }
+    }
+    for (auto& worker : workers)
+    {
+        worker.get();
+    }
+    return voltages;
+}
+
+bool PSUManager::allPSUsReported() const
+{
+    // Every present PSU has reported its model name once its driver is
+    // bound, and they are as many as the configuration of the model expects
+    std::string model{};
+    size_t presentCount{0};
+    for (const auto& psu : psus)
+    {
+        if (psu->isDriverWorkPending())
+        {
+            return false;
+        }
+        if (!psu->isPresent())
+        {
+            continue;
+        }
+        const auto& psuModel = psu->getModelName();
+        if (psuModel.empty())
+        {
+            return false;
+        }
+        if (model.empty())
+        {
+            model = psuModel;
+        }
+        presentCount++;
+    }
+
+    auto config = supportedConfigs.find(model);
+    return (config != supportedConfigs.end()) &&
+           (static_cast<int>(presentCount) >= config->second.powerSupplyCount);
+}
+
 bool PSUManager::validateModelName(
     std::string& model, std::map<std::string, std::string>& additionalData)
 {
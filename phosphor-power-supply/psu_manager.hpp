@@ -1,14 +1,40 @@
 #pragma once
 
+#include "capacity_interface.hpp"
+#include "cycle_stats.hpp"
+#include "cycle_stats_interface.hpp"
+#include "error_log_queue.hpp"
+#include "event_loop_lag.hpp"
+#include "event_loop_lag_interface.hpp"
+#include "event_loop_lag_monitor.hpp"
+#include "file_descriptor.hpp"
+#include "match_dispatcher.hpp"
+#include "power_state_watcher.hpp"
 #include "power_supply.hpp"
+#include "realtime.hpp"
+#include "smbus_alert.hpp"
+#include "startup_times.hpp"
+#include "startup_times_interface.hpp"
+#include "state_handoff.hpp"
 #include "types.hpp"
 #include "utility.hpp"
 
+#include <nlohmann/json.hpp>
 #include <phosphor-logging/log.hpp>
 #include <sdbusplus/bus/match.hpp>
 #include <sdeventplus/event.hpp>
+#include <sdeventplus/source/io.hpp>
 #include <sdeventplus/utility/timer.hpp>
 
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <optional>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
 struct sys_properties
 {
     int powerSupplyCount;
@@ -23,9 +49,25 @@ namespace phosphor::power::manager
 {
 
 // Validation timeout. Allow 10s to detect if new EM interfaces show up in D-Bus
-// before performing the validation.
+// before performing the validation.  The validation runs sooner once all the
+// expected PSUs have reported.
 constexpr auto validationTimeout = std::chrono::seconds(10);
 
+// Default interval for analyzing the power supplies when polling for faults.
+constexpr auto analyzeInterval = std::chrono::milliseconds(1000);
+
+// Interval for analyzing the power supplies in event mode while no alarms are
+// active.  This is a safety net in case an alarm notification is missed.
+constexpr auto eventModeInterval = std::chrono::seconds(10);
+
+// Interval for saving the state for the next instance of the application.
+// Well below the maximum age of a restored state.
+constexpr auto stateHandoffInterval = std::chrono::seconds(10);
+
+// Version of the format of the saved state.  Must be changed when the state
+// saved by an older version can no longer be restored.
+constexpr uint32_t stateFormatVersion = 1;
+
 /**
  * @class PSUManager
  *
@@ -45,10 +87,66 @@ class PSUManager
     /**
      * Constructor to read configuration from D-Bus.
      *
+     * In event mode the power supplies are analyzed when one of their hwmon
+     * alarm files changes state, and otherwise only every eventModeInterval.
+     * Power supplies without alarm files are still polled every poll
+     * interval.
+     *
+     * With staggering, each power supply is analyzed at its own phase of the
+     * poll interval, so the buses are not read in a burst once per interval.
+     *
+     * With a presence settle time, the presence GPIOs are watched for edge
+     * events in both modes.  A presence change is applied, and the device
+     * driver bound or unbound, once the GPIO has had no edges for the settle
+     * time, so a bouncing connector does not bind the driver repeatedly.
+     *
+     * In parallel mode the status registers of power supplies on different
+     * I2C buses are read on separate threads, so a slow or unresponsive power
+     * supply does not delay the others.  Presence changes, error commits, and
+     * error creation still happen on the calling thread in the order of the
+     * power supplies.
+     *
+     * If the fault path options set a priority or CPU affinity, the status
+     * registers are always read on separate threads, even in serial mode or
+     * with one I2C bus, and the threads run with those options.  Telemetry,
+     * inventory, and error creation stay on the normal priority event loop.
+     *
+     * With batch discovery the configuration is read from Entity Manager
+     * with a single GetManagedObjects call.  If that call fails, each object
+     * is looked up and read separately.
+     *
      * @param[in] bus - D-Bus bus object
      * @param[in] e - event object
+     * @param[in] eventMode - true to analyze the power supplies when hwmon
+     *                        alarms change state instead of polling
+     * @param[in] parallel - true to analyze the power supplies on different
+     *                       I2C buses concurrently
+     * @param[in] batchDiscovery - true to read the configuration with one
+     *                             D-Bus call
+     * @param[in] energyHistoryRecords - the number of input power history
+     *                                   records computed from READ_EIN to
+     *                                   keep for each power supply, or 0 to
+     *                                   not compute the history
+     * @param[in] faultPathOptions - the scheduling options of the threads
+     *                               that read the status registers
+     * @param[in] throttleGPIOName - the GPIO asserted while a power supply
+     *                               has lost capacity, or empty for none
+     * @param[in] pollInterval - the interval between the analyses of each
+     *                           power supply when polling
+     * @param[in] stagger - true to analyze the power supplies one at a time,
+     *                      spread over the poll interval
+     * @param[in] presenceSettleTime - the time a presence GPIO must keep a
+     *                                 new value before the change is
+     *                                 applied, or 0 to apply it right away
      */
-    PSUManager(sdbusplus::bus::bus& bus, const sdeventplus::Event& e);
+    PSUManager(sdbusplus::bus::bus& bus, const sdeventplus::Event& e,
+               bool eventMode = false, bool parallel = false,
+               bool batchDiscovery = false, size_t energyHistoryRecords = 0,
+               const util::RealtimeOptions& faultPathOptions = {},
+               const std::string& throttleGPIOName = {},
+               std::chrono::milliseconds pollInterval = analyzeInterval,
+               bool stagger = false,
+               std::chrono::milliseconds presenceSettleTime = {});
 
     /**
      * Get PSU properties from D-Bus, use that to build a power supply
@@ -61,15 +159,53 @@ class PSUManager
 
     /**
      * Get PSU configuration from D-Bus
+     *
+     * The power supplies are created from the event loop as the replies
+     * arrive.
      */
     void getPSUConfiguration();
 
     /**
      * @brief Initialize the system properties from the Supported Configuration
      *        D-Bus object provided by Entity Manager.
+     *
+     * The properties are read from the event loop as the replies arrive.
      */
     void getSystemProperties();
 
+    /**
+     * @brief Get the PSU configuration and the system properties from all of
+     *        the Entity Manager objects at once.
+     *
+     * Falls back to getPSUConfiguration() and getSystemProperties() if the
+     * objects cannot be read.
+     */
+    void getManagedObjects();
+
+    /**
+     * @brief Creates the power supplies and supported configurations from
+     *        the state saved by the previous instance of the application,
+     *        instead of reading them from Entity Manager.
+     *
+     * Also restores the hwmon directories of the devices.  Nothing is
+     * restored if the state is invalid.
+     *
+     * @param[in] state - the saved state
+     *
+     * @return true if the state was restored, false otherwise
+     */
+    bool restoreState(const nlohmann::json& state);
+
+    /**
+     * @brief Saves the power supply and supported configuration properties
+     *        and the hwmon directories for the next instance of the
+     *        application.
+     *
+     * Nothing is saved until all of the configuration has been read and
+     * there are power supplies to monitor.
+     */
+    void saveState();
+
     /**
      * Initializes the manager.
      *
@@ -77,30 +213,14 @@ class PSUManager
      */
     void initialize()
     {
-        // When state = 1, system is powered on
-        int32_t state = 0;
-
-        try
+        // The power state was read when the watcher was constructed.  If it
+        // could not be read, assume it is off.
+        if (powerState.isPoweredOn())
         {
-            // Use getProperty utility function to get power state.
-            util::getProperty<int32_t>(POWER_IFACE, "state", POWER_OBJ_PATH,
-                                       powerService, bus, state);
-
-            if (state)
-            {
-                powerOn = true;
-                validationTimer->restartOnce(validationTimeout);
-            }
-            else
-            {
-                powerOn = false;
-                runValidateConfig = true;
-            }
+            validationTimer->restartOnce(validationTimeout);
         }
-        catch (const std::exception& e)
+        else
         {
-            log<level::INFO>("Failed to get power state. Assuming it is off.");
-            powerOn = false;
             runValidateConfig = true;
         }
 
@@ -118,6 +238,15 @@ class PSUManager
         return timer->get_event().loop();
     }
 
+    /**
+     * Returns the startup times.  The manager is ready once the configuration
+     * has been read and all the power supplies have been analyzed.
+     */
+    util::StartupTimes& getStartupTimes()
+    {
+        return startupTimes;
+    }
+
     /**
      * Write PMBus ON_OFF_CONFIG
      *
@@ -152,6 +281,18 @@ class PSUManager
      */
     sdbusplus::bus::bus& bus;
 
+    /**
+     * @brief The times of the startup phases, from when the manager is
+     *        constructed.
+     */
+    util::StartupTimes startupTimes{};
+
+    /**
+     * The error logs waiting to be created, so fault detection does not block
+     * on phosphor-logging
+     */
+    util::ErrorLogQueue errorLogQueue;
+
     /**
      * The timer that runs to periodically check the power supplies.
      */
@@ -167,9 +308,219 @@ class PSUManager
         sdeventplus::utility::Timer<sdeventplus::ClockId::Monotonic>>
         validationTimer;
 
+    /**
+     * The timer that analyzes the power supplies after a hwmon alarm changes
+     * state.  Multiple alarm notifications in the same event loop iteration
+     * result in a single analysis.
+     */
+    std::unique_ptr<
+        sdeventplus::utility::Timer<sdeventplus::ClockId::Monotonic>>
+        alarmTimer;
+
+    /**
+     * @brief The eventfd the power supplies signal from their worker thread
+     * when they have bound or unbound their device driver.
+     */
+    util::FileDescriptor driverWorkFD;
+
+    /** @brief The event source watching driverWorkFD. */
+    std::unique_ptr<sdeventplus::source::IO> driverWorkSource;
+
+    /**
+     * @struct AlarmSource
+     *
+     * An open hwmon alarm file that is watched for POLLPRI notifications.
+     */
+    struct AlarmSource
+    {
+        /** @brief The open alarm file. */
+        util::FileDescriptor fd;
+
+        /** @brief The event source watching the file. */
+        std::unique_ptr<sdeventplus::source::IO> source;
+
+        /** @brief True if the alarm was active when last read. */
+        bool active = false;
+    };
+
+    /** @brief True if faults are detected using hwmon alarms. */
+    bool eventMode = false;
+
+    /** @brief The hwmon alarm files being watched in event mode. */
+    std::vector<std::unique_ptr<AlarmSource>> alarmSources;
+
+    /**
+     * @brief The power supplies and their presence when the alarm sources
+     * were last created.  Used to detect when they must be created again.
+     */
+    std::vector<std::pair<const PowerSupply*, bool>> alarmSourcePSUs;
+
+    /** @brief True if a present power supply has no hwmon alarm files. */
+    bool hasUnwatchedPSU = false;
+
+    /**
+     * @brief The presence GPIO edge events being watched in event mode, or
+     * when debouncing the presence.
+     */
+    std::vector<std::unique_ptr<sdeventplus::source::IO>> presenceSources;
+
+    /**
+     * @brief The number of power supplies when the presence sources were
+     * last created.
+     */
+    size_t presenceSourcePSUs = 0;
+
+    /**
+     * @brief The time a presence GPIO must keep a new value before the
+     * change is applied.
+     */
+    std::chrono::milliseconds presenceSettleTime{0};
+
+    /**
+     * @brief The timer that analyzes the power supplies once a presence
+     * GPIO has settled.
+     */
+    std::unique_ptr<
+        sdeventplus::utility::Timer<sdeventplus::ClockId::Monotonic>>
+        presenceTimer;
+
+    /**
+     * @brief The timer that saves the state for the next instance of the
+     * application.
+     */
+    std::unique_ptr<
+        sdeventplus::utility::Timer<sdeventplus::ClockId::Monotonic>>
+        stateHandoffTimer;
+
+    /**
+     * @brief Hands the state over to the next instance of the application
+     * when it is restarted.
+     */
+    util::StateHandoff stateHandoff{"phosphor-psu-monitor",
+                                    stateFormatVersion};
+
+    /**
+     * @struct AlertWatch
+     *
+     * The SMBALERT# GPIO of an I2C bus that is watched for edge events.
+     */
+    struct AlertWatch
+    {
+        /** @brief The SMBALERT# GPIO. */
+        std::unique_ptr<GPIOInterfaceBase> gpio;
+
+        /** @brief Reads the Alert Response Address of the bus. */
+        std::unique_ptr<i2c::AlertSource> source;
+
+        /** @brief The event source watching the GPIO. */
+        std::unique_ptr<sdeventplus::source::IO> event;
+    };
+
+    /**
+     * @brief The SMBALERT# GPIO names from the configuration, and the I2C
+     * bus each one is on.
+     */
+    std::map<std::string, uint8_t> alertGPIOs;
+
+    /** @brief The SMBALERT# GPIOs being watched, by GPIO name. */
+    std::map<std::string, std::unique_ptr<AlertWatch>> alertWatches;
+
+    /**
+     * @brief The schedulers of the PMBus accesses, by I2C bus.  The power
+     * supplies on a bus share one, so their status reads are not delayed by
+     * telemetry.
+     */
+    std::map<uint8_t, std::shared_ptr<phosphor::pmbus::PMBusScheduler>>
+        pmbusSchedulers;
+
+    /**
+     * @brief Watches the SMBALERT# GPIOs that are not watched yet.
+     *
+     * Called once the event loop timers exist, and again when a power supply
+     * with a new SMBALERT# GPIO is found.
+     */
+    void updateAlertWatches();
+
+    /**
+     * @brief Callback for an edge event on an SMBALERT# GPIO.
+     *
+     * Reads the Alert Response Address to find the power supplies asserting
+     * SMBALERT#, and analyzes just those.  All of the power supplies are
+     * analyzed if they cannot be found.
+     *
+     * @param[in] watch - the SMBALERT# GPIO that changed
+     */
+    void alertAsserted(AlertWatch& watch);
+
+    /**
+     * @brief Creates the alarm sources for the present power supplies.
+     *
+     * Called in event mode when the power supplies or their presence change,
+     * since binding or unbinding a device driver creates or removes its
+     * hwmon files.  Also watches the presence GPIO of every power supply for
+     * edge events, so a power supply being installed or removed is analyzed
+     * right away.
+     */
+    void updateAlarmSources();
+
+    /**
+     * @brief Reads an alarm file and returns whether the alarm is active.
+     *
+     * The file is read from offset 0, which also re-arms the POLLPRI
+     * notification.
+     *
+     * @param[in] fd - the open alarm file
+     * @param[out] active - true if the alarm is active
+     *
+     * @return bool - true if the file was read successfully
+     */
+    static bool readAlarm(int fd, bool& active);
+
+    /**
+     * @brief Watches the presence GPIO of every power supply for edge
+     * events.
+     */
+    void updatePresenceSources();
+
+    /**
+     * @brief Callback for an edge event on a presence GPIO.
+     *
+     * Analyzes right away without a settle time, and otherwise once the
+     * GPIO has had no edges for the settle time.
+     *
+     * @param[in] psu - the power supply
+     */
+    void presenceEdge(PowerSupply& psu);
+
+    /**
+     * @brief Callback for a POLLPRI notification on an alarm file.
+     *
+     * @param[in] alarm - the alarm source that was notified
+     */
+    void alarmChanged(AlarmSource& alarm);
+
+    /**
+     * @brief Sets the interval of the periodic analysis timer.
+     *
+     * In event mode the slow safety-net interval is used unless an alarm is
+     * active or a present power supply cannot be watched.  When polling with
+     * staggering, the timer runs once per power supply each poll interval.
+     */
+    void updateAnalyzeInterval();
+
+    /**
+     * @brief Callback for the periodic analysis timer.
+     *
+     * Analyzes the next power supply while staggering, and otherwise all of
+     * them.
+     */
+    void analyzeTick();
+
     /**
      * Create an error
      *
+     * The error is queued and created without blocking the event loop.
+     *
      * @param[in] faultName - 'name' message for the BMC error log entry
      * @param[in,out] additionalData - The AdditionalData property for the error
      */
@@ -183,29 +534,140 @@ class PSUManager
      */
     void analyze();
 
-    /** @brief True if the power is on. */
-    bool powerOn = false;
+    /**
+     * Analyze the status of some of the power supplies.
+     *
+     * Log errors for their faults, when and where appropriate.
+     *
+     * @param[in] selected - the power supplies to analyze
+     */
+    void analyze(std::span<const std::unique_ptr<PowerSupply>> selected);
 
-    /** @brief Used as part of subscribing to power on state changes*/
-    std::string powerService;
+    /**
+     * Log errors for the faults of one power supply, when appropriate.
+     *
+     * @param[in] psu - the power supply, which was just analyzed
+     */
+    void createErrors(PowerSupply* psu);
 
-    /** @brief Used to subscribe to D-Bus power on state changes */
-    std::unique_ptr<sdbusplus::bus::match_t> powerOnMatch;
+    /**
+     * Signals when a power supply loses or regains its capacity.
+     *
+     * Runs right after the power supply is analyzed and before its errors
+     * are created, so the load can be shed before the faults are deglitched
+     * and logged.  Capacity is lost when an input fault is seen, PGOOD is
+     * negated, or a power supply that was working is removed.
+     *
+     * @param[in] psu - the power supply, which was just analyzed
+     */
+    void updateCapacity(const PowerSupply& psu);
+
+    /**
+     * Forgets the capacity of the power supplies and deasserts the throttle
+     * GPIO, such as when the power is turned off.
+     */
+    void resetCapacity();
+
+    /**
+     * Writes the throttle GPIO, if there is one.
+     *
+     * @param[in] value - 1 to assert the GPIO, 0 to deassert it
+     */
+    void setThrottleGPIO(int value);
+
+    /**
+     * Reads the status of the power supplies, with one thread per I2C bus.
+     *
+     * The power supplies on one bus are read serially in their normal order.
+     * Returns after all the threads have finished.
+     *
+     * @param[in] selected - the power supplies to read
+     */
+    void analyzeStatusParallel(
+        std::span<const std::unique_ptr<PowerSupply>> selected);
+
+    /** @brief True if the status of each I2C bus is read in parallel. */
+    bool parallel = false;
+
+    /** @brief The scheduling options of the status read threads. */
+    util::RealtimeOptions faultPathOptions;
+
+    /** @brief True once a scheduling options error was journaled. */
+    std::atomic<bool> faultPathErrorLogged{false};
+
+    /** @brief The number of energy history records for each power supply. */
+    size_t energyHistoryRecords = 0;
+
+    /** @brief The interval between the analyses of each power supply when
+     * polling. */
+    std::chrono::milliseconds pollInterval;
+
+    /** @brief True if the power supplies are analyzed one at a time, spread
+     * over the poll interval. */
+    bool stagger = false;
+
+    /** @brief True while the timer analyzes one power supply per tick. */
+    bool staggering = false;
+
+    /** @brief The index in psus of the power supply analyzed on the next
+     * staggered tick. */
+    size_t nextPSU = 0;
+
+    /** @brief Tracks whether the power is on, subscribing to the D-Bus
+     * power state changes. */
+    util::PowerStateWatcher powerState{bus};
+
+    /** @brief Shares one D-Bus match per signal between the power supply
+     * inventory objects, instead of adding matches for each power supply.
+     * Declared before the power supplies, which register with it.
+     */
+    util::MatchDispatcher inventoryMatches{bus, INVENTORY_OBJ_PATH};
 
     /** @brief Used to subscribe to D-Bus power supply presence changes */
-    std::vector<std::unique_ptr<sdbusplus::bus::match_t>> presenceMatches;
+    std::vector<util::MatchDispatcher::Registration> presenceMatches;
 
     /** @brief Used to subscribe to Entity Manager interfaces added */
     std::unique_ptr<sdbusplus::bus::match_t> entityManagerIfacesAddedMatch;
 
+    /**
+     * @brief The asynchronous D-Bus calls made by getPSUConfiguration() and
+     *        getSystemProperties().  Kept until the manager is destroyed,
+     *        since the handlers start more calls.
+     */
+    std::vector<util::AsyncCallPtr> configCalls;
+
+    /** @brief Number of configCalls whose handler has not run. */
+    size_t pendingConfigCalls = 0;
+
+    /**
+     * @brief Stores a configuration call until it completes.
+     *
+     * @param[in] call - the pending call
+     */
+    void startConfigCall(util::AsyncCallPtr call);
+
+    /**
+     * @brief Called by the handler of each configuration call.
+     *
+     * Once all of the configuration has been read, sets the power config
+     * GPIO and schedules the configuration validation.
+     */
+    void endConfigCall();
+
+    /**
+     * @brief Schedules the configuration validation if the power is on and
+     *        the power supplies and supported configurations are known.
+     */
+    void scheduleValidation();
+
     /**
      * @brief Callback for power state property changes
      *
      * Process changes to the powered on state property for the system.
      *
-     * @param[in] msg - Data associated with the power state signal
+     * @param[in] powerOn - true if the power is now on
      */
-    void powerStateChanged(sdbusplus::message::message& msg);
+    void powerStateChanged(bool powerOn);
 
     /**
      * @brief Callback for inventory property changes
@@ -276,6 +738,70 @@ class PSUManager
      */
     bool hasRequiredPSUs(std::map<std::string, std::string>& additionalData);
 
+    /**
+     * @brief Performs the checks of hasRequiredPSUs() without using the
+     * cached result.
+     *
+     * @param[out] additionalData - Contains debug information on why the check
+     *             might have failed.
+     * @return true if all the required PSUs are present, false otherwise.
+     */
+    bool checkRequiredPSUs(std::map<std::string, std::string>& additionalData);
+
+    /**
+     * @brief The result of hasRequiredPSUs() and the PSU state it was
+     * computed for.
+     */
+    struct RequiredPSUsState
+    {
+        /**
+         * @brief The presence and model name of each PSU.
+         */
+        std::vector<std::pair<bool, std::string>> psuStates;
+
+        /**
+         * @brief The result of the check.
+         */
+        bool present = false;
+
+        /**
+         * @brief The debug information of a failed check.
+         */
+        std::map<std::string, std::string> additionalData;
+    };
+
+    /**
+     * @brief The cached result of hasRequiredPSUs().
+     *
+     * Reset when the PSUs, their presence, or the supported configurations
+     * change.  Also discarded if the presence or model name of any PSU no
+     * longer matches, since presence GPIO changes are found during analyze().
+     */
+    std::optional<RequiredPSUsState> requiredPSUsState;
+
+    /**
+     * @brief Reads the input voltage of each present PSU for the
+     * configuration validation.
+     *
+     * The PSUs on different I2C buses are read concurrently.  The readings
+     * come from the input voltage samples and the PMBus cache when they are
+     * recent.
+     *
+     * @return The actual and rated input voltage of each PSU, in the order
+     *         of psus.  0 for the PSUs that are not present.
+     */
+    std::vector<std::pair<double, int>> collectInputVoltages() const;
+
+    /**
+     * @brief Returns whether all the expected PSUs have reported, so the
+     * configuration can be validated before the validation timer expires.
+     *
+     * @return true if no driver is being bound, every present PSU has a model
+     *         name, and the supported configuration of the model has no more
+     *         PSUs than are present.
+     */
+    bool allPSUsReported() const;
+
     /**
      * @brief Helper function to validate that all PSUs have the same model name
      *
@@ -299,6 +825,19 @@ class PSUManager
      */
     std::map<std::string, sys_properties> supportedConfigs;
 
+    /**
+     * @brief The Entity Manager properties the power supplies were created
+     *        from, saved for the next instance of the application.
+     */
+    nlohmann::json psuConfigs = nlohmann::json::array();
+
+    /**
+     * @brief The status and fault state of the power supplies, checked
+     *        together on each analysis.  Declared before psus so the power
+     *        supplies are destroyed first.
+     */
+    PSUStateTable psuStates;
+
     /**
      * @brief The vector for power supplies.
      */
@@ -308,6 +847,63 @@ class PSUManager
      * @brief The libgpiod object for setting the power supply config
      */
     std::unique_ptr<GPIOInterfaceBase> powerConfigGPIO = nullptr;
+
+    /**
+     * @brief The GPIO asserted while a power supply has lost capacity, so
+     *        the host throttles without waiting for the D-Bus signal.
+     */
+    std::unique_ptr<GPIOInterfaceBase> throttleGPIO = nullptr;
+
+    /**
+     * @brief Whether each power supply that has been seen working has lost
+     *        its capacity, by inventory path.
+     */
+    std::map<std::string, bool> capacityLost;
+
+    /**
+     * @brief Cycle time statistics of analyze().
+     */
+    util::CycleStatistics analyzeCycleStats{analyzeInterval};
+
+    /**
+     * @brief Debug D-Bus interface that shows the analyze() cycle time
+     *        statistics.
+     */
+    util::CycleStatisticsInterface analyzeCycleStatsInterface;
+
+    /**
+     * @brief Time from the first detection of each power supply fault until
+     *        its error was created.  The percentiles cover the most recent
+     *        faults.
+     */
+    util::CycleStatistics faultLatencyStats{};
+
+    /**
+     * @brief Debug D-Bus interface that shows the fault latency statistics.
+     */
+    util::CycleStatisticsInterface faultLatencyStatsInterface;
+
+    /**
+     * @brief Debug D-Bus interface that shows the startup times.
+     */
+    util::StartupTimesInterface startupTimesInterface;
+
+    /**
+     * @brief D-Bus interface that signals when power supply capacity is lost
+     *        or restored.
+     */
+    CapacityInterface capacityInterface;
+
+    /**
+     * @brief Probe that measures how late the event loop dispatches timers,
+     *        and which handler blocked it.
+     */
+    util::EventLoopLagMonitor lagMonitor;
+
+    /**
+     * @brief Debug D-Bus interface that shows the event loop lag statistics.
+     */
+    util::EventLoopLagInterface lagInterface;
 };
 
 } // namespace phosphor::power::manager
@@ -0,0 +1,173 @@
+#pragma once
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace phosphor::power::psu
+{
+
+/**
+ * @struct StatusSample
+ *
+ * @brief The status registers of a power supply from one analyze() call.
+ */
+struct StatusSample
+{
+    /**
+     * @brief The STATUS_WORD value.
+     */
+    uint16_t statusWord{0};
+
+    /**
+     * @brief The last STATUS_MFR_SPECIFIC value read.
+     */
+    uint8_t statusMFR{0};
+
+    /**
+     * @brief When STATUS_WORD was read.
+     */
+    std::chrono::steady_clock::time_point timestamp{};
+};
+
+/**
+ * @class StatusHistory
+ *
+ * @brief The last N status samples of a power supply.
+ *
+ * The samples are stored in the object, and the oldest one is overwritten
+ * when it is full, so adding a sample never allocates.
+ */
+template <size_t N>
+class StatusHistory
+{
+    static_assert(N > 0, "No room for the samples");
+
+  public:
+    /**
+     * @brief Adds a sample, removing the oldest one if full.
+     *
+     * @param[in] sample - the sample
+     */
+    void add(const StatusSample& sample)
+    {
+        samples[next] = sample;
+        next = (next + 1) % N;
+        count = std::min(count + 1, N);
+    }
+
+    /**
+     * @brief Removes all the samples.
+     */
+    void clear()
+    {
+        next = 0;
+        count = 0;
+    }
+
+    /**
+     * @brief Returns the number of samples.
+     */
+    size_t size() const
+    {
+        return count;
+    }
+
+    /**
+     * @brief Returns true if there are no samples.
+     */
+    bool empty() const
+    {
+        return count == 0;
+    }
+
+    /**
+     * @brief Returns a sample by age.
+     *
+     * @param[in] age - 0 for the newest sample, size() - 1 for the oldest
+     *
+     * @return const StatusSample& - the sample
+     */
+    const StatusSample& operator[](size_t age) const
+    {
+        return samples[(next + N - 1 - age) % N];
+    }
+
+    /**
+     * @brief Returns how many of the newest samples match a predicate.
+     *
+     * @param[in] last - the number of newest samples to check
+     * @param[in] predicate - called with each sample
+     *
+     * @return size_t - the number of matching samples
+     */
+    template <typename Predicate>
+    size_t countNewest(size_t last, Predicate predicate) const
+    {
+        size_t matches{0};
+        for (size_t age = 0; age < std::min(last, count); age++)
+        {
+            if (predicate((*this)[age]))
+            {
+                matches++;
+            }
+        }
+        return matches;
+    }
+
+    /**
+     * @brief Formats the samples for error log metadata.
+     *
+     * The samples are listed oldest first, each as STATUS_WORD/STATUS_MFR
+     * and its age in milliseconds relative to the newest sample, such as
+     * "0x0840/0x00@-2000ms, 0x0000/0x00@0ms".
+     *
+     * @return std::string - the samples
+     */
+    std::string toString() const
+    {
+        std::string text;
+        if (empty())
+        {
+            return text;
+        }
+
+        const auto newest = (*this)[0].timestamp;
+        for (size_t age = count; age > 0; age--)
+        {
+            const auto& sample = (*this)[age - 1];
+            auto offset = std::chrono::duration_cast<std::chrono::milliseconds>(
+                sample.timestamp - newest);
+            if (!text.empty())
+            {
+                text += ", ";
+            }
+            text += fmt::format("{:#06x}/{:#04x}@{}ms", sample.statusWord,
+                                sample.statusMFR, offset.count());
+        }
+        return text;
+    }
+
+  private:
+    /**
+     * @brief The samples.
+     */
+    std::array<StatusSample, N> samples{};
+
+    /**
+     * @brief The index the next sample is stored at.
+     */
+    size_t next{0};
+
+    /**
+     * @brief The number of samples stored.
+     */
+    size_t count{0};
+};
+
+} // namespace phosphor::power::psu
@@ -24,7 +24,8 @@ class MockedPMBus : public PMBusBase
     MOCK_METHOD(std::string, readString, (const std::string& name, Type type),
                 (override));
     MOCK_METHOD(void, writeBinary,
-                (const std::string& name, std::vector<uint8_t> data, Type type),
+                (const std::string& name, std::span<const uint8_t> data,
+                 Type type),
                 (override));
     MOCK_METHOD(void, findHwmonDir, (), (override));
     MOCK_METHOD(const fs::path&, path, (), (const, override));
@@ -0,0 +1,379 @@
+#include "../power_supply.hpp"
+#include "mock.hpp"
+#include "phosphor-regulators/test/allocation_tracker.hpp"
+#include "pmbus_trace.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <gmock/gmock.h>
+
+using namespace phosphor::power::psu;
+using namespace phosphor::pmbus;
+namespace allocation_tracker = phosphor::power::regulators::allocation_tracker;
+
+using ::testing::_;
+using ::testing::AnyNumber;
+using ::testing::Return;
+using ::testing::ReturnRef;
+
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * Number of analysis cycles in the fault script of each power supply.
+ */
+constexpr size_t scriptCycles = 32;
+
+/**
+ * Number of cycles each power supply is faulted for in its script.
+ */
+constexpr size_t faultCycles = 6;
+
+/**
+ * Bus trace replayed by BM_AnalyzeChassisReplay, set by the --bus_trace
+ * option.
+ */
+std::string busTracePath{};
+
+/**
+ * A power supply with a mocked PMBus that returns a scripted STATUS_WORD.
+ */
+struct ScriptedPSU
+{
+    std::unique_ptr<PowerSupply> psu;
+
+    /** The STATUS_WORD this power supply reports when it is faulted. */
+    uint16_t faultStatusWord = 0;
+
+    /** The STATUS_WORD currently returned by the mocked PMBus. */
+    uint16_t statusWord = 0;
+
+    /** When the current fault first appeared in STATUS_WORD. */
+    std::optional<Clock::time_point> faultStart;
+
+    /** The cycle the current fault first appeared in STATUS_WORD. */
+    size_t faultStartCycle = 0;
+};
+
+/**
+ * Analyzes a chassis of power supplies the way PSUManager::analyze() does,
+ * on one thread, while each power supply follows a fault script.
+ *
+ * The power supplies are staggered through the script, so a few of them
+ * start or stop a fault in each cycle.  Even power supplies report a PGOOD
+ * fault, which is deglitched for DEGLITCH_LIMIT cycles, and odd power
+ * supplies report an input fault.
+ *
+ * The mocked PMBus and GPIO calls are included in the cost of analyze(),
+ * so the results are an upper bound for the PowerSupply code itself.
+ *
+ * With recorded devices, such as from phosphor-psu-monitor --bus-trace, the
+ * PMBus reads of each power supply are instead replayed from the next
+ * recorded device, with the recorded values, failures, and timing, and
+ * there is no fault script.  The recorded devices are shared in turn when
+ * there are more power supplies than recorded ones.
+ */
+class Chassis
+{
+  public:
+    Chassis(sdbusplus::bus::bus& bus, size_t count,
+            const std::vector<std::unique_ptr<ReplayPMBus>>* replays =
+                nullptr) :
+        mockedUtil(static_cast<const MockedUtil&>(getUtils())),
+        replaying(replays != nullptr)
+    {
+        EXPECT_CALL(mockedUtil, getPresence(_, _))
+            .Times(AnyNumber())
+            .WillRepeatedly(Return(true));
+        EXPECT_CALL(mockedUtil, setPresence(_, _, _, _)).Times(AnyNumber());
+
+        psus.resize(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            ScriptedPSU& scripted = psus[i];
+            scripted.faultStatusWord = (i % 2 == 0)
+                                           ? status_word::POWER_GOOD_NEGATED
+                                           : status_word::INPUT_FAULT_WARN;
+            scripted.psu = std::make_unique<PowerSupply>(
+                bus,
+                "/xyz/openbmc_project/inventory/system/chassis/motherboard/"
+                "powersupply" +
+                    std::to_string(i),
+                static_cast<uint8_t>(3 + i / 8),
+                static_cast<uint16_t>(0x58 + i % 8),
+                "presence-ps" + std::to_string(i));
+
+            auto* gpio = static_cast<MockedGPIOInterface*>(
+                scripted.psu->getPresenceGPIO());
+            EXPECT_CALL(*gpio, read()).WillRepeatedly(Return(1));
+            EXPECT_CALL(*gpio, getName()).Times(AnyNumber());
+
+            auto& pmbus =
+                static_cast<MockedPMBus&>(scripted.psu->getPMBus());
+            EXPECT_CALL(pmbus, findHwmonDir()).Times(AnyNumber());
+            EXPECT_CALL(pmbus, writeBinary(_, _, _)).Times(AnyNumber());
+            EXPECT_CALL(pmbus, path()).WillRepeatedly(ReturnRef(devicePath));
+            if (replays != nullptr)
+            {
+                ReplayPMBus* replay = (*replays)[i % replays->size()].get();
+                EXPECT_CALL(pmbus, insertPageNum(_, _))
+                    .WillRepeatedly([replay](const std::string& name,
+                                             size_t page) {
+                        return replay->insertPageNum(name, page);
+                    });
+                EXPECT_CALL(pmbus, readString(_, _))
+                    .WillRepeatedly(
+                        [replay](const std::string& name, Type type) {
+                            return replay->readString(name, type);
+                        });
+                EXPECT_CALL(pmbus, read(_, _))
+                    .WillRepeatedly(
+                        [replay](const std::string& name, Type type) {
+                            return replay->read(name, type);
+                        });
+                continue;
+            }
+            EXPECT_CALL(pmbus, insertPageNum(_, _))
+                .WillRepeatedly(Return(std::string{"status0_vout"}));
+            EXPECT_CALL(pmbus, readString(_, _))
+                .WillRepeatedly(Return(std::string{}));
+            EXPECT_CALL(pmbus, read(_, _))
+                .WillRepeatedly([&scripted](const std::string& name, Type) {
+                    return readRegister(scripted, name);
+                });
+        }
+
+        // The first cycle finds the power supplies present
+        cycle();
+        latencies.clear();
+        latencyCycles.clear();
+    }
+
+    /**
+     * Runs one analysis cycle.
+     */
+    void cycle()
+    {
+        for (size_t i = 0; !replaying && (i < psus.size()); ++i)
+        {
+            updateScript(psus[i]);
+        }
+
+        for (ScriptedPSU& scripted : psus)
+        {
+            scripted.psu->analyze();
+        }
+
+        for (ScriptedPSU& scripted : psus)
+        {
+            createErrors(scripted);
+        }
+        ++cycleCount;
+    }
+
+    /** Time from each fault appearing to its error being created. */
+    std::vector<std::chrono::microseconds> latencies;
+
+    /** Number of cycles from each fault appearing to its error. */
+    std::vector<size_t> latencyCycles;
+
+  private:
+    static uint64_t readRegister(const ScriptedPSU& scripted,
+                                 const std::string& name)
+    {
+        if (name == STATUS_WORD)
+        {
+            return scripted.statusWord;
+        }
+        if (name == STATUS_INPUT)
+        {
+            return (scripted.statusWord & status_word::INPUT_FAULT_WARN)
+                       ? 0x80
+                       : 0x00;
+        }
+        if (name == READ_VIN)
+        {
+            return 206000;
+        }
+        return 0;
+    }
+
+    /**
+     * Sets the STATUS_WORD of a power supply for the current cycle.
+     */
+    void updateScript(ScriptedPSU& scripted)
+    {
+        size_t index = &scripted - psus.data();
+        bool faulted = ((cycleCount + index) % scriptCycles) < faultCycles;
+        uint16_t statusWord = faulted ? scripted.faultStatusWord : 0;
+        if (statusWord == scripted.statusWord)
+        {
+            return;
+        }
+
+        scripted.statusWord = statusWord;
+        if (faulted)
+        {
+            scripted.faultStart = Clock::now();
+            scripted.faultStartCycle = cycleCount;
+        }
+        else
+        {
+            // Like a power supply being replaced or the system being powered
+            // on again, so the next fault is logged too
+            scripted.faultStart.reset();
+            scripted.psu->clearFaults();
+        }
+    }
+
+    /**
+     * Does what PSUManager::createErrors() does for a faulted power supply,
+     * apart from the D-Bus call that creates the error log.
+     */
+    void createErrors(ScriptedPSU& scripted)
+    {
+        PowerSupply& psu = *scripted.psu;
+        if (psu.isFaultLogged() || !psu.isFaulted())
+        {
+            return;
+        }
+
+        std::map<std::string, std::string> additionalData;
+        additionalData["STATUS_WORD"] = std::to_string(psu.getStatusWord());
+        additionalData["STATUS_MFR"] = std::to_string(psu.getMFRFault());
+        additionalData["FW_VERSION"] = psu.getFWVersion();
+        additionalData["CALLOUT_INVENTORY_PATH"] = psu.getInventoryPath();
+        benchmark::DoNotOptimize(additionalData);
+
+        if (scripted.faultStart)
+        {
+            latencies.push_back(
+                std::chrono::duration_cast<std::chrono::microseconds>(
+                    Clock::now() - *scripted.faultStart));
+            latencyCycles.push_back(cycleCount - scripted.faultStartCycle +
+                                    1);
+        }
+        psu.setFaultLogged();
+    }
+
+    const MockedUtil& mockedUtil;
+    const bool replaying;
+    const fs::path devicePath{"/sys/bus/i2c/devices/3-0058"};
+    std::vector<ScriptedPSU> psus;
+    size_t cycleCount = 0;
+};
+
+void BM_AnalyzeChassis(benchmark::State& state,
+                       const std::vector<std::unique_ptr<ReplayPMBus>>*
+                           replays = nullptr)
+{
+    auto bus = sdbusplus::bus::new_default();
+    auto count = static_cast<size_t>(state.range(0));
+    {
+        Chassis chassis{bus, count, replays};
+
+        uint64_t allocations = allocation_tracker::getAllocationCount();
+        for (auto _ : state)
+        {
+            chassis.cycle();
+        }
+        allocations = allocation_tracker::getAllocationCount() - allocations;
+
+        double psuCycles = static_cast<double>(state.iterations()) * count;
+        state.counters["per_psu"] =
+            benchmark::Counter(psuCycles, benchmark::Counter::kIsRate |
+                                              benchmark::Counter::kInvert);
+        state.counters["allocs_per_psu"] = allocations / psuCycles;
+
+        if (!chassis.latencies.empty())
+        {
+            double total = 0;
+            for (auto latency : chassis.latencies)
+            {
+                total += latency.count();
+            }
+            state.counters["errors"] = chassis.latencies.size();
+            state.counters["fault_to_error_us"] =
+                total / chassis.latencies.size();
+            state.counters["fault_to_error_max_us"] =
+                std::max_element(chassis.latencies.begin(),
+                                 chassis.latencies.end())
+                    ->count();
+            state.counters["fault_to_error_cycles"] = *std::max_element(
+                chassis.latencyCycles.begin(), chassis.latencyCycles.end());
+        }
+    }
+    freeUtils();
+}
+
+void BM_AnalyzeChassisReplay(benchmark::State& state)
+{
+    auto replays = ReplayPMBus::load(busTracePath);
+    if (replays.empty())
+    {
+        state.SkipWithError("No PMBus accesses in the bus trace");
+        return;
+    }
+    BM_AnalyzeChassis(state, &replays);
+
+    // Reads the recorded system did not do fail without a recorded value
+    size_t misses{0};
+    for (const auto& replay : replays)
+    {
+        misses += replay->getMissCount();
+    }
+    state.counters["misses"] = static_cast<double>(misses);
+}
+
+} // namespace
+
+BENCHMARK(BM_AnalyzeChassis)->RangeMultiplier(2)->Range(2, 64);
+
+int main(int argc, char** argv)
+{
+    // Remove the --bus_trace=<file> option, which the benchmark library does
+    // not know, before initializing it
+    const char* option = "--bus_trace=";
+    int count = 1;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strncmp(argv[i], option, std::strlen(option)) == 0)
+        {
+            busTracePath = argv[i] + std::strlen(option);
+        }
+        else
+        {
+            argv[count++] = argv[i];
+        }
+    }
+    argc = count;
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+    {
+        return 1;
+    }
+    if (!busTracePath.empty())
+    {
+        benchmark::RegisterBenchmark("BM_AnalyzeChassisReplay",
+                                     BM_AnalyzeChassisReplay)
+            ->RangeMultiplier(2)
+            ->Range(2, 64)
+            ->UseRealTime();
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -4,6 +4,9 @@
 #include <xyz/openbmc_project/Common/Device/error.hpp>
 #include <xyz/openbmc_project/Common/error.hpp>
 
+#include <chrono>
+#include <thread>
+
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
@@ -11,13 +14,16 @@ using namespace phosphor::power::psu;
 using namespace phosphor::pmbus;
 
 using ::testing::_;
+using ::testing::AnyNumber;
 using ::testing::Args;
 using ::testing::Assign;
 using ::testing::DoAll;
 using ::testing::ElementsAre;
 using ::testing::NotNull;
 using ::testing::Return;
+using ::testing::ReturnRef;
 using ::testing::StrEq;
+using ::testing::Throw;
 
 static auto PSUInventoryPath = "/xyz/bmc/inv/sys/chassis/board/powersupply0";
 static auto PSUGPIOLineName = "presence-ps0";
@@ -45,33 +51,43 @@ void setPMBusExpectations(MockedPMBus& mockPMBus,
     if (expectations.statusWordValue != 0)
     {
         // If fault bits are on in STATUS_WORD, there will also be a read of
-        // STATUS_INPUT, STATUS_MFR, STATUS_CML, STATUS_VOUT (page 0), and
-        // STATUS_TEMPERATURE.
-        EXPECT_CALL(mockPMBus, read(STATUS_INPUT, _))
-            .Times(1)
-            .WillOnce(Return(expectations.statusInputValue));
-        EXPECT_CALL(mockPMBus, read(STATUS_MFR, _))
-            .Times(1)
-            .WillOnce(Return(expectations.statusMFRValue));
-        EXPECT_CALL(mockPMBus, read(STATUS_CML, _))
-            .Times(1)
-            .WillOnce(Return(expectations.statusCMLValue));
+        // STATUS_MFR and of the registers whose summary bits are on.
+        auto expectRead = [&](const std::string& name, uint64_t summaryBits,
+                              uint8_t value) {
+            if (expectations.statusWordValue & summaryBits)
+            {
+                EXPECT_CALL(mockPMBus, read(name, _))
+                    .Times(1)
+                    .WillOnce(Return(value));
+            }
+            else
+            {
+                EXPECT_CALL(mockPMBus, read(name, _)).Times(0);
+            }
+        };
+        expectRead(STATUS_INPUT,
+                   status_word::INPUT_FAULT_WARN | status_word::VIN_UV_FAULT,
+                   expectations.statusInputValue);
+        expectRead(STATUS_MFR, ~0ull, expectations.statusMFRValue);
+        expectRead(STATUS_CML, status_word::CML_FAULT,
+                   expectations.statusCMLValue);
         // Page will need to be set to 0 to read STATUS_VOUT.
-        EXPECT_CALL(mockPMBus, insertPageNum(STATUS_VOUT, 0))
-            .Times(1)
-            .WillOnce(Return("status0_vout"));
-        EXPECT_CALL(mockPMBus, read("status0_vout", _))
-            .Times(1)
-            .WillOnce(Return(expectations.statusVOUTValue));
-        EXPECT_CALL(mockPMBus, read(STATUS_IOUT, _))
-            .Times(1)
-            .WillOnce(Return(expectations.statusIOUTValue));
-        EXPECT_CALL(mockPMBus, read(STATUS_FANS_1_2, _))
-            .Times(1)
-            .WillOnce(Return(expectations.statusFans12Value));
-        EXPECT_CALL(mockPMBus, read(STATUS_TEMPERATURE, _))
-            .Times(1)
-            .WillOnce(Return(expectations.statusTempValue));
+        uint64_t voutBits =
+            status_word::VOUT_FAULT | status_word::VOUT_OV_FAULT;
+        if (expectations.statusWordValue & voutBits)
+        {
+            EXPECT_CALL(mockPMBus, insertPageNum(STATUS_VOUT, 0))
+                .Times(1)
+                .WillOnce(Return("status0_vout"));
+        }
+        expectRead("status0_vout", voutBits, expectations.statusVOUTValue);
+        expectRead(STATUS_IOUT,
+                   status_word::IOUT_POUT_FAULT | status_word::IOUT_OC_FAULT,
+                   expectations.statusIOUTValue);
+        expectRead(STATUS_FANS_1_2, status_word::FAN_FAULT,
+                   expectations.statusFans12Value);
+        expectRead(STATUS_TEMPERATURE, status_word::TEMPERATURE_FAULT_WARN,
+                   expectations.statusTempValue);
     }
 }
 
@@ -760,6 +776,12 @@ TEST_F(PowerSupplyTests, UpdateInventory)
 #endif
         psu.updateInventory();
         // TODO: D-Bus mocking to verify values stored on D-Bus (???)
+
+        // Once removed, the VPD should not be read.
+        EXPECT_CALL(*mockPresenceGPIO, read()).Times(1).WillOnce(Return(0));
+        EXPECT_CALL(mockPMBus, readString(_, _)).Times(0);
+        psu.analyze();
+        psu.updateInventory();
     }
     catch (...)
     {
@@ -782,6 +804,78 @@ TEST_F(PowerSupplyTests, IsPresent)
     EXPECT_EQ(psu.isPresent(), true);
 }
 
+TEST_F(PowerSupplyTests, StateTable)
+{
+    auto bus = sdbusplus::bus::new_default();
+
+    // The power supplies share the table, each in its own slot
+    PSUStateTable states;
+    auto psu1 = std::make_unique<PowerSupply>(
+        bus, PSUInventoryPath, 3, 0x68, PSUGPIOLineName, nullptr, &states);
+    PowerSupply psu2{bus,     PSUInventoryPath, 3, 0x69, PSUGPIOLineName,
+                     nullptr, &states};
+    EXPECT_EQ(states.size(), 2);
+    EXPECT_EQ(psu1->getStateSlot(), 0);
+    EXPECT_EQ(psu2.getStateSlot(), 1);
+    EXPECT_EQ(states.countPresent(), 0);
+    EXPECT_EQ(states.needsError(1), true);
+
+    MockedGPIOInterface* mockPresenceGPIO =
+        static_cast<MockedGPIOInterface*>(psu2.getPresenceGPIO());
+    EXPECT_CALL(*mockPresenceGPIO, read()).Times(1).WillOnce(Return(1));
+    psu2.analyze();
+    EXPECT_EQ(psu2.isPresent(), true);
+    EXPECT_EQ(psu1->isPresent(), false);
+    EXPECT_EQ(states.present[1], 1);
+    EXPECT_EQ(states.countPresent(), 1);
+    EXPECT_EQ(states.isFaulted(1), false);
+    EXPECT_EQ(states.needsError(1), false);
+
+    // A destroyed power supply's slot is no longer counted
+    states.present[0] = 1;
+    psu1.reset();
+    EXPECT_EQ(states.size(), 2);
+    EXPECT_EQ(states.countPresent(), 1);
+}
+
+TEST_F(PowerSupplyTests, PresenceDebounce)
+{
+    auto bus = sdbusplus::bus::new_default();
+
+    PowerSupply psu{bus, PSUInventoryPath, 3, 0x68, PSUGPIOLineName};
+    psu.setPresenceSettleTime(std::chrono::milliseconds{20});
+    MockedGPIOInterface* mockPresenceGPIO =
+        static_cast<MockedGPIOInterface*>(psu.getPresenceGPIO());
+    // Present, bounces back, and present again until it settles.
+    EXPECT_CALL(*mockPresenceGPIO, read())
+        .WillOnce(Return(1))
+        .WillOnce(Return(0))
+        .WillRepeatedly(Return(1));
+    psu.analyze();
+    EXPECT_EQ(psu.isPresent(), false);
+    EXPECT_EQ(psu.isPresenceSettling(), true);
+    psu.analyze();
+    EXPECT_EQ(psu.isPresenceSettling(), false);
+    EXPECT_EQ(psu.getPresenceDebounceStats().bounces, 1);
+
+    // An edge restarts the settle time
+    psu.analyze();
+    psu.presenceEdge();
+    psu.analyze();
+    EXPECT_EQ(psu.isPresent(), false);
+    EXPECT_EQ(psu.isPresenceSettling(), true);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds{30});
+    psu.analyze();
+    EXPECT_EQ(psu.isPresent(), true);
+    EXPECT_EQ(psu.isPresenceSettling(), false);
+    const auto& stats = psu.getPresenceDebounceStats();
+    EXPECT_EQ(stats.edges, 1);
+    EXPECT_EQ(stats.bounces, 1);
+    EXPECT_EQ(stats.changes, 1);
+    EXPECT_GE(stats.maxSettleTime, std::chrono::milliseconds{20});
+}
+
 TEST_F(PowerSupplyTests, IsFaulted)
 {
     auto bus = sdbusplus::bus::new_default();
@@ -1128,6 +1222,178 @@ TEST_F(PowerSupplyTests, HasPgoodFault)
     EXPECT_EQ(psu.hasPgoodFault(), false);
 }
 
+TEST_F(PowerSupplyTests, HasPgoodFaultNotConsecutive)
+{
+    auto bus = sdbusplus::bus::new_default();
+
+    PowerSupply psu{bus, PSUInventoryPath, 3, 0x6b, PSUGPIOLineName};
+    MockedGPIOInterface* mockPresenceGPIO =
+        static_cast<MockedGPIOInterface*>(psu.getPresenceGPIO());
+    // Always return 1 to indicate present.
+    EXPECT_CALL(*mockPresenceGPIO, read()).WillRepeatedly(Return(1));
+    psu.analyze();
+    MockedPMBus& mockPMBus = static_cast<MockedPMBus&>(psu.getPMBus());
+    // STATUS_WORD 0x0000 is powered on, no faults.
+    PMBusExpectations expectations;
+    setPMBusExpectations(mockPMBus, expectations);
+    psu.analyze();
+    // PGOOD# glitches off, on, and then off twice.  DEGLITCH_LIMIT of the
+    // newest DEGLITCH_WINDOW samples are faulted.
+    expectations.statusWordValue = (status_word::POWER_GOOD_NEGATED);
+    setPMBusExpectations(mockPMBus, expectations);
+    psu.analyze();
+    EXPECT_EQ(psu.hasPgoodFault(), false);
+    expectations.statusWordValue = 0;
+    setPMBusExpectations(mockPMBus, expectations);
+    psu.analyze();
+    EXPECT_EQ(psu.hasPgoodFault(), false);
+    EXPECT_EQ(psu.isCapacityLost(), false);
+    expectations.statusWordValue = (status_word::POWER_GOOD_NEGATED);
+    setPMBusExpectations(mockPMBus, expectations);
+    psu.analyze();
+    EXPECT_EQ(psu.hasPgoodFault(), false);
+    setPMBusExpectations(mockPMBus, expectations);
+    psu.analyze();
+    EXPECT_EQ(psu.hasPgoodFault(), true);
+
+    // Every read STATUS_WORD is in the history, newest first
+    const auto& history = psu.getStatusHistory();
+    ASSERT_GE(history.size(), 5);
+    EXPECT_EQ(history[0].statusWord, status_word::POWER_GOOD_NEGATED);
+    EXPECT_EQ(history[2].statusWord, 0);
+    EXPECT_EQ(history[4].statusWord, 0);
+    EXPECT_GE(history[0].timestamp, history[4].timestamp);
+
+    // The first good sample after the fault ends it
+    expectations.statusWordValue = 0;
+    setPMBusExpectations(mockPMBus, expectations);
+    psu.analyze();
+    EXPECT_EQ(psu.hasPgoodFault(), false);
+    expectations.statusWordValue = (status_word::POWER_GOOD_NEGATED);
+    setPMBusExpectations(mockPMBus, expectations);
+    psu.analyze();
+    EXPECT_EQ(psu.hasPgoodFault(), false);
+}
+
+TEST(StatusHistoryTests, AddAndFormat)
+{
+    StatusHistory<3> history;
+    EXPECT_TRUE(history.empty());
+    EXPECT_EQ(history.toString(), "");
+
+    auto now = std::chrono::steady_clock::now();
+    for (uint16_t word = 1; word <= 4; word++)
+    {
+        history.add({word, 0x10, now + std::chrono::seconds{word}});
+    }
+
+    // The oldest sample was overwritten
+    ASSERT_EQ(history.size(), 3);
+    EXPECT_EQ(history[0].statusWord, 4);
+    EXPECT_EQ(history[2].statusWord, 2);
+    EXPECT_EQ(history.countNewest(2, [](const StatusSample& sample) {
+        return sample.statusWord >= 3;
+    }),
+              2);
+    EXPECT_EQ(history.countNewest(10, [](const StatusSample& sample) {
+        return sample.statusWord >= 3;
+    }),
+              2);
+    EXPECT_EQ(history.toString(), "0x0002/0x10@-2000ms, 0x0003/0x10@-1000ms, "
+                                  "0x0004/0x10@0ms");
+
+    history.clear();
+    EXPECT_TRUE(history.empty());
+}
+
+TEST_F(PowerSupplyTests, IsCapacityLost)
+{
+    auto bus = sdbusplus::bus::new_default();
+
+    PowerSupply psu{bus, PSUInventoryPath, 3, 0x6b, PSUGPIOLineName};
+    MockedGPIOInterface* mockPresenceGPIO =
+        static_cast<MockedGPIOInterface*>(psu.getPresenceGPIO());
+    // Always return 1 to indicate present.
+    EXPECT_CALL(*mockPresenceGPIO, read()).WillRepeatedly(Return(1));
+    psu.analyze();
+    MockedPMBus& mockPMBus = static_cast<MockedPMBus&>(psu.getPMBus());
+    // STATUS_WORD 0x0000 is powered on, no faults.
+    PMBusExpectations expectations;
+    setPMBusExpectations(mockPMBus, expectations);
+    psu.analyze();
+    EXPECT_EQ(psu.isCapacityLost(), false);
+    // Turn PGOOD# off (fault on).  Lost before the fault is deglitched.
+    expectations.statusWordValue = (status_word::POWER_GOOD_NEGATED);
+    setPMBusExpectations(mockPMBus, expectations);
+    psu.analyze();
+    EXPECT_EQ(psu.hasPgoodFault(), false);
+    EXPECT_EQ(psu.isCapacityLost(), true);
+    // Back to no fault bits on in STATUS_WORD
+    expectations.statusWordValue = 0;
+    setPMBusExpectations(mockPMBus, expectations);
+    psu.analyze();
+    EXPECT_EQ(psu.isCapacityLost(), false);
+    // STATUS_WORD with input fault/warn on.
+    expectations.statusWordValue = (status_word::INPUT_FAULT_WARN);
+    // STATUS_INPUT with an input fault bit on.
+    expectations.statusInputValue = 0x80;
+    setPMBusExpectations(mockPMBus, expectations);
+    psu.analyze();
+    EXPECT_EQ(psu.isCapacityLost(), true);
+    // STATUS_WORD with no bits on.
+    expectations.statusWordValue = 0;
+    expectations.statusInputValue = 0;
+    setPMBusExpectations(mockPMBus, expectations);
+    psu.analyze();
+    EXPECT_EQ(psu.isCapacityLost(), false);
+}
+
+TEST_F(PowerSupplyTests, GetFaultDetectedTime)
+{
+    auto bus = sdbusplus::bus::new_default();
+
+    PowerSupply psu{bus, PSUInventoryPath, 3, 0x6b, PSUGPIOLineName};
+    MockedGPIOInterface* mockPresenceGPIO =
+        static_cast<MockedGPIOInterface*>(psu.getPresenceGPIO());
+    // Always return 1 to indicate present.
+    EXPECT_CALL(*mockPresenceGPIO, read()).WillRepeatedly(Return(1));
+    MockedPMBus& mockPMBus = static_cast<MockedPMBus&>(psu.getPMBus());
+    EXPECT_CALL(mockPMBus, findHwmonDir());
+    // Presence change from missing to present will trigger write to
+    // ON_OFF_CONFIG.
+    EXPECT_CALL(mockPMBus, writeBinary(ON_OFF_CONFIG, _, _));
+    // Missing/present will trigger read of "in1_input" to try CLEAR_FAULTS.
+    EXPECT_CALL(mockPMBus, read("in1_input", _))
+        .Times(1)
+        .WillOnce(Return(207000));
+    // Missing/present call will update Presence in inventory.
+    EXPECT_CALL(mockedUtil, setPresence(_, _, true, _));
+    // STATUS_WORD 0x0000 is powered on, no faults.
+    PMBusExpectations expectations;
+    setPMBusExpectations(mockPMBus, expectations);
+    psu.analyze();
+    EXPECT_FALSE(psu.getFaultDetectedTime().has_value());
+    // Turn PGOOD# off (fault on).  Detected before DEGLITCH_LIMIT is reached.
+    expectations.statusWordValue = (status_word::POWER_GOOD_NEGATED);
+    setPMBusExpectations(mockPMBus, expectations);
+    psu.analyze();
+    EXPECT_EQ(psu.hasPgoodFault(), false);
+    auto detected = psu.getFaultDetectedTime();
+    ASSERT_TRUE(detected.has_value());
+    // Time of the first detection is kept while the fault is deglitched
+    setPMBusExpectations(mockPMBus, expectations);
+    psu.analyze();
+    setPMBusExpectations(mockPMBus, expectations);
+    psu.analyze();
+    EXPECT_EQ(psu.hasPgoodFault(), true);
+    EXPECT_EQ(psu.getFaultDetectedTime(), detected);
+    // Back to no fault bits on in STATUS_WORD
+    expectations.statusWordValue = 0;
+    setPMBusExpectations(mockPMBus, expectations);
+    psu.analyze();
+    EXPECT_FALSE(psu.getFaultDetectedTime().has_value());
+}
+
 TEST_F(PowerSupplyTests, HasPSKillFault)
 {
     auto bus = sdbusplus::bus::new_default();
@@ -1253,3 +1519,210 @@ TEST_F(PowerSupplyTests, HasPSCS12VFault)
     psu.analyze();
     EXPECT_EQ(psu.hasPSCS12VFault(), false);
 }
+
+TEST_F(PowerSupplyTests, AnalyzeStatusRegisters)
+{
+    auto bus = sdbusplus::bus::new_default();
+
+    PowerSupply psu{bus, PSUInventoryPath, 3, 0x6b, PSUGPIOLineName};
+    MockedGPIOInterface* mockPresenceGPIO =
+        static_cast<MockedGPIOInterface*>(psu.getPresenceGPIO());
+    // Always return 1 to indicate present.
+    EXPECT_CALL(*mockPresenceGPIO, read()).WillRepeatedly(Return(1));
+    MockedPMBus& mockPMBus = static_cast<MockedPMBus&>(psu.getPMBus());
+    EXPECT_CALL(mockPMBus, findHwmonDir());
+    // Presence change from missing to present will trigger write to
+    // ON_OFF_CONFIG.
+    EXPECT_CALL(mockPMBus, writeBinary(ON_OFF_CONFIG, _, _));
+    // Missing/present will trigger read of "in1_input" to try CLEAR_FAULTS.
+    EXPECT_CALL(mockPMBus, read("in1_input", _))
+        .Times(1)
+        .WillOnce(Return(207000));
+    // Missing/present call will update Presence in inventory.
+    EXPECT_CALL(mockedUtil, setPresence(_, _, true, _));
+    // STATUS_WORD 0x0000 is powered on, no faults.
+    PMBusExpectations expectations;
+    setPMBusExpectations(mockPMBus, expectations);
+    psu.analyze();
+
+    // Input fault.  Only STATUS_MFR and STATUS_INPUT are read.
+    expectations.statusWordValue = (status_word::INPUT_FAULT_WARN);
+    expectations.statusInputValue = 0x20;
+    setPMBusExpectations(mockPMBus, expectations);
+    psu.analyze();
+    EXPECT_EQ(psu.hasInputFault(), true);
+    EXPECT_EQ(psu.hasTempFault(), false);
+    EXPECT_EQ(psu.getStatusInput(), 0x20);
+
+    // Temperature fault added.  STATUS_TEMPERATURE is read as well.
+    expectations.statusWordValue =
+        (status_word::INPUT_FAULT_WARN | status_word::TEMPERATURE_FAULT_WARN);
+    expectations.statusTempValue = 0x40;
+    setPMBusExpectations(mockPMBus, expectations);
+    psu.analyze();
+    EXPECT_EQ(psu.hasInputFault(), true);
+    EXPECT_EQ(psu.hasTempFault(), true);
+    EXPECT_EQ(psu.getStatusTemperature(), 0x40);
+
+    // STATUS_WORD unchanged, but a new fault in STATUS_TEMPERATURE.  The
+    // registers are read again, so it is seen on the next cycle.
+    expectations.statusTempValue = 0x60;
+    setPMBusExpectations(mockPMBus, expectations);
+    psu.analyze();
+    EXPECT_EQ(psu.getStatusInput(), 0x20);
+    EXPECT_EQ(psu.getStatusTemperature(), 0x60);
+
+    // Input fault gone.  STATUS_INPUT is no longer read.
+    expectations.statusWordValue = (status_word::TEMPERATURE_FAULT_WARN);
+    setPMBusExpectations(mockPMBus, expectations);
+    psu.analyze();
+    EXPECT_EQ(psu.getStatusInput(), 0);
+    EXPECT_EQ(psu.getStatusTemperature(), 0x60);
+
+    // Back to no faults.  Only STATUS_WORD is read.
+    expectations.statusWordValue = 0;
+    setPMBusExpectations(mockPMBus, expectations);
+    psu.analyze();
+    EXPECT_EQ(psu.hasInputFault(), false);
+    EXPECT_EQ(psu.hasTempFault(), false);
+    setPMBusExpectations(mockPMBus, expectations);
+    psu.analyze();
+}
+
+TEST_F(PowerSupplyTests, AnalyzeSteps)
+{
+    auto bus = sdbusplus::bus::new_default();
+
+    PowerSupply psu{bus, PSUInventoryPath, 3, 0x6b, PSUGPIOLineName};
+    EXPECT_EQ(psu.getI2CBus(), 3);
+    MockedGPIOInterface* mockPresenceGPIO =
+        static_cast<MockedGPIOInterface*>(psu.getPresenceGPIO());
+    // Always return 1 to indicate present.
+    EXPECT_CALL(*mockPresenceGPIO, read()).WillRepeatedly(Return(1));
+    MockedPMBus& mockPMBus = static_cast<MockedPMBus&>(psu.getPMBus());
+    EXPECT_CALL(mockPMBus, findHwmonDir());
+    EXPECT_CALL(mockPMBus, writeBinary(ON_OFF_CONFIG, _, _));
+    EXPECT_CALL(mockPMBus, read("in1_input", _))
+        .Times(1)
+        .WillOnce(Return(207000));
+    EXPECT_CALL(mockedUtil, setPresence(_, _, true, _));
+
+    // Presence is updated without reading the status registers.
+    EXPECT_CALL(mockPMBus, read(STATUS_WORD, _)).Times(0);
+    psu.analyzePresence();
+    EXPECT_EQ(psu.isPresent(), true);
+
+    // Status registers are read and analyzed separately.
+    PMBusExpectations expectations;
+    expectations.statusWordValue = (status_word::FAN_FAULT);
+    setPMBusExpectations(mockPMBus, expectations);
+    psu.analyzeStatus();
+    EXPECT_EQ(psu.hasFanFault(), true);
+
+    // No read failure occurred, so nothing is committed.
+    psu.commitReadFailure();
+    EXPECT_EQ(psu.isFaulted(), true);
+}
+
+TEST_F(PowerSupplyTests, AnalyzeHealth)
+{
+    using ReadFailure =
+        sdbusplus::xyz::openbmc_project::Common::Device::Error::ReadFailure;
+
+    auto bus = sdbusplus::bus::new_default();
+
+    PowerSupply psu{bus, PSUInventoryPath, 3, 0x6b, PSUGPIOLineName};
+    MockedGPIOInterface* mockPresenceGPIO =
+        static_cast<MockedGPIOInterface*>(psu.getPresenceGPIO());
+    EXPECT_CALL(*mockPresenceGPIO, read()).WillRepeatedly(Return(1));
+    MockedPMBus& mockPMBus = static_cast<MockedPMBus&>(psu.getPMBus());
+    EXPECT_CALL(mockPMBus, findHwmonDir());
+    EXPECT_CALL(mockPMBus, writeBinary(ON_OFF_CONFIG, _, _));
+    EXPECT_CALL(mockPMBus, read("in1_input", _))
+        .WillRepeatedly(Return(207000));
+    EXPECT_CALL(mockedUtil, setPresence(_, _, true, _));
+    psu.analyzePresence();
+    EXPECT_EQ(psu.getHealth(), Health::responsive);
+
+    // Read on every call until LOG_LIMIT failures.  The device path is
+    // recorded for the error log of the first one.
+    const std::filesystem::path devicePath{"/sys/bus/i2c/devices/3-006b"};
+    EXPECT_CALL(mockPMBus, path()).WillRepeatedly(ReturnRef(devicePath));
+    EXPECT_CALL(mockPMBus, read(STATUS_WORD, _))
+        .Times(LOG_LIMIT)
+        .WillRepeatedly(Throw(ReadFailure()));
+    psu.analyzeStatus();
+    EXPECT_EQ(psu.getHealth(), Health::failing);
+    EXPECT_EQ(psu.hasCommFault(), false);
+    for (auto i = 1; i < LOG_LIMIT; i++)
+    {
+        psu.analyzeStatus();
+    }
+    EXPECT_EQ(psu.getHealth(), Health::unresponsive);
+    EXPECT_EQ(psu.hasCommFault(), true);
+    ::testing::Mock::VerifyAndClearExpectations(&mockPMBus);
+
+    // Probed after 1, then 2, then 4 skipped calls
+    EXPECT_CALL(mockPMBus, read(STATUS_WORD, _))
+        .Times(3)
+        .WillRepeatedly(Throw(ReadFailure()));
+    for (auto i = 0; i < (1 + 1) + (2 + 1) + (4 + 1); i++)
+    {
+        psu.analyzeStatus();
+    }
+    ::testing::Mock::VerifyAndClearExpectations(&mockPMBus);
+
+    // Clearing the faults probes it once right away
+    EXPECT_CALL(mockPMBus, read("in1_input", _))
+        .WillRepeatedly(Return(207000));
+    psu.clearFaults();
+    EXPECT_EQ(psu.hasCommFault(), true);
+    PMBusExpectations expectations;
+    setPMBusExpectations(mockPMBus, expectations);
+    psu.analyzeStatus();
+    EXPECT_EQ(psu.getHealth(), Health::responsive);
+    EXPECT_EQ(psu.hasCommFault(), false);
+    EXPECT_GT(psu.getHealthTime(Health::responsive).count(), 0);
+}
+
+TEST_F(PowerSupplyTests, GetInputVoltage)
+{
+    auto bus = sdbusplus::bus::new_default();
+
+    PowerSupply psu{bus, PSUInventoryPath, 3, 0x6b, PSUGPIOLineName};
+    double actualInputVoltage;
+    int inputVoltage;
+
+    // Not present, so nothing is read
+    MockedPMBus& mockPMBus = static_cast<MockedPMBus&>(psu.getPMBus());
+    EXPECT_CALL(mockPMBus, readString(READ_VIN, _)).Times(0);
+    psu.getInputVoltage(actualInputVoltage, inputVoltage);
+    EXPECT_EQ(actualInputVoltage, in_input::VIN_VOLTAGE_0);
+    EXPECT_EQ(inputVoltage, in_input::VIN_VOLTAGE_0);
+    ::testing::Mock::VerifyAndClearExpectations(&mockPMBus);
+
+    MockedGPIOInterface* mockPresenceGPIO =
+        static_cast<MockedGPIOInterface*>(psu.getPresenceGPIO());
+    EXPECT_CALL(*mockPresenceGPIO, read()).WillRepeatedly(Return(1));
+    EXPECT_CALL(mockPMBus, findHwmonDir());
+    EXPECT_CALL(mockPMBus, writeBinary(ON_OFF_CONFIG, _, _));
+    EXPECT_CALL(mockPMBus, read(READ_VIN, _)).WillOnce(Return(206000));
+    EXPECT_CALL(mockedUtil, setPresence(_, _, true, _));
+
+    // The input voltage is sampled once while analyzing the status.  The VPD
+    // read with IBM_VPD is not checked here.
+    EXPECT_CALL(mockPMBus, readString(_, _)).Times(AnyNumber());
+    EXPECT_CALL(mockPMBus, readString(READ_VIN, _))
+        .Times(1)
+        .WillOnce(Return("206000"));
+    PMBusExpectations expectations;
+    setPMBusExpectations(mockPMBus, expectations);
+    psu.analyze();
+    setPMBusExpectations(mockPMBus, expectations);
+    psu.analyze();
+
+    // Validation uses the sample
+    psu.getInputVoltage(actualInputVoltage, inputVoltage);
+    EXPECT_EQ(actualInputVoltage, 206);
+    EXPECT_EQ(inputVoltage, in_input::VIN_VOLTAGE_220);
+}
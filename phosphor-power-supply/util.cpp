@@ -2,6 +2,8 @@
 
 #include <gpiod.hpp>
 
+#include <chrono>
+
 namespace phosphor::power::psu
 {
 
@@ -28,6 +30,16 @@ GPIOInterface::GPIOInterface(const std::string& namedGpio)
     }
 }
 
+GPIOInterface::~GPIOInterface()
+{
+    try
+    {
+        release();
+    }
+    catch (const std::exception& e)
+    {}
+}
+
 std::unique_ptr<GPIOInterfaceBase>
     GPIOInterface::createGPIO(const std::string& namedGpio)
 {
@@ -53,8 +65,12 @@ int GPIOInterface::read()
 
     try
     {
-        line.request({__FUNCTION__, gpiod::line_request::DIRECTION_INPUT,
-                      gpiod::line_request::FLAG_ACTIVE_LOW});
+        // A line requested for events can be read as is
+        if (requestType != gpiod::line_request::EVENT_BOTH_EDGES)
+        {
+            request(gpiod::line_request::DIRECTION_INPUT,
+                    gpiod::line_request::FLAG_ACTIVE_LOW);
+        }
         try
         {
             value = line.get_value();
@@ -64,11 +80,9 @@ int GPIOInterface::read()
             log<level::ERR>(
                 fmt::format("Failed to get_value of GPIO line: {}", e.what())
                     .c_str());
-            line.release();
+            release();
             throw;
         }
-
-        line.release();
     }
     catch (const std::exception& e)
     {
@@ -92,20 +106,84 @@ void GPIOInterface::write(int value, std::bitset<32> flags)
 
     try
     {
-        line.request(
-            {__FUNCTION__, gpiod::line_request::DIRECTION_OUTPUT, flags},
-            value);
-
-        line.release();
+        // The value is set by the request if the line was not already an
+        // output with these flags
+        if (!request(gpiod::line_request::DIRECTION_OUTPUT, flags, value))
+        {
+            line.set_value(value);
+        }
     }
     catch (std::exception& e)
     {
         log<level::ERR>("Failed to set GPIO line", entry("MSG=%s", e.what()),
                         entry("VALUE=%d", value));
+        release();
         throw;
     }
 }
 
+int GPIOInterface::requestEvents()
+{
+    using namespace phosphor::logging;
+
+    if (!line)
+    {
+        log<level::ERR>("Failed line");
+        throw std::runtime_error{std::string{"Failed to find line"}};
+    }
+
+    try
+    {
+        request(gpiod::line_request::EVENT_BOTH_EDGES,
+                gpiod::line_request::FLAG_ACTIVE_LOW);
+        return line.event_get_fd();
+    }
+    catch (const std::exception& e)
+    {
+        log<level::ERR>("Failed to request GPIO line events",
+                        entry("MSG=%s", e.what()));
+        release();
+        throw;
+    }
+}
+
+void GPIOInterface::clearEvents()
+{
+    if (requestType != gpiod::line_request::EVENT_BOTH_EDGES)
+    {
+        return;
+    }
+
+    while (line.event_wait(std::chrono::nanoseconds(0)))
+    {
+        line.event_read();
+    }
+}
+
+bool GPIOInterface::request(int type, std::bitset<32> flags, int value)
+{
+    if ((requestType == type) && (requestFlags == flags))
+    {
+        return false;
+    }
+
+    // The direction or flags changed, so the line must be requested again
+    release();
+    line.request({"phosphor-psu-monitor", type, flags}, value);
+    requestType = type;
+    requestFlags = flags;
+    return true;
+}
+
+void GPIOInterface::release()
+{
+    if (requestType != -1)
+    {
+        requestType = -1;
+        line.release();
+    }
+}
+
 std::unique_ptr<GPIOInterfaceBase> createGPIO(const std::string& namedGpio)
 {
     return GPIOInterface::createGPIO(namedGpio);
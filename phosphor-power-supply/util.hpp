@@ -97,11 +97,11 @@ class GPIOInterface : public GPIOInterfaceBase
 {
   public:
     GPIOInterface() = delete;
-    virtual ~GPIOInterface() = default;
-    GPIOInterface(const GPIOInterface&) = default;
-    GPIOInterface& operator=(const GPIOInterface&) = default;
-    GPIOInterface(GPIOInterface&&) = default;
-    GPIOInterface& operator=(GPIOInterface&&) = default;
+    virtual ~GPIOInterface();
+    GPIOInterface(const GPIOInterface&) = delete;
+    GPIOInterface& operator=(const GPIOInterface&) = delete;
+    GPIOInterface(GPIOInterface&&) = delete;
+    GPIOInterface& operator=(GPIOInterface&&) = delete;
 
     /**
      * Constructor
@@ -116,6 +116,9 @@ class GPIOInterface : public GPIOInterfaceBase
     /**
      * @brief Attempts to read the state of the GPIO line.
      *
+     * The line stays requested as an input after the read, so later reads
+     * only need to get the value.
+     *
      * Throws an exception if line not found, request line fails, or get_value
      * from line fails.
      *
@@ -126,6 +129,9 @@ class GPIOInterface : public GPIOInterfaceBase
     /**
      * @brief Attempts to set the state of the GPIO line to the specified value.
      *
+     * The line stays requested as an output after the write, so later writes
+     * with the same flags only need to set the value.
+     *
      * Throws an exception if line not found, request line fails, or set_value
      * to line fails.
      *
@@ -139,8 +145,46 @@ class GPIOInterface : public GPIOInterfaceBase
      */
     std::string getName() const override;
 
+    /**
+     * @brief Requests events for both edges of the line.
+     *
+     * The line can still be read while events are requested.
+     *
+     * Throws an exception if line not found or request line fails.
+     *
+     * @return The file descriptor to watch for events.
+     */
+    int requestEvents() override;
+
+    /**
+     * @brief Reads and discards the pending events.
+     */
+    void clearEvents() override;
+
   private:
+    /**
+     * @brief Requests the line, unless it is already requested the same way.
+     *
+     * @param[in] type - the gpiod::line_request type
+     * @param[in] flags - the gpiod::line_request flags
+     * @param[in] value - the initial value of an output
+     *
+     * @return true if the line was requested, false if it already was.
+     */
+    bool request(int type, std::bitset<32> flags, int value = 0);
+
+    /**
+     * @brief Releases the line if it is requested.
+     */
+    void release();
+
     gpiod::line line;
+
+    /** @brief The type the line is requested with, or -1 if not requested. */
+    int requestType = -1;
+
+    /** @brief The flags the line is requested with. */
+    std::bitset<32> requestFlags;
 };
 
 } // namespace phosphor::power::psu
@@ -47,6 +47,23 @@ class GPIOInterfaceBase
     virtual int read() = 0;
     virtual void write(int value, std::bitset<32> flags) = 0;
     virtual std::string getName() const = 0;
+
+    /**
+     * @brief Requests events for both edges of the line.
+     *
+     * @return A file descriptor that is readable while events are pending, or
+     *         -1 if events are not supported.
+     */
+    virtual int requestEvents()
+    {
+        return -1;
+    }
+
+    /**
+     * @brief Reads and discards the pending events.
+     */
+    virtual void clearEvents()
+    {}
 };
 
 } // namespace phosphor::power::psu
@@ -57,6 +57,23 @@ class Action
      */
     virtual bool execute(ActionEnvironment& environment) = 0;
 
+    /**
+     * Resolves any IDs referenced by this action using the specified IDMap.
+     *
+     * Actions that refer to a device or rule by ID store a pointer to the
+     * object so that no lookup is needed when the action is executed.
+     * Actions that contain other actions link those actions.
+     *
+     * IDs that cannot be resolved are ignored.  The error will occur when the
+     * action is executed.
+     *
+     * The default implementation does nothing.
+     *
+     * @param idMap mapping from IDs to the associated Device/Rule objects
+     */
+    virtual void link(const IDMap& /*idMap*/)
+    {}
+
     /**
      * Returns a string description of this action.
      *
@@ -17,14 +17,21 @@
 
 #include "id_map.hpp"
 #include "phase_fault.hpp"
+#include "sensor_values.hpp"
+#include "sensors.hpp"
 #include "services.hpp"
+#include "symbol.hpp"
 
 #include <cstddef> // for size_t
+#include <cstdint>
+#include <functional>
 #include <map>
 #include <optional>
 #include <set>
 #include <stdexcept>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace phosphor::power::regulators
 {
@@ -33,6 +40,12 @@ namespace phosphor::power::regulators
 class Device;
 class Rule;
 
+/**
+ * A write verification that was deferred until the writes of an operation are
+ * done.  Throws an exception if the verification fails.
+ */
+using DeferredVerification = std::function<void()>;
+
 /**
  * @class ActionEnvironment
  *
@@ -46,6 +59,8 @@ class Rule;
  *   - reference to system services
  *   - faults detected by actions (if any)
  *   - additional error data captured by actions (if any)
+ *   - register values read with one I2C block read (if any)
+ *   - write verifications deferred by actions (if any)
  */
 class ActionEnvironment
 {
@@ -76,6 +91,22 @@ class ActionEnvironment
         deviceID{deviceID}, services{services}
     {}
 
+    /**
+     * Constructor.
+     *
+     * Faster than the constructor with a string device ID since the ID does
+     * not need to be looked up in the symbol table.
+     *
+     * @param idMap mapping from IDs to the associated Device/Rule objects
+     * @param deviceID current device ID
+     * @param services system services like error logging and the journal
+     */
+    explicit ActionEnvironment(const IDMap& idMap, Symbol deviceID,
+                               Services& services) :
+        idMap{idMap},
+        deviceID{deviceID}, services{services}
+    {}
+
     /**
      * Adds the specified key/value pair to the map of additional error data
      * that has been captured.
@@ -103,6 +134,56 @@ class ActionEnvironment
         phaseFaults.emplace(type);
     }
 
+    /**
+     * Adds the specified sensor value to the values that have been read.
+     *
+     * Replaces any previous value of the same sensor type.
+     *
+     * @param type sensor type
+     * @param value sensor value
+     */
+    void addSensorValue(SensorType type, double value)
+    {
+        sensorValues.set(type, value);
+    }
+
+    /**
+     * Stores the values of consecutive registers of the current device that
+     * were read with one I2C block read.
+     *
+     * Replaces any previously cached values.  The values are used by the I2C
+     * actions instead of reading the registers again until
+     * clearCachedRegisters() is called or the device ID changes.
+     *
+     * @param reg first register address
+     * @param values register values
+     * @param count number of registers
+     */
+    void cacheRegisters(uint8_t reg, const uint8_t* values, size_t count)
+    {
+        cachedRegister = reg;
+        cachedRegisterValues.assign(values, values + count);
+    }
+
+    /**
+     * Clears the cached register values, if any.  See cacheRegisters().
+     */
+    void clearCachedRegisters()
+    {
+        cachedRegisterValues.clear();
+    }
+
+    /**
+     * Defers the specified write verification.  Only valid if
+     * isVerificationDeferred() returns true.
+     *
+     * @param verification write verification
+     */
+    void deferVerification(DeferredVerification verification)
+    {
+        deferredVerifications->emplace_back(std::move(verification));
+    }
+
     /**
      * Decrements the rule call stack depth by one.
      *
@@ -127,6 +208,25 @@ class ActionEnvironment
         return additionalErrorData;
     }
 
+    /**
+     * Returns the cached values of consecutive registers of the current
+     * device.  See cacheRegisters().
+     *
+     * @param reg first register address
+     * @param count number of registers
+     * @return pointer to the values, or nullptr if any of the registers is not
+     *         cached
+     */
+    const uint8_t* getCachedRegisters(uint8_t reg, size_t count) const
+    {
+        if ((reg < cachedRegister) ||
+            ((reg - cachedRegister + count) > cachedRegisterValues.size()))
+        {
+            return nullptr;
+        }
+        return cachedRegisterValues.data() + (reg - cachedRegister);
+    }
+
     /**
      * Returns the device with the current device ID.
      *
@@ -136,7 +236,12 @@ class ActionEnvironment
      */
     Device& getDevice() const
     {
-        return idMap.getDevice(deviceID);
+        // Look up device the first time it is needed for the current ID
+        if (device == nullptr)
+        {
+            device = &(idMap.getDevice(deviceID));
+        }
+        return *device;
     }
 
     /**
@@ -146,7 +251,7 @@ class ActionEnvironment
      */
     const std::string& getDeviceID() const
     {
-        return deviceID;
+        return deviceID.str();
     }
 
     /**
@@ -184,6 +289,16 @@ class ActionEnvironment
         return ruleDepth;
     }
 
+    /**
+     * Returns the sensor values that have been read (if any).
+     *
+     * @return sensor values read
+     */
+    const SensorValues& getSensorValues() const
+    {
+        return sensorValues;
+    }
+
     /**
      * Returns the services in this action environment.
      *
@@ -204,6 +319,18 @@ class ActionEnvironment
         return volts;
     }
 
+    /**
+     * Returns whether the write verifications of the current device are
+     * deferred.  See setDeferredVerifications().
+     *
+     * @return true if the verifications are deferred, false otherwise
+     */
+    bool isVerificationDeferred() const
+    {
+        return (deferredVerifications != nullptr) &&
+               (&getDevice() == deferringDevice);
+    }
+
     /**
      * Increments the rule call stack depth by one.
      *
@@ -225,14 +352,112 @@ class ActionEnvironment
         ++ruleDepth;
     }
 
+    /**
+     * Resets this action environment so it can be reused.
+     *
+     * Restores the state of a newly constructed environment with the
+     * specified device ID.  The IDMap and services are not changed.
+     *
+     * Reusing an environment avoids allocating memory each time actions are
+     * executed.  Memory that was previously allocated, such as for the
+     * register values, is kept.
+     *
+     * @param deviceID current device ID
+     */
+    void reset(const std::string& deviceID)
+    {
+        reset(Symbol{deviceID});
+    }
+
+    /**
+     * Resets this action environment so it can be reused.
+     *
+     * Faster than reset() with a string device ID since the ID does not need
+     * to be looked up in the symbol table.
+     *
+     * @param deviceID current device ID
+     */
+    void reset(Symbol deviceID)
+    {
+        this->deviceID = deviceID;
+        device = nullptr;
+        volts.reset();
+        ruleDepth = 0;
+        phaseFaults.clear();
+        sensorValues.clear();
+        additionalErrorData.clear();
+        cachedRegisterValues.clear();
+        deferringDevice = nullptr;
+        deferredVerifications = nullptr;
+    }
+
+    /**
+     * Defers the write verifications of the specified device.
+     *
+     * Actions that verify the registers they write, such as
+     * PMBusWriteVoutCommandAction, add the verifications to the specified
+     * vector instead of reading each register back right after writing it.
+     * The caller runs the verifications once all the writes are done.  The
+     * writes to other devices are still verified right away.
+     *
+     * @param device device whose write verifications are deferred
+     * @param verifications deferred verifications are added to this vector
+     */
+    void setDeferredVerifications(
+        Device& device, std::vector<DeferredVerification>& verifications)
+    {
+        deferringDevice = &device;
+        deferredVerifications = &verifications;
+    }
+
     /**
      * Sets the current device ID.
      *
      * @param id device ID
      */
     void setDeviceID(const std::string& id)
+    {
+        setDeviceID(Symbol{id});
+    }
+
+    /**
+     * Sets the current device ID.
+     *
+     * @param id device ID
+     */
+    void setDeviceID(Symbol id)
     {
         deviceID = id;
+        device = nullptr;
+        cachedRegisterValues.clear();
+    }
+
+    /**
+     * Sets the current device ID and the device with that ID.
+     *
+     * Avoids looking up the device when getDevice() is called.
+     *
+     * @param id device ID
+     * @param device device with the specified ID
+     */
+    void setDeviceID(const std::string& id, Device& device)
+    {
+        setDeviceID(Symbol{id}, device);
+    }
+
+    /**
+     * Sets the current device ID and the device with that ID.
+     *
+     * Avoids looking up the device when getDevice() is called.
+     *
+     * @param id device ID
+     * @param device device with the specified ID
+     */
+    void setDeviceID(Symbol id, Device& device)
+    {
+        deviceID = id;
+        this->device = &device;
+        cachedRegisterValues.clear();
     }
 
     /**
@@ -254,7 +479,13 @@ class ActionEnvironment
     /**
      * Current device ID.
      */
-    std::string deviceID{};
+    Symbol deviceID{};
+
+    /**
+     * Device with the current device ID, if it has been found.  Cached to
+     * avoid looking up the device each time getDevice() is called.
+     */
+    mutable Device* device{nullptr};
 
     /**
      * System services like error logging and the journal.
@@ -276,10 +507,36 @@ class ActionEnvironment
      */
     std::set<PhaseFaultType> phaseFaults{};
 
+    /**
+     * Sensor values that have been read.
+     */
+    SensorValues sensorValues{};
+
+    /**
+     * Device whose write verifications are deferred, if any.
+     */
+    Device* deferringDevice{nullptr};
+
+    /**
+     * Write verifications that were deferred, if any.
+     */
+    std::vector<DeferredVerification>* deferredVerifications{nullptr};
+
     /**
      * Additional error data that has been captured.
      */
     std::map<std::string, std::string> additionalErrorData{};
+
+    /**
+     * Address of the first register in cachedRegisterValues.
+     */
+    uint8_t cachedRegister{0};
+
+    /**
+     * Cached values of consecutive registers of the current device.  Empty if
+     * no registers are cached.
+     */
+    std::vector<uint8_t> cachedRegisterValues{};
 };
 
 } // namespace phosphor::power::regulators
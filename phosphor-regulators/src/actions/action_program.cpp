@@ -0,0 +1,467 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "action_program.hpp"
+
+#include "action_utils.hpp"
+#include "and_action.hpp"
+#include "device.hpp"
+#include "i2c_capture_bytes_action.hpp"
+#include "i2c_compare_bit_action.hpp"
+#include "i2c_compare_byte_action.hpp"
+#include "i2c_compare_bytes_action.hpp"
+#include "i2c_interface.hpp"
+#include "if_action.hpp"
+#include "not_action.hpp"
+#include "or_action.hpp"
+#include "rule.hpp"
+#include "rule_profiler.hpp"
+#include "run_rule_action.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+
+namespace phosphor::power::regulators
+{
+
+namespace
+{
+
+/**
+ * Returns the registers read by an action that can be coalesced with adjacent
+ * actions into one I2C block read.
+ *
+ * @param action action
+ * @return first register and number of registers, or std::nullopt if the
+ *         action cannot be coalesced
+ */
+std::optional<std::pair<std::size_t, std::size_t>>
+    getRegisterRange(Action& action)
+{
+    if (auto* compareBit = dynamic_cast<I2CCompareBitAction*>(&action))
+    {
+        return std::make_pair(compareBit->getRegister(), 1);
+    }
+    if (auto* compareByte = dynamic_cast<I2CCompareByteAction*>(&action))
+    {
+        return std::make_pair(compareByte->getRegister(), 1);
+    }
+    if (auto* compareBytes = dynamic_cast<I2CCompareBytesAction*>(&action))
+    {
+        return std::make_pair(compareBytes->getRegister(),
+                              compareBytes->getValues().size());
+    }
+    if (auto* captureBytes = dynamic_cast<I2CCaptureBytesAction*>(&action))
+    {
+        return std::make_pair(captureBytes->getRegister(),
+                              captureBytes->getCount());
+    }
+    return std::nullopt;
+}
+
+/**
+ * @class CachedRegistersGuard
+ *
+ * Clears the cached register values in an action environment when a program
+ * stops executing.
+ */
+class CachedRegistersGuard
+{
+  public:
+    explicit CachedRegistersGuard(ActionEnvironment& environment) :
+        environment{environment}
+    {}
+
+    ~CachedRegistersGuard()
+    {
+        environment.clearCachedRegisters();
+    }
+
+    CachedRegistersGuard(const CachedRegistersGuard&) = delete;
+    CachedRegistersGuard& operator=(const CachedRegistersGuard&) = delete;
+
+  private:
+    ActionEnvironment& environment;
+};
+
+} // namespace
+
+ActionProgram::ActionProgram(
+    const std::vector<std::unique_ptr<Action>>& actions, const IDMap& idMap)
+{
+    for (const std::unique_ptr<Action>& action : actions)
+    {
+        this->actions.emplace_back(action.get());
+    }
+
+    // Compile the actions followed by the rules they call.  Compiling a rule
+    // can add more rules to the end of the vector.
+    compileActions(actions, idMap);
+    emit(Opcode::halt);
+    for (std::size_t i = 0; i < rules.size(); ++i)
+    {
+        rules[i].second = static_cast<uint32_t>(instructions.size());
+        compileActions(rules[i].first->getActions(), idMap);
+        emit(Opcode::returnFromRule);
+    }
+
+    // Link the rule calls to the first instruction of each rule
+    for (const auto& [index, ruleIndex] : ruleCalls)
+    {
+        instructions[index].target = rules[ruleIndex].second;
+    }
+    rules.clear();
+    ruleCalls.clear();
+}
+
+bool ActionProgram::execute(ActionEnvironment& environment) const
+{
+    // Interpret the actions so the rules and actions are profiled
+    if (RuleProfiler::get().isEnabled())
+    {
+        bool returnValue{true};
+        for (Action* action : actions)
+        {
+            returnValue = action_utils::execute(*action, environment);
+        }
+        return returnValue;
+    }
+
+    std::vector<bool> values{};
+    std::vector<uint32_t> returnAddresses{};
+
+    // Do not leave cached register values in the environment if an action
+    // throws an exception
+    CachedRegistersGuard guard{environment};
+
+    uint32_t pc{0};
+    while (true)
+    {
+        const Instruction& instruction = instructions[pc++];
+        switch (instruction.opcode)
+        {
+            case Opcode::execute:
+                values.push_back(instruction.action->execute(environment));
+                break;
+
+            case Opcode::pushTrue:
+                values.push_back(true);
+                break;
+
+            case Opcode::pushFalse:
+                values.push_back(false);
+                break;
+
+            case Opcode::pop:
+                values.pop_back();
+                break;
+
+            case Opcode::andValues:
+            {
+                bool value = values.back();
+                values.pop_back();
+                values.back() = values.back() && value;
+                break;
+            }
+
+            case Opcode::orValues:
+            {
+                bool value = values.back();
+                values.pop_back();
+                values.back() = values.back() || value;
+                break;
+            }
+
+            case Opcode::notValue:
+                values.back() = !values.back();
+                break;
+
+            case Opcode::jumpIfFalse:
+            {
+                bool value = values.back();
+                values.pop_back();
+                if (!value)
+                {
+                    pc = instruction.target;
+                }
+                break;
+            }
+
+            case Opcode::jump:
+                pc = instruction.target;
+                break;
+
+            case Opcode::callRule:
+                // Rule depth is used to detect infinite recursion
+                environment.incrementRuleDepth(*instruction.ruleID);
+                returnAddresses.push_back(pc);
+                pc = instruction.target;
+                break;
+
+            case Opcode::returnFromRule:
+                environment.decrementRuleDepth();
+                pc = returnAddresses.back();
+                returnAddresses.pop_back();
+                break;
+
+            case Opcode::readRegisters:
+                readRegisters(instruction, environment);
+                break;
+
+            case Opcode::clearRegisters:
+                environment.clearCachedRegisters();
+                break;
+
+            case Opcode::halt:
+                return values.back();
+        }
+    }
+}
+
+void ActionProgram::compileAction(Action& action, const IDMap& idMap)
+{
+    if (auto* andAction = dynamic_cast<AndAction*>(&action))
+    {
+        // All actions are executed; result is true if all returned true
+        emit(Opcode::pushTrue);
+        const auto& subActions = andAction->getActions();
+        std::size_t runEnd{0};
+        for (std::size_t i = 0; i < subActions.size(); ++i)
+        {
+            if (i >= runEnd)
+            {
+                runEnd = compileRegisterReads(subActions, i);
+            }
+            compileAction(*(subActions[i]), idMap);
+            emit(Opcode::andValues);
+            if ((i + 1) == runEnd)
+            {
+                emit(Opcode::clearRegisters);
+            }
+        }
+    }
+    else if (auto* orAction = dynamic_cast<OrAction*>(&action))
+    {
+        // All actions are executed; result is true if any returned true
+        emit(Opcode::pushFalse);
+        const auto& subActions = orAction->getActions();
+        std::size_t runEnd{0};
+        for (std::size_t i = 0; i < subActions.size(); ++i)
+        {
+            if (i >= runEnd)
+            {
+                runEnd = compileRegisterReads(subActions, i);
+            }
+            compileAction(*(subActions[i]), idMap);
+            emit(Opcode::orValues);
+            if ((i + 1) == runEnd)
+            {
+                emit(Opcode::clearRegisters);
+            }
+        }
+    }
+    else if (auto* notAction = dynamic_cast<NotAction*>(&action))
+    {
+        compileAction(*(notAction->getAction()), idMap);
+        emit(Opcode::notValue);
+    }
+    else if (auto* ifAction = dynamic_cast<IfAction*>(&action))
+    {
+        compileAction(*(ifAction->getConditionAction()), idMap);
+        uint32_t jumpToElse = emit(Opcode::jumpIfFalse);
+        compileActions(ifAction->getThenActions(), idMap);
+        uint32_t jumpToEnd = emit(Opcode::jump);
+
+        // If no "else" clause was specified the return value is false
+        instructions[jumpToElse].target =
+            static_cast<uint32_t>(instructions.size());
+        if (ifAction->getElseActions().empty())
+        {
+            emit(Opcode::pushFalse);
+        }
+        else
+        {
+            compileActions(ifAction->getElseActions(), idMap);
+        }
+        instructions[jumpToEnd].target =
+            static_cast<uint32_t>(instructions.size());
+    }
+    else if (auto* runRuleAction = dynamic_cast<RunRuleAction*>(&action))
+    {
+        Rule* rule{nullptr};
+        try
+        {
+            rule = &(idMap.getRule(runRuleAction->getRuleID()));
+        }
+        catch (const std::invalid_argument&)
+        {
+            // Rule not found; execute action normally so the same error occurs
+            uint32_t index = emit(Opcode::execute);
+            instructions[index].action = &action;
+            return;
+        }
+
+        // Execute a memoizable rule normally so its result can be reused
+        if (rule->isMemoizable())
+        {
+            uint32_t index = emit(Opcode::execute);
+            instructions[index].action = &action;
+            return;
+        }
+
+        // Find or add the rule.  The call is linked after all rules have
+        // been compiled.
+        std::size_t ruleIndex{0};
+        while ((ruleIndex < rules.size()) && (rules[ruleIndex].first != rule))
+        {
+            ++ruleIndex;
+        }
+        if (ruleIndex == rules.size())
+        {
+            rules.emplace_back(rule, 0);
+        }
+
+        uint32_t index = emit(Opcode::callRule);
+        instructions[index].ruleID = &(runRuleAction->getRuleID());
+        ruleCalls.emplace_back(index, ruleIndex);
+    }
+    else
+    {
+        uint32_t index = emit(Opcode::execute);
+        instructions[index].action = &action;
+    }
+}
+
+void ActionProgram::compileActions(
+    const std::vector<std::unique_ptr<Action>>& actions, const IDMap& idMap)
+{
+    // Return value is from the last action, or true if there are no actions
+    if (actions.empty())
+    {
+        emit(Opcode::pushTrue);
+        return;
+    }
+
+    // Read the registers of adjacent I2C actions with one block read
+    std::size_t runEnd{0};
+    for (std::size_t i = 0; i < actions.size(); ++i)
+    {
+        if (i > 0)
+        {
+            emit(Opcode::pop);
+        }
+        if (i >= runEnd)
+        {
+            runEnd = compileRegisterReads(actions, i);
+        }
+        compileAction(*(actions[i]), idMap);
+        if ((i + 1) == runEnd)
+        {
+            emit(Opcode::clearRegisters);
+        }
+    }
+}
+
+std::size_t ActionProgram::compileRegisterReads(
+    const std::vector<std::unique_ptr<Action>>& actions, std::size_t index)
+{
+    // Find the adjacent actions whose registers form one consecutive range
+    std::size_t first{0};
+    std::size_t end{0};
+    std::size_t runEnd{index};
+    while (runEnd < actions.size())
+    {
+        auto range = getRegisterRange(*(actions[runEnd]));
+        if (!range || (range->second == 0))
+        {
+            break;
+        }
+        auto [reg, count] = *range;
+        if (runEnd == index)
+        {
+            first = reg;
+            end = reg + count;
+        }
+        else
+        {
+            // Registers must overlap or be next to the range so far
+            if ((reg > end) || ((reg + count) < first))
+            {
+                break;
+            }
+            std::size_t newFirst = std::min(first, reg);
+            std::size_t newEnd = std::max(end, reg + count);
+            if ((newEnd - newFirst) > maxBlockReadSize)
+            {
+                break;
+            }
+            first = newFirst;
+            end = newEnd;
+        }
+        ++runEnd;
+    }
+
+    if (((runEnd - index) < 2) || ((end - first) > maxBlockReadSize))
+    {
+        return index;
+    }
+
+    uint32_t instructionIndex = emit(Opcode::readRegisters);
+    instructions[instructionIndex].reg = static_cast<uint8_t>(first);
+    instructions[instructionIndex].count = static_cast<uint8_t>(end - first);
+    return runEnd;
+}
+
+uint32_t ActionProgram::emit(Opcode opcode)
+{
+    instructions.emplace_back(Instruction{opcode});
+    return static_cast<uint32_t>(instructions.size() - 1);
+}
+
+void ActionProgram::readRegisters(const Instruction& instruction,
+                                  ActionEnvironment& environment)
+{
+    try
+    {
+        Device& device = environment.getDevice();
+        if (!device.hasAutoIncrement())
+        {
+            return;
+        }
+
+        i2c::I2CInterface& interface = device.getI2CInterface();
+        if (!interface.isOpen())
+        {
+            interface.open();
+        }
+
+        uint8_t values[maxBlockReadSize];
+        uint8_t size{instruction.count}; // byte count is input/output
+        interface.read(instruction.reg, size, values,
+                       i2c::I2CInterface::Mode::I2C);
+        environment.cacheRegisters(instruction.reg, values,
+                                   std::min(size, instruction.count));
+    }
+    catch (const std::exception&)
+    {
+        // The actions read the registers individually and report any error
+    }
+}
+
+} // namespace phosphor::power::regulators
@@ -0,0 +1,315 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "action.hpp"
+#include "action_environment.hpp"
+#include "id_map.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace phosphor::power::regulators
+{
+
+/**
+ * @class ActionProgram
+ *
+ * A list of actions compiled into a flat array of instructions.
+ *
+ * The and, or, not, if, and run_rule actions are lowered into instructions
+ * that evaluate their results on a stack of boolean values.  Rules are
+ * resolved when the program is compiled, and each rule that can be reached
+ * from the actions is compiled once into the program.  A run_rule action
+ * becomes a call to the rule's instructions, so rule IDs are not looked up
+ * during execution.  All other actions are executed by calling their
+ * execute() method.
+ *
+ * Executing the program has the same results as executing the actions with
+ * action_utils::execute(), including the rule depth checking done by the
+ * run_rule action.  If a rule cannot be found when the program is compiled,
+ * the run_rule action is executed normally so the same error occurs.  A
+ * run_rule action that runs a memoizable rule is also executed normally, so
+ * the memoized result of the rule is used; see Rule.
+ *
+ * Adjacent i2c_compare_bit, i2c_compare_byte, i2c_compare_bytes, and
+ * i2c_capture_bytes actions in the same list that access consecutive or
+ * overlapping registers are coalesced.  The registers are read with one I2C
+ * block read before the actions are executed, and the actions use the values
+ * cached in the ActionEnvironment.  Registers are only coalesced if the
+ * current device supports auto increment; see Device::hasAutoIncrement().  If
+ * it does not, or if the block read fails, the actions read the registers
+ * individually as usual.
+ *
+ * While rule profiling is enabled, the actions are executed with
+ * action_utils::execute() instead of the compiled instructions so that each
+ * rule and action is profiled; see RuleProfiler.
+ *
+ * The program refers to the compiled actions and rules.  They must not be
+ * deleted while the program exists.
+ */
+class ActionProgram
+{
+  public:
+    // Specify which compiler-generated methods we want
+    ActionProgram() = delete;
+    ActionProgram(const ActionProgram&) = delete;
+    ActionProgram(ActionProgram&&) = delete;
+    ActionProgram& operator=(const ActionProgram&) = delete;
+    ActionProgram& operator=(ActionProgram&&) = delete;
+    ~ActionProgram() = default;
+
+    /**
+     * Maximum number of registers read with one I2C block read when
+     * coalescing actions.
+     */
+    static constexpr std::size_t maxBlockReadSize{32};
+
+    /**
+     * Constructor.
+     *
+     * Compiles the specified actions and the rules they run.
+     *
+     * @param actions actions to compile
+     * @param idMap mapping from IDs to the associated Device/Rule objects
+     */
+    explicit ActionProgram(const std::vector<std::unique_ptr<Action>>& actions,
+                           const IDMap& idMap);
+
+    /**
+     * Executes the compiled actions in sequential order.
+     *
+     * Returns the return value from the last action.
+     *
+     * Throws an exception if an error occurs and an action cannot be
+     * successfully executed.
+     *
+     * @param environment action execution environment
+     * @return return value from last action
+     */
+    bool execute(ActionEnvironment& environment) const;
+
+    /**
+     * Returns the number of instructions in the program.
+     *
+     * @return instruction count
+     */
+    std::size_t getInstructionCount() const
+    {
+        return instructions.size();
+    }
+
+  private:
+    /**
+     * Instruction operation code.
+     */
+    enum class Opcode : uint8_t
+    {
+        /**
+         * Execute an action and push its return value.
+         */
+        execute,
+
+        /**
+         * Push true.
+         */
+        pushTrue,
+
+        /**
+         * Push false.
+         */
+        pushFalse,
+
+        /**
+         * Pop a value.
+         */
+        pop,
+
+        /**
+         * Pop a value and replace the top value with the logical AND of both.
+         */
+        andValues,
+
+        /**
+         * Pop a value and replace the top value with the logical OR of both.
+         */
+        orValues,
+
+        /**
+         * Replace the top value with its logical NOT.
+         */
+        notValue,
+
+        /**
+         * Pop a value and jump to the target if it is false.
+         */
+        jumpIfFalse,
+
+        /**
+         * Jump to the target.
+         */
+        jump,
+
+        /**
+         * Increment the rule depth and call the rule at the target.
+         */
+        callRule,
+
+        /**
+         * Decrement the rule depth and return from a rule.
+         */
+        returnFromRule,
+
+        /**
+         * Read registers of the current device with one I2C block read and
+         * cache their values, if the device supports auto increment.
+         */
+        readRegisters,
+
+        /**
+         * Clear the cached register values.
+         */
+        clearRegisters,
+
+        /**
+         * Stop and return the top value.
+         */
+        halt
+    };
+
+    /**
+     * One instruction.
+     */
+    struct Instruction
+    {
+        /**
+         * Operation code.
+         */
+        Opcode opcode;
+
+        /**
+         * Instruction index to jump to or call.
+         */
+        uint32_t target{0};
+
+        /**
+         * Action to execute.  Only used by Opcode::execute.
+         */
+        Action* action{nullptr};
+
+        /**
+         * ID of the rule to call.  Only used by Opcode::callRule.
+         */
+        const std::string* ruleID{nullptr};
+
+        /**
+         * First register to read.  Only used by Opcode::readRegisters.
+         */
+        uint8_t reg{0};
+
+        /**
+         * Number of registers to read.  Only used by Opcode::readRegisters.
+         */
+        uint8_t count{0};
+    };
+
+    /**
+     * Compiles one action.
+     *
+     * The compiled instructions push the return value of the action.
+     *
+     * @param action action to compile
+     * @param idMap mapping from IDs to the associated Device/Rule objects
+     */
+    void compileAction(Action& action, const IDMap& idMap);
+
+    /**
+     * Compiles a list of actions that are executed in sequential order.
+     *
+     * The compiled instructions push the return value of the last action, or
+     * true if the list is empty.
+     *
+     * @param actions actions to compile
+     * @param idMap mapping from IDs to the associated Device/Rule objects
+     */
+    void compileActions(const std::vector<std::unique_ptr<Action>>& actions,
+                        const IDMap& idMap);
+
+    /**
+     * Compiles a block read of the registers accessed by a run of adjacent
+     * I2C actions, if any, starting at the specified action.
+     *
+     * The run contains at least two actions that read consecutive or
+     * overlapping registers, up to maxBlockReadSize registers in total.
+     *
+     * @param actions list of actions
+     * @param index index of the first action in the run
+     * @return index of the action after the run, or index if there is no run
+     */
+    std::size_t compileRegisterReads(
+        const std::vector<std::unique_ptr<Action>>& actions, std::size_t index);
+
+    /**
+     * Appends an instruction to the program.
+     *
+     * @param opcode instruction operation code
+     * @return index of the instruction
+     */
+    uint32_t emit(Opcode opcode);
+
+    /**
+     * Executes an Opcode::readRegisters instruction.
+     *
+     * Errors are ignored, since the actions read the registers individually
+     * if they are not cached.
+     *
+     * @param instruction instruction to execute
+     * @param environment action execution environment
+     */
+    static void readRegisters(const Instruction& instruction,
+                              ActionEnvironment& environment);
+
+    /**
+     * Instructions in the program.
+     */
+    std::vector<Instruction> instructions{};
+
+    /**
+     * Actions that were compiled.  Executed instead of the instructions while
+     * rule profiling is enabled.
+     */
+    std::vector<Action*> actions{};
+
+    /**
+     * Rules that are called by the program.  Only used during compilation.
+     *
+     * Each element contains the rule and the index of its first instruction,
+     * or 0 if the rule has not been compiled yet.
+     */
+    std::vector<std::pair<Rule*, uint32_t>> rules{};
+
+    /**
+     * Call instructions whose target rule is compiled later, and the index of
+     * the rule in the rules vector.  Only used during compilation.
+     */
+    std::vector<std::pair<uint32_t, std::size_t>> ruleCalls{};
+};
+
+} // namespace phosphor::power::regulators
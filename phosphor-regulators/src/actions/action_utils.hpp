@@ -17,6 +17,7 @@
 
 #include "action.hpp"
 #include "action_environment.hpp"
+#include "rule_profiler.hpp"
 
 #include <memory>
 #include <vector>
@@ -29,6 +30,30 @@ namespace phosphor::power::regulators::action_utils
  * framework.
  */
 
+/**
+ * Executes one action.
+ *
+ * The action is profiled if rule profiling is enabled; see RuleProfiler.
+ * Actions that contain other actions should use this function to execute
+ * them.
+ *
+ * Throws an exception if an error occurs and the action cannot be
+ * successfully executed.
+ *
+ * @param action action to execute
+ * @param environment action execution environment
+ * @return return value from the action
+ */
+inline bool execute(Action& action, ActionEnvironment& environment)
+{
+    if (!RuleProfiler::get().isEnabled())
+    {
+        return action.execute(environment);
+    }
+    RuleProfiler::Scope scope{action, environment};
+    return action.execute(environment);
+}
+
 /**
  * Executes one or more actions in sequential order.
  *
@@ -47,7 +72,7 @@ inline bool execute(std::vector<std::unique_ptr<Action>>& actions,
     bool returnValue{true};
     for (std::unique_ptr<Action>& action : actions)
     {
-        returnValue = action->execute(environment);
+        returnValue = execute(*action, environment);
     }
     return returnValue;
 }
@@ -17,6 +17,7 @@
 
 #include "action.hpp"
 #include "action_environment.hpp"
+#include "action_utils.hpp"
 
 #include <memory>
 #include <string>
@@ -75,7 +76,7 @@ class AndAction : public Action
         bool returnValue{true};
         for (std::unique_ptr<Action>& action : actions)
         {
-            if (action->execute(environment) == false)
+            if (action_utils::execute(*action, environment) == false)
             {
                 returnValue = false;
             }
@@ -93,6 +94,15 @@ class AndAction : public Action
         return actions;
     }
 
+    /** @copydoc Action::link() */
+    virtual void link(const IDMap& idMap) override
+    {
+        for (std::unique_ptr<Action>& action : actions)
+        {
+            action->link(idMap);
+        }
+    }
+
     /**
      * Returns a string description of this action.
      *
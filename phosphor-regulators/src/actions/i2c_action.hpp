@@ -20,6 +20,10 @@
 #include "device.hpp"
 #include "i2c_interface.hpp"
 
+#include <algorithm>
+#include <cstdint>
+#include <span>
+
 namespace phosphor::power::regulators
 {
 
@@ -68,6 +72,93 @@ class I2CAction : public Action
 
         return interface;
     }
+
+    /**
+     * Reads one register of the current device within the specified action
+     * environment.
+     *
+     * Uses the cached value of the register if it was read with an I2C block
+     * read.  See ActionEnvironment::cacheRegisters().
+     *
+     * Throws an exception if an error occurs.
+     *
+     * @param environment action execution environment
+     * @param reg register address
+     * @param value register value
+     */
+    void readRegister(ActionEnvironment& environment, uint8_t reg,
+                      uint8_t& value)
+    {
+        const uint8_t* cachedValue = environment.getCachedRegisters(reg, 1);
+        if (cachedValue != nullptr)
+        {
+            value = *cachedValue;
+            return;
+        }
+        getI2CInterface(environment).read(reg, value);
+    }
+
+    /**
+     * Reads consecutive registers of the current device within the specified
+     * action environment.
+     *
+     * Uses an I2C mode block read, where the number of bytes to read is
+     * explicitly specified.  Uses the cached values of the registers if they
+     * were read with an I2C block read.  See
+     * ActionEnvironment::cacheRegisters().
+     *
+     * Throws an exception if an error occurs.
+     *
+     * @param environment action execution environment
+     * @param reg first register address
+     * @param count number of registers
+     * @param values buffer that receives the register values; must hold at
+     *               least count bytes
+     */
+    void readRegisters(ActionEnvironment& environment, uint8_t reg,
+                       uint8_t count, uint8_t* values)
+    {
+        const uint8_t* cachedValues =
+            environment.getCachedRegisters(reg, count);
+        if (cachedValues != nullptr)
+        {
+            std::copy_n(cachedValues, count, values);
+            return;
+        }
+        uint8_t size{count}; // byte count parameter is input/output
+        getI2CInterface(environment)
+            .read(reg, size, values, i2c::I2CInterface::Mode::I2C);
+    }
+
+    /**
+     * Reads consecutive registers of the current device within the specified
+     * action environment using a large read.
+     *
+     * Unlike readRegisters(), the number of bytes is not limited to the 32
+     * bytes of an SMBus block read.  See I2CInterface::readLarge().  Uses the
+     * cached values of the registers if they were read with an I2C block read.
+     *
+     * Throws an exception if an error occurs.
+     *
+     * @param environment action execution environment
+     * @param reg first register address
+     * @param count number of registers
+     * @param values buffer that receives the register values; must hold at
+     *               least count bytes
+     */
+    void readLargeRegisters(ActionEnvironment& environment, uint8_t reg,
+                            uint8_t count, uint8_t* values)
+    {
+        const uint8_t* cachedValues =
+            environment.getCachedRegisters(reg, count);
+        if (cachedValues != nullptr)
+        {
+            std::copy_n(cachedValues, count, values);
+            return;
+        }
+        getI2CInterface(environment)
+            .readLarge(reg, std::span<uint8_t>{values, count});
+    }
 };
 
 } // namespace phosphor::power::regulators
@@ -30,12 +30,16 @@ bool I2CCaptureBytesAction::execute(ActionEnvironment& environment)
 {
     try
     {
-        // Read device register values.  Use I2C mode where the number of bytes
-        // to read is explicitly specified.
-        i2c::I2CInterface& interface = getI2CInterface(environment);
-        uint8_t size{count}; // byte count parameter is input/output
+        // Read device register values
         uint8_t values[UINT8_MAX];
-        interface.read(reg, size, values, i2c::I2CInterface::Mode::I2C);
+        if (isLargeRead)
+        {
+            readLargeRegisters(environment, reg, count, values);
+        }
+        else
+        {
+            readRegisters(environment, reg, count, values);
+        }
 
         // Store error data in action environment as a string key/value pair
         std::string key = getErrorDataKey(environment);
@@ -56,7 +60,12 @@ std::string I2CCaptureBytesAction::toString() const
     std::ostringstream ss;
     ss << "i2c_capture_bytes: { register: 0x" << std::hex << std::uppercase
        << static_cast<uint16_t>(reg) << ", count: " << std::dec
-       << static_cast<uint16_t>(count) << " }";
+       << static_cast<uint16_t>(count);
+    if (isLargeRead)
+    {
+        ss << ", large_read: true";
+    }
+    ss << " }";
     return ss.str();
 }
 
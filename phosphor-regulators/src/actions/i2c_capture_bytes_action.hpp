@@ -52,9 +52,13 @@ class I2CCaptureBytesAction : public I2CAction
      * @param reg Device register address.  Note: named 'reg' because 'register'
      *            is a reserved keyword.
      * @param count Number of bytes to read from the device register.
+     * @param isLargeRead Specifies whether to read the bytes with a large
+     *                    read, which is not limited to the 32 bytes of an
+     *                    SMBus block read.
      */
-    explicit I2CCaptureBytesAction(uint8_t reg, uint8_t count) :
-        reg{reg}, count{count}
+    explicit I2CCaptureBytesAction(uint8_t reg, uint8_t count,
+                                   bool isLargeRead = false) :
+        reg{reg}, count{count}, isLargeRead{isLargeRead}
     {
         if (count < 1)
         {
@@ -69,7 +73,8 @@ class I2CCaptureBytesAction : public I2CAction
      * The resulting values are stored as additional error data in the specified
      * action environment.
      *
-     * All of the bytes will be read in a single I2C operation.
+     * All of the bytes will be read in a single I2C operation.  If this is a
+     * large read, the bytes are read with I2CInterface::readLarge().
      *
      * The device register was specified in the constructor.
      *
@@ -92,6 +97,16 @@ class I2CCaptureBytesAction : public I2CAction
         return count;
     }
 
+    /**
+     * Returns whether the bytes are read with a large read.
+     *
+     * @return true if a large read is used, false otherwise
+     */
+    bool getIsLargeRead() const
+    {
+        return isLargeRead;
+    }
+
     /**
      * Returns the device register address.
      *
@@ -139,6 +154,11 @@ class I2CCaptureBytesAction : public I2CAction
      * Number of bytes to read from the device register.
      */
     const uint8_t count;
+
+    /**
+     * Specifies whether the bytes are read with a large read.
+     */
+    const bool isLargeRead;
 };
 
 } // namespace phosphor::power::regulators
@@ -33,8 +33,7 @@ bool I2CCompareBitAction::execute(ActionEnvironment& environment)
     {
         // Read actual value of device register
         uint8_t registerValue{0x00};
-        i2c::I2CInterface& interface = getI2CInterface(environment);
-        interface.read(reg, registerValue);
+        readRegister(environment, reg, registerValue);
 
         // Get actual bit value
         uint8_t actualValue = (registerValue >> position) & 0x01;
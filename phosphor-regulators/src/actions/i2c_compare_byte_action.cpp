@@ -33,8 +33,7 @@ bool I2CCompareByteAction::execute(ActionEnvironment& environment)
     {
         // Read actual value of device register
         uint8_t actualValue{0x00};
-        i2c::I2CInterface& interface = getI2CInterface(environment);
-        interface.read(reg, actualValue);
+        readRegister(environment, reg, actualValue);
 
         // Modify actual value to only include bits specified in the mask
         actualValue &= mask;
@@ -31,12 +31,10 @@ bool I2CCompareBytesAction::execute(ActionEnvironment& environment)
     bool isEqual{true};
     try
     {
-        // Read actual device register values.  Use I2C mode where the number of
-        // bytes to read is explicitly specified.
-        i2c::I2CInterface& interface = getI2CInterface(environment);
-        uint8_t size = values.size();
+        // Read actual device register values
         uint8_t actualValues[UINT8_MAX];
-        interface.read(reg, size, actualValues, i2c::I2CInterface::Mode::I2C);
+        readRegisters(environment, reg, static_cast<uint8_t>(values.size()),
+                      actualValues);
 
         // Compare actual byte values to expected byte values
         for (unsigned int i = 0; i < values.size(); ++i)
@@ -0,0 +1,65 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "i2c_probe_action.hpp"
+
+#include "action_error.hpp"
+#include "i2c_interface.hpp"
+
+#include <cstdint>
+#include <exception>
+
+namespace phosphor::power::regulators
+{
+
+bool I2CProbeAction::execute(ActionEnvironment& environment)
+{
+    try
+    {
+        i2c::I2CInterface& interface = getI2CInterface(environment);
+        if (method == Method::quick)
+        {
+            interface.writeQuick();
+        }
+        else
+        {
+            uint8_t data{0x00};
+            interface.read(data);
+        }
+    }
+    catch (const i2c::I2CException& e)
+    {
+        // A failed transfer means the device did not respond.  Other errors,
+        // such as an unsupported probe method, have no error number.
+        if (e.errorCode != 0)
+        {
+            return false;
+        }
+
+        // Nest I2CException within an ActionError so caller will have both the
+        // low level I2C error information and the action information
+        std::throw_with_nested(ActionError(*this));
+    }
+    return true;
+}
+
+std::string I2CProbeAction::toString() const
+{
+    return std::string{"i2c_probe: { method: "} +
+           ((method == Method::quick) ? "quick" : "read_byte") + " }";
+}
+
+} // namespace phosphor::power::regulators
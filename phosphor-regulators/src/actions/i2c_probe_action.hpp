@@ -0,0 +1,114 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "action_environment.hpp"
+#include "i2c_action.hpp"
+
+#include <string>
+
+namespace phosphor::power::regulators
+{
+
+/**
+ * @class I2CProbeAction
+ *
+ * Probes a device to find whether it is present.  Communicates with the device
+ * directly using the I2C interface.
+ *
+ * The device is present if it acknowledges an SMBus quick command or an SMBus
+ * receive byte, depending on the probe method.  No register is read or
+ * written.
+ *
+ * Implements the i2c_probe action in the JSON config file.
+ */
+class I2CProbeAction : public I2CAction
+{
+  public:
+    /**
+     * Probe method.
+     */
+    enum class Method
+    {
+        /**
+         * SMBus quick command.  Only sends the device address.
+         */
+        quick,
+
+        /**
+         * SMBus receive byte.  Reads one byte without a register address.
+         */
+        readByte
+    };
+
+    // Specify which compiler-generated methods we want
+    I2CProbeAction(const I2CProbeAction&) = delete;
+    I2CProbeAction(I2CProbeAction&&) = delete;
+    I2CProbeAction& operator=(const I2CProbeAction&) = delete;
+    I2CProbeAction& operator=(I2CProbeAction&&) = delete;
+    virtual ~I2CProbeAction() = default;
+
+    /**
+     * Constructor.
+     *
+     * @param method Probe method.  If not specified, defaults to a receive
+     *               byte, which some devices accept more safely than a quick
+     *               command.
+     */
+    explicit I2CProbeAction(Method method = Method::readByte) : method{method}
+    {}
+
+    /**
+     * Executes this action.
+     *
+     * Probes the device using the I2C interface.  The probe method was
+     * specified in the constructor.
+     *
+     * The device is obtained from the specified action environment.
+     *
+     * Throws an exception if the probe cannot be done, such as if the I2C
+     * adapter does not support the probe method.
+     *
+     * @param environment action execution environment
+     * @return true if the device responded, otherwise returns false.
+     */
+    virtual bool execute(ActionEnvironment& environment) override;
+
+    /**
+     * Returns the probe method.
+     *
+     * @return probe method
+     */
+    Method getMethod() const
+    {
+        return method;
+    }
+
+    /**
+     * Returns a string description of this action.
+     *
+     * @return description of action
+     */
+    virtual std::string toString() const override;
+
+  private:
+    /**
+     * Probe method.
+     */
+    const Method method{Method::readByte};
+};
+
+} // namespace phosphor::power::regulators
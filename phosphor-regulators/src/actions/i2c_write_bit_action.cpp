@@ -30,10 +30,14 @@ bool I2CWriteBitAction::execute(ActionEnvironment& environment)
 {
     try
     {
-        // Read value of device register
+        // Read value of device register unless its shadow copy is known
+        Device& device = environment.getDevice();
         uint8_t registerValue{0x00};
         i2c::I2CInterface& interface = getI2CInterface(environment);
-        interface.read(reg, registerValue);
+        if (!device.getShadowRegisters(reg, {&registerValue, 1}))
+        {
+            interface.read(reg, registerValue);
+        }
 
         // Write bit to register value
         if (value == 0)
@@ -49,9 +53,14 @@ bool I2CWriteBitAction::execute(ActionEnvironment& environment)
 
         // Write modified value to device register
         interface.write(reg, registerValue);
+        device.registerWritten(reg);
+        device.updateShadowRegisters(reg, {&registerValue, 1});
     }
     catch (const i2c::I2CException& e)
     {
+        // Register may have been written before the error occurred
+        environment.getDevice().registerWritten(reg);
+
         // Nest I2CException within an ActionError so caller will have both the
         // low level I2C error information and the action information
         std::throw_with_nested(ActionError(*this));
@@ -18,6 +18,7 @@
 
 #include "action_error.hpp"
 #include "i2c_interface.hpp"
+#include "pmbus_utils.hpp"
 
 #include <exception>
 #include <ios>
@@ -30,6 +31,15 @@ bool I2CWriteByteAction::execute(ActionEnvironment& environment)
 {
     try
     {
+        // Skip writing the PMBus PAGE command if the page is already selected
+        Device& device = environment.getDevice();
+        if ((reg == pmbus_utils::PAGE) && (mask == 0xFF) &&
+            (device.getCurrentPage() == value))
+        {
+            device.pageSelected(value);
+            return true;
+        }
+
         i2c::I2CInterface& interface = getI2CInterface(environment);
         uint8_t valueToWrite;
         if (mask == 0xFF)
@@ -38,9 +48,13 @@ bool I2CWriteByteAction::execute(ActionEnvironment& environment)
         }
         else
         {
-            // Read current value of device register
+            // Read current value of device register unless its shadow copy
+            // is known
             uint8_t currentValue{0x00};
-            interface.read(reg, currentValue);
+            if (!device.getShadowRegisters(reg, {&currentValue, 1}))
+            {
+                interface.read(reg, currentValue);
+            }
 
             // Combine value to write with current value
             valueToWrite = (value & mask) | (currentValue & (~mask));
@@ -48,9 +62,18 @@ bool I2CWriteByteAction::execute(ActionEnvironment& environment)
 
         // Write value to device register
         interface.write(reg, valueToWrite);
+        device.registerWritten(reg);
+        device.updateShadowRegisters(reg, {&valueToWrite, 1});
+        if (reg == pmbus_utils::PAGE)
+        {
+            device.pageSelected(valueToWrite);
+        }
     }
     catch (const i2c::I2CException& e)
     {
+        // Register may have been written before the error occurred
+        environment.getDevice().registerWritten(reg);
+
         // Nest I2CException within an ActionError so caller will have both the
         // low level I2C error information and the action information
         std::throw_with_nested(ActionError(*this));
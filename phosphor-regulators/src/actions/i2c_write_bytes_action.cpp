@@ -30,6 +30,7 @@ bool I2CWriteBytesAction::execute(ActionEnvironment& environment)
 {
     try
     {
+        Device& device = environment.getDevice();
         i2c::I2CInterface& interface = getI2CInterface(environment);
         uint8_t valuesToWrite[UINT8_MAX];
         if (masks.size() == 0)
@@ -41,12 +42,16 @@ bool I2CWriteBytesAction::execute(ActionEnvironment& environment)
         }
         else
         {
-            // Read current device register values.  Use I2C mode where the
-            // number of bytes to read is explicitly specified.
+            // Read current device register values unless their shadow copy
+            // is known.  Use I2C mode where the number of bytes to read is
+            // explicitly specified.
             uint8_t size = values.size();
             uint8_t currentValues[UINT8_MAX];
-            interface.read(reg, size, currentValues,
-                           i2c::I2CInterface::Mode::I2C);
+            if (!device.getShadowRegisters(reg, {currentValues, size}))
+            {
+                interface.read(reg, size, currentValues,
+                               i2c::I2CInterface::Mode::I2C);
+            }
 
             // Combine values to write with current values
             for (unsigned int i = 0; i < values.size(); ++i)
@@ -59,9 +64,14 @@ bool I2CWriteBytesAction::execute(ActionEnvironment& environment)
         // Write values to device register
         interface.write(reg, values.size(), valuesToWrite,
                         i2c::I2CInterface::Mode::I2C);
+        device.registerWritten(reg, values.size());
+        device.updateShadowRegisters(reg, {valuesToWrite, values.size()});
     }
     catch (const i2c::I2CException& e)
     {
+        // Registers may have been written before the error occurred
+        environment.getDevice().registerWritten(reg, values.size());
+
         // Nest I2CException within an ActionError so caller will have both the
         // low level I2C error information and the action information
         std::throw_with_nested(ActionError(*this));
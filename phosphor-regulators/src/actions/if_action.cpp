@@ -26,7 +26,7 @@ bool IfAction::execute(ActionEnvironment& environment)
     bool returnValue{true};
 
     // Execute condition action and check whether it returned true
-    if (conditionAction->execute(environment) == true)
+    if (action_utils::execute(*conditionAction, environment) == true)
     {
         // Condition was true; execute actions in "then" clause
         returnValue = action_utils::execute(thenActions, environment);
@@ -49,4 +49,17 @@ bool IfAction::execute(ActionEnvironment& environment)
     return returnValue;
 }
 
+void IfAction::link(const IDMap& idMap)
+{
+    conditionAction->link(idMap);
+    for (std::unique_ptr<Action>& action : thenActions)
+    {
+        action->link(idMap);
+    }
+    for (std::unique_ptr<Action>& action : elseActions)
+    {
+        action->link(idMap);
+    }
+}
+
 } // namespace phosphor::power::regulators
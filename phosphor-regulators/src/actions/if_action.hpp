@@ -126,6 +126,9 @@ class IfAction : public Action
         return elseActions;
     }
 
+    /** @copydoc Action::link() */
+    virtual void link(const IDMap& idMap) override;
+
     /**
      * Returns a string description of this action.
      *
@@ -17,6 +17,7 @@
 
 #include "action.hpp"
 #include "action_environment.hpp"
+#include "action_utils.hpp"
 
 #include <memory>
 #include <string>
@@ -66,7 +67,7 @@ class NotAction : public Action
      */
     virtual bool execute(ActionEnvironment& environment) override
     {
-        return !(action->execute(environment));
+        return !(action_utils::execute(*action, environment));
     }
 
     /**
@@ -79,6 +80,12 @@ class NotAction : public Action
         return action;
     }
 
+    /** @copydoc Action::link() */
+    virtual void link(const IDMap& idMap) override
+    {
+        action->link(idMap);
+    }
+
     /**
      * Returns a string description of this action.
      *
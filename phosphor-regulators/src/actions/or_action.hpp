@@ -17,6 +17,7 @@
 
 #include "action.hpp"
 #include "action_environment.hpp"
+#include "action_utils.hpp"
 
 #include <memory>
 #include <string>
@@ -75,7 +76,7 @@ class OrAction : public Action
         bool returnValue{false};
         for (std::unique_ptr<Action>& action : actions)
         {
-            if (action->execute(environment) == true)
+            if (action_utils::execute(*action, environment) == true)
             {
                 returnValue = true;
             }
@@ -93,6 +94,15 @@ class OrAction : public Action
         return actions;
     }
 
+    /** @copydoc Action::link() */
+    virtual void link(const IDMap& idMap) override
+    {
+        for (std::unique_ptr<Action>& action : actions)
+        {
+            action->link(idMap);
+        }
+    }
+
     /**
      * Returns a string description of this action.
      *
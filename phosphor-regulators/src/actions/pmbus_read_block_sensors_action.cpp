@@ -0,0 +1,173 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "pmbus_read_block_sensors_action.hpp"
+
+#include "action_error.hpp"
+#include "pmbus_error.hpp"
+
+#include <sdbusplus/exception.hpp>
+
+#include <cstddef>
+#include <chrono>
+#include <exception>
+#include <ios>
+#include <sstream>
+
+namespace phosphor::power::regulators
+{
+
+bool PMBusReadBlockSensorsAction::execute(ActionEnvironment& environment)
+{
+    try
+    {
+        // Get I2C interface to current device
+        i2c::I2CInterface& interface = getI2CInterface(environment);
+
+        // Read the block command.  The device returns the number of bytes.
+        uint8_t values[maxBlockSize]{};
+        uint8_t size{0};
+        auto readTime = std::chrono::steady_clock::now();
+        interface.read(command, size, values, i2c::I2CInterface::Mode::SMBUS);
+
+        // Decode each sensor value and publish it using the Sensors service
+        Sensors& sensorsService = environment.getServices().getSensors();
+        std::optional<int8_t> exponentValue{};
+        for (const Sensor& sensor : sensors)
+        {
+            if ((sensor.offset + sensor.size) > size)
+            {
+                throw PMBusError("Block command returned " +
+                                     std::to_string(size) + " bytes",
+                                 environment.getDeviceID(),
+                                 environment.getDevice().getFRU());
+            }
+
+            // Values are stored low byte first
+            uint16_t value = values[sensor.offset];
+            if (sensor.size == 2)
+            {
+                value |= static_cast<uint16_t>(values[sensor.offset + 1] << 8);
+            }
+
+            double sensorValue{0.0};
+            if (!sensor.format.has_value())
+            {
+                sensorValue = value * sensor.scale;
+            }
+            else if (sensor.format == pmbus_utils::SensorDataFormat::linear_11)
+            {
+                sensorValue = pmbus_utils::convertFromLinear(value);
+            }
+            else
+            {
+                if (!exponentValue.has_value())
+                {
+                    exponentValue = getExponentValue(environment);
+                }
+                sensorValue = pmbus_utils::convertFromVoutLinear(
+                    value, exponentValue.value());
+            }
+            sensorsService.setValue(sensor.type, sensorValue, readTime);
+
+            // Store sensor value so the caller can tell if it is changing
+            environment.addSensorValue(sensor.type, sensorValue);
+        }
+    }
+    // Nest the following exception types within an ActionError so the caller
+    // will have both the low level error information and the action information
+    catch (const i2c::I2CException& e)
+    {
+        std::throw_with_nested(ActionError(*this));
+    }
+    catch (const PMBusError& e)
+    {
+        std::throw_with_nested(ActionError(*this));
+    }
+    catch (const sdbusplus::exception_t& e)
+    {
+        std::throw_with_nested(ActionError(*this));
+    }
+    return true;
+}
+
+std::string PMBusReadBlockSensorsAction::toString() const
+{
+    std::ostringstream ss;
+    ss << "pmbus_read_block_sensors: { " << std::hex << std::uppercase;
+    ss << "command: 0x" << static_cast<uint16_t>(command) << ", " << std::dec
+       << std::nouppercase;
+    if (exponent.has_value())
+    {
+        ss << "exponent: " << static_cast<int16_t>(exponent.value()) << ", ";
+    }
+
+    ss << "sensors: [ ";
+    for (std::size_t i = 0; i < sensors.size(); ++i)
+    {
+        const Sensor& sensor = sensors[i];
+        if (i > 0)
+        {
+            ss << ", ";
+        }
+        ss << "{ type: " << sensors::toString(sensor.type)
+           << ", offset: " << static_cast<uint16_t>(sensor.offset);
+        if (sensor.format.has_value())
+        {
+            ss << ", format: " << pmbus_utils::toString(sensor.format.value());
+        }
+        else
+        {
+            ss << ", format: raw, size: " << static_cast<uint16_t>(sensor.size)
+               << ", scale: " << sensor.scale;
+        }
+        ss << " }";
+    }
+    ss << " ] }";
+
+    return ss.str();
+}
+
+int8_t PMBusReadBlockSensorsAction::getExponentValue(
+    ActionEnvironment& environment)
+{
+    // Check if an exponent value is defined for this action
+    if (exponent.has_value())
+    {
+        return exponent.value();
+    }
+
+    // Get value of the VOUT_MODE command.  The device caches the value, so it
+    // is only read once for all the sensors.
+    uint8_t voutModeValue = environment.getDevice().getVoutMode();
+
+    // Parse VOUT_MODE value to get data format and parameter value
+    pmbus_utils::VoutDataFormat format;
+    int8_t parameter;
+    pmbus_utils::parseVoutMode(voutModeValue, format, parameter);
+
+    // Verify format is linear; other formats not currently supported
+    if (format != pmbus_utils::VoutDataFormat::linear)
+    {
+        throw PMBusError("VOUT_MODE contains unsupported data format",
+                         environment.getDeviceID(),
+                         environment.getDevice().getFRU());
+    }
+
+    // Return parameter value; it contains the exponent when format is linear
+    return parameter;
+}
+
+} // namespace phosphor::power::regulators
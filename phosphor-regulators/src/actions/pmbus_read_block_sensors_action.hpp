@@ -0,0 +1,222 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "action_environment.hpp"
+#include "i2c_action.hpp"
+#include "i2c_interface.hpp"
+#include "pmbus_utils.hpp"
+#include "sensors.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace phosphor::power::regulators
+{
+
+/**
+ * @class PMBusReadBlockSensorsAction
+ *
+ * Reads several sensors for a PMBus regulator rail from one manufacturer-
+ * specific block command.  Communicates with the device directly using the
+ * I2C interface.
+ *
+ * Implements the pmbus_read_block_sensors action in the JSON config file.
+ *
+ * The command is read once using the SMBus Block Read protocol.  Each sensor
+ * value is decoded from a byte offset within the data returned by the device.
+ * Values are stored low byte first, the same as PMBus word commands.
+ *
+ * A sensor value can use the linear_11 or linear_16 data format, or can be a
+ * raw unsigned integer that is multiplied by a scale factor.  All the
+ * linear_16 sensors use the same exponent.  The exponent value can be
+ * specified in the constructor.  Otherwise the exponent value is obtained once
+ * from the PMBus VOUT_MODE command.
+ */
+class PMBusReadBlockSensorsAction : public I2CAction
+{
+  public:
+    /**
+     * Maximum number of bytes returned by an SMBus block command.
+     */
+    static constexpr uint8_t maxBlockSize{32};
+
+    /**
+     * One sensor decoded from the block data.
+     */
+    struct Sensor
+    {
+        /**
+         * Sensor type.
+         */
+        SensorType type{};
+
+        /**
+         * Offset of the sensor value within the block data.
+         */
+        uint8_t offset{};
+
+        /**
+         * Data format of the sensor value.  If not specified, the value is a
+         * raw unsigned integer that is multiplied by scale.
+         */
+        std::optional<pmbus_utils::SensorDataFormat> format{};
+
+        /**
+         * Number of bytes in the sensor value.  Must be 2 if format is
+         * specified, and 1 or 2 otherwise.
+         */
+        uint8_t size{2};
+
+        /**
+         * Scale factor for a raw sensor value.
+         */
+        double scale{1.0};
+    };
+
+    // Specify which compiler-generated methods we want
+    PMBusReadBlockSensorsAction() = delete;
+    PMBusReadBlockSensorsAction(const PMBusReadBlockSensorsAction&) = delete;
+    PMBusReadBlockSensorsAction(PMBusReadBlockSensorsAction&&) = delete;
+    PMBusReadBlockSensorsAction&
+        operator=(const PMBusReadBlockSensorsAction&) = delete;
+    PMBusReadBlockSensorsAction&
+        operator=(PMBusReadBlockSensorsAction&&) = delete;
+    virtual ~PMBusReadBlockSensorsAction() = default;
+
+    /**
+     * Constructor.
+     *
+     * Throws an exception if a sensor is invalid.
+     *
+     * @param command PMBus block command code.
+     * @param sensors Sensors to decode from the block data.
+     * @param exponent Exponent value for the linear_16 data format.
+     *                 Can be positive or negative. If not specified, the
+     *                 exponent value will be read from VOUT_MODE.
+     */
+    explicit PMBusReadBlockSensorsAction(uint8_t command,
+                                         std::vector<Sensor> sensors,
+                                         std::optional<int8_t> exponent) :
+        command{command},
+        sensors{std::move(sensors)}, exponent{exponent}
+    {
+        for (const Sensor& sensor : this->sensors)
+        {
+            if ((sensor.size < 1) || (sensor.size > 2) ||
+                (sensor.format.has_value() && (sensor.size != 2)))
+            {
+                throw std::invalid_argument{"Invalid sensor size: " +
+                                            std::to_string(sensor.size)};
+            }
+            if ((sensor.offset + sensor.size) > maxBlockSize)
+            {
+                throw std::invalid_argument{"Invalid sensor offset: " +
+                                            std::to_string(sensor.offset)};
+            }
+        }
+    }
+
+    /**
+     * Executes this action.
+     *
+     * Reads the block command using the I2C interface, decodes the sensor
+     * values, and publishes each value using the Sensors service.
+     *
+     * The device is obtained from the ActionEnvironment.
+     *
+     * Throws an exception if an error occurs, including when the device
+     * returns too few bytes for a sensor.
+     *
+     * @param environment Action execution environment.
+     * @return true
+     */
+    virtual bool execute(ActionEnvironment& environment) override;
+
+    /**
+     * Returns the PMBus block command code.
+     *
+     * @return command
+     */
+    uint8_t getCommand() const
+    {
+        return command;
+    }
+
+    /**
+     * Returns the optional exponent value for linear_16 data format.
+     *
+     * @return optional exponent value
+     */
+    std::optional<int8_t> getExponent() const
+    {
+        return exponent;
+    }
+
+    /**
+     * Returns the sensors to decode from the block data.
+     *
+     * @return sensors
+     */
+    const std::vector<Sensor>& getSensors() const
+    {
+        return sensors;
+    }
+
+    /**
+     * Returns a string description of this action.
+     *
+     * @return description of action
+     */
+    virtual std::string toString() const override;
+
+  private:
+    /**
+     * Gets the exponent value to use to convert a linear_16 format value to a
+     * decimal volts value.
+     *
+     * If an exponent value is defined for this action, that value is returned.
+     * Otherwise the VOUT_MODE value of the current device is used to obtain
+     * the exponent value.  The device caches the VOUT_MODE value.
+     *
+     * Throws an exception if an error occurs.
+     *
+     * @param environment action execution environment
+     * @return exponent value
+     */
+    int8_t getExponentValue(ActionEnvironment& environment);
+
+    /**
+     * PMBus block command code.
+     */
+    const uint8_t command{0x00};
+
+    /**
+     * Sensors to decode from the block data.
+     */
+    const std::vector<Sensor> sensors{};
+
+    /**
+     * Optional exponent value for linear_16 data format.
+     */
+    const std::optional<int8_t> exponent{};
+};
+
+} // namespace phosphor::power::regulators
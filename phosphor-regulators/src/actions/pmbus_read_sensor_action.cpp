@@ -21,8 +21,10 @@
 
 #include <sdbusplus/exception.hpp>
 
+#include <chrono>
 #include <exception>
 #include <ios>
+#include <optional>
 #include <sstream>
 
 namespace phosphor::power::regulators
@@ -35,10 +37,25 @@ bool PMBusReadSensorAction::execute(ActionEnvironment& environment)
         // Get I2C interface to current device
         i2c::I2CInterface& interface = getI2CInterface(environment);
 
-        // Read two byte value of PMBus command code.  I2CInterface method reads
-        // low byte first as required by PMBus.
+        // Use the value if another rail on the device already read it.
+        // Otherwise read two byte value of PMBus command code.  I2CInterface
+        // method reads low byte first as required by PMBus.
+        Device& device = environment.getDevice();
         uint16_t value{0x00};
-        interface.read(command, value);
+        std::chrono::steady_clock::time_point readTime{};
+        std::optional<Device::SensorReading> reading =
+            device.getSensorReading(command);
+        if (reading.has_value())
+        {
+            value = reading->value;
+            readTime = reading->readTime;
+        }
+        else
+        {
+            readTime = std::chrono::steady_clock::now();
+            interface.read(command, value);
+            device.addSensorReading(command, value, readTime);
+        }
 
         // Convert two byte PMBus value into a decimal sensor value
         double sensorValue{0.0};
@@ -48,14 +65,25 @@ bool PMBusReadSensorAction::execute(ActionEnvironment& environment)
                 sensorValue = pmbus_utils::convertFromLinear(value);
                 break;
             case pmbus_utils::SensorDataFormat::linear_16:
-                int8_t exponentValue = getExponentValue(environment, interface);
+                int8_t exponentValue = getExponentValue(environment);
                 sensorValue =
                     pmbus_utils::convertFromVoutLinear(value, exponentValue);
                 break;
         }
 
         // Publish sensor value using the Sensors service
-        environment.getServices().getSensors().setValue(type, sensorValue);
+        Sensors& sensors = environment.getServices().getSensors();
+        if (aggregation.has_value())
+        {
+            sensors.setAggregatedValue(type, sensorValue, aggregation.value());
+        }
+        else
+        {
+            sensors.setValue(type, sensorValue, readTime);
+        }
+
+        // Store sensor value so the caller can tell if it is changing
+        environment.addSensorValue(type, sensorValue);
     }
     // Nest the following exception types within an ActionError so the caller
     // will have both the low level error information and the action information
@@ -89,13 +117,20 @@ std::string PMBusReadSensorAction::toString() const
         ss << ", exponent: " << static_cast<int16_t>(exponent.value());
     }
 
+    if (aggregation.has_value())
+    {
+        ss << ", aggregation: { window_ms: "
+           << aggregation->window.count()
+           << ", statistic: " << sensors::toString(aggregation->statistic)
+           << " }";
+    }
+
     ss << " }";
 
     return ss.str();
 }
 
-int8_t PMBusReadSensorAction::getExponentValue(ActionEnvironment& environment,
-                                               i2c::I2CInterface& interface)
+int8_t PMBusReadSensorAction::getExponentValue(ActionEnvironment& environment)
 {
     // Check if an exponent value is defined for this action
     if (exponent.has_value())
@@ -103,9 +138,8 @@ int8_t PMBusReadSensorAction::getExponentValue(ActionEnvironment& environment,
         return exponent.value();
     }
 
-    // Read value of the VOUT_MODE command
-    uint8_t voutModeValue;
-    interface.read(pmbus_utils::VOUT_MODE, voutModeValue);
+    // Get value of the VOUT_MODE command.  The device caches the value.
+    uint8_t voutModeValue = environment.getDevice().getVoutMode();
 
     // Parse VOUT_MODE value to get data format and parameter value
     pmbus_utils::VoutDataFormat format;
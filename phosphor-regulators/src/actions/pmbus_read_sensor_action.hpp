@@ -43,6 +43,10 @@ namespace phosphor::power::regulators
  * obtained from the PMBus VOUT_MODE command.  Note that some PMBus devices do
  * not support the VOUT_MODE command.  The exponent value for a device is often
  * found in the device documentation (data sheet).
+ *
+ * By default the sensor value is published each time it is read.  If a
+ * SensorAggregation is specified, the values read during each aggregation
+ * window are combined and only the resulting statistic is published.
  */
 class PMBusReadSensorAction : public I2CAction
 {
@@ -65,12 +69,17 @@ class PMBusReadSensorAction : public I2CAction
      *                 Can be positive or negative. If not specified, the
      *                 exponent value will be read from VOUT_MODE.
      *                 Should not be specified if the data format is linear_11.
+     * @param aggregation Optional aggregation of the sensor values read during
+     *                    a time window.  If not specified, each sensor value
+     *                    is published when it is read.
      */
-    explicit PMBusReadSensorAction(SensorType type, uint8_t command,
-                                   pmbus_utils::SensorDataFormat format,
-                                   std::optional<int8_t> exponent) :
+    explicit PMBusReadSensorAction(
+        SensorType type, uint8_t command, pmbus_utils::SensorDataFormat format,
+        std::optional<int8_t> exponent,
+        std::optional<SensorAggregation> aggregation = std::nullopt) :
         type{type},
-        command{command}, format{format}, exponent{exponent}
+        command{command}, format{format}, exponent{exponent},
+        aggregation{aggregation}
     {}
 
     /**
@@ -100,6 +109,16 @@ class PMBusReadSensorAction : public I2CAction
      */
     virtual bool execute(ActionEnvironment& environment) override;
 
+    /**
+     * Returns the optional aggregation of the sensor values.
+     *
+     * @return optional sensor aggregation
+     */
+    const std::optional<SensorAggregation>& getAggregation() const
+    {
+        return aggregation;
+    }
+
     /**
      * Returns the PMBus command code.
      *
@@ -153,17 +172,15 @@ class PMBusReadSensorAction : public I2CAction
      * decimal volts value.
      *
      * If an exponent value is defined for this action, that value is returned.
-     * Otherwise VOUT_MODE is read from the current device to obtain the
-     * exponent value.
+     * Otherwise the VOUT_MODE value of the current device is used to obtain
+     * the exponent value.  The device caches the VOUT_MODE value.
      *
      * Throws an exception if an error occurs.
      *
      * @param environment action execution environment
-     * @param interface I2C interface to the current device
      * @return exponent value
      */
-    int8_t getExponentValue(ActionEnvironment& environment,
-                            i2c::I2CInterface& interface);
+    int8_t getExponentValue(ActionEnvironment& environment);
 
     /**
      * Sensor type.
@@ -184,6 +201,11 @@ class PMBusReadSensorAction : public I2CAction
      * Optional exponent value for linear_16 data format.
      */
     const std::optional<int8_t> exponent{};
+
+    /**
+     * Optional aggregation of the sensor values read during a time window.
+     */
+    const std::optional<SensorAggregation> aggregation{};
 };
 
 } // namespace phosphor::power::regulators
@@ -0,0 +1,244 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "pmbus_read_sensors_action.hpp"
+
+#include "action_error.hpp"
+#include "pmbus_error.hpp"
+
+#include <sdbusplus/exception.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <ios>
+#include <iterator>
+#include <optional>
+#include <sstream>
+
+namespace phosphor::power::regulators
+{
+
+bool PMBusReadSensorsAction::execute(ActionEnvironment& environment)
+{
+    Device& device = environment.getDevice();
+    bool isPageWritten{false};
+    try
+    {
+        // Get I2C interface to current device
+        i2c::I2CInterface& interface = getI2CInterface(environment);
+
+        // Select the page at the start of the transaction unless it is
+        // already selected.  The sensor readings of other rails are only
+        // valid if the page does not change.
+        using Operation = i2c::I2CInterface::Operation;
+        std::vector<Operation> operations{};
+        operations.reserve(sensors.size() + 1);
+        uint8_t pageValue = page.value_or(0x00);
+        isPageWritten = page.has_value() && (device.getCurrentPage() != page);
+        if (isPageWritten)
+        {
+            operations.push_back({false, pmbus_utils::PAGE, 1, &pageValue});
+        }
+        else if (page.has_value())
+        {
+            device.pageSelected(pageValue);
+        }
+
+        // Read each command once, unless another rail on the device already
+        // read it.  I2CInterface transfers words low byte first as required
+        // by PMBus.
+        std::vector<uint16_t> values(sensors.size());
+        std::vector<std::chrono::steady_clock::time_point> readTimes(
+            sensors.size());
+        std::vector<std::array<uint8_t, 2>> buffers(sensors.size());
+        std::vector<std::size_t> readIndexes(sensors.size(), sensors.size());
+        for (std::size_t i = 0; i < sensors.size(); ++i)
+        {
+            uint8_t command = sensors[i].command;
+            auto first = std::find_if(
+                sensors.begin(), sensors.begin() + i,
+                [command](const Sensor& other) {
+                    return other.command == command;
+                });
+            std::optional<Device::SensorReading> reading{};
+            if (!isPageWritten)
+            {
+                reading = device.getSensorReading(command);
+            }
+            if (first != sensors.begin() + i)
+            {
+                // Same command as a previous sensor; use its value
+                readIndexes[i] = static_cast<std::size_t>(
+                    std::distance(sensors.begin(), first));
+            }
+            else if (reading.has_value())
+            {
+                values[i] = reading->value;
+                readTimes[i] = reading->readTime;
+            }
+            else
+            {
+                readIndexes[i] = i;
+                operations.push_back({true, command, 2, buffers[i].data()});
+            }
+        }
+
+        // The commands are read in one transfer, so they share a read time
+        auto transferTime = std::chrono::steady_clock::now();
+        if (!operations.empty())
+        {
+            interface.transfer(operations);
+        }
+        if (isPageWritten)
+        {
+            device.registerWritten(pmbus_utils::PAGE);
+            device.pageSelected(pageValue);
+            isPageWritten = false;
+        }
+
+        // Store the values read so other rails on the device can use them
+        for (std::size_t i = 0; i < sensors.size(); ++i)
+        {
+            if (readIndexes[i] == i)
+            {
+                values[i] = static_cast<uint16_t>(buffers[i][0] |
+                                                  (buffers[i][1] << 8));
+                readTimes[i] = transferTime;
+                device.addSensorReading(sensors[i].command, values[i],
+                                        transferTime);
+            }
+            else if (readIndexes[i] < i)
+            {
+                values[i] = values[readIndexes[i]];
+                readTimes[i] = readTimes[readIndexes[i]];
+            }
+        }
+
+        // Convert each two byte PMBus value into a decimal sensor value and
+        // publish it using the Sensors service
+        Sensors& sensorsService = environment.getServices().getSensors();
+        std::optional<int8_t> exponentValue{};
+        for (std::size_t i = 0; i < sensors.size(); ++i)
+        {
+            const Sensor& sensor = sensors[i];
+            double sensorValue{0.0};
+            switch (sensor.format)
+            {
+                case pmbus_utils::SensorDataFormat::linear_11:
+                    sensorValue = pmbus_utils::convertFromLinear(values[i]);
+                    break;
+                case pmbus_utils::SensorDataFormat::linear_16:
+                    if (!exponentValue.has_value())
+                    {
+                        exponentValue = getExponentValue(environment);
+                    }
+                    sensorValue = pmbus_utils::convertFromVoutLinear(
+                        values[i], exponentValue.value());
+                    break;
+            }
+            sensorsService.setValue(sensor.type, sensorValue, readTimes[i]);
+
+            // Store sensor value so the caller can tell if it is changing
+            environment.addSensorValue(sensor.type, sensorValue);
+        }
+    }
+    // Nest the following exception types within an ActionError so the caller
+    // will have both the low level error information and the action information
+    catch (const i2c::I2CException& e)
+    {
+        // PAGE may have been written before the error occurred
+        if (isPageWritten)
+        {
+            device.registerWritten(pmbus_utils::PAGE);
+        }
+        std::throw_with_nested(ActionError(*this));
+    }
+    catch (const PMBusError& e)
+    {
+        std::throw_with_nested(ActionError(*this));
+    }
+    catch (const sdbusplus::exception_t& e)
+    {
+        std::throw_with_nested(ActionError(*this));
+    }
+    return true;
+}
+
+std::string PMBusReadSensorsAction::toString() const
+{
+    std::ostringstream ss;
+    ss << "pmbus_read_sensors: { " << std::hex << std::uppercase;
+    if (page.has_value())
+    {
+        ss << "page: 0x" << static_cast<uint16_t>(page.value()) << ", ";
+    }
+    ss << std::dec << std::nouppercase;
+    if (exponent.has_value())
+    {
+        ss << "exponent: " << static_cast<int16_t>(exponent.value()) << ", ";
+    }
+
+    ss << "sensors: [ ";
+    for (std::size_t i = 0; i < sensors.size(); ++i)
+    {
+        const Sensor& sensor = sensors[i];
+        if (i > 0)
+        {
+            ss << ", ";
+        }
+        ss << "{ type: " << sensors::toString(sensor.type) << ", "
+           << std::hex << std::uppercase;
+        ss << "command: 0x" << static_cast<uint16_t>(sensor.command) << ", "
+           << std::dec << std::nouppercase;
+        ss << "format: " << pmbus_utils::toString(sensor.format) << " }";
+    }
+    ss << " ] }";
+
+    return ss.str();
+}
+
+int8_t PMBusReadSensorsAction::getExponentValue(ActionEnvironment& environment)
+{
+    // Check if an exponent value is defined for this action
+    if (exponent.has_value())
+    {
+        return exponent.value();
+    }
+
+    // Get value of the VOUT_MODE command.  The device caches the value, so it
+    // is only read once for all the sensors.
+    uint8_t voutModeValue = environment.getDevice().getVoutMode();
+
+    // Parse VOUT_MODE value to get data format and parameter value
+    pmbus_utils::VoutDataFormat format;
+    int8_t parameter;
+    pmbus_utils::parseVoutMode(voutModeValue, format, parameter);
+
+    // Verify format is linear; other formats not currently supported
+    if (format != pmbus_utils::VoutDataFormat::linear)
+    {
+        throw PMBusError("VOUT_MODE contains unsupported data format",
+                         environment.getDeviceID(),
+                         environment.getDevice().getFRU());
+    }
+
+    // Return parameter value; it contains the exponent when format is linear
+    return parameter;
+}
+
+} // namespace phosphor::power::regulators
@@ -0,0 +1,188 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "action_environment.hpp"
+#include "i2c_action.hpp"
+#include "i2c_interface.hpp"
+#include "pmbus_utils.hpp"
+#include "sensors.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace phosphor::power::regulators
+{
+
+/**
+ * @class PMBusReadSensorsAction
+ *
+ * Reads several sensors for a PMBus regulator rail. Communicates with the
+ * device directly using the I2C interface.
+ *
+ * Implements the pmbus_read_sensors action in the JSON config file.
+ *
+ * The sensors are read in one combined I2C transaction.  If a page is
+ * specified, the PMBus PAGE command is written at the start of the same
+ * transaction, unless the page is already selected.  Sensor commands that
+ * another rail on the device already read on the same page are not read
+ * again.
+ *
+ * Supports the same sensor data formats as PMBusReadSensorAction.  All the
+ * linear_16 sensors use the same exponent.  The exponent value can be
+ * specified in the constructor.  Otherwise the exponent value is obtained once
+ * from the PMBus VOUT_MODE command.
+ *
+ * Each sensor value is published when it is read.
+ */
+class PMBusReadSensorsAction : public I2CAction
+{
+  public:
+    /**
+     * One sensor read by this action.
+     */
+    struct Sensor
+    {
+        /**
+         * Sensor type.
+         */
+        SensorType type{};
+
+        /**
+         * PMBus command code.
+         */
+        uint8_t command{};
+
+        /**
+         * Data format of the sensor value returned by the device.
+         */
+        pmbus_utils::SensorDataFormat format{};
+    };
+
+    // Specify which compiler-generated methods we want
+    PMBusReadSensorsAction() = delete;
+    PMBusReadSensorsAction(const PMBusReadSensorsAction&) = delete;
+    PMBusReadSensorsAction(PMBusReadSensorsAction&&) = delete;
+    PMBusReadSensorsAction& operator=(const PMBusReadSensorsAction&) = delete;
+    PMBusReadSensorsAction& operator=(PMBusReadSensorsAction&&) = delete;
+    virtual ~PMBusReadSensorsAction() = default;
+
+    /**
+     * Constructor.
+     *
+     * @param sensors Sensors to read.
+     * @param page Optional PMBus page to select before reading the sensors.
+     *             If not specified, the sensors are read from the currently
+     *             selected page.
+     * @param exponent Exponent value for the linear_16 data format.
+     *                 Can be positive or negative. If not specified, the
+     *                 exponent value will be read from VOUT_MODE.
+     */
+    explicit PMBusReadSensorsAction(std::vector<Sensor> sensors,
+                                    std::optional<uint8_t> page,
+                                    std::optional<int8_t> exponent) :
+        sensors{std::move(sensors)},
+        page{page}, exponent{exponent}
+    {}
+
+    /**
+     * Executes this action.
+     *
+     * Reads the sensors using the I2C interface and publishes each value
+     * using the Sensors service.
+     *
+     * The device is obtained from the ActionEnvironment.
+     *
+     * Throws an exception if an error occurs.
+     *
+     * @param environment Action execution environment.
+     * @return true
+     */
+    virtual bool execute(ActionEnvironment& environment) override;
+
+    /**
+     * Returns the optional exponent value for linear_16 data format.
+     *
+     * @return optional exponent value
+     */
+    std::optional<int8_t> getExponent() const
+    {
+        return exponent;
+    }
+
+    /**
+     * Returns the optional PMBus page to select.
+     *
+     * @return optional page
+     */
+    std::optional<uint8_t> getPage() const
+    {
+        return page;
+    }
+
+    /**
+     * Returns the sensors to read.
+     *
+     * @return sensors
+     */
+    const std::vector<Sensor>& getSensors() const
+    {
+        return sensors;
+    }
+
+    /**
+     * Returns a string description of this action.
+     *
+     * @return description of action
+     */
+    virtual std::string toString() const override;
+
+  private:
+    /**
+     * Gets the exponent value to use to convert a linear_16 format value to a
+     * decimal volts value.
+     *
+     * If an exponent value is defined for this action, that value is returned.
+     * Otherwise the VOUT_MODE value of the current device is used to obtain
+     * the exponent value.  The device caches the VOUT_MODE value.
+     *
+     * Throws an exception if an error occurs.
+     *
+     * @param environment action execution environment
+     * @return exponent value
+     */
+    int8_t getExponentValue(ActionEnvironment& environment);
+
+    /**
+     * Sensors to read.
+     */
+    const std::vector<Sensor> sensors{};
+
+    /**
+     * Optional PMBus page to select before reading the sensors.
+     */
+    const std::optional<uint8_t> page{};
+
+    /**
+     * Optional exponent value for linear_16 data format.
+     */
+    const std::optional<int8_t> exponent{};
+};
+
+} // namespace phosphor::power::regulators
@@ -38,7 +38,7 @@ bool PMBusWriteVoutCommandAction::execute(ActionEnvironment& environment)
         i2c::I2CInterface& interface = getI2CInterface(environment);
 
         // Get exponent value for converting volts value to linear format
-        int8_t exponentValue = getExponentValue(environment, interface);
+        int8_t exponentValue = getExponentValue(environment);
 
         // Convert volts value to linear data format
         uint16_t linearValue =
@@ -48,10 +48,21 @@ bool PMBusWriteVoutCommandAction::execute(ActionEnvironment& environment)
         // writes low-order byte first as required by PMBus.
         interface.write(pmbus_utils::VOUT_COMMAND, linearValue);
 
-        // Verify write if necessary
-        if (isWriteVerified)
+        // Verify write if necessary.  The verification can only be deferred
+        // if the page can be selected again before reading VOUT_COMMAND.
+        Device& device = environment.getDevice();
+        if (isWriteVerified && environment.isVerificationDeferred() &&
+            device.getCurrentPage().has_value())
         {
-            verifyWrite(environment, interface, linearValue);
+            uint8_t page = device.getCurrentPage().value();
+            environment.deferVerification(
+                [this, &device, &interface, page, linearValue]() {
+                    verifyDeferredWrite(device, interface, page, linearValue);
+                });
+        }
+        else if (isWriteVerified)
+        {
+            verifyWrite(device, interface, linearValue);
         }
     }
     // Nest the following exception types within an ActionError so the caller
@@ -93,7 +104,7 @@ std::string PMBusWriteVoutCommandAction::toString() const
 }
 
 int8_t PMBusWriteVoutCommandAction::getExponentValue(
-    ActionEnvironment& environment, i2c::I2CInterface& interface)
+    ActionEnvironment& environment)
 {
     // Check if an exponent value is defined for this action
     if (exponent.has_value())
@@ -101,9 +112,8 @@ int8_t PMBusWriteVoutCommandAction::getExponentValue(
         return exponent.value();
     }
 
-    // Read value of the VOUT_MODE command
-    uint8_t voutModeValue;
-    interface.read(pmbus_utils::VOUT_MODE, voutModeValue);
+    // Get value of the VOUT_MODE command.  The device caches the value.
+    uint8_t voutModeValue = environment.getDevice().getVoutMode();
 
     // Parse VOUT_MODE value to get data format and parameter value
     pmbus_utils::VoutDataFormat format;
@@ -145,7 +155,36 @@ double
     return voltsValue;
 }
 
-void PMBusWriteVoutCommandAction::verifyWrite(ActionEnvironment& environment,
+void PMBusWriteVoutCommandAction::verifyDeferredWrite(
+    Device& device, i2c::I2CInterface& interface, uint8_t page,
+    uint16_t valueWritten)
+{
+    try
+    {
+        // Select the page the value was written to, if not already selected
+        if (device.getCurrentPage() != page)
+        {
+            interface.write(pmbus_utils::PAGE, page);
+            device.registerWritten(pmbus_utils::PAGE);
+            device.pageSelected(page);
+        }
+
+        verifyWrite(device, interface, valueWritten);
+    }
+    // Report the error the same way as when the write is verified right away
+    catch (const i2c::I2CException& i2cError)
+    {
+        // Page may have been written before the error occurred
+        device.registerWritten(pmbus_utils::PAGE);
+        std::throw_with_nested(ActionError(*this));
+    }
+    catch (const WriteVerificationError& verifyError)
+    {
+        std::throw_with_nested(ActionError(*this));
+    }
+}
+
+void PMBusWriteVoutCommandAction::verifyWrite(const Device& device,
                                               i2c::I2CInterface& interface,
                                               uint16_t valueWritten)
 {
@@ -158,11 +197,10 @@ void PMBusWriteVoutCommandAction::verifyWrite(ActionEnvironment& environment,
     if (valueRead != valueWritten)
     {
         std::ostringstream ss;
-        ss << "device: " << environment.getDeviceID()
+        ss << "device: " << device.getID()
            << ", register: VOUT_COMMAND, value_written: 0x" << std::hex
            << std::uppercase << valueWritten << ", value_read: 0x" << valueRead;
-        throw WriteVerificationError(ss.str(), environment.getDeviceID(),
-                                     environment.getDevice().getFRU());
+        throw WriteVerificationError(ss.str(), device.getID(), device.getFRU());
     }
 }
 
@@ -60,6 +60,11 @@ namespace phosphor::power::regulators
  * the expected value.  If VOUT_COMMAND contains an unexpected value, a
  * WriteVerificationError is thrown.  To perform verification, the device must
  * return all 16 bits of voltage data that were written to VOUT_COMMAND.
+ *
+ * If the ActionEnvironment defers the write verifications of the device, and
+ * the PMBus page of the device is known, the verification is deferred until
+ * the writes of the operation are done.  See
+ * ActionEnvironment::setDeferredVerifications().
  */
 class PMBusWriteVoutCommandAction : public I2CAction
 {
@@ -184,17 +189,15 @@ class PMBusWriteVoutCommandAction : public I2CAction
      * format.
      *
      * If an exponent value is defined for this action, that value is returned.
-     * Otherwise VOUT_MODE is read from the current device to obtain the
-     * exponent value.
+     * Otherwise the VOUT_MODE value of the current device is used to obtain
+     * the exponent value.  The device caches the VOUT_MODE value.
      *
      * Throws an exception if an error occurs.
      *
      * @param environment action execution environment
-     * @param interface I2C interface to the current device
      * @return exponent value
      */
-    int8_t getExponentValue(ActionEnvironment& environment,
-                            i2c::I2CInterface& interface);
+    int8_t getExponentValue(ActionEnvironment& environment);
 
     /**
      * Gets the volts value to write to VOUT_COMMAND.
@@ -210,6 +213,22 @@ class PMBusWriteVoutCommandAction : public I2CAction
      */
     double getVoltsValue(ActionEnvironment& environment);
 
+    /**
+     * Verifies the value written to VOUT_COMMAND after the action has been
+     * executed.  Selects the page the value was written to and calls
+     * verifyWrite().
+     *
+     * Throws an ActionError with the nested exception if the values do not
+     * match or a communication error occurs.
+     *
+     * @param device device the value was written to
+     * @param interface I2C interface to the device
+     * @param page PMBus page the value was written to
+     * @param valueWritten linear format volts value written to VOUT_COMMAND
+     */
+    void verifyDeferredWrite(Device& device, i2c::I2CInterface& interface,
+                             uint8_t page, uint16_t valueWritten);
+
     /**
      * Verifies the value written to VOUT_COMMAND.  Reads the current value of
      * VOUT_COMMAND and ensures that it matches the value written.
@@ -217,12 +236,12 @@ class PMBusWriteVoutCommandAction : public I2CAction
      * Throws an exception if the values do not match or a communication error
      * occurs.
      *
-     * @param environment action execution environment
-     * @param interface I2C interface to the current device
+     * @param device device the value was written to
+     * @param interface I2C interface to the device
      * @param valueWritten linear format volts value written to VOUT_COMMAND
      */
-    void verifyWrite(ActionEnvironment& environment,
-                     i2c::I2CInterface& interface, uint16_t valueWritten);
+    void verifyWrite(const Device& device, i2c::I2CInterface& interface,
+                     uint16_t valueWritten);
 
     /**
      * Optional volts value to write.
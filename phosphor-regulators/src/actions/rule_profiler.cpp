@@ -0,0 +1,271 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "rule_profiler.hpp"
+
+#include "action.hpp"
+#include "action_environment.hpp"
+#include "device.hpp"
+#include "i2c_interface.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <utility>
+#include <vector>
+
+namespace phosphor::power::regulators
+{
+
+namespace
+{
+
+/**
+ * One action or rule on the call stack of a thread.
+ */
+struct Frame
+{
+    /**
+     * Name of the frame in the folded stacks.
+     */
+    std::string name;
+
+    /**
+     * Whether the frame is a rule rather than an action.
+     */
+    bool isRule;
+
+    /**
+     * Rule ID or action type.
+     */
+    std::string id;
+
+    /**
+     * Time when the execution started.
+     */
+    std::chrono::steady_clock::time_point start;
+
+    /**
+     * I2C interface of the current device, if any.  Only used by actions.
+     */
+    i2c::I2CInterface* interface{nullptr};
+
+    /**
+     * Transaction count of the I2C interface when the execution started.
+     */
+    uint64_t i2cStart{0};
+
+    /**
+     * Total time of the nested actions and rules.
+     */
+    std::chrono::microseconds childTime{0};
+
+    /**
+     * I2C transactions of the nested actions and rules.
+     */
+    uint64_t childI2CTransactions{0};
+
+    /**
+     * Whether any action or rule is nested in this one.
+     */
+    bool hasChildren{false};
+};
+
+/**
+ * Call stack of the actions and rules being profiled on this thread.
+ */
+thread_local std::vector<Frame> callStack{};
+
+} // namespace
+
+RuleProfiler::Scope::Scope(const Action& action, ActionEnvironment& environment)
+{
+    RuleProfiler& profiler = RuleProfiler::get();
+    if (!profiler.isEnabled())
+    {
+        return;
+    }
+
+    // Count the I2C transactions of the current device.  The device might
+    // not exist; an action that needs it will then fail.
+    i2c::I2CInterface* interface{nullptr};
+    try
+    {
+        interface = &(environment.getDevice().getI2CInterface());
+    }
+    catch (const std::exception&)
+    {}
+
+    std::string type = profiler.getActionType(action);
+    callStack.emplace_back(
+        Frame{type, false, type, std::chrono::steady_clock::now(), interface,
+              (interface != nullptr) ? interface->getTransactionCount() : 0});
+    active = true;
+}
+
+RuleProfiler::Scope::Scope(const std::string& ruleID)
+{
+    if (!RuleProfiler::get().isEnabled())
+    {
+        return;
+    }
+
+    callStack.emplace_back(Frame{"rule:" + ruleID, true, ruleID,
+                                 std::chrono::steady_clock::now()});
+    active = true;
+}
+
+RuleProfiler::Scope::~Scope()
+{
+    if (!active)
+    {
+        return;
+    }
+
+    Frame frame = std::move(callStack.back());
+    callStack.pop_back();
+
+    auto totalTime = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - frame.start);
+    auto selfTime = std::max(totalTime - frame.childTime,
+                             std::chrono::microseconds{0});
+
+    // The transactions of an action with nested actions are counted by the
+    // nested actions, since they might change the current device
+    uint64_t i2cTransactions = frame.childI2CTransactions;
+    if (!frame.hasChildren && (frame.interface != nullptr))
+    {
+        i2cTransactions +=
+            frame.interface->getTransactionCount() - frame.i2cStart;
+    }
+
+    std::string stack{};
+    for (const Frame& caller : callStack)
+    {
+        stack += caller.name;
+        stack += ';';
+    }
+    stack += frame.name;
+
+    if (!callStack.empty())
+    {
+        Frame& caller = callStack.back();
+        caller.childTime += totalTime;
+        caller.childI2CTransactions += i2cTransactions;
+        caller.hasChildren = true;
+    }
+
+    RuleProfiler::get().record(stack, frame.isRule, frame.id, totalTime,
+                               selfTime, i2cTransactions);
+}
+
+void RuleProfiler::enable(bool enable)
+{
+    enabled.store(enable, std::memory_order_relaxed);
+    if (!enable)
+    {
+        reset();
+    }
+}
+
+std::map<std::string, RuleProfiler::Statistics>
+    RuleProfiler::getActionStatistics() const
+{
+    std::lock_guard<std::mutex> lock{mutex};
+    return actionStatistics;
+}
+
+std::string RuleProfiler::getFoldedStacks() const
+{
+    std::lock_guard<std::mutex> lock{mutex};
+    std::string folded{};
+    for (const auto& [stack, selfTime] : stacks)
+    {
+        folded += stack + ' ' + std::to_string(selfTime.count()) + '\n';
+    }
+    return folded;
+}
+
+std::map<std::string, RuleProfiler::Statistics>
+    RuleProfiler::getRuleStatistics() const
+{
+    std::lock_guard<std::mutex> lock{mutex};
+    return ruleStatistics;
+}
+
+void RuleProfiler::reset()
+{
+    std::lock_guard<std::mutex> lock{mutex};
+    actionTypes.clear();
+    actionStatistics.clear();
+    ruleStatistics.clear();
+    stacks.clear();
+}
+
+std::string RuleProfiler::toString() const
+{
+    auto format = [](const std::string& name, const Statistics& stats) {
+        return name + ": calls: " + std::to_string(stats.calls) +
+               ", total: " + std::to_string(stats.totalTime.count()) +
+               " us, self: " + std::to_string(stats.selfTime.count()) +
+               " us, i2c: " + std::to_string(stats.i2cTransactions) + '\n';
+    };
+
+    std::lock_guard<std::mutex> lock{mutex};
+    std::string text{};
+    for (const auto& [ruleID, stats] : ruleStatistics)
+    {
+        text += format("rule " + ruleID, stats);
+    }
+    for (const auto& [type, stats] : actionStatistics)
+    {
+        text += format("action " + type, stats);
+    }
+    return text;
+}
+
+std::string RuleProfiler::getActionType(const Action& action)
+{
+    std::lock_guard<std::mutex> lock{mutex};
+    auto it = actionTypes.find(&action);
+    if (it == actionTypes.end())
+    {
+        // The description starts with the action type, such as
+        // "i2c_write_byte: { register: 0x7C, value: 0x18 }"
+        std::string description = action.toString();
+        it = actionTypes
+                 .emplace(&action, description.substr(0, description.find(':')))
+                 .first;
+    }
+    return it->second;
+}
+
+void RuleProfiler::record(const std::string& stack, bool isRule,
+                          const std::string& name,
+                          std::chrono::microseconds totalTime,
+                          std::chrono::microseconds selfTime,
+                          uint64_t i2cTransactions)
+{
+    std::lock_guard<std::mutex> lock{mutex};
+    Statistics& stats =
+        isRule ? ruleStatistics[name] : actionStatistics[name];
+    ++stats.calls;
+    stats.totalTime += totalTime;
+    stats.selfTime += selfTime;
+    stats.i2cTransactions += i2cTransactions;
+    stacks[stack] += selfTime;
+}
+
+} // namespace phosphor::power::regulators
@@ -0,0 +1,276 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace phosphor::power::regulators
+{
+
+// Forward declarations to avoid circular dependencies
+class Action;
+class ActionEnvironment;
+
+/**
+ * @class RuleProfiler
+ *
+ * Profiles the execution of rules and actions.
+ *
+ * While profiling is enabled, the number of calls, the total and self time,
+ * and the number of I2C transactions are accumulated for each rule ID and
+ * each action type.  The self time excludes the time spent in nested actions
+ * and rules.  The time spent in each call stack is also accumulated so it can
+ * be written in the folded stack format used by flame graph tools.
+ *
+ * Actions are profiled by action_utils::execute() and rules by RunRuleAction.
+ * While profiling is enabled, ActionProgram interprets the actions instead of
+ * executing its compiled instructions so the rules and actions are visible.
+ *
+ * There is one profiler per process.  Actions may be profiled on multiple
+ * threads at the same time; each thread has its own call stack.
+ */
+class RuleProfiler
+{
+  public:
+    // Specify which compiler-generated methods we want
+    RuleProfiler(const RuleProfiler&) = delete;
+    RuleProfiler(RuleProfiler&&) = delete;
+    RuleProfiler& operator=(const RuleProfiler&) = delete;
+    RuleProfiler& operator=(RuleProfiler&&) = delete;
+    ~RuleProfiler() = default;
+
+    /**
+     * @struct Statistics
+     *
+     * Accumulated statistics of a rule ID or action type.
+     */
+    struct Statistics
+    {
+        /**
+         * Number of times the rule or action was executed.
+         */
+        uint64_t calls{0};
+
+        /**
+         * Total time, including nested actions and rules.
+         */
+        std::chrono::microseconds totalTime{0};
+
+        /**
+         * Time excluding nested actions and rules.
+         */
+        std::chrono::microseconds selfTime{0};
+
+        /**
+         * Number of I2C transactions, including nested actions and rules.
+         */
+        uint64_t i2cTransactions{0};
+    };
+
+    /**
+     * @class Scope
+     *
+     * Profiles one execution of an action or rule.  Records the time and I2C
+     * transactions from construction until destruction.
+     *
+     * Does nothing if profiling was not enabled when constructed.
+     */
+    class Scope
+    {
+      public:
+        // Specify which compiler-generated methods we want
+        Scope() = delete;
+        Scope(const Scope&) = delete;
+        Scope(Scope&&) = delete;
+        Scope& operator=(const Scope&) = delete;
+        Scope& operator=(Scope&&) = delete;
+
+        /**
+         * Constructor.  Starts profiling an action.
+         *
+         * The I2C transactions are counted on the current device in the
+         * environment.
+         *
+         * @param action action being executed
+         * @param environment action execution environment
+         */
+        Scope(const Action& action, ActionEnvironment& environment);
+
+        /**
+         * Constructor.  Starts profiling a rule.
+         *
+         * @param ruleID rule ID
+         */
+        explicit Scope(const std::string& ruleID);
+
+        /**
+         * Destructor.  Records the execution.
+         */
+        ~Scope();
+
+      private:
+        /**
+         * Whether this scope is on the call stack of the current thread.
+         */
+        bool active{false};
+    };
+
+    /**
+     * Returns the profiler of this process.
+     *
+     * @return profiler
+     */
+    static RuleProfiler& get()
+    {
+        static RuleProfiler profiler;
+        return profiler;
+    }
+
+    /**
+     * Enables or disables profiling.
+     *
+     * The statistics are discarded when disabled.
+     *
+     * @param enable true to enable profiling, false to disable it
+     */
+    void enable(bool enable);
+
+    /**
+     * Returns the statistics of each action type.
+     *
+     * The action type is the name used in the JSON config file, such as
+     * i2c_write_byte.
+     *
+     * @return statistics by action type
+     */
+    std::map<std::string, Statistics> getActionStatistics() const;
+
+    /**
+     * Returns the accumulated self time of each call stack in the folded stack
+     * format.
+     *
+     * Each line contains the frames of one call stack separated by
+     * semicolons, followed by a space and the self time in microseconds.
+     * Rule frames are written as rule:<rule ID> and action frames as the
+     * action type.
+     *
+     * @return folded stacks text
+     */
+    std::string getFoldedStacks() const;
+
+    /**
+     * Returns the statistics of each rule ID.
+     *
+     * @return statistics by rule ID
+     */
+    std::map<std::string, Statistics> getRuleStatistics() const;
+
+    /**
+     * Returns whether profiling is enabled.
+     *
+     * @return true if enabled, false otherwise
+     */
+    bool isEnabled() const
+    {
+        return enabled.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Discards the statistics.
+     *
+     * Should be called when the actions and rules are deleted, such as when
+     * the config file is reloaded.
+     */
+    void reset();
+
+    /**
+     * Returns the rule and action statistics as text.
+     *
+     * Each rule and action type is listed on one line.
+     *
+     * @return statistics text
+     */
+    std::string toString() const;
+
+  private:
+    /**
+     * Constructor.
+     */
+    RuleProfiler() = default;
+
+    /**
+     * Returns the type of the specified action.
+     *
+     * The type is obtained from the description of the action the first time
+     * the action is profiled.
+     *
+     * @param action action being executed
+     * @return action type
+     */
+    std::string getActionType(const Action& action);
+
+    /**
+     * Records one execution of an action or rule.
+     *
+     * @param stack frames of the call stack, ending with the executed one
+     * @param isRule true if a rule was executed, false if an action was
+     * @param name rule ID or action type
+     * @param totalTime total time of the execution
+     * @param selfTime time excluding nested actions and rules
+     * @param i2cTransactions number of I2C transactions
+     */
+    void record(const std::string& stack, bool isRule, const std::string& name,
+                std::chrono::microseconds totalTime,
+                std::chrono::microseconds selfTime, uint64_t i2cTransactions);
+
+    /**
+     * Whether profiling is enabled.
+     */
+    std::atomic<bool> enabled{false};
+
+    /**
+     * Serializes access to the statistics from multiple threads.
+     */
+    mutable std::mutex mutex{};
+
+    /**
+     * Type of each action that has been profiled.
+     */
+    std::unordered_map<const Action*, std::string> actionTypes{};
+
+    /**
+     * Statistics by action type.
+     */
+    std::map<std::string, Statistics> actionStatistics{};
+
+    /**
+     * Statistics by rule ID.
+     */
+    std::map<std::string, Statistics> ruleStatistics{};
+
+    /**
+     * Self time by folded call stack.
+     */
+    std::map<std::string, std::chrono::microseconds> stacks{};
+};
+
+} // namespace phosphor::power::regulators
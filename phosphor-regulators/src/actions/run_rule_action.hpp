@@ -18,7 +18,9 @@
 #include "action.hpp"
 #include "action_environment.hpp"
 #include "rule.hpp"
+#include "rule_profiler.hpp"
 
+#include <stdexcept>
 #include <string>
 
 namespace phosphor::power::regulators
@@ -69,8 +71,12 @@ class RunRuleAction : public Action
         // depth is used to detect infinite recursion.
         environment.incrementRuleDepth(ruleID);
 
-        // Execute rule
-        bool returnValue = environment.getRule(ruleID).execute(environment);
+        // Execute rule.  Use linked rule if available to avoid a lookup.  The
+        // rule is profiled if rule profiling is enabled.
+        Rule& ruleToRun =
+            (rule != nullptr) ? *rule : environment.getRule(ruleID);
+        RuleProfiler::Scope profilerScope{ruleID};
+        bool returnValue = ruleToRun.execute(environment);
 
         // Decrement rule depth since rule has returned
         environment.decrementRuleDepth();
@@ -88,6 +94,26 @@ class RunRuleAction : public Action
         return ruleID;
     }
 
+    /**
+     * Stores a pointer to the rule with the ID specified in the constructor.
+     *
+     * The rule is not linked if it cannot be found.
+     *
+     * @param idMap mapping from IDs to the associated Device/Rule objects
+     */
+    virtual void link(const IDMap& idMap) override
+    {
+        try
+        {
+            rule = &(idMap.getRule(ruleID));
+        }
+        catch (const std::invalid_argument&)
+        {
+            // Rule not found; error will occur when action is executed
+            rule = nullptr;
+        }
+    }
+
     /**
      * Returns a string description of this action.
      *
@@ -103,6 +129,11 @@ class RunRuleAction : public Action
      * Rule ID.
      */
     const std::string ruleID{};
+
+    /**
+     * Rule with the rule ID, if linked.  Does not own the object.
+     */
+    Rule* rule{nullptr};
 };
 
 } // namespace phosphor::power::regulators
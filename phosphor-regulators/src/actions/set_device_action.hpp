@@ -17,7 +17,9 @@
 
 #include "action.hpp"
 #include "action_environment.hpp"
+#include "symbol.hpp"
 
+#include <stdexcept>
 #include <string>
 
 namespace phosphor::power::regulators
@@ -60,7 +62,15 @@ class SetDeviceAction : public Action
      */
     virtual bool execute(ActionEnvironment& environment) override
     {
-        environment.setDeviceID(deviceID);
+        // Use linked device if available to avoid a lookup
+        if (device != nullptr)
+        {
+            environment.setDeviceID(deviceID, *device);
+        }
+        else
+        {
+            environment.setDeviceID(deviceID);
+        }
         return true;
     }
 
@@ -71,7 +81,27 @@ class SetDeviceAction : public Action
      */
     const std::string& getDeviceID() const
     {
-        return deviceID;
+        return deviceID.str();
+    }
+
+    /**
+     * Stores a pointer to the device with the ID specified in the constructor.
+     *
+     * The device is not linked if it cannot be found.
+     *
+     * @param idMap mapping from IDs to the associated Device/Rule objects
+     */
+    virtual void link(const IDMap& idMap) override
+    {
+        try
+        {
+            device = &(idMap.getDevice(deviceID));
+        }
+        catch (const std::invalid_argument&)
+        {
+            // Device not found; error will occur when device is used
+            device = nullptr;
+        }
     }
 
     /**
@@ -81,14 +111,19 @@ class SetDeviceAction : public Action
      */
     virtual std::string toString() const override
     {
-        return "set_device: " + deviceID;
+        return "set_device: " + deviceID.str();
     }
 
   private:
     /**
      * Device ID.
      */
-    const std::string deviceID{};
+    const Symbol deviceID;
+
+    /**
+     * Device with the device ID, if linked.  Does not own the object.
+     */
+    Device* device{nullptr};
 };
 
 } // namespace phosphor::power::regulators
@@ -0,0 +1,468 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "bus_usage.hpp"
+
+#include "action_environment.hpp"
+#include "and_action.hpp"
+#include "bus_budget.hpp"
+#include "chassis.hpp"
+#include "device.hpp"
+#include "enable_detection.hpp"
+#include "i2c_capture_bytes_action.hpp"
+#include "i2c_compare_bit_action.hpp"
+#include "i2c_compare_byte_action.hpp"
+#include "i2c_compare_bytes_action.hpp"
+#include "i2c_probe_action.hpp"
+#include "i2c_write_bit_action.hpp"
+#include "i2c_write_byte_action.hpp"
+#include "i2c_write_bytes_action.hpp"
+#include "if_action.hpp"
+#include "not_action.hpp"
+#include "or_action.hpp"
+#include "phase_fault_detection.hpp"
+#include "pmbus_read_block_sensors_action.hpp"
+#include "pmbus_read_sensor_action.hpp"
+#include "pmbus_read_sensors_action.hpp"
+#include "pmbus_utils.hpp"
+#include "pmbus_write_vout_command_action.hpp"
+#include "presence_detection.hpp"
+#include "rail.hpp"
+#include "rule.hpp"
+#include "run_rule_action.hpp"
+#include "sensor_monitoring.hpp"
+#include "set_device_action.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+namespace phosphor::power::regulators::bus_usage
+{
+
+/**
+ * Usage of reading a byte register, such as VOUT_MODE.
+ */
+constexpr Usage readByteUsage{1.0, 2.0};
+
+/**
+ * Usage of writing a byte register.
+ */
+constexpr Usage writeByteUsage{1.0, 2.0};
+
+/**
+ * Usage of probing a device with a quick command, which transfers no data.
+ */
+constexpr Usage quickUsage{1.0, 0.0};
+
+/**
+ * Usage of probing a device by receiving a byte without a register address.
+ */
+constexpr Usage receiveByteUsage{1.0, 1.0};
+
+/**
+ * Usage of reading or writing a word register.
+ */
+constexpr Usage wordUsage{1.0, 3.0};
+
+/**
+ * Returns the usage of reading or writing the specified number of bytes
+ * starting at a register.
+ */
+static Usage getBytesUsage(std::size_t count)
+{
+    return Usage{1.0, 1.0 + static_cast<double>(count)};
+}
+
+/**
+ * Adds the usage of each device in the specified map, multiplied by the
+ * specified factor, to the usage of each device in another map.
+ */
+static void addScaled(const DeviceUsageMap& from, double factor,
+                      DeviceUsageMap& to)
+{
+    for (const auto& [deviceID, usage] : from)
+    {
+        Usage& total = to[deviceID];
+        total.transactions += usage.transactions * factor;
+        total.bytes += usage.bytes * factor;
+    }
+}
+
+Report analyze(const System& system,
+               std::chrono::milliseconds phaseFaultInterval)
+{
+    // Usage of each activity, by device ID
+    DeviceUsageMap sensorMonitoring{};
+    DeviceUsageMap phaseFaultDetection{};
+    DeviceUsageMap presenceDetection{};
+    DeviceUsageMap perSecond{};
+
+    for (const std::unique_ptr<Chassis>& chassis : system.getChassis())
+    {
+        for (const std::unique_ptr<Device>& device : chassis->getDevices())
+        {
+            const std::string& deviceID = device->getID();
+            if (device->getPresenceDetection())
+            {
+                addScaled(internal::getUsage(
+                              device->getPresenceDetection()->getActions(),
+                              system, deviceID),
+                          1.0, presenceDetection);
+            }
+
+            // Phase faults are detected with the specified device, if any
+            if (device->getPhaseFaultDetection())
+            {
+                const PhaseFaultDetection& detection =
+                    *(device->getPhaseFaultDetection());
+                DeviceUsageMap usage = internal::getUsage(
+                    detection.getActions(), system,
+                    detection.getDeviceID().empty() ? deviceID
+                                                    : detection.getDeviceID());
+                addScaled(usage, 1.0, phaseFaultDetection);
+                if (phaseFaultInterval.count() > 0)
+                {
+                    addScaled(usage, 1000.0 / phaseFaultInterval.count(),
+                              perSecond);
+                }
+            }
+
+            for (const std::unique_ptr<Rail>& rail : device->getRails())
+            {
+                if (!rail->getSensorMonitoring())
+                {
+                    continue;
+                }
+
+                // Enable detection runs each time the sensors are due to be
+                // read.  The sensors are read at the minimum interval while
+                // they are changing.
+                const SensorMonitoring& monitoring =
+                    *(rail->getSensorMonitoring());
+                DeviceUsageMap usage =
+                    internal::getUsage(monitoring.getActions(), system,
+                                       deviceID);
+                if (monitoring.getEnableDetection())
+                {
+                    addScaled(internal::getUsage(
+                                  monitoring.getEnableDetection()->getActions(),
+                                  system, deviceID),
+                              1.0, usage);
+                }
+                double readsPerSecond =
+                    1000.0 / std::max<std::chrono::milliseconds::rep>(
+                                 monitoring.getMinInterval().count(), 1);
+                addScaled(usage, 1.0, sensorMonitoring);
+                addScaled(usage, readsPerSecond, perSecond);
+
+                // Sampling groups are read during every divisor'th read
+                for (const SamplingGroup& group :
+                     monitoring.getSamplingGroups())
+                {
+                    DeviceUsageMap groupUsage =
+                        internal::getUsage(group.actions, system, deviceID);
+                    addScaled(groupUsage, 1.0, sensorMonitoring);
+                    addScaled(groupUsage,
+                              readsPerSecond / std::max(group.divisor, 1u),
+                              perSecond);
+                }
+            }
+        }
+    }
+
+    // Combine the usage of the devices on each bus
+    Report report{};
+    std::map<uint8_t, BusUsage> buses{};
+    for (const std::unique_ptr<Chassis>& chassis : system.getChassis())
+    {
+        for (const std::unique_ptr<Device>& device : chassis->getDevices())
+        {
+            const std::string& deviceID = device->getID();
+            DeviceUsage deviceUsage{};
+            deviceUsage.deviceID = deviceID;
+            deviceUsage.bus = device->getI2CInterface().getBus();
+            deviceUsage.address = device->getI2CInterface().getAddress();
+            deviceUsage.sensorMonitoring = sensorMonitoring[deviceID];
+            deviceUsage.phaseFaultDetection = phaseFaultDetection[deviceID];
+            deviceUsage.presenceDetection = presenceDetection[deviceID];
+            deviceUsage.perSecond = perSecond[deviceID];
+
+            BusUsage& busUsage = buses[deviceUsage.bus];
+            busUsage.bus = deviceUsage.bus;
+            busUsage.sensorMonitoring += deviceUsage.sensorMonitoring;
+            busUsage.perSecond += deviceUsage.perSecond;
+            report.devices.emplace_back(std::move(deviceUsage));
+        }
+    }
+    for (auto& [bus, busUsage] : buses)
+    {
+        std::optional<i2c::BusBudget> budget = i2c::getBusBudget(bus);
+        if (budget)
+        {
+            busUsage.maxTransactionsPerSecond = budget->transactionsPerSecond;
+        }
+        report.buses.emplace_back(busUsage);
+    }
+    return report;
+}
+
+std::string toString(const Report& report)
+{
+    // Each usage is shown as transactions/bytes
+    auto format = [](const Usage& usage) {
+        std::ostringstream ss;
+        ss << std::fixed << std::setprecision(1) << usage.transactions << '/'
+           << usage.bytes;
+        return ss.str();
+    };
+
+    std::ostringstream ss;
+    ss << "Transactions/bytes per sensor read, phase fault detection, "
+          "presence detection, and second\n";
+    for (const DeviceUsage& device : report.devices)
+    {
+        ss << "device " << device.deviceID << " (bus "
+           << static_cast<unsigned int>(device.bus) << ", address 0x"
+           << std::hex << std::uppercase
+           << static_cast<unsigned int>(device.address) << std::dec
+           << std::nouppercase << "): sensors "
+           << format(device.sensorMonitoring) << ", phase faults "
+           << format(device.phaseFaultDetection) << ", presence "
+           << format(device.presenceDetection) << ", per second "
+           << format(device.perSecond) << '\n';
+    }
+    for (const BusUsage& bus : report.buses)
+    {
+        ss << "bus " << static_cast<unsigned int>(bus.bus) << ": sensors "
+           << format(bus.sensorMonitoring) << ", per second "
+           << format(bus.perSecond);
+        if (bus.maxTransactionsPerSecond)
+        {
+            ss << ", budget " << std::fixed << std::setprecision(1)
+               << *bus.maxTransactionsPerSecond;
+            if (bus.isOverBudget())
+            {
+                ss << " (over budget)";
+            }
+        }
+        ss << '\n';
+    }
+    return ss.str();
+}
+
+namespace internal
+{
+
+void addUsage(const Action& action, const System& system,
+              std::string& deviceID, DeviceUsageMap& usage,
+              unsigned int ruleDepth)
+{
+    if (auto* runRuleAction = dynamic_cast<const RunRuleAction*>(&action))
+    {
+        // Use the same limit as when the rule is executed, so recursive rules
+        // are reported rather than walked forever
+        const std::string& ruleID = runRuleAction->getRuleID();
+        if (ruleDepth >= ActionEnvironment::maxRuleDepth)
+        {
+            throw std::runtime_error("Maximum rule depth exceeded by rule " +
+                                     ruleID + '.');
+        }
+        const Rule& rule = system.getIDMap().getRule(ruleID);
+        addUsage(rule.getActions(), system, deviceID, usage, ruleDepth + 1);
+    }
+    else if (auto* andAction = dynamic_cast<const AndAction*>(&action))
+    {
+        addUsage(andAction->getActions(), system, deviceID, usage, ruleDepth);
+    }
+    else if (auto* orAction = dynamic_cast<const OrAction*>(&action))
+    {
+        addUsage(orAction->getActions(), system, deviceID, usage, ruleDepth);
+    }
+    else if (auto* notAction = dynamic_cast<const NotAction*>(&action))
+    {
+        addUsage(*(notAction->getAction()), system, deviceID, usage,
+                 ruleDepth);
+    }
+    else if (auto* ifAction = dynamic_cast<const IfAction*>(&action))
+    {
+        addUsage(*(ifAction->getConditionAction()), system, deviceID, usage,
+                 ruleDepth);
+
+        // Use the larger usage of the two branches for each device.  The
+        // current device afterwards is the one selected by the then branch.
+        std::string elseDeviceID{deviceID};
+        DeviceUsageMap thenUsage{};
+        DeviceUsageMap elseUsage{};
+        addUsage(ifAction->getThenActions(), system, deviceID, thenUsage,
+                 ruleDepth);
+        addUsage(ifAction->getElseActions(), system, elseDeviceID, elseUsage,
+                 ruleDepth);
+        for (const auto& [id, branchUsage] : elseUsage)
+        {
+            Usage& maxUsage = thenUsage[id];
+            maxUsage.transactions =
+                std::max(maxUsage.transactions, branchUsage.transactions);
+            maxUsage.bytes = std::max(maxUsage.bytes, branchUsage.bytes);
+        }
+        addScaled(thenUsage, 1.0, usage);
+    }
+    else if (auto* setDeviceAction =
+                 dynamic_cast<const SetDeviceAction*>(&action))
+    {
+        deviceID = setDeviceAction->getDeviceID();
+    }
+    else if ((dynamic_cast<const I2CCompareBitAction*>(&action) != nullptr) ||
+             (dynamic_cast<const I2CCompareByteAction*>(&action) != nullptr))
+    {
+        usage[deviceID] += readByteUsage;
+    }
+    else if (auto* probe = dynamic_cast<const I2CProbeAction*>(&action))
+    {
+        usage[deviceID] += (probe->getMethod() == I2CProbeAction::Method::quick)
+                               ? quickUsage
+                               : receiveByteUsage;
+    }
+    else if (auto* compareBytes =
+                 dynamic_cast<const I2CCompareBytesAction*>(&action))
+    {
+        usage[deviceID] += getBytesUsage(compareBytes->getValues().size());
+    }
+    else if (auto* captureBytes =
+                 dynamic_cast<const I2CCaptureBytesAction*>(&action))
+    {
+        usage[deviceID] += getBytesUsage(captureBytes->getCount());
+    }
+    else if (dynamic_cast<const I2CWriteBitAction*>(&action) != nullptr)
+    {
+        // Read-modify-write
+        usage[deviceID] += readByteUsage;
+        usage[deviceID] += writeByteUsage;
+    }
+    else if (auto* writeByte = dynamic_cast<const I2CWriteByteAction*>(&action))
+    {
+        // Masked writes read the register first
+        if (writeByte->getMask() != 0xFF)
+        {
+            usage[deviceID] += readByteUsage;
+        }
+        usage[deviceID] += writeByteUsage;
+    }
+    else if (auto* writeBytes =
+                 dynamic_cast<const I2CWriteBytesAction*>(&action))
+    {
+        // Masked writes read the registers first
+        Usage bytesUsage = getBytesUsage(writeBytes->getValues().size());
+        if (!writeBytes->getMasks().empty())
+        {
+            usage[deviceID] += bytesUsage;
+        }
+        usage[deviceID] += bytesUsage;
+    }
+    else if (auto* readSensor =
+                 dynamic_cast<const PMBusReadSensorAction*>(&action))
+    {
+        // VOUT_MODE is read for the exponent of linear_16 values
+        if ((readSensor->getFormat() ==
+             pmbus_utils::SensorDataFormat::linear_16) &&
+            !readSensor->getExponent().has_value())
+        {
+            usage[deviceID] += readByteUsage;
+        }
+        usage[deviceID] += wordUsage;
+    }
+    else if (auto* readSensors =
+                 dynamic_cast<const PMBusReadSensorsAction*>(&action))
+    {
+        // The page is selected in the same transfer as the reads
+        if (readSensors->getPage().has_value())
+        {
+            usage[deviceID] += writeByteUsage;
+        }
+        bool isVoutModeRead{false};
+        for (const auto& sensor : readSensors->getSensors())
+        {
+            usage[deviceID] += wordUsage;
+            if (sensor.format == pmbus_utils::SensorDataFormat::linear_16)
+            {
+                isVoutModeRead = !readSensors->getExponent().has_value();
+            }
+        }
+        if (isVoutModeRead)
+        {
+            usage[deviceID] += readByteUsage;
+        }
+    }
+    else if (auto* readBlockSensors =
+                 dynamic_cast<const PMBusReadBlockSensorsAction*>(&action))
+    {
+        // The block starts with a byte count
+        std::size_t size{0};
+        bool isVoutModeRead{false};
+        for (const auto& sensor : readBlockSensors->getSensors())
+        {
+            size = std::max<std::size_t>(size, sensor.offset + sensor.size);
+            if (sensor.format == pmbus_utils::SensorDataFormat::linear_16)
+            {
+                isVoutModeRead = !readBlockSensors->getExponent().has_value();
+            }
+        }
+        usage[deviceID] += getBytesUsage(size + 1);
+        if (isVoutModeRead)
+        {
+            usage[deviceID] += readByteUsage;
+        }
+    }
+    else if (auto* writeVoutCommand =
+                 dynamic_cast<const PMBusWriteVoutCommandAction*>(&action))
+    {
+        if (!writeVoutCommand->getExponent().has_value())
+        {
+            usage[deviceID] += readByteUsage;
+        }
+        usage[deviceID] += wordUsage;
+        if (writeVoutCommand->isVerified())
+        {
+            usage[deviceID] += wordUsage;
+        }
+    }
+
+    // The other actions, such as compare_presence and log_phase_fault, do
+    // not access the I2C bus
+}
+
+void addUsage(const std::vector<std::unique_ptr<Action>>& actions,
+              const System& system, std::string& deviceID,
+              DeviceUsageMap& usage, unsigned int ruleDepth)
+{
+    for (const std::unique_ptr<Action>& action : actions)
+    {
+        addUsage(*action, system, deviceID, usage, ruleDepth);
+    }
+}
+
+DeviceUsageMap getUsage(const std::vector<std::unique_ptr<Action>>& actions,
+                        const System& system, const std::string& deviceID)
+{
+    std::string currentDeviceID{deviceID};
+    DeviceUsageMap usage{};
+    addUsage(actions, system, currentDeviceID, usage);
+    return usage;
+}
+
+} // namespace internal
+
+} // namespace phosphor::power::regulators::bus_usage
@@ -0,0 +1,259 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "action.hpp"
+#include "system.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+/**
+ * @namespace bus_usage
+ *
+ * Contains functions for estimating the I2C bus usage of a config file
+ * without accessing the hardware.
+ *
+ * The actions are walked rather than executed, following the rules run by
+ * run_rule actions.  The estimates are worst case: every action of an and/or
+ * action is counted, both branches of an if action are considered, and sensor
+ * values that could be shared between the rails of a device are counted for
+ * each rail.
+ */
+namespace phosphor::power::regulators::bus_usage
+{
+
+/**
+ * @struct Usage
+ *
+ * Number of I2C transactions and bytes.
+ *
+ * Each message of a transfer is counted as a transaction.  The command code
+ * and data bytes of each message are counted; the address bytes are not.
+ */
+struct Usage
+{
+    double transactions{0.0};
+    double bytes{0.0};
+
+    Usage& operator+=(const Usage& other)
+    {
+        transactions += other.transactions;
+        bytes += other.bytes;
+        return *this;
+    }
+};
+
+/**
+ * Worst-case I2C usage of executing actions, by device ID.
+ */
+using DeviceUsageMap = std::map<std::string, Usage>;
+
+/**
+ * @struct DeviceUsage
+ *
+ * Worst-case I2C usage of a device.
+ *
+ * Includes the usage of the actions of other devices that select this device
+ * with a set_device action.
+ */
+struct DeviceUsage
+{
+    /**
+     * Device ID.
+     */
+    std::string deviceID{};
+
+    /**
+     * I2C bus and address of the device.
+     */
+    uint8_t bus{0};
+    uint8_t address{0};
+
+    /**
+     * Usage of reading the sensors of all the rails once, including all the
+     * sampling groups.
+     */
+    Usage sensorMonitoring{};
+
+    /**
+     * Usage of detecting phase faults once.
+     */
+    Usage phaseFaultDetection{};
+
+    /**
+     * Usage of detecting presence once.  Presence is cached, so it is not
+     * included in perSecond.
+     */
+    Usage presenceDetection{};
+
+    /**
+     * Usage per second of sensor monitoring, at the minimum interval of each
+     * rail, and phase fault detection.
+     */
+    Usage perSecond{};
+};
+
+/**
+ * @struct BusUsage
+ *
+ * Worst-case I2C usage of the devices on a bus.
+ */
+struct BusUsage
+{
+    /**
+     * I2C bus.
+     */
+    uint8_t bus{0};
+
+    /**
+     * Usage of reading the sensors of all the rails on the bus once.
+     */
+    Usage sensorMonitoring{};
+
+    /**
+     * Usage per second of the devices on the bus.
+     */
+    Usage perSecond{};
+
+    /**
+     * Maximum transactions per second of the bus, if the config file
+     * specifies a budget for it.
+     */
+    std::optional<double> maxTransactionsPerSecond{};
+
+    /**
+     * Returns whether the worst-case transactions per second exceed the
+     * budget of the bus.
+     *
+     * @return true if the bus is over its budget
+     */
+    bool isOverBudget() const
+    {
+        return maxTransactionsPerSecond &&
+               (perSecond.transactions > *maxTransactionsPerSecond);
+    }
+};
+
+/**
+ * @struct Report
+ *
+ * Worst-case I2C usage of a system.
+ */
+struct Report
+{
+    /**
+     * Usage of each device, in config file order.
+     */
+    std::vector<DeviceUsage> devices{};
+
+    /**
+     * Usage of each bus, in bus number order.
+     */
+    std::vector<BusUsage> buses{};
+};
+
+/**
+ * Default interval between phase fault detections for each device.
+ */
+constexpr std::chrono::milliseconds defaultPhaseFaultInterval{15000};
+
+/**
+ * Estimates the worst-case I2C usage of the specified system.
+ *
+ * The budget of each bus is obtained from i2c::getBusBudget(), which is set
+ * when the config file is parsed.
+ *
+ * Throws an exception if a rule cannot be found or the maximum rule depth is
+ * exceeded.
+ *
+ * @param system system created from the config file
+ * @param phaseFaultInterval interval between phase fault detections for each
+ *                           device
+ * @return usage of each device and bus
+ */
+Report analyze(
+    const System& system,
+    std::chrono::milliseconds phaseFaultInterval = defaultPhaseFaultInterval);
+
+/**
+ * Returns the specified report as text, with one line per device and bus.
+ *
+ * @param report report to format
+ * @return report text
+ */
+std::string toString(const Report& report);
+
+/*
+ * Internal implementation details
+ */
+namespace internal
+{
+
+/**
+ * Adds the worst-case I2C usage of executing the specified action.
+ *
+ * The usage is added to the current device, which is changed by set_device
+ * actions.
+ *
+ * Throws an exception if a rule cannot be found or the maximum rule depth is
+ * exceeded.
+ *
+ * @param action action to walk
+ * @param system system that contains the rules
+ * @param deviceID ID of the current device
+ * @param usage usage of each device so far
+ * @param ruleDepth number of rules being run
+ */
+void addUsage(const Action& action, const System& system,
+              std::string& deviceID, DeviceUsageMap& usage,
+              unsigned int ruleDepth = 0);
+
+/**
+ * Adds the worst-case I2C usage of executing the specified actions.
+ *
+ * See addUsage(const Action&, ...) for more information.
+ *
+ * @param actions actions to walk
+ * @param system system that contains the rules
+ * @param deviceID ID of the current device
+ * @param usage usage of each device so far
+ * @param ruleDepth number of rules being run
+ */
+void addUsage(const std::vector<std::unique_ptr<Action>>& actions,
+              const System& system, std::string& deviceID,
+              DeviceUsageMap& usage, unsigned int ruleDepth = 0);
+
+/**
+ * Returns the worst-case I2C usage of executing the specified actions with
+ * the specified current device.
+ *
+ * @param actions actions to walk
+ * @param system system that contains the rules
+ * @param deviceID ID of the current device
+ * @return usage of each device
+ */
+DeviceUsageMap getUsage(const std::vector<std::unique_ptr<Action>>& actions,
+                        const System& system, const std::string& deviceID);
+
+} // namespace internal
+
+} // namespace phosphor::power::regulators::bus_usage
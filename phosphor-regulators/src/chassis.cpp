@@ -16,6 +16,8 @@
 
 #include "chassis.hpp"
 
+#include "action_environment.hpp"
+#include "configuration_executor.hpp"
 #include "system.hpp"
 
 namespace phosphor::power::regulators
@@ -51,8 +53,11 @@ void Chassis::clearErrorHistory()
 void Chassis::closeDevices(Services& services)
 {
     // Log debug message in journal
-    services.getJournal().logDebug("Closing devices in chassis " +
-                                   std::to_string(number));
+    if constexpr (isJournalDebugEnabled)
+    {
+        services.getJournal().logDebug("Closing devices in chassis " +
+                                       std::to_string(number));
+    }
 
     // Close devices
     for (std::unique_ptr<Device>& device : devices)
@@ -61,35 +66,119 @@ void Chassis::closeDevices(Services& services)
     }
 }
 
-void Chassis::configure(Services& services, System& system)
+void Chassis::closeUnpoweredDevices(Services& services, System& system)
+{
+    // Log debug message in journal
+    if constexpr (isJournalDebugEnabled)
+    {
+        services.getJournal().logDebug(
+            "Closing unpowered devices in chassis " + std::to_string(number));
+    }
+
+    // Close devices that lose power or are no longer present.  Presence is
+    // only checked for standby-powered devices.
+    for (std::unique_ptr<Device>& device : devices)
+    {
+        if (!device->isStandbyPowered() ||
+            !device->isPresent(services, system, *this))
+        {
+            device->close(services);
+        }
+    }
+}
+
+void Chassis::compileActions(const IDMap& idMap)
+{
+    // Compile actions in each device
+    for (std::unique_ptr<Device>& device : devices)
+    {
+        device->compileActions(idMap);
+    }
+}
+
+unsigned int Chassis::configure(Services& services, System& system,
+                                const std::optional<std::string>& powerDomain)
 {
     // Log info message in journal; important for verifying success of boot
-    services.getJournal().logInfo("Configuring chassis " +
-                                  std::to_string(number));
+    std::string message{"Configuring chassis " + std::to_string(number)};
+    if (powerDomain && !powerDomain->empty())
+    {
+        message += " power domain " + *powerDomain;
+    }
+    services.getJournal().logInfo(message);
+
+    // Configure devices on different I2C buses in parallel if enabled
+    if (parallelConfiguration)
+    {
+        ConfigurationExecutor executor{system, *this};
+        return executor.execute(services, powerDomain);
+    }
 
     // Configure devices
+    unsigned int errorCount{0};
     for (std::unique_ptr<Device>& device : devices)
     {
-        device->configure(services, system, *this);
+        if (!powerDomain || device->isInPowerDomain(*powerDomain))
+        {
+            errorCount += device->configure(services, system, *this);
+        }
     }
+    return errorCount;
 }
 
 void Chassis::detectPhaseFaults(Services& services, System& system)
 {
-    // Detect phase faults in each device
+    // Detect phase faults in each device, reusing the same environment
+    ActionEnvironment environment{system.getIDMap(), Symbol{}, services};
+    for (std::unique_ptr<Device>& device : devices)
+    {
+        device->detectPhaseFaults(services, system, *this, environment);
+    }
+}
+
+bool Chassis::handleAlert(Services& services, System& system, uint8_t bus,
+                          uint8_t address)
+{
+    // Several devices can share an address if they are switched in and out
+    // based on presence, so check all of them
+    bool wasFound{false};
     for (std::unique_ptr<Device>& device : devices)
     {
-        device->detectPhaseFaults(services, system, *this);
+        i2c::I2CInterface& interface = device->getI2CInterface();
+        if ((interface.getBus() == bus) && (interface.getAddress() == address))
+        {
+            device->handleAlert(services, system, *this);
+            wasFound = true;
+        }
+    }
+    return wasFound;
+}
+
+void Chassis::linkActions(const IDMap& idMap)
+{
+    // Link actions in each device
+    for (std::unique_ptr<Device>& device : devices)
+    {
+        device->linkActions(idMap);
     }
 }
 
 void Chassis::monitorSensors(Services& services, System& system)
 {
-    // Monitor sensors in each device
+    // Monitor sensors in each device, reusing the same environment
+    ActionEnvironment environment{system.getIDMap(), Symbol{}, services};
     for (std::unique_ptr<Device>& device : devices)
     {
-        device->monitorSensors(services, system, *this);
+        device->monitorSensors(services, system, *this, environment);
     }
 }
 
+std::unique_ptr<Device> Chassis::replaceDevice(std::size_t index,
+                                               std::unique_ptr<Device> device)
+{
+    std::unique_ptr<Device>& element = devices.at(index);
+    std::swap(element, device);
+    return device;
+}
+
 } // namespace phosphor::power::regulators
@@ -19,7 +19,10 @@
 #include "id_map.hpp"
 #include "services.hpp"
 
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <optional>
 #include <stdexcept>
 #include <string>
 #include <utility>
@@ -65,12 +68,26 @@ class Chassis
      * @param devices Devices within this chassis, if any.  The vector should
      *                contain regulator devices and any related devices required
      *                to perform regulator operations.
+     * @param parallelConfiguration indicates whether devices on different I2C
+     *                              buses are configured in parallel
+     * @param independentMonitoring indicates whether the sensors of this
+     *                              chassis are monitored on their own worker
+     *                              thread
+     * @param deferredWriteVerification indicates whether the writes to each
+     *                                  device are verified after all of them
+     *                                  are done
      */
     explicit Chassis(unsigned int number, const std::string& inventoryPath,
                      std::vector<std::unique_ptr<Device>> devices =
-                         std::vector<std::unique_ptr<Device>>{}) :
+                         std::vector<std::unique_ptr<Device>>{},
+                     bool parallelConfiguration = false,
+                     bool independentMonitoring = false,
+                     bool deferredWriteVerification = false) :
         number{number},
-        inventoryPath{inventoryPath}, devices{std::move(devices)}
+        inventoryPath{inventoryPath}, devices{std::move(devices)},
+        parallelConfiguration{parallelConfiguration},
+        independentMonitoring{independentMonitoring},
+        deferredWriteVerification{deferredWriteVerification}
     {
         if (number < 1)
         {
@@ -108,16 +125,50 @@ class Chassis
      */
     void closeDevices(Services& services);
 
+    /**
+     * Close the devices within this chassis that do not remain powered while
+     * the system is powered off.
+     *
+     * The I2C interfaces to standby-powered devices are kept open, so they do
+     * not need to be reopened during the next boot.  The interface is closed
+     * if a standby-powered device is no longer present.  See
+     * Device::isStandbyPowered().
+     *
+     * @param services system services like error logging and the journal
+     * @param system system that contains this chassis
+     */
+    void closeUnpoweredDevices(Services& services, System& system);
+
+    /**
+     * Compiles the actions for the devices within this chassis, if any.
+     *
+     * @param idMap mapping from IDs to the associated Device/Rail/Rule objects
+     */
+    void compileActions(const IDMap& idMap);
+
     /**
      * Configure the devices within this chassis, if any.
      *
      * This method should be called during the boot before regulators are
      * enabled.
      *
+     * If parallel configuration is enabled, devices on different I2C buses
+     * are configured at the same time.  See ConfigurationExecutor.
+     *
+     * If a power domain is specified, only the devices in that power domain
+     * are configured.  See PowerDomain.
+     *
      * @param services system services like error logging and the journal
      * @param system system that contains this chassis
+     * @param powerDomain name of the power domain whose devices should be
+     *                    configured, or an empty string for the devices that
+     *                    are not in a power domain.  If not specified, all the
+     *                    devices are configured.
+     * @return number of errors that occurred configuring the devices
      */
-    void configure(Services& services, System& system);
+    unsigned int
+        configure(Services& services, System& system,
+                  const std::optional<std::string>& powerDomain = std::nullopt);
 
     /**
      * Detect redundant phase faults in regulator devices in this chassis.
@@ -129,6 +180,21 @@ class Chassis
      */
     void detectPhaseFaults(Services& services, System& system);
 
+    /**
+     * Handles an SMBus alert from the devices in this chassis with the
+     * specified I2C bus and address.
+     *
+     * See Device::handleAlert() for more information.
+     *
+     * @param services system services like error logging and the journal
+     * @param system system that contains this chassis
+     * @param bus I2C bus of the device
+     * @param address I2C address of the device
+     * @return true if a device in this chassis has the bus and address
+     */
+    bool handleAlert(Services& services, System& system, uint8_t bus,
+                     uint8_t address);
+
     /**
      * Returns the devices within this chassis, if any.
      *
@@ -162,6 +228,49 @@ class Chassis
         return number;
     }
 
+    /**
+     * Returns whether devices on different I2C buses are configured in
+     * parallel.
+     *
+     * @return true if parallel configuration is enabled, false otherwise
+     */
+    bool isParallelConfiguration() const
+    {
+        return parallelConfiguration;
+    }
+
+    /**
+     * Returns whether the sensors of this chassis are monitored on their own
+     * worker thread, at their own interval.  See ChassisMonitor.
+     *
+     * @return true if independent monitoring is enabled, false otherwise
+     */
+    bool isIndependentMonitoring() const
+    {
+        return independentMonitoring;
+    }
+
+    /**
+     * Returns whether the writes to each device are verified after all the
+     * writes to the device are done when configuring it.  See
+     * Device::configure().
+     *
+     * @return true if write verification is deferred, false otherwise
+     */
+    bool isWriteVerificationDeferred() const
+    {
+        return deferredWriteVerification;
+    }
+
+    /**
+     * Links the actions for the devices within this chassis, if any.
+     *
+     * See Action::link() for more information.
+     *
+     * @param idMap mapping from IDs to the associated Device/Rail/Rule objects
+     */
+    void linkActions(const IDMap& idMap);
+
     /**
      * Monitors the sensors for the voltage rails produced by this chassis, if
      * any.
@@ -173,6 +282,22 @@ class Chassis
      */
     void monitorSensors(Services& services, System& system);
 
+    /**
+     * Replaces the device at the specified index in this chassis.
+     *
+     * Used to keep an unchanged device, and its runtime state, when the config
+     * file is reloaded.  The actions of the new device must be linked and
+     * compiled again afterwards.
+     *
+     * Throws an exception if the index is invalid.
+     *
+     * @param index index of the device within the chassis
+     * @param device new device
+     * @return device that was replaced
+     */
+    std::unique_ptr<Device> replaceDevice(std::size_t index,
+                                          std::unique_ptr<Device> device);
+
   private:
     /**
      * Chassis number within the system.
@@ -194,6 +319,24 @@ class Chassis
      * required to perform regulator operations.
      */
     std::vector<std::unique_ptr<Device>> devices{};
+
+    /**
+     * Indicates whether devices on different I2C buses are configured in
+     * parallel.
+     */
+    const bool parallelConfiguration{false};
+
+    /**
+     * Indicates whether the sensors of this chassis are monitored on their own
+     * worker thread.
+     */
+    const bool independentMonitoring{false};
+
+    /**
+     * Indicates whether the writes to each device are verified after all the
+     * writes to the device are done.
+     */
+    const bool deferredWriteVerification{false};
 };
 
 } // namespace phosphor::power::regulators
@@ -0,0 +1,203 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "chassis_monitor.hpp"
+
+#include "chassis.hpp"
+#include "device.hpp"
+#include "exception_utils.hpp"
+#include "rail.hpp"
+#include "sensor_monitoring.hpp"
+#include "system.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <memory>
+#include <numeric>
+#include <system_error>
+#include <vector>
+
+namespace phosphor::power::regulators
+{
+
+/**
+ * Minimum interval between monitoring the sensors of a chassis; matches the
+ * minimum rail interval.
+ */
+constexpr std::chrono::milliseconds minInterval{100};
+
+/**
+ * Amount of time the sensors of a chassis can be monitored early.  Matches
+ * the tolerance of the rails, so a rail is not skipped because the timer
+ * expired slightly before its interval elapsed.
+ */
+constexpr std::chrono::milliseconds startTimeTolerance{50};
+
+/**
+ * Returns the interval between monitoring the sensors of the specified
+ * chassis.
+ *
+ * @param chassis chassis that contains the rails
+ * @return greatest common divisor of the rail intervals
+ */
+static std::chrono::milliseconds getChassisInterval(Chassis& chassis)
+{
+    std::chrono::milliseconds::rep interval{0};
+    for (const std::unique_ptr<Device>& device : chassis.getDevices())
+    {
+        for (const std::unique_ptr<Rail>& rail : device->getRails())
+        {
+            const auto& monitoring = rail->getSensorMonitoring();
+            if (monitoring)
+            {
+                interval =
+                    std::gcd(interval, monitoring->getInterval().count());
+                interval =
+                    std::gcd(interval, monitoring->getMinInterval().count());
+            }
+        }
+    }
+
+    if (interval == 0)
+    {
+        return SensorMonitoring::defaultInterval;
+    }
+    return std::max(std::chrono::milliseconds{interval}, minInterval);
+}
+
+ChassisMonitor::ChassisMonitor(Services& services, System& system,
+                               Chassis& chassis,
+                               std::size_t phaseFaultSliceCount,
+                               const std::filesystem::path& i2cDevicesDir) :
+    services{services},
+    system{system}, chassis{chassis}, interval{getChassisInterval(chassis)},
+    sensorMonitoringExecutor{system, std::vector<Chassis*>{&chassis},
+                             i2cDevicesDir},
+    phaseFaultScheduler{system, std::vector<Chassis*>{&chassis},
+                        phaseFaultSliceCount},
+    workerServices{services, mutex, true}
+{}
+
+ChassisMonitor::~ChassisMonitor()
+{
+    if (worker.valid())
+    {
+        worker.wait();
+    }
+}
+
+bool ChassisMonitor::collect()
+{
+    // Do not wait for a worker that is still running
+    if (!worker.valid() || (worker.wait_for(std::chrono::seconds{0}) ==
+                            std::future_status::timeout))
+    {
+        return false;
+    }
+
+    bool wereSensorsMonitored = isMonitoringSensors;
+    replay();
+    return wereSensorsMonitored;
+}
+
+void ChassisMonitor::skipRails()
+{
+    Sensors& sensors = services.getSensors();
+    for (const std::unique_ptr<Device>& device : chassis.getDevices())
+    {
+        for (const std::unique_ptr<Rail>& rail : device->getRails())
+        {
+            if (rail->getSensorMonitoring())
+            {
+                sensors.skipRail(rail->getID());
+            }
+        }
+    }
+}
+
+bool ChassisMonitor::start(std::chrono::steady_clock::time_point now)
+{
+    bool isSensorMonitoringDue = (now + startTimeTolerance) >= nextStartTime;
+    if (worker.valid() ||
+        (!isSensorMonitoringDue && (pendingPhaseFaultSlices == 0)))
+    {
+        return false;
+    }
+
+    // Determine device presence on this thread, since the worker only uses
+    // cached hardware presence.  The result is cached by each device.
+    for (const std::unique_ptr<Device>& device : chassis.getDevices())
+    {
+        device->isPresent(services, system, chassis);
+    }
+
+    isMonitoringSensors = isSensorMonitoringDue;
+    if (isMonitoringSensors)
+    {
+        nextStartTime = now + interval;
+    }
+    std::size_t phaseFaultSlices = pendingPhaseFaultSlices;
+    pendingPhaseFaultSlices = 0;
+
+    auto job = [this, phaseFaultSlices]() {
+        if (isMonitoringSensors)
+        {
+            sensorMonitoringExecutor.execute(workerServices);
+        }
+        for (std::size_t i = 0; i < phaseFaultSlices; ++i)
+        {
+            phaseFaultScheduler.execute(workerServices);
+        }
+    };
+    try
+    {
+        worker = std::async(std::launch::async, job);
+    }
+    catch (const std::system_error&)
+    {
+        // Unable to start a thread; run the job when it is collected
+        worker = std::async(std::launch::deferred, job);
+    }
+    return true;
+}
+
+void ChassisMonitor::wait()
+{
+    if (worker.valid())
+    {
+        replay();
+    }
+}
+
+void ChassisMonitor::replay()
+{
+    try
+    {
+        worker.get();
+    }
+    catch (const std::exception& e)
+    {
+        services.getJournal().logError(exception_utils::MessageView{e});
+        services.getJournal().logError(
+            "Unable to monitor chassis " + std::to_string(chassis.getNumber()));
+    }
+    isMonitoringSensors = false;
+
+    // Replay the sensor updates and other service calls on this thread
+    workerServices.replay();
+}
+
+} // namespace phosphor::power::regulators
@@ -0,0 +1,246 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "mux_topology.hpp"
+#include "phase_fault_detection_scheduler.hpp"
+#include "sensor_monitoring_executor.hpp"
+#include "services.hpp"
+#include "worker_services.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <future>
+#include <shared_mutex>
+
+namespace phosphor::power::regulators
+{
+
+// Forward declarations to avoid circular dependencies
+class Chassis;
+class System;
+
+/**
+ * @class ChassisMonitor
+ *
+ * Monitors one chassis on its own worker thread.
+ *
+ * Used for chassis with independent monitoring enabled in the configuration
+ * file.  The sensors of the chassis are monitored at the interval of its own
+ * rails, and its redundant phase faults are detected when requested.  The
+ * calling thread, normally the event loop thread, does not wait for the
+ * worker.  A chassis with a slow or failing I2C bus therefore does not delay
+ * the monitoring of the other chassis.
+ *
+ * Sensor updates, error logs, and journal messages are recorded by the worker
+ * and replayed on the calling thread by collect().  The worker only uses
+ * cached presence and VPD values, since the calling thread keeps using D-Bus
+ * while the worker runs.  The presence of the devices in the chassis is
+ * determined on the calling thread before the worker is started.
+ *
+ * The devices in the chassis must not be accessed by the calling thread while
+ * the worker is running.  Call wait() first.
+ */
+class ChassisMonitor
+{
+  public:
+    // Specify which compiler-generated methods we want
+    ChassisMonitor() = delete;
+    ChassisMonitor(const ChassisMonitor&) = delete;
+    ChassisMonitor(ChassisMonitor&&) = delete;
+    ChassisMonitor& operator=(const ChassisMonitor&) = delete;
+    ChassisMonitor& operator=(ChassisMonitor&&) = delete;
+
+    /**
+     * Destructor.
+     *
+     * Waits for the worker to finish.  Results that were not collected are
+     * discarded.
+     */
+    ~ChassisMonitor();
+
+    /**
+     * Constructor.
+     *
+     * @param services system services like error logging and the journal
+     * @param system system that contains the chassis
+     * @param chassis chassis to monitor
+     * @param phaseFaultSliceCount number of slices the regulator devices with
+     *                             phase fault detection are divided into; see
+     *                             PhaseFaultDetectionScheduler
+     * @param i2cDevicesDir sysfs directory containing the I2C adapters, used
+     *                      to find the mux topology
+     */
+    ChassisMonitor(
+        Services& services, System& system, Chassis& chassis,
+        std::size_t phaseFaultSliceCount,
+        const std::filesystem::path& i2cDevicesDir = i2c::sysfsI2CDevicesDir);
+
+    /**
+     * Replays the results of the worker if it has finished.
+     *
+     * This method should be called during each sensor monitoring cycle,
+     * between calls to Sensors::startCycle() and Sensors::endCycle().
+     *
+     * @return true if the replayed results include the sensors of the
+     *         chassis, false if the sensors were not monitored by the worker
+     *         or the worker has not finished
+     */
+    bool collect();
+
+    /**
+     * Returns the chassis that is monitored.
+     *
+     * @return chassis
+     */
+    Chassis& getChassis()
+    {
+        return chassis;
+    }
+
+    /**
+     * Returns the interval between monitoring the sensors of the chassis.
+     *
+     * This is the greatest common divisor of the intervals of its rails.
+     *
+     * @return interval
+     */
+    std::chrono::milliseconds getInterval() const
+    {
+        return interval;
+    }
+
+    /**
+     * Returns whether the worker is running or has results that were not
+     * collected.
+     *
+     * @return true if the worker is running, false otherwise
+     */
+    bool isRunning() const
+    {
+        return worker.valid();
+    }
+
+    /**
+     * Requests that redundant phase faults are detected in the next slice of
+     * the regulator devices in the chassis.
+     *
+     * Phase faults are detected the next time the worker is started.
+     */
+    void requestPhaseFaultDetection()
+    {
+        ++pendingPhaseFaultSlices;
+    }
+
+    /**
+     * Marks the sensors of the rails in the chassis as skipped during the
+     * current sensor monitoring cycle.
+     *
+     * This method should be called when collect() returns false, so the
+     * sensors of the chassis are not deleted at the end of the cycle.
+     */
+    void skipRails();
+
+    /**
+     * Starts the worker if it is not running and the sensors are due to be
+     * monitored or phase fault detection was requested.
+     *
+     * @param now current time
+     * @return true if the worker was started, false otherwise
+     */
+    bool start(std::chrono::steady_clock::time_point now =
+                   std::chrono::steady_clock::now());
+
+    /**
+     * Waits for the worker to finish and replays its results.
+     *
+     * This method should be called before the devices in the chassis are
+     * accessed by the calling thread.
+     */
+    void wait();
+
+  private:
+    /**
+     * Waits for the worker, replays its results, and logs an error if the
+     * worker threw an exception.
+     */
+    void replay();
+
+    /**
+     * System services like error logging and the journal.
+     */
+    Services& services;
+
+    /**
+     * System that contains the chassis.
+     */
+    System& system;
+
+    /**
+     * Chassis that is monitored.
+     */
+    Chassis& chassis;
+
+    /**
+     * Interval between monitoring the sensors of the chassis.
+     */
+    const std::chrono::milliseconds interval;
+
+    /**
+     * Monitors the sensors of the chassis.
+     */
+    SensorMonitoringExecutor sensorMonitoringExecutor;
+
+    /**
+     * Detects redundant phase faults in the chassis.
+     */
+    PhaseFaultDetectionScheduler phaseFaultScheduler;
+
+    /**
+     * Lock shared by the services of the worker.
+     */
+    std::shared_mutex mutex{};
+
+    /**
+     * Services used by the worker.  Only cached presence and VPD values are
+     * used.
+     */
+    WorkerServices workerServices;
+
+    /**
+     * Worker that is running or has results that were not collected.
+     */
+    std::future<void> worker{};
+
+    /**
+     * Whether the worker monitors the sensors of the chassis.
+     */
+    bool isMonitoringSensors{false};
+
+    /**
+     * Number of phase fault detection slices requested since the worker was
+     * last started.
+     */
+    std::size_t pendingPhaseFaultSlices{0};
+
+    /**
+     * Time when the sensors are next due to be monitored.
+     */
+    std::chrono::steady_clock::time_point nextStartTime{};
+};
+
+} // namespace phosphor::power::regulators
@@ -0,0 +1,54 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "circuit_breaker.hpp"
+
+namespace phosphor::power::regulators
+{
+
+bool CircuitBreaker::recordFailure(Clock::time_point now)
+{
+    ++failureCount;
+    if (open)
+    {
+        // The try after the backoff failed; wait twice as long next time
+        backoff = std::min(backoff * 2, maxBackoff);
+        nextTryTime = now + backoff;
+        return false;
+    }
+
+    if (failureCount < failureLimit)
+    {
+        return false;
+    }
+
+    open = true;
+    backoff = minBackoff;
+    nextTryTime = now + backoff;
+    return true;
+}
+
+bool CircuitBreaker::recordSuccess()
+{
+    bool wasOpen = open;
+    failureCount = 0;
+    open = false;
+    backoff = Clock::duration{0};
+    nextTryTime = Clock::time_point{};
+    return wasOpen;
+}
+
+} // namespace phosphor::power::regulators
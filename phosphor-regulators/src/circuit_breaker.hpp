@@ -0,0 +1,186 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+
+namespace phosphor::power::regulators
+{
+
+/**
+ * @class CircuitBreaker
+ *
+ * Stops a failing hardware device from slowing down the operations on the
+ * healthy devices.
+ *
+ * The breaker is closed while the device works.  After a number of
+ * consecutive failures it opens, and the device is only tried again after a
+ * backoff time.  Each failed try doubles the backoff up to a maximum.  The
+ * first success closes the breaker again.
+ *
+ * This class is not thread safe.
+ */
+class CircuitBreaker
+{
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * Default number of consecutive failures that open the breaker.
+     */
+    static constexpr unsigned int defaultFailureLimit{3};
+
+    /**
+     * Default backoff time after the breaker opens.
+     */
+    static constexpr Clock::duration defaultMinBackoff{std::chrono::seconds{1}};
+
+    /**
+     * Default maximum backoff time.
+     */
+    static constexpr Clock::duration defaultMaxBackoff{
+        std::chrono::seconds{64}};
+
+    // Specify which compiler-generated methods we want
+    CircuitBreaker(const CircuitBreaker&) = delete;
+    CircuitBreaker(CircuitBreaker&&) = delete;
+    CircuitBreaker& operator=(const CircuitBreaker&) = delete;
+    CircuitBreaker& operator=(CircuitBreaker&&) = delete;
+    ~CircuitBreaker() = default;
+
+    /**
+     * Constructor.
+     *
+     * @param failureLimit number of consecutive failures that open the
+     *                     breaker
+     * @param minBackoff backoff time after the breaker opens
+     * @param maxBackoff maximum backoff time
+     */
+    explicit CircuitBreaker(unsigned int failureLimit = defaultFailureLimit,
+                            Clock::duration minBackoff = defaultMinBackoff,
+                            Clock::duration maxBackoff = defaultMaxBackoff) :
+        failureLimit{std::max(failureLimit, 1u)},
+        minBackoff{minBackoff}, maxBackoff{std::max(maxBackoff, minBackoff)}
+    {}
+
+    /**
+     * Returns the current backoff time.
+     *
+     * @return backoff time, or 0 if the breaker is closed
+     */
+    Clock::duration getBackoff() const
+    {
+        return backoff;
+    }
+
+    /**
+     * Returns the number of consecutive failures.
+     *
+     * @return failure count
+     */
+    unsigned int getFailureCount() const
+    {
+        return failureCount;
+    }
+
+    /**
+     * Returns whether the device may be tried now.
+     *
+     * Always true while the breaker is closed.  While it is open, true once
+     * the backoff time has elapsed.
+     *
+     * @param now current time
+     * @return true if the device may be tried, false otherwise
+     */
+    bool isAllowed(Clock::time_point now) const
+    {
+        return !open || (now >= nextTryTime);
+    }
+
+    /**
+     * Returns whether the breaker is open.
+     *
+     * @return true if the device has failed too often, false otherwise
+     */
+    bool isOpen() const
+    {
+        return open;
+    }
+
+    /**
+     * Records that a try of the device failed.
+     *
+     * @param now current time
+     * @return true if the breaker opened because of this failure, false
+     *         otherwise
+     */
+    bool recordFailure(Clock::time_point now);
+
+    /**
+     * Records that a try of the device succeeded.  Closes the breaker.
+     *
+     * @return true if the breaker was open, false otherwise
+     */
+    bool recordSuccess();
+
+    /**
+     * Closes the breaker and forgets the failures, such as when the device
+     * was replaced.
+     */
+    void reset()
+    {
+        recordSuccess();
+    }
+
+  private:
+    /**
+     * Number of consecutive failures that open the breaker.
+     */
+    const unsigned int failureLimit;
+
+    /**
+     * Backoff time after the breaker opens.
+     */
+    const Clock::duration minBackoff;
+
+    /**
+     * Maximum backoff time.
+     */
+    const Clock::duration maxBackoff;
+
+    /**
+     * Number of consecutive failures.
+     */
+    unsigned int failureCount{0};
+
+    /**
+     * Indicates whether the breaker is open.
+     */
+    bool open{false};
+
+    /**
+     * Current backoff time, or 0 if the breaker is closed.
+     */
+    Clock::duration backoff{0};
+
+    /**
+     * Time when the device may be tried again while the breaker is open.
+     */
+    Clock::time_point nextTryTime{};
+};
+
+} // namespace phosphor::power::regulators
@@ -0,0 +1,87 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+
+namespace phosphor::power::regulators
+{
+
+/**
+ * @struct CompiledConfig
+ *
+ * JSON configuration file that is compiled into the binary.
+ *
+ * The configuration file is validated at build time and stored as the tree of
+ * JSON elements in CBOR format, like the binary cache file of the
+ * configuration file parser.  The JSON text is not parsed at runtime.
+ */
+struct CompiledConfig
+{
+    /**
+     * Base file name of the configuration file, such as "ibm_rainier.json".
+     */
+    const char* fileName;
+
+    /**
+     * Tree of JSON elements in CBOR format.
+     */
+    const uint8_t* data;
+
+    /**
+     * Size of the CBOR data in bytes.
+     */
+    std::size_t size;
+};
+
+namespace compiled_configs
+{
+
+/**
+ * Returns the configuration files compiled into the binary.
+ *
+ * Defined in a source file generated by generate-compiled-configs.py from the
+ * regulators-compiled-configs build option.
+ *
+ * @return compiled configuration files; empty if there are none
+ */
+std::span<const CompiledConfig> getAll();
+
+/**
+ * Returns the configuration file with the specified base file name that is
+ * compiled into the binary.
+ *
+ * @param fileName base file name, such as "ibm_rainier.json"
+ * @return compiled configuration file, or nullptr if not found
+ */
+inline const CompiledConfig* find(const std::string& fileName)
+{
+    for (const CompiledConfig& config : getAll())
+    {
+        if (fileName == config.fileName)
+        {
+            return &config;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace compiled_configs
+
+} // namespace phosphor::power::regulators
@@ -0,0 +1,259 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "sensors.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace phosphor::power::regulators
+{
+
+/**
+ * @class CompositeSensors
+ *
+ * Implementation of the Sensors interface that passes the sensor updates to
+ * several other Sensors implementations, called sinks.
+ *
+ * Each sink has its own minimum interval between monitoring cycles.  A
+ * monitoring cycle is only passed to a sink if its interval has elapsed since
+ * the last cycle passed to it.  During the other cycles the sink receives no
+ * calls, so its sensors keep their values.  This allows a sink with expensive
+ * updates, such as D-Bus, to be updated less often than a sink used by high
+ * rate consumers.
+ *
+ * Calls made outside of a monitoring cycle, such as enable() and disable(),
+ * are passed to all the sinks.
+ *
+ * If a sink throws an exception, the call is still passed to the remaining
+ * sinks.  The first exception is then rethrown.
+ */
+class CompositeSensors : public Sensors
+{
+  public:
+    // Specify which compiler-generated methods we want
+    CompositeSensors() = default;
+    CompositeSensors(const CompositeSensors&) = delete;
+    CompositeSensors(CompositeSensors&&) = delete;
+    CompositeSensors& operator=(const CompositeSensors&) = delete;
+    CompositeSensors& operator=(CompositeSensors&&) = delete;
+    virtual ~CompositeSensors() = default;
+
+    /**
+     * Adds a sink that receives the sensor updates.
+     *
+     * The sink must exist for the lifetime of this object.  Sinks should be
+     * added before the first monitoring cycle.
+     *
+     * @param sink Sensors implementation to receive the updates
+     * @param minCycleInterval minimum interval between the monitoring cycles
+     *                         passed to the sink.  0 passes every cycle.
+     */
+    void addSink(Sensors& sink, std::chrono::milliseconds minCycleInterval =
+                                    std::chrono::milliseconds{0})
+    {
+        sinks.emplace_back(Sink{&sink, minCycleInterval});
+    }
+
+    /**
+     * Returns the number of sinks.
+     *
+     * @return number of sinks
+     */
+    std::size_t getSinkCount() const
+    {
+        return sinks.size();
+    }
+
+    /** @copydoc Sensors::enable() */
+    virtual void enable() override
+    {
+        forEachSink([](Sensors& sink) { sink.enable(); }, false);
+    }
+
+    /** @copydoc Sensors::endCycle() */
+    virtual void endCycle() override
+    {
+        forEachSink([](Sensors& sink) { sink.endCycle(); });
+        isCycleStarted = false;
+    }
+
+    /** @copydoc Sensors::endRail() */
+    virtual void endRail(bool errorOccurred) override
+    {
+        forEachSink([=](Sensors& sink) { sink.endRail(errorOccurred); });
+    }
+
+    /** @copydoc Sensors::disable() */
+    virtual void disable() override
+    {
+        forEachSink([](Sensors& sink) { sink.disable(); }, false);
+    }
+
+    /** @copydoc Sensors::disableRail() */
+    virtual void disableRail(const std::string& rail) override
+    {
+        forEachSink([&](Sensors& sink) { sink.disableRail(rail); });
+    }
+
+    /** @copydoc Sensors::setAggregatedValue() */
+    virtual void
+        setAggregatedValue(SensorType type, double value,
+                           const SensorAggregation& aggregation) override
+    {
+        forEachSink([&](Sensors& sink) {
+            sink.setAggregatedValue(type, value, aggregation);
+        });
+    }
+
+    /** @copydoc Sensors::setValue(SensorType, double) */
+    virtual void setValue(SensorType type, double value) override
+    {
+        forEachSink([=](Sensors& sink) { sink.setValue(type, value); });
+    }
+
+    /** @copydoc Sensors::setValue(SensorType, double,
+     *           std::chrono::steady_clock::time_point) */
+    virtual void
+        setValue(SensorType type, double value,
+                 std::chrono::steady_clock::time_point readTime) override
+    {
+        forEachSink(
+            [=](Sensors& sink) { sink.setValue(type, value, readTime); });
+    }
+
+    /** @copydoc Sensors::skipRail() */
+    virtual void skipRail(const std::string& rail) override
+    {
+        forEachSink([&](Sensors& sink) { sink.skipRail(rail); });
+    }
+
+    /** @copydoc Sensors::startCycle() */
+    virtual void startCycle() override
+    {
+        // Determine which sinks receive this monitoring cycle
+        auto now = std::chrono::steady_clock::now();
+        for (Sink& sink : sinks)
+        {
+            sink.isActive = !sink.lastCycleTime ||
+                            ((now - *sink.lastCycleTime) >=
+                             sink.minCycleInterval);
+            if (sink.isActive)
+            {
+                sink.lastCycleTime = now;
+            }
+        }
+        isCycleStarted = true;
+
+        forEachSink([](Sensors& sink) { sink.startCycle(); });
+    }
+
+    /** @copydoc Sensors::startRail() */
+    virtual void startRail(const std::string& rail,
+                           const std::string& deviceInventoryPath,
+                           const std::string& chassisInventoryPath) override
+    {
+        forEachSink([&](Sensors& sink) {
+            sink.startRail(rail, deviceInventoryPath, chassisInventoryPath);
+        });
+    }
+
+  private:
+    /**
+     * Sensors implementation that receives the sensor updates.
+     */
+    struct Sink
+    {
+        /**
+         * Sensors implementation.
+         */
+        Sensors* sensors;
+
+        /**
+         * Minimum interval between the monitoring cycles passed to the sink.
+         */
+        std::chrono::milliseconds minCycleInterval;
+
+        /**
+         * Time when the last monitoring cycle passed to the sink started.
+         */
+        std::optional<std::chrono::steady_clock::time_point> lastCycleTime{};
+
+        /**
+         * Indicates whether the current monitoring cycle is passed to the
+         * sink.
+         */
+        bool isActive{true};
+    };
+
+    /**
+     * Calls the specified function for each sink that receives the current
+     * monitoring cycle.
+     *
+     * Outside of a monitoring cycle, or if onlyActive is false, the function
+     * is called for all the sinks.
+     *
+     * @param function function to call with each sink
+     * @param onlyActive specifies whether to skip the sinks that do not
+     *                   receive the current monitoring cycle
+     */
+    template <typename Function>
+    void forEachSink(Function&& function, bool onlyActive = true)
+    {
+        std::exception_ptr firstException{};
+        for (Sink& sink : sinks)
+        {
+            if (onlyActive && isCycleStarted && !sink.isActive)
+            {
+                continue;
+            }
+
+            try
+            {
+                function(*sink.sensors);
+            }
+            catch (...)
+            {
+                if (!firstException)
+                {
+                    firstException = std::current_exception();
+                }
+            }
+        }
+
+        if (firstException)
+        {
+            std::rethrow_exception(firstException);
+        }
+    }
+
+    /**
+     * Sinks that receive the sensor updates.
+     */
+    std::vector<Sink> sinks{};
+
+    /**
+     * Indicates whether a monitoring cycle is in progress.
+     */
+    bool isCycleStarted{false};
+};
+
+} // namespace phosphor::power::regulators
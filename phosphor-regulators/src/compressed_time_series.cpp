@@ -0,0 +1,377 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "compressed_time_series.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+#include <string>
+
+namespace phosphor::power::regulators
+{
+
+namespace
+{
+
+/**
+ * Number of bits in the uncompressed first point of a block.
+ */
+constexpr std::size_t firstPointBits{128};
+
+/**
+ * Maximum number of bits in a compressed point: a 4-bit timestamp code with a
+ * 64-bit delta of delta, and a 13-bit value header with a 64-bit XOR value.
+ */
+constexpr std::size_t maxPointBits{4 + 64 + 13 + 64};
+
+/**
+ * Returns a mask of the specified number of low-order bits.
+ *
+ * @param count number of bits, from 0 to 64
+ * @return mask
+ */
+constexpr uint64_t lowBits(unsigned int count)
+{
+    return (count >= 64) ? ~uint64_t{0} : ((uint64_t{1} << count) - 1);
+}
+
+/**
+ * Returns whether a signed value fits in the specified number of bits.
+ *
+ * @param value value to check
+ * @param count number of bits
+ * @return true if the value fits, false otherwise
+ */
+constexpr bool fitsInBits(int64_t value, unsigned int count)
+{
+    int64_t limit = int64_t{1} << (count - 1);
+    return (value >= -limit) && (value < limit);
+}
+
+/**
+ * Returns the signed value of a two's complement number with the specified
+ * number of bits.
+ *
+ * @param bits low-order bits of the number
+ * @param count number of bits
+ * @return signed value
+ */
+constexpr int64_t signExtend(uint64_t bits, unsigned int count)
+{
+    uint64_t signBit = uint64_t{1} << (count - 1);
+    return static_cast<int64_t>((bits ^ signBit) - signBit);
+}
+
+/**
+ * Reads bits from a block, most significant bit first.
+ */
+class BitReader
+{
+  public:
+    explicit BitReader(const uint64_t* data) : data{data} {}
+
+    uint64_t read(unsigned int count)
+    {
+        uint64_t bits{0};
+        while (count > 0)
+        {
+            unsigned int offset = position % 64;
+            unsigned int available = 64 - offset;
+            unsigned int n = std::min(count, available);
+            uint64_t word = data[position / 64];
+            uint64_t chunk = (word >> (available - n)) & lowBits(n);
+            bits = (n == 64) ? chunk : ((bits << n) | chunk);
+            position += n;
+            count -= n;
+        }
+        return bits;
+    }
+
+  private:
+    const uint64_t* data;
+    std::size_t position{0};
+};
+
+} // namespace
+
+CompressedTimeSeries::CompressedTimeSeries(std::size_t blockCount,
+                                           std::size_t blockWords) :
+    blockWords{blockWords}
+{
+    if (blockCount < 2)
+    {
+        throw std::invalid_argument{"Invalid block count: " +
+                                    std::to_string(blockCount)};
+    }
+    if (blockWords < minBlockWords)
+    {
+        throw std::invalid_argument{"Invalid block size: " +
+                                    std::to_string(blockWords)};
+    }
+    words.resize(blockCount * blockWords);
+    blocks.resize(blockCount);
+}
+
+void CompressedTimeSeries::append(int64_t timestamp, double value)
+{
+    if ((usedBlocks == 0) || !hasRoom() ||
+        (timestamp < blocks[currentBlock()].lastTimestamp))
+    {
+        startBlock();
+    }
+
+    Block& block = blocks[currentBlock()];
+    uint64_t valueBits = std::bit_cast<uint64_t>(value);
+    if (block.pointCount == 0)
+    {
+        writeBits(static_cast<uint64_t>(timestamp), 64);
+        writeBits(valueBits, 64);
+    }
+    else
+    {
+        // Unsigned arithmetic, so large jumps wrap instead of overflowing
+        int64_t delta = static_cast<int64_t>(
+            static_cast<uint64_t>(timestamp) -
+            static_cast<uint64_t>(block.lastTimestamp));
+        int64_t deltaOfDelta = static_cast<int64_t>(
+            static_cast<uint64_t>(delta) -
+            static_cast<uint64_t>(block.lastDelta));
+        uint64_t dodBits = static_cast<uint64_t>(deltaOfDelta);
+        if (deltaOfDelta == 0)
+        {
+            writeBits(0b0, 1);
+        }
+        else if (fitsInBits(deltaOfDelta, 7))
+        {
+            writeBits(0b10, 2);
+            writeBits(dodBits, 7);
+        }
+        else if (fitsInBits(deltaOfDelta, 9))
+        {
+            writeBits(0b110, 3);
+            writeBits(dodBits, 9);
+        }
+        else if (fitsInBits(deltaOfDelta, 12))
+        {
+            writeBits(0b1110, 4);
+            writeBits(dodBits, 12);
+        }
+        else
+        {
+            writeBits(0b1111, 4);
+            writeBits(dodBits, 64);
+        }
+        block.lastDelta = delta;
+
+        uint64_t xorBits = valueBits ^ block.lastValueBits;
+        if (xorBits == 0)
+        {
+            writeBits(0b0, 1);
+        }
+        else
+        {
+            // The leading zero count is stored in 5 bits
+            auto leadingZeros = std::min(
+                static_cast<unsigned int>(std::countl_zero(xorBits)), 31U);
+            auto trailingZeros =
+                static_cast<unsigned int>(std::countr_zero(xorBits));
+            if (block.hasWindow && (leadingZeros >= block.leadingZeros) &&
+                (trailingZeros >= block.trailingZeros))
+            {
+                // Meaningful bits fit in the window of the previous value
+                writeBits(0b10, 2);
+                writeBits(xorBits >> block.trailingZeros,
+                          64 - block.leadingZeros - block.trailingZeros);
+            }
+            else
+            {
+                unsigned int length = 64 - leadingZeros - trailingZeros;
+                writeBits(0b11, 2);
+                writeBits(leadingZeros, 5);
+                writeBits(length - 1, 6);
+                writeBits(xorBits >> trailingZeros, length);
+                block.leadingZeros = leadingZeros;
+                block.trailingZeros = trailingZeros;
+                block.hasWindow = true;
+            }
+        }
+    }
+
+    block.lastTimestamp = timestamp;
+    block.lastValueBits = valueBits;
+    ++block.pointCount;
+}
+
+void CompressedTimeSeries::clear()
+{
+    firstBlock = 0;
+    usedBlocks = 0;
+}
+
+std::optional<CompressedTimeSeries::Point>
+    CompressedTimeSeries::getLastPoint() const
+{
+    if (usedBlocks == 0)
+    {
+        return std::nullopt;
+    }
+    const Block& block = blocks[currentBlock()];
+    return Point{block.lastTimestamp,
+                 std::bit_cast<double>(block.lastValueBits)};
+}
+
+std::size_t CompressedTimeSeries::getPointCount() const
+{
+    std::size_t count{0};
+    for (std::size_t i = 0; i < usedBlocks; ++i)
+    {
+        count += blocks[(firstBlock + i) % blocks.size()].pointCount;
+    }
+    return count;
+}
+
+std::vector<CompressedTimeSeries::Point>
+    CompressedTimeSeries::getPoints(int64_t since) const
+{
+    std::vector<Point> points{};
+    for (std::size_t i = 0; i < usedBlocks; ++i)
+    {
+        std::size_t index = (firstBlock + i) % blocks.size();
+
+        // Timestamps do not decrease within a block, so skip blocks that
+        // end before the requested time without decoding them
+        if (blocks[index].lastTimestamp >= since)
+        {
+            decodeBlock(index, since, points);
+        }
+    }
+    return points;
+}
+
+std::size_t CompressedTimeSeries::currentBlock() const
+{
+    return (firstBlock + usedBlocks - 1) % blocks.size();
+}
+
+void CompressedTimeSeries::decodeBlock(std::size_t index, int64_t since,
+                                       std::vector<Point>& points) const
+{
+    const Block& block = blocks[index];
+    if (block.pointCount == 0)
+    {
+        return;
+    }
+
+    BitReader reader{&words[index * blockWords]};
+    auto timestamp = static_cast<int64_t>(reader.read(64));
+    uint64_t valueBits = reader.read(64);
+    uint64_t delta{0};
+    unsigned int leadingZeros{0};
+    unsigned int trailingZeros{0};
+    for (std::size_t i = 0; i < block.pointCount; ++i)
+    {
+        if (i > 0)
+        {
+            int64_t deltaOfDelta{0};
+            if (reader.read(1) == 0)
+            {
+                deltaOfDelta = 0;
+            }
+            else if (reader.read(1) == 0)
+            {
+                deltaOfDelta = signExtend(reader.read(7), 7);
+            }
+            else if (reader.read(1) == 0)
+            {
+                deltaOfDelta = signExtend(reader.read(9), 9);
+            }
+            else if (reader.read(1) == 0)
+            {
+                deltaOfDelta = signExtend(reader.read(12), 12);
+            }
+            else
+            {
+                deltaOfDelta = static_cast<int64_t>(reader.read(64));
+            }
+            delta += static_cast<uint64_t>(deltaOfDelta);
+            timestamp = static_cast<int64_t>(
+                static_cast<uint64_t>(timestamp) + delta);
+
+            if (reader.read(1) == 1)
+            {
+                if (reader.read(1) == 1)
+                {
+                    leadingZeros = static_cast<unsigned int>(reader.read(5));
+                    auto length = static_cast<unsigned int>(reader.read(6)) + 1;
+                    trailingZeros = 64 - leadingZeros - length;
+                }
+                valueBits ^= reader.read(64 - leadingZeros - trailingZeros)
+                             << trailingZeros;
+            }
+        }
+
+        if (timestamp >= since)
+        {
+            points.emplace_back(
+                Point{timestamp, std::bit_cast<double>(valueBits)});
+        }
+    }
+}
+
+bool CompressedTimeSeries::hasRoom() const
+{
+    const Block& block = blocks[currentBlock()];
+    std::size_t needed =
+        (block.pointCount == 0) ? firstPointBits : maxPointBits;
+    return (block.bitCount + needed) <= (blockWords * 64);
+}
+
+void CompressedTimeSeries::startBlock()
+{
+    if (usedBlocks < blocks.size())
+    {
+        ++usedBlocks;
+    }
+    else
+    {
+        // Reuse the oldest block
+        firstBlock = (firstBlock + 1) % blocks.size();
+    }
+
+    std::size_t index = currentBlock();
+    blocks[index] = Block{};
+    std::fill_n(words.begin() + index * blockWords, blockWords, uint64_t{0});
+}
+
+void CompressedTimeSeries::writeBits(uint64_t bits, unsigned int count)
+{
+    std::size_t index = currentBlock();
+    Block& block = blocks[index];
+    uint64_t* data = &words[index * blockWords];
+    while (count > 0)
+    {
+        unsigned int offset = block.bitCount % 64;
+        unsigned int available = 64 - offset;
+        unsigned int n = std::min(count, available);
+        uint64_t chunk = (bits >> (count - n)) & lowBits(n);
+        data[block.bitCount / 64] |= chunk << (available - n);
+        block.bitCount += n;
+        count -= n;
+    }
+}
+
+} // namespace phosphor::power::regulators
@@ -0,0 +1,255 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <vector>
+
+namespace phosphor::power::regulators
+{
+
+/**
+ * @class CompressedTimeSeries
+ *
+ * Time series of sensor values stored in a fixed amount of memory.
+ *
+ * The values are compressed using the method described in the paper "Gorilla:
+ * A Fast, Scalable, In-Memory Time Series Database".  Timestamps are stored as
+ * the difference between consecutive deltas, which is usually zero for
+ * periodic reads.  Values are stored as the XOR of consecutive values, which
+ * only has a few meaningful bits when a value is unchanged or changes
+ * slightly.
+ *
+ * The points are stored in a ring of fixed size blocks.  Each block starts
+ * with an uncompressed point, so it can be decoded on its own.  When the last
+ * block is full, the oldest block is discarded and reused.  The memory used
+ * does not change after construction.
+ *
+ * Timestamps must not decrease.  If a timestamp is earlier than the previous
+ * one, such as after the system clock was set, a new block is started.
+ */
+class CompressedTimeSeries
+{
+  public:
+    /**
+     * One point in the time series.
+     */
+    struct Point
+    {
+        /**
+         * Timestamp, such as milliseconds since the epoch.
+         */
+        int64_t timestamp;
+
+        /**
+         * Value.  May be NaN.
+         */
+        double value;
+
+        bool operator==(const Point&) const = default;
+    };
+
+    /**
+     * Minimum number of 64-bit words in each block.
+     */
+    static constexpr std::size_t minBlockWords{8};
+
+    // Specify which compiler-generated methods we want
+    CompressedTimeSeries() = delete;
+    CompressedTimeSeries(const CompressedTimeSeries&) = delete;
+    CompressedTimeSeries(CompressedTimeSeries&&) = default;
+    CompressedTimeSeries& operator=(const CompressedTimeSeries&) = delete;
+    CompressedTimeSeries& operator=(CompressedTimeSeries&&) = default;
+    ~CompressedTimeSeries() = default;
+
+    /**
+     * Constructor.
+     *
+     * Throws an exception if blockCount is less than 2 or blockWords is less
+     * than minBlockWords.
+     *
+     * @param blockCount number of blocks in the ring
+     * @param blockWords number of 64-bit words in each block
+     */
+    explicit CompressedTimeSeries(std::size_t blockCount,
+                                  std::size_t blockWords);
+
+    /**
+     * Adds a point to the end of the time series.
+     *
+     * Discards the oldest block if there is no room for the point.
+     *
+     * @param timestamp timestamp of the point
+     * @param value value of the point
+     */
+    void append(int64_t timestamp, double value);
+
+    /**
+     * Removes all the points.
+     */
+    void clear();
+
+    /**
+     * Returns the last point in the time series, if any.
+     *
+     * @return last point, or std::nullopt if the time series is empty
+     */
+    std::optional<Point> getLastPoint() const;
+
+    /**
+     * Returns the number of points in the time series.
+     *
+     * @return number of points
+     */
+    std::size_t getPointCount() const;
+
+    /**
+     * Returns the points in the time series with timestamps at or after the
+     * specified timestamp, oldest first.
+     *
+     * @param since earliest timestamp to return
+     * @return points
+     */
+    std::vector<Point>
+        getPoints(int64_t since = std::numeric_limits<int64_t>::min()) const;
+
+    /**
+     * Returns the number of bytes used to store the compressed points.
+     *
+     * This is fixed when the object is constructed.
+     *
+     * @return number of bytes
+     */
+    std::size_t getStorageSize() const
+    {
+        return words.size() * sizeof(uint64_t);
+    }
+
+  private:
+    /**
+     * State of one block in the ring.
+     */
+    struct Block
+    {
+        /**
+         * Number of points in the block.
+         */
+        std::size_t pointCount{0};
+
+        /**
+         * Number of bits written to the block.
+         */
+        std::size_t bitCount{0};
+
+        /**
+         * Timestamp of the last point.
+         */
+        int64_t lastTimestamp{0};
+
+        /**
+         * Difference between the timestamps of the last two points.
+         */
+        int64_t lastDelta{0};
+
+        /**
+         * Bits of the last value.
+         */
+        uint64_t lastValueBits{0};
+
+        /**
+         * Number of leading zero bits in the last stored XOR value.
+         */
+        unsigned int leadingZeros{0};
+
+        /**
+         * Number of trailing zero bits in the last stored XOR value.
+         */
+        unsigned int trailingZeros{0};
+
+        /**
+         * Indicates whether leadingZeros and trailingZeros are set.
+         */
+        bool hasWindow{false};
+    };
+
+    /**
+     * Returns whether the current block has room for one more point.
+     *
+     * @return true if there is room, false otherwise
+     */
+    bool hasRoom() const;
+
+    /**
+     * Returns the index of the block in the ring that points are added to.
+     *
+     * @return block index
+     */
+    std::size_t currentBlock() const;
+
+    /**
+     * Starts a new block, discarding the oldest block if necessary.
+     */
+    void startBlock();
+
+    /**
+     * Writes the specified number of low-order bits of a value to the current
+     * block.
+     *
+     * @param bits value to write
+     * @param count number of bits to write, from 1 to 64
+     */
+    void writeBits(uint64_t bits, unsigned int count);
+
+    /**
+     * Decodes the points in one block and adds them to a vector.
+     *
+     * @param index index of the block in the ring
+     * @param since earliest timestamp to add
+     * @param points vector to add the points to
+     */
+    void decodeBlock(std::size_t index, int64_t since,
+                     std::vector<Point>& points) const;
+
+    /**
+     * Number of 64-bit words in each block.
+     */
+    std::size_t blockWords;
+
+    /**
+     * Storage of all the blocks.
+     */
+    std::vector<uint64_t> words{};
+
+    /**
+     * State of all the blocks.
+     */
+    std::vector<Block> blocks{};
+
+    /**
+     * Index of the oldest block in use.
+     */
+    std::size_t firstBlock{0};
+
+    /**
+     * Number of blocks in use.
+     */
+    std::size_t usedBlocks{0};
+};
+
+} // namespace phosphor::power::regulators
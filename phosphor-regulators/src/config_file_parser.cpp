@@ -16,13 +16,22 @@
 
 #include "config_file_parser.hpp"
 
+#include "bus_budget.hpp"
 #include "config_file_parser_error.hpp"
 #include "i2c_interface.hpp"
 #include "pmbus_utils.hpp"
 
+#include <chrono>
+#include <algorithm>
+#include <cstring>
 #include <exception>
 #include <fstream>
+#include <future>
+#include <istream>
+#include <iterator>
+#include <mutex>
 #include <optional>
+#include <system_error>
 #include <utility>
 
 using json = nlohmann::json;
@@ -49,9 +58,187 @@ std::tuple<std::vector<std::unique_ptr<Rule>>,
     }
 }
 
+std::tuple<std::vector<std::unique_ptr<Rule>>,
+           std::vector<std::unique_ptr<Chassis>>>
+    parse(const std::filesystem::path& pathName,
+          const std::filesystem::path& cacheDirectory,
+          unsigned int threadCount)
+{
+    try
+    {
+        // Read the config file contents and compute the hash
+        std::ifstream file{pathName, std::ios::binary};
+        if (!file)
+        {
+            throw std::runtime_error{"Unable to open file"};
+        }
+        std::string contents{std::istreambuf_iterator<char>{file},
+                             std::istreambuf_iterator<char>{}};
+        uint64_t hash = internal::getHash(contents);
+
+        // Get tree of JSON elements from cache file if it is up to date.
+        // Otherwise use standard JSON parser.
+        std::filesystem::path cachePathName =
+            internal::getCacheFilePath(pathName, cacheDirectory);
+        std::optional<json> rootElement =
+            internal::readCacheFile(cachePathName, hash);
+        bool isCached = rootElement.has_value();
+        if (!isCached)
+        {
+            rootElement = json::parse(contents);
+        }
+
+        // Parse tree of JSON elements and create corresponding C++ objects
+        auto objects = internal::parseRoot(*rootElement, threadCount);
+
+        // Write new cache file now that the JSON elements are known to be valid
+        if (!isCached)
+        {
+            try
+            {
+                internal::writeCacheFile(cachePathName, hash, *rootElement);
+            }
+            catch (const std::exception&)
+            {
+                // Ignore error; cache is only used to improve performance
+            }
+        }
+
+        return objects;
+    }
+    catch (const std::exception& e)
+    {
+        throw ConfigFileParserError{pathName, e.what()};
+    }
+}
+
+std::tuple<std::vector<std::unique_ptr<Rule>>,
+           std::vector<std::unique_ptr<Chassis>>>
+    parse(const CompiledConfig& config, unsigned int threadCount)
+{
+    try
+    {
+        // Create tree of JSON elements from the CBOR data
+        json rootElement = json::from_cbor(config.data,
+                                           config.data + config.size);
+
+        // Parse tree of JSON elements and return corresponding C++ objects
+        return internal::parseRoot(rootElement, threadCount);
+    }
+    catch (const std::exception& e)
+    {
+        throw ConfigFileParserError{config.fileName, e.what()};
+    }
+}
+
+std::tuple<std::vector<std::unique_ptr<Rule>>,
+           std::vector<std::unique_ptr<Chassis>>>
+    parseStreaming(const std::filesystem::path& pathName)
+{
+    try
+    {
+        std::ifstream file{pathName};
+        if (!file)
+        {
+            throw std::runtime_error{"Unable to open file"};
+        }
+
+        // Parse JSON text and create C++ objects one element at a time
+        return internal::parseRootStreaming(file);
+    }
+    catch (const std::exception& e)
+    {
+        throw ConfigFileParserError{pathName, e.what()};
+    }
+}
+
+std::tuple<std::vector<std::unique_ptr<Rule>>, std::vector<DeferredChassis>>
+    parseDeferred(const std::filesystem::path& pathName)
+{
+    try
+    {
+        std::ifstream file{pathName};
+        if (!file)
+        {
+            throw std::runtime_error{"Unable to open file"};
+        }
+
+        // Parse JSON text, creating rules and deferring chassis
+        std::vector<DeferredChassis> chassis{};
+        std::vector<std::unique_ptr<Rule>> rules = internal::parseRootStreaming(
+            file, [&chassis](const json& element) {
+                chassis.emplace_back(internal::deferChassis(element));
+            });
+        return std::make_tuple(std::move(rules), std::move(chassis));
+    }
+    catch (const std::exception& e)
+    {
+        throw ConfigFileParserError{pathName, e.what()};
+    }
+}
+
+std::unique_ptr<Chassis> parseDeferredChassis(const DeferredChassis& chassis)
+{
+    // Restore tree of JSON elements for the chassis and parse it
+    json element = json::from_cbor(chassis.data);
+    return internal::parseChassis(element);
+}
+
 namespace internal
 {
 
+/**
+ * Header at the beginning of a binary cache file.
+ *
+ * The header is followed by the tree of JSON elements in CBOR format.
+ */
+struct CacheFileHeader
+{
+    /**
+     * Identifies the file as a regulators configuration cache file.
+     */
+    char magic[4]{'R', 'C', 'F', 'C'};
+
+    /**
+     * Version of the parser that created the file.
+     */
+    uint32_t parserVersion{config_file_parser::parserVersion};
+
+    /**
+     * Hash of the configuration file contents.
+     */
+    uint64_t hash{0};
+
+    /**
+     * Size of the CBOR data in bytes.
+     */
+    uint64_t dataSize{0};
+};
+
+DeferredChassis deferChassis(const json& element)
+{
+    verifyIsObject(element);
+    DeferredChassis chassis{};
+
+    // Required number property
+    const json& numberElement = getRequiredProperty(element, "number");
+    chassis.number = parseUnsignedInteger(numberElement);
+    if (chassis.number < 1)
+    {
+        throw std::invalid_argument{"Invalid chassis number: Must be > 0"};
+    }
+
+    // Required inventory_path property
+    const json& inventoryPathElement =
+        getRequiredProperty(element, "inventory_path");
+    chassis.inventoryPath = parseInventoryPath(inventoryPathElement);
+
+    // Store JSON elements in compact format; other properties verified later
+    chassis.data = json::to_cbor(element);
+
+    return chassis;
+}
+
 std::unique_ptr<Action> parseAction(const json& element)
 {
     verifyIsObject(element);
@@ -100,6 +287,11 @@ std::unique_ptr<Action> parseAction(const json& element)
         action = parseI2CCompareBytes(element["i2c_compare_bytes"]);
         ++propertyCount;
     }
+    else if (element.contains("i2c_probe"))
+    {
+        action = parseI2CProbe(element["i2c_probe"]);
+        ++propertyCount;
+    }
     else if (element.contains("i2c_write_bit"))
     {
         action = parseI2CWriteBit(element["i2c_write_bit"]);
@@ -135,11 +327,22 @@ std::unique_ptr<Action> parseAction(const json& element)
         action = parseOr(element["or"]);
         ++propertyCount;
     }
+    else if (element.contains("pmbus_read_block_sensors"))
+    {
+        action =
+            parsePMBusReadBlockSensors(element["pmbus_read_block_sensors"]);
+        ++propertyCount;
+    }
     else if (element.contains("pmbus_read_sensor"))
     {
         action = parsePMBusReadSensor(element["pmbus_read_sensor"]);
         ++propertyCount;
     }
+    else if (element.contains("pmbus_read_sensors"))
+    {
+        action = parsePMBusReadSensors(element["pmbus_read_sensors"]);
+        ++propertyCount;
+    }
     else if (element.contains("pmbus_write_vout_command"))
     {
         action =
@@ -171,6 +374,7 @@ std::vector<std::unique_ptr<Action>> parseActionArray(const json& element)
 {
     verifyIsArray(element);
     std::vector<std::unique_ptr<Action>> actions;
+    actions.reserve(element.size());
     for (auto& actionElement : element)
     {
         actions.emplace_back(parseAction(actionElement));
@@ -178,6 +382,44 @@ std::vector<std::unique_ptr<Action>> parseActionArray(const json& element)
     return actions;
 }
 
+AdaptiveInterval parseAdaptiveInterval(const json& element)
+{
+    verifyIsObject(element);
+    unsigned int propertyCount{0};
+
+    // Optional comments property; value not stored
+    if (element.contains("comments"))
+    {
+        ++propertyCount;
+    }
+
+    // Required min_interval_ms property
+    const json& minIntervalElement =
+        getRequiredProperty(element, "min_interval_ms");
+    std::chrono::milliseconds minInterval =
+        parseMonitoringInterval(minIntervalElement);
+    ++propertyCount;
+
+    // Optional change_percent property
+    double changePercent{1.0};
+    auto changePercentIt = element.find("change_percent");
+    if (changePercentIt != element.end())
+    {
+        changePercent = parseDouble(*changePercentIt);
+        if (changePercent <= 0.0)
+        {
+            throw std::invalid_argument{
+                "Invalid change_percent value: Must be > 0"};
+        }
+        ++propertyCount;
+    }
+
+    // Verify no invalid properties exist
+    verifyPropertyCount(element, propertyCount);
+
+    return AdaptiveInterval{minInterval, changePercent};
+}
+
 std::unique_ptr<AndAction> parseAnd(const json& element)
 {
     verifyIsArray(element);
@@ -228,16 +470,47 @@ std::unique_ptr<Chassis> parseChassis(const json& element)
         ++propertyCount;
     }
 
+    // Optional parallel_configuration property
+    bool parallelConfiguration{false};
+    auto parallelConfigurationIt = element.find("parallel_configuration");
+    if (parallelConfigurationIt != element.end())
+    {
+        parallelConfiguration = parseBoolean(*parallelConfigurationIt);
+        ++propertyCount;
+    }
+
+    // Optional independent_monitoring property
+    bool independentMonitoring{false};
+    auto independentMonitoringIt = element.find("independent_monitoring");
+    if (independentMonitoringIt != element.end())
+    {
+        independentMonitoring = parseBoolean(*independentMonitoringIt);
+        ++propertyCount;
+    }
+
+    // Optional deferred_write_verification property
+    bool deferredWriteVerification{false};
+    auto deferredWriteVerificationIt =
+        element.find("deferred_write_verification");
+    if (deferredWriteVerificationIt != element.end())
+    {
+        deferredWriteVerification = parseBoolean(*deferredWriteVerificationIt);
+        ++propertyCount;
+    }
+
     // Verify no invalid properties exist
     verifyPropertyCount(element, propertyCount);
 
-    return std::make_unique<Chassis>(number, inventoryPath, std::move(devices));
+    return std::make_unique<Chassis>(
+        number, inventoryPath, std::move(devices), parallelConfiguration,
+        independentMonitoring, deferredWriteVerification);
 }
 
 std::vector<std::unique_ptr<Chassis>> parseChassisArray(const json& element)
 {
     verifyIsArray(element);
     std::vector<std::unique_ptr<Chassis>> chassis;
+    chassis.reserve(element.size());
     for (auto& chassisElement : element)
     {
         chassis.emplace_back(parseChassis(chassisElement));
@@ -419,19 +692,79 @@ std::unique_ptr<Device> parseDevice(const json& element)
         ++propertyCount;
     }
 
+    // Optional depends_on property
+    std::vector<std::string> dependsOn{};
+    auto dependsOnIt = element.find("depends_on");
+    if (dependsOnIt != element.end())
+    {
+        verifyIsArray(*dependsOnIt);
+        for (const json& deviceIDElement : *dependsOnIt)
+        {
+            dependsOn.emplace_back(parseString(deviceIDElement));
+        }
+        ++propertyCount;
+    }
+
+    // Optional power_domain property
+    std::unique_ptr<PowerDomain> powerDomain{};
+    auto powerDomainIt = element.find("power_domain");
+    if (powerDomainIt != element.end())
+    {
+        powerDomain = parsePowerDomain(*powerDomainIt);
+        ++propertyCount;
+    }
+
+    // Optional is_standby_powered property
+    bool isStandbyPowered{false};
+    auto isStandbyPoweredIt = element.find("is_standby_powered");
+    if (isStandbyPoweredIt != element.end())
+    {
+        isStandbyPowered = parseBoolean(*isStandbyPoweredIt);
+        ++propertyCount;
+    }
+
     // Verify no invalid properties exist
     verifyPropertyCount(element, propertyCount);
 
-    return std::make_unique<Device>(
+    auto device = std::make_unique<Device>(
         id, isRegulator, fru, std::move(i2cInterface),
         std::move(presenceDetection), std::move(configuration),
-        std::move(phaseFaultDetection), std::move(rails));
+        std::move(phaseFaultDetection), std::move(rails), std::move(dependsOn));
+
+    // Optional auto_increment property of the i2c_interface; validated by
+    // parseI2CInterface()
+    auto autoIncrementIt = i2cInterfaceElement.find("auto_increment");
+    if (autoIncrementIt != i2cInterfaceElement.end())
+    {
+        device->setAutoIncrement(parseBoolean(*autoIncrementIt));
+    }
+
+    // Optional shadow_registers and volatile_registers properties of the
+    // i2c_interface; validated by parseI2CInterface()
+    auto shadowRegistersIt = i2cInterfaceElement.find("shadow_registers");
+    if (shadowRegistersIt != i2cInterfaceElement.end())
+    {
+        device->setShadowRegisters(parseBoolean(*shadowRegistersIt));
+    }
+    auto volatileRegistersIt = i2cInterfaceElement.find("volatile_registers");
+    if (volatileRegistersIt != i2cInterfaceElement.end())
+    {
+        device->setVolatileRegisters(parseHexByteArray(*volatileRegistersIt));
+    }
+
+    device->setPowerDomain(std::move(powerDomain));
+    device->setStandbyPowered(isStandbyPowered);
+
+    // Hash of the definition; used to find unchanged devices during a reload
+    device->setDefinitionHash(internal::getHash(element.dump()));
+    return device;
 }
 
 std::vector<std::unique_ptr<Device>> parseDeviceArray(const json& element)
 {
     verifyIsArray(element);
     std::vector<std::unique_ptr<Device>> devices;
+    devices.reserve(element.size());
     for (auto& deviceElement : element)
     {
         devices.emplace_back(parseDevice(deviceElement));
@@ -439,10 +772,33 @@ std::vector<std::unique_ptr<Device>> parseDeviceArray(const json& element)
     return devices;
 }
 
+std::unique_ptr<EnableDetection> parseEnableDetection(const json& element)
+{
+    verifyIsObject(element);
+    unsigned int propertyCount{0};
+
+    // Optional comments property; value not stored
+    if (element.contains("comments"))
+    {
+        ++propertyCount;
+    }
+
+    // Required rule_id or actions property
+    std::vector<std::unique_ptr<Action>> actions{};
+    actions = parseRuleIDOrActionsProperty(element);
+    ++propertyCount;
+
+    // Verify no invalid properties exist
+    verifyPropertyCount(element, propertyCount);
+
+    return std::make_unique<EnableDetection>(std::move(actions));
+}
+
 std::vector<uint8_t> parseHexByteArray(const json& element)
 {
     verifyIsArray(element);
     std::vector<uint8_t> values;
+    values.reserve(element.size());
     for (auto& valueElement : element)
     {
         values.emplace_back(parseHexByte(valueElement));
@@ -469,10 +825,19 @@ std::unique_ptr<I2CCaptureBytesAction> parseI2CCaptureBytes(const json& element)
     }
     ++propertyCount;
 
+    // Optional large_read property
+    bool isLargeRead{false};
+    auto largeReadIt = element.find("large_read");
+    if (largeReadIt != element.end())
+    {
+        isLargeRead = parseBoolean(*largeReadIt);
+        ++propertyCount;
+    }
+
     // Verify no invalid properties exist
     verifyPropertyCount(element, propertyCount);
 
-    return std::make_unique<I2CCaptureBytesAction>(reg, count);
+    return std::make_unique<I2CCaptureBytesAction>(reg, count, isLargeRead);
 }
 
 std::unique_ptr<I2CCompareBitAction> parseI2CCompareBit(const json& element)
@@ -586,13 +951,123 @@ std::unique_ptr<i2c::I2CInterface> parseI2CInterface(const json& element)
     uint8_t address = parseHexByte(addressElement);
     ++propertyCount;
 
+    // Optional max_transactions_per_second property
+    std::optional<double> maxTransactionsPerSecond{};
+    auto maxTransactionsIt = element.find("max_transactions_per_second");
+    if (maxTransactionsIt != element.end())
+    {
+        maxTransactionsPerSecond = parseDouble(*maxTransactionsIt);
+        if (*maxTransactionsPerSecond <= 0.0)
+        {
+            throw std::invalid_argument{
+                "Invalid max_transactions_per_second value: Must be > 0"};
+        }
+        ++propertyCount;
+    }
+
+    // Optional auto_increment property; stored in the Device by parseDevice()
+    auto autoIncrementIt = element.find("auto_increment");
+    if (autoIncrementIt != element.end())
+    {
+        parseBoolean(*autoIncrementIt);
+        ++propertyCount;
+    }
+
+    // Optional shadow_registers property; stored in the Device by
+    // parseDevice()
+    auto shadowRegistersIt = element.find("shadow_registers");
+    if (shadowRegistersIt != element.end())
+    {
+        parseBoolean(*shadowRegistersIt);
+        ++propertyCount;
+    }
+
+    // Optional volatile_registers property; stored in the Device by
+    // parseDevice()
+    auto volatileRegistersIt = element.find("volatile_registers");
+    if (volatileRegistersIt != element.end())
+    {
+        parseHexByteArray(*volatileRegistersIt);
+        ++propertyCount;
+    }
+
     // Verify no invalid properties exist
     verifyPropertyCount(element, propertyCount);
 
-    // Create I2CInterface object; retry failed I2C operations a max of 3 times.
-    int maxRetries{3};
+    // Limit the transactions on the bus.  The budget is shared by all the
+    // devices on the bus, so use the lowest one specified for the bus.  The
+    // chassis may be parsed in parallel by parseRoot(), so check and set the
+    // budget atomically.
+    if (maxTransactionsPerSecond)
+    {
+        static std::mutex budgetMutex{};
+        std::lock_guard<std::mutex> lock{budgetMutex};
+        std::optional<i2c::BusBudget> budget = i2c::getBusBudget(bus);
+        if (!budget ||
+            (*maxTransactionsPerSecond < budget->transactionsPerSecond))
+        {
+            i2c::setBusBudget(bus, i2c::BusBudget{*maxTransactionsPerSecond});
+        }
+    }
+
+    // Create I2CInterface object; retry failed I2C operations a max of 3
+    // times.  Back off between retries so that bus contention has time to
+    // clear, but give up after 50ms so a monitoring cycle is not held up.
+    i2c::RetryPolicy retryPolicy{};
+    retryPolicy.maxRetries = 3;
+    retryPolicy.initialDelay = std::chrono::milliseconds{1};
+    retryPolicy.maxDelay = std::chrono::milliseconds{8};
+    retryPolicy.maxJitter = std::chrono::microseconds{500};
+    retryPolicy.deadline = std::chrono::milliseconds{50};
+
+    // Close the device when it has not been used for a minute.  Devices that
+    // are only used when they are configured then do not keep their bus open.
+    // Devices that are monitored stay open.
+    i2c::IdlePolicy idlePolicy{};
+    idlePolicy.idleTimeout = std::chrono::minutes{1};
     return i2c::create(bus, address, i2c::I2CInterface::InitialState::CLOSED,
-                       maxRetries);
+                       retryPolicy, idlePolicy);
+}
+
+std::unique_ptr<I2CProbeAction> parseI2CProbe(const json& element)
+{
+    verifyIsObject(element);
+    unsigned int propertyCount{0};
+
+    // Optional method property
+    I2CProbeAction::Method method{I2CProbeAction::Method::readByte};
+    auto methodIt = element.find("method");
+    if (methodIt != element.end())
+    {
+        method = parseI2CProbeMethod(*methodIt);
+        ++propertyCount;
+    }
+
+    // Verify no invalid properties exist
+    verifyPropertyCount(element, propertyCount);
+
+    return std::make_unique<I2CProbeAction>(method);
+}
+
+I2CProbeAction::Method parseI2CProbeMethod(const json& element)
+{
+    std::string value = parseString(element);
+    I2CProbeAction::Method method{};
+
+    if (value == "quick")
+    {
+        method = I2CProbeAction::Method::quick;
+    }
+    else if (value == "read_byte")
+    {
+        method = I2CProbeAction::Method::readByte;
+    }
+    else
+    {
+        throw std::invalid_argument{"Element is not an I2C probe method"};
+    }
+
+    return method;
 }
 
 std::unique_ptr<I2CWriteBitAction> parseI2CWriteBit(const json& element)
@@ -752,6 +1227,19 @@ std::unique_ptr<LogPhaseFaultAction> parseLogPhaseFault(const json& element)
     return std::make_unique<LogPhaseFaultAction>(type);
 }
 
+std::chrono::milliseconds parseMonitoringInterval(const json& element)
+{
+    std::chrono::milliseconds interval{parseUnsignedInteger(element)};
+
+    // Do not allow an interval so short that sensor reads dominate the bus
+    if (interval < std::chrono::milliseconds{100})
+    {
+        throw std::invalid_argument{"Invalid monitoring interval: Must be >= "
+                                    "100 milliseconds"};
+    }
+    return interval;
+}
+
 std::unique_ptr<NotAction> parseNot(const json& element)
 {
     // Required action to execute
@@ -828,24 +1316,30 @@ PhaseFaultType parsePhaseFaultType(const json& element)
     return type;
 }
 
-std::unique_ptr<PMBusReadSensorAction> parsePMBusReadSensor(const json& element)
+std::unique_ptr<PMBusReadBlockSensorsAction>
+    parsePMBusReadBlockSensors(const json& element)
 {
     verifyIsObject(element);
     unsigned int propertyCount{0};
 
-    // Required type property
-    const json& typeElement = getRequiredProperty(element, "type");
-    SensorType type = parseSensorType(typeElement);
-    ++propertyCount;
-
     // Required command property
     const json& commandElement = getRequiredProperty(element, "command");
     uint8_t command = parseHexByte(commandElement);
     ++propertyCount;
 
-    // Required format property
-    const json& formatElement = getRequiredProperty(element, "format");
-    pmbus_utils::SensorDataFormat format = parseSensorDataFormat(formatElement);
+    // Required sensors property
+    const json& sensorsElement = getRequiredProperty(element, "sensors");
+    verifyIsArray(sensorsElement);
+    if (sensorsElement.empty())
+    {
+        throw std::invalid_argument{"Array must contain one or more sensors"};
+    }
+    std::vector<PMBusReadBlockSensorsAction::Sensor> sensors;
+    sensors.reserve(sensorsElement.size());
+    for (auto& sensorElement : sensorsElement)
+    {
+        sensors.emplace_back(parsePMBusReadBlockSensorsSensor(sensorElement));
+    }
     ++propertyCount;
 
     // Optional exponent property
@@ -860,19 +1354,186 @@ std::unique_ptr<PMBusReadSensorAction> parsePMBusReadSensor(const json& element)
     // Verify no invalid properties exist
     verifyPropertyCount(element, propertyCount);
 
-    return std::make_unique<PMBusReadSensorAction>(type, command, format,
-                                                   exponent);
+    return std::make_unique<PMBusReadBlockSensorsAction>(
+        command, std::move(sensors), exponent);
 }
 
-std::unique_ptr<PMBusWriteVoutCommandAction>
-    parsePMBusWriteVoutCommand(const json& element)
+PMBusReadBlockSensorsAction::Sensor
+    parsePMBusReadBlockSensorsSensor(const json& element)
 {
     verifyIsObject(element);
     unsigned int propertyCount{0};
+    PMBusReadBlockSensorsAction::Sensor sensor{};
 
-    // Optional volts property
-    std::optional<double> volts{};
-    auto voltsIt = element.find("volts");
+    // Required type property
+    const json& typeElement = getRequiredProperty(element, "type");
+    sensor.type = parseSensorType(typeElement);
+    ++propertyCount;
+
+    // Required offset property
+    const json& offsetElement = getRequiredProperty(element, "offset");
+    sensor.offset = parseUint8(offsetElement);
+    ++propertyCount;
+
+    // Required format property.  A raw value has no SensorDataFormat.
+    const json& formatElement = getRequiredProperty(element, "format");
+    if (formatElement.is_string() &&
+        (formatElement.get<std::string>() == "raw"))
+    {
+        // Optional size property
+        auto sizeIt = element.find("size");
+        if (sizeIt != element.end())
+        {
+            sensor.size = parseUint8(*sizeIt);
+            ++propertyCount;
+        }
+
+        // Optional scale property
+        auto scaleIt = element.find("scale");
+        if (scaleIt != element.end())
+        {
+            sensor.scale = parseDouble(*scaleIt);
+            ++propertyCount;
+        }
+    }
+    else
+    {
+        sensor.format = parseSensorDataFormat(formatElement);
+    }
+    ++propertyCount;
+
+    // Verify no invalid properties exist
+    verifyPropertyCount(element, propertyCount);
+
+    return sensor;
+}
+
+std::unique_ptr<PMBusReadSensorAction> parsePMBusReadSensor(const json& element)
+{
+    verifyIsObject(element);
+    unsigned int propertyCount{0};
+
+    // Required type property
+    const json& typeElement = getRequiredProperty(element, "type");
+    SensorType type = parseSensorType(typeElement);
+    ++propertyCount;
+
+    // Required command property
+    const json& commandElement = getRequiredProperty(element, "command");
+    uint8_t command = parseHexByte(commandElement);
+    ++propertyCount;
+
+    // Required format property
+    const json& formatElement = getRequiredProperty(element, "format");
+    pmbus_utils::SensorDataFormat format = parseSensorDataFormat(formatElement);
+    ++propertyCount;
+
+    // Optional exponent property
+    std::optional<int8_t> exponent{};
+    auto exponentIt = element.find("exponent");
+    if (exponentIt != element.end())
+    {
+        exponent = parseInt8(*exponentIt);
+        ++propertyCount;
+    }
+
+    // Optional aggregation property
+    std::optional<SensorAggregation> aggregation{};
+    auto aggregationIt = element.find("aggregation");
+    if (aggregationIt != element.end())
+    {
+        aggregation = parseSensorAggregation(*aggregationIt);
+        ++propertyCount;
+    }
+
+    // Verify no invalid properties exist
+    verifyPropertyCount(element, propertyCount);
+
+    return std::make_unique<PMBusReadSensorAction>(type, command, format,
+                                                   exponent, aggregation);
+}
+
+std::unique_ptr<PMBusReadSensorsAction>
+    parsePMBusReadSensors(const json& element)
+{
+    verifyIsObject(element);
+    unsigned int propertyCount{0};
+
+    // Required sensors property
+    const json& sensorsElement = getRequiredProperty(element, "sensors");
+    verifyIsArray(sensorsElement);
+    if (sensorsElement.empty())
+    {
+        throw std::invalid_argument{"Array must contain one or more sensors"};
+    }
+    std::vector<PMBusReadSensorsAction::Sensor> sensors;
+    sensors.reserve(sensorsElement.size());
+    for (auto& sensorElement : sensorsElement)
+    {
+        sensors.emplace_back(parsePMBusReadSensorsSensor(sensorElement));
+    }
+    ++propertyCount;
+
+    // Optional page property
+    std::optional<uint8_t> page{};
+    auto pageIt = element.find("page");
+    if (pageIt != element.end())
+    {
+        page = parseHexByte(*pageIt);
+        ++propertyCount;
+    }
+
+    // Optional exponent property
+    std::optional<int8_t> exponent{};
+    auto exponentIt = element.find("exponent");
+    if (exponentIt != element.end())
+    {
+        exponent = parseInt8(*exponentIt);
+        ++propertyCount;
+    }
+
+    // Verify no invalid properties exist
+    verifyPropertyCount(element, propertyCount);
+
+    return std::make_unique<PMBusReadSensorsAction>(std::move(sensors), page,
+                                                    exponent);
+}
+
+PMBusReadSensorsAction::Sensor parsePMBusReadSensorsSensor(const json& element)
+{
+    verifyIsObject(element);
+    unsigned int propertyCount{0};
+
+    // Required type property
+    const json& typeElement = getRequiredProperty(element, "type");
+    SensorType type = parseSensorType(typeElement);
+    ++propertyCount;
+
+    // Required command property
+    const json& commandElement = getRequiredProperty(element, "command");
+    uint8_t command = parseHexByte(commandElement);
+    ++propertyCount;
+
+    // Required format property
+    const json& formatElement = getRequiredProperty(element, "format");
+    pmbus_utils::SensorDataFormat format = parseSensorDataFormat(formatElement);
+    ++propertyCount;
+
+    // Verify no invalid properties exist
+    verifyPropertyCount(element, propertyCount);
+
+    return PMBusReadSensorsAction::Sensor{type, command, format};
+}
+
+std::unique_ptr<PMBusWriteVoutCommandAction>
+    parsePMBusWriteVoutCommand(const json& element)
+{
+    verifyIsObject(element);
+    unsigned int propertyCount{0};
+
+    // Optional volts property
+    std::optional<double> volts{};
+    auto voltsIt = element.find("volts");
     if (voltsIt != element.end())
     {
         volts = parseDouble(*voltsIt);
@@ -914,6 +1575,43 @@ std::unique_ptr<PMBusWriteVoutCommandAction>
                                                          exponent, isVerified);
 }
 
+std::unique_ptr<PowerDomain> parsePowerDomain(const json& element)
+{
+    verifyIsObject(element);
+    unsigned int propertyCount{0};
+
+    // Optional comments property; value not stored
+    if (element.contains("comments"))
+    {
+        ++propertyCount;
+    }
+
+    // Required name property
+    const json& nameElement = getRequiredProperty(element, "name");
+    std::string name = parseString(nameElement);
+    ++propertyCount;
+
+    // Required sequencer_rails property
+    const json& railsElement = getRequiredProperty(element, "sequencer_rails");
+    verifyIsArray(railsElement);
+    if (railsElement.empty())
+    {
+        throw std::invalid_argument{
+            "Array must contain one or more sequencer rails"};
+    }
+    std::vector<unsigned int> sequencerRails{};
+    for (const json& railElement : railsElement)
+    {
+        sequencerRails.emplace_back(parseUnsignedInteger(railElement));
+    }
+    ++propertyCount;
+
+    // Verify no invalid properties exist
+    verifyPropertyCount(element, propertyCount);
+
+    return std::make_unique<PowerDomain>(name, std::move(sequencerRails));
+}
+
 std::unique_ptr<PresenceDetection> parsePresenceDetection(const json& element)
 {
     verifyIsObject(element);
@@ -930,10 +1628,24 @@ std::unique_ptr<PresenceDetection> parsePresenceDetection(const json& element)
     actions = parseRuleIDOrActionsProperty(element);
     ++propertyCount;
 
+    // Optional cache_ttl_ms property
+    std::optional<std::chrono::milliseconds> cacheTTL{};
+    auto cacheTTLIt = element.find("cache_ttl_ms");
+    if (cacheTTLIt != element.end())
+    {
+        cacheTTL = std::chrono::milliseconds{parseUnsignedInteger(*cacheTTLIt)};
+        if (cacheTTL->count() == 0)
+        {
+            throw std::invalid_argument{
+                "Invalid presence cache TTL: Must be > 0"};
+        }
+        ++propertyCount;
+    }
+
     // Verify no invalid properties exist
     verifyPropertyCount(element, propertyCount);
 
-    return std::make_unique<PresenceDetection>(std::move(actions));
+    return std::make_unique<PresenceDetection>(std::move(actions), cacheTTL);
 }
 
 std::unique_ptr<Rail> parseRail(const json& element)
@@ -970,17 +1682,29 @@ std::unique_ptr<Rail> parseRail(const json& element)
         ++propertyCount;
     }
 
+    // Optional voltage_setpoint property
+    std::unique_ptr<VoltageSetpoint> voltageSetpoint{};
+    auto voltageSetpointIt = element.find("voltage_setpoint");
+    if (voltageSetpointIt != element.end())
+    {
+        voltageSetpoint = parseVoltageSetpoint(*voltageSetpointIt);
+        ++propertyCount;
+    }
+
     // Verify no invalid properties exist
     verifyPropertyCount(element, propertyCount);
 
-    return std::make_unique<Rail>(id, std::move(configuration),
-                                  std::move(sensorMonitoring));
+    auto rail = std::make_unique<Rail>(id, std::move(configuration),
+                                       std::move(sensorMonitoring));
+    rail->setVoltageSetpoint(std::move(voltageSetpoint));
+    return rail;
 }
 
 std::vector<std::unique_ptr<Rail>> parseRailArray(const json& element)
 {
     verifyIsArray(element);
     std::vector<std::unique_ptr<Rail>> rails;
+    rails.reserve(element.size());
     for (auto& railElement : element)
     {
         rails.emplace_back(parseRail(railElement));
@@ -988,9 +1712,103 @@ std::vector<std::unique_ptr<Rail>> parseRailArray(const json& element)
     return rails;
 }
 
+/**
+ * Minimum number of elements in each range of a JSON array that is parsed by
+ * its own worker thread.  Smaller arrays are not worth the cost of starting a
+ * thread.
+ */
+constexpr std::size_t parallelParseMinElementCount{32};
+
+/**
+ * Starts parsing the elements of the specified JSON array.
+ *
+ * The array is split into at most threadCount ranges of consecutive elements.
+ * Each range is parsed by its own worker thread.  If the array only contains
+ * one range, or if a worker thread cannot be started, the range is parsed by
+ * the thread that gets its result.
+ *
+ * @param element JSON array
+ * @param parseElement function that parses one element of the array
+ * @param threadCount maximum number of worker threads
+ * @return futures containing the objects for each range, in file order
+ */
+template <typename T>
+std::vector<std::future<std::vector<std::unique_ptr<T>>>>
+    startParsing(const json& element,
+                 std::unique_ptr<T> (*parseElement)(const json&),
+                 unsigned int threadCount)
+{
+    std::size_t size = element.size();
+    std::size_t rangeCount = std::max<std::size_t>(
+        std::min<std::size_t>(threadCount,
+                              size / parallelParseMinElementCount),
+        1);
+
+    std::vector<std::future<std::vector<std::unique_ptr<T>>>> ranges{};
+    ranges.reserve(rangeCount);
+    for (std::size_t i = 0; i < rangeCount; ++i)
+    {
+        std::size_t first = i * size / rangeCount;
+        std::size_t last = (i + 1) * size / rangeCount;
+        auto parseRange = [&element, parseElement, first, last]() {
+            std::vector<std::unique_ptr<T>> objects{};
+            objects.reserve(last - first);
+            for (std::size_t index = first; index < last; ++index)
+            {
+                objects.emplace_back(parseElement(element[index]));
+            }
+            return objects;
+        };
+
+        std::launch policy = (rangeCount > 1) ? std::launch::async
+                                              : std::launch::deferred;
+        try
+        {
+            ranges.emplace_back(std::async(policy, parseRange));
+        }
+        catch (const std::system_error&)
+        {
+            // Unable to start a thread; parse this range when it is needed
+            ranges.emplace_back(std::async(std::launch::deferred, parseRange));
+        }
+    }
+    return ranges;
+}
+
+/**
+ * Waits for the ranges started by startParsing() and merges their objects.
+ *
+ * The ranges are waited for in file order.  If a range failed, its exception
+ * is re-thrown, so the error reported is always the first one in the file.
+ * The remaining workers are waited for by the future destructors.
+ *
+ * @param ranges futures containing the objects for each range
+ * @return objects for all the elements of the array, in file order
+ */
+template <typename T>
+std::vector<std::unique_ptr<T>> finishParsing(
+    std::vector<std::future<std::vector<std::unique_ptr<T>>>>& ranges)
+{
+    std::vector<std::unique_ptr<T>> objects{};
+    for (auto& range : ranges)
+    {
+        std::vector<std::unique_ptr<T>> rangeObjects = range.get();
+        if (objects.empty())
+        {
+            objects = std::move(rangeObjects);
+        }
+        else
+        {
+            std::move(rangeObjects.begin(), rangeObjects.end(),
+                      std::back_inserter(objects));
+        }
+    }
+    return objects;
+}
+
 std::tuple<std::vector<std::unique_ptr<Rule>>,
            std::vector<std::unique_ptr<Chassis>>>
-    parseRoot(const json& element)
+    parseRoot(const json& element, unsigned int threadCount)
 {
     verifyIsObject(element);
     unsigned int propertyCount{0};
@@ -1001,19 +1819,35 @@ std::tuple<std::vector<std::unique_ptr<Rule>>,
         ++propertyCount;
     }
 
-    // Optional rules property
-    std::vector<std::unique_ptr<Rule>> rules{};
+    // Optional rules property.  Start parsing the rule array.
+    std::vector<std::future<std::vector<std::unique_ptr<Rule>>>> ruleRanges{};
     auto rulesIt = element.find("rules");
     if (rulesIt != element.end())
     {
-        rules = parseRuleArray(*rulesIt);
+        verifyIsArray(*rulesIt);
+        ruleRanges = startParsing(*rulesIt, &parseRule, threadCount);
         ++propertyCount;
     }
 
+    // Start parsing the chassis array at the same time as the rule array.  If
+    // the chassis property is invalid, its error is reported below after any
+    // error in the rules.
+    std::vector<std::future<std::vector<std::unique_ptr<Chassis>>>>
+        chassisRanges{};
+    auto chassisIt = element.find("chassis");
+    if ((chassisIt != element.end()) && chassisIt->is_array())
+    {
+        chassisRanges = startParsing(*chassisIt, &parseChassis, threadCount);
+    }
+
+    // Merge the rules, reporting the first error in the rule array
+    std::vector<std::unique_ptr<Rule>> rules = finishParsing(ruleRanges);
+
     // Required chassis property
     const json& chassisElement = getRequiredProperty(element, "chassis");
+    verifyIsArray(chassisElement);
     std::vector<std::unique_ptr<Chassis>> chassis =
-        parseChassisArray(chassisElement);
+        finishParsing(chassisRanges);
     ++propertyCount;
 
     // Verify no invalid properties exist
@@ -1022,6 +1856,81 @@ std::tuple<std::vector<std::unique_ptr<Rule>>,
     return std::make_tuple(std::move(rules), std::move(chassis));
 }
 
+std::tuple<std::vector<std::unique_ptr<Rule>>,
+           std::vector<std::unique_ptr<Chassis>>>
+    parseRootStreaming(std::istream& input)
+{
+    // Create each chassis as soon as its JSON elements have been read
+    std::vector<std::unique_ptr<Chassis>> chassis{};
+    std::vector<std::unique_ptr<Rule>> rules =
+        parseRootStreaming(input, [&chassis](const json& element) {
+            chassis.emplace_back(parseChassis(element));
+        });
+    return std::make_tuple(std::move(rules), std::move(chassis));
+}
+
+std::vector<std::unique_ptr<Rule>>
+    parseRootStreaming(std::istream& input,
+                       const ChassisElementHandler& handleChassis)
+{
+    std::vector<std::unique_ptr<Rule>> rules{};
+
+    // Name of the current property of the root element, and whether the
+    // parser is inside the array value of the "rules" or "chassis" property
+    std::string property{};
+    bool isInArray{false};
+
+    // Callback invoked by the JSON parser for each parsing event.  The depth
+    // of the root element is 0, and the depth of the elements in the "rules"
+    // and "chassis" arrays is 2.
+    json::parser_callback_t callback =
+        [&](int depth, json::parse_event_t event, json& parsed) {
+        if (depth == 1)
+        {
+            if (event == json::parse_event_t::key)
+            {
+                property = parsed.get<std::string>();
+            }
+            else if (event == json::parse_event_t::array_start)
+            {
+                isInArray = (property == "rules") || (property == "chassis");
+            }
+            else if (event == json::parse_event_t::array_end)
+            {
+                isInArray = false;
+            }
+        }
+        else if ((depth == 2) && isInArray &&
+                 ((event == json::parse_event_t::object_end) ||
+                  (event == json::parse_event_t::array_end) ||
+                  (event == json::parse_event_t::value)))
+        {
+            // Element in the array has been read.  Handle the element and
+            // discard it.
+            if (property == "rules")
+            {
+                rules.emplace_back(parseRule(parsed));
+            }
+            else
+            {
+                handleChassis(parsed);
+            }
+            return false;
+        }
+        return true;
+    };
+
+    // Parse JSON text.  The "rules" and "chassis" arrays in the resulting root
+    // element are empty because their elements were discarded.
+    json rootElement = json::parse(input, callback);
+
+    // Verify the rest of the root element.  No objects are returned because
+    // the arrays are empty.
+    parseRoot(rootElement);
+
+    return rules;
+}
+
 std::unique_ptr<Rule> parseRule(const json& element)
 {
     verifyIsObject(element);
@@ -1047,13 +1956,18 @@ std::unique_ptr<Rule> parseRule(const json& element)
     // Verify no invalid properties exist
     verifyPropertyCount(element, propertyCount);
 
-    return std::make_unique<Rule>(id, std::move(actions));
+    auto rule = std::make_unique<Rule>(id, std::move(actions));
+
+    // Hash of the definition; used to find unchanged rules during a reload
+    rule->setDefinitionHash(internal::getHash(element.dump()));
+    return rule;
 }
 
 std::vector<std::unique_ptr<Rule>> parseRuleArray(const json& element)
 {
     verifyIsArray(element);
     std::vector<std::unique_ptr<Rule>> rules;
+    rules.reserve(element.size());
     for (auto& ruleElement : element)
     {
         rules.emplace_back(parseRule(ruleElement));
@@ -1095,6 +2009,80 @@ std::unique_ptr<RunRuleAction> parseRunRule(const json& element)
     return std::make_unique<RunRuleAction>(ruleID);
 }
 
+SamplingGroup parseSamplingGroup(const json& element)
+{
+    verifyIsObject(element);
+    unsigned int propertyCount{0};
+
+    // Optional comments property; value not stored
+    if (element.contains("comments"))
+    {
+        ++propertyCount;
+    }
+
+    // Required divisor property
+    const json& divisorElement = getRequiredProperty(element, "divisor");
+    unsigned int divisor = parseUnsignedInteger(divisorElement);
+    if (divisor < 1)
+    {
+        throw std::invalid_argument{"Invalid divisor value: Must be >= 1"};
+    }
+    ++propertyCount;
+
+    // Required rule_id or actions property
+    std::vector<std::unique_ptr<Action>> actions{};
+    actions = parseRuleIDOrActionsProperty(element);
+    ++propertyCount;
+
+    // Verify no invalid properties exist
+    verifyPropertyCount(element, propertyCount);
+
+    return SamplingGroup{divisor, std::move(actions)};
+}
+
+std::vector<SamplingGroup> parseSamplingGroupArray(const json& element)
+{
+    verifyIsArray(element);
+    std::vector<SamplingGroup> samplingGroups;
+    samplingGroups.reserve(element.size());
+    for (auto& samplingGroupElement : element)
+    {
+        samplingGroups.emplace_back(parseSamplingGroup(samplingGroupElement));
+    }
+    return samplingGroups;
+}
+
+SensorAggregation parseSensorAggregation(const json& element)
+{
+    verifyIsObject(element);
+    unsigned int propertyCount{0};
+
+    // Optional comments property; value not stored
+    if (element.contains("comments"))
+    {
+        ++propertyCount;
+    }
+
+    // Required window_ms property
+    const json& windowElement = getRequiredProperty(element, "window_ms");
+    std::chrono::milliseconds window = parseMonitoringInterval(windowElement);
+    ++propertyCount;
+
+    // Optional statistic property
+    SensorStatistic statistic{SensorStatistic::mean};
+    auto statisticIt = element.find("statistic");
+    if (statisticIt != element.end())
+    {
+        statistic = parseSensorStatistic(*statisticIt);
+        ++propertyCount;
+    }
+
+    // Verify no invalid properties exist
+    verifyPropertyCount(element, propertyCount);
+
+    return SensorAggregation{window, statistic};
+}
+
 pmbus_utils::SensorDataFormat parseSensorDataFormat(const json& element)
 {
     if (!element.is_string())
@@ -1136,10 +2124,53 @@ std::unique_ptr<SensorMonitoring> parseSensorMonitoring(const json& element)
     actions = parseRuleIDOrActionsProperty(element);
     ++propertyCount;
 
+    // Optional interval_ms property
+    std::chrono::milliseconds interval{SensorMonitoring::defaultInterval};
+    auto intervalIt = element.find("interval_ms");
+    if (intervalIt != element.end())
+    {
+        interval = parseMonitoringInterval(*intervalIt);
+        ++propertyCount;
+    }
+
+    // Optional adaptive_interval property
+    std::optional<AdaptiveInterval> adaptiveInterval{};
+    auto adaptiveIntervalIt = element.find("adaptive_interval");
+    if (adaptiveIntervalIt != element.end())
+    {
+        adaptiveInterval = parseAdaptiveInterval(*adaptiveIntervalIt);
+        if (adaptiveInterval->minInterval > interval)
+        {
+            throw std::invalid_argument{"Invalid min_interval_ms value: Must "
+                                        "be <= interval_ms"};
+        }
+        ++propertyCount;
+    }
+
+    // Optional sampling_groups property
+    std::vector<SamplingGroup> samplingGroups{};
+    auto samplingGroupsIt = element.find("sampling_groups");
+    if (samplingGroupsIt != element.end())
+    {
+        samplingGroups = parseSamplingGroupArray(*samplingGroupsIt);
+        ++propertyCount;
+    }
+
+    // Optional enable_detection property
+    std::unique_ptr<EnableDetection> enableDetection{};
+    auto enableDetectionIt = element.find("enable_detection");
+    if (enableDetectionIt != element.end())
+    {
+        enableDetection = parseEnableDetection(*enableDetectionIt);
+        ++propertyCount;
+    }
+
     // Verify no invalid properties exist
     verifyPropertyCount(element, propertyCount);
 
-    return std::make_unique<SensorMonitoring>(std::move(actions));
+    return std::make_unique<SensorMonitoring>(
+        std::move(actions), interval, adaptiveInterval,
+        std::move(samplingGroups), std::move(enableDetection));
 }
 
 SensorType parseSensorType(const json& element)
@@ -1191,6 +2222,35 @@ SensorType parseSensorType(const json& element)
     return type;
 }
 
+SensorStatistic parseSensorStatistic(const json& element)
+{
+    std::string value = parseString(element);
+    SensorStatistic statistic{};
+
+    if (value == "minimum")
+    {
+        statistic = SensorStatistic::minimum;
+    }
+    else if (value == "maximum")
+    {
+        statistic = SensorStatistic::maximum;
+    }
+    else if (value == "mean")
+    {
+        statistic = SensorStatistic::mean;
+    }
+    else if (value == "peak_to_peak")
+    {
+        statistic = SensorStatistic::peak_to_peak;
+    }
+    else
+    {
+        throw std::invalid_argument{"Element is not a sensor statistic"};
+    }
+
+    return statistic;
+}
+
 std::unique_ptr<SetDeviceAction> parseSetDevice(const json& element)
 {
     // String deviceID
@@ -1199,6 +2259,58 @@ std::unique_ptr<SetDeviceAction> parseSetDevice(const json& element)
     return std::make_unique<SetDeviceAction>(deviceID);
 }
 
+std::unique_ptr<VoltageSetpoint> parseVoltageSetpoint(const json& element)
+{
+    verifyIsObject(element);
+    unsigned int propertyCount{0};
+
+    // Optional comments property; value not stored
+    if (element.contains("comments"))
+    {
+        ++propertyCount;
+    }
+
+    // Required min_volts property
+    const json& minVoltsElement = getRequiredProperty(element, "min_volts");
+    double minVolts = parseDouble(minVoltsElement);
+    ++propertyCount;
+
+    // Required max_volts property
+    const json& maxVoltsElement = getRequiredProperty(element, "max_volts");
+    double maxVolts = parseDouble(maxVoltsElement);
+    ++propertyCount;
+
+    if (minVolts > maxVolts)
+    {
+        throw std::invalid_argument{
+            "Invalid voltage setpoint: min_volts must be <= max_volts"};
+    }
+
+    // Optional page property
+    std::optional<uint8_t> page{};
+    auto pageIt = element.find("page");
+    if (pageIt != element.end())
+    {
+        page = parseHexByte(*pageIt);
+        ++propertyCount;
+    }
+
+    // Optional exponent property
+    std::optional<int8_t> exponent{};
+    auto exponentIt = element.find("exponent");
+    if (exponentIt != element.end())
+    {
+        exponent = parseInt8(*exponentIt);
+        ++propertyCount;
+    }
+
+    // Verify no invalid properties exist
+    verifyPropertyCount(element, propertyCount);
+
+    return std::make_unique<VoltageSetpoint>(minVolts, maxVolts, page,
+                                             exponent);
+}
+
 pmbus_utils::VoutDataFormat parseVoutDataFormat(const json& element)
 {
     if (!element.is_string())
@@ -1232,6 +2344,72 @@ pmbus_utils::VoutDataFormat parseVoutDataFormat(const json& element)
     return format;
 }
 
+std::optional<json> readCacheFile(const std::filesystem::path& cachePathName,
+                                  uint64_t hash)
+{
+    try
+    {
+        std::ifstream file{cachePathName, std::ios::binary};
+        if (!file)
+        {
+            return std::nullopt;
+        }
+
+        // Verify header matches this parser version and config file contents
+        CacheFileHeader header{};
+        CacheFileHeader expectedHeader{};
+        file.read(reinterpret_cast<char*>(&header), sizeof(header));
+        if (!file ||
+            (std::memcmp(header.magic, expectedHeader.magic,
+                         sizeof(header.magic)) != 0) ||
+            (header.parserVersion != expectedHeader.parserVersion) ||
+            (header.hash != hash))
+        {
+            return std::nullopt;
+        }
+
+        // Read CBOR data and convert to tree of JSON elements
+        std::vector<uint8_t> data(header.dataSize);
+        file.read(reinterpret_cast<char*>(data.data()), data.size());
+        if (!file)
+        {
+            return std::nullopt;
+        }
+        return json::from_cbor(data);
+    }
+    catch (const std::exception&)
+    {
+        // Cache file is invalid; config file will be parsed instead
+        return std::nullopt;
+    }
+}
+
+void writeCacheFile(const std::filesystem::path& cachePathName, uint64_t hash,
+                    const json& rootElement)
+{
+    std::vector<uint8_t> data = json::to_cbor(rootElement);
+    CacheFileHeader header{};
+    header.hash = hash;
+    header.dataSize = data.size();
+
+    // Write to a temporary file and then rename it to the cache file name
+    std::filesystem::create_directories(cachePathName.parent_path());
+    std::filesystem::path tempPathName{cachePathName.string() + ".tmp"};
+    {
+        std::ofstream file{tempPathName, std::ios::binary | std::ios::trunc};
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(data.data()), data.size());
+        file.close();
+        if (!file)
+        {
+            std::filesystem::remove(tempPathName);
+            throw std::runtime_error{"Unable to write cache file " +
+                                     cachePathName.string()};
+        }
+    }
+    std::filesystem::rename(tempPathName, cachePathName);
+}
+
 } // namespace internal
 
 } // namespace phosphor::power::regulators::config_file_parser
@@ -19,13 +19,16 @@
 #include "and_action.hpp"
 #include "chassis.hpp"
 #include "compare_presence_action.hpp"
+#include "compiled_config.hpp"
 #include "compare_vpd_action.hpp"
 #include "configuration.hpp"
 #include "device.hpp"
+#include "enable_detection.hpp"
 #include "i2c_capture_bytes_action.hpp"
 #include "i2c_compare_bit_action.hpp"
 #include "i2c_compare_byte_action.hpp"
 #include "i2c_compare_bytes_action.hpp"
+#include "i2c_probe_action.hpp"
 #include "i2c_interface.hpp"
 #include "i2c_write_bit_action.hpp"
 #include "i2c_write_byte_action.hpp"
@@ -36,8 +39,11 @@
 #include "or_action.hpp"
 #include "phase_fault.hpp"
 #include "phase_fault_detection.hpp"
+#include "pmbus_read_block_sensors_action.hpp"
 #include "pmbus_read_sensor_action.hpp"
+#include "pmbus_read_sensors_action.hpp"
 #include "pmbus_write_vout_command_action.hpp"
+#include "power_domain.hpp"
 #include "presence_detection.hpp"
 #include "rail.hpp"
 #include "rule.hpp"
@@ -45,12 +51,17 @@
 #include "sensor_monitoring.hpp"
 #include "sensors.hpp"
 #include "set_device_action.hpp"
+#include "voltage_setpoint.hpp"
 
 #include <nlohmann/json.hpp>
 
+#include <chrono>
 #include <cstdint>
 #include <filesystem>
+#include <functional>
+#include <istream>
 #include <memory>
+#include <optional>
 #include <stdexcept>
 #include <string>
 #include <tuple>
@@ -59,6 +70,40 @@
 namespace phosphor::power::regulators::config_file_parser
 {
 
+/**
+ * Chassis in a configuration file whose C++ objects have not been created yet.
+ *
+ * Contains the chassis number and inventory path, which are needed to find
+ * out whether the chassis is present.  The rest of the chassis is stored as
+ * JSON elements in the compact CBOR format.
+ */
+struct DeferredChassis
+{
+    /**
+     * Chassis number within the system.
+     */
+    unsigned int number{0};
+
+    /**
+     * Inventory path of the chassis.  Includes the
+     * /xyz/openbmc_project/inventory prefix.
+     */
+    std::string inventoryPath{};
+
+    /**
+     * JSON elements for the chassis in CBOR format.
+     */
+    std::vector<uint8_t> data{};
+};
+
+/**
+ * Version of the parser.
+ *
+ * Stored in binary cache files.  Must be incremented when the parser changes
+ * in a way that makes previously cached files invalid.
+ */
+constexpr uint32_t parserVersion{1};
+
 /**
  * Parses the specified JSON configuration file.
  *
@@ -73,12 +118,168 @@ std::tuple<std::vector<std::unique_ptr<Rule>>,
            std::vector<std::unique_ptr<Chassis>>>
     parse(const std::filesystem::path& pathName);
 
+/**
+ * Parses the specified JSON configuration file, using a binary cache file to
+ * avoid parsing the JSON text when the configuration file has not changed.
+ *
+ * The cache file is stored in the specified directory.  It contains the tree
+ * of JSON elements in CBOR format, the parser version, and a hash of the
+ * configuration file contents.  If the hash and parser version match, the
+ * JSON elements are obtained from the cache file.  Otherwise the
+ * configuration file is parsed and a new cache file is written.
+ *
+ * Errors reading or writing the cache file are ignored.  The cache is only
+ * used to improve performance.
+ *
+ * The rules and chassis are parsed using up to the specified number of worker
+ * threads.  See internal::parseRoot().
+ *
+ * Returns the corresponding C++ Rule and Chassis objects.
+ *
+ * Throws a ConfigFileParserError if an error occurs.
+ *
+ * @param pathName configuration file path name
+ * @param cacheDirectory directory containing the binary cache file
+ * @param threadCount maximum number of worker threads used to parse the rules
+ *                    and chassis
+ * @return tuple containing vectors of Rule and Chassis objects
+ */
+std::tuple<std::vector<std::unique_ptr<Rule>>,
+           std::vector<std::unique_ptr<Chassis>>>
+    parse(const std::filesystem::path& pathName,
+          const std::filesystem::path& cacheDirectory,
+          unsigned int threadCount = 1);
+
+/**
+ * Parses the specified configuration file that is compiled into the binary.
+ *
+ * The tree of JSON elements is obtained from the CBOR data of the compiled
+ * configuration file.  The file system is not accessed and no JSON text is
+ * parsed.  The rules and chassis are parsed using up to the specified number
+ * of worker threads.  See internal::parseRoot().
+ *
+ * Returns the corresponding C++ Rule and Chassis objects.
+ *
+ * Throws a ConfigFileParserError if an error occurs.
+ *
+ * @param config compiled configuration file
+ * @param threadCount maximum number of worker threads used to parse the rules
+ *                    and chassis
+ * @return tuple containing vectors of Rule and Chassis objects
+ */
+std::tuple<std::vector<std::unique_ptr<Rule>>,
+           std::vector<std::unique_ptr<Chassis>>>
+    parse(const CompiledConfig& config, unsigned int threadCount = 1);
+
+/**
+ * Parses the specified JSON configuration file, deferring the creation of the
+ * C++ Chassis objects.
+ *
+ * The file is read incrementally like parseStreaming().  The rules are parsed
+ * and the corresponding C++ Rule objects are created.  The chassis are not
+ * parsed.  Only the chassis number and inventory path are verified.  Use
+ * parseDeferredChassis() to create the C++ Chassis object, such as when the
+ * chassis is present.  Chassis that are never created cost very little memory.
+ *
+ * Throws a ConfigFileParserError if an error occurs.
+ *
+ * @param pathName configuration file path name
+ * @return tuple containing vectors of Rule objects and deferred chassis
+ */
+std::tuple<std::vector<std::unique_ptr<Rule>>, std::vector<DeferredChassis>>
+    parseDeferred(const std::filesystem::path& pathName);
+
+/**
+ * Parses the specified deferred chassis from parseDeferred().
+ *
+ * Returns the corresponding C++ Chassis object, including its devices and
+ * rails.
+ *
+ * Throws an exception if parsing fails.
+ *
+ * @param chassis deferred chassis
+ * @return Chassis object
+ */
+std::unique_ptr<Chassis> parseDeferredChassis(const DeferredChassis& chassis);
+
+/**
+ * Parses the specified JSON configuration file without creating a tree of
+ * JSON elements for the entire file.
+ *
+ * The file is read incrementally.  As soon as the JSON elements for one rule
+ * or chassis have been read, they are converted to the corresponding C++
+ * object and discarded.  This requires much less memory than parse() for a
+ * large configuration file.  A binary cache file is not used because it
+ * contains the tree of JSON elements for the entire file.
+ *
+ * Returns the corresponding C++ Rule and Chassis objects.
+ *
+ * Throws a ConfigFileParserError if an error occurs.
+ *
+ * @param pathName configuration file path name
+ * @return tuple containing vectors of Rule and Chassis objects
+ */
+std::tuple<std::vector<std::unique_ptr<Rule>>,
+           std::vector<std::unique_ptr<Chassis>>>
+    parseStreaming(const std::filesystem::path& pathName);
+
 /*
  * Internal implementation details for parse()
  */
 namespace internal
 {
 
+/**
+ * Function called by parseRootStreaming() for each element of the "chassis"
+ * array.
+ */
+using ChassisElementHandler = std::function<void(const nlohmann::json&)>;
+
+/**
+ * Creates a deferred chassis from a JSON element containing a chassis.
+ *
+ * Verifies the element is an object and parses the number and inventory_path
+ * properties.  The other properties are not verified.
+ *
+ * Throws an exception if parsing fails.
+ *
+ * @param element JSON element
+ * @return deferred chassis
+ */
+DeferredChassis deferChassis(const nlohmann::json& element);
+
+/**
+ * Returns the path name of the binary cache file for the specified
+ * configuration file.
+ *
+ * @param pathName configuration file path name
+ * @param cacheDirectory directory containing the binary cache file
+ * @return cache file path name
+ */
+inline std::filesystem::path
+    getCacheFilePath(const std::filesystem::path& pathName,
+                     const std::filesystem::path& cacheDirectory)
+{
+    return cacheDirectory / (pathName.filename().string() + ".cache");
+}
+
+/**
+ * Returns a 64-bit FNV-1a hash of the specified configuration file contents.
+ *
+ * @param contents configuration file contents
+ * @return hash value
+ */
+inline uint64_t getHash(const std::string& contents)
+{
+    uint64_t hash{0xcbf29ce484222325};
+    for (char c : contents)
+    {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 0x100000001b3;
+    }
+    return hash;
+}
+
 /**
  * Returns the specified property of the specified JSON element.
  *
@@ -123,6 +324,18 @@ std::unique_ptr<Action> parseAction(const nlohmann::json& element);
 std::vector<std::unique_ptr<Action>>
     parseActionArray(const nlohmann::json& element);
 
+/**
+ * Parses a JSON element containing an adaptive_interval object.
+ *
+ * Returns the corresponding C++ AdaptiveInterval object.
+ *
+ * Throws an exception if parsing fails.
+ *
+ * @param element JSON element
+ * @return AdaptiveInterval object
+ */
+AdaptiveInterval parseAdaptiveInterval(const nlohmann::json& element);
+
 /**
  * Parses a JSON element containing an and action.
  *
@@ -314,6 +527,19 @@ inline double parseDouble(const nlohmann::json& element)
     return element.get<double>();
 }
 
+/**
+ * Parses a JSON element containing an enable_detection object.
+ *
+ * Returns the corresponding C++ EnableDetection object.
+ *
+ * Throws an exception if parsing fails.
+ *
+ * @param element JSON element
+ * @return EnableDetection object
+ */
+std::unique_ptr<EnableDetection>
+    parseEnableDetection(const nlohmann::json& element);
+
 /**
  * Parses a JSON element containing a byte value expressed as a hexadecimal
  * string.
@@ -418,6 +644,9 @@ std::unique_ptr<I2CCompareBytesAction>
  *
  * Returns the corresponding C++ i2c::I2CInterface object.
  *
+ * If the max_transactions_per_second property is specified, it is set as the
+ * budget of the I2C bus unless the bus already has a lower budget.
+ *
  * Throws an exception if parsing fails.
  *
  * @param element JSON element
@@ -426,6 +655,30 @@ std::unique_ptr<I2CCompareBytesAction>
 std::unique_ptr<i2c::I2CInterface>
     parseI2CInterface(const nlohmann::json& element);
 
+/**
+ * Parses a JSON element containing an i2c_probe action.
+ *
+ * Returns the corresponding C++ I2CProbeAction object.
+ *
+ * Throws an exception if parsing fails.
+ *
+ * @param element JSON element
+ * @return I2CProbeAction object
+ */
+std::unique_ptr<I2CProbeAction> parseI2CProbe(const nlohmann::json& element);
+
+/**
+ * Parses a JSON element containing an I2C probe method.
+ *
+ * Returns the corresponding C++ I2CProbeAction::Method value.
+ *
+ * Throws an exception if parsing fails.
+ *
+ * @param element JSON element
+ * @return I2CProbeAction::Method value
+ */
+I2CProbeAction::Method parseI2CProbeMethod(const nlohmann::json& element);
+
 /**
  * Parses a JSON element containing an i2c_write_bit action.
  *
@@ -530,6 +783,20 @@ std::string parseInventoryPath(const nlohmann::json& element);
 std::unique_ptr<LogPhaseFaultAction>
     parseLogPhaseFault(const nlohmann::json& element);
 
+/**
+ * Parses a JSON element containing a sensor monitoring interval expressed as
+ * an unsigned integer number of milliseconds.
+ *
+ * Returns the corresponding C++ milliseconds value.
+ *
+ * Throws an exception if parsing fails.
+ *
+ * @param element JSON element
+ * @return milliseconds value
+ */
+std::chrono::milliseconds
+    parseMonitoringInterval(const nlohmann::json& element);
+
 /**
  * Parses a JSON element containing a not action.
  *
@@ -579,6 +846,33 @@ std::unique_ptr<PhaseFaultDetection>
  */
 PhaseFaultType parsePhaseFaultType(const nlohmann::json& element);
 
+/**
+ * Parses a JSON element containing a pmbus_read_block_sensors action.
+ *
+ * Returns the corresponding C++ PMBusReadBlockSensorsAction object.
+ *
+ * Throws an exception if parsing fails.
+ *
+ * @param element JSON element
+ * @return PMBusReadBlockSensorsAction object
+ */
+std::unique_ptr<PMBusReadBlockSensorsAction>
+    parsePMBusReadBlockSensors(const nlohmann::json& element);
+
+/**
+ * Parses a JSON element containing one sensor of a pmbus_read_block_sensors
+ * action.
+ *
+ * Returns the corresponding C++ PMBusReadBlockSensorsAction::Sensor object.
+ *
+ * Throws an exception if parsing fails.
+ *
+ * @param element JSON element
+ * @return PMBusReadBlockSensorsAction::Sensor object
+ */
+PMBusReadBlockSensorsAction::Sensor
+    parsePMBusReadBlockSensorsSensor(const nlohmann::json& element);
+
 /**
  * Parses a JSON element containing a pmbus_read_sensor action.
  *
@@ -592,6 +886,33 @@ PhaseFaultType parsePhaseFaultType(const nlohmann::json& element);
 std::unique_ptr<PMBusReadSensorAction>
     parsePMBusReadSensor(const nlohmann::json& element);
 
+/**
+ * Parses a JSON element containing a pmbus_read_sensors action.
+ *
+ * Returns the corresponding C++ PMBusReadSensorsAction object.
+ *
+ * Throws an exception if parsing fails.
+ *
+ * @param element JSON element
+ * @return PMBusReadSensorsAction object
+ */
+std::unique_ptr<PMBusReadSensorsAction>
+    parsePMBusReadSensors(const nlohmann::json& element);
+
+/**
+ * Parses a JSON element containing one sensor of a pmbus_read_sensors
+ * action.
+ *
+ * Returns the corresponding C++ PMBusReadSensorsAction::Sensor object.
+ *
+ * Throws an exception if parsing fails.
+ *
+ * @param element JSON element
+ * @return PMBusReadSensorsAction::Sensor object
+ */
+PMBusReadSensorsAction::Sensor
+    parsePMBusReadSensorsSensor(const nlohmann::json& element);
+
 /**
  * Parses a JSON element containing a pmbus_write_vout_command action.
  *
@@ -605,6 +926,18 @@ std::unique_ptr<PMBusReadSensorAction>
 std::unique_ptr<PMBusWriteVoutCommandAction>
     parsePMBusWriteVoutCommand(const nlohmann::json& element);
 
+/**
+ * Parses a JSON element containing a power_domain object.
+ *
+ * Returns the corresponding C++ PowerDomain object.
+ *
+ * Throws an exception if parsing fails.
+ *
+ * @param element JSON element
+ * @return PowerDomain object
+ */
+std::unique_ptr<PowerDomain> parsePowerDomain(const nlohmann::json& element);
+
 /**
  * Parses a JSON element containing a presence_detection object.
  *
@@ -646,16 +979,65 @@ std::vector<std::unique_ptr<Rail>>
 /**
  * Parses the JSON root element of the entire configuration file.
  *
+ * The elements of the "rules" and "chassis" arrays are independent of each
+ * other until the IDs are resolved by the System.  Large arrays are split into
+ * ranges of consecutive elements that are parsed in parallel by up to
+ * threadCount worker threads.  The rules and chassis are parsed at the same
+ * time.  The objects are returned in the same order as the configuration file.
+ *
+ * If more than one element is invalid, the exception for the first one in the
+ * configuration file is thrown, the same as when parsing with one thread.
+ *
  * Returns the corresponding C++ Rule and Chassis objects.
  *
  * Throws an exception if parsing fails.
  *
  * @param element JSON element
+ * @param threadCount maximum number of worker threads
+ * @return tuple containing vectors of Rule and Chassis objects
+ */
+std::tuple<std::vector<std::unique_ptr<Rule>>,
+           std::vector<std::unique_ptr<Chassis>>>
+    parseRoot(const nlohmann::json& element, unsigned int threadCount = 1);
+
+/**
+ * Parses the JSON text of the entire configuration file from the specified
+ * input stream.
+ *
+ * Each element of the "rules" and "chassis" arrays is converted to the
+ * corresponding C++ object as soon as it has been read.  The JSON elements are
+ * then discarded.  The rest of the root element is verified the same way as
+ * parseRoot().
+ *
+ * Returns the corresponding C++ Rule and Chassis objects.
+ *
+ * Throws an exception if parsing fails.
+ *
+ * @param input input stream containing the JSON text
  * @return tuple containing vectors of Rule and Chassis objects
  */
 std::tuple<std::vector<std::unique_ptr<Rule>>,
            std::vector<std::unique_ptr<Chassis>>>
-    parseRoot(const nlohmann::json& element);
+    parseRootStreaming(std::istream& input);
+
+/**
+ * Parses the JSON text of the entire configuration file from the specified
+ * input stream, passing each element of the "chassis" array to the specified
+ * function instead of creating the C++ Chassis object.
+ *
+ * See parseRootStreaming(std::istream&) for more information.
+ *
+ * Returns the corresponding C++ Rule objects.
+ *
+ * Throws an exception if parsing fails.
+ *
+ * @param input input stream containing the JSON text
+ * @param handleChassis function called for each element of the chassis array
+ * @return vector of Rule objects
+ */
+std::vector<std::unique_ptr<Rule>>
+    parseRootStreaming(std::istream& input,
+                       const ChassisElementHandler& handleChassis);
 
 /**
  * Parses a JSON element containing a rule.
@@ -713,6 +1095,43 @@ std::vector<std::unique_ptr<Action>>
  */
 std::unique_ptr<RunRuleAction> parseRunRule(const nlohmann::json& element);
 
+/**
+ * Parses a JSON element containing a sampling_group object.
+ *
+ * Returns the corresponding C++ SamplingGroup object.
+ *
+ * Throws an exception if parsing fails.
+ *
+ * @param element JSON element
+ * @return SamplingGroup object
+ */
+SamplingGroup parseSamplingGroup(const nlohmann::json& element);
+
+/**
+ * Parses a JSON element containing an array of sampling_group objects.
+ *
+ * Returns the corresponding C++ SamplingGroup objects.
+ *
+ * Throws an exception if parsing fails.
+ *
+ * @param element JSON element
+ * @return vector of SamplingGroup objects
+ */
+std::vector<SamplingGroup>
+    parseSamplingGroupArray(const nlohmann::json& element);
+
+/**
+ * Parses a JSON element containing an aggregation object.
+ *
+ * Returns the corresponding C++ SensorAggregation object.
+ *
+ * Throws an exception if parsing fails.
+ *
+ * @param element JSON element
+ * @return SensorAggregation object
+ */
+SensorAggregation parseSensorAggregation(const nlohmann::json& element);
+
 /**
  * Parses a JSON element containing a SensorDataFormat expressed as a string.
  *
@@ -751,6 +1170,18 @@ std::unique_ptr<SensorMonitoring>
  */
 SensorType parseSensorType(const nlohmann::json& element);
 
+/**
+ * Parses a JSON element containing a SensorStatistic expressed as a string.
+ *
+ * Returns the corresponding SensorStatistic enum value.
+ *
+ * Throws an exception if parsing fails.
+ *
+ * @param element JSON element
+ * @return SensorStatistic enum value
+ */
+SensorStatistic parseSensorStatistic(const nlohmann::json& element);
+
 /**
  * Parses a JSON element containing a set_device action.
  *
@@ -834,6 +1265,19 @@ inline unsigned int parseUnsignedInteger(const nlohmann::json& element)
     return element.get<unsigned int>();
 }
 
+/**
+ * Parses a JSON element containing a voltage_setpoint object.
+ *
+ * Returns the corresponding C++ VoltageSetpoint object.
+ *
+ * Throws an exception if parsing fails.
+ *
+ * @param element JSON element
+ * @return VoltageSetpoint object
+ */
+std::unique_ptr<VoltageSetpoint>
+    parseVoltageSetpoint(const nlohmann::json& element);
+
 /**
  * Parses a JSON element containing a VoutDataFormat expressed as a string.
  *
@@ -846,6 +1290,20 @@ inline unsigned int parseUnsignedInteger(const nlohmann::json& element)
  */
 pmbus_utils::VoutDataFormat parseVoutDataFormat(const nlohmann::json& element);
 
+/**
+ * Reads the tree of JSON elements from the specified binary cache file.
+ *
+ * Returns an empty optional if the cache file does not exist, cannot be read,
+ * or was not created from a configuration file with the specified hash by
+ * this version of the parser.
+ *
+ * @param cachePathName cache file path name
+ * @param hash hash of the configuration file contents
+ * @return root JSON element, if available
+ */
+std::optional<nlohmann::json>
+    readCacheFile(const std::filesystem::path& cachePathName, uint64_t hash);
+
 /**
  * Verifies that the specified JSON element is a JSON array.
  *
@@ -896,6 +1354,21 @@ inline void verifyPropertyCount(const nlohmann::json& element,
     }
 }
 
+/**
+ * Writes the tree of JSON elements to the specified binary cache file.
+ *
+ * The file is written to a temporary file and then renamed so that a partial
+ * cache file is never read.
+ *
+ * Throws an exception if an error occurs.
+ *
+ * @param cachePathName cache file path name
+ * @param hash hash of the configuration file contents
+ * @param rootElement root JSON element
+ */
+void writeCacheFile(const std::filesystem::path& cachePathName, uint64_t hash,
+                    const nlohmann::json& rootElement);
+
 } // namespace internal
 
 } // namespace phosphor::power::regulators::config_file_parser
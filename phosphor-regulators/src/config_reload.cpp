@@ -0,0 +1,245 @@
+/**
+ * Copyright © 2026 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "config_reload.hpp"
+
+#include "and_action.hpp"
+#include "id_map.hpp"
+#include "if_action.hpp"
+#include "not_action.hpp"
+#include "or_action.hpp"
+#include "rail.hpp"
+#include "run_rule_action.hpp"
+#include "sensor_monitoring.hpp"
+
+#include <utility>
+
+namespace phosphor::power::regulators::config_reload
+{
+
+/**
+ * Returns the specified rules keyed by ID.
+ *
+ * @param rules rules
+ * @return map from rule IDs to rules
+ */
+static std::map<std::string, const Rule*>
+    getRuleMap(const std::vector<std::unique_ptr<Rule>>& rules)
+{
+    std::map<std::string, const Rule*> ruleMap{};
+    for (const std::unique_ptr<Rule>& rule : rules)
+    {
+        ruleMap.emplace(rule->getID(), rule.get());
+    }
+    return ruleMap;
+}
+
+std::size_t
+    reuseUnchangedDevices(System& oldSystem,
+                          const std::vector<std::unique_ptr<Rule>>& newRules,
+                          std::vector<std::unique_ptr<Chassis>>& newChassis)
+{
+    // Verify the new IDs are unique before moving any device.  The System
+    // constructor throws the same exception, and the old system must still be
+    // complete if the new config file cannot be used.
+    IDMap newIDMap{};
+    for (const std::unique_ptr<Rule>& rule : newRules)
+    {
+        newIDMap.addRule(*rule);
+    }
+    for (std::unique_ptr<Chassis>& chassis : newChassis)
+    {
+        chassis->addToIDMap(newIDMap);
+    }
+
+    std::map<std::string, const Rule*> oldRuleMap =
+        getRuleMap(oldSystem.getRules());
+    std::map<std::string, const Rule*> newRuleMap = getRuleMap(newRules);
+
+    std::size_t count{0};
+    for (std::unique_ptr<Chassis>& chassis : newChassis)
+    {
+        // Find the chassis with the same number in the old system
+        Chassis* oldChassis{nullptr};
+        for (const std::unique_ptr<Chassis>& element : oldSystem.getChassis())
+        {
+            if (element->getNumber() == chassis->getNumber())
+            {
+                oldChassis = element.get();
+                break;
+            }
+        }
+        if (oldChassis == nullptr)
+        {
+            continue;
+        }
+
+        const std::vector<std::unique_ptr<Device>>& oldDevices =
+            oldChassis->getDevices();
+        for (std::size_t i = 0; i < chassis->getDevices().size(); ++i)
+        {
+            const Device& newDevice = *(chassis->getDevices()[i]);
+            for (std::size_t j = 0; j < oldDevices.size(); ++j)
+            {
+                // A moved device is replaced by an empty pointer
+                const std::unique_ptr<Device>& oldDevice = oldDevices[j];
+                if (oldDevice && (oldDevice->getID() == newDevice.getID()))
+                {
+                    if (internal::isUnchanged(*oldDevice, newDevice,
+                                              oldRuleMap, newRuleMap))
+                    {
+                        chassis->replaceDevice(
+                            i, oldChassis->replaceDevice(j, nullptr));
+                        ++count;
+                    }
+                    break;
+                }
+            }
+        }
+    }
+    return count;
+}
+
+namespace internal
+{
+
+void getRuleIDs(const Action& action,
+                const std::map<std::string, const Rule*>& rules,
+                std::set<std::string>& ruleIDs)
+{
+    if (auto* runRuleAction = dynamic_cast<const RunRuleAction*>(&action))
+    {
+        // Follow each rule once; rules can be run from multiple places
+        const std::string& ruleID = runRuleAction->getRuleID();
+        if (ruleIDs.emplace(ruleID).second)
+        {
+            auto it = rules.find(ruleID);
+            if (it != rules.end())
+            {
+                getRuleIDs(it->second->getActions(), rules, ruleIDs);
+            }
+        }
+    }
+    else if (auto* andAction = dynamic_cast<const AndAction*>(&action))
+    {
+        getRuleIDs(andAction->getActions(), rules, ruleIDs);
+    }
+    else if (auto* orAction = dynamic_cast<const OrAction*>(&action))
+    {
+        getRuleIDs(orAction->getActions(), rules, ruleIDs);
+    }
+    else if (auto* notAction = dynamic_cast<const NotAction*>(&action))
+    {
+        getRuleIDs(*(notAction->getAction()), rules, ruleIDs);
+    }
+    else if (auto* ifAction = dynamic_cast<const IfAction*>(&action))
+    {
+        getRuleIDs(*(ifAction->getConditionAction()), rules, ruleIDs);
+        getRuleIDs(ifAction->getThenActions(), rules, ruleIDs);
+        getRuleIDs(ifAction->getElseActions(), rules, ruleIDs);
+    }
+}
+
+void getRuleIDs(const std::vector<std::unique_ptr<Action>>& actions,
+                const std::map<std::string, const Rule*>& rules,
+                std::set<std::string>& ruleIDs)
+{
+    for (const std::unique_ptr<Action>& action : actions)
+    {
+        getRuleIDs(*action, rules, ruleIDs);
+    }
+}
+
+std::set<std::string> getRuleIDs(
+    const Device& device, const std::map<std::string, const Rule*>& rules)
+{
+    std::set<std::string> ruleIDs{};
+    if (device.getPresenceDetection())
+    {
+        getRuleIDs(device.getPresenceDetection()->getActions(), rules,
+                   ruleIDs);
+    }
+    if (device.getConfiguration())
+    {
+        getRuleIDs(device.getConfiguration()->getActions(), rules, ruleIDs);
+    }
+    if (device.getPhaseFaultDetection())
+    {
+        getRuleIDs(device.getPhaseFaultDetection()->getActions(), rules,
+                   ruleIDs);
+    }
+    for (const std::unique_ptr<Rail>& rail : device.getRails())
+    {
+        if (rail->getConfiguration())
+        {
+            getRuleIDs(rail->getConfiguration()->getActions(), rules, ruleIDs);
+        }
+        if (rail->getSensorMonitoring())
+        {
+            getRuleIDs(rail->getSensorMonitoring()->getActions(), rules,
+                       ruleIDs);
+            for (const SamplingGroup& group :
+                 rail->getSensorMonitoring()->getSamplingGroups())
+            {
+                getRuleIDs(group.actions, rules, ruleIDs);
+            }
+            if (rail->getSensorMonitoring()->getEnableDetection())
+            {
+                getRuleIDs(rail->getSensorMonitoring()
+                               ->getEnableDetection()
+                               ->getActions(),
+                           rules, ruleIDs);
+            }
+        }
+    }
+    return ruleIDs;
+}
+
+bool isUnchanged(const Device& oldDevice, const Device& newDevice,
+                 const std::map<std::string, const Rule*>& oldRules,
+                 const std::map<std::string, const Rule*>& newRules)
+{
+    // Devices that were not created by the parser have no hash
+    if ((oldDevice.getDefinitionHash() == 0) ||
+        (oldDevice.getDefinitionHash() != newDevice.getDefinitionHash()))
+    {
+        return false;
+    }
+
+    // The device definitions are the same, so the rules they run directly are
+    // the same.  Verify the rules are the same in both config files.
+    for (const std::string& ruleID : getRuleIDs(newDevice, newRules))
+    {
+        auto oldIt = oldRules.find(ruleID);
+        auto newIt = newRules.find(ruleID);
+        bool oldFound = (oldIt != oldRules.end());
+        bool newFound = (newIt != newRules.end());
+        if (oldFound != newFound)
+        {
+            return false;
+        }
+        if (oldFound && (oldIt->second->getDefinitionHash() !=
+                         newIt->second->getDefinitionHash()))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace internal
+
+} // namespace phosphor::power::regulators::config_reload
@@ -0,0 +1,128 @@
+/**
+ * Copyright © 2026 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "chassis.hpp"
+#include "device.hpp"
+#include "rule.hpp"
+#include "system.hpp"
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+/**
+ * @namespace config_reload
+ *
+ * Contains functions for reloading the config file without losing the runtime
+ * state of the devices that did not change.
+ */
+namespace phosphor::power::regulators::config_reload
+{
+
+/**
+ * Moves the unchanged devices from the old system into the new chassis.
+ *
+ * A device is unchanged if its definition in the config file is the same, and
+ * all the rules that can be run by its actions are the same, in the old and
+ * new config file.  Definitions are compared using the hashes set by the
+ * config file parser.  Devices without a hash are never unchanged.
+ *
+ * Chassis are matched by number and devices by ID.  An unchanged device
+ * replaces the new device that was parsed from the new config file.  It keeps
+ * its I2C interface, cached presence, page, error history, and the state of
+ * its rails.  The old system no longer contains the moved devices, so it must
+ * be deleted rather than used.
+ *
+ * This function must be called before the new System object is created, so
+ * that the actions of the moved devices are linked to the new rules and
+ * compiled again.
+ *
+ * Throws an exception if the new config file contains duplicate IDs.  No
+ * devices are moved in that case.
+ *
+ * @param oldSystem system created from the old config file
+ * @param newRules rules parsed from the new config file
+ * @param newChassis chassis parsed from the new config file
+ * @return number of devices that were moved
+ */
+std::size_t
+    reuseUnchangedDevices(System& oldSystem,
+                          const std::vector<std::unique_ptr<Rule>>& newRules,
+                          std::vector<std::unique_ptr<Chassis>>& newChassis);
+
+/*
+ * Internal implementation details
+ */
+namespace internal
+{
+
+/**
+ * Adds the IDs of the rules that can be run by the specified action.
+ *
+ * Rules that run other rules are followed using the specified rules.
+ *
+ * @param action action to search
+ * @param rules rules that can be run, keyed by ID
+ * @param ruleIDs IDs of the rules found so far
+ */
+void getRuleIDs(const Action& action,
+                const std::map<std::string, const Rule*>& rules,
+                std::set<std::string>& ruleIDs);
+
+/**
+ * Adds the IDs of the rules that can be run by the specified actions.
+ *
+ * Rules that run other rules are followed using the specified rules.
+ *
+ * @param actions actions to search
+ * @param rules rules that can be run, keyed by ID
+ * @param ruleIDs IDs of the rules found so far
+ */
+void getRuleIDs(const std::vector<std::unique_ptr<Action>>& actions,
+                const std::map<std::string, const Rule*>& rules,
+                std::set<std::string>& ruleIDs);
+
+/**
+ * Returns the IDs of the rules that can be run by the actions of the
+ * specified device, including the actions of its rails.
+ *
+ * @param device device to search
+ * @param rules rules that can be run, keyed by ID
+ * @return rule IDs
+ */
+std::set<std::string> getRuleIDs(
+    const Device& device, const std::map<std::string, const Rule*>& rules);
+
+/**
+ * Returns whether the specified device is unchanged in the new config file.
+ *
+ * @param oldDevice device from the old config file
+ * @param newDevice device with the same ID from the new config file
+ * @param oldRules rules from the old config file, keyed by ID
+ * @param newRules rules from the new config file, keyed by ID
+ * @return true if the device is unchanged, false otherwise
+ */
+bool isUnchanged(const Device& oldDevice, const Device& newDevice,
+                 const std::map<std::string, const Rule*>& oldRules,
+                 const std::map<std::string, const Rule*>& newRules);
+
+} // namespace internal
+
+} // namespace phosphor::power::regulators::config_reload
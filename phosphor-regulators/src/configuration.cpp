@@ -30,53 +30,100 @@
 namespace phosphor::power::regulators
 {
 
-void Configuration::execute(Services& services, System& system,
-                            Chassis& chassis, Device& device)
+bool Configuration::execute(
+    Services& services, System& system, Chassis& chassis, Device& device,
+    std::vector<DeferredVerification>* deferredVerifications)
 {
-    execute(services, system, chassis, device, device.getID());
+    return execute(services, system, chassis, device, device.getID(),
+                   deferredVerifications);
 }
 
-void Configuration::execute(Services& services, System& system,
-                            Chassis& chassis, Device& device, Rail& rail)
+bool Configuration::execute(
+    Services& services, System& system, Chassis& chassis, Device& device,
+    Rail& rail, std::vector<DeferredVerification>* deferredVerifications)
 {
-    execute(services, system, chassis, device, rail.getID());
+    return execute(services, system, chassis, device, rail.getID(),
+                   deferredVerifications);
 }
 
-void Configuration::execute(Services& services, System& system,
-                            Chassis& /*chassis*/, Device& device,
-                            const std::string& deviceOrRailID)
+bool Configuration::verifyWrites(
+    Services& services, const std::string& deviceOrRailID,
+    std::vector<DeferredVerification>& verifications)
+{
+    try
+    {
+        for (DeferredVerification& verification : verifications)
+        {
+            verification();
+        }
+        return true;
+    }
+    catch (const std::exception& e)
+    {
+        // Log error messages in journal
+        services.getJournal().logError(exception_utils::MessageView{e});
+        services.getJournal().logError("Unable to configure " + deviceOrRailID);
+
+        // Create error log entry
+        error_logging_utils::logError(std::current_exception(),
+                                      Entry::Level::Warning, services);
+    }
+    return false;
+}
+
+bool Configuration::execute(
+    Services& services, System& system, Chassis& /*chassis*/, Device& device,
+    const std::string& deviceOrRailID,
+    std::vector<DeferredVerification>* deferredVerifications)
 {
     try
     {
         // Log debug message in journal
-        std::string message{"Configuring " + deviceOrRailID};
-        if (volts.has_value())
+        if constexpr (isJournalDebugEnabled)
         {
-            message += ": volts=" + std::to_string(volts.value());
+            std::string message{"Configuring " + deviceOrRailID};
+            if (volts.has_value())
+            {
+                message += ": volts=" + std::to_string(volts.value());
+            }
+            services.getJournal().logDebug(message);
         }
-        services.getJournal().logDebug(message);
 
         // Create ActionEnvironment
-        ActionEnvironment environment{system.getIDMap(), device.getID(),
-                                      services};
+        ActionEnvironment environment{system.getIDMap(),
+                                      device.getIDSymbol(), services};
         if (volts.has_value())
         {
             environment.setVolts(volts.value());
         }
+        if (deferredVerifications != nullptr)
+        {
+            environment.setDeferredVerifications(device,
+                                                 *deferredVerifications);
+        }
 
-        // Execute the actions
-        action_utils::execute(actions, environment);
+        // Execute the actions, using the compiled program if available
+        if (program)
+        {
+            program->execute(environment);
+        }
+        else
+        {
+            action_utils::execute(actions, environment);
+        }
+        return true;
     }
     catch (const std::exception& e)
     {
         // Log error messages in journal
-        services.getJournal().logError(exception_utils::getMessages(e));
+        services.getJournal().logError(exception_utils::MessageView{e});
         services.getJournal().logError("Unable to configure " + deviceOrRailID);
 
         // Create error log entry
         error_logging_utils::logError(std::current_exception(),
                                       Entry::Level::Warning, services);
     }
+    return false;
 }
 
 } // namespace phosphor::power::regulators
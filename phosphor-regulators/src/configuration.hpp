@@ -16,6 +16,8 @@
 #pragma once
 
 #include "action.hpp"
+#include "action_environment.hpp"
+#include "action_program.hpp"
 #include "services.hpp"
 
 #include <memory>
@@ -76,6 +78,20 @@ class Configuration
         actions{std::move(actions)}
     {}
 
+    /**
+     * Compiles the actions into an ActionProgram.
+     *
+     * The compiled program is used by execute() instead of interpreting the
+     * actions.  This method should be called after the System has been
+     * created, since the rules run by the actions must be resolved.
+     *
+     * @param idMap mapping from IDs to the associated Device/Rule objects
+     */
+    void compile(const IDMap& idMap)
+    {
+        program = std::make_unique<ActionProgram>(actions, idMap);
+    }
+
     /**
      * Executes the actions to configure the specified device.
      *
@@ -86,9 +102,16 @@ class Configuration
      * @param system system that contains the chassis
      * @param chassis chassis that contains the device
      * @param device device to configure
+     * @param deferredVerifications if specified, the write verifications of
+     *                              the device are deferred and added to this
+     *                              vector.  See verifyWrites().
+     * @return true if the configuration changes were applied, false if an
+     *         error occurred
      */
-    void execute(Services& services, System& system, Chassis& chassis,
-                 Device& device);
+    bool execute(Services& services, System& system, Chassis& chassis,
+                 Device& device,
+                 std::vector<DeferredVerification>* deferredVerifications =
+                     nullptr);
 
     /**
      * Executes the actions to configure the specified rail.
@@ -101,9 +124,32 @@ class Configuration
      * @param chassis chassis that contains the device
      * @param device device that contains the rail
      * @param rail rail to configure
+     * @param deferredVerifications if specified, the write verifications of
+     *                              the device are deferred and added to this
+     *                              vector.  See verifyWrites().
+     * @return true if the configuration changes were applied, false if an
+     *         error occurred
      */
-    void execute(Services& services, System& system, Chassis& chassis,
-                 Device& device, Rail& rail);
+    bool execute(Services& services, System& system, Chassis& chassis,
+                 Device& device, Rail& rail,
+                 std::vector<DeferredVerification>* deferredVerifications =
+                     nullptr);
+
+    /**
+     * Runs the write verifications that were deferred while configuring the
+     * specified device or rail.
+     *
+     * Stops at the first verification that fails, and logs the error the same
+     * way as execute() does.
+     *
+     * @param services system services like error logging and the journal
+     * @param deviceOrRailID ID of the device or rail that was configured
+     * @param verifications deferred write verifications
+     * @return true if the writes were verified, false if an error occurred
+     */
+    static bool verifyWrites(Services& services,
+                             const std::string& deviceOrRailID,
+                             std::vector<DeferredVerification>& verifications);
 
     /**
      * Returns the actions that configure the device/rail.
@@ -125,6 +171,31 @@ class Configuration
         return volts;
     }
 
+    /**
+     * Returns the compiled program, if any.
+     *
+     * @return pointer to compiled program, or nullptr if not compiled
+     */
+    const ActionProgram* getProgram() const
+    {
+        return program.get();
+    }
+
+    /**
+     * Links the actions.
+     *
+     * See Action::link() for more information.
+     *
+     * @param idMap mapping from IDs to the associated Device/Rule objects
+     */
+    void linkActions(const IDMap& idMap)
+    {
+        for (std::unique_ptr<Action>& action : actions)
+        {
+            action->link(idMap);
+        }
+    }
+
   private:
     /**
      * Executes the actions to configure a device or rail.
@@ -134,9 +205,13 @@ class Configuration
      * @param chassis chassis that contains the device
      * @param device device to configure or that contains rail to configure
      * @param deviceOrRailID ID of the device or rail to configure
+     * @param deferredVerifications deferred write verifications, if any
+     * @return true if the configuration changes were applied, false if an
+     *         error occurred
      */
-    void execute(Services& services, System& system, Chassis& chassis,
-                 Device& device, const std::string& deviceOrRailID);
+    bool execute(Services& services, System& system, Chassis& chassis,
+                 Device& device, const std::string& deviceOrRailID,
+                 std::vector<DeferredVerification>* deferredVerifications);
 
     /**
      * Optional output voltage value.
@@ -147,6 +222,11 @@ class Configuration
      * Actions that configure the device/rail.
      */
     std::vector<std::unique_ptr<Action>> actions{};
+
+    /**
+     * Actions compiled into a program, if compile() has been called.
+     */
+    std::unique_ptr<ActionProgram> program{};
 };
 
 } // namespace phosphor::power::regulators
@@ -0,0 +1,295 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "configuration_executor.hpp"
+
+#include "chassis.hpp"
+#include "device.hpp"
+#include "system.hpp"
+#include "worker_services.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <exception>
+#include <future>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <system_error>
+
+namespace phosphor::power::regulators
+{
+
+ConfigurationExecutor::ConfigurationExecutor(System& system, Chassis& chassis) :
+    system{system}, chassis{chassis}
+{
+    // Find the devices in the chassis
+    std::map<std::string, std::size_t> deviceIndexes{};
+    for (const std::unique_ptr<Device>& device : chassis.getDevices())
+    {
+        deviceIndexes.emplace(device->getID(), devices.size());
+        devices.emplace_back(device.get());
+    }
+
+    // Find the devices that each device depends on
+    dependencies.resize(devices.size());
+    std::vector<DeviceIndexes> dependents(devices.size());
+    std::vector<std::size_t> waitCount(devices.size(), 0);
+    for (std::size_t index = 0; index < devices.size(); ++index)
+    {
+        for (const std::string& id : devices[index]->getDependsOn())
+        {
+            auto it = deviceIndexes.find(id);
+            if ((it != deviceIndexes.end()) && (it->second != index))
+            {
+                dependencies[index].emplace_back(it->second);
+                dependents[it->second].emplace_back(index);
+                ++waitCount[index];
+            }
+        }
+    }
+
+    // Order the devices so each device follows the devices it depends on.
+    // Prefer the configuration file order.  If there is a cycle, the devices
+    // in the cycle are never added.
+    std::vector<bool> isOrdered(devices.size(), false);
+    while (order.size() < devices.size())
+    {
+        std::size_t index{0};
+        while ((index < devices.size()) &&
+               (isOrdered[index] || (waitCount[index] != 0)))
+        {
+            ++index;
+        }
+        if (index == devices.size())
+        {
+            break;
+        }
+
+        isOrdered[index] = true;
+        order.emplace_back(index);
+        for (std::size_t dependent : dependents[index])
+        {
+            --waitCount[dependent];
+        }
+    }
+
+    // Group the devices by I2C bus, keeping the dependency order
+    std::map<uint8_t, std::size_t> busIndexes{};
+    for (std::size_t index : order)
+    {
+        uint8_t bus = devices[index]->getI2CInterface().getBus();
+        auto [it, added] = busIndexes.try_emplace(bus, buses.size());
+        if (added)
+        {
+            buses.emplace_back();
+        }
+        buses[it->second].emplace_back(index);
+    }
+}
+
+unsigned int ConfigurationExecutor::execute(
+    Services& services, const std::optional<std::string>& powerDomain)
+{
+    Progress progress{};
+    progress.configured.assign(devices.size(), false);
+
+    // The devices that are not selected are treated as already configured, so
+    // the selected devices do not wait for them
+    auto isSelected = [&powerDomain](const Device* device) {
+        return !powerDomain || device->isInPowerDomain(*powerDomain);
+    };
+    for (std::size_t index = 0; index < devices.size(); ++index)
+    {
+        progress.configured[index] = !isSelected(devices[index]);
+    }
+
+    // Configure the devices serially if the dependencies contain a cycle
+    if (hasDependencyCycle())
+    {
+        services.getJournal().logError(
+            "Unable to configure devices in parallel in chassis " +
+            std::to_string(chassis.getNumber()) +
+            ": Device dependencies contain a cycle");
+        unsigned int errorCount{0};
+        for (Device* device : devices)
+        {
+            if (isSelected(device))
+            {
+                errorCount += device->configure(services, system, chassis);
+            }
+        }
+        return errorCount;
+    }
+
+    // Find the selected devices on each bus
+    auto select = [this, &isSelected](const DeviceIndexes& indexes) {
+        DeviceIndexes selected{};
+        std::copy_if(indexes.begin(), indexes.end(),
+                     std::back_inserter(selected),
+                     [this, &isSelected](std::size_t index) {
+                         return isSelected(devices[index]);
+                     });
+        return selected;
+    };
+    DeviceIndexes selectedOrder = select(order);
+    std::vector<DeviceIndexes> selectedBuses{};
+    for (const DeviceIndexes& bus : buses)
+    {
+        DeviceIndexes selected = select(bus);
+        if (!selected.empty())
+        {
+            selectedBuses.emplace_back(std::move(selected));
+        }
+    }
+
+    // Configure the devices on the calling thread if there is only one bus
+    if (selectedBuses.size() <= 1)
+    {
+        return configureDevices(services, selectedOrder, progress);
+    }
+
+    // Start a worker for each bus
+    std::shared_mutex mutex{};
+    std::vector<std::unique_ptr<WorkerServices>> workerServices{};
+    std::vector<std::future<unsigned int>> workers{};
+    std::vector<bool> isStarted(devices.size(), false);
+    for (const DeviceIndexes& bus : selectedBuses)
+    {
+        WorkerServices& worker = *workerServices.emplace_back(
+            std::make_unique<WorkerServices>(services, mutex));
+        try
+        {
+            workers.emplace_back(std::async(
+                std::launch::async, [this, &worker, &bus, &progress]() {
+                    return configureDevices(worker, bus, progress);
+                }));
+            for (std::size_t index : bus)
+            {
+                isStarted[index] = true;
+            }
+        }
+        catch (const std::system_error&)
+        {
+            // Unable to start a thread; configure this bus on this thread
+            workerServices.pop_back();
+        }
+    }
+
+    // Configure the devices on buses without a worker on this thread, in
+    // dependency order so this thread never waits for one of its own devices
+    DeviceIndexes remaining{};
+    std::copy_if(selectedOrder.begin(), selectedOrder.end(),
+                 std::back_inserter(remaining),
+                 [&isStarted](std::size_t index) { return !isStarted[index]; });
+    std::exception_ptr error{};
+    unsigned int errorCount{0};
+    if (!remaining.empty())
+    {
+        WorkerServices& worker = *workerServices.emplace_back(
+            std::make_unique<WorkerServices>(services, mutex));
+        try
+        {
+            errorCount += configureDevices(worker, remaining, progress);
+        }
+        catch (...)
+        {
+            error = std::current_exception();
+        }
+    }
+
+    // Wait for all the workers to finish
+    for (std::future<unsigned int>& worker : workers)
+    {
+        try
+        {
+            errorCount += worker.get();
+        }
+        catch (...)
+        {
+            if (!error)
+            {
+                error = std::current_exception();
+            }
+        }
+    }
+
+    // Replay the journal messages and other service calls on this thread
+    for (std::unique_ptr<WorkerServices>& worker : workerServices)
+    {
+        worker->replay();
+    }
+
+    // Re-throw the first error that occurred
+    if (error)
+    {
+        std::rethrow_exception(error);
+    }
+    return errorCount;
+}
+
+unsigned int ConfigurationExecutor::configureDevices(
+    Services& services, const DeviceIndexes& indexes, Progress& progress)
+{
+    unsigned int errorCount{0};
+    for (auto it = indexes.begin(); it != indexes.end(); ++it)
+    {
+        std::size_t index = *it;
+        try
+        {
+            // Wait for the devices this device depends on
+            {
+                std::unique_lock<std::mutex> lock{progress.mutex};
+                progress.deviceConfigured.wait(lock, [this, index,
+                                                      &progress]() {
+                    return std::all_of(
+                        dependencies[index].begin(), dependencies[index].end(),
+                        [&progress](std::size_t dependency) {
+                            return progress.configured[dependency];
+                        });
+                });
+            }
+
+            errorCount += devices[index]->configure(services, system, chassis);
+        }
+        catch (...)
+        {
+            // Do not make other workers wait for the remaining devices
+            markConfigured(DeviceIndexes{it, indexes.end()}, progress);
+            throw;
+        }
+        markConfigured(DeviceIndexes{index}, progress);
+    }
+    return errorCount;
+}
+
+void ConfigurationExecutor::markConfigured(const DeviceIndexes& indexes,
+                                           Progress& progress)
+{
+    {
+        std::lock_guard<std::mutex> lock{progress.mutex};
+        for (std::size_t index : indexes)
+        {
+            progress.configured[index] = true;
+        }
+    }
+    progress.deviceConfigured.notify_all();
+}
+
+} // namespace phosphor::power::regulators
@@ -0,0 +1,209 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "services.hpp"
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace phosphor::power::regulators
+{
+
+// Forward declarations to avoid circular dependencies
+class Chassis;
+class Device;
+class System;
+
+/**
+ * @class ConfigurationExecutor
+ *
+ * Configures the devices in a chassis, configuring the devices on each I2C
+ * bus in parallel.
+ *
+ * The devices in the chassis are grouped by the I2C bus they are attached to.
+ * Each bus is handled by its own worker thread.  The devices on one bus are
+ * configured serially.
+ *
+ * A device may depend on other devices in the chassis using the depends_on
+ * property in the configuration file.  A device is not configured until the
+ * devices it depends on have been configured, even if they are on a different
+ * bus.  Otherwise devices are configured in the same order as the
+ * configuration file.  Dependencies on devices that are not in the chassis are
+ * ignored.
+ *
+ * Service calls made by the worker threads are handled the same way as in
+ * SensorMonitoringExecutor.  Journal messages and error logs are replayed on
+ * the calling thread after all the workers have finished.
+ *
+ * If all the devices are on the same bus, the devices are configured on the
+ * calling thread without any worker threads.  If the dependencies contain a
+ * cycle, an error is written to the journal and the devices are configured
+ * serially in the same order as the configuration file.
+ */
+class ConfigurationExecutor
+{
+  public:
+    // Specify which compiler-generated methods we want
+    ConfigurationExecutor() = delete;
+    ConfigurationExecutor(const ConfigurationExecutor&) = delete;
+    ConfigurationExecutor(ConfigurationExecutor&&) = delete;
+    ConfigurationExecutor& operator=(const ConfigurationExecutor&) = delete;
+    ConfigurationExecutor& operator=(ConfigurationExecutor&&) = delete;
+    ~ConfigurationExecutor() = default;
+
+    /**
+     * Constructor.
+     *
+     * Groups the devices in the specified chassis by I2C bus and resolves
+     * their dependencies.
+     *
+     * @param system system that contains the chassis
+     * @param chassis chassis whose devices will be configured
+     */
+    explicit ConfigurationExecutor(System& system, Chassis& chassis);
+
+    /**
+     * Configures the devices in the chassis.
+     *
+     * Throws an exception if an error occurs while configuring a device.  The
+     * devices on other buses are still configured.
+     *
+     * If a power domain is specified, only the devices in that power domain
+     * are configured.  Dependencies on devices outside of the power domain
+     * are ignored, since those devices are configured separately.
+     *
+     * @param services system services like error logging and the journal
+     * @param powerDomain name of the power domain whose devices should be
+     *                    configured, or an empty string for the devices that
+     *                    are not in a power domain.  If not specified, all the
+     *                    devices are configured.
+     * @return number of errors that occurred configuring the devices
+     */
+    unsigned int
+        execute(Services& services,
+                const std::optional<std::string>& powerDomain = std::nullopt);
+
+    /**
+     * Returns the number of I2C buses the devices were grouped into.
+     *
+     * @return number of buses
+     */
+    std::size_t getBusCount() const
+    {
+        return buses.size();
+    }
+
+    /**
+     * Returns whether the device dependencies contain a cycle.
+     *
+     * @return true if dependencies contain a cycle, false otherwise
+     */
+    bool hasDependencyCycle() const
+    {
+        return order.size() != devices.size();
+    }
+
+  private:
+    /**
+     * Indexes of devices in the devices vector.
+     */
+    using DeviceIndexes = std::vector<std::size_t>;
+
+    /**
+     * Tracks which devices have been configured while workers are running.
+     */
+    struct Progress
+    {
+        /**
+         * Mutex that protects the configured vector.
+         */
+        std::mutex mutex{};
+
+        /**
+         * Notified when a device has been configured.
+         */
+        std::condition_variable deviceConfigured{};
+
+        /**
+         * Indicates whether each device has been configured.
+         */
+        std::vector<bool> configured{};
+    };
+
+    /**
+     * Configures the specified devices in order.
+     *
+     * Waits for the dependencies of each device to be configured first.  If
+     * an error occurs, the remaining devices are marked as configured so that
+     * other workers do not wait for them, and the exception is re-thrown.
+     *
+     * @param services system services like error logging and the journal
+     * @param indexes devices to configure
+     * @param progress devices that have been configured
+     * @return number of errors that occurred configuring the devices
+     */
+    unsigned int configureDevices(Services& services,
+                                  const DeviceIndexes& indexes,
+                                  Progress& progress);
+
+    /**
+     * Marks the specified devices as configured and notifies the workers.
+     *
+     * @param indexes devices that have been configured
+     * @param progress devices that have been configured
+     */
+    static void markConfigured(const DeviceIndexes& indexes,
+                               Progress& progress);
+
+    /**
+     * System that contains the chassis.
+     */
+    System& system;
+
+    /**
+     * Chassis whose devices are configured.
+     */
+    Chassis& chassis;
+
+    /**
+     * Devices in the chassis in the same order as the configuration file.
+     */
+    std::vector<Device*> devices{};
+
+    /**
+     * Devices that each device depends on.  Indexed the same as devices.
+     */
+    std::vector<DeviceIndexes> dependencies{};
+
+    /**
+     * Devices grouped by I2C bus.  The devices on each bus are in dependency
+     * order.
+     */
+    std::vector<DeviceIndexes> buses{};
+
+    /**
+     * Devices in an order that satisfies the dependencies.  Incomplete if the
+     * dependencies contain a cycle.
+     */
+    DeviceIndexes order{};
+};
+
+} // namespace phosphor::power::regulators
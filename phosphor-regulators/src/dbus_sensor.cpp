@@ -16,6 +16,11 @@
 
 #include "dbus_sensor.hpp"
 
+#include <systemd/sd-bus.h>
+
+#include <sdbusplus/exception.hpp>
+
+#include <algorithm>
 #include <cmath>
 #include <limits>
 #include <utility>
@@ -27,20 +32,32 @@ namespace phosphor::power::regulators
  * Constants for current sensors.
  *
  * Values are in amperes.
+ *
+ * Output current is noisy, so the value is only updated when it changes by
+ * more than the deadband percentage.  It is updated at least once per maximum
+ * age so other applications know it is still current.
  */
 constexpr double currentMinValue = 0.0;
 constexpr double currentMaxValue = 500.0;
 constexpr double currentHysteresis = 1.0;
+constexpr double currentDeadbandPercent = 2.0;
+constexpr std::chrono::milliseconds currentMinUpdateInterval{500};
+constexpr std::chrono::milliseconds currentMaxAge{30000};
 constexpr const char* currentNamespace = "current";
 
 /**
  * Constants for power sensors.
  *
  * Values are in watts.
+ *
+ * Output power follows the output current, so it uses the same update policy.
  */
 constexpr double powerMinValue = 0.0;
 constexpr double powerMaxValue = 1000.0;
 constexpr double powerHysteresis = 1.0;
+constexpr double powerDeadbandPercent = 2.0;
+constexpr std::chrono::milliseconds powerMinUpdateInterval{500};
+constexpr std::chrono::milliseconds powerMaxAge{30000};
 constexpr const char* powerNamespace = "power";
 
 /**
@@ -69,15 +86,16 @@ constexpr const char* voltageNamespace = "voltage";
 DBusSensor::DBusSensor(sdbusplus::bus::bus& bus, const std::string& name,
                        SensorType type, double value, const std::string& rail,
                        const std::string& deviceInventoryPath,
-                       const std::string& chassisInventoryPath) :
+                       const std::string& chassisInventoryPath,
+                       bool deferSignals) :
     bus{bus},
     name{name}, type{type}, rail{rail}
 {
     // Get sensor properties that are based on the sensor type
-    std::string objectPath;
     Unit unit;
     double minValue, maxValue;
     getTypeBasedProperties(objectPath, unit, minValue, maxValue);
+    typeUpdatePolicy = updatePolicy;
 
     // Get the D-Bus associations to create for this sensor
     std::vector<AssocationTuple> associations =
@@ -104,17 +122,31 @@ DBusSensor::DBusSensor(sdbusplus::bus::bus& bus, const std::string& name,
     // Set properties on the Association.Definitions interface
     dbusObject->associations(std::move(associations), skipSignal);
 
-    // Now emit signal that object has been created
-    dbusObject->emit_object_added();
+    // Now emit signal that object has been created, unless the signal is
+    // deferred so it can be emitted together with those for other objects
+    if (deferSignals)
+    {
+        isObjectAddedSignalDeferred = true;
+    }
+    else
+    {
+        dbusObject->emit_object_added();
+    }
 
     // Set the last update time
     setLastUpdateTime();
+    lastValueUpdateTime = std::chrono::steady_clock::now();
 }
 
 void DBusSensor::disable()
 {
-    // Set sensor value to NaN
+    // Set sensor value to NaN.  Discard the values in the current aggregation
+    // window since they were read before the sensor was disabled.
     setValueToNaN();
+    if (aggregator)
+    {
+        aggregator->reset();
+    }
 
     // Set the sensor to unavailable since it is disabled
     dbusObject->available(false);
@@ -123,36 +155,140 @@ void DBusSensor::disable()
     setLastUpdateTime();
 }
 
-void DBusSensor::setToErrorState()
+void DBusSensor::emitDeferredSignals()
 {
-    // Set sensor value to NaN
-    setValueToNaN();
+    // The InterfacesAdded signal contains the current property values, so
+    // no PropertiesChanged signals are needed
+    if (isObjectAddedSignalDeferred)
+    {
+        isObjectAddedSignalDeferred = false;
+        isValueSignalDeferred = false;
+        isFunctionalSignalDeferred = false;
+        isAvailableSignalDeferred = false;
+        dbusObject->emit_object_added();
+        return;
+    }
+
+    // Build list of D-Bus interfaces and properties with deferred signals
+    std::vector<std::pair<const char*, const char*>> changes{};
+    if (isValueSignalDeferred)
+    {
+        changes.emplace_back(ValueInterface::interface, "Value");
+    }
+    if (isFunctionalSignalDeferred)
+    {
+        changes.emplace_back(OperationalStatusInterface::interface,
+                             "Functional");
+    }
+    if (isAvailableSignalDeferred)
+    {
+        changes.emplace_back(AvailabilityInterface::interface, "Available");
+    }
+    isValueSignalDeferred = false;
+    isFunctionalSignalDeferred = false;
+    isAvailableSignalDeferred = false;
+
+    // Emit one PropertiesChanged signal for each interface
+    for (const auto& [interface, property] : changes)
+    {
+        emitPropertiesChanged(interface, property);
+    }
+}
+
+void DBusSensor::setAggregatedValue(double value,
+                                    const SensorAggregation& aggregation,
+                                    bool deferSignals)
+{
+    // Switch to the aggregate policy.  Start a new window if the aggregation
+    // changed, such as when a new configuration file was loaded.
+    if (!aggregator || (aggregator->getAggregation() != aggregation))
+    {
+        aggregator.emplace(aggregation);
+    }
+    updatePolicy = ValueUpdatePolicy::aggregate;
+
+    // Update value on D-Bus at the end of the window.  If the current value is
+    // NaN, update it immediately rather than waiting for the window to end.
+    std::optional<double> statistic =
+        aggregator->add(value, SensorAggregator::Clock::now());
+    if (statistic)
+    {
+        setDBusValue(*statistic, deferSignals);
+    }
+    else if (std::isnan(dbusObject->value()))
+    {
+        setDBusValue(value, deferSignals);
+    }
+
+    // Set the sensor to functional since it has a valid value
+    setFunctional(true, deferSignals);
+
+    // Set the sensor to available since it is not disabled
+    setAvailable(true, deferSignals);
+
+    // Set the last update time
+    setLastUpdateTime();
+}
+
+void DBusSensor::setToErrorState(bool deferSignals)
+{
+    // Set sensor value to NaN.  Discard the values in the current aggregation
+    // window since the sensor could not be read.
+    setValueToNaN(deferSignals);
+    if (aggregator)
+    {
+        aggregator->reset();
+    }
 
     // Set the sensor to non-functional since it could not be read
-    dbusObject->functional(false);
+    setFunctional(false, deferSignals);
 
     // Set the last update time
     setLastUpdateTime();
 }
 
-void DBusSensor::setValue(double value)
+void DBusSensor::setValue(double value, bool deferSignals)
 {
-    // Update value on D-Bus if necessary
+    // Switch back to the policy based on the sensor type if necessary
+    if (aggregator)
+    {
+        aggregator = std::nullopt;
+        updatePolicy = typeUpdatePolicy;
+    }
+
+    // Update value on D-Bus if necessary.  If the value is too old, update it
+    // even if it has not changed.
     if (shouldUpdateValue(value))
     {
-        dbusObject->value(value);
+        setDBusValue(value, deferSignals);
+    }
+    else if (isValueExpired())
+    {
+        setDBusValue(value, deferSignals, true);
     }
 
     // Set the sensor to functional since it has a valid value
-    dbusObject->functional(true);
+    setFunctional(true, deferSignals);
 
     // Set the sensor to available since it is not disabled
-    dbusObject->available(true);
+    setAvailable(true, deferSignals);
 
     // Set the last update time
     setLastUpdateTime();
 }
 
+void DBusSensor::emitPropertiesChanged(const char* interface,
+                                       const char* property)
+{
+    int rc = sd_bus_emit_properties_changed(bus.get(), objectPath.c_str(),
+                                            interface, property, nullptr);
+    if (rc < 0)
+    {
+        throw sdbusplus::exception::SdBusError(
+            -rc, "sd_bus_emit_properties_changed");
+    }
+}
+
 std::vector<AssocationTuple>
     DBusSensor::getAssociations(const std::string& deviceInventoryPath,
                                 const std::string& chassisInventoryPath)
@@ -184,8 +320,11 @@ void DBusSensor::getTypeBasedProperties(std::string& objectPath, Unit& unit,
             unit = Unit::Amperes;
             minValue = currentMinValue;
             maxValue = currentMaxValue;
-            updatePolicy = ValueUpdatePolicy::hysteresis;
+            updatePolicy = ValueUpdatePolicy::deadband;
             hysteresis = currentHysteresis;
+            deadbandPercent = currentDeadbandPercent;
+            minUpdateInterval = currentMinUpdateInterval;
+            maxAge = currentMaxAge;
             break;
 
         case SensorType::iout_peak:
@@ -209,8 +348,11 @@ void DBusSensor::getTypeBasedProperties(std::string& objectPath, Unit& unit,
             unit = Unit::Watts;
             minValue = powerMinValue;
             maxValue = powerMaxValue;
-            updatePolicy = ValueUpdatePolicy::hysteresis;
+            updatePolicy = ValueUpdatePolicy::deadband;
             hysteresis = powerHysteresis;
+            deadbandPercent = powerDeadbandPercent;
+            minUpdateInterval = powerMinUpdateInterval;
+            maxAge = powerMaxAge;
             break;
 
         case SensorType::temperature:
@@ -265,7 +407,65 @@ void DBusSensor::getTypeBasedProperties(std::string& objectPath, Unit& unit,
     objectPath += name;
 }
 
-void DBusSensor::setValueToNaN()
+bool DBusSensor::isValueExpired() const
+{
+    return (updatePolicy == ValueUpdatePolicy::deadband) &&
+           ((std::chrono::steady_clock::now() - lastValueUpdateTime) >=
+            maxAge);
+}
+
+void DBusSensor::setAvailable(bool available, bool deferSignals)
+{
+    // The generated C++ code only emits a signal if the value changed.  When
+    // deferring the signal, check for a change here.
+    if (!deferSignals)
+    {
+        dbusObject->available(available);
+    }
+    else if (dbusObject->available() != available)
+    {
+        dbusObject->available(available, true);
+        isAvailableSignalDeferred = true;
+    }
+}
+
+void DBusSensor::setFunctional(bool functional, bool deferSignals)
+{
+    if (!deferSignals)
+    {
+        dbusObject->functional(functional);
+    }
+    else if (dbusObject->functional() != functional)
+    {
+        dbusObject->functional(functional, true);
+        isFunctionalSignalDeferred = true;
+    }
+}
+
+void DBusSensor::setDBusValue(double value, bool deferSignals,
+                              bool forceSignal)
+{
+    if (!deferSignals)
+    {
+        if (forceSignal && (dbusObject->value() == value))
+        {
+            // Generated C++ code does not emit a signal if value is unchanged
+            emitPropertiesChanged(ValueInterface::interface, "Value");
+        }
+        else
+        {
+            dbusObject->value(value);
+        }
+    }
+    else if (forceSignal || (dbusObject->value() != value))
+    {
+        dbusObject->value(value, true);
+        isValueSignalDeferred = true;
+    }
+    lastValueUpdateTime = std::chrono::steady_clock::now();
+}
+
+void DBusSensor::setValueToNaN(bool deferSignals)
 {
     // Get current value published on D-Bus
     double currentValue = dbusObject->value();
@@ -278,7 +478,7 @@ void DBusSensor::setValueToNaN()
     if (!std::isnan(currentValue))
     {
         // Set value to NaN
-        dbusObject->value(std::numeric_limits<double>::quiet_NaN());
+        setDBusValue(std::numeric_limits<double>::quiet_NaN(), deferSignals);
     }
 }
 
@@ -305,12 +505,24 @@ bool DBusSensor::shouldUpdateValue(double value)
             case ValueUpdatePolicy::hysteresis:
                 shouldUpdate = (std::abs(value - currentValue) >= hysteresis);
                 break;
+            case ValueUpdatePolicy::deadband:
+                shouldUpdate =
+                    ((std::chrono::steady_clock::now() - lastValueUpdateTime) >=
+                     minUpdateInterval) &&
+                    (std::abs(value - currentValue) >=
+                     std::max(hysteresis, std::abs(currentValue) *
+                                              deadbandPercent / 100.0));
+                break;
             case ValueUpdatePolicy::highest:
                 shouldUpdate = (value > currentValue);
                 break;
             case ValueUpdatePolicy::lowest:
                 shouldUpdate = (value < currentValue);
                 break;
+            case ValueUpdatePolicy::aggregate:
+                // Value is updated by setAggregatedValue()
+                shouldUpdate = true;
+                break;
         }
     }
 
@@ -15,6 +15,7 @@
  */
 #pragma once
 
+#include "sensor_aggregator.hpp"
 #include "sensors.hpp"
 
 #include <sdbusplus/bus.hpp>
@@ -26,6 +27,7 @@
 
 #include <chrono>
 #include <memory>
+#include <optional>
 #include <string>
 #include <tuple>
 #include <vector>
@@ -119,11 +121,15 @@ class DBusSensor
      *                            device that produces the rail
      * @param chassisInventoryPath D-Bus inventory path of the chassis that
      *                             contains the voltage regulator device
+     * @param deferSignals specifies whether to defer the InterfacesAdded
+     *                     signal for the new object until
+     *                     emitDeferredSignals() is called
      */
     explicit DBusSensor(sdbusplus::bus::bus& bus, const std::string& name,
                         SensorType type, double value, const std::string& rail,
                         const std::string& deviceInventoryPath,
-                        const std::string& chassisInventoryPath);
+                        const std::string& chassisInventoryPath,
+                        bool deferSignals = false);
 
     /**
      * Disable this sensor.
@@ -136,6 +142,20 @@ class DBusSensor
      */
     void disable();
 
+    /**
+     * Emit the signals that were deferred by the constructor, setValue(), or
+     * setToErrorState().
+     *
+     * If the InterfacesAdded signal for the object was deferred, only that
+     * signal is emitted since it contains the current property values.
+     * Otherwise one PropertiesChanged signal is emitted for each D-Bus
+     * interface that has changed properties.  Does nothing if no signals were
+     * deferred.
+     *
+     * Throws an exception if an error occurs.
+     */
+    void emitDeferredSignals();
+
     /**
      * Return the last time this sensor was updated.
      *
@@ -176,13 +196,37 @@ class DBusSensor
         return type;
     }
 
+    /**
+     * Set the value of this sensor using the aggregate value update policy.
+     *
+     * The value is added to the current aggregation window.  The D-Bus value
+     * is only updated at the end of the window, when it is set to the
+     * statistic specified by aggregation.  If the D-Bus value is NaN, it is
+     * set to the new value immediately.
+     *
+     * Switches the sensor to the aggregate value update policy.  If the
+     * aggregation differs from the previous call, a new window is started.
+     *
+     * Do not specify the value NaN; see setValue().
+     *
+     * @param value new sensor value
+     * @param aggregation defines the window and the statistic to publish
+     * @param deferSignals specifies whether to defer the PropertiesChanged
+     *                     signals until emitDeferredSignals() is called
+     */
+    void setAggregatedValue(double value, const SensorAggregation& aggregation,
+                            bool deferSignals = false);
+
     /**
      * Set this sensor to the error state.
      *
      * Updates the sensor properties on D-Bus to indicate an error occurred and
      * the sensor value could not be read.
+     *
+     * @param deferSignals specifies whether to defer the PropertiesChanged
+     *                     signals until emitDeferredSignals() is called
      */
-    void setToErrorState();
+    void setToErrorState(bool deferSignals = false);
 
     /**
      * Set the value of this sensor.
@@ -192,9 +236,14 @@ class DBusSensor
      * disable() or setToErrorState() method instead so that all affected D-Bus
      * interfaces are updated correctly.
      *
+     * If the sensor was using the aggregate value update policy, it switches
+     * back to the policy based on the sensor type.
+     *
      * @param value new sensor value
+     * @param deferSignals specifies whether to defer the PropertiesChanged
+     *                     signals until emitDeferredSignals() is called
      */
-    void setValue(double value);
+    void setValue(double value, bool deferSignals = false);
 
   private:
     /**
@@ -258,9 +307,50 @@ class DBusSensor
          * sensor value is normally the lowest value read since the system was
          * powered on.
          */
-        lowest
+        lowest,
+
+        /**
+         * Deadband value update policy.
+         *
+         * The sensor value will only be updated if the new value differs from
+         * the current value by at least the deadband percentage of the current
+         * value, or by the hysteresis amount if that is larger.  The value is
+         * not updated more often than the minimum update interval.
+         *
+         * If the value has not been updated for the maximum age, it is
+         * updated even if it has not changed.  The PropertiesChanged signal
+         * tells other applications the value is still current.
+         *
+         * This policy is used for noisy sensors, such as output current, where
+         * a fixed hysteresis would cause an update nearly every cycle.
+         */
+        deadband,
+
+        /**
+         * Aggregate value update policy.
+         *
+         * The sensor value is read frequently, such as to detect transient
+         * events, but is only updated once per aggregation window.  The values
+         * read during the window are combined into a statistic such as the
+         * mean or peak-to-peak value.  This avoids frequent D-Bus traffic
+         * while still using every value that was read.
+         *
+         * This policy is selected by the configuration file rather than by
+         * the sensor type.  See SensorAggregation.
+         */
+        aggregate
     };
 
+    /**
+     * Emit a PropertiesChanged signal for the specified property.
+     *
+     * Throws an exception if an error occurs.
+     *
+     * @param interface D-Bus interface that contains the property
+     * @param property property name
+     */
+    void emitPropertiesChanged(const char* interface, const char* property);
+
     /**
      * Get the D-Bus associations to create for this sensor.
      *
@@ -289,6 +379,16 @@ class DBusSensor
     void getTypeBasedProperties(std::string& objectPath, Unit& unit,
                                 double& minValue, double& maxValue);
 
+    /**
+     * Returns whether the sensor value on D-Bus is older than the maximum age
+     * and should be updated even if it has not changed.
+     *
+     * Always returns false if updatePolicy is not deadband.
+     *
+     * @return true if value should be updated on D-Bus, false otherwise
+     */
+    bool isValueExpired() const;
+
     /**
      * Set the last time this sensor was updated.
      */
@@ -297,10 +397,43 @@ class DBusSensor
         lastUpdateTime = std::chrono::system_clock::now();
     }
 
+    /**
+     * Set the Available property on D-Bus.
+     *
+     * @param available new property value
+     * @param deferSignals specifies whether to defer the PropertiesChanged
+     *                     signal
+     */
+    void setAvailable(bool available, bool deferSignals);
+
+    /**
+     * Set the Functional property on D-Bus.
+     *
+     * @param functional new property value
+     * @param deferSignals specifies whether to defer the PropertiesChanged
+     *                     signal
+     */
+    void setFunctional(bool functional, bool deferSignals);
+
+    /**
+     * Set the Value property on D-Bus.
+     *
+     * @param value new property value
+     * @param deferSignals specifies whether to defer the PropertiesChanged
+     *                     signal
+     * @param forceSignal specifies whether to emit the PropertiesChanged
+     *                    signal even if the value did not change
+     */
+    void setDBusValue(double value, bool deferSignals,
+                      bool forceSignal = false);
+
     /**
      * Set the sensor value on D-Bus to NaN.
+     *
+     * @param deferSignals specifies whether to defer the PropertiesChanged
+     *                     signal
      */
-    void setValueToNaN();
+    void setValueToNaN(bool deferSignals = false);
 
     /**
      * Returns whether to update the sensor value on D-Bus with the specified
@@ -326,6 +459,11 @@ class DBusSensor
      */
     SensorType type;
 
+    /**
+     * D-Bus object path.
+     */
+    std::string objectPath{};
+
     /**
      * Voltage regulator rail associated with this sensor.
      */
@@ -336,13 +474,49 @@ class DBusSensor
      */
     ValueUpdatePolicy updatePolicy{ValueUpdatePolicy::hysteresis};
 
+    /**
+     * Sensor value update policy based on the sensor type.
+     *
+     * Restored when the sensor stops using the aggregate policy.
+     */
+    ValueUpdatePolicy typeUpdatePolicy{ValueUpdatePolicy::hysteresis};
+
     /**
      * Hysteresis value.
      *
-     * Only used when updatePolicy is hysteresis.
+     * Only used when updatePolicy is hysteresis or deadband.
      */
     double hysteresis{0.0};
 
+    /**
+     * Deadband as a percentage of the current value.
+     *
+     * Only used when updatePolicy is deadband.
+     */
+    double deadbandPercent{0.0};
+
+    /**
+     * Minimum interval between updates of the value on D-Bus.
+     *
+     * Only used when updatePolicy is deadband.
+     */
+    std::chrono::milliseconds minUpdateInterval{0};
+
+    /**
+     * Maximum age of the value on D-Bus before it is updated again, even if
+     * it has not changed.
+     *
+     * Only used when updatePolicy is deadband.
+     */
+    std::chrono::milliseconds maxAge{0};
+
+    /**
+     * Values read during the current aggregation window.
+     *
+     * Only set when updatePolicy is aggregate.
+     */
+    std::optional<SensorAggregator> aggregator{};
+
     /**
      * sdbusplus object_t class that implements all the necessary D-Bus
      * interfaces via templates and multiple inheritance.
@@ -353,6 +527,35 @@ class DBusSensor
      * Last time this sensor was updated.
      */
     std::chrono::system_clock::time_point lastUpdateTime{};
+
+    /**
+     * Last time the Value property was updated on D-Bus.
+     */
+    std::chrono::steady_clock::time_point lastValueUpdateTime{};
+
+    /**
+     * Indicates whether the InterfacesAdded signal for the object is
+     * deferred.
+     */
+    bool isObjectAddedSignalDeferred{false};
+
+    /**
+     * Indicates whether a PropertiesChanged signal is deferred for the Value
+     * property.
+     */
+    bool isValueSignalDeferred{false};
+
+    /**
+     * Indicates whether a PropertiesChanged signal is deferred for the
+     * Functional property.
+     */
+    bool isFunctionalSignalDeferred{false};
+
+    /**
+     * Indicates whether a PropertiesChanged signal is deferred for the
+     * Available property.
+     */
+    bool isAvailableSignalDeferred{false};
 };
 
 } // namespace phosphor::power::regulators
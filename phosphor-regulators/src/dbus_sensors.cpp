@@ -16,11 +16,101 @@
 
 #include "dbus_sensors.hpp"
 
+#include "memory_accounting.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <exception>
 #include <utility>
 
 namespace phosphor::power::regulators
 {
 
+using util::sensor_telemetry::Status;
+
+namespace
+{
+
+/**
+ * Returns the last element of a D-Bus object path.
+ *
+ * @param path object path
+ * @return last element, or the whole path if it has no '/'
+ */
+std::string getLeaf(const std::string& path)
+{
+    std::string::size_type pos = path.rfind('/');
+    return (pos == std::string::npos) ? path : path.substr(pos + 1);
+}
+
+/**
+ * Returns the label of the derived total of a device.
+ *
+ * The label contains the path of the device relative to its chassis, so
+ * devices with the same name in different chassis have different labels.
+ *
+ * @param deviceInventoryPath D-Bus inventory path of the device
+ * @param chassisInventoryPath D-Bus inventory path of the chassis
+ * @return label
+ */
+std::string getDeviceTotalLabel(const std::string& deviceInventoryPath,
+                                const std::string& chassisInventoryPath)
+{
+    std::string relativePath{};
+    if (deviceInventoryPath.starts_with(chassisInventoryPath + '/'))
+    {
+        relativePath =
+            deviceInventoryPath.substr(chassisInventoryPath.size() + 1);
+    }
+    else
+    {
+        relativePath = getLeaf(deviceInventoryPath);
+    }
+    std::replace(relativePath.begin(), relativePath.end(), '/', '_');
+    return getLeaf(chassisInventoryPath) + '_' + relativePath + "_total";
+}
+
+/**
+ * Returns the precedence of a derived total status.
+ *
+ * @param status status of a derived value
+ * @return precedence; higher values take precedence
+ */
+int getPrecedence(Status status)
+{
+    switch (status)
+    {
+        case Status::error:
+            return 3;
+        case Status::ok:
+            return 2;
+        case Status::unavailable:
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+} // namespace
+
+DBusSensors::DBusSensors(sdbusplus::bus::bus& bus, bool deferSignals,
+                         bool enableTelemetry) :
+    bus{bus}, manager{bus, sensorsObjectPath}, deferSignals{deferSignals}
+{
+    if (enableTelemetry)
+    {
+        try
+        {
+            telemetry = std::make_unique<util::sensor_telemetry::Writer>(
+                sensorTelemetryName, sensorTelemetryCapacity);
+        }
+        catch (const std::exception&)
+        {
+            // Telemetry is optional; sensors are still available on D-Bus
+        }
+    }
+}
+
 void DBusSensors::enable()
 {
     // Currently nothing to do here.  The next monitoring cycle will set the
@@ -31,72 +121,182 @@ void DBusSensors::endCycle()
 {
     // Delete any sensors that were not updated during this monitoring cycle.
     // This can happen if the hardware device producing the sensors was removed
-    // or replaced with a different version.
-    auto it = sensors.begin();
-    while (it != sensors.end())
+    // or replaced with a different version.  Sensors for skipped rails were
+    // not expected to be updated.  Derived sensors are removed by
+    // updateDerivedSensors() when no rail contributes to them.
+    for (RailSensors& row : railSensors)
     {
-        // Increment iterator before potentially deleting the sensor.
-        // map::erase() invalidates iterators/references to the erased element.
-        auto& [sensorName, sensor] = *it;
-        ++it;
+        if (row.wasSkipped || row.isDerived)
+        {
+            continue;
+        }
+
+        for (std::size_t type = 0; type < sensorTypeCount; ++type)
+        {
+            std::unique_ptr<DBusSensor>& sensor = row.sensors[type];
+            if (sensor && (sensor->getLastUpdateTime() < cycleStartTime))
+            {
+                sensor.reset();
+                recordValue(row, static_cast<SensorType>(type), NAN,
+                            Status::removed);
+            }
+        }
+    }
 
-        // Check if last update time for sensor is before cycle start time
-        if (sensor->getLastUpdateTime() < cycleStartTime)
+    // Derive the power sensors from the values recorded during this cycle,
+    // so their signals are emitted with the other signals of the cycle
+    updateDerivedSensors();
+
+    // Emit the signals deferred during this monitoring cycle.  This includes
+    // the InterfacesAdded signals for the sensors created during the cycle,
+    // so the sensors created during the first cycle are announced together.
+    if (deferSignals)
+    {
+        for (RailSensors& row : railSensors)
         {
-            sensors.erase(sensorName);
+            for (std::unique_ptr<DBusSensor>& sensor : row.sensors)
+            {
+                if (sensor)
+                {
+                    sensor->emitDeferredSignals();
+                }
+            }
         }
     }
+    isCycleStarted = false;
 }
 
 void DBusSensors::endRail(bool errorOccurred)
 {
     // If an error occurred, set all sensors for current rail to the error state
-    if (errorOccurred)
+    if (errorOccurred && isRailStarted)
     {
-        for (auto& [sensorName, sensor] : sensors)
+        RailSensors& row = railSensors[railIndex];
+        for (std::size_t type = 0; type < sensorTypeCount; ++type)
         {
-            if (sensor->getRail() == rail)
+            if (row.sensors[type])
             {
-                sensor->setToErrorState();
+                row.sensors[type]->setToErrorState(areSignalsDeferred());
+                recordValue(row, static_cast<SensorType>(type), NAN,
+                            Status::error);
             }
         }
     }
 
     // Clear current rail information
-    rail.clear();
-    deviceInventoryPath.clear();
-    chassisInventoryPath.clear();
+    isRailStarted = false;
 }
 
 void DBusSensors::disable()
 {
     // Disable all sensors
-    for (auto& [sensorName, sensor] : sensors)
+    for (RailSensors& row : railSensors)
+    {
+        for (std::size_t type = 0; type < sensorTypeCount; ++type)
+        {
+            if (row.sensors[type])
+            {
+                row.sensors[type]->disable();
+                recordValue(row, static_cast<SensorType>(type), NAN,
+                            Status::unavailable);
+            }
+        }
+    }
+}
+
+void DBusSensors::disableRail(const std::string& rail)
+{
+    // Disable the sensors for the rail and keep them at the end of the cycle
+    RailSensors& row = railSensors[getRailIndex(rail)];
+    for (std::size_t type = 0; type < sensorTypeCount; ++type)
+    {
+        if (row.sensors[type])
+        {
+            row.sensors[type]->disable();
+            recordValue(row, static_cast<SensorType>(type), NAN,
+                        Status::unavailable);
+        }
+    }
+    row.wasSkipped = true;
+}
+
+std::vector<DBusSensors::SensorValue>
+    DBusSensors::getValues(uint64_t since) const
+{
+    std::vector<SensorValue> values{};
+    for (const RailSensors& row : railSensors)
+    {
+        for (std::size_t type = 0; type < sensorTypeCount; ++type)
+        {
+            const std::optional<SensorRecord>& record = row.records[type];
+            if (!record || (record->sequence <= since) ||
+                ((since == 0) && (record->status == Status::removed)))
+            {
+                continue;
+            }
+            values.emplace_back(SensorValue{
+                row.rail + '_' +
+                    sensors::toString(static_cast<SensorType>(type)),
+                record->status, record->value, record->timestamp,
+                record->readTime});
+        }
+    }
+    return values;
+}
+
+void DBusSensors::setAggregatedValue(SensorType type, double value,
+                                     const SensorAggregation& aggregation)
+{
+    if (!isRailStarted)
+    {
+        return;
+    }
+
+    // Create the sensor if it doesn't exist.  Add the value to the window
+    // of the sensor; the telemetry segment always receives the value read.
+    RailSensors& row = railSensors[railIndex];
+    std::unique_ptr<DBusSensor>& sensor =
+        row.sensors[static_cast<std::size_t>(type)];
+    if (!sensor)
     {
-        sensor->disable();
+        createSensor(row, type, value);
     }
+    sensor->setAggregatedValue(value, aggregation, areSignalsDeferred());
+    recordValue(row, type, value, Status::ok);
 }
 
 void DBusSensors::setValue(SensorType type, double value)
 {
-    // Build unique sensor name based on rail and sensor type
-    std::string sensorName{rail + '_' + sensors::toString(type)};
+    setValue(type, value, std::chrono::steady_clock::now());
+}
+
+void DBusSensors::setValue(SensorType type, double value,
+                           std::chrono::steady_clock::time_point readTime)
+{
+    if (!isRailStarted)
+    {
+        return;
+    }
 
     // Check to see if the sensor already exists
-    auto it = sensors.find(sensorName);
-    if (it != sensors.end())
+    RailSensors& row = railSensors[railIndex];
+    std::unique_ptr<DBusSensor>& sensor =
+        row.sensors[static_cast<std::size_t>(type)];
+    if (sensor)
     {
         // Sensor exists; update value
-        it->second->setValue(value);
+        sensor->setValue(value, areSignalsDeferred());
     }
     else
     {
-        // Sensor doesn't exist; create it and add it to the map
-        auto sensor = std::make_unique<DBusSensor>(bus, sensorName, type, value,
-                                                   rail, deviceInventoryPath,
-                                                   chassisInventoryPath);
-        sensors.emplace(sensorName, std::move(sensor));
+        createSensor(row, type, value);
     }
+    recordValue(row, type, value, Status::ok, readTime);
+}
+
+void DBusSensors::skipRail(const std::string& rail)
+{
+    railSensors[getRailIndex(rail)].wasSkipped = true;
 }
 
 void DBusSensors::startCycle()
@@ -104,6 +304,11 @@ void DBusSensors::startCycle()
     // Store the time when this monitoring cycle started.  This is used to
     // detect sensors that were not updated during this cycle.
     cycleStartTime = std::chrono::system_clock::now();
+    isCycleStarted = true;
+    for (RailSensors& row : railSensors)
+    {
+        row.wasSkipped = false;
+    }
 }
 
 void DBusSensors::startRail(const std::string& rail,
@@ -111,9 +316,270 @@ void DBusSensors::startRail(const std::string& rail,
                             const std::string& chassisInventoryPath)
 {
     // Store current rail information; used later by setValue() and endRail()
-    this->rail = rail;
-    this->deviceInventoryPath = deviceInventoryPath;
-    this->chassisInventoryPath = chassisInventoryPath;
+    railIndex = getRailIndex(rail);
+    isRailStarted = true;
+
+    // Only look up the derived rows again if the inventory paths changed
+    const RailSensors& row = railSensors[railIndex];
+    if (!row.derivedRailIndex ||
+        (row.deviceInventoryPath != deviceInventoryPath) ||
+        (row.chassisInventoryPath != chassisInventoryPath))
+    {
+        setRailInventoryPaths(railIndex, deviceInventoryPath,
+                              chassisInventoryPath);
+    }
+}
+
+void DBusSensors::addDerivedValue(DerivedValue& total,
+                                  const DerivedValue& power)
+{
+    if (power.status == Status::ok)
+    {
+        total.value += power.value;
+        total.readTime = std::min(total.readTime, power.readTime);
+    }
+    if (getPrecedence(power.status) > getPrecedence(total.status))
+    {
+        total.status = power.status;
+    }
+}
+
+void DBusSensors::createSensor(RailSensors& row, SensorType type, double value)
+{
+    memory_accounting::Scope memoryScope{memory_accounting::Tag::dbusSensors};
+
+    // Create the sensor with a unique name based on rail and sensor type
+    std::string sensorName{row.rail + '_' + sensors::toString(type)};
+    row.sensors[static_cast<std::size_t>(type)] = std::make_unique<DBusSensor>(
+        bus, sensorName, type, value, row.rail, row.deviceInventoryPath,
+        row.chassisInventoryPath, areSignalsDeferred());
+    if (telemetry)
+    {
+        row.telemetryIndexes[static_cast<std::size_t>(type)] =
+            telemetry->addSensor(sensorName);
+    }
+}
+
+std::size_t
+    DBusSensors::getDerivedIndex(const std::string& label,
+                                 const std::string& deviceInventoryPath,
+                                 const std::string& chassisInventoryPath)
+{
+    memory_accounting::Scope memoryScope{memory_accounting::Tag::dbusSensors};
+    auto [it, wasAdded] = derivedIndexes.try_emplace(label, railSensors.size());
+    if (wasAdded)
+    {
+        RailSensors& row = railSensors.emplace_back();
+        row.rail = label;
+        row.isDerived = true;
+        row.deviceInventoryPath = deviceInventoryPath;
+        row.chassisInventoryPath = chassisInventoryPath;
+    }
+    return it->second;
+}
+
+std::size_t DBusSensors::getRailIndex(const std::string& rail)
+{
+    memory_accounting::Scope memoryScope{memory_accounting::Tag::dbusSensors};
+    auto [it, wasAdded] = railIndexes.try_emplace(rail, railSensors.size());
+    if (wasAdded)
+    {
+        railSensors.emplace_back().rail = rail;
+    }
+    return it->second;
+}
+
+DBusSensors::DerivedValue DBusSensors::getRailPower(const RailSensors& row)
+{
+    const std::optional<SensorRecord>& vout =
+        row.records[static_cast<std::size_t>(SensorType::vout)];
+    const std::optional<SensorRecord>& iout =
+        row.records[static_cast<std::size_t>(SensorType::iout)];
+    if (!vout || !iout || (vout->status == Status::removed) ||
+        (iout->status == Status::removed))
+    {
+        return DerivedValue{};
+    }
+
+    DerivedValue power{};
+    if ((vout->status == Status::error) || (iout->status == Status::error))
+    {
+        power.status = Status::error;
+    }
+    else if ((vout->status == Status::unavailable) ||
+             (iout->status == Status::unavailable))
+    {
+        power.status = Status::unavailable;
+    }
+    else
+    {
+        power.status = Status::ok;
+        power.value = vout->value * iout->value;
+        power.readTime = std::min(vout->readTime, iout->readTime);
+    }
+    return power;
+}
+
+void DBusSensors::publishDerivedValue(RailSensors& row)
+{
+    constexpr SensorType type{SensorType::pout};
+    std::unique_ptr<DBusSensor>& sensor =
+        row.sensors[static_cast<std::size_t>(type)];
+    const DerivedValue& derived = row.derived;
+    switch (derived.status)
+    {
+        case Status::ok:
+            if (sensor)
+            {
+                sensor->setValue(derived.value, areSignalsDeferred());
+            }
+            else
+            {
+                createSensor(row, type, derived.value);
+            }
+            recordValue(row, type, derived.value, Status::ok,
+                        derived.readTime);
+            break;
+        case Status::error:
+            if (sensor)
+            {
+                sensor->setToErrorState(areSignalsDeferred());
+                recordValue(row, type, NAN, Status::error);
+            }
+            break;
+        case Status::unavailable:
+            if (sensor)
+            {
+                sensor->disable();
+                recordValue(row, type, NAN, Status::unavailable);
+            }
+            break;
+        default:
+            if (sensor)
+            {
+                sensor.reset();
+                recordValue(row, type, NAN, Status::removed);
+            }
+            break;
+    }
+}
+
+void DBusSensors::recordValue(RailSensors& row, SensorType type,
+                              double value, Status status,
+                              std::chrono::steady_clock::time_point readTime)
+{
+    // Convert the read time to the system clock for the D-Bus clients
+    using std::chrono::system_clock;
+    auto timestamp = system_clock::now() -
+                     std::chrono::duration_cast<system_clock::duration>(
+                         std::chrono::steady_clock::now() - readTime);
+
+    // Only count changes, so unchanged sensors are not returned by
+    // getValues() for a later sequence number
+    std::optional<SensorRecord>& record =
+        row.records[static_cast<std::size_t>(type)];
+    if (!record || (record->status != status) ||
+        ((status == Status::ok) && (record->value != value)))
+    {
+        record = SensorRecord{status, value, timestamp, readTime, ++sequence};
+    }
+    else
+    {
+        record->timestamp = timestamp;
+        record->readTime = readTime;
+    }
+
+    std::optional<std::size_t>& index =
+        row.telemetryIndexes[static_cast<std::size_t>(type)];
+    if (telemetry && index)
+    {
+        if (status == Status::removed)
+        {
+            telemetry->writeRemoved(*index);
+        }
+        else
+        {
+            telemetry->write(*index, value, status, readTime);
+        }
+    }
+}
+
+void DBusSensors::setRailInventoryPaths(
+    std::size_t index, const std::string& deviceInventoryPath,
+    const std::string& chassisInventoryPath)
+{
+    // Adding derived rows can reallocate the table, so the row of the rail
+    // is only accessed after the lookups
+    std::size_t railPowerIndex =
+        getDerivedIndex(railSensors[index].rail + "_derived",
+                        deviceInventoryPath, chassisInventoryPath);
+    std::optional<std::size_t> deviceTotalIndex{};
+    std::optional<std::size_t> chassisTotalIndex{};
+    if (!chassisInventoryPath.empty())
+    {
+        chassisTotalIndex =
+            getDerivedIndex(getLeaf(chassisInventoryPath) + "_total",
+                            chassisInventoryPath, chassisInventoryPath);
+        if (!deviceInventoryPath.empty() &&
+            (deviceInventoryPath != chassisInventoryPath))
+        {
+            deviceTotalIndex = getDerivedIndex(
+                getDeviceTotalLabel(deviceInventoryPath, chassisInventoryPath),
+                deviceInventoryPath, chassisInventoryPath);
+        }
+    }
+
+    RailSensors& row = railSensors[index];
+    row.deviceInventoryPath = deviceInventoryPath;
+    row.chassisInventoryPath = chassisInventoryPath;
+    row.derivedRailIndex = railPowerIndex;
+    row.deviceTotalIndex = deviceTotalIndex;
+    row.chassisTotalIndex = chassisTotalIndex;
+}
+
+void DBusSensors::updateDerivedSensors()
+{
+    for (RailSensors& row : railSensors)
+    {
+        if (row.isDerived)
+        {
+            row.derived = DerivedValue{};
+        }
+    }
+
+    // Rails that were skipped during this cycle contribute the values they
+    // last recorded
+    for (const RailSensors& row : railSensors)
+    {
+        if (row.isDerived || !row.derivedRailIndex)
+        {
+            continue;
+        }
+
+        DerivedValue power = getRailPower(row);
+        if (power.status == Status::removed)
+        {
+            continue;
+        }
+        railSensors[*row.derivedRailIndex].derived = power;
+        if (row.deviceTotalIndex)
+        {
+            addDerivedValue(railSensors[*row.deviceTotalIndex].derived, power);
+        }
+        if (row.chassisTotalIndex)
+        {
+            addDerivedValue(railSensors[*row.chassisTotalIndex].derived,
+                            power);
+        }
+    }
+
+    for (RailSensors& row : railSensors)
+    {
+        if (row.isDerived)
+        {
+            publishDerivedValue(row);
+        }
+    }
 }
 
 } // namespace phosphor::power::regulators
@@ -16,27 +16,108 @@
 #pragma once
 
 #include "dbus_sensor.hpp"
+#include "sensor_telemetry.hpp"
 #include "sensors.hpp"
 
 #include <sdbusplus/bus.hpp>
 #include <sdbusplus/server/manager.hpp>
 
+#include <array>
 #include <chrono>
-#include <map>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <optional>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace phosphor::power::regulators
 {
 
+/**
+ * Name of the shared memory segment containing the latest sensor values.
+ *
+ * Other processes can read the values using sensor_telemetry::Reader.
+ */
+constexpr const char* sensorTelemetryName = "/phosphor-regulators-sensors";
+
+/**
+ * Maximum number of sensors in the shared memory segment.
+ */
+constexpr std::size_t sensorTelemetryCapacity{1024};
+
 /**
  * @class DBusSensors
  *
  * Implementation of the Sensors interface using D-Bus.
+ *
+ * Sensors are stored in a table indexed by rail and SensorType.  Each rail is
+ * assigned an index the first time startRail() is called for it, and keeps
+ * that index while this object exists.  The rail index lookup is done once per
+ * rail in startRail(), so setValue() and endRail() only access the table row
+ * of the current rail.
+ *
+ * If deferred signals are enabled, the PropertiesChanged signals for sensor
+ * changes made during a monitoring cycle are emitted together by endCycle().
+ * Each sensor emits at most one signal per D-Bus interface per cycle, rather
+ * than one signal for every property change.
+ *
+ * The InterfacesAdded signals for sensors created during a monitoring cycle
+ * are also deferred until endCycle().  When hundreds of sensors are created
+ * during the first cycle, the signals are emitted in one pass after all the
+ * sensors have been read, rather than between the reads.  The new objects
+ * can be obtained with the GetManagedObjects method of the object manager as
+ * soon as they are created.
+ *
+ * If telemetry is enabled, the sensor values are also written to the shared
+ * memory segment named sensorTelemetryName.  Processes that need the values
+ * at a high rate can read them from the segment instead of from D-Bus.
+ *
+ * endCycle() also publishes derived power sensors computed from the vout and
+ * iout values recorded during the cycle: the power of each rail, named
+ * "<rail>_derived_pout", the total power of each device and the total power
+ * of each chassis.  The derived sensors are stored in extra table rows, so
+ * they have the same update policy, telemetry, and history as the sensors
+ * read from the hardware.
  */
 class DBusSensors : public Sensors
 {
   public:
+    /**
+     * Current value of one sensor.
+     */
+    struct SensorValue
+    {
+        /**
+         * Sensor name.
+         */
+        std::string name{};
+
+        /**
+         * Status of the sensor value.
+         */
+        util::sensor_telemetry::Status status{};
+
+        /**
+         * Sensor value.  NaN unless status is ok.
+         */
+        double value{};
+
+        /**
+         * Time that the value was read from the hardware, or that the status
+         * was last set if the value is not valid.
+         */
+        std::chrono::system_clock::time_point timestamp{};
+
+        /**
+         * Time on the monotonic clock that the value was read from the
+         * hardware, or that the status was last set if the value is not
+         * valid.
+         */
+        std::chrono::steady_clock::time_point readTime{};
+    };
+
     // Specify which compiler-generated methods we want
     DBusSensors() = delete;
     DBusSensors(const DBusSensors&) = delete;
@@ -48,11 +129,18 @@ class DBusSensors : public Sensors
     /**
      * Constructor.
      *
+     * If the shared memory segment for telemetry cannot be created,
+     * telemetry is disabled.
+     *
      * @param bus D-Bus bus object
+     * @param deferSignals specifies whether to defer the PropertiesChanged
+     *                     signals for sensor changes until the end of the
+     *                     monitoring cycle
+     * @param enableTelemetry specifies whether to write the sensor values to
+     *                        a shared memory segment
      */
-    explicit DBusSensors(sdbusplus::bus::bus& bus) :
-        bus{bus}, manager{bus, sensorsObjectPath}
-    {}
+    explicit DBusSensors(sdbusplus::bus::bus& bus, bool deferSignals = true,
+                         bool enableTelemetry = false);
 
     /** @copydoc Sensors::enable() */
     virtual void enable() override;
@@ -66,9 +154,52 @@ class DBusSensors : public Sensors
     /** @copydoc Sensors::disable() */
     virtual void disable() override;
 
-    /** @copydoc Sensors::setValue() */
+    /** @copydoc Sensors::disableRail() */
+    virtual void disableRail(const std::string& rail) override;
+
+    /**
+     * Returns the current sequence number.
+     *
+     * The sequence number is incremented each time the value or status of a
+     * sensor changes.  It starts at 0, before any sensor has a value.
+     *
+     * @return sequence number
+     */
+    uint64_t getSequence() const
+    {
+        return sequence;
+    }
+
+    /**
+     * Returns the current values of the sensors from the sensors table.
+     *
+     * If since is 0, all sensors that currently exist are returned.
+     * Otherwise only the sensors whose value or status changed after the
+     * specified sequence number are returned, including the sensors removed
+     * since then with the status removed.
+     *
+     * @param since sequence number from a previous getSequence() call, or 0
+     * @return sensor values ordered by rail and sensor type
+     */
+    std::vector<SensorValue> getValues(uint64_t since = 0) const;
+
+    /** @copydoc Sensors::setAggregatedValue() */
+    virtual void
+        setAggregatedValue(SensorType type, double value,
+                           const SensorAggregation& aggregation) override;
+
+    /** @copydoc Sensors::setValue(SensorType, double) */
     virtual void setValue(SensorType type, double value) override;
 
+    /** @copydoc Sensors::setValue(SensorType, double,
+     *           std::chrono::steady_clock::time_point) */
+    virtual void
+        setValue(SensorType type, double value,
+                 std::chrono::steady_clock::time_point readTime) override;
+
+    /** @copydoc Sensors::skipRail() */
+    virtual void skipRail(const std::string& rail) override;
+
     /** @copydoc Sensors::startCycle() */
     virtual void startCycle() override;
 
@@ -78,6 +209,249 @@ class DBusSensors : public Sensors
                            const std::string& chassisInventoryPath) override;
 
   private:
+    /**
+     * Number of SensorType values.
+     */
+    static constexpr std::size_t sensorTypeCount{
+        static_cast<std::size_t>(SensorType::vout_valley) + 1};
+
+    /**
+     * Value of a derived sensor computed by updateDerivedSensors().
+     */
+    struct DerivedValue
+    {
+        /**
+         * Status of the value.  Sensors that no rail contributes to have the
+         * status removed.
+         */
+        util::sensor_telemetry::Status status{
+            util::sensor_telemetry::Status::removed};
+
+        /**
+         * Sensor value.  Only valid if status is ok.
+         */
+        double value{0};
+
+        /**
+         * Oldest read time of the values the sensor value was computed from.
+         * Contains the maximum time point if no values were used.
+         */
+        std::chrono::steady_clock::time_point readTime{
+            std::chrono::steady_clock::time_point::max()};
+    };
+
+    /**
+     * Last value recorded for a sensor.
+     */
+    struct SensorRecord
+    {
+        /**
+         * Status of the sensor value.
+         */
+        util::sensor_telemetry::Status status{};
+
+        /**
+         * Sensor value.
+         */
+        double value{};
+
+        /**
+         * Time that the value was read from the hardware, or that the status
+         * was last set if the value is not valid.
+         */
+        std::chrono::system_clock::time_point timestamp{};
+
+        /**
+         * Time on the monotonic clock corresponding to timestamp.
+         */
+        std::chrono::steady_clock::time_point readTime{};
+
+        /**
+         * Sequence number when the value or status last changed.
+         */
+        uint64_t sequence{0};
+    };
+
+    /**
+     * Sensors for one voltage rail, or the derived sensors of one rail,
+     * device, or chassis.
+     */
+    struct RailSensors
+    {
+        /**
+         * Voltage rail ID, or the label of the derived sensors.
+         */
+        std::string rail{};
+
+        /**
+         * Indicates whether the row contains derived sensors.
+         */
+        bool isDerived{false};
+
+        /**
+         * D-Bus inventory path of the device that produces the rail.
+         */
+        std::string deviceInventoryPath{};
+
+        /**
+         * D-Bus inventory path of the chassis that contains the device.
+         */
+        std::string chassisInventoryPath{};
+
+        /**
+         * Sensors for the rail indexed by SensorType.  Contains nullptr for
+         * sensor types the rail does not have.
+         */
+        std::array<std::unique_ptr<DBusSensor>, sensorTypeCount> sensors{};
+
+        /**
+         * Indicates whether the rail was skipped during the current monitoring
+         * cycle.
+         */
+        bool wasSkipped{false};
+
+        /**
+         * Shared memory segment record indexes for the sensors, indexed by
+         * SensorType.  Contains no value for sensor types the rail does not
+         * have and if the segment is full.
+         */
+        std::array<std::optional<std::size_t>, sensorTypeCount>
+            telemetryIndexes{};
+
+        /**
+         * Last values recorded for the sensors, indexed by SensorType.
+         * Contains no value for sensor types the rail has never had.
+         */
+        std::array<std::optional<SensorRecord>, sensorTypeCount> records{};
+
+        /**
+         * Table indexes of the rows that the power of the rail is derived
+         * into: the rail power, the device total, and the chassis total.
+         * Contains no value for the totals if the inventory paths do not
+         * identify a device or chassis.
+         */
+        std::optional<std::size_t> derivedRailIndex{};
+        std::optional<std::size_t> deviceTotalIndex{};
+        std::optional<std::size_t> chassisTotalIndex{};
+
+        /**
+         * Value being computed by updateDerivedSensors() for a derived row.
+         */
+        DerivedValue derived{};
+    };
+
+    /**
+     * Adds the power of a rail to a derived device or chassis total.
+     *
+     * A total is in the error state if any rail is in the error state.
+     * Disabled rails do not draw power, so they only make the total
+     * unavailable if all of its rails are disabled.
+     *
+     * @param total derived total
+     * @param power derived power of the rail
+     */
+    static void addDerivedValue(DerivedValue& total, const DerivedValue& power);
+
+    /**
+     * Returns whether PropertiesChanged signals for sensor changes should
+     * currently be deferred.
+     *
+     * @return true if signals should be deferred, false otherwise
+     */
+    bool areSignalsDeferred() const
+    {
+        return deferSignals && isCycleStarted;
+    }
+
+    /**
+     * Creates a sensor for the current rail with the specified initial value.
+     *
+     * @param row sensors table row of the current rail
+     * @param type sensor type
+     * @param value sensor value
+     */
+    void createSensor(RailSensors& row, SensorType type, double value);
+
+    /**
+     * Returns the table index of the derived sensors with the specified label,
+     * adding a row to the table if necessary.
+     *
+     * @param label derived sensors label
+     * @param deviceInventoryPath D-Bus inventory path of the device
+     *                            associated with the sensors
+     * @param chassisInventoryPath D-Bus inventory path of the chassis
+     *                             associated with the sensors
+     * @return table index
+     */
+    std::size_t getDerivedIndex(const std::string& label,
+                                const std::string& deviceInventoryPath,
+                                const std::string& chassisInventoryPath);
+
+    /**
+     * Returns the table index of the specified rail, adding the rail to the
+     * table if necessary.
+     *
+     * @param rail voltage rail ID
+     * @return table index
+     */
+    std::size_t getRailIndex(const std::string& rail);
+
+    /**
+     * Returns the power of a rail derived from its vout and iout records.
+     *
+     * @param row sensors table row of the voltage rail
+     * @return derived power; status removed if the rail has no vout or iout
+     *         sensor
+     */
+    static DerivedValue getRailPower(const RailSensors& row);
+
+    /**
+     * Publishes the value computed for a derived row by
+     * updateDerivedSensors().
+     *
+     * @param row sensors table row of the derived sensors
+     */
+    void publishDerivedValue(RailSensors& row);
+
+    /**
+     * Records the specified sensor value in the sensors table and writes it
+     * to the shared memory segment.
+     *
+     * Increments the sequence number if the value or status changed.  The
+     * value is not written to the segment if telemetry is disabled or the
+     * sensor has no record in the segment.
+     *
+     * @param row sensors table row of the voltage rail
+     * @param type sensor type
+     * @param value sensor value
+     * @param status status of the sensor value
+     * @param readTime time when the value was read from the hardware
+     */
+    void recordValue(RailSensors& row, SensorType type, double value,
+                     util::sensor_telemetry::Status status,
+                     std::chrono::steady_clock::time_point readTime =
+                         std::chrono::steady_clock::now());
+
+    /**
+     * Stores the inventory paths of a rail and looks up the table rows that
+     * its power is derived into.
+     *
+     * @param index sensors table index of the voltage rail
+     * @param deviceInventoryPath D-Bus inventory path of the device that
+     *                            produces the rail
+     * @param chassisInventoryPath D-Bus inventory path of the chassis that
+     *                             contains the device
+     */
+    void setRailInventoryPaths(std::size_t index,
+                               const std::string& deviceInventoryPath,
+                               const std::string& chassisInventoryPath);
+
+    /**
+     * Computes the derived power sensors from the vout and iout values
+     * recorded during the current monitoring cycle and publishes them.
+     */
+    void updateDerivedSensors();
+
     /**
      * D-Bus bus object.
      */
@@ -92,35 +466,63 @@ class DBusSensors : public Sensors
     sdbusplus::server::manager_t manager;
 
     /**
-     * Map from sensor names to DBusSensor objects.
+     * Specifies whether to defer PropertiesChanged signals until the end of
+     * the monitoring cycle.
      */
-    std::map<std::string, std::unique_ptr<DBusSensor>> sensors{};
+    bool deferSignals;
 
     /**
-     * Time that current monitoring cycle started.
+     * Writer for the shared memory segment containing the sensor values.
+     *
+     * Contains nullptr if telemetry is disabled.
      */
-    std::chrono::system_clock::time_point cycleStartTime{};
+    std::unique_ptr<util::sensor_telemetry::Writer> telemetry{};
 
     /**
-     * Current voltage rail.
+     * Indicates whether a monitoring cycle is in progress.
      *
-     * This is set by startRail().
+     * This is set by startCycle() and cleared by endCycle().
+     */
+    bool isCycleStarted{false};
+
+    /**
+     * Sensors table with one row for each voltage rail.
      */
-    std::string rail{};
+    std::vector<RailSensors> railSensors{};
 
     /**
-     * Current device inventory path.
+     * Sequence number of the last sensor value or status change.
+     */
+    uint64_t sequence{0};
+
+    /**
+     * Map from voltage rail IDs to railSensors indexes.
+     */
+    std::unordered_map<std::string, std::size_t> railIndexes{};
+
+    /**
+     * Map from derived sensors labels to railSensors indexes.
+     */
+    std::unordered_map<std::string, std::size_t> derivedIndexes{};
+
+    /**
+     * Time that current monitoring cycle started.
+     */
+    std::chrono::system_clock::time_point cycleStartTime{};
+
+    /**
+     * Sensors table index of the current voltage rail.
      *
      * This is set by startRail().
      */
-    std::string deviceInventoryPath{};
+    std::size_t railIndex{0};
 
     /**
-     * Current chassis inventory path.
+     * Indicates whether there is a current voltage rail.
      *
-     * This is set by startRail().
+     * This is set by startRail() and cleared by endRail().
      */
-    std::string chassisInventoryPath{};
+    bool isRailStarted{false};
 };
 
 } // namespace phosphor::power::regulators
@@ -16,16 +16,32 @@
 
 #include "device.hpp"
 
+#include "action_environment.hpp"
 #include "chassis.hpp"
 #include "error_logging_utils.hpp"
 #include "exception_utils.hpp"
+#include "pmbus_utils.hpp"
 #include "system.hpp"
 
+#include <algorithm>
 #include <exception>
+#include <numeric>
+#include <string>
+#include <utility>
+#include <vector>
 
 namespace phosphor::power::regulators
 {
 
+void Device::addSensorReading(uint8_t command, uint16_t value,
+                              std::chrono::steady_clock::time_point readTime)
+{
+    if (isSharingSensorReadings)
+    {
+        sensorReadings[command] = SensorReading{value, readTime};
+    }
+}
+
 void Device::addToIDMap(IDMap& idMap)
 {
     // Add this device to the map
@@ -40,12 +56,29 @@ void Device::addToIDMap(IDMap& idMap)
 
 void Device::clearCache()
 {
-    // If presence detection is defined for this device
-    if (presenceDetection)
+    // If presence detection is defined for this device.  Presence that only
+    // depends on other hardware is cleared when that presence changes; see
+    // System::clearPresenceCache().
+    if (presenceDetection && !presenceDetection->dependsOnlyOnPresence())
     {
         // Clear cached presence data
         presenceDetection->clearCache();
     }
+
+    // Clear cached VOUT_MODE value
+    voutMode.reset();
+
+    // Clear cached data in the rails
+    for (std::unique_ptr<Rail>& rail : rails)
+    {
+        rail->clearCache();
+    }
+
+    // Clear tracked page and shared sensor readings
+    resetOperationState();
+
+    // Try the device again, since it may have been replaced or repaired
+    resetCircuitBreaker();
 }
 
 void Device::clearErrorHistory()
@@ -76,8 +109,8 @@ void Device::close(Services& services)
     catch (const std::exception& e)
     {
         // Log error messages in journal
-        services.getJournal().logError(exception_utils::getMessages(e));
-        services.getJournal().logError("Unable to close device " + id);
+        services.getJournal().logError(exception_utils::MessageView{e});
+        services.getJournal().logError("Unable to close device " + id.str());
 
         // Create error log entry
         error_logging_utils::logError(std::current_exception(),
@@ -85,51 +118,428 @@ void Device::close(Services& services)
     }
 }
 
-void Device::configure(Services& services, System& system, Chassis& chassis)
+void Device::compileActions(const IDMap& idMap)
+{
+    // Compile actions for presence detection, configuration, and phase fault
+    // detection, if defined
+    if (presenceDetection)
+    {
+        presenceDetection->compile(idMap);
+    }
+    if (configuration)
+    {
+        configuration->compile(idMap);
+    }
+    if (phaseFaultDetection)
+    {
+        phaseFaultDetection->compile(idMap);
+    }
+
+    // Compile actions in each rail
+    for (std::unique_ptr<Rail>& rail : rails)
+    {
+        rail->compileActions(idMap);
+    }
+}
+
+unsigned int Device::configure(Services& services, System& system,
+                               Chassis& chassis)
 {
+    // Do not assume which page is selected from a previous operation
+    resetOperationState();
+    isShadowingRegisters = shadowRegisters;
+
     // Verify device is present
+    unsigned int errorCount{0};
     if (isPresent(services, system, chassis))
     {
+        // If write verification is deferred, do all the writes first and then
+        // verify them, so each write does not wait for a read.  The
+        // verifications of a device or rail are skipped if configuring it
+        // failed.
+        bool isDeferred = chassis.isWriteVerificationDeferred();
+        std::vector<std::pair<const std::string*,
+                              std::vector<DeferredVerification>>>
+            pending{};
+
         // If configuration changes are defined for this device, apply them
         if (configuration)
         {
-            configuration->execute(services, system, chassis, *this);
+            std::vector<DeferredVerification> verifications{};
+            if (!configuration->execute(services, system, chassis, *this,
+                                        isDeferred ? &verifications : nullptr))
+            {
+                ++errorCount;
+            }
+            else if (!verifications.empty())
+            {
+                pending.emplace_back(&getID(), std::move(verifications));
+            }
         }
 
         // Configure rails
         for (std::unique_ptr<Rail>& rail : rails)
         {
-            rail->configure(services, system, chassis, *this);
+            std::vector<DeferredVerification> verifications{};
+            if (!rail->configure(services, system, chassis, *this,
+                                 isDeferred ? &verifications : nullptr))
+            {
+                ++errorCount;
+            }
+            else if (!verifications.empty())
+            {
+                pending.emplace_back(&rail->getID(), std::move(verifications));
+            }
+        }
+
+        // Verify the deferred writes
+        for (auto& [deviceOrRailID, railVerifications] : pending)
+        {
+            if (!Configuration::verifyWrites(services, *deviceOrRailID,
+                                             railVerifications))
+            {
+                ++errorCount;
+            }
         }
     }
+
+    // The shadow registers are only valid during this configuration
+    isShadowingRegisters = false;
+    shadowRegisterValues.clear();
+    return errorCount;
 }
 
 void Device::detectPhaseFaults(Services& services, System& system,
                                Chassis& chassis)
 {
+    ActionEnvironment environment{system.getIDMap(), id, services};
+    detectPhaseFaults(services, system, chassis, environment);
+}
+
+void Device::detectPhaseFaults(Services& services, System& system,
+                               Chassis& chassis, ActionEnvironment& environment)
+{
+    // Do not assume which page is selected from a previous operation
+    resetOperationState();
+
     // Verify device is present
     if (isPresent(services, system, chassis))
     {
         // If phase fault detection is defined for this device, execute it
         if (phaseFaultDetection)
         {
-            phaseFaultDetection->execute(services, system, chassis, *this);
+            phaseFaultDetection->execute(services, system, chassis, *this,
+                                         environment);
         }
     }
 }
 
+void Device::handleAlert(Services& services, System& system, Chassis& chassis)
+{
+    // Read the sensors of each rail during the next monitoring cycle
+    for (std::unique_ptr<Rail>& rail : rails)
+    {
+        const std::unique_ptr<SensorMonitoring>& monitoring =
+            rail->getSensorMonitoring();
+        if (monitoring)
+        {
+            monitoring->requestRead();
+        }
+    }
+
+    detectPhaseFaults(services, system, chassis);
+}
+
+bool Device::getShadowRegisters(uint8_t reg, std::span<uint8_t> values) const
+{
+    for (std::size_t i = 0; i < values.size(); ++i)
+    {
+        auto it = shadowRegisterValues.find(static_cast<uint8_t>(reg + i));
+        if (it == shadowRegisterValues.end())
+        {
+            return false;
+        }
+        values[i] = it->second;
+    }
+    return true;
+}
+
+uint8_t Device::getVoutMode()
+{
+    if (!voutMode.has_value())
+    {
+        uint8_t value{0x00};
+        i2cInterface->read(pmbus_utils::VOUT_MODE, value);
+        voutMode = value;
+    }
+    return voutMode.value();
+}
+
+void Device::linkActions(const IDMap& idMap)
+{
+    // Link actions for presence detection, configuration, and phase fault
+    // detection, if defined
+    if (presenceDetection)
+    {
+        presenceDetection->linkActions(idMap);
+    }
+    if (configuration)
+    {
+        configuration->linkActions(idMap);
+    }
+    if (phaseFaultDetection)
+    {
+        phaseFaultDetection->linkActions(idMap);
+    }
+
+    // Link actions in each rail
+    for (std::unique_ptr<Rail>& rail : rails)
+    {
+        rail->linkActions(idMap);
+    }
+}
+
+void Device::registerWritten(uint8_t reg, std::size_t count)
+{
+    // VOUT_MODE is a paged command, so the cached value is no longer valid if
+    // the page changed
+    auto isWritten = [reg, count](uint8_t command) {
+        return (command >= reg) && (command - reg < count);
+    };
+    if (isWritten(pmbus_utils::PAGE) || isWritten(pmbus_utils::VOUT_MODE))
+    {
+        voutMode.reset();
+    }
+
+    // The selected page is unknown until pageSelected() is called.  The
+    // shadow registers may be for a different page.
+    if (isWritten(pmbus_utils::PAGE))
+    {
+        currentPage.reset();
+        shadowRegisterValues.clear();
+    }
+
+    // The new values of the registers are unknown until
+    // updateShadowRegisters() is called
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        shadowRegisterValues.erase(static_cast<uint8_t>(reg + i));
+    }
+
+    // Writing a register may change the sensor values
+    sensorReadings.clear();
+}
+
 void Device::monitorSensors(Services& services, System& system,
                             Chassis& chassis)
 {
-    // Verify device is present
-    if (isPresent(services, system, chassis))
+    ActionEnvironment environment{system.getIDMap(), id, services};
+    monitorSensors(services, system, chassis, environment);
+}
+
+void Device::monitorSensors(Services& services, System& system,
+                            Chassis& chassis, ActionEnvironment& environment)
+{
+    // Do not assume which page is selected from a previous operation
+    resetOperationState();
+    isSharingSensorReadings = true;
+
+    // Verify device is present.  If it was just plugged in, try it right
+    // away even if the previous device in its slot had failed.
+    bool isDevicePresent = isPresent(services, system, chassis);
+    if (isDevicePresent && !wasPresent)
     {
-        // Monitor sensors in each rail
-        for (std::unique_ptr<Rail>& rail : rails)
+        resetCircuitBreaker();
+    }
+    wasPresent = isDevicePresent;
+
+    // Do not read a device that keeps failing until its backoff has elapsed.
+    // Its sensors stay unavailable.
+    auto now = CircuitBreaker::Clock::now();
+    if (isDevicePresent && !circuitBreaker.isAllowed(now))
+    {
+        skipRails(services);
+    }
+    else if (isDevicePresent)
+    {
+        if (sensorMonitoringOrder.size() != rails.size())
+        {
+            railPages.assign(rails.size(), std::nullopt);
+            railFailures.assign(rails.size(), false);
+            updateSensorMonitoringOrder();
+        }
+
+        // Monitor sensors in each rail in page order, reusing the same
+        // environment.  Record the page each rail selects.
+        bool isOrderChanged{false};
+        bool isRead{false};
+        bool isFailed{false};
+        for (std::size_t index : sensorMonitoringOrder)
+        {
+            lastSelectedPage.reset();
+            SensorMonitoring::Result result = rails[index]->monitorSensors(
+                services, system, chassis, *this, environment);
+            if (lastSelectedPage.has_value() &&
+                (lastSelectedPage != railPages[index]))
+            {
+                railPages[index] = lastSelectedPage;
+                isOrderChanged = true;
+            }
+
+            if (result == SensorMonitoring::Result::read)
+            {
+                isRead = true;
+            }
+            else if (result == SensorMonitoring::Result::i2cFailed)
+            {
+                isFailed = true;
+                railFailures[index] = true;
+
+                // While backing off, one failed rail is enough to know that
+                // the device still does not respond
+                if (circuitBreaker.isOpen())
+                {
+                    break;
+                }
+            }
+        }
+
+        // Monitor rails on the same page one after the other next time
+        if (isOrderChanged)
+        {
+            updateSensorMonitoringOrder();
+        }
+
+        updateCircuitBreaker(services, now, isRead, isFailed);
+    }
+
+    // Sensor readings are only shared during one monitoring cycle
+    isSharingSensorReadings = false;
+    sensorReadings.clear();
+}
+
+void Device::markRailsUnavailable(Services& services)
+{
+    Sensors& sensors = services.getSensors();
+    for (const std::unique_ptr<Rail>& rail : rails)
+    {
+        if (rail->getSensorMonitoring())
+        {
+            sensors.disableRail(rail->getID());
+        }
+    }
+}
+
+void Device::pageSelected(uint8_t page)
+{
+    // Sensor readings and shadow registers were for the previous page
+    if (currentPage != page)
+    {
+        sensorReadings.clear();
+        shadowRegisterValues.clear();
+    }
+    currentPage = page;
+    lastSelectedPage = page;
+}
+
+void Device::resetOperationState()
+{
+    currentPage.reset();
+    lastSelectedPage.reset();
+    isSharingSensorReadings = false;
+    sensorReadings.clear();
+    isShadowingRegisters = false;
+    shadowRegisterValues.clear();
+}
+
+void Device::skipRails(Services& services)
+{
+    Sensors& sensors = services.getSensors();
+    for (const std::unique_ptr<Rail>& rail : rails)
+    {
+        if (rail->getSensorMonitoring())
         {
-            rail->monitorSensors(services, system, chassis, *this);
+            sensors.skipRail(rail->getID());
         }
     }
 }
 
+void Device::updateCircuitBreaker(Services& services,
+                                  CircuitBreaker::Clock::time_point now,
+                                  bool isRead, bool isFailed)
+{
+    if (isRead)
+    {
+        // The device responded
+        railFailures.assign(rails.size(), false);
+        if (circuitBreaker.recordSuccess())
+        {
+            services.getJournal().logInfo("Device " + id.str() +
+                                          " is responding again");
+        }
+        return;
+    }
+
+    if (!isFailed)
+    {
+        // All the rails were skipped or failed for other reasons
+        return;
+    }
+
+    // Only count the failure if every rail has had an I2C error since the
+    // device last responded.  One rail that always fails does not stop the
+    // others.
+    for (std::size_t i = 0; i < rails.size(); ++i)
+    {
+        if (rails[i]->getSensorMonitoring() && !railFailures[i])
+        {
+            return;
+        }
+    }
+
+    if (circuitBreaker.recordFailure(now))
+    {
+        services.getJournal().logError(
+            "Device " + id.str() + " is not responding after " +
+            std::to_string(circuitBreaker.getFailureCount()) +
+            " attempts; it will only be read after a backoff");
+    }
+    if (circuitBreaker.isOpen())
+    {
+        // Replace the error state set by the failed rail, and mark the rails
+        // that were not read
+        markRailsUnavailable(services);
+    }
+}
+
+void Device::updateShadowRegisters(uint8_t reg,
+                                   std::span<const uint8_t> values)
+{
+    if (!isShadowingRegisters)
+    {
+        return;
+    }
+    for (std::size_t i = 0; i < values.size(); ++i)
+    {
+        uint8_t address = static_cast<uint8_t>(reg + i);
+        if (std::find(volatileRegisters.begin(), volatileRegisters.end(),
+                      address) == volatileRegisters.end())
+        {
+            shadowRegisterValues[address] = values[i];
+        }
+    }
+}
+
+void Device::updateSensorMonitoringOrder()
+{
+    // Sort rails by page.  Rails with an unknown page are first.  Rails on the
+    // same page stay in configuration file order.
+    sensorMonitoringOrder.resize(rails.size());
+    std::iota(sensorMonitoringOrder.begin(), sensorMonitoringOrder.end(), 0);
+    std::stable_sort(sensorMonitoringOrder.begin(), sensorMonitoringOrder.end(),
+                     [this](std::size_t a, std::size_t b) {
+                         return railPages[a] < railPages[b];
+                     });
+}
+
 } // namespace phosphor::power::regulators
@@ -15,15 +15,24 @@
  */
 #pragma once
 
+#include "circuit_breaker.hpp"
 #include "configuration.hpp"
 #include "i2c_interface.hpp"
 #include "id_map.hpp"
 #include "phase_fault_detection.hpp"
+#include "power_domain.hpp"
 #include "presence_detection.hpp"
 #include "rail.hpp"
 #include "services.hpp"
+#include "symbol.hpp"
 
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
 #include <memory>
+#include <optional>
+#include <span>
 #include <string>
 #include <utility>
 #include <vector>
@@ -43,6 +52,22 @@ class System;
 class Device
 {
   public:
+    /**
+     * PMBus sensor reading shared between rails.  See getSensorReading().
+     */
+    struct SensorReading
+    {
+        /**
+         * Value read from the device.
+         */
+        uint16_t value{};
+
+        /**
+         * Time when the value was read from the device.
+         */
+        std::chrono::steady_clock::time_point readTime{};
+    };
+
     // Specify which compiler-generated methods we want
     Device() = delete;
     Device(const Device&) = delete;
@@ -63,6 +88,8 @@ class Device
      *                      any
      * @param phaseFaultDetection phase fault detection for this device, if any
      * @param rails voltage rails produced by this device, if any
+     * @param dependsOn IDs of devices that must be configured before this
+     *                  device, if any
      */
     explicit Device(
         const std::string& id, bool isRegulator, const std::string& fru,
@@ -71,16 +98,30 @@ class Device
         std::unique_ptr<Configuration> configuration = nullptr,
         std::unique_ptr<PhaseFaultDetection> phaseFaultDetection = nullptr,
         std::vector<std::unique_ptr<Rail>> rails =
-            std::vector<std::unique_ptr<Rail>>{}) :
+            std::vector<std::unique_ptr<Rail>>{},
+        std::vector<std::string> dependsOn = std::vector<std::string>{}) :
         id{id},
         isRegulatorDevice{isRegulator}, fru{fru},
         i2cInterface{std::move(i2cInterface)}, presenceDetection{std::move(
                                                    presenceDetection)},
         configuration{std::move(configuration)},
-        phaseFaultDetection{std::move(phaseFaultDetection)}, rails{std::move(
-                                                                 rails)}
+        phaseFaultDetection{std::move(phaseFaultDetection)},
+        rails{std::move(rails)}, dependsOn{std::move(dependsOn)}
     {}
 
+    /**
+     * Stores the value of a PMBus sensor command so that other rails on this
+     * device can use it during the current sensor monitoring cycle.
+     *
+     * Does nothing if sensors are not being monitored.  See getSensorReading().
+     *
+     * @param command PMBus command code
+     * @param value value read from the device
+     * @param readTime time when the value was read from the device
+     */
+    void addSensorReading(uint8_t command, uint16_t value,
+                          std::chrono::steady_clock::time_point readTime);
+
     /**
      * Adds this Device object to the specified IDMap.
      *
@@ -92,6 +133,8 @@ class Device
 
     /**
      * Clear any cached data about hardware devices.
+     *
+     * Also resets the circuit breaker.  See resetCircuitBreaker().
      */
     void clearCache();
 
@@ -115,6 +158,13 @@ class Device
      */
     void close(Services& services);
 
+    /**
+     * Compiles the actions for this device and its rails, if any.
+     *
+     * @param idMap mapping from IDs to the associated Device/Rail/Rule objects
+     */
+    void compileActions(const IDMap& idMap);
+
     /**
      * Configure this device.
      *
@@ -123,14 +173,21 @@ class Device
      *
      * Also configures the voltage rails produced by this device, if any.
      *
+     * If write verification is deferred in the chassis, the writes are
+     * verified after the device and all of its rails have been configured.
+     * See Chassis::isWriteVerificationDeferred().
+     *
      * This method should be called during the boot before regulators are
      * enabled.
      *
      * @param services system services like error logging and the journal
      * @param system system that contains the chassis
      * @param chassis chassis that contains this device
+     * @return number of errors that occurred configuring this device and its
+     *         rails
      */
-    void configure(Services& services, System& system, Chassis& chassis);
+    unsigned int configure(Services& services, System& system,
+                           Chassis& chassis);
 
     /**
      * Detect redundant phase faults in this device.
@@ -146,6 +203,45 @@ class Device
     void detectPhaseFaults(Services& services, System& system,
                            Chassis& chassis);
 
+    /**
+     * Detect redundant phase faults in this device using the specified action
+     * environment.
+     *
+     * The environment is reused to avoid allocating memory.  See
+     * PhaseFaultDetection::execute() for more information.
+     *
+     * @param services system services like error logging and the journal
+     * @param system system that contains the chassis
+     * @param chassis chassis that contains the device
+     * @param environment action execution environment to reuse
+     */
+    void detectPhaseFaults(Services& services, System& system,
+                           Chassis& chassis, ActionEnvironment& environment);
+
+    /**
+     * Handles an SMBus alert from this device.
+     *
+     * Detects redundant phase faults in this device now, and requests that
+     * the sensors of its rails be read during the next sensor monitoring
+     * cycle, instead of waiting for the device's turn in the periodic tasks.
+     *
+     * @param services system services like error logging and the journal
+     * @param system system that contains the chassis
+     * @param chassis chassis that contains the device
+     */
+    void handleAlert(Services& services, System& system, Chassis& chassis);
+
+    /**
+     * Returns the circuit breaker that stops reading the sensors of this
+     * device while it is not responding.  See monitorSensors().
+     *
+     * @return circuit breaker
+     */
+    const CircuitBreaker& getCircuitBreaker() const
+    {
+        return circuitBreaker;
+    }
+
     /**
      * Returns the configuration changes to apply to this device, if any.
      *
@@ -157,6 +253,47 @@ class Device
         return configuration;
     }
 
+    /**
+     * Returns the IDs of the devices that must be configured before this
+     * device, if any.
+     *
+     * Only used when the devices in a chassis are configured in parallel.
+     *
+     * @return device IDs
+     */
+    const std::vector<std::string>& getDependsOn() const
+    {
+        return dependsOn;
+    }
+
+    /**
+     * Returns the hash of the definition of this device in the config file.
+     *
+     * Used to find the devices that are unchanged when the config file is
+     * reloaded.
+     *
+     * @return definition hash, or 0 if not set
+     */
+    uint64_t getDefinitionHash() const
+    {
+        return definitionHash;
+    }
+
+    /**
+     * Returns the PMBus page that is currently selected in this device, if
+     * known.
+     *
+     * The page is only tracked during one operation on this device, such as
+     * configuring the device or monitoring its sensors.  It is unknown at the
+     * start of each operation.  See pageSelected().
+     *
+     * @return current page, if known
+     */
+    const std::optional<uint8_t>& getCurrentPage() const
+    {
+        return currentPage;
+    }
+
     /**
      * Returns the Field-Replaceable Unit (FRU) for this device.
      *
@@ -180,12 +317,37 @@ class Device
         return *i2cInterface;
     }
 
+    /**
+     * Returns the value of the PMBus VOUT_MODE command for this device.
+     *
+     * The value is read from the device the first time and then cached.  The
+     * cached value is cleared by clearCache() and when the PAGE or VOUT_MODE
+     * command is written.  See registerWritten().
+     *
+     * The I2C interface to this device must be open.
+     *
+     * Throws I2CException if an error occurs.
+     *
+     * @return VOUT_MODE value
+     */
+    uint8_t getVoutMode();
+
     /**
      * Returns the unique ID of this device.
      *
      * @return device ID
      */
     const std::string& getID() const
+    {
+        return id.str();
+    }
+
+    /**
+     * Returns the unique ID of this device as a symbol.
+     *
+     * @return device ID
+     */
+    Symbol getIDSymbol() const
     {
         return id;
     }
@@ -201,6 +363,17 @@ class Device
         return phaseFaultDetection;
     }
 
+    /**
+     * Returns the power domain this device belongs to, if any.
+     *
+     * @return Pointer to PowerDomain object.  Will equal nullptr if this
+     *         device does not belong to a power domain.
+     */
+    const std::unique_ptr<PowerDomain>& getPowerDomain() const
+    {
+        return powerDomain;
+    }
+
     /**
      * Returns the presence detection for this device, if any.
      *
@@ -222,6 +395,85 @@ class Device
         return rails;
     }
 
+    /**
+     * Returns the value of a PMBus sensor command that was already read during
+     * the current sensor monitoring cycle, if any.
+     *
+     * Rails on the same device that read the same command share the value
+     * instead of reading it again.  The shared values are cleared when any
+     * register is written, when the PAGE command is changed, and at the end of
+     * the monitoring cycle.  See addSensorReading().
+     *
+     * @param command PMBus command code
+     * @return sensor reading, if any
+     */
+    std::optional<SensorReading> getSensorReading(uint8_t command) const
+    {
+        auto it = sensorReadings.find(command);
+        if (it == sensorReadings.end())
+        {
+            return std::nullopt;
+        }
+        return it->second;
+    }
+
+    /**
+     * Gets the shadow copy of the specified registers, if known.
+     *
+     * While this device is being configured, the values written to its
+     * registers are remembered, so read-modify-write actions that write the
+     * same registers again do not need to read them first.  The shadow copy
+     * of a register is cleared when the register is written without
+     * updating it, such as by a failed write, and when the PAGE command is
+     * changed.  See updateShadowRegisters().
+     *
+     * @param reg first register
+     * @param values filled in with the values of the consecutive registers
+     *               starting at reg
+     * @return true if the values of all the registers are known, false
+     *         otherwise
+     */
+    bool getShadowRegisters(uint8_t reg, std::span<uint8_t> values) const;
+
+    /**
+     * Returns the registers of this device whose values may be changed by
+     * the device itself.  They are always read by read-modify-write actions.
+     * See hasShadowRegisters().
+     *
+     * @return volatile registers
+     */
+    const std::vector<uint8_t>& getVolatileRegisters() const
+    {
+        return volatileRegisters;
+    }
+
+    /**
+     * Returns whether this device increments the register address after each
+     * byte of an I2C block read.
+     *
+     * If true, consecutive registers can be read with one I2C block read.
+     * See ActionProgram.
+     *
+     * @return true if the device supports auto increment, false otherwise
+     */
+    bool hasAutoIncrement() const
+    {
+        return autoIncrement;
+    }
+
+    /**
+     * Returns whether this device belongs to the power domain with the
+     * specified name.
+     *
+     * @param name power domain name, or an empty string to check whether this
+     *             device does not belong to a power domain
+     * @return true if device belongs to the power domain, false otherwise
+     */
+    bool isInPowerDomain(const std::string& name) const
+    {
+        return powerDomain ? (powerDomain->getName() == name) : name.empty();
+    }
+
     /**
      * Returns whether this device is present.
      *
@@ -241,6 +493,17 @@ class Device
         }
     }
 
+    /**
+     * Returns whether the values written to the registers of this device are
+     * remembered while it is being configured.  See getShadowRegisters().
+     *
+     * @return true if shadow registers are used, false otherwise
+     */
+    bool hasShadowRegisters() const
+    {
+        return shadowRegisters;
+    }
+
     /**
      * Returns whether this device is a voltage regulator.
      *
@@ -251,6 +514,39 @@ class Device
         return isRegulatorDevice;
     }
 
+    /**
+     * Returns whether this device remains powered while the system is powered
+     * off.
+     *
+     * The I2C interface to a standby-powered device is kept open across power
+     * cycles.  See closeUnpoweredDevices() in Chassis.
+     *
+     * @return true if device is standby-powered, false otherwise
+     */
+    bool isStandbyPowered() const
+    {
+        return isStandbyPoweredDevice;
+    }
+
+    /**
+     * Notifies this device that one or more registers were written.
+     *
+     * Clears any cached data that depends on the written registers.
+     *
+     * @param reg first register that was written
+     * @param count number of registers that were written
+     */
+    void registerWritten(uint8_t reg, std::size_t count = 1);
+
+    /**
+     * Links the actions for this device and its rails, if any.
+     *
+     * See Action::link() for more information.
+     *
+     * @param idMap mapping from IDs to the associated Device/Rail/Rule objects
+     */
+    void linkActions(const IDMap& idMap);
+
     /**
      * Monitors the sensors for the voltage rails produced by this device, if
      * any.
@@ -263,11 +559,180 @@ class Device
      */
     void monitorSensors(Services& services, System& system, Chassis& chassis);
 
+    /**
+     * Monitors the sensors for the voltage rails produced by this device, if
+     * any, using the specified action environment.
+     *
+     * The environment is reused for each rail to avoid allocating memory.  See
+     * SensorMonitoring::execute() for more information.
+     *
+     * The rails are monitored in order of the PMBus page they selected during
+     * the previous cycle.  Rails on the same page are monitored one after the
+     * other, so the PAGE command is only written once for them and they can
+     * share sensor readings.  See getSensorReading().
+     *
+     * A monitoring cycle fails if no rail is read successfully and every rail
+     * has had an I2C error since the last successful read.  After a number of
+     * consecutive failed cycles the circuit breaker opens: the sensors of
+     * the rails are marked unavailable, and the device is only read again
+     * after a backoff that doubles each time it still fails.  The first
+     * successful read closes the breaker.  See getCircuitBreaker().
+     *
+     * @param services system services like error logging and the journal
+     * @param system system that contains the chassis
+     * @param chassis chassis that contains the device
+     * @param environment action execution environment to reuse
+     */
+    void monitorSensors(Services& services, System& system, Chassis& chassis,
+                        ActionEnvironment& environment);
+
+    /**
+     * Notifies this device that the specified PMBus page was selected.
+     *
+     * Called after the PAGE command was written, or after writing PAGE was
+     * skipped because the page was already selected.
+     *
+     * @param page page that was selected
+     */
+    void pageSelected(uint8_t page);
+
+    /**
+     * Resets the circuit breaker, so the sensors of this device are read
+     * during the next monitoring cycle even if it was not responding.
+     *
+     * This method should be called when the device may have been replaced,
+     * such as when its presence changes.  It is also called when the device
+     * is found to be present after it was missing.
+     */
+    void resetCircuitBreaker()
+    {
+        circuitBreaker.reset();
+        railFailures.assign(railFailures.size(), false);
+    }
+
+    /**
+     * Sets whether this device increments the register address after each
+     * byte of an I2C block read.  See hasAutoIncrement().
+     *
+     * @param autoIncrement true if the device supports auto increment
+     */
+    void setAutoIncrement(bool autoIncrement)
+    {
+        this->autoIncrement = autoIncrement;
+    }
+
+    /**
+     * Sets the hash of the definition of this device in the config file.
+     *
+     * @param hash definition hash
+     */
+    void setDefinitionHash(uint64_t hash)
+    {
+        definitionHash = hash;
+    }
+
+    /**
+     * Sets the power domain this device belongs to.
+     *
+     * @param powerDomain power domain, or nullptr if none
+     */
+    void setPowerDomain(std::unique_ptr<PowerDomain> powerDomain)
+    {
+        this->powerDomain = std::move(powerDomain);
+    }
+
+    /**
+     * Sets whether the values written to the registers of this device are
+     * remembered while it is being configured.  See getShadowRegisters().
+     *
+     * @param shadowRegisters true if shadow registers should be used
+     */
+    void setShadowRegisters(bool shadowRegisters)
+    {
+        this->shadowRegisters = shadowRegisters;
+    }
+
+    /**
+     * Sets whether this device remains powered while the system is powered
+     * off.
+     *
+     * @param isStandbyPowered true if device is standby-powered
+     */
+    void setStandbyPowered(bool isStandbyPowered)
+    {
+        isStandbyPoweredDevice = isStandbyPowered;
+    }
+
+    /**
+     * Sets the registers of this device whose values may be changed by the
+     * device itself.  See getVolatileRegisters().
+     *
+     * @param registers volatile registers
+     */
+    void setVolatileRegisters(std::vector<uint8_t> registers)
+    {
+        volatileRegisters = std::move(registers);
+    }
+
+    /**
+     * Stores the values written to the specified registers as their shadow
+     * copy.
+     *
+     * Does nothing if this device is not being configured or does not use
+     * shadow registers.  Volatile registers are not stored.  See
+     * getShadowRegisters().
+     *
+     * @param reg first register that was written
+     * @param values values written to the consecutive registers starting at
+     *               reg
+     */
+    void updateShadowRegisters(uint8_t reg, std::span<const uint8_t> values);
+
   private:
+    /**
+     * Notifies the Sensors service that the sensors of the rails are
+     * unavailable.
+     *
+     * @param services system services like error logging and the journal
+     */
+    void markRailsUnavailable(Services& services);
+
+    /**
+     * Clears the PMBus state that is only tracked during one operation on this
+     * device, such as the current page and shared sensor readings.
+     */
+    void resetOperationState();
+
+    /**
+     * Notifies the Sensors service that the sensors of the rails were not
+     * read during this monitoring cycle.
+     *
+     * @param services system services like error logging and the journal
+     */
+    void skipRails(Services& services);
+
+    /**
+     * Updates the circuit breaker after a sensor monitoring cycle.
+     *
+     * @param services system services like error logging and the journal
+     * @param now time when the cycle started
+     * @param isRead indicates whether any rail was read successfully
+     * @param isFailed indicates whether any rail had an I2C error
+     */
+    void updateCircuitBreaker(Services& services,
+                              CircuitBreaker::Clock::time_point now,
+                              bool isRead, bool isFailed);
+
+    /**
+     * Updates the order in which the rails are monitored based on the pages
+     * they selected.
+     */
+    void updateSensorMonitoringOrder();
+
     /**
      * Unique ID of this device.
      */
-    const std::string id{};
+    const Symbol id;
 
     /**
      * Indicates whether this device is a voltage regulator.
@@ -310,6 +775,114 @@ class Device
      * voltage rails are defined for this device.
      */
     std::vector<std::unique_ptr<Rail>> rails{};
+
+    /**
+     * IDs of devices that must be configured before this device, if any.
+     */
+    std::vector<std::string> dependsOn{};
+
+    /**
+     * Power domain this device belongs to, if any.
+     */
+    std::unique_ptr<PowerDomain> powerDomain{};
+
+    /**
+     * Indicates whether this device remains powered while the system is
+     * powered off.
+     */
+    bool isStandbyPoweredDevice{false};
+
+    /**
+     * Cached value of the PMBus VOUT_MODE command, if it has been read.
+     */
+    std::optional<uint8_t> voutMode{};
+
+    /**
+     * PMBus page currently selected in this device, if known.
+     */
+    std::optional<uint8_t> currentPage{};
+
+    /**
+     * Last PMBus page selected while monitoring the sensors of one rail, if
+     * any.
+     */
+    std::optional<uint8_t> lastSelectedPage{};
+
+    /**
+     * Indicates whether sensor readings are shared between rails.  Only true
+     * while monitoring sensors.
+     */
+    bool isSharingSensorReadings{false};
+
+    /**
+     * PMBus sensor readings shared between rails during the current sensor
+     * monitoring cycle.  Maps from PMBus command codes to readings.
+     */
+    std::map<uint8_t, SensorReading> sensorReadings{};
+
+    /**
+     * Page selected by each rail during sensor monitoring, if known.  Indexed
+     * the same as rails.
+     */
+    std::vector<std::optional<uint8_t>> railPages{};
+
+    /**
+     * Indexes of the rails in the order their sensors are monitored.
+     */
+    std::vector<std::size_t> sensorMonitoringOrder{};
+
+    /**
+     * Indicates whether reading the sensors of each rail has had an I2C error
+     * since the device last responded.  Indexed the same as rails.
+     */
+    std::vector<bool> railFailures{};
+
+    /**
+     * Circuit breaker that stops reading the sensors of this device while it
+     * is not responding.
+     */
+    CircuitBreaker circuitBreaker{};
+
+    /**
+     * Indicates whether this device was present during the previous sensor
+     * monitoring cycle.
+     */
+    bool wasPresent{false};
+
+    /**
+     * Hash of the definition of this device in the config file, or 0 if not
+     * set.
+     */
+    uint64_t definitionHash{0};
+
+    /**
+     * Indicates whether this device increments the register address after
+     * each byte of an I2C block read.
+     */
+    bool autoIncrement{false};
+
+    /**
+     * Indicates whether the values written to the registers are remembered
+     * while this device is being configured.
+     */
+    bool shadowRegisters{false};
+
+    /**
+     * Registers whose values may be changed by the device itself.
+     */
+    std::vector<uint8_t> volatileRegisters{};
+
+    /**
+     * Indicates whether shadow register values are stored.  Only true while
+     * configuring this device.
+     */
+    bool isShadowingRegisters{false};
+
+    /**
+     * Shadow copy of the registers written during the current configuration.
+     * Maps from register addresses to values.
+     */
+    std::map<uint8_t, uint8_t> shadowRegisterValues{};
 };
 
 } // namespace phosphor::power::regulators
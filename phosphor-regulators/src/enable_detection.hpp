@@ -0,0 +1,146 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "action.hpp"
+#include "action_environment.hpp"
+#include "action_program.hpp"
+#include "action_utils.hpp"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace phosphor::power::regulators
+{
+
+/**
+ * @class EnableDetection
+ *
+ * Specifies how to detect whether a voltage rail is enabled.
+ *
+ * During some power states only part of the system is powered on.  The
+ * sensors of a rail that is powered off cannot be read successfully, or they
+ * return meaningless values such as zero.
+ *
+ * Rail enablement is detected by executing actions, such as
+ * I2CCompareBitAction to test the On bit of the PMBus OPERATION command or
+ * the POWER_GOOD# bit of STATUS_WORD.
+ *
+ * Unlike device presence, rail enablement changes while the system is
+ * running.  The actions are executed each time the rail sensors are due to
+ * be read, so they should be inexpensive.
+ */
+class EnableDetection
+{
+  public:
+    // Specify which compiler-generated methods we want
+    EnableDetection() = delete;
+    EnableDetection(const EnableDetection&) = delete;
+    EnableDetection(EnableDetection&&) = delete;
+    EnableDetection& operator=(const EnableDetection&) = delete;
+    EnableDetection& operator=(EnableDetection&&) = delete;
+    ~EnableDetection() = default;
+
+    /**
+     * Constructor.
+     *
+     * @param actions actions that detect whether the rail is enabled
+     */
+    explicit EnableDetection(std::vector<std::unique_ptr<Action>> actions) :
+        actions{std::move(actions)}
+    {}
+
+    /**
+     * Compiles the actions into an ActionProgram.
+     *
+     * The compiled program is used by execute() instead of interpreting the
+     * actions.  This method should be called after the System has been
+     * created, since the rules run by the actions must be resolved.
+     *
+     * @param idMap mapping from IDs to the associated Device/Rule objects
+     */
+    void compile(const IDMap& idMap)
+    {
+        program = std::make_unique<ActionProgram>(actions, idMap);
+    }
+
+    /**
+     * Executes the actions to detect whether the rail is enabled.
+     *
+     * The return value of the last action indicates whether the rail is
+     * enabled.  A return value of true means the rail is enabled; false means
+     * it is disabled.
+     *
+     * Throws an exception if an error occurs.
+     *
+     * @param environment action execution environment
+     * @return true if the rail is enabled, false otherwise
+     */
+    bool execute(ActionEnvironment& environment)
+    {
+        return program ? program->execute(environment)
+                       : action_utils::execute(actions, environment);
+    }
+
+    /**
+     * Returns the actions that detect whether the rail is enabled.
+     *
+     * @return actions
+     */
+    const std::vector<std::unique_ptr<Action>>& getActions() const
+    {
+        return actions;
+    }
+
+    /**
+     * Returns the compiled program, if any.
+     *
+     * @return pointer to compiled program, or nullptr if not compiled
+     */
+    const ActionProgram* getProgram() const
+    {
+        return program.get();
+    }
+
+    /**
+     * Links the actions.
+     *
+     * See Action::link() for more information.
+     *
+     * @param idMap mapping from IDs to the associated Device/Rule objects
+     */
+    void linkActions(const IDMap& idMap)
+    {
+        for (std::unique_ptr<Action>& action : actions)
+        {
+            action->link(idMap);
+        }
+    }
+
+  private:
+    /**
+     * Actions that detect whether the rail is enabled.
+     */
+    std::vector<std::unique_ptr<Action>> actions{};
+
+    /**
+     * Actions compiled into a program, if compile() has been called.
+     */
+    std::unique_ptr<ActionProgram> program{};
+};
+
+} // namespace phosphor::power::regulators
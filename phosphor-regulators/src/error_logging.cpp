@@ -17,22 +17,50 @@
 #include "error_logging.hpp"
 
 #include "exception_utils.hpp"
+#include "flight_recorder.hpp"
+#include "memory_accounting.hpp"
 
-#include <errno.h>     // for errno
-#include <string.h>    // for strerror()
-#include <sys/types.h> // for getpid(), lseek(), ssize_t
-#include <unistd.h>    // for getpid(), lseek(), write()
+#include <sys/types.h> // for getpid()
+#include <unistd.h>    // for getpid()
 
 #include <sdbusplus/message.hpp>
 
+#include <charconv>
+#include <chrono>
 #include <exception>
 #include <ios>
+#include <memory>
+#include <optional>
 #include <sstream>
 #include <stdexcept>
+#include <system_error>
+#include <utility>
 
 namespace phosphor::power::regulators
 {
 
+/**
+ * Time the capture thread waits after an error is queued before logging it.
+ * Errors queued during this time, such as the rail errors from one sensor
+ * monitoring cycle when an I2C bus fails, are logged as one batch.
+ */
+constexpr std::chrono::milliseconds errorBatchDelay{250};
+
+DBusErrorLogging::~DBusErrorLogging()
+{
+    // Tell capture thread to stop after logging the queued errors
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        isStopping = true;
+    }
+    condition.notify_one();
+
+    if (captureThread.joinable())
+    {
+        captureThread.join();
+    }
+}
+
 void DBusErrorLogging::logConfigFileError(Entry::Level severity,
                                           Journal& journal)
 {
@@ -75,8 +103,24 @@ void DBusErrorLogging::logI2CError(Entry::Level severity, Journal& journal,
     additionalData.emplace("CALLOUT_IIC_BUS", bus);
     additionalData.emplace("CALLOUT_IIC_ADDR", addrStr);
     additionalData.emplace("CALLOUT_ERRNO", errorNumberStr);
+
+    // Store the most recent transactions on the bus as binary FFDC.  The bus
+    // is a device path like /dev/i2c-3.
+    std::vector<uint8_t> i2cRecords{};
+    std::string::size_type pos = bus.find_last_not_of("0123456789");
+    if ((pos != std::string::npos) && (pos + 1 < bus.size()))
+    {
+        unsigned int busId{0};
+        const char* end = bus.data() + bus.size();
+        auto [ptr, ec] = std::from_chars(bus.data() + pos + 1, end, busId);
+        if ((ec == std::errc{}) && (ptr == end) && (busId <= UINT8_MAX))
+        {
+            i2cRecords = i2c::dumpFlightRecorder(static_cast<uint8_t>(busId));
+        }
+    }
+
     logError("xyz.openbmc_project.Power.Error.I2C", severity, additionalData,
-             journal);
+             journal, std::move(i2cRecords));
 }
 
 void DBusErrorLogging::logInternalError(Entry::Level severity, Journal& journal)
@@ -96,7 +140,7 @@ void DBusErrorLogging::logPhaseFault(
             ? "xyz.openbmc_project.Power.Regulators.Error.PhaseFault.N"
             : "xyz.openbmc_project.Power.Regulators.Error.PhaseFault.NPlus1";
     additionalData.emplace("CALLOUT_INVENTORY_PATH", inventoryPath);
-    logError(message, severity, additionalData, journal);
+    logError(message, severity, additionalData, journal, {}, inventoryPath);
 }
 
 void DBusErrorLogging::logPMBusError(Entry::Level severity, Journal& journal,
@@ -105,7 +149,7 @@ void DBusErrorLogging::logPMBusError(Entry::Level severity, Journal& journal,
     std::map<std::string, std::string> additionalData{};
     additionalData.emplace("CALLOUT_INVENTORY_PATH", inventoryPath);
     logError("xyz.openbmc_project.Power.Error.PMBus", severity, additionalData,
-             journal);
+             journal, {}, inventoryPath);
 }
 
 void DBusErrorLogging::logWriteVerificationError(
@@ -114,70 +158,43 @@ void DBusErrorLogging::logWriteVerificationError(
     std::map<std::string, std::string> additionalData{};
     additionalData.emplace("CALLOUT_INVENTORY_PATH", inventoryPath);
     logError("xyz.openbmc_project.Power.Regulators.Error.WriteVerification",
-             severity, additionalData, journal);
+             severity, additionalData, journal, {}, inventoryPath);
 }
 
-FFDCFile DBusErrorLogging::createFFDCFile(const std::vector<std::string>& lines)
+MemFDFile
+    DBusErrorLogging::createFFDCFile(const std::vector<std::string>& lines)
 {
-    // Create FFDC file of type Text
-    FFDCFile file{FFDCFormat::Text};
-    int fd = file.getFileDescriptor();
-
-    // Write lines to file
-    std::string buffer;
+    // Copy lines to buffer.  Add newline if necessary.
+    std::string buffer{};
     for (const std::string& line : lines)
     {
-        // Copy line to buffer.  Add newline if necessary.
-        buffer = line;
+        buffer += line;
         if (line.empty() || (line.back() != '\n'))
         {
             buffer += '\n';
         }
-
-        // Write buffer to file
-        const char* bufPtr = buffer.c_str();
-        unsigned int count = buffer.size();
-        while (count > 0)
-        {
-            // Try to write remaining bytes; it might not write all of them
-            ssize_t bytesWritten = write(fd, bufPtr, count);
-            if (bytesWritten == -1)
-            {
-                throw std::runtime_error{
-                    std::string{"Unable to write to FFDC file: "} +
-                    strerror(errno)};
-            }
-            bufPtr += bytesWritten;
-            count -= bytesWritten;
-        }
     }
 
-    // Seek to beginning of file so error logging system can read data
-    if (lseek(fd, 0, SEEK_SET) != 0)
-    {
-        throw std::runtime_error{
-            std::string{"Unable to seek within FFDC file: "} + strerror(errno)};
-    }
+    // Write buffer to an in-memory file so no file system writes occur.  Seal
+    // the file before the error logging system reads it.
+    MemFDFile file{"phosphor-regulators-ffdc"};
+    file.write(buffer);
+    file.seal();
 
     return file;
 }
 
-std::vector<FFDCFile> DBusErrorLogging::createFFDCFiles(Journal& journal)
+std::vector<MemFDFile> DBusErrorLogging::createFFDCFiles(
+    const std::vector<std::vector<std::string>>& journalMessages,
+    Journal& journal)
 {
-    std::vector<FFDCFile> files{};
+    std::vector<MemFDFile> files{};
 
-    // Create FFDC files containing journal messages from relevant executables.
-    // Executables in priority order in case error log cannot hold all the FFDC.
-    std::vector<std::string> executables{"phosphor-regulators", "systemd"};
-    for (const std::string& executable : executables)
+    // Create FFDC files containing journal messages from relevant executables
+    for (const std::vector<std::string>& messages : journalMessages)
     {
         try
         {
-            // Get recent journal messages from the executable
-            std::vector<std::string> messages =
-                journal.getMessages("SYSLOG_IDENTIFIER", executable, 30);
-
-            // Create FFDC file containing the journal messages
             if (!messages.empty())
             {
                 files.emplace_back(createFFDCFile(messages));
@@ -185,40 +202,145 @@ std::vector<FFDCFile> DBusErrorLogging::createFFDCFiles(Journal& journal)
         }
         catch (const std::exception& e)
         {
-            journal.logError(exception_utils::getMessages(e));
+            journal.logError(exception_utils::MessageView{e});
         }
     }
 
     return files;
 }
 
-std::vector<FFDCTuple>
-    DBusErrorLogging::createFFDCTuples(std::vector<FFDCFile>& files)
+std::vector<FFDCTuple> DBusErrorLogging::createFFDCTuples(
+    std::vector<FileDescriptor>& descriptors)
 {
+    // All FFDC files contain journal messages in text format
     std::vector<FFDCTuple> ffdcTuples{};
-    for (FFDCFile& file : files)
+    for (FileDescriptor& descriptor : descriptors)
     {
-        ffdcTuples.emplace_back(
-            file.getFormat(), file.getSubType(), file.getVersion(),
-            sdbusplus::message::unix_fd(file.getFileDescriptor()));
+        ffdcTuples.emplace_back(FFDCFormat::Text, 0, 0,
+                                sdbusplus::message::unix_fd(descriptor()));
     }
     return ffdcTuples;
 }
 
-void DBusErrorLogging::logError(
-    const std::string& message, Entry::Level severity,
-    std::map<std::string, std::string>& additionalData, Journal& journal)
+void DBusErrorLogging::captureErrors()
 {
-    try
+    // Account the queued errors and FFDC buffers to error logging
+    memory_accounting::Scope memoryScope{memory_accounting::Tag::errorLogging};
+
+    // Use a separate D-Bus connection.  The connection passed to the
+    // constructor is used by the event loop thread.
+    std::unique_ptr<sdbusplus::bus::bus> captureBus{};
+
+    std::unique_lock<std::mutex> lock{mutex};
+    while (true)
     {
-        // Add PID to AdditionalData
-        additionalData.emplace("_PID", std::to_string(getpid()));
+        // Wait until errors are queued or this object is being destroyed
+        condition.wait(lock,
+                       [this] { return isStopping || !pendingErrors.empty(); });
+        if (pendingErrors.empty())
+        {
+            break;
+        }
+
+        // Wait for any other errors from the same burst, such as the rest of
+        // the rail errors from one monitoring cycle
+        condition.wait_for(lock, errorBatchDelay,
+                           [this] { return isStopping; });
+
+        // Take all the queued errors.  Errors queued at the same time share
+        // one journal capture and one set of FFDC files.
+        std::deque<PendingError> errors{};
+        errors.swap(pendingErrors);
+        lock.unlock();
+
+        Journal* capturedJournal{nullptr};
+        std::vector<MemFDFile> files{};
+        for (PendingError& error : errors)
+        {
+            try
+            {
+                if (!captureBus)
+                {
+                    captureBus = std::make_unique<sdbusplus::bus::bus>(
+                        sdbusplus::bus::new_default());
+                }
+            }
+            catch (const std::exception& e)
+            {
+                error.journal->logError(exception_utils::MessageView{e});
+                error.journal->logError("Unable to log error " +
+                                        error.message);
+                continue;
+            }
+
+            if (error.journal != capturedJournal)
+            {
+                if (capturedJournal != nullptr)
+                {
+                    removeFFDCFiles(files, *capturedJournal);
+                }
+                files = createFFDCFiles(getJournalMessages(*error.journal),
+                                        *error.journal);
+                capturedJournal = error.journal;
+            }
+            createErrorLog(*captureBus, error, files);
+        }
+
+        // Remove the FFDC files now that all the errors in the batch have been
+        // logged
+        if (capturedJournal != nullptr)
+        {
+            removeFFDCFiles(files, *capturedJournal);
+        }
 
-        // Create FFDC files containing debug data to store in error log
-        std::vector<FFDCFile> files{createFFDCFiles(journal)};
+        lock.lock();
+    }
+}
+
+void DBusErrorLogging::createErrorLog(sdbusplus::bus::bus& bus,
+                                      PendingError& error,
+                                      std::vector<MemFDFile>& files)
+{
+    Journal& journal = *error.journal;
+    try
+    {
+        // Open the FFDC files again for this error log.  The files are shared
+        // by the errors in a batch, and the error logging system reads each
+        // file from the offset of the descriptor it receives, so every error
+        // log needs descriptors with their own offsets.  They are closed when
+        // they go out of scope.
+        std::vector<FileDescriptor> descriptors{};
+        for (MemFDFile& file : files)
+        {
+            descriptors.emplace_back(file.reopen());
+        }
 
         // Create FFDC tuples used to pass FFDC files to D-Bus method
-        std::vector<FFDCTuple> ffdcTuples{createFFDCTuples(files)};
+        std::vector<FFDCTuple> ffdcTuples{createFFDCTuples(descriptors)};
+
+        // Add the I2C flight recorder records of this error.  The file is
+        // only used by this error log and is closed when it goes out of scope.
+        std::optional<MemFDFile> i2cFile{};
+        if (!error.i2cRecords.empty())
+        {
+            i2cFile.emplace("phosphor-regulators-i2c-ffdc");
+            i2cFile->write(error.i2cRecords);
+            i2cFile->seal();
+            ffdcTuples.emplace_back(
+                FFDCFormat::Custom, i2cRecordsSubType, i2cRecordsVersion,
+                sdbusplus::message::unix_fd(i2cFile->getFileDescriptor()));
+        }
+
+        // Add the sensor history of the device.  Also only used by this
+        // error log.
+        std::optional<MemFDFile> sensorFile{};
+        if (!error.sensorLines.empty())
+        {
+            sensorFile.emplace(createFFDCFile(error.sensorLines));
+            ffdcTuples.emplace_back(
+                FFDCFormat::Text, 0, 0,
+                sdbusplus::message::unix_fd(sensorFile->getFileDescriptor()));
+        }
 
         // Call D-Bus method to create an error log with FFDC files
         const char* service = "xyz.openbmc_project.Logging";
@@ -226,38 +348,115 @@ void DBusErrorLogging::logError(
         const char* interface = "xyz.openbmc_project.Logging.Create";
         const char* method = "CreateWithFFDCFiles";
         auto reqMsg = bus.new_method_call(service, objPath, interface, method);
-        reqMsg.append(message, severity, additionalData, ffdcTuples);
+        reqMsg.append(error.message, error.severity, error.additionalData,
+                      ffdcTuples);
         auto respMsg = bus.call(reqMsg);
-
-        // Remove FFDC files.  If an exception occurs before this, the files
-        // will be deleted by FFDCFile desctructor but errors will be ignored.
-        removeFFDCFiles(files, journal);
     }
     catch (const std::exception& e)
     {
-        journal.logError(exception_utils::getMessages(e));
-        journal.logError("Unable to log error " + message);
+        journal.logError(exception_utils::MessageView{e});
+        journal.logError("Unable to log error " + error.message);
+    }
+}
+
+std::vector<std::vector<std::string>>
+    DBusErrorLogging::getJournalMessages(Journal& journal)
+{
+    std::vector<std::vector<std::string>> journalMessages{};
+
+    // Get journal messages from relevant executables.  Executables in priority
+    // order in case error log cannot hold all the FFDC.
+    std::vector<std::string> executables{"phosphor-regulators", "systemd"};
+    for (const std::string& executable : executables)
+    {
+        try
+        {
+            // Get recent journal messages from the executable
+            journalMessages.emplace_back(
+                journal.getMessages("SYSLOG_IDENTIFIER", executable, 30));
+        }
+        catch (const std::exception& e)
+        {
+            journal.logError(exception_utils::MessageView{e});
+        }
+    }
+
+    return journalMessages;
+}
+
+void DBusErrorLogging::logError(
+    const std::string& message, Entry::Level severity,
+    std::map<std::string, std::string>& additionalData, Journal& journal,
+    std::vector<uint8_t> i2cRecords, const std::string& inventoryPath)
+{
+    memory_accounting::Scope memoryScope{memory_accounting::Tag::errorLogging};
+
+    // Add PID to AdditionalData
+    additionalData.emplace("_PID", std::to_string(getpid()));
+
+    // Capture the sensor values before the error now, since the history
+    // keeps changing while the error is queued
+    std::vector<std::string> sensorLines{};
+    if ((sensorHistory != nullptr) && !inventoryPath.empty())
+    {
+        try
+        {
+            sensorLines = sensorHistory->getFFDCLines(inventoryPath);
+        }
+        catch (const std::exception& e)
+        {
+            journal.logError(exception_utils::MessageView{e});
+        }
+    }
+
+    // Queue the error for the capture thread so the caller is not blocked
+    // while journal messages are captured
+    std::unique_lock<std::mutex> lock{mutex};
+    pendingErrors.emplace_back(PendingError{message, severity, additionalData,
+                                            &journal, std::move(i2cRecords),
+                                            std::move(sensorLines)});
+    if (!captureThread.joinable())
+    {
+        try
+        {
+            captureThread = std::thread{&DBusErrorLogging::captureErrors, this};
+        }
+        catch (const std::system_error& e)
+        {
+            // Unable to start capture thread; log the error on this thread
+            PendingError error{std::move(pendingErrors.back())};
+            pendingErrors.pop_back();
+            lock.unlock();
+            journal.logError(exception_utils::MessageView{e});
+            std::vector<MemFDFile> files{
+                createFFDCFiles(getJournalMessages(journal), journal)};
+            createErrorLog(bus, error, files);
+            removeFFDCFiles(files, journal);
+            return;
+        }
     }
+    lock.unlock();
+    condition.notify_one();
 }
 
-void DBusErrorLogging::removeFFDCFiles(std::vector<FFDCFile>& files,
+void DBusErrorLogging::removeFFDCFiles(std::vector<MemFDFile>& files,
                                        Journal& journal)
 {
-    // Explicitly remove FFDC files rather than relying on FFDCFile destructor.
+    // Explicitly close FFDC files rather than relying on MemFDFile destructor.
     // This allows any resulting errors to be written to the journal.
-    for (FFDCFile& file : files)
+    for (MemFDFile& file : files)
     {
         try
         {
-            file.remove();
+            file.close();
         }
         catch (const std::exception& e)
         {
-            journal.logError(exception_utils::getMessages(e));
+            journal.logError(exception_utils::MessageView{e});
         }
     }
 
-    // Clear vector since the FFDCFile objects can no longer be used
+    // Clear vector since the MemFDFile objects can no longer be used
     files.clear();
 }
 
@@ -17,15 +17,21 @@
 
 #include "ffdc_file.hpp"
 #include "journal.hpp"
+#include "memfd_file.hpp"
 #include "phase_fault.hpp"
+#include "sensor_history.hpp"
 #include "xyz/openbmc_project/Logging/Create/server.hpp"
 #include "xyz/openbmc_project/Logging/Entry/server.hpp"
 
 #include <sdbusplus/bus.hpp>
 
+#include <condition_variable>
 #include <cstdint>
+#include <deque>
 #include <map>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <tuple>
 #include <vector>
 
@@ -35,6 +41,8 @@ namespace phosphor::power::regulators
 using namespace sdbusplus::xyz::openbmc_project::Logging::server;
 using FFDCTuple =
     std::tuple<FFDCFormat, uint8_t, uint8_t, sdbusplus::message::unix_fd>;
+using FileDescriptor = phosphor::power::util::FileDescriptor;
+using MemFDFile = phosphor::power::util::MemFDFile;
 
 /**
  * @class ErrorLogging
@@ -149,6 +157,19 @@ class ErrorLogging
  * @class DBusErrorLogging
  *
  * Implementation of the ErrorLogging interface using D-Bus method calls.
+ *
+ * Error logs contain FFDC files with recent journal messages.  Capturing the
+ * journal messages takes more than 100 milliseconds, so error logs are created
+ * asynchronously by a capture thread.  The log methods queue the error and
+ * return immediately.  The capture thread waits briefly for other errors from
+ * the same burst, such as one sensor monitoring cycle, and then logs the
+ * queued errors as a batch.  The journal messages are captured and written to
+ * FFDC files once per batch.  The files are shared by all the error logs in
+ * the batch.  The D-Bus method to create each error log is called using the
+ * capture thread's own D-Bus connection.
+ *
+ * Errors that are still queued when this object is destroyed are logged
+ * before the destructor returns.
  */
 class DBusErrorLogging : public ErrorLogging
 {
@@ -159,16 +180,36 @@ class DBusErrorLogging : public ErrorLogging
     DBusErrorLogging(DBusErrorLogging&&) = delete;
     DBusErrorLogging& operator=(const DBusErrorLogging&) = delete;
     DBusErrorLogging& operator=(DBusErrorLogging&&) = delete;
-    virtual ~DBusErrorLogging() = default;
+    /**
+     * Destructor.
+     *
+     * Logs any queued errors and stops the capture thread.
+     */
+    virtual ~DBusErrorLogging();
 
     /**
      * Constructor.
      *
-     * @param bus D-Bus bus object
+     * @param bus D-Bus bus object.  Used to log errors if the capture thread
+     *            cannot be started.
      */
     explicit DBusErrorLogging(sdbusplus::bus::bus& bus) : bus{bus}
     {}
 
+    /**
+     * Sets the sensor history that is stored in error logs for a device.
+     *
+     * The recent sensor values of the device are captured when the error is
+     * logged.  The sensor history must exist for the lifetime of this object,
+     * and errors must be logged on the thread that updates it.
+     *
+     * @param sensorHistory sensor history, or nullptr to not store any
+     */
+    void setSensorHistory(const SensorHistory* sensorHistory)
+    {
+        this->sensorHistory = sensorHistory;
+    }
+
     /** @copydoc ErrorLogging::logConfigFileError() */
     virtual void logConfigFileError(Entry::Level severity,
                                     Journal& journal) override;
@@ -202,69 +243,201 @@ class DBusErrorLogging : public ErrorLogging
 
   private:
     /**
-     * Create an FFDCFile object containing the specified lines of text data.
+     * Error that is queued to be logged by the capture thread.
+     */
+    struct PendingError
+    {
+        /**
+         * Message property of the error log entry.
+         */
+        std::string message;
+
+        /**
+         * Severity property of the error log entry.
+         */
+        Entry::Level severity;
+
+        /**
+         * AdditionalData property of the error log entry.
+         */
+        std::map<std::string, std::string> additionalData;
+
+        /**
+         * System journal.
+         */
+        Journal* journal;
+
+        /**
+         * I2C flight recorder records of the bus the error occurred on, in
+         * the binary format from i2c::FlightRecorder::dump().  Empty if the
+         * error is not an I2C error.
+         */
+        std::vector<uint8_t> i2cRecords{};
+
+        /**
+         * Recent sensor values of the device the error occurred on, from
+         * SensorHistory::getFFDCLines().  Empty if none.
+         */
+        std::vector<std::string> sensorLines{};
+    };
+
+    /**
+     * FFDC subtype of the I2C flight recorder records.  Stored with the
+     * Custom format.
+     */
+    static constexpr uint8_t i2cRecordsSubType{1};
+
+    /**
+     * FFDC version of the I2C flight recorder records.
+     */
+    static constexpr uint8_t i2cRecordsVersion{1};
+
+    /**
+     * Logs the queued errors until this object is destroyed.
+     *
+     * This is the main function of the capture thread.
+     */
+    void captureErrors();
+
+    /**
+     * Create an in-memory FFDC file containing the specified lines of text
+     * data.
+     *
+     * The file is sealed so its contents cannot be changed after it is passed
+     * to the error logging system.
      *
      * Throws an exception if an error occurs.
      *
      * @param lines lines of text data to write to file
-     * @return FFDCFile object
+     * @return MemFDFile object
      */
-    FFDCFile createFFDCFile(const std::vector<std::string>& lines);
+    MemFDFile createFFDCFile(const std::vector<std::string>& lines);
 
     /**
-     * Create FFDCFile objects containing debug data to store in the error log.
+     * Create in-memory FFDC files containing debug data to store in the error
+     * log.
      *
      * If an error occurs, the error is written to the journal but an exception
      * is not thrown.
      *
+     * @param journalMessages journal messages from getJournalMessages()
      * @param journal system journal
-     * @return vector of FFDCFile objects
+     * @return vector of MemFDFile objects
      */
-    std::vector<FFDCFile> createFFDCFiles(Journal& journal);
+    std::vector<MemFDFile> createFFDCFiles(
+        const std::vector<std::vector<std::string>>& journalMessages,
+        Journal& journal);
 
     /**
-     * Create FFDCTuple objects corresponding to the specified FFDC files.
+     * Create FFDCTuple objects corresponding to the specified FFDC file
+     * descriptors.
      *
      * The D-Bus method to create an error log requires a vector of tuples to
      * pass in the FFDC file information.
      *
-     * @param files FFDC files
+     * @param descriptors file descriptors of the FFDC files
      * @return vector of FFDCTuple objects
      */
-    std::vector<FFDCTuple> createFFDCTuples(std::vector<FFDCFile>& files);
+    std::vector<FFDCTuple>
+        createFFDCTuples(std::vector<FileDescriptor>& descriptors);
 
     /**
-     * Logs an error using the D-Bus CreateWithFFDCFiles method.
+     * Creates an error log using the D-Bus CreateWithFFDCFiles method.
+     *
+     * The FFDC files may be shared by several error logs.  They are not
+     * closed.  Each error log reads them through its own file descriptors.
      *
      * If logging fails, a message is written to the journal but an exception is
      * not thrown.
      *
+     * @param bus D-Bus bus object to use for the method call
+     * @param error error to log
+     * @param files FFDC files to store in the error log
+     */
+    void createErrorLog(sdbusplus::bus::bus& bus, PendingError& error,
+                        std::vector<MemFDFile>& files);
+
+    /**
+     * Gets the recent journal messages to store in error logs.
+     *
+     * Returns one vector of messages for each relevant executable.  If an
+     * error occurs, the error is written to the journal but an exception is
+     * not thrown.
+     *
+     * @param journal system journal
+     * @return journal messages
+     */
+    std::vector<std::vector<std::string>> getJournalMessages(Journal& journal);
+
+    /**
+     * Logs an error using the D-Bus CreateWithFFDCFiles method.
+     *
+     * The error is queued and logged by the capture thread.
+     *
      * @param message Message property of the error log entry
      * @param severity Severity property of the error log entry
      * @param additionalData AdditionalData property of the error log entry
      * @param journal system journal
+     * @param i2cRecords I2C flight recorder records to store in the error
+     *                   log; empty if none
+     * @param inventoryPath D-Bus inventory path of the device whose sensor
+     *                      history is stored in the error log; empty if none
      */
     void logError(const std::string& message, Entry::Level severity,
                   std::map<std::string, std::string>& additionalData,
-                  Journal& journal);
+                  Journal& journal, std::vector<uint8_t> i2cRecords = {},
+                  const std::string& inventoryPath = {});
 
     /**
-     * Removes the specified FFDC files from the file system.
+     * Closes the specified FFDC files.  The memory used by each file is freed
+     * once the error logging system has also closed it.
      *
-     * Also clears the specified vector, removing the FFDCFile objects.
+     * Also clears the specified vector, removing the MemFDFile objects.
      *
      * If an error occurs, the error is written to the journal but an exception
      * is not thrown.
      *
-     * @param files FFDC files to remove
+     * @param files FFDC files to close
      * @param journal system journal
      */
-    void removeFFDCFiles(std::vector<FFDCFile>& files, Journal& journal);
+    void removeFFDCFiles(std::vector<MemFDFile>& files, Journal& journal);
 
     /**
      * D-Bus bus object.
      */
     sdbusplus::bus::bus& bus;
+
+    /**
+     * Sensor history stored in error logs for a device.  May be nullptr.
+     */
+    const SensorHistory* sensorHistory{nullptr};
+
+    /**
+     * Mutex that protects the error queue and stop flag.
+     */
+    std::mutex mutex{};
+
+    /**
+     * Condition variable used to notify the capture thread.
+     */
+    std::condition_variable condition{};
+
+    /**
+     * Errors queued to be logged by the capture thread.
+     */
+    std::deque<PendingError> pendingErrors{};
+
+    /**
+     * Indicates whether the capture thread should stop after logging the
+     * queued errors.
+     */
+    bool isStopping{false};
+
+    /**
+     * Thread that captures journal messages and creates error logs.  Started
+     * when the first error is logged.
+     */
+    std::thread captureThread{};
 };
 
 } // namespace phosphor::power::regulators
@@ -133,19 +133,16 @@ std::exception_ptr getExceptionToLog(std::exception_ptr eptr)
     // Default to selecting the outermost exception
     std::exception_ptr exceptionToLog{eptr};
 
-    // Get vector containing this exception and any nested exceptions
-    std::vector<std::exception_ptr> exceptions =
-        exception_utils::getExceptions(eptr);
-
     // Define temporary constants for exception priorities
     const int lowPriority{0}, mediumPriority{1}, highPriority{2};
 
-    // Loop through the exceptions from innermost to outermost.  Find the
-    // exception with the highest priority.  If there is a tie, select the
-    // outermost exception with that priority.
+    // Visit this exception and any nested exceptions from innermost to
+    // outermost.  Find the exception with the highest priority.  If there is
+    // a tie, select the outermost exception with that priority.  The
+    // exceptions are visited in place rather than copied into a vector, since
+    // this runs every time a monitoring operation fails.
     int highestPriorityFound{-1};
-    for (std::exception_ptr curptr : exceptions)
-    {
+    auto checkPriority = [&](std::exception_ptr curptr) {
         int priority{-1};
         try
         {
@@ -185,7 +182,8 @@ std::exception_ptr getExceptionToLog(std::exception_ptr eptr)
             highestPriorityFound = priority;
             exceptionToLog = curptr;
         }
-    }
+    };
+    exception_utils::internal::forEachException(eptr, checkPriority);
 
     return exceptionToLog;
 }
@@ -39,42 +39,18 @@ namespace internal
 void getExceptions(std::exception_ptr eptr,
                    std::vector<std::exception_ptr>& exceptions)
 {
-    // Verify exception pointer is not null
-    if (eptr)
-    {
-        // If this exception is nested, add inner exception(s) to vector
-        try
-        {
-            std::rethrow_exception(eptr);
-        }
-        catch (const std::nested_exception& e)
-        {
-            getExceptions(e.nested_ptr(), exceptions);
-        }
-        catch (...)
-        {}
-
-        // Append this exception to vector
-        exceptions.emplace_back(eptr);
-    }
+    auto append = [&exceptions](std::exception_ptr curptr) {
+        exceptions.emplace_back(curptr);
+    };
+    forEachException(eptr, append);
 }
 
 void getMessages(const std::exception& e, std::vector<std::string>& messages)
 {
-    // If this exception is nested, get messages from inner exception(s)
-    try
-    {
-        std::rethrow_if_nested(e);
-    }
-    catch (const std::exception& inner)
-    {
-        getMessages(inner, messages);
-    }
-    catch (...)
-    {}
-
-    // Append error message from this exception
-    messages.emplace_back(e.what());
+    auto append = [&messages](const char* message) {
+        messages.emplace_back(message);
+    };
+    forEachMessage(e, append);
 }
 
 } // namespace internal
@@ -15,8 +15,6 @@
  */
 #pragma once
 
-#include "journal.hpp"
-
 #include <exception>
 #include <string>
 #include <vector>
@@ -57,12 +55,131 @@ std::vector<std::exception_ptr> getExceptions(std::exception_ptr eptr);
  */
 std::vector<std::string> getMessages(const std::exception& e);
 
+/**
+ * @class MessageView
+ *
+ * Lazy view of the error messages from an exception and any nested inner
+ * exceptions.
+ *
+ * Creating a view is cheap; the nested exceptions are only unwrapped and
+ * their messages copied when the messages are actually used, such as when
+ * they are written to the journal.  Code that catches an exception on every
+ * monitoring cycle can create a view without paying for the messages when
+ * they will not be logged.
+ *
+ * The view refers to the exception, so it must not outlive it.
+ */
+class MessageView
+{
+  public:
+    // Specify which compiler-generated methods we want
+    MessageView() = delete;
+    MessageView(const MessageView&) = default;
+    MessageView(MessageView&&) = default;
+    MessageView& operator=(const MessageView&) = delete;
+    MessageView& operator=(MessageView&&) = delete;
+    ~MessageView() = default;
+
+    /**
+     * Constructor.
+     *
+     * @param e exception
+     */
+    explicit MessageView(const std::exception& e) : exception{e} {}
+
+    /**
+     * Calls the specified function with each error message, from innermost
+     * exception to outermost exception.
+     *
+     * The function is passed a const char* that is only valid during the
+     * call.
+     *
+     * @param func function to call with each error message
+     */
+    template <typename Func>
+    void forEach(Func func) const;
+
+    /**
+     * Returns the error messages, from innermost exception to outermost
+     * exception.
+     *
+     * @return error messages
+     */
+    std::vector<std::string> toVector() const
+    {
+        return getMessages(exception);
+    }
+
+  private:
+    /**
+     * Exception containing the error messages.
+     */
+    const std::exception& exception;
+};
+
 /*
  * Internal implementation details
  */
 namespace internal
 {
 
+/**
+ * Calls the specified function for the specified exception and any nested
+ * inner exceptions, from innermost exception to outermost exception.
+ *
+ * The function is passed the exception pointer of each exception.
+ *
+ * @param eptr exception pointer
+ * @param func function to call for each exception
+ */
+template <typename Func>
+void forEachException(std::exception_ptr eptr, Func& func)
+{
+    // Verify exception pointer is not null
+    if (eptr)
+    {
+        // If this exception is nested, visit inner exception(s) first
+        try
+        {
+            std::rethrow_exception(eptr);
+        }
+        catch (const std::nested_exception& e)
+        {
+            forEachException(e.nested_ptr(), func);
+        }
+        catch (...)
+        {}
+
+        func(eptr);
+    }
+}
+
+/**
+ * Calls the specified function with the error message of the specified
+ * exception and any nested inner exceptions, from innermost exception to
+ * outermost exception.
+ *
+ * @param e exception
+ * @param func function to call with each error message
+ */
+template <typename Func>
+void forEachMessage(const std::exception& e, Func& func)
+{
+    // If this exception is nested, visit inner exception(s) first
+    try
+    {
+        std::rethrow_if_nested(e);
+    }
+    catch (const std::exception& inner)
+    {
+        forEachMessage(inner, func);
+    }
+    catch (...)
+    {}
+
+    func(e.what());
+}
+
 /**
  * Builds a vector containing the specified exception and any nested inner
  * exceptions.
@@ -90,4 +207,10 @@ void getMessages(const std::exception& e, std::vector<std::string>& messages);
 
 } // namespace internal
 
+template <typename Func>
+void MessageView::forEach(Func func) const
+{
+    internal::forEachMessage(exception, func);
+}
+
 } // namespace phosphor::power::regulators::exception_utils
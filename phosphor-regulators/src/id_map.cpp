@@ -25,11 +25,11 @@ namespace phosphor::power::regulators
 
 void IDMap::addDevice(Device& device)
 {
-    const std::string& id = device.getID();
+    Symbol id = device.getIDSymbol();
     if (deviceMap.count(id) != 0)
     {
         throw std::invalid_argument{"Unable to add device: Duplicate ID \"" +
-                                    id + '"'};
+                                    id.str() + '"'};
     }
     deviceMap[id] = &device;
 }
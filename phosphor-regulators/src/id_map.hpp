@@ -15,9 +15,12 @@
  */
 #pragma once
 
-#include <map>
+#include "symbol.hpp"
+
+#include <optional>
 #include <stdexcept>
 #include <string>
+#include <unordered_map>
 
 namespace phosphor::power::regulators
 {
@@ -80,12 +83,35 @@ class IDMap
      * @return device with specified ID
      */
     Device& getDevice(const std::string& id) const
+    {
+        // If the ID is not in the symbol table, no device has it
+        std::optional<Symbol> symbol = Symbol::find(id);
+        if (!symbol)
+        {
+            throw std::invalid_argument{"Unable to find device with ID \"" +
+                                        id + '"'};
+        }
+        return getDevice(*symbol);
+    }
+
+    /**
+     * Returns the device with the specified ID.
+     *
+     * Faster than getDevice(const std::string&) since the ID does not need to
+     * be hashed or compared character by character.
+     *
+     * Throws invalid_argument if no device is found with specified ID.
+     *
+     * @param id device ID
+     * @return device with specified ID
+     */
+    Device& getDevice(Symbol id) const
     {
         auto it = deviceMap.find(id);
         if (it == deviceMap.end())
         {
             throw std::invalid_argument{"Unable to find device with ID \"" +
-                                        id + '"'};
+                                        id.str() + '"'};
         }
         return *(it->second);
     }
@@ -132,17 +158,17 @@ class IDMap
     /**
      * Map from device IDs to Device objects.  Does not own the objects.
      */
-    std::map<std::string, Device*> deviceMap{};
+    std::unordered_map<Symbol, Device*> deviceMap{};
 
     /**
      * Map from rail IDs to Rail objects.  Does not own the objects.
      */
-    std::map<std::string, Rail*> railMap{};
+    std::unordered_map<std::string, Rail*> railMap{};
 
     /**
      * Map from rule IDs to Rule objects.  Does not own the objects.
      */
-    std::map<std::string, Rule*> ruleMap{};
+    std::unordered_map<std::string, Rule*> ruleMap{};
 };
 
 } // namespace phosphor::power::regulators
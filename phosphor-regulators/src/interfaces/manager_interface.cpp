@@ -21,8 +21,11 @@
 #include <sdbusplus/sdbus.hpp>
 #include <sdbusplus/server.hpp>
 
+#include <cstdint>
+#include <map>
 #include <string>
 #include <tuple>
+#include <vector>
 
 namespace phosphor
 {
@@ -37,6 +40,35 @@ ManagerInterface::ManagerInterface(sdbusplus::bus::bus& bus, const char* path) :
     _serverInterface(bus, path, interface, _vtable, this)
 {}
 
+void ManagerInterface::emitConfigureProgressSignal(uint32_t chassisNumber,
+                                                   uint32_t configuredCount,
+                                                   uint32_t chassisCount,
+                                                   uint32_t errorCount,
+                                                   uint64_t duration)
+{
+    auto msg = _serverInterface.new_signal("ConfigureProgress");
+    msg.append(chassisNumber, configuredCount, chassisCount, errorCount,
+               duration);
+    msg.signal_send();
+}
+
+void ManagerInterface::emitConfigureCompletedSignal(
+    bool success, uint32_t errorCount,
+    const std::map<std::string, uint64_t>& phaseTimes)
+{
+    auto msg = _serverInterface.new_signal("ConfigureCompleted");
+    msg.append(success, errorCount, phaseTimes);
+    msg.signal_send();
+}
+
+void ManagerInterface::emitPowerDomainConfiguredSignal(const std::string& name,
+                                                       bool success)
+{
+    auto msg = _serverInterface.new_signal("PowerDomainConfigured");
+    msg.append(name, success);
+    msg.signal_send();
+}
+
 int ManagerInterface::callbackConfigure(sd_bus_message* msg, void* context,
                                         sd_bus_error* error)
 {
@@ -104,12 +136,443 @@ int ManagerInterface::callbackMonitor(sd_bus_message* msg, void* context,
     return 1;
 }
 
+int ManagerInterface::callbackEnableI2CStats(sd_bus_message* msg,
+                                             void* context, sd_bus_error* error)
+{
+    if (msg != nullptr && context != nullptr)
+    {
+        try
+        {
+            bool enable{};
+            auto m = sdbusplus::message::message(msg);
+
+            m.read(enable);
+
+            auto mgrObj = static_cast<ManagerInterface*>(context);
+            mgrObj->enableI2CStats(enable);
+
+            auto reply = m.new_method_return();
+
+            reply.method_return();
+        }
+        catch (const sdbusplus::exception_t& e)
+        {
+            return sd_bus_error_set(error, e.name(), e.description());
+        }
+    }
+    else
+    {
+        // The message or context were null
+        using namespace phosphor::logging;
+        log<level::ERR>("Unable to service EnableI2CStats method callback");
+        return -1;
+    }
+
+    return 1;
+}
+
+int ManagerInterface::callbackGetI2CStats(sd_bus_message* msg, void* context,
+                                          sd_bus_error* error)
+{
+    if (msg != nullptr && context != nullptr)
+    {
+        try
+        {
+            auto m = sdbusplus::message::message(msg);
+
+            auto mgrObj = static_cast<ManagerInterface*>(context);
+            std::string stats = mgrObj->getI2CStats();
+
+            auto reply = m.new_method_return();
+            reply.append(stats);
+
+            reply.method_return();
+        }
+        catch (const sdbusplus::exception_t& e)
+        {
+            return sd_bus_error_set(error, e.name(), e.description());
+        }
+    }
+    else
+    {
+        // The message or context were null
+        using namespace phosphor::logging;
+        log<level::ERR>("Unable to service GetI2CStats method callback");
+        return -1;
+    }
+
+    return 1;
+}
+
+int ManagerInterface::callbackGetMemoryUsage(sd_bus_message* msg,
+                                             void* context, sd_bus_error* error)
+{
+    if (msg != nullptr && context != nullptr)
+    {
+        try
+        {
+            bool resetPeaks{};
+            auto m = sdbusplus::message::message(msg);
+
+            m.read(resetPeaks);
+
+            auto mgrObj = static_cast<ManagerInterface*>(context);
+            std::string usage = mgrObj->getMemoryUsage(resetPeaks);
+
+            auto reply = m.new_method_return();
+            reply.append(usage);
+
+            reply.method_return();
+        }
+        catch (const sdbusplus::exception_t& e)
+        {
+            return sd_bus_error_set(error, e.name(), e.description());
+        }
+    }
+    else
+    {
+        // The message or context were null
+        using namespace phosphor::logging;
+        log<level::ERR>("Unable to service GetMemoryUsage method callback");
+        return -1;
+    }
+
+    return 1;
+}
+
+int ManagerInterface::callbackEnableRuleProfiling(sd_bus_message* msg,
+                                                  void* context,
+                                                  sd_bus_error* error)
+{
+    if (msg != nullptr && context != nullptr)
+    {
+        try
+        {
+            bool enable{};
+            auto m = sdbusplus::message::message(msg);
+
+            m.read(enable);
+
+            auto mgrObj = static_cast<ManagerInterface*>(context);
+            mgrObj->enableRuleProfiling(enable);
+
+            auto reply = m.new_method_return();
+
+            reply.method_return();
+        }
+        catch (const sdbusplus::exception_t& e)
+        {
+            return sd_bus_error_set(error, e.name(), e.description());
+        }
+    }
+    else
+    {
+        // The message or context were null
+        using namespace phosphor::logging;
+        log<level::ERR>(
+            "Unable to service EnableRuleProfiling method callback");
+        return -1;
+    }
+
+    return 1;
+}
+
+int ManagerInterface::callbackGetRuleProfile(sd_bus_message* msg,
+                                             void* context, sd_bus_error* error)
+{
+    if (msg != nullptr && context != nullptr)
+    {
+        try
+        {
+            bool folded{};
+            auto m = sdbusplus::message::message(msg);
+
+            m.read(folded);
+
+            auto mgrObj = static_cast<ManagerInterface*>(context);
+            std::string profile = mgrObj->getRuleProfile(folded);
+
+            auto reply = m.new_method_return();
+            reply.append(profile);
+
+            reply.method_return();
+        }
+        catch (const sdbusplus::exception_t& e)
+        {
+            return sd_bus_error_set(error, e.name(), e.description());
+        }
+    }
+    else
+    {
+        // The message or context were null
+        using namespace phosphor::logging;
+        log<level::ERR>("Unable to service GetRuleProfile method callback");
+        return -1;
+    }
+
+    return 1;
+}
+
+int ManagerInterface::callbackGetRailStats(sd_bus_message* msg, void* context,
+                                           sd_bus_error* error)
+{
+    if (msg != nullptr && context != nullptr)
+    {
+        try
+        {
+            auto m = sdbusplus::message::message(msg);
+
+            auto mgrObj = static_cast<ManagerInterface*>(context);
+            std::string stats = mgrObj->getRailStats();
+
+            auto reply = m.new_method_return();
+            reply.append(stats);
+
+            reply.method_return();
+        }
+        catch (const sdbusplus::exception_t& e)
+        {
+            return sd_bus_error_set(error, e.name(), e.description());
+        }
+    }
+    else
+    {
+        // The message or context were null
+        using namespace phosphor::logging;
+        log<level::ERR>("Unable to service GetRailStats method callback");
+        return -1;
+    }
+
+    return 1;
+}
+
+int ManagerInterface::callbackBenchmark(sd_bus_message* msg, void* context,
+                                        sd_bus_error* error)
+{
+    if (msg != nullptr && context != nullptr)
+    {
+        try
+        {
+            uint32_t count{};
+            auto m = sdbusplus::message::message(msg);
+
+            m.read(count);
+
+            auto mgrObj = static_cast<ManagerInterface*>(context);
+            std::string results = mgrObj->benchmark(count);
+
+            auto reply = m.new_method_return();
+            reply.append(results);
+
+            reply.method_return();
+        }
+        catch (const sdbusplus::exception_t& e)
+        {
+            return sd_bus_error_set(error, e.name(), e.description());
+        }
+    }
+    else
+    {
+        // The message or context were null
+        using namespace phosphor::logging;
+        log<level::ERR>("Unable to service Benchmark method callback");
+        return -1;
+    }
+
+    return 1;
+}
+
+int ManagerInterface::callbackHandleAlert(sd_bus_message* msg, void* context,
+                                          sd_bus_error* error)
+{
+    if (msg != nullptr && context != nullptr)
+    {
+        try
+        {
+            uint8_t bus{};
+            auto m = sdbusplus::message::message(msg);
+
+            m.read(bus);
+
+            auto mgrObj = static_cast<ManagerInterface*>(context);
+            std::vector<uint8_t> addresses = mgrObj->handleAlert(bus);
+
+            auto reply = m.new_method_return();
+            reply.append(addresses);
+
+            reply.method_return();
+        }
+        catch (const sdbusplus::exception_t& e)
+        {
+            return sd_bus_error_set(error, e.name(), e.description());
+        }
+    }
+    else
+    {
+        // The message or context were null
+        using namespace phosphor::logging;
+        log<level::ERR>("Unable to service HandleAlert method callback");
+        return -1;
+    }
+
+    return 1;
+}
+
+int ManagerInterface::callbackGetAllSensors(sd_bus_message* msg,
+                                            void* context, sd_bus_error* error)
+{
+    if (msg != nullptr && context != nullptr)
+    {
+        try
+        {
+            uint64_t since{};
+            auto m = sdbusplus::message::message(msg);
+
+            m.read(since);
+
+            auto mgrObj = static_cast<ManagerInterface*>(context);
+            auto [sequence, sensors] = mgrObj->getAllSensors(since);
+
+            auto reply = m.new_method_return();
+            reply.append(sequence, sensors);
+
+            reply.method_return();
+        }
+        catch (const sdbusplus::exception_t& e)
+        {
+            return sd_bus_error_set(error, e.name(), e.description());
+        }
+    }
+    else
+    {
+        // The message or context were null
+        using namespace phosphor::logging;
+        log<level::ERR>("Unable to service GetAllSensors method callback");
+        return -1;
+    }
+
+    return 1;
+}
+
+int ManagerInterface::callbackGetSensorHistory(sd_bus_message* msg,
+                                               void* context,
+                                               sd_bus_error* error)
+{
+    if (msg != nullptr && context != nullptr)
+    {
+        try
+        {
+            std::string name{};
+            uint64_t since{};
+            auto m = sdbusplus::message::message(msg);
+
+            m.read(name, since);
+
+            auto mgrObj = static_cast<ManagerInterface*>(context);
+            auto values = mgrObj->getSensorHistory(name, since);
+
+            auto reply = m.new_method_return();
+            reply.append(std::move(values));
+
+            reply.method_return();
+        }
+        catch (const sdbusplus::exception_t& e)
+        {
+            return sd_bus_error_set(error, e.name(), e.description());
+        }
+    }
+    else
+    {
+        // The message or context were null
+        using namespace phosphor::logging;
+        log<level::ERR>("Unable to service GetSensorHistory method callback");
+        return -1;
+    }
+
+    return 1;
+}
+
+int ManagerInterface::callbackSetRailVolts(sd_bus_message* msg, void* context,
+                                           sd_bus_error* error)
+{
+    if (msg != nullptr && context != nullptr)
+    {
+        try
+        {
+            std::string rail{};
+            double volts{};
+            auto m = sdbusplus::message::message(msg);
+
+            m.read(rail, volts);
+
+            auto mgrObj = static_cast<ManagerInterface*>(context);
+            mgrObj->setRailVolts(rail, volts);
+
+            auto reply = m.new_method_return();
+
+            reply.method_return();
+        }
+        catch (const sdbusplus::exception_t& e)
+        {
+            return sd_bus_error_set(error, e.name(), e.description());
+        }
+    }
+    else
+    {
+        // The message or context were null
+        using namespace phosphor::logging;
+        log<level::ERR>("Unable to service SetRailVolts method callback");
+        return -1;
+    }
+
+    return 1;
+}
+
 const sdbusplus::vtable::vtable_t ManagerInterface::_vtable[] = {
     sdbusplus::vtable::start(),
     // No configure method parameters and returns void
     sdbusplus::vtable::method("Configure", "", "", callbackConfigure),
     // Monitor method takes a boolean parameter and returns void
     sdbusplus::vtable::method("Monitor", "b", "", callbackMonitor),
+    // EnableI2CStats method takes a boolean parameter and returns void
+    sdbusplus::vtable::method("EnableI2CStats", "b", "",
+                              callbackEnableI2CStats),
+    // No GetI2CStats method parameters and returns a string
+    sdbusplus::vtable::method("GetI2CStats", "", "s", callbackGetI2CStats),
+    // GetMemoryUsage method takes a boolean parameter and returns a string
+    sdbusplus::vtable::method("GetMemoryUsage", "b", "s",
+                              callbackGetMemoryUsage),
+    // EnableRuleProfiling method takes a boolean parameter and returns void
+    sdbusplus::vtable::method("EnableRuleProfiling", "b", "",
+                              callbackEnableRuleProfiling),
+    // GetRuleProfile method takes a boolean parameter and returns a string
+    sdbusplus::vtable::method("GetRuleProfile", "b", "s",
+                              callbackGetRuleProfile),
+    // No GetRailStats method parameters and returns a string
+    sdbusplus::vtable::method("GetRailStats", "", "s", callbackGetRailStats),
+    // Benchmark method takes a uint32 parameter and returns a string
+    sdbusplus::vtable::method("Benchmark", "u", "s", callbackBenchmark),
+    // HandleAlert method takes a byte parameter and returns a byte array
+    sdbusplus::vtable::method("HandleAlert", "y", "ay", callbackHandleAlert),
+    // GetAllSensors method takes a uint64 parameter and returns a uint64 and
+    // an array of (string, string, double, uint64) structs
+    sdbusplus::vtable::method("GetAllSensors", "t", "ta(ssdt)",
+                              callbackGetAllSensors),
+    // GetSensorHistory method takes a string and a uint64 parameter and
+    // returns an array of (uint64, double) structs
+    sdbusplus::vtable::method("GetSensorHistory", "st", "a(td)",
+                              callbackGetSensorHistory),
+    // SetRailVolts method takes a string and a double parameter and returns
+    // void
+    sdbusplus::vtable::method("SetRailVolts", "sd", "", callbackSetRailVolts),
+    // ConfigureProgress signal has four uint32 parameters and a uint64
+    // parameter
+    sdbusplus::vtable::signal("ConfigureProgress", "uuuut"),
+    // ConfigureCompleted signal has a boolean, a uint32, and a dictionary of
+    // string to uint64 parameter
+    sdbusplus::vtable::signal("ConfigureCompleted", "bua{st}"),
+    // PowerDomainConfigured signal has a string and a boolean parameter
+    sdbusplus::vtable::signal("PowerDomainConfigured", "sb"),
     sdbusplus::vtable::end()};
 
 } // namespace interface
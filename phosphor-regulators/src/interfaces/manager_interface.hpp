@@ -6,7 +6,11 @@
 #include <sdbusplus/server/interface.hpp>
 #include <sdbusplus/vtable.hpp>
 
+#include <cstdint>
+#include <map>
 #include <string>
+#include <tuple>
+#include <vector>
 
 namespace phosphor
 {
@@ -47,6 +51,10 @@ class ManagerInterface
      * @brief Implementation for the configure method
      * Request to configure the regulators according to the
      * machine's regulators configuration file.
+     *
+     * Starts a configure job and returns without waiting for it.  The
+     * ConfigureProgress and ConfigureCompleted signals report the progress
+     * and the result of the job.
      */
     virtual void configure() = 0;
 
@@ -59,6 +67,175 @@ class ManagerInterface
      */
     virtual void monitor(bool enable) = 0;
 
+    /**
+     * @brief Implementation for the EnableI2CStats method
+     * Enable or disable collecting I2C transaction statistics for the
+     * regulator devices.
+     *
+     * @param[in] enable - Enable or disable I2C statistics.
+     */
+    virtual void enableI2CStats(bool enable) = 0;
+
+    /**
+     * @brief Implementation for the GetI2CStats method
+     * Get the I2C transaction statistics of the regulator devices.
+     *
+     * @return Statistics text
+     */
+    virtual std::string getI2CStats() = 0;
+
+    /**
+     * @brief Implementation for the GetMemoryUsage method
+     * Get the heap memory used by each subsystem.
+     *
+     * @param[in] resetPeaks - Reset the peak memory usage after getting it.
+     *
+     * @return Memory usage text
+     */
+    virtual std::string getMemoryUsage(bool resetPeaks) = 0;
+
+    /**
+     * @brief Implementation for the EnableRuleProfiling method
+     * Enable or disable profiling the rules and actions.
+     *
+     * @param[in] enable - Enable or disable rule profiling.
+     */
+    virtual void enableRuleProfiling(bool enable) = 0;
+
+    /**
+     * @brief Implementation for the GetRuleProfile method
+     * Get the profile of the rules and actions.
+     *
+     * @param[in] folded - Get the folded call stacks instead of the
+     *                     statistics of each rule and action type.
+     *
+     * @return Profile text
+     */
+    virtual std::string getRuleProfile(bool folded) = 0;
+
+    /**
+     * @brief Implementation for the GetRailStats method
+     * Get the sensor read time statistics of the voltage rails.
+     *
+     * @return Statistics text
+     */
+    virtual std::string getRailStats() = 0;
+
+    /**
+     * @brief Implementation for the Benchmark method
+     * Run back-to-back sensor monitoring cycles and get the throughput and
+     * cycle time distribution.
+     *
+     * @param[in] count - Number of sensor monitoring cycles to run.
+     *
+     * @return Benchmark results text
+     */
+    virtual std::string benchmark(uint32_t count) = 0;
+
+    /**
+     * @brief Implementation for the HandleAlert method
+     * Check the regulator devices asserting SMBALERT# on an I2C bus.
+     *
+     * @param[in] bus - I2C bus whose SMBALERT# line was asserted.
+     *
+     * @return Addresses of the devices that responded to the Alert Response
+     *         Address
+     */
+    virtual std::vector<uint8_t> handleAlert(uint8_t bus) = 0;
+
+    /**
+     * @brief Current value of one sensor in a GetAllSensors reply
+     *
+     * Contains the sensor name, the status ("ok", "error", "unavailable" or
+     * "removed"), the value and the time the value or status was last set
+     * in microseconds since the epoch.
+     */
+    using SensorValue = std::tuple<std::string, std::string, double, uint64_t>;
+
+    /**
+     * @brief Implementation for the GetAllSensors method
+     * Get the current values of all the sensors in one reply.
+     *
+     * @param[in] since - Sequence number from a previous reply, to get only
+     *                    the sensors that changed after it, or 0 to get all
+     *                    the sensors.
+     *
+     * @return Current sequence number and the sensor values
+     */
+    virtual std::tuple<uint64_t, std::vector<SensorValue>>
+        getAllSensors(uint64_t since) = 0;
+
+    /**
+     * @brief One value of a sensor in a GetSensorHistory reply
+     *
+     * Contains the time the value was read in microseconds since the epoch
+     * and the value.  A NaN value marks a gap in the history.
+     */
+    using SensorHistoryValue = std::tuple<uint64_t, double>;
+
+    /**
+     * @brief Implementation for the GetSensorHistory method
+     * Get the recent values of one sensor, oldest first.
+     *
+     * @param[in] name - Sensor name, such as "vdd1_vout".
+     * @param[in] since - Earliest time to return in microseconds since the
+     *                    epoch, or 0 to get all the stored values.
+     *
+     * @return Sensor values
+     */
+    virtual std::vector<SensorHistoryValue>
+        getSensorHistory(const std::string& name, uint64_t since) = 0;
+
+    /**
+     * @brief Implementation for the SetRailVolts method
+     * Set the output voltage of a rail at runtime.
+     *
+     * @param[in] rail - Rail ID, such as "vdd1".
+     * @param[in] volts - Volts value.
+     */
+    virtual void setRailVolts(const std::string& rail, double volts) = 0;
+
+    /**
+     * @brief Emits the ConfigureProgress signal
+     * Sent when the regulators in a chassis have been configured by the
+     * configure job.
+     *
+     * @param[in] chassisNumber - Chassis number.
+     * @param[in] configuredCount - Number of chassis configured so far.
+     * @param[in] chassisCount - Number of chassis to configure.
+     * @param[in] errorCount - Number of errors configuring the chassis.
+     * @param[in] duration - Time taken to configure the chassis in
+     *                       microseconds.
+     */
+    void emitConfigureProgressSignal(uint32_t chassisNumber,
+                                     uint32_t configuredCount,
+                                     uint32_t chassisCount, uint32_t errorCount,
+                                     uint64_t duration);
+
+    /**
+     * @brief Emits the ConfigureCompleted signal
+     * Sent when the configure job has finished.
+     *
+     * @param[in] success - Whether the configuration file was loaded and
+     *                      used to configure the regulators.
+     * @param[in] errorCount - Number of errors configuring the regulators.
+     * @param[in] phaseTimes - Time taken by each phase of the job in
+     *                         microseconds.
+     */
+    void emitConfigureCompletedSignal(
+        bool success, uint32_t errorCount,
+        const std::map<std::string, uint64_t>& phaseTimes);
+
+    /**
+     * @brief Emits the PowerDomainConfigured signal
+     * Sent when the regulators in a power domain have been configured.
+     *
+     * @param[in] name - Power domain name.
+     * @param[in] success - Whether the regulators were configured.
+     */
+    void emitPowerDomainConfiguredSignal(const std::string& name,
+                                         bool success);
+
     /**
      * @brief This dbus interface's name
      */
@@ -78,6 +255,72 @@ class ManagerInterface
     static int callbackMonitor(sd_bus_message* msg, void* context,
                                sd_bus_error* error);
 
+    /**
+     * @brief Systemd bus callback for the EnableI2CStats method
+     */
+    static int callbackEnableI2CStats(sd_bus_message* msg, void* context,
+                                      sd_bus_error* error);
+
+    /**
+     * @brief Systemd bus callback for the GetI2CStats method
+     */
+    static int callbackGetI2CStats(sd_bus_message* msg, void* context,
+                                   sd_bus_error* error);
+
+    /**
+     * @brief Systemd bus callback for the GetMemoryUsage method
+     */
+    static int callbackGetMemoryUsage(sd_bus_message* msg, void* context,
+                                      sd_bus_error* error);
+
+    /**
+     * @brief Systemd bus callback for the EnableRuleProfiling method
+     */
+    static int callbackEnableRuleProfiling(sd_bus_message* msg, void* context,
+                                           sd_bus_error* error);
+
+    /**
+     * @brief Systemd bus callback for the GetRuleProfile method
+     */
+    static int callbackGetRuleProfile(sd_bus_message* msg, void* context,
+                                      sd_bus_error* error);
+
+    /**
+     * @brief Systemd bus callback for the GetRailStats method
+     */
+    static int callbackGetRailStats(sd_bus_message* msg, void* context,
+                                    sd_bus_error* error);
+
+    /**
+     * @brief Systemd bus callback for the Benchmark method
+     */
+    static int callbackBenchmark(sd_bus_message* msg, void* context,
+                                 sd_bus_error* error);
+
+    /**
+     * @brief Systemd bus callback for the HandleAlert method
+     */
+    static int callbackHandleAlert(sd_bus_message* msg, void* context,
+                                   sd_bus_error* error);
+
+    /**
+     * @brief Systemd bus callback for the GetAllSensors method
+     */
+    static int callbackGetAllSensors(sd_bus_message* msg, void* context,
+                                     sd_bus_error* error);
+
+    /**
+     * @brief Systemd bus callback for the GetSensorHistory method
+     */
+    static int callbackGetSensorHistory(sd_bus_message* msg, void* context,
+                                        sd_bus_error* error);
+
+    /**
+     * @brief Systemd bus callback for the SetRailVolts method
+     */
+    static int callbackSetRailVolts(sd_bus_message* msg, void* context,
+                                    sd_bus_error* error);
+
     /**
      * @brief Systemd vtable structure that contains all the
      * methods, signals, and properties of this interface with their
@@ -0,0 +1,60 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <sdbusplus/message/types.hpp>
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <tuple>
+#include <variant>
+#include <vector>
+
+namespace phosphor::power::regulators
+{
+
+/**
+ * Value of a D-Bus property on an inventory object.
+ *
+ * Contains the property types used by the inventory manager.  A
+ * GetManagedObjects reply containing any other type cannot be read.
+ */
+using InventoryValue =
+    std::variant<bool, uint8_t, int16_t, uint16_t, int32_t, uint32_t, int64_t,
+                 uint64_t, double, std::string, std::vector<uint8_t>,
+                 std::vector<std::string>,
+                 std::vector<std::tuple<std::string, std::string, std::string>>,
+                 sdbusplus::message::object_path>;
+
+/**
+ * Map from property names to values.
+ */
+using InventoryProperties = std::map<std::string, InventoryValue>;
+
+/**
+ * Map from interface names to properties.
+ */
+using InventoryInterfaces = std::map<std::string, InventoryProperties>;
+
+/**
+ * Map from inventory object paths to interfaces.  This is the result of the
+ * inventory manager GetManagedObjects method.
+ */
+using InventoryObjects =
+    std::map<sdbusplus::message::object_path, InventoryInterfaces>;
+
+} // namespace phosphor::power::regulators
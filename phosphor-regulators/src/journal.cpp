@@ -16,12 +16,16 @@
 
 #include "journal.hpp"
 
+#include <phosphor-logging/log.hpp>
+
 #include <errno.h>
 #include <stdint.h>
 #include <string.h>
 #include <time.h>
 
+#include <algorithm>
 #include <chrono>
+#include <cstdlib>
 #include <stdexcept>
 #include <thread>
 
@@ -55,14 +59,112 @@ class JournalCloser
     sd_journal* journal{nullptr};
 };
 
+SystemdJournal::SystemdJournal()
+{
+    writer = std::thread{&SystemdJournal::writeMessages, this};
+}
+
+SystemdJournal::~SystemdJournal()
+{
+    // Write the queued messages and stop the writer thread
+    {
+        std::lock_guard<std::mutex> lock{queueMutex};
+        isStopping = true;
+    }
+    queueChanged.notify_one();
+    writer.join();
+
+    for (auto& [match, cache] : caches)
+    {
+        sd_journal_close(cache.journal);
+    }
+}
+
 std::vector<std::string>
     SystemdJournal::getMessages(const std::string& field,
                                 const std::string& fieldValue, unsigned int max)
 {
+    // Write the messages this object has queued
+    flush();
+
     // Sleep 100ms; otherwise recent journal entries sometimes not available
     using namespace std::chrono_literals;
     std::this_thread::sleep_for(100ms);
 
+    // Read journal directly if more messages are needed than are cached
+    if ((max == 0) || (max > maxCachedMessages))
+    {
+        return readMessages(field, fieldValue, max);
+    }
+
+    // Read new journal entries into the cache
+    std::lock_guard<std::mutex> lock{mutex};
+    MessageCache& cache = getCache(field, fieldValue);
+    updateCache(cache);
+
+    // Copy the newest max messages from the cache
+    auto first = cache.messages.end() -
+                 std::min<std::size_t>(max, cache.messages.size());
+    return std::vector<std::string>{first, cache.messages.end()};
+}
+
+void SystemdJournal::flush()
+{
+    std::unique_lock<std::mutex> lock{queueMutex};
+    queueFlushed.wait(lock, [this] { return queue.empty() && !isWriting; });
+}
+
+std::string SystemdJournal::formatEntry(sd_journal* journal)
+{
+    // Get relevant journal entry fields
+    std::string timeStamp = getTimeStamp(journal);
+    std::string syslogID = getFieldValue(journal, "SYSLOG_IDENTIFIER");
+    std::string pid = getFieldValue(journal, "_PID");
+    std::string message = getFieldValue(journal, "MESSAGE");
+
+    // Build one line string containing field values
+    return timeStamp + " " + syslogID + "[" + pid + "]: " + message;
+}
+
+SystemdJournal::MessageCache&
+    SystemdJournal::getCache(const std::string& field,
+                             const std::string& fieldValue)
+{
+    std::string match{field + '=' + fieldValue};
+    auto it = caches.find(match);
+    if (it != caches.end())
+    {
+        return it->second;
+    }
+
+    // Open the journal
+    sd_journal* journal;
+    int rc = sd_journal_open(&journal, SD_JOURNAL_LOCAL_ONLY);
+    if (rc < 0)
+    {
+        throw std::runtime_error{std::string{"Failed to open journal: "} +
+                                 strerror(-rc)};
+    }
+
+    // Add match so we only loop over entries with specified field value
+    rc = sd_journal_add_match(journal, match.c_str(), 0);
+    if (rc < 0)
+    {
+        sd_journal_close(journal);
+        throw std::runtime_error{std::string{"Failed to add journal match: "} +
+                                 strerror(-rc)};
+    }
+
+    MessageCache& cache = caches[match];
+    cache.journal = journal;
+    return cache;
+}
+
+std::vector<std::string>
+    SystemdJournal::readMessages(const std::string& field,
+                                 const std::string& fieldValue,
+                                 unsigned int max)
+{
     // Open the journal
     sd_journal* journal;
     int rc = sd_journal_open(&journal, SD_JOURNAL_LOCAL_ONLY);
@@ -87,18 +189,9 @@ std::vector<std::string>
     // Loop through matching entries from newest to oldest
     std::vector<std::string> messages;
     messages.reserve((max != 0) ? max : 10);
-    std::string syslogID, pid, message, timeStamp, line;
     SD_JOURNAL_FOREACH_BACKWARDS(journal)
     {
-        // Get relevant journal entry fields
-        timeStamp = getTimeStamp(journal);
-        syslogID = getFieldValue(journal, "SYSLOG_IDENTIFIER");
-        pid = getFieldValue(journal, "_PID");
-        message = getFieldValue(journal, "MESSAGE");
-
-        // Build one line string containing field values
-        line = timeStamp + " " + syslogID + "[" + pid + "]: " + message;
-        messages.emplace(messages.begin(), line);
+        messages.emplace(messages.begin(), formatEntry(journal));
 
         // Stop looping if a max was specified and we have reached it
         if ((max != 0) && (messages.size() >= max))
@@ -110,6 +203,98 @@ std::vector<std::string>
     return messages;
 }
 
+void SystemdJournal::updateCache(MessageCache& cache)
+{
+    sd_journal* journal = cache.journal;
+    try
+    {
+        // Pick up journal files that were added or rotated since last read
+        int rc = sd_journal_process(journal);
+        if (rc < 0)
+        {
+            throw std::runtime_error{
+                std::string{"Failed to process journal changes: "} +
+                strerror(-rc)};
+        }
+
+        // Position on the newest entry read previously.  The entry may no
+        // longer exist if the journal was vacuumed.
+        bool isPositioned{false};
+        if (!cache.cursor.empty() &&
+            (sd_journal_seek_cursor(journal, cache.cursor.c_str()) >= 0) &&
+            (sd_journal_next(journal) > 0) &&
+            (sd_journal_test_cursor(journal, cache.cursor.c_str()) > 0))
+        {
+            isPositioned = true;
+        }
+
+        if (isPositioned)
+        {
+            // Read entries newer than the cursor from oldest to newest
+            bool wasEntryRead{false};
+            while (sd_journal_next(journal) > 0)
+            {
+                cache.messages.emplace_back(formatEntry(journal));
+                if (cache.messages.size() > maxCachedMessages)
+                {
+                    cache.messages.pop_front();
+                }
+                wasEntryRead = true;
+            }
+
+            // Save cursor of the newest entry.  The journal remains
+            // positioned on it after sd_journal_next() reaches the end.
+            if (wasEntryRead)
+            {
+                cache.cursor = getCursor(journal);
+            }
+        }
+        else
+        {
+            // Read the newest entries from newest to oldest
+            cache.cursor.clear();
+            cache.messages.clear();
+            SD_JOURNAL_FOREACH_BACKWARDS(journal)
+            {
+                // Save cursor of the newest entry
+                if (cache.cursor.empty())
+                {
+                    cache.cursor = getCursor(journal);
+                }
+
+                cache.messages.emplace_front(formatEntry(journal));
+                if (cache.messages.size() >= maxCachedMessages)
+                {
+                    break;
+                }
+            }
+        }
+    }
+    catch (...)
+    {
+        // Read the cache again from the end of the journal next time
+        cache.cursor.clear();
+        cache.messages.clear();
+        throw;
+    }
+}
+
+std::string SystemdJournal::getCursor(sd_journal* journal)
+{
+    char* cursor{nullptr};
+    int rc = sd_journal_get_cursor(journal, &cursor);
+    if (rc < 0)
+    {
+        throw std::runtime_error{
+            std::string{"Failed to get journal entry cursor: "} +
+            strerror(-rc)};
+    }
+
+    std::string value{cursor};
+    free(cursor);
+    return value;
+}
+
 std::string SystemdJournal::getFieldValue(sd_journal* journal,
                                           const std::string& field)
 {
@@ -146,6 +331,101 @@ std::string SystemdJournal::getFieldValue(sd_journal* journal,
     return value;
 }
 
+void SystemdJournal::queueMessages(int priority, const std::string* messages,
+                                   std::size_t count)
+{
+    {
+        std::lock_guard<std::mutex> lock{queueMutex};
+        auto now = JournalRateLimiter::Clock::now();
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            std::size_t suppressed{0};
+            if (!rateLimiter.allow(messages[i], now, suppressed))
+            {
+                continue;
+            }
+
+            // Room is needed for the message and any suppressed message
+            // count
+            std::size_t needed = (suppressed > 0) ? 2 : 1;
+            if ((queue.size() + needed) > maxQueuedMessages)
+            {
+                ++droppedCount;
+                continue;
+            }
+
+            if (suppressed > 0)
+            {
+                queue.push_back(QueuedMessage{
+                    priority, "Suppressed " + std::to_string(suppressed) +
+                                  " repeats of message: " + messages[i]});
+            }
+            queue.push_back(QueuedMessage{priority, messages[i]});
+        }
+    }
+    queueChanged.notify_one();
+}
+
+void SystemdJournal::writeMessages()
+{
+    std::vector<QueuedMessage> messages{};
+    std::unique_lock<std::mutex> lock{queueMutex};
+    while (true)
+    {
+        queueChanged.wait(lock, [this] {
+            return !queue.empty() || (droppedCount > 0) || isStopping;
+        });
+        if (queue.empty() && (droppedCount == 0))
+        {
+            // Stopping and all messages have been written
+            break;
+        }
+
+        // Write the messages without holding the lock, so callers can
+        // queue more messages in the meantime
+        messages.swap(queue);
+        std::size_t dropped = droppedCount;
+        droppedCount = 0;
+        isWriting = true;
+        lock.unlock();
+
+        for (const QueuedMessage& queued : messages)
+        {
+            writeMessage(queued.priority, queued.message);
+        }
+        if (dropped > 0)
+        {
+            writeMessage(LOG_ERR, "Dropped " + std::to_string(dropped) +
+                                      " journal messages; queue was full");
+        }
+        messages.clear();
+
+        lock.lock();
+        isWriting = false;
+        if (queue.empty() && (droppedCount == 0))
+        {
+            queueFlushed.notify_all();
+        }
+    }
+}
+
+void SystemdJournal::writeMessage(int priority, const std::string& message)
+{
+    using namespace phosphor::logging;
+    switch (priority)
+    {
+        case LOG_DEBUG:
+            log<level::DEBUG>(message.c_str());
+            break;
+        case LOG_INFO:
+            log<level::INFO>(message.c_str());
+            break;
+        default:
+            log<level::ERR>(message.c_str());
+            break;
+    }
+}
+
 std::string SystemdJournal::getTimeStamp(sd_journal* journal)
 {
     // Get realtime (wallclock) timestamp of current journal entry.  The
@@ -15,16 +15,38 @@
  */
 #pragma once
 
-#include <systemd/sd-journal.h>
+#include "exception_utils.hpp"
+#include "journal_rate_limiter.hpp"
 
-#include <phosphor-logging/log.hpp>
+#include <syslog.h>
+#include <systemd/sd-journal.h>
 
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <map>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
+// Debug messages are compiled out when the build sets this to 0
+#ifndef REGULATORS_JOURNAL_DEBUG
+#define REGULATORS_JOURNAL_DEBUG 1
+#endif
+
 namespace phosphor::power::regulators
 {
 
+/**
+ * Whether debug messages are logged in the journal.
+ *
+ * Callers that build a debug message only to log it check this with
+ * `if constexpr`, so building the message is compiled out when debug
+ * messages are disabled.
+ */
+constexpr bool isJournalDebugEnabled{REGULATORS_JOURNAL_DEBUG != 0};
+
 /**
  * @class Journal
  *
@@ -87,6 +109,20 @@ class Journal
      */
     virtual void logError(const std::vector<std::string>& messages) = 0;
 
+    /**
+     * Logs the error messages from an exception and any nested inner
+     * exceptions in the system journal.
+     *
+     * The messages are only copied out of the exceptions here, when they are
+     * logged.
+     *
+     * @param messages view of the error messages to log
+     */
+    void logError(const exception_utils::MessageView& messages)
+    {
+        logError(messages.toVector());
+    }
+
     /**
      * Logs an informational message in the system journal.
      *
@@ -106,17 +142,27 @@ class Journal
  * @class SystemdJournal
  *
  * Implementation of the Journal interface that writes to the systemd journal.
+ *
+ * getMessages() keeps a journal handle open for each field value it is called
+ * with, along with the cursor of the newest entry read and the most recent
+ * formatted messages.  Later calls only read the entries added since then.
+ *
+ * Logged messages are queued and written to the journal by a separate writer
+ * thread, so the callers do not wait for the journal I/O.  getMessages()
+ * first waits for the queued messages to be written.  The same message is
+ * only written a limited number of times per interval; see
+ * JournalRateLimiter.
  */
 class SystemdJournal : public Journal
 {
   public:
     // Specify which compiler-generated methods we want
-    SystemdJournal() = default;
+    SystemdJournal();
     SystemdJournal(const SystemdJournal&) = delete;
     SystemdJournal(SystemdJournal&&) = delete;
     SystemdJournal& operator=(const SystemdJournal&) = delete;
     SystemdJournal& operator=(SystemdJournal&&) = delete;
-    virtual ~SystemdJournal() = default;
+    virtual ~SystemdJournal();
 
     /** @copydoc Journal::getMessages() */
     virtual std::vector<std::string> getMessages(const std::string& field,
@@ -126,52 +172,114 @@ class SystemdJournal : public Journal
     /** @copydoc Journal::logDebug(const std::string&) */
     virtual void logDebug(const std::string& message) override
     {
-        using namespace phosphor::logging;
-        log<level::DEBUG>(message.c_str());
+        if constexpr (isJournalDebugEnabled)
+        {
+            queueMessages(LOG_DEBUG, &message, 1);
+        }
     }
 
     /** @copydoc Journal::logDebug(const std::vector<std::string>&) */
     virtual void logDebug(const std::vector<std::string>& messages) override
     {
-        for (const std::string& message : messages)
+        if constexpr (isJournalDebugEnabled)
         {
-            logDebug(message);
+            queueMessages(LOG_DEBUG, messages.data(), messages.size());
         }
     }
 
+    // Do not hide the Journal::logError(const MessageView&) overload
+    using Journal::logError;
+
     /** @copydoc Journal::logError(const std::string&) */
     virtual void logError(const std::string& message) override
     {
-        using namespace phosphor::logging;
-        log<level::ERR>(message.c_str());
+        queueMessages(LOG_ERR, &message, 1);
     }
 
     /** @copydoc Journal::logError(const std::vector<std::string>&) */
     virtual void logError(const std::vector<std::string>& messages) override
     {
-        for (const std::string& message : messages)
-        {
-            logError(message);
-        }
+        queueMessages(LOG_ERR, messages.data(), messages.size());
     }
 
     /** @copydoc Journal::logInfo(const std::string&) */
     virtual void logInfo(const std::string& message) override
     {
-        using namespace phosphor::logging;
-        log<level::INFO>(message.c_str());
+        queueMessages(LOG_INFO, &message, 1);
     }
 
     /** @copydoc Journal::logInfo(const std::vector<std::string>&) */
     virtual void logInfo(const std::vector<std::string>& messages) override
     {
-        for (const std::string& message : messages)
-        {
-            logInfo(message);
-        }
+        queueMessages(LOG_INFO, messages.data(), messages.size());
     }
 
+    /**
+     * Waits until the queued messages have been written to the journal.
+     */
+    void flush();
+
   private:
+    /**
+     * Maximum number of messages cached for each field value.
+     *
+     * Calls to getMessages() with a larger max, or with max 0, read the
+     * journal directly.
+     */
+    static constexpr std::size_t maxCachedMessages{100};
+
+    /**
+     * Recent journal messages that have one field value.
+     */
+    struct MessageCache
+    {
+        /**
+         * Journal handle with a match for the field value.
+         */
+        sd_journal* journal{nullptr};
+
+        /**
+         * Cursor of the newest entry read, or empty if none have been read.
+         */
+        std::string cursor{};
+
+        /**
+         * Most recent messages, from oldest to newest.
+         */
+        std::deque<std::string> messages{};
+    };
+
+    /**
+     * Formats the current journal entry as a one line message.
+     *
+     * @param journal current journal entry
+     * @return message
+     */
+    std::string formatEntry(sd_journal* journal);
+
+    /**
+     * Gets the message cache for the specified field value, opening a journal
+     * handle for it if necessary.
+     *
+     * Throws an exception if an error occurs.
+     *
+     * @param field journal field name
+     * @param fieldValue field value
+     * @return message cache
+     */
+    MessageCache& getCache(const std::string& field,
+                           const std::string& fieldValue);
+
+    /**
+     * Gets the cursor of the current journal entry.
+     *
+     * Throws an exception if an error occurs.
+     *
+     * @param journal current journal entry
+     * @return cursor string
+     */
+    std::string getCursor(sd_journal* journal);
+
     /**
      * Gets the value of the specified field for the current journal entry.
      *
@@ -191,6 +299,138 @@ class SystemdJournal : public Journal
      * @return timestamp as a date/time string
      */
     std::string getTimeStamp(sd_journal* journal);
+
+    /**
+     * Reads the journal messages that have the specified field value without
+     * using a message cache.
+     *
+     * @param field journal field name
+     * @param fieldValue field value
+     * @param max Maximum number of messages to return.  Specify 0 to return
+     *            all matching messages.
+     * @return matching messages, from oldest to newest
+     */
+    std::vector<std::string> readMessages(const std::string& field,
+                                          const std::string& fieldValue,
+                                          unsigned int max);
+
+    /**
+     * Reads the journal entries added since the cache was last updated.
+     *
+     * Throws an exception if an error occurs.
+     *
+     * @param cache message cache to update
+     */
+    void updateCache(MessageCache& cache);
+
+    /**
+     * Maximum number of messages waiting to be written.  Messages logged
+     * while the queue is full are dropped and counted.
+     */
+    static constexpr std::size_t maxQueuedMessages{1000};
+
+    /**
+     * A message waiting to be written to the journal.
+     */
+    struct QueuedMessage
+    {
+        /**
+         * Syslog priority, such as LOG_ERR.
+         */
+        int priority;
+
+        /**
+         * Message text.
+         */
+        std::string message;
+    };
+
+    /**
+     * Queues messages to be written by the writer thread.
+     *
+     * Messages suppressed by the rate limiter are not queued.
+     *
+     * @param priority syslog priority, such as LOG_ERR
+     * @param messages messages to queue
+     * @param count number of messages
+     */
+    void queueMessages(int priority, const std::string* messages,
+                       std::size_t count);
+
+    /**
+     * Writes the queued messages to the journal until the object is
+     * destroyed.  Runs on the writer thread.
+     */
+    void writeMessages();
+
+    /**
+     * Writes a message to the journal.
+     *
+     * @param priority syslog priority, such as LOG_ERR
+     * @param message message text
+     */
+    static void writeMessage(int priority, const std::string& message);
+
+    /**
+     * Message caches, by match string "FIELD=value".
+     */
+    std::map<std::string, MessageCache> caches{};
+
+    /**
+     * Mutex that protects the message caches.  getMessages() may be called
+     * from more than one thread.
+     */
+    std::mutex mutex{};
+
+    /**
+     * Mutex that protects the members below.  Messages may be logged from
+     * more than one thread.
+     */
+    std::mutex queueMutex{};
+
+    /**
+     * Notified when messages are queued or the writer thread must stop.
+     */
+    std::condition_variable queueChanged{};
+
+    /**
+     * Notified when the writer thread has written all of the queued
+     * messages.
+     */
+    std::condition_variable queueFlushed{};
+
+    /**
+     * Messages waiting to be written, from oldest to newest.
+     */
+    std::vector<QueuedMessage> queue{};
+
+    /**
+     * True while the writer thread is writing messages it removed from the
+     * queue.
+     */
+    bool isWriting{false};
+
+    /**
+     * True when the writer thread must stop.
+     */
+    bool isStopping{false};
+
+    /**
+     * Number of messages dropped because the queue was full, since the last
+     * report of dropped messages.
+     */
+    std::size_t droppedCount{0};
+
+    /**
+     * Limits how often the same message is written.
+     */
+    JournalRateLimiter rateLimiter{};
+
+    /**
+     * Thread that writes the queued messages to the journal, so the journal
+     * I/O is not done by the threads that log them.
+     */
+    std::thread writer{};
 };
 
 } // namespace phosphor::power::regulators
@@ -0,0 +1,75 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "journal_rate_limiter.hpp"
+
+namespace phosphor::power::regulators
+{
+
+bool JournalRateLimiter::allow(const std::string& message,
+                               Clock::time_point now, std::size_t& suppressed)
+{
+    suppressed = 0;
+
+    auto it = messages.find(message);
+    if (it != messages.end())
+    {
+        Entry& entry = it->second;
+        if ((now - entry.start) < interval)
+        {
+            // Same interval; log the message until the burst is used up
+            if (entry.count < burst)
+            {
+                ++entry.count;
+                return true;
+            }
+            ++entry.suppressed;
+            return false;
+        }
+
+        // New interval; report what was suppressed in the previous one
+        suppressed = entry.suppressed;
+        entry = Entry{now, 1, 0};
+        return true;
+    }
+
+    if (messages.size() >= maxMessages)
+    {
+        removeExpired(now);
+    }
+    if (messages.size() < maxMessages)
+    {
+        messages.emplace(message, Entry{now, 1, 0});
+    }
+    return true;
+}
+
+void JournalRateLimiter::removeExpired(Clock::time_point now)
+{
+    for (auto it = messages.begin(); it != messages.end();)
+    {
+        if ((now - it->second.start) >= interval)
+        {
+            it = messages.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+} // namespace phosphor::power::regulators
@@ -0,0 +1,157 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <map>
+#include <string>
+
+namespace phosphor::power::regulators
+{
+
+/**
+ * @class JournalRateLimiter
+ *
+ * Limits how often the same journal message is logged.
+ *
+ * Each distinct message text may be logged a number of times (the burst) in
+ * an interval.  Further occurrences in that interval are suppressed and
+ * counted.  The first occurrence in a later interval is logged again, and
+ * returns the number of occurrences that were suppressed.
+ *
+ * The number of distinct messages tracked is limited.  When the limit is
+ * reached, messages whose interval has ended are forgotten.  If there are
+ * still too many, new messages are logged without being tracked.
+ *
+ * This class is not thread safe.
+ */
+class JournalRateLimiter
+{
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * Default number of times a message may be logged in an interval.
+     */
+    static constexpr std::size_t defaultBurst{10};
+
+    /**
+     * Default interval.
+     */
+    static constexpr Clock::duration defaultInterval{std::chrono::minutes{1}};
+
+    /**
+     * Default maximum number of distinct messages tracked.
+     */
+    static constexpr std::size_t defaultMaxMessages{256};
+
+    // Specify which compiler-generated methods we want
+    JournalRateLimiter(const JournalRateLimiter&) = delete;
+    JournalRateLimiter(JournalRateLimiter&&) = delete;
+    JournalRateLimiter& operator=(const JournalRateLimiter&) = delete;
+    JournalRateLimiter& operator=(JournalRateLimiter&&) = delete;
+    ~JournalRateLimiter() = default;
+
+    /**
+     * Constructor.
+     *
+     * @param burst number of times a message may be logged in an interval
+     * @param interval interval length
+     * @param maxMessages maximum number of distinct messages tracked
+     */
+    explicit JournalRateLimiter(std::size_t burst = defaultBurst,
+                                Clock::duration interval = defaultInterval,
+                                std::size_t maxMessages = defaultMaxMessages) :
+        burst{burst},
+        interval{interval}, maxMessages{maxMessages}
+    {}
+
+    /**
+     * Returns whether the specified message may be logged now.
+     *
+     * @param message message text
+     * @param now current time
+     * @param suppressed set to the number of occurrences of the message that
+     *                   were suppressed in its previous interval, if this is
+     *                   the first occurrence in a new interval.  Otherwise
+     *                   set to 0.
+     * @return true if the message may be logged, false if it is suppressed
+     */
+    bool allow(const std::string& message, Clock::time_point now,
+               std::size_t& suppressed);
+
+    /**
+     * Returns the number of distinct messages being tracked.
+     *
+     * @return number of messages
+     */
+    std::size_t getMessageCount() const
+    {
+        return messages.size();
+    }
+
+  private:
+    /**
+     * Occurrences of one message in its current interval.
+     */
+    struct Entry
+    {
+        /**
+         * Start of the interval.
+         */
+        Clock::time_point start{};
+
+        /**
+         * Number of times the message was logged in the interval.
+         */
+        std::size_t count{0};
+
+        /**
+         * Number of times the message was suppressed in the interval.
+         */
+        std::size_t suppressed{0};
+    };
+
+    /**
+     * Forgets the messages whose interval has ended.
+     *
+     * @param now current time
+     */
+    void removeExpired(Clock::time_point now);
+
+    /**
+     * Number of times a message may be logged in an interval.
+     */
+    const std::size_t burst;
+
+    /**
+     * Interval length.
+     */
+    const Clock::duration interval;
+
+    /**
+     * Maximum number of distinct messages tracked.
+     */
+    const std::size_t maxMessages;
+
+    /**
+     * Messages being tracked, by message text.
+     */
+    std::map<std::string, Entry> messages{};
+};
+
+} // namespace phosphor::power::regulators
@@ -14,18 +14,44 @@
  * limitations under the License.
  */
 
+#include "bus_trace.hpp"
 #include "manager.hpp"
+#include "startup_times.hpp"
 
+#include <CLI/CLI.hpp>
+#include <phosphor-logging/log.hpp>
 #include <sdbusplus/bus.hpp>
 #include <sdeventplus/event.hpp>
 #include <sdeventplus/source/signal.hpp>
 #include <stdplus/signal.hpp>
 
+#include <exception>
 #include <functional>
+#include <string>
 
-int main(void)
+int main(int argc, char** argv)
 {
     using namespace phosphor::power;
+    using namespace phosphor::logging;
+
+    CLI::App app{"OpenBMC voltage regulator manager"};
+    std::string busTrace{};
+    app.add_option("--bus-trace", busTrace,
+                   "File to record the I2C transactions in, so they can be "
+                   "replayed by the benchmarks");
+    CLI11_PARSE(app, argc, argv);
+
+    if (!busTrace.empty())
+    {
+        try
+        {
+            i2c::startTrace(busTrace);
+        }
+        catch (const std::exception& e)
+        {
+            log<level::ERR>(e.what());
+        }
+    }
 
     auto bus = sdbusplus::bus::new_default();
     auto event = sdeventplus::Event::get_default();
@@ -40,5 +66,10 @@ int main(void)
         std::bind(&regulators::Manager::sighupHandler, &manager,
                   std::placeholders::_1, std::placeholders::_2));
 
-    return event.loop();
+    // Tell systemd when the manager is ready
+    util::notifyReady({{"phosphor-regulators", &manager.getStartupTimes()}});
+
+    int rc = event.loop();
+    i2c::stopTrace();
+    return rc;
 }
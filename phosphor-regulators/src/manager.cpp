@@ -16,24 +16,44 @@
 
 #include "manager.hpp"
 
+#include "bus_budget.hpp"
 #include "chassis.hpp"
 #include "config_file_parser.hpp"
+#include "config_reload.hpp"
 #include "exception_utils.hpp"
+#include "i2c_interface.hpp"
+#include "memory_accounting.hpp"
+#include "rail.hpp"
 #include "rule.hpp"
+#include "rule_profiler.hpp"
+#include "sensor_history.hpp"
+#include "sensor_monitoring.hpp"
+#include "trace.hpp"
+#include "types.hpp"
 #include "utility.hpp"
 
+#include <nlohmann/json.hpp>
 #include <xyz/openbmc_project/Common/error.hpp>
 #include <xyz/openbmc_project/State/Chassis/server.hpp>
 
 #include <algorithm>
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <exception>
 #include <functional>
 #include <map>
+#include <numeric>
+#include <optional>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <system_error>
 #include <thread>
 #include <tuple>
 #include <utility>
 #include <variant>
+#include <vector>
 
 namespace phosphor::power::regulators
 {
@@ -50,6 +70,36 @@ constexpr auto chassisStateIntf = "xyz.openbmc_project.State.Chassis";
 constexpr auto chassisStateProp = "CurrentPowerState";
 constexpr std::chrono::minutes maxTimeToWaitForCompatTypes{5};
 
+/**
+ * Interval at which phase faults are detected in each regulator device.
+ */
+constexpr std::chrono::seconds phaseFaultInterval{15};
+
+/**
+ * Number of phase fault detection timer ticks per interval.  The regulator
+ * devices are spread across the ticks to avoid bursts of I2C traffic.
+ */
+constexpr std::size_t phaseFaultSliceCount{15};
+
+/**
+ * Interval at which the I2C devices that have been idle for their idle timeout
+ * are closed.
+ */
+constexpr std::chrono::seconds idleDeviceInterval{10};
+
+/**
+ * Interval at which the state is saved for the next instance of the
+ * application.  Well below the maximum age of a restored state, so a restart
+ * at any time finds a recent one.
+ */
+constexpr std::chrono::seconds stateHandoffInterval{10};
+
+/**
+ * Version of the format of the saved state.  Must be changed when the state
+ * saved by an older version of the application can no longer be restored.
+ */
+constexpr uint32_t stateFormatVersion{1};
+
 using PowerState =
     sdbusplus::xyz::openbmc_project::State::server::Chassis::PowerState;
 
@@ -71,12 +121,86 @@ const fs::path standardConfigFileDir{"/usr/share/phosphor-regulators"};
  */
 const fs::path testConfigFileDir{"/etc/phosphor-regulators"};
 
+/**
+ * Configuration file cache directory.  This directory contains a binary cache
+ * of the parsed config file that is used to improve startup performance.
+ */
+const fs::path configFileCacheDir{"/var/lib/phosphor-regulators"};
+
+/**
+ * Minimum size of a config file that is parsed without creating a tree of
+ * JSON elements for the entire file.  Parsing large config files this way
+ * reduces the peak memory usage at startup.  The Chassis objects are only
+ * created for chassis that are present.  The binary cache file is not used for
+ * these files because it contains the entire tree.
+ */
+constexpr std::uintmax_t streamingParseMinFileSize{1024 * 1024};
+
+/**
+ * Returns the maximum number of worker threads used to parse the rules and
+ * chassis in a config file.  Uses one thread for each processor.
+ */
+static unsigned int getParseThreadCount()
+{
+    return std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+/**
+ * Logs an error for each I2C bus that a chassis with independent monitoring
+ * shares with another chassis.
+ *
+ * The devices of a chassis with independent monitoring are read on its own
+ * worker thread, so a slow or failing bus shared with another chassis still
+ * delays the monitoring of the other chassis.
+ *
+ * @param services system services like error logging and the journal
+ * @param system system whose chassis are checked
+ */
+static void checkChassisMonitorBuses(Services& services, System& system)
+{
+    std::map<uint8_t, std::set<Chassis*>> busChassis{};
+    for (const std::unique_ptr<Chassis>& chassis : system.getChassis())
+    {
+        for (const std::unique_ptr<Device>& device : chassis->getDevices())
+        {
+            busChassis[device->getI2CInterface().getBus()].insert(
+                chassis.get());
+        }
+    }
+
+    for (const auto& [bus, chassisSet] : busChassis)
+    {
+        if ((chassisSet.size() > 1) &&
+            std::any_of(chassisSet.begin(), chassisSet.end(),
+                        [](Chassis* chassis) {
+                            return chassis->isIndependentMonitoring();
+                        }))
+        {
+            std::string numbers{};
+            for (Chassis* chassis : chassisSet)
+            {
+                numbers += (numbers.empty() ? "" : ", ") +
+                           std::to_string(chassis->getNumber());
+            }
+            services.getJournal().logError(
+                "I2C bus " + std::to_string(bus) +
+                " is shared by chassis " + numbers +
+                ", but a chassis with independent monitoring should not "
+                "share I2C buses with other chassis");
+        }
+    }
+}
+
 Manager::Manager(sdbusplus::bus::bus& bus, const sdeventplus::Event& event) :
     ManagerObject{bus, managerObjPath, true}, bus{bus}, eventLoop{event},
-    services{bus}, phaseFaultTimer{event,
-                                   std::bind(&Manager::phaseFaultTimerExpired,
-                                             this)},
-    sensorTimer{event, std::bind(&Manager::sensorTimerExpired, this)}
+    services{bus}, scheduler{event},
+    stateHandoff{"phosphor-regulators", stateFormatVersion},
+    configureTimer{event, std::bind(&Manager::configureTimerExpired, this)},
+    configureStepTimer{event,
+                       std::bind(&Manager::configureNextChassis, this)},
+    sensorCycleStatsInterface{bus, managerObjPath, sensorCycleStats},
+    startupTimesInterface{bus, managerObjPath, startupTimes},
+    lagMonitor{event}, lagInterface{bus, managerObjPath, lagMonitor.getLag()}
 {
     // Subscribe to D-Bus interfacesAdded signal from Entity Manager.  This
     // notifies us if the compatible interface becomes available later.
@@ -90,10 +214,33 @@ Manager::Manager(sdbusplus::bus::bus& bus, const sdeventplus::Event& event) :
                       std::placeholders::_1));
     signals.emplace_back(std::move(matchPtr));
 
+    // Subscribe to the power sequencer signals used to configure the devices
+    // in power domains while the system is powering on
+    using namespace sdbusplus::bus::match::rules;
+    std::string sequencerMatch{type::signal() + path(POWER_OBJ_PATH) +
+                               interface(POWER_IFACE)};
+    signals.emplace_back(std::make_unique<sdbusplus::bus::match_t>(
+        bus, sequencerMatch + member("RailStateChanged"),
+        std::bind(&Manager::railStateChangedHandler, this,
+                  std::placeholders::_1)));
+    signals.emplace_back(std::make_unique<sdbusplus::bus::match_t>(
+        bus, sequencerMatch + member("PowerGood"),
+        std::bind(&Manager::powerGoodHandler, this, std::placeholders::_1)));
+
+    // Clear cached device presence when the presence of hardware changes
+    services.setPresenceChangeHandler(std::bind(
+        &Manager::presenceChangedHandler, this, std::placeholders::_1));
+
+    // Resume with the state of the previous instance, if it was restarted
+    restoreState();
+
     // Try to find compatible system types using D-Bus compatible interface.
     // Note that it might not be supported on this system, or the service that
     // provides the interface might not be running yet.
-    findCompatibleSystemTypes();
+    if (compatibleSystemTypes.empty())
+    {
+        findCompatibleSystemTypes();
+    }
 
     // Try to find and load the JSON configuration file
     loadConfigFile();
@@ -101,45 +248,108 @@ Manager::Manager(sdbusplus::bus::bus& bus, const sdeventplus::Event& event) :
     // Obtain D-Bus service name
     bus.request_name(busName);
 
+    // Start task that closes the I2C devices that are not being used
+    idleDeviceTask =
+        scheduler.add(idleDeviceInterval, []() { i2c::closeIdleDevices(); });
+
+    // Keep a recent state for the next instance, in case of a crash
+    saveState();
+    stateHandoffTask = scheduler.add(stateHandoffInterval,
+                                     std::bind(&Manager::saveState, this));
+
     // If system is already powered on, enable monitoring
     if (isSystemPoweredOn())
     {
         monitor(true);
     }
+
+    // Ready to handle the configure and monitor requests
+    startupTimes.setReady();
 }
 
 void Manager::configure()
 {
+    util::EventLoopLag::Scope lagScope{lagMonitor.getLag(),
+                                       "Manager::configure"};
+
+    // Calls made while the job is running share the job
+    if (configureJob.isActive)
+    {
+        services.getJournal().logInfo("Configure job already running");
+        return;
+    }
+    configureJob = ConfigureJob{};
+    configureJob.isActive = true;
+    configureJob.startTime = std::chrono::steady_clock::now();
+    configureJob.phaseStartTime = configureJob.startTime;
+
     // Clear any cached data or error history related to hardware devices
     clearHardwareData();
+    endConfigurePhase("clear");
 
-    // Wait until the config file has been loaded or hit max wait time
-    waitUntilConfigFileLoaded();
+    // Wait until the config file has been loaded or hit max wait time.  The
+    // config file is loaded by interfacesAddedHandler() when the compatible
+    // system types become available.
+    configureJob.isWaiting = true;
+    if (!isConfigFileLoaded() && compatibleSystemTypes.empty())
+    {
+        // Try to find list of compatible system types
+        findCompatibleSystemTypes();
+        if (compatibleSystemTypes.empty())
+        {
+            if (!configureTimer.isEnabled())
+            {
+                configureTimer.restartOnce(maxTimeToWaitForCompatTypes);
+            }
+            return;
+        }
 
-    // Verify config file has been loaded and System object is valid
+        // Compatible system types found; try to load config file
+        loadConfigFile();
+    }
+
+    finishConfigure();
+}
+
+std::chrono::milliseconds Manager::getSensorMonitoringInterval() const
+{
+    // Minimum timer interval; matches the minimum rail interval
+    constexpr std::chrono::milliseconds minInterval{100};
+
+    std::chrono::milliseconds::rep interval{0};
     if (isConfigFileLoaded())
     {
-        // Configure the regulator devices in the system
-        system->configure(services);
+        for (const auto& chassis : system->getChassis())
+        {
+            for (const auto& device : chassis->getDevices())
+            {
+                for (const auto& rail : device->getRails())
+                {
+                    const auto& monitoring = rail->getSensorMonitoring();
+                    if (monitoring)
+                    {
+                        interval = std::gcd(interval,
+                                            monitoring->getInterval().count());
+                        interval = std::gcd(
+                            interval, monitoring->getMinInterval().count());
+                    }
+                }
+            }
+        }
     }
-    else
-    {
-        // Write error message to journal
-        services.getJournal().logError("Unable to configure regulator devices: "
-                                       "Configuration file not loaded");
-
-        // Log critical error since regulators could not be configured.  Could
-        // cause hardware damage if default regulator settings are very wrong.
-        services.getErrorLogging().logConfigFileError(Entry::Level::Critical,
-                                                      services.getJournal());
 
-        // Throw InternalFailure to propogate error status to D-Bus client
-        throw sdbusplus::xyz::openbmc_project::Common::Error::InternalFailure{};
+    if (interval == 0)
+    {
+        return SensorMonitoring::defaultInterval;
     }
+    return std::max(std::chrono::milliseconds{interval}, minInterval);
 }
 
 void Manager::interfacesAddedHandler(sdbusplus::message::message& msg)
 {
+    util::EventLoopLag::Scope lagScope{lagMonitor.getLag(),
+                                       "Manager::interfacesAddedHandler"};
+
     // Verify message is valid
     if (!msg)
     {
@@ -176,6 +386,10 @@ void Manager::interfacesAddedHandler(sdbusplus::message::message& msg)
 
                     // Find and load JSON config file based on system types
                     loadConfigFile();
+
+                    // Finish the configure method calls waiting for the
+                    // config file
+                    finishConfigure();
                 }
             }
         }
@@ -187,8 +401,74 @@ void Manager::interfacesAddedHandler(sdbusplus::message::message& msg)
     }
 }
 
+void Manager::powerGoodHandler(sdbusplus::message::message& /*msg*/)
+{
+    util::EventLoopLag::Scope lagScope{lagMonitor.getLag(),
+                                       "Manager::powerGoodHandler"};
+
+    // Power good may have been reached without the power sequencer reporting
+    // the standby rails, such as if the device has no rail states
+    configurePendingPowerDomains();
+}
+
+void Manager::presenceChangedHandler(const std::string& inventoryPath)
+{
+    util::EventLoopLag::Scope lagScope{lagMonitor.getLag(),
+                                       "Manager::presenceChangedHandler"};
+
+    // Verify config file has been loaded and System object is valid
+    if (isConfigFileLoaded())
+    {
+        waitForChassisMonitors();
+        system->clearPresenceCache(inventoryPath);
+    }
+}
+
+void Manager::railStateChangedHandler(sdbusplus::message::message& msg)
+{
+    util::EventLoopLag::Scope lagScope{lagMonitor.getLag(),
+                                       "Manager::railStateChangedHandler"};
+
+    if (!msg || pendingPowerDomains.empty())
+    {
+        return;
+    }
+
+    try
+    {
+        uint32_t id{0};
+        int32_t value{0};
+        msg.read(id, value);
+        if (value == 0)
+        {
+            return;
+        }
+
+        // Find the power domains whose standby rails are now all on
+        std::vector<std::string> readyDomains{};
+        for (auto& [name, rails] : pendingPowerDomains)
+        {
+            if ((rails.erase(id) > 0) && rails.empty())
+            {
+                readyDomains.emplace_back(name);
+            }
+        }
+
+        for (const std::string& name : readyDomains)
+        {
+            configurePowerDomain(name);
+        }
+    }
+    catch (const std::exception&)
+    {
+        // Error trying to read RailStateChanged message
+    }
+}
+
 void Manager::monitor(bool enable)
 {
+    util::EventLoopLag::Scope lagScope{lagMonitor.getLag(), "Manager::monitor"};
+
     // Check whether already in the requested monitoring state
     if (enable == isMonitoringEnabled)
     {
@@ -200,11 +480,19 @@ void Manager::monitor(bool enable)
     {
         services.getJournal().logDebug("Monitoring enabled");
 
-        // Restart phase fault detection timer with repeating 15 second interval
-        phaseFaultTimer.restart(std::chrono::seconds(15));
+        // The regulators are enabled, so configure any power domains whose
+        // standby rails were not reported to be on
+        configurePendingPowerDomains();
 
-        // Restart sensor monitoring timer with repeating 1 second interval
-        sensorTimer.restart(std::chrono::seconds(1));
+        // Start phase fault detection task.  Each run checks one slice of
+        // the regulator devices, so each device is checked every 15 seconds.
+        phaseFaultTask = scheduler.add(
+            phaseFaultInterval / phaseFaultSliceCount,
+            std::bind(&Manager::phaseFaultTimerExpired, this));
+
+        // Start sensor monitoring task with repeating interval based on the
+        // rail monitoring intervals
+        startSensorTask();
 
         // Enable sensors service; put all sensors in an active state
         services.getSensors().enable();
@@ -213,9 +501,10 @@ void Manager::monitor(bool enable)
     {
         services.getJournal().logDebug("Monitoring disabled");
 
-        // Disable timers
-        phaseFaultTimer.setEnabled(false);
-        sensorTimer.setEnabled(false);
+        // Stop periodic tasks
+        phaseFaultTask.reset();
+        sensorTask.reset();
+        waitForChassisMonitors();
 
         // Disable sensors service; put all sensors in an inactive state
         services.getSensors().disable();
@@ -226,152 +515,718 @@ void Manager::monitor(bool enable)
             // Close the regulator devices in the system.  Monitoring is
             // normally disabled because the system is being powered off.  The
             // devices should be closed in case hardware is removed or replaced
-            // while the system is powered off.
-            system->closeDevices(services);
+            // while the system is powered off.  Standby-powered devices that
+            // are still present are kept open for the next boot.
+            system->closeUnpoweredDevices(services);
         }
     }
 }
 
-void Manager::phaseFaultTimerExpired()
+void Manager::enableI2CStats(bool enable)
 {
     // Verify config file has been loaded and System object is valid
     if (isConfigFileLoaded())
     {
-        // Detect redundant phase faults in regulator devices in the system
-        system->detectPhaseFaults(services);
+        waitForChassisMonitors();
+        for (const auto& chassis : system->getChassis())
+        {
+            for (const auto& device : chassis->getDevices())
+            {
+                device->getI2CInterface().setStatsEnabled(enable);
+            }
+        }
     }
 }
 
-void Manager::sensorTimerExpired()
+void Manager::enableRuleProfiling(bool enable)
 {
-    // Notify sensors service that a sensor monitoring cycle is starting
-    services.getSensors().startCycle();
+    RuleProfiler::get().enable(enable);
+}
+
+std::string Manager::getI2CStats()
+{
+    std::string stats{};
 
     // Verify config file has been loaded and System object is valid
     if (isConfigFileLoaded())
     {
-        // Monitor sensors for the voltage rails in the system
-        system->monitorSensors(services);
+        waitForChassisMonitors();
+        for (const auto& chassis : system->getChassis())
+        {
+            for (const auto& device : chassis->getDevices())
+            {
+                std::string deviceStats =
+                    device->getI2CInterface().getStats();
+                if (!deviceStats.empty())
+                {
+                    i2c::IdleStats idle =
+                        device->getI2CInterface().getIdleStats();
+                    stats += device->getID() + ":\n" + deviceStats +
+                             "idle closes " +
+                             std::to_string(idle.idleCloseCount) +
+                             " reopens " + std::to_string(idle.reopenCount) +
+                             " reopen_us " +
+                             std::to_string(idle.reopenTime.count()) + "\n";
+                }
+            }
+        }
     }
 
-    // Notify sensors service that current sensor monitoring cycle has ended
-    services.getSensors().endCycle();
+    return stats;
 }
 
-void Manager::sighupHandler(sdeventplus::source::Signal& /*sigSrc*/,
-                            const struct signalfd_siginfo* /*sigInfo*/)
+std::string Manager::getMemoryUsage(bool resetPeaks)
 {
-    // Reload the JSON configuration file
-    loadConfigFile();
+    std::string usage = memory_accounting::toString();
+    if (resetPeaks)
+    {
+        memory_accounting::resetPeaks();
+    }
+    return usage;
 }
 
-void Manager::clearHardwareData()
+std::string Manager::getRuleProfile(bool folded)
+{
+    RuleProfiler& profiler = RuleProfiler::get();
+    return folded ? profiler.getFoldedStacks() : profiler.toString();
+}
+
+std::string Manager::getRailStats()
 {
-    // Clear any cached hardware presence data and VPD values
-    services.getPresenceService().clearCache();
-    services.getVPD().clearCache();
+    std::string stats{};
 
     // Verify config file has been loaded and System object is valid
     if (isConfigFileLoaded())
     {
-        // Clear any cached hardware data in the System object
-        system->clearCache();
-
-        // Clear error history related to hardware devices in the System object
-        system->clearErrorHistory();
+        waitForChassisMonitors();
+        for (const auto& chassis : system->getChassis())
+        {
+            for (const auto& device : chassis->getDevices())
+            {
+                for (const auto& rail : device->getRails())
+                {
+                    const auto& monitoring = rail->getSensorMonitoring();
+                    if (!monitoring)
+                    {
+                        continue;
+                    }
+                    const SensorReadStatistics& readStats =
+                        monitoring->getReadStatistics();
+                    auto mean = (readStats.count > 0)
+                                    ? (readStats.total.count() /
+                                       static_cast<int64_t>(readStats.count))
+                                    : 0;
+                    auto meanJitter =
+                        (readStats.jitterCount > 0)
+                            ? (readStats.totalJitter.count() /
+                               static_cast<int64_t>(readStats.jitterCount))
+                            : 0;
+                    stats += rail->getID() +
+                             ": reads: " + std::to_string(readStats.count) +
+                             ", last: " +
+                             std::to_string(readStats.last.count()) +
+                             " us, mean: " + std::to_string(mean) +
+                             " us, max: " +
+                             std::to_string(readStats.max.count()) +
+                             " us, jitter last: " +
+                             std::to_string(readStats.lastJitter.count()) +
+                             " us, mean: " + std::to_string(meanJitter) +
+                             " us, max: " +
+                             std::to_string(readStats.maxJitter.count()) +
+                             " us\n";
+                }
+            }
+        }
     }
+
+    return stats;
 }
 
-void Manager::findCompatibleSystemTypes()
+std::string Manager::benchmark(uint32_t count)
 {
-    using namespace phosphor::power::util;
-
-    try
+    if (!isConfigFileLoaded())
     {
-        // Query object mapper for object paths that implement the compatible
-        // interface.  Returns a map of object paths to a map of services names
-        // to their interfaces.
-        DbusSubtree subTree = getSubTree(bus, "/xyz/openbmc_project/inventory",
-                                         compatibleIntf, 0);
+        return "Configuration file not loaded\n";
+    }
+    if (!isMonitoringEnabled)
+    {
+        return "Monitoring not enabled\n";
+    }
+    count = std::clamp(count, uint32_t{1}, maxBenchmarkCount);
+    waitForChassisMonitors();
 
-        // Get the first object path
-        auto objectIt = subTree.cbegin();
-        if (objectIt != subTree.cend())
+    std::vector<std::chrono::microseconds> durations{};
+    durations.reserve(count);
+    std::chrono::microseconds total{0};
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        // Read the sensors of every rail during this cycle
+        for (const auto& chassis : system->getChassis())
         {
-            std::string objPath = objectIt->first;
-
-            // Get the first service name
-            auto serviceIt = objectIt->second.cbegin();
-            if (serviceIt != objectIt->second.cend())
+            for (const auto& device : chassis->getDevices())
             {
-                std::string service = serviceIt->first;
-                if (!service.empty())
+                for (const auto& rail : device->getRails())
                 {
-                    // Get compatible system types property value
-                    getProperty(compatibleIntf, compatibleNamesProp, objPath,
-                                service, bus, compatibleSystemTypes);
+                    const auto& monitoring = rail->getSensorMonitoring();
+                    if (monitoring)
+                    {
+                        monitoring->requestRead();
+                    }
                 }
             }
         }
+
+        durations.emplace_back(runSensorCycle());
+        total += durations.back();
     }
-    catch (const std::exception&)
+
+    // The scheduler would run the sensor cycles missed while the benchmark
+    // blocked the event loop back to back; start the task again instead
+    startSensorTask();
+
+    // Nearest rank percentiles
+    std::sort(durations.begin(), durations.end());
+    auto percentile = [&durations](std::size_t percent) {
+        std::size_t rank = (percent * durations.size() + 99) / 100;
+        return std::to_string(durations[std::max(rank, std::size_t{1}) - 1]
+                                  .count());
+    };
+    double seconds = static_cast<double>(total.count()) / 1000000.0;
+    double rate = (seconds > 0.0) ? (count / seconds) : 0.0;
+
+    return "cycles: " + std::to_string(count) +
+           ", total: " + std::to_string(total.count()) +
+           " us, cycles/s: " + std::to_string(rate) + "\n" +
+           "min: " + std::to_string(durations.front().count()) +
+           " us, p50: " + percentile(50) + " us, p90: " + percentile(90) +
+           " us, p99: " + percentile(99) +
+           " us, max: " + std::to_string(durations.back().count()) + " us\n";
+}
+
+std::tuple<uint64_t, std::vector<Manager::SensorValue>>
+    Manager::getAllSensors(uint64_t since)
+{
+    DBusSensors& sensors = services.getDBusSensors();
+    uint64_t sequence = sensors.getSequence();
+
+    std::vector<SensorValue> values{};
+    for (const DBusSensors::SensorValue& sensor : sensors.getValues(since))
     {
-        // Compatible system types information is not available.  The current
-        // system might not support the interface, or the service that
-        // implements the interface might not be running yet.
+        auto timestamp = std::chrono::duration_cast<std::chrono::microseconds>(
+            sensor.timestamp.time_since_epoch());
+        values.emplace_back(sensor.name,
+                            util::sensor_telemetry::toString(sensor.status),
+                            sensor.value,
+                            static_cast<uint64_t>(timestamp.count()));
     }
+    return {sequence, std::move(values)};
 }
 
-fs::path Manager::findConfigFile()
+std::vector<Manager::SensorHistoryValue>
+    Manager::getSensorHistory(const std::string& name, uint64_t since)
 {
-    // Build list of possible base file names
-    std::vector<std::string> fileNames{};
-
-    // Add possible file names based on compatible system types (if any)
-    for (const std::string& systemType : compatibleSystemTypes)
+    // The history is stored in milliseconds; D-Bus uses microseconds like
+    // GetAllSensors
+    std::vector<CompressedTimeSeries::Point> points{};
+    try
     {
-        // Replace all spaces and commas in system type name with underscores
-        std::string fileName{systemType};
-        std::replace(fileName.begin(), fileName.end(), ' ', '_');
-        std::replace(fileName.begin(), fileName.end(), ',', '_');
+        points = services.getSensorHistory().getValues(
+            name, static_cast<int64_t>(since / 1000));
+    }
+    catch (const std::invalid_argument&)
+    {
+        throw sdbusplus::xyz::openbmc_project::Common::Error::InvalidArgument{};
+    }
 
-        // Append .json suffix and add to list
-        fileName.append(".json");
-        fileNames.emplace_back(fileName);
+    std::vector<SensorHistoryValue> values{};
+    values.reserve(points.size());
+    for (const CompressedTimeSeries::Point& point : points)
+    {
+        values.emplace_back(static_cast<uint64_t>(point.timestamp) * 1000,
+                            point.value);
     }
+    return values;
+}
 
-    // Add default file name for systems that don't use compatible interface
-    fileNames.emplace_back(defaultConfigFileName);
+void Manager::setRailVolts(const std::string& rail, double volts)
+{
+    using namespace sdbusplus::xyz::openbmc_project::Common::Error;
 
-    // Look for a config file with one of the possible base names
-    for (const std::string& fileName : fileNames)
+    auto it = railSetpoints.find(rail);
+    if ((it == railSetpoints.end()) || !it->second.setpoint->isInRange(volts))
     {
-        // Check if file exists in test directory
-        fs::path pathName{testConfigFileDir / fileName};
-        if (fs::exists(pathName))
-        {
-            return pathName;
-        }
+        throw InvalidArgument{};
+    }
 
-        // Check if file exists in standard directory
-        pathName = standardConfigFileDir / fileName;
-        if (fs::exists(pathName))
-        {
-            return pathName;
-        }
+    // The configure job sets the voltages of the rails.  Devices that are not
+    // standby-powered are only powered while monitoring is enabled.
+    RailSetpoint& railSetpoint = it->second;
+    Device& device = *railSetpoint.device;
+    if (configureJob.isActive ||
+        (!isMonitoringEnabled && !device.isStandbyPowered()))
+    {
+        throw Unavailable{};
     }
 
-    // No config file found; return empty path
-    return fs::path{};
+    waitForChassisMonitors();
+    if (!device.isPresent(services, *system, *railSetpoint.chassis))
+    {
+        throw Unavailable{};
+    }
+
+    try
+    {
+        railSetpoint.setpoint->set(device, volts);
+    }
+    catch (const std::exception& e)
+    {
+        services.getJournal().logError(exception_utils::MessageView{e});
+        services.getJournal().logError("Unable to set voltage of rail " +
+                                       rail);
+        throw InternalFailure{};
+    }
 }
 
-bool Manager::isSystemPoweredOn()
+std::vector<uint8_t> Manager::handleAlert(uint8_t bus)
 {
-    bool isOn{false};
+    // The monitoring workers may be using the same bus, and the alerting
+    // devices are handled on this thread once the addresses are read
+    waitForChassisMonitors();
 
+    std::vector<uint8_t> addresses{};
     try
     {
-        // Get D-Bus property that contains the current power state for
+        // SMBALERT# cannot be read, so assume it is asserted and read the
+        // Alert Response Address until no device responds
+        auto it = alertSources.find(bus);
+        if (it == alertSources.end())
+        {
+            // Do not retry; no device responding is the normal end of an
+            // alert
+            auto ara = i2c::create(bus, i2c::alertResponseAddress,
+                                   i2c::I2CInterface::InitialState::CLOSED, 0);
+            i2c::AlertSource source{std::move(ara), []() { return true; }};
+            it = alertSources.emplace(bus, std::move(source)).first;
+        }
+        addresses = it->second.getAlertingAddresses();
+    }
+    catch (const std::exception& e)
+    {
+        services.getJournal().logError(exception_utils::MessageView{e});
+        services.getJournal().logError("Unable to handle SMBus alert on bus " +
+                                       std::to_string(bus));
+        return addresses;
+    }
+
+    // Phase faults are only detected and sensors are only read while
+    // monitoring is enabled
+    if (!isConfigFileLoaded() || !isMonitoringEnabled)
+    {
+        return addresses;
+    }
+
+    bool wasFound{false};
+    for (uint8_t address : addresses)
+    {
+        if (system->handleAlert(services, bus, address))
+        {
+            wasFound = true;
+        }
+    }
+
+    // Read the sensors of the rails whose read was requested.  The other
+    // rails are skipped since their interval has not elapsed.
+    if (wasFound)
+    {
+        runSensorCycle();
+    }
+
+    return addresses;
+}
+
+void Manager::phaseFaultTimerExpired()
+{
+    util::EventLoopLag::Scope lagScope{lagMonitor.getLag(),
+                                       "Manager::phaseFaultTimerExpired"};
+
+    // Verify config file has been loaded and System object is valid
+    if (isConfigFileLoaded())
+    {
+        // Detect redundant phase faults in the next slice of regulator devices
+        phaseFaultScheduler->execute(services);
+
+        // The chassis with independent monitoring detect phase faults on
+        // their workers.  The results are replayed by the next sensor cycle.
+        for (std::unique_ptr<ChassisMonitor>& monitor : chassisMonitors)
+        {
+            monitor->requestPhaseFaultDetection();
+            monitor->start();
+        }
+    }
+}
+
+void Manager::sensorTimerExpired()
+{
+    util::EventLoopLag::Scope lagScope{lagMonitor.getLag(),
+                                       "Manager::sensorTimerExpired"};
+
+    POWER_TRACE_SCOPE("Manager::sensorTimerExpired", "", "");
+
+    // Record the cycle time.  An overrun means the rail intervals in the
+    // config file cannot all be met.
+    if (sensorCycleStats.record(runSensorCycle()) &&
+        sensorCycleStats.isOverrunWarningEnabled())
+    {
+        services.getJournal().logInfo(
+            "Sensor monitoring cycle overrun: " + sensorCycleStats.toString());
+    }
+    startupTimes.complete(util::StartupTimes::Phase::firstCycle);
+}
+
+void Manager::sighupHandler(sdeventplus::source::Signal& /*sigSrc*/,
+                            const struct signalfd_siginfo* /*sigInfo*/)
+{
+    util::EventLoopLag::Scope lagScope{lagMonitor.getLag(),
+                                       "Manager::sighupHandler"};
+
+    // Reload the JSON configuration file
+    loadConfigFile();
+}
+
+void Manager::clearHardwareData()
+{
+    // Reload cached hardware presence data and VPD values.  The cached values
+    // are kept up to date by PropertiesChanged signals while the system is
+    // running, but hardware might have been replaced while powered off.
+    // Device presence that only depends on hardware presence is cleared by
+    // presenceChangedHandler() for the values that changed.
+    waitForChassisMonitors();
+    loadInventoryData();
+
+    // Verify config file has been loaded and System object is valid
+    if (isConfigFileLoaded())
+    {
+        // Clear any cached hardware data in the System object
+        system->clearCache();
+
+        // Close any standby-powered devices that were removed while the system
+        // was powered off
+        system->closeUnpoweredDevices(services);
+
+        // Clear error history related to hardware devices in the System object
+        system->clearErrorHistory();
+    }
+}
+
+void Manager::completeConfigure(bool success)
+{
+    configureStepTimer.setEnabled(false);
+    configureJob.isActive = false;
+    configureJob.isWaiting = false;
+    configureJob.phaseTimes["devices"] = configureJob.devicesTime.count();
+    auto total = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - configureJob.startTime);
+    configureJob.phaseTimes["total"] = total.count();
+
+    if (success)
+    {
+        startupTimes.complete(util::StartupTimes::Phase::hardwareDiscovery);
+        services.getJournal().logInfo(
+            "Configured regulator devices in " +
+            std::to_string(total.count() / 1000) + " ms with " +
+            std::to_string(configureJob.errorCount) + " errors");
+    }
+
+    try
+    {
+        emitConfigureCompletedSignal(success, configureJob.errorCount,
+                                     configureJob.phaseTimes);
+    }
+    catch (const std::exception& e)
+    {
+        services.getJournal().logError(exception_utils::MessageView{e});
+    }
+}
+
+void Manager::configureNextChassis()
+{
+    util::EventLoopLag::Scope lagScope{lagMonitor.getLag(),
+                                       "Manager::configureNextChassis"};
+
+    // The config file may have been reloaded while the job was running
+    if (!isConfigFileLoaded() ||
+        (configureJob.chassisIndex >= system->getChassis().size()))
+    {
+        completeConfigure(isConfigFileLoaded());
+        return;
+    }
+
+    // Configure the regulator devices in the chassis
+    waitForChassisMonitors();
+    const std::vector<std::unique_ptr<Chassis>>& chassis =
+        system->getChassis();
+    Chassis& oneChassis = *chassis[configureJob.chassisIndex++];
+    auto start = std::chrono::steady_clock::now();
+    unsigned int errorCount =
+        oneChassis.configure(services, *system, configureJob.powerDomain);
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start);
+    configureJob.devicesTime += duration;
+    configureJob.errorCount += errorCount;
+
+    try
+    {
+        emitConfigureProgressSignal(oneChassis.getNumber(),
+                                    configureJob.chassisIndex, chassis.size(),
+                                    errorCount, duration.count());
+    }
+    catch (const std::exception& e)
+    {
+        services.getJournal().logError(exception_utils::MessageView{e});
+    }
+
+    // Let the event loop service other events before the next chassis
+    if (configureJob.chassisIndex < chassis.size())
+    {
+        configureStepTimer.restartOnce(std::chrono::microseconds{0});
+    }
+    else
+    {
+        completeConfigure(true);
+    }
+}
+
+void Manager::configurePendingPowerDomains()
+{
+    while (!pendingPowerDomains.empty())
+    {
+        configurePowerDomain(pendingPowerDomains.begin()->first);
+    }
+}
+
+void Manager::configurePowerDomain(const std::string& name)
+{
+    pendingPowerDomains.erase(name);
+    bool success{false};
+    if (isConfigFileLoaded())
+    {
+        waitForChassisMonitors();
+        try
+        {
+            system->configure(services, name);
+            success = true;
+        }
+        catch (const std::exception& e)
+        {
+            services.getJournal().logError(exception_utils::MessageView{e});
+            services.getJournal().logError(
+                "Unable to configure power domain " + name);
+        }
+    }
+
+    try
+    {
+        emitPowerDomainConfiguredSignal(name, success);
+    }
+    catch (const std::exception& e)
+    {
+        services.getJournal().logError(exception_utils::MessageView{e});
+    }
+}
+
+void Manager::configureTimerExpired()
+{
+    util::EventLoopLag::Scope lagScope{lagMonitor.getLag(),
+                                       "Manager::configureTimerExpired"};
+
+    // Try one last time to find list of compatible system types
+    if (!isConfigFileLoaded() && compatibleSystemTypes.empty())
+    {
+        findCompatibleSystemTypes();
+        if (!compatibleSystemTypes.empty())
+        {
+            loadConfigFile();
+        }
+    }
+
+    // Configure with the config file if it was loaded; otherwise complete the
+    // job with an error
+    finishConfigure();
+}
+
+void Manager::endConfigurePhase(const std::string& phase)
+{
+    auto now = std::chrono::steady_clock::now();
+    configureJob.phaseTimes[phase] =
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            now - configureJob.phaseStartTime)
+            .count();
+    configureJob.phaseStartTime = now;
+}
+
+void Manager::findCompatibleSystemTypes()
+{
+    using namespace phosphor::power::util;
+
+    try
+    {
+        // Query object mapper for object paths that implement the compatible
+        // interface.  Returns a map of object paths to a map of services names
+        // to their interfaces.
+        DbusSubtree subTree = getSubTree(bus, "/xyz/openbmc_project/inventory",
+                                         compatibleIntf, 0);
+
+        // Get the first object path
+        auto objectIt = subTree.cbegin();
+        if (objectIt != subTree.cend())
+        {
+            std::string objPath = objectIt->first;
+
+            // Get the first service name
+            auto serviceIt = objectIt->second.cbegin();
+            if (serviceIt != objectIt->second.cend())
+            {
+                std::string service = serviceIt->first;
+                if (!service.empty())
+                {
+                    // Get compatible system types property value
+                    getProperty(compatibleIntf, compatibleNamesProp, objPath,
+                                service, bus, compatibleSystemTypes);
+                }
+            }
+        }
+    }
+    catch (const std::exception&)
+    {
+        // Compatible system types information is not available.  The current
+        // system might not support the interface, or the service that
+        // implements the interface might not be running yet.
+    }
+}
+
+const CompiledConfig* Manager::findCompiledConfig()
+{
+    for (const std::string& fileName : getCompatibleConfigFileNames())
+    {
+        // A file in the test directory overrides the compiled config file
+        if (fs::exists(testConfigFileDir / fileName))
+        {
+            return nullptr;
+        }
+
+        const CompiledConfig* config = compiled_configs::find(fileName);
+        if (config != nullptr)
+        {
+            return config;
+        }
+    }
+    return nullptr;
+}
+
+fs::path Manager::findConfigFile()
+{
+    // Build list of possible base file names.  Add possible file names based
+    // on compatible system types (if any).
+    std::vector<std::string> fileNames = getCompatibleConfigFileNames();
+
+    // Add default file name for systems that don't use compatible interface
+    fileNames.emplace_back(defaultConfigFileName);
+
+    // Look for a config file with one of the possible base names
+    for (const std::string& fileName : fileNames)
+    {
+        // Check if file exists in test directory
+        fs::path pathName{testConfigFileDir / fileName};
+        if (fs::exists(pathName))
+        {
+            return pathName;
+        }
+
+        // Check if file exists in standard directory
+        pathName = standardConfigFileDir / fileName;
+        if (fs::exists(pathName))
+        {
+            return pathName;
+        }
+    }
+
+    // No config file found; return empty path
+    return fs::path{};
+}
+
+std::vector<std::string> Manager::getCompatibleConfigFileNames() const
+{
+    std::vector<std::string> fileNames{};
+    for (const std::string& systemType : compatibleSystemTypes)
+    {
+        // Replace all spaces and commas in system type name with underscores
+        std::string fileName{systemType};
+        std::replace(fileName.begin(), fileName.end(), ' ', '_');
+        std::replace(fileName.begin(), fileName.end(), ',', '_');
+
+        // Append .json suffix and add to list
+        fileName.append(".json");
+        fileNames.emplace_back(fileName);
+    }
+    return fileNames;
+}
+
+void Manager::finishConfigure()
+{
+    configureTimer.setEnabled(false);
+    if (!configureJob.isWaiting)
+    {
+        return;
+    }
+    configureJob.isWaiting = false;
+    endConfigurePhase("wait");
+
+    // Verify config file has been loaded and System object is valid
+    if (!isConfigFileLoaded())
+    {
+        // Write error message to journal
+        services.getJournal().logError("Unable to configure regulator devices: "
+                                       "Configuration file not loaded");
+
+        // Log critical error since regulators could not be configured.  Could
+        // cause hardware damage if default regulator settings are very wrong.
+        services.getErrorLogging().logConfigFileError(Entry::Level::Critical,
+                                                      services.getJournal());
+
+        completeConfigure(false);
+        return;
+    }
+
+    // Create the deferred chassis that are now present
+    waitForChassisMonitors();
+    if (loadPresentChassis())
+    {
+        updateExecutors();
+    }
+
+    // Devices in a power domain are configured when the standby rails of the
+    // domain are on
+    pendingPowerDomains = system->getPowerDomains();
+    if (!pendingPowerDomains.empty())
+    {
+        services.getJournal().logInfo(
+            "Configuring " + std::to_string(pendingPowerDomains.size()) +
+            " power domains when their standby rails are on");
+        configureJob.powerDomain = std::string{};
+    }
+    endConfigurePhase("prepare");
+
+    // Configure the chassis one at a time from the event loop
+    configureStepTimer.restartOnce(std::chrono::microseconds{0});
+}
+
+bool Manager::isSystemPoweredOn()
+{
+    bool isOn{false};
+
+    try
+    {
+        // Get D-Bus property that contains the current power state for
         // chassis0, which represents the entire system (all chassis)
         using namespace phosphor::power::util;
         auto service = getService(chassisStatePath, chassisStateIntf, bus);
@@ -397,31 +1252,98 @@ bool Manager::isSystemPoweredOn()
 
 void Manager::loadConfigFile()
 {
+    memory_accounting::Scope memoryScope{memory_accounting::Tag::configTree};
     try
     {
-        // Find the absolute path to the config file
-        fs::path pathName = findConfigFile();
-        if (!pathName.empty())
+        // Find the config file compiled into the binary, if any.  Otherwise
+        // find the absolute path to the config file.
+        const CompiledConfig* compiledConfig = findCompiledConfig();
+        fs::path pathName =
+            (compiledConfig == nullptr) ? findConfigFile() : fs::path{};
+        if ((compiledConfig != nullptr) || !pathName.empty())
         {
             // Log info message in journal; config file path is important
-            services.getJournal().logInfo("Loading configuration file " +
-                                          pathName.string());
+            if (compiledConfig != nullptr)
+            {
+                services.getJournal().logInfo(
+                    "Loading configuration file " +
+                    std::string{compiledConfig->fileName} +
+                    " compiled into the binary");
+            }
+            else
+            {
+                services.getJournal().logInfo("Loading configuration file " +
+                                              pathName.string());
+            }
+
+            // Remove the I2C bus budgets of the previous config file; they are
+            // set again by the devices in the config file
+            i2c::clearBusBudgets();
 
-            // Parse the config file
+            // Parse the config file.  A compiled config file is already in
+            // binary form.  Parse a large config file incrementally to limit
+            // memory usage, deferring the chassis until they are present.
+            // Otherwise use the binary cache file if the config file has not
+            // changed.
             std::vector<std::unique_ptr<Rule>> rules{};
             std::vector<std::unique_ptr<Chassis>> chassis{};
-            std::tie(rules, chassis) = config_file_parser::parse(pathName);
+            std::vector<config_file_parser::DeferredChassis> deferred{};
+            std::error_code ec{};
+            if (compiledConfig != nullptr)
+            {
+                std::tie(rules, chassis) = config_file_parser::parse(
+                    *compiledConfig, getParseThreadCount());
+            }
+            else if (std::uintmax_t fileSize = fs::file_size(pathName, ec);
+                     !ec && (fileSize >= streamingParseMinFileSize))
+            {
+                std::tie(rules, deferred) =
+                    config_file_parser::parseDeferred(pathName);
+            }
+            else
+            {
+                std::tie(rules, chassis) = config_file_parser::parse(
+                    pathName, configFileCacheDir, getParseThreadCount());
+            }
+
+            // Keep the devices that did not change, and their runtime state,
+            // if a config file was already loaded
+            if (system)
+            {
+                waitForChassisMonitors();
+                std::size_t count = config_reload::reuseUnchangedDevices(
+                    *system, rules, chassis);
+                if constexpr (isJournalDebugEnabled)
+                {
+                    services.getJournal().logDebug(
+                        "Reused " + std::to_string(count) +
+                        " unchanged devices from previous configuration file");
+                }
+            }
 
             // Store config file information in a new System object.  The old
             // System object, if any, is automatically deleted.
+            chassisMonitors.clear();
             system =
                 std::make_unique<System>(std::move(rules), std::move(chassis));
+            deferredChassis = std::move(deferred);
+
+            // Discard the rule profile of the deleted rules and actions
+            RuleProfiler::get().reset();
+
+            // Compile the actions now that all rules can be resolved
+            system->compileActions();
+
+            // Create the deferred chassis that are already present
+            loadPresentChassis();
+            updateExecutors();
+            startupTimes.complete(util::StartupTimes::Phase::configLoad);
         }
     }
     catch (const std::exception& e)
     {
         // Log error messages in journal
-        services.getJournal().logError(exception_utils::getMessages(e));
+        services.getJournal().logError(exception_utils::MessageView{e});
         services.getJournal().logError("Unable to load configuration file");
 
         // Log error
@@ -430,33 +1352,249 @@ void Manager::loadConfigFile()
     }
 }
 
-void Manager::waitUntilConfigFileLoaded()
+void Manager::loadInventoryData()
 {
-    // If config file not loaded and list of compatible system types is empty
-    if (!isConfigFileLoaded() && compatibleSystemTypes.empty())
+    try
+    {
+        auto method =
+            bus.new_method_call(INVENTORY_MGR_IFACE, INVENTORY_OBJ_PATH,
+                                "org.freedesktop.DBus.ObjectManager",
+                                "GetManagedObjects");
+        auto reply = bus.call(method);
+        InventoryObjects objects{};
+        reply.read(objects);
+        services.loadInventoryCache(objects);
+    }
+    catch (const std::exception& e)
     {
-        // Loop until compatible system types found or waited max amount of time
-        auto start = std::chrono::system_clock::now();
-        std::chrono::system_clock::duration timeWaited{0};
-        while (compatibleSystemTypes.empty() &&
-               (timeWaited <= maxTimeToWaitForCompatTypes))
+        // Obtain presence and VPD values one at a time when they are needed
+        services.getJournal().logError(exception_utils::MessageView{e});
+        services.getJournal().logError("Unable to get inventory objects");
+        services.getPresenceService().clearCache();
+        services.getVPD().clearCache();
+    }
+}
+
+bool Manager::loadPresentChassis()
+{
+    std::vector<std::unique_ptr<Chassis>> chassis{};
+    PresenceService& presenceService = services.getPresenceService();
+    for (auto it = deferredChassis.begin(); it != deferredChassis.end();)
+    {
+        // Leave chassis deferred until it is present.  Try again later if the
+        // presence cannot be obtained.
+        bool isPresent{false};
+        try
+        {
+            isPresent = presenceService.isPresent(it->inventoryPath);
+        }
+        catch (const std::exception& e)
+        {
+            services.getJournal().logError(exception_utils::MessageView{e});
+        }
+        if (!isPresent)
+        {
+            ++it;
+            continue;
+        }
+
+        try
+        {
+            // Create Chassis object from the config file information
+            memory_accounting::Scope memoryScope{
+                memory_accounting::Tag::configTree};
+            chassis.emplace_back(config_file_parser::parseDeferredChassis(*it));
+            it = deferredChassis.erase(it);
+        }
+        catch (const std::exception& e)
         {
-            // Try to find list of compatible system types
-            findCompatibleSystemTypes();
-            if (!compatibleSystemTypes.empty())
+            // Log error messages in journal
+            services.getJournal().logError(exception_utils::MessageView{e});
+            services.getJournal().logError("Unable to load chassis " +
+                                           std::to_string(it->number));
+
+            // Log error and do not try to create the chassis again
+            services.getErrorLogging().logConfigFileError(
+                Entry::Level::Error, services.getJournal());
+            it = deferredChassis.erase(it);
+        }
+    }
+
+    if (chassis.empty())
+    {
+        return false;
+    }
+
+    try
+    {
+        // Log info message in journal; important for verifying chassis loaded
+        for (const std::unique_ptr<Chassis>& oneChassis : chassis)
+        {
+            services.getJournal().logInfo(
+                "Loading chassis " + std::to_string(oneChassis->getNumber()));
+        }
+        system->addChassis(std::move(chassis));
+    }
+    catch (const std::exception& e)
+    {
+        // Log error messages in journal
+        services.getJournal().logError(exception_utils::MessageView{e});
+        services.getJournal().logError("Unable to add chassis to system");
+
+        // Log error
+        services.getErrorLogging().logConfigFileError(Entry::Level::Error,
+                                                      services.getJournal());
+        return false;
+    }
+    return true;
+}
+
+void Manager::restoreState()
+{
+    std::optional<nlohmann::json> state = stateHandoff.take();
+    if (!state)
+    {
+        return;
+    }
+
+    try
+    {
+        // Convert all the values before using any of them
+        auto types =
+            state->at("compatibleSystemTypes").get<std::vector<std::string>>();
+        auto presence =
+            state->at("presence").get<std::map<std::string, bool>>();
+        auto vpd = state->at("vpd")
+                       .get<std::map<std::string, DBusVPD::KeywordMap>>();
+
+        compatibleSystemTypes = std::move(types);
+        services.getDBusPresenceService().restoreCache(std::move(presence));
+        services.getDBusVPD().restoreCache(std::move(vpd));
+        services.getJournal().logInfo(
+            "Restored the state of the previous instance");
+    }
+    catch (const std::exception& e)
+    {
+        services.getJournal().logError(exception_utils::MessageView{e});
+        services.getJournal().logError(
+            "Unable to restore the state of the previous instance");
+    }
+}
+
+std::chrono::microseconds Manager::runSensorCycle()
+{
+    auto start = std::chrono::steady_clock::now();
+
+    // Notify sensors service that a sensor monitoring cycle is starting
+    services.getSensors().startCycle();
+
+    // Verify config file has been loaded and System object is valid
+    if (isConfigFileLoaded())
+    {
+        // Monitor sensors for the voltage rails in the system.  The devices on
+        // each I2C bus are read in parallel.
+        sensorMonitoringExecutor->execute(services);
+
+        // Publish the results of the chassis with independent monitoring
+        // whose workers finished, and start the workers that are due.  The
+        // sensors of a chassis whose worker is still running keep their
+        // values.
+        auto now = std::chrono::steady_clock::now();
+        for (std::unique_ptr<ChassisMonitor>& monitor : chassisMonitors)
+        {
+            if (!monitor->collect())
             {
-                // Compatible system types found; try to load config file
-                loadConfigFile();
+                monitor->skipRails();
             }
-            else
+            monitor->start(now);
+        }
+    }
+
+    // Notify sensors service that current sensor monitoring cycle has ended
+    services.getSensors().endCycle();
+
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start);
+}
+
+void Manager::saveState()
+{
+    util::EventLoopLag::Scope lagScope{lagMonitor.getLag(),
+                                       "Manager::saveState"};
+
+    nlohmann::json state{
+        {"compatibleSystemTypes", compatibleSystemTypes},
+        {"presence", services.getDBusPresenceService().getCache()},
+        {"vpd", services.getDBusVPD().getCache()}};
+    stateHandoff.save(state);
+}
+
+void Manager::startSensorTask()
+{
+    // End the current task first so its phase is free to be chosen again
+    sensorTask.reset();
+    std::chrono::milliseconds interval = getSensorMonitoringInterval();
+    sensorCycleStats.setInterval(interval);
+    sensorTask = scheduler.add(
+        interval, std::bind(&Manager::sensorTimerExpired, this));
+}
+
+void Manager::updateExecutors()
+{
+    // Create objects that refer to the current devices in the system.  Each
+    // chassis with independent monitoring gets its own monitor.
+    waitForChassisMonitors();
+    chassisMonitors.clear();
+    checkChassisMonitorBuses(services, *system);
+    std::vector<Chassis*> sharedChassis{};
+    for (const std::unique_ptr<Chassis>& chassis : system->getChassis())
+    {
+        if (chassis->isIndependentMonitoring())
+        {
+            chassisMonitors.emplace_back(std::make_unique<ChassisMonitor>(
+                services, *system, *chassis, phaseFaultSliceCount));
+        }
+        else
+        {
+            sharedChassis.emplace_back(chassis.get());
+        }
+    }
+    sensorMonitoringExecutor =
+        std::make_unique<SensorMonitoringExecutor>(*system, sharedChassis);
+    phaseFaultScheduler = std::make_unique<PhaseFaultDetectionScheduler>(
+        *system, sharedChassis, phaseFaultSliceCount);
+
+    // Find the rails whose voltage can be set at runtime
+    railSetpoints.clear();
+    for (const std::unique_ptr<Chassis>& chassis : system->getChassis())
+    {
+        for (const std::unique_ptr<Device>& device : chassis->getDevices())
+        {
+            for (const std::unique_ptr<Rail>& rail : device->getRails())
             {
-                // Sleep 5 seconds
-                using namespace std::chrono_literals;
-                std::this_thread::sleep_for(5s);
+                if (rail->getVoltageSetpoint())
+                {
+                    railSetpoints[rail->getID()] = RailSetpoint{
+                        chassis.get(), device.get(),
+                        rail->getVoltageSetpoint().get()};
+                }
             }
-            timeWaited = std::chrono::system_clock::now() - start;
         }
     }
+
+    // Update the sensor monitoring task for the new rail intervals
+    if (isMonitoringEnabled)
+    {
+        startSensorTask();
+    }
+}
+
+void Manager::waitForChassisMonitors()
+{
+    for (std::unique_ptr<ChassisMonitor>& monitor : chassisMonitors)
+    {
+        monitor->wait();
+    }
 }
 
 } // namespace phosphor::power::regulators
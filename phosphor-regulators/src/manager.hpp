@@ -15,7 +15,22 @@
  */
 #pragma once
 
+#include "chassis_monitor.hpp"
+#include "compiled_config.hpp"
+#include "config_file_parser.hpp"
+#include "phase_fault_detection_scheduler.hpp"
+#include "cycle_stats.hpp"
+#include "cycle_stats_interface.hpp"
+#include "event_loop_lag.hpp"
+#include "event_loop_lag_interface.hpp"
+#include "event_loop_lag_monitor.hpp"
+#include "periodic_scheduler.hpp"
+#include "sensor_monitoring_executor.hpp"
 #include "services.hpp"
+#include "smbus_alert.hpp"
+#include "startup_times.hpp"
+#include "startup_times_interface.hpp"
+#include "state_handoff.hpp"
 #include "system.hpp"
 
 #include <interfaces/manager_interface.hpp>
@@ -26,22 +41,32 @@
 #include <sdeventplus/source/signal.hpp>
 #include <sdeventplus/utility/timer.hpp>
 
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <filesystem>
+#include <map>
 #include <memory>
+#include <optional>
+#include <set>
 #include <string>
+#include <tuple>
 #include <vector>
 
 namespace phosphor::power::regulators
 {
 
-using Timer = sdeventplus::utility::Timer<sdeventplus::ClockId::Monotonic>;
-
 using ManagerObject = sdbusplus::server::object::object<
     phosphor::power::regulators::interface::ManagerInterface>;
 
 class Manager : public ManagerObject
 {
   public:
+    /**
+     * Maximum number of cycles run by benchmark().
+     */
+    static constexpr uint32_t maxBenchmarkCount{1000};
+
     Manager() = delete;
     Manager(const Manager&) = delete;
     Manager(Manager&&) = delete;
@@ -61,10 +86,25 @@ class Manager : public ManagerObject
     /**
      * Implements the D-Bus "configure" method.
      *
-     * Configures all the voltage regulators in the system.
+     * Starts a job that configures all the voltage regulators in the system,
+     * and returns without waiting for it.
      *
      * This method should be called when the system is being powered on.  It
      * needs to occur before the regulators have been enabled/turned on.
+     *
+     * If the config file has not been loaded because the compatible system
+     * types have not been found, the job waits until they are found or the
+     * maximum amount of time to wait has elapsed.  The chassis are then
+     * configured one at a time from the event loop, so other D-Bus requests
+     * are serviced while the job runs.  The ConfigureProgress signal is
+     * emitted after each chassis and the ConfigureCompleted signal when the
+     * job has finished.
+     *
+     * Calls made while a job is running do not start another job.
+     *
+     * Devices in a power domain are configured later, when the standby rails
+     * of the domain are on.  See PowerDomain.  The job finishes once the
+     * devices that are not in a power domain have been configured.
      */
     void configure() override;
 
@@ -75,6 +115,42 @@ class Manager : public ManagerObject
      */
     void interfacesAddedHandler(sdbusplus::message::message& msg);
 
+    /**
+     * Callback function to handle PowerGood D-Bus signals from the power
+     * sequencer.
+     *
+     * Configures the devices in the power domains that have not been
+     * configured yet.
+     *
+     * @param msg Expanded sdbusplus message data
+     */
+    void powerGoodHandler(sdbusplus::message::message& msg);
+
+    /**
+     * Callback function to handle changes to the cached hardware presence
+     * values.
+     *
+     * Clears the cached presence of the devices whose presence detection
+     * depends on the hardware, so it is detected again the next time it is
+     * needed.
+     *
+     * @param inventoryPath D-Bus inventory path of the hardware, or an empty
+     *                      string if the presence of any hardware might have
+     *                      changed
+     */
+    void presenceChangedHandler(const std::string& inventoryPath);
+
+    /**
+     * Callback function to handle RailStateChanged D-Bus signals from the
+     * power sequencer.
+     *
+     * Configures the devices in the power domains whose standby rails are now
+     * all on.
+     *
+     * @param msg Expanded sdbusplus message data
+     */
+    void railStateChangedHandler(sdbusplus::message::message& msg);
+
     /**
      * Implements the D-Bus "monitor" method.
      *
@@ -104,12 +180,159 @@ class Manager : public ManagerObject
     void monitor(bool enable) override;
 
     /**
-     * Phase fault detection timer expired callback function.
+     * Enables or disables collecting I2C transaction statistics for all
+     * regulator devices in the system.
+     *
+     * Statistics are discarded when disabled, and when the configuration file
+     * is reloaded.
+     *
+     * @param enable true if statistics should be enabled, false if they
+     *               should be disabled
+     */
+    void enableI2CStats(bool enable) override;
+
+    /**
+     * Enables or disables profiling the rules and actions.
+     *
+     * The profile is discarded when disabled, and when the configuration file
+     * is reloaded.  See RuleProfiler.
+     *
+     * @param enable true if profiling should be enabled, false if it should
+     *               be disabled
+     */
+    void enableRuleProfiling(bool enable) override;
+
+    /**
+     * Returns the I2C transaction statistics of all regulator devices in the
+     * system.
+     *
+     * Each device with statistics is listed by ID, followed by its statistics
+     * lines.
+     *
+     * @return statistics text
+     */
+    std::string getI2CStats() override;
+
+    /**
+     * Returns the heap memory used by each subsystem.
+     *
+     * Each tag is listed on one line with its current and peak number of
+     * bytes.  See memory_accounting.
+     *
+     * @param resetPeaks true to set the peaks to the current number of bytes
+     *                   after they are returned, false otherwise
+     * @return memory usage text
+     */
+    std::string getMemoryUsage(bool resetPeaks) override;
+
+    /**
+     * Returns the profile of the rules and actions.
+     *
+     * @param folded true to return the call stacks in the folded stack format
+     *               used by flame graph tools, false to return the statistics
+     *               of each rule ID and action type
+     * @return profile text
+     */
+    std::string getRuleProfile(bool folded) override;
+
+    /**
+     * Returns the sensor read time statistics of all voltage rails in the
+     * system.
+     *
+     * Each rail with sensor monitoring is listed on one line by ID.
+     *
+     * @return statistics text
+     */
+    std::string getRailStats() override;
+
+    /**
+     * Runs the specified number of sensor monitoring cycles back to back and
+     * returns the throughput and cycle time distribution.
+     *
+     * The sensors of every rail are read in each cycle, even if the rail's
+     * monitoring interval has not elapsed.  The cycles run on the event loop,
+     * so the count is limited to maxBenchmarkCount.  The cycles are not
+     * included in the sensor monitoring cycle statistics.
+     *
+     * Monitoring must be enabled, otherwise the sensors service would publish
+     * values while it is disabled.
+     *
+     * @param count number of cycles to run
+     * @return benchmark results text
+     */
+    std::string benchmark(uint32_t count) override;
+
+    /**
+     * Handles an SMBus alert on the specified I2C bus.
+     *
+     * Reads the Alert Response Address of the bus to find the regulator
+     * devices asserting SMBALERT#.  If monitoring is enabled, phase faults
+     * are detected in just those devices and the sensors of their rails are
+     * read right away, instead of waiting for the periodic tasks to reach
+     * them.
+     *
+     * This is called for the SMBALERT# GPIO edge, typically by a GPIO monitor
+     * service.  This application cannot read the GPIO, so the Alert Response
+     * Address is read until no device responds.
+     *
+     * @param bus I2C bus whose SMBALERT# line was asserted
+     * @return addresses of the devices that responded
+     */
+    std::vector<uint8_t> handleAlert(uint8_t bus) override;
+
+    /**
+     * Returns the current values of the voltage regulator sensors.
+     *
+     * The values come from the sensors table of this application, so they
+     * are all returned in one reply rather than read from each sensor
+     * object on D-Bus.
+     *
+     * @param since sequence number from a previous call to only return the
+     *              sensors that changed after it, or 0 to return all sensors
+     * @return current sequence number and sensor values
+     */
+    std::tuple<uint64_t, std::vector<SensorValue>>
+        getAllSensors(uint64_t since) override;
+
+    /**
+     * Returns the recent values of one voltage regulator sensor.
+     *
+     * The values come from the sensor history stored in memory.
+     *
+     * Throws InvalidArgument if the sensor has no history.
+     *
+     * @param name sensor name
+     * @param since earliest time to return in microseconds since the epoch
+     * @return timestamps in microseconds since the epoch and values
+     */
+    std::vector<SensorHistoryValue>
+        getSensorHistory(const std::string& name, uint64_t since) override;
+
+    /**
+     * Sets the output voltage of a rail at runtime.
+     *
+     * The rail must have a voltage setpoint in the config file.  The device
+     * and chassis of each such rail are found when the config file is loaded,
+     * so the volts value is written to the device without searching the
+     * system or running any rules.
+     *
+     * Throws InvalidArgument if the rail has no voltage setpoint or the volts
+     * value is outside its limits.  Throws Unavailable while the regulators
+     * are being configured or if the device is not powered or present.
+     * Throws InternalFailure if the device could not be written.
+     *
+     * @param rail rail ID
+     * @param volts volts value
+     */
+    void setRailVolts(const std::string& rail, double volts) override;
+
+    /**
+     * Phase fault detection task callback function.
      */
     void phaseFaultTimerExpired();
 
     /**
-     * Sensor monitoring timer expired callback function.
+     * Sensor monitoring task callback function.
      */
     void sensorTimerExpired();
 
@@ -123,6 +346,21 @@ class Manager : public ManagerObject
     void sighupHandler(sdeventplus::source::Signal& sigSrc,
                        const struct signalfd_siginfo* sigInfo);
 
+    /**
+     * Returns the startup times.
+     *
+     * The manager is ready when it has been constructed and owns its D-Bus
+     * service name.  The config file has been loaded by then if the
+     * compatible system types were known.  Otherwise configure() waits for
+     * it.
+     *
+     * @return startup times
+     */
+    util::StartupTimes& getStartupTimes()
+    {
+        return startupTimes;
+    }
+
   private:
     /**
      * Clear any cached data or error history related to hardware devices.
@@ -133,6 +371,56 @@ class Manager : public ManagerObject
      */
     void clearHardwareData();
 
+    /**
+     * Completes the configure job and emits the ConfigureCompleted signal.
+     *
+     * @param success whether the config file was loaded and used to configure
+     *                the regulator devices
+     */
+    void completeConfigure(bool success);
+
+    /**
+     * Configures the regulator devices in the next chassis of the configure
+     * job.  Called from the event loop by the configure step timer.
+     *
+     * Emits the ConfigureProgress signal.  Completes the job after the last
+     * chassis.
+     */
+    void configureNextChassis();
+
+    /**
+     * Configures the devices in the power domains that have not been
+     * configured yet.
+     *
+     * Called if the system is powered on before the standby rails of the
+     * power domains were reported to be on.
+     */
+    void configurePendingPowerDomains();
+
+    /**
+     * Configures the devices in the specified power domain.
+     *
+     * Removes the power domain from pendingPowerDomains and emits the
+     * PowerDomainConfigured signal.
+     *
+     * @param name power domain name
+     */
+    void configurePowerDomain(const std::string& name);
+
+    /**
+     * Deferred configure job callback.  Called when the maximum amount of
+     * time to wait for the compatible system types has elapsed.
+     */
+    void configureTimerExpired();
+
+    /**
+     * Ends the current phase of the configure job and stores how long it
+     * took.
+     *
+     * @param phase phase name
+     */
+    void endConfigurePhase(const std::string& phase);
+
     /**
      * Finds the list of compatible system types using D-Bus methods.
      *
@@ -146,6 +434,21 @@ class Manager : public ManagerObject
      */
     void findCompatibleSystemTypes();
 
+    /**
+     * Finds the JSON configuration file compiled into the binary for the
+     * current system.
+     *
+     * Looks for a compiled configuration file based on the list of compatible
+     * system types.  A file with the same name in the test directory takes
+     * precedence, so a compiled configuration file can still be overridden.
+     *
+     * Throws an exception if an operating system error occurs while checking
+     * for the existence of a file.
+     *
+     * @return compiled configuration file, or nullptr if none found
+     */
+    const CompiledConfig* findCompiledConfig();
+
     /**
      * Finds the JSON configuration file.
      *
@@ -161,6 +464,26 @@ class Manager : public ManagerObject
      */
     std::filesystem::path findConfigFile();
 
+    /**
+     * Returns the possible base names of the JSON configuration file based on
+     * the list of compatible system types.
+     *
+     * @return base file names, in the order of the compatible system types
+     */
+    std::vector<std::string> getCompatibleConfigFileNames() const;
+
+    /**
+     * Returns the interval of the sensor monitoring timer.
+     *
+     * The timer must expire often enough for the sensors of each rail to be
+     * read at that rail's monitoring interval.  The interval is the greatest
+     * common divisor of the rail monitoring intervals, or the default
+     * interval if the config file is not loaded.
+     *
+     * @return sensor monitoring timer interval
+     */
+    std::chrono::milliseconds getSensorMonitoringInterval() const;
+
     /**
      * Returns whether the JSON configuration file has been loaded.
      *
@@ -179,26 +502,100 @@ class Manager : public ManagerObject
      */
     bool isSystemPoweredOn();
 
+    /**
+     * Starts configuring the regulator devices if the configure job is waiting
+     * for the config file.
+     *
+     * Completes the job with an error if the config file has not been loaded.
+     */
+    void finishConfigure();
+
     /**
      * Loads the JSON configuration file.
      *
-     * Looks for the config file using findConfigFile().
+     * Looks for the config file using findCompiledConfig() and then
+     * findConfigFile().
      *
      * If the config file is found, it is parsed and the resulting information
      * is stored in the system data member.  If parsing fails, an error is
      * logged.
+     *
+     * For a large config file, the Chassis objects are only created for the
+     * chassis that are present.  The other chassis are stored in the
+     * deferredChassis data member.
      */
     void loadConfigFile();
 
     /**
-     * Waits until the JSON configuration file has been loaded.
+     * Loads the hardware presence data and VPD values for all inventory
+     * objects into the cache.
+     *
+     * Obtains the inventory objects using a single GetManagedObjects call to
+     * the inventory manager.  This is much faster than obtaining the presence
+     * and VPD values one at a time while configuring the regulators.
+     *
+     * If the inventory objects cannot be obtained, the cache is cleared and
+     * the values are obtained one at a time when needed.
+     */
+    void loadInventoryData();
+
+    /**
+     * Creates the chassis deferred by loadConfigFile() that are now present.
+     *
+     * Adds the new Chassis objects to the system data member.  Chassis that
+     * are not present remain deferred, as do chassis whose presence cannot be
+     * obtained.  If an error occurs creating a chassis, an error is logged and
+     * the chassis is no longer deferred.
+     *
+     * @return true if any chassis were added to the system, false otherwise
+     */
+    bool loadPresentChassis();
+
+    /**
+     * Restores the state saved by the previous instance of the application,
+     * if any.
+     *
+     * Restores the compatible system types, so the config file can be loaded
+     * without waiting for them, and the cached hardware presence data and
+     * VPD values.  Nothing is restored if the saved state is invalid.
+     */
+    void restoreState();
+
+    /**
+     * Runs one sensor monitoring cycle.
+     *
+     * @return time taken by the cycle
+     */
+    std::chrono::microseconds runSensorCycle();
+
+    /**
+     * Saves the state restored by restoreState() for the next instance of the
+     * application.
+     */
+    void saveState();
+
+    /**
+     * Starts the sensor monitoring task, or restarts it with the current
+     * sensor monitoring interval if it is already active.
+     */
+    void startSensorTask();
+
+    /**
+     * Creates the objects that monitor the devices in the system data member.
+     *
+     * Must be called when the devices in the system change.  Restarts the
+     * sensor monitoring task if monitoring is enabled.
+     */
+    void updateExecutors();
+
+    /**
+     * Waits for the workers of the chassis with independent monitoring and
+     * replays their results.
      *
-     * If the config file has not yet been loaded, waits until one of the
-     * following occurs:
-     * - config file is loaded
-     * - maximum amount of time to wait has elapsed
+     * Must be called before the devices in the system are accessed outside
+     * of a sensor monitoring cycle or phase fault detection.
      */
-    void waitUntilConfigFileLoaded();
+    void waitForChassisMonitors();
 
     /**
      * The D-Bus bus
@@ -216,14 +613,154 @@ class Manager : public ManagerObject
     BMCServices services;
 
     /**
-     * Event timer used to initiate phase fault detection.
+     * Scheduler that runs the periodic monitoring tasks from the event loop.
+     * The tasks are spread across the scheduler ticks so phase fault
+     * detection and sensor monitoring do not wake up at the same time.
+     */
+    util::PeriodicScheduler scheduler;
+
+    /**
+     * Periodic task used to initiate phase fault detection.  Not active
+     * while monitoring is disabled.
+     */
+    util::TimerWheel::Task phaseFaultTask{};
+
+    /**
+     * Periodic task used to initiate sensor monitoring.  Not active while
+     * monitoring is disabled.
      */
-    Timer phaseFaultTimer;
+    util::TimerWheel::Task sensorTask{};
 
     /**
-     * Event timer used to initiate sensor monitoring.
+     * Periodic task used to close the I2C devices that have been idle for
+     * their idle timeout.  Always active.
      */
-    Timer sensorTimer;
+    util::TimerWheel::Task idleDeviceTask{};
+
+    /**
+     * Hands the state of the application over to the next instance when the
+     * application is restarted.
+     */
+    util::StateHandoff stateHandoff;
+
+    /**
+     * Periodic task used to save the state for the next instance.  Always
+     * active.
+     */
+    util::TimerWheel::Task stateHandoffTask{};
+
+    /**
+     * Power domains whose devices have not been configured yet.
+     *
+     * Maps each power domain name to the IDs of its standby rails that have
+     * not been reported to be on by the power sequencer.
+     */
+    std::map<std::string, std::set<unsigned int>> pendingPowerDomains{};
+
+    /**
+     * State of the job started by the configure method.
+     */
+    struct ConfigureJob
+    {
+        /**
+         * Indicates whether the job is running.
+         */
+        bool isActive{false};
+
+        /**
+         * Indicates whether the job is waiting for the config file to be
+         * loaded.
+         */
+        bool isWaiting{false};
+
+        /**
+         * Time the job started.
+         */
+        std::chrono::steady_clock::time_point startTime{};
+
+        /**
+         * Time the current phase of the job started.
+         */
+        std::chrono::steady_clock::time_point phaseStartTime{};
+
+        /**
+         * Time taken by each phase of the job in microseconds.
+         */
+        std::map<std::string, uint64_t> phaseTimes{};
+
+        /**
+         * Power domain whose devices are configured.  See System::configure().
+         */
+        std::optional<std::string> powerDomain{};
+
+        /**
+         * Index of the next chassis to configure.
+         */
+        std::size_t chassisIndex{0};
+
+        /**
+         * Time taken to configure the chassis so far.
+         */
+        std::chrono::microseconds devicesTime{0};
+
+        /**
+         * Number of errors that occurred configuring the devices.
+         */
+        unsigned int errorCount{0};
+    };
+
+    /**
+     * Configure job started by the configure method.
+     */
+    ConfigureJob configureJob{};
+
+    /**
+     * Timer that limits how long the configure job waits for the config file
+     * to be loaded.
+     */
+    sdeventplus::utility::Timer<sdeventplus::ClockId::Monotonic>
+        configureTimer;
+
+    /**
+     * Timer that configures the next chassis of the configure job.  Started
+     * with no delay, so the event loop services other events between each
+     * chassis.
+     */
+    sdeventplus::utility::Timer<sdeventplus::ClockId::Monotonic>
+        configureStepTimer;
+
+    /**
+     * Cycle time statistics of sensor monitoring.
+     */
+    util::CycleStatistics sensorCycleStats{};
+
+    /**
+     * Debug D-Bus interface that shows the sensor monitoring cycle time
+     * statistics.
+     */
+    util::CycleStatisticsInterface sensorCycleStatsInterface;
+
+    /**
+     * Times of the startup phases: loading the config file, configuring the
+     * devices, and the first sensor monitoring cycle.
+     */
+    util::StartupTimes startupTimes{};
+
+    /**
+     * Debug D-Bus interface that shows the startup times.
+     */
+    util::StartupTimesInterface startupTimesInterface;
+
+    /**
+     * Probe that measures how late the event loop dispatches timers, and
+     * which handler blocked it.
+     */
+    util::EventLoopLagMonitor lagMonitor;
+
+    /**
+     * Debug D-Bus interface that shows the event loop lag statistics.
+     */
+    util::EventLoopLagInterface lagInterface;
 
     /**
      * List of D-Bus signal matches
@@ -249,6 +786,61 @@ class Manager : public ManagerObject
      * Contains nullptr if the configuration file has not been loaded.
      */
     std::unique_ptr<System> system{};
+
+    /**
+     * Chassis in the JSON configuration file whose Chassis objects have not
+     * been created yet because the chassis is not present.
+     *
+     * Only used for large configuration files.  The Chassis objects for smaller
+     * files are created when the file is loaded.
+     */
+    std::vector<config_file_parser::DeferredChassis> deferredChassis{};
+
+    /**
+     * Executor that monitors the sensors in the System object, reading the
+     * devices on each I2C bus in parallel.
+     *
+     * Contains nullptr if the configuration file has not been loaded.
+     */
+    std::unique_ptr<SensorMonitoringExecutor> sensorMonitoringExecutor{};
+
+    /**
+     * Scheduler that detects phase faults in the System object, spreading the
+     * regulator devices across the phase fault detection timer ticks.
+     *
+     * Contains nullptr if the configuration file has not been loaded.
+     */
+    std::unique_ptr<PhaseFaultDetectionScheduler> phaseFaultScheduler{};
+
+    /**
+     * Monitors of the chassis with independent monitoring enabled.  These
+     * chassis are not monitored by sensorMonitoringExecutor or
+     * phaseFaultScheduler.
+     */
+    std::vector<std::unique_ptr<ChassisMonitor>> chassisMonitors{};
+
+    /**
+     * SMBus alert sources, by I2C bus.  Created the first time an alert is
+     * handled on the bus.
+     */
+    std::map<uint8_t, i2c::AlertSource> alertSources{};
+
+    /**
+     * Voltage setpoint of a rail with the device and chassis that contain the
+     * rail.
+     */
+    struct RailSetpoint
+    {
+        Chassis* chassis{nullptr};
+        Device* device{nullptr};
+        VoltageSetpoint* setpoint{nullptr};
+    };
+
+    /**
+     * Rails whose voltage can be set at runtime, by rail ID.  Updated by
+     * updateExecutors() when the devices in the system change.
+     */
+    std::map<std::string, RailSetpoint> railSetpoints{};
 };
 
 } // namespace phosphor::power::regulators
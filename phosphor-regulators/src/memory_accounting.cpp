@@ -0,0 +1,153 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "memory_accounting.hpp"
+
+#include <array>
+#include <atomic>
+
+namespace phosphor::power::regulators::memory_accounting
+{
+
+namespace
+{
+
+/**
+ * Counters of one tag.
+ *
+ * The counters are constant initialized, so allocations can be recorded
+ * before the static objects of the process are constructed.
+ */
+struct Counters
+{
+    std::atomic<std::size_t> currentBytes{0};
+    std::atomic<std::size_t> peakBytes{0};
+    std::atomic<std::size_t> allocations{0};
+};
+
+std::array<Counters, tagCount> counters{};
+
+std::atomic<bool> enabled{false};
+
+thread_local Tag currentTag{Tag::other};
+
+} // namespace
+
+Scope::Scope(Tag tag) : previousTag{currentTag}
+{
+    currentTag = tag;
+}
+
+Scope::~Scope()
+{
+    currentTag = previousTag;
+}
+
+void enable()
+{
+    enabled.store(true, std::memory_order_relaxed);
+}
+
+Tag getCurrentTag()
+{
+    return currentTag;
+}
+
+const char* getName(Tag tag)
+{
+    switch (tag)
+    {
+        case Tag::configTree:
+            return "config_tree";
+        case Tag::dbusSensors:
+            return "dbus_sensors";
+        case Tag::caches:
+            return "caches";
+        case Tag::errorLogging:
+            return "error_logging";
+        case Tag::other:
+            break;
+    }
+    return "other";
+}
+
+Usage getUsage(Tag tag)
+{
+    const Counters& tagCounters = counters[static_cast<std::size_t>(tag)];
+    return Usage{tagCounters.currentBytes.load(std::memory_order_relaxed),
+                 tagCounters.peakBytes.load(std::memory_order_relaxed),
+                 tagCounters.allocations.load(std::memory_order_relaxed)};
+}
+
+bool isEnabled()
+{
+    return enabled.load(std::memory_order_relaxed);
+}
+
+void recordAllocation(Tag tag, std::size_t size)
+{
+    Counters& tagCounters = counters[static_cast<std::size_t>(tag)];
+    tagCounters.allocations.fetch_add(1, std::memory_order_relaxed);
+    std::size_t bytes =
+        tagCounters.currentBytes.fetch_add(size, std::memory_order_relaxed) +
+        size;
+
+    // Raise the peak if another thread has not already raised it higher
+    std::size_t peak = tagCounters.peakBytes.load(std::memory_order_relaxed);
+    while ((bytes > peak) && !tagCounters.peakBytes.compare_exchange_weak(
+                                 peak, bytes, std::memory_order_relaxed))
+    {}
+}
+
+void recordDeallocation(Tag tag, std::size_t size)
+{
+    Counters& tagCounters = counters[static_cast<std::size_t>(tag)];
+    tagCounters.allocations.fetch_sub(1, std::memory_order_relaxed);
+    tagCounters.currentBytes.fetch_sub(size, std::memory_order_relaxed);
+}
+
+void resetPeaks()
+{
+    for (Counters& tagCounters : counters)
+    {
+        tagCounters.peakBytes.store(
+            tagCounters.currentBytes.load(std::memory_order_relaxed),
+            std::memory_order_relaxed);
+    }
+}
+
+std::string toString()
+{
+    if (!isEnabled())
+    {
+        return "Memory accounting is not enabled in this build\n";
+    }
+
+    std::string text{};
+    for (std::size_t i = 0; i < tagCount; ++i)
+    {
+        Tag tag = static_cast<Tag>(i);
+        Usage usage = getUsage(tag);
+        text += std::string{getName(tag)} +
+                ": current: " + std::to_string(usage.currentBytes) +
+                " bytes, peak: " + std::to_string(usage.peakBytes) +
+                " bytes, allocations: " + std::to_string(usage.allocations) +
+                '\n';
+    }
+    return text;
+}
+
+} // namespace phosphor::power::regulators::memory_accounting
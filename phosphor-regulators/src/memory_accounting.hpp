@@ -0,0 +1,185 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @namespace memory_accounting
+ *
+ * Contains functions for accounting the heap memory used by each subsystem.
+ *
+ * Each heap allocation is tagged with the subsystem that was active on the
+ * current thread when it was made; see Scope.  The current and peak number of
+ * bytes are accumulated for each tag.  A deallocation is accounted to the tag
+ * of the allocation, even if it is made by another subsystem.
+ *
+ * The allocations are only recorded if the phosphor-regulators application is
+ * built with the regulators-memory-accounting option, which replaces the
+ * global operator new and operator delete.  See enable().
+ */
+namespace phosphor::power::regulators::memory_accounting
+{
+
+/**
+ * Subsystem that made a heap allocation.
+ */
+enum class Tag : uint8_t
+{
+    other,
+    configTree,
+    dbusSensors,
+    caches,
+    errorLogging
+};
+
+/**
+ * Number of tags.
+ */
+constexpr std::size_t tagCount{5};
+
+/**
+ * @struct Usage
+ *
+ * Heap memory used by one tag.
+ */
+struct Usage
+{
+    /**
+     * Number of bytes currently allocated.
+     */
+    std::size_t currentBytes{0};
+
+    /**
+     * Highest number of bytes allocated at the same time.
+     */
+    std::size_t peakBytes{0};
+
+    /**
+     * Number of allocations that have not been deallocated.
+     */
+    std::size_t allocations{0};
+};
+
+/**
+ * @class Scope
+ *
+ * Tags the heap allocations made on the current thread from construction
+ * until destruction.
+ *
+ * Scopes may be nested; the previous tag is restored when destroyed.
+ */
+class Scope
+{
+  public:
+    // Specify which compiler-generated methods we want
+    Scope() = delete;
+    Scope(const Scope&) = delete;
+    Scope(Scope&&) = delete;
+    Scope& operator=(const Scope&) = delete;
+    Scope& operator=(Scope&&) = delete;
+
+    /**
+     * Constructor.
+     *
+     * @param tag tag of the allocations made in this scope
+     */
+    explicit Scope(Tag tag);
+
+    /**
+     * Destructor.  Restores the previous tag.
+     */
+    ~Scope();
+
+  private:
+    /**
+     * Tag that was current when this scope was constructed.
+     */
+    Tag previousTag;
+};
+
+/**
+ * Enables recording the allocations.
+ *
+ * Called when the global operator new is replaced by one that records the
+ * allocations.
+ */
+void enable();
+
+/**
+ * Returns the tag of the allocations made on the current thread.
+ *
+ * @return current tag
+ */
+Tag getCurrentTag();
+
+/**
+ * Returns the name of the specified tag, such as "config_tree".
+ *
+ * @param tag tag
+ * @return tag name
+ */
+const char* getName(Tag tag);
+
+/**
+ * Returns the heap memory used by the specified tag.
+ *
+ * @param tag tag
+ * @return memory usage
+ */
+Usage getUsage(Tag tag);
+
+/**
+ * Returns whether the allocations are recorded.
+ *
+ * @return true if enabled, false otherwise
+ */
+bool isEnabled();
+
+/**
+ * Records an allocation.
+ *
+ * @param tag tag of the allocation
+ * @param size number of bytes allocated
+ */
+void recordAllocation(Tag tag, std::size_t size);
+
+/**
+ * Records a deallocation.
+ *
+ * @param tag tag of the allocation
+ * @param size number of bytes that were allocated
+ */
+void recordDeallocation(Tag tag, std::size_t size);
+
+/**
+ * Sets the peak number of bytes of each tag to the current number of bytes.
+ */
+void resetPeaks();
+
+/**
+ * Returns the heap memory used by each tag as text.
+ *
+ * Each line contains the tag name followed by the current and peak number of
+ * bytes and the number of allocations.
+ *
+ * @return memory usage text
+ */
+std::string toString();
+
+} // namespace phosphor::power::regulators::memory_accounting
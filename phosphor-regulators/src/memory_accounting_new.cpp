@@ -0,0 +1,83 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Replaces the global operator new and operator delete to record the heap
+// allocations of the phosphor-regulators application by tag.  Only linked into
+// the application when it is built with the regulators-memory-accounting
+// option.
+
+#include "memory_accounting.hpp"
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+using namespace phosphor::power::regulators;
+
+namespace
+{
+
+/**
+ * Header stored before each allocation.  Contains the size and tag so the
+ * deallocation can be accounted to the tag of the allocation.
+ */
+struct alignas(std::max_align_t) AllocationHeader
+{
+    std::size_t size;
+    memory_accounting::Tag tag;
+};
+
+/**
+ * Enables memory accounting when the process starts.
+ */
+[[maybe_unused]] const bool isAccountingEnabled =
+    (memory_accounting::enable(), true);
+
+} // namespace
+
+void* operator new(std::size_t size)
+{
+    void* block{nullptr};
+    while ((block = std::malloc(sizeof(AllocationHeader) + size)) == nullptr)
+    {
+        std::new_handler handler = std::get_new_handler();
+        if (handler == nullptr)
+        {
+            throw std::bad_alloc{};
+        }
+        handler();
+    }
+
+    auto* header = new (block)
+        AllocationHeader{size, memory_accounting::getCurrentTag()};
+    memory_accounting::recordAllocation(header->tag, size);
+    return header + 1;
+}
+
+void operator delete(void* ptr) noexcept
+{
+    if (ptr != nullptr)
+    {
+        auto* header = static_cast<AllocationHeader*>(ptr) - 1;
+        memory_accounting::recordDeallocation(header->tag, header->size);
+        std::free(header);
+    }
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    operator delete(ptr);
+}
@@ -43,21 +43,37 @@ constexpr unsigned short maxActionErrorCount{3};
 constexpr unsigned short requiredConsecutiveFaults{2};
 
 void PhaseFaultDetection::execute(Services& services, System& system,
-                                  Chassis& /*chassis*/, Device& regulator)
+                                  Chassis& chassis, Device& regulator)
+{
+    ActionEnvironment environment{system.getIDMap(), regulator.getIDSymbol(),
+                                  services};
+    execute(services, system, chassis, regulator, environment);
+}
+
+void PhaseFaultDetection::execute(Services& services, System& /*system*/,
+                                  Chassis& /*chassis*/, Device& regulator,
+                                  ActionEnvironment& environment)
 {
     try
     {
         // Find the device ID to use.  If the deviceID data member is empty, use
         // the ID of the specified regulator.
-        const std::string& effectiveDeviceID =
-            deviceID.empty() ? regulator.getID() : deviceID;
+        Symbol effectiveDeviceID =
+            deviceID.empty() ? regulator.getIDSymbol() : deviceID;
 
-        // Create ActionEnvironment
-        ActionEnvironment environment{system.getIDMap(), effectiveDeviceID,
-                                      services};
+        // Reset ActionEnvironment for this regulator
+        environment.reset(effectiveDeviceID);
 
-        // Execute the actions to detect phase faults
-        action_utils::execute(actions, environment);
+        // Execute the actions to detect phase faults, using the compiled
+        // program if available
+        if (program)
+        {
+            program->execute(environment);
+        }
+        else
+        {
+            action_utils::execute(actions, environment);
+        }
 
         // Check for any N or N+1 phase faults that were detected
         checkForPhaseFault(PhaseFaultType::n, services, regulator, environment);
@@ -70,7 +86,7 @@ void PhaseFaultDetection::execute(Services& services, System& system,
         if (actionErrorCount < maxActionErrorCount)
         {
             ++actionErrorCount;
-            services.getJournal().logError(exception_utils::getMessages(e));
+            services.getJournal().logError(exception_utils::MessageView{e});
             services.getJournal().logError(
                 "Unable to detect phase faults in regulator " +
                 regulator.getID());
@@ -83,6 +99,14 @@ void PhaseFaultDetection::execute(Services& services, System& system,
     }
 }
 
+bool PhaseFaultDetection::isConfirming() const
+{
+    return ((nFaultCount > 0) &&
+            !errorHistory.wasLogged(toErrorType(PhaseFaultType::n))) ||
+           ((nPlus1FaultCount > 0) &&
+            !errorHistory.wasLogged(toErrorType(PhaseFaultType::n_plus_1)));
+}
+
 void PhaseFaultDetection::checkForPhaseFault(PhaseFaultType faultType,
                                              Services& services,
                                              Device& regulator,
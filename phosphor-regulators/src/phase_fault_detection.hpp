@@ -16,10 +16,12 @@
 #pragma once
 
 #include "action.hpp"
+#include "action_program.hpp"
 #include "action_environment.hpp"
 #include "error_history.hpp"
 #include "phase_fault.hpp"
 #include "services.hpp"
+#include "symbol.hpp"
 
 #include <memory>
 #include <string>
@@ -97,6 +99,20 @@ class PhaseFaultDetection
         nPlus1FaultCount = 0;
     }
 
+    /**
+     * Compiles the actions into an ActionProgram.
+     *
+     * The compiled program is used by execute() instead of interpreting the
+     * actions.  This method should be called after the System has been
+     * created, since the rules run by the actions must be resolved.
+     *
+     * @param idMap mapping from IDs to the associated Device/Rule objects
+     */
+    void compile(const IDMap& idMap)
+    {
+        program = std::make_unique<ActionProgram>(actions, idMap);
+    }
+
     /**
      * Executes the actions that detect phase faults in the regulator.
      *
@@ -111,6 +127,24 @@ class PhaseFaultDetection
     void execute(Services& services, System& system, Chassis& chassis,
                  Device& regulator);
 
+    /**
+     * Executes the actions that detect phase faults in the regulator using the
+     * specified action environment.
+     *
+     * The environment is reset before the actions are executed.  This allows
+     * one environment to be reused for multiple regulators without allocating
+     * memory.  The environment must use the IDMap of the specified system and
+     * the specified services.
+     *
+     * @param services system services like error logging and the journal
+     * @param system system that contains the chassis
+     * @param chassis chassis that contains the regulator device
+     * @param regulator voltage regulator device
+     * @param environment action execution environment to reuse
+     */
+    void execute(Services& services, System& system, Chassis& chassis,
+                 Device& regulator, ActionEnvironment& environment);
+
     /**
      * Returns the actions that detect phase faults in the regulator.
      *
@@ -131,7 +165,45 @@ class PhaseFaultDetection
      */
     const std::string& getDeviceID() const
     {
-        return deviceID;
+        return deviceID.str();
+    }
+
+    /**
+     * Returns whether a phase fault has been detected that has not been
+     * confirmed yet.
+     *
+     * A phase fault error is only logged after the fault has been detected
+     * a required number of consecutive times.  A fault that does not need
+     * to be detected again to be logged, or that has already been logged,
+     * is not pending.
+     *
+     * @return true if a phase fault is waiting to be confirmed or cleared
+     */
+    bool isConfirming() const;
+
+    /**
+     * Returns the compiled program, if any.
+     *
+     * @return pointer to compiled program, or nullptr if not compiled
+     */
+    const ActionProgram* getProgram() const
+    {
+        return program.get();
+    }
+
+    /**
+     * Links the actions.
+     *
+     * See Action::link() for more information.
+     *
+     * @param idMap mapping from IDs to the associated Device/Rule objects
+     */
+    void linkActions(const IDMap& idMap)
+    {
+        for (std::unique_ptr<Action>& action : actions)
+        {
+            action->link(idMap);
+        }
     }
 
   private:
@@ -169,6 +241,11 @@ class PhaseFaultDetection
      */
     std::vector<std::unique_ptr<Action>> actions{};
 
+    /**
+     * Actions compiled into a program, if compile() has been called.
+     */
+    std::unique_ptr<ActionProgram> program{};
+
     /**
      * Unique ID of the device to use when detecting phase faults.
      *
@@ -177,7 +254,7 @@ class PhaseFaultDetection
      *
      * If the value is "", the regulator will be used.
      */
-    const std::string deviceID{};
+    const Symbol deviceID;
 
     /**
      * History of which error types have been logged.
@@ -0,0 +1,91 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "phase_fault_detection_scheduler.hpp"
+
+#include "action_environment.hpp"
+#include "chassis.hpp"
+#include "device.hpp"
+#include "phase_fault_detection.hpp"
+#include "system.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+namespace phosphor::power::regulators
+{
+
+PhaseFaultDetectionScheduler::PhaseFaultDetectionScheduler(
+    System& system, std::size_t sliceCount) :
+    system{system},
+    sliceCount{std::max(sliceCount, std::size_t{1})}
+{
+    // Find the devices with phase fault detection, keeping the configuration
+    // file order
+    for (const std::unique_ptr<Chassis>& chassis : system.getChassis())
+    {
+        addDevices(*chassis);
+    }
+}
+
+PhaseFaultDetectionScheduler::PhaseFaultDetectionScheduler(
+    System& system, const std::vector<Chassis*>& chassis,
+    std::size_t sliceCount) :
+    system{system},
+    sliceCount{std::max(sliceCount, std::size_t{1})}
+{
+    for (Chassis* element : chassis)
+    {
+        addDevices(*element);
+    }
+}
+
+void PhaseFaultDetectionScheduler::addDevices(Chassis& chassis)
+{
+    for (const std::unique_ptr<Device>& device : chassis.getDevices())
+    {
+        if (device->getPhaseFaultDetection())
+        {
+            devices.emplace_back(&chassis, device.get());
+        }
+    }
+}
+
+void PhaseFaultDetectionScheduler::execute(Services& services)
+{
+    // Find the devices in the next slice.  Spread the devices evenly so the
+    // slice sizes differ by at most one device.
+    std::size_t first = nextSlice * devices.size() / sliceCount;
+    std::size_t last = (nextSlice + 1) * devices.size() / sliceCount;
+    nextSlice = (nextSlice + 1) % sliceCount;
+
+    // Detect phase faults in each device, reusing the same environment.
+    // Devices outside the slice are checked again if a phase fault was
+    // detected and needs to be confirmed.
+    ActionEnvironment environment{system.getIDMap(), Symbol{}, services};
+    for (std::size_t index = 0; index < devices.size(); ++index)
+    {
+        auto [chassis, device] = devices[index];
+        if (((index >= first) && (index < last)) ||
+            device->getPhaseFaultDetection()->isConfirming())
+        {
+            device->detectPhaseFaults(services, system, *chassis, environment);
+        }
+    }
+}
+
+} // namespace phosphor::power::regulators
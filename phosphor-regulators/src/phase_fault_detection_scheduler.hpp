@@ -0,0 +1,169 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#pragma once
+
+#include "services.hpp"
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace phosphor::power::regulators
+{
+
+// Forward declarations to avoid circular dependencies
+class Chassis;
+class Device;
+class System;
+
+/**
+ * @class PhaseFaultDetectionScheduler
+ *
+ * Detects redundant phase faults in the regulator devices in the system,
+ * spreading the devices across several timer ticks.
+ *
+ * The regulator devices with phase fault detection are divided into slices of
+ * about the same size.  Each call to execute() detects phase faults in the
+ * next slice.  After the last slice, the first slice is used again.  Each
+ * device is therefore checked once every sliceCount calls, and the I2C
+ * traffic is spread out instead of occurring in one burst.
+ *
+ * Calling execute() at an interval of the phase fault detection period
+ * divided by the slice count keeps the same period for each device.
+ *
+ * A phase fault must be detected several consecutive times before it is
+ * logged (see PhaseFaultDetection).  After a fault is first detected in a
+ * device, the device is also checked by every later call to execute() until
+ * the fault is confirmed or cleared.  This shortens the time to confirm a
+ * fault from several periods to several timer ticks, without increasing the
+ * I2C traffic of the devices without faults.
+ */
+class PhaseFaultDetectionScheduler
+{
+  public:
+    // Specify which compiler-generated methods we want
+    PhaseFaultDetectionScheduler() = delete;
+    PhaseFaultDetectionScheduler(const PhaseFaultDetectionScheduler&) = delete;
+    PhaseFaultDetectionScheduler(PhaseFaultDetectionScheduler&&) = delete;
+    PhaseFaultDetectionScheduler&
+        operator=(const PhaseFaultDetectionScheduler&) = delete;
+    PhaseFaultDetectionScheduler&
+        operator=(PhaseFaultDetectionScheduler&&) = delete;
+    ~PhaseFaultDetectionScheduler() = default;
+
+    /**
+     * Constructor.
+     *
+     * Divides the regulator devices with phase fault detection into the
+     * specified number of slices.
+     *
+     * @param system system whose regulator devices will be checked
+     * @param sliceCount number of slices.  One slice is used if 0 is
+     *                   specified.
+     */
+    explicit PhaseFaultDetectionScheduler(System& system,
+                                          std::size_t sliceCount);
+
+    /**
+     * Constructor.
+     *
+     * Divides the regulator devices with phase fault detection in the
+     * specified chassis into the specified number of slices.  The devices in
+     * other chassis are not checked.
+     *
+     * @param system system that contains the chassis
+     * @param chassis chassis whose regulator devices will be checked
+     * @param sliceCount number of slices.  One slice is used if 0 is
+     *                   specified.
+     */
+    PhaseFaultDetectionScheduler(System& system,
+                                 const std::vector<Chassis*>& chassis,
+                                 std::size_t sliceCount);
+
+    /**
+     * Detects redundant phase faults in the devices in the next slice and in
+     * the devices with a phase fault waiting to be confirmed.
+     *
+     * This method should be called repeatedly based on a timer.
+     *
+     * @param services system services like error logging and the journal
+     */
+    void execute(Services& services);
+
+    /**
+     * Returns the number of devices with phase fault detection.
+     *
+     * @return number of devices
+     */
+    std::size_t getDeviceCount() const
+    {
+        return devices.size();
+    }
+
+    /**
+     * Returns the index of the slice that will be used by the next call to
+     * execute().
+     *
+     * @return slice index
+     */
+    std::size_t getNextSlice() const
+    {
+        return nextSlice;
+    }
+
+    /**
+     * Returns the number of slices the devices are divided into.
+     *
+     * @return number of slices
+     */
+    std::size_t getSliceCount() const
+    {
+        return sliceCount;
+    }
+
+  private:
+    /**
+     * Adds the regulator devices with phase fault detection in the specified
+     * chassis, keeping the configuration file order.
+     *
+     * @param chassis chassis that contains the devices
+     */
+    void addDevices(Chassis& chassis);
+
+    /**
+     * System whose regulator devices are checked.
+     */
+    System& system;
+
+    /**
+     * Number of slices the devices are divided into.
+     */
+    const std::size_t sliceCount;
+
+    /**
+     * Regulator devices with phase fault detection and the chassis that
+     * contains each device.  In the same order as the configuration file.
+     */
+    std::vector<std::pair<Chassis*, Device*>> devices{};
+
+    /**
+     * Index of the slice used by the next call to execute().
+     */
+    std::size_t nextSlice{0};
+};
+
+} // namespace phosphor::power::regulators
@@ -0,0 +1,96 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace phosphor::power::regulators
+{
+
+/**
+ * @class PowerDomain
+ *
+ * Power domain that a device belongs to.
+ *
+ * A power domain is a group of devices that are powered by the same standby
+ * rails of the power sequencer.  The devices in a power domain can be
+ * configured as soon as those rails are on, while the power sequencer is still
+ * powering on the rest of the system.  This allows devices to be configured in
+ * parallel with power sequencing rather than before it.
+ *
+ * The standby rails are identified by the rail state IDs reported by the power
+ * sequencer in its RailStateChanged D-Bus signal.
+ */
+class PowerDomain
+{
+  public:
+    // Specify which compiler-generated methods we want
+    PowerDomain() = delete;
+    PowerDomain(const PowerDomain&) = delete;
+    PowerDomain(PowerDomain&&) = delete;
+    PowerDomain& operator=(const PowerDomain&) = delete;
+    PowerDomain& operator=(PowerDomain&&) = delete;
+    ~PowerDomain() = default;
+
+    /**
+     * Constructor.
+     *
+     * @param name power domain name
+     * @param sequencerRails IDs of the power sequencer rails that must be on
+     *                       before the devices in the domain are configured
+     */
+    explicit PowerDomain(const std::string& name,
+                         std::vector<unsigned int> sequencerRails) :
+        name{name}, sequencerRails{std::move(sequencerRails)}
+    {}
+
+    /**
+     * Returns the name of this power domain.
+     *
+     * @return power domain name
+     */
+    const std::string& getName() const
+    {
+        return name;
+    }
+
+    /**
+     * Returns the IDs of the power sequencer rails that must be on before the
+     * devices in this power domain are configured.
+     *
+     * @return power sequencer rail IDs
+     */
+    const std::vector<unsigned int>& getSequencerRails() const
+    {
+        return sequencerRails;
+    }
+
+  private:
+    /**
+     * Power domain name.
+     */
+    const std::string name{};
+
+    /**
+     * IDs of the power sequencer rails that must be on before the devices in
+     * this power domain are configured.
+     */
+    std::vector<unsigned int> sequencerRails{};
+};
+
+} // namespace phosphor::power::regulators
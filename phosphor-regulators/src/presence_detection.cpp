@@ -24,6 +24,7 @@
 #include "exception_utils.hpp"
 #include "system.hpp"
 
+#include <chrono>
 #include <exception>
 
 namespace phosphor::power::regulators
@@ -32,26 +33,37 @@ namespace phosphor::power::regulators
 bool PresenceDetection::execute(Services& services, System& system,
                                 Chassis& /*chassis*/, Device& device)
 {
+    // If the cached presence value has expired
+    auto now = std::chrono::steady_clock::now();
+    if (isPresent.has_value() && cacheTTL.has_value() &&
+        (now - detectionTime >= *cacheTTL))
+    {
+        isPresent.reset();
+    }
+
     // If no presence value is cached
     if (!isPresent.has_value())
     {
         // Initially assume device is present
         isPresent = true;
+        detectionTime = now;
 
         // Execute actions to find device presence
         try
         {
             // Create ActionEnvironment
-            ActionEnvironment environment{system.getIDMap(), device.getID(),
-                                          services};
+            ActionEnvironment environment{system.getIDMap(),
+                                          device.getIDSymbol(), services};
 
-            // Execute the actions and cache resulting value
-            isPresent = action_utils::execute(actions, environment);
+            // Execute the actions and cache resulting value.  Use the
+            // compiled program if available.
+            isPresent = program ? program->execute(environment)
+                                : action_utils::execute(actions, environment);
         }
         catch (const std::exception& e)
         {
             // Log error messages in journal
-            services.getJournal().logError(exception_utils::getMessages(e));
+            services.getJournal().logError(exception_utils::MessageView{e});
             services.getJournal().logError("Unable to determine presence of " +
                                            device.getID());
 
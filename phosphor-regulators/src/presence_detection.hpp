@@ -16,10 +16,13 @@
 #pragma once
 
 #include "action.hpp"
+#include "action_program.hpp"
 #include "services.hpp"
 
+#include <chrono>
 #include <memory>
 #include <optional>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -53,6 +56,16 @@ class System;
  * configuration).  When the system is re-booted, presence will be re-detected.
  * As a result, presence detection is not supported for devices that can be
  * removed or added (hot-plugged) while the system is booted and running.
+ *
+ * The exception is presence detection whose actions only depend on the
+ * presence of other hardware, such as ComparePresenceAction.  The inventory
+ * paths of that hardware are found when the actions are compiled, and the
+ * cached presence value is only cleared when the presence of that hardware
+ * changes.  See System::clearPresenceCache().
+ *
+ * Presence detection for devices that can be hot-plugged can specify a cache
+ * time to live (TTL).  The cached presence value expires after the TTL, and it
+ * is cleared when the presence of any hardware changes.
  */
 class PresenceDetection
 {
@@ -69,9 +82,14 @@ class PresenceDetection
      * Constructor.
      *
      * @param actions actions that detect whether the device is present
+     * @param cacheTTL time to live of the cached presence value, or no value
+     *                 if presence is only detected once per boot
      */
-    explicit PresenceDetection(std::vector<std::unique_ptr<Action>> actions) :
-        actions{std::move(actions)}
+    explicit PresenceDetection(
+        std::vector<std::unique_ptr<Action>> actions,
+        std::optional<std::chrono::milliseconds> cacheTTL = {}) :
+        actions{std::move(actions)},
+        cacheTTL{cacheTTL}
     {}
 
     /**
@@ -82,6 +100,31 @@ class PresenceDetection
         isPresent.reset();
     }
 
+    /**
+     * Returns whether the actions only depend on the presence of other
+     * hardware.
+     *
+     * @return true if the inventory paths of the hardware are known
+     */
+    bool dependsOnlyOnPresence() const
+    {
+        return inventoryPaths.has_value();
+    }
+
+    /**
+     * Compiles the actions into an ActionProgram.
+     *
+     * The compiled program is used by execute() instead of interpreting the
+     * actions.  This method should be called after the System has been
+     * created, since the rules run by the actions must be resolved.
+     *
+     * @param idMap mapping from IDs to the associated Device/Rule objects
+     */
+    void compile(const IDMap& idMap)
+    {
+        program = std::make_unique<ActionProgram>(actions, idMap);
+    }
+
     /**
      * Executes the actions to detect whether the device is present.
      *
@@ -93,7 +136,8 @@ class PresenceDetection
      * return the cached value rather than re-executing the actions.  This
      * provides a performance improvement since the actions may be expensive to
      * execute, such as I2C reads or D-Bus method calls.  The cached value can
-     * be cleared by calling clearCache().
+     * be cleared by calling clearCache().  If a cache TTL was specified, the
+     * actions are re-executed once the cached value is older than the TTL.
      *
      * @return true if device is present, false otherwise
      */
@@ -110,6 +154,17 @@ class PresenceDetection
         return actions;
     }
 
+    /**
+     * Returns the time to live of the cached presence value, if any.
+     *
+     * @return cache TTL, or no value if presence is only detected once per
+     *         boot
+     */
+    const std::optional<std::chrono::milliseconds>& getCacheTTL() const
+    {
+        return cacheTTL;
+    }
+
     /**
      * Returns the cached presence value, if any.
      *
@@ -120,16 +175,87 @@ class PresenceDetection
         return isPresent;
     }
 
+    /**
+     * Returns the inventory paths of the hardware whose presence the actions
+     * depend on, if the actions only depend on the presence of other hardware.
+     *
+     * @return inventory paths, or no value if the actions depend on other data
+     */
+    const std::optional<std::vector<std::string>>& getInventoryPaths() const
+    {
+        return inventoryPaths;
+    }
+
+    /**
+     * Returns the compiled program, if any.
+     *
+     * @return pointer to compiled program, or nullptr if not compiled
+     */
+    const ActionProgram* getProgram() const
+    {
+        return program.get();
+    }
+
+    /**
+     * Links the actions.
+     *
+     * See Action::link() for more information.
+     *
+     * @param idMap mapping from IDs to the associated Device/Rule objects
+     */
+    void linkActions(const IDMap& idMap)
+    {
+        for (std::unique_ptr<Action>& action : actions)
+        {
+            action->link(idMap);
+        }
+    }
+
+    /**
+     * Sets the inventory paths of the hardware whose presence the actions
+     * depend on.
+     *
+     * @param inventoryPaths inventory paths, or no value if the actions depend
+     *                       on other data, such as VPD or device registers
+     */
+    void setInventoryPaths(
+        std::optional<std::vector<std::string>> inventoryPaths)
+    {
+        this->inventoryPaths = std::move(inventoryPaths);
+    }
+
   private:
     /**
      * Actions that detect whether the device is present.
      */
     std::vector<std::unique_ptr<Action>> actions{};
 
+    /**
+     * Actions compiled into a program, if compile() has been called.
+     */
+    std::unique_ptr<ActionProgram> program{};
+
     /**
      * Cached presence value.  Initially has no value.
      */
     std::optional<bool> isPresent{};
+
+    /**
+     * Time to live of the cached presence value.  Has no value if presence is
+     * only detected once per boot.
+     */
+    const std::optional<std::chrono::milliseconds> cacheTTL{};
+
+    /**
+     * Time when the cached presence value was detected.
+     */
+    std::chrono::steady_clock::time_point detectionTime{};
+
+    /**
+     * Inventory paths of the hardware whose presence the actions depend on.
+     * Has no value if the actions depend on other data.
+     */
+    std::optional<std::vector<std::string>> inventoryPaths{};
 };
 
 } // namespace phosphor::power::regulators
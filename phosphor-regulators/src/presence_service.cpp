@@ -16,50 +16,180 @@
 
 #include "presence_service.hpp"
 
+#include "memory_accounting.hpp"
 #include "types.hpp"
 #include "utility.hpp"
 
+#include <exception>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
 namespace phosphor::power::regulators
 {
 
-bool DBusPresenceService::isPresent(const std::string& inventoryPath)
+DBusPresenceService::DBusPresenceService(sdbusplus::bus::bus& bus) : bus{bus}
 {
-    // Initially assume hardware is not present
-    bool present{false};
+    namespace rules = sdbusplus::bus::match::rules;
+    std::string matchStr = rules::type::signal() +
+                           rules::member("PropertiesChanged") +
+                           rules::interface(util::PROPERTY_INTF) +
+                           rules::path_namespace(INVENTORY_OBJ_PATH) +
+                           rules::argN(0, INVENTORY_IFACE);
+    propertiesChangedMatch = std::make_unique<sdbusplus::bus::match_t>(
+        bus, matchStr,
+        std::bind(&DBusPresenceService::propertiesChangedHandler, this,
+                  std::placeholders::_1));
+}
 
+bool DBusPresenceService::isPresent(const std::string& inventoryPath)
+{
     // Try to find cached presence value
-    auto it = cache.find(inventoryPath);
-    if (it != cache.end())
+    std::optional<bool> cachedPresent = getCachedPresence(inventoryPath);
+    if (cachedPresent)
     {
-        present = it->second;
+        return *cachedPresent;
     }
-    else
+
+    // Get presence from D-Bus interface/property.  Initially assume hardware
+    // is not present.
+    bool present{false};
+    try
+    {
+        util::getProperty(INVENTORY_IFACE, PRESENT_PROP, inventoryPath,
+                          INVENTORY_MGR_IFACE, bus, present);
+    }
+    catch (const sdbusplus::exception::exception& e)
     {
-        // Get presence from D-Bus interface/property
-        try
+        // If exception type is expected and indicates hardware not present
+        if (isExpectedException(e))
+        {
+            present = false;
+        }
+        else
         {
-            util::getProperty(INVENTORY_IFACE, PRESENT_PROP, inventoryPath,
-                              INVENTORY_MGR_IFACE, bus, present);
+            // Re-throw unexpected exception
+            throw;
         }
-        catch (const sdbusplus::exception::exception& e)
+    }
+
+    // Cache presence value
+    memory_accounting::Scope memoryScope{memory_accounting::Tag::caches};
+    std::unique_lock<std::shared_mutex> lock{mutex};
+    cache[inventoryPath] = present;
+    return present;
+}
+
+void DBusPresenceService::loadCache(const InventoryObjects& objects)
+{
+    memory_accounting::Scope memoryScope{memory_accounting::Tag::caches};
+    std::map<std::string, bool> newCache{};
+    for (const auto& [path, interfaces] : objects)
+    {
+        auto interfaceIt = interfaces.find(INVENTORY_IFACE);
+        if (interfaceIt != interfaces.end())
         {
-            // If exception type is expected and indicates hardware not present
-            if (isExpectedException(e))
+            auto propertyIt = interfaceIt->second.find(PRESENT_PROP);
+            if (propertyIt != interfaceIt->second.end())
             {
-                present = false;
+                const bool* present = std::get_if<bool>(&propertyIt->second);
+                if (present != nullptr)
+                {
+                    newCache[path.str] = *present;
+                }
             }
-            else
+        }
+    }
+
+    // Find the cached values that changed or were removed.  Values that were
+    // not cached before are not changes.
+    std::vector<std::string> changedPaths{};
+    {
+        std::unique_lock<std::shared_mutex> lock{mutex};
+        for (const auto& [path, present] : cache)
+        {
+            auto it = newCache.find(path);
+            if ((it == newCache.end()) || (it->second != present))
             {
-                // Re-throw unexpected exception
-                throw;
+                changedPaths.emplace_back(path);
             }
         }
 
-        // Cache presence value
-        cache[inventoryPath] = present;
+        cache = std::move(newCache);
+        if (!changedPaths.empty())
+        {
+            ++generation;
+        }
     }
 
-    return present;
+    for (const std::string& path : changedPaths)
+    {
+        notifyChanged(path);
+    }
+}
+
+void DBusPresenceService::propertiesChangedHandler(
+    sdbusplus::message::message& msg)
+{
+    // Verify message is valid
+    if (!msg)
+    {
+        return;
+    }
+
+    std::string path = msg.get_path();
+    try
+    {
+        std::string interface;
+        InventoryProperties properties;
+        msg.read(interface, properties);
+
+        auto it = properties.find(PRESENT_PROP);
+        if (it != properties.end())
+        {
+            const bool* present = std::get_if<bool>(&it->second);
+            {
+                memory_accounting::Scope memoryScope{
+                    memory_accounting::Tag::caches};
+                std::unique_lock<std::shared_mutex> lock{mutex};
+                auto cacheIt = cache.find(path);
+                if ((present != nullptr) && (cacheIt != cache.end()) &&
+                    (cacheIt->second == *present))
+                {
+                    // Value did not change
+                    return;
+                }
+
+                // Results computed from the previous value must not be reused
+                ++generation;
+                if (present != nullptr)
+                {
+                    cache[path] = *present;
+                }
+                else
+                {
+                    cache.erase(path);
+                }
+            }
+            notifyChanged(path);
+        }
+    }
+    catch (const std::exception&)
+    {
+        // Unable to read the new value; obtain it from D-Bus when needed
+        {
+            std::unique_lock<std::shared_mutex> lock{mutex};
+            cache.erase(path);
+            ++generation;
+        }
+        notifyChanged(path);
+    }
 }
 
 bool DBusPresenceService::isExpectedException(
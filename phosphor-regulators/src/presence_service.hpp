@@ -15,11 +15,22 @@
  */
 #pragma once
 
+#include "inventory_objects.hpp"
+
 #include <sdbusplus/bus.hpp>
+#include <sdbusplus/bus/match.hpp>
 #include <sdbusplus/exception.hpp>
+#include <sdbusplus/message.hpp>
 
+#include <cstdint>
+#include <functional>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
 #include <string>
+#include <utility>
 
 namespace phosphor::power::regulators
 {
@@ -47,6 +58,31 @@ class PresenceService
      */
     virtual void clearCache(void) = 0;
 
+    /**
+     * Returns the cached presence value of the hardware with the specified
+     * inventory path.
+     *
+     * Unlike isPresent(), the value is not obtained if it is not cached and
+     * the cache is not modified.  Several threads can call this at the same
+     * time as long as no other methods are called.
+     *
+     * @param inventoryPath D-Bus inventory path of the hardware
+     * @return cached presence value, or no value if it is not cached
+     */
+    virtual std::optional<bool>
+        getCachedPresence(const std::string& inventoryPath) = 0;
+
+    /**
+     * Returns the generation of the cached hardware presence data.
+     *
+     * The generation changes whenever a cached presence value changes or is
+     * removed.  Results computed from presence values can be reused while the
+     * generation is the same.
+     *
+     * @return generation, or 0 if changes are not tracked
+     */
+    virtual uint64_t getGeneration(void) = 0;
+
     /**
      * Returns whether the hardware with the specified inventory path is
      * present.
@@ -66,6 +102,10 @@ class PresenceService
  * @class DBusPresenceService
  *
  * Implementation of the PresenceService interface using D-Bus method calls.
+ *
+ * The cache is protected by a lock, so worker threads can read cached values
+ * with getCachedPresence() while the event loop thread updates them.  Only
+ * the event loop thread should obtain values from D-Bus.
  */
 class DBusPresenceService : public PresenceService
 {
@@ -81,20 +121,102 @@ class DBusPresenceService : public PresenceService
     /**
      * Constructor.
      *
+     * Subscribes to PropertiesChanged signals for inventory objects so that
+     * cached presence values are updated when they change.
+     *
      * @param bus D-Bus bus object
      */
-    explicit DBusPresenceService(sdbusplus::bus::bus& bus) : bus{bus}
-    {}
+    explicit DBusPresenceService(sdbusplus::bus::bus& bus);
 
     /** @copydoc PresenceService::clearCache() */
     virtual void clearCache(void) override
     {
-        cache.clear();
+        {
+            std::unique_lock<std::shared_mutex> lock{mutex};
+            cache.clear();
+            ++generation;
+        }
+        notifyChanged(std::string{});
+    }
+
+    /** @copydoc PresenceService::getCachedPresence() */
+    virtual std::optional<bool>
+        getCachedPresence(const std::string& inventoryPath) override
+    {
+        std::shared_lock<std::shared_mutex> lock{mutex};
+        auto it = cache.find(inventoryPath);
+        if (it == cache.end())
+        {
+            return std::nullopt;
+        }
+        return it->second;
+    }
+
+    /** @copydoc PresenceService::getGeneration() */
+    virtual uint64_t getGeneration(void) override
+    {
+        std::shared_lock<std::shared_mutex> lock{mutex};
+        return generation;
     }
 
     /** @copydoc PresenceService::isPresent() */
     virtual bool isPresent(const std::string& inventoryPath) override;
 
+    /**
+     * Replaces the cached presence data with the presence values in the
+     * specified inventory objects.
+     *
+     * Objects that do not contain a presence value are not cached.  Their
+     * presence is obtained from D-Bus when isPresent() is called.
+     *
+     * Only the cached values that changed are reported to the change handler.
+     *
+     * @param objects inventory objects from the inventory manager
+     */
+    void loadCache(const InventoryObjects& objects);
+
+    /**
+     * Returns the cached presence data, so it can be handed over to the next
+     * instance of the application.
+     *
+     * @return map from inventory paths to presence values
+     */
+    std::map<std::string, bool> getCache()
+    {
+        std::shared_lock<std::shared_mutex> lock{mutex};
+        return cache;
+    }
+
+    /**
+     * Replaces the cached presence data with the values cached by a previous
+     * instance of the application.
+     *
+     * The change handler is not called, so this should be called before any
+     * cached values are used.
+     *
+     * @param values map from inventory paths to presence values
+     */
+    void restoreCache(std::map<std::string, bool> values)
+    {
+        std::unique_lock<std::shared_mutex> lock{mutex};
+        cache = std::move(values);
+        ++generation;
+    }
+
+    /**
+     * Sets the function that is called when a cached presence value changes
+     * or is removed.
+     *
+     * The function is passed the inventory path of the hardware.  An empty
+     * path means that all the cached values were removed.
+     *
+     * @param handler change handler
+     */
+    void setChangeHandler(std::function<void(const std::string&)> handler)
+    {
+        changeHandler = std::move(handler);
+    }
+
   private:
     /**
      * Returns whether the specified D-Bus exception is one of the expected
@@ -104,17 +226,60 @@ class DBusPresenceService : public PresenceService
      */
     bool isExpectedException(const sdbusplus::exception::exception& e);
 
+    /**
+     * Calls the change handler, if any, for the specified inventory path.
+     *
+     * @param inventoryPath D-Bus inventory path of the hardware, or an empty
+     *                      string if all the cached values were removed
+     */
+    void notifyChanged(const std::string& inventoryPath)
+    {
+        if (changeHandler)
+        {
+            changeHandler(inventoryPath);
+        }
+    }
+
+    /**
+     * Callback for PropertiesChanged signals from inventory objects.
+     *
+     * Updates the cached presence value if the Present property changed.
+     *
+     * @param msg D-Bus signal message
+     */
+    void propertiesChangedHandler(sdbusplus::message::message& msg);
+
     /**
      * D-Bus bus object.
      */
     sdbusplus::bus::bus& bus;
 
+    /**
+     * D-Bus signal match for PropertiesChanged signals from inventory objects.
+     */
+    std::unique_ptr<sdbusplus::bus::match_t> propertiesChangedMatch{};
+
     /**
      * Cached presence data.
      *
      * Map from inventory paths to presence values.
      */
     std::map<std::string, bool> cache{};
+
+    /**
+     * Generation of the cached presence data.
+     */
+    uint64_t generation{1};
+
+    /**
+     * Function called when a cached presence value changes or is removed.
+     */
+    std::function<void(const std::string&)> changeHandler{};
+
+    /**
+     * Lock that protects the cache and the generation.
+     */
+    std::shared_mutex mutex{};
 };
 
 } // namespace phosphor::power::regulators
@@ -19,10 +19,21 @@
 #include "chassis.hpp"
 #include "device.hpp"
 #include "system.hpp"
+#include "trace.hpp"
 
 namespace phosphor::power::regulators
 {
 
+void Rail::clearCache()
+{
+    // If a voltage setpoint is defined for this rail, clear its cached
+    // exponent
+    if (voltageSetpoint)
+    {
+        voltageSetpoint->clearCache();
+    }
+}
+
 void Rail::clearErrorHistory()
 {
     // If sensor monitoring is defined for this rail, clear its error history
@@ -32,24 +43,74 @@ void Rail::clearErrorHistory()
     }
 }
 
-void Rail::configure(Services& services, System& system, Chassis& chassis,
-                     Device& device)
+void Rail::compileActions(const IDMap& idMap)
+{
+    // Compile actions for configuration and sensor monitoring, if defined
+    if (configuration)
+    {
+        configuration->compile(idMap);
+    }
+    if (sensorMonitoring)
+    {
+        sensorMonitoring->compile(idMap);
+    }
+}
+
+bool Rail::configure(Services& services, System& system, Chassis& chassis,
+                     Device& device,
+                     std::vector<DeferredVerification>* deferredVerifications)
 {
     // If configuration changes are defined for this rail, apply them
     if (configuration)
     {
-        configuration->execute(services, system, chassis, device, *this);
+        return configuration->execute(services, system, chassis, device,
+                                      *this, deferredVerifications);
+    }
+    return true;
+}
+
+void Rail::linkActions(const IDMap& idMap)
+{
+    // Link actions for configuration and sensor monitoring, if defined
+    if (configuration)
+    {
+        configuration->linkActions(idMap);
+    }
+    if (sensorMonitoring)
+    {
+        sensorMonitoring->linkActions(idMap);
+    }
+}
+
+SensorMonitoring::Result Rail::monitorSensors(Services& services,
+                                              System& system, Chassis& chassis,
+                                              Device& device)
+{
+    POWER_TRACE_SCOPE("Rail::monitorSensors", device.getID(), id);
+
+    // If sensor monitoring is defined for this rail, read the sensors.
+    if (sensorMonitoring)
+    {
+        return sensorMonitoring->execute(services, system, chassis, device,
+                                         *this);
     }
+    return SensorMonitoring::Result::skipped;
 }
 
-void Rail::monitorSensors(Services& services, System& system, Chassis& chassis,
-                          Device& device)
+SensorMonitoring::Result Rail::monitorSensors(Services& services,
+                                              System& system, Chassis& chassis,
+                                              Device& device,
+                                              ActionEnvironment& environment)
 {
+    POWER_TRACE_SCOPE("Rail::monitorSensors", device.getID(), id);
+
     // If sensor monitoring is defined for this rail, read the sensors.
     if (sensorMonitoring)
     {
-        sensorMonitoring->execute(services, system, chassis, device, *this);
+        return sensorMonitoring->execute(services, system, chassis, device,
+                                         *this, environment);
     }
+    return SensorMonitoring::Result::skipped;
 }
 
 } // namespace phosphor::power::regulators
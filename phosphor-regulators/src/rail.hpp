@@ -16,12 +16,15 @@
 #pragma once
 
 #include "configuration.hpp"
+#include "id_map.hpp"
 #include "sensor_monitoring.hpp"
 #include "services.hpp"
+#include "voltage_setpoint.hpp"
 
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 namespace phosphor::power::regulators
 {
@@ -66,6 +69,14 @@ class Rail
                                                      sensorMonitoring)}
     {}
 
+    /**
+     * Clears any cached hardware data.
+     *
+     * This method should be called when the device that produces this rail
+     * may have been replaced.
+     */
+    void clearCache();
+
     /**
      * Clears all error history.
      *
@@ -76,6 +87,13 @@ class Rail
      */
     void clearErrorHistory();
 
+    /**
+     * Compiles the actions for this rail, if any.
+     *
+     * @param idMap mapping from IDs to the associated Device/Rail/Rule objects
+     */
+    void compileActions(const IDMap& idMap);
+
     /**
      * Configure this rail.
      *
@@ -88,9 +106,16 @@ class Rail
      * @param system system that contains the chassis
      * @param chassis chassis that contains the device
      * @param device device that contains this rail
+     * @param deferredVerifications if specified, the write verifications of
+     *                              the device are deferred and added to this
+     *                              vector.  See Configuration::verifyWrites().
+     * @return true if the configuration changes were applied or none are
+     *         defined, false if an error occurred
      */
-    void configure(Services& services, System& system, Chassis& chassis,
-                   Device& device);
+    bool configure(Services& services, System& system, Chassis& chassis,
+                   Device& device,
+                   std::vector<DeferredVerification>* deferredVerifications =
+                       nullptr);
 
     /**
      * Returns the configuration changes to apply to this rail, if any.
@@ -113,6 +138,15 @@ class Rail
         return id;
     }
 
+    /**
+     * Links the actions for this rail, if any.
+     *
+     * See Action::link() for more information.
+     *
+     * @param idMap mapping from IDs to the associated Device/Rail/Rule objects
+     */
+    void linkActions(const IDMap& idMap);
+
     /**
      * Monitor the sensors for this rail.
      *
@@ -125,9 +159,30 @@ class Rail
      * @param system system that contains the chassis
      * @param chassis chassis that contains the device
      * @param device device that contains this rail
+     * @return whether the sensors were skipped, read, or failed; skipped if
+     *         no sensor monitoring is defined
      */
-    void monitorSensors(Services& services, System& system, Chassis& chassis,
-                        Device& device);
+    SensorMonitoring::Result monitorSensors(Services& services, System& system,
+                                            Chassis& chassis, Device& device);
+
+    /**
+     * Monitor the sensors for this rail using the specified action
+     * environment.
+     *
+     * The environment is reused to avoid allocating memory.  See
+     * SensorMonitoring::execute() for more information.
+     *
+     * @param services system services like error logging and the journal
+     * @param system system that contains the chassis
+     * @param chassis chassis that contains the device
+     * @param device device that contains this rail
+     * @param environment action execution environment to reuse
+     * @return whether the sensors were skipped, read, or failed; skipped if
+     *         no sensor monitoring is defined
+     */
+    SensorMonitoring::Result monitorSensors(Services& services, System& system,
+                                            Chassis& chassis, Device& device,
+                                            ActionEnvironment& environment);
 
     /**
      * Returns the sensor monitoring for this rail, if any.
@@ -140,6 +195,28 @@ class Rail
         return sensorMonitoring;
     }
 
+    /**
+     * Returns the runtime voltage setpoint of this rail, if any.
+     *
+     * @return Pointer to VoltageSetpoint object.  Will equal nullptr if the
+     *         voltage of this rail cannot be set at runtime.
+     */
+    const std::unique_ptr<VoltageSetpoint>& getVoltageSetpoint() const
+    {
+        return voltageSetpoint;
+    }
+
+    /**
+     * Sets the runtime voltage setpoint of this rail.
+     *
+     * @param voltageSetpoint voltage setpoint, or nullptr if the voltage of
+     *                        this rail cannot be set at runtime
+     */
+    void setVoltageSetpoint(std::unique_ptr<VoltageSetpoint> voltageSetpoint)
+    {
+        this->voltageSetpoint = std::move(voltageSetpoint);
+    }
+
   private:
     /**
      * Unique ID of this rail.
@@ -157,6 +234,12 @@ class Rail
      * monitoring is defined for this rail.
      */
     std::unique_ptr<SensorMonitoring> sensorMonitoring{};
+
+    /**
+     * Runtime voltage setpoint of this rail, if any.  Set to nullptr if the
+     * voltage of this rail cannot be set at runtime.
+     */
+    std::unique_ptr<VoltageSetpoint> voltageSetpoint{};
 };
 
 } // namespace phosphor::power::regulators
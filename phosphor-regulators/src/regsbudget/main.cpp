@@ -0,0 +1,82 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "bus_usage.hpp"
+#include "config_file_parser.hpp"
+#include "system.hpp"
+
+#include <CLI/CLI.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <iostream>
+#include <string>
+
+using namespace phosphor::power::regulators;
+
+int main(int argc, char* argv[])
+{
+    auto rc = 0;
+
+    try
+    {
+        std::string configFile{};
+        uint32_t phaseFaultInterval =
+            bus_usage::defaultPhaseFaultInterval.count();
+        double maxBusTransactions = 0.0;
+
+        CLI::App app{"Estimates the worst-case I2C bus usage of a "
+                     "phosphor-regulators config file"};
+        app.add_option("config_file", configFile, "Config file path")
+            ->required()
+            ->check(CLI::ExistingFile);
+        app.add_option("-p,--phase-fault-interval", phaseFaultInterval,
+                       "Milliseconds between phase fault detections")
+            ->check(CLI::PositiveNumber);
+        app.add_option("-m,--max-bus-transactions", maxBusTransactions,
+                       "Fail if a bus needs more transactions per second; 0 "
+                       "for no limit")
+            ->check(CLI::NonNegativeNumber);
+        CLI11_PARSE(app, argc, argv);
+
+        auto [rules, chassis] = config_file_parser::parse(configFile);
+        System system{std::move(rules), std::move(chassis)};
+        bus_usage::Report report = bus_usage::analyze(
+            system, std::chrono::milliseconds{phaseFaultInterval});
+        std::cout << bus_usage::toString(report);
+
+        // Fail if a bus is over the budget in the config file or the limit
+        for (const bus_usage::BusUsage& bus : report.buses)
+        {
+            if (bus.isOverBudget() ||
+                ((maxBusTransactions > 0.0) &&
+                 (bus.perSecond.transactions > maxBusTransactions)))
+            {
+                std::cerr << "I2C bus " << static_cast<unsigned int>(bus.bus)
+                          << " is over its transaction budget" << std::endl;
+                rc = 1;
+            }
+        }
+    }
+    catch (const std::exception& e)
+    {
+        rc = 1;
+        std::cerr << e.what() << std::endl;
+    }
+
+    return rc;
+}
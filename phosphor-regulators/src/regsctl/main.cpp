@@ -19,8 +19,10 @@
 #include <CLI/CLI.hpp>
 
 #include <algorithm>
+#include <cstdint>
 #include <exception>
 #include <iostream>
+#include <map>
 #include <string>
 
 using namespace phosphor::power::regulators::control;
@@ -33,6 +35,17 @@ int main(int argc, char* argv[])
     {
         bool monitorEnable = false;
         bool monitorDisable = false;
+        bool statsEnable = false;
+        bool statsDisable = false;
+        bool statsShow = false;
+        uint32_t benchCount = 100;
+        bool profileEnable = false;
+        bool profileDisable = false;
+        bool profileShow = false;
+        bool profileFolded = false;
+        bool memoryResetPeaks = false;
+        std::string railID{};
+        double railVolts = 0.0;
 
         CLI::App app{"Regulators control app for OpenBMC phosphor-regulators"};
 
@@ -52,6 +65,55 @@ int main(int argc, char* argv[])
                           "Disable regulator monitoring");
         // Monitor subcommand requires only 1 option be provided
         monitor->require_option(1);
+        // I2C statistics methods
+        CLI::App* i2cStats = methods->add_subcommand(
+            "i2c-stats", "Regulator device I2C transaction statistics");
+        i2cStats->set_help_flag("-h,--help", "I2C statistics methods help");
+        i2cStats->add_flag("-e,--enable", statsEnable,
+                           "Enable collecting I2C statistics");
+        i2cStats->add_flag("-d,--disable", statsDisable,
+                           "Disable collecting I2C statistics");
+        i2cStats->add_flag("-s,--show", statsShow, "Show I2C statistics");
+        // I2C statistics subcommand requires only 1 option be provided
+        i2cStats->require_option(1);
+        // Rule profiling methods
+        CLI::App* ruleProfile = methods->add_subcommand(
+            "rule-profile", "Profile of the rules and actions");
+        ruleProfile->set_help_flag("-h,--help", "Rule profiling methods help");
+        ruleProfile->add_flag("-e,--enable", profileEnable,
+                              "Enable rule profiling");
+        ruleProfile->add_flag("-d,--disable", profileDisable,
+                              "Disable rule profiling");
+        ruleProfile->add_flag("-s,--show", profileShow,
+                              "Show statistics of each rule and action type");
+        ruleProfile->add_flag("-f,--folded", profileFolded,
+                              "Show call stacks in folded stack format");
+        // Rule profile subcommand requires only 1 option be provided
+        ruleProfile->require_option(1);
+        // Memory usage method
+        CLI::App* memory = methods->add_subcommand(
+            "memory", "Show heap memory used by each subsystem");
+        memory->set_help_flag("-h,--help", "Memory usage method help");
+        memory->add_flag("-r,--reset-peaks", memoryResetPeaks,
+                         "Reset peak memory usage after showing it");
+        // Timing statistics
+        CLI::App* timing = methods->add_subcommand(
+            "stats", "Show I2C, rail, and sensor monitoring cycle timing");
+        timing->set_help_flag("-h,--help", "Timing statistics help");
+        // Benchmark method
+        CLI::App* bench = methods->add_subcommand(
+            "bench", "Run back-to-back sensor monitoring cycles");
+        bench->set_help_flag("-h,--help", "Benchmark method help");
+        bench->add_option("-n,--count", benchCount,
+                          "Number of sensor monitoring cycles to run")
+            ->check(CLI::Range(uint32_t{1}, uint32_t{1000}));
+        // Set rail volts method
+        CLI::App* setVolts = methods->add_subcommand(
+            "set-volts", "Set the output voltage of a rail at runtime");
+        setVolts->set_help_flag("-h,--help", "Set rail volts method help");
+        setVolts->add_option("-r,--rail", railID, "Rail ID")->required();
+        setVolts->add_option("-v,--volts", railVolts, "Volts value")
+            ->required();
         // Methods group requires only 1 subcommand to be given
         methods->require_subcommand(1);
 
@@ -59,12 +121,72 @@ int main(int argc, char* argv[])
 
         if (app.got_subcommand("config"))
         {
-            callMethod("Configure");
+            configure();
         }
         else if (app.got_subcommand("monitor"))
         {
             callMethod("Monitor", monitorEnable);
         }
+        else if (app.got_subcommand("i2c-stats"))
+        {
+            if (statsShow)
+            {
+                auto reply = callMethod("GetI2CStats");
+                std::string stats{};
+                reply.read(stats);
+                std::cout << stats;
+            }
+            else
+            {
+                callMethod("EnableI2CStats", statsEnable);
+            }
+        }
+        else if (app.got_subcommand("rule-profile"))
+        {
+            if (profileShow || profileFolded)
+            {
+                std::string profile{};
+                callMethod("GetRuleProfile", profileFolded).read(profile);
+                std::cout << profile;
+            }
+            else
+            {
+                callMethod("EnableRuleProfiling", profileEnable);
+            }
+        }
+        else if (app.got_subcommand("memory"))
+        {
+            std::string usage{};
+            callMethod("GetMemoryUsage", memoryResetPeaks).read(usage);
+            std::cout << usage;
+        }
+        else if (app.got_subcommand("stats"))
+        {
+            std::string stats{};
+            callMethod("GetI2CStats").read(stats);
+            std::cout << "I2C devices:\n" << stats;
+            callMethod("GetRailStats").read(stats);
+            std::cout << "Rails:\n" << stats;
+
+            std::map<std::string, uint64_t> cycleStats{};
+            callInterfaceMethod(cycleStatsInterface, "GetStatistics")
+                .read(cycleStats);
+            std::cout << "Sensor monitoring cycles:\n";
+            for (const auto& [name, value] : cycleStats)
+            {
+                std::cout << name << ": " << value << '\n';
+            }
+        }
+        else if (app.got_subcommand("bench"))
+        {
+            std::string results{};
+            callMethod("Benchmark", benchCount).read(results);
+            std::cout << results;
+        }
+        else if (app.got_subcommand("set-volts"))
+        {
+            callMethod("SetRailVolts", railID, railVolts);
+        }
     }
     catch (const std::exception& e)
     {
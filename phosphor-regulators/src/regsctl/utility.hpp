@@ -1,9 +1,13 @@
 #pragma once
 
 #include <sdbusplus/bus.hpp>
+#include <sdbusplus/bus/match.hpp>
 #include <sdbusplus/sdbus.hpp>
 
 #include <chrono>
+#include <optional>
+#include <stdexcept>
+#include <string>
 
 namespace phosphor::power::regulators::control
 {
@@ -11,20 +15,23 @@ namespace phosphor::power::regulators::control
 constexpr auto busName = "xyz.openbmc_project.Power.Regulators";
 constexpr auto objPath = "/xyz/openbmc_project/power/regulators/manager";
 constexpr auto interface = "xyz.openbmc_project.Power.Regulators.Manager";
+constexpr auto cycleStatsInterface =
+    "xyz.openbmc_project.Power.Debug.CycleStatistics";
 
 /**
- * @brief Call a dbus method
+ * @brief Call a dbus method on an interface of the manager object
+ * @param[in] intf - Interface of the method
  * @param[in] method - Method name to call
  * @param[in] args - Any needed arguments to the method
  *
  * @return Response message from the method call
  */
 template <typename... Args>
-auto callMethod(const std::string& method, Args&&... args)
+auto callInterfaceMethod(const char* intf, const std::string& method,
+                         Args&&... args)
 {
     auto bus = sdbusplus::bus::new_default();
-    auto reqMsg =
-        bus.new_method_call(busName, objPath, interface, method.c_str());
+    auto reqMsg = bus.new_method_call(busName, objPath, intf, method.c_str());
     reqMsg.append(std::forward<Args>(args)...);
 
     // Set timeout to 6 minutes; some regulator methods take over 5 minutes
@@ -33,4 +40,70 @@ auto callMethod(const std::string& method, Args&&... args)
     return bus.call(reqMsg, timeout);
 }
 
+/**
+ * @brief Call a dbus method
+ * @param[in] method - Method name to call
+ * @param[in] args - Any needed arguments to the method
+ *
+ * @return Response message from the method call
+ */
+template <typename... Args>
+auto callMethod(const std::string& method, Args&&... args)
+{
+    return callInterfaceMethod(interface, method, std::forward<Args>(args)...);
+}
+
+/**
+ * @brief Call the Configure method and wait for the configure job to finish
+ *
+ * The Configure method returns as soon as the job has started.  The result
+ * of the job is reported by the ConfigureCompleted signal.
+ *
+ * Throws an exception if the job fails or does not finish in time.
+ */
+inline void configure()
+{
+    auto bus = sdbusplus::bus::new_default();
+
+    // Subscribe to the signal before calling the method so it is not missed
+    std::optional<bool> success{};
+    namespace rules = sdbusplus::bus::match::rules;
+    sdbusplus::bus::match_t match{
+        bus,
+        rules::type::signal() + rules::path(objPath) +
+            rules::interface(interface) + rules::member("ConfigureCompleted"),
+        [&success](sdbusplus::message::message& msg) {
+            bool value{false};
+            msg.read(value);
+            success = value;
+        }};
+
+    auto reqMsg = bus.new_method_call(busName, objPath, interface, "Configure");
+    bus.call(reqMsg);
+
+    // Wait at most 6 minutes; configure waits up to 5 minutes for the config
+    // file to be loaded
+    using namespace std::chrono_literals;
+    auto deadline = std::chrono::steady_clock::now() + 6min;
+    while (!success)
+    {
+        auto now = std::chrono::steady_clock::now();
+        if (now >= deadline)
+        {
+            throw std::runtime_error{
+                "Timed out waiting for the regulators to be configured"};
+        }
+        if (!bus.process_discard())
+        {
+            bus.wait(std::chrono::duration_cast<sdbusplus::SdBusDuration>(
+                deadline - now));
+        }
+    }
+
+    if (!*success)
+    {
+        throw std::runtime_error{"Unable to configure the regulators"};
+    }
+}
+
 } // namespace phosphor::power::regulators::control
@@ -18,7 +18,10 @@
 #include "action.hpp"
 #include "action_environment.hpp"
 #include "action_utils.hpp"
+#include "services.hpp"
 
+#include <atomic>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <utility>
@@ -38,6 +41,9 @@ namespace phosphor::power::regulators
  * - Actions that set the output voltage of a regulator rail
  * - Actions that read all the sensors of a regulator rail
  * - Actions that detect down-level hardware using version registers
+ *
+ * The result of a memoizable rule only depends on the cached hardware presence
+ * and VPD data.  It is reused until that data changes.
  */
 class Rule
 {
@@ -62,6 +68,14 @@ class Rule
         actions{std::move(actions)}
     {}
 
+    /**
+     * Clears the memoized result of this rule, if any.
+     */
+    void clearCache()
+    {
+        memoizedResult.store(0, std::memory_order_relaxed);
+    }
+
     /**
      * Executes the actions in this rule.
      *
@@ -75,7 +89,29 @@ class Rule
      */
     bool execute(ActionEnvironment& environment)
     {
-        return action_utils::execute(actions, environment);
+        if (!memoizable)
+        {
+            return action_utils::execute(actions, environment);
+        }
+
+        // Reuse the previous result if the presence and VPD data did not
+        // change.  The result is not stored if an exception is thrown.
+        uint64_t generation = getGeneration(environment.getServices());
+        if (generation != 0)
+        {
+            uint64_t result = memoizedResult.load(std::memory_order_relaxed);
+            if ((result >> 1) == generation)
+            {
+                return (result & 1) != 0;
+            }
+        }
+        bool returnValue = action_utils::execute(actions, environment);
+        if (generation != 0)
+        {
+            memoizedResult.store((generation << 1) | (returnValue ? 1 : 0),
+                                 std::memory_order_relaxed);
+        }
+        return returnValue;
     }
 
     /**
@@ -88,6 +124,19 @@ class Rule
         return actions;
     }
 
+    /**
+     * Returns the hash of the definition of this rule in the config file.
+     *
+     * Used to find the rules that are unchanged when the config file is
+     * reloaded.
+     *
+     * @return definition hash, or 0 if not set
+     */
+    uint64_t getDefinitionHash() const
+    {
+        return definitionHash;
+    }
+
     /**
      * Returns the unique ID of this rule.
      *
@@ -98,7 +147,76 @@ class Rule
         return id;
     }
 
+    /**
+     * Returns whether the result of this rule is memoized.
+     *
+     * @return true if the rule is memoizable, false otherwise
+     */
+    bool isMemoizable() const
+    {
+        return memoizable;
+    }
+
+    /**
+     * Links the actions in this rule.
+     *
+     * See Action::link() for more information.
+     *
+     * @param idMap mapping from IDs to the associated Device/Rule objects
+     */
+    void linkActions(const IDMap& idMap)
+    {
+        for (std::unique_ptr<Action>& action : actions)
+        {
+            action->link(idMap);
+        }
+    }
+
+    /**
+     * Sets the hash of the definition of this rule in the config file.
+     *
+     * @param hash definition hash
+     */
+    void setDefinitionHash(uint64_t hash)
+    {
+        definitionHash = hash;
+    }
+
+    /**
+     * Sets whether the result of this rule is memoized.
+     *
+     * A rule is memoizable if its result only depends on the cached hardware
+     * presence and VPD data.  The memoized result, if any, is cleared.
+     *
+     * @param memoizable true if the rule is memoizable, false otherwise
+     */
+    void setMemoizable(bool memoizable)
+    {
+        this->memoizable = memoizable;
+        clearCache();
+    }
+
   private:
+    /**
+     * Returns the combined generation of the cached presence and VPD data.
+     *
+     * @param services system services like error logging and the journal
+     * @return generation, or 0 if changes are not tracked
+     */
+    static uint64_t getGeneration(Services& services)
+    {
+        uint64_t presenceGeneration =
+            services.getPresenceService().getGeneration();
+        uint64_t vpdGeneration = services.getVPD().getGeneration();
+        if ((presenceGeneration == 0) || (vpdGeneration == 0))
+        {
+            return 0;
+        }
+
+        // Both generations only increase, so the sum changes if either does
+        return presenceGeneration + vpdGeneration;
+    }
+
     /**
      * Unique ID of this rule.
      */
@@ -108,6 +226,25 @@ class Rule
      * Actions in this rule.
      */
     std::vector<std::unique_ptr<Action>> actions{};
+
+    /**
+     * Hash of the definition of this rule in the config file, or 0 if not set.
+     */
+    uint64_t definitionHash{0};
+
+    /**
+     * Indicates whether the result of this rule is memoized.
+     */
+    bool memoizable{false};
+
+    /**
+     * Memoized result, or 0 if none.
+     *
+     * Contains the generation of the presence and VPD data shifted left by
+     * one bit, and the result in the lowest bit.  Atomic because rules can be
+     * executed by multiple threads during parallel configuration.
+     */
+    std::atomic<uint64_t> memoizedResult{0};
 };
 
 } // namespace phosphor::power::regulators
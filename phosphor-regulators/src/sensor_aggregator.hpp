@@ -0,0 +1,192 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "sensors.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef> // for size_t
+#include <optional>
+
+namespace phosphor::power::regulators
+{
+
+/**
+ * @class SensorAggregator
+ *
+ * Combines the values of one sensor that are read during a time window.
+ *
+ * Keeps the minimum, maximum, mean, and peak-to-peak values of the current
+ * window.  The window starts when the first value is added.  When a value is
+ * added after the window has elapsed, the statistic specified in the
+ * SensorAggregation is returned and a new window is started.
+ *
+ * Only a fixed number of members are updated for each value, so adding values
+ * never allocates memory.
+ */
+class SensorAggregator
+{
+  public:
+    /**
+     * Clock used to measure the window.
+     */
+    using Clock = std::chrono::steady_clock;
+
+    // Specify which compiler-generated methods we want
+    SensorAggregator() = delete;
+    SensorAggregator(const SensorAggregator&) = default;
+    SensorAggregator(SensorAggregator&&) = default;
+    SensorAggregator& operator=(const SensorAggregator&) = default;
+    SensorAggregator& operator=(SensorAggregator&&) = default;
+    ~SensorAggregator() = default;
+
+    /**
+     * Constructor.
+     *
+     * @param aggregation defines the window and the statistic to return
+     */
+    explicit SensorAggregator(const SensorAggregation& aggregation) :
+        aggregation{aggregation}
+    {}
+
+    /**
+     * Adds a sensor value to the current window.
+     *
+     * If the window has elapsed, the value is included in the window and the
+     * statistic for the window is returned.  The next value starts a new
+     * window.
+     *
+     * @param value sensor value
+     * @param now current time
+     * @return statistic for the window if the window has elapsed
+     */
+    std::optional<double> add(double value, Clock::time_point now)
+    {
+        if (count == 0)
+        {
+            windowStart = now;
+            minimum = value;
+            maximum = value;
+            sum = 0.0;
+        }
+        minimum = std::min(minimum, value);
+        maximum = std::max(maximum, value);
+        sum += value;
+        ++count;
+
+        if ((now - windowStart) < aggregation.window)
+        {
+            return std::nullopt;
+        }
+        double statistic = getStatistic(aggregation.statistic);
+        reset();
+        return statistic;
+    }
+
+    /**
+     * Returns the definition of the window and the statistic to return.
+     *
+     * @return sensor aggregation
+     */
+    const SensorAggregation& getAggregation() const
+    {
+        return aggregation;
+    }
+
+    /**
+     * Returns the number of values in the current window.
+     *
+     * @return number of values
+     */
+    std::size_t getCount() const
+    {
+        return count;
+    }
+
+    /**
+     * Returns the specified statistic for the values in the current window.
+     *
+     * Must not be called if the current window contains no values.
+     *
+     * @param statistic sensor statistic
+     * @return statistic value
+     */
+    double getStatistic(SensorStatistic statistic) const
+    {
+        double value{0.0};
+        switch (statistic)
+        {
+            case SensorStatistic::minimum:
+                value = minimum;
+                break;
+            case SensorStatistic::maximum:
+                value = maximum;
+                break;
+            case SensorStatistic::mean:
+                value = sum / count;
+                break;
+            case SensorStatistic::peak_to_peak:
+                value = maximum - minimum;
+                break;
+        }
+        return value;
+    }
+
+    /**
+     * Discards the values in the current window.
+     *
+     * The next value starts a new window.  This method is normally called
+     * when the sensor is disabled or could not be read.
+     */
+    void reset()
+    {
+        count = 0;
+    }
+
+  private:
+    /**
+     * Definition of the window and the statistic to return.
+     */
+    SensorAggregation aggregation;
+
+    /**
+     * Time when the current window started.
+     */
+    Clock::time_point windowStart{};
+
+    /**
+     * Lowest value in the current window.
+     */
+    double minimum{0.0};
+
+    /**
+     * Highest value in the current window.
+     */
+    double maximum{0.0};
+
+    /**
+     * Sum of the values in the current window.
+     */
+    double sum{0.0};
+
+    /**
+     * Number of values in the current window.
+     */
+    std::size_t count{0};
+};
+
+} // namespace phosphor::power::regulators
@@ -0,0 +1,225 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "sensor_history.hpp"
+
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <stdexcept>
+
+namespace phosphor::power::regulators
+{
+
+SensorHistory::SensorHistory(std::size_t blockCount, std::size_t blockWords) :
+    blockCount{blockCount}, blockWords{blockWords}
+{
+    // Verify the time series size now rather than when the first value is
+    // stored during sensor monitoring
+    CompressedTimeSeries{blockCount, blockWords};
+}
+
+void SensorHistory::disable()
+{
+    int64_t timestamp = getTimestamp();
+    for (RailHistory& row : rails)
+    {
+        addGap(row, timestamp);
+    }
+    isRailStarted = false;
+}
+
+void SensorHistory::disableRail(const std::string& rail)
+{
+    auto it = railIndexes.find(rail);
+    if (it != railIndexes.end())
+    {
+        addGap(rails[it->second], cycleTimestamp);
+    }
+}
+
+void SensorHistory::endRail(bool errorOccurred)
+{
+    if (isRailStarted && errorOccurred)
+    {
+        addGap(rails[railIndex], cycleTimestamp);
+    }
+    isRailStarted = false;
+}
+
+std::vector<std::string>
+    SensorHistory::getFFDCLines(const std::string& deviceInventoryPath,
+                                std::chrono::milliseconds window) const
+{
+    std::vector<std::string> lines{};
+    int64_t since = getTimestamp() - window.count();
+    for (const RailHistory& row : rails)
+    {
+        if (row.deviceInventoryPath != deviceInventoryPath)
+        {
+            continue;
+        }
+
+        for (std::size_t type = 0; type < row.series.size(); ++type)
+        {
+            if (!row.series[type])
+            {
+                continue;
+            }
+
+            std::string prefix{
+                row.rail + '_' +
+                sensors::toString(static_cast<SensorType>(type)) + ' '};
+            for (const CompressedTimeSeries::Point& point :
+                 row.series[type]->getPoints(since))
+            {
+                // Shortest text that converts back to the same value
+                std::array<char, 32> value{};
+                auto [end, ec] = std::to_chars(value.data(),
+                                               value.data() + value.size(),
+                                               point.value);
+                lines.emplace_back(prefix + std::to_string(point.timestamp) +
+                                   ' ' + std::string{value.data(), end});
+            }
+        }
+    }
+    return lines;
+}
+
+std::vector<std::string> SensorHistory::getSensorNames() const
+{
+    std::vector<std::string> names{};
+    for (const RailHistory& row : rails)
+    {
+        for (std::size_t type = 0; type < row.series.size(); ++type)
+        {
+            if (row.series[type])
+            {
+                names.emplace_back(
+                    row.rail + '_' +
+                    sensors::toString(static_cast<SensorType>(type)));
+            }
+        }
+    }
+    return names;
+}
+
+std::size_t SensorHistory::getStorageSize() const
+{
+    std::size_t size{0};
+    for (const RailHistory& row : rails)
+    {
+        for (const std::unique_ptr<CompressedTimeSeries>& series : row.series)
+        {
+            if (series)
+            {
+                size += series->getStorageSize();
+            }
+        }
+    }
+    return size;
+}
+
+std::vector<CompressedTimeSeries::Point>
+    SensorHistory::getValues(const std::string& name, int64_t since) const
+{
+    // Sensor names are "<rail>_<sensor type>", and rail names may contain
+    // underscores, so compare the whole name for each sensor
+    for (const RailHistory& row : rails)
+    {
+        if (name.size() <= row.rail.size() || !name.starts_with(row.rail) ||
+            name[row.rail.size()] != '_')
+        {
+            continue;
+        }
+
+        for (std::size_t type = 0; type < row.series.size(); ++type)
+        {
+            if (row.series[type] &&
+                (name.compare(row.rail.size() + 1, std::string::npos,
+                              sensors::toString(
+                                  static_cast<SensorType>(type))) == 0))
+            {
+                return row.series[type]->getPoints(since);
+            }
+        }
+    }
+    throw std::invalid_argument{"No history for sensor " + name};
+}
+
+void SensorHistory::setValue(SensorType type, double value)
+{
+    if (!isRailStarted)
+    {
+        return;
+    }
+
+    std::unique_ptr<CompressedTimeSeries>& series =
+        rails[railIndex].series[static_cast<std::size_t>(type)];
+    if (!series)
+    {
+        series = std::make_unique<CompressedTimeSeries>(blockCount, blockWords);
+    }
+    series->append(cycleTimestamp, value);
+}
+
+void SensorHistory::startCycle()
+{
+    cycleTimestamp = getTimestamp();
+}
+
+void SensorHistory::startRail(const std::string& rail,
+                              const std::string& deviceInventoryPath,
+                              const std::string& /* chassisInventoryPath */)
+{
+    railIndex = getRailIndex(rail);
+    rails[railIndex].deviceInventoryPath = deviceInventoryPath;
+    isRailStarted = true;
+}
+
+void SensorHistory::addGap(RailHistory& row, int64_t timestamp)
+{
+    for (std::unique_ptr<CompressedTimeSeries>& series : row.series)
+    {
+        if (series)
+        {
+            auto last = series->getLastPoint();
+            if (last && !std::isnan(last->value))
+            {
+                series->append(timestamp, std::nan(""));
+            }
+        }
+    }
+}
+
+int64_t SensorHistory::getTimestamp()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+
+std::size_t SensorHistory::getRailIndex(const std::string& rail)
+{
+    auto [it, wasAdded] = railIndexes.try_emplace(rail, rails.size());
+    if (wasAdded)
+    {
+        rails.emplace_back().rail = rail;
+    }
+    return it->second;
+}
+
+} // namespace phosphor::power::regulators
@@ -0,0 +1,276 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "compressed_time_series.hpp"
+#include "sensor_values.hpp"
+#include "sensors.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace phosphor::power::regulators
+{
+
+/**
+ * @class SensorHistory
+ *
+ * Implementation of the Sensors interface that stores the recent values of
+ * each sensor in memory.
+ *
+ * The values of each sensor are stored in a CompressedTimeSeries of fixed
+ * size, so the memory used by a sensor does not grow over time.  With the
+ * default size each sensor uses 8 KB, so 500 sensors use about 4 MB.  How far
+ * back the history goes depends on how well the values compress.  A sensor
+ * that is read every second typically has between 30 minutes and several
+ * hours of history.
+ *
+ * The values are timestamped with the start time of the monitoring cycle, in
+ * milliseconds since the epoch.  A NaN value is stored when a sensor stops
+ * being updated, such as when an error occurs reading the rail, when the rail
+ * is disabled, or when sensor monitoring is disabled.  This marks a gap in
+ * the history.
+ *
+ * This class is not thread safe.  The history must be read on the thread that
+ * updates the sensors.
+ */
+class SensorHistory : public Sensors
+{
+  public:
+    /**
+     * Default number of blocks in the time series of each sensor.
+     */
+    static constexpr std::size_t defaultBlockCount{16};
+
+    /**
+     * Default number of 64-bit words in each block.
+     */
+    static constexpr std::size_t defaultBlockWords{64};
+
+    /**
+     * Default time window of the values returned by getFFDCLines().
+     */
+    static constexpr std::chrono::milliseconds defaultFFDCWindow{60000};
+
+    // Specify which compiler-generated methods we want
+    SensorHistory(const SensorHistory&) = delete;
+    SensorHistory(SensorHistory&&) = delete;
+    SensorHistory& operator=(const SensorHistory&) = delete;
+    SensorHistory& operator=(SensorHistory&&) = delete;
+    virtual ~SensorHistory() = default;
+
+    /**
+     * Constructor.
+     *
+     * Throws an exception if the time series size is invalid.  See
+     * CompressedTimeSeries.
+     *
+     * @param blockCount number of blocks in the time series of each sensor
+     * @param blockWords number of 64-bit words in each block
+     */
+    explicit SensorHistory(std::size_t blockCount = defaultBlockCount,
+                           std::size_t blockWords = defaultBlockWords);
+
+    /** @copydoc Sensors::enable() */
+    virtual void enable() override
+    {
+        // Gaps were already recorded by disable()
+    }
+
+    /** @copydoc Sensors::endCycle() */
+    virtual void endCycle() override
+    {
+        isRailStarted = false;
+    }
+
+    /** @copydoc Sensors::endRail() */
+    virtual void endRail(bool errorOccurred) override;
+
+    /** @copydoc Sensors::disable() */
+    virtual void disable() override;
+
+    /** @copydoc Sensors::disableRail() */
+    virtual void disableRail(const std::string& rail) override;
+
+    /** @copydoc Sensors::setAggregatedValue() */
+    virtual void
+        setAggregatedValue(SensorType type, double value,
+                           const SensorAggregation& /* aggregation */) override
+    {
+        // Store every value read; aggregation only affects publishing
+        setValue(type, value);
+    }
+
+    /** @copydoc Sensors::setValue(SensorType, double) */
+    virtual void setValue(SensorType type, double value) override;
+
+    // The values are stored at the cycle timestamp, which keeps the history
+    // compact, so the read time is ignored
+    using Sensors::setValue;
+
+    /** @copydoc Sensors::skipRail() */
+    virtual void skipRail(const std::string& /* rail */) override
+    {
+        // The sensors keep their values, so there is nothing to store
+    }
+
+    /** @copydoc Sensors::startCycle() */
+    virtual void startCycle() override;
+
+    /** @copydoc Sensors::startRail() */
+    virtual void startRail(const std::string& rail,
+                           const std::string& deviceInventoryPath,
+                           const std::string& chassisInventoryPath) override;
+
+    /**
+     * Returns lines of text containing the recent values of the sensors of
+     * the specified device.
+     *
+     * Used to store the history before a fault in an error log.  Each line
+     * has the format "<sensor name> <milliseconds since epoch> <value>".
+     *
+     * @param deviceInventoryPath D-Bus inventory path of the device
+     * @param window time window of the values to return, ending now
+     * @return lines of text; empty if the device has no history
+     */
+    std::vector<std::string> getFFDCLines(
+        const std::string& deviceInventoryPath,
+        std::chrono::milliseconds window = defaultFFDCWindow) const;
+
+    /**
+     * Returns the names of the sensors that have a history, in the format
+     * "<rail>_<sensor type>" used for the D-Bus sensors.
+     *
+     * @return sensor names
+     */
+    std::vector<std::string> getSensorNames() const;
+
+    /**
+     * Returns the number of bytes used to store the values of all the
+     * sensors.
+     *
+     * @return number of bytes
+     */
+    std::size_t getStorageSize() const;
+
+    /**
+     * Returns the stored values of the specified sensor, oldest first.
+     *
+     * Throws an exception if the sensor has no history.
+     *
+     * @param name sensor name, such as "vdd1_vout"
+     * @param since earliest timestamp to return, in milliseconds since the
+     *              epoch
+     * @return timestamps and values
+     */
+    std::vector<CompressedTimeSeries::Point>
+        getValues(const std::string& name, int64_t since = 0) const;
+
+  private:
+    /**
+     * History of the sensors of one voltage rail.
+     */
+    struct RailHistory
+    {
+        /**
+         * Rail name.
+         */
+        std::string rail;
+
+        /**
+         * D-Bus inventory path of the device that produces the rail.
+         */
+        std::string deviceInventoryPath{};
+
+        /**
+         * Time series of the sensors, indexed by SensorType.  Created when
+         * the first value of the sensor type is stored.
+         */
+        std::array<std::unique_ptr<CompressedTimeSeries>,
+                   SensorValues::typeCount>
+            series{};
+    };
+
+    /**
+     * Stores a NaN value in each time series of the specified rail that does
+     * not already end with one.
+     *
+     * @param row rail history
+     * @param timestamp timestamp of the NaN values
+     */
+    void addGap(RailHistory& row, int64_t timestamp);
+
+    /**
+     * Returns the current time in milliseconds since the epoch.
+     *
+     * @return timestamp
+     */
+    static int64_t getTimestamp();
+
+    /**
+     * Returns the index of the specified rail in the rails vector.  Adds the
+     * rail if necessary.
+     *
+     * @param rail rail name
+     * @return index in the rails vector
+     */
+    std::size_t getRailIndex(const std::string& rail);
+
+    /**
+     * Number of blocks in the time series of each sensor.
+     */
+    std::size_t blockCount;
+
+    /**
+     * Number of 64-bit words in each block.
+     */
+    std::size_t blockWords;
+
+    /**
+     * History of each rail.
+     */
+    std::vector<RailHistory> rails{};
+
+    /**
+     * Map from rail name to index in the rails vector.
+     */
+    std::map<std::string, std::size_t> railIndexes{};
+
+    /**
+     * Index of the current rail in the rails vector.  Only valid while
+     * isRailStarted is true.
+     */
+    std::size_t railIndex{0};
+
+    /**
+     * Indicates whether a rail is currently being monitored.
+     */
+    bool isRailStarted{false};
+
+    /**
+     * Start time of the current monitoring cycle, in milliseconds since the
+     * epoch.
+     */
+    int64_t cycleTimestamp{0};
+};
+
+} // namespace phosphor::power::regulators
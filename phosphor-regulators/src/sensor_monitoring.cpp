@@ -18,59 +18,304 @@
 
 #include "action_environment.hpp"
 #include "action_utils.hpp"
+#include "bus_budget.hpp"
 #include "chassis.hpp"
 #include "device.hpp"
 #include "error_logging_utils.hpp"
 #include "exception_utils.hpp"
+#include "i2c_interface.hpp"
 #include "rail.hpp"
 #include "sensors.hpp"
 #include "system.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
 #include <exception>
 
 namespace phosphor::power::regulators
 {
 
-void SensorMonitoring::execute(Services& services, System& system,
-                               Chassis& chassis, Device& device, Rail& rail)
+/**
+ * Amount of time that a read may occur before the next read time.  This
+ * allows for monitoring timer expirations that are slightly early.
+ */
+constexpr std::chrono::milliseconds readTimeTolerance{50};
+
+/**
+ * Returns whether the specified exception or any nested inner exception is an
+ * I2CException.
+ */
+static bool isI2CError(const std::exception& e)
 {
-    // Notify sensors service that monitoring is starting for this rail
+    if (dynamic_cast<const i2c::I2CException*>(&e) != nullptr)
+    {
+        return true;
+    }
+    try
+    {
+        std::rethrow_if_nested(e);
+    }
+    catch (const std::exception& inner)
+    {
+        return isI2CError(inner);
+    }
+    catch (...)
+    {}
+    return false;
+}
+
+SensorMonitoring::Result SensorMonitoring::execute(Services& services,
+                                                   System& system,
+                                                   Chassis& chassis,
+                                                   Device& device, Rail& rail)
+{
+    ActionEnvironment environment{system.getIDMap(), device.getIDSymbol(),
+                                  services};
+    return execute(services, system, chassis, device, rail, environment);
+}
+
+SensorMonitoring::Result
+    SensorMonitoring::execute(Services& services, System& /*system*/,
+                              Chassis& chassis, Device& device, Rail& rail,
+                              ActionEnvironment& environment)
+{
+    // Skip reading the sensors if the current interval has not elapsed
     Sensors& sensors = services.getSensors();
+    auto now = std::chrono::steady_clock::now();
+    if ((now + readTimeTolerance) < nextReadTime)
+    {
+        sensors.skipRail(rail.getID());
+        return Result::skipped;
+    }
+
+    // Defer reading the sensors if the I2C bus has used up its budget.  The
+    // next read time is unchanged, so the sensors are read during the first
+    // monitoring cycle in which the bus is within its budget again.
+    if (i2c::isBusOverBudget(device.getI2CInterface().getBus()))
+    {
+        ++readStatistics.deferredCount;
+        sensors.skipRail(rail.getID());
+        return Result::skipped;
+    }
+
+    // Skip reading the sensors if the rail is disabled.  The sensors are set
+    // to an inactive state the first time the rail is found to be disabled.
+    if (enableDetection)
+    {
+        bool isEnabled{true};
+        try
+        {
+            environment.reset(device.getIDSymbol());
+            isEnabled = enableDetection->execute(environment);
+        }
+        catch (const std::exception& e)
+        {
+            // Assume the rail is enabled.  Reading the sensors fails if not.
+            logError(services, rail, e);
+        }
+
+        if (!isEnabled)
+        {
+            if (isDisabled)
+            {
+                sensors.skipRail(rail.getID());
+            }
+            else
+            {
+                sensors.disableRail(rail.getID());
+                isDisabled = true;
+            }
+            nextReadTime = now + interval;
+            isReadScheduled = true;
+            return Result::read;
+        }
+
+        if (isDisabled)
+        {
+            // Read the sensors of all the sampling groups now that the rail
+            // is enabled again
+            isDisabled = false;
+            isGroupReadRequested = true;
+        }
+    }
+
+    // Record how far the start of the read is from its scheduled time
+    if (isReadScheduled)
+    {
+        auto jitter = std::chrono::duration_cast<std::chrono::microseconds>(
+            now - nextReadTime);
+        auto absJitter = std::chrono::abs(jitter);
+        ++readStatistics.jitterCount;
+        readStatistics.lastJitter = jitter;
+        readStatistics.maxJitter =
+            std::max(readStatistics.maxJitter, absJitter);
+        readStatistics.totalJitter += absJitter;
+        isReadScheduled = false;
+    }
+
+    // Determine which sampling groups are read.  If a group is not read, the
+    // Sensors service must keep the sensors that are not updated.
+    bool isGroupSkipped{false};
+    auto isGroupRead = [this](const SamplingGroup& group) {
+        return isGroupReadRequested || ((sampleCount % group.divisor) == 0);
+    };
+    for (const SamplingGroup& group : samplingGroups)
+    {
+        if (!isGroupRead(group))
+        {
+            isGroupSkipped = true;
+            break;
+        }
+    }
+    if (isGroupSkipped)
+    {
+        sensors.skipRail(rail.getID());
+    }
+
+    // Notify sensors service that monitoring is starting for this rail
     sensors.startRail(rail.getID(), device.getFRU(),
                       chassis.getInventoryPath());
 
     // Read all sensors defined for this rail
     bool errorOccurred{false};
+    bool i2cErrorOccurred{false};
     try
     {
-        // Create ActionEnvironment
-        ActionEnvironment environment{system.getIDMap(), device.getID(),
-                                      services};
+        // Reset ActionEnvironment for this rail
+        environment.reset(device.getIDSymbol());
+
+        // Execute the actions, using the compiled program if available
+        if (program)
+        {
+            program->execute(environment);
+        }
+        else
+        {
+            action_utils::execute(actions, environment);
+        }
+
+        // Execute the actions of the sampling groups that are read this time
+        for (std::size_t i = 0; i < samplingGroups.size(); ++i)
+        {
+            if (!isGroupRead(samplingGroups[i]))
+            {
+                continue;
+            }
+            if (i < groupPrograms.size())
+            {
+                groupPrograms[i]->execute(environment);
+            }
+            else
+            {
+                action_utils::execute(samplingGroups[i].actions, environment);
+            }
+        }
 
-        // Execute the actions
-        action_utils::execute(actions, environment);
+        // Schedule the next read.  If an error occurs the sensors are read
+        // again during the next monitoring cycle.
+        updateCurrentInterval(environment.getSensorValues());
+        nextReadTime = now + currentInterval;
+        isReadScheduled = true;
     }
     catch (const std::exception& e)
     {
         // Set flag to notify sensors service that an error occurred
         errorOccurred = true;
+        i2cErrorOccurred = isI2CError(e);
+        logError(services, rail, e);
+    }
+
+    // Notify sensors service that monitoring has ended for this rail
+    sensors.endRail(errorOccurred);
+    ++sampleCount;
+    isGroupReadRequested = false;
+
+    // Record the time taken to read the sensors
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - now);
+    ++readStatistics.count;
+    readStatistics.last = duration;
+    readStatistics.max = std::max(readStatistics.max, duration);
+    readStatistics.total += duration;
+
+    if (i2cErrorOccurred)
+    {
+        return Result::i2cFailed;
+    }
+    return errorOccurred ? Result::failed : Result::read;
+}
+
+void SensorMonitoring::logError(Services& services, Rail& rail,
+                                const std::exception& e)
+{
+    // Log error messages in journal for the first 3 errors
+    if (++errorCount <= 3)
+    {
+        services.getJournal().logError(exception_utils::MessageView{e});
+        services.getJournal().logError("Unable to monitor sensors for rail " +
+                                       rail.getID());
+    }
+
+    // Create error log entry if this type hasn't already been logged
+    error_logging_utils::logError(std::current_exception(),
+                                  Entry::Level::Warning, services,
+                                  errorHistory);
+}
+
+bool SensorMonitoring::isChanging(const SensorValues& values) const
+{
+    for (std::size_t i = 0; i < SensorValues::typeCount; ++i)
+    {
+        SensorType type = static_cast<SensorType>(i);
+        if (!values.contains(type))
+        {
+            continue;
+        }
 
-        // Log error messages in journal for the first 3 errors
-        if (++errorCount <= 3)
+        if (!previousValues.contains(type))
         {
-            services.getJournal().logError(exception_utils::getMessages(e));
-            services.getJournal().logError(
-                "Unable to monitor sensors for rail " + rail.getID());
+            // No previous value to compare to
+            return true;
         }
 
-        // Create error log entry if this type hasn't already been logged
-        error_logging_utils::logError(std::current_exception(),
-                                      Entry::Level::Warning, services,
-                                      errorHistory);
+        double previousValue = previousValues.at(type);
+        double change = std::abs(values.at(type) - previousValue);
+        if (change >
+            (std::abs(previousValue) * adaptiveInterval->changePercent / 100.0))
+        {
+            return true;
+        }
     }
+    return false;
+}
 
-    // Notify sensors service that monitoring has ended for this rail
-    sensors.endRail(errorOccurred);
+void SensorMonitoring::updateCurrentInterval(const SensorValues& values)
+{
+    if (adaptiveInterval)
+    {
+        if (isChanging(values))
+        {
+            // Read sensors more often while they are changing
+            currentInterval = adaptiveInterval->minInterval;
+        }
+        else
+        {
+            // Back off toward the normal interval while they are stable
+            currentInterval = std::min(currentInterval * 2, interval);
+        }
+
+        // Keep the previous values of the sampling group sensors that were
+        // not read this time
+        for (std::size_t i = 0; i < SensorValues::typeCount; ++i)
+        {
+            SensorType type = static_cast<SensorType>(i);
+            if (values.contains(type))
+            {
+                previousValues.set(type, values.at(type));
+            }
+        }
+    }
 }
 
 } // namespace phosphor::power::regulators
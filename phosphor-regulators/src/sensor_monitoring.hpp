@@ -16,10 +16,19 @@
 #pragma once
 
 #include "action.hpp"
+#include "action_environment.hpp"
+#include "action_program.hpp"
+#include "enable_detection.hpp"
 #include "error_history.hpp"
+#include "sensor_values.hpp"
+#include "sensors.hpp"
 #include "services.hpp"
 
+#include <chrono>
+#include <cstdint>
+#include <exception>
 #include <memory>
+#include <optional>
 #include <utility>
 #include <vector>
 
@@ -32,6 +41,116 @@ class Device;
 class Rail;
 class System;
 
+/**
+ * @struct AdaptiveInterval
+ *
+ * Defines how the sensor monitoring interval for a voltage rail adapts to how
+ * quickly the sensor values are changing.
+ *
+ * While any sensor value changes by more than changePercent between reads, the
+ * sensors are read every minInterval.  Each time the values are stable, the
+ * interval is doubled until it is back to the normal monitoring interval.
+ */
+struct AdaptiveInterval
+{
+    /**
+     * Interval between reads while the sensor values are changing.
+     */
+    std::chrono::milliseconds minInterval;
+
+    /**
+     * Change between reads, as a percentage of the previous value, that
+     * indicates a sensor value is changing.
+     */
+    double changePercent;
+};
+
+/**
+ * @struct SamplingGroup
+ *
+ * Actions that read sensors for a voltage rail less often than the other
+ * sensors of the rail.
+ *
+ * The actions are executed during every divisor'th read of the rail sensors.
+ * For example, a temperature that changes slowly can be read during every
+ * tenth read while the output current is read during every read.
+ */
+struct SamplingGroup
+{
+    /**
+     * Number of reads of the rail sensors per execution of the actions.
+     */
+    unsigned int divisor;
+
+    /**
+     * Actions that read the sensors in this group.
+     */
+    std::vector<std::unique_ptr<Action>> actions;
+};
+
+/**
+ * @struct SensorReadStatistics
+ *
+ * Time taken to read the sensors for a voltage rail.
+ *
+ * Only reads that execute the actions are counted.  Reads that are skipped
+ * because the current interval has not elapsed are not counted, and reads
+ * that are deferred because the I2C bus is over its budget are only counted
+ * in deferredCount.
+ */
+struct SensorReadStatistics
+{
+    /**
+     * Number of reads.
+     */
+    uint64_t count{0};
+
+    /**
+     * Duration of the last read.
+     */
+    std::chrono::microseconds last{0};
+
+    /**
+     * Duration of the longest read.
+     */
+    std::chrono::microseconds max{0};
+
+    /**
+     * Total duration of all the reads.
+     */
+    std::chrono::microseconds total{0};
+
+    /**
+     * Number of reads deferred because the I2C bus of the device was over its
+     * budget.
+     */
+    uint64_t deferredCount{0};
+
+    /**
+     * Number of reads that started at a scheduled time, so their jitter was
+     * measured.  Reads after an error or a requestRead() are not scheduled.
+     */
+    uint64_t jitterCount{0};
+
+    /**
+     * Difference between the start of the last scheduled read and its
+     * scheduled time.  Negative if the read started early.
+     */
+    std::chrono::microseconds lastJitter{0};
+
+    /**
+     * Largest absolute difference between the start of a scheduled read and
+     * its scheduled time.
+     */
+    std::chrono::microseconds maxJitter{0};
+
+    /**
+     * Total absolute difference between the start of the scheduled reads and
+     * their scheduled times.
+     */
+    std::chrono::microseconds totalJitter{0};
+};
+
 /**
  * @class SensorMonitoring
  *
@@ -45,6 +164,22 @@ class System;
  *
  * Sensors are read by executing actions, such as PMBusReadSensorAction.  To
  * read multiple sensors for a rail, multiple actions need to be executed.
+ *
+ * The sensors are read at most once per monitoring interval.  The interval can
+ * adapt to how quickly the sensor values are changing; see AdaptiveInterval.
+ *
+ * If the I2C bus of the device has a budget (see i2c::setBusBudget()) and has
+ * used it up, the read is deferred until a later monitoring cycle.  This
+ * lowers the monitoring frequency on a busy bus instead of taking bus time
+ * from the other users of the bus.
+ *
+ * Sensors that change slowly can be read less often by putting their actions
+ * in a SamplingGroup.  The D-Bus sensors of a group are kept during the reads
+ * that do not execute the group.
+ *
+ * If EnableDetection is specified, the sensors are only read while the rail is
+ * enabled.  When the rail is found to be disabled, its sensors are set to an
+ * inactive state once and are not read again until the rail is enabled.
  */
 class SensorMonitoring
 {
@@ -57,13 +192,63 @@ class SensorMonitoring
     SensorMonitoring& operator=(SensorMonitoring&&) = delete;
     ~SensorMonitoring() = default;
 
+    /**
+     * Default interval between sensor reads.
+     */
+    static constexpr std::chrono::milliseconds defaultInterval{1000};
+
+    /**
+     * Result of one call to execute().
+     */
+    enum class Result
+    {
+        /**
+         * The sensors were not read, such as when the current interval has
+         * not elapsed.
+         */
+        skipped,
+
+        /**
+         * The device responded.  The sensors were read, or the rail was found
+         * to be disabled.
+         */
+        read,
+
+        /**
+         * An error occurred reading the sensors that does not show whether
+         * the device responded, such as a D-Bus error.
+         */
+        failed,
+
+        /**
+         * An I2C error occurred reading the sensors.  The device may have
+         * stopped responding.
+         */
+        i2cFailed
+    };
+
     /**
      * Constructor.
      *
      * @param actions actions that read the sensors for a rail
+     * @param interval interval between sensor reads
+     * @param adaptiveInterval optional settings for adapting the interval to
+     *                         how quickly the sensor values are changing
+     * @param samplingGroups actions that read sensors less often than the
+     *                       other actions
+     * @param enableDetection optional actions that detect whether the rail is
+     *                        enabled
      */
-    explicit SensorMonitoring(std::vector<std::unique_ptr<Action>> actions) :
-        actions{std::move(actions)}
+    explicit SensorMonitoring(
+        std::vector<std::unique_ptr<Action>> actions,
+        std::chrono::milliseconds interval = defaultInterval,
+        std::optional<AdaptiveInterval> adaptiveInterval = std::nullopt,
+        std::vector<SamplingGroup> samplingGroups = {},
+        std::unique_ptr<EnableDetection> enableDetection = nullptr) :
+        actions{std::move(actions)},
+        interval{interval}, adaptiveInterval{adaptiveInterval},
+        currentInterval{interval}, samplingGroups{std::move(samplingGroups)},
+        enableDetection{std::move(enableDetection)}
     {}
 
     /**
@@ -80,17 +265,78 @@ class SensorMonitoring
         errorCount = 0;
     }
 
+    /**
+     * Compiles the actions into an ActionProgram.
+     *
+     * The compiled program is used by execute() instead of interpreting the
+     * actions.  This method should be called after the System has been
+     * created, since the rules run by the actions must be resolved.
+     *
+     * @param idMap mapping from IDs to the associated Device/Rule objects
+     */
+    void compile(const IDMap& idMap)
+    {
+        program = std::make_unique<ActionProgram>(actions, idMap);
+        groupPrograms.clear();
+        groupPrograms.reserve(samplingGroups.size());
+        for (const SamplingGroup& group : samplingGroups)
+        {
+            groupPrograms.emplace_back(
+                std::make_unique<ActionProgram>(group.actions, idMap));
+        }
+        if (enableDetection)
+        {
+            enableDetection->compile(idMap);
+        }
+    }
+
     /**
      * Executes the actions to read the sensors for a rail.
      *
+     * The actions are not executed if the current monitoring interval has not
+     * elapsed since the sensors were last read successfully, or if the I2C
+     * bus of the device is over its budget.  The Sensors service is notified
+     * that the rail was skipped.
+     *
+     * The actions of a sampling group are only executed during every
+     * divisor'th read.  All the groups are executed during the first read and
+     * after requestRead() is called.
+     *
+     * If EnableDetection is specified, it is executed before the sensors are
+     * read.  If the rail is disabled, the sensors are not read and the
+     * Sensors service is notified that the rail is disabled or skipped.  All
+     * the groups are executed during the first read after the rail is
+     * enabled again.
+     *
      * @param services system services like error logging and the journal
      * @param system system that contains the chassis
      * @param chassis chassis that contains the device
      * @param device device that contains the rail
      * @param rail rail associated with the sensors
+     * @return whether the sensors were skipped, read, or failed
      */
-    void execute(Services& services, System& system, Chassis& chassis,
-                 Device& device, Rail& rail);
+    Result execute(Services& services, System& system, Chassis& chassis,
+                   Device& device, Rail& rail);
+
+    /**
+     * Executes the actions to read the sensors for a rail using the specified
+     * action environment.
+     *
+     * The environment is reset before the actions are executed.  This allows
+     * one environment to be reused for multiple rails without allocating
+     * memory.  The environment must use the IDMap of the specified system and
+     * the specified services.
+     *
+     * @param services system services like error logging and the journal
+     * @param system system that contains the chassis
+     * @param chassis chassis that contains the device
+     * @param device device that contains the rail
+     * @param rail rail associated with the sensors
+     * @param environment action execution environment to reuse
+     * @return whether the sensors were skipped, read, or failed
+     */
+    Result execute(Services& services, System& system, Chassis& chassis,
+                   Device& device, Rail& rail, ActionEnvironment& environment);
 
     /**
      * Returns the actions that read the sensors for a rail.
@@ -102,12 +348,250 @@ class SensorMonitoring
         return actions;
     }
 
+    /**
+     * Returns the actions that detect whether the rail is enabled, if any.
+     *
+     * @return Pointer to EnableDetection object.  Will equal nullptr if the
+     *         sensors are always read.
+     */
+    const std::unique_ptr<EnableDetection>& getEnableDetection() const
+    {
+        return enableDetection;
+    }
+
+    /**
+     * Returns the compiled program, if any.
+     *
+     * @return pointer to compiled program, or nullptr if not compiled
+     */
+    const ActionProgram* getProgram() const
+    {
+        return program.get();
+    }
+
+    /**
+     * Returns the settings for adapting the monitoring interval, if any.
+     *
+     * @return adaptive interval settings
+     */
+    const std::optional<AdaptiveInterval>& getAdaptiveInterval() const
+    {
+        return adaptiveInterval;
+    }
+
+    /**
+     * Returns the current interval between sensor reads.
+     *
+     * This is the normal interval unless it is being adapted to changing
+     * sensor values.
+     *
+     * @return current interval
+     */
+    std::chrono::milliseconds getCurrentInterval() const
+    {
+        return currentInterval;
+    }
+
+    /**
+     * Returns the interval between sensor reads.
+     *
+     * @return interval
+     */
+    std::chrono::milliseconds getInterval() const
+    {
+        return interval;
+    }
+
+    /**
+     * Returns the shortest interval that may be used between sensor reads.
+     *
+     * @return minimum interval
+     */
+    std::chrono::milliseconds getMinInterval() const
+    {
+        return adaptiveInterval ? adaptiveInterval->minInterval : interval;
+    }
+
+    /**
+     * Returns the actions that read sensors less often than the other
+     * actions.
+     *
+     * @return sampling groups
+     */
+    const std::vector<SamplingGroup>& getSamplingGroups() const
+    {
+        return samplingGroups;
+    }
+
+    /**
+     * Returns the time taken by the sensor reads for the rail.
+     *
+     * @return read statistics
+     */
+    const SensorReadStatistics& getReadStatistics() const
+    {
+        return readStatistics;
+    }
+
+    /**
+     * Links the actions.
+     *
+     * See Action::link() for more information.
+     *
+     * @param idMap mapping from IDs to the associated Device/Rule objects
+     */
+    void linkActions(const IDMap& idMap)
+    {
+        for (std::unique_ptr<Action>& action : actions)
+        {
+            action->link(idMap);
+        }
+        for (SamplingGroup& group : samplingGroups)
+        {
+            for (std::unique_ptr<Action>& action : group.actions)
+            {
+                action->link(idMap);
+            }
+        }
+        if (enableDetection)
+        {
+            enableDetection->linkActions(idMap);
+        }
+    }
+
+    /**
+     * Requests that the sensors be read during the next call to execute(),
+     * even if the current interval has not elapsed.
+     *
+     * The sensors of all the sampling groups are read.
+     */
+    void requestRead()
+    {
+        nextReadTime = std::chrono::steady_clock::time_point{};
+        isReadScheduled = false;
+        isGroupReadRequested = true;
+    }
+
+    /**
+     * Returns whether the rail was found to be disabled when the sensors were
+     * last due to be read.
+     *
+     * @return true if the rail is disabled, false otherwise
+     */
+    bool isRailDisabled() const
+    {
+        return isDisabled;
+    }
+
   private:
+    /**
+     * Logs an error that occurred while monitoring the sensors.
+     *
+     * Must be called from a catch block for the error.
+     *
+     * @param services system services like error logging and the journal
+     * @param rail rail associated with the sensors
+     * @param e error that occurred
+     */
+    void logError(Services& services, Rail& rail, const std::exception& e);
+
+    /**
+     * Returns whether any sensor value has changed significantly since the
+     * previous read.
+     *
+     * @param values sensor values that were just read
+     * @return true if a sensor value is changing, false otherwise
+     */
+    bool isChanging(const SensorValues& values) const;
+
+    /**
+     * Updates the current interval after the sensors have been read.
+     *
+     * @param values sensor values that were just read
+     */
+    void updateCurrentInterval(const SensorValues& values);
+
     /**
      * Actions that read the sensors for a rail.
      */
     std::vector<std::unique_ptr<Action>> actions{};
 
+    /**
+     * Actions compiled into a program, if compile() has been called.
+     */
+    std::unique_ptr<ActionProgram> program{};
+
+    /**
+     * Interval between sensor reads.
+     */
+    std::chrono::milliseconds interval;
+
+    /**
+     * Settings for adapting the interval to changing sensor values, if any.
+     */
+    std::optional<AdaptiveInterval> adaptiveInterval{};
+
+    /**
+     * Current interval between sensor reads.
+     */
+    std::chrono::milliseconds currentInterval;
+
+    /**
+     * Time when the sensors should be read next.
+     */
+    std::chrono::steady_clock::time_point nextReadTime{};
+
+    /**
+     * Indicates whether nextReadTime is the scheduled time of the next read,
+     * rather than a retry after an error or a requested read.  Jitter is only
+     * measured for scheduled reads.
+     */
+    bool isReadScheduled{false};
+
+    /**
+     * Sensor values from the previous successful read.
+     */
+    SensorValues previousValues{};
+
+    /**
+     * Actions that read sensors less often than the other actions.
+     */
+    std::vector<SamplingGroup> samplingGroups{};
+
+    /**
+     * Sampling group actions compiled into programs, if compile() has been
+     * called.  In the same order as samplingGroups.
+     */
+    std::vector<std::unique_ptr<ActionProgram>> groupPrograms{};
+
+    /**
+     * Number of reads that executed the actions.  Used to determine which
+     * sampling groups are executed.
+     */
+    uint64_t sampleCount{0};
+
+    /**
+     * Indicates whether all the sampling groups should be executed during the
+     * next read.
+     */
+    bool isGroupReadRequested{true};
+
+    /**
+     * Actions that detect whether the rail is enabled, if any.
+     */
+    std::unique_ptr<EnableDetection> enableDetection{};
+
+    /**
+     * Indicates whether the rail was found to be disabled.  The sensors of
+     * the rail have been set to an inactive state.
+     */
+    bool isDisabled{false};
+
+    /**
+     * Time taken by the sensor reads.
+     */
+    SensorReadStatistics readStatistics{};
+
     /**
      * History of which error types have been logged.
      *
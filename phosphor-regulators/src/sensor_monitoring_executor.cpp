@@ -0,0 +1,311 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "sensor_monitoring_executor.hpp"
+
+#include "action_environment.hpp"
+#include "chassis.hpp"
+#include "device.hpp"
+#include "system.hpp"
+#include "worker_services.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <exception>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace phosphor::power::regulators
+{
+
+/**
+ * Returns the chassis in the specified system.
+ *
+ * @param system system that contains the chassis
+ * @return chassis in configuration file order
+ */
+static std::vector<Chassis*> getAllChassis(System& system)
+{
+    std::vector<Chassis*> chassis{};
+    for (const std::unique_ptr<Chassis>& element : system.getChassis())
+    {
+        chassis.emplace_back(element.get());
+    }
+    return chassis;
+}
+
+SensorMonitoringExecutor::SensorMonitoringExecutor(
+    System& system, const std::filesystem::path& i2cDevicesDir) :
+    SensorMonitoringExecutor{system, getAllChassis(system), i2cDevicesDir}
+{}
+
+SensorMonitoringExecutor::SensorMonitoringExecutor(
+    System& system, const std::vector<Chassis*>& chassis,
+    const std::filesystem::path& i2cDevicesDir) :
+    system{system}
+{
+    // Find the mux topology of each bus once
+    std::map<uint8_t, i2c::BusTopology> topologies{};
+    auto getTopology = [&](uint8_t bus) -> const i2c::BusTopology& {
+        auto it = topologies.find(bus);
+        if (it == topologies.end())
+        {
+            it = topologies
+                     .emplace(bus, i2c::getBusTopology(bus, i2cDevicesDir))
+                     .first;
+        }
+        return it->second;
+    };
+
+    // Group the devices by physical I2C bus, keeping the configuration file
+    // order
+    struct Entry
+    {
+        Chassis* chassis;
+        Device* device;
+        const i2c::BusTopology* topology;
+    };
+    std::vector<std::vector<Entry>> groups{};
+    std::map<uint8_t, std::size_t> busIndexes{};
+    for (Chassis* element : chassis)
+    {
+        for (const std::unique_ptr<Device>& device : element->getDevices())
+        {
+            const i2c::BusTopology& topology =
+                getTopology(device->getI2CInterface().getBus());
+            auto [it, added] =
+                busIndexes.try_emplace(topology.rootBus, groups.size());
+            if (added)
+            {
+                groups.emplace_back();
+            }
+            groups[it->second].push_back(
+                Entry{element, device.get(), &topology});
+        }
+    }
+
+    for (std::vector<Entry>& group : groups)
+    {
+        // Read the devices that are not behind a mux first, then the devices
+        // behind each mux channel.  The sort is stable so the devices on one
+        // channel stay in the configuration file order.
+        std::stable_sort(group.begin(), group.end(),
+                         [](const Entry& a, const Entry& b) {
+                             return a.topology->channels <
+                                    b.topology->channels;
+                         });
+
+        BusDevices& devices = buses.emplace_back();
+        const std::vector<i2c::MuxChannel>* selected{nullptr};
+        for (const Entry& entry : group)
+        {
+            devices.emplace_back(entry.chassis, entry.device);
+            const std::vector<i2c::MuxChannel>& channels =
+                entry.topology->channels;
+            if (!channels.empty() &&
+                ((selected == nullptr) || (*selected != channels)))
+            {
+                ++channelSwitchCount;
+                selected = &channels;
+            }
+        }
+    }
+}
+
+SensorMonitoringExecutor::~SensorMonitoringExecutor()
+{
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        isStopping = true;
+    }
+    cycleStarted.notify_all();
+    for (Worker& worker : workers)
+    {
+        if (worker.thread.joinable())
+        {
+            worker.thread.join();
+        }
+    }
+}
+
+void SensorMonitoringExecutor::execute(Services& services)
+{
+    // Read the devices on the calling thread if there is only one bus
+    if (buses.size() <= 1)
+    {
+        for (const BusDevices& devices : buses)
+        {
+            monitorBus(services, devices);
+        }
+        return;
+    }
+
+    if (workers.empty())
+    {
+        startWorkers();
+    }
+
+    // Start the cycle with new services for each worker
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        for (Worker& worker : workers)
+        {
+            worker.services =
+                std::make_unique<WorkerServices>(services, servicesMutex);
+            worker.exception = nullptr;
+            if (worker.thread.joinable())
+            {
+                ++pendingWorkers;
+            }
+        }
+        ++cycle;
+    }
+    cycleStarted.notify_all();
+
+    // Read the buses without a worker thread on this thread
+    for (std::size_t i = 0; i < workers.size(); ++i)
+    {
+        Worker& worker = workers[i];
+        if (!worker.thread.joinable())
+        {
+            try
+            {
+                monitorBus(*worker.services, buses[i]);
+            }
+            catch (...)
+            {
+                worker.exception = std::current_exception();
+            }
+        }
+    }
+
+    // Wait for all the workers to finish
+    {
+        std::unique_lock<std::mutex> lock{mutex};
+        cycleFinished.wait(lock, [this]() { return pendingWorkers == 0; });
+    }
+
+    // Replay the sensor updates and other service calls on this thread.  An
+    // exception from one worker does not prevent replaying the others.
+    std::exception_ptr exception{};
+    for (Worker& worker : workers)
+    {
+        if (!exception)
+        {
+            exception = worker.exception;
+        }
+    }
+    for (Worker& worker : workers)
+    {
+        try
+        {
+            worker.services->replay();
+        }
+        catch (...)
+        {
+            if (!exception)
+            {
+                exception = std::current_exception();
+            }
+        }
+        worker.services.reset();
+    }
+    if (exception)
+    {
+        std::rethrow_exception(exception);
+    }
+}
+
+void SensorMonitoringExecutor::monitorBus(Services& services,
+                                          const BusDevices& devices)
+{
+    // Reuse the same environment for all devices on the bus
+    ActionEnvironment environment{system.getIDMap(), Symbol{}, services};
+    for (const auto& [chassis, device] : devices)
+    {
+        device->monitorSensors(services, system, *chassis, environment);
+    }
+}
+
+void SensorMonitoringExecutor::startWorkers()
+{
+    // Size the vector first; the threads refer to its elements
+    workers.resize(buses.size());
+    for (std::size_t i = 0; i < workers.size(); ++i)
+    {
+        try
+        {
+            workers[i].thread =
+                std::thread{&SensorMonitoringExecutor::runWorker, this, i};
+        }
+        catch (const std::system_error&)
+        {
+            // Unable to start a thread; read this bus on the calling thread
+        }
+    }
+}
+
+void SensorMonitoringExecutor::runWorker(std::size_t index)
+{
+    // The threads are started before the first cycle
+    std::size_t lastCycle{0};
+    while (true)
+    {
+        // Wait for the next cycle
+        WorkerServices* services{nullptr};
+        {
+            std::unique_lock<std::mutex> lock{mutex};
+            cycleStarted.wait(lock, [this, lastCycle]() {
+                return isStopping || (cycle != lastCycle);
+            });
+            if (isStopping)
+            {
+                return;
+            }
+            lastCycle = cycle;
+            services = workers[index].services.get();
+        }
+
+        std::exception_ptr exception{};
+        try
+        {
+            monitorBus(*services, buses[index]);
+        }
+        catch (...)
+        {
+            exception = std::current_exception();
+        }
+
+        bool isLast{false};
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+            workers[index].exception = exception;
+            isLast = (--pendingWorkers == 0);
+        }
+        if (isLast)
+        {
+            cycleFinished.notify_one();
+        }
+    }
+}
+
+} // namespace phosphor::power::regulators
@@ -0,0 +1,263 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "mux_topology.hpp"
+#include "services.hpp"
+
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace phosphor::power::regulators
+{
+
+// Forward declarations to avoid circular dependencies
+class Chassis;
+class Device;
+class System;
+class WorkerServices;
+
+/**
+ * @class SensorMonitoringExecutor
+ *
+ * Monitors the sensors for the voltage rails in the system, reading the
+ * devices on each I2C bus in parallel.
+ *
+ * The devices in the system are grouped by the physical I2C bus they are
+ * attached to.  The adapters of the channels of an I2C mux are on the same
+ * physical bus as the mux, so they are in the same group.  During a
+ * monitoring cycle, each physical bus is handled by its own worker thread.
+ * A monitoring cycle therefore takes about as long as the slowest bus rather
+ * than the sum of all buses.  The worker threads are started by the first
+ * cycle and wait for the next one in between, so a cycle does not start any
+ * threads.
+ *
+ * The devices on one physical bus are read serially.  The devices behind a
+ * mux are ordered by mux channel, so each channel is selected only once per
+ * cycle.  Devices on the same channel are read in the same order as the
+ * configuration file, so the order is always the same for a given
+ * configuration file and mux topology.
+ *
+ * The worker threads do not access D-Bus directly.  Sensor updates, error
+ * logs, and journal messages are recorded by each worker and replayed on the
+ * calling thread, normally the event loop thread, after all the workers have
+ * finished.  Services that must return a value, such as presence and VPD,
+ * are called by the workers one at a time while the calling thread waits.
+ *
+ * If all the devices are on the same bus, the devices are read on the
+ * calling thread without any worker threads.
+ */
+class SensorMonitoringExecutor
+{
+  public:
+    // Specify which compiler-generated methods we want
+    SensorMonitoringExecutor() = delete;
+    SensorMonitoringExecutor(const SensorMonitoringExecutor&) = delete;
+    SensorMonitoringExecutor(SensorMonitoringExecutor&&) = delete;
+    SensorMonitoringExecutor&
+        operator=(const SensorMonitoringExecutor&) = delete;
+    SensorMonitoringExecutor& operator=(SensorMonitoringExecutor&&) = delete;
+
+    /**
+     * Destructor.
+     *
+     * Stops the worker threads.
+     */
+    ~SensorMonitoringExecutor();
+
+    /**
+     * Constructor.
+     *
+     * Groups the devices in the specified system by physical I2C bus and
+     * orders them by mux channel.
+     *
+     * @param system system whose sensors will be monitored
+     * @param i2cDevicesDir sysfs directory containing the I2C adapters, used
+     *                      to find the mux topology
+     */
+    explicit SensorMonitoringExecutor(
+        System& system,
+        const std::filesystem::path& i2cDevicesDir = i2c::sysfsI2CDevicesDir);
+
+    /**
+     * Constructor.
+     *
+     * Groups the devices in the specified chassis by physical I2C bus and
+     * orders them by mux channel.  The devices in other chassis are not
+     * monitored.
+     *
+     * @param system system that contains the chassis
+     * @param chassis chassis whose sensors will be monitored
+     * @param i2cDevicesDir sysfs directory containing the I2C adapters, used
+     *                      to find the mux topology
+     */
+    SensorMonitoringExecutor(
+        System& system, const std::vector<Chassis*>& chassis,
+        const std::filesystem::path& i2cDevicesDir = i2c::sysfsI2CDevicesDir);
+
+    /**
+     * Monitors the sensors for the voltage rails in the system.
+     *
+     * This method should be called repeatedly based on a timer, between calls
+     * to Sensors::startCycle() and Sensors::endCycle().
+     *
+     * If an exception occurs on a worker thread, or while replaying the
+     * service calls of a worker, the calls of the other workers are still
+     * replayed.  The first exception is then rethrown.
+     *
+     * @param services system services like error logging and the journal
+     */
+    void execute(Services& services);
+
+    /**
+     * Returns the number of I2C buses the devices were grouped into.
+     *
+     * @return number of buses
+     */
+    std::size_t getBusCount() const
+    {
+        return buses.size();
+    }
+
+    /**
+     * Returns the number of times a mux channel is selected during a
+     * monitoring cycle, when all the devices are read.
+     *
+     * @return number of channel selections
+     */
+    std::size_t getChannelSwitchCount() const
+    {
+        return channelSwitchCount;
+    }
+
+  private:
+    /**
+     * Devices on one I2C bus and the chassis that contains each device.
+     */
+    using BusDevices = std::vector<std::pair<Chassis*, Device*>>;
+
+    /**
+     * Monitors the sensors for the devices on one I2C bus.
+     *
+     * @param services system services like error logging and the journal
+     * @param devices devices on the bus
+     */
+    void monitorBus(Services& services, const BusDevices& devices);
+
+    /**
+     * Starts the worker threads, one for each bus.
+     *
+     * If a thread cannot be started, its bus is monitored on the calling
+     * thread during each cycle.
+     */
+    void startWorkers();
+
+    /**
+     * Monitors the bus with the specified index during each cycle.  Runs on
+     * the worker thread of the bus until the executor is destroyed.
+     *
+     * @param index index of the bus in buses
+     */
+    void runWorker(std::size_t index);
+
+    /**
+     * Worker thread of one bus and the results of its last cycle.
+     */
+    struct Worker
+    {
+        /**
+         * Thread monitoring the bus.  Not joinable if it could not be started.
+         */
+        std::thread thread{};
+
+        /**
+         * Services used by the worker during the current cycle.
+         */
+        std::unique_ptr<WorkerServices> services{};
+
+        /**
+         * Exception that occurred during the current cycle, if any.
+         */
+        std::exception_ptr exception{};
+    };
+
+    /**
+     * System whose sensors are monitored.
+     */
+    System& system;
+
+    /**
+     * Devices grouped by physical I2C bus.
+     */
+    std::vector<BusDevices> buses{};
+
+    /**
+     * Number of mux channel selections during a monitoring cycle.
+     */
+    std::size_t channelSwitchCount{0};
+
+    /**
+     * Worker of each bus, in the same order as buses.  Empty until the first
+     * cycle with more than one bus.
+     */
+    std::vector<Worker> workers{};
+
+    /**
+     * Mutex shared by the WorkerServices of the workers.
+     */
+    std::shared_mutex servicesMutex{};
+
+    /**
+     * Mutex protecting the members below and the services and exception of
+     * each worker.
+     */
+    std::mutex mutex{};
+
+    /**
+     * Notified when a cycle starts or the executor is destroyed.
+     */
+    std::condition_variable cycleStarted{};
+
+    /**
+     * Notified when the last worker thread of a cycle is done.
+     */
+    std::condition_variable cycleFinished{};
+
+    /**
+     * Number of cycles started.
+     */
+    std::size_t cycle{0};
+
+    /**
+     * Number of worker threads that have not finished the current cycle.
+     */
+    std::size_t pendingWorkers{0};
+
+    /**
+     * Indicates whether the worker threads must exit.
+     */
+    bool isStopping{false};
+};
+
+} // namespace phosphor::power::regulators
@@ -0,0 +1,130 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "sensors.hpp"
+
+#include <array>
+#include <cstddef> // for size_t
+#include <stdexcept>
+
+namespace phosphor::power::regulators
+{
+
+/**
+ * @class SensorValues
+ *
+ * Sensor values for one voltage rail, indexed by sensor type.
+ *
+ * Stores at most one value for each SensorType.  The values are stored in a
+ * fixed-size array, so adding values and clearing them never allocates
+ * memory.
+ */
+class SensorValues
+{
+  public:
+    /**
+     * Number of SensorType values.
+     */
+    static constexpr std::size_t typeCount{
+        static_cast<std::size_t>(SensorType::vout_valley) + 1};
+
+    /**
+     * Returns the value for the specified sensor type.
+     *
+     * Throws out_of_range if no value has been set for the sensor type.
+     *
+     * @param type sensor type
+     * @return sensor value
+     */
+    double at(SensorType type) const
+    {
+        std::size_t index = static_cast<std::size_t>(type);
+        if (!hasValue[index])
+        {
+            throw std::out_of_range{"No value for sensor type " +
+                                    sensors::toString(type)};
+        }
+        return values[index];
+    }
+
+    /**
+     * Removes all sensor values.
+     */
+    void clear()
+    {
+        hasValue.fill(false);
+        count = 0;
+    }
+
+    /**
+     * Returns whether a value has been set for the specified sensor type.
+     *
+     * @param type sensor type
+     * @return true if value has been set, false otherwise
+     */
+    bool contains(SensorType type) const
+    {
+        return hasValue[static_cast<std::size_t>(type)];
+    }
+
+    /**
+     * Sets the value for the specified sensor type.
+     *
+     * Replaces any previous value for the sensor type.
+     *
+     * @param type sensor type
+     * @param value sensor value
+     */
+    void set(SensorType type, double value)
+    {
+        std::size_t index = static_cast<std::size_t>(type);
+        if (!hasValue[index])
+        {
+            hasValue[index] = true;
+            ++count;
+        }
+        values[index] = value;
+    }
+
+    /**
+     * Returns the number of sensor types that have a value.
+     *
+     * @return number of sensor values
+     */
+    std::size_t size() const
+    {
+        return count;
+    }
+
+  private:
+    /**
+     * Sensor values indexed by SensorType.
+     */
+    std::array<double, typeCount> values{};
+
+    /**
+     * Indicates whether each element in the values array has been set.
+     */
+    std::array<bool, typeCount> hasValue{};
+
+    /**
+     * Number of sensor types that have a value.
+     */
+    std::size_t count{0};
+};
+
+} // namespace phosphor::power::regulators
@@ -15,6 +15,7 @@
  */
 #pragma once
 
+#include <chrono>
 #include <string>
 
 namespace phosphor::power::regulators
@@ -71,6 +72,56 @@ enum class SensorType : unsigned char
     vout_valley
 };
 
+/**
+ * Statistic calculated from the sensor values read during a time window.
+ */
+enum class SensorStatistic : unsigned char
+{
+    /**
+     * Lowest value.
+     */
+    minimum,
+
+    /**
+     * Highest value.
+     */
+    maximum,
+
+    /**
+     * Average value.
+     */
+    mean,
+
+    /**
+     * Difference between the highest and lowest values.
+     */
+    peak_to_peak
+};
+
+/**
+ * @struct SensorAggregation
+ *
+ * Defines how the values of a sensor that is read frequently are combined
+ * into one value that is published less often.
+ *
+ * The values read during each window are combined into the specified
+ * statistic.  The statistic is published at the end of the window.
+ */
+struct SensorAggregation
+{
+    /**
+     * Length of the window.
+     */
+    std::chrono::milliseconds window;
+
+    /**
+     * Statistic to publish at the end of each window.
+     */
+    SensorStatistic statistic;
+
+    bool operator==(const SensorAggregation&) const = default;
+};
+
 /**
  * @namespace sensors
  *
@@ -124,6 +175,36 @@ inline std::string toString(SensorType type)
     return name;
 }
 
+/**
+ * Returns the name of the specified SensorStatistic.
+ *
+ * The returned string will exactly match the enumerator name, such as
+ * "peak_to_peak".
+ *
+ * @param statistic sensor statistic
+ * @return sensor statistic name
+ */
+inline std::string toString(SensorStatistic statistic)
+{
+    std::string name{};
+    switch (statistic)
+    {
+        case SensorStatistic::minimum:
+            name = "minimum";
+            break;
+        case SensorStatistic::maximum:
+            name = "maximum";
+            break;
+        case SensorStatistic::mean:
+            name = "mean";
+            break;
+        case SensorStatistic::peak_to_peak:
+            name = "peak_to_peak";
+            break;
+    }
+    return name;
+}
+
 } // namespace sensors
 
 /**
@@ -151,6 +232,17 @@ inline std::string toString(SensorType type)
  * - endRail()    // After reading all the sensors for one rail
  * - endCycle()   // At the end of a sensor monitoring cycle
  *
+ * setAggregatedValue() can be called instead of setValue() for sensors whose
+ * values are combined over a time window before being published.
+ *
+ * If the sensors for a rail are not read during a monitoring cycle because
+ * the monitoring interval of the rail has not elapsed, skipRail() should be
+ * called instead of startRail(), setValue(), and endRail().
+ *
+ * If the sensors for a rail are not read because the rail is powered off,
+ * disableRail() should be called instead of startRail(), setValue(), and
+ * endRail().
+ *
  * This service can be enabled or disabled.  It is typically enabled when the
  * system is powered on and voltage regulators begin producing output.  It is
  * typically disabled when the system is powered off.  It can also be
@@ -201,9 +293,24 @@ class Sensors
      */
     virtual void disable() = 0;
 
+    /**
+     * Notify the sensors service that the specified voltage rail is disabled
+     * and its sensors will not be read during the current monitoring cycle.
+     *
+     * The sensors for this rail will be in an inactive state, as if the
+     * service was disabled, until they are updated again.  They will not be
+     * removed at the end of the cycle.
+     *
+     * @param rail unique rail ID
+     */
+    virtual void disableRail(const std::string& rail) = 0;
+
     /**
      * Sets the value of one sensor for the current voltage rail.
      *
+     * The value is assumed to have been read from the hardware when this
+     * method is called.
+     *
      * Throws an exception if an error occurs.
      *
      * @param type sensor type
@@ -211,6 +318,55 @@ class Sensors
      */
     virtual void setValue(SensorType type, double value) = 0;
 
+    /**
+     * Sets the value of one sensor for the current voltage rail, specifying
+     * when the value was read from the hardware.
+     *
+     * The rails are read at different times during a monitoring cycle, and a
+     * value may be published well after it was read, such as when it is read
+     * by a worker thread.  The read time allows the values of different rails
+     * to be correlated.
+     *
+     * The default implementation ignores the read time.
+     *
+     * Throws an exception if an error occurs.
+     *
+     * @param type sensor type
+     * @param value sensor value
+     * @param readTime time when the value was read from the hardware
+     */
+    virtual void setValue(SensorType type, double value,
+                          std::chrono::steady_clock::time_point /*readTime*/)
+    {
+        setValue(type, value);
+    }
+
+    /**
+     * Sets the value of one sensor for the current voltage rail, combining
+     * the values read during a time window into one published value.
+     *
+     * The value is added to the current window of the sensor.  The sensor is
+     * only updated with the aggregate value at the end of the window.
+     *
+     * Throws an exception if an error occurs.
+     *
+     * @param type sensor type
+     * @param value sensor value
+     * @param aggregation defines the window and the statistic to publish
+     */
+    virtual void setAggregatedValue(SensorType type, double value,
+                                    const SensorAggregation& aggregation) = 0;
+
+    /**
+     * Notify the sensors service that the sensors for the specified voltage
+     * rail will not be read during the current monitoring cycle.
+     *
+     * The sensors for this rail will not be removed at the end of the cycle.
+     *
+     * @param rail unique rail ID
+     */
+    virtual void skipRail(const std::string& rail) = 0;
+
     /**
      * Notify the sensors service that a sensor monitoring cycle is starting.
      */
@@ -15,15 +15,22 @@
  */
 #pragma once
 
+#include "composite_sensors.hpp"
 #include "dbus_sensors.hpp"
 #include "error_logging.hpp"
+#include "inventory_objects.hpp"
 #include "journal.hpp"
 #include "presence_service.hpp"
+#include "sensor_history.hpp"
 #include "sensors.hpp"
 #include "vpd.hpp"
 
 #include <sdbusplus/bus.hpp>
 
+#include <functional>
+#include <string>
+#include <utility>
+
 namespace phosphor::power::regulators
 {
 
@@ -113,8 +120,12 @@ class BMCServices : public Services
      */
     explicit BMCServices(sdbusplus::bus::bus& bus) :
         bus{bus}, errorLogging{bus},
-        presenceService{bus}, sensors{bus}, vpd{bus}
-    {}
+        presenceService{bus}, sensors{bus, true, true}, vpd{bus}
+    {
+        compositeSensors.addSink(sensors);
+        compositeSensors.addSink(sensorHistory);
+        errorLogging.setSensorHistory(&sensorHistory);
+    }
 
     /** @copydoc Services::getBus() */
     virtual sdbusplus::bus::bus& getBus() override
@@ -143,7 +154,7 @@ class BMCServices : public Services
     /** @copydoc Services::getSensors() */
     virtual Sensors& getSensors() override
     {
-        return sensors;
+        return compositeSensors;
     }
 
     /** @copydoc Services::getVPD() */
@@ -152,23 +163,123 @@ class BMCServices : public Services
         return vpd;
     }
 
-  private:
     /**
-     * D-Bus bus object.
+     * Returns the implementation of the Sensors interface using D-Bus.
+     *
+     * Provides access to the current values in the sensors table, which are
+     * not part of the Sensors interface.
+     *
+     * @return D-Bus sensors
      */
-    sdbusplus::bus::bus& bus;
+    DBusSensors& getDBusSensors()
+    {
+        return sensors;
+    }
 
     /**
-     * Implementation of the ErrorLogging interface using D-Bus method calls.
+     * Returns the implementation of the PresenceService interface using
+     * D-Bus.
+     *
+     * Provides access to the entire presence cache, which is not part of the
+     * PresenceService interface.
+     *
+     * @return D-Bus presence service
      */
-    DBusErrorLogging errorLogging;
+    DBusPresenceService& getDBusPresenceService()
+    {
+        return presenceService;
+    }
+
+    /**
+     * Returns the implementation of the VPD interface using D-Bus.
+     *
+     * Provides access to the entire VPD cache, which is not part of the VPD
+     * interface.
+     *
+     * @return D-Bus VPD
+     */
+    DBusVPD& getDBusVPD()
+    {
+        return vpd;
+    }
+
+    /**
+     * Returns the Sensors implementation that passes the sensor updates to
+     * the D-Bus sensors and any other sinks.
+     *
+     * Other sinks can be added with CompositeSensors::addSink().
+     *
+     * @return composite sensors
+     */
+    CompositeSensors& getCompositeSensors()
+    {
+        return compositeSensors;
+    }
+
+    /**
+     * Returns the recent values of the sensors, which are stored in error
+     * logs and can be queried on D-Bus.
+     *
+     * @return sensor history
+     */
+    const SensorHistory& getSensorHistory() const
+    {
+        return sensorHistory;
+    }
+
+    /**
+     * Replaces the cached hardware presence data and VPD values with the
+     * values in the specified inventory objects.
+     *
+     * @param objects inventory objects from the inventory manager
+     */
+    void loadInventoryCache(const InventoryObjects& objects)
+    {
+        presenceService.loadCache(objects);
+        vpd.loadCache(objects);
+    }
+
+    /**
+     * Sets the function that is called when a cached hardware presence value
+     * changes.
+     *
+     * See DBusPresenceService::setChangeHandler().
+     *
+     * @param handler change handler
+     */
+    void setPresenceChangeHandler(
+        std::function<void(const std::string&)> handler)
+    {
+        presenceService.setChangeHandler(std::move(handler));
+    }
+
+  private:
+    /**
+     * D-Bus bus object.
+     */
+    sdbusplus::bus::bus& bus;
 
     /**
      * Implementation of the Journal interface that writes to the systemd
      * journal.
+     *
+     * Declared before errorLogging since queued errors use the journal when
+     * errorLogging is destroyed.
      */
     SystemdJournal journal{};
 
+    /**
+     * Recent values of the sensors.  Receives every monitoring cycle.
+     *
+     * Declared before errorLogging since errorLogging refers to it.
+     */
+    SensorHistory sensorHistory{};
+
+    /**
+     * Implementation of the ErrorLogging interface using D-Bus method calls.
+     */
+    DBusErrorLogging errorLogging;
+
     /**
      * Implementation of the PresenceService interface using D-Bus method calls.
      */
@@ -179,6 +290,12 @@ class BMCServices : public Services
      */
     DBusSensors sensors;
 
+    /**
+     * Implementation of the Sensors interface that passes the sensor updates
+     * to sensors and any other sinks.
+     */
+    CompositeSensors compositeSensors{};
+
     /**
      * Implementation of the VPD interface using D-Bus method calls.
      */
@@ -0,0 +1,75 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "symbol.hpp"
+
+#include <mutex>
+#include <unordered_set>
+
+namespace phosphor::power::regulators
+{
+
+namespace
+{
+
+/**
+ * Interned strings.
+ *
+ * The elements of an unordered_set are not moved when it grows, so
+ * references to them stay valid.
+ */
+std::unordered_set<std::string>& getTable()
+{
+    static std::unordered_set<std::string> table{};
+    return table;
+}
+
+/**
+ * Mutex that protects the interned strings.
+ */
+std::mutex& getTableMutex()
+{
+    static std::mutex mutex{};
+    return mutex;
+}
+
+} // namespace
+
+Symbol::Symbol()
+{
+    // Only look up the empty string once
+    static const std::string& empty = intern("");
+    string = &empty;
+}
+
+std::optional<Symbol> Symbol::find(std::string_view value)
+{
+    std::lock_guard<std::mutex> lock{getTableMutex()};
+    std::unordered_set<std::string>& table = getTable();
+    auto it = table.find(std::string{value});
+    if (it == table.end())
+    {
+        return std::nullopt;
+    }
+    return Symbol{&*it};
+}
+
+const std::string& Symbol::intern(std::string_view value)
+{
+    std::lock_guard<std::mutex> lock{getTableMutex()};
+    return *getTable().emplace(value).first;
+}
+
+} // namespace phosphor::power::regulators
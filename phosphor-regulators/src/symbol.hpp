@@ -0,0 +1,143 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace phosphor::power::regulators
+{
+
+/**
+ * @class Symbol
+ *
+ * Handle to an interned string, such as a device ID.
+ *
+ * Each distinct string is stored once in a table for the life of the process.
+ * A Symbol refers to the string in the table, so copying and comparing
+ * symbols does not allocate memory or compare characters.  Strings are only
+ * looked up in the table when a Symbol is created from a string, such as when
+ * the config file is parsed.
+ *
+ * Symbols can be created and used by several threads at the same time.
+ */
+class Symbol
+{
+  public:
+    /**
+     * Constructor.
+     *
+     * Creates a symbol for the empty string.
+     */
+    Symbol();
+
+    /**
+     * Constructor.
+     *
+     * Adds the specified string to the table if necessary.
+     *
+     * @param value string value
+     */
+    explicit Symbol(std::string_view value) : string{&intern(value)} {}
+
+    /**
+     * Returns the symbol for the specified string if it is in the table.
+     *
+     * Unlike the constructor, the string is not added to the table.
+     *
+     * @param value string value
+     * @return symbol, or no value if the string is not in the table
+     */
+    static std::optional<Symbol> find(std::string_view value);
+
+    /**
+     * Returns whether this symbol is for the empty string.
+     *
+     * @return true if the string is empty, false otherwise
+     */
+    bool empty() const
+    {
+        return string->empty();
+    }
+
+    /**
+     * Returns the string value of this symbol.
+     *
+     * The string exists for the life of the process.
+     *
+     * @return string value
+     */
+    const std::string& str() const
+    {
+        return *string;
+    }
+
+    /**
+     * Returns whether this symbol and the specified symbol are for the same
+     * string.
+     *
+     * @param other symbol to compare with
+     * @return true if the symbols are equal, false otherwise
+     */
+    bool operator==(const Symbol& other) const
+    {
+        return string == other.string;
+    }
+
+  private:
+    /**
+     * Constructor.
+     *
+     * @param string string in the table
+     */
+    explicit Symbol(const std::string* string) : string{string} {}
+
+    /**
+     * Returns the string in the table that is equal to the specified string,
+     * adding it to the table if necessary.
+     *
+     * @param value string value
+     * @return string in the table
+     */
+    static const std::string& intern(std::string_view value);
+
+    /**
+     * String in the table.
+     */
+    const std::string* string;
+
+    friend struct std::hash<Symbol>;
+};
+
+} // namespace phosphor::power::regulators
+
+/**
+ * Hash function for Symbol, so it can be used as an unordered_map key.
+ *
+ * Hashes the address of the string rather than its characters.
+ */
+template <>
+struct std::hash<phosphor::power::regulators::Symbol>
+{
+    std::size_t
+        operator()(const phosphor::power::regulators::Symbol& symbol) const
+    {
+        return std::hash<const std::string*>{}(symbol.string);
+    }
+};
@@ -16,21 +16,254 @@
 
 #include "system.hpp"
 
+#include "and_action.hpp"
+#include "compare_presence_action.hpp"
+#include "compare_vpd_action.hpp"
+#include "if_action.hpp"
+#include "not_action.hpp"
+#include "or_action.hpp"
+#include "run_rule_action.hpp"
+
+#include <map>
+#include <optional>
+#include <set>
+#include <stdexcept>
+
 namespace phosphor::power::regulators
 {
 
-void System::buildIDMap()
+/**
+ * Returns whether the result of the specified action only depends on the
+ * cached hardware presence and VPD data.
+ *
+ * @param action action to check
+ * @param idMap mapping from IDs to the associated Device/Rule objects
+ * @param rules whether each rule checked so far is memoizable; no value while
+ *              the rule is being checked
+ * @return true if the action is pure, false otherwise
+ */
+static bool isPure(const Action& action, const IDMap& idMap,
+                   std::map<const Rule*, std::optional<bool>>& rules);
+
+/**
+ * Returns whether the results of the specified actions only depend on the
+ * cached hardware presence and VPD data.
+ *
+ * @param actions actions to check
+ * @param idMap mapping from IDs to the associated Device/Rule objects
+ * @param rules whether each rule checked so far is memoizable
+ * @return true if all the actions are pure, false otherwise
+ */
+static bool isPure(const std::vector<std::unique_ptr<Action>>& actions,
+                   const IDMap& idMap,
+                   std::map<const Rule*, std::optional<bool>>& rules)
+{
+    for (const std::unique_ptr<Action>& action : actions)
+    {
+        if (!isPure(*action, idMap, rules))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Returns whether the specified rule is memoizable.
+ *
+ * @param rule rule to check
+ * @param idMap mapping from IDs to the associated Device/Rule objects
+ * @param rules whether each rule checked so far is memoizable
+ * @return true if the rule is memoizable, false otherwise
+ */
+static bool isPure(const Rule& rule, const IDMap& idMap,
+                   std::map<const Rule*, std::optional<bool>>& rules)
+{
+    auto it = rules.find(&rule);
+    if (it != rules.end())
+    {
+        // A rule that runs itself is never memoized
+        return it->second.value_or(false);
+    }
+    rules.emplace(&rule, std::nullopt);
+    bool pure = isPure(rule.getActions(), idMap, rules);
+    rules[&rule] = pure;
+    return pure;
+}
+
+static bool isPure(const Action& action, const IDMap& idMap,
+                   std::map<const Rule*, std::optional<bool>>& rules)
+{
+    if ((dynamic_cast<const ComparePresenceAction*>(&action) != nullptr) ||
+        (dynamic_cast<const CompareVPDAction*>(&action) != nullptr))
+    {
+        return true;
+    }
+    if (auto* andAction = dynamic_cast<const AndAction*>(&action))
+    {
+        return isPure(andAction->getActions(), idMap, rules);
+    }
+    if (auto* orAction = dynamic_cast<const OrAction*>(&action))
+    {
+        return isPure(orAction->getActions(), idMap, rules);
+    }
+    if (auto* notAction = dynamic_cast<const NotAction*>(&action))
+    {
+        return isPure(*(notAction->getAction()), idMap, rules);
+    }
+    if (auto* ifAction = dynamic_cast<const IfAction*>(&action))
+    {
+        return isPure(*(ifAction->getConditionAction()), idMap, rules) &&
+               isPure(ifAction->getThenActions(), idMap, rules) &&
+               isPure(ifAction->getElseActions(), idMap, rules);
+    }
+    if (auto* runRuleAction = dynamic_cast<const RunRuleAction*>(&action))
+    {
+        try
+        {
+            return isPure(idMap.getRule(runRuleAction->getRuleID()), idMap,
+                          rules);
+        }
+        catch (const std::invalid_argument&)
+        {
+            // Rule not found; error will occur when action is executed
+            return false;
+        }
+    }
+    return false;
+}
+
+/**
+ * Finds the inventory paths of the hardware whose presence the specified
+ * action depends on.
+ *
+ * @param action action to check
+ * @param idMap mapping from IDs to the associated Device/Rule objects
+ * @param rules rules checked so far
+ * @param paths inventory paths found so far
+ * @return true if the action only depends on hardware presence, false
+ *         otherwise
+ */
+static bool findPresencePaths(const Action& action, const IDMap& idMap,
+                              std::set<const Rule*>& rules,
+                              std::set<std::string>& paths);
+
+/**
+ * Finds the inventory paths of the hardware whose presence the specified
+ * actions depend on.
+ *
+ * @param actions actions to check
+ * @param idMap mapping from IDs to the associated Device/Rule objects
+ * @param rules rules checked so far
+ * @param paths inventory paths found so far
+ * @return true if the actions only depend on hardware presence, false
+ *         otherwise
+ */
+static bool
+    findPresencePaths(const std::vector<std::unique_ptr<Action>>& actions,
+                      const IDMap& idMap, std::set<const Rule*>& rules,
+                      std::set<std::string>& paths)
+{
+    for (const std::unique_ptr<Action>& action : actions)
+    {
+        if (!findPresencePaths(*action, idMap, rules, paths))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool findPresencePaths(const Action& action, const IDMap& idMap,
+                              std::set<const Rule*>& rules,
+                              std::set<std::string>& paths)
+{
+    if (auto* comparePresenceAction =
+            dynamic_cast<const ComparePresenceAction*>(&action))
+    {
+        paths.emplace(comparePresenceAction->getFRU());
+        return true;
+    }
+    if (auto* andAction = dynamic_cast<const AndAction*>(&action))
+    {
+        return findPresencePaths(andAction->getActions(), idMap, rules, paths);
+    }
+    if (auto* orAction = dynamic_cast<const OrAction*>(&action))
+    {
+        return findPresencePaths(orAction->getActions(), idMap, rules, paths);
+    }
+    if (auto* notAction = dynamic_cast<const NotAction*>(&action))
+    {
+        return findPresencePaths(*(notAction->getAction()), idMap, rules,
+                                 paths);
+    }
+    if (auto* ifAction = dynamic_cast<const IfAction*>(&action))
+    {
+        return findPresencePaths(*(ifAction->getConditionAction()), idMap,
+                                 rules, paths) &&
+               findPresencePaths(ifAction->getThenActions(), idMap, rules,
+                                 paths) &&
+               findPresencePaths(ifAction->getElseActions(), idMap, rules,
+                                 paths);
+    }
+    if (auto* runRuleAction = dynamic_cast<const RunRuleAction*>(&action))
+    {
+        try
+        {
+            const Rule& rule = idMap.getRule(runRuleAction->getRuleID());
+
+            // The paths of a rule that was already checked have been found
+            if (!rules.emplace(&rule).second)
+            {
+                return true;
+            }
+            return findPresencePaths(rule.getActions(), idMap, rules, paths);
+        }
+        catch (const std::invalid_argument&)
+        {
+            // Rule not found; error will occur when action is executed
+            return false;
+        }
+    }
+    return false;
+}
+
+void System::addChassis(std::vector<std::unique_ptr<Chassis>> newChassis)
+{
+    // Verify the IDs in the new chassis are unique before changing the IDMap
+    {
+        IDMap newIDMap{};
+        buildIDMap(newIDMap);
+        for (std::unique_ptr<Chassis>& oneChassis : newChassis)
+        {
+            oneChassis->addToIDMap(newIDMap);
+        }
+    }
+
+    // Add new chassis to the system and the IDMap
+    for (std::unique_ptr<Chassis>& oneChassis : newChassis)
+    {
+        oneChassis->addToIDMap(idMap);
+        chassis.emplace_back(std::move(oneChassis));
+    }
+
+    // Link and compile all actions; they might refer to the new devices
+    linkActions();
+    compileActions();
+}
+
+void System::buildIDMap(IDMap& map)
 {
     // Add rules to the map
     for (std::unique_ptr<Rule>& rule : rules)
     {
-        idMap.addRule(*rule);
+        map.addRule(*rule);
     }
 
     // Add devices and rails in each chassis to the map
     for (std::unique_ptr<Chassis>& oneChassis : chassis)
     {
-        oneChassis->addToIDMap(idMap);
+        oneChassis->addToIDMap(map);
     }
 }
 
@@ -41,6 +274,12 @@ void System::clearCache()
     {
         oneChassis->clearCache();
     }
+
+    // Clear any memoized rule results
+    for (std::unique_ptr<Rule>& rule : rules)
+    {
+        rule->clearCache();
+    }
 }
 
 void System::clearErrorHistory()
@@ -52,6 +291,49 @@ void System::clearErrorHistory()
     }
 }
 
+void System::clearPresenceCache(const std::string& inventoryPath)
+{
+    // A change in the presence of any hardware might be the hot-plug of a
+    // device whose presence detection has a cache TTL
+    for (PresenceDetection* presenceDetection : hotPluggablePresence)
+    {
+        presenceDetection->clearCache();
+    }
+
+    // A device whose FRU was replaced is no longer known to fail
+    for (std::unique_ptr<Chassis>& oneChassis : chassis)
+    {
+        for (const std::unique_ptr<Device>& device : oneChassis->getDevices())
+        {
+            if (inventoryPath.empty() || (device->getFRU() == inventoryPath))
+            {
+                device->resetCircuitBreaker();
+            }
+        }
+    }
+
+    if (inventoryPath.empty())
+    {
+        for (auto& [path, presenceDetections] : presenceDependents)
+        {
+            for (PresenceDetection* presenceDetection : presenceDetections)
+            {
+                presenceDetection->clearCache();
+            }
+        }
+        return;
+    }
+
+    auto it = presenceDependents.find(inventoryPath);
+    if (it != presenceDependents.end())
+    {
+        for (PresenceDetection* presenceDetection : it->second)
+        {
+            presenceDetection->clearCache();
+        }
+    }
+}
+
 void System::closeDevices(Services& services)
 {
     // Close devices in each chassis
@@ -61,13 +343,40 @@ void System::closeDevices(Services& services)
     }
 }
 
-void System::configure(Services& services)
+void System::closeUnpoweredDevices(Services& services)
+{
+    // Close unpowered devices in each chassis
+    for (std::unique_ptr<Chassis>& oneChassis : chassis)
+    {
+        oneChassis->closeUnpoweredDevices(services, *this);
+    }
+}
+
+void System::compileActions()
+{
+    // Memoizable rules are not inlined into the compiled programs
+    findMemoizableRules();
+
+    // Find the presence detection that is cleared when presence changes
+    findPresenceDependents();
+
+    // Compile actions in each chassis
+    for (std::unique_ptr<Chassis>& oneChassis : chassis)
+    {
+        oneChassis->compileActions(idMap);
+    }
+}
+
+unsigned int System::configure(Services& services,
+                               const std::optional<std::string>& powerDomain)
 {
     // Configure devices in each chassis
+    unsigned int errorCount{0};
     for (std::unique_ptr<Chassis>& oneChassis : chassis)
     {
-        oneChassis->configure(services, *this);
+        errorCount += oneChassis->configure(services, *this, powerDomain);
     }
+    return errorCount;
 }
 
 void System::detectPhaseFaults(Services& services)
@@ -79,6 +388,103 @@ void System::detectPhaseFaults(Services& services)
     }
 }
 
+std::map<std::string, std::set<unsigned int>> System::getPowerDomains() const
+{
+    std::map<std::string, std::set<unsigned int>> powerDomains{};
+    for (const std::unique_ptr<Chassis>& oneChassis : chassis)
+    {
+        for (const std::unique_ptr<Device>& device : oneChassis->getDevices())
+        {
+            const std::unique_ptr<PowerDomain>& powerDomain =
+                device->getPowerDomain();
+            if (powerDomain)
+            {
+                const std::vector<unsigned int>& rails =
+                    powerDomain->getSequencerRails();
+                powerDomains[powerDomain->getName()].insert(rails.begin(),
+                                                            rails.end());
+            }
+        }
+    }
+    return powerDomains;
+}
+
+bool System::handleAlert(Services& services, uint8_t bus, uint8_t address)
+{
+    // Handle the alert in each chassis
+    bool wasFound{false};
+    for (std::unique_ptr<Chassis>& oneChassis : chassis)
+    {
+        if (oneChassis->handleAlert(services, *this, bus, address))
+        {
+            wasFound = true;
+        }
+    }
+    return wasFound;
+}
+
+void System::findMemoizableRules()
+{
+    std::map<const Rule*, std::optional<bool>> memoizable{};
+    for (std::unique_ptr<Rule>& rule : rules)
+    {
+        rule->setMemoizable(isPure(*rule, idMap, memoizable));
+    }
+}
+
+void System::findPresenceDependents()
+{
+    presenceDependents.clear();
+    hotPluggablePresence.clear();
+    for (std::unique_ptr<Chassis>& oneChassis : chassis)
+    {
+        for (const std::unique_ptr<Device>& device : oneChassis->getDevices())
+        {
+            const std::unique_ptr<PresenceDetection>& presenceDetection =
+                device->getPresenceDetection();
+            if (!presenceDetection)
+            {
+                continue;
+            }
+
+            std::set<const Rule*> rules{};
+            std::set<std::string> paths{};
+            if (!findPresencePaths(presenceDetection->getActions(), idMap,
+                                   rules, paths))
+            {
+                presenceDetection->setInventoryPaths(std::nullopt);
+                if (presenceDetection->getCacheTTL().has_value())
+                {
+                    hotPluggablePresence.emplace_back(presenceDetection.get());
+                }
+                continue;
+            }
+
+            for (const std::string& path : paths)
+            {
+                presenceDependents[path].emplace_back(presenceDetection.get());
+            }
+            presenceDetection->setInventoryPaths(
+                std::vector<std::string>{paths.begin(), paths.end()});
+        }
+    }
+}
+
+void System::linkActions()
+{
+    // Link actions in each rule
+    for (std::unique_ptr<Rule>& rule : rules)
+    {
+        rule->linkActions(idMap);
+    }
+
+    // Link actions in each chassis
+    for (std::unique_ptr<Chassis>& oneChassis : chassis)
+    {
+        oneChassis->linkActions(idMap);
+    }
+}
+
 void System::monitorSensors(Services& services)
 {
     // Monitor sensors in each chassis
@@ -17,10 +17,16 @@
 
 #include "chassis.hpp"
 #include "id_map.hpp"
+#include "presence_detection.hpp"
 #include "rule.hpp"
 #include "services.hpp"
 
+#include <cstdint>
+#include <map>
 #include <memory>
+#include <optional>
+#include <set>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -57,9 +63,26 @@ class System
         rules{std::move(rules)},
         chassis{std::move(chassis)}
     {
-        buildIDMap();
+        buildIDMap(idMap);
+        linkActions();
     }
 
+    /**
+     * Adds the specified chassis to the system.
+     *
+     * Used to add chassis that were not known when the system was created,
+     * such as chassis that were not present.  The chassis are added after the
+     * existing chassis.  The actions in the system are linked and compiled
+     * again because existing actions might refer to devices in the new
+     * chassis.
+     *
+     * Throws an exception if an ID in the new chassis is already used in the
+     * system.  No chassis are added in that case.
+     *
+     * @param newChassis chassis to add
+     */
+    void addChassis(std::vector<std::unique_ptr<Chassis>> newChassis);
+
     /**
      * Clear any cached data about hardware devices.
      */
@@ -75,6 +98,28 @@ class System
      */
     void clearErrorHistory();
 
+    /**
+     * Clears the cached presence values of the devices whose presence
+     * detection depends on the presence of the hardware with the specified
+     * inventory path.
+     *
+     * This method should be called when the presence of the hardware changes,
+     * such as when it is hot-plugged.  Only the presence detection that only
+     * depends on the presence of other hardware is tracked; other presence
+     * detection is cleared by clearCache().  The exception is presence
+     * detection with a cache TTL, which is cleared when the presence of any
+     * hardware changes.
+     *
+     * Also resets the circuit breakers of the devices in that hardware, so a
+     * replaced device is read again right away.  See
+     * Device::resetCircuitBreaker().
+     *
+     * @param inventoryPath D-Bus inventory path of the hardware, or an empty
+     *                      string if the presence of any hardware might have
+     *                      changed
+     */
+    void clearPresenceCache(const std::string& inventoryPath);
+
     /**
      * Close the regulator devices in the system.
      *
@@ -82,15 +127,48 @@ class System
      */
     void closeDevices(Services& services);
 
+    /**
+     * Close the regulator devices in the system that do not remain powered
+     * while the system is powered off.
+     *
+     * See Chassis::closeUnpoweredDevices().
+     *
+     * @param services system services like error logging and the journal
+     */
+    void closeUnpoweredDevices(Services& services);
+
+    /**
+     * Compiles the actions in the system into ActionPrograms.
+     *
+     * Compiles the actions for configuration, presence detection, phase fault
+     * detection, and sensor monitoring.  The compiled programs are used when
+     * the actions are executed.
+     *
+     * Also finds the rules whose result can be memoized; see Rule.  Also finds
+     * the presence detection that only depends on the presence of other
+     * hardware; see clearPresenceCache().
+     */
+    void compileActions();
+
     /**
      * Configure the regulator devices in the system.
      *
      * This method should be called during the boot before regulators are
      * enabled.
      *
+     * If a power domain is specified, only the devices in that power domain
+     * are configured.  See PowerDomain.
+     *
      * @param services system services like error logging and the journal
+     * @param powerDomain name of the power domain whose devices should be
+     *                    configured, or an empty string for the devices that
+     *                    are not in a power domain.  If not specified, all the
+     *                    devices are configured.
+     * @return number of errors that occurred configuring the devices
      */
-    void configure(Services& services);
+    unsigned int
+        configure(Services& services,
+                  const std::optional<std::string>& powerDomain = std::nullopt);
 
     /**
      * Detect redundant phase faults in regulator devices in the system.
@@ -124,6 +202,18 @@ class System
         return idMap;
     }
 
+    /**
+     * Returns the power domains of the devices in the system.
+     *
+     * Maps each power domain name to the IDs of the power sequencer rails that
+     * must be on before its devices are configured.  If the devices in a
+     * power domain specify different rails, all of the rails are included.
+     *
+     * @return power domains, or an empty map if no devices are in a power
+     *         domain
+     */
+    std::map<std::string, std::set<unsigned int>> getPowerDomains() const;
+
     /**
      * Returns the rules used to monitor and control regulators in the system.
      *
@@ -134,6 +224,19 @@ class System
         return rules;
     }
 
+    /**
+     * Handles an SMBus alert from the devices in this system with the
+     * specified I2C bus and address.
+     *
+     * See Device::handleAlert() for more information.
+     *
+     * @param services system services like error logging and the journal
+     * @param bus I2C bus of the device
+     * @param address I2C address of the device
+     * @return true if a device in this system has the bus and address
+     */
+    bool handleAlert(Services& services, uint8_t bus, uint8_t address);
+
     /**
      * Monitors the sensors for the voltage rails produced by this system, if
      * any.
@@ -148,9 +251,40 @@ class System
     /**
      * Builds the IDMap for the system.
      *
-     * Adds the Device, Rail, and Rule objects in the system to the map.
+     * Adds the Device, Rail, and Rule objects in the system to the specified
+     * map.
+     *
+     * @param map IDMap to add the objects to
      */
-    void buildIDMap();
+    void buildIDMap(IDMap& map);
+
+    /**
+     * Finds the rules whose result only depends on the cached hardware
+     * presence and VPD data, and marks them as memoizable.
+     *
+     * These rules only contain compare_presence and compare_vpd actions,
+     * combined using and, or, not, if, and run_rule actions that run other
+     * memoizable rules.
+     */
+    void findMemoizableRules();
+
+    /**
+     * Finds the presence detection in the system whose actions only depend on
+     * the presence of other hardware.
+     *
+     * Stores the inventory paths of that hardware in the PresenceDetection
+     * objects and in presenceDependents.  Stores the other presence detection
+     * with a cache TTL in hotPluggablePresence.
+     */
+    void findPresenceDependents();
+
+    /**
+     * Links the actions in the system to the objects in the IDMap.
+     *
+     * Stores pointers to the devices and rules referenced by actions so that
+     * no lookups are needed when the actions are executed.
+     */
+    void linkActions();
 
     /**
      * Rules used to monitor and control regulators in the system.
@@ -166,6 +300,18 @@ class System
      * Mapping from string IDs to the associated Device, Rail, and Rule objects.
      */
     IDMap idMap{};
+
+    /**
+     * Mapping from inventory paths to the presence detection whose actions
+     * depend on the presence of the hardware with that path.
+     */
+    std::map<std::string, std::vector<PresenceDetection*>> presenceDependents{};
+
+    /**
+     * Presence detection with a cache TTL whose actions depend on data other
+     * than the presence of hardware, such as device registers.
+     */
+    std::vector<PresenceDetection*> hotPluggablePresence{};
 };
 
 } // namespace phosphor::power::regulators
@@ -0,0 +1,102 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "voltage_setpoint.hpp"
+
+#include "device.hpp"
+#include "i2c_interface.hpp"
+#include "pmbus_error.hpp"
+#include "pmbus_utils.hpp"
+
+#include <sstream>
+#include <stdexcept>
+
+namespace phosphor::power::regulators
+{
+
+void VoltageSetpoint::set(Device& device, double volts)
+{
+    // Verify the volts value is within the limits of the rail
+    if (!isInRange(volts))
+    {
+        std::ostringstream ss;
+        ss << "Volts value " << volts << " is outside the range " << minimum
+           << " to " << maximum << " of device " << device.getID();
+        throw std::invalid_argument{ss.str()};
+    }
+
+    // Open the I2C interface if necessary.  It stays open for the next call.
+    i2c::I2CInterface& interface = device.getI2CInterface();
+    if (!interface.isOpen())
+    {
+        interface.open();
+    }
+
+    // Select the PAGE of the rail if it is not already selected
+    if (page.has_value() && (device.getCurrentPage() != page))
+    {
+        try
+        {
+            interface.write(pmbus_utils::PAGE, page.value());
+        }
+        catch (...)
+        {
+            // Page may have been written before the error occurred
+            device.registerWritten(pmbus_utils::PAGE);
+            throw;
+        }
+        device.registerWritten(pmbus_utils::PAGE);
+        device.pageSelected(page.value());
+    }
+
+    // Convert volts value to linear data format and write it to
+    // VOUT_COMMAND.  I2CInterface method writes low-order byte first as
+    // required by PMBus.
+    uint16_t linearValue =
+        pmbus_utils::convertToVoutLinear(volts, getExponentValue(device));
+    interface.write(pmbus_utils::VOUT_COMMAND, linearValue);
+    device.registerWritten(pmbus_utils::VOUT_COMMAND);
+}
+
+int8_t VoltageSetpoint::getExponentValue(Device& device)
+{
+    // Check if an exponent value is defined or was already read
+    if (exponent.has_value())
+    {
+        return exponent.value();
+    }
+    if (voutModeExponent.has_value())
+    {
+        return voutModeExponent.value();
+    }
+
+    // Parse VOUT_MODE value to get data format and parameter value
+    pmbus_utils::VoutDataFormat format;
+    int8_t parameter;
+    pmbus_utils::parseVoutMode(device.getVoutMode(), format, parameter);
+
+    // Verify format is linear; other formats not currently supported
+    if (format != pmbus_utils::VoutDataFormat::linear)
+    {
+        throw PMBusError("VOUT_MODE contains unsupported data format",
+                         device.getID(), device.getFRU());
+    }
+
+    // Cache parameter value; it contains the exponent when format is linear
+    voutModeExponent = parameter;
+    return parameter;
+}
+
+} // namespace phosphor::power::regulators
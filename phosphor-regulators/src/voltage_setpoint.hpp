@@ -0,0 +1,187 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstdint>
+#include <optional>
+
+namespace phosphor::power::regulators
+{
+
+// Forward declarations to avoid circular dependencies
+class Device;
+
+/**
+ * @class VoltageSetpoint
+ *
+ * Allows the output voltage of a rail to be changed at runtime.
+ *
+ * The output voltage is set by writing VOUT_COMMAND directly, rather than by
+ * running the rules and actions of the rail configuration, so the setpoint
+ * can be changed with as few I2C transactions as possible.  The exponent used
+ * to convert the volts value to linear format is read from VOUT_MODE the first
+ * time and then cached.
+ *
+ * The volts value must be within the minimum and maximum values, which are
+ * normally the safe operating limits of the rail.
+ */
+class VoltageSetpoint
+{
+  public:
+    // Specify which compiler-generated methods we want
+    VoltageSetpoint() = delete;
+    VoltageSetpoint(const VoltageSetpoint&) = delete;
+    VoltageSetpoint(VoltageSetpoint&&) = delete;
+    VoltageSetpoint& operator=(const VoltageSetpoint&) = delete;
+    VoltageSetpoint& operator=(VoltageSetpoint&&) = delete;
+    ~VoltageSetpoint() = default;
+
+    /**
+     * Constructor.
+     *
+     * @param minimum minimum volts value that can be set
+     * @param maximum maximum volts value that can be set
+     * @param page PAGE of the rail, if any.  Must be specified if the device
+     *             produces more than one rail.
+     * @param exponent exponent for converting the volts value to linear
+     *                 format, if any.  If not specified, the exponent is
+     *                 read from VOUT_MODE.
+     */
+    explicit VoltageSetpoint(double minimum, double maximum,
+                             std::optional<uint8_t> page = std::nullopt,
+                             std::optional<int8_t> exponent = std::nullopt) :
+        minimum{minimum}, maximum{maximum}, page{page}, exponent{exponent}
+    {}
+
+    /**
+     * Clears the cached exponent read from VOUT_MODE.
+     *
+     * This method should be called when the device may have been replaced.
+     */
+    void clearCache()
+    {
+        voutModeExponent.reset();
+    }
+
+    /**
+     * Returns the exponent for converting the volts value to linear format,
+     * if specified.
+     *
+     * @return exponent value
+     */
+    const std::optional<int8_t>& getExponent() const
+    {
+        return exponent;
+    }
+
+    /**
+     * Returns the maximum volts value that can be set.
+     *
+     * @return maximum volts value
+     */
+    double getMaximum() const
+    {
+        return maximum;
+    }
+
+    /**
+     * Returns the minimum volts value that can be set.
+     *
+     * @return minimum volts value
+     */
+    double getMinimum() const
+    {
+        return minimum;
+    }
+
+    /**
+     * Returns the PAGE of the rail, if specified.
+     *
+     * @return PAGE value
+     */
+    const std::optional<uint8_t>& getPage() const
+    {
+        return page;
+    }
+
+    /**
+     * Returns whether the specified volts value is within the minimum and
+     * maximum values.
+     *
+     * @param volts volts value
+     * @return true if the value can be set, false otherwise
+     */
+    bool isInRange(double volts) const
+    {
+        return (volts >= minimum) && (volts <= maximum);
+    }
+
+    /**
+     * Sets the output voltage of the rail.
+     *
+     * Selects the PAGE of the rail, if specified and not already selected,
+     * and writes the volts value to VOUT_COMMAND.  The I2C interface of the
+     * device is opened if necessary.
+     *
+     * Throws std::invalid_argument if the volts value is not within the
+     * minimum and maximum values.  Throws an exception if an I2C error occurs
+     * or VOUT_MODE specifies an unsupported data format.
+     *
+     * @param device device that produces the rail
+     * @param volts volts value
+     */
+    void set(Device& device, double volts);
+
+  private:
+    /**
+     * Returns the exponent for converting the volts value to linear format.
+     *
+     * Reads VOUT_MODE the first time if no exponent was specified.
+     *
+     * Throws an exception if an error occurs.
+     *
+     * @param device device that produces the rail
+     * @return exponent value
+     */
+    int8_t getExponentValue(Device& device);
+
+    /**
+     * Minimum volts value that can be set.
+     */
+    const double minimum{0.0};
+
+    /**
+     * Maximum volts value that can be set.
+     */
+    const double maximum{0.0};
+
+    /**
+     * PAGE of the rail, if specified.
+     */
+    const std::optional<uint8_t> page{};
+
+    /**
+     * Exponent for converting the volts value to linear format, if specified.
+     */
+    const std::optional<int8_t> exponent{};
+
+    /**
+     * Exponent read from VOUT_MODE, if it has been read.
+     */
+    std::optional<int8_t> voutModeExponent{};
+};
+
+} // namespace phosphor::power::regulators
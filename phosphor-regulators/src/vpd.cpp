@@ -16,37 +16,172 @@
 
 #include "vpd.hpp"
 
+#include "memory_accounting.hpp"
 #include "types.hpp"
 #include "utility.hpp"
 
+#include <exception>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
 namespace phosphor::power::regulators
 {
 
+DBusVPD::DBusVPD(sdbusplus::bus::bus& bus) : bus{bus}
+{
+    namespace rules = sdbusplus::bus::match::rules;
+    std::string matchStr = rules::type::signal() +
+                           rules::member("PropertiesChanged") +
+                           rules::interface(util::PROPERTY_INTF) +
+                           rules::path_namespace(INVENTORY_OBJ_PATH);
+    propertiesChangedMatch = std::make_unique<sdbusplus::bus::match_t>(
+        bus, matchStr,
+        std::bind(&DBusVPD::propertiesChangedHandler, this,
+                  std::placeholders::_1));
+}
+
+std::optional<std::vector<uint8_t>>
+    DBusVPD::getCachedValue(const std::string& inventoryPath,
+                            const std::string& keyword)
+{
+    // Use find() rather than operator[] so the cache is not modified
+    std::shared_lock<std::shared_mutex> lock{mutex};
+    auto pathIt = cache.find(inventoryPath);
+    if (pathIt == cache.end())
+    {
+        return std::nullopt;
+    }
+
+    auto it = pathIt->second.find(keyword);
+    if (it == pathIt->second.end())
+    {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
 std::vector<uint8_t> DBusVPD::getValue(const std::string& inventoryPath,
                                        const std::string& keyword)
 {
+    // Check if the keyword value is already cached
+    std::optional<std::vector<uint8_t>> cachedValue =
+        getCachedValue(inventoryPath, keyword);
+    if (cachedValue)
+    {
+        return std::move(*cachedValue);
+    }
+
+    // Get keyword value from D-Bus interface/property.  The lock is not held
+    // during the D-Bus call.
     std::vector<uint8_t> value{};
+    getDBusProperty(inventoryPath, keyword, value);
+
+    // Cache keyword value
+    memory_accounting::Scope memoryScope{memory_accounting::Tag::caches};
+    std::unique_lock<std::shared_mutex> lock{mutex};
+    cache[inventoryPath][keyword] = value;
+    return value;
+}
 
-    // Get cached keywords for the inventory path
-    KeywordMap& cachedKeywords = cache[inventoryPath];
+void DBusVPD::loadCache(const InventoryObjects& objects)
+{
+    memory_accounting::Scope memoryScope{memory_accounting::Tag::caches};
+    std::map<std::string, KeywordMap> newCache{};
+    for (const auto& [path, interfaces] : objects)
+    {
+        KeywordMap keywords{};
+        for (const auto& [interface, properties] : interfaces)
+        {
+            cacheKeywords(interface, properties, keywords);
+        }
 
-    // Check if the keyword value is already cached
-    auto it = cachedKeywords.find(keyword);
-    if (it != cachedKeywords.end())
+        if (!keywords.empty())
+        {
+            newCache[path.str] = std::move(keywords);
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> lock{mutex};
+    cache = std::move(newCache);
+    ++generation;
+}
+
+void DBusVPD::cacheKeywords(const std::string& interface,
+                            const InventoryProperties& properties,
+                            KeywordMap& keywords)
+{
+    memory_accounting::Scope memoryScope{memory_accounting::Tag::caches};
+    if (interface == VINI_IFACE)
+    {
+        // HW property has byte vector value
+        auto it = properties.find("HW");
+        if (it != properties.end())
+        {
+            const auto* value = std::get_if<std::vector<uint8_t>>(&it->second);
+            if (value != nullptr)
+            {
+                keywords["HW"] = *value;
+            }
+        }
+    }
+    else if (interface == ASSET_IFACE)
     {
-        // Get keyword value from cache
-        value = it->second;
+        // Other properties have string value.  The CCIN keyword is stored in
+        // the Model property.  The HW keyword is not in this interface.
+        for (const auto& [property, variant] : properties)
+        {
+            const auto* value = std::get_if<std::string>(&variant);
+            if ((value != nullptr) && (property != "HW"))
+            {
+                std::vector<uint8_t> bytes{value->begin(), value->end()};
+                if (property == "Model")
+                {
+                    keywords["CCIN"] = bytes;
+                }
+                keywords[property] = std::move(bytes);
+            }
+        }
     }
-    else
+}
+
+void DBusVPD::propertiesChangedHandler(sdbusplus::message::message& msg)
+{
+    // Verify message is valid
+    if (!msg)
     {
-        // Get keyword value from D-Bus interface/property
-        getDBusProperty(inventoryPath, keyword, value);
+        return;
+    }
 
-        // Cache keyword value
-        cachedKeywords[keyword] = value;
+    std::string path = msg.get_path();
+    std::unique_lock<std::shared_mutex> lock{mutex};
+    auto it = cache.find(path);
+    if (it == cache.end())
+    {
+        // No cached values for this inventory path
+        return;
     }
 
-    return value;
+    // Results computed from the previous values must not be reused
+    ++generation;
+    try
+    {
+        std::string interface;
+        InventoryProperties properties;
+        msg.read(interface, properties);
+        cacheKeywords(interface, properties, it->second);
+    }
+    catch (const std::exception&)
+    {
+        // Unable to read the new values; obtain them from D-Bus when needed
+        cache.erase(it);
+    }
 }
 
 void DBusVPD::getDBusProperty(const std::string& inventoryPath,
@@ -15,12 +15,21 @@
  */
 #pragma once
 
+#include "inventory_objects.hpp"
+
 #include <sdbusplus/bus.hpp>
+#include <sdbusplus/bus/match.hpp>
 #include <sdbusplus/exception.hpp>
+#include <sdbusplus/message.hpp>
 
 #include <cstdint>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace phosphor::power::regulators
@@ -50,6 +59,33 @@ class VPD
      */
     virtual void clearCache(void) = 0;
 
+    /**
+     * Returns the cached value of the specified VPD keyword for the specified
+     * inventory path.
+     *
+     * Unlike getValue(), the value is not obtained if it is not cached and
+     * the cache is not modified.  Several threads can call this at the same
+     * time as long as no other methods are called.
+     *
+     * @param inventoryPath D-Bus inventory path of the hardware
+     * @param keyword VPD keyword
+     * @return cached VPD keyword value, or no value if it is not cached
+     */
+    virtual std::optional<std::vector<uint8_t>>
+        getCachedValue(const std::string& inventoryPath,
+                       const std::string& keyword) = 0;
+
+    /**
+     * Returns the generation of the cached VPD values.
+     *
+     * The generation changes whenever a cached VPD value changes or is
+     * removed.  Results computed from VPD values can be reused while the
+     * generation is the same.
+     *
+     * @return generation, or 0 if changes are not tracked
+     */
+    virtual uint64_t getGeneration(void) = 0;
+
     /**
      * Returns the value of the specified VPD keyword for the specified
      * inventory path.
@@ -71,6 +107,10 @@ class VPD
  * @class DBusVPD
  *
  * Implementation of the VPD interface using D-Bus method calls.
+ *
+ * The cache is protected by a lock, so worker threads can read cached values
+ * with getCachedValue() while the event loop thread updates them.  Only the
+ * event loop thread should obtain values from D-Bus.
  */
 class DBusVPD : public VPD
 {
@@ -83,24 +123,81 @@ class DBusVPD : public VPD
     DBusVPD& operator=(DBusVPD&&) = delete;
     virtual ~DBusVPD() = default;
 
+    /**
+     * Type alias for map from keyword names to values.
+     */
+    using KeywordMap = std::map<std::string, std::vector<uint8_t>>;
+
     /**
      * Constructor.
      *
+     * Subscribes to PropertiesChanged signals for inventory objects so that
+     * cached VPD values are updated when they change.
+     *
      * @param bus D-Bus bus object
      */
-    explicit DBusVPD(sdbusplus::bus::bus& bus) : bus{bus}
-    {}
+    explicit DBusVPD(sdbusplus::bus::bus& bus);
 
     /** @copydoc VPD::clearCache() */
     virtual void clearCache(void) override
     {
+        std::unique_lock<std::shared_mutex> lock{mutex};
         cache.clear();
+        ++generation;
+    }
+
+    /** @copydoc VPD::getCachedValue() */
+    virtual std::optional<std::vector<uint8_t>>
+        getCachedValue(const std::string& inventoryPath,
+                       const std::string& keyword) override;
+
+    /** @copydoc VPD::getGeneration() */
+    virtual uint64_t getGeneration(void) override
+    {
+        std::shared_lock<std::shared_mutex> lock{mutex};
+        return generation;
     }
 
     /** @copydoc VPD::getValue() */
     virtual std::vector<uint8_t> getValue(const std::string& inventoryPath,
                                           const std::string& keyword) override;
 
+    /**
+     * Replaces the cached VPD values with the VPD keyword values in the
+     * specified inventory objects.
+     *
+     * Keywords that are not found in the objects are not cached.  Their
+     * values are obtained from D-Bus when getValue() is called.
+     *
+     * @param objects inventory objects from the inventory manager
+     */
+    void loadCache(const InventoryObjects& objects);
+
+    /**
+     * Returns the cached VPD values, so they can be handed over to the next
+     * instance of the application.
+     *
+     * @return map from inventory paths to VPD keywords
+     */
+    std::map<std::string, KeywordMap> getCache()
+    {
+        std::shared_lock<std::shared_mutex> lock{mutex};
+        return cache;
+    }
+
+    /**
+     * Replaces the cached VPD values with the values cached by a previous
+     * instance of the application.
+     *
+     * @param values map from inventory paths to VPD keywords
+     */
+    void restoreCache(std::map<std::string, KeywordMap> values)
+    {
+        std::unique_lock<std::shared_mutex> lock{mutex};
+        cache = std::move(values);
+        ++generation;
+    }
+
   private:
     /**
      * Gets the value of the specified VPD keyword from a D-Bus interface and
@@ -129,21 +226,52 @@ class DBusVPD : public VPD
     bool isUnknownPropertyException(const sdbusplus::exception_t& e);
 
     /**
-     * Type alias for map from keyword names to values.
+     * Stores the VPD keyword values found in the specified properties of an
+     * inventory object.
+     *
+     * @param interface D-Bus interface containing the properties
+     * @param properties D-Bus property names and values
+     * @param keywords map where keyword values are stored
      */
-    using KeywordMap = std::map<std::string, std::vector<uint8_t>>;
+    static void cacheKeywords(const std::string& interface,
+                              const InventoryProperties& properties,
+                              KeywordMap& keywords);
+
+    /**
+     * Callback for PropertiesChanged signals from inventory objects.
+     *
+     * Updates the cached VPD values if any VPD properties changed.
+     *
+     * @param msg D-Bus signal message
+     */
+    void propertiesChangedHandler(sdbusplus::message::message& msg);
 
     /**
      * D-Bus bus object.
      */
     sdbusplus::bus::bus& bus;
 
+    /**
+     * D-Bus signal match for PropertiesChanged signals from inventory objects.
+     */
+    std::unique_ptr<sdbusplus::bus::match_t> propertiesChangedMatch{};
+
     /**
      * Cached VPD keyword values.
      *
      * Map from inventory paths to VPD keywords.
      */
     std::map<std::string, KeywordMap> cache{};
+
+    /**
+     * Generation of the cached VPD values.
+     */
+    uint64_t generation{1};
+
+    /**
+     * Lock that protects the cache and the generation.
+     */
+    std::shared_mutex mutex{};
 };
 
 } // namespace phosphor::power::regulators
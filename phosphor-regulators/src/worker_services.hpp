@@ -0,0 +1,516 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "error_logging.hpp"
+#include "journal.hpp"
+#include "presence_service.hpp"
+#include "sensors.hpp"
+#include "services.hpp"
+#include "vpd.hpp"
+
+#include <sdbusplus/bus.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace phosphor::power::regulators
+{
+
+/**
+ * Service calls recorded by a worker thread.
+ *
+ * The calls are replayed on the calling thread after the worker has finished.
+ */
+class DeferredCalls
+{
+  public:
+    /**
+     * Records a call.
+     *
+     * @param call function that performs the call using the real services
+     */
+    void add(std::function<void(Services&)> call)
+    {
+        calls.emplace_back(std::move(call));
+    }
+
+    /**
+     * Replays the recorded calls in the order they were recorded.
+     *
+     * @param services real system services
+     */
+    void replay(Services& services)
+    {
+        for (std::function<void(Services&)>& call : calls)
+        {
+            call(services);
+        }
+        calls.clear();
+    }
+
+  private:
+    /**
+     * Recorded calls.
+     */
+    std::vector<std::function<void(Services&)>> calls{};
+};
+
+/**
+ * ErrorLogging implementation that records calls for a worker thread.
+ */
+class DeferredErrorLogging : public ErrorLogging
+{
+  public:
+    explicit DeferredErrorLogging(DeferredCalls& calls) : calls{calls} {}
+
+    virtual void logConfigFileError(Entry::Level severity,
+                                    Journal& /*journal*/) override
+    {
+        calls.add([=](Services& services) {
+            services.getErrorLogging().logConfigFileError(
+                severity, services.getJournal());
+        });
+    }
+
+    virtual void logDBusError(Entry::Level severity,
+                              Journal& /*journal*/) override
+    {
+        calls.add([=](Services& services) {
+            services.getErrorLogging().logDBusError(severity,
+                                                    services.getJournal());
+        });
+    }
+
+    virtual void logI2CError(Entry::Level severity, Journal& /*journal*/,
+                             const std::string& bus, uint8_t addr,
+                             int errorNumber) override
+    {
+        calls.add([=](Services& services) {
+            services.getErrorLogging().logI2CError(
+                severity, services.getJournal(), bus, addr, errorNumber);
+        });
+    }
+
+    virtual void logInternalError(Entry::Level severity,
+                                  Journal& /*journal*/) override
+    {
+        calls.add([=](Services& services) {
+            services.getErrorLogging().logInternalError(severity,
+                                                        services.getJournal());
+        });
+    }
+
+    virtual void logPhaseFault(
+        Entry::Level severity, Journal& /*journal*/, PhaseFaultType type,
+        const std::string& inventoryPath,
+        std::map<std::string, std::string> additionalData) override
+    {
+        calls.add([=](Services& services) {
+            services.getErrorLogging().logPhaseFault(
+                severity, services.getJournal(), type, inventoryPath,
+                additionalData);
+        });
+    }
+
+    virtual void logPMBusError(Entry::Level severity, Journal& /*journal*/,
+                               const std::string& inventoryPath) override
+    {
+        calls.add([=](Services& services) {
+            services.getErrorLogging().logPMBusError(
+                severity, services.getJournal(), inventoryPath);
+        });
+    }
+
+    virtual void
+        logWriteVerificationError(Entry::Level severity, Journal& /*journal*/,
+                                  const std::string& inventoryPath) override
+    {
+        calls.add([=](Services& services) {
+            services.getErrorLogging().logWriteVerificationError(
+                severity, services.getJournal(), inventoryPath);
+        });
+    }
+
+  private:
+    DeferredCalls& calls;
+};
+
+/**
+ * Journal implementation that records calls for a worker thread.
+ *
+ * Messages are obtained from the real journal while holding an exclusive lock.
+ */
+class DeferredJournal : public Journal
+{
+  public:
+    DeferredJournal(DeferredCalls& calls, Journal& journal,
+                    std::shared_mutex& mutex) :
+        calls{calls}, journal{journal}, mutex{mutex}
+    {}
+
+    virtual std::vector<std::string> getMessages(const std::string& field,
+                                                 const std::string& fieldValue,
+                                                 unsigned int max) override
+    {
+        std::unique_lock<std::shared_mutex> lock{mutex};
+        return journal.getMessages(field, fieldValue, max);
+    }
+
+    virtual void logDebug(const std::string& message) override
+    {
+        calls.add([=](Services& services) {
+            services.getJournal().logDebug(message);
+        });
+    }
+
+    virtual void logDebug(const std::vector<std::string>& messages) override
+    {
+        calls.add([=](Services& services) {
+            services.getJournal().logDebug(messages);
+        });
+    }
+
+    virtual void logError(const std::string& message) override
+    {
+        calls.add([=](Services& services) {
+            services.getJournal().logError(message);
+        });
+    }
+
+    virtual void logError(const std::vector<std::string>& messages) override
+    {
+        calls.add([=](Services& services) {
+            services.getJournal().logError(messages);
+        });
+    }
+
+    virtual void logInfo(const std::string& message) override
+    {
+        calls.add([=](Services& services) {
+            services.getJournal().logInfo(message);
+        });
+    }
+
+    virtual void logInfo(const std::vector<std::string>& messages) override
+    {
+        calls.add([=](Services& services) {
+            services.getJournal().logInfo(messages);
+        });
+    }
+
+  private:
+    DeferredCalls& calls;
+    Journal& journal;
+    std::shared_mutex& mutex;
+};
+
+/**
+ * PresenceService implementation that calls the real service while holding a
+ * lock.
+ *
+ * Cached presence values are read while holding a shared lock, so workers
+ * only wait for each other when a value is not cached and has to be obtained.
+ *
+ * A worker that runs while the calling thread keeps using the real service
+ * must not obtain values itself.  In that case only cached values are used,
+ * and an exception is thrown if a value is not cached.
+ */
+class LockedPresenceService : public PresenceService
+{
+  public:
+    LockedPresenceService(PresenceService& presenceService,
+                          std::shared_mutex& mutex, bool isCachedOnly = false) :
+        presenceService{presenceService}, mutex{mutex},
+        isCachedOnly{isCachedOnly}
+    {}
+
+    virtual void clearCache(void) override
+    {
+        std::unique_lock<std::shared_mutex> lock{mutex};
+        presenceService.clearCache();
+    }
+
+    virtual std::optional<bool>
+        getCachedPresence(const std::string& inventoryPath) override
+    {
+        std::shared_lock<std::shared_mutex> lock{mutex};
+        return presenceService.getCachedPresence(inventoryPath);
+    }
+
+    virtual uint64_t getGeneration(void) override
+    {
+        std::shared_lock<std::shared_mutex> lock{mutex};
+        return presenceService.getGeneration();
+    }
+
+    virtual bool isPresent(const std::string& inventoryPath) override
+    {
+        std::optional<bool> present = getCachedPresence(inventoryPath);
+        if (present)
+        {
+            return *present;
+        }
+        if (isCachedOnly)
+        {
+            throw std::runtime_error{"Presence of " + inventoryPath +
+                                     " is not cached"};
+        }
+
+        // Obtaining the value modifies the cache
+        std::unique_lock<std::shared_mutex> lock{mutex};
+        return presenceService.isPresent(inventoryPath);
+    }
+
+  private:
+    PresenceService& presenceService;
+    std::shared_mutex& mutex;
+    const bool isCachedOnly;
+};
+
+/**
+ * Sensors implementation that records calls for a worker thread.
+ */
+class DeferredSensors : public Sensors
+{
+  public:
+    explicit DeferredSensors(DeferredCalls& calls) : calls{calls} {}
+
+    virtual void enable() override
+    {
+        calls.add([](Services& services) { services.getSensors().enable(); });
+    }
+
+    virtual void endCycle() override
+    {
+        calls.add(
+            [](Services& services) { services.getSensors().endCycle(); });
+    }
+
+    virtual void endRail(bool errorOccurred) override
+    {
+        calls.add([=](Services& services) {
+            services.getSensors().endRail(errorOccurred);
+        });
+    }
+
+    virtual void disable() override
+    {
+        calls.add([](Services& services) { services.getSensors().disable(); });
+    }
+
+    virtual void disableRail(const std::string& rail) override
+    {
+        calls.add([=](Services& services) {
+            services.getSensors().disableRail(rail);
+        });
+    }
+
+    virtual void
+        setAggregatedValue(SensorType type, double value,
+                           const SensorAggregation& aggregation) override
+    {
+        calls.add([=](Services& services) {
+            services.getSensors().setAggregatedValue(type, value, aggregation);
+        });
+    }
+
+    virtual void setValue(SensorType type, double value) override
+    {
+        // The value is replayed later, so record when it was read
+        setValue(type, value, std::chrono::steady_clock::now());
+    }
+
+    virtual void
+        setValue(SensorType type, double value,
+                 std::chrono::steady_clock::time_point readTime) override
+    {
+        calls.add([=](Services& services) {
+            services.getSensors().setValue(type, value, readTime);
+        });
+    }
+
+    virtual void skipRail(const std::string& rail) override
+    {
+        calls.add([=](Services& services) {
+            services.getSensors().skipRail(rail);
+        });
+    }
+
+    virtual void startCycle() override
+    {
+        calls.add(
+            [](Services& services) { services.getSensors().startCycle(); });
+    }
+
+    virtual void startRail(const std::string& rail,
+                           const std::string& deviceInventoryPath,
+                           const std::string& chassisInventoryPath) override
+    {
+        calls.add([=](Services& services) {
+            services.getSensors().startRail(rail, deviceInventoryPath,
+                                            chassisInventoryPath);
+        });
+    }
+
+  private:
+    DeferredCalls& calls;
+};
+
+/**
+ * VPD implementation that calls the real service while holding a lock.
+ *
+ * Cached VPD values are read while holding a shared lock, so workers only
+ * wait for each other when a value is not cached and has to be obtained.
+ *
+ * See LockedPresenceService for when only cached values are used.
+ */
+class LockedVPD : public VPD
+{
+  public:
+    LockedVPD(VPD& vpd, std::shared_mutex& mutex, bool isCachedOnly = false) :
+        vpd{vpd}, mutex{mutex}, isCachedOnly{isCachedOnly}
+    {}
+
+    virtual void clearCache(void) override
+    {
+        std::unique_lock<std::shared_mutex> lock{mutex};
+        vpd.clearCache();
+    }
+
+    virtual std::optional<std::vector<uint8_t>>
+        getCachedValue(const std::string& inventoryPath,
+                       const std::string& keyword) override
+    {
+        std::shared_lock<std::shared_mutex> lock{mutex};
+        return vpd.getCachedValue(inventoryPath, keyword);
+    }
+
+    virtual uint64_t getGeneration(void) override
+    {
+        std::shared_lock<std::shared_mutex> lock{mutex};
+        return vpd.getGeneration();
+    }
+
+    virtual std::vector<uint8_t> getValue(const std::string& inventoryPath,
+                                          const std::string& keyword) override
+    {
+        std::optional<std::vector<uint8_t>> value =
+            getCachedValue(inventoryPath, keyword);
+        if (value)
+        {
+            return std::move(*value);
+        }
+        if (isCachedOnly)
+        {
+            throw std::runtime_error{"VPD keyword " + keyword + " of " +
+                                     inventoryPath + " is not cached"};
+        }
+
+        // Obtaining the value modifies the cache
+        std::unique_lock<std::shared_mutex> lock{mutex};
+        return vpd.getValue(inventoryPath, keyword);
+    }
+
+  private:
+    VPD& vpd;
+    std::shared_mutex& mutex;
+    const bool isCachedOnly;
+};
+
+/**
+ * Services used by a worker thread.
+ *
+ * Calls that do not return a value are recorded and replayed on the calling
+ * thread by replay().  This includes the sensor updates, so the current rail
+ * of the real Sensors is only changed on the calling thread.  Calls that
+ * return a value are made to the real services while holding a lock shared by
+ * all the workers.  Cached values are read while all the workers can hold the
+ * lock.
+ *
+ * If isCachedOnly is true, presence and VPD values that are not cached are
+ * not obtained.  This is used when the calling thread keeps running while the
+ * worker runs, so only the calling thread obtains values from D-Bus.
+ */
+class WorkerServices : public Services
+{
+  public:
+    WorkerServices(Services& services, std::shared_mutex& mutex,
+                   bool isCachedOnly = false) :
+        services{services}, errorLogging{calls},
+        journal{calls, services.getJournal(), mutex},
+        presenceService{services.getPresenceService(), mutex, isCachedOnly},
+        sensors{calls}, vpd{services.getVPD(), mutex, isCachedOnly}
+    {}
+
+    virtual sdbusplus::bus::bus& getBus() override
+    {
+        return services.getBus();
+    }
+
+    virtual ErrorLogging& getErrorLogging() override
+    {
+        return errorLogging;
+    }
+
+    virtual Journal& getJournal() override
+    {
+        return journal;
+    }
+
+    virtual PresenceService& getPresenceService() override
+    {
+        return presenceService;
+    }
+
+    virtual Sensors& getSensors() override
+    {
+        return sensors;
+    }
+
+    virtual VPD& getVPD() override
+    {
+        return vpd;
+    }
+
+    /**
+     * Replays the recorded calls using the real services.
+     */
+    void replay()
+    {
+        calls.replay(services);
+    }
+
+  private:
+    Services& services;
+    DeferredCalls calls{};
+    DeferredErrorLogging errorLogging;
+    DeferredJournal journal;
+    LockedPresenceService presenceService;
+    DeferredSensors sensors;
+    LockedVPD vpd;
+};
+
+} // namespace phosphor::power::regulators
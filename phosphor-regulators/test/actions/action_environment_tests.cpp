@@ -21,8 +21,10 @@
 #include "mocked_i2c_interface.hpp"
 #include "phase_fault.hpp"
 #include "rule.hpp"
+#include "sensors.hpp"
 
 #include <cstddef> // for size_t
+#include <cstdint>
 #include <exception>
 #include <memory>
 #include <stdexcept>
@@ -58,6 +60,7 @@ TEST(ActionEnvironmentTests, Constructor)
         EXPECT_EQ(env.getDevice().getID(), "regulator1");
         EXPECT_EQ(env.getDeviceID(), "regulator1");
         EXPECT_EQ(env.getPhaseFaults().size(), 0);
+        EXPECT_EQ(env.getSensorValues().size(), 0);
         EXPECT_EQ(env.getRuleDepth(), 0);
         EXPECT_EQ(env.getVolts().has_value(), false);
     }
@@ -105,6 +108,65 @@ TEST(ActionEnvironmentTests, AddPhaseFault)
     EXPECT_EQ(env.getPhaseFaults().size(), 2);
 }
 
+TEST(ActionEnvironmentTests, AddSensorValue)
+{
+    IDMap idMap{};
+    MockServices services{};
+    ActionEnvironment env{idMap, "", services};
+    EXPECT_EQ(env.getSensorValues().size(), 0);
+
+    // Add iout value
+    env.addSensorValue(SensorType::iout, 11.5);
+    EXPECT_EQ(env.getSensorValues().size(), 1);
+    EXPECT_EQ(env.getSensorValues().at(SensorType::iout), 11.5);
+
+    // Add vout value
+    env.addSensorValue(SensorType::vout, 1.3);
+    EXPECT_EQ(env.getSensorValues().size(), 2);
+    EXPECT_EQ(env.getSensorValues().at(SensorType::vout), 1.3);
+
+    // Add iout value again; should replace previous value
+    env.addSensorValue(SensorType::iout, 12.0);
+    EXPECT_EQ(env.getSensorValues().size(), 2);
+    EXPECT_EQ(env.getSensorValues().at(SensorType::iout), 12.0);
+}
+
+TEST(ActionEnvironmentTests, CacheRegisters)
+{
+    IDMap idMap{};
+    MockServices services{};
+    ActionEnvironment env{idMap, "", services};
+    EXPECT_EQ(env.getCachedRegisters(0x00, 1), nullptr);
+
+    // Cache registers 0x20-0x23
+    const uint8_t values[] = {0x01, 0x02, 0x03, 0x04};
+    env.cacheRegisters(0x20, values, 4);
+    const uint8_t* cached = env.getCachedRegisters(0x20, 4);
+    ASSERT_NE(cached, nullptr);
+    EXPECT_EQ(cached[0], 0x01);
+    EXPECT_EQ(cached[3], 0x04);
+
+    // Cache registers 0x40-0x41; should replace previous values
+    const uint8_t newValues[] = {0xAB, 0xCD};
+    env.cacheRegisters(0x40, newValues, 2);
+    EXPECT_EQ(env.getCachedRegisters(0x20, 1), nullptr);
+    cached = env.getCachedRegisters(0x41, 1);
+    ASSERT_NE(cached, nullptr);
+    EXPECT_EQ(*cached, 0xCD);
+}
+
+TEST(ActionEnvironmentTests, ClearCachedRegisters)
+{
+    IDMap idMap{};
+    MockServices services{};
+    ActionEnvironment env{idMap, "", services};
+    const uint8_t values[] = {0x01, 0x02};
+    env.cacheRegisters(0x20, values, 2);
+    EXPECT_NE(env.getCachedRegisters(0x20, 2), nullptr);
+    env.clearCachedRegisters();
+    EXPECT_EQ(env.getCachedRegisters(0x20, 1), nullptr);
+}
+
 TEST(ActionEnvironmentTests, DecrementRuleDepth)
 {
     IDMap idMap{};
@@ -138,6 +200,27 @@ TEST(ActionEnvironmentTests, GetAdditionalErrorData)
     EXPECT_EQ(env.getAdditionalErrorData().at("bar"), "bar_value");
 }
 
+TEST(ActionEnvironmentTests, GetCachedRegisters)
+{
+    IDMap idMap{};
+    MockServices services{};
+    ActionEnvironment env{idMap, "", services};
+    const uint8_t values[] = {0x11, 0x22, 0x33};
+    env.cacheRegisters(0x10, values, 3);
+
+    // Test where all registers are cached
+    const uint8_t* cached = env.getCachedRegisters(0x11, 2);
+    ASSERT_NE(cached, nullptr);
+    EXPECT_EQ(cached[0], 0x22);
+    EXPECT_EQ(cached[1], 0x33);
+
+    // Test where first register is before the cached registers
+    EXPECT_EQ(env.getCachedRegisters(0x0F, 2), nullptr);
+
+    // Test where last register is after the cached registers
+    EXPECT_EQ(env.getCachedRegisters(0x12, 2), nullptr);
+}
+
 TEST(ActionEnvironmentTests, GetDevice)
 {
     // Create IDMap
@@ -270,6 +353,18 @@ TEST(ActionEnvironmentTests, GetRuleDepth)
     EXPECT_EQ(env.getRuleDepth(), 0);
 }
 
+TEST(ActionEnvironmentTests, GetSensorValues)
+{
+    IDMap idMap{};
+    MockServices services{};
+    ActionEnvironment env{idMap, "", services};
+    EXPECT_EQ(env.getSensorValues().size(), 0);
+
+    env.addSensorValue(SensorType::temperature, 45.0);
+    EXPECT_EQ(env.getSensorValues().size(), 1);
+    EXPECT_EQ(env.getSensorValues().at(SensorType::temperature), 45.0);
+}
+
 TEST(ActionEnvironmentTests, GetServices)
 {
     IDMap idMap{};
@@ -326,6 +421,73 @@ TEST(ActionEnvironmentTests, IncrementRuleDepth)
     }
 }
 
+TEST(ActionEnvironmentTests, Reset)
+{
+    IDMap idMap{};
+    MockServices services{};
+    ActionEnvironment env{idMap, "regulator1", services};
+    env.addAdditionalErrorData("foo", "foo_value");
+    env.addPhaseFault(PhaseFaultType::n);
+    env.addSensorValue(SensorType::iout, 11.5);
+    env.incrementRuleDepth("set_voltage_rule");
+    env.setVolts(1.3);
+    const uint8_t values[] = {0x01};
+    env.cacheRegisters(0x20, values, 1);
+
+    // Verify all data is cleared and the new device ID is set
+    env.reset("regulator2");
+    EXPECT_EQ(env.getCachedRegisters(0x20, 1), nullptr);
+    EXPECT_EQ(env.getDeviceID(), "regulator2");
+    EXPECT_EQ(env.getAdditionalErrorData().size(), 0);
+    EXPECT_EQ(env.getPhaseFaults().size(), 0);
+    EXPECT_EQ(env.getSensorValues().size(), 0);
+    EXPECT_EQ(env.getRuleDepth(), 0);
+    EXPECT_EQ(env.getVolts().has_value(), false);
+
+    // Verify environment can be used again after being reset
+    env.addSensorValue(SensorType::vout, 1.2);
+    EXPECT_EQ(env.getSensorValues().size(), 1);
+    EXPECT_EQ(env.getSensorValues().at(SensorType::vout), 1.2);
+}
+
+TEST(ActionEnvironmentTests, SetDeferredVerifications)
+{
+    // Create IDMap with two devices
+    IDMap idMap{};
+    MockServices services{};
+    Device reg1{
+        "regulator1", true,
+        "/xyz/openbmc_project/inventory/system/chassis/motherboard/reg1",
+        i2c::create(1, 0x70, i2c::I2CInterface::InitialState::CLOSED)};
+    Device reg2{
+        "regulator2", true,
+        "/xyz/openbmc_project/inventory/system/chassis/motherboard/reg2",
+        i2c::create(1, 0x71, i2c::I2CInterface::InitialState::CLOSED)};
+    idMap.addDevice(reg1);
+    idMap.addDevice(reg2);
+
+    ActionEnvironment env{idMap, "regulator1", services};
+    EXPECT_FALSE(env.isVerificationDeferred());
+
+    // Only the verifications of the specified device are deferred
+    std::vector<DeferredVerification> verifications{};
+    env.setDeferredVerifications(reg1, verifications);
+    EXPECT_TRUE(env.isVerificationDeferred());
+    int count{0};
+    env.deferVerification([&count]() { ++count; });
+    EXPECT_EQ(verifications.size(), 1);
+    verifications[0]();
+    EXPECT_EQ(count, 1);
+    env.setDeviceID("regulator2");
+    EXPECT_FALSE(env.isVerificationDeferred());
+    env.setDeviceID("regulator1");
+    EXPECT_TRUE(env.isVerificationDeferred());
+
+    // Not deferred after a reset
+    env.reset("regulator1");
+    EXPECT_FALSE(env.isVerificationDeferred());
+}
+
 TEST(ActionEnvironmentTests, SetDeviceID)
 {
     IDMap idMap{};
@@ -334,6 +496,30 @@ TEST(ActionEnvironmentTests, SetDeviceID)
     EXPECT_EQ(env.getDeviceID(), "regulator1");
     env.setDeviceID("regulator2");
     EXPECT_EQ(env.getDeviceID(), "regulator2");
+
+    // Test where device is specified.  Device is not looked up in IDMap.
+    std::unique_ptr<i2c::I2CInterface> i2cInterface =
+        i2c::create(1, 0x70, i2c::I2CInterface::InitialState::CLOSED);
+    Device reg1{
+        "regulator1", true,
+        "/xyz/openbmc_project/inventory/system/chassis/motherboard/reg1",
+        std::move(i2cInterface)};
+    env.setDeviceID("regulator1", reg1);
+    EXPECT_EQ(env.getDeviceID(), "regulator1");
+    EXPECT_EQ(&(env.getDevice()), &reg1);
+
+    // Test where device is no longer specified
+    env.setDeviceID("regulator1");
+    EXPECT_THROW(env.getDevice(), std::invalid_argument);
+
+    // Test where cached registers are cleared when the device ID is set
+    const uint8_t values[] = {0x01};
+    env.cacheRegisters(0x20, values, 1);
+    env.setDeviceID("regulator2");
+    EXPECT_EQ(env.getCachedRegisters(0x20, 1), nullptr);
+    env.cacheRegisters(0x20, values, 1);
+    env.setDeviceID("regulator1", reg1);
+    EXPECT_EQ(env.getCachedRegisters(0x20, 1), nullptr);
 }
 
 TEST(ActionEnvironmentTests, SetVolts)
@@ -0,0 +1,504 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "action.hpp"
+#include "action_environment.hpp"
+#include "action_program.hpp"
+#include "and_action.hpp"
+#include "device.hpp"
+#include "i2c_compare_byte_action.hpp"
+#include "i2c_compare_bytes_action.hpp"
+#include "i2c_interface.hpp"
+#include "id_map.hpp"
+#include "if_action.hpp"
+#include "mock_action.hpp"
+#include "mock_services.hpp"
+#include "mocked_i2c_interface.hpp"
+#include "not_action.hpp"
+#include "or_action.hpp"
+#include "rule.hpp"
+#include "run_rule_action.hpp"
+
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+using namespace phosphor::power::regulators;
+
+using ::testing::_;
+using ::testing::NotNull;
+using ::testing::Return;
+using ::testing::SetArgReferee;
+using ::testing::SetArrayArgument;
+using ::testing::Throw;
+using ::testing::TypedEq;
+
+/**
+ * Creates a MockAction that is executed the specified number of times and
+ * returns the specified value.
+ *
+ * @param returnValue value returned by the action
+ * @param times number of times the action is expected to be executed
+ * @return MockAction object
+ */
+static std::unique_ptr<MockAction> createMockAction(bool returnValue,
+                                                    int times = 1)
+{
+    auto action = std::make_unique<MockAction>();
+    EXPECT_CALL(*action, execute)
+        .Times(times)
+        .WillRepeatedly(Return(returnValue));
+    return action;
+}
+
+/**
+ * Creates the actions that compare registers 0x20-0x22 to 0x11, 0x22, and
+ * 0x33.
+ *
+ * @return actions
+ */
+static std::vector<std::unique_ptr<Action>> createRegisterActions()
+{
+    std::vector<std::unique_ptr<Action>> actions{};
+    actions.push_back(std::make_unique<I2CCompareByteAction>(0x20, 0x11));
+    actions.push_back(std::make_unique<I2CCompareBytesAction>(
+        0x21, std::vector<uint8_t>{0x22, 0x33}));
+    return actions;
+}
+
+TEST(ActionProgramTests, Constructor)
+{
+    // Test where there are no actions
+    {
+        std::vector<std::unique_ptr<Action>> actions{};
+        IDMap idMap{};
+        ActionProgram program{actions, idMap};
+        EXPECT_EQ(program.getInstructionCount(), 2);
+    }
+
+    // Test where the same rule is run multiple times.  Rule is only compiled
+    // once.
+    {
+        std::vector<std::unique_ptr<Action>> ruleActions{};
+        ruleActions.push_back(createMockAction(true, 0));
+        Rule rule{"read_sensors_rule", std::move(ruleActions)};
+        IDMap idMap{};
+        idMap.addRule(rule);
+
+        std::vector<std::unique_ptr<Action>> actions{};
+        actions.push_back(std::make_unique<RunRuleAction>("read_sensors_rule"));
+        actions.push_back(std::make_unique<RunRuleAction>("read_sensors_rule"));
+        ActionProgram program{actions, idMap};
+
+        // call, pop, call, halt, execute, return
+        EXPECT_EQ(program.getInstructionCount(), 6);
+    }
+
+    // Test where a memoizable rule is run.  Rule is not compiled.
+    {
+        std::vector<std::unique_ptr<Action>> ruleActions{};
+        ruleActions.push_back(createMockAction(true, 0));
+        Rule rule{"is_foobar_backplane_installed_rule", std::move(ruleActions)};
+        rule.setMemoizable(true);
+        IDMap idMap{};
+        idMap.addRule(rule);
+
+        std::vector<std::unique_ptr<Action>> actions{};
+        actions.push_back(std::make_unique<RunRuleAction>(
+            "is_foobar_backplane_installed_rule"));
+        ActionProgram program{actions, idMap};
+
+        // execute, halt
+        EXPECT_EQ(program.getInstructionCount(), 2);
+    }
+
+    // Test where adjacent actions read consecutive registers.  Registers are
+    // read with one block read.
+    {
+        std::vector<std::unique_ptr<Action>> actions = createRegisterActions();
+        IDMap idMap{};
+        ActionProgram program{actions, idMap};
+
+        // read registers, execute, pop, execute, clear registers, halt
+        EXPECT_EQ(program.getInstructionCount(), 6);
+    }
+
+    // Test where adjacent actions read registers that are not consecutive
+    {
+        std::vector<std::unique_ptr<Action>> actions{};
+        actions.push_back(std::make_unique<I2CCompareByteAction>(0x20, 0x11));
+        actions.push_back(std::make_unique<I2CCompareByteAction>(0x40, 0x22));
+        IDMap idMap{};
+        ActionProgram program{actions, idMap};
+
+        // execute, pop, execute, halt
+        EXPECT_EQ(program.getInstructionCount(), 4);
+    }
+}
+
+TEST(ActionProgramTests, Execute)
+{
+    // Test where there are no actions.  Returns true.
+    {
+        std::vector<std::unique_ptr<Action>> actions{};
+        IDMap idMap{};
+        MockServices services{};
+        ActionEnvironment env{idMap, "", services};
+        ActionProgram program{actions, idMap};
+        EXPECT_TRUE(program.execute(env));
+    }
+
+    // Test where return value is from the last action
+    {
+        std::vector<std::unique_ptr<Action>> actions{};
+        actions.push_back(createMockAction(true));
+        actions.push_back(createMockAction(false));
+        IDMap idMap{};
+        MockServices services{};
+        ActionEnvironment env{idMap, "", services};
+        ActionProgram program{actions, idMap};
+        EXPECT_FALSE(program.execute(env));
+    }
+
+    // Test where and action executes all actions
+    {
+        std::vector<std::unique_ptr<Action>> andActions{};
+        andActions.push_back(createMockAction(false));
+        andActions.push_back(createMockAction(true));
+        std::vector<std::unique_ptr<Action>> actions{};
+        actions.push_back(std::make_unique<AndAction>(std::move(andActions)));
+        actions.push_back(std::make_unique<AndAction>(
+            std::vector<std::unique_ptr<Action>>{}));
+        IDMap idMap{};
+        MockServices services{};
+        ActionEnvironment env{idMap, "", services};
+
+        // Empty and action returns true
+        ActionProgram program{actions, idMap};
+        EXPECT_TRUE(program.execute(env));
+    }
+
+    // Test where and/or/not actions are nested
+    {
+        std::vector<std::unique_ptr<Action>> andActions{};
+        andActions.push_back(createMockAction(true));
+        andActions.push_back(createMockAction(false));
+        std::vector<std::unique_ptr<Action>> orActions{};
+        orActions.push_back(createMockAction(false));
+        orActions.push_back(
+            std::make_unique<NotAction>(createMockAction(false)));
+        andActions.push_back(std::make_unique<OrAction>(std::move(orActions)));
+        std::vector<std::unique_ptr<Action>> actions{};
+        actions.push_back(std::make_unique<NotAction>(
+            std::make_unique<AndAction>(std::move(andActions))));
+        IDMap idMap{};
+        MockServices services{};
+        ActionEnvironment env{idMap, "", services};
+
+        // not(and(true, false, or(false, not(false)))) is true
+        ActionProgram program{actions, idMap};
+        EXPECT_TRUE(program.execute(env));
+    }
+
+    // Test where or action has no actions.  Returns false.
+    {
+        std::vector<std::unique_ptr<Action>> actions{};
+        actions.push_back(
+            std::make_unique<OrAction>(std::vector<std::unique_ptr<Action>>{}));
+        IDMap idMap{};
+        MockServices services{};
+        ActionEnvironment env{idMap, "", services};
+        ActionProgram program{actions, idMap};
+        EXPECT_FALSE(program.execute(env));
+    }
+
+    // Test where if condition is true
+    {
+        std::vector<std::unique_ptr<Action>> thenActions{};
+        thenActions.push_back(createMockAction(true));
+        thenActions.push_back(createMockAction(false));
+        std::vector<std::unique_ptr<Action>> elseActions{};
+        elseActions.push_back(createMockAction(true, 0));
+        std::vector<std::unique_ptr<Action>> actions{};
+        actions.push_back(std::make_unique<IfAction>(createMockAction(true),
+                                                     std::move(thenActions),
+                                                     std::move(elseActions)));
+        IDMap idMap{};
+        MockServices services{};
+        ActionEnvironment env{idMap, "", services};
+        ActionProgram program{actions, idMap};
+        EXPECT_FALSE(program.execute(env));
+    }
+
+    // Test where if condition is false and else clause specified
+    {
+        std::vector<std::unique_ptr<Action>> thenActions{};
+        thenActions.push_back(createMockAction(false, 0));
+        std::vector<std::unique_ptr<Action>> elseActions{};
+        elseActions.push_back(createMockAction(true));
+        std::vector<std::unique_ptr<Action>> actions{};
+        actions.push_back(std::make_unique<IfAction>(createMockAction(false),
+                                                     std::move(thenActions),
+                                                     std::move(elseActions)));
+        IDMap idMap{};
+        MockServices services{};
+        ActionEnvironment env{idMap, "", services};
+        ActionProgram program{actions, idMap};
+        EXPECT_TRUE(program.execute(env));
+    }
+
+    // Test where if condition is false and no else clause specified.  Returns
+    // false.
+    {
+        std::vector<std::unique_ptr<Action>> thenActions{};
+        thenActions.push_back(createMockAction(true, 0));
+        std::vector<std::unique_ptr<Action>> actions{};
+        actions.push_back(std::make_unique<IfAction>(createMockAction(false),
+                                                     std::move(thenActions)));
+        IDMap idMap{};
+        MockServices services{};
+        ActionEnvironment env{idMap, "", services};
+        ActionProgram program{actions, idMap};
+        EXPECT_FALSE(program.execute(env));
+    }
+
+    // Test where rules run other rules
+    {
+        std::vector<std::unique_ptr<Action>> innerActions{};
+        innerActions.push_back(createMockAction(false, 2));
+        Rule innerRule{"inner_rule", std::move(innerActions)};
+
+        std::vector<std::unique_ptr<Action>> outerActions{};
+        outerActions.push_back(std::make_unique<RunRuleAction>("inner_rule"));
+        outerActions.push_back(std::make_unique<NotAction>(
+            std::make_unique<RunRuleAction>("inner_rule")));
+        Rule outerRule{"outer_rule", std::move(outerActions)};
+
+        IDMap idMap{};
+        idMap.addRule(innerRule);
+        idMap.addRule(outerRule);
+        MockServices services{};
+        ActionEnvironment env{idMap, "", services};
+
+        std::vector<std::unique_ptr<Action>> actions{};
+        actions.push_back(std::make_unique<RunRuleAction>("outer_rule"));
+        ActionProgram program{actions, idMap};
+        EXPECT_TRUE(program.execute(env));
+        EXPECT_EQ(env.getRuleDepth(), 0);
+    }
+
+    // Test where rule is not in the IDMap
+    try
+    {
+        std::vector<std::unique_ptr<Action>> actions{};
+        actions.push_back(std::make_unique<RunRuleAction>("set_voltage_rule"));
+        IDMap idMap{};
+        MockServices services{};
+        ActionEnvironment env{idMap, "", services};
+        ActionProgram program{actions, idMap};
+        program.execute(env);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& ia_error)
+    {
+        EXPECT_STREQ(ia_error.what(),
+                     "Unable to find rule with ID \"set_voltage_rule\"");
+    }
+    catch (const std::exception& error)
+    {
+        ADD_FAILURE() << "Should not have caught exception.";
+    }
+
+    // Test where rule calls itself and results in infinite recursion
+    try
+    {
+        std::vector<std::unique_ptr<Action>> ruleActions{};
+        ruleActions.push_back(std::make_unique<RunRuleAction>("infinite_rule"));
+        Rule rule{"infinite_rule", std::move(ruleActions)};
+        IDMap idMap{};
+        idMap.addRule(rule);
+        MockServices services{};
+        ActionEnvironment env{idMap, "", services};
+
+        std::vector<std::unique_ptr<Action>> actions{};
+        actions.push_back(std::make_unique<RunRuleAction>("infinite_rule"));
+        ActionProgram program{actions, idMap};
+        program.execute(env);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::runtime_error& r_error)
+    {
+        EXPECT_STREQ(r_error.what(),
+                     "Maximum rule depth exceeded by rule infinite_rule.");
+    }
+    catch (const std::exception& error)
+    {
+        ADD_FAILURE() << "Should not have caught exception.";
+    }
+
+    // Test where memoized result of a rule is reused
+    {
+        std::vector<std::unique_ptr<Action>> ruleActions{};
+        ruleActions.push_back(createMockAction(false, 1));
+        Rule rule{"is_foobar_backplane_installed_rule", std::move(ruleActions)};
+        rule.setMemoizable(true);
+        IDMap idMap{};
+        idMap.addRule(rule);
+        MockServices services{};
+        ON_CALL(services.getMockPresenceService(), getGeneration)
+            .WillByDefault(Return(1));
+        ON_CALL(services.getMockVPD(), getGeneration).WillByDefault(Return(1));
+        ActionEnvironment env{idMap, "", services};
+
+        std::vector<std::unique_ptr<Action>> actions{};
+        actions.push_back(std::make_unique<NotAction>(
+            std::make_unique<RunRuleAction>(
+                "is_foobar_backplane_installed_rule")));
+        ActionProgram program{actions, idMap};
+        EXPECT_TRUE(program.execute(env));
+        EXPECT_TRUE(program.execute(env));
+        EXPECT_EQ(env.getRuleDepth(), 0);
+    }
+
+    // Test where registers are read with one block read.  Device
+    // auto-increments the register address.
+    {
+        auto i2cInterface = std::make_unique<i2c::MockedI2CInterface>();
+        uint8_t actualValues[] = {0x11, 0x22, 0x33};
+        EXPECT_CALL(*i2cInterface, isOpen).WillRepeatedly(Return(true));
+        EXPECT_CALL(*i2cInterface, read(0x20, TypedEq<uint8_t&>(3), NotNull(),
+                                        i2c::I2CInterface::Mode::I2C))
+            .Times(1)
+            .WillOnce(SetArrayArgument<2>(actualValues, actualValues + 3));
+        EXPECT_CALL(*i2cInterface, read(_, TypedEq<uint8_t&>(0))).Times(0);
+        Device device{
+            "reg1", true,
+            "/xyz/openbmc_project/inventory/system/chassis/motherboard/reg1",
+            std::move(i2cInterface)};
+        device.setAutoIncrement(true);
+        IDMap idMap{};
+        idMap.addDevice(device);
+        MockServices services{};
+        ActionEnvironment env{idMap, "reg1", services};
+
+        std::vector<std::unique_ptr<Action>> actions = createRegisterActions();
+        ActionProgram program{actions, idMap};
+        EXPECT_TRUE(program.execute(env));
+        EXPECT_EQ(env.getCachedRegisters(0x20, 1), nullptr);
+    }
+
+    // Test where registers are read individually.  Device does not
+    // auto-increment the register address.
+    {
+        auto i2cInterface = std::make_unique<i2c::MockedI2CInterface>();
+        uint8_t actualValues[] = {0x22, 0x33};
+        EXPECT_CALL(*i2cInterface, isOpen).WillRepeatedly(Return(true));
+        EXPECT_CALL(*i2cInterface, read(0x20, TypedEq<uint8_t&>(0)))
+            .Times(1)
+            .WillOnce(SetArgReferee<1>(0x11));
+        EXPECT_CALL(*i2cInterface, read(0x21, TypedEq<uint8_t&>(2), NotNull(),
+                                        i2c::I2CInterface::Mode::I2C))
+            .Times(1)
+            .WillOnce(SetArrayArgument<2>(actualValues, actualValues + 2));
+        Device device{
+            "reg1", true,
+            "/xyz/openbmc_project/inventory/system/chassis/motherboard/reg1",
+            std::move(i2cInterface)};
+        IDMap idMap{};
+        idMap.addDevice(device);
+        MockServices services{};
+        ActionEnvironment env{idMap, "reg1", services};
+
+        std::vector<std::unique_ptr<Action>> actions = createRegisterActions();
+        ActionProgram program{actions, idMap};
+        EXPECT_TRUE(program.execute(env));
+    }
+
+    // Test where block read fails.  Registers are read individually.
+    {
+        auto i2cInterface = std::make_unique<i2c::MockedI2CInterface>();
+        uint8_t actualValues[] = {0x22, 0x33};
+        EXPECT_CALL(*i2cInterface, isOpen).WillRepeatedly(Return(true));
+        EXPECT_CALL(*i2cInterface, read(0x20, TypedEq<uint8_t&>(3), NotNull(),
+                                        i2c::I2CInterface::Mode::I2C))
+            .Times(1)
+            .WillOnce(Throw(i2c::I2CException{"Failed to read i2c block data",
+                                              "/dev/i2c-1", 0x70}));
+        EXPECT_CALL(*i2cInterface, read(0x20, TypedEq<uint8_t&>(0)))
+            .Times(1)
+            .WillOnce(SetArgReferee<1>(0x11));
+        EXPECT_CALL(*i2cInterface, read(0x21, TypedEq<uint8_t&>(2), NotNull(),
+                                        i2c::I2CInterface::Mode::I2C))
+            .Times(1)
+            .WillOnce(SetArrayArgument<2>(actualValues, actualValues + 2));
+        Device device{
+            "reg1", true,
+            "/xyz/openbmc_project/inventory/system/chassis/motherboard/reg1",
+            std::move(i2cInterface)};
+        device.setAutoIncrement(true);
+        IDMap idMap{};
+        idMap.addDevice(device);
+        MockServices services{};
+        ActionEnvironment env{idMap, "reg1", services};
+
+        std::vector<std::unique_ptr<Action>> actions = createRegisterActions();
+        ActionProgram program{actions, idMap};
+        EXPECT_TRUE(program.execute(env));
+    }
+
+    // Test where an action throws an exception
+    try
+    {
+        auto action = std::make_unique<MockAction>();
+        EXPECT_CALL(*action, execute)
+            .Times(1)
+            .WillOnce(Throw(std::logic_error{"Communication error"}));
+        std::vector<std::unique_ptr<Action>> actions{};
+        actions.push_back(std::move(action));
+        actions.push_back(createMockAction(true, 0));
+        IDMap idMap{};
+        MockServices services{};
+        ActionEnvironment env{idMap, "", services};
+        ActionProgram program{actions, idMap};
+        program.execute(env);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::exception& error)
+    {
+        EXPECT_STREQ(error.what(), "Communication error");
+    }
+}
+
+TEST(ActionProgramTests, GetInstructionCount)
+{
+    // Test where actions contain an if action
+    std::vector<std::unique_ptr<Action>> thenActions{};
+    thenActions.push_back(createMockAction(true, 0));
+    std::vector<std::unique_ptr<Action>> actions{};
+    actions.push_back(std::make_unique<IfAction>(createMockAction(true, 0),
+                                                 std::move(thenActions)));
+    IDMap idMap{};
+    ActionProgram program{actions, idMap};
+
+    // execute, jump if false, execute, jump, push false, halt
+    EXPECT_EQ(program.getInstructionCount(), 6);
+}
@@ -19,6 +19,8 @@
 #include "id_map.hpp"
 #include "mock_action.hpp"
 #include "mock_services.hpp"
+#include "rule.hpp"
+#include "run_rule_action.hpp"
 
 #include <exception>
 #include <memory>
@@ -165,6 +167,32 @@ TEST(AndActionTests, GetActions)
     EXPECT_EQ(andAction.getActions()[1].get(), action2);
 }
 
+TEST(AndActionTests, Link)
+{
+    // Create rule and add to IDMap
+    std::vector<std::unique_ptr<Action>> ruleActions{};
+    std::unique_ptr<MockAction> ruleAction = std::make_unique<MockAction>();
+    EXPECT_CALL(*ruleAction, execute).Times(2).WillRepeatedly(Return(true));
+    ruleActions.push_back(std::move(ruleAction));
+    Rule rule("set_voltage_rule", std::move(ruleActions));
+    IDMap idMap{};
+    idMap.addRule(rule);
+
+    // Create AndAction that runs the rule twice
+    std::vector<std::unique_ptr<Action>> actions{};
+    actions.push_back(std::make_unique<RunRuleAction>("set_voltage_rule"));
+    actions.push_back(std::make_unique<RunRuleAction>("set_voltage_rule"));
+    AndAction andAction{std::move(actions)};
+    andAction.link(idMap);
+
+    // Execute with an empty IDMap.  Rule can only be found if the actions were
+    // linked.
+    IDMap emptyIDMap{};
+    MockServices services{};
+    ActionEnvironment env{emptyIDMap, "", services};
+    EXPECT_EQ(andAction.execute(env), true);
+}
+
 TEST(AndActionTests, ToString)
 {
     std::vector<std::unique_ptr<Action>> actions{};
@@ -22,8 +22,10 @@
 #include "mock_services.hpp"
 #include "mocked_i2c_interface.hpp"
 
+#include <algorithm>
 #include <cstdint>
 #include <memory>
+#include <span>
 #include <stdexcept>
 #include <string>
 #include <utility>
@@ -33,6 +35,8 @@
 
 using namespace phosphor::power::regulators;
 
+using ::testing::_;
+using ::testing::Invoke;
 using ::testing::NotNull;
 using ::testing::Return;
 using ::testing::SetArrayArgument;
@@ -47,6 +51,20 @@ TEST(I2CCaptureBytesActionTests, Constructor)
         I2CCaptureBytesAction action{0x2A, 2};
         EXPECT_EQ(action.getRegister(), 0x2A);
         EXPECT_EQ(action.getCount(), 2);
+        EXPECT_FALSE(action.getIsLargeRead());
+    }
+    catch (...)
+    {
+        ADD_FAILURE() << "Should not have caught exception.";
+    }
+
+    // Test where works: Large read
+    try
+    {
+        I2CCaptureBytesAction action{0x2A, 100, true};
+        EXPECT_EQ(action.getRegister(), 0x2A);
+        EXPECT_EQ(action.getCount(), 100);
+        EXPECT_TRUE(action.getIsLargeRead());
     }
     catch (...)
     {
@@ -139,6 +157,48 @@ TEST(I2CCaptureBytesActionTests, Execute)
         ADD_FAILURE() << "Should not have caught exception.";
     }
 
+    // Test where works: Large read of more than 32 bytes
+    try
+    {
+        // Create mock I2CInterface: readLarge() returns 40 bytes of 0xA5
+        std::unique_ptr<i2c::MockedI2CInterface> i2cInterface =
+            std::make_unique<i2c::MockedI2CInterface>();
+        EXPECT_CALL(*i2cInterface, isOpen).Times(1).WillOnce(Return(true));
+        EXPECT_CALL(*i2cInterface, read(_, TypedEq<uint8_t&>(40), _, _))
+            .Times(0);
+        EXPECT_CALL(*i2cInterface, readLarge(0xDC, _))
+            .Times(1)
+            .WillOnce(Invoke([](uint8_t, std::span<uint8_t> data) {
+                EXPECT_EQ(data.size(), 40);
+                std::fill(data.begin(), data.end(), 0xA5);
+            }));
+
+        // Create Device, IDMap, MockServices, and ActionEnvironment
+        Device device{
+            "vdd1", true,
+            "/xyz/openbmc_project/inventory/system/chassis/motherboard/vdd1",
+            std::move(i2cInterface)};
+        IDMap idMap{};
+        idMap.addDevice(device);
+        MockServices services{};
+        ActionEnvironment env{idMap, "vdd1", services};
+
+        I2CCaptureBytesAction action{0xDC, 40, true};
+        EXPECT_EQ(action.execute(env), true);
+        std::string expectedValue{"[ 0xA5"};
+        for (int i = 1; i < 40; ++i)
+        {
+            expectedValue += ", 0xA5";
+        }
+        expectedValue += " ]";
+        EXPECT_EQ(env.getAdditionalErrorData().at("vdd1_register_0xDC"),
+                  expectedValue);
+    }
+    catch (...)
+    {
+        ADD_FAILURE() << "Should not have caught exception.";
+    }
+
     // Test where works: Same device + register captured multiple times
     try
     {
@@ -268,6 +328,15 @@ TEST(I2CCaptureBytesActionTests, GetCount)
     EXPECT_EQ(action.getCount(), 3);
 }
 
+TEST(I2CCaptureBytesActionTests, GetIsLargeRead)
+{
+    I2CCaptureBytesAction action{0xA0, 3};
+    EXPECT_FALSE(action.getIsLargeRead());
+
+    I2CCaptureBytesAction largeAction{0xA0, 64, true};
+    EXPECT_TRUE(largeAction.getIsLargeRead());
+}
+
 TEST(I2CCaptureBytesActionTests, GetRegister)
 {
     I2CCaptureBytesAction action{0xA0, 3};
@@ -279,4 +348,9 @@ TEST(I2CCaptureBytesActionTests, ToString)
     I2CCaptureBytesAction action{0xA0, 3};
     EXPECT_EQ(action.toString(),
               "i2c_capture_bytes: { register: 0xA0, count: 3 }");
+
+    I2CCaptureBytesAction largeAction{0xA0, 64, true};
+    EXPECT_EQ(
+        largeAction.toString(),
+        "i2c_capture_bytes: { register: 0xA0, count: 64, large_read: true }");
 }
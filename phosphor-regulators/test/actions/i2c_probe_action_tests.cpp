@@ -0,0 +1,242 @@
+/**
+ * Copyright © 2019 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "action_environment.hpp"
+#include "action_error.hpp"
+#include "device.hpp"
+#include "i2c_interface.hpp"
+#include "i2c_probe_action.hpp"
+#include "id_map.hpp"
+#include "mock_services.hpp"
+#include "mocked_i2c_interface.hpp"
+
+#include <cerrno>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+using namespace phosphor::power::regulators;
+
+using ::testing::A;
+using ::testing::Return;
+using ::testing::SetArgReferee;
+using ::testing::Throw;
+
+namespace
+{
+
+/**
+ * Returns a Device with the specified I2C interface.
+ */
+std::unique_ptr<Device>
+    createDevice(std::unique_ptr<i2c::MockedI2CInterface> i2cInterface)
+{
+    return std::make_unique<Device>(
+        "reg1", true,
+        "/xyz/openbmc_project/inventory/system/chassis/motherboard/reg1",
+        std::move(i2cInterface));
+}
+
+} // namespace
+
+TEST(I2CProbeActionTests, Constructor)
+{
+    // Test where method is not specified
+    {
+        I2CProbeAction action{};
+        EXPECT_EQ(action.getMethod(), I2CProbeAction::Method::readByte);
+    }
+
+    // Test where method is specified
+    {
+        I2CProbeAction action{I2CProbeAction::Method::quick};
+        EXPECT_EQ(action.getMethod(), I2CProbeAction::Method::quick);
+    }
+}
+
+TEST(I2CProbeActionTests, Execute)
+{
+    // Test where works: Quick command acknowledged
+    try
+    {
+        // Create mock I2CInterface: interface is closed, so it is opened
+        std::unique_ptr<i2c::MockedI2CInterface> i2cInterface =
+            std::make_unique<i2c::MockedI2CInterface>();
+        EXPECT_CALL(*i2cInterface, isOpen).Times(1).WillOnce(Return(false));
+        EXPECT_CALL(*i2cInterface, open).Times(1);
+        EXPECT_CALL(*i2cInterface, writeQuick).Times(1);
+        EXPECT_CALL(*i2cInterface, read(A<uint8_t&>())).Times(0);
+
+        // Create Device, IDMap, MockServices, and ActionEnvironment
+        std::unique_ptr<Device> device = createDevice(std::move(i2cInterface));
+        IDMap idMap{};
+        idMap.addDevice(*device);
+        MockServices services{};
+        ActionEnvironment env{idMap, "reg1", services};
+
+        I2CProbeAction action{I2CProbeAction::Method::quick};
+        EXPECT_EQ(action.execute(env), true);
+    }
+    catch (...)
+    {
+        ADD_FAILURE() << "Should not have caught exception.";
+    }
+
+    // Test where works: Receive byte acknowledged
+    try
+    {
+        // Create mock I2CInterface: read() returns value 0x12
+        std::unique_ptr<i2c::MockedI2CInterface> i2cInterface =
+            std::make_unique<i2c::MockedI2CInterface>();
+        EXPECT_CALL(*i2cInterface, isOpen).Times(1).WillOnce(Return(true));
+        EXPECT_CALL(*i2cInterface, writeQuick).Times(0);
+        EXPECT_CALL(*i2cInterface, read(A<uint8_t&>()))
+            .Times(1)
+            .WillOnce(SetArgReferee<0>(0x12));
+
+        // Create Device, IDMap, MockServices, and ActionEnvironment
+        std::unique_ptr<Device> device = createDevice(std::move(i2cInterface));
+        IDMap idMap{};
+        idMap.addDevice(*device);
+        MockServices services{};
+        ActionEnvironment env{idMap, "reg1", services};
+
+        I2CProbeAction action{};
+        EXPECT_EQ(action.execute(env), true);
+    }
+    catch (...)
+    {
+        ADD_FAILURE() << "Should not have caught exception.";
+    }
+
+    // Test where works: Device does not respond
+    try
+    {
+        // Create mock I2CInterface: writeQuick() fails with an errno
+        std::unique_ptr<i2c::MockedI2CInterface> i2cInterface =
+            std::make_unique<i2c::MockedI2CInterface>();
+        EXPECT_CALL(*i2cInterface, isOpen).Times(1).WillOnce(Return(true));
+        EXPECT_CALL(*i2cInterface, writeQuick)
+            .Times(1)
+            .WillOnce(Throw(i2c::I2CException{"Failed to write quick",
+                                              "/dev/i2c-1", 0x70, ENXIO}));
+
+        // Create Device, IDMap, MockServices, and ActionEnvironment
+        std::unique_ptr<Device> device = createDevice(std::move(i2cInterface));
+        IDMap idMap{};
+        idMap.addDevice(*device);
+        MockServices services{};
+        ActionEnvironment env{idMap, "reg1", services};
+
+        I2CProbeAction action{I2CProbeAction::Method::quick};
+        EXPECT_EQ(action.execute(env), false);
+    }
+    catch (...)
+    {
+        ADD_FAILURE() << "Should not have caught exception.";
+    }
+
+    // Test where fails: Getting I2CInterface fails
+    try
+    {
+        // Create IDMap, MockServices, and ActionEnvironment
+        IDMap idMap{};
+        MockServices services{};
+        ActionEnvironment env{idMap, "reg1", services};
+
+        I2CProbeAction action{};
+        action.execute(env);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Unable to find device with ID \"reg1\"");
+    }
+    catch (...)
+    {
+        ADD_FAILURE() << "Should not have caught exception.";
+    }
+
+    // Test where fails: Probe method not supported
+    try
+    {
+        // Create mock I2CInterface: read() fails without an errno
+        std::unique_ptr<i2c::MockedI2CInterface> i2cInterface =
+            std::make_unique<i2c::MockedI2CInterface>();
+        EXPECT_CALL(*i2cInterface, isOpen).Times(1).WillOnce(Return(true));
+        EXPECT_CALL(*i2cInterface, read(A<uint8_t&>()))
+            .Times(1)
+            .WillOnce(Throw(i2c::I2CException{"Missing SMBUS_READ_BYTE",
+                                              "/dev/i2c-1", 0x70}));
+
+        // Create Device, IDMap, MockServices, and ActionEnvironment
+        std::unique_ptr<Device> device = createDevice(std::move(i2cInterface));
+        IDMap idMap{};
+        idMap.addDevice(*device);
+        MockServices services{};
+        ActionEnvironment env{idMap, "reg1", services};
+
+        I2CProbeAction action{};
+        action.execute(env);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const ActionError& e)
+    {
+        EXPECT_STREQ(e.what(),
+                     "ActionError: i2c_probe: { method: read_byte }");
+        try
+        {
+            // Re-throw inner I2CException
+            std::rethrow_if_nested(e);
+            ADD_FAILURE() << "Should not have reached this line.";
+        }
+        catch (const i2c::I2CException& ie)
+        {
+            EXPECT_STREQ(ie.what(), "I2CException: Missing SMBUS_READ_BYTE: "
+                                    "bus /dev/i2c-1, addr 0x70");
+        }
+        catch (...)
+        {
+            ADD_FAILURE() << "Should not have caught exception.";
+        }
+    }
+    catch (...)
+    {
+        ADD_FAILURE() << "Should not have caught exception.";
+    }
+}
+
+TEST(I2CProbeActionTests, GetMethod)
+{
+    I2CProbeAction action{I2CProbeAction::Method::quick};
+    EXPECT_EQ(action.getMethod(), I2CProbeAction::Method::quick);
+}
+
+TEST(I2CProbeActionTests, ToString)
+{
+    {
+        I2CProbeAction action{I2CProbeAction::Method::quick};
+        EXPECT_EQ(action.toString(), "i2c_probe: { method: quick }");
+    }
+    {
+        I2CProbeAction action{I2CProbeAction::Method::readByte};
+        EXPECT_EQ(action.toString(), "i2c_probe: { method: read_byte }");
+    }
+}
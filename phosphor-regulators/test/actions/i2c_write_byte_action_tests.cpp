@@ -129,6 +129,47 @@ TEST(I2CWriteByteActionTests, Execute)
         ADD_FAILURE() << "Should not have caught exception.";
     }
 
+    // Test where works: PAGE written twice.  Second write skipped because page
+    // is already selected.
+    try
+    {
+        // Create mock I2CInterface
+        std::unique_ptr<i2c::MockedI2CInterface> i2cInterface =
+            std::make_unique<i2c::MockedI2CInterface>();
+        EXPECT_CALL(*i2cInterface, isOpen)
+            .Times(2)
+            .WillRepeatedly(Return(true));
+        EXPECT_CALL(*i2cInterface,
+                    write(TypedEq<uint8_t>(0x00), TypedEq<uint8_t>(0x01)))
+            .Times(1);
+        EXPECT_CALL(*i2cInterface,
+                    write(TypedEq<uint8_t>(0x00), TypedEq<uint8_t>(0x02)))
+            .Times(1);
+
+        // Create Device, IDMap, MockServices, and ActionEnvironment
+        Device device{
+            "reg1", true,
+            "/xyz/openbmc_project/inventory/system/chassis/motherboard/reg1",
+            std::move(i2cInterface)};
+        IDMap idMap{};
+        idMap.addDevice(device);
+        MockServices services{};
+        ActionEnvironment env{idMap, "reg1", services};
+
+        I2CWriteByteAction page1Action{0x00, 0x01};
+        I2CWriteByteAction page2Action{0x00, 0x02};
+        EXPECT_EQ(page1Action.execute(env), true);
+        EXPECT_EQ(device.getCurrentPage(), 0x01);
+        EXPECT_EQ(page1Action.execute(env), true);
+        EXPECT_EQ(device.getCurrentPage(), 0x01);
+        EXPECT_EQ(page2Action.execute(env), true);
+        EXPECT_EQ(device.getCurrentPage(), 0x02);
+    }
+    catch (...)
+    {
+        ADD_FAILURE() << "Should not have caught exception.";
+    }
+
     // Test where fails: Getting I2CInterface fails
     try
     {
@@ -256,6 +297,39 @@ TEST(I2CWriteByteActionTests, Execute)
     {
         ADD_FAILURE() << "Should not have caught exception.";
     }
+
+    // Test where fails: Writing PAGE fails.  Page is unknown, so next write is
+    // not skipped.
+    {
+        // Create mock I2CInterface: first write() throws an I2CException
+        std::unique_ptr<i2c::MockedI2CInterface> i2cInterface =
+            std::make_unique<i2c::MockedI2CInterface>();
+        EXPECT_CALL(*i2cInterface, isOpen)
+            .Times(2)
+            .WillRepeatedly(Return(true));
+        EXPECT_CALL(*i2cInterface,
+                    write(TypedEq<uint8_t>(0x00), TypedEq<uint8_t>(0x01)))
+            .Times(2)
+            .WillOnce(Throw(
+                i2c::I2CException{"Failed to write byte", "/dev/i2c-1", 0x70}))
+            .WillOnce(Return());
+
+        // Create Device, IDMap, MockServices, and ActionEnvironment
+        Device device{
+            "reg1", true,
+            "/xyz/openbmc_project/inventory/system/chassis/motherboard/reg1",
+            std::move(i2cInterface)};
+        IDMap idMap{};
+        idMap.addDevice(device);
+        MockServices services{};
+        ActionEnvironment env{idMap, "reg1", services};
+
+        I2CWriteByteAction action{0x00, 0x01};
+        EXPECT_THROW(action.execute(env), ActionError);
+        EXPECT_FALSE(device.getCurrentPage().has_value());
+        EXPECT_EQ(action.execute(env), true);
+        EXPECT_EQ(device.getCurrentPage(), 0x01);
+    }
 }
 
 TEST(I2CWriteByteActionTests, GetRegister)
@@ -19,6 +19,9 @@
 #include "if_action.hpp"
 #include "mock_action.hpp"
 #include "mock_services.hpp"
+#include "not_action.hpp"
+#include "rule.hpp"
+#include "run_rule_action.hpp"
 
 #include <exception>
 #include <memory>
@@ -301,6 +304,42 @@ TEST(IfActionTests, GetElseActions)
     EXPECT_EQ(ifAction.getElseActions()[1].get(), elseAction2);
 }
 
+TEST(IfActionTests, Link)
+{
+    // Create rule and add to IDMap
+    std::vector<std::unique_ptr<Action>> ruleActions{};
+    std::unique_ptr<MockAction> ruleAction = std::make_unique<MockAction>();
+    EXPECT_CALL(*ruleAction, execute).Times(4).WillRepeatedly(Return(true));
+    ruleActions.push_back(std::move(ruleAction));
+    Rule rule("set_voltage_rule", std::move(ruleActions));
+    IDMap idMap{};
+    idMap.addRule(rule);
+
+    // Create IfAction that runs the rule in the condition and "then" clause
+    std::vector<std::unique_ptr<Action>> thenActions{};
+    thenActions.push_back(std::make_unique<RunRuleAction>("set_voltage_rule"));
+    IfAction ifAction1{std::make_unique<RunRuleAction>("set_voltage_rule"),
+                       std::move(thenActions)};
+    ifAction1.link(idMap);
+
+    // Create IfAction that runs the rule in the condition and "else" clause
+    std::vector<std::unique_ptr<Action>> elseActions{};
+    elseActions.push_back(std::make_unique<RunRuleAction>("set_voltage_rule"));
+    IfAction ifAction2{std::make_unique<NotAction>(
+                           std::make_unique<RunRuleAction>("set_voltage_rule")),
+                       std::vector<std::unique_ptr<Action>>{},
+                       std::move(elseActions)};
+    ifAction2.link(idMap);
+
+    // Execute with an empty IDMap.  Rule can only be found if the actions were
+    // linked.
+    IDMap emptyIDMap{};
+    MockServices services{};
+    ActionEnvironment env{emptyIDMap, "", services};
+    EXPECT_EQ(ifAction1.execute(env), true);
+    EXPECT_EQ(ifAction2.execute(env), true);
+}
+
 TEST(IfActionTests, ToString)
 {
     // Test where else clause is not specified
@@ -19,6 +19,8 @@
 #include "mock_action.hpp"
 #include "mock_services.hpp"
 #include "not_action.hpp"
+#include "rule.hpp"
+#include "run_rule_action.hpp"
 
 #include <exception>
 #include <memory>
@@ -99,6 +101,29 @@ TEST(NotActionTests, GetAction)
     EXPECT_EQ(notAction.getAction().get(), action);
 }
 
+TEST(NotActionTests, Link)
+{
+    // Create rule and add to IDMap
+    std::vector<std::unique_ptr<Action>> ruleActions{};
+    std::unique_ptr<MockAction> ruleAction = std::make_unique<MockAction>();
+    EXPECT_CALL(*ruleAction, execute).Times(1).WillRepeatedly(Return(true));
+    ruleActions.push_back(std::move(ruleAction));
+    Rule rule("set_voltage_rule", std::move(ruleActions));
+    IDMap idMap{};
+    idMap.addRule(rule);
+
+    // Create NotAction that runs the rule
+    NotAction notAction{std::make_unique<RunRuleAction>("set_voltage_rule")};
+    notAction.link(idMap);
+
+    // Execute with an empty IDMap.  Rule can only be found if the action was
+    // linked.
+    IDMap emptyIDMap{};
+    MockServices services{};
+    ActionEnvironment env{emptyIDMap, "", services};
+    EXPECT_EQ(notAction.execute(env), false);
+}
+
 TEST(NotActionTests, ToString)
 {
     NotAction notAction{std::make_unique<MockAction>()};
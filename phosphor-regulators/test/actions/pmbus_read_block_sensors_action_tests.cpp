@@ -0,0 +1,397 @@
+/**
+ * Copyright © 2020 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "action_environment.hpp"
+#include "action_error.hpp"
+#include "device.hpp"
+#include "i2c_interface.hpp"
+#include "id_map.hpp"
+#include "mock_services.hpp"
+#include "mocked_i2c_interface.hpp"
+#include "pmbus_error.hpp"
+#include "pmbus_read_block_sensors_action.hpp"
+#include "pmbus_utils.hpp"
+#include "sensors.hpp"
+
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+using namespace phosphor::power::regulators;
+using namespace phosphor::power::regulators::pmbus_utils;
+
+using ::testing::A;
+using ::testing::DoAll;
+using ::testing::NotNull;
+using ::testing::Return;
+using ::testing::SetArgReferee;
+using ::testing::SetArrayArgument;
+using ::testing::Throw;
+using ::testing::TypedEq;
+
+using Sensor = PMBusReadBlockSensorsAction::Sensor;
+
+TEST(PMBusReadBlockSensorsActionTests, Constructor)
+{
+    // Test where works
+    try
+    {
+        std::vector<Sensor> sensors{
+            {SensorType::vout, 0, SensorDataFormat::linear_16},
+            {SensorType::temperature, 31, std::nullopt, 1, 0.5}};
+        PMBusReadBlockSensorsAction action{0xD8, sensors, -8};
+        EXPECT_EQ(action.getCommand(), 0xD8);
+        ASSERT_EQ(action.getSensors().size(), 2);
+        EXPECT_EQ(action.getSensors()[0].type, SensorType::vout);
+        EXPECT_EQ(action.getSensors()[0].offset, 0);
+        EXPECT_EQ(action.getSensors()[0].format, SensorDataFormat::linear_16);
+        EXPECT_EQ(action.getSensors()[1].type, SensorType::temperature);
+        EXPECT_EQ(action.getSensors()[1].offset, 31);
+        EXPECT_FALSE(action.getSensors()[1].format.has_value());
+        EXPECT_EQ(action.getSensors()[1].size, 1);
+        EXPECT_EQ(action.getSensors()[1].scale, 0.5);
+        EXPECT_EQ(action.getExponent().value(), -8);
+    }
+    catch (...)
+    {
+        ADD_FAILURE() << "Should not have caught exception.";
+    }
+
+    // Test where fails: Sensor extends past the end of the block
+    try
+    {
+        std::vector<Sensor> sensors{
+            {SensorType::iout, 31, SensorDataFormat::linear_11}};
+        PMBusReadBlockSensorsAction action{0xD8, sensors, std::nullopt};
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Invalid sensor offset: 31");
+    }
+    catch (...)
+    {
+        ADD_FAILURE() << "Should not have caught exception.";
+    }
+
+    // Test where fails: Linear sensor is not two bytes
+    try
+    {
+        std::vector<Sensor> sensors{
+            {SensorType::iout, 0, SensorDataFormat::linear_11, 1}};
+        PMBusReadBlockSensorsAction action{0xD8, sensors, std::nullopt};
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Invalid sensor size: 1");
+    }
+    catch (...)
+    {
+        ADD_FAILURE() << "Should not have caught exception.";
+    }
+
+    // Test where fails: Raw sensor size is invalid
+    try
+    {
+        std::vector<Sensor> sensors{
+            {SensorType::pout, 0, std::nullopt, 3, 1.0}};
+        PMBusReadBlockSensorsAction action{0xD8, sensors, std::nullopt};
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Invalid sensor size: 3");
+    }
+    catch (...)
+    {
+        ADD_FAILURE() << "Should not have caught exception.";
+    }
+}
+
+TEST(PMBusReadBlockSensorsActionTests, Execute)
+{
+    // Test where works: linear_11, linear_16, and raw formats
+    try
+    {
+        // Block data returned by the device:
+        // * offset 0: READ_VOUT 0x0330 = 816 * 2^(-8) = 3.1875
+        // * offset 2: READ_IOUT 0xD2E0 = 736 * 2^(-6) = 11.5
+        // * offset 4: temperature 0x2A = 42
+        // * offset 5: power 0x0190 = 400 * 0.25 = 100
+        uint8_t values[] = {0x30, 0x03, 0xE0, 0xD2, 0x2A, 0x90, 0x01};
+        uint8_t size{sizeof(values)};
+
+        // Create mock I2CInterface.  Expect action to do the following:
+        // * will read the block command once
+        // * will read 0b0001'1000 (linear format, -8 exponent) from VOUT_MODE
+        //   (command/register 0x20) once
+        std::unique_ptr<i2c::MockedI2CInterface> i2cInterface =
+            std::make_unique<i2c::MockedI2CInterface>();
+        EXPECT_CALL(*i2cInterface, isOpen).Times(1).WillOnce(Return(true));
+        EXPECT_CALL(*i2cInterface, read(0xD8, A<uint8_t&>(), NotNull(),
+                                        i2c::I2CInterface::Mode::SMBUS))
+            .Times(1)
+            .WillOnce(DoAll(SetArgReferee<1>(size),
+                            SetArrayArgument<2>(values, values + size)));
+        EXPECT_CALL(*i2cInterface, read(TypedEq<uint8_t>(0x20), A<uint8_t&>()))
+            .Times(1)
+            .WillOnce(SetArgReferee<1>(0b0001'1000));
+
+        // Create MockServices.  Expect the sensor values to be set.
+        MockServices services{};
+        MockSensors& sensors = services.getMockSensors();
+        EXPECT_CALL(sensors, setValue(SensorType::vout, 3.1875)).Times(1);
+        EXPECT_CALL(sensors, setValue(SensorType::vout_peak, 3.1875)).Times(1);
+        EXPECT_CALL(sensors, setValue(SensorType::iout, 11.5)).Times(1);
+        EXPECT_CALL(sensors, setValue(SensorType::temperature, 42)).Times(1);
+        EXPECT_CALL(sensors, setValue(SensorType::pout, 100)).Times(1);
+
+        // Create Device, IDMap, and ActionEnvironment
+        Device device{
+            "reg1", true,
+            "/xyz/openbmc_project/inventory/system/chassis/motherboard/reg1",
+            std::move(i2cInterface)};
+        IDMap idMap{};
+        idMap.addDevice(device);
+        ActionEnvironment env{idMap, "reg1", services};
+
+        // Create and execute action
+        std::vector<Sensor> sensorsToRead{
+            {SensorType::vout, 0, SensorDataFormat::linear_16},
+            {SensorType::vout_peak, 0, SensorDataFormat::linear_16},
+            {SensorType::iout, 2, SensorDataFormat::linear_11},
+            {SensorType::temperature, 4, std::nullopt, 1, 1.0},
+            {SensorType::pout, 5, std::nullopt, 2, 0.25}};
+        PMBusReadBlockSensorsAction action{0xD8, sensorsToRead, std::nullopt};
+        EXPECT_EQ(action.execute(env), true);
+        EXPECT_EQ(env.getSensorValues().size(), 5);
+        EXPECT_EQ(env.getSensorValues().at(SensorType::vout), 3.1875);
+        EXPECT_EQ(env.getSensorValues().at(SensorType::iout), 11.5);
+        EXPECT_EQ(env.getSensorValues().at(SensorType::temperature), 42);
+        EXPECT_EQ(env.getSensorValues().at(SensorType::pout), 100);
+    }
+    catch (...)
+    {
+        ADD_FAILURE() << "Should not have caught exception.";
+    }
+
+    // Test where fails: Unable to get I2C interface to current device
+    try
+    {
+        // Create IDMap, MockServices, and ActionEnvironment
+        IDMap idMap{};
+        MockServices services{};
+        ActionEnvironment env{idMap, "reg1", services};
+
+        // Create and execute action
+        std::vector<Sensor> sensorsToRead{
+            {SensorType::iout, 0, SensorDataFormat::linear_11}};
+        PMBusReadBlockSensorsAction action{0xD8, sensorsToRead, std::nullopt};
+        action.execute(env);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Unable to find device with ID \"reg1\"");
+    }
+    catch (...)
+    {
+        ADD_FAILURE() << "Should not have caught exception.";
+    }
+
+    // Test where fails: Block read fails
+    try
+    {
+        // Create mock I2CInterface.  Expect the block read to fail.
+        std::unique_ptr<i2c::MockedI2CInterface> i2cInterface =
+            std::make_unique<i2c::MockedI2CInterface>();
+        EXPECT_CALL(*i2cInterface, isOpen).Times(1).WillOnce(Return(true));
+        EXPECT_CALL(*i2cInterface, read(0xD8, A<uint8_t&>(), NotNull(),
+                                        i2c::I2CInterface::Mode::SMBUS))
+            .Times(1)
+            .WillOnce(Throw(i2c::I2CException{"Failed to read block data",
+                                              "/dev/i2c-1", 0x70}));
+
+        // Create Device, IDMap, MockServices, and ActionEnvironment
+        Device device{
+            "reg1", true,
+            "/xyz/openbmc_project/inventory/system/chassis/motherboard/reg1",
+            std::move(i2cInterface)};
+        IDMap idMap{};
+        idMap.addDevice(device);
+        MockServices services{};
+        ActionEnvironment env{idMap, "reg1", services};
+
+        // Create and execute action
+        std::vector<Sensor> sensorsToRead{
+            {SensorType::iout, 2, SensorDataFormat::linear_11}};
+        PMBusReadBlockSensorsAction action{0xD8, sensorsToRead, std::nullopt};
+        action.execute(env);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const ActionError& e)
+    {
+        EXPECT_STREQ(e.what(),
+                     "ActionError: pmbus_read_block_sensors: { command: 0xD8, "
+                     "sensors: [ { type: iout, offset: 2, format: linear_11 "
+                     "} ] }");
+        try
+        {
+            // Re-throw inner I2CException
+            std::rethrow_if_nested(e);
+            ADD_FAILURE() << "Should not have reached this line.";
+        }
+        catch (const i2c::I2CException& ie)
+        {
+            EXPECT_STREQ(ie.what(), "I2CException: Failed to read block data: "
+                                    "bus /dev/i2c-1, addr 0x70");
+        }
+        catch (...)
+        {
+            ADD_FAILURE() << "Should not have caught exception.";
+        }
+    }
+    catch (...)
+    {
+        ADD_FAILURE() << "Should not have caught exception.";
+    }
+
+    // Test where fails: Device returns too few bytes
+    try
+    {
+        // Create mock I2CInterface.  Expect action to read 3 bytes.
+        uint8_t values[] = {0x30, 0x03, 0xE0};
+        uint8_t size{sizeof(values)};
+        std::unique_ptr<i2c::MockedI2CInterface> i2cInterface =
+            std::make_unique<i2c::MockedI2CInterface>();
+        EXPECT_CALL(*i2cInterface, isOpen).Times(1).WillOnce(Return(true));
+        EXPECT_CALL(*i2cInterface, read(0xD8, A<uint8_t&>(), NotNull(),
+                                        i2c::I2CInterface::Mode::SMBUS))
+            .Times(1)
+            .WillOnce(DoAll(SetArgReferee<1>(size),
+                            SetArrayArgument<2>(values, values + size)));
+
+        // Create MockServices.  Expect no sensor value to be set for iout.
+        MockServices services{};
+        MockSensors& sensors = services.getMockSensors();
+        EXPECT_CALL(sensors, setValue(SensorType::vout, 3.1875)).Times(1);
+        EXPECT_CALL(sensors, setValue(SensorType::iout, A<double>())).Times(0);
+
+        // Create Device, IDMap, and ActionEnvironment
+        Device device{
+            "reg1", true,
+            "/xyz/openbmc_project/inventory/system/chassis/motherboard/reg1",
+            std::move(i2cInterface)};
+        IDMap idMap{};
+        idMap.addDevice(device);
+        ActionEnvironment env{idMap, "reg1", services};
+
+        // Create and execute action
+        std::vector<Sensor> sensorsToRead{
+            {SensorType::vout, 0, SensorDataFormat::linear_16},
+            {SensorType::iout, 2, SensorDataFormat::linear_11}};
+        PMBusReadBlockSensorsAction action{0xD8, sensorsToRead, -8};
+        action.execute(env);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const ActionError& e)
+    {
+        try
+        {
+            // Re-throw inner PMBusError
+            std::rethrow_if_nested(e);
+            ADD_FAILURE() << "Should not have reached this line.";
+        }
+        catch (const PMBusError& pe)
+        {
+            EXPECT_STREQ(pe.what(),
+                         "PMBusError: Block command returned 3 bytes");
+            EXPECT_EQ(pe.getDeviceID(), "reg1");
+            EXPECT_EQ(
+                pe.getInventoryPath(),
+                "/xyz/openbmc_project/inventory/system/chassis/motherboard/"
+                "reg1");
+        }
+        catch (...)
+        {
+            ADD_FAILURE() << "Should not have caught exception.";
+        }
+    }
+    catch (...)
+    {
+        ADD_FAILURE() << "Should not have caught exception.";
+    }
+}
+
+TEST(PMBusReadBlockSensorsActionTests, GetCommand)
+{
+    std::vector<Sensor> sensors{
+        {SensorType::iout, 0, SensorDataFormat::linear_11}};
+    PMBusReadBlockSensorsAction action{0xE3, sensors, std::nullopt};
+    EXPECT_EQ(action.getCommand(), 0xE3);
+}
+
+TEST(PMBusReadBlockSensorsActionTests, GetExponent)
+{
+    std::vector<Sensor> sensors{
+        {SensorType::vout, 0, SensorDataFormat::linear_16}};
+
+    // Exponent specified
+    {
+        PMBusReadBlockSensorsAction action{0xD8, sensors, -9};
+        EXPECT_EQ(action.getExponent().value(), -9);
+    }
+
+    // Exponent not specified
+    {
+        PMBusReadBlockSensorsAction action{0xD8, sensors, std::nullopt};
+        EXPECT_FALSE(action.getExponent().has_value());
+    }
+}
+
+TEST(PMBusReadBlockSensorsActionTests, GetSensors)
+{
+    std::vector<Sensor> sensors{
+        {SensorType::pout, 6, std::nullopt, 2, 0.125}};
+    PMBusReadBlockSensorsAction action{0xD8, sensors, std::nullopt};
+    ASSERT_EQ(action.getSensors().size(), 1);
+    EXPECT_EQ(action.getSensors()[0].type, SensorType::pout);
+    EXPECT_EQ(action.getSensors()[0].offset, 6);
+    EXPECT_FALSE(action.getSensors()[0].format.has_value());
+    EXPECT_EQ(action.getSensors()[0].size, 2);
+    EXPECT_EQ(action.getSensors()[0].scale, 0.125);
+}
+
+TEST(PMBusReadBlockSensorsActionTests, ToString)
+{
+    std::vector<Sensor> sensors{
+        {SensorType::vout, 0, SensorDataFormat::linear_16},
+        {SensorType::temperature, 4, std::nullopt, 1, 0.5}};
+    PMBusReadBlockSensorsAction action{0xD8, sensors, -8};
+    EXPECT_EQ(action.toString(),
+              "pmbus_read_block_sensors: { command: 0xD8, exponent: -8, "
+              "sensors: [ { type: vout, offset: 0, format: linear_16 }, { "
+              "type: temperature, offset: 4, format: raw, size: 1, scale: "
+              "0.5 } ] }");
+}
@@ -26,6 +26,7 @@
 #include "sensors.hpp"
 #include "test_sdbus_error.hpp"
 
+#include <chrono>
 #include <cstdint>
 #include <exception>
 #include <memory>
@@ -73,6 +74,22 @@ TEST(PMBusReadSensorActionTests, Constructor)
         EXPECT_EQ(action.getCommand(), 0x8C);
         EXPECT_EQ(action.getFormat(), SensorDataFormat::linear_11);
         EXPECT_EQ(action.getExponent().has_value(), false);
+        EXPECT_EQ(action.getAggregation().has_value(), false);
+    }
+
+    // Test where works: aggregation is specified
+    {
+        SensorType type{SensorType::vout};
+        uint8_t command{0x8B};
+        SensorDataFormat format{SensorDataFormat::linear_16};
+        std::optional<int8_t> exponent{-8};
+        SensorAggregation aggregation{std::chrono::milliseconds{1000},
+                                      SensorStatistic::peak_to_peak};
+        PMBusReadSensorAction action{type, command, format, exponent,
+                                     aggregation};
+        EXPECT_EQ(action.getType(), SensorType::vout);
+        EXPECT_EQ(action.getAggregation().has_value(), true);
+        EXPECT_EQ(action.getAggregation().value(), aggregation);
     }
 }
 
@@ -118,7 +135,60 @@ TEST(PMBusReadSensorActionTests, Execute)
         SensorDataFormat format{SensorDataFormat::linear_11};
         std::optional<int8_t> exponent{};
         PMBusReadSensorAction action{type, command, format, exponent};
+        auto startTime = std::chrono::steady_clock::now();
+        EXPECT_EQ(action.execute(env), true);
+        EXPECT_EQ(env.getSensorValues().size(), 1);
+        EXPECT_EQ(env.getSensorValues().at(SensorType::iout), 11.5);
+
+        // The value is published with the time it was read
+        EXPECT_GE(sensors.lastReadTime, startTime);
+        EXPECT_LE(sensors.lastReadTime, std::chrono::steady_clock::now());
+    }
+    catch (...)
+    {
+        ADD_FAILURE() << "Should not have caught exception.";
+    }
+
+    // Test where works: aggregation specified
+    try
+    {
+        // Create mock I2CInterface.  Expect action to read 0xD2E0 (11.5) from
+        // READ_IOUT.
+        std::unique_ptr<i2c::MockedI2CInterface> i2cInterface =
+            std::make_unique<i2c::MockedI2CInterface>();
+        EXPECT_CALL(*i2cInterface, isOpen).Times(1).WillOnce(Return(true));
+        EXPECT_CALL(*i2cInterface, read(TypedEq<uint8_t>(0x8C), A<uint16_t&>()))
+            .Times(1)
+            .WillOnce(SetArgReferee<1>(0xD2E0));
+
+        // Create MockServices.  Expect the sensor value to be aggregated.
+        SensorAggregation aggregation{std::chrono::milliseconds{500},
+                                      SensorStatistic::maximum};
+        MockServices services{};
+        MockSensors& sensors = services.getMockSensors();
+        EXPECT_CALL(sensors,
+                    setAggregatedValue(SensorType::iout, 11.5, aggregation))
+            .Times(1);
+        EXPECT_CALL(sensors, setValue).Times(0);
+
+        // Create Device, IDMap, and ActionEnvironment
+        Device device{
+            "reg1", true,
+            "/xyz/openbmc_project/inventory/system/chassis/motherboard/reg1",
+            std::move(i2cInterface)};
+        IDMap idMap{};
+        idMap.addDevice(device);
+        ActionEnvironment env{idMap, "reg1", services};
+
+        // Create and execute action
+        SensorType type{SensorType::iout};
+        uint8_t command{0x8C};
+        SensorDataFormat format{SensorDataFormat::linear_11};
+        std::optional<int8_t> exponent{};
+        PMBusReadSensorAction action{type, command, format, exponent,
+                                     aggregation};
         EXPECT_EQ(action.execute(env), true);
+        EXPECT_EQ(env.getSensorValues().at(SensorType::iout), 11.5);
     }
     catch (...)
     {
@@ -501,6 +571,31 @@ TEST(PMBusReadSensorActionTests, Execute)
     }
 }
 
+TEST(PMBusReadSensorActionTests, GetAggregation)
+{
+    SensorType type{SensorType::vout};
+    uint8_t command{0x8B};
+    SensorDataFormat format{SensorDataFormat::linear_16};
+    std::optional<int8_t> exponent{};
+
+    // Aggregation is specified
+    {
+        SensorAggregation aggregation{std::chrono::milliseconds{2000},
+                                      SensorStatistic::mean};
+        PMBusReadSensorAction action{type, command, format, exponent,
+                                     aggregation};
+        EXPECT_EQ(action.getAggregation().has_value(), true);
+        EXPECT_EQ(action.getAggregation()->window.count(), 2000);
+        EXPECT_EQ(action.getAggregation()->statistic, SensorStatistic::mean);
+    }
+
+    // Aggregation is not specified
+    {
+        PMBusReadSensorAction action{type, command, format, exponent};
+        EXPECT_EQ(action.getAggregation().has_value(), false);
+    }
+}
+
 TEST(PMBusReadSensorActionTests, GetCommand)
 {
     SensorType type{SensorType::iout};
@@ -577,4 +672,20 @@ TEST(PMBusReadSensorActionTests, ToString)
         EXPECT_EQ(action.toString(), "pmbus_read_sensor: { type: iout_valley, "
                                      "command: 0xCB, format: linear_11 }");
     }
+
+    // Test where aggregation is specified
+    {
+        SensorType type{SensorType::vout};
+        uint8_t command{0x8B};
+        SensorDataFormat format{SensorDataFormat::linear_16};
+        std::optional<int8_t> exponent{-8};
+        SensorAggregation aggregation{std::chrono::milliseconds{1000},
+                                      SensorStatistic::peak_to_peak};
+        PMBusReadSensorAction action{type, command, format, exponent,
+                                     aggregation};
+        EXPECT_EQ(action.toString(),
+                  "pmbus_read_sensor: { type: vout, command: 0x8B, format: "
+                  "linear_16, exponent: -8, aggregation: { window_ms: 1000, "
+                  "statistic: peak_to_peak } }");
+    }
 }
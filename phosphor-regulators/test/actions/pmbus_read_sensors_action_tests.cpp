@@ -0,0 +1,455 @@
+/**
+ * Copyright © 2020 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "action_environment.hpp"
+#include "action_error.hpp"
+#include "device.hpp"
+#include "i2c_interface.hpp"
+#include "id_map.hpp"
+#include "mock_services.hpp"
+#include "mocked_i2c_interface.hpp"
+#include "pmbus_error.hpp"
+#include "pmbus_read_sensors_action.hpp"
+#include "pmbus_utils.hpp"
+#include "sensors.hpp"
+
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+using namespace phosphor::power::regulators;
+using namespace phosphor::power::regulators::pmbus_utils;
+
+using ::testing::A;
+using ::testing::Invoke;
+using ::testing::Return;
+using ::testing::SetArgReferee;
+using ::testing::Throw;
+using ::testing::TypedEq;
+
+using Operation = i2c::I2CInterface::Operation;
+using Sensor = PMBusReadSensorsAction::Sensor;
+
+namespace
+{
+
+/**
+ * Returns a function that verifies the operations of an I2C transfer and
+ * stores the specified words in the read operations.
+ *
+ * @param page PAGE value expected in the first operation, if any
+ * @param commands commands expected in the read operations
+ * @param words words to return for the read operations
+ */
+auto transferOperations(std::optional<uint8_t> page,
+                        std::vector<uint8_t> commands,
+                        std::vector<uint16_t> words)
+{
+    return [page, commands, words](std::vector<Operation>& operations) {
+        std::size_t first = page.has_value() ? 1 : 0;
+        ASSERT_EQ(operations.size(), first + commands.size());
+        if (page.has_value())
+        {
+            EXPECT_FALSE(operations[0].isRead);
+            EXPECT_EQ(operations[0].addr, PAGE);
+            ASSERT_EQ(operations[0].size, 1);
+            EXPECT_EQ(operations[0].data[0], page.value());
+        }
+        for (std::size_t i = 0; i < commands.size(); ++i)
+        {
+            Operation& operation = operations[first + i];
+            EXPECT_TRUE(operation.isRead);
+            EXPECT_EQ(operation.addr, commands[i]);
+            ASSERT_EQ(operation.size, 2);
+            operation.data[0] = static_cast<uint8_t>(words[i] & 0xFF);
+            operation.data[1] = static_cast<uint8_t>(words[i] >> 8);
+        }
+    };
+}
+
+} // namespace
+
+TEST(PMBusReadSensorsActionTests, Constructor)
+{
+    std::vector<Sensor> sensors{
+        {SensorType::vout, 0x8B, SensorDataFormat::linear_16},
+        {SensorType::iout, 0x8C, SensorDataFormat::linear_11}};
+    PMBusReadSensorsAction action{sensors, 0x01, -8};
+    ASSERT_EQ(action.getSensors().size(), 2);
+    EXPECT_EQ(action.getSensors()[0].type, SensorType::vout);
+    EXPECT_EQ(action.getSensors()[0].command, 0x8B);
+    EXPECT_EQ(action.getSensors()[0].format, SensorDataFormat::linear_16);
+    EXPECT_EQ(action.getSensors()[1].type, SensorType::iout);
+    EXPECT_EQ(action.getSensors()[1].command, 0x8C);
+    EXPECT_EQ(action.getSensors()[1].format, SensorDataFormat::linear_11);
+    EXPECT_EQ(action.getPage().value(), 0x01);
+    EXPECT_EQ(action.getExponent().value(), -8);
+}
+
+TEST(PMBusReadSensorsActionTests, Execute)
+{
+    // Test where works: page specified; VOUT_MODE read once
+    try
+    {
+        // Create mock I2CInterface.  Expect action to do the following:
+        // * will write 0x01 to PAGE and read READ_VOUT, READ_IOUT, and
+        //   READ_VOUT_PEAK (commands 0x8B, 0x8C, 0xC6) in one transfer
+        // * will read 0b0001'1000 (linear format, -8 exponent) from VOUT_MODE
+        //   (command/register 0x20) once
+        std::unique_ptr<i2c::MockedI2CInterface> i2cInterface =
+            std::make_unique<i2c::MockedI2CInterface>();
+        EXPECT_CALL(*i2cInterface, isOpen).Times(1).WillOnce(Return(true));
+        EXPECT_CALL(*i2cInterface, transfer)
+            .Times(1)
+            .WillOnce(Invoke(transferOperations(
+                0x01, {0x8B, 0x8C, 0xC6}, {0x0330, 0xD2E0, 0x0340})));
+        EXPECT_CALL(*i2cInterface, read(TypedEq<uint8_t>(0x20), A<uint8_t&>()))
+            .Times(1)
+            .WillOnce(SetArgReferee<1>(0b0001'1000));
+
+        // Create MockServices.  Expect the sensor values to be set.
+        MockServices services{};
+        MockSensors& sensors = services.getMockSensors();
+        EXPECT_CALL(sensors, setValue(SensorType::vout, 3.1875)).Times(1);
+        EXPECT_CALL(sensors, setValue(SensorType::iout, 11.5)).Times(1);
+        EXPECT_CALL(sensors, setValue(SensorType::vout_peak, 3.25)).Times(1);
+
+        // Create Device, IDMap, and ActionEnvironment
+        Device device{
+            "reg1", true,
+            "/xyz/openbmc_project/inventory/system/chassis/motherboard/reg1",
+            std::move(i2cInterface)};
+        IDMap idMap{};
+        idMap.addDevice(device);
+        ActionEnvironment env{idMap, "reg1", services};
+
+        // Create and execute action
+        std::vector<Sensor> sensorsToRead{
+            {SensorType::vout, 0x8B, SensorDataFormat::linear_16},
+            {SensorType::iout, 0x8C, SensorDataFormat::linear_11},
+            {SensorType::vout_peak, 0xC6, SensorDataFormat::linear_16}};
+        PMBusReadSensorsAction action{sensorsToRead, 0x01, std::nullopt};
+        EXPECT_EQ(action.execute(env), true);
+        EXPECT_EQ(env.getSensorValues().size(), 3);
+        EXPECT_EQ(env.getSensorValues().at(SensorType::vout), 3.1875);
+        EXPECT_EQ(env.getSensorValues().at(SensorType::iout), 11.5);
+        EXPECT_EQ(env.getSensorValues().at(SensorType::vout_peak), 3.25);
+        EXPECT_EQ(device.getCurrentPage().value(), 0x01);
+    }
+    catch (...)
+    {
+        ADD_FAILURE() << "Should not have caught exception.";
+    }
+
+    // Test where works: page already selected; command read once
+    try
+    {
+        // Create mock I2CInterface.  Expect action to read READ_IOUT once and
+        // not write PAGE.
+        std::unique_ptr<i2c::MockedI2CInterface> i2cInterface =
+            std::make_unique<i2c::MockedI2CInterface>();
+        EXPECT_CALL(*i2cInterface, isOpen).Times(1).WillOnce(Return(true));
+        EXPECT_CALL(*i2cInterface, transfer)
+            .Times(1)
+            .WillOnce(
+                Invoke(transferOperations(std::nullopt, {0x8C}, {0xD2E0})));
+
+        // Create MockServices.  Expect the sensor values to be set.
+        MockServices services{};
+        MockSensors& sensors = services.getMockSensors();
+        EXPECT_CALL(sensors, setValue(SensorType::iout, 11.5)).Times(1);
+        EXPECT_CALL(sensors, setValue(SensorType::iout_peak, 11.5)).Times(1);
+
+        // Create Device, IDMap, and ActionEnvironment
+        Device device{
+            "reg1", true,
+            "/xyz/openbmc_project/inventory/system/chassis/motherboard/reg1",
+            std::move(i2cInterface)};
+        device.pageSelected(0x02);
+        IDMap idMap{};
+        idMap.addDevice(device);
+        ActionEnvironment env{idMap, "reg1", services};
+
+        // Create and execute action
+        std::vector<Sensor> sensorsToRead{
+            {SensorType::iout, 0x8C, SensorDataFormat::linear_11},
+            {SensorType::iout_peak, 0x8C, SensorDataFormat::linear_11}};
+        PMBusReadSensorsAction action{sensorsToRead, 0x02, std::nullopt};
+        EXPECT_EQ(action.execute(env), true);
+        EXPECT_EQ(device.getCurrentPage().value(), 0x02);
+    }
+    catch (...)
+    {
+        ADD_FAILURE() << "Should not have caught exception.";
+    }
+
+    // Test where works: page not specified; exponent specified
+    try
+    {
+        // Create mock I2CInterface.  Expect action to read READ_VOUT and not
+        // read VOUT_MODE.
+        std::unique_ptr<i2c::MockedI2CInterface> i2cInterface =
+            std::make_unique<i2c::MockedI2CInterface>();
+        EXPECT_CALL(*i2cInterface, isOpen).Times(1).WillOnce(Return(true));
+        EXPECT_CALL(*i2cInterface, transfer)
+            .Times(1)
+            .WillOnce(
+                Invoke(transferOperations(std::nullopt, {0x8B}, {0x0330})));
+        EXPECT_CALL(*i2cInterface, read(A<uint8_t>(), A<uint8_t&>())).Times(0);
+
+        // Create MockServices.  Expect the sensor value to be set.
+        MockServices services{};
+        MockSensors& sensors = services.getMockSensors();
+        EXPECT_CALL(sensors, setValue(SensorType::vout, 3.1875)).Times(1);
+
+        // Create Device, IDMap, and ActionEnvironment
+        Device device{
+            "reg1", true,
+            "/xyz/openbmc_project/inventory/system/chassis/motherboard/reg1",
+            std::move(i2cInterface)};
+        IDMap idMap{};
+        idMap.addDevice(device);
+        ActionEnvironment env{idMap, "reg1", services};
+
+        // Create and execute action
+        std::vector<Sensor> sensorsToRead{
+            {SensorType::vout, 0x8B, SensorDataFormat::linear_16}};
+        PMBusReadSensorsAction action{sensorsToRead, std::nullopt, -8};
+        EXPECT_EQ(action.execute(env), true);
+        EXPECT_FALSE(device.getCurrentPage().has_value());
+    }
+    catch (...)
+    {
+        ADD_FAILURE() << "Should not have caught exception.";
+    }
+
+    // Test where fails: Unable to get I2C interface to current device
+    try
+    {
+        // Create IDMap, MockServices, and ActionEnvironment
+        IDMap idMap{};
+        MockServices services{};
+        ActionEnvironment env{idMap, "reg1", services};
+
+        // Create and execute action
+        std::vector<Sensor> sensorsToRead{
+            {SensorType::pout, 0x96, SensorDataFormat::linear_11}};
+        PMBusReadSensorsAction action{sensorsToRead, 0x00, std::nullopt};
+        action.execute(env);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Unable to find device with ID \"reg1\"");
+    }
+    catch (...)
+    {
+        ADD_FAILURE() << "Should not have caught exception.";
+    }
+
+    // Test where fails: I2C transfer fails; page is unknown
+    try
+    {
+        // Create mock I2CInterface.  Expect the transfer to fail.
+        std::unique_ptr<i2c::MockedI2CInterface> i2cInterface =
+            std::make_unique<i2c::MockedI2CInterface>();
+        EXPECT_CALL(*i2cInterface, isOpen).Times(1).WillOnce(Return(true));
+        EXPECT_CALL(*i2cInterface, transfer)
+            .Times(1)
+            .WillOnce(Throw(
+                i2c::I2CException{"Failed to transfer", "/dev/i2c-1", 0x70}));
+
+        // Create MockServices.  Expect no sensor values to be set.
+        MockServices services{};
+        MockSensors& sensors = services.getMockSensors();
+        EXPECT_CALL(sensors, setValue).Times(0);
+
+        // Create Device, IDMap, and ActionEnvironment
+        Device device{
+            "reg1", true,
+            "/xyz/openbmc_project/inventory/system/chassis/motherboard/reg1",
+            std::move(i2cInterface)};
+        device.pageSelected(0x00);
+        IDMap idMap{};
+        idMap.addDevice(device);
+        ActionEnvironment env{idMap, "reg1", services};
+
+        // Create and execute action
+        std::vector<Sensor> sensorsToRead{
+            {SensorType::temperature, 0x8D, SensorDataFormat::linear_11}};
+        PMBusReadSensorsAction action{sensorsToRead, 0x01, std::nullopt};
+        try
+        {
+            action.execute(env);
+            ADD_FAILURE() << "Should not have reached this line.";
+        }
+        catch (const ActionError& e)
+        {
+            EXPECT_STREQ(e.what(),
+                         "ActionError: pmbus_read_sensors: { page: 0x1, "
+                         "sensors: [ { type: temperature, command: 0x8D, "
+                         "format: linear_11 } ] }");
+            try
+            {
+                // Re-throw inner I2CException
+                std::rethrow_if_nested(e);
+                ADD_FAILURE() << "Should not have reached this line.";
+            }
+            catch (const i2c::I2CException& ie)
+            {
+                EXPECT_STREQ(ie.what(), "I2CException: Failed to transfer: "
+                                        "bus /dev/i2c-1, addr 0x70");
+            }
+            catch (...)
+            {
+                ADD_FAILURE() << "Should not have caught exception.";
+            }
+        }
+        EXPECT_FALSE(device.getCurrentPage().has_value());
+    }
+    catch (...)
+    {
+        ADD_FAILURE() << "Should not have caught exception.";
+    }
+
+    // Test where fails: VOUT_MODE data format is not linear
+    try
+    {
+        // Create mock I2CInterface.  Expect action to read READ_VOUT and then
+        // read 0b0010'0000 (vid data format) from VOUT_MODE.
+        std::unique_ptr<i2c::MockedI2CInterface> i2cInterface =
+            std::make_unique<i2c::MockedI2CInterface>();
+        EXPECT_CALL(*i2cInterface, isOpen).Times(1).WillOnce(Return(true));
+        EXPECT_CALL(*i2cInterface, transfer)
+            .Times(1)
+            .WillOnce(
+                Invoke(transferOperations(std::nullopt, {0x8B}, {0x0330})));
+        EXPECT_CALL(*i2cInterface, read(TypedEq<uint8_t>(0x20), A<uint8_t&>()))
+            .Times(1)
+            .WillOnce(SetArgReferee<1>(0b0010'0000));
+
+        // Create Device, IDMap, MockServices, and ActionEnvironment
+        Device device{
+            "reg1", true,
+            "/xyz/openbmc_project/inventory/system/chassis/motherboard/reg1",
+            std::move(i2cInterface)};
+        IDMap idMap{};
+        idMap.addDevice(device);
+        MockServices services{};
+        ActionEnvironment env{idMap, "reg1", services};
+
+        // Create and execute action
+        std::vector<Sensor> sensorsToRead{
+            {SensorType::vout, 0x8B, SensorDataFormat::linear_16}};
+        PMBusReadSensorsAction action{sensorsToRead, std::nullopt,
+                                      std::nullopt};
+        action.execute(env);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const ActionError& e)
+    {
+        EXPECT_STREQ(e.what(),
+                     "ActionError: pmbus_read_sensors: { sensors: [ { type: "
+                     "vout, command: 0x8B, format: linear_16 } ] }");
+        try
+        {
+            // Re-throw inner PMBusError
+            std::rethrow_if_nested(e);
+            ADD_FAILURE() << "Should not have reached this line.";
+        }
+        catch (const PMBusError& pe)
+        {
+            EXPECT_STREQ(
+                pe.what(),
+                "PMBusError: VOUT_MODE contains unsupported data format");
+            EXPECT_EQ(pe.getDeviceID(), "reg1");
+        }
+        catch (...)
+        {
+            ADD_FAILURE() << "Should not have caught exception.";
+        }
+    }
+    catch (...)
+    {
+        ADD_FAILURE() << "Should not have caught exception.";
+    }
+}
+
+TEST(PMBusReadSensorsActionTests, GetExponent)
+{
+    std::vector<Sensor> sensors{
+        {SensorType::vout, 0x8B, SensorDataFormat::linear_16}};
+
+    // Exponent specified
+    {
+        PMBusReadSensorsAction action{sensors, std::nullopt, -9};
+        EXPECT_EQ(action.getExponent().value(), -9);
+    }
+
+    // Exponent not specified
+    {
+        PMBusReadSensorsAction action{sensors, std::nullopt, std::nullopt};
+        EXPECT_FALSE(action.getExponent().has_value());
+    }
+}
+
+TEST(PMBusReadSensorsActionTests, GetPage)
+{
+    std::vector<Sensor> sensors{
+        {SensorType::vout, 0x8B, SensorDataFormat::linear_16}};
+
+    // Page specified
+    {
+        PMBusReadSensorsAction action{sensors, 0x03, std::nullopt};
+        EXPECT_EQ(action.getPage().value(), 0x03);
+    }
+
+    // Page not specified
+    {
+        PMBusReadSensorsAction action{sensors, std::nullopt, std::nullopt};
+        EXPECT_FALSE(action.getPage().has_value());
+    }
+}
+
+TEST(PMBusReadSensorsActionTests, GetSensors)
+{
+    std::vector<Sensor> sensors{
+        {SensorType::pout, 0x96, SensorDataFormat::linear_11}};
+    PMBusReadSensorsAction action{sensors, std::nullopt, std::nullopt};
+    ASSERT_EQ(action.getSensors().size(), 1);
+    EXPECT_EQ(action.getSensors()[0].type, SensorType::pout);
+    EXPECT_EQ(action.getSensors()[0].command, 0x96);
+    EXPECT_EQ(action.getSensors()[0].format, SensorDataFormat::linear_11);
+}
+
+TEST(PMBusReadSensorsActionTests, ToString)
+{
+    std::vector<Sensor> sensors{
+        {SensorType::vout, 0x8B, SensorDataFormat::linear_16},
+        {SensorType::iout, 0x8C, SensorDataFormat::linear_11}};
+    PMBusReadSensorsAction action{sensors, 0x0A, -8};
+    EXPECT_EQ(action.toString(),
+              "pmbus_read_sensors: { page: 0xA, exponent: -8, sensors: [ { "
+              "type: vout, command: 0x8B, format: linear_16 }, { type: iout, "
+              "command: 0x8C, format: linear_11 } ] }");
+}
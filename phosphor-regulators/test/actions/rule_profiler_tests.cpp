@@ -0,0 +1,266 @@
+/**
+ * Copyright © 2019 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "action.hpp"
+#include "action_environment.hpp"
+#include "action_program.hpp"
+#include "action_utils.hpp"
+#include "device.hpp"
+#include "i2c_interface.hpp"
+#include "id_map.hpp"
+#include "mock_action.hpp"
+#include "mock_services.hpp"
+#include "mocked_i2c_interface.hpp"
+#include "rule.hpp"
+#include "rule_profiler.hpp"
+#include "run_rule_action.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+using namespace phosphor::power::regulators;
+
+using ::testing::Return;
+using ::testing::Throw;
+
+namespace
+{
+
+/**
+ * Creates a rule containing one mock action.  The action performs two I2C
+ * transactions each time it is executed.
+ *
+ * @param ruleID rule ID
+ * @param transactions I2C transaction count of the device
+ * @param times number of times the action is executed
+ * @return rule
+ */
+std::unique_ptr<Rule> createRule(const std::string& ruleID,
+                                 uint64_t& transactions, int times)
+{
+    std::unique_ptr<MockAction> action = std::make_unique<MockAction>();
+    EXPECT_CALL(*action, toString)
+        .WillRepeatedly(Return("mock_read: { register: 0x8C }"));
+    EXPECT_CALL(*action, execute)
+        .Times(times)
+        .WillRepeatedly([&transactions](ActionEnvironment&) {
+            transactions += 2;
+            return true;
+        });
+    std::vector<std::unique_ptr<Action>> actions{};
+    actions.emplace_back(std::move(action));
+    return std::make_unique<Rule>(ruleID, std::move(actions));
+}
+
+/**
+ * Creates a device whose mock I2C interface returns the specified
+ * transaction count.
+ *
+ * @param transactions I2C transaction count of the device
+ * @return device
+ */
+std::unique_ptr<Device> createDevice(uint64_t& transactions)
+{
+    std::unique_ptr<i2c::MockedI2CInterface> i2cInterface =
+        std::make_unique<i2c::MockedI2CInterface>();
+    EXPECT_CALL(*i2cInterface, getTransactionCount)
+        .WillRepeatedly([&transactions]() { return transactions; });
+    return std::make_unique<Device>(
+        "reg1", true,
+        "/xyz/openbmc_project/inventory/system/chassis/motherboard/reg1",
+        std::move(i2cInterface));
+}
+
+} // namespace
+
+TEST(RuleProfilerTests, ActionProgram)
+{
+    uint64_t transactions{0};
+    std::unique_ptr<Device> device = createDevice(transactions);
+    std::unique_ptr<Rule> rule = createRule("read_rule", transactions, 2);
+    IDMap idMap{};
+    idMap.addDevice(*device);
+    idMap.addRule(*rule);
+    MockServices services{};
+    ActionEnvironment env{idMap, "reg1", services};
+
+    std::vector<std::unique_ptr<Action>> actions{};
+    actions.emplace_back(std::make_unique<RunRuleAction>("read_rule"));
+    ActionProgram program{actions, idMap};
+
+    // Compiled instructions are executed while profiling is disabled
+    RuleProfiler& profiler = RuleProfiler::get();
+    EXPECT_TRUE(program.execute(env));
+    EXPECT_TRUE(profiler.getRuleStatistics().empty());
+
+    // Actions are interpreted and profiled while profiling is enabled
+    profiler.enable(true);
+    EXPECT_TRUE(program.execute(env));
+    EXPECT_EQ(profiler.getRuleStatistics().at("read_rule").calls, 1);
+    EXPECT_EQ(profiler.getRuleStatistics().at("read_rule").i2cTransactions,
+              2);
+    profiler.enable(false);
+}
+
+TEST(RuleProfilerTests, Enable)
+{
+    uint64_t transactions{0};
+    std::unique_ptr<Device> device = createDevice(transactions);
+    std::unique_ptr<Rule> rule = createRule("read_rule", transactions, 2);
+    IDMap idMap{};
+    idMap.addDevice(*device);
+    idMap.addRule(*rule);
+    MockServices services{};
+    ActionEnvironment env{idMap, "reg1", services};
+    RunRuleAction action{"read_rule"};
+
+    // Nothing is recorded while profiling is disabled
+    RuleProfiler& profiler = RuleProfiler::get();
+    EXPECT_FALSE(profiler.isEnabled());
+    action_utils::execute(action, env);
+    EXPECT_TRUE(profiler.getActionStatistics().empty());
+    EXPECT_TRUE(profiler.getRuleStatistics().empty());
+    EXPECT_EQ(profiler.getFoldedStacks(), "");
+
+    profiler.enable(true);
+    EXPECT_TRUE(profiler.isEnabled());
+    action_utils::execute(action, env);
+    EXPECT_EQ(profiler.getRuleStatistics().size(), 1);
+
+    // Statistics are discarded when disabled
+    profiler.enable(false);
+    EXPECT_FALSE(profiler.isEnabled());
+    EXPECT_TRUE(profiler.getActionStatistics().empty());
+    EXPECT_TRUE(profiler.getRuleStatistics().empty());
+    EXPECT_EQ(profiler.getFoldedStacks(), "");
+}
+
+TEST(RuleProfilerTests, Execute)
+{
+    uint64_t transactions{0};
+    std::unique_ptr<Device> device = createDevice(transactions);
+    std::unique_ptr<Rule> rule = createRule("read_rule", transactions, 3);
+    IDMap idMap{};
+    idMap.addDevice(*device);
+    idMap.addRule(*rule);
+    MockServices services{};
+    ActionEnvironment env{idMap, "reg1", services};
+
+    std::vector<std::unique_ptr<Action>> actions{};
+    actions.emplace_back(std::make_unique<RunRuleAction>("read_rule"));
+    actions.emplace_back(std::make_unique<RunRuleAction>("read_rule"));
+
+    RuleProfiler& profiler = RuleProfiler::get();
+    profiler.enable(true);
+    EXPECT_TRUE(action_utils::execute(actions, env));
+    EXPECT_TRUE(action_utils::execute(*actions[0], env));
+
+    // Rule statistics
+    auto rules = profiler.getRuleStatistics();
+    EXPECT_EQ(rules.size(), 1);
+    EXPECT_EQ(rules["read_rule"].calls, 3);
+    EXPECT_EQ(rules["read_rule"].i2cTransactions, 6);
+    EXPECT_GE(rules["read_rule"].totalTime, rules["read_rule"].selfTime);
+
+    // Action statistics.  The action type is the start of the description.
+    auto types = profiler.getActionStatistics();
+    EXPECT_EQ(types.size(), 2);
+    EXPECT_EQ(types["run_rule"].calls, 3);
+    EXPECT_EQ(types["run_rule"].i2cTransactions, 6);
+    EXPECT_EQ(types["mock_read"].calls, 3);
+    EXPECT_EQ(types["mock_read"].i2cTransactions, 6);
+
+    // Folded stacks contain one line per call stack
+    std::string folded = profiler.getFoldedStacks();
+    EXPECT_EQ(std::count(folded.begin(), folded.end(), '\n'), 3);
+    EXPECT_NE(folded.find("run_rule "), std::string::npos);
+    EXPECT_NE(folded.find("run_rule;rule:read_rule "), std::string::npos);
+    EXPECT_NE(folded.find("run_rule;rule:read_rule;mock_read "),
+              std::string::npos);
+
+    // Text contains one line per rule and action type
+    std::string text = profiler.toString();
+    EXPECT_NE(text.find("rule read_rule: calls: 3, total: "),
+              std::string::npos);
+    EXPECT_NE(text.find("action mock_read: calls: 3, total: "),
+              std::string::npos);
+    EXPECT_NE(text.find(" us, i2c: 6\n"), std::string::npos);
+    profiler.enable(false);
+}
+
+TEST(RuleProfilerTests, ExecuteException)
+{
+    // Create rule with action that throws an exception
+    std::unique_ptr<MockAction> action = std::make_unique<MockAction>();
+    EXPECT_CALL(*action, toString).WillRepeatedly(Return("mock_write: {}"));
+    EXPECT_CALL(*action, execute)
+        .Times(1)
+        .WillOnce(Throw(std::logic_error{"Communication error"}));
+    std::vector<std::unique_ptr<Action>> actions{};
+    actions.emplace_back(std::move(action));
+    Rule rule{"exception_rule", std::move(actions)};
+
+    // Device is not found; I2C transactions are not counted
+    IDMap idMap{};
+    idMap.addRule(rule);
+    MockServices services{};
+    ActionEnvironment env{idMap, "reg1", services};
+
+    RuleProfiler& profiler = RuleProfiler::get();
+    profiler.enable(true);
+    RunRuleAction runRuleAction{"exception_rule"};
+    EXPECT_THROW(action_utils::execute(runRuleAction, env), std::logic_error);
+
+    // Failed executions are recorded
+    EXPECT_EQ(profiler.getRuleStatistics().at("exception_rule").calls, 1);
+    EXPECT_EQ(profiler.getActionStatistics().at("mock_write").calls, 1);
+    EXPECT_EQ(
+        profiler.getActionStatistics().at("mock_write").i2cTransactions, 0);
+    profiler.enable(false);
+}
+
+TEST(RuleProfilerTests, Reset)
+{
+    uint64_t transactions{0};
+    std::unique_ptr<Device> device = createDevice(transactions);
+    std::unique_ptr<Rule> rule = createRule("read_rule", transactions, 1);
+    IDMap idMap{};
+    idMap.addDevice(*device);
+    idMap.addRule(*rule);
+    MockServices services{};
+    ActionEnvironment env{idMap, "reg1", services};
+    RunRuleAction action{"read_rule"};
+
+    RuleProfiler& profiler = RuleProfiler::get();
+    profiler.enable(true);
+    action_utils::execute(action, env);
+    EXPECT_FALSE(profiler.getRuleStatistics().empty());
+
+    // Profiling remains enabled after a reset
+    profiler.reset();
+    EXPECT_TRUE(profiler.isEnabled());
+    EXPECT_TRUE(profiler.getActionStatistics().empty());
+    EXPECT_TRUE(profiler.getRuleStatistics().empty());
+    EXPECT_EQ(profiler.getFoldedStacks(), "");
+    profiler.enable(false);
+}
@@ -194,6 +194,46 @@ TEST(RunRuleActionTests, GetRuleID)
     EXPECT_EQ(action.getRuleID(), "read_sensors_rule");
 }
 
+TEST(RunRuleActionTests, Link)
+{
+    // Create rule and add to IDMap
+    std::vector<std::unique_ptr<Action>> actions{};
+    std::unique_ptr<MockAction> action = std::make_unique<MockAction>();
+    EXPECT_CALL(*action, execute).Times(1).WillOnce(Return(true));
+    actions.push_back(std::move(action));
+    Rule rule("set_voltage_rule", std::move(actions));
+    IDMap idMap{};
+    idMap.addRule(rule);
+
+    // Create ActionEnvironment with an empty IDMap.  Rule can only be found if
+    // the action was linked.
+    IDMap emptyIDMap{};
+    MockServices services{};
+    ActionEnvironment env{emptyIDMap, "", services};
+
+    // Test where rule is found
+    {
+        RunRuleAction runRuleAction{"set_voltage_rule"};
+        runRuleAction.link(idMap);
+        EXPECT_EQ(runRuleAction.execute(env), true);
+        EXPECT_EQ(env.getRuleDepth(), 0);
+    }
+
+    // Test where rule is not found.  Error occurs when action executed.
+    try
+    {
+        RunRuleAction runRuleAction{"read_sensors_rule"};
+        runRuleAction.link(idMap);
+        runRuleAction.execute(env);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& ia_error)
+    {
+        EXPECT_STREQ(ia_error.what(),
+                     "Unable to find rule with ID \"read_sensors_rule\"");
+    }
+}
+
 TEST(RunRuleActionTests, ToString)
 {
     RunRuleAction action{"set_voltage_rule"};
@@ -23,6 +23,7 @@
 
 #include <exception>
 #include <memory>
+#include <stdexcept>
 #include <utility>
 
 #include <gtest/gtest.h>
@@ -86,6 +87,44 @@ TEST(SetDeviceActionTests, GetDeviceID)
     EXPECT_EQ(action.getDeviceID(), "io_expander_0");
 }
 
+TEST(SetDeviceActionTests, Link)
+{
+    // Create Device regulator1 and add to IDMap
+    IDMap idMap{};
+    std::unique_ptr<i2c::I2CInterface> i2cInterface =
+        i2c::create(1, 0x70, i2c::I2CInterface::InitialState::CLOSED);
+    Device reg1{
+        "regulator1", true,
+        "/xyz/openbmc_project/inventory/system/chassis/motherboard/reg1",
+        std::move(i2cInterface)};
+    idMap.addDevice(reg1);
+
+    // Create ActionEnvironment with an empty IDMap.  Device can only be found
+    // if the action was linked.
+    IDMap emptyIDMap{};
+    MockServices services{};
+
+    // Test where device is found
+    {
+        ActionEnvironment env{emptyIDMap, "", services};
+        SetDeviceAction action{"regulator1"};
+        action.link(idMap);
+        EXPECT_EQ(action.execute(env), true);
+        EXPECT_EQ(env.getDeviceID(), "regulator1");
+        EXPECT_EQ(&(env.getDevice()), &reg1);
+    }
+
+    // Test where device is not found.  Error occurs when device used.
+    {
+        ActionEnvironment env{emptyIDMap, "", services};
+        SetDeviceAction action{"regulator2"};
+        action.link(idMap);
+        EXPECT_EQ(action.execute(env), true);
+        EXPECT_EQ(env.getDeviceID(), "regulator2");
+        EXPECT_THROW(env.getDevice(), std::invalid_argument);
+    }
+}
+
 TEST(SetDeviceActionTests, ToString)
 {
     SetDeviceAction action{"regulator1"};
@@ -0,0 +1,99 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "allocation_tracker.hpp"
+
+#include <malloc.h> // for malloc_usable_size()
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+
+/**
+ * Number of heap allocations made by the process.
+ */
+std::atomic<uint64_t> allocationCount{0};
+
+/**
+ * Number of heap bytes currently allocated by the process.
+ */
+std::atomic<std::size_t> allocatedBytes{0};
+
+/**
+ * Largest number of heap bytes allocated since the peak was last reset.
+ */
+std::atomic<std::size_t> peakAllocatedBytes{0};
+
+} // namespace
+
+void* operator new(std::size_t size)
+{
+    void* ptr = std::malloc((size == 0) ? 1 : size);
+    if (ptr == nullptr)
+    {
+        throw std::bad_alloc{};
+    }
+
+    ++allocationCount;
+    std::size_t bytes = allocatedBytes += malloc_usable_size(ptr);
+    std::size_t peak = peakAllocatedBytes;
+    while ((bytes > peak) &&
+           !peakAllocatedBytes.compare_exchange_weak(peak, bytes))
+    {}
+    return ptr;
+}
+
+void operator delete(void* ptr) noexcept
+{
+    if (ptr != nullptr)
+    {
+        allocatedBytes -= malloc_usable_size(ptr);
+        std::free(ptr);
+    }
+}
+
+void operator delete(void* ptr, std::size_t /*size*/) noexcept
+{
+    operator delete(ptr);
+}
+
+namespace phosphor::power::regulators::allocation_tracker
+{
+
+uint64_t getAllocationCount()
+{
+    return allocationCount;
+}
+
+std::size_t getAllocatedBytes()
+{
+    return allocatedBytes;
+}
+
+std::size_t getPeakAllocatedBytes()
+{
+    return peakAllocatedBytes;
+}
+
+void resetPeakAllocatedBytes()
+{
+    peakAllocatedBytes = allocatedBytes.load();
+}
+
+} // namespace phosphor::power::regulators::allocation_tracker
@@ -0,0 +1,59 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Functions that report the heap allocations made by the process.
+ *
+ * The allocations are tracked by replacing the global operator new and
+ * operator delete.  Used by the benchmarks to report the number of allocations
+ * and the peak heap usage of the code being measured.
+ */
+namespace phosphor::power::regulators::allocation_tracker
+{
+
+/**
+ * Returns the number of heap allocations made by the process.
+ *
+ * @return number of allocations
+ */
+uint64_t getAllocationCount();
+
+/**
+ * Returns the number of heap bytes currently allocated by the process.
+ *
+ * @return number of allocated bytes
+ */
+std::size_t getAllocatedBytes();
+
+/**
+ * Returns the largest number of heap bytes allocated by the process since the
+ * last call to resetPeakAllocatedBytes().
+ *
+ * @return peak number of allocated bytes
+ */
+std::size_t getPeakAllocatedBytes();
+
+/**
+ * Sets the peak number of allocated heap bytes to the number currently
+ * allocated.
+ */
+void resetPeakAllocatedBytes();
+
+} // namespace phosphor::power::regulators::allocation_tracker
@@ -0,0 +1,291 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "action.hpp"
+#include "bus_budget.hpp"
+#include "bus_usage.hpp"
+#include "chassis.hpp"
+#include "device.hpp"
+#include "i2c_compare_bit_action.hpp"
+#include "i2c_probe_action.hpp"
+#include "i2c_write_byte_action.hpp"
+#include "i2c_write_bytes_action.hpp"
+#include "if_action.hpp"
+#include "mock_action.hpp"
+#include "mocked_i2c_interface.hpp"
+#include "phase_fault_detection.hpp"
+#include "pmbus_read_sensor_action.hpp"
+#include "pmbus_read_sensors_action.hpp"
+#include "pmbus_utils.hpp"
+#include "pmbus_write_vout_command_action.hpp"
+#include "presence_detection.hpp"
+#include "rail.hpp"
+#include "rule.hpp"
+#include "run_rule_action.hpp"
+#include "sensor_monitoring.hpp"
+#include "sensors.hpp"
+#include "set_device_action.hpp"
+#include "system.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+using namespace phosphor::power::regulators;
+using namespace phosphor::power::regulators::bus_usage;
+using namespace std::chrono_literals;
+
+using ::testing::Return;
+
+namespace
+{
+
+/**
+ * Creates a Device on the specified I2C bus and address.
+ */
+std::unique_ptr<Device> createDevice(
+    const std::string& id, uint8_t bus, uint8_t address,
+    std::unique_ptr<PresenceDetection> presenceDetection = nullptr,
+    std::unique_ptr<PhaseFaultDetection> phaseFaultDetection = nullptr,
+    std::vector<std::unique_ptr<Rail>> rails = {})
+{
+    auto i2cInterface = std::make_unique<i2c::MockedI2CInterface>();
+    ON_CALL(*i2cInterface, getBus).WillByDefault(Return(bus));
+    ON_CALL(*i2cInterface, getAddress).WillByDefault(Return(address));
+    return std::make_unique<Device>(
+        id, true,
+        "/xyz/openbmc_project/inventory/system/chassis/motherboard/" + id,
+        std::move(i2cInterface), std::move(presenceDetection), nullptr,
+        std::move(phaseFaultDetection), std::move(rails));
+}
+
+/**
+ * Creates a System containing the specified rules and devices.
+ */
+std::unique_ptr<System>
+    createSystem(std::vector<std::unique_ptr<Rule>> rules,
+                 std::vector<std::unique_ptr<Device>> devices)
+{
+    std::vector<std::unique_ptr<Chassis>> chassis{};
+    chassis.emplace_back(std::make_unique<Chassis>(
+        1, "/xyz/openbmc_project/inventory/system/chassis",
+        std::move(devices)));
+    return std::make_unique<System>(std::move(rules), std::move(chassis));
+}
+
+/**
+ * Creates a vector containing the specified action.
+ */
+std::vector<std::unique_ptr<Action>>
+    createActions(std::unique_ptr<Action> action)
+{
+    std::vector<std::unique_ptr<Action>> actions{};
+    actions.emplace_back(std::move(action));
+    return actions;
+}
+
+} // namespace
+
+TEST(BusUsageTests, Analyze)
+{
+    // Rule that reads vout, which also reads VOUT_MODE: 2 transactions,
+    // 5 bytes
+    std::vector<std::unique_ptr<Rule>> rules{};
+    rules.emplace_back(std::make_unique<Rule>(
+        "read_vout",
+        createActions(std::make_unique<PMBusReadSensorAction>(
+            SensorType::vout, 0x8B, pmbus_utils::SensorDataFormat::linear_16,
+            std::nullopt))));
+
+    // Read the sensors every 500ms, and the group every 4th read
+    std::vector<SamplingGroup> samplingGroups{};
+    samplingGroups.emplace_back(SamplingGroup{
+        4, createActions(std::make_unique<I2CCompareBitAction>(0x7A, 0, 1))});
+    auto sensorMonitoring = std::make_unique<SensorMonitoring>(
+        createActions(std::make_unique<RunRuleAction>("read_vout")), 500ms,
+        std::nullopt, std::move(samplingGroups));
+    std::vector<std::unique_ptr<Rail>> rails{};
+    rails.emplace_back(
+        std::make_unique<Rail>("vdd0", nullptr, std::move(sensorMonitoring)));
+
+    // Masked byte write: 2 transactions, 4 bytes
+    auto phaseFaultDetection = std::make_unique<PhaseFaultDetection>(
+        createActions(std::make_unique<I2CWriteByteAction>(0x7B, 0x01, 0xF0)));
+    auto presenceDetection = std::make_unique<PresenceDetection>(
+        createActions(std::make_unique<I2CCompareBitAction>(0x7C, 1, 0)));
+
+    std::vector<std::unique_ptr<Device>> devices{};
+    devices.emplace_back(createDevice("reg0", 1, 0x70,
+                                      std::move(presenceDetection),
+                                      std::move(phaseFaultDetection),
+                                      std::move(rails)));
+    devices.emplace_back(createDevice("reg1", 1, 0x71));
+    devices.emplace_back(createDevice("reg2", 3, 0x40));
+    std::unique_ptr<System> system =
+        createSystem(std::move(rules), std::move(devices));
+
+    i2c::clearBusBudgets();
+    i2c::setBusBudget(1, i2c::BusBudget{4.0});
+    Report report = analyze(*system, 10s);
+    i2c::clearBusBudgets();
+
+    ASSERT_EQ(report.devices.size(), 3);
+    const DeviceUsage& reg0 = report.devices[0];
+    EXPECT_EQ(reg0.deviceID, "reg0");
+    EXPECT_EQ(reg0.bus, 1);
+    EXPECT_EQ(reg0.address, 0x70);
+    EXPECT_DOUBLE_EQ(reg0.sensorMonitoring.transactions, 3.0);
+    EXPECT_DOUBLE_EQ(reg0.sensorMonitoring.bytes, 7.0);
+    EXPECT_DOUBLE_EQ(reg0.phaseFaultDetection.transactions, 2.0);
+    EXPECT_DOUBLE_EQ(reg0.phaseFaultDetection.bytes, 4.0);
+    EXPECT_DOUBLE_EQ(reg0.presenceDetection.transactions, 1.0);
+    EXPECT_DOUBLE_EQ(reg0.presenceDetection.bytes, 2.0);
+
+    // Sensors: 2 reads per second; group: 0.5; phase faults: 0.1
+    EXPECT_DOUBLE_EQ(reg0.perSecond.transactions, 4.0 + 0.5 + 0.2);
+    EXPECT_DOUBLE_EQ(reg0.perSecond.bytes, 10.0 + 1.0 + 0.4);
+    EXPECT_DOUBLE_EQ(report.devices[1].perSecond.transactions, 0.0);
+    EXPECT_EQ(report.devices[2].bus, 3);
+
+    ASSERT_EQ(report.buses.size(), 2);
+    EXPECT_EQ(report.buses[0].bus, 1);
+    EXPECT_DOUBLE_EQ(report.buses[0].sensorMonitoring.transactions, 3.0);
+    EXPECT_DOUBLE_EQ(report.buses[0].perSecond.transactions, 4.7);
+    EXPECT_EQ(report.buses[0].maxTransactionsPerSecond, 4.0);
+    EXPECT_TRUE(report.buses[0].isOverBudget());
+    EXPECT_EQ(report.buses[1].bus, 3);
+    EXPECT_FALSE(report.buses[1].maxTransactionsPerSecond);
+    EXPECT_FALSE(report.buses[1].isOverBudget());
+
+    std::string text = toString(report);
+    EXPECT_NE(text.find("device reg0 (bus 1, address 0x70): sensors 3.0/7.0, "
+                        "phase faults 2.0/4.0, presence 1.0/2.0, per second "
+                        "4.7/11.4\n"),
+              std::string::npos);
+    EXPECT_NE(text.find("bus 1: sensors 3.0/7.0, per second 4.7/11.4, "
+                        "budget 4.0 (over budget)\n"),
+              std::string::npos);
+    EXPECT_NE(text.find("bus 3: sensors 0.0/0.0, per second 0.0/0.0\n"),
+              std::string::npos);
+}
+
+TEST(BusUsageTests, GetUsage)
+{
+    std::vector<std::unique_ptr<Rule>> rules{};
+    rules.emplace_back(std::make_unique<Rule>(
+        "recursive", createActions(std::make_unique<RunRuleAction>(
+                         "recursive"))));
+    std::vector<std::unique_ptr<Device>> devices{};
+    devices.emplace_back(createDevice("reg0", 1, 0x70));
+    devices.emplace_back(createDevice("reg1", 1, 0x71));
+    std::unique_ptr<System> system =
+        createSystem(std::move(rules), std::move(devices));
+
+    // Actions that do not access the bus
+    {
+        DeviceUsageMap usage = internal::getUsage(
+            createActions(std::make_unique<MockAction>()), *system, "reg0");
+        EXPECT_TRUE(usage.empty());
+    }
+
+    // Page is written, then two reads and VOUT_MODE
+    {
+        std::vector<PMBusReadSensorsAction::Sensor> sensors{
+            {SensorType::vout, 0x8B, pmbus_utils::SensorDataFormat::linear_16},
+            {SensorType::iout, 0x8C,
+             pmbus_utils::SensorDataFormat::linear_11}};
+        DeviceUsageMap usage = internal::getUsage(
+            createActions(std::make_unique<PMBusReadSensorsAction>(
+                sensors, 0x01, std::nullopt)),
+            *system, "reg0");
+        EXPECT_DOUBLE_EQ(usage["reg0"].transactions, 4.0);
+        EXPECT_DOUBLE_EQ(usage["reg0"].bytes, 10.0);
+    }
+
+    // Masked write of 2 bytes reads them first
+    {
+        DeviceUsageMap usage = internal::getUsage(
+            createActions(std::make_unique<I2CWriteBytesAction>(
+                0x0A, std::vector<uint8_t>{0x01, 0x02},
+                std::vector<uint8_t>{0xFF, 0x0F})),
+            *system, "reg0");
+        EXPECT_DOUBLE_EQ(usage["reg0"].transactions, 2.0);
+        EXPECT_DOUBLE_EQ(usage["reg0"].bytes, 6.0);
+    }
+
+    // Probes transfer no register address
+    {
+        std::vector<std::unique_ptr<Action>> actions{};
+        actions.emplace_back(
+            std::make_unique<I2CProbeAction>(I2CProbeAction::Method::quick));
+        actions.emplace_back(std::make_unique<I2CProbeAction>());
+        DeviceUsageMap usage = internal::getUsage(actions, *system, "reg0");
+        EXPECT_DOUBLE_EQ(usage["reg0"].transactions, 2.0);
+        EXPECT_DOUBLE_EQ(usage["reg0"].bytes, 1.0);
+    }
+
+    // Verified write with an exponent
+    {
+        DeviceUsageMap usage = internal::getUsage(
+            createActions(std::make_unique<PMBusWriteVoutCommandAction>(
+                1.1, pmbus_utils::VoutDataFormat::linear, -8, true)),
+            *system, "reg0");
+        EXPECT_DOUBLE_EQ(usage["reg0"].transactions, 2.0);
+        EXPECT_DOUBLE_EQ(usage["reg0"].bytes, 6.0);
+    }
+
+    // set_device changes the device, and the larger branch of the if is used
+    {
+        std::vector<std::unique_ptr<Action>> thenActions{};
+        thenActions.emplace_back(std::make_unique<SetDeviceAction>("reg1"));
+        thenActions.emplace_back(
+            std::make_unique<I2CCompareBitAction>(0x10, 0, 1));
+        std::vector<std::unique_ptr<Action>> elseActions{};
+        elseActions.emplace_back(
+            std::make_unique<I2CWriteByteAction>(0x10, 0x01, 0x0F));
+        std::vector<std::unique_ptr<Action>> actions{};
+        actions.emplace_back(std::make_unique<IfAction>(
+            std::make_unique<I2CCompareBitAction>(0x11, 0, 1),
+            std::move(thenActions), std::move(elseActions)));
+        actions.emplace_back(
+            std::make_unique<I2CCompareBitAction>(0x12, 0, 1));
+        DeviceUsageMap usage = internal::getUsage(actions, *system, "reg0");
+        EXPECT_DOUBLE_EQ(usage["reg0"].transactions, 3.0);
+        EXPECT_DOUBLE_EQ(usage["reg0"].bytes, 6.0);
+        EXPECT_DOUBLE_EQ(usage["reg1"].transactions, 2.0);
+        EXPECT_DOUBLE_EQ(usage["reg1"].bytes, 4.0);
+    }
+
+    // Maximum rule depth exceeded
+    try
+    {
+        internal::getUsage(
+            createActions(std::make_unique<RunRuleAction>("recursive")),
+            *system, "reg0");
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::runtime_error& e)
+    {
+        EXPECT_STREQ(e.what(),
+                     "Maximum rule depth exceeded by rule recursive.");
+    }
+}
@@ -0,0 +1,362 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "action.hpp"
+#include "action_environment.hpp"
+#include "chassis.hpp"
+#include "chassis_monitor.hpp"
+#include "configuration.hpp"
+#include "device.hpp"
+#include "mock_action.hpp"
+#include "mock_sensors.hpp"
+#include "mock_services.hpp"
+#include "mocked_i2c_interface.hpp"
+#include "phase_fault_detection.hpp"
+#include "presence_detection.hpp"
+#include "rail.hpp"
+#include "rule.hpp"
+#include "sensor_monitoring.hpp"
+#include "sensors.hpp"
+#include "system.hpp"
+#include "test_utils.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+using namespace phosphor::power::regulators;
+using namespace phosphor::power::regulators::test_utils;
+
+using ::testing::_;
+using ::testing::InvokeWithoutArgs;
+using ::testing::Return;
+
+static const std::string chassisInvPath{
+    "/xyz/openbmc_project/inventory/system/chassis"};
+
+/**
+ * Creates a Rail whose sensor monitoring sleeps for the specified read time
+ * and then sets the iout sensor to the specified value.
+ *
+ * @param id rail ID
+ * @param readTime time it takes to read the sensors of the rail
+ * @param value iout sensor value
+ * @param interval interval between sensor reads
+ * @return Rail object
+ */
+static std::unique_ptr<Rail> createRail(
+    const std::string& id, std::chrono::milliseconds readTime, double value,
+    std::chrono::milliseconds interval = SensorMonitoring::defaultInterval)
+{
+    auto action = std::make_unique<MockAction>();
+    EXPECT_CALL(*action, execute)
+        .WillRepeatedly([readTime, value](ActionEnvironment& environment) {
+            std::this_thread::sleep_for(readTime);
+            environment.getServices().getSensors().setValue(SensorType::iout,
+                                                            value);
+            return true;
+        });
+    std::vector<std::unique_ptr<Action>> actions{};
+    actions.emplace_back(std::move(action));
+    auto sensorMonitoring =
+        std::make_unique<SensorMonitoring>(std::move(actions), interval);
+
+    std::unique_ptr<Configuration> configuration{};
+    return std::make_unique<Rail>(id, std::move(configuration),
+                                  std::move(sensorMonitoring));
+}
+
+/**
+ * Creates a Device on I2C bus 1 that contains the specified rails.
+ *
+ * @param id device ID
+ * @param rails rails in the device
+ * @param presenceDetection presence detection for the device, if any
+ * @return Device object
+ */
+static std::unique_ptr<Device> createDevice(
+    const std::string& id, std::vector<std::unique_ptr<Rail>> rails,
+    std::unique_ptr<PresenceDetection> presenceDetection = nullptr)
+{
+    auto i2cInterface = std::make_unique<i2c::MockedI2CInterface>();
+    EXPECT_CALL(*i2cInterface, getBus).WillRepeatedly(Return(1));
+    std::unique_ptr<Configuration> configuration{};
+    std::unique_ptr<PhaseFaultDetection> phaseFaultDetection{};
+    return std::make_unique<Device>(
+        id, true,
+        "/xyz/openbmc_project/inventory/system/chassis/motherboard/" + id,
+        std::move(i2cInterface), std::move(presenceDetection),
+        std::move(configuration), std::move(phaseFaultDetection),
+        std::move(rails));
+}
+
+/**
+ * Collects the results of the specified monitor, waiting up to 10 seconds
+ * for its worker to finish.
+ *
+ * @param monitor chassis monitor
+ * @return return value of ChassisMonitor::collect()
+ */
+static bool collectWithTimeout(ChassisMonitor& monitor)
+{
+    auto end = std::chrono::steady_clock::now() + std::chrono::seconds{10};
+    while (monitor.isRunning() && (std::chrono::steady_clock::now() < end))
+    {
+        if (monitor.collect())
+        {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds{10});
+    }
+    return false;
+}
+
+TEST(ChassisMonitorTests, Constructor)
+{
+    MockServices services{};
+
+    // Test where chassis contains no rails
+    {
+        auto system = createSystem({}, false, true);
+        Chassis& chassis = *system->getChassis()[0];
+        ChassisMonitor monitor{services, *system, chassis, 15};
+        EXPECT_EQ(&monitor.getChassis(), &chassis);
+        EXPECT_EQ(monitor.getInterval(), SensorMonitoring::defaultInterval);
+        EXPECT_FALSE(monitor.isRunning());
+    }
+
+    // Test where rails have different intervals
+    {
+        std::vector<std::unique_ptr<Rail>> rails{};
+        rails.emplace_back(createRail("vdd0", std::chrono::milliseconds{0},
+                                      1.0, std::chrono::milliseconds{500}));
+        rails.emplace_back(createRail("vdd1", std::chrono::milliseconds{0},
+                                      1.0, std::chrono::milliseconds{750}));
+        std::vector<std::unique_ptr<Device>> devices{};
+        devices.emplace_back(createDevice("vdd_reg", std::move(rails)));
+        auto system = createSystem(std::move(devices), false, true);
+        ChassisMonitor monitor{services, *system, *system->getChassis()[0],
+                               15};
+        EXPECT_EQ(monitor.getInterval(), std::chrono::milliseconds{250});
+    }
+}
+
+TEST(ChassisMonitorTests, Collect)
+{
+    // Test where the worker has not been started
+    {
+        MockServices services{};
+        auto system = createSystem({}, false, true);
+        ChassisMonitor monitor{services, *system, *system->getChassis()[0],
+                               15};
+        EXPECT_FALSE(monitor.collect());
+    }
+
+    // Test where the sensors are monitored on the worker and the sensor
+    // updates occur on the calling thread
+    {
+        std::vector<std::unique_ptr<Rail>> rails{};
+        rails.emplace_back(
+            createRail("vdd0", std::chrono::milliseconds{200}, 1.5));
+        std::vector<std::unique_ptr<Device>> devices{};
+        devices.emplace_back(createDevice("vdd_reg", std::move(rails)));
+        auto system = createSystem(std::move(devices), false, true);
+
+        std::thread::id callingThread = std::this_thread::get_id();
+        auto checkThread = [callingThread]() {
+            EXPECT_EQ(std::this_thread::get_id(), callingThread);
+        };
+        MockServices services{};
+        MockSensors& sensors = services.getMockSensors();
+        EXPECT_CALL(sensors, startRail("vdd0", _, chassisInvPath))
+            .Times(1)
+            .WillOnce(InvokeWithoutArgs(checkThread));
+        EXPECT_CALL(sensors, setValue(SensorType::iout, 1.5))
+            .Times(1)
+            .WillOnce(InvokeWithoutArgs(checkThread));
+        EXPECT_CALL(sensors, endRail(false)).Times(1);
+
+        ChassisMonitor monitor{services, *system, *system->getChassis()[0],
+                               15};
+        EXPECT_TRUE(monitor.start());
+        EXPECT_TRUE(monitor.isRunning());
+
+        // Worker is still reading the rail
+        EXPECT_FALSE(monitor.collect());
+        EXPECT_TRUE(monitor.isRunning());
+
+        EXPECT_TRUE(collectWithTimeout(monitor));
+        EXPECT_FALSE(monitor.isRunning());
+        EXPECT_FALSE(monitor.collect());
+    }
+}
+
+TEST(ChassisMonitorTests, SkipRails)
+{
+    std::vector<std::unique_ptr<Rail>> rails{};
+    rails.emplace_back(createRail("vdd0", std::chrono::milliseconds{0}, 1.0));
+    std::unique_ptr<Configuration> configuration{};
+    rails.emplace_back(
+        std::make_unique<Rail>("vio0", std::move(configuration)));
+    std::vector<std::unique_ptr<Device>> devices{};
+    devices.emplace_back(createDevice("vdd_reg", std::move(rails)));
+    auto system = createSystem(std::move(devices), false, true);
+
+    // Only rails with sensor monitoring are skipped
+    MockServices services{};
+    MockSensors& sensors = services.getMockSensors();
+    EXPECT_CALL(sensors, skipRail("vdd0")).Times(1);
+    EXPECT_CALL(sensors, skipRail("vio0")).Times(0);
+
+    ChassisMonitor monitor{services, *system, *system->getChassis()[0], 15};
+    monitor.skipRails();
+}
+
+TEST(ChassisMonitorTests, Start)
+{
+    // Test where the sensors are not due to be monitored again until the
+    // interval has elapsed
+    {
+        std::vector<std::unique_ptr<Rail>> rails{};
+        rails.emplace_back(
+            createRail("vdd0", std::chrono::milliseconds{0}, 1.0));
+        std::vector<std::unique_ptr<Device>> devices{};
+        devices.emplace_back(createDevice("vdd_reg", std::move(rails)));
+        auto system = createSystem(std::move(devices), false, true);
+
+        // The rail skips the second read since its own interval has not
+        // elapsed
+        MockServices services{};
+        MockSensors& sensors = services.getMockSensors();
+        EXPECT_CALL(sensors, startRail).Times(1);
+        EXPECT_CALL(sensors, setValue(SensorType::iout, 1.0)).Times(1);
+        EXPECT_CALL(sensors, endRail(false)).Times(1);
+        EXPECT_CALL(sensors, skipRail("vdd0")).Times(1);
+
+        ChassisMonitor monitor{services, *system, *system->getChassis()[0],
+                               15};
+        auto now = std::chrono::steady_clock::now();
+        EXPECT_TRUE(monitor.start(now));
+
+        // Worker is already running
+        EXPECT_FALSE(monitor.start(now));
+        EXPECT_TRUE(collectWithTimeout(monitor));
+
+        // Interval has not elapsed
+        EXPECT_FALSE(monitor.start(now + std::chrono::milliseconds{500}));
+
+        // Interval has elapsed
+        EXPECT_TRUE(monitor.start(now + SensorMonitoring::defaultInterval));
+        EXPECT_TRUE(collectWithTimeout(monitor));
+    }
+
+    // Test where phase fault detection is requested before the interval has
+    // elapsed.  The sensors are not monitored.
+    {
+        std::vector<std::unique_ptr<Rail>> rails{};
+        rails.emplace_back(
+            createRail("vdd0", std::chrono::milliseconds{0}, 1.0));
+        std::vector<std::unique_ptr<Device>> devices{};
+        devices.emplace_back(createDevice("vdd_reg", std::move(rails)));
+        auto system = createSystem(std::move(devices), false, true);
+
+        MockServices services{};
+        MockSensors& sensors = services.getMockSensors();
+        EXPECT_CALL(sensors, startRail).Times(1);
+        EXPECT_CALL(sensors, setValue(SensorType::iout, 1.0)).Times(1);
+        EXPECT_CALL(sensors, endRail(false)).Times(1);
+
+        ChassisMonitor monitor{services, *system, *system->getChassis()[0],
+                               15};
+        auto now = std::chrono::steady_clock::now();
+        EXPECT_TRUE(monitor.start(now));
+        monitor.wait();
+        EXPECT_FALSE(monitor.isRunning());
+
+        monitor.requestPhaseFaultDetection();
+        EXPECT_TRUE(monitor.start(now));
+        monitor.wait();
+        EXPECT_FALSE(monitor.start(now));
+    }
+
+    // Test where device presence is determined on the calling thread
+    {
+        std::thread::id callingThread = std::this_thread::get_id();
+        auto action = std::make_unique<MockAction>();
+        EXPECT_CALL(*action, execute)
+            .Times(1)
+            .WillOnce([callingThread](ActionEnvironment&) {
+                EXPECT_EQ(std::this_thread::get_id(), callingThread);
+                return true;
+            });
+        std::vector<std::unique_ptr<Action>> actions{};
+        actions.emplace_back(std::move(action));
+        auto presenceDetection =
+            std::make_unique<PresenceDetection>(std::move(actions));
+
+        std::vector<std::unique_ptr<Rail>> rails{};
+        rails.emplace_back(
+            createRail("vdd0", std::chrono::milliseconds{0}, 1.0));
+        std::vector<std::unique_ptr<Device>> devices{};
+        devices.emplace_back(createDevice("vdd_reg", std::move(rails),
+                                          std::move(presenceDetection)));
+        auto system = createSystem(std::move(devices), false, true);
+
+        MockServices services{};
+        MockSensors& sensors = services.getMockSensors();
+        EXPECT_CALL(sensors, startRail).Times(1);
+        EXPECT_CALL(sensors, setValue(SensorType::iout, 1.0)).Times(1);
+        EXPECT_CALL(sensors, endRail(false)).Times(1);
+
+        ChassisMonitor monitor{services, *system, *system->getChassis()[0],
+                               15};
+        EXPECT_TRUE(monitor.start());
+        EXPECT_TRUE(collectWithTimeout(monitor));
+    }
+}
+
+TEST(ChassisMonitorTests, Wait)
+{
+    std::vector<std::unique_ptr<Rail>> rails{};
+    rails.emplace_back(
+        createRail("vdd0", std::chrono::milliseconds{100}, 2.5));
+    std::vector<std::unique_ptr<Device>> devices{};
+    devices.emplace_back(createDevice("vdd_reg", std::move(rails)));
+    auto system = createSystem(std::move(devices), false, true);
+
+    MockServices services{};
+    MockSensors& sensors = services.getMockSensors();
+    EXPECT_CALL(sensors, startRail).Times(1);
+    EXPECT_CALL(sensors, setValue(SensorType::iout, 2.5)).Times(1);
+    EXPECT_CALL(sensors, endRail(false)).Times(1);
+
+    ChassisMonitor monitor{services, *system, *system->getChassis()[0], 15};
+
+    // Test where the worker has not been started
+    monitor.wait();
+
+    // Test where the worker is running.  The results are replayed.
+    EXPECT_TRUE(monitor.start());
+    monitor.wait();
+    EXPECT_FALSE(monitor.isRunning());
+    EXPECT_FALSE(monitor.collect());
+}
@@ -28,6 +28,7 @@
 #include "mocked_i2c_interface.hpp"
 #include "phase_fault.hpp"
 #include "phase_fault_detection.hpp"
+#include "power_domain.hpp"
 #include "presence_detection.hpp"
 #include "rail.hpp"
 #include "rule.hpp"
@@ -84,6 +85,9 @@ TEST_F(ChassisTests, Constructor)
         EXPECT_EQ(chassis.getNumber(), 2);
         EXPECT_EQ(chassis.getInventoryPath(), defaultInventoryPath);
         EXPECT_EQ(chassis.getDevices().size(), 0);
+        EXPECT_FALSE(chassis.isParallelConfiguration());
+        EXPECT_FALSE(chassis.isIndependentMonitoring());
+        EXPECT_FALSE(chassis.isWriteVerificationDeferred());
     }
 
     // Test where works: All parameters are specified
@@ -94,10 +98,14 @@ TEST_F(ChassisTests, Constructor)
         devices.emplace_back(createDevice("vdd_reg2"));
 
         // Create Chassis
-        Chassis chassis{1, defaultInventoryPath, std::move(devices)};
+        Chassis chassis{
+            1, defaultInventoryPath, std::move(devices), true, true, true};
         EXPECT_EQ(chassis.getNumber(), 1);
         EXPECT_EQ(chassis.getInventoryPath(), defaultInventoryPath);
         EXPECT_EQ(chassis.getDevices().size(), 2);
+        EXPECT_TRUE(chassis.isParallelConfiguration());
+        EXPECT_TRUE(chassis.isIndependentMonitoring());
+        EXPECT_TRUE(chassis.isWriteVerificationDeferred());
     }
 
     // Test where fails: Invalid chassis number < 1
@@ -314,6 +322,76 @@ TEST_F(ChassisTests, CloseDevices)
     }
 }
 
+TEST_F(ChassisTests, CloseUnpoweredDevices)
+{
+    std::vector<std::unique_ptr<Device>> devices{};
+
+    // Create mock services.  Expect logDebug() to be called.
+    MockServices services{};
+    MockJournal& journal = services.getMockJournal();
+    EXPECT_CALL(journal, logDebug("Closing unpowered devices in chassis 1"))
+        .Times(1);
+
+    // Create Device vdd0_reg that is not standby-powered.  Should be closed.
+    {
+        auto i2cInterface = std::make_unique<i2c::MockedI2CInterface>();
+        EXPECT_CALL(*i2cInterface, isOpen).Times(1).WillOnce(Return(true));
+        EXPECT_CALL(*i2cInterface, close).Times(1);
+
+        auto device = std::make_unique<Device>(
+            "vdd0_reg", true,
+            "/xyz/openbmc_project/inventory/system/chassis/motherboard/"
+            "vdd0_reg",
+            std::move(i2cInterface));
+        devices.emplace_back(std::move(device));
+    }
+
+    // Create Device vdd1_reg that is standby-powered and present.  Should not
+    // be closed.
+    {
+        auto i2cInterface = std::make_unique<i2c::MockedI2CInterface>();
+        EXPECT_CALL(*i2cInterface, isOpen).Times(0);
+        EXPECT_CALL(*i2cInterface, close).Times(0);
+
+        auto device = std::make_unique<Device>(
+            "vdd1_reg", true,
+            "/xyz/openbmc_project/inventory/system/chassis/motherboard/"
+            "vdd1_reg",
+            std::move(i2cInterface));
+        device->setStandbyPowered(true);
+        devices.emplace_back(std::move(device));
+    }
+
+    // Create Device vdd2_reg that is standby-powered and not present.  Should
+    // be closed.
+    {
+        auto action = std::make_unique<MockAction>();
+        EXPECT_CALL(*action, execute).WillOnce(Return(false));
+        std::vector<std::unique_ptr<Action>> actions{};
+        actions.emplace_back(std::move(action));
+        auto presenceDetection =
+            std::make_unique<PresenceDetection>(std::move(actions));
+
+        auto i2cInterface = std::make_unique<i2c::MockedI2CInterface>();
+        EXPECT_CALL(*i2cInterface, isOpen).Times(1).WillOnce(Return(true));
+        EXPECT_CALL(*i2cInterface, close).Times(1);
+
+        auto device = std::make_unique<Device>(
+            "vdd2_reg", true,
+            "/xyz/openbmc_project/inventory/system/chassis/motherboard/"
+            "vdd2_reg",
+            std::move(i2cInterface), std::move(presenceDetection));
+        device->setStandbyPowered(true);
+        devices.emplace_back(std::move(device));
+    }
+
+    // Create Chassis
+    Chassis chassis{1, defaultInventoryPath, std::move(devices)};
+
+    // Call closeUnpoweredDevices()
+    chassis.closeUnpoweredDevices(services, *system);
+}
+
 TEST_F(ChassisTests, Configure)
 {
     // Test where no devices were specified in constructor
@@ -329,7 +407,7 @@ TEST_F(ChassisTests, Configure)
         Chassis chassis{1, defaultInventoryPath};
 
         // Call configure()
-        chassis.configure(services, *system);
+        EXPECT_EQ(chassis.configure(services, *system), 0);
     }
 
     // Test where devices were specified in constructor
@@ -388,7 +466,52 @@ TEST_F(ChassisTests, Configure)
         Chassis chassis{2, defaultInventoryPath, std::move(devices)};
 
         // Call configure()
-        chassis.configure(services, *system);
+        EXPECT_EQ(chassis.configure(services, *system), 0);
+    }
+
+    // Test where a power domain is specified.  Only the devices in the power
+    // domain are configured.
+    {
+        std::vector<std::unique_ptr<Device>> devices{};
+
+        // Create mock services.  Expect logInfo() and logDebug() to be called.
+        MockServices services{};
+        MockJournal& journal = services.getMockJournal();
+        EXPECT_CALL(journal, logInfo("Configuring chassis 2 power domain cpu0"))
+            .Times(1);
+        EXPECT_CALL(journal, logInfo("Configuring chassis 2")).Times(1);
+        EXPECT_CALL(journal, logDebug("Configuring vdd0_reg: volts=1.300000"))
+            .Times(1);
+        EXPECT_CALL(journal, logDebug("Configuring vdd1_reg: volts=1.200000"))
+            .Times(1);
+        EXPECT_CALL(journal, logError(A<const std::string&>())).Times(0);
+
+        // Create Devices vdd0_reg and vdd1_reg.  vdd0_reg is in power domain
+        // cpu0.
+        for (const auto& [id, volts] : {std::pair{"vdd0_reg", 1.3},
+                                        std::pair{"vdd1_reg", 1.2}})
+        {
+            std::vector<std::unique_ptr<Action>> actions{};
+            auto configuration =
+                std::make_unique<Configuration>(volts, std::move(actions));
+            auto i2cInterface = std::make_unique<i2c::MockedI2CInterface>();
+            std::unique_ptr<PresenceDetection> presenceDetection{};
+            devices.emplace_back(std::make_unique<Device>(
+                id, true,
+                "/xyz/openbmc_project/inventory/system/chassis/motherboard/" +
+                    std::string{id},
+                std::move(i2cInterface), std::move(presenceDetection),
+                std::move(configuration)));
+        }
+        devices[0]->setPowerDomain(std::make_unique<PowerDomain>(
+            "cpu0", std::vector<unsigned int>{4}));
+
+        // Create Chassis
+        Chassis chassis{2, defaultInventoryPath, std::move(devices)};
+
+        // Configure the power domain, then the devices not in a power domain
+        chassis.configure(services, *system, "cpu0");
+        chassis.configure(services, *system, std::string{});
     }
 }
 
@@ -535,6 +658,56 @@ TEST_F(ChassisTests, GetNumber)
     EXPECT_EQ(chassis.getNumber(), 3);
 }
 
+TEST_F(ChassisTests, HandleAlert)
+{
+    // Create mock services.  Expect phase fault detection to run only in
+    // device reg1.
+    MockServices services{};
+    MockJournal& journal = services.getMockJournal();
+    EXPECT_CALL(journal,
+                logError("n phase fault detected in regulator reg1: count=1"))
+        .Times(1);
+    MockErrorLogging& errorLogging = services.getMockErrorLogging();
+    EXPECT_CALL(errorLogging, logPhaseFault).Times(0);
+
+    // Create Devices reg0 at address 0x70 and reg1 at address 0x71 on bus 1
+    std::vector<std::unique_ptr<Device>> devices{};
+    for (uint8_t address : {0x70, 0x71})
+    {
+        std::string id{(address == 0x70) ? "reg0" : "reg1"};
+
+        // Create PhaseFaultDetection
+        auto action = std::make_unique<LogPhaseFaultAction>(PhaseFaultType::n);
+        std::vector<std::unique_ptr<Action>> actions{};
+        actions.push_back(std::move(action));
+        auto phaseFaultDetection =
+            std::make_unique<PhaseFaultDetection>(std::move(actions));
+
+        // Create Device
+        auto i2cInterface = std::make_unique<i2c::MockedI2CInterface>();
+        EXPECT_CALL(*i2cInterface, getBus).WillRepeatedly(Return(1));
+        EXPECT_CALL(*i2cInterface, getAddress).WillRepeatedly(Return(address));
+        std::unique_ptr<PresenceDetection> presenceDetection{};
+        std::unique_ptr<Configuration> configuration{};
+        auto device = std::make_unique<Device>(
+            id, true,
+            "/xyz/openbmc_project/inventory/system/chassis/motherboard/" + id,
+            std::move(i2cInterface), std::move(presenceDetection),
+            std::move(configuration), std::move(phaseFaultDetection));
+        devices.emplace_back(std::move(device));
+    }
+
+    // Create Chassis
+    Chassis chassis{2, defaultInventoryPath, std::move(devices)};
+
+    // Test where a device has the bus and address
+    EXPECT_TRUE(chassis.handleAlert(services, *system, 1, 0x71));
+
+    // Test where no device has the bus and address
+    EXPECT_FALSE(chassis.handleAlert(services, *system, 1, 0x20));
+    EXPECT_FALSE(chassis.handleAlert(services, *system, 2, 0x70));
+}
+
 TEST_F(ChassisTests, MonitorSensors)
 {
     // Test where no devices were specified in constructor
@@ -644,3 +817,31 @@ TEST_F(ChassisTests, MonitorSensors)
         chassis.monitorSensors(services, *system);
     }
 }
+
+TEST_F(ChassisTests, ReplaceDevice)
+{
+    // Test where works
+    {
+        std::vector<std::unique_ptr<Device>> devices{};
+        devices.emplace_back(createDevice("vdd_reg1"));
+        devices.emplace_back(createDevice("vdd_reg2"));
+        Chassis chassis{1, defaultInventoryPath, std::move(devices)};
+        Device* oldDevice = chassis.getDevices()[1].get();
+
+        std::unique_ptr<Device> newDevice = createDevice("vdd_reg2");
+        Device* newDevicePtr = newDevice.get();
+        std::unique_ptr<Device> replaced =
+            chassis.replaceDevice(1, std::move(newDevice));
+        EXPECT_EQ(replaced.get(), oldDevice);
+        EXPECT_EQ(chassis.getDevices().size(), 2);
+        EXPECT_EQ(chassis.getDevices()[0]->getID(), "vdd_reg1");
+        EXPECT_EQ(chassis.getDevices()[1].get(), newDevicePtr);
+    }
+
+    // Test where fails: Invalid index
+    {
+        Chassis chassis{1, defaultInventoryPath};
+        EXPECT_THROW(chassis.replaceDevice(0, createDevice("vdd_reg1")),
+                     std::out_of_range);
+    }
+}
@@ -0,0 +1,119 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "circuit_breaker.hpp"
+
+#include <chrono>
+
+#include <gtest/gtest.h>
+
+using namespace phosphor::power::regulators;
+using namespace std::chrono_literals;
+
+TEST(CircuitBreakerTests, Constructor)
+{
+    CircuitBreaker breaker{};
+    EXPECT_FALSE(breaker.isOpen());
+    EXPECT_EQ(breaker.getFailureCount(), 0);
+    EXPECT_EQ(breaker.getBackoff(), CircuitBreaker::Clock::duration{0});
+    EXPECT_TRUE(breaker.isAllowed(CircuitBreaker::Clock::time_point{}));
+}
+
+TEST(CircuitBreakerTests, RecordFailure)
+{
+    CircuitBreaker breaker{3, 1s, 4s};
+    CircuitBreaker::Clock::time_point now{};
+
+    // Test where breaker stays closed below the failure limit
+    EXPECT_FALSE(breaker.recordFailure(now));
+    EXPECT_FALSE(breaker.recordFailure(now));
+    EXPECT_FALSE(breaker.isOpen());
+    EXPECT_EQ(breaker.getFailureCount(), 2);
+    EXPECT_TRUE(breaker.isAllowed(now));
+
+    // Test where breaker opens at the failure limit
+    EXPECT_TRUE(breaker.recordFailure(now));
+    EXPECT_TRUE(breaker.isOpen());
+    EXPECT_EQ(breaker.getFailureCount(), 3);
+    EXPECT_EQ(breaker.getBackoff(), 1s);
+    EXPECT_FALSE(breaker.isAllowed(now));
+    EXPECT_FALSE(breaker.isAllowed(now + 999ms));
+    EXPECT_TRUE(breaker.isAllowed(now + 1s));
+
+    // Test where backoff doubles after each failed try
+    now += 1s;
+    EXPECT_FALSE(breaker.recordFailure(now));
+    EXPECT_TRUE(breaker.isOpen());
+    EXPECT_EQ(breaker.getBackoff(), 2s);
+    EXPECT_FALSE(breaker.isAllowed(now + 1s));
+    EXPECT_TRUE(breaker.isAllowed(now + 2s));
+
+    // Test where backoff is limited to the maximum
+    now += 2s;
+    EXPECT_FALSE(breaker.recordFailure(now));
+    EXPECT_EQ(breaker.getBackoff(), 4s);
+    now += 4s;
+    EXPECT_FALSE(breaker.recordFailure(now));
+    EXPECT_EQ(breaker.getBackoff(), 4s);
+    EXPECT_FALSE(breaker.isAllowed(now + 3s));
+    EXPECT_TRUE(breaker.isAllowed(now + 4s));
+    EXPECT_EQ(breaker.getFailureCount(), 6);
+}
+
+TEST(CircuitBreakerTests, RecordSuccess)
+{
+    CircuitBreaker breaker{2, 1s, 4s};
+    CircuitBreaker::Clock::time_point now{};
+
+    // Test where success resets the failure count of a closed breaker
+    breaker.recordFailure(now);
+    EXPECT_FALSE(breaker.recordSuccess());
+    EXPECT_EQ(breaker.getFailureCount(), 0);
+    EXPECT_FALSE(breaker.recordFailure(now));
+    EXPECT_FALSE(breaker.isOpen());
+
+    // Test where success closes an open breaker
+    EXPECT_TRUE(breaker.recordFailure(now));
+    EXPECT_TRUE(breaker.recordSuccess());
+    EXPECT_FALSE(breaker.isOpen());
+    EXPECT_EQ(breaker.getFailureCount(), 0);
+    EXPECT_EQ(breaker.getBackoff(), CircuitBreaker::Clock::duration{0});
+    EXPECT_TRUE(breaker.isAllowed(now));
+
+    // Test where breaker opens again with the minimum backoff
+    breaker.recordFailure(now);
+    EXPECT_TRUE(breaker.recordFailure(now));
+    EXPECT_EQ(breaker.getBackoff(), 1s);
+}
+
+TEST(CircuitBreakerTests, Reset)
+{
+    CircuitBreaker breaker{1, 1s, 4s};
+    CircuitBreaker::Clock::time_point now{};
+    EXPECT_TRUE(breaker.recordFailure(now));
+    EXPECT_FALSE(breaker.isAllowed(now));
+
+    breaker.reset();
+    EXPECT_FALSE(breaker.isOpen());
+    EXPECT_EQ(breaker.getFailureCount(), 0);
+    EXPECT_TRUE(breaker.isAllowed(now));
+}
+
+TEST(CircuitBreakerTests, ZeroFailureLimit)
+{
+    // A failure limit of 0 is treated as 1
+    CircuitBreaker breaker{0, 1s, 4s};
+    EXPECT_TRUE(breaker.recordFailure(CircuitBreaker::Clock::time_point{}));
+}
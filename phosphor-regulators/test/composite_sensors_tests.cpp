@@ -0,0 +1,167 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "composite_sensors.hpp"
+#include "mock_sensors.hpp"
+#include "sensors.hpp"
+
+#include <chrono>
+#include <stdexcept>
+#include <string>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+using namespace phosphor::power::regulators;
+
+using ::testing::_;
+using ::testing::InSequence;
+using ::testing::Throw;
+
+TEST(CompositeSensorsTests, AddSink)
+{
+    CompositeSensors sensors{};
+    EXPECT_EQ(sensors.getSinkCount(), 0);
+
+    MockSensors sink1{};
+    MockSensors sink2{};
+    sensors.addSink(sink1);
+    sensors.addSink(sink2, std::chrono::milliseconds{5000});
+    EXPECT_EQ(sensors.getSinkCount(), 2);
+}
+
+TEST(CompositeSensorsTests, MonitoringCycle)
+{
+    // Test where all calls are passed to all sinks
+    {
+        MockSensors sink1{};
+        MockSensors sink2{};
+        for (MockSensors* sink : {&sink1, &sink2})
+        {
+            InSequence seq{};
+            EXPECT_CALL(*sink, startCycle).Times(1);
+            EXPECT_CALL(*sink, startRail("vdd0", "/reg0", "/chassis"))
+                .Times(1);
+            EXPECT_CALL(*sink, setValue(SensorType::iout, 11.5)).Times(1);
+            EXPECT_CALL(*sink, setAggregatedValue(SensorType::vout, 1.1, _))
+                .Times(1);
+            EXPECT_CALL(*sink, endRail(false)).Times(1);
+            EXPECT_CALL(*sink, skipRail("vdd1")).Times(1);
+            EXPECT_CALL(*sink, disableRail("vdd2")).Times(1);
+            EXPECT_CALL(*sink, endCycle).Times(1);
+        }
+
+        CompositeSensors sensors{};
+        sensors.addSink(sink1);
+        sensors.addSink(sink2);
+        sensors.startCycle();
+        sensors.startRail("vdd0", "/reg0", "/chassis");
+        sensors.setValue(SensorType::iout, 11.5);
+        sensors.setAggregatedValue(
+            SensorType::vout, 1.1,
+            SensorAggregation{std::chrono::milliseconds{1000},
+                              SensorStatistic::mean});
+        sensors.endRail(false);
+        sensors.skipRail("vdd1");
+        sensors.disableRail("vdd2");
+        sensors.endCycle();
+    }
+
+    // Test where one sink has a minimum cycle interval.  It only receives
+    // the first cycle.
+    {
+        MockSensors sink1{};
+        EXPECT_CALL(sink1, startCycle).Times(2);
+        EXPECT_CALL(sink1, startRail).Times(2);
+        EXPECT_CALL(sink1, setValue(SensorType::iout, 11.5)).Times(2);
+        EXPECT_CALL(sink1, endRail(false)).Times(2);
+        EXPECT_CALL(sink1, endCycle).Times(2);
+
+        MockSensors sink2{};
+        EXPECT_CALL(sink2, startCycle).Times(1);
+        EXPECT_CALL(sink2, startRail).Times(1);
+        EXPECT_CALL(sink2, setValue(SensorType::iout, 11.5)).Times(1);
+        EXPECT_CALL(sink2, endRail(false)).Times(1);
+        EXPECT_CALL(sink2, endCycle).Times(1);
+
+        CompositeSensors sensors{};
+        sensors.addSink(sink1);
+        sensors.addSink(sink2, std::chrono::milliseconds{3600000});
+        for (int i = 0; i < 2; ++i)
+        {
+            sensors.startCycle();
+            sensors.startRail("vdd0", "/reg0", "/chassis");
+            sensors.setValue(SensorType::iout, 11.5);
+            sensors.endRail(false);
+            sensors.endCycle();
+        }
+    }
+}
+
+TEST(CompositeSensorsTests, EnableDisable)
+{
+    // Sinks receive enable() and disable() outside of the cycles they
+    // receive
+    MockSensors sink1{};
+    MockSensors sink2{};
+    EXPECT_CALL(sink1, enable).Times(1);
+    EXPECT_CALL(sink2, enable).Times(1);
+    EXPECT_CALL(sink1, disable).Times(1);
+    EXPECT_CALL(sink2, disable).Times(1);
+    EXPECT_CALL(sink2, startCycle).Times(1);
+    EXPECT_CALL(sink2, endCycle).Times(1);
+
+    CompositeSensors sensors{};
+    sensors.addSink(sink1, std::chrono::milliseconds{3600000});
+    sensors.addSink(sink2);
+    sensors.enable();
+
+    // Use up the first cycle of sink1
+    EXPECT_CALL(sink1, startCycle).Times(1);
+    EXPECT_CALL(sink1, endCycle).Times(1);
+    sensors.startCycle();
+    sensors.endCycle();
+    sensors.disable();
+}
+
+TEST(CompositeSensorsTests, Exception)
+{
+    // The call is passed to the remaining sinks and the first exception is
+    // rethrown
+    MockSensors sink1{};
+    MockSensors sink2{};
+    MockSensors sink3{};
+    EXPECT_CALL(sink1, setValue)
+        .Times(1)
+        .WillOnce(Throw(std::runtime_error{"sink1 failed"}));
+    EXPECT_CALL(sink2, setValue)
+        .Times(1)
+        .WillOnce(Throw(std::logic_error{"sink2 failed"}));
+    EXPECT_CALL(sink3, setValue(SensorType::temperature, 45.0)).Times(1);
+
+    CompositeSensors sensors{};
+    sensors.addSink(sink1);
+    sensors.addSink(sink2);
+    sensors.addSink(sink3);
+    try
+    {
+        sensors.setValue(SensorType::temperature, 45.0);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::runtime_error& e)
+    {
+        EXPECT_STREQ(e.what(), "sink1 failed");
+    }
+}
@@ -0,0 +1,238 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "compressed_time_series.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace phosphor::power::regulators;
+
+using Point = CompressedTimeSeries::Point;
+
+namespace
+{
+
+/**
+ * Returns whether two points are equal, treating NaN values as equal.
+ */
+bool isSamePoint(const Point& a, const Point& b)
+{
+    return (a.timestamp == b.timestamp) &&
+           ((a.value == b.value) ||
+            (std::isnan(a.value) && std::isnan(b.value)));
+}
+
+/**
+ * Appends the specified points and verifies they are all returned.
+ */
+void verifyRoundTrip(const std::vector<Point>& expected)
+{
+    CompressedTimeSeries series{4, 256};
+    for (const Point& point : expected)
+    {
+        series.append(point.timestamp, point.value);
+    }
+    std::vector<Point> points = series.getPoints();
+    ASSERT_EQ(points.size(), expected.size());
+    for (std::size_t i = 0; i < points.size(); ++i)
+    {
+        EXPECT_TRUE(isSamePoint(points[i], expected[i])) << "index " << i;
+    }
+}
+
+} // namespace
+
+TEST(CompressedTimeSeriesTests, Constructor)
+{
+    // Test where works
+    {
+        CompressedTimeSeries series{2, CompressedTimeSeries::minBlockWords};
+        EXPECT_EQ(series.getPointCount(), 0);
+        EXPECT_TRUE(series.getPoints().empty());
+    }
+
+    // Test where fails: Too few blocks
+    EXPECT_THROW((CompressedTimeSeries{1, 64}), std::invalid_argument);
+
+    // Test where fails: Blocks too small
+    EXPECT_THROW(
+        (CompressedTimeSeries{16, CompressedTimeSeries::minBlockWords - 1}),
+        std::invalid_argument);
+}
+
+TEST(CompressedTimeSeriesTests, Append)
+{
+    // Test where timestamps are periodic and value does not change
+    {
+        std::vector<Point> points{};
+        for (int64_t i = 0; i < 500; ++i)
+        {
+            points.emplace_back(Point{1700000000000 + i * 1000, 1.1});
+        }
+        verifyRoundTrip(points);
+    }
+
+    // Test where value changes slightly
+    {
+        std::vector<Point> points{};
+        for (int64_t i = 0; i < 500; ++i)
+        {
+            points.emplace_back(
+                Point{1700000000000 + i * 1000, 1.1 + (i % 7) * 0.00125});
+        }
+        verifyRoundTrip(points);
+    }
+
+    // Test where timestamps are irregular and values change a lot
+    {
+        std::vector<Point> points{
+            {0, 0.0},
+            {1, -1.5},
+            {3, 12345.678},
+            {60, 1e-300},
+            {300, -1e300},
+            {2300, std::numeric_limits<double>::infinity()},
+            {2300, std::numeric_limits<double>::denorm_min()},
+            {1000000, 1.0},
+            {1000000000000, 2.0},
+            {1000000000001, std::nan("")},
+            {1000000001001, 3.0},
+            {std::numeric_limits<int64_t>::max(), 4.0}};
+        verifyRoundTrip(points);
+    }
+
+    // Test where timestamps are negative
+    verifyRoundTrip({{std::numeric_limits<int64_t>::min(), 1.0},
+                     {-1000, 2.0},
+                     {-1, 3.0},
+                     {0, 4.0}});
+
+    // Test where timestamp decreases: Starts a new block
+    {
+        CompressedTimeSeries series{4, 64};
+        series.append(2000, 1.0);
+        series.append(3000, 2.0);
+        series.append(1000, 3.0);
+        series.append(2000, 4.0);
+        std::vector<Point> points = series.getPoints();
+        std::vector<Point> expected{
+            {2000, 1.0}, {3000, 2.0}, {1000, 3.0}, {2000, 4.0}};
+        EXPECT_EQ(points, expected);
+    }
+
+    // Test where oldest block is discarded
+    {
+        CompressedTimeSeries series{2, CompressedTimeSeries::minBlockWords};
+        for (int64_t i = 0; i < 1000; ++i)
+        {
+            series.append(i, static_cast<double>(i));
+        }
+
+        // Newest points are returned in order without gaps
+        std::vector<Point> points = series.getPoints();
+        ASSERT_FALSE(points.empty());
+        EXPECT_LT(points.size(), 1000);
+        EXPECT_EQ(points.size(), series.getPointCount());
+        for (std::size_t i = 0; i < points.size(); ++i)
+        {
+            int64_t expected = 1000 - points.size() + i;
+            EXPECT_EQ(points[i].timestamp, expected);
+            EXPECT_EQ(points[i].value, static_cast<double>(expected));
+        }
+    }
+}
+
+TEST(CompressedTimeSeriesTests, Clear)
+{
+    CompressedTimeSeries series{4, 64};
+    series.append(1000, 1.0);
+    series.append(2000, 2.0);
+    series.clear();
+    EXPECT_EQ(series.getPointCount(), 0);
+    EXPECT_TRUE(series.getPoints().empty());
+    EXPECT_FALSE(series.getLastPoint());
+
+    series.append(500, 3.0);
+    std::vector<Point> expected{{500, 3.0}};
+    EXPECT_EQ(series.getPoints(), expected);
+}
+
+TEST(CompressedTimeSeriesTests, GetLastPoint)
+{
+    CompressedTimeSeries series{4, 64};
+    EXPECT_FALSE(series.getLastPoint());
+
+    series.append(1000, 1.0);
+    series.append(2000, 2.5);
+    EXPECT_EQ(series.getLastPoint(), (Point{2000, 2.5}));
+}
+
+TEST(CompressedTimeSeriesTests, GetPointCount)
+{
+    CompressedTimeSeries series{4, 64};
+    for (int64_t i = 0; i < 100; ++i)
+    {
+        series.append(i * 1000, 1.0);
+    }
+    EXPECT_EQ(series.getPointCount(), 100);
+}
+
+TEST(CompressedTimeSeriesTests, GetPoints)
+{
+    CompressedTimeSeries series{4, CompressedTimeSeries::minBlockWords};
+    for (int64_t i = 0; i < 10; ++i)
+    {
+        series.append(i * 1000, i * 0.5);
+    }
+
+    // Test where all points are returned
+    EXPECT_EQ(series.getPoints().size(), 10);
+
+    // Test where only recent points are returned.  The points are stored in
+    // several blocks.
+    std::vector<Point> expected{{7000, 3.5}, {8000, 4.0}, {9000, 4.5}};
+    EXPECT_EQ(series.getPoints(6500), expected);
+    EXPECT_EQ(series.getPoints(7000), expected);
+
+    // Test where no points are returned
+    EXPECT_TRUE(series.getPoints(9001).empty());
+}
+
+TEST(CompressedTimeSeriesTests, GetStorageSize)
+{
+    CompressedTimeSeries series{16, 64};
+    EXPECT_EQ(series.getStorageSize(), 16 * 64 * 8);
+
+    // Memory does not grow as points are added
+    for (int64_t i = 0; i < 100000; ++i)
+    {
+        series.append(i * 1000, std::sin(i * 0.01));
+    }
+    EXPECT_EQ(series.getStorageSize(), 16 * 64 * 8);
+
+    // Periodic unchanged values take about 2 bits each
+    series.clear();
+    for (int64_t i = 0; i < 100000; ++i)
+    {
+        series.append(i * 1000, 1.0);
+    }
+    EXPECT_GT(series.getPointCount(), 25000);
+}
@@ -0,0 +1,211 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "allocation_tracker.hpp"
+#include "chassis.hpp"
+#include "config_file_parser.hpp"
+#include "rule.hpp"
+#include "temporary_file.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+using namespace phosphor::power::regulators;
+using namespace phosphor::power::regulators::config_file_parser;
+
+namespace
+{
+
+/**
+ * Number of rails produced by each regulator device.
+ */
+constexpr std::size_t railsPerDevice{2};
+
+/**
+ * Number of regulator devices in each chassis.
+ */
+constexpr std::size_t devicesPerChassis{32};
+
+/**
+ * Returns the JSON text of a config file with the specified number of rails.
+ *
+ * The devices and rails use the same properties and rules as the standard
+ * config files: configuring the output voltage, monitoring the sensors, and
+ * detecting phase faults.
+ *
+ * @param railCount number of rails
+ * @return JSON text
+ */
+std::string createConfigFileContents(std::size_t railCount)
+{
+    std::string contents{};
+    contents += R"({
+  "comments": [ "Generated config file for benchmarks" ],
+  "rules": [
+    {
+      "id": "set_voltage_rule",
+      "actions": [
+        { "pmbus_write_vout_command": { "format": "linear" } }
+      ]
+    },
+    {
+      "id": "read_sensors_rule",
+      "actions": [
+        { "pmbus_read_sensor": { "type": "vout", "command": "0x8B", "format": "linear_16" } },
+        { "pmbus_read_sensor": { "type": "iout", "command": "0x8C", "format": "linear_11" } },
+        { "pmbus_read_sensor": { "type": "temperature", "command": "0x8D", "format": "linear_11" } }
+      ]
+    },
+    {
+      "id": "detect_phase_fault_rule",
+      "actions": [
+        { "if": { "condition": { "i2c_compare_bit": { "register": "0x7E", "position": 3, "value": 1 } },
+                  "then": [ { "log_phase_fault": { "type": "n" } } ] } }
+      ]
+    }
+  ],
+  "chassis": [)";
+
+    std::size_t deviceCount = (railCount + railsPerDevice - 1) / railsPerDevice;
+    std::size_t railIndex{0};
+    for (std::size_t deviceIndex = 0; deviceIndex < deviceCount; ++deviceIndex)
+    {
+        std::size_t chassisNumber = (deviceIndex / devicesPerChassis) + 1;
+        if ((deviceIndex % devicesPerChassis) == 0)
+        {
+            contents += (deviceIndex == 0) ? "\n" : "\n      ]\n    },\n";
+            contents += "    {\n      \"number\": " +
+                        std::to_string(chassisNumber) +
+                        ",\n      \"inventory_path\": \"system/chassis" +
+                        std::to_string(chassisNumber) +
+                        "\",\n      \"devices\": [\n";
+        }
+        else
+        {
+            contents += ",\n";
+        }
+
+        std::string deviceID = "reg" + std::to_string(deviceIndex);
+        contents += R"(        {
+          "id": ")" + deviceID +
+                    R"(",
+          "is_regulator": true,
+          "fru": "system/chassis/motherboard/)" +
+                    deviceID + R"(",
+          "i2c_interface": { "bus": )" +
+                    std::to_string(deviceIndex % 16) +
+                    R"(, "address": "0x70" },
+          "phase_fault_detection": { "rule_id": "detect_phase_fault_rule" },
+          "rails": [)";
+        for (std::size_t page = 0;
+             (page < railsPerDevice) && (railIndex < railCount);
+             ++page, ++railIndex)
+        {
+            contents += (page == 0) ? "\n" : ",\n";
+            contents += R"(            {
+              "id": "rail)" + std::to_string(railIndex) +
+                        R"(",
+              "configuration": {
+                "volts": 1.0,
+                "actions": [
+                  { "i2c_write_byte": { "register": "0x00", "value": "0x0)" +
+                        std::to_string(page) + R"(" } },
+                  { "run_rule": "set_voltage_rule" }
+                ]
+              },
+              "sensor_monitoring": {
+                "actions": [
+                  { "i2c_write_byte": { "register": "0x00", "value": "0x0)" +
+                        std::to_string(page) + R"(" } },
+                  { "run_rule": "read_sensors_rule" }
+                ]
+              }
+            })";
+        }
+        contents += "\n          ]\n        }";
+    }
+    contents += (deviceCount == 0) ? "\n" : "\n      ]\n    }\n";
+    contents += "  ]\n}\n";
+    return contents;
+}
+
+/**
+ * Parses a generated config file repeatedly and reports the parse rate and the
+ * peak heap usage.
+ *
+ * @param state benchmark state.  range(0) is the number of rails.
+ * @param parseFunction function used to parse the config file
+ */
+template <typename ParseFunction>
+void runBenchmark(benchmark::State& state, ParseFunction parseFunction)
+{
+    TemporaryFile configFile;
+    std::filesystem::path pathName{configFile.getPath()};
+    std::string contents = createConfigFileContents(state.range(0));
+    {
+        std::ofstream file{pathName};
+        file << contents;
+    }
+    contents.clear();
+    contents.shrink_to_fit();
+
+    std::size_t peakBytes{0};
+    for (auto _ : state)
+    {
+        std::size_t baseBytes = allocation_tracker::getAllocatedBytes();
+        allocation_tracker::resetPeakAllocatedBytes();
+
+        auto objects = parseFunction(pathName);
+        benchmark::DoNotOptimize(objects);
+
+        std::size_t bytes =
+            allocation_tracker::getPeakAllocatedBytes() - baseBytes;
+        peakBytes = std::max(peakBytes, bytes);
+    }
+
+    std::size_t fileSize = std::filesystem::file_size(pathName);
+    state.SetBytesProcessed(state.iterations() * fileSize);
+    state.counters["file_size"] = benchmark::Counter(
+        fileSize, benchmark::Counter::kDefaults, benchmark::Counter::kIs1024);
+    state.counters["peak_heap"] = benchmark::Counter(
+        peakBytes, benchmark::Counter::kDefaults, benchmark::Counter::kIs1024);
+}
+
+void BM_Parse(benchmark::State& state)
+{
+    runBenchmark(state, [](const std::filesystem::path& pathName) {
+        return parse(pathName);
+    });
+}
+
+void BM_ParseStreaming(benchmark::State& state)
+{
+    runBenchmark(state, [](const std::filesystem::path& pathName) {
+        return parseStreaming(pathName);
+    });
+}
+
+} // namespace
+
+BENCHMARK(BM_Parse)->RangeMultiplier(10)->Range(100, 10000);
+BENCHMARK(BM_ParseStreaming)->RangeMultiplier(10)->Range(100, 10000);
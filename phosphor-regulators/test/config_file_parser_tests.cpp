@@ -15,6 +15,7 @@
  */
 #include "action.hpp"
 #include "and_action.hpp"
+#include "bus_budget.hpp"
 #include "chassis.hpp"
 #include "compare_presence_action.hpp"
 #include "compare_vpd_action.hpp"
@@ -26,6 +27,7 @@
 #include "i2c_compare_bit_action.hpp"
 #include "i2c_compare_byte_action.hpp"
 #include "i2c_compare_bytes_action.hpp"
+#include "i2c_probe_action.hpp"
 #include "i2c_interface.hpp"
 #include "i2c_write_bit_action.hpp"
 #include "i2c_write_byte_action.hpp"
@@ -35,9 +37,12 @@
 #include "or_action.hpp"
 #include "phase_fault.hpp"
 #include "phase_fault_detection.hpp"
+#include "pmbus_read_block_sensors_action.hpp"
 #include "pmbus_read_sensor_action.hpp"
+#include "pmbus_read_sensors_action.hpp"
 #include "pmbus_utils.hpp"
 #include "pmbus_write_vout_command_action.hpp"
+#include "power_domain.hpp"
 #include "presence_detection.hpp"
 #include "rail.hpp"
 #include "rule.hpp"
@@ -51,13 +56,16 @@
 
 #include <nlohmann/json.hpp>
 
+#include <chrono>
 #include <cstdint>
 #include <cstring>
 #include <exception>
 #include <filesystem>
 #include <fstream>
+#include <iterator>
 #include <memory>
 #include <optional>
+#include <sstream>
 #include <stdexcept>
 #include <string>
 #include <tuple>
@@ -208,312 +216,1479 @@ TEST(ConfigFileParserTests, Parse)
     }
 }
 
+TEST(ConfigFileParserTests, ParseWithCache)
+{
+    const json configFileContents = R"(
+        {
+          "rules": [
+            {
+              "id": "set_voltage_rule",
+              "actions": [
+                { "pmbus_write_vout_command": { "volts": 1.03, "format": "linear" } }
+              ]
+            }
+          ],
+          "chassis": [
+            { "number": 1, "inventory_path": "system/chassis1" }
+          ]
+        }
+    )"_json;
+
+    TemporaryFile configFile;
+    std::filesystem::path pathName{configFile.getPath()};
+    std::filesystem::path cacheDirectory{pathName.string() + ".cache.d"};
+    std::filesystem::path cachePathName =
+        getCacheFilePath(pathName, cacheDirectory);
+    writeConfigFile(pathName, configFileContents);
+
+    // Test where cache file does not exist.  Cache file is created.
+    {
+        std::vector<std::unique_ptr<Rule>> rules{};
+        std::vector<std::unique_ptr<Chassis>> chassis{};
+        std::tie(rules, chassis) = parse(pathName, cacheDirectory);
+        EXPECT_EQ(rules.size(), 1);
+        EXPECT_EQ(rules[0]->getID(), "set_voltage_rule");
+        EXPECT_EQ(chassis.size(), 1);
+        EXPECT_TRUE(std::filesystem::exists(cachePathName));
+
+        std::ifstream file{pathName};
+        std::string contents{std::istreambuf_iterator<char>{file},
+                             std::istreambuf_iterator<char>{}};
+        std::optional<json> rootElement =
+            readCacheFile(cachePathName, getHash(contents));
+        ASSERT_TRUE(rootElement.has_value());
+        EXPECT_EQ(*rootElement, configFileContents);
+    }
+
+    // Test where cache file is up to date.  JSON elements obtained from cache
+    // file.
+    {
+        std::vector<std::unique_ptr<Rule>> rules{};
+        std::vector<std::unique_ptr<Chassis>> chassis{};
+        std::tie(rules, chassis) = parse(pathName, cacheDirectory);
+        EXPECT_EQ(rules.size(), 1);
+        EXPECT_EQ(rules[0]->getID(), "set_voltage_rule");
+        EXPECT_EQ(chassis.size(), 1);
+        EXPECT_EQ(chassis[0]->getNumber(), 1);
+    }
+
+    // Test where config file has changed.  Cache file is replaced.
+    {
+        const json newContents = R"(
+            {
+              "chassis": [
+                { "number": 1, "inventory_path": "system/chassis1" },
+                { "number": 2, "inventory_path": "system/chassis2" }
+              ]
+            }
+        )"_json;
+        writeConfigFile(pathName, newContents);
+
+        std::vector<std::unique_ptr<Rule>> rules{};
+        std::vector<std::unique_ptr<Chassis>> chassis{};
+        std::tie(rules, chassis) = parse(pathName, cacheDirectory);
+        EXPECT_EQ(rules.size(), 0);
+        EXPECT_EQ(chassis.size(), 2);
+
+        std::optional<json> rootElement =
+            readCacheFile(cachePathName, getHash(newContents.dump()));
+        ASSERT_TRUE(rootElement.has_value());
+        EXPECT_EQ(*rootElement, newContents);
+    }
+
+    // Test where cache file is corrupted.  Config file is parsed.
+    {
+        writeConfigFile(cachePathName, std::string{"not a cache file"});
+
+        std::vector<std::unique_ptr<Rule>> rules{};
+        std::vector<std::unique_ptr<Chassis>> chassis{};
+        std::tie(rules, chassis) = parse(pathName, cacheDirectory);
+        EXPECT_EQ(chassis.size(), 2);
+    }
+
+    // Test where config file is invalid.  Cache file is not written.
+    try
+    {
+        writeConfigFile(pathName, std::string{"{ \"chassis\": 1 }"});
+        std::filesystem::remove(cachePathName);
+        parse(pathName, cacheDirectory);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const ConfigFileParserError& e)
+    {
+        EXPECT_FALSE(std::filesystem::exists(cachePathName));
+    }
+
+    std::filesystem::remove_all(cacheDirectory);
+}
+
+TEST(ConfigFileParserTests, ParseCompiledConfig)
+{
+    // Test where works
+    {
+        const json configFileContents = R"(
+            {
+              "rules": [
+                {
+                  "id": "set_voltage_rule",
+                  "actions": [
+                    { "pmbus_write_vout_command": { "volts": 1.03, "format": "linear" } }
+                  ]
+                }
+              ],
+              "chassis": [
+                { "number": 1, "inventory_path": "system/chassis1" },
+                { "number": 2, "inventory_path": "system/chassis2" }
+              ]
+            }
+        )"_json;
+        std::vector<uint8_t> data = json::to_cbor(configFileContents);
+        CompiledConfig config{"test.json", data.data(), data.size()};
+
+        std::vector<std::unique_ptr<Rule>> rules{};
+        std::vector<std::unique_ptr<Chassis>> chassis{};
+        std::tie(rules, chassis) = parse(config);
+
+        EXPECT_EQ(rules.size(), 1);
+        EXPECT_EQ(rules[0]->getID(), "set_voltage_rule");
+
+        EXPECT_EQ(chassis.size(), 2);
+        EXPECT_EQ(chassis[0]->getNumber(), 1);
+        EXPECT_EQ(chassis[1]->getInventoryPath(),
+                  "/xyz/openbmc_project/inventory/system/chassis2");
+    }
+
+    // Test where fails: CBOR data is invalid
+    try
+    {
+        std::vector<uint8_t> data{0xff, 0x01};
+        CompiledConfig config{"test.json", data.data(), data.size()};
+        parse(config);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const ConfigFileParserError& e)
+    {
+        // Expected exception; what() message will vary
+    }
+
+    // Test where fails: Config file is invalid
+    try
+    {
+        std::vector<uint8_t> data = json::to_cbor(R"({ "chassis": 1 })"_json);
+        CompiledConfig config{"test.json", data.data(), data.size()};
+        parse(config);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const ConfigFileParserError& e)
+    {
+        EXPECT_STREQ(e.what(), "ConfigFileParserError: test.json: Element is "
+                               "not an array");
+    }
+}
+
+TEST(ConfigFileParserTests, ParseDeferred)
+{
+    // Test where works
+    {
+        const json configFileContents = R"(
+            {
+              "rules": [
+                {
+                  "id": "set_voltage_rule",
+                  "actions": [
+                    { "pmbus_write_vout_command": { "volts": 1.03, "format": "linear" } }
+                  ]
+                }
+              ],
+              "chassis": [
+                {
+                  "number": 1,
+                  "inventory_path": "system/chassis1",
+                  "devices": [
+                    {
+                      "id": "vdd_regulator",
+                      "is_regulator": true,
+                      "fru": "system/chassis1/motherboard/regulator2",
+                      "i2c_interface": { "bus": 1, "address": "0x70" },
+                      "rails": [ { "id": "vdd" } ]
+                    }
+                  ]
+                },
+                { "number": 2, "inventory_path": "system/chassis2" }
+              ]
+            }
+        )"_json;
+
+        TemporaryFile configFile;
+        std::filesystem::path pathName{configFile.getPath()};
+        writeConfigFile(pathName, configFileContents);
+
+        std::vector<std::unique_ptr<Rule>> rules{};
+        std::vector<DeferredChassis> chassis{};
+        std::tie(rules, chassis) = parseDeferred(pathName);
+
+        EXPECT_EQ(rules.size(), 1);
+        EXPECT_EQ(rules[0]->getID(), "set_voltage_rule");
+
+        EXPECT_EQ(chassis.size(), 2);
+        EXPECT_EQ(chassis[0].number, 1);
+        EXPECT_EQ(chassis[0].inventoryPath,
+                  "/xyz/openbmc_project/inventory/system/chassis1");
+        EXPECT_EQ(json::from_cbor(chassis[0].data),
+                  configFileContents["chassis"][0]);
+        EXPECT_EQ(chassis[1].number, 2);
+        EXPECT_EQ(chassis[1].inventoryPath,
+                  "/xyz/openbmc_project/inventory/system/chassis2");
+    }
+
+    // Test where fails: File does not exist
+    try
+    {
+        std::filesystem::path pathName{"/tmp/non_existent_file"};
+        parseDeferred(pathName);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const ConfigFileParserError& e)
+    {
+        // Expected exception; what() message will vary
+    }
+
+    // Test where fails: Error when parsing rule element
+    try
+    {
+        const json configFileContents = R"(
+            {
+              "rules": [ { "id": "set_voltage_rule" } ],
+              "chassis": [
+                { "number": 1, "inventory_path": "system/chassis1" }
+              ]
+            }
+        )"_json;
+
+        TemporaryFile configFile;
+        std::filesystem::path pathName{configFile.getPath()};
+        writeConfigFile(pathName, configFileContents);
+
+        parseDeferred(pathName);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const ConfigFileParserError& e)
+    {
+        // Expected exception; what() message will vary
+    }
+
+    // Test where fails: Error when parsing chassis number
+    try
+    {
+        const json configFileContents = R"(
+            {
+              "chassis": [
+                { "number": 0, "inventory_path": "system/chassis1" }
+              ]
+            }
+        )"_json;
+
+        TemporaryFile configFile;
+        std::filesystem::path pathName{configFile.getPath()};
+        writeConfigFile(pathName, configFileContents);
+
+        parseDeferred(pathName);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const ConfigFileParserError& e)
+    {
+        // Expected exception; what() message will vary
+    }
+}
+
+TEST(ConfigFileParserTests, ParseDeferredChassis)
+{
+    // Test where works
+    {
+        const json element = R"(
+            {
+              "number": 1,
+              "inventory_path": "system/chassis1",
+              "devices": [
+                {
+                  "id": "vdd_regulator",
+                  "is_regulator": true,
+                  "fru": "system/chassis1/motherboard/regulator2",
+                  "i2c_interface": { "bus": 1, "address": "0x70" }
+                }
+              ]
+            }
+        )"_json;
+        DeferredChassis deferred = deferChassis(element);
+        std::unique_ptr<Chassis> chassis = parseDeferredChassis(deferred);
+        EXPECT_EQ(chassis->getNumber(), 1);
+        EXPECT_EQ(chassis->getInventoryPath(),
+                  "/xyz/openbmc_project/inventory/system/chassis1");
+        EXPECT_EQ(chassis->getDevices().size(), 1);
+        EXPECT_EQ(chassis->getDevices()[0]->getID(), "vdd_regulator");
+    }
+
+    // Test where fails: Invalid property specified.  Only detected when the
+    // chassis is parsed.
+    try
+    {
+        const json element = R"(
+            {
+              "number": 1,
+              "inventory_path": "system/chassis1",
+              "foo": 2
+            }
+        )"_json;
+        DeferredChassis deferred = deferChassis(element);
+        parseDeferredChassis(deferred);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Element contains an invalid property");
+    }
+}
+
+TEST(ConfigFileParserTests, ParseStreaming)
+{
+    // Test where works
+    {
+        const json configFileContents = R"(
+            {
+              "comments": [ "Config file for a FooBar two-chassis system" ],
+              "rules": [
+                {
+                  "id": "set_voltage_rule1",
+                  "actions": [
+                    { "pmbus_write_vout_command": { "volts": 1.03, "format": "linear" } }
+                  ]
+                },
+                {
+                  "id": "set_voltage_rule2",
+                  "actions": [
+                    { "pmbus_write_vout_command": { "volts": 1.33, "format": "linear" } }
+                  ]
+                }
+              ],
+              "chassis": [
+                {
+                  "number": 1,
+                  "inventory_path": "system/chassis1",
+                  "devices": [
+                    {
+                      "id": "vdd_regulator",
+                      "is_regulator": true,
+                      "fru": "system/chassis1/motherboard/regulator2",
+                      "i2c_interface": { "bus": 1, "address": "0x70" },
+                      "rails": [ { "id": "vdd" }, { "id": "vio" } ]
+                    }
+                  ]
+                },
+                { "number": 2, "inventory_path": "system/chassis2" }
+              ]
+            }
+        )"_json;
+
+        TemporaryFile configFile;
+        std::filesystem::path pathName{configFile.getPath()};
+        writeConfigFile(pathName, configFileContents);
+
+        std::vector<std::unique_ptr<Rule>> rules{};
+        std::vector<std::unique_ptr<Chassis>> chassis{};
+        std::tie(rules, chassis) = parseStreaming(pathName);
+
+        EXPECT_EQ(rules.size(), 2);
+        EXPECT_EQ(rules[0]->getID(), "set_voltage_rule1");
+        EXPECT_EQ(rules[1]->getID(), "set_voltage_rule2");
+
+        EXPECT_EQ(chassis.size(), 2);
+        EXPECT_EQ(chassis[0]->getNumber(), 1);
+        EXPECT_EQ(chassis[0]->getInventoryPath(),
+                  "/xyz/openbmc_project/inventory/system/chassis1");
+        EXPECT_EQ(chassis[0]->getDevices().size(), 1);
+        EXPECT_EQ(chassis[0]->getDevices()[0]->getID(), "vdd_regulator");
+        EXPECT_EQ(chassis[0]->getDevices()[0]->getRails().size(), 2);
+        EXPECT_EQ(chassis[1]->getNumber(), 2);
+        EXPECT_EQ(chassis[1]->getInventoryPath(),
+                  "/xyz/openbmc_project/inventory/system/chassis2");
+    }
+
+    // Test where fails: File does not exist
+    try
+    {
+        std::filesystem::path pathName{"/tmp/non_existent_file"};
+        parseStreaming(pathName);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const ConfigFileParserError& e)
+    {
+        // Expected exception; what() message will vary
+    }
+
+    // Test where fails: File is not valid JSON
+    try
+    {
+        const std::string configFileContents = "] foo [";
+
+        TemporaryFile configFile;
+        std::filesystem::path pathName{configFile.getPath()};
+        writeConfigFile(pathName, configFileContents);
+
+        parseStreaming(pathName);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const ConfigFileParserError& e)
+    {
+        // Expected exception; what() message will vary
+    }
+
+    // Test where fails: Error when parsing JSON elements
+    try
+    {
+        const json configFileContents = R"( { "foo": "bar" } )"_json;
+
+        TemporaryFile configFile;
+        std::filesystem::path pathName{configFile.getPath()};
+        writeConfigFile(pathName, configFileContents);
+
+        parseStreaming(pathName);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const ConfigFileParserError& e)
+    {
+        // Expected exception; what() message will vary
+    }
+}
+
+TEST(ConfigFileParserTests, DeferChassis)
+{
+    // Test where works
+    {
+        const json element = R"(
+            {
+              "comments": [ "IO chassis" ],
+              "number": 2,
+              "inventory_path": "system/chassis2",
+              "devices": [ { "id": "vdd_regulator" } ]
+            }
+        )"_json;
+        DeferredChassis chassis = deferChassis(element);
+        EXPECT_EQ(chassis.number, 2);
+        EXPECT_EQ(chassis.inventoryPath,
+                  "/xyz/openbmc_project/inventory/system/chassis2");
+        EXPECT_EQ(json::from_cbor(chassis.data), element);
+    }
+
+    // Test where fails: Element is not an object
+    try
+    {
+        const json element = R"( [ "0xFF", "0x01" ] )"_json;
+        deferChassis(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Element is not an object");
+    }
+
+    // Test where fails: Required number property not specified
+    try
+    {
+        const json element = R"( { "inventory_path": "system/chassis" } )"_json;
+        deferChassis(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Required property missing: number");
+    }
+
+    // Test where fails: Invalid number
+    try
+    {
+        const json element = R"(
+            { "number": 0, "inventory_path": "system/chassis" }
+        )"_json;
+        deferChassis(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Invalid chassis number: Must be > 0");
+    }
+
+    // Test where fails: Required inventory_path property not specified
+    try
+    {
+        const json element = R"( { "number": 1 } )"_json;
+        deferChassis(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Required property missing: inventory_path");
+    }
+}
+
+TEST(ConfigFileParserTests, GetCacheFilePath)
+{
+    EXPECT_EQ(getCacheFilePath("/usr/share/phosphor-regulators/config.json",
+                               "/var/lib/phosphor-regulators"),
+              "/var/lib/phosphor-regulators/config.json.cache");
+}
+
+TEST(ConfigFileParserTests, GetHash)
+{
+    // FNV-1a test vectors
+    EXPECT_EQ(getHash(""), 0xcbf29ce484222325);
+    EXPECT_EQ(getHash("a"), 0xaf63dc4c8601ec8c);
+
+    // Different contents result in different hashes
+    EXPECT_NE(getHash("{ \"chassis\": [] }"), getHash("{ \"chassis\": [ ] }"));
+}
+
 TEST(ConfigFileParserTests, GetRequiredProperty)
 {
-    // Test where property exists
+    // Test where property exists
+    {
+        const json element = R"( { "format": "linear" } )"_json;
+        const json& propertyElement = getRequiredProperty(element, "format");
+        EXPECT_EQ(propertyElement.get<std::string>(), "linear");
+    }
+
+    // Test where property does not exist
+    try
+    {
+        const json element = R"( { "volts": 1.03 } )"_json;
+        getRequiredProperty(element, "format");
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Required property missing: format");
+    }
+}
+
+TEST(ConfigFileParserTests, ParseAction)
+{
+    // Test where works: comments property specified
+    {
+        const json element = R"(
+            {
+              "comments": [ "Set output voltage." ],
+              "pmbus_write_vout_command": {
+                "format": "linear"
+              }
+            }
+        )"_json;
+        std::unique_ptr<Action> action = parseAction(element);
+        EXPECT_NE(action.get(), nullptr);
+    }
+
+    // Test where works: comments property not specified
+    {
+        const json element = R"(
+            {
+              "pmbus_write_vout_command": {
+                "format": "linear"
+              }
+            }
+        )"_json;
+        std::unique_ptr<Action> action = parseAction(element);
+        EXPECT_NE(action.get(), nullptr);
+    }
+
+    // Test where works: and action type specified
+    {
+        const json element = R"(
+            {
+              "and": [
+                { "i2c_compare_byte": { "register": "0xA0", "value": "0x00" } },
+                { "i2c_compare_byte": { "register": "0xA1", "value": "0x00" } }
+              ]
+            }
+        )"_json;
+        std::unique_ptr<Action> action = parseAction(element);
+        EXPECT_NE(action.get(), nullptr);
+    }
+
+    // Test where works: compare_presence action type specified
+    {
+        const json element = R"(
+            {
+              "compare_presence":
+              {
+                "fru": "system/chassis/motherboard/cpu3",
+                "value": true
+              }
+            }
+        )"_json;
+        std::unique_ptr<Action> action = parseAction(element);
+        EXPECT_NE(action.get(), nullptr);
+    }
+
+    // Test where works: compare_vpd action type specified
+    {
+        const json element = R"(
+            {
+              "compare_vpd":
+              {
+                "fru": "system/chassis/disk_backplane",
+                "keyword": "CCIN",
+                "value": "2D35"
+              }
+            }
+        )"_json;
+        std::unique_ptr<Action> action = parseAction(element);
+        EXPECT_NE(action.get(), nullptr);
+    }
+
+    // Test where works: i2c_capture_bytes action type specified
+    {
+        const json element = R"(
+            {
+              "i2c_capture_bytes": {
+                "register": "0xA0",
+                "count": 2
+              }
+            }
+        )"_json;
+        std::unique_ptr<Action> action = parseAction(element);
+        EXPECT_NE(action.get(), nullptr);
+    }
+
+    // Test where works: i2c_compare_bit action type specified
+    {
+        const json element = R"(
+            {
+              "i2c_compare_bit": {
+                "register": "0xA0",
+                "position": 3,
+                "value": 0
+              }
+            }
+        )"_json;
+        std::unique_ptr<Action> action = parseAction(element);
+        EXPECT_NE(action.get(), nullptr);
+    }
+
+    // Test where works: i2c_compare_byte action type specified
+    {
+        const json element = R"(
+            {
+              "i2c_compare_byte": {
+                "register": "0x0A",
+                "value": "0xCC"
+              }
+            }
+        )"_json;
+        std::unique_ptr<Action> action = parseAction(element);
+        EXPECT_NE(action.get(), nullptr);
+    }
+
+    // Test where works: i2c_compare_bytes action type specified
+    {
+        const json element = R"(
+            {
+              "i2c_compare_bytes": {
+                "register": "0x0A",
+                "values": [ "0xCC", "0xFF" ]
+              }
+            }
+        )"_json;
+        std::unique_ptr<Action> action = parseAction(element);
+        EXPECT_NE(action.get(), nullptr);
+    }
+
+    // Test where works: i2c_probe action type specified
+    {
+        const json element = R"(
+            {
+              "i2c_probe": {}
+            }
+        )"_json;
+        std::unique_ptr<Action> action = parseAction(element);
+        EXPECT_NE(action.get(), nullptr);
+    }
+
+    // Test where works: i2c_write_bit action type specified
+    {
+        const json element = R"(
+            {
+              "i2c_write_bit": {
+                "register": "0xA0",
+                "position": 3,
+                "value": 0
+              }
+            }
+        )"_json;
+        std::unique_ptr<Action> action = parseAction(element);
+        EXPECT_NE(action.get(), nullptr);
+    }
+
+    // Test where works: i2c_write_byte action type specified
+    {
+        const json element = R"(
+            {
+              "i2c_write_byte": {
+                "register": "0x0A",
+                "value": "0xCC"
+              }
+            }
+        )"_json;
+        std::unique_ptr<Action> action = parseAction(element);
+        EXPECT_NE(action.get(), nullptr);
+    }
+
+    // Test where works: i2c_write_bytes action type specified
+    {
+        const json element = R"(
+            {
+              "i2c_write_bytes": {
+                "register": "0x0A",
+                "values": [ "0xCC", "0xFF" ]
+              }
+            }
+        )"_json;
+        std::unique_ptr<Action> action = parseAction(element);
+        EXPECT_NE(action.get(), nullptr);
+    }
+
+    // Test where works: if action type specified
+    {
+        const json element = R"(
+            {
+              "if":
+              {
+                "condition": { "run_rule": "is_downlevel_regulator" },
+                "then": [ { "run_rule": "configure_downlevel_regulator" } ],
+                "else": [ { "run_rule": "configure_standard_regulator" } ]
+              }
+            }
+        )"_json;
+        std::unique_ptr<Action> action = parseAction(element);
+        EXPECT_NE(action.get(), nullptr);
+    }
+
+    // Test where works: log_phase_fault action type specified
+    {
+        const json element = R"(
+            {
+              "log_phase_fault": {
+                "type": "n+1"
+              }
+            }
+        )"_json;
+        std::unique_ptr<Action> action = parseAction(element);
+        EXPECT_NE(action.get(), nullptr);
+    }
+
+    // Test where works: not action type specified
+    {
+        const json element = R"(
+            {
+              "not":
+              { "i2c_compare_byte": { "register": "0xA0", "value": "0xFF" } }
+            }
+        )"_json;
+        std::unique_ptr<Action> action = parseAction(element);
+        EXPECT_NE(action.get(), nullptr);
+    }
+
+    // Test where works: or action type specified
+    {
+        const json element = R"(
+            {
+              "or": [
+                { "i2c_compare_byte": { "register": "0xA0", "value": "0x00" } },
+                { "i2c_compare_byte": { "register": "0xA1", "value": "0x00" } }
+              ]
+            }
+        )"_json;
+        std::unique_ptr<Action> action = parseAction(element);
+        EXPECT_NE(action.get(), nullptr);
+    }
+
+    // Test where works: pmbus_read_block_sensors action type specified
+    {
+        const json element = R"(
+            {
+              "pmbus_read_block_sensors": {
+                "command": "0xD8",
+                "sensors": [
+                  { "type": "iout", "offset": 2, "format": "linear_11" }
+                ]
+              }
+            }
+        )"_json;
+        std::unique_ptr<Action> action = parseAction(element);
+        EXPECT_NE(action.get(), nullptr);
+    }
+
+    // Test where works: pmbus_read_sensor action type specified
+    {
+        const json element = R"(
+            {
+              "pmbus_read_sensor": {
+                "type": "iout",
+                "command": "0x8C",
+                "format": "linear_11"
+              }
+            }
+        )"_json;
+        std::unique_ptr<Action> action = parseAction(element);
+        EXPECT_NE(action.get(), nullptr);
+    }
+
+    // Test where works: pmbus_read_sensors action type specified
+    {
+        const json element = R"(
+            {
+              "pmbus_read_sensors": {
+                "sensors": [
+                  { "type": "iout", "command": "0x8C", "format": "linear_11" }
+                ]
+              }
+            }
+        )"_json;
+        std::unique_ptr<Action> action = parseAction(element);
+        EXPECT_NE(action.get(), nullptr);
+    }
+
+    // Test where works: pmbus_write_vout_command action type specified
+    {
+        const json element = R"(
+            {
+              "pmbus_write_vout_command": {
+                "format": "linear"
+              }
+            }
+        )"_json;
+        std::unique_ptr<Action> action = parseAction(element);
+        EXPECT_NE(action.get(), nullptr);
+    }
+
+    // Test where works: run_rule action type specified
+    {
+        const json element = R"(
+            {
+              "run_rule": "set_voltage_rule"
+            }
+        )"_json;
+        std::unique_ptr<Action> action = parseAction(element);
+        EXPECT_NE(action.get(), nullptr);
+    }
+
+    // Test where works: set_device action type specified
+    {
+        const json element = R"(
+            {
+              "set_device": "io_expander2"
+            }
+        )"_json;
+        std::unique_ptr<Action> action = parseAction(element);
+        EXPECT_NE(action.get(), nullptr);
+    }
+
+    // Test where fails: Element is not an object
+    try
+    {
+        const json element = R"( [ "0xFF", "0x01" ] )"_json;
+        parseAction(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Element is not an object");
+    }
+
+    // Test where fails: No action type specified
+    try
+    {
+        const json element = R"(
+            {
+              "comments": [ "Set output voltage." ]
+            }
+        )"_json;
+        parseAction(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Required action type property missing");
+    }
+
+    // Test where fails: Multiple action types specified
+    try
+    {
+        const json element = R"(
+            {
+              "pmbus_write_vout_command": { "format": "linear" },
+              "run_rule": "set_voltage_rule"
+            }
+        )"_json;
+        parseAction(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Element contains an invalid property");
+    }
+
+    // Test where fails: Invalid property specified
+    try
+    {
+        const json element = R"(
+            {
+              "remarks": [ "Set output voltage." ],
+              "pmbus_write_vout_command": {
+                "format": "linear"
+              }
+            }
+        )"_json;
+        parseAction(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Element contains an invalid property");
+    }
+}
+
+TEST(ConfigFileParserTests, ParseActionArray)
+{
+    // Test where works
+    {
+        const json element = R"(
+            [
+              { "pmbus_write_vout_command": { "volts": 1.01, "format": "linear" } },
+              { "pmbus_write_vout_command": { "volts": 1.03, "format": "linear" } }
+            ]
+        )"_json;
+        std::vector<std::unique_ptr<Action>> actions =
+            parseActionArray(element);
+        EXPECT_EQ(actions.size(), 2);
+    }
+
+    // Test where fails: Element is not an array
+    try
+    {
+        const json element = R"(
+            {
+              "foo": "bar"
+            }
+        )"_json;
+        parseActionArray(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Element is not an array");
+    }
+}
+
+TEST(ConfigFileParserTests, ParseAdaptiveInterval)
+{
+    // Test where works: Only required properties specified
     {
-        const json element = R"( { "format": "linear" } )"_json;
-        const json& propertyElement = getRequiredProperty(element, "format");
-        EXPECT_EQ(propertyElement.get<std::string>(), "linear");
+        const json element = R"(
+            {
+              "min_interval_ms": 250
+            }
+        )"_json;
+        AdaptiveInterval adaptiveInterval = parseAdaptiveInterval(element);
+        EXPECT_EQ(adaptiveInterval.minInterval, std::chrono::milliseconds{250});
+        EXPECT_EQ(adaptiveInterval.changePercent, 1.0);
     }
 
-    // Test where property does not exist
+    // Test where works: All properties specified
+    {
+        const json element = R"(
+            {
+              "comments": [ "comments property" ],
+              "min_interval_ms": 500,
+              "change_percent": 2.5
+            }
+        )"_json;
+        AdaptiveInterval adaptiveInterval = parseAdaptiveInterval(element);
+        EXPECT_EQ(adaptiveInterval.minInterval, std::chrono::milliseconds{500});
+        EXPECT_EQ(adaptiveInterval.changePercent, 2.5);
+    }
+
+    // Test where fails: Element is not an object
     try
     {
-        const json element = R"( { "volts": 1.03 } )"_json;
-        getRequiredProperty(element, "format");
+        const json element = R"( [ "foo", "bar" ] )"_json;
+        parseAdaptiveInterval(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Required property missing: format");
+        EXPECT_STREQ(e.what(), "Element is not an object");
+    }
+
+    // Test where fails: Required min_interval_ms property not specified
+    try
+    {
+        const json element = R"(
+            {
+              "change_percent": 2.5
+            }
+        )"_json;
+        parseAdaptiveInterval(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Required property missing: min_interval_ms");
+    }
+
+    // Test where fails: min_interval_ms value is invalid
+    try
+    {
+        const json element = R"(
+            {
+              "min_interval_ms": -1
+            }
+        )"_json;
+        parseAdaptiveInterval(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Element is not an unsigned integer");
+    }
+
+    // Test where fails: change_percent value is invalid
+    try
+    {
+        const json element = R"(
+            {
+              "min_interval_ms": 250,
+              "change_percent": 0
+            }
+        )"_json;
+        parseAdaptiveInterval(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Invalid change_percent value: Must be > 0");
+    }
+
+    // Test where fails: Invalid property specified
+    try
+    {
+        const json element = R"(
+            {
+              "min_interval_ms": 250,
+              "foo": 1
+            }
+        )"_json;
+        parseAdaptiveInterval(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Element contains an invalid property");
     }
 }
 
-TEST(ConfigFileParserTests, ParseAction)
+TEST(ConfigFileParserTests, ParseAnd)
 {
-    // Test where works: comments property specified
+    // Test where works: Element is an array with 2 actions
+    {
+        const json element = R"(
+            [
+              { "i2c_compare_byte": { "register": "0xA0", "value": "0x00" } },
+              { "i2c_compare_byte": { "register": "0xA1", "value": "0x00" } }
+            ]
+        )"_json;
+        std::unique_ptr<AndAction> action = parseAnd(element);
+        EXPECT_EQ(action->getActions().size(), 2);
+    }
+
+    // Test where fails: Element is an array with 1 action
+    try
+    {
+        const json element = R"(
+            [
+              { "i2c_compare_byte": { "register": "0xA0", "value": "0x00" } }
+            ]
+        )"_json;
+        parseAnd(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Array must contain two or more actions");
+    }
+
+    // Test where fails: Element is not an array
+    try
     {
         const json element = R"(
             {
-              "comments": [ "Set output voltage." ],
-              "pmbus_write_vout_command": {
-                "format": "linear"
-              }
+              "foo": "bar"
             }
         )"_json;
-        std::unique_ptr<Action> action = parseAction(element);
-        EXPECT_NE(action.get(), nullptr);
+        parseAnd(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Element is not an array");
+    }
+}
+
+TEST(ConfigFileParserTests, ParseBitPosition)
+{
+    // Test where works: 0
+    {
+        const json element = R"( 0 )"_json;
+        uint8_t value = parseBitPosition(element);
+        EXPECT_EQ(value, 0);
+    }
+
+    // Test where works: 7
+    {
+        const json element = R"( 7 )"_json;
+        uint8_t value = parseBitPosition(element);
+        EXPECT_EQ(value, 7);
+    }
+
+    // Test where fails: Element is not an integer
+    try
+    {
+        const json element = R"( 1.03 )"_json;
+        parseBitPosition(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Element is not an integer");
+    }
+
+    // Test where fails: Value < 0
+    try
+    {
+        const json element = R"( -1 )"_json;
+        parseBitPosition(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Element is not a bit position");
+    }
+
+    // Test where fails: Value > 7
+    try
+    {
+        const json element = R"( 8 )"_json;
+        parseBitPosition(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Element is not a bit position");
+    }
+}
+
+TEST(ConfigFileParserTests, ParseBitValue)
+{
+    // Test where works: 0
+    {
+        const json element = R"( 0 )"_json;
+        uint8_t value = parseBitValue(element);
+        EXPECT_EQ(value, 0);
+    }
+
+    // Test where works: 1
+    {
+        const json element = R"( 1 )"_json;
+        uint8_t value = parseBitValue(element);
+        EXPECT_EQ(value, 1);
+    }
+
+    // Test where fails: Element is not an integer
+    try
+    {
+        const json element = R"( 0.5 )"_json;
+        parseBitValue(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Element is not an integer");
+    }
+
+    // Test where fails: Value < 0
+    try
+    {
+        const json element = R"( -1 )"_json;
+        parseBitValue(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Element is not a bit value");
+    }
+
+    // Test where fails: Value > 1
+    try
+    {
+        const json element = R"( 2 )"_json;
+        parseBitValue(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Element is not a bit value");
+    }
+}
+
+TEST(ConfigFileParserTests, ParseBoolean)
+{
+    // Test where works: true
+    {
+        const json element = R"( true )"_json;
+        bool value = parseBoolean(element);
+        EXPECT_EQ(value, true);
     }
 
-    // Test where works: comments property not specified
+    // Test where works: false
     {
-        const json element = R"(
-            {
-              "pmbus_write_vout_command": {
-                "format": "linear"
-              }
-            }
-        )"_json;
-        std::unique_ptr<Action> action = parseAction(element);
-        EXPECT_NE(action.get(), nullptr);
+        const json element = R"( false )"_json;
+        bool value = parseBoolean(element);
+        EXPECT_EQ(value, false);
     }
 
-    // Test where works: and action type specified
+    // Test where fails: Element is not a boolean
+    try
     {
-        const json element = R"(
-            {
-              "and": [
-                { "i2c_compare_byte": { "register": "0xA0", "value": "0x00" } },
-                { "i2c_compare_byte": { "register": "0xA1", "value": "0x00" } }
-              ]
-            }
-        )"_json;
-        std::unique_ptr<Action> action = parseAction(element);
-        EXPECT_NE(action.get(), nullptr);
+        const json element = R"( 1 )"_json;
+        parseBoolean(element);
+        ADD_FAILURE() << "Should not have reached this line.";
     }
-
-    // Test where works: compare_presence action type specified
+    catch (const std::invalid_argument& e)
     {
-        const json element = R"(
-            {
-              "compare_presence":
-              {
-                "fru": "system/chassis/motherboard/cpu3",
-                "value": true
-              }
-            }
-        )"_json;
-        std::unique_ptr<Action> action = parseAction(element);
-        EXPECT_NE(action.get(), nullptr);
+        EXPECT_STREQ(e.what(), "Element is not a boolean");
     }
+}
 
-    // Test where works: compare_vpd action type specified
+TEST(ConfigFileParserTests, ParseChassis)
+{
+    // Test where works: Only required properties specified
     {
         const json element = R"(
             {
-              "compare_vpd":
-              {
-                "fru": "system/chassis/disk_backplane",
-                "keyword": "CCIN",
-                "value": "2D35"
-              }
+              "number": 1,
+              "inventory_path": "system/chassis1"
             }
         )"_json;
-        std::unique_ptr<Action> action = parseAction(element);
-        EXPECT_NE(action.get(), nullptr);
+        std::unique_ptr<Chassis> chassis = parseChassis(element);
+        EXPECT_EQ(chassis->getNumber(), 1);
+        EXPECT_EQ(chassis->getInventoryPath(),
+                  "/xyz/openbmc_project/inventory/system/chassis1");
+        EXPECT_EQ(chassis->getDevices().size(), 0);
+        EXPECT_FALSE(chassis->isParallelConfiguration());
     }
 
-    // Test where works: i2c_capture_bytes action type specified
+    // Test where works: All properties specified
     {
         const json element = R"(
             {
-              "i2c_capture_bytes": {
-                "register": "0xA0",
-                "count": 2
-              }
+              "comments": [ "comments property" ],
+              "number": 2,
+              "inventory_path": "system/chassis2",
+              "devices": [
+                {
+                  "id": "vdd_regulator",
+                  "is_regulator": true,
+                  "fru": "system/chassis/motherboard/regulator2",
+                  "i2c_interface":
+                  {
+                      "bus": 1,
+                      "address": "0x70"
+                  }
+                }
+              ],
+              "parallel_configuration": true,
+              "independent_monitoring": true,
+              "deferred_write_verification": true
             }
         )"_json;
-        std::unique_ptr<Action> action = parseAction(element);
-        EXPECT_NE(action.get(), nullptr);
+        std::unique_ptr<Chassis> chassis = parseChassis(element);
+        EXPECT_EQ(chassis->getNumber(), 2);
+        EXPECT_EQ(chassis->getInventoryPath(),
+                  "/xyz/openbmc_project/inventory/system/chassis2");
+        EXPECT_EQ(chassis->getDevices().size(), 1);
+        EXPECT_EQ(chassis->getDevices()[0]->getID(), "vdd_regulator");
+        EXPECT_TRUE(chassis->isParallelConfiguration());
+        EXPECT_TRUE(chassis->isIndependentMonitoring());
+        EXPECT_TRUE(chassis->isWriteVerificationDeferred());
     }
 
-    // Test where works: i2c_compare_bit action type specified
+    // Test where fails: deferred_write_verification value is invalid
+    try
     {
         const json element = R"(
             {
-              "i2c_compare_bit": {
-                "register": "0xA0",
-                "position": 3,
-                "value": 0
-              }
+              "number": 1,
+              "inventory_path": "system/chassis",
+              "deferred_write_verification": "yes"
             }
         )"_json;
-        std::unique_ptr<Action> action = parseAction(element);
-        EXPECT_NE(action.get(), nullptr);
+        parseChassis(element);
+        ADD_FAILURE() << "Should not have reached this line.";
     }
-
-    // Test where works: i2c_compare_byte action type specified
+    catch (const std::invalid_argument& e)
     {
-        const json element = R"(
-            {
-              "i2c_compare_byte": {
-                "register": "0x0A",
-                "value": "0xCC"
-              }
-            }
-        )"_json;
-        std::unique_ptr<Action> action = parseAction(element);
-        EXPECT_NE(action.get(), nullptr);
+        EXPECT_STREQ(e.what(), "Element is not a boolean");
     }
 
-    // Test where works: i2c_compare_bytes action type specified
+    // Test where fails: independent_monitoring value is invalid
+    try
     {
         const json element = R"(
             {
-              "i2c_compare_bytes": {
-                "register": "0x0A",
-                "values": [ "0xCC", "0xFF" ]
-              }
+              "number": 1,
+              "inventory_path": "system/chassis",
+              "independent_monitoring": 1
             }
         )"_json;
-        std::unique_ptr<Action> action = parseAction(element);
-        EXPECT_NE(action.get(), nullptr);
+        parseChassis(element);
+        ADD_FAILURE() << "Should not have reached this line.";
     }
-
-    // Test where works: i2c_write_bit action type specified
+    catch (const std::invalid_argument& e)
     {
-        const json element = R"(
-            {
-              "i2c_write_bit": {
-                "register": "0xA0",
-                "position": 3,
-                "value": 0
-              }
-            }
-        )"_json;
-        std::unique_ptr<Action> action = parseAction(element);
-        EXPECT_NE(action.get(), nullptr);
+        EXPECT_STREQ(e.what(), "Element is not a boolean");
     }
 
-    // Test where works: i2c_write_byte action type specified
+    // Test where fails: parallel_configuration value is invalid
+    try
     {
         const json element = R"(
             {
-              "i2c_write_byte": {
-                "register": "0x0A",
-                "value": "0xCC"
-              }
+              "number": 1,
+              "inventory_path": "system/chassis",
+              "parallel_configuration": 1
             }
         )"_json;
-        std::unique_ptr<Action> action = parseAction(element);
-        EXPECT_NE(action.get(), nullptr);
+        parseChassis(element);
+        ADD_FAILURE() << "Should not have reached this line.";
     }
-
-    // Test where works: i2c_write_bytes action type specified
+    catch (const std::invalid_argument& e)
     {
-        const json element = R"(
-            {
-              "i2c_write_bytes": {
-                "register": "0x0A",
-                "values": [ "0xCC", "0xFF" ]
-              }
-            }
-        )"_json;
-        std::unique_ptr<Action> action = parseAction(element);
-        EXPECT_NE(action.get(), nullptr);
+        EXPECT_STREQ(e.what(), "Element is not a boolean");
     }
 
-    // Test where works: if action type specified
+    // Test where fails: number value is invalid
+    try
     {
         const json element = R"(
             {
-              "if":
-              {
-                "condition": { "run_rule": "is_downlevel_regulator" },
-                "then": [ { "run_rule": "configure_downlevel_regulator" } ],
-                "else": [ { "run_rule": "configure_standard_regulator" } ]
-              }
+              "number": 0.5,
+              "inventory_path": "system/chassis"
             }
         )"_json;
-        std::unique_ptr<Action> action = parseAction(element);
-        EXPECT_NE(action.get(), nullptr);
+        parseChassis(element);
+        ADD_FAILURE() << "Should not have reached this line.";
     }
-
-    // Test where works: log_phase_fault action type specified
+    catch (const std::invalid_argument& e)
     {
-        const json element = R"(
-            {
-              "log_phase_fault": {
-                "type": "n+1"
-              }
-            }
-        )"_json;
-        std::unique_ptr<Action> action = parseAction(element);
-        EXPECT_NE(action.get(), nullptr);
+        EXPECT_STREQ(e.what(), "Element is not an unsigned integer");
     }
 
-    // Test where works: not action type specified
+    // Test where fails: inventory_path is invalid: Not a string
+    try
     {
         const json element = R"(
             {
-              "not":
-              { "i2c_compare_byte": { "register": "0xA0", "value": "0xFF" } }
+              "number": 2,
+              "inventory_path": true
             }
         )"_json;
-        std::unique_ptr<Action> action = parseAction(element);
-        EXPECT_NE(action.get(), nullptr);
+        parseChassis(element);
+        ADD_FAILURE() << "Should not have reached this line.";
     }
-
-    // Test where works: or action type specified
+    catch (const std::invalid_argument& e)
     {
-        const json element = R"(
-            {
-              "or": [
-                { "i2c_compare_byte": { "register": "0xA0", "value": "0x00" } },
-                { "i2c_compare_byte": { "register": "0xA1", "value": "0x00" } }
-              ]
-            }
-        )"_json;
-        std::unique_ptr<Action> action = parseAction(element);
-        EXPECT_NE(action.get(), nullptr);
+        EXPECT_STREQ(e.what(), "Element is not a string");
     }
 
-    // Test where works: pmbus_read_sensor action type specified
+    // Test where fails: inventory_path is invalid: Empty string
+    try
     {
         const json element = R"(
             {
-              "pmbus_read_sensor": {
-                "type": "iout",
-                "command": "0x8C",
-                "format": "linear_11"
-              }
+              "number": 2,
+              "inventory_path": ""
             }
         )"_json;
-        std::unique_ptr<Action> action = parseAction(element);
-        EXPECT_NE(action.get(), nullptr);
+        parseChassis(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Element contains an empty string");
     }
 
-    // Test where works: pmbus_write_vout_command action type specified
+    // Test where fails: Invalid property specified
+    try
     {
         const json element = R"(
             {
-              "pmbus_write_vout_command": {
-                "format": "linear"
-              }
+              "number": 1,
+              "inventory_path": "system/chassis",
+              "foo": 2
             }
         )"_json;
-        std::unique_ptr<Action> action = parseAction(element);
-        EXPECT_NE(action.get(), nullptr);
+        parseChassis(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Element contains an invalid property");
     }
 
-    // Test where works: run_rule action type specified
+    // Test where fails: Required number property not specified
+    try
     {
         const json element = R"(
             {
-              "run_rule": "set_voltage_rule"
+              "inventory_path": "system/chassis"
             }
         )"_json;
-        std::unique_ptr<Action> action = parseAction(element);
-        EXPECT_NE(action.get(), nullptr);
+        parseChassis(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Required property missing: number");
     }
 
-    // Test where works: set_device action type specified
+    // Test where fails: Required inventory_path property not specified
+    try
     {
         const json element = R"(
             {
-              "set_device": "io_expander2"
+              "number": 1
             }
         )"_json;
-        std::unique_ptr<Action> action = parseAction(element);
-        EXPECT_NE(action.get(), nullptr);
+        parseChassis(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Required property missing: inventory_path");
     }
 
     // Test where fails: Element is not an object
     try
     {
         const json element = R"( [ "0xFF", "0x01" ] )"_json;
-        parseAction(element);
+        parseChassis(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
@@ -521,346 +1696,416 @@ TEST(ConfigFileParserTests, ParseAction)
         EXPECT_STREQ(e.what(), "Element is not an object");
     }
 
-    // Test where fails: No action type specified
+    // Test where fails: number value is < 1
     try
     {
         const json element = R"(
             {
-              "comments": [ "Set output voltage." ]
+              "number": 0,
+              "inventory_path": "system/chassis"
             }
         )"_json;
-        parseAction(element);
+        parseChassis(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Required action type property missing");
+        EXPECT_STREQ(e.what(), "Invalid chassis number: Must be > 0");
     }
 
-    // Test where fails: Multiple action types specified
+    // Test where fails: devices value is invalid
     try
     {
         const json element = R"(
             {
-              "pmbus_write_vout_command": { "format": "linear" },
-              "run_rule": "set_voltage_rule"
+              "number": 1,
+              "inventory_path": "system/chassis",
+              "devices": 2
             }
         )"_json;
-        parseAction(element);
+        parseChassis(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Element contains an invalid property");
+        EXPECT_STREQ(e.what(), "Element is not an array");
     }
+}
 
-    // Test where fails: Invalid property specified
+TEST(ConfigFileParserTests, ParseChassisArray)
+{
+    // Test where works
+    {
+        const json element = R"(
+            [
+              { "number": 1, "inventory_path": "system/chassis1" },
+              { "number": 2, "inventory_path": "system/chassis2" }
+            ]
+        )"_json;
+        std::vector<std::unique_ptr<Chassis>> chassis =
+            parseChassisArray(element);
+        EXPECT_EQ(chassis.size(), 2);
+        EXPECT_EQ(chassis[0]->getNumber(), 1);
+        EXPECT_EQ(chassis[0]->getInventoryPath(),
+                  "/xyz/openbmc_project/inventory/system/chassis1");
+        EXPECT_EQ(chassis[1]->getNumber(), 2);
+        EXPECT_EQ(chassis[1]->getInventoryPath(),
+                  "/xyz/openbmc_project/inventory/system/chassis2");
+    }
+
+    // Test where fails: Element is not an array
     try
     {
         const json element = R"(
             {
-              "remarks": [ "Set output voltage." ],
-              "pmbus_write_vout_command": {
-                "format": "linear"
-              }
+              "foo": "bar"
             }
         )"_json;
-        parseAction(element);
+        parseChassisArray(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Element contains an invalid property");
+        EXPECT_STREQ(e.what(), "Element is not an array");
     }
 }
 
-TEST(ConfigFileParserTests, ParseActionArray)
+TEST(ConfigFileParserTests, ParseComparePresence)
 {
     // Test where works
     {
         const json element = R"(
-            [
-              { "pmbus_write_vout_command": { "volts": 1.01, "format": "linear" } },
-              { "pmbus_write_vout_command": { "volts": 1.03, "format": "linear" } }
-            ]
+            {
+              "fru": "system/chassis/motherboard/cpu3",
+              "value": true
+            }
         )"_json;
-        std::vector<std::unique_ptr<Action>> actions =
-            parseActionArray(element);
-        EXPECT_EQ(actions.size(), 2);
+        std::unique_ptr<ComparePresenceAction> action =
+            parseComparePresence(element);
+        EXPECT_EQ(
+            action->getFRU(),
+            "/xyz/openbmc_project/inventory/system/chassis/motherboard/cpu3");
+        EXPECT_EQ(action->getValue(), true);
     }
 
-    // Test where fails: Element is not an array
+    // Test where fails: Element is not an object
+    try
+    {
+        const json element = R"( [ "0xFF", "0x01" ] )"_json;
+        parseComparePresence(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Element is not an object");
+    }
+
+    // Test where fails: Invalid property specified
     try
     {
         const json element = R"(
             {
-              "foo": "bar"
+              "fru": "system/chassis/motherboard/cpu3",
+              "value": true,
+              "foo" : true
             }
         )"_json;
-        parseActionArray(element);
+        parseComparePresence(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Element is not an array");
+        EXPECT_STREQ(e.what(), "Element contains an invalid property");
     }
-}
 
-TEST(ConfigFileParserTests, ParseAnd)
-{
-    // Test where works: Element is an array with 2 actions
+    // Test where fails: Required fru property not specified
+    try
     {
         const json element = R"(
-            [
-              { "i2c_compare_byte": { "register": "0xA0", "value": "0x00" } },
-              { "i2c_compare_byte": { "register": "0xA1", "value": "0x00" } }
-            ]
+            {
+              "value": true
+            }
         )"_json;
-        std::unique_ptr<AndAction> action = parseAnd(element);
-        EXPECT_EQ(action->getActions().size(), 2);
+        parseComparePresence(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Required property missing: fru");
     }
 
-    // Test where fails: Element is an array with 1 action
+    // Test where fails: Required value property not specified
     try
     {
         const json element = R"(
-            [
-              { "i2c_compare_byte": { "register": "0xA0", "value": "0x00" } }
-            ]
+            {
+              "fru": "system/chassis/motherboard/cpu3"
+            }
         )"_json;
-        parseAnd(element);
+        parseComparePresence(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Array must contain two or more actions");
+        EXPECT_STREQ(e.what(), "Required property missing: value");
     }
 
-    // Test where fails: Element is not an array
+    // Test where fails: fru value is invalid
     try
     {
         const json element = R"(
             {
-              "foo": "bar"
+              "fru": 1,
+              "value": true
             }
         )"_json;
-        parseAnd(element);
+        parseComparePresence(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Element is not an array");
+        EXPECT_STREQ(e.what(), "Element is not a string");
+    }
+
+    // Test where fails: value value is invalid
+    try
+    {
+        const json element = R"(
+            {
+              "fru": "system/chassis/motherboard/cpu3",
+              "value": 1
+            }
+        )"_json;
+        parseComparePresence(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Element is not a boolean");
     }
 }
 
-TEST(ConfigFileParserTests, ParseBitPosition)
+TEST(ConfigFileParserTests, ParseCompareVPD)
 {
-    // Test where works: 0
+    // Test where works: value property: Not empty
     {
-        const json element = R"( 0 )"_json;
-        uint8_t value = parseBitPosition(element);
-        EXPECT_EQ(value, 0);
+        const json element = R"(
+            {
+              "fru": "system/chassis/disk_backplane",
+              "keyword": "CCIN",
+              "value": "2D35"
+            }
+        )"_json;
+        std::unique_ptr<CompareVPDAction> action = parseCompareVPD(element);
+        EXPECT_EQ(
+            action->getFRU(),
+            "/xyz/openbmc_project/inventory/system/chassis/disk_backplane");
+        EXPECT_EQ(action->getKeyword(), "CCIN");
+        EXPECT_EQ(action->getValue(),
+                  (std::vector<uint8_t>{0x32, 0x44, 0x33, 0x35}));
     }
 
-    // Test where works: 7
+    // Test where works: value property: Empty
     {
-        const json element = R"( 7 )"_json;
-        uint8_t value = parseBitPosition(element);
-        EXPECT_EQ(value, 7);
+        const json element = R"(
+            {
+              "fru": "system/chassis/disk_backplane",
+              "keyword": "CCIN",
+              "value": ""
+            }
+        )"_json;
+        std::unique_ptr<CompareVPDAction> action = parseCompareVPD(element);
+        EXPECT_EQ(
+            action->getFRU(),
+            "/xyz/openbmc_project/inventory/system/chassis/disk_backplane");
+        EXPECT_EQ(action->getKeyword(), "CCIN");
+        EXPECT_EQ(action->getValue(), (std::vector<uint8_t>{}));
     }
 
-    // Test where fails: Element is not an integer
-    try
+    // Test where works: byte_values property: Not empty
     {
-        const json element = R"( 1.03 )"_json;
-        parseBitPosition(element);
-        ADD_FAILURE() << "Should not have reached this line.";
+        const json element = R"(
+            {
+              "fru": "system/chassis/disk_backplane",
+              "keyword": "CCIN",
+              "byte_values": ["0x11", "0x22", "0x33"]
+            }
+        )"_json;
+        std::unique_ptr<CompareVPDAction> action = parseCompareVPD(element);
+        EXPECT_EQ(
+            action->getFRU(),
+            "/xyz/openbmc_project/inventory/system/chassis/disk_backplane");
+        EXPECT_EQ(action->getKeyword(), "CCIN");
+        EXPECT_EQ(action->getValue(), (std::vector<uint8_t>{0x11, 0x22, 0x33}));
     }
-    catch (const std::invalid_argument& e)
+
+    // Test where works: byte_values property: Empty
     {
-        EXPECT_STREQ(e.what(), "Element is not an integer");
+        const json element = R"(
+            {
+              "fru": "system/chassis/disk_backplane",
+              "keyword": "CCIN",
+              "byte_values": []
+            }
+        )"_json;
+        std::unique_ptr<CompareVPDAction> action = parseCompareVPD(element);
+        EXPECT_EQ(
+            action->getFRU(),
+            "/xyz/openbmc_project/inventory/system/chassis/disk_backplane");
+        EXPECT_EQ(action->getKeyword(), "CCIN");
+        EXPECT_EQ(action->getValue(), (std::vector<uint8_t>{}));
     }
 
-    // Test where fails: Value < 0
+    // Test where fails: Element is not an object
     try
     {
-        const json element = R"( -1 )"_json;
-        parseBitPosition(element);
+        const json element = R"( [ "0xFF", "0x01" ] )"_json;
+        parseCompareVPD(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Element is not a bit position");
+        EXPECT_STREQ(e.what(), "Element is not an object");
     }
 
-    // Test where fails: Value > 7
+    // Test where fails: Invalid property specified
     try
     {
-        const json element = R"( 8 )"_json;
-        parseBitPosition(element);
+        const json element = R"(
+            {
+              "fru": "system/chassis/disk_backplane",
+              "keyword": "CCIN",
+              "value": "2D35",
+              "foo" : true
+            }
+        )"_json;
+        parseCompareVPD(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Element is not a bit position");
-    }
-}
-
-TEST(ConfigFileParserTests, ParseBitValue)
-{
-    // Test where works: 0
-    {
-        const json element = R"( 0 )"_json;
-        uint8_t value = parseBitValue(element);
-        EXPECT_EQ(value, 0);
-    }
-
-    // Test where works: 1
-    {
-        const json element = R"( 1 )"_json;
-        uint8_t value = parseBitValue(element);
-        EXPECT_EQ(value, 1);
+        EXPECT_STREQ(e.what(), "Element contains an invalid property");
     }
 
-    // Test where fails: Element is not an integer
+    // Test where fails: Required fru property not specified
     try
     {
-        const json element = R"( 0.5 )"_json;
-        parseBitValue(element);
+        const json element = R"(
+            {
+              "keyword": "CCIN",
+              "value": "2D35"
+            }
+        )"_json;
+        parseCompareVPD(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Element is not an integer");
+        EXPECT_STREQ(e.what(), "Required property missing: fru");
     }
 
-    // Test where fails: Value < 0
+    // Test where fails: Required keyword property not specified
     try
     {
-        const json element = R"( -1 )"_json;
-        parseBitValue(element);
+        const json element = R"(
+            {
+              "fru": "system/chassis/disk_backplane",
+              "value": "2D35"
+            }
+        )"_json;
+        parseCompareVPD(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Element is not a bit value");
+        EXPECT_STREQ(e.what(), "Required property missing: keyword");
     }
 
-    // Test where fails: Value > 1
+    // Test where fails: Required value property not specified
     try
     {
-        const json element = R"( 2 )"_json;
-        parseBitValue(element);
+        const json element = R"(
+            {
+              "fru": "system/chassis/disk_backplane",
+              "keyword": "CCIN"
+            }
+        )"_json;
+        parseCompareVPD(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Element is not a bit value");
-    }
-}
-
-TEST(ConfigFileParserTests, ParseBoolean)
-{
-    // Test where works: true
-    {
-        const json element = R"( true )"_json;
-        bool value = parseBoolean(element);
-        EXPECT_EQ(value, true);
-    }
-
-    // Test where works: false
-    {
-        const json element = R"( false )"_json;
-        bool value = parseBoolean(element);
-        EXPECT_EQ(value, false);
+        EXPECT_STREQ(e.what(), "Invalid property: Must contain "
+                               "either value or byte_values");
     }
 
-    // Test where fails: Element is not a boolean
+    // Test where fails: both value and byte_values specified
     try
     {
-        const json element = R"( 1 )"_json;
-        parseBoolean(element);
+        const json element = R"(
+            {
+              "fru": "system/chassis/disk_backplane",
+              "keyword": "CCIN",
+              "value": "2D35",
+              "byte_values": [ "0x01", "0x02" ]
+            }
+        )"_json;
+        parseCompareVPD(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Element is not a boolean");
+        EXPECT_STREQ(e.what(), "Invalid property: Must contain "
+                               "either value or byte_values");
     }
-}
 
-TEST(ConfigFileParserTests, ParseChassis)
-{
-    // Test where works: Only required properties specified
+    // Test where fails: fru value is invalid
+    try
     {
         const json element = R"(
             {
-              "number": 1,
-              "inventory_path": "system/chassis1"
+              "fru": 1,
+              "keyword": "CCIN",
+              "value": "2D35"
             }
         )"_json;
-        std::unique_ptr<Chassis> chassis = parseChassis(element);
-        EXPECT_EQ(chassis->getNumber(), 1);
-        EXPECT_EQ(chassis->getInventoryPath(),
-                  "/xyz/openbmc_project/inventory/system/chassis1");
-        EXPECT_EQ(chassis->getDevices().size(), 0);
+        parseCompareVPD(element);
+        ADD_FAILURE() << "Should not have reached this line.";
     }
-
-    // Test where works: All properties specified
+    catch (const std::invalid_argument& e)
     {
-        const json element = R"(
-            {
-              "comments": [ "comments property" ],
-              "number": 2,
-              "inventory_path": "system/chassis2",
-              "devices": [
-                {
-                  "id": "vdd_regulator",
-                  "is_regulator": true,
-                  "fru": "system/chassis/motherboard/regulator2",
-                  "i2c_interface":
-                  {
-                      "bus": 1,
-                      "address": "0x70"
-                  }
-                }
-              ]
-            }
-        )"_json;
-        std::unique_ptr<Chassis> chassis = parseChassis(element);
-        EXPECT_EQ(chassis->getNumber(), 2);
-        EXPECT_EQ(chassis->getInventoryPath(),
-                  "/xyz/openbmc_project/inventory/system/chassis2");
-        EXPECT_EQ(chassis->getDevices().size(), 1);
-        EXPECT_EQ(chassis->getDevices()[0]->getID(), "vdd_regulator");
+        EXPECT_STREQ(e.what(), "Element is not a string");
     }
 
-    // Test where fails: number value is invalid
+    // Test where fails: keyword value is invalid
     try
     {
         const json element = R"(
             {
-              "number": 0.5,
-              "inventory_path": "system/chassis"
+              "fru": "system/chassis/disk_backplane",
+              "keyword": 1,
+              "value": "2D35"
             }
         )"_json;
-        parseChassis(element);
+        parseCompareVPD(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Element is not an unsigned integer");
+        EXPECT_STREQ(e.what(), "Element is not a string");
     }
 
-    // Test where fails: inventory_path is invalid: Not a string
+    // Test where fails: value value is invalid
     try
     {
         const json element = R"(
             {
-              "number": 2,
-              "inventory_path": true
+              "fru": "system/chassis/disk_backplane",
+              "keyword": "CCIN",
+              "value": 1
             }
         )"_json;
-        parseChassis(element);
+        parseCompareVPD(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
@@ -868,182 +2113,184 @@ TEST(ConfigFileParserTests, ParseChassis)
         EXPECT_STREQ(e.what(), "Element is not a string");
     }
 
-    // Test where fails: inventory_path is invalid: Empty string
+    // Test where fails: byte_values is wrong format
     try
     {
         const json element = R"(
             {
-              "number": 2,
-              "inventory_path": ""
+              "fru": "system/chassis/disk_backplane",
+              "keyword": "CCIN",
+              "byte_values": [1, 2, 3]
             }
         )"_json;
-        parseChassis(element);
+        parseCompareVPD(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Element contains an empty string");
+        EXPECT_STREQ(e.what(), "Element is not a string");
     }
+}
 
-    // Test where fails: Invalid property specified
-    try
+TEST(ConfigFileParserTests, ParseConfiguration)
+{
+    // Test where works: actions required property specified
     {
         const json element = R"(
             {
-              "number": 1,
-              "inventory_path": "system/chassis",
-              "foo": 2
+              "actions": [
+                {
+                  "pmbus_write_vout_command": {
+                    "format": "linear"
+                  }
+                }
+              ]
             }
         )"_json;
-        parseChassis(element);
-        ADD_FAILURE() << "Should not have reached this line.";
-    }
-    catch (const std::invalid_argument& e)
-    {
-        EXPECT_STREQ(e.what(), "Element contains an invalid property");
+        std::unique_ptr<Configuration> configuration =
+            parseConfiguration(element);
+        EXPECT_EQ(configuration->getActions().size(), 1);
+        EXPECT_EQ(configuration->getVolts().has_value(), false);
     }
 
-    // Test where fails: Required number property not specified
-    try
+    // Test where works: volts and actions properties specified
     {
         const json element = R"(
             {
-              "inventory_path": "system/chassis"
+              "comments": [ "comments property" ],
+              "volts": 1.03,
+              "actions": [
+                { "pmbus_write_vout_command": { "format": "linear" } },
+                { "run_rule": "set_voltage_rule" }
+              ]
             }
         )"_json;
-        parseChassis(element);
-        ADD_FAILURE() << "Should not have reached this line.";
+        std::unique_ptr<Configuration> configuration =
+            parseConfiguration(element);
+        EXPECT_EQ(configuration->getVolts().has_value(), true);
+        EXPECT_EQ(configuration->getVolts().value(), 1.03);
+        EXPECT_EQ(configuration->getActions().size(), 2);
     }
-    catch (const std::invalid_argument& e)
+
+    // Test where works: volts and rule_id properties specified
     {
-        EXPECT_STREQ(e.what(), "Required property missing: number");
+        const json element = R"(
+            {
+              "volts": 1.05,
+              "rule_id": "set_voltage_rule"
+            }
+        )"_json;
+        std::unique_ptr<Configuration> configuration =
+            parseConfiguration(element);
+        EXPECT_EQ(configuration->getVolts().has_value(), true);
+        EXPECT_EQ(configuration->getVolts().value(), 1.05);
+        EXPECT_EQ(configuration->getActions().size(), 1);
     }
 
-    // Test where fails: Required inventory_path property not specified
+    // Test where fails: volts value is invalid
     try
     {
         const json element = R"(
             {
-              "number": 1
+              "volts": "foo",
+              "actions": [
+                {
+                  "pmbus_write_vout_command": {
+                    "format": "linear"
+                  }
+                }
+              ]
             }
         )"_json;
-        parseChassis(element);
+        parseConfiguration(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Required property missing: inventory_path");
+        EXPECT_STREQ(e.what(), "Element is not a number");
     }
 
-    // Test where fails: Element is not an object
+    // Test where fails: actions object is invalid
     try
     {
-        const json element = R"( [ "0xFF", "0x01" ] )"_json;
-        parseChassis(element);
+        const json element = R"(
+            {
+              "volts": 1.03,
+              "actions": 1
+            }
+        )"_json;
+        parseConfiguration(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Element is not an object");
+        EXPECT_STREQ(e.what(), "Element is not an array");
     }
 
-    // Test where fails: number value is < 1
+    // Test where fails: rule_id value is invalid
     try
     {
         const json element = R"(
             {
-              "number": 0,
-              "inventory_path": "system/chassis"
+              "volts": 1.05,
+              "rule_id": 1
             }
         )"_json;
-        parseChassis(element);
+        parseConfiguration(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Invalid chassis number: Must be > 0");
+        EXPECT_STREQ(e.what(), "Element is not a string");
     }
 
-    // Test where fails: devices value is invalid
+    // Test where fails: Required actions or rule_id property not specified
     try
     {
         const json element = R"(
             {
-              "number": 1,
-              "inventory_path": "system/chassis",
-              "devices": 2
+              "volts": 1.03
             }
         )"_json;
-        parseChassis(element);
+        parseConfiguration(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Element is not an array");
-    }
-}
-
-TEST(ConfigFileParserTests, ParseChassisArray)
-{
-    // Test where works
-    {
-        const json element = R"(
-            [
-              { "number": 1, "inventory_path": "system/chassis1" },
-              { "number": 2, "inventory_path": "system/chassis2" }
-            ]
-        )"_json;
-        std::vector<std::unique_ptr<Chassis>> chassis =
-            parseChassisArray(element);
-        EXPECT_EQ(chassis.size(), 2);
-        EXPECT_EQ(chassis[0]->getNumber(), 1);
-        EXPECT_EQ(chassis[0]->getInventoryPath(),
-                  "/xyz/openbmc_project/inventory/system/chassis1");
-        EXPECT_EQ(chassis[1]->getNumber(), 2);
-        EXPECT_EQ(chassis[1]->getInventoryPath(),
-                  "/xyz/openbmc_project/inventory/system/chassis2");
+        EXPECT_STREQ(e.what(), "Invalid property combination: Must contain "
+                               "either rule_id or actions");
     }
 
-    // Test where fails: Element is not an array
+    // Test where fails: Required actions or rule_id property both specified
     try
     {
         const json element = R"(
             {
-              "foo": "bar"
+              "volts": 1.03,
+              "rule_id": "set_voltage_rule",
+              "actions": [
+                {
+                  "pmbus_write_vout_command": {
+                    "format": "linear"
+                  }
+                }
+              ]
             }
         )"_json;
-        parseChassisArray(element);
+        parseConfiguration(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Element is not an array");
-    }
-}
-
-TEST(ConfigFileParserTests, ParseComparePresence)
-{
-    // Test where works
-    {
-        const json element = R"(
-            {
-              "fru": "system/chassis/motherboard/cpu3",
-              "value": true
-            }
-        )"_json;
-        std::unique_ptr<ComparePresenceAction> action =
-            parseComparePresence(element);
-        EXPECT_EQ(
-            action->getFRU(),
-            "/xyz/openbmc_project/inventory/system/chassis/motherboard/cpu3");
-        EXPECT_EQ(action->getValue(), true);
+        EXPECT_STREQ(e.what(), "Invalid property combination: Must contain "
+                               "either rule_id or actions");
     }
 
     // Test where fails: Element is not an object
     try
     {
         const json element = R"( [ "0xFF", "0x01" ] )"_json;
-        parseComparePresence(element);
+        parseConfiguration(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
@@ -1056,289 +2303,379 @@ TEST(ConfigFileParserTests, ParseComparePresence)
     {
         const json element = R"(
             {
-              "fru": "system/chassis/motherboard/cpu3",
-              "value": true,
-              "foo" : true
+              "volts": 1.03,
+              "rule_id": "set_voltage_rule",
+              "foo": 1
             }
         )"_json;
-        parseComparePresence(element);
+        parseConfiguration(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
         EXPECT_STREQ(e.what(), "Element contains an invalid property");
     }
+}
 
-    // Test where fails: Required fru property not specified
-    try
+TEST(ConfigFileParserTests, ParseDevice)
+{
+    // Test where works: Only required properties specified
     {
         const json element = R"(
             {
-              "value": true
+              "id": "vdd_regulator",
+              "is_regulator": true,
+              "fru": "system/chassis/motherboard/regulator2",
+              "i2c_interface": { "bus": 1, "address": "0x70" }
             }
         )"_json;
-        parseComparePresence(element);
-        ADD_FAILURE() << "Should not have reached this line.";
-    }
-    catch (const std::invalid_argument& e)
-    {
-        EXPECT_STREQ(e.what(), "Required property missing: fru");
+        std::unique_ptr<Device> device = parseDevice(element);
+        EXPECT_EQ(device->getID(), "vdd_regulator");
+        EXPECT_EQ(device->isRegulator(), true);
+        EXPECT_EQ(device->getFRU(), "/xyz/openbmc_project/inventory/system/"
+                                    "chassis/motherboard/regulator2");
+        EXPECT_NE(&(device->getI2CInterface()), nullptr);
+        EXPECT_EQ(device->getPresenceDetection(), nullptr);
+        EXPECT_EQ(device->getConfiguration(), nullptr);
+        EXPECT_EQ(device->getPhaseFaultDetection(), nullptr);
+        EXPECT_EQ(device->getRails().size(), 0);
+        EXPECT_EQ(device->getDependsOn().size(), 0);
+        EXPECT_FALSE(device->hasAutoIncrement());
+        EXPECT_FALSE(device->hasShadowRegisters());
+        EXPECT_EQ(device->getVolatileRegisters().size(), 0);
+        EXPECT_FALSE(device->isStandbyPowered());
     }
 
-    // Test where fails: Required value property not specified
-    try
+    // Test where works: auto_increment specified in i2c_interface
     {
         const json element = R"(
             {
-              "fru": "system/chassis/motherboard/cpu3"
+              "id": "vdd_regulator",
+              "is_regulator": true,
+              "fru": "system/chassis/motherboard/regulator2",
+              "i2c_interface":
+              {
+                  "bus": 1,
+                  "address": "0x70",
+                  "auto_increment": true
+              }
             }
         )"_json;
-        parseComparePresence(element);
-        ADD_FAILURE() << "Should not have reached this line.";
-    }
-    catch (const std::invalid_argument& e)
-    {
-        EXPECT_STREQ(e.what(), "Required property missing: value");
+        std::unique_ptr<Device> device = parseDevice(element);
+        EXPECT_TRUE(device->hasAutoIncrement());
     }
 
-    // Test where fails: fru value is invalid
-    try
+    // Test where works: shadow_registers and volatile_registers specified in
+    // i2c_interface
     {
         const json element = R"(
             {
-              "fru": 1,
-              "value": true
+              "id": "vdd_regulator",
+              "is_regulator": true,
+              "fru": "system/chassis/motherboard/regulator2",
+              "i2c_interface":
+              {
+                  "bus": 1,
+                  "address": "0x70",
+                  "shadow_registers": true,
+                  "volatile_registers": [ "0x78", "0x7A" ]
+              }
             }
         )"_json;
-        parseComparePresence(element);
-        ADD_FAILURE() << "Should not have reached this line.";
-    }
-    catch (const std::invalid_argument& e)
-    {
-        EXPECT_STREQ(e.what(), "Element is not a string");
+        std::unique_ptr<Device> device = parseDevice(element);
+        EXPECT_TRUE(device->hasShadowRegisters());
+        EXPECT_EQ(device->getVolatileRegisters(),
+                  (std::vector<uint8_t>{0x78, 0x7A}));
     }
 
-    // Test where fails: value value is invalid
-    try
+    // Test where works: Definition hash set.  Same for an identical
+    // definition, different for a changed definition.
     {
         const json element = R"(
             {
-              "fru": "system/chassis/motherboard/cpu3",
-              "value": 1
+              "id": "vdd_regulator",
+              "is_regulator": true,
+              "fru": "system/chassis/motherboard/regulator2",
+              "i2c_interface": { "bus": 1, "address": "0x70" }
             }
         )"_json;
-        parseComparePresence(element);
-        ADD_FAILURE() << "Should not have reached this line.";
-    }
-    catch (const std::invalid_argument& e)
-    {
-        EXPECT_STREQ(e.what(), "Element is not a boolean");
-    }
-}
+        std::unique_ptr<Device> device = parseDevice(element);
+        EXPECT_NE(device->getDefinitionHash(), 0);
+        EXPECT_EQ(parseDevice(element)->getDefinitionHash(),
+                  device->getDefinitionHash());
 
-TEST(ConfigFileParserTests, ParseCompareVPD)
-{
-    // Test where works: value property: Not empty
-    {
-        const json element = R"(
-            {
-              "fru": "system/chassis/disk_backplane",
-              "keyword": "CCIN",
-              "value": "2D35"
-            }
-        )"_json;
-        std::unique_ptr<CompareVPDAction> action = parseCompareVPD(element);
-        EXPECT_EQ(
-            action->getFRU(),
-            "/xyz/openbmc_project/inventory/system/chassis/disk_backplane");
-        EXPECT_EQ(action->getKeyword(), "CCIN");
-        EXPECT_EQ(action->getValue(),
-                  (std::vector<uint8_t>{0x32, 0x44, 0x33, 0x35}));
+        json changedElement = element;
+        changedElement["i2c_interface"]["bus"] = 2;
+        EXPECT_NE(parseDevice(changedElement)->getDefinitionHash(),
+                  device->getDefinitionHash());
     }
 
-    // Test where works: value property: Empty
+    // Test where works: All properties specified
     {
         const json element = R"(
             {
-              "fru": "system/chassis/disk_backplane",
-              "keyword": "CCIN",
-              "value": ""
+              "comments": [ "VDD Regulator" ],
+              "id": "vdd_regulator",
+              "is_regulator": true,
+              "fru": "system/chassis/motherboard/regulator2",
+              "i2c_interface":
+              {
+                  "bus": 1,
+                  "address": "0x70"
+              },
+              "presence_detection":
+              {
+                  "rule_id": "is_foobar_backplane_installed_rule"
+              },
+              "configuration":
+              {
+                  "rule_id": "configure_ir35221_rule"
+              },
+              "phase_fault_detection":
+              {
+                  "rule_id": "detect_phase_fault_rule"
+              },
+              "rails":
+              [
+                {
+                  "id": "vdd"
+                }
+              ],
+              "depends_on": [ "vio_regulator", "vcs_regulator" ]
             }
         )"_json;
-        std::unique_ptr<CompareVPDAction> action = parseCompareVPD(element);
-        EXPECT_EQ(
-            action->getFRU(),
-            "/xyz/openbmc_project/inventory/system/chassis/disk_backplane");
-        EXPECT_EQ(action->getKeyword(), "CCIN");
-        EXPECT_EQ(action->getValue(), (std::vector<uint8_t>{}));
+        std::unique_ptr<Device> device = parseDevice(element);
+        EXPECT_EQ(device->getID(), "vdd_regulator");
+        EXPECT_EQ(device->isRegulator(), true);
+        EXPECT_EQ(device->getFRU(), "/xyz/openbmc_project/inventory/system/"
+                                    "chassis/motherboard/regulator2");
+        EXPECT_NE(&(device->getI2CInterface()), nullptr);
+        EXPECT_NE(device->getPresenceDetection(), nullptr);
+        EXPECT_NE(device->getConfiguration(), nullptr);
+        EXPECT_NE(device->getPhaseFaultDetection(), nullptr);
+        EXPECT_EQ(device->getRails().size(), 1);
+        EXPECT_EQ(device->getDependsOn(),
+                  (std::vector<std::string>{"vio_regulator", "vcs_regulator"}));
     }
 
-    // Test where works: byte_values property: Not empty
+    // Test where works: power_domain specified
     {
         const json element = R"(
             {
-              "fru": "system/chassis/disk_backplane",
-              "keyword": "CCIN",
-              "byte_values": ["0x11", "0x22", "0x33"]
+              "id": "vdd_regulator",
+              "is_regulator": true,
+              "fru": "system/chassis/motherboard/regulator2",
+              "i2c_interface": { "bus": 1, "address": "0x70" },
+              "power_domain": { "name": "cpu0", "sequencer_rails": [ 4, 5 ] }
             }
         )"_json;
-        std::unique_ptr<CompareVPDAction> action = parseCompareVPD(element);
-        EXPECT_EQ(
-            action->getFRU(),
-            "/xyz/openbmc_project/inventory/system/chassis/disk_backplane");
-        EXPECT_EQ(action->getKeyword(), "CCIN");
-        EXPECT_EQ(action->getValue(), (std::vector<uint8_t>{0x11, 0x22, 0x33}));
+        std::unique_ptr<Device> device = parseDevice(element);
+        EXPECT_NE(device->getPowerDomain(), nullptr);
+        EXPECT_EQ(device->getPowerDomain()->getName(), "cpu0");
+        EXPECT_EQ(device->getPowerDomain()->getSequencerRails(),
+                  (std::vector<unsigned int>{4, 5}));
     }
 
-    // Test where works: byte_values property: Empty
+    // Test where works: is_standby_powered specified
     {
         const json element = R"(
             {
-              "fru": "system/chassis/disk_backplane",
-              "keyword": "CCIN",
-              "byte_values": []
+              "id": "vdd_regulator",
+              "is_regulator": true,
+              "fru": "system/chassis/motherboard/regulator2",
+              "i2c_interface": { "bus": 1, "address": "0x70" },
+              "is_standby_powered": true
             }
         )"_json;
-        std::unique_ptr<CompareVPDAction> action = parseCompareVPD(element);
-        EXPECT_EQ(
-            action->getFRU(),
-            "/xyz/openbmc_project/inventory/system/chassis/disk_backplane");
-        EXPECT_EQ(action->getKeyword(), "CCIN");
-        EXPECT_EQ(action->getValue(), (std::vector<uint8_t>{}));
+        std::unique_ptr<Device> device = parseDevice(element);
+        EXPECT_TRUE(device->isStandbyPowered());
     }
 
-    // Test where fails: Element is not an object
+    // Test where fails: is_standby_powered value is invalid
     try
     {
-        const json element = R"( [ "0xFF", "0x01" ] )"_json;
-        parseCompareVPD(element);
+        const json element = R"(
+            {
+              "id": "vdd_regulator",
+              "is_regulator": true,
+              "fru": "system/chassis/motherboard/regulator2",
+              "i2c_interface": { "bus": 1, "address": "0x70" },
+              "is_standby_powered": 1
+            }
+        )"_json;
+        parseDevice(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Element is not an object");
+        EXPECT_STREQ(e.what(), "Element is not a boolean");
     }
 
-    // Test where fails: Invalid property specified
+    // Test where fails: power_domain value is invalid
     try
     {
         const json element = R"(
             {
-              "fru": "system/chassis/disk_backplane",
-              "keyword": "CCIN",
-              "value": "2D35",
-              "foo" : true
+              "id": "vdd_regulator",
+              "is_regulator": true,
+              "fru": "system/chassis/motherboard/regulator2",
+              "i2c_interface": { "bus": 1, "address": "0x70" },
+              "power_domain": "cpu0"
             }
         )"_json;
-        parseCompareVPD(element);
+        parseDevice(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Element contains an invalid property");
+        EXPECT_STREQ(e.what(), "Element is not an object");
     }
 
-    // Test where fails: Required fru property not specified
+    // Test where fails: depends_on value is invalid
     try
     {
         const json element = R"(
             {
-              "keyword": "CCIN",
-              "value": "2D35"
+              "id": "vdd_regulator",
+              "is_regulator": true,
+              "fru": "system/chassis/motherboard/regulator2",
+              "i2c_interface": { "bus": 1, "address": "0x70" },
+              "depends_on": "vio_regulator"
             }
         )"_json;
-        parseCompareVPD(element);
+        parseDevice(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Required property missing: fru");
+        EXPECT_STREQ(e.what(), "Element is not an array");
     }
 
-    // Test where fails: Required keyword property not specified
+    // Test where fails: phase_fault_detection property exists and is_regulator
+    // is false
     try
     {
         const json element = R"(
             {
-              "fru": "system/chassis/disk_backplane",
-              "value": "2D35"
+              "id": "vdd_regulator",
+              "is_regulator": false,
+              "fru": "system/chassis/motherboard/regulator2",
+              "i2c_interface":
+              {
+                  "bus": 1,
+                  "address": "0x70"
+              },
+              "phase_fault_detection":
+              {
+                  "rule_id": "detect_phase_fault_rule"
+              }
             }
         )"_json;
-        parseCompareVPD(element);
+        parseDevice(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Required property missing: keyword");
+        EXPECT_STREQ(e.what(), "Invalid phase_fault_detection property when "
+                               "is_regulator is false");
     }
 
-    // Test where fails: Required value property not specified
+    // Test where fails: rails property exists and is_regulator is false
     try
     {
         const json element = R"(
             {
-              "fru": "system/chassis/disk_backplane",
-              "keyword": "CCIN"
+              "id": "vdd_regulator",
+              "is_regulator": false,
+              "fru": "system/chassis/motherboard/regulator2",
+              "i2c_interface":
+              {
+                  "bus": 1,
+                  "address": "0x70"
+              },
+              "configuration":
+              {
+                  "rule_id": "configure_ir35221_rule"
+              },
+              "rails":
+              [
+                {
+                  "id": "vdd"
+                }
+              ]
             }
         )"_json;
-        parseCompareVPD(element);
+        parseDevice(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Invalid property: Must contain "
-                               "either value or byte_values");
+        EXPECT_STREQ(e.what(),
+                     "Invalid rails property when is_regulator is false");
     }
 
-    // Test where fails: both value and byte_values specified
+    // Test where fails: id value is invalid
     try
     {
         const json element = R"(
             {
-              "fru": "system/chassis/disk_backplane",
-              "keyword": "CCIN",
-              "value": "2D35",
-              "byte_values": [ "0x01", "0x02" ]
+              "id": 3,
+              "is_regulator": true,
+              "fru": "system/chassis/motherboard/regulator2",
+              "i2c_interface":
+              {
+                  "bus": 1,
+                  "address": "0x70"
+              }
             }
         )"_json;
-        parseCompareVPD(element);
+        parseDevice(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Invalid property: Must contain "
-                               "either value or byte_values");
+        EXPECT_STREQ(e.what(), "Element is not a string");
     }
 
-    // Test where fails: fru value is invalid
+    // Test where fails: is_regulator value is invalid
     try
     {
         const json element = R"(
             {
-              "fru": 1,
-              "keyword": "CCIN",
-              "value": "2D35"
+              "id": "vdd_regulator",
+              "is_regulator": 3,
+              "fru": "system/chassis/motherboard/regulator2",
+              "i2c_interface":
+              {
+                  "bus": 1,
+                  "address": "0x70"
+              }
             }
         )"_json;
-        parseCompareVPD(element);
+        parseDevice(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Element is not a string");
+        EXPECT_STREQ(e.what(), "Element is not a boolean");
     }
 
-    // Test where fails: keyword value is invalid
+    // Test where fails: fru value is invalid
     try
     {
         const json element = R"(
             {
-              "fru": "system/chassis/disk_backplane",
-              "keyword": 1,
-              "value": "2D35"
+              "id": "vdd_regulator",
+              "is_regulator": true,
+              "fru": 2,
+              "i2c_interface":
+              {
+                  "bus": 1,
+                  "address": "0x70"
+              }
             }
         )"_json;
-        parseCompareVPD(element);
+        parseDevice(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
@@ -1346,189 +2683,254 @@ TEST(ConfigFileParserTests, ParseCompareVPD)
         EXPECT_STREQ(e.what(), "Element is not a string");
     }
 
-    // Test where fails: value value is invalid
+    // Test where fails: i2c_interface value is invalid
     try
     {
         const json element = R"(
             {
-              "fru": "system/chassis/disk_backplane",
-              "keyword": "CCIN",
-              "value": 1
+              "id": "vdd_regulator",
+              "is_regulator": true,
+              "fru": "system/chassis/motherboard/regulator2",
+              "i2c_interface": 3
             }
         )"_json;
-        parseCompareVPD(element);
+        parseDevice(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Element is not a string");
+        EXPECT_STREQ(e.what(), "Element is not an object");
     }
 
-    // Test where fails: byte_values is wrong format
+    // Test where fails: Required id property not specified
     try
     {
         const json element = R"(
             {
-              "fru": "system/chassis/disk_backplane",
-              "keyword": "CCIN",
-              "byte_values": [1, 2, 3]
+              "is_regulator": true,
+              "fru": "system/chassis/motherboard/regulator2",
+              "i2c_interface":
+              {
+                  "bus": 1,
+                  "address": "0x70"
+              }
             }
         )"_json;
-        parseCompareVPD(element);
+        parseDevice(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Element is not a string");
+        EXPECT_STREQ(e.what(), "Required property missing: id");
     }
-}
 
-TEST(ConfigFileParserTests, ParseConfiguration)
-{
-    // Test where works: actions required property specified
+    // Test where fails: Required is_regulator property not specified
+    try
     {
         const json element = R"(
             {
-              "actions": [
-                {
-                  "pmbus_write_vout_command": {
-                    "format": "linear"
-                  }
-                }
-              ]
+              "id": "vdd_regulator",
+              "fru": "system/chassis/motherboard/regulator2",
+              "i2c_interface":
+              {
+                  "bus": 1,
+                  "address": "0x70"
+              }
             }
         )"_json;
-        std::unique_ptr<Configuration> configuration =
-            parseConfiguration(element);
-        EXPECT_EQ(configuration->getActions().size(), 1);
-        EXPECT_EQ(configuration->getVolts().has_value(), false);
+        parseDevice(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Required property missing: is_regulator");
     }
 
-    // Test where works: volts and actions properties specified
+    // Test where fails: Required fru property not specified
+    try
     {
         const json element = R"(
             {
-              "comments": [ "comments property" ],
-              "volts": 1.03,
-              "actions": [
-                { "pmbus_write_vout_command": { "format": "linear" } },
-                { "run_rule": "set_voltage_rule" }
-              ]
+              "id": "vdd_regulator",
+              "is_regulator": true,
+              "i2c_interface":
+              {
+                  "bus": 1,
+                  "address": "0x70"
+              }
             }
         )"_json;
-        std::unique_ptr<Configuration> configuration =
-            parseConfiguration(element);
-        EXPECT_EQ(configuration->getVolts().has_value(), true);
-        EXPECT_EQ(configuration->getVolts().value(), 1.03);
-        EXPECT_EQ(configuration->getActions().size(), 2);
+        parseDevice(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Required property missing: fru");
     }
 
-    // Test where works: volts and rule_id properties specified
+    // Test where fails: Required i2c_interface property not specified
+    try
     {
         const json element = R"(
             {
-              "volts": 1.05,
-              "rule_id": "set_voltage_rule"
+              "id": "vdd_regulator",
+              "is_regulator": true,
+              "fru": "system/chassis/motherboard/regulator2"
             }
         )"_json;
-        std::unique_ptr<Configuration> configuration =
-            parseConfiguration(element);
-        EXPECT_EQ(configuration->getVolts().has_value(), true);
-        EXPECT_EQ(configuration->getVolts().value(), 1.05);
-        EXPECT_EQ(configuration->getActions().size(), 1);
+        parseDevice(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Required property missing: i2c_interface");
     }
 
-    // Test where fails: volts value is invalid
+    // Test where fails: Element is not an object
     try
     {
-        const json element = R"(
-            {
-              "volts": "foo",
-              "actions": [
-                {
-                  "pmbus_write_vout_command": {
-                    "format": "linear"
-                  }
-                }
-              ]
-            }
-        )"_json;
-        parseConfiguration(element);
+        const json element = R"( [ "0xFF", "0x01" ] )"_json;
+        parseDevice(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Element is not a number");
+        EXPECT_STREQ(e.what(), "Element is not an object");
     }
 
-    // Test where fails: actions object is invalid
+    // Test where fails: Invalid property specified
     try
     {
         const json element = R"(
             {
-              "volts": 1.03,
-              "actions": 1
+              "id": "vdd_regulator",
+              "is_regulator": true,
+              "fru": "system/chassis/motherboard/regulator2",
+              "i2c_interface": { "bus": 1, "address": "0x70" },
+              "foo" : true
             }
         )"_json;
-        parseConfiguration(element);
+        parseDevice(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Element is not an array");
+        EXPECT_STREQ(e.what(), "Element contains an invalid property");
     }
+}
 
-    // Test where fails: rule_id value is invalid
+TEST(ConfigFileParserTests, ParseDeviceArray)
+{
+    // Test where works
+    {
+        const json element = R"(
+            [
+              {
+                "id": "vdd_regulator",
+                "is_regulator": true,
+                "fru": "system/chassis/motherboard/regulator2",
+                "i2c_interface": { "bus": 1, "address": "0x70" }
+              },
+              {
+                "id": "vio_regulator",
+                "is_regulator": true,
+                "fru": "system/chassis/motherboard/regulator2",
+                "i2c_interface": { "bus": 1, "address": "0x71" }
+              }
+            ]
+        )"_json;
+        std::vector<std::unique_ptr<Device>> devices =
+            parseDeviceArray(element);
+        EXPECT_EQ(devices.size(), 2);
+        EXPECT_EQ(devices[0]->getID(), "vdd_regulator");
+        EXPECT_EQ(devices[1]->getID(), "vio_regulator");
+    }
+
+    // Test where fails: Element is not an array
     try
     {
         const json element = R"(
             {
-              "volts": 1.05,
-              "rule_id": 1
+              "foo": "bar"
             }
         )"_json;
-        parseConfiguration(element);
+        parseDeviceArray(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Element is not a string");
+        EXPECT_STREQ(e.what(), "Element is not an array");
     }
+}
 
-    // Test where fails: Required actions or rule_id property not specified
+TEST(ConfigFileParserTests, ParseDouble)
+{
+    // Test where works: floating point value
+    {
+        const json element = R"( 1.03 )"_json;
+        double value = parseDouble(element);
+        EXPECT_EQ(value, 1.03);
+    }
+
+    // Test where works: integer value
+    {
+        const json element = R"( 24 )"_json;
+        double value = parseDouble(element);
+        EXPECT_EQ(value, 24.0);
+    }
+
+    // Test where fails: Element is not a number
     try
+    {
+        const json element = R"( true )"_json;
+        parseDouble(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Element is not a number");
+    }
+}
+
+TEST(ConfigFileParserTests, ParseEnableDetection)
+{
+    // Test where works: actions property specified
     {
         const json element = R"(
             {
-              "volts": 1.03
+              "actions": [
+                { "i2c_compare_bit": { "register": "0x01", "position": 7,
+                                       "value": 1 } }
+              ]
             }
         )"_json;
-        parseConfiguration(element);
-        ADD_FAILURE() << "Should not have reached this line.";
+        std::unique_ptr<EnableDetection> enableDetection =
+            parseEnableDetection(element);
+        EXPECT_EQ(enableDetection->getActions().size(), 1);
     }
-    catch (const std::invalid_argument& e)
+
+    // Test where works: rule_id property specified
     {
-        EXPECT_STREQ(e.what(), "Invalid property combination: Must contain "
-                               "either rule_id or actions");
+        const json element = R"(
+            {
+              "comments": [ "comments property" ],
+              "rule_id": "is_rail_on_rule"
+            }
+        )"_json;
+        std::unique_ptr<EnableDetection> enableDetection =
+            parseEnableDetection(element);
+        EXPECT_EQ(enableDetection->getActions().size(), 1);
     }
 
-    // Test where fails: Required actions or rule_id property both specified
+    // Test where fails: Required actions or rule_id property not specified
     try
     {
         const json element = R"(
             {
-              "volts": 1.03,
-              "rule_id": "set_voltage_rule",
-              "actions": [
-                {
-                  "pmbus_write_vout_command": {
-                    "format": "linear"
-                  }
-                }
-              ]
+              "comments": [ "comments property" ]
             }
         )"_json;
-        parseConfiguration(element);
+        parseEnableDetection(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
@@ -1540,8 +2942,8 @@ TEST(ConfigFileParserTests, ParseConfiguration)
     // Test where fails: Element is not an object
     try
     {
-        const json element = R"( [ "0xFF", "0x01" ] )"_json;
-        parseConfiguration(element);
+        const json element = R"( [ "foo", "bar" ] )"_json;
+        parseEnableDetection(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
@@ -1554,12 +2956,11 @@ TEST(ConfigFileParserTests, ParseConfiguration)
     {
         const json element = R"(
             {
-              "volts": 1.03,
-              "rule_id": "set_voltage_rule",
-              "foo": 1
+              "foo": "bar",
+              "rule_id": "is_rail_on_rule"
             }
         )"_json;
-        parseConfiguration(element);
+        parseEnableDetection(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
@@ -1568,315 +2969,175 @@ TEST(ConfigFileParserTests, ParseConfiguration)
     }
 }
 
-TEST(ConfigFileParserTests, ParseDevice)
+TEST(ConfigFileParserTests, ParseHexByte)
 {
-    // Test where works: Only required properties specified
-    {
-        const json element = R"(
-            {
-              "id": "vdd_regulator",
-              "is_regulator": true,
-              "fru": "system/chassis/motherboard/regulator2",
-              "i2c_interface": { "bus": 1, "address": "0x70" }
-            }
-        )"_json;
-        std::unique_ptr<Device> device = parseDevice(element);
-        EXPECT_EQ(device->getID(), "vdd_regulator");
-        EXPECT_EQ(device->isRegulator(), true);
-        EXPECT_EQ(device->getFRU(), "/xyz/openbmc_project/inventory/system/"
-                                    "chassis/motherboard/regulator2");
-        EXPECT_NE(&(device->getI2CInterface()), nullptr);
-        EXPECT_EQ(device->getPresenceDetection(), nullptr);
-        EXPECT_EQ(device->getConfiguration(), nullptr);
-        EXPECT_EQ(device->getPhaseFaultDetection(), nullptr);
-        EXPECT_EQ(device->getRails().size(), 0);
-    }
-
-    // Test where works: All properties specified
+    // Test where works: "0xFF"
     {
-        const json element = R"(
-            {
-              "comments": [ "VDD Regulator" ],
-              "id": "vdd_regulator",
-              "is_regulator": true,
-              "fru": "system/chassis/motherboard/regulator2",
-              "i2c_interface":
-              {
-                  "bus": 1,
-                  "address": "0x70"
-              },
-              "presence_detection":
-              {
-                  "rule_id": "is_foobar_backplane_installed_rule"
-              },
-              "configuration":
-              {
-                  "rule_id": "configure_ir35221_rule"
-              },
-              "phase_fault_detection":
-              {
-                  "rule_id": "detect_phase_fault_rule"
-              },
-              "rails":
-              [
-                {
-                  "id": "vdd"
-                }
-              ]
-            }
-        )"_json;
-        std::unique_ptr<Device> device = parseDevice(element);
-        EXPECT_EQ(device->getID(), "vdd_regulator");
-        EXPECT_EQ(device->isRegulator(), true);
-        EXPECT_EQ(device->getFRU(), "/xyz/openbmc_project/inventory/system/"
-                                    "chassis/motherboard/regulator2");
-        EXPECT_NE(&(device->getI2CInterface()), nullptr);
-        EXPECT_NE(device->getPresenceDetection(), nullptr);
-        EXPECT_NE(device->getConfiguration(), nullptr);
-        EXPECT_NE(device->getPhaseFaultDetection(), nullptr);
-        EXPECT_EQ(device->getRails().size(), 1);
+        const json element = R"( "0xFF" )"_json;
+        uint8_t value = parseHexByte(element);
+        EXPECT_EQ(value, 0xFF);
     }
 
-    // Test where fails: phase_fault_detection property exists and is_regulator
-    // is false
-    try
+    // Test where works: "0xff"
     {
-        const json element = R"(
-            {
-              "id": "vdd_regulator",
-              "is_regulator": false,
-              "fru": "system/chassis/motherboard/regulator2",
-              "i2c_interface":
-              {
-                  "bus": 1,
-                  "address": "0x70"
-              },
-              "phase_fault_detection":
-              {
-                  "rule_id": "detect_phase_fault_rule"
-              }
-            }
-        )"_json;
-        parseDevice(element);
-        ADD_FAILURE() << "Should not have reached this line.";
+        const json element = R"( "0xff" )"_json;
+        uint8_t value = parseHexByte(element);
+        EXPECT_EQ(value, 0xff);
     }
-    catch (const std::invalid_argument& e)
+
+    // Test where works: "0xf"
     {
-        EXPECT_STREQ(e.what(), "Invalid phase_fault_detection property when "
-                               "is_regulator is false");
+        const json element = R"( "0xf" )"_json;
+        uint8_t value = parseHexByte(element);
+        EXPECT_EQ(value, 0xf);
     }
 
-    // Test where fails: rails property exists and is_regulator is false
+    // Test where fails: "0xfff"
     try
     {
-        const json element = R"(
-            {
-              "id": "vdd_regulator",
-              "is_regulator": false,
-              "fru": "system/chassis/motherboard/regulator2",
-              "i2c_interface":
-              {
-                  "bus": 1,
-                  "address": "0x70"
-              },
-              "configuration":
-              {
-                  "rule_id": "configure_ir35221_rule"
-              },
-              "rails":
-              [
-                {
-                  "id": "vdd"
-                }
-              ]
-            }
-        )"_json;
-        parseDevice(element);
+        const json element = R"( "0xfff" )"_json;
+        parseHexByte(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(),
-                     "Invalid rails property when is_regulator is false");
+        EXPECT_STREQ(e.what(), "Element is not hexadecimal string");
     }
 
-    // Test where fails: id value is invalid
+    // Test where fails: "0xAG"
     try
     {
-        const json element = R"(
-            {
-              "id": 3,
-              "is_regulator": true,
-              "fru": "system/chassis/motherboard/regulator2",
-              "i2c_interface":
-              {
-                  "bus": 1,
-                  "address": "0x70"
-              }
-            }
-        )"_json;
-        parseDevice(element);
+        const json element = R"( "0xAG" )"_json;
+        parseHexByte(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Element is not a string");
+        EXPECT_STREQ(e.what(), "Element is not hexadecimal string");
     }
 
-    // Test where fails: is_regulator value is invalid
+    // Test where fails: "ff"
     try
     {
-        const json element = R"(
-            {
-              "id": "vdd_regulator",
-              "is_regulator": 3,
-              "fru": "system/chassis/motherboard/regulator2",
-              "i2c_interface":
-              {
-                  "bus": 1,
-                  "address": "0x70"
-              }
-            }
-        )"_json;
-        parseDevice(element);
+        const json element = R"( "ff" )"_json;
+        parseHexByte(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Element is not a boolean");
+        EXPECT_STREQ(e.what(), "Element is not hexadecimal string");
     }
 
-    // Test where fails: fru value is invalid
+    // Test where fails: ""
     try
     {
-        const json element = R"(
-            {
-              "id": "vdd_regulator",
-              "is_regulator": true,
-              "fru": 2,
-              "i2c_interface":
-              {
-                  "bus": 1,
-                  "address": "0x70"
-              }
-            }
-        )"_json;
-        parseDevice(element);
+        const json element = "";
+        parseHexByte(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Element is not a string");
+        EXPECT_STREQ(e.what(), "Element is not hexadecimal string");
     }
 
-    // Test where fails: i2c_interface value is invalid
+    // Test where fails: "f"
     try
     {
-        const json element = R"(
-            {
-              "id": "vdd_regulator",
-              "is_regulator": true,
-              "fru": "system/chassis/motherboard/regulator2",
-              "i2c_interface": 3
-            }
-        )"_json;
-        parseDevice(element);
+        const json element = R"( "f" )"_json;
+        parseHexByte(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Element is not an object");
+        EXPECT_STREQ(e.what(), "Element is not hexadecimal string");
     }
 
-    // Test where fails: Required id property not specified
+    // Test where fails: "0x"
     try
     {
-        const json element = R"(
-            {
-              "is_regulator": true,
-              "fru": "system/chassis/motherboard/regulator2",
-              "i2c_interface":
-              {
-                  "bus": 1,
-                  "address": "0x70"
-              }
-            }
-        )"_json;
-        parseDevice(element);
+        const json element = R"( "0x" )"_json;
+        parseHexByte(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Required property missing: id");
+        EXPECT_STREQ(e.what(), "Element is not hexadecimal string");
     }
 
-    // Test where fails: Required is_regulator property not specified
+    // Test where fails: "0Xff"
     try
     {
-        const json element = R"(
-            {
-              "id": "vdd_regulator",
-              "fru": "system/chassis/motherboard/regulator2",
-              "i2c_interface":
-              {
-                  "bus": 1,
-                  "address": "0x70"
-              }
-            }
-        )"_json;
-        parseDevice(element);
+        const json element = R"( "0XFF" )"_json;
+        parseHexByte(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Required property missing: is_regulator");
+        EXPECT_STREQ(e.what(), "Element is not hexadecimal string");
     }
+}
 
-    // Test where fails: Required fru property not specified
+TEST(ConfigFileParserTests, ParseHexByteArray)
+{
+    // Test where works
+    {
+        const json element = R"( [ "0xCC", "0xFF" ] )"_json;
+        std::vector<uint8_t> hexBytes = parseHexByteArray(element);
+        std::vector<uint8_t> expected = {0xcc, 0xff};
+        EXPECT_EQ(hexBytes, expected);
+    }
+
+    // Test where fails: Element is not an array
     try
     {
-        const json element = R"(
-            {
-              "id": "vdd_regulator",
-              "is_regulator": true,
-              "i2c_interface":
-              {
-                  "bus": 1,
-                  "address": "0x70"
-              }
-            }
-        )"_json;
-        parseDevice(element);
+        const json element = 0;
+        parseHexByteArray(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Required property missing: fru");
+        EXPECT_STREQ(e.what(), "Element is not an array");
     }
+}
 
-    // Test where fails: Required i2c_interface property not specified
-    try
+TEST(ConfigFileParserTests, ParseI2CCaptureBytes)
+{
+    // Test where works
     {
         const json element = R"(
             {
-              "id": "vdd_regulator",
-              "is_regulator": true,
-              "fru": "system/chassis/motherboard/regulator2"
+              "register": "0xA0",
+              "count": 2
             }
         )"_json;
-        parseDevice(element);
-        ADD_FAILURE() << "Should not have reached this line.";
+        std::unique_ptr<I2CCaptureBytesAction> action =
+            parseI2CCaptureBytes(element);
+        EXPECT_EQ(action->getRegister(), 0xA0);
+        EXPECT_EQ(action->getCount(), 2);
+        EXPECT_FALSE(action->getIsLargeRead());
     }
-    catch (const std::invalid_argument& e)
+
+    // Test where works: large_read specified
     {
-        EXPECT_STREQ(e.what(), "Required property missing: i2c_interface");
+        const json element = R"(
+            {
+              "register": "0xB2",
+              "count": 128,
+              "large_read": true
+            }
+        )"_json;
+        std::unique_ptr<I2CCaptureBytesAction> action =
+            parseI2CCaptureBytes(element);
+        EXPECT_EQ(action->getRegister(), 0xB2);
+        EXPECT_EQ(action->getCount(), 128);
+        EXPECT_TRUE(action->getIsLargeRead());
     }
 
     // Test where fails: Element is not an object
     try
     {
         const json element = R"( [ "0xFF", "0x01" ] )"_json;
-        parseDevice(element);
+        parseI2CCaptureBytes(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
@@ -1884,140 +3145,169 @@ TEST(ConfigFileParserTests, ParseDevice)
         EXPECT_STREQ(e.what(), "Element is not an object");
     }
 
-    // Test where fails: Invalid property specified
+    // Test where fails: register value is invalid
     try
     {
         const json element = R"(
             {
-              "id": "vdd_regulator",
-              "is_regulator": true,
-              "fru": "system/chassis/motherboard/regulator2",
-              "i2c_interface": { "bus": 1, "address": "0x70" },
-              "foo" : true
+              "register": "0x0Z",
+              "count": 2
             }
         )"_json;
-        parseDevice(element);
+        parseI2CCaptureBytes(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Element contains an invalid property");
+        EXPECT_STREQ(e.what(), "Element is not hexadecimal string");
     }
-}
 
-TEST(ConfigFileParserTests, ParseDeviceArray)
-{
-    // Test where works
+    // Test where fails: count value is invalid
+    try
     {
         const json element = R"(
-            [
-              {
-                "id": "vdd_regulator",
-                "is_regulator": true,
-                "fru": "system/chassis/motherboard/regulator2",
-                "i2c_interface": { "bus": 1, "address": "0x70" }
-              },
-              {
-                "id": "vio_regulator",
-                "is_regulator": true,
-                "fru": "system/chassis/motherboard/regulator2",
-                "i2c_interface": { "bus": 1, "address": "0x71" }
-              }
-            ]
+            {
+              "register": "0xA0",
+              "count": 0
+            }
         )"_json;
-        std::vector<std::unique_ptr<Device>> devices =
-            parseDeviceArray(element);
-        EXPECT_EQ(devices.size(), 2);
-        EXPECT_EQ(devices[0]->getID(), "vdd_regulator");
-        EXPECT_EQ(devices[1]->getID(), "vio_regulator");
+        parseI2CCaptureBytes(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Invalid byte count: Must be > 0");
+    }
+
+    // Test where fails: large_read value is invalid
+    try
+    {
+        const json element = R"(
+            {
+              "register": "0xA0",
+              "count": 2,
+              "large_read": 1
+            }
+        )"_json;
+        parseI2CCaptureBytes(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Element is not a boolean");
     }
 
-    // Test where fails: Element is not an array
+    // Test where fails: Required register property not specified
     try
     {
         const json element = R"(
             {
-              "foo": "bar"
+              "count": 2
             }
         )"_json;
-        parseDeviceArray(element);
+        parseI2CCaptureBytes(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Element is not an array");
+        EXPECT_STREQ(e.what(), "Required property missing: register");
     }
-}
 
-TEST(ConfigFileParserTests, ParseDouble)
-{
-    // Test where works: floating point value
+    // Test where fails: Required count property not specified
+    try
     {
-        const json element = R"( 1.03 )"_json;
-        double value = parseDouble(element);
-        EXPECT_EQ(value, 1.03);
+        const json element = R"(
+            {
+              "register": "0xA0"
+            }
+        )"_json;
+        parseI2CCaptureBytes(element);
+        ADD_FAILURE() << "Should not have reached this line.";
     }
-
-    // Test where works: integer value
+    catch (const std::invalid_argument& e)
     {
-        const json element = R"( 24 )"_json;
-        double value = parseDouble(element);
-        EXPECT_EQ(value, 24.0);
+        EXPECT_STREQ(e.what(), "Required property missing: count");
     }
 
-    // Test where fails: Element is not a number
+    // Test where fails: Invalid property specified
     try
     {
-        const json element = R"( true )"_json;
-        parseDouble(element);
+        const json element = R"(
+            {
+              "register": "0xA0",
+              "count": 2,
+              "foo": 3
+            }
+        )"_json;
+        parseI2CCaptureBytes(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Element is not a number");
+        EXPECT_STREQ(e.what(), "Element contains an invalid property");
     }
 }
 
-TEST(ConfigFileParserTests, ParseHexByte)
+TEST(ConfigFileParserTests, ParseI2CCompareBit)
 {
-    // Test where works: "0xFF"
+    // Test where works
     {
-        const json element = R"( "0xFF" )"_json;
-        uint8_t value = parseHexByte(element);
-        EXPECT_EQ(value, 0xFF);
+        const json element = R"(
+            {
+              "register": "0xA0",
+              "position": 3,
+              "value": 0
+            }
+        )"_json;
+        std::unique_ptr<I2CCompareBitAction> action =
+            parseI2CCompareBit(element);
+        EXPECT_EQ(action->getRegister(), 0xA0);
+        EXPECT_EQ(action->getPosition(), 3);
+        EXPECT_EQ(action->getValue(), 0);
     }
 
-    // Test where works: "0xff"
+    // Test where fails: Invalid property specified
+    try
     {
-        const json element = R"( "0xff" )"_json;
-        uint8_t value = parseHexByte(element);
-        EXPECT_EQ(value, 0xff);
+        const json element = R"(
+            {
+              "register": "0xA0",
+              "position": 3,
+              "value": 0,
+              "foo": 3
+            }
+        )"_json;
+        parseI2CCompareBit(element);
+        ADD_FAILURE() << "Should not have reached this line.";
     }
-
-    // Test where works: "0xf"
+    catch (const std::invalid_argument& e)
     {
-        const json element = R"( "0xf" )"_json;
-        uint8_t value = parseHexByte(element);
-        EXPECT_EQ(value, 0xf);
+        EXPECT_STREQ(e.what(), "Element contains an invalid property");
     }
 
-    // Test where fails: "0xfff"
+    // Test where fails: Element is not an object
     try
     {
-        const json element = R"( "0xfff" )"_json;
-        parseHexByte(element);
+        const json element = R"( [ "0xFF", "0x01" ] )"_json;
+        parseI2CCompareBit(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Element is not hexadecimal string");
+        EXPECT_STREQ(e.what(), "Element is not an object");
     }
 
-    // Test where fails: "0xAG"
+    // Test where fails: register value is invalid
     try
     {
-        const json element = R"( "0xAG" )"_json;
-        parseHexByte(element);
+        const json element = R"(
+            {
+              "register": "0xAG",
+              "position": 3,
+              "value": 0
+            }
+        )"_json;
+        parseI2CCompareBit(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
@@ -2025,116 +3315,156 @@ TEST(ConfigFileParserTests, ParseHexByte)
         EXPECT_STREQ(e.what(), "Element is not hexadecimal string");
     }
 
-    // Test where fails: "ff"
+    // Test where fails: position value is invalid
     try
     {
-        const json element = R"( "ff" )"_json;
-        parseHexByte(element);
+        const json element = R"(
+                {
+                  "register": "0xA0",
+                  "position": 8,
+                  "value": 0
+                }
+            )"_json;
+        parseI2CCompareBit(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Element is not hexadecimal string");
+        EXPECT_STREQ(e.what(), "Element is not a bit position");
     }
 
-    // Test where fails: ""
+    // Test where fails: value value is invalid
     try
     {
-        const json element = "";
-        parseHexByte(element);
+        const json element = R"(
+                {
+                  "register": "0xA0",
+                  "position": 3,
+                  "value": 2
+                }
+            )"_json;
+        parseI2CCompareBit(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Element is not hexadecimal string");
+        EXPECT_STREQ(e.what(), "Element is not a bit value");
     }
 
-    // Test where fails: "f"
+    // Test where fails: Required register property not specified
     try
     {
-        const json element = R"( "f" )"_json;
-        parseHexByte(element);
+        const json element = R"(
+            {
+              "position": 3,
+              "value": 0
+            }
+        )"_json;
+        parseI2CCompareBit(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Element is not hexadecimal string");
+        EXPECT_STREQ(e.what(), "Required property missing: register");
     }
 
-    // Test where fails: "0x"
+    // Test where fails: Required position property not specified
     try
     {
-        const json element = R"( "0x" )"_json;
-        parseHexByte(element);
+        const json element = R"(
+            {
+              "register": "0xA0",
+              "value": 0
+            }
+        )"_json;
+        parseI2CCompareBit(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Element is not hexadecimal string");
+        EXPECT_STREQ(e.what(), "Required property missing: position");
     }
 
-    // Test where fails: "0Xff"
+    // Test where fails: Required value property not specified
     try
     {
-        const json element = R"( "0XFF" )"_json;
-        parseHexByte(element);
+        const json element = R"(
+            {
+              "register": "0xA0",
+              "position": 3
+            }
+        )"_json;
+        parseI2CCompareBit(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Element is not hexadecimal string");
+        EXPECT_STREQ(e.what(), "Required property missing: value");
     }
 }
 
-TEST(ConfigFileParserTests, ParseHexByteArray)
+TEST(ConfigFileParserTests, ParseI2CCompareByte)
 {
-    // Test where works
+    // Test where works: Only required properties specified
     {
-        const json element = R"( [ "0xCC", "0xFF" ] )"_json;
-        std::vector<uint8_t> hexBytes = parseHexByteArray(element);
-        std::vector<uint8_t> expected = {0xcc, 0xff};
-        EXPECT_EQ(hexBytes, expected);
+        const json element = R"(
+            {
+              "register": "0x0A",
+              "value": "0xCC"
+            }
+        )"_json;
+        std::unique_ptr<I2CCompareByteAction> action =
+            parseI2CCompareByte(element);
+        EXPECT_EQ(action->getRegister(), 0x0A);
+        EXPECT_EQ(action->getValue(), 0xCC);
+        EXPECT_EQ(action->getMask(), 0xFF);
     }
 
-    // Test where fails: Element is not an array
+    // Test where works: All properties specified
+    {
+        const json element = R"(
+            {
+              "register": "0x0A",
+              "value": "0xCC",
+              "mask": "0xF7"
+            }
+        )"_json;
+        std::unique_ptr<I2CCompareByteAction> action =
+            parseI2CCompareByte(element);
+        EXPECT_EQ(action->getRegister(), 0x0A);
+        EXPECT_EQ(action->getValue(), 0xCC);
+        EXPECT_EQ(action->getMask(), 0xF7);
+    }
+
+    // Test where fails: Element is not an object
     try
     {
-        const json element = 0;
-        parseHexByteArray(element);
+        const json element = R"( [ "0xFF", "0x01" ] )"_json;
+        parseI2CCompareByte(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Element is not an array");
+        EXPECT_STREQ(e.what(), "Element is not an object");
     }
-}
 
-TEST(ConfigFileParserTests, ParseI2CCaptureBytes)
-{
-    // Test where works
+    // Test where fails: Invalid property specified
+    try
     {
         const json element = R"(
             {
-              "register": "0xA0",
-              "count": 2
+              "register": "0x0A",
+              "value": "0xCC",
+              "mask": "0xF7",
+              "foo": 1
             }
         )"_json;
-        std::unique_ptr<I2CCaptureBytesAction> action =
-            parseI2CCaptureBytes(element);
-        EXPECT_EQ(action->getRegister(), 0xA0);
-        EXPECT_EQ(action->getCount(), 2);
-    }
-
-    // Test where fails: Element is not an object
-    try
-    {
-        const json element = R"( [ "0xFF", "0x01" ] )"_json;
-        parseI2CCaptureBytes(element);
+        parseI2CCompareByte(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Element is not an object");
+        EXPECT_STREQ(e.what(), "Element contains an invalid property");
     }
 
     // Test where fails: register value is invalid
@@ -2143,10 +3473,11 @@ TEST(ConfigFileParserTests, ParseI2CCaptureBytes)
         const json element = R"(
             {
               "register": "0x0Z",
-              "count": 2
+              "value": "0xCC",
+              "mask": "0xF7"
             }
         )"_json;
-        parseI2CCaptureBytes(element);
+        parseI2CCompareByte(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
@@ -2154,121 +3485,147 @@ TEST(ConfigFileParserTests, ParseI2CCaptureBytes)
         EXPECT_STREQ(e.what(), "Element is not hexadecimal string");
     }
 
-    // Test where fails: count value is invalid
+    // Test where fails: value value is invalid
     try
     {
         const json element = R"(
             {
-              "register": "0xA0",
-              "count": 0
+              "register": "0x0A",
+              "value": "0xCCC",
+              "mask": "0xF7"
             }
         )"_json;
-        parseI2CCaptureBytes(element);
+        parseI2CCompareByte(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Invalid byte count: Must be > 0");
+        EXPECT_STREQ(e.what(), "Element is not hexadecimal string");
     }
 
-    // Test where fails: Required register property not specified
+    // Test where fails: mask value is invalid
     try
     {
         const json element = R"(
             {
-              "count": 2
+              "register": "0x0A",
+              "value": "0xCC",
+              "mask": "F7"
             }
         )"_json;
-        parseI2CCaptureBytes(element);
+        parseI2CCompareByte(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Required property missing: register");
+        EXPECT_STREQ(e.what(), "Element is not hexadecimal string");
     }
 
-    // Test where fails: Required count property not specified
+    // Test where fails: Required register property not specified
     try
     {
         const json element = R"(
             {
-              "register": "0xA0"
+              "value": "0xCC",
+              "mask": "0xF7"
             }
         )"_json;
-        parseI2CCaptureBytes(element);
+        parseI2CCompareByte(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Required property missing: count");
+        EXPECT_STREQ(e.what(), "Required property missing: register");
     }
 
-    // Test where fails: Invalid property specified
+    // Test where fails: Required value property not specified
     try
     {
         const json element = R"(
             {
-              "register": "0xA0",
-              "count": 2,
-              "foo": 3
+              "register": "0x0A",
+              "mask": "0xF7"
             }
         )"_json;
-        parseI2CCaptureBytes(element);
+        parseI2CCompareByte(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Element contains an invalid property");
+        EXPECT_STREQ(e.what(), "Required property missing: value");
     }
 }
 
-TEST(ConfigFileParserTests, ParseI2CCompareBit)
+TEST(ConfigFileParserTests, ParseI2CCompareBytes)
 {
-    // Test where works
+    // Test where works: Only required properties specified
     {
         const json element = R"(
             {
-              "register": "0xA0",
-              "position": 3,
-              "value": 0
+              "register": "0x0A",
+              "values": [ "0xCC", "0xFF" ]
             }
         )"_json;
-        std::unique_ptr<I2CCompareBitAction> action =
-            parseI2CCompareBit(element);
-        EXPECT_EQ(action->getRegister(), 0xA0);
-        EXPECT_EQ(action->getPosition(), 3);
-        EXPECT_EQ(action->getValue(), 0);
+        std::unique_ptr<I2CCompareBytesAction> action =
+            parseI2CCompareBytes(element);
+        EXPECT_EQ(action->getRegister(), 0x0A);
+        EXPECT_EQ(action->getValues().size(), 2);
+        EXPECT_EQ(action->getValues()[0], 0xCC);
+        EXPECT_EQ(action->getValues()[1], 0xFF);
+        EXPECT_EQ(action->getMasks().size(), 2);
+        EXPECT_EQ(action->getMasks()[0], 0xFF);
+        EXPECT_EQ(action->getMasks()[1], 0xFF);
     }
 
-    // Test where fails: Invalid property specified
-    try
+    // Test where works: All properties specified
     {
         const json element = R"(
             {
-              "register": "0xA0",
-              "position": 3,
-              "value": 0,
-              "foo": 3
+              "register": "0x0A",
+              "values": [ "0xCC", "0xFF" ],
+              "masks":  [ "0x7F", "0x77" ]
             }
         )"_json;
-        parseI2CCompareBit(element);
+        std::unique_ptr<I2CCompareBytesAction> action =
+            parseI2CCompareBytes(element);
+        EXPECT_EQ(action->getRegister(), 0x0A);
+        EXPECT_EQ(action->getValues().size(), 2);
+        EXPECT_EQ(action->getValues()[0], 0xCC);
+        EXPECT_EQ(action->getValues()[1], 0xFF);
+        EXPECT_EQ(action->getMasks().size(), 2);
+        EXPECT_EQ(action->getMasks()[0], 0x7F);
+        EXPECT_EQ(action->getMasks()[1], 0x77);
+    }
+
+    // Test where fails: Element is not an object
+    try
+    {
+        const json element = R"( [ "0xFF", "0x01" ] )"_json;
+        parseI2CCompareBytes(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Element contains an invalid property");
+        EXPECT_STREQ(e.what(), "Element is not an object");
     }
 
-    // Test where fails: Element is not an object
+    // Test where fails: Invalid property specified
     try
     {
-        const json element = R"( [ "0xFF", "0x01" ] )"_json;
-        parseI2CCompareBit(element);
+        const json element = R"(
+            {
+              "register": "0x0A",
+              "values": [ "0xCC", "0xFF" ],
+              "masks":  [ "0x7F", "0x7F" ],
+              "foo": 1
+            }
+        )"_json;
+        parseI2CCompareBytes(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Element is not an object");
+        EXPECT_STREQ(e.what(), "Element contains an invalid property");
     }
 
     // Test where fails: register value is invalid
@@ -2276,12 +3633,12 @@ TEST(ConfigFileParserTests, ParseI2CCompareBit)
     {
         const json element = R"(
             {
-              "register": "0xAG",
-              "position": 3,
-              "value": 0
+              "register": "0x0Z",
+              "values": [ "0xCC", "0xFF" ],
+              "masks":  [ "0x7F", "0x7F" ]
             }
         )"_json;
-        parseI2CCompareBit(element);
+        parseI2CCompareBytes(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
@@ -2289,298 +3646,267 @@ TEST(ConfigFileParserTests, ParseI2CCompareBit)
         EXPECT_STREQ(e.what(), "Element is not hexadecimal string");
     }
 
-    // Test where fails: position value is invalid
+    // Test where fails: values value is invalid
     try
     {
         const json element = R"(
-                {
-                  "register": "0xA0",
-                  "position": 8,
-                  "value": 0
-                }
-            )"_json;
-        parseI2CCompareBit(element);
+            {
+              "register": "0x0A",
+              "values": [ "0xCCC", "0xFF" ],
+              "masks":  [ "0x7F", "0x7F" ]
+            }
+        )"_json;
+        parseI2CCompareBytes(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Element is not a bit position");
+        EXPECT_STREQ(e.what(), "Element is not hexadecimal string");
     }
 
-    // Test where fails: value value is invalid
+    // Test where fails: masks value is invalid
     try
     {
         const json element = R"(
-                {
-                  "register": "0xA0",
-                  "position": 3,
-                  "value": 2
-                }
-            )"_json;
-        parseI2CCompareBit(element);
+            {
+              "register": "0x0A",
+              "values": [ "0xCC", "0xFF" ],
+              "masks":  [ "F", "0x7F" ]
+            }
+        )"_json;
+        parseI2CCompareBytes(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Element is not a bit value");
+        EXPECT_STREQ(e.what(), "Element is not hexadecimal string");
     }
 
-    // Test where fails: Required register property not specified
+    // Test where fails: number of elements in masks is invalid
     try
     {
         const json element = R"(
             {
-              "position": 3,
-              "value": 0
+              "register": "0x0A",
+              "values": [ "0xCC", "0xFF" ],
+              "masks":  [ "0x7F" ]
             }
         )"_json;
-        parseI2CCompareBit(element);
+        parseI2CCompareBytes(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Required property missing: register");
+        EXPECT_STREQ(e.what(), "Invalid number of elements in masks");
     }
 
-    // Test where fails: Required position property not specified
+    // Test where fails: Required register property not specified
     try
     {
         const json element = R"(
             {
-              "register": "0xA0",
-              "value": 0
+              "values": [ "0xCC", "0xFF" ]
             }
         )"_json;
-        parseI2CCompareBit(element);
+        parseI2CCompareBytes(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Required property missing: position");
+        EXPECT_STREQ(e.what(), "Required property missing: register");
     }
 
-    // Test where fails: Required value property not specified
+    // Test where fails: Required values property not specified
     try
     {
         const json element = R"(
             {
-              "register": "0xA0",
-              "position": 3
+              "register": "0x0A"
             }
         )"_json;
-        parseI2CCompareBit(element);
+        parseI2CCompareBytes(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Required property missing: value");
+        EXPECT_STREQ(e.what(), "Required property missing: values");
     }
 }
 
-TEST(ConfigFileParserTests, ParseI2CCompareByte)
+TEST(ConfigFileParserTests, ParseI2CInterface)
 {
     // Test where works: Only required properties specified
     {
+        i2c::clearBusBudgets();
         const json element = R"(
             {
-              "register": "0x0A",
-              "value": "0xCC"
+              "bus": 1,
+              "address": "0x70"
             }
         )"_json;
-        std::unique_ptr<I2CCompareByteAction> action =
-            parseI2CCompareByte(element);
-        EXPECT_EQ(action->getRegister(), 0x0A);
-        EXPECT_EQ(action->getValue(), 0xCC);
-        EXPECT_EQ(action->getMask(), 0xFF);
+        std::unique_ptr<i2c::I2CInterface> interface =
+            parseI2CInterface(element);
+        EXPECT_NE(interface.get(), nullptr);
+        EXPECT_FALSE(i2c::getBusBudget(1).has_value());
     }
 
-    // Test where works: All properties specified
+    // Test where works: max_transactions_per_second specified
     {
+        i2c::clearBusBudgets();
         const json element = R"(
             {
-              "register": "0x0A",
-              "value": "0xCC",
-              "mask": "0xF7"
+              "bus": 1,
+              "address": "0x70",
+              "max_transactions_per_second": 200
             }
         )"_json;
-        std::unique_ptr<I2CCompareByteAction> action =
-            parseI2CCompareByte(element);
-        EXPECT_EQ(action->getRegister(), 0x0A);
-        EXPECT_EQ(action->getValue(), 0xCC);
-        EXPECT_EQ(action->getMask(), 0xF7);
-    }
-
-    // Test where fails: Element is not an object
-    try
-    {
-        const json element = R"( [ "0xFF", "0x01" ] )"_json;
-        parseI2CCompareByte(element);
-        ADD_FAILURE() << "Should not have reached this line.";
-    }
-    catch (const std::invalid_argument& e)
-    {
-        EXPECT_STREQ(e.what(), "Element is not an object");
+        std::unique_ptr<i2c::I2CInterface> interface =
+            parseI2CInterface(element);
+        EXPECT_NE(interface.get(), nullptr);
+        ASSERT_TRUE(i2c::getBusBudget(1).has_value());
+        EXPECT_EQ(i2c::getBusBudget(1)->transactionsPerSecond, 200.0);
     }
 
-    // Test where fails: Invalid property specified
-    try
+    // Test where works: Lowest max_transactions_per_second on bus is used
     {
-        const json element = R"(
+        i2c::clearBusBudgets();
+        const json element1 = R"(
             {
-              "register": "0x0A",
-              "value": "0xCC",
-              "mask": "0xF7",
-              "foo": 1
+              "bus": 1,
+              "address": "0x70",
+              "max_transactions_per_second": 100
             }
         )"_json;
-        parseI2CCompareByte(element);
-        ADD_FAILURE() << "Should not have reached this line.";
-    }
-    catch (const std::invalid_argument& e)
-    {
-        EXPECT_STREQ(e.what(), "Element contains an invalid property");
+        const json element2 = R"(
+            {
+              "bus": 1,
+              "address": "0x71",
+              "max_transactions_per_second": 300
+            }
+        )"_json;
+        parseI2CInterface(element1);
+        parseI2CInterface(element2);
+        ASSERT_TRUE(i2c::getBusBudget(1).has_value());
+        EXPECT_EQ(i2c::getBusBudget(1)->transactionsPerSecond, 100.0);
+        i2c::clearBusBudgets();
     }
 
-    // Test where fails: register value is invalid
-    try
+    // Test where works: auto_increment specified
     {
         const json element = R"(
             {
-              "register": "0x0Z",
-              "value": "0xCC",
-              "mask": "0xF7"
+              "bus": 1,
+              "address": "0x70",
+              "auto_increment": true
             }
         )"_json;
-        parseI2CCompareByte(element);
-        ADD_FAILURE() << "Should not have reached this line.";
-    }
-    catch (const std::invalid_argument& e)
-    {
-        EXPECT_STREQ(e.what(), "Element is not hexadecimal string");
+        std::unique_ptr<i2c::I2CInterface> interface =
+            parseI2CInterface(element);
+        EXPECT_NE(interface.get(), nullptr);
     }
 
-    // Test where fails: value value is invalid
-    try
+    // Test where works: shadow_registers and volatile_registers specified
     {
         const json element = R"(
             {
-              "register": "0x0A",
-              "value": "0xCCC",
-              "mask": "0xF7"
+              "bus": 1,
+              "address": "0x70",
+              "shadow_registers": true,
+              "volatile_registers": [ "0x78" ]
             }
         )"_json;
-        parseI2CCompareByte(element);
-        ADD_FAILURE() << "Should not have reached this line.";
-    }
-    catch (const std::invalid_argument& e)
-    {
-        EXPECT_STREQ(e.what(), "Element is not hexadecimal string");
+        std::unique_ptr<i2c::I2CInterface> interface =
+            parseI2CInterface(element);
+        EXPECT_NE(interface.get(), nullptr);
     }
 
-    // Test where fails: mask value is invalid
+    // Test where fails: shadow_registers value is invalid
     try
     {
-        const json element = R"(
-            {
-              "register": "0x0A",
-              "value": "0xCC",
-              "mask": "F7"
+        const json element = R"(
+            {
+              "bus": 1,
+              "address": "0x70",
+              "shadow_registers": "true"
             }
         )"_json;
-        parseI2CCompareByte(element);
+        parseI2CInterface(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Element is not hexadecimal string");
+        EXPECT_STREQ(e.what(), "Element is not a boolean");
     }
 
-    // Test where fails: Required register property not specified
+    // Test where fails: volatile_registers value is invalid
     try
     {
         const json element = R"(
             {
-              "value": "0xCC",
-              "mask": "0xF7"
+              "bus": 1,
+              "address": "0x70",
+              "volatile_registers": [ "0x7G" ]
             }
         )"_json;
-        parseI2CCompareByte(element);
+        parseI2CInterface(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Required property missing: register");
+        EXPECT_STREQ(e.what(), "Element is not hexadecimal string");
     }
 
-    // Test where fails: Required value property not specified
+    // Test where fails: auto_increment value is invalid
     try
     {
         const json element = R"(
             {
-              "register": "0x0A",
-              "mask": "0xF7"
+              "bus": 1,
+              "address": "0x70",
+              "auto_increment": 1
             }
         )"_json;
-        parseI2CCompareByte(element);
+        parseI2CInterface(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Required property missing: value");
+        EXPECT_STREQ(e.what(), "Element is not a boolean");
     }
-}
 
-TEST(ConfigFileParserTests, ParseI2CCompareBytes)
-{
-    // Test where works: Only required properties specified
+    // Test where fails: max_transactions_per_second value is invalid
+    try
     {
         const json element = R"(
             {
-              "register": "0x0A",
-              "values": [ "0xCC", "0xFF" ]
+              "bus": 1,
+              "address": "0x70",
+              "max_transactions_per_second": 0
             }
         )"_json;
-        std::unique_ptr<I2CCompareBytesAction> action =
-            parseI2CCompareBytes(element);
-        EXPECT_EQ(action->getRegister(), 0x0A);
-        EXPECT_EQ(action->getValues().size(), 2);
-        EXPECT_EQ(action->getValues()[0], 0xCC);
-        EXPECT_EQ(action->getValues()[1], 0xFF);
-        EXPECT_EQ(action->getMasks().size(), 2);
-        EXPECT_EQ(action->getMasks()[0], 0xFF);
-        EXPECT_EQ(action->getMasks()[1], 0xFF);
+        parseI2CInterface(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(),
+                     "Invalid max_transactions_per_second value: Must be > 0");
     }
 
-    // Test where works: All properties specified
+    // Test where fails: Required address property not specified
+    try
     {
         const json element = R"(
             {
-              "register": "0x0A",
-              "values": [ "0xCC", "0xFF" ],
-              "masks":  [ "0x7F", "0x77" ]
+              "bus": 1
             }
         )"_json;
-        std::unique_ptr<I2CCompareBytesAction> action =
-            parseI2CCompareBytes(element);
-        EXPECT_EQ(action->getRegister(), 0x0A);
-        EXPECT_EQ(action->getValues().size(), 2);
-        EXPECT_EQ(action->getValues()[0], 0xCC);
-        EXPECT_EQ(action->getValues()[1], 0xFF);
-        EXPECT_EQ(action->getMasks().size(), 2);
-        EXPECT_EQ(action->getMasks()[0], 0x7F);
-        EXPECT_EQ(action->getMasks()[1], 0x77);
-    }
-
-    // Test where fails: Element is not an object
-    try
-    {
-        const json element = R"( [ "0xFF", "0x01" ] )"_json;
-        parseI2CCompareBytes(element);
+        parseI2CInterface(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Element is not an object");
+        EXPECT_STREQ(e.what(), "Required property missing: address");
     }
 
     // Test where fails: Invalid property specified
@@ -2588,122 +3914,112 @@ TEST(ConfigFileParserTests, ParseI2CCompareBytes)
     {
         const json element = R"(
             {
-              "register": "0x0A",
-              "values": [ "0xCC", "0xFF" ],
-              "masks":  [ "0x7F", "0x7F" ],
+              "bus": 1,
+              "address": "0x70",
               "foo": 1
             }
         )"_json;
-        parseI2CCompareBytes(element);
+        parseI2CInterface(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
         EXPECT_STREQ(e.what(), "Element contains an invalid property");
     }
+}
 
-    // Test where fails: register value is invalid
-    try
+TEST(ConfigFileParserTests, ParseI2CProbe)
+{
+    // Test where works: Method not specified
+    {
+        const json element = R"( {} )"_json;
+        std::unique_ptr<I2CProbeAction> action = parseI2CProbe(element);
+        EXPECT_EQ(action->getMethod(), I2CProbeAction::Method::readByte);
+    }
+
+    // Test where works: Method specified
     {
         const json element = R"(
             {
-              "register": "0x0Z",
-              "values": [ "0xCC", "0xFF" ],
-              "masks":  [ "0x7F", "0x7F" ]
+              "method": "quick"
             }
         )"_json;
-        parseI2CCompareBytes(element);
-        ADD_FAILURE() << "Should not have reached this line.";
-    }
-    catch (const std::invalid_argument& e)
-    {
-        EXPECT_STREQ(e.what(), "Element is not hexadecimal string");
+        std::unique_ptr<I2CProbeAction> action = parseI2CProbe(element);
+        EXPECT_EQ(action->getMethod(), I2CProbeAction::Method::quick);
     }
 
-    // Test where fails: values value is invalid
+    // Test where fails: Element is not an object
     try
     {
-        const json element = R"(
-            {
-              "register": "0x0A",
-              "values": [ "0xCCC", "0xFF" ],
-              "masks":  [ "0x7F", "0x7F" ]
-            }
-        )"_json;
-        parseI2CCompareBytes(element);
+        const json element = R"( [ "0xFF", "0x01" ] )"_json;
+        parseI2CProbe(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Element is not hexadecimal string");
+        EXPECT_STREQ(e.what(), "Element is not an object");
     }
 
-    // Test where fails: masks value is invalid
+    // Test where fails: method value is invalid
     try
     {
         const json element = R"(
             {
-              "register": "0x0A",
-              "values": [ "0xCC", "0xFF" ],
-              "masks":  [ "F", "0x7F" ]
+              "method": "write_byte"
             }
         )"_json;
-        parseI2CCompareBytes(element);
+        parseI2CProbe(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Element is not hexadecimal string");
+        EXPECT_STREQ(e.what(), "Element is not an I2C probe method");
     }
 
-    // Test where fails: number of elements in masks is invalid
+    // Test where fails: Invalid property specified
     try
     {
         const json element = R"(
             {
-              "register": "0x0A",
-              "values": [ "0xCC", "0xFF" ],
-              "masks":  [ "0x7F" ]
+              "method": "quick",
+              "foo": "bar"
             }
         )"_json;
-        parseI2CCompareBytes(element);
+        parseI2CProbe(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Invalid number of elements in masks");
+        EXPECT_STREQ(e.what(), "Element contains an invalid property");
     }
+}
 
-    // Test where fails: Required register property not specified
-    try
+TEST(ConfigFileParserTests, ParseI2CProbeMethod)
+{
+    // Test where works: quick
     {
-        const json element = R"(
-            {
-              "values": [ "0xCC", "0xFF" ]
-            }
-        )"_json;
-        parseI2CCompareBytes(element);
-        ADD_FAILURE() << "Should not have reached this line.";
+        const json element = "quick";
+        I2CProbeAction::Method method = parseI2CProbeMethod(element);
+        EXPECT_EQ(method, I2CProbeAction::Method::quick);
     }
-    catch (const std::invalid_argument& e)
+
+    // Test where works: read_byte
     {
-        EXPECT_STREQ(e.what(), "Required property missing: register");
+        const json element = "read_byte";
+        I2CProbeAction::Method method = parseI2CProbeMethod(element);
+        EXPECT_EQ(method, I2CProbeAction::Method::readByte);
     }
 
-    // Test where fails: Required values property not specified
+    // Test where fails: Element is not a string
     try
     {
-        const json element = R"(
-            {
-              "register": "0x0A"
-            }
-        )"_json;
-        parseI2CCompareBytes(element);
+        const json element = 1;
+        parseI2CProbeMethod(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Required property missing: values");
+        EXPECT_STREQ(e.what(), "Element is not a string");
     }
 }
 
@@ -3511,6 +4827,48 @@ TEST(ConfigFileParserTests, ParseLogPhaseFault)
     }
 }
 
+TEST(ConfigFileParserTests, ParseMonitoringInterval)
+{
+    // Test where works: Minimum value
+    {
+        const json element = R"( 100 )"_json;
+        EXPECT_EQ(parseMonitoringInterval(element),
+                  std::chrono::milliseconds{100});
+    }
+
+    // Test where works: Larger value
+    {
+        const json element = R"( 15000 )"_json;
+        EXPECT_EQ(parseMonitoringInterval(element),
+                  std::chrono::milliseconds{15000});
+    }
+
+    // Test where fails: Value is too small
+    try
+    {
+        const json element = R"( 99 )"_json;
+        parseMonitoringInterval(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Invalid monitoring interval: Must be >= 100 "
+                               "milliseconds");
+    }
+
+    // Test where fails: Element is not an unsigned integer
+    try
+    {
+        const json element = R"( "1000" )"_json;
+        parseMonitoringInterval(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Element is not an unsigned integer");
+    }
+}
+
 TEST(ConfigFileParserTests, ParseNot)
 {
     // Test where works
@@ -3757,19 +5115,174 @@ TEST(ConfigFileParserTests, ParsePhaseFaultType)
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Element is not a phase fault type");
+        EXPECT_STREQ(e.what(), "Element is not a phase fault type");
+    }
+
+    // Test where fails: Element is not a string
+    try
+    {
+        const json element = R"( { "foo": "bar" } )"_json;
+        parsePhaseFaultType(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Element is not a string");
+    }
+}
+
+TEST(ConfigFileParserTests, ParsePMBusReadBlockSensors)
+{
+    // Test where works: Only required properties specified
+    {
+        const json element = R"(
+            {
+              "command": "0xD8",
+              "sensors": [
+                { "type": "iout", "offset": 2, "format": "linear_11" }
+              ]
+            }
+        )"_json;
+        std::unique_ptr<PMBusReadBlockSensorsAction> action =
+            parsePMBusReadBlockSensors(element);
+        EXPECT_EQ(action->getCommand(), 0xD8);
+        ASSERT_EQ(action->getSensors().size(), 1);
+        EXPECT_EQ(action->getSensors()[0].type, SensorType::iout);
+        EXPECT_EQ(action->getSensors()[0].offset, 2);
+        EXPECT_EQ(action->getSensors()[0].format,
+                  pmbus_utils::SensorDataFormat::linear_11);
+        EXPECT_EQ(action->getSensors()[0].size, 2);
+        EXPECT_EQ(action->getExponent().has_value(), false);
+    }
+
+    // Test where works: All properties specified
+    {
+        const json element = R"(
+            {
+              "command": "0xD8",
+              "sensors": [
+                { "type": "vout", "offset": 0, "format": "linear_16" },
+                { "type": "temperature", "offset": 4, "format": "raw",
+                  "size": 1, "scale": 0.5 },
+                { "type": "pout", "offset": 6, "format": "raw" }
+              ],
+              "exponent": -8
+            }
+        )"_json;
+        std::unique_ptr<PMBusReadBlockSensorsAction> action =
+            parsePMBusReadBlockSensors(element);
+        ASSERT_EQ(action->getSensors().size(), 3);
+        EXPECT_EQ(action->getSensors()[0].format,
+                  pmbus_utils::SensorDataFormat::linear_16);
+        EXPECT_EQ(action->getSensors()[1].type, SensorType::temperature);
+        EXPECT_EQ(action->getSensors()[1].offset, 4);
+        EXPECT_EQ(action->getSensors()[1].format.has_value(), false);
+        EXPECT_EQ(action->getSensors()[1].size, 1);
+        EXPECT_EQ(action->getSensors()[1].scale, 0.5);
+        EXPECT_EQ(action->getSensors()[2].format.has_value(), false);
+        EXPECT_EQ(action->getSensors()[2].size, 2);
+        EXPECT_EQ(action->getSensors()[2].scale, 1.0);
+        EXPECT_EQ(action->getExponent().value(), -8);
+    }
+
+    // Test where fails: Element is not an object
+    try
+    {
+        const json element = R"( [ "0xFF", "0x01" ] )"_json;
+        parsePMBusReadBlockSensors(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Element is not an object");
+    }
+
+    // Test where fails: Required command property not specified
+    try
+    {
+        const json element = R"(
+            {
+              "sensors": [
+                { "type": "iout", "offset": 2, "format": "linear_11" }
+              ]
+            }
+        )"_json;
+        parsePMBusReadBlockSensors(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Required property missing: command");
+    }
+
+    // Test where fails: sensors array is empty
+    try
+    {
+        const json element = R"( { "command": "0xD8", "sensors": [] } )"_json;
+        parsePMBusReadBlockSensors(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Array must contain one or more sensors");
+    }
+
+    // Test where fails: scale specified for a linear sensor
+    try
+    {
+        const json element = R"(
+            {
+              "command": "0xD8",
+              "sensors": [
+                { "type": "iout", "offset": 2, "format": "linear_11",
+                  "scale": 2 }
+              ]
+            }
+        )"_json;
+        parsePMBusReadBlockSensors(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Element contains an invalid property");
+    }
+
+    // Test where fails: format value is invalid
+    try
+    {
+        const json element = R"(
+            {
+              "command": "0xD8",
+              "sensors": [
+                { "type": "iout", "offset": 2, "format": "foo" }
+              ]
+            }
+        )"_json;
+        parsePMBusReadBlockSensors(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Element is not a sensor data format");
     }
 
-    // Test where fails: Element is not a string
+    // Test where fails: offset value is past the end of the block
     try
     {
-        const json element = R"( { "foo": "bar" } )"_json;
-        parsePhaseFaultType(element);
+        const json element = R"(
+            {
+              "command": "0xD8",
+              "sensors": [
+                { "type": "iout", "offset": 31, "format": "linear_11" }
+              ]
+            }
+        )"_json;
+        parsePMBusReadBlockSensors(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Element is not a string");
+        EXPECT_STREQ(e.what(), "Invalid sensor offset: 31");
     }
 }
 
@@ -3811,6 +5324,26 @@ TEST(ConfigFileParserTests, ParsePMBusReadSensor)
                   pmbus_utils::SensorDataFormat::linear_16);
         EXPECT_EQ(action->getExponent().has_value(), true);
         EXPECT_EQ(action->getExponent().value(), -8);
+        EXPECT_EQ(action->getAggregation().has_value(), false);
+    }
+
+    // Test where works: aggregation specified
+    {
+        const json element = R"(
+            {
+              "type": "vout",
+              "command": "0x8B",
+              "format": "linear_16",
+              "aggregation": { "window_ms": 1000, "statistic": "maximum" }
+            }
+        )"_json;
+        std::unique_ptr<PMBusReadSensorAction> action =
+            parsePMBusReadSensor(element);
+        EXPECT_EQ(action->getType(), SensorType::vout);
+        EXPECT_EQ(action->getAggregation().has_value(), true);
+        EXPECT_EQ(action->getAggregation()->window.count(), 1000);
+        EXPECT_EQ(action->getAggregation()->statistic,
+                  SensorStatistic::maximum);
     }
 
     // Test where fails: Element is not an object
@@ -3969,6 +5502,148 @@ TEST(ConfigFileParserTests, ParsePMBusReadSensor)
     }
 }
 
+TEST(ConfigFileParserTests, ParsePMBusReadSensors)
+{
+    // Test where works: Only required properties specified
+    {
+        const json element = R"(
+            {
+              "sensors": [
+                { "type": "iout", "command": "0x8C", "format": "linear_11" }
+              ]
+            }
+        )"_json;
+        std::unique_ptr<PMBusReadSensorsAction> action =
+            parsePMBusReadSensors(element);
+        ASSERT_EQ(action->getSensors().size(), 1);
+        EXPECT_EQ(action->getSensors()[0].type, SensorType::iout);
+        EXPECT_EQ(action->getSensors()[0].command, 0x8C);
+        EXPECT_EQ(action->getSensors()[0].format,
+                  pmbus_utils::SensorDataFormat::linear_11);
+        EXPECT_EQ(action->getPage().has_value(), false);
+        EXPECT_EQ(action->getExponent().has_value(), false);
+    }
+
+    // Test where works: All properties specified
+    {
+        const json element = R"(
+            {
+              "sensors": [
+                { "type": "vout", "command": "0x8B", "format": "linear_16" },
+                { "type": "temperature", "command": "0x8D",
+                  "format": "linear_11" }
+              ],
+              "page": "0x01",
+              "exponent": -8
+            }
+        )"_json;
+        std::unique_ptr<PMBusReadSensorsAction> action =
+            parsePMBusReadSensors(element);
+        ASSERT_EQ(action->getSensors().size(), 2);
+        EXPECT_EQ(action->getSensors()[0].type, SensorType::vout);
+        EXPECT_EQ(action->getSensors()[0].command, 0x8B);
+        EXPECT_EQ(action->getSensors()[0].format,
+                  pmbus_utils::SensorDataFormat::linear_16);
+        EXPECT_EQ(action->getSensors()[1].type, SensorType::temperature);
+        EXPECT_EQ(action->getSensors()[1].command, 0x8D);
+        EXPECT_EQ(action->getPage().value(), 0x01);
+        EXPECT_EQ(action->getExponent().value(), -8);
+    }
+
+    // Test where fails: Element is not an object
+    try
+    {
+        const json element = R"( [ "0xFF", "0x01" ] )"_json;
+        parsePMBusReadSensors(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Element is not an object");
+    }
+
+    // Test where fails: Required sensors property not specified
+    try
+    {
+        const json element = R"( { "page": "0x01" } )"_json;
+        parsePMBusReadSensors(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Required property missing: sensors");
+    }
+
+    // Test where fails: sensors array is empty
+    try
+    {
+        const json element = R"( { "sensors": [] } )"_json;
+        parsePMBusReadSensors(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Array must contain one or more sensors");
+    }
+
+    // Test where fails: Invalid property specified in a sensor
+    try
+    {
+        const json element = R"(
+            {
+              "sensors": [
+                { "type": "iout", "command": "0x8C", "format": "linear_11",
+                  "exponent": -8 }
+              ]
+            }
+        )"_json;
+        parsePMBusReadSensors(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Element contains an invalid property");
+    }
+
+    // Test where fails: page value is invalid
+    try
+    {
+        const json element = R"(
+            {
+              "sensors": [
+                { "type": "iout", "command": "0x8C", "format": "linear_11" }
+              ],
+              "page": 1
+            }
+        )"_json;
+        parsePMBusReadSensors(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Element is not a string");
+    }
+
+    // Test where fails: Invalid property specified
+    try
+    {
+        const json element = R"(
+            {
+              "sensors": [
+                { "type": "iout", "command": "0x8C", "format": "linear_11" }
+              ],
+              "aggregation": { "window_ms": 1000 }
+            }
+        )"_json;
+        parsePMBusReadSensors(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Element contains an invalid property");
+    }
+}
+
 TEST(ConfigFileParserTests, ParsePMBusWriteVoutCommand)
 {
     // Test where works: Only required properties specified
@@ -4006,100 +5681,262 @@ TEST(ConfigFileParserTests, ParsePMBusWriteVoutCommand)
         EXPECT_EQ(action->isVerified(), true);
     }
 
-    // Test where fails: Element is not an object
+    // Test where fails: Element is not an object
+    try
+    {
+        const json element = R"( [ "0xFF", "0x01" ] )"_json;
+        parsePMBusWriteVoutCommand(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Element is not an object");
+    }
+
+    // Test where fails: volts value is invalid
+    try
+    {
+        const json element = R"(
+            {
+              "volts": "foo",
+              "format": "linear"
+            }
+        )"_json;
+        parsePMBusWriteVoutCommand(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Element is not a number");
+    }
+
+    // Test where fails: Required format property not specified
+    try
+    {
+        const json element = R"(
+            {
+              "volts": 1.03,
+              "is_verified": true
+            }
+        )"_json;
+        parsePMBusWriteVoutCommand(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Required property missing: format");
+    }
+
+    // Test where fails: format value is invalid
+    try
+    {
+        const json element = R"(
+            {
+              "format": "linear_11"
+            }
+        )"_json;
+        parsePMBusWriteVoutCommand(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Invalid format value: linear_11");
+    }
+
+    // Test where fails: exponent value is invalid
+    try
+    {
+        const json element = R"(
+            {
+              "format": "linear",
+              "exponent": 1.3
+            }
+        )"_json;
+        parsePMBusWriteVoutCommand(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Element is not an integer");
+    }
+
+    // Test where fails: is_verified value is invalid
+    try
+    {
+        const json element = R"(
+            {
+              "format": "linear",
+              "is_verified": "true"
+            }
+        )"_json;
+        parsePMBusWriteVoutCommand(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Element is not a boolean");
+    }
+
+    // Test where fails: Invalid property specified
+    try
+    {
+        const json element = R"(
+            {
+              "format": "linear",
+              "foo": "bar"
+            }
+        )"_json;
+        parsePMBusWriteVoutCommand(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Element contains an invalid property");
+    }
+}
+
+TEST(ConfigFileParserTests, ParsePowerDomain)
+{
+    // Test where works: Only required properties specified
+    {
+        const json element = R"(
+            {
+              "name": "cpu0",
+              "sequencer_rails": [ 4 ]
+            }
+        )"_json;
+        std::unique_ptr<PowerDomain> powerDomain = parsePowerDomain(element);
+        EXPECT_EQ(powerDomain->getName(), "cpu0");
+        EXPECT_EQ(powerDomain->getSequencerRails(),
+                  (std::vector<unsigned int>{4}));
+    }
+
+    // Test where works: All properties specified
+    {
+        const json element = R"(
+            {
+              "comments": [ "Regulators powered by the CPU 0 standby rails" ],
+              "name": "cpu0",
+              "sequencer_rails": [ 4, 5, 0 ]
+            }
+        )"_json;
+        std::unique_ptr<PowerDomain> powerDomain = parsePowerDomain(element);
+        EXPECT_EQ(powerDomain->getName(), "cpu0");
+        EXPECT_EQ(powerDomain->getSequencerRails(),
+                  (std::vector<unsigned int>{4, 5, 0}));
+    }
+
+    // Test where fails: Element is not an object
+    try
+    {
+        const json element = R"( [ "cpu0" ] )"_json;
+        parsePowerDomain(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Element is not an object");
+    }
+
+    // Test where fails: Required name property not specified
     try
     {
-        const json element = R"( [ "0xFF", "0x01" ] )"_json;
-        parsePMBusWriteVoutCommand(element);
+        const json element = R"(
+            {
+              "sequencer_rails": [ 4 ]
+            }
+        )"_json;
+        parsePowerDomain(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Element is not an object");
+        EXPECT_STREQ(e.what(), "Required property missing: name");
     }
 
-    // Test where fails: volts value is invalid
+    // Test where fails: name value is invalid
     try
     {
         const json element = R"(
             {
-              "volts": "foo",
-              "format": "linear"
+              "name": "",
+              "sequencer_rails": [ 4 ]
             }
         )"_json;
-        parsePMBusWriteVoutCommand(element);
+        parsePowerDomain(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Element is not a number");
+        EXPECT_STREQ(e.what(), "Element contains an empty string");
     }
 
-    // Test where fails: Required format property not specified
+    // Test where fails: Required sequencer_rails property not specified
     try
     {
         const json element = R"(
             {
-              "volts": 1.03,
-              "is_verified": true
+              "name": "cpu0"
             }
         )"_json;
-        parsePMBusWriteVoutCommand(element);
+        parsePowerDomain(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Required property missing: format");
+        EXPECT_STREQ(e.what(), "Required property missing: sequencer_rails");
     }
 
-    // Test where fails: format value is invalid
+    // Test where fails: sequencer_rails value is not an array
     try
     {
         const json element = R"(
             {
-              "format": "linear_11"
+              "name": "cpu0",
+              "sequencer_rails": 4
             }
         )"_json;
-        parsePMBusWriteVoutCommand(element);
+        parsePowerDomain(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Invalid format value: linear_11");
+        EXPECT_STREQ(e.what(), "Element is not an array");
     }
 
-    // Test where fails: exponent value is invalid
+    // Test where fails: sequencer_rails array is empty
     try
     {
         const json element = R"(
             {
-              "format": "linear",
-              "exponent": 1.3
+              "name": "cpu0",
+              "sequencer_rails": [ ]
             }
         )"_json;
-        parsePMBusWriteVoutCommand(element);
+        parsePowerDomain(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Element is not an integer");
+        EXPECT_STREQ(e.what(),
+                     "Array must contain one or more sequencer rails");
     }
 
-    // Test where fails: is_verified value is invalid
+    // Test where fails: sequencer_rails element is invalid
     try
     {
         const json element = R"(
             {
-              "format": "linear",
-              "is_verified": "true"
+              "name": "cpu0",
+              "sequencer_rails": [ -1 ]
             }
         )"_json;
-        parsePMBusWriteVoutCommand(element);
+        parsePowerDomain(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Element is not a boolean");
+        EXPECT_STREQ(e.what(), "Element is not an unsigned integer");
     }
 
     // Test where fails: Invalid property specified
@@ -4107,11 +5944,12 @@ TEST(ConfigFileParserTests, ParsePMBusWriteVoutCommand)
     {
         const json element = R"(
             {
-              "format": "linear",
-              "foo": "bar"
+              "name": "cpu0",
+              "sequencer_rails": [ 4 ],
+              "foo": true
             }
         )"_json;
-        parsePMBusWriteVoutCommand(element);
+        parsePowerDomain(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
@@ -4134,6 +5972,24 @@ TEST(ConfigFileParserTests, ParsePresenceDetection)
         std::unique_ptr<PresenceDetection> presenceDetection =
             parsePresenceDetection(element);
         EXPECT_EQ(presenceDetection->getActions().size(), 1);
+        EXPECT_FALSE(presenceDetection->getCacheTTL().has_value());
+    }
+
+    // Test where works: cache_ttl_ms property specified
+    {
+        const json element = R"(
+            {
+              "actions": [
+                { "i2c_probe": { "method": "quick" } }
+              ],
+              "cache_ttl_ms": 5000
+            }
+        )"_json;
+        std::unique_ptr<PresenceDetection> presenceDetection =
+            parsePresenceDetection(element);
+        EXPECT_EQ(presenceDetection->getActions().size(), 1);
+        EXPECT_EQ(presenceDetection->getCacheTTL(),
+                  std::chrono::milliseconds{5000});
     }
 
     // Test where works: rule_id property specified
@@ -4218,6 +6074,40 @@ TEST(ConfigFileParserTests, ParsePresenceDetection)
                                "either rule_id or actions");
     }
 
+    // Test where fails: cache_ttl_ms value is zero
+    try
+    {
+        const json element = R"(
+            {
+              "rule_id": "set_voltage_rule",
+              "cache_ttl_ms": 0
+            }
+        )"_json;
+        parsePresenceDetection(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Invalid presence cache TTL: Must be > 0");
+    }
+
+    // Test where fails: cache_ttl_ms value is invalid
+    try
+    {
+        const json element = R"(
+            {
+              "rule_id": "set_voltage_rule",
+              "cache_ttl_ms": -1
+            }
+        )"_json;
+        parsePresenceDetection(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Element is not an unsigned integer");
+    }
+
     // Test where fails: Element is not an object
     try
     {
@@ -4263,6 +6153,7 @@ TEST(ConfigFileParserTests, ParseRail)
         EXPECT_EQ(rail->getID(), "vdd");
         EXPECT_EQ(rail->getConfiguration(), nullptr);
         EXPECT_EQ(rail->getSensorMonitoring(), nullptr);
+        EXPECT_EQ(rail->getVoltageSetpoint(), nullptr);
     }
 
     // Test where works: All properties specified
@@ -4285,6 +6176,10 @@ TEST(ConfigFileParserTests, ParseRail)
                 "actions": [
                   { "run_rule": "read_sensors_rule" }
                 ]
+              },
+              "voltage_setpoint": {
+                "min_volts": 0.7,
+                "max_volts": 1.2
               }
             }
         )"_json;
@@ -4292,6 +6187,7 @@ TEST(ConfigFileParserTests, ParseRail)
         EXPECT_EQ(rail->getID(), "vdd");
         EXPECT_NE(rail->getConfiguration(), nullptr);
         EXPECT_NE(rail->getSensorMonitoring(), nullptr);
+        EXPECT_NE(rail->getVoltageSetpoint(), nullptr);
     }
 
     // Test where fails: id property not specified
@@ -4402,6 +6298,23 @@ TEST(ConfigFileParserTests, ParseRail)
         EXPECT_STREQ(e.what(), "Element is not an object");
     }
 
+    // Test where fails: voltage_setpoint value is invalid
+    try
+    {
+        const json element = R"(
+            {
+              "id": "vdd",
+              "voltage_setpoint": 1
+            }
+        )"_json;
+        parseRail(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Element is not an object");
+    }
+
     // Test where fails: Invalid property specified
     try
     {
@@ -4424,27 +6337,244 @@ TEST(ConfigFileParserTests, ParseRailArray)
 {
     // Test where works
     {
-        const json element = R"(
-            [
-              { "id": "vdd" },
-              { "id": "vio" }
-            ]
-        )"_json;
-        std::vector<std::unique_ptr<Rail>> rails = parseRailArray(element);
-        EXPECT_EQ(rails.size(), 2);
-        EXPECT_EQ(rails[0]->getID(), "vdd");
-        EXPECT_EQ(rails[1]->getID(), "vio");
+        const json element = R"(
+            [
+              { "id": "vdd" },
+              { "id": "vio" }
+            ]
+        )"_json;
+        std::vector<std::unique_ptr<Rail>> rails = parseRailArray(element);
+        EXPECT_EQ(rails.size(), 2);
+        EXPECT_EQ(rails[0]->getID(), "vdd");
+        EXPECT_EQ(rails[1]->getID(), "vio");
+    }
+
+    // Test where fails: Element is not an array
+    try
+    {
+        const json element = R"(
+            {
+              "foo": "bar"
+            }
+        )"_json;
+        parseRailArray(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Element is not an array");
+    }
+}
+
+TEST(ConfigFileParserTests, ParseRoot)
+{
+    // Test where works: Only required properties specified
+    {
+        const json element = R"(
+            {
+              "chassis": [
+                { "number": 1, "inventory_path": "system/chassis" }
+              ]
+            }
+        )"_json;
+        std::vector<std::unique_ptr<Rule>> rules{};
+        std::vector<std::unique_ptr<Chassis>> chassis{};
+        std::tie(rules, chassis) = parseRoot(element);
+        EXPECT_EQ(rules.size(), 0);
+        EXPECT_EQ(chassis.size(), 1);
+    }
+
+    // Test where works: All properties specified
+    {
+        const json element = R"(
+            {
+              "comments": [ "Config file for a FooBar one-chassis system" ],
+              "rules": [
+                {
+                  "id": "set_voltage_rule",
+                  "actions": [
+                    { "pmbus_write_vout_command": { "format": "linear" } }
+                  ]
+                }
+              ],
+              "chassis": [
+                { "number": 1, "inventory_path": "system/chassis1" },
+                { "number": 3, "inventory_path": "system/chassis3" }
+              ]
+            }
+        )"_json;
+        std::vector<std::unique_ptr<Rule>> rules{};
+        std::vector<std::unique_ptr<Chassis>> chassis{};
+        std::tie(rules, chassis) = parseRoot(element);
+        EXPECT_EQ(rules.size(), 1);
+        EXPECT_EQ(chassis.size(), 2);
+    }
+
+    // Test where fails: Element is not an object
+    try
+    {
+        const json element = R"( [ "0xFF", "0x01" ] )"_json;
+        parseRoot(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Element is not an object");
+    }
+
+    // Test where fails: chassis property not specified
+    try
+    {
+        const json element = R"(
+            {
+              "rules": [
+                {
+                  "id": "set_voltage_rule",
+                  "actions": [
+                    { "pmbus_write_vout_command": { "format": "linear" } }
+                  ]
+                }
+              ]
+            }
+        )"_json;
+        parseRoot(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Required property missing: chassis");
+    }
+
+    // Test where fails: Invalid property specified
+    try
+    {
+        const json element = R"(
+            {
+              "remarks": [ "Config file for a FooBar one-chassis system" ],
+              "chassis": [
+                { "number": 1, "inventory_path": "system/chassis" }
+              ]
+            }
+        )"_json;
+        parseRoot(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Element contains an invalid property");
+    }
+}
+
+TEST(ConfigFileParserTests, ParseRootParallel)
+{
+    // Create a root element with enough rules and chassis to be split across
+    // multiple worker threads
+    auto createElement = []() {
+        json element = json::object();
+        element["rules"] = json::array();
+        for (unsigned int i = 0; i < 200; ++i)
+        {
+            element["rules"].push_back(
+                {{"id", "rule" + std::to_string(i)},
+                 {"actions",
+                  {{{"pmbus_write_vout_command", {{"format", "linear"}}}}}}});
+        }
+        element["chassis"] = json::array();
+        for (unsigned int i = 1; i <= 100; ++i)
+        {
+            element["chassis"].push_back(
+                {{"number", i},
+                 {"inventory_path", "system/chassis" + std::to_string(i)}});
+        }
+        return element;
+    };
+
+    // Test where works: Objects are in the same order as the config file
+    {
+        const json element = createElement();
+        std::vector<std::unique_ptr<Rule>> rules{};
+        std::vector<std::unique_ptr<Chassis>> chassis{};
+        std::tie(rules, chassis) = parseRoot(element, 4);
+        ASSERT_EQ(rules.size(), 200);
+        for (unsigned int i = 0; i < rules.size(); ++i)
+        {
+            EXPECT_EQ(rules[i]->getID(), "rule" + std::to_string(i));
+        }
+        ASSERT_EQ(chassis.size(), 100);
+        for (unsigned int i = 0; i < chassis.size(); ++i)
+        {
+            EXPECT_EQ(chassis[i]->getNumber(), i + 1);
+        }
+    }
+
+    // Test where works: More threads than elements
+    {
+        json element = createElement();
+        element["rules"].erase(element["rules"].begin() + 1,
+                               element["rules"].end());
+        element["chassis"].erase(element["chassis"].begin() + 1,
+                                 element["chassis"].end());
+        std::vector<std::unique_ptr<Rule>> rules{};
+        std::vector<std::unique_ptr<Chassis>> chassis{};
+        std::tie(rules, chassis) = parseRoot(element, 16);
+        ASSERT_EQ(rules.size(), 1);
+        EXPECT_EQ(rules[0]->getID(), "rule0");
+        ASSERT_EQ(chassis.size(), 1);
+        EXPECT_EQ(chassis[0]->getNumber(), 1);
+    }
+
+    // Test where fails: First error in the config file is reported when
+    // errors occur in different ranges of the rule and chassis arrays
+    try
+    {
+        json element = createElement();
+        element["rules"][20]["id"] = "";
+        element["rules"][180].erase("id");
+        element["chassis"][5]["number"] = 0u;
+        parseRoot(element, 4);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Element contains an empty string");
+    }
+
+    // Test where fails: Error in the chassis array is reported when the rules
+    // are valid
+    try
+    {
+        json element = createElement();
+        element["chassis"][90]["number"] = 0u;
+        element["chassis"][95].erase("inventory_path");
+        parseRoot(element, 4);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Invalid chassis number: Must be > 0");
+    }
+
+    // Test where fails: Error in the rule array is reported before the
+    // chassis property is found to be missing
+    try
+    {
+        json element = createElement();
+        element["rules"][150].erase("id");
+        element.erase("chassis");
+        parseRoot(element, 4);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Required property missing: id");
     }
 
-    // Test where fails: Element is not an array
+    // Test where fails: chassis property is not an array
     try
     {
-        const json element = R"(
-            {
-              "foo": "bar"
-            }
-        )"_json;
-        parseRailArray(element);
+        json element = createElement();
+        element["chassis"] = "system/chassis";
+        parseRoot(element, 4);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
@@ -4453,31 +6583,33 @@ TEST(ConfigFileParserTests, ParseRailArray)
     }
 }
 
-TEST(ConfigFileParserTests, ParseRoot)
+TEST(ConfigFileParserTests, ParseRootStreaming)
 {
     // Test where works: Only required properties specified
     {
-        const json element = R"(
+        std::istringstream input{R"(
             {
               "chassis": [
                 { "number": 1, "inventory_path": "system/chassis" }
               ]
             }
-        )"_json;
+        )"};
         std::vector<std::unique_ptr<Rule>> rules{};
         std::vector<std::unique_ptr<Chassis>> chassis{};
-        std::tie(rules, chassis) = parseRoot(element);
+        std::tie(rules, chassis) = parseRootStreaming(input);
         EXPECT_EQ(rules.size(), 0);
         EXPECT_EQ(chassis.size(), 1);
     }
 
-    // Test where works: All properties specified
+    // Test where works: All properties specified.  Nested arrays and objects
+    // do not affect parsing of the rules and chassis arrays.
     {
-        const json element = R"(
+        std::istringstream input{R"(
             {
               "comments": [ "Config file for a FooBar one-chassis system" ],
               "rules": [
                 {
+                  "comments": [ "Sets the output voltage" ],
                   "id": "set_voltage_rule",
                   "actions": [
                     { "pmbus_write_vout_command": { "format": "linear" } }
@@ -4489,19 +6621,23 @@ TEST(ConfigFileParserTests, ParseRoot)
                 { "number": 3, "inventory_path": "system/chassis3" }
               ]
             }
-        )"_json;
+        )"};
         std::vector<std::unique_ptr<Rule>> rules{};
         std::vector<std::unique_ptr<Chassis>> chassis{};
-        std::tie(rules, chassis) = parseRoot(element);
+        std::tie(rules, chassis) = parseRootStreaming(input);
         EXPECT_EQ(rules.size(), 1);
+        EXPECT_EQ(rules[0]->getID(), "set_voltage_rule");
+        EXPECT_EQ(rules[0]->getActions().size(), 1);
         EXPECT_EQ(chassis.size(), 2);
+        EXPECT_EQ(chassis[0]->getNumber(), 1);
+        EXPECT_EQ(chassis[1]->getNumber(), 3);
     }
 
     // Test where fails: Element is not an object
     try
     {
-        const json element = R"( [ "0xFF", "0x01" ] )"_json;
-        parseRoot(element);
+        std::istringstream input{R"( [ "0xFF", "0x01" ] )"};
+        parseRootStreaming(input);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
@@ -4512,7 +6648,7 @@ TEST(ConfigFileParserTests, ParseRoot)
     // Test where fails: chassis property not specified
     try
     {
-        const json element = R"(
+        std::istringstream input{R"(
             {
               "rules": [
                 {
@@ -4523,8 +6659,8 @@ TEST(ConfigFileParserTests, ParseRoot)
                 }
               ]
             }
-        )"_json;
-        parseRoot(element);
+        )"};
+        parseRootStreaming(input);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
@@ -4532,24 +6668,75 @@ TEST(ConfigFileParserTests, ParseRoot)
         EXPECT_STREQ(e.what(), "Required property missing: chassis");
     }
 
+    // Test where fails: chassis property is not an array
+    try
+    {
+        std::istringstream input{R"(
+            {
+              "chassis": { "number": 1, "inventory_path": "system/chassis" }
+            }
+        )"};
+        parseRootStreaming(input);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Element is not an array");
+    }
+
     // Test where fails: Invalid property specified
     try
     {
-        const json element = R"(
+        std::istringstream input{R"(
             {
               "remarks": [ "Config file for a FooBar one-chassis system" ],
               "chassis": [
                 { "number": 1, "inventory_path": "system/chassis" }
               ]
             }
-        )"_json;
-        parseRoot(element);
+        )"};
+        parseRootStreaming(input);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
         EXPECT_STREQ(e.what(), "Element contains an invalid property");
     }
+
+    // Test where fails: Error when parsing rule element
+    try
+    {
+        std::istringstream input{R"(
+            {
+              "rules": [ { "id": "set_voltage_rule" } ],
+              "chassis": [
+                { "number": 1, "inventory_path": "system/chassis" }
+              ]
+            }
+        )"};
+        parseRootStreaming(input);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Required property missing: actions");
+    }
+
+    // Test where fails: Error when parsing chassis element
+    try
+    {
+        std::istringstream input{R"(
+            {
+              "chassis": [ 1 ]
+            }
+        )"};
+        parseRootStreaming(input);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Element is not an object");
+    }
 }
 
 TEST(ConfigFileParserTests, ParseRule)
@@ -4571,6 +6758,29 @@ TEST(ConfigFileParserTests, ParseRule)
         EXPECT_EQ(rule->getActions().size(), 2);
     }
 
+    // Test where works: Definition hash set.  Same for an identical
+    // definition, different for a changed definition.
+    {
+        const json element = R"(
+            {
+              "id": "set_voltage_rule",
+              "actions": [
+                { "pmbus_write_vout_command": { "volts": 1.01, "format": "linear" } }
+              ]
+            }
+        )"_json;
+        std::unique_ptr<Rule> rule = parseRule(element);
+        EXPECT_NE(rule->getDefinitionHash(), 0);
+        EXPECT_EQ(parseRule(element)->getDefinitionHash(),
+                  rule->getDefinitionHash());
+
+        json changedElement = element;
+        changedElement["actions"][0]["pmbus_write_vout_command"]["volts"] =
+            1.02;
+        EXPECT_NE(parseRule(changedElement)->getDefinitionHash(),
+                  rule->getDefinitionHash());
+    }
+
     // Test where works: comments property not specified
     {
         const json element = R"(
@@ -4781,102 +6991,328 @@ TEST(ConfigFileParserTests, ParseRuleIDOrActionsProperty)
         const json element = R"(
             { "rule_id": 1 }
         )"_json;
-        parseRuleIDOrActionsProperty(element);
+        parseRuleIDOrActionsProperty(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Element is not a string");
+    }
+
+    // Test where fails: actions is invalid
+    try
+    {
+        const json element = R"(
+            { "actions": 1 }
+        )"_json;
+        parseRuleIDOrActionsProperty(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Element is not an array");
+    }
+
+    // Test where fails: Neither rule_id nor actions specified
+    try
+    {
+        const json element = R"(
+            {
+              "volts": 1.03
+            }
+        )"_json;
+        parseRuleIDOrActionsProperty(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Invalid property combination: Must contain "
+                               "either rule_id or actions");
+    }
+
+    // Test where fails: Both rule_id and actions specified
+    try
+    {
+        const json element = R"(
+            {
+              "volts": 1.03,
+              "rule_id": "set_voltage_rule",
+              "actions": [
+                {
+                  "pmbus_write_vout_command": {
+                    "format": "linear"
+                  }
+                }
+              ]
+            }
+        )"_json;
+        parseRuleIDOrActionsProperty(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Invalid property combination: Must contain "
+                               "either rule_id or actions");
+    }
+}
+
+TEST(ConfigFileParserTests, ParseRunRule)
+{
+    // Test where works
+    {
+        const json element = "vdd_regulator";
+        std::unique_ptr<RunRuleAction> action = parseRunRule(element);
+        EXPECT_EQ(action->getRuleID(), "vdd_regulator");
+    }
+
+    // Test where fails: Element is not a string
+    try
+    {
+        const json element = 1;
+        parseRunRule(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Element is not a string");
+    }
+
+    // Test where fails: Empty string
+    try
+    {
+        const json element = "";
+        parseRunRule(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Element contains an empty string");
+    }
+}
+
+TEST(ConfigFileParserTests, ParseSamplingGroup)
+{
+    // Test where works: actions property specified
+    {
+        const json element = R"(
+            {
+              "comments": [ "Read temperature every tenth time" ],
+              "divisor": 10,
+              "actions": [
+                { "run_rule": "read_temperature_rule" },
+                { "run_rule": "read_pout_rule" }
+              ]
+            }
+        )"_json;
+        SamplingGroup samplingGroup = parseSamplingGroup(element);
+        EXPECT_EQ(samplingGroup.divisor, 10);
+        EXPECT_EQ(samplingGroup.actions.size(), 2);
+    }
+
+    // Test where works: rule_id property specified
+    {
+        const json element = R"(
+            {
+              "divisor": 1,
+              "rule_id": "read_temperature_rule"
+            }
+        )"_json;
+        SamplingGroup samplingGroup = parseSamplingGroup(element);
+        EXPECT_EQ(samplingGroup.divisor, 1);
+        EXPECT_EQ(samplingGroup.actions.size(), 1);
+    }
+
+    // Test where fails: Element is not an object
+    try
+    {
+        const json element = R"( [ "0xFF", "0x01" ] )"_json;
+        parseSamplingGroup(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Element is not an object");
+    }
+
+    // Test where fails: Required divisor property not specified
+    try
+    {
+        const json element = R"( { "rule_id": "read_temperature_rule" } )"_json;
+        parseSamplingGroup(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Required property missing: divisor");
+    }
+
+    // Test where fails: divisor value is invalid
+    try
+    {
+        const json element = R"(
+            {
+              "divisor": 0,
+              "rule_id": "read_temperature_rule"
+            }
+        )"_json;
+        parseSamplingGroup(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Invalid divisor value: Must be >= 1");
+    }
+
+    // Test where fails: Neither rule_id nor actions specified
+    try
+    {
+        const json element = R"( { "divisor": 10 } )"_json;
+        parseSamplingGroup(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Invalid property combination: Must contain "
+                               "either rule_id or actions");
+    }
+
+    // Test where fails: Invalid property specified
+    try
+    {
+        const json element = R"(
+            {
+              "divisor": 10,
+              "rule_id": "read_temperature_rule",
+              "foo": 1
+            }
+        )"_json;
+        parseSamplingGroup(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Element is not a string");
+        EXPECT_STREQ(e.what(), "Element contains an invalid property");
     }
+}
 
-    // Test where fails: actions is invalid
-    try
+TEST(ConfigFileParserTests, ParseSamplingGroupArray)
+{
+    // Test where works
     {
         const json element = R"(
-            { "actions": 1 }
+            [
+              { "divisor": 5, "rule_id": "read_pout_rule" },
+              { "divisor": 10, "rule_id": "read_temperature_rule" }
+            ]
         )"_json;
-        parseRuleIDOrActionsProperty(element);
+        std::vector<SamplingGroup> samplingGroups =
+            parseSamplingGroupArray(element);
+        ASSERT_EQ(samplingGroups.size(), 2);
+        EXPECT_EQ(samplingGroups[0].divisor, 5);
+        EXPECT_EQ(samplingGroups[1].divisor, 10);
+    }
+
+    // Test where fails: Element is not an array
+    try
+    {
+        const json element = R"( { "divisor": 5 } )"_json;
+        parseSamplingGroupArray(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
         EXPECT_STREQ(e.what(), "Element is not an array");
     }
+}
 
-    // Test where fails: Neither rule_id nor actions specified
-    try
+TEST(ConfigFileParserTests, ParseSensorAggregation)
+{
+    // Test where works: Only required properties specified
+    {
+        const json element = R"( { "window_ms": 500 } )"_json;
+        SensorAggregation aggregation = parseSensorAggregation(element);
+        EXPECT_EQ(aggregation.window.count(), 500);
+        EXPECT_EQ(aggregation.statistic, SensorStatistic::mean);
+    }
+
+    // Test where works: All properties specified
     {
         const json element = R"(
             {
-              "volts": 1.03
+              "comments": [ "Publish peak-to-peak voltage every 2 seconds" ],
+              "window_ms": 2000,
+              "statistic": "peak_to_peak"
             }
         )"_json;
-        parseRuleIDOrActionsProperty(element);
+        SensorAggregation aggregation = parseSensorAggregation(element);
+        EXPECT_EQ(aggregation.window.count(), 2000);
+        EXPECT_EQ(aggregation.statistic, SensorStatistic::peak_to_peak);
+    }
+
+    // Test where fails: Element is not an object
+    try
+    {
+        const json element = R"( [ 1000 ] )"_json;
+        parseSensorAggregation(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Invalid property combination: Must contain "
-                               "either rule_id or actions");
+        EXPECT_STREQ(e.what(), "Element is not an object");
     }
 
-    // Test where fails: Both rule_id and actions specified
+    // Test where fails: Required window_ms property not specified
     try
     {
-        const json element = R"(
-            {
-              "volts": 1.03,
-              "rule_id": "set_voltage_rule",
-              "actions": [
-                {
-                  "pmbus_write_vout_command": {
-                    "format": "linear"
-                  }
-                }
-              ]
-            }
-        )"_json;
-        parseRuleIDOrActionsProperty(element);
+        const json element = R"( { "statistic": "mean" } )"_json;
+        parseSensorAggregation(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Invalid property combination: Must contain "
-                               "either rule_id or actions");
+        EXPECT_STREQ(e.what(), "Required property missing: window_ms");
     }
-}
 
-TEST(ConfigFileParserTests, ParseRunRule)
-{
-    // Test where works
+    // Test where fails: window_ms value is invalid
+    try
     {
-        const json element = "vdd_regulator";
-        std::unique_ptr<RunRuleAction> action = parseRunRule(element);
-        EXPECT_EQ(action->getRuleID(), "vdd_regulator");
+        const json element = R"( { "window_ms": 50 } )"_json;
+        parseSensorAggregation(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Invalid monitoring interval: Must be >= 100 "
+                               "milliseconds");
     }
 
-    // Test where fails: Element is not a string
+    // Test where fails: statistic value is invalid
     try
     {
-        const json element = 1;
-        parseRunRule(element);
+        const json element = R"(
+            {
+              "window_ms": 1000,
+              "statistic": "foo"
+            }
+        )"_json;
+        parseSensorAggregation(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Element is not a string");
+        EXPECT_STREQ(e.what(), "Element is not a sensor statistic");
     }
 
-    // Test where fails: Empty string
+    // Test where fails: Invalid property specified
     try
     {
-        const json element = "";
-        parseRunRule(element);
+        const json element = R"( { "window_ms": 1000, "foo": 1 } )"_json;
+        parseSensorAggregation(element);
         ADD_FAILURE() << "Should not have reached this line.";
     }
     catch (const std::invalid_argument& e)
     {
-        EXPECT_STREQ(e.what(), "Element contains an empty string");
+        EXPECT_STREQ(e.what(), "Element contains an invalid property");
     }
 }
 
@@ -4952,6 +7388,99 @@ TEST(ConfigFileParserTests, ParseSensorMonitoring)
         std::unique_ptr<SensorMonitoring> sensorMonitoring =
             parseSensorMonitoring(element);
         EXPECT_EQ(sensorMonitoring->getActions().size(), 1);
+        EXPECT_EQ(sensorMonitoring->getInterval(),
+                  SensorMonitoring::defaultInterval);
+        EXPECT_FALSE(sensorMonitoring->getAdaptiveInterval().has_value());
+    }
+
+    // Test where works: interval_ms and adaptive_interval properties specified
+    {
+        const json element = R"(
+            {
+              "rule_id": "read_sensors_rule",
+              "interval_ms": 5000,
+              "adaptive_interval": { "min_interval_ms": 500 }
+            }
+        )"_json;
+        std::unique_ptr<SensorMonitoring> sensorMonitoring =
+            parseSensorMonitoring(element);
+        EXPECT_EQ(sensorMonitoring->getActions().size(), 1);
+        EXPECT_EQ(sensorMonitoring->getInterval(),
+                  std::chrono::milliseconds{5000});
+        EXPECT_EQ(sensorMonitoring->getAdaptiveInterval()->minInterval,
+                  std::chrono::milliseconds{500});
+        EXPECT_EQ(sensorMonitoring->getMinInterval(),
+                  std::chrono::milliseconds{500});
+    }
+
+    // Test where works: sampling_groups property specified
+    {
+        const json element = R"(
+            {
+              "rule_id": "read_iout_rule",
+              "sampling_groups": [
+                { "divisor": 10, "rule_id": "read_temperature_rule" }
+              ]
+            }
+        )"_json;
+        std::unique_ptr<SensorMonitoring> sensorMonitoring =
+            parseSensorMonitoring(element);
+        EXPECT_EQ(sensorMonitoring->getActions().size(), 1);
+        ASSERT_EQ(sensorMonitoring->getSamplingGroups().size(), 1);
+        EXPECT_EQ(sensorMonitoring->getSamplingGroups()[0].divisor, 10);
+    }
+
+    // Test where works: enable_detection property specified
+    {
+        const json element = R"(
+            {
+              "rule_id": "read_sensors_rule",
+              "enable_detection": { "rule_id": "is_rail_on_rule" }
+            }
+        )"_json;
+        std::unique_ptr<SensorMonitoring> sensorMonitoring =
+            parseSensorMonitoring(element);
+        EXPECT_EQ(sensorMonitoring->getActions().size(), 1);
+        ASSERT_NE(sensorMonitoring->getEnableDetection(), nullptr);
+        EXPECT_EQ(sensorMonitoring->getEnableDetection()->getActions().size(),
+                  1);
+    }
+
+    // Test where fails: interval_ms value is invalid
+    try
+    {
+        const json element = R"(
+            {
+              "rule_id": "read_sensors_rule",
+              "interval_ms": 50
+            }
+        )"_json;
+        parseSensorMonitoring(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Invalid monitoring interval: Must be >= 100 "
+                               "milliseconds");
+    }
+
+    // Test where fails: min_interval_ms is larger than interval_ms
+    try
+    {
+        const json element = R"(
+            {
+              "rule_id": "read_sensors_rule",
+              "interval_ms": 1000,
+              "adaptive_interval": { "min_interval_ms": 2000 }
+            }
+        )"_json;
+        parseSensorMonitoring(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(),
+                     "Invalid min_interval_ms value: Must be <= interval_ms");
     }
 
     // Test where fails: actions object is invalid
@@ -5055,6 +7584,58 @@ TEST(ConfigFileParserTests, ParseSensorMonitoring)
     }
 }
 
+TEST(ConfigFileParserTests, ParseSensorStatistic)
+{
+    // Test where works: minimum
+    {
+        const json element = "minimum";
+        EXPECT_EQ(parseSensorStatistic(element), SensorStatistic::minimum);
+    }
+
+    // Test where works: maximum
+    {
+        const json element = "maximum";
+        EXPECT_EQ(parseSensorStatistic(element), SensorStatistic::maximum);
+    }
+
+    // Test where works: mean
+    {
+        const json element = "mean";
+        EXPECT_EQ(parseSensorStatistic(element), SensorStatistic::mean);
+    }
+
+    // Test where works: peak_to_peak
+    {
+        const json element = "peak_to_peak";
+        EXPECT_EQ(parseSensorStatistic(element),
+                  SensorStatistic::peak_to_peak);
+    }
+
+    // Test where fails: Element is not a sensor statistic
+    try
+    {
+        const json element = "average";
+        parseSensorStatistic(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Element is not a sensor statistic");
+    }
+
+    // Test where fails: Element is not a string
+    try
+    {
+        const json element = R"( { "foo": "bar" } )"_json;
+        parseSensorStatistic(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Element is not a string");
+    }
+}
+
 TEST(ConfigFileParserTests, ParseSensorType)
 {
     // Test where works: iout
@@ -5307,6 +7888,135 @@ TEST(ConfigFileParserTests, ParseUnsignedInteger)
     }
 }
 
+TEST(ConfigFileParserTests, ParseVoltageSetpoint)
+{
+    // Test where works: Only required properties specified
+    {
+        const json element = R"(
+            {
+              "min_volts": 0.7,
+              "max_volts": 1.2
+            }
+        )"_json;
+        std::unique_ptr<VoltageSetpoint> setpoint =
+            parseVoltageSetpoint(element);
+        EXPECT_EQ(setpoint->getMinimum(), 0.7);
+        EXPECT_EQ(setpoint->getMaximum(), 1.2);
+        EXPECT_FALSE(setpoint->getPage().has_value());
+        EXPECT_FALSE(setpoint->getExponent().has_value());
+    }
+
+    // Test where works: All properties specified
+    {
+        const json element = R"(
+            {
+              "comments": [ "comments property" ],
+              "min_volts": 0.7,
+              "max_volts": 1.2,
+              "page": "0x01",
+              "exponent": -8
+            }
+        )"_json;
+        std::unique_ptr<VoltageSetpoint> setpoint =
+            parseVoltageSetpoint(element);
+        EXPECT_EQ(setpoint->getMinimum(), 0.7);
+        EXPECT_EQ(setpoint->getMaximum(), 1.2);
+        EXPECT_EQ(setpoint->getPage(), 0x01);
+        EXPECT_EQ(setpoint->getExponent(), -8);
+    }
+
+    // Test where fails: Element is not an object
+    try
+    {
+        const json element = R"( [ 0.7, 1.2 ] )"_json;
+        parseVoltageSetpoint(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Element is not an object");
+    }
+
+    // Test where fails: min_volts property not specified
+    try
+    {
+        const json element = R"( { "max_volts": 1.2 } )"_json;
+        parseVoltageSetpoint(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Required property missing: min_volts");
+    }
+
+    // Test where fails: max_volts property not specified
+    try
+    {
+        const json element = R"( { "min_volts": 0.7 } )"_json;
+        parseVoltageSetpoint(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Required property missing: max_volts");
+    }
+
+    // Test where fails: min_volts is greater than max_volts
+    try
+    {
+        const json element = R"(
+            {
+              "min_volts": 1.2,
+              "max_volts": 0.7
+            }
+        )"_json;
+        parseVoltageSetpoint(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(
+            e.what(),
+            "Invalid voltage setpoint: min_volts must be <= max_volts");
+    }
+
+    // Test where fails: page value is invalid
+    try
+    {
+        const json element = R"(
+            {
+              "min_volts": 0.7,
+              "max_volts": 1.2,
+              "page": 1
+            }
+        )"_json;
+        parseVoltageSetpoint(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Element is not a string");
+    }
+
+    // Test where fails: Invalid property specified
+    try
+    {
+        const json element = R"(
+            {
+              "min_volts": 0.7,
+              "max_volts": 1.2,
+              "foo": 1
+            }
+        )"_json;
+        parseVoltageSetpoint(element);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::invalid_argument& e)
+    {
+        EXPECT_STREQ(e.what(), "Element contains an invalid property");
+    }
+}
+
 TEST(ConfigFileParserTests, ParseVoutDataFormat)
 {
     // Test where works: linear
@@ -0,0 +1,297 @@
+/**
+ * Copyright © 2026 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "action.hpp"
+#include "chassis.hpp"
+#include "config_file_parser.hpp"
+#include "config_reload.hpp"
+#include "device.hpp"
+#include "id_map.hpp"
+#include "rule.hpp"
+#include "system.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <map>
+#include <memory>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace phosphor::power::regulators;
+using namespace phosphor::power::regulators::config_reload;
+using namespace phosphor::power::regulators::config_reload::internal;
+using namespace phosphor::power::regulators::config_file_parser::internal;
+using json = nlohmann::json;
+
+/**
+ * Creates a device with the specified ID, I2C bus, and configuration rule.
+ */
+static std::unique_ptr<Device> createDevice(const std::string& id,
+                                            unsigned int bus,
+                                            const std::string& ruleID)
+{
+    json element = R"(
+        {
+          "is_regulator": true,
+          "fru": "system/chassis/motherboard/regulator1",
+          "rails": [ { "id": "" } ]
+        }
+    )"_json;
+    element["id"] = id;
+    element["i2c_interface"] = json{{"bus", bus}, {"address", "0x70"}};
+    element["configuration"] = json{{"rule_id", ruleID}};
+    element["rails"][0]["id"] = id + "_rail";
+    return parseDevice(element);
+}
+
+/**
+ * Creates a rule with the specified ID that sets the specified volts.
+ */
+static std::unique_ptr<Rule> createRule(const std::string& id, double volts)
+{
+    json element = R"(
+        {
+          "actions": [
+            { "pmbus_write_vout_command": { "format": "linear" } }
+          ]
+        }
+    )"_json;
+    element["id"] = id;
+    element["actions"][0]["pmbus_write_vout_command"]["volts"] = volts;
+    return parseRule(element);
+}
+
+/**
+ * Returns the specified rules keyed by ID.
+ */
+static std::map<std::string, const Rule*>
+    createRuleMap(const std::vector<std::unique_ptr<Rule>>& rules)
+{
+    std::map<std::string, const Rule*> ruleMap{};
+    for (const std::unique_ptr<Rule>& rule : rules)
+    {
+        ruleMap.emplace(rule->getID(), rule.get());
+    }
+    return ruleMap;
+}
+
+TEST(ConfigReloadTests, ReuseUnchangedDevices)
+{
+    // Create old system
+    std::vector<std::unique_ptr<Rule>> oldRules{};
+    oldRules.emplace_back(createRule("rule1", 1.0));
+    oldRules.emplace_back(createRule("rule2", 1.1));
+    std::vector<std::unique_ptr<Device>> oldDevices{};
+    oldDevices.emplace_back(createDevice("reg1", 1, "rule1"));
+    oldDevices.emplace_back(createDevice("reg2", 1, "rule2"));
+    oldDevices.emplace_back(createDevice("reg3", 1, "rule1"));
+    std::vector<std::unique_ptr<Chassis>> oldChassis{};
+    oldChassis.emplace_back(std::make_unique<Chassis>(
+        1, "/xyz/openbmc_project/inventory/system/chassis",
+        std::move(oldDevices)));
+    System oldSystem{std::move(oldRules), std::move(oldChassis)};
+    Device* reg1 = &(oldSystem.getIDMap().getDevice("reg1"));
+
+    // Test where works: Only reg1 is unchanged.  The rule run by reg2 changed,
+    // the I2C bus of reg3 changed, and reg4 is new.
+    {
+        std::vector<std::unique_ptr<Rule>> rules{};
+        rules.emplace_back(createRule("rule1", 1.0));
+        rules.emplace_back(createRule("rule2", 1.2));
+        std::vector<std::unique_ptr<Device>> devices{};
+        devices.emplace_back(createDevice("reg4", 1, "rule1"));
+        devices.emplace_back(createDevice("reg3", 2, "rule1"));
+        devices.emplace_back(createDevice("reg2", 1, "rule2"));
+        devices.emplace_back(createDevice("reg1", 1, "rule1"));
+        Device* reg2 = devices[2].get();
+        std::vector<std::unique_ptr<Chassis>> chassis{};
+        chassis.emplace_back(std::make_unique<Chassis>(
+            1, "/xyz/openbmc_project/inventory/system/chassis",
+            std::move(devices)));
+
+        EXPECT_EQ(reuseUnchangedDevices(oldSystem, rules, chassis), 1);
+        const auto& newDevices = chassis[0]->getDevices();
+        EXPECT_EQ(newDevices.size(), 4);
+        EXPECT_EQ(newDevices[3].get(), reg1);
+        EXPECT_EQ(newDevices[2].get(), reg2);
+        EXPECT_EQ(oldSystem.getChassis()[0]->getDevices()[0], nullptr);
+        EXPECT_NE(oldSystem.getChassis()[0]->getDevices()[1], nullptr);
+
+        // Verify the reused device works in a new system
+        System system{std::move(rules), std::move(chassis)};
+        EXPECT_EQ(&(system.getIDMap().getDevice("reg1")), reg1);
+    }
+}
+
+TEST(ConfigReloadTests, ReuseUnchangedDevicesChassisNumber)
+{
+    std::vector<std::unique_ptr<Rule>> oldRules{};
+    oldRules.emplace_back(createRule("rule1", 1.0));
+    std::vector<std::unique_ptr<Device>> oldDevices{};
+    oldDevices.emplace_back(createDevice("reg1", 1, "rule1"));
+    std::vector<std::unique_ptr<Chassis>> oldChassis{};
+    oldChassis.emplace_back(std::make_unique<Chassis>(
+        1, "/xyz/openbmc_project/inventory/system/chassis1",
+        std::move(oldDevices)));
+    System oldSystem{std::move(oldRules), std::move(oldChassis)};
+
+    // Test where device not reused: Moved to a different chassis
+    std::vector<std::unique_ptr<Rule>> rules{};
+    rules.emplace_back(createRule("rule1", 1.0));
+    std::vector<std::unique_ptr<Device>> devices{};
+    devices.emplace_back(createDevice("reg1", 1, "rule1"));
+    std::vector<std::unique_ptr<Chassis>> chassis{};
+    chassis.emplace_back(std::make_unique<Chassis>(
+        2, "/xyz/openbmc_project/inventory/system/chassis2",
+        std::move(devices)));
+    EXPECT_EQ(reuseUnchangedDevices(oldSystem, rules, chassis), 0);
+    EXPECT_NE(oldSystem.getChassis()[0]->getDevices()[0], nullptr);
+}
+
+TEST(ConfigReloadTests, ReuseUnchangedDevicesDuplicateID)
+{
+    std::vector<std::unique_ptr<Rule>> oldRules{};
+    oldRules.emplace_back(createRule("rule1", 1.0));
+    std::vector<std::unique_ptr<Device>> oldDevices{};
+    oldDevices.emplace_back(createDevice("reg1", 1, "rule1"));
+    std::vector<std::unique_ptr<Chassis>> oldChassis{};
+    oldChassis.emplace_back(std::make_unique<Chassis>(
+        1, "/xyz/openbmc_project/inventory/system/chassis",
+        std::move(oldDevices)));
+    System oldSystem{std::move(oldRules), std::move(oldChassis)};
+
+    // Test where fails: Duplicate rule ID.  No devices are moved.
+    std::vector<std::unique_ptr<Rule>> rules{};
+    rules.emplace_back(createRule("rule1", 1.0));
+    rules.emplace_back(createRule("rule1", 1.0));
+    std::vector<std::unique_ptr<Device>> devices{};
+    devices.emplace_back(createDevice("reg1", 1, "rule1"));
+    std::vector<std::unique_ptr<Chassis>> chassis{};
+    chassis.emplace_back(std::make_unique<Chassis>(
+        1, "/xyz/openbmc_project/inventory/system/chassis",
+        std::move(devices)));
+    EXPECT_THROW(reuseUnchangedDevices(oldSystem, rules, chassis),
+                 std::invalid_argument);
+    EXPECT_NE(oldSystem.getChassis()[0]->getDevices()[0], nullptr);
+}
+
+TEST(ConfigReloadTests, GetRuleIDs)
+{
+    // Rules run from nested actions and from other rules, including a rule
+    // that runs itself
+    std::vector<std::unique_ptr<Rule>> rules{};
+    rules.emplace_back(parseRule(R"(
+        {
+          "id": "rule1",
+          "actions": [ { "run_rule": "rule2" }, { "run_rule": "rule1" } ]
+        }
+    )"_json));
+    rules.emplace_back(createRule("rule2", 1.0));
+    rules.emplace_back(createRule("rule3", 1.0));
+    rules.emplace_back(createRule("rule4", 1.0));
+    rules.emplace_back(createRule("rule5", 1.0));
+    rules.emplace_back(createRule("unused_rule", 1.0));
+    std::map<std::string, const Rule*> ruleMap = createRuleMap(rules);
+
+    std::unique_ptr<Device> device = parseDevice(R"(
+        {
+          "id": "reg1",
+          "is_regulator": true,
+          "fru": "system/chassis/motherboard/regulator1",
+          "i2c_interface": { "bus": 1, "address": "0x70" },
+          "configuration": {
+            "actions": [
+              { "and": [ { "run_rule": "rule1" }, { "run_rule": "rule1" } ] },
+              { "if": {
+                  "condition": { "not": { "run_rule": "rule3" } },
+                  "then": [
+                    {
+                      "or": [ { "run_rule": "rule4" }, { "run_rule": "rule4" } ]
+                    }
+                  ],
+                  "else": [ { "run_rule": "missing_rule" } ]
+              } }
+            ]
+          },
+          "rails": [
+            {
+              "id": "rail1",
+              "sensor_monitoring": { "rule_id": "rule5" }
+            }
+          ]
+        }
+    )"_json);
+
+    std::set<std::string> expected{"missing_rule", "rule1", "rule2",
+                                   "rule3",        "rule4", "rule5"};
+    EXPECT_EQ(getRuleIDs(*device, ruleMap), expected);
+}
+
+TEST(ConfigReloadTests, IsUnchanged)
+{
+    std::vector<std::unique_ptr<Rule>> oldRules{};
+    oldRules.emplace_back(createRule("rule1", 1.0));
+    std::map<std::string, const Rule*> oldRuleMap = createRuleMap(oldRules);
+
+    // Test where unchanged
+    {
+        std::vector<std::unique_ptr<Rule>> newRules{};
+        newRules.emplace_back(createRule("rule1", 1.0));
+        EXPECT_TRUE(isUnchanged(*createDevice("reg1", 1, "rule1"),
+                                *createDevice("reg1", 1, "rule1"), oldRuleMap,
+                                createRuleMap(newRules)));
+    }
+
+    // Test where changed: Device definition changed
+    {
+        std::vector<std::unique_ptr<Rule>> newRules{};
+        newRules.emplace_back(createRule("rule1", 1.0));
+        EXPECT_FALSE(isUnchanged(*createDevice("reg1", 1, "rule1"),
+                                 *createDevice("reg1", 3, "rule1"), oldRuleMap,
+                                 createRuleMap(newRules)));
+    }
+
+    // Test where changed: Rule definition changed
+    {
+        std::vector<std::unique_ptr<Rule>> newRules{};
+        newRules.emplace_back(createRule("rule1", 1.5));
+        EXPECT_FALSE(isUnchanged(*createDevice("reg1", 1, "rule1"),
+                                 *createDevice("reg1", 1, "rule1"), oldRuleMap,
+                                 createRuleMap(newRules)));
+    }
+
+    // Test where changed: Rule removed
+    {
+        std::map<std::string, const Rule*> newRuleMap{};
+        EXPECT_FALSE(isUnchanged(*createDevice("reg1", 1, "rule1"),
+                                 *createDevice("reg1", 1, "rule1"), oldRuleMap,
+                                 newRuleMap));
+    }
+
+    // Test where changed: Device has no definition hash
+    {
+        std::unique_ptr<Device> oldDevice = createDevice("reg1", 1, "rule1");
+        std::unique_ptr<Device> newDevice = createDevice("reg1", 1, "rule1");
+        oldDevice->setDefinitionHash(0);
+        newDevice->setDefinitionHash(0);
+        EXPECT_FALSE(
+            isUnchanged(*oldDevice, *newDevice, oldRuleMap, oldRuleMap));
+    }
+}
@@ -0,0 +1,348 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "action.hpp"
+#include "action_environment.hpp"
+#include "chassis.hpp"
+#include "configuration.hpp"
+#include "configuration_executor.hpp"
+#include "device.hpp"
+#include "mock_action.hpp"
+#include "mock_error_logging.hpp"
+#include "mock_journal.hpp"
+#include "mock_services.hpp"
+#include "mocked_i2c_interface.hpp"
+#include "phase_fault_detection.hpp"
+#include "power_domain.hpp"
+#include "presence_detection.hpp"
+#include "rail.hpp"
+#include "rule.hpp"
+#include "system.hpp"
+#include "test_utils.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+using namespace phosphor::power::regulators;
+using namespace phosphor::power::regulators::test_utils;
+
+using ::testing::A;
+using ::testing::InvokeWithoutArgs;
+using ::testing::Ref;
+using ::testing::Return;
+
+static const std::string chassisInvPath{
+    "/xyz/openbmc_project/inventory/system/chassis"};
+
+/**
+ * IDs of the devices in the order they were configured.
+ */
+struct ConfiguredDevices
+{
+    std::mutex mutex{};
+    std::vector<std::string> ids{};
+};
+
+/**
+ * Creates a Device on the specified I2C bus.
+ *
+ * Configuring the device sleeps for the specified time and then adds the
+ * device ID to the specified list.  If fail is true, an exception is thrown
+ * instead.
+ *
+ * @param id device ID
+ * @param bus I2C bus of the device
+ * @param configTime time it takes to configure the device
+ * @param configured list of devices that have been configured
+ * @param dependsOn IDs of devices that must be configured first
+ * @param fail indicates whether configuring the device fails
+ * @return Device object
+ */
+static std::unique_ptr<Device>
+    createDevice(const std::string& id, uint8_t bus,
+                 std::chrono::milliseconds configTime,
+                 ConfiguredDevices& configured,
+                 std::vector<std::string> dependsOn = {}, bool fail = false)
+{
+    // Create Configuration
+    auto action = std::make_unique<MockAction>();
+    EXPECT_CALL(*action, execute)
+        .WillRepeatedly([id, configTime, &configured, fail](
+                            ActionEnvironment& /*environment*/) {
+            std::this_thread::sleep_for(configTime);
+            if (fail)
+            {
+                throw std::runtime_error{"Unable to write VOUT_COMMAND"};
+            }
+            std::lock_guard<std::mutex> lock{configured.mutex};
+            configured.ids.emplace_back(id);
+            return true;
+        });
+    std::vector<std::unique_ptr<Action>> actions{};
+    actions.emplace_back(std::move(action));
+    auto configuration =
+        std::make_unique<Configuration>(std::optional<double>{},
+                                        std::move(actions));
+
+    // Create Device
+    auto i2cInterface = std::make_unique<i2c::MockedI2CInterface>();
+    EXPECT_CALL(*i2cInterface, getBus).WillRepeatedly(Return(bus));
+    std::unique_ptr<PresenceDetection> presenceDetection{};
+    std::unique_ptr<PhaseFaultDetection> phaseFaultDetection{};
+    std::vector<std::unique_ptr<Rail>> rails{};
+    return std::make_unique<Device>(
+        id, true,
+        "/xyz/openbmc_project/inventory/system/chassis/motherboard/" + id,
+        std::move(i2cInterface), std::move(presenceDetection),
+        std::move(configuration), std::move(phaseFaultDetection),
+        std::move(rails), std::move(dependsOn));
+}
+
+TEST(ConfigurationExecutorTests, Constructor)
+{
+    ConfiguredDevices configured{};
+
+    // Test where chassis contains no devices
+    {
+        auto system = createSystem({}, true);
+        ConfigurationExecutor executor{*system, *system->getChassis()[0]};
+        EXPECT_EQ(executor.getBusCount(), 0);
+        EXPECT_FALSE(executor.hasDependencyCycle());
+    }
+
+    // Test where devices are on multiple buses
+    {
+        std::vector<std::unique_ptr<Device>> devices{};
+        devices.emplace_back(createDevice("vdd0_reg", 1,
+                                          std::chrono::milliseconds{0},
+                                          configured));
+        devices.emplace_back(createDevice("vdd1_reg", 2,
+                                          std::chrono::milliseconds{0},
+                                          configured, {"vdd0_reg"}));
+        devices.emplace_back(createDevice("vdd2_reg", 1,
+                                          std::chrono::milliseconds{0},
+                                          configured, {"unknown_reg"}));
+        auto system = createSystem(std::move(devices), true);
+        ConfigurationExecutor executor{*system, *system->getChassis()[0]};
+        EXPECT_EQ(executor.getBusCount(), 2);
+        EXPECT_FALSE(executor.hasDependencyCycle());
+    }
+
+    // Test where dependencies contain a cycle
+    {
+        std::vector<std::unique_ptr<Device>> devices{};
+        devices.emplace_back(createDevice("vdd0_reg", 1,
+                                          std::chrono::milliseconds{0},
+                                          configured, {"vdd1_reg"}));
+        devices.emplace_back(createDevice("vdd1_reg", 2,
+                                          std::chrono::milliseconds{0},
+                                          configured, {"vdd2_reg"}));
+        devices.emplace_back(createDevice("vdd2_reg", 1,
+                                          std::chrono::milliseconds{0},
+                                          configured, {"vdd0_reg"}));
+        auto system = createSystem(std::move(devices), true);
+        ConfigurationExecutor executor{*system, *system->getChassis()[0]};
+        EXPECT_TRUE(executor.hasDependencyCycle());
+    }
+}
+
+TEST(ConfigurationExecutorTests, Execute)
+{
+    // Test where all devices are on one bus.  Devices are configured in
+    // dependency order.
+    {
+        ConfiguredDevices configured{};
+        std::vector<std::unique_ptr<Device>> devices{};
+        devices.emplace_back(createDevice("vdd0_reg", 3,
+                                          std::chrono::milliseconds{0},
+                                          configured, {"vdd1_reg"}));
+        devices.emplace_back(createDevice("vdd1_reg", 3,
+                                          std::chrono::milliseconds{0},
+                                          configured));
+        auto system = createSystem(std::move(devices), true);
+        ConfigurationExecutor executor{*system, *system->getChassis()[0]};
+
+        MockServices services{};
+        EXPECT_EQ(executor.execute(services), 0);
+        EXPECT_EQ(configured.ids,
+                  (std::vector<std::string>{"vdd1_reg", "vdd0_reg"}));
+    }
+
+    // Test where devices are on multiple buses.  Buses are configured in
+    // parallel and journal messages are logged on the calling thread.
+    {
+        ConfiguredDevices configured{};
+        std::vector<std::unique_ptr<Device>> devices{};
+        for (uint8_t bus = 0; bus < 4; ++bus)
+        {
+            devices.emplace_back(
+                createDevice("vdd" + std::to_string(bus) + "_reg", bus,
+                             std::chrono::milliseconds{200}, configured));
+        }
+        auto system = createSystem(std::move(devices), true);
+        ConfigurationExecutor executor{*system, *system->getChassis()[0]};
+        EXPECT_EQ(executor.getBusCount(), 4);
+
+        std::thread::id callingThread = std::this_thread::get_id();
+        MockServices services{};
+        MockJournal& journal = services.getMockJournal();
+        EXPECT_CALL(journal, logDebug(A<const std::string&>()))
+            .Times(4)
+            .WillRepeatedly(InvokeWithoutArgs([callingThread]() {
+                EXPECT_EQ(std::this_thread::get_id(), callingThread);
+            }));
+
+        // Configuration should take about as long as the slowest bus
+        auto start = std::chrono::steady_clock::now();
+        executor.execute(services);
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        EXPECT_LT(elapsed, std::chrono::milliseconds{600});
+        EXPECT_EQ(configured.ids.size(), 4);
+    }
+
+    // Test where a device depends on a device on another bus.  The next
+    // device on the same bus does not wait for it.
+    {
+        ConfiguredDevices configured{};
+        std::vector<std::unique_ptr<Device>> devices{};
+        devices.emplace_back(createDevice("vdd0_reg", 1,
+                                          std::chrono::milliseconds{0},
+                                          configured, {"vio0_reg"}));
+        devices.emplace_back(createDevice("vdd1_reg", 1,
+                                          std::chrono::milliseconds{0},
+                                          configured));
+        devices.emplace_back(createDevice("vio0_reg", 2,
+                                          std::chrono::milliseconds{100},
+                                          configured));
+        auto system = createSystem(std::move(devices), true);
+        ConfigurationExecutor executor{*system, *system->getChassis()[0]};
+
+        MockServices services{};
+        executor.execute(services);
+        EXPECT_EQ(configured.ids,
+                  (std::vector<std::string>{"vdd1_reg", "vio0_reg",
+                                            "vdd0_reg"}));
+    }
+
+    // Test where dependencies contain a cycle.  Devices are configured in
+    // configuration file order.
+    {
+        ConfiguredDevices configured{};
+        std::vector<std::unique_ptr<Device>> devices{};
+        devices.emplace_back(createDevice("vdd0_reg", 1,
+                                          std::chrono::milliseconds{0},
+                                          configured, {"vdd1_reg"}));
+        devices.emplace_back(createDevice("vdd1_reg", 2,
+                                          std::chrono::milliseconds{0},
+                                          configured, {"vdd0_reg"}));
+        auto system = createSystem(std::move(devices), true);
+        ConfigurationExecutor executor{*system, *system->getChassis()[0]};
+
+        MockServices services{};
+        MockJournal& journal = services.getMockJournal();
+        EXPECT_CALL(journal,
+                    logError("Unable to configure devices in parallel in "
+                             "chassis 1: Device dependencies contain a cycle"))
+            .Times(1);
+        EXPECT_EQ(executor.execute(services), 0);
+        EXPECT_EQ(configured.ids,
+                  (std::vector<std::string>{"vdd0_reg", "vdd1_reg"}));
+    }
+
+    // Test where an error occurs configuring a device on one bus.  Devices
+    // that depend on it are still configured and the error is logged on the
+    // calling thread.
+    {
+        ConfiguredDevices configured{};
+        std::vector<std::unique_ptr<Device>> devices{};
+        devices.emplace_back(createDevice("vdd0_reg", 1,
+                                          std::chrono::milliseconds{0},
+                                          configured, {}, true));
+        devices.emplace_back(createDevice("vdd1_reg", 2,
+                                          std::chrono::milliseconds{0},
+                                          configured, {"vdd0_reg"}));
+        auto system = createSystem(std::move(devices), true);
+        ConfigurationExecutor executor{*system, *system->getChassis()[0]};
+
+        std::thread::id callingThread = std::this_thread::get_id();
+        MockServices services{};
+        MockJournal& journal = services.getMockJournal();
+        std::vector<std::string> expectedErrMessages{
+            "Unable to write VOUT_COMMAND"};
+        EXPECT_CALL(journal, logError(expectedErrMessages)).Times(1);
+        EXPECT_CALL(journal, logError("Unable to configure vdd0_reg")).Times(1);
+        MockErrorLogging& errorLogging = services.getMockErrorLogging();
+        EXPECT_CALL(errorLogging,
+                    logInternalError(Entry::Level::Warning, Ref(journal)))
+            .Times(1)
+            .WillOnce(InvokeWithoutArgs([callingThread]() {
+                EXPECT_EQ(std::this_thread::get_id(), callingThread);
+            }));
+
+        EXPECT_EQ(executor.execute(services), 1);
+        EXPECT_EQ(configured.ids, std::vector<std::string>{"vdd1_reg"});
+    }
+
+    // Test where a power domain is specified.  Only the devices in the power
+    // domain are configured, and dependencies on devices in other power
+    // domains are ignored.
+    {
+        ConfiguredDevices configured{};
+        std::vector<std::unique_ptr<Device>> devices{};
+        devices.emplace_back(createDevice("vdd0_reg", 1,
+                                          std::chrono::milliseconds{0},
+                                          configured, {"vio0_reg"}));
+        devices.emplace_back(createDevice("vio0_reg", 2,
+                                          std::chrono::milliseconds{0},
+                                          configured));
+        devices.emplace_back(createDevice("vdd1_reg", 1,
+                                          std::chrono::milliseconds{0},
+                                          configured, {"vdd0_reg"}));
+        devices[0]->setPowerDomain(std::make_unique<PowerDomain>(
+            "cpu0", std::vector<unsigned int>{4}));
+        devices[2]->setPowerDomain(std::make_unique<PowerDomain>(
+            "cpu0", std::vector<unsigned int>{4}));
+        auto system = createSystem(std::move(devices), true);
+        ConfigurationExecutor executor{*system, *system->getChassis()[0]};
+
+        MockServices services{};
+        executor.execute(services, "cpu0");
+        EXPECT_EQ(configured.ids,
+                  (std::vector<std::string>{"vdd0_reg", "vdd1_reg"}));
+
+        // Configure the devices that are not in a power domain
+        configured.ids.clear();
+        executor.execute(services, std::string{});
+        EXPECT_EQ(configured.ids, std::vector<std::string>{"vio0_reg"});
+
+        // Configure all the devices
+        configured.ids.clear();
+        executor.execute(services);
+        EXPECT_EQ(configured.ids,
+                  (std::vector<std::string>{"vio0_reg", "vdd0_reg",
+                                            "vdd1_reg"}));
+    }
+}
@@ -136,7 +136,8 @@ TEST(ConfigurationTests, ExecuteForDevice)
         System system{std::move(rules), std::move(chassisVec)};
 
         // Execute Configuration
-        configurationPtr->execute(services, system, *chassisPtr, *devicePtr);
+        EXPECT_TRUE(configurationPtr->execute(services, system, *chassisPtr,
+                                              *devicePtr));
     }
 
     // Test where works: Volts value specified
@@ -196,7 +197,8 @@ TEST(ConfigurationTests, ExecuteForDevice)
         System system{std::move(rules), std::move(chassisVec)};
 
         // Execute Configuration
-        configurationPtr->execute(services, system, *chassisPtr, *devicePtr);
+        EXPECT_TRUE(configurationPtr->execute(services, system, *chassisPtr,
+                                              *devicePtr));
     }
 
     // Test where fails
@@ -263,7 +265,8 @@ TEST(ConfigurationTests, ExecuteForDevice)
         System system{std::move(rules), std::move(chassisVec)};
 
         // Execute Configuration
-        configurationPtr->execute(services, system, *chassisPtr, *devicePtr);
+        EXPECT_FALSE(configurationPtr->execute(services, system, *chassisPtr,
+                                               *devicePtr));
     }
 }
 
@@ -331,8 +334,8 @@ TEST(ConfigurationTests, ExecuteForRail)
         System system{std::move(rules), std::move(chassisVec)};
 
         // Execute Configuration
-        configurationPtr->execute(services, system, *chassisPtr, *devicePtr,
-                                  *railPtr);
+        EXPECT_TRUE(configurationPtr->execute(services, system, *chassisPtr,
+                                              *devicePtr, *railPtr));
     }
 
     // Test where works: Volts value specified
@@ -402,8 +405,8 @@ TEST(ConfigurationTests, ExecuteForRail)
         System system{std::move(rules), std::move(chassisVec)};
 
         // Execute Configuration
-        configurationPtr->execute(services, system, *chassisPtr, *devicePtr,
-                                  *railPtr);
+        EXPECT_TRUE(configurationPtr->execute(services, system, *chassisPtr,
+                                              *devicePtr, *railPtr));
     }
 
     // Test where fails
@@ -480,8 +483,8 @@ TEST(ConfigurationTests, ExecuteForRail)
         System system{std::move(rules), std::move(chassisVec)};
 
         // Execute Configuration
-        configurationPtr->execute(services, system, *chassisPtr, *devicePtr,
-                                  *railPtr);
+        EXPECT_FALSE(configurationPtr->execute(services, system, *chassisPtr,
+                                               *devicePtr, *railPtr));
     }
 }
 
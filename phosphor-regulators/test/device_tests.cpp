@@ -18,6 +18,9 @@
 #include "configuration.hpp"
 #include "device.hpp"
 #include "i2c_interface.hpp"
+#include "i2c_write_bit_action.hpp"
+#include "i2c_write_byte_action.hpp"
+#include "i2c_write_bytes_action.hpp"
 #include "id_map.hpp"
 #include "log_phase_fault_action.hpp"
 #include "mock_action.hpp"
@@ -28,6 +31,10 @@
 #include "mocked_i2c_interface.hpp"
 #include "phase_fault.hpp"
 #include "phase_fault_detection.hpp"
+#include "pmbus_read_sensor_action.hpp"
+#include "pmbus_utils.hpp"
+#include "pmbus_write_vout_command_action.hpp"
+#include "power_domain.hpp"
 #include "presence_detection.hpp"
 #include "rail.hpp"
 #include "rule.hpp"
@@ -37,9 +44,13 @@
 #include "test_sdbus_error.hpp"
 #include "test_utils.hpp"
 
+#include <array>
+#include <chrono>
 #include <memory>
 #include <optional>
+#include <stdexcept>
 #include <string>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -49,9 +60,15 @@
 using namespace phosphor::power::regulators;
 using namespace phosphor::power::regulators::test_utils;
 
+using ::testing::_;
 using ::testing::A;
+using ::testing::Args;
+using ::testing::ElementsAre;
+using ::testing::InSequence;
+using ::testing::NotNull;
 using ::testing::Ref;
 using ::testing::Return;
+using ::testing::SetArgReferee;
 using ::testing::Throw;
 using ::testing::TypedEq;
 
@@ -106,6 +123,7 @@ TEST_F(DeviceTests, Constructor)
         EXPECT_EQ(device.getConfiguration(), nullptr);
         EXPECT_EQ(device.getPhaseFaultDetection(), nullptr);
         EXPECT_EQ(device.getRails().size(), 0);
+        EXPECT_EQ(device.getDependsOn().size(), 0);
     }
 
     // Test where all parameters are specified
@@ -149,7 +167,8 @@ TEST_F(DeviceTests, Constructor)
                       std::move(presenceDetection),
                       std::move(configuration),
                       std::move(phaseFaultDetection),
-                      std::move(rails)};
+                      std::move(rails),
+                      std::vector<std::string>{"vio_reg"}};
         EXPECT_EQ(device.getID(), "vdd_reg");
         EXPECT_EQ(device.isRegulator(), false);
         EXPECT_EQ(device.getFRU(), deviceInvPath);
@@ -162,6 +181,7 @@ TEST_F(DeviceTests, Constructor)
         EXPECT_NE(device.getPhaseFaultDetection(), nullptr);
         EXPECT_EQ(device.getPhaseFaultDetection()->getActions().size(), 3);
         EXPECT_EQ(device.getRails().size(), 2);
+        EXPECT_EQ(device.getDependsOn(), std::vector<std::string>{"vio_reg"});
     }
 }
 
@@ -238,6 +258,58 @@ TEST_F(DeviceTests, ClearCache)
         // Verify presence value no longer cached in PresenceDetection
         EXPECT_FALSE(presenceDetectionPtr->getCachedPresence().has_value());
     }
+
+    // Test where Device contains a PresenceDetection object that only depends
+    // on hardware presence.  Presence value should remain cached.
+    {
+        // Create PresenceDetection
+        std::vector<std::unique_ptr<Action>> actions{};
+        auto presenceDetection =
+            std::make_unique<PresenceDetection>(std::move(actions));
+        presenceDetection->setInventoryPaths(std::vector<std::string>{});
+        PresenceDetection* presenceDetectionPtr = presenceDetection.get();
+
+        // Create Device
+        std::unique_ptr<i2c::I2CInterface> i2cInterface = createI2CInterface();
+        Device device{"reg2", true, deviceInvPath, std::move(i2cInterface),
+                      std::move(presenceDetection)};
+
+        // Cache presence value in PresenceDetection
+        MockServices services{};
+        presenceDetectionPtr->execute(services, *system, *chassis, device);
+        EXPECT_TRUE(presenceDetectionPtr->getCachedPresence().has_value());
+
+        // Clear cached data in Device
+        device.clearCache();
+
+        // Verify presence value still cached in PresenceDetection
+        EXPECT_TRUE(presenceDetectionPtr->getCachedPresence().has_value());
+    }
+
+    // Test where Device has a cached VOUT_MODE value
+    {
+        // Create mock I2CInterface.  VOUT_MODE is read again after the cache
+        // is cleared.
+        auto i2cInterface = std::make_unique<i2c::MockedI2CInterface>();
+        EXPECT_CALL(*i2cInterface, read(TypedEq<uint8_t>(0x20), A<uint8_t&>()))
+            .Times(2)
+            .WillRepeatedly(SetArgReferee<1>(0b0001'1000));
+
+        Device device{"reg2", true, deviceInvPath, std::move(i2cInterface)};
+        EXPECT_EQ(device.getVoutMode(), 0b0001'1000);
+        device.clearCache();
+        EXPECT_EQ(device.getVoutMode(), 0b0001'1000);
+    }
+
+    // Test where Device has a current page
+    {
+        std::unique_ptr<i2c::I2CInterface> i2cInterface = createI2CInterface();
+        Device device{"reg2", true, deviceInvPath, std::move(i2cInterface)};
+        device.pageSelected(0x01);
+        EXPECT_EQ(device.getCurrentPage(), 0x01);
+        device.clearCache();
+        EXPECT_FALSE(device.getCurrentPage().has_value());
+    }
 }
 
 TEST_F(DeviceTests, ClearErrorHistory)
@@ -470,7 +542,7 @@ TEST_F(DeviceTests, Configure)
                       std::move(configuration)};
 
         // Call configure().  Should do nothing.
-        device.configure(services, *system, *chassis);
+        EXPECT_EQ(device.configure(services, *system, *chassis), 0);
     }
 
     // Test where Configuration and Rails were not specified in constructor
@@ -486,7 +558,7 @@ TEST_F(DeviceTests, Configure)
         Device device{"reg2", true, deviceInvPath, std::move(i2cInterface)};
 
         // Call configure().
-        device.configure(services, *system, *chassis);
+        EXPECT_EQ(device.configure(services, *system, *chassis), 0);
     }
 
     // Test where Configuration and Rails were specified in constructor
@@ -562,8 +634,244 @@ TEST_F(DeviceTests, Configure)
                       std::move(rails)};
 
         // Call configure().
-        device.configure(services, *system, *chassis);
+        EXPECT_EQ(device.configure(services, *system, *chassis), 0);
+    }
+
+    // Test where configuring the Device and one of its Rails fails
+    {
+        std::vector<std::unique_ptr<Rail>> rails{};
+
+        // Create mock services.  Expect logError() and logInternalError() to
+        // be called for the Device and Rail vdd0.
+        MockServices services{};
+        MockJournal& journal = services.getMockJournal();
+        std::vector<std::string> expectedErrMessages{
+            "Unable to write VOUT_COMMAND"};
+        EXPECT_CALL(journal, logError(expectedErrMessages)).Times(2);
+        EXPECT_CALL(journal, logError("Unable to configure reg2")).Times(1);
+        EXPECT_CALL(journal, logError("Unable to configure vdd0")).Times(1);
+        MockErrorLogging& errorLogging = services.getMockErrorLogging();
+        EXPECT_CALL(errorLogging,
+                    logInternalError(Entry::Level::Warning, Ref(journal)))
+            .Times(2);
+
+        // Create Rails vdd0 and vio0.  Configuring vdd0 fails.
+        for (const auto& [id, fail] :
+             {std::pair{"vdd0", true}, std::pair{"vio0", false}})
+        {
+            auto action = std::make_unique<MockAction>();
+            if (fail)
+            {
+                EXPECT_CALL(*action, execute)
+                    .Times(1)
+                    .WillOnce(Throw(
+                        std::runtime_error{"Unable to write VOUT_COMMAND"}));
+            }
+            else
+            {
+                EXPECT_CALL(*action, execute).Times(1).WillOnce(Return(true));
+            }
+            std::vector<std::unique_ptr<Action>> actions{};
+            actions.emplace_back(std::move(action));
+            auto configuration = std::make_unique<Configuration>(
+                std::optional<double>{}, std::move(actions));
+            rails.emplace_back(
+                std::make_unique<Rail>(id, std::move(configuration)));
+        }
+
+        // Create Configuration for Device.  Configuring the Device fails.
+        auto action = std::make_unique<MockAction>();
+        EXPECT_CALL(*action, execute)
+            .Times(1)
+            .WillOnce(
+                Throw(std::runtime_error{"Unable to write VOUT_COMMAND"}));
+        std::vector<std::unique_ptr<Action>> actions{};
+        actions.emplace_back(std::move(action));
+        auto configuration = std::make_unique<Configuration>(
+            std::optional<double>{}, std::move(actions));
+
+        // Create Device
+        std::unique_ptr<i2c::I2CInterface> i2cInterface = createI2CInterface();
+        std::unique_ptr<PresenceDetection> presenceDetection{};
+        std::unique_ptr<PhaseFaultDetection> phaseFaultDetection{};
+        Device device{"reg2",
+                      true,
+                      deviceInvPath,
+                      std::move(i2cInterface),
+                      std::move(presenceDetection),
+                      std::move(configuration),
+                      std::move(phaseFaultDetection),
+                      std::move(rails)};
+
+        // Call configure().  Two errors should occur.
+        EXPECT_EQ(device.configure(services, *system, *chassis), 2);
+    }
+}
+
+TEST_F(DeviceTests, ConfigureDeferredWriteVerification)
+{
+    // Create mock services.  Expect the verification of vdd1 to fail.
+    MockServices services{};
+    MockJournal& journal = services.getMockJournal();
+    EXPECT_CALL(journal, logError(A<const std::vector<std::string>&>()))
+        .Times(1);
+    EXPECT_CALL(journal, logError("Unable to configure vdd0")).Times(0);
+    EXPECT_CALL(journal, logError("Unable to configure vdd1")).Times(1);
+    MockErrorLogging& errorLogging = services.getMockErrorLogging();
+    EXPECT_CALL(errorLogging, logWriteVerificationError(Entry::Level::Warning,
+                                                        Ref(journal),
+                                                        deviceInvPath))
+        .Times(1);
+
+    // Create mock I2CInterface.  Both values are written before either of
+    // them is read back, on the page it was written to.
+    auto i2cInterface = std::make_unique<i2c::MockedI2CInterface>();
+    EXPECT_CALL(*i2cInterface, isOpen).WillRepeatedly(Return(true));
+    {
+        InSequence seq{};
+        EXPECT_CALL(*i2cInterface,
+                    write(TypedEq<uint8_t>(0x00), TypedEq<uint8_t>(0x00)))
+            .Times(1);
+        EXPECT_CALL(*i2cInterface,
+                    write(TypedEq<uint8_t>(0x21), TypedEq<uint16_t>(0x0100)))
+            .Times(1);
+        EXPECT_CALL(*i2cInterface,
+                    write(TypedEq<uint8_t>(0x00), TypedEq<uint8_t>(0x01)))
+            .Times(1);
+        EXPECT_CALL(*i2cInterface,
+                    write(TypedEq<uint8_t>(0x21), TypedEq<uint16_t>(0x0200)))
+            .Times(1);
+        EXPECT_CALL(*i2cInterface,
+                    write(TypedEq<uint8_t>(0x00), TypedEq<uint8_t>(0x00)))
+            .Times(1);
+        EXPECT_CALL(*i2cInterface, read(TypedEq<uint8_t>(0x21), A<uint16_t&>()))
+            .Times(1)
+            .WillOnce(SetArgReferee<1>(0x0100));
+        EXPECT_CALL(*i2cInterface,
+                    write(TypedEq<uint8_t>(0x00), TypedEq<uint8_t>(0x01)))
+            .Times(1);
+        EXPECT_CALL(*i2cInterface, read(TypedEq<uint8_t>(0x21), A<uint16_t&>()))
+            .Times(1)
+            .WillOnce(SetArgReferee<1>(0x0201));
+    }
+
+    // Create Rails that select a page and write a verified VOUT_COMMAND
+    std::vector<std::unique_ptr<Rail>> rails{};
+    for (const auto& [railID, page, volts] :
+         {std::tuple{"vdd0", 0x00, 1.0}, std::tuple{"vdd1", 0x01, 2.0}})
+    {
+        std::vector<std::unique_ptr<Action>> actions{};
+        actions.emplace_back(std::make_unique<I2CWriteByteAction>(
+            pmbus_utils::PAGE, static_cast<uint8_t>(page)));
+        actions.emplace_back(std::make_unique<PMBusWriteVoutCommandAction>(
+            volts, pmbus_utils::VoutDataFormat::linear, -8, true));
+        auto configuration = std::make_unique<Configuration>(
+            std::optional<double>{}, std::move(actions));
+        rails.emplace_back(
+            std::make_unique<Rail>(railID, std::move(configuration)));
+    }
+
+    // Create Device, Chassis with deferred write verification, and System
+    std::unique_ptr<PresenceDetection> presenceDetection{};
+    std::unique_ptr<Configuration> configuration{};
+    std::unique_ptr<PhaseFaultDetection> phaseFaultDetection{};
+    auto device = std::make_unique<Device>(
+        "reg2", true, deviceInvPath, std::move(i2cInterface),
+        std::move(presenceDetection), std::move(configuration),
+        std::move(phaseFaultDetection), std::move(rails));
+    Device* devicePtr = device.get();
+    std::vector<std::unique_ptr<Device>> devices{};
+    devices.emplace_back(std::move(device));
+    auto deferredChassis = std::make_unique<Chassis>(
+        1, chassisInvPath, std::move(devices), false, false, true);
+    Chassis* chassisPtr = deferredChassis.get();
+    std::vector<std::unique_ptr<Chassis>> chassisVec{};
+    chassisVec.emplace_back(std::move(deferredChassis));
+    System deferredSystem{std::vector<std::unique_ptr<Rule>>{},
+                          std::move(chassisVec)};
+
+    // Call configure().  One error should occur.
+    EXPECT_EQ(devicePtr->configure(services, deferredSystem, *chassisPtr), 1);
+}
+
+TEST_F(DeviceTests, ConfigureShadowRegisters)
+{
+    MockServices services{};
+
+    // Create mock I2CInterface.  The non-volatile register 0x10 is only read
+    // once per configuration.  The volatile register 0x11 is read before each
+    // masked write.
+    auto i2cInterface = std::make_unique<i2c::MockedI2CInterface>();
+    EXPECT_CALL(*i2cInterface, isOpen).WillRepeatedly(Return(true));
+    EXPECT_CALL(*i2cInterface, read(TypedEq<uint8_t>(0x10), A<uint8_t&>()))
+        .Times(2)
+        .WillRepeatedly(SetArgReferee<1>(0x80));
+    EXPECT_CALL(*i2cInterface, read(_, A<uint8_t&>(), _, _)).Times(0);
+    EXPECT_CALL(*i2cInterface, read(TypedEq<uint8_t>(0x11), A<uint8_t&>()))
+        .Times(4)
+        .WillRepeatedly(SetArgReferee<1>(0x40));
+    {
+        InSequence seq;
+        for (int pass = 0; pass < 2; ++pass)
+        {
+            EXPECT_CALL(*i2cInterface, write(TypedEq<uint8_t>(0x10),
+                                             TypedEq<uint8_t>(0x81)))
+                .Times(1);
+            EXPECT_CALL(*i2cInterface, write(TypedEq<uint8_t>(0x10),
+                                             TypedEq<uint8_t>(0x83)))
+                .Times(1);
+            EXPECT_CALL(*i2cInterface, write(TypedEq<uint8_t>(0x10),
+                                             TypedEq<uint8_t>(0x73)))
+                .Times(1);
+            EXPECT_CALL(*i2cInterface, write(0x10, 1, NotNull(),
+                                             i2c::I2CInterface::Mode::I2C))
+                .With(Args<2, 1>(ElementsAre(0x75)))
+                .Times(1);
+        }
     }
+    EXPECT_CALL(*i2cInterface,
+                write(TypedEq<uint8_t>(0x11), TypedEq<uint8_t>(0x41)))
+        .Times(2);
+    EXPECT_CALL(*i2cInterface,
+                write(TypedEq<uint8_t>(0x11), TypedEq<uint8_t>(0x42)))
+        .Times(2);
+
+    // Create Configuration with read-modify-write actions
+    std::vector<std::unique_ptr<Action>> actions{};
+    actions.emplace_back(std::make_unique<I2CWriteBitAction>(0x10, 0, 1));
+    actions.emplace_back(std::make_unique<I2CWriteBitAction>(0x10, 1, 1));
+    actions.emplace_back(
+        std::make_unique<I2CWriteByteAction>(0x10, 0x70, 0xF0));
+    actions.emplace_back(std::make_unique<I2CWriteBytesAction>(
+        0x10, std::vector<uint8_t>{0x05}, std::vector<uint8_t>{0x0F}));
+    actions.emplace_back(
+        std::make_unique<I2CWriteByteAction>(0x11, 0x01, 0x0F));
+    actions.emplace_back(
+        std::make_unique<I2CWriteByteAction>(0x11, 0x02, 0x0F));
+    auto configuration =
+        std::make_unique<Configuration>(std::nullopt, std::move(actions));
+
+    // Create Device with shadow registers, Chassis, and System
+    auto device = std::make_unique<Device>(
+        "reg2", true, deviceInvPath, std::move(i2cInterface), nullptr,
+        std::move(configuration));
+    device->setShadowRegisters(true);
+    device->setVolatileRegisters({0x11});
+    Device* devicePtr = device.get();
+    std::vector<std::unique_ptr<Device>> devices{};
+    devices.emplace_back(std::move(device));
+    std::vector<std::unique_ptr<Chassis>> chassisVec{};
+    chassisVec.emplace_back(
+        std::make_unique<Chassis>(1, chassisInvPath, std::move(devices)));
+    Chassis* chassisPtr = chassisVec[0].get();
+    System shadowSystem{std::vector<std::unique_ptr<Rule>>{},
+                        std::move(chassisVec)};
+
+    // Shadow registers are discarded after each configuration
+    EXPECT_EQ(devicePtr->configure(services, shadowSystem, *chassisPtr), 0);
+    uint8_t value{0x00};
+    EXPECT_FALSE(devicePtr->getShadowRegisters(0x10, {&value, 1}));
+    EXPECT_EQ(devicePtr->configure(services, shadowSystem, *chassisPtr), 0);
 }
 
 TEST_F(DeviceTests, DetectPhaseFaults)
@@ -717,6 +1025,27 @@ TEST_F(DeviceTests, GetConfiguration)
     }
 }
 
+TEST_F(DeviceTests, GetCurrentPage)
+{
+    std::unique_ptr<i2c::I2CInterface> i2cInterface = createI2CInterface();
+    Device device{"reg2", true, deviceInvPath, std::move(i2cInterface)};
+
+    // Test where page has not been selected
+    EXPECT_FALSE(device.getCurrentPage().has_value());
+
+    // Test where page has been selected
+    device.pageSelected(0x03);
+    EXPECT_EQ(device.getCurrentPage(), 0x03);
+}
+
+TEST_F(DeviceTests, GetDefinitionHash)
+{
+    std::unique_ptr<Device> device = createDevice("vdd_reg");
+    EXPECT_EQ(device->getDefinitionHash(), 0);
+    device->setDefinitionHash(0x1234'5678'9abc'def0);
+    EXPECT_EQ(device->getDefinitionHash(), 0x1234'5678'9abc'def0);
+}
+
 TEST_F(DeviceTests, GetFRU)
 {
     Device device{"vdd_reg", true, deviceInvPath,
@@ -771,6 +1100,19 @@ TEST_F(DeviceTests, GetPhaseFaultDetection)
     }
 }
 
+TEST_F(DeviceTests, GetPowerDomain)
+{
+    std::unique_ptr<Device> device = createDevice("vdd_reg");
+    EXPECT_EQ(device->getPowerDomain(), nullptr);
+
+    device->setPowerDomain(std::make_unique<PowerDomain>(
+        "cpu0", std::vector<unsigned int>{4, 5}));
+    EXPECT_NE(device->getPowerDomain(), nullptr);
+    EXPECT_EQ(device->getPowerDomain()->getName(), "cpu0");
+    EXPECT_EQ(device->getPowerDomain()->getSequencerRails(),
+              (std::vector<unsigned int>{4, 5}));
+}
+
 TEST_F(DeviceTests, GetPresenceDetection)
 {
     // Test where PresenceDetection was not specified in constructor
@@ -832,6 +1174,98 @@ TEST_F(DeviceTests, GetRails)
     }
 }
 
+TEST_F(DeviceTests, GetSensorReading)
+{
+    std::unique_ptr<i2c::I2CInterface> i2cInterface = createI2CInterface();
+    Device device{"reg2", true, deviceInvPath, std::move(i2cInterface)};
+
+    // Test where sensors are not being monitored.  Readings are not shared.
+    device.addSensorReading(0x8C, 0xD2E0, std::chrono::steady_clock::now());
+    EXPECT_FALSE(device.getSensorReading(0x8C).has_value());
+
+    // Readings shared while monitoring sensors are tested in MonitorSensors
+}
+
+TEST_F(DeviceTests, GetShadowRegisters)
+{
+    std::unique_ptr<i2c::I2CInterface> i2cInterface = createI2CInterface();
+    Device device{"reg2", true, deviceInvPath, std::move(i2cInterface)};
+    device.setShadowRegisters(true);
+
+    // Test where device is not being configured.  Values are not stored.
+    std::array<uint8_t, 2> values{0x12, 0x34};
+    device.updateShadowRegisters(0x10, values);
+    EXPECT_FALSE(device.getShadowRegisters(0x10, values));
+
+    // Values stored while configuring are tested in ConfigureShadowRegisters
+}
+
+TEST_F(DeviceTests, GetVoutMode)
+{
+    // Test where VOUT_MODE is read once and then cached
+    {
+        auto i2cInterface = std::make_unique<i2c::MockedI2CInterface>();
+        EXPECT_CALL(*i2cInterface, read(TypedEq<uint8_t>(0x20), A<uint8_t&>()))
+            .Times(1)
+            .WillOnce(SetArgReferee<1>(0b0001'1000));
+
+        Device device{"reg2", true, deviceInvPath, std::move(i2cInterface)};
+        EXPECT_EQ(device.getVoutMode(), 0b0001'1000);
+        EXPECT_EQ(device.getVoutMode(), 0b0001'1000);
+    }
+
+    // Test where read fails.  Value is not cached.
+    {
+        auto i2cInterface = std::make_unique<i2c::MockedI2CInterface>();
+        EXPECT_CALL(*i2cInterface, read(TypedEq<uint8_t>(0x20), A<uint8_t&>()))
+            .Times(2)
+            .WillOnce(Throw(
+                i2c::I2CException{"Failed to read byte", "/dev/i2c-1", 0x70}))
+            .WillOnce(SetArgReferee<1>(0b0001'1010));
+
+        Device device{"reg2", true, deviceInvPath, std::move(i2cInterface)};
+        EXPECT_THROW(device.getVoutMode(), i2c::I2CException);
+        EXPECT_EQ(device.getVoutMode(), 0b0001'1010);
+    }
+}
+
+TEST_F(DeviceTests, HasAutoIncrement)
+{
+    std::unique_ptr<Device> device = createDevice("vdd_reg");
+    EXPECT_FALSE(device->hasAutoIncrement());
+    device->setAutoIncrement(true);
+    EXPECT_TRUE(device->hasAutoIncrement());
+    device->setAutoIncrement(false);
+    EXPECT_FALSE(device->hasAutoIncrement());
+}
+
+TEST_F(DeviceTests, HasShadowRegisters)
+{
+    std::unique_ptr<Device> device = createDevice("vdd_reg");
+    EXPECT_FALSE(device->hasShadowRegisters());
+    EXPECT_EQ(device->getVolatileRegisters().size(), 0);
+    device->setShadowRegisters(true);
+    device->setVolatileRegisters({0x78, 0x79});
+    EXPECT_TRUE(device->hasShadowRegisters());
+    EXPECT_EQ(device->getVolatileRegisters(),
+              (std::vector<uint8_t>{0x78, 0x79}));
+}
+
+TEST_F(DeviceTests, IsInPowerDomain)
+{
+    // Test where device is not in a power domain
+    std::unique_ptr<Device> device = createDevice("vdd_reg");
+    EXPECT_TRUE(device->isInPowerDomain(""));
+    EXPECT_FALSE(device->isInPowerDomain("cpu0"));
+
+    // Test where device is in a power domain
+    device->setPowerDomain(
+        std::make_unique<PowerDomain>("cpu0", std::vector<unsigned int>{4}));
+    EXPECT_FALSE(device->isInPowerDomain(""));
+    EXPECT_TRUE(device->isInPowerDomain("cpu0"));
+    EXPECT_FALSE(device->isInPowerDomain("cpu1"));
+}
+
 TEST_F(DeviceTests, IsPresent)
 {
     // Test where PresenceDetection not specified in constructor
@@ -1038,4 +1472,268 @@ TEST_F(DeviceTests, MonitorSensors)
         // Call monitorSensors().  Should monitor sensors in both rails.
         device.monitorSensors(services, *system, *chassis);
     }
+
+    // Test where Rails select different pages.  Rails are monitored in page
+    // order after the first cycle.  Redundant PAGE writes are skipped and
+    // rails on the same page share sensor readings.
+    {
+        // Create mock services.  Expect rails in file order during the first
+        // cycle and in page order during the second cycle.
+        MockServices services{};
+        MockSensors& sensors = services.getMockSensors();
+        {
+            InSequence seq{};
+            for (const char* railID :
+                 {"vdd1", "vdd0", "vio1", "vdd0", "vdd1", "vio1"})
+            {
+                EXPECT_CALL(sensors,
+                            startRail(railID, deviceInvPath, chassisInvPath))
+                    .Times(1);
+            }
+        }
+        EXPECT_CALL(sensors, setValue(SensorType::iout, 11.5)).Times(6);
+        EXPECT_CALL(sensors, endRail(false)).Times(6);
+
+        // Create mock I2CInterface.  First cycle selects pages 1, 0, and 1 and
+        // reads READ_IOUT for each rail.  Second cycle selects pages 0 and 1
+        // and reads READ_IOUT once for each page.
+        auto i2cInterface = std::make_unique<i2c::MockedI2CInterface>();
+        EXPECT_CALL(*i2cInterface, isOpen).WillRepeatedly(Return(true));
+        EXPECT_CALL(*i2cInterface,
+                    write(TypedEq<uint8_t>(0x00), TypedEq<uint8_t>(0x01)))
+            .Times(3);
+        EXPECT_CALL(*i2cInterface,
+                    write(TypedEq<uint8_t>(0x00), TypedEq<uint8_t>(0x00)))
+            .Times(2);
+        EXPECT_CALL(*i2cInterface, read(TypedEq<uint8_t>(0x8C), A<uint16_t&>()))
+            .Times(5)
+            .WillRepeatedly(SetArgReferee<1>(0xD2E0));
+
+        // Create Rails that select a page and read READ_IOUT.  Sensors are read
+        // every cycle.
+        std::vector<std::unique_ptr<Rail>> rails{};
+        for (const auto& [railID, page] :
+             {std::pair{"vdd1", 0x01}, std::pair{"vdd0", 0x00},
+              std::pair{"vio1", 0x01}})
+        {
+            std::vector<std::unique_ptr<Action>> actions{};
+            actions.emplace_back(std::make_unique<I2CWriteByteAction>(
+                pmbus_utils::PAGE, static_cast<uint8_t>(page)));
+            actions.emplace_back(std::make_unique<PMBusReadSensorAction>(
+                SensorType::iout, 0x8C,
+                pmbus_utils::SensorDataFormat::linear_11, std::nullopt));
+            auto sensorMonitoring = std::make_unique<SensorMonitoring>(
+                std::move(actions), std::chrono::milliseconds{0});
+            std::unique_ptr<Configuration> configuration{};
+            rails.emplace_back(std::make_unique<Rail>(
+                railID, std::move(configuration), std::move(sensorMonitoring)));
+        }
+
+        // Create Device that contains Rails
+        std::unique_ptr<PresenceDetection> presenceDetection{};
+        std::unique_ptr<Configuration> configuration{};
+        std::unique_ptr<PhaseFaultDetection> phaseFaultDetection{};
+        Device device{"reg2",
+                      true,
+                      deviceInvPath,
+                      std::move(i2cInterface),
+                      std::move(presenceDetection),
+                      std::move(configuration),
+                      std::move(phaseFaultDetection),
+                      std::move(rails)};
+        IDMap idMap{};
+        idMap.addDevice(device);
+        ActionEnvironment environment{idMap, "reg2", services};
+
+        // Call monitorSensors() twice
+        device.monitorSensors(services, *system, *chassis, environment);
+        device.monitorSensors(services, *system, *chassis, environment);
+
+        // Verify readings are no longer shared after the cycle
+        EXPECT_FALSE(device.getSensorReading(0x8C).has_value());
+    }
+}
+
+TEST_F(DeviceTests, MonitorSensorsCircuitBreaker)
+{
+    // Creates a Rail whose sensor monitoring action throws an I2C exception,
+    // or succeeds and reads sensors once per second
+    auto createRail = [](const std::string& id, bool isFailing, int times) {
+        auto action = std::make_unique<MockAction>();
+        if (isFailing)
+        {
+            EXPECT_CALL(*action, execute)
+                .Times(times)
+                .WillRepeatedly(Throw(i2c::I2CException{
+                    "Failed to read word data", "/dev/i2c-1", 0x70}));
+        }
+        else
+        {
+            EXPECT_CALL(*action, execute)
+                .Times(times)
+                .WillRepeatedly(Return(true));
+        }
+        std::vector<std::unique_ptr<Action>> actions{};
+        actions.emplace_back(std::move(action));
+        auto sensorMonitoring = std::make_unique<SensorMonitoring>(
+            std::move(actions),
+            isFailing ? std::chrono::milliseconds{0}
+                      : SensorMonitoring::defaultInterval);
+        std::unique_ptr<Configuration> configuration{};
+        return std::make_unique<Rail>(id, std::move(configuration),
+                                      std::move(sensorMonitoring));
+    };
+
+    // Test where all rails fail.  Breaker opens after 3 cycles, and the
+    // rails are skipped until it is reset.
+    {
+        MockServices services{};
+        MockSensors& sensors = services.getMockSensors();
+        EXPECT_CALL(sensors, startRail).Times(8);
+        EXPECT_CALL(sensors, endRail(true)).Times(8);
+        EXPECT_CALL(sensors, disableRail("vdd0")).Times(1);
+        EXPECT_CALL(sensors, disableRail("vio0")).Times(1);
+        EXPECT_CALL(sensors, skipRail("vdd0")).Times(1);
+        EXPECT_CALL(sensors, skipRail("vio0")).Times(1);
+
+        MockJournal& journal = services.getMockJournal();
+        EXPECT_CALL(journal, logError(A<const std::vector<std::string>&>()))
+            .Times(6);
+        EXPECT_CALL(journal, logError(A<const std::string&>())).Times(6);
+        EXPECT_CALL(journal,
+                    logError("Device reg2 is not responding after 3 "
+                             "attempts; it will only be read after a backoff"))
+            .Times(1);
+
+        MockErrorLogging& errorLogging = services.getMockErrorLogging();
+        EXPECT_CALL(errorLogging, logI2CError).Times(2);
+
+        std::vector<std::unique_ptr<Rail>> rails{};
+        rails.emplace_back(createRail("vdd0", true, 4));
+        rails.emplace_back(createRail("vio0", true, 4));
+        Device device{"reg2",
+                      true,
+                      deviceInvPath,
+                      createI2CInterface(),
+                      nullptr,
+                      nullptr,
+                      nullptr,
+                      std::move(rails)};
+
+        device.monitorSensors(services, *system, *chassis);
+        device.monitorSensors(services, *system, *chassis);
+        EXPECT_FALSE(device.getCircuitBreaker().isOpen());
+        EXPECT_EQ(device.getCircuitBreaker().getFailureCount(), 2);
+
+        device.monitorSensors(services, *system, *chassis);
+        EXPECT_TRUE(device.getCircuitBreaker().isOpen());
+        EXPECT_EQ(device.getCircuitBreaker().getBackoff(),
+                  CircuitBreaker::defaultMinBackoff);
+
+        // Backoff has not elapsed; rails are skipped
+        device.monitorSensors(services, *system, *chassis);
+        EXPECT_TRUE(device.getCircuitBreaker().isOpen());
+
+        // Reset, such as when presence changes.  Rails are read again.
+        device.resetCircuitBreaker();
+        EXPECT_FALSE(device.getCircuitBreaker().isOpen());
+        device.monitorSensors(services, *system, *chassis);
+        EXPECT_FALSE(device.getCircuitBreaker().isOpen());
+        EXPECT_EQ(device.getCircuitBreaker().getFailureCount(), 1);
+    }
+
+    // Test where one rail always fails and the other rail works.  Breaker
+    // stays closed.
+    {
+        MockServices services{};
+        MockSensors& sensors = services.getMockSensors();
+        EXPECT_CALL(sensors, startRail("vdd0", deviceInvPath, chassisInvPath))
+            .Times(5);
+        EXPECT_CALL(sensors, startRail("vio0", deviceInvPath, chassisInvPath))
+            .Times(1);
+        EXPECT_CALL(sensors, endRail(true)).Times(5);
+        EXPECT_CALL(sensors, endRail(false)).Times(1);
+        EXPECT_CALL(sensors, skipRail("vio0")).Times(4);
+        EXPECT_CALL(sensors, disableRail).Times(0);
+
+        MockJournal& journal = services.getMockJournal();
+        EXPECT_CALL(journal, logError(A<const std::vector<std::string>&>()))
+            .Times(3);
+        EXPECT_CALL(journal, logError(A<const std::string&>())).Times(3);
+
+        MockErrorLogging& errorLogging = services.getMockErrorLogging();
+        EXPECT_CALL(errorLogging, logI2CError).Times(1);
+
+        std::vector<std::unique_ptr<Rail>> rails{};
+        rails.emplace_back(createRail("vdd0", true, 5));
+        rails.emplace_back(createRail("vio0", false, 1));
+        Device device{"reg2",
+                      true,
+                      deviceInvPath,
+                      createI2CInterface(),
+                      nullptr,
+                      nullptr,
+                      nullptr,
+                      std::move(rails)};
+
+        for (int i = 0; i < 5; ++i)
+        {
+            device.monitorSensors(services, *system, *chassis);
+        }
+        EXPECT_FALSE(device.getCircuitBreaker().isOpen());
+        EXPECT_EQ(device.getCircuitBreaker().getFailureCount(), 0);
+    }
+}
+
+TEST_F(DeviceTests, PageSelected)
+{
+    std::unique_ptr<i2c::I2CInterface> i2cInterface = createI2CInterface();
+    Device device{"reg2", true, deviceInvPath, std::move(i2cInterface)};
+
+    // Test where no page selected
+    EXPECT_FALSE(device.getCurrentPage().has_value());
+
+    // Test where page selected
+    device.pageSelected(0x00);
+    EXPECT_EQ(device.getCurrentPage(), 0x00);
+
+    // Test where different page selected
+    device.pageSelected(0x02);
+    EXPECT_EQ(device.getCurrentPage(), 0x02);
+}
+
+TEST_F(DeviceTests, RegisterWritten)
+{
+    auto i2cInterface = std::make_unique<i2c::MockedI2CInterface>();
+    EXPECT_CALL(*i2cInterface, read(TypedEq<uint8_t>(0x20), A<uint8_t&>()))
+        .Times(4)
+        .WillRepeatedly(SetArgReferee<1>(0b0001'1000));
+    Device device{"reg2", true, deviceInvPath, std::move(i2cInterface)};
+    device.getVoutMode();
+
+    // Test where unrelated register written.  Value is still cached.
+    device.registerWritten(0x21);
+    device.registerWritten(0x01, 0x1F);
+    device.getVoutMode();
+
+    // Test where PAGE written
+    device.registerWritten(0x00);
+    device.getVoutMode();
+
+    // Test where VOUT_MODE written
+    device.registerWritten(0x20);
+    device.getVoutMode();
+
+    // Test where range of registers that includes VOUT_MODE written
+    device.registerWritten(0x1E, 3);
+    device.getVoutMode();
+
+    // Test where unrelated register written.  Current page is still known.
+    device.pageSelected(0x01);
+    device.registerWritten(0x21);
+    EXPECT_EQ(device.getCurrentPage(), 0x01);
+
+    // Test where PAGE written.  Current page is unknown.
+    device.registerWritten(0x00);
+    EXPECT_FALSE(device.getCurrentPage().has_value());
 }
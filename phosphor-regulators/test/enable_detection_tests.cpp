@@ -0,0 +1,133 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "action.hpp"
+#include "action_environment.hpp"
+#include "enable_detection.hpp"
+#include "id_map.hpp"
+#include "mock_action.hpp"
+#include "mock_services.hpp"
+
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+using namespace phosphor::power::regulators;
+
+using ::testing::Return;
+using ::testing::Throw;
+
+TEST(EnableDetectionTests, Constructor)
+{
+    std::vector<std::unique_ptr<Action>> actions{};
+    actions.emplace_back(std::make_unique<MockAction>());
+
+    EnableDetection detection{std::move(actions)};
+    EXPECT_EQ(detection.getActions().size(), 1);
+    EXPECT_EQ(detection.getProgram(), nullptr);
+}
+
+TEST(EnableDetectionTests, Compile)
+{
+    std::vector<std::unique_ptr<Action>> actions{};
+    actions.emplace_back(std::make_unique<MockAction>());
+    EnableDetection detection{std::move(actions)};
+
+    IDMap idMap{};
+    detection.compile(idMap);
+    EXPECT_NE(detection.getProgram(), nullptr);
+}
+
+TEST(EnableDetectionTests, Execute)
+{
+    // Test where rail is enabled
+    {
+        std::unique_ptr<MockAction> action = std::make_unique<MockAction>();
+        EXPECT_CALL(*action, execute).Times(2).WillRepeatedly(Return(true));
+        std::vector<std::unique_ptr<Action>> actions{};
+        actions.emplace_back(std::move(action));
+        EnableDetection detection{std::move(actions)};
+
+        // Actions are executed each time; the result is not cached
+        IDMap idMap{};
+        MockServices services{};
+        ActionEnvironment env{idMap, "", services};
+        EXPECT_TRUE(detection.execute(env));
+        EXPECT_TRUE(detection.execute(env));
+    }
+
+    // Test where rail is disabled.  Uses the compiled program.
+    {
+        std::unique_ptr<MockAction> action = std::make_unique<MockAction>();
+        EXPECT_CALL(*action, execute).Times(1).WillOnce(Return(false));
+        std::vector<std::unique_ptr<Action>> actions{};
+        actions.emplace_back(std::move(action));
+        EnableDetection detection{std::move(actions)};
+
+        IDMap idMap{};
+        detection.compile(idMap);
+        MockServices services{};
+        ActionEnvironment env{idMap, "", services};
+        EXPECT_FALSE(detection.execute(env));
+    }
+
+    // Test where action throws an exception
+    {
+        std::unique_ptr<MockAction> action = std::make_unique<MockAction>();
+        EXPECT_CALL(*action, execute)
+            .Times(1)
+            .WillOnce(Throw(std::logic_error{"Communication error"}));
+        std::vector<std::unique_ptr<Action>> actions{};
+        actions.emplace_back(std::move(action));
+        EnableDetection detection{std::move(actions)};
+
+        IDMap idMap{};
+        MockServices services{};
+        ActionEnvironment env{idMap, "", services};
+        EXPECT_THROW(detection.execute(env), std::logic_error);
+    }
+}
+
+TEST(EnableDetectionTests, GetActions)
+{
+    std::vector<std::unique_ptr<Action>> actions{};
+
+    MockAction* action1 = new MockAction{};
+    actions.emplace_back(std::unique_ptr<MockAction>{action1});
+
+    MockAction* action2 = new MockAction{};
+    actions.emplace_back(std::unique_ptr<MockAction>{action2});
+
+    EnableDetection detection{std::move(actions)};
+    EXPECT_EQ(detection.getActions().size(), 2);
+    EXPECT_EQ(detection.getActions()[0].get(), action1);
+    EXPECT_EQ(detection.getActions()[1].get(), action2);
+}
+
+TEST(EnableDetectionTests, GetProgram)
+{
+    std::vector<std::unique_ptr<Action>> actions{};
+    actions.emplace_back(std::make_unique<MockAction>());
+    EnableDetection detection{std::move(actions)};
+    EXPECT_EQ(detection.getProgram(), nullptr);
+
+    IDMap idMap{};
+    detection.compile(idMap);
+    EXPECT_NE(detection.getProgram(), nullptr);
+}
@@ -117,6 +117,42 @@ TEST(ExceptionUtilsTests, GetMessages)
     }
 }
 
+TEST(ExceptionUtilsTests, MessageView)
+{
+    try
+    {
+        try
+        {
+            throw std::invalid_argument{"JSON element is not an array"};
+        }
+        catch (...)
+        {
+            std::throw_with_nested(
+                std::logic_error{"Unable to parse config file"});
+        }
+    }
+    catch (const std::exception& e)
+    {
+        exception_utils::MessageView view{e};
+
+        // Test forEach()
+        std::vector<std::string> messages{};
+        view.forEach(
+            [&messages](const char* message) { messages.push_back(message); });
+        EXPECT_EQ(messages.size(), 2);
+        EXPECT_EQ(messages[0], "JSON element is not an array");
+        EXPECT_EQ(messages[1], "Unable to parse config file");
+
+        // Test toVector()
+        EXPECT_EQ(view.toVector(), messages);
+
+        // Test logging the view in the journal
+        MockJournal journal{};
+        EXPECT_CALL(journal, logError(messages)).Times(1);
+        journal.logError(view);
+    }
+}
+
 TEST(ExceptionUtilsTests, InternalGetExceptions)
 {
     // Test where exception pointer is null
@@ -0,0 +1,83 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "journal_rate_limiter.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+
+#include <gtest/gtest.h>
+
+using namespace phosphor::power::regulators;
+using namespace std::chrono_literals;
+
+TEST(JournalRateLimiterTests, Allow)
+{
+    JournalRateLimiter limiter{2, 10s, 10};
+    JournalRateLimiter::Clock::time_point now{};
+    std::size_t suppressed{99};
+
+    // Test where message is logged up to the burst
+    EXPECT_TRUE(limiter.allow("Bus error", now, suppressed));
+    EXPECT_EQ(suppressed, 0);
+    EXPECT_TRUE(limiter.allow("Bus error", now + 1s, suppressed));
+    EXPECT_EQ(suppressed, 0);
+
+    // Test where message is suppressed after the burst
+    EXPECT_FALSE(limiter.allow("Bus error", now + 2s, suppressed));
+    EXPECT_FALSE(limiter.allow("Bus error", now + 9s, suppressed));
+    EXPECT_EQ(suppressed, 0);
+
+    // Test where a different message is not affected
+    EXPECT_TRUE(limiter.allow("Rail vdd1 fault", now + 9s, suppressed));
+    EXPECT_EQ(suppressed, 0);
+
+    // Test where message is logged in the next interval with the number of
+    // suppressed occurrences
+    EXPECT_TRUE(limiter.allow("Bus error", now + 10s, suppressed));
+    EXPECT_EQ(suppressed, 2);
+    EXPECT_TRUE(limiter.allow("Bus error", now + 11s, suppressed));
+    EXPECT_EQ(suppressed, 0);
+    EXPECT_FALSE(limiter.allow("Bus error", now + 12s, suppressed));
+
+    // Test where nothing was suppressed in the previous interval
+    EXPECT_TRUE(limiter.allow("Rail vdd1 fault", now + 30s, suppressed));
+    EXPECT_EQ(suppressed, 0);
+}
+
+TEST(JournalRateLimiterTests, MaxMessages)
+{
+    JournalRateLimiter limiter{1, 10s, 2};
+    JournalRateLimiter::Clock::time_point now{};
+    std::size_t suppressed{0};
+
+    EXPECT_TRUE(limiter.allow("message 1", now, suppressed));
+    EXPECT_TRUE(limiter.allow("message 2", now + 5s, suppressed));
+    EXPECT_EQ(limiter.getMessageCount(), 2);
+
+    // Test where too many messages are tracked; new message is logged
+    // without being tracked
+    EXPECT_TRUE(limiter.allow("message 3", now + 5s, suppressed));
+    EXPECT_TRUE(limiter.allow("message 3", now + 5s, suppressed));
+    EXPECT_EQ(limiter.getMessageCount(), 2);
+    EXPECT_FALSE(limiter.allow("message 1", now + 5s, suppressed));
+
+    // Test where an expired message is forgotten to make room
+    EXPECT_TRUE(limiter.allow("message 3", now + 12s, suppressed));
+    EXPECT_EQ(limiter.getMessageCount(), 2);
+    EXPECT_FALSE(limiter.allow("message 3", now + 12s, suppressed));
+    EXPECT_FALSE(limiter.allow("message 2", now + 12s, suppressed));
+}
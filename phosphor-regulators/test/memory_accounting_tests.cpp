@@ -0,0 +1,125 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "memory_accounting.hpp"
+
+#include <string>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+using namespace phosphor::power::regulators;
+using namespace phosphor::power::regulators::memory_accounting;
+
+TEST(MemoryAccountingTests, Scope)
+{
+    EXPECT_EQ(getCurrentTag(), Tag::other);
+    {
+        Scope outer{Tag::configTree};
+        EXPECT_EQ(getCurrentTag(), Tag::configTree);
+        {
+            Scope inner{Tag::caches};
+            EXPECT_EQ(getCurrentTag(), Tag::caches);
+
+            // Tag is not changed on other threads
+            Tag otherThreadTag{Tag::errorLogging};
+            std::thread thread{[&otherThreadTag]() {
+                otherThreadTag = getCurrentTag();
+            }};
+            thread.join();
+            EXPECT_EQ(otherThreadTag, Tag::other);
+        }
+        EXPECT_EQ(getCurrentTag(), Tag::configTree);
+    }
+    EXPECT_EQ(getCurrentTag(), Tag::other);
+}
+
+TEST(MemoryAccountingTests, GetName)
+{
+    EXPECT_EQ(std::string{getName(Tag::other)}, "other");
+    EXPECT_EQ(std::string{getName(Tag::configTree)}, "config_tree");
+    EXPECT_EQ(std::string{getName(Tag::dbusSensors)}, "dbus_sensors");
+    EXPECT_EQ(std::string{getName(Tag::caches)}, "caches");
+    EXPECT_EQ(std::string{getName(Tag::errorLogging)}, "error_logging");
+}
+
+TEST(MemoryAccountingTests, RecordAllocation)
+{
+    Usage before = getUsage(Tag::dbusSensors);
+    Usage otherBefore = getUsage(Tag::caches);
+
+    recordAllocation(Tag::dbusSensors, 100);
+    recordAllocation(Tag::dbusSensors, 28);
+    Usage usage = getUsage(Tag::dbusSensors);
+    EXPECT_EQ(usage.currentBytes, before.currentBytes + 128);
+    EXPECT_EQ(usage.allocations, before.allocations + 2);
+    EXPECT_GE(usage.peakBytes, usage.currentBytes);
+
+    // Other tags are not changed
+    Usage otherUsage = getUsage(Tag::caches);
+    EXPECT_EQ(otherUsage.currentBytes, otherBefore.currentBytes);
+    EXPECT_EQ(otherUsage.allocations, otherBefore.allocations);
+
+    // Peak is kept after deallocation
+    std::size_t peak = usage.peakBytes;
+    recordDeallocation(Tag::dbusSensors, 100);
+    recordDeallocation(Tag::dbusSensors, 28);
+    usage = getUsage(Tag::dbusSensors);
+    EXPECT_EQ(usage.currentBytes, before.currentBytes);
+    EXPECT_EQ(usage.allocations, before.allocations);
+    EXPECT_EQ(usage.peakBytes, peak);
+}
+
+TEST(MemoryAccountingTests, ResetPeaks)
+{
+    recordAllocation(Tag::errorLogging, 4096);
+    recordDeallocation(Tag::errorLogging, 4096);
+    Usage usage = getUsage(Tag::errorLogging);
+    EXPECT_GE(usage.peakBytes, usage.currentBytes + 4096);
+
+    resetPeaks();
+    usage = getUsage(Tag::errorLogging);
+    EXPECT_EQ(usage.peakBytes, usage.currentBytes);
+
+    // Peak is raised by the next allocation
+    recordAllocation(Tag::errorLogging, 16);
+    usage = getUsage(Tag::errorLogging);
+    EXPECT_EQ(usage.peakBytes, usage.currentBytes);
+    recordDeallocation(Tag::errorLogging, 16);
+}
+
+TEST(MemoryAccountingTests, ToString)
+{
+    // Not enabled, since operator new is not replaced in the tests
+    EXPECT_FALSE(isEnabled());
+    EXPECT_EQ(toString(), "Memory accounting is not enabled in this build\n");
+
+    enable();
+    EXPECT_TRUE(isEnabled());
+    recordAllocation(Tag::configTree, 64);
+    Usage usage = getUsage(Tag::configTree);
+    std::string text = toString();
+    EXPECT_EQ(text.find("other: current: "), 0);
+    EXPECT_NE(text.find("\nconfig_tree: current: " +
+                        std::to_string(usage.currentBytes) + " bytes, peak: " +
+                        std::to_string(usage.peakBytes) +
+                        " bytes, allocations: " +
+                        std::to_string(usage.allocations) + '\n'),
+              std::string::npos);
+    EXPECT_NE(text.find("\ndbus_sensors: current: "), std::string::npos);
+    EXPECT_NE(text.find("\ncaches: current: "), std::string::npos);
+    EXPECT_NE(text.find("\nerror_logging: current: "), std::string::npos);
+    recordDeallocation(Tag::configTree, 64);
+}
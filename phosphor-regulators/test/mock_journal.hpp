@@ -48,6 +48,9 @@ class MockJournal : public Journal
     MOCK_METHOD(void, logDebug, (const std::string& message), (override));
     MOCK_METHOD(void, logDebug, (const std::vector<std::string>& messages),
                 (override));
+    // Do not hide the Journal::logError(const MessageView&) overload
+    using Journal::logError;
+
     MOCK_METHOD(void, logError, (const std::string& message), (override));
     MOCK_METHOD(void, logError, (const std::vector<std::string>& messages),
                 (override));
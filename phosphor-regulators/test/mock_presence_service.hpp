@@ -40,6 +40,11 @@ class MockPresenceService : public PresenceService
 
     MOCK_METHOD(void, clearCache, (), (override));
 
+    MOCK_METHOD(std::optional<bool>, getCachedPresence,
+                (const std::string& inventoryPath), (override));
+
+    MOCK_METHOD(uint64_t, getGeneration, (), (override));
+
     MOCK_METHOD(bool, isPresent, (const std::string& inventoryPath),
                 (override));
 };
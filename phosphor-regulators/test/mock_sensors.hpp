@@ -17,6 +17,7 @@
 
 #include "sensors.hpp"
 
+#include <chrono>
 #include <string>
 
 #include <gmock/gmock.h>
@@ -48,8 +49,30 @@ class MockSensors : public Sensors
 
     MOCK_METHOD(void, disable, (), (override));
 
+    MOCK_METHOD(void, disableRail, (const std::string& rail), (override));
+
+    MOCK_METHOD(void, setAggregatedValue,
+                (SensorType type, double value,
+                 const SensorAggregation& aggregation),
+                (override));
+
     MOCK_METHOD(void, setValue, (SensorType type, double value), (override));
 
+    /**
+     * Stores the read time and calls the mocked two argument setValue(), so
+     * the tests can set expectations on the values regardless of the read
+     * time.
+     */
+    virtual void
+        setValue(SensorType type, double value,
+                 std::chrono::steady_clock::time_point readTime) override
+    {
+        lastReadTime = readTime;
+        setValue(type, value);
+    }
+
+    MOCK_METHOD(void, skipRail, (const std::string& rail), (override));
+
     MOCK_METHOD(void, startCycle, (), (override));
 
     MOCK_METHOD(void, startRail,
@@ -57,6 +80,11 @@ class MockSensors : public Sensors
                  const std::string& deviceInventoryPath,
                  const std::string& chassisInventoryPath),
                 (override));
+
+    /**
+     * Read time passed to the last setValue() call that specified one.
+     */
+    std::chrono::steady_clock::time_point lastReadTime{};
 };
 
 } // namespace phosphor::power::regulators
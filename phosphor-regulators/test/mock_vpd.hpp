@@ -40,6 +40,12 @@ class MockVPD : public VPD
 
     MOCK_METHOD(void, clearCache, (), (override));
 
+    MOCK_METHOD(std::optional<std::vector<uint8_t>>, getCachedValue,
+                (const std::string& inventoryPath, const std::string& keyword),
+                (override));
+
+    MOCK_METHOD(uint64_t, getGeneration, (), (override));
+
     MOCK_METHOD(std::vector<uint8_t>, getValue,
                 (const std::string& inventoryPath, const std::string& keyword),
                 (override));
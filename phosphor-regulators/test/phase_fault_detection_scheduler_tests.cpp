@@ -0,0 +1,251 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "action_environment.hpp"
+#include "chassis.hpp"
+#include "configuration.hpp"
+#include "device.hpp"
+#include "mock_action.hpp"
+#include "mock_services.hpp"
+#include "mocked_i2c_interface.hpp"
+#include "phase_fault.hpp"
+#include "phase_fault_detection.hpp"
+#include "phase_fault_detection_scheduler.hpp"
+#include "presence_detection.hpp"
+#include "rail.hpp"
+#include "rule.hpp"
+#include "system.hpp"
+#include "test_utils.hpp"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+using namespace phosphor::power::regulators;
+using namespace phosphor::power::regulators::test_utils;
+
+static const std::string chassisInvPath{
+    "/xyz/openbmc_project/inventory/system/chassis"};
+
+/**
+ * Creates a Device with phase fault detection.
+ *
+ * Detecting phase faults appends the device ID to the specified vector.
+ *
+ * @param id device ID
+ * @param detected IDs of devices in which phase faults were detected
+ * @param hasPhaseFault optional flag; an N phase fault is detected while it is
+ *                      true
+ * @return Device object
+ */
+static std::unique_ptr<Device>
+    createDevice(const std::string& id, std::vector<std::string>& detected,
+                 const bool* hasPhaseFault = nullptr)
+{
+    // Create PhaseFaultDetection
+    auto action = std::make_unique<MockAction>();
+    EXPECT_CALL(*action, execute)
+        .WillRepeatedly(
+            [id, &detected, hasPhaseFault](ActionEnvironment& environment) {
+                detected.emplace_back(id);
+                if ((hasPhaseFault != nullptr) && *hasPhaseFault)
+                {
+                    environment.addPhaseFault(PhaseFaultType::n);
+                }
+                return true;
+            });
+    std::vector<std::unique_ptr<Action>> actions{};
+    actions.emplace_back(std::move(action));
+    auto phaseFaultDetection =
+        std::make_unique<PhaseFaultDetection>(std::move(actions));
+
+    // Create Device
+    auto i2cInterface = std::make_unique<i2c::MockedI2CInterface>();
+    std::unique_ptr<PresenceDetection> presenceDetection{};
+    std::unique_ptr<Configuration> configuration{};
+    return std::make_unique<Device>(
+        id, true,
+        "/xyz/openbmc_project/inventory/system/chassis/motherboard/" + id,
+        std::move(i2cInterface), std::move(presenceDetection),
+        std::move(configuration), std::move(phaseFaultDetection));
+}
+
+TEST(PhaseFaultDetectionSchedulerTests, Constructor)
+{
+    std::vector<std::string> detected{};
+
+    // Test where system contains no devices
+    {
+        auto system = createSystem({});
+        PhaseFaultDetectionScheduler scheduler{*system, 15};
+        EXPECT_EQ(scheduler.getDeviceCount(), 0);
+        EXPECT_EQ(scheduler.getSliceCount(), 15);
+        EXPECT_EQ(scheduler.getNextSlice(), 0);
+    }
+
+    // Test where some devices do not have phase fault detection
+    {
+        std::vector<std::unique_ptr<Device>> devices{};
+        devices.emplace_back(createDevice("vdd0_reg", detected));
+        devices.emplace_back(std::make_unique<Device>(
+            "ioexp", false,
+            "/xyz/openbmc_project/inventory/system/chassis/motherboard/ioexp",
+            std::make_unique<i2c::MockedI2CInterface>()));
+        devices.emplace_back(createDevice("vdd1_reg", detected));
+        auto system = createSystem(std::move(devices));
+        PhaseFaultDetectionScheduler scheduler{*system, 15};
+        EXPECT_EQ(scheduler.getDeviceCount(), 2);
+    }
+
+    // Test where slice count is 0
+    {
+        auto system = createSystem({});
+        PhaseFaultDetectionScheduler scheduler{*system, 0};
+        EXPECT_EQ(scheduler.getSliceCount(), 1);
+    }
+
+    // Test where only the devices in some chassis are checked
+    {
+        std::vector<std::unique_ptr<Device>> devices{};
+        devices.emplace_back(createDevice("vdd0_reg", detected));
+        auto system = createSystem(std::move(devices));
+        std::vector<std::unique_ptr<Device>> devices2{};
+        devices2.emplace_back(createDevice("vdd1_reg", detected));
+        devices2.emplace_back(createDevice("vdd2_reg", detected));
+        std::vector<std::unique_ptr<Chassis>> chassis{};
+        chassis.emplace_back(std::make_unique<Chassis>(
+            2, chassisInvPath + "2", std::move(devices2)));
+        system->addChassis(std::move(chassis));
+
+        std::vector<Chassis*> checkedChassis{system->getChassis()[1].get()};
+        PhaseFaultDetectionScheduler scheduler{*system, checkedChassis, 15};
+        EXPECT_EQ(scheduler.getDeviceCount(), 2);
+
+        PhaseFaultDetectionScheduler noScheduler{*system, {}, 15};
+        EXPECT_EQ(noScheduler.getDeviceCount(), 0);
+    }
+}
+
+TEST(PhaseFaultDetectionSchedulerTests, Execute)
+{
+    // Test where system contains no devices
+    {
+        MockServices services{};
+        auto system = createSystem({});
+        PhaseFaultDetectionScheduler scheduler{*system, 3};
+        scheduler.execute(services);
+        EXPECT_EQ(scheduler.getNextSlice(), 1);
+    }
+
+    // Test where there are more devices than slices.  Devices are spread
+    // evenly and each device is checked once per interval.
+    {
+        MockServices services{};
+        std::vector<std::string> detected{};
+        std::vector<std::unique_ptr<Device>> devices{};
+        for (const char* id : {"reg0", "reg1", "reg2", "reg3", "reg4"})
+        {
+            devices.emplace_back(createDevice(id, detected));
+        }
+        auto system = createSystem(std::move(devices));
+        PhaseFaultDetectionScheduler scheduler{*system, 3};
+
+        scheduler.execute(services);
+        EXPECT_EQ(detected, (std::vector<std::string>{"reg0"}));
+        EXPECT_EQ(scheduler.getNextSlice(), 1);
+
+        detected.clear();
+        scheduler.execute(services);
+        EXPECT_EQ(detected, (std::vector<std::string>{"reg1", "reg2"}));
+        EXPECT_EQ(scheduler.getNextSlice(), 2);
+
+        detected.clear();
+        scheduler.execute(services);
+        EXPECT_EQ(detected, (std::vector<std::string>{"reg3", "reg4"}));
+        EXPECT_EQ(scheduler.getNextSlice(), 0);
+
+        // Next interval starts with the first slice again
+        detected.clear();
+        scheduler.execute(services);
+        EXPECT_EQ(detected, (std::vector<std::string>{"reg0"}));
+    }
+
+    // Test where there are fewer devices than slices.  Some slices are empty.
+    {
+        MockServices services{};
+        std::vector<std::string> detected{};
+        std::vector<std::unique_ptr<Device>> devices{};
+        devices.emplace_back(createDevice("reg0", detected));
+        devices.emplace_back(createDevice("reg1", detected));
+        auto system = createSystem(std::move(devices));
+        PhaseFaultDetectionScheduler scheduler{*system, 4};
+
+        for (int tick = 0; tick < 8; ++tick)
+        {
+            scheduler.execute(services);
+        }
+        EXPECT_EQ(detected, (std::vector<std::string>{"reg0", "reg1", "reg0",
+                                                      "reg1"}));
+    }
+}
+
+TEST(PhaseFaultDetectionSchedulerTests, ExecuteConfirmPhaseFault)
+{
+    MockServices services{};
+    std::vector<std::string> detected{};
+    bool reg1HasFault{true};
+    bool reg2HasFault{false};
+    std::vector<std::unique_ptr<Device>> devices{};
+    devices.emplace_back(createDevice("reg0", detected));
+    devices.emplace_back(createDevice("reg1", detected, &reg1HasFault));
+    devices.emplace_back(createDevice("reg2", detected, &reg2HasFault));
+    auto system = createSystem(std::move(devices));
+    PhaseFaultDetectionScheduler scheduler{*system, 3};
+
+    // Test where phase fault is confirmed during the next tick
+    scheduler.execute(services);
+    EXPECT_EQ(detected, (std::vector<std::string>{"reg0"}));
+    detected.clear();
+    scheduler.execute(services);
+    EXPECT_EQ(detected, (std::vector<std::string>{"reg1"}));
+    detected.clear();
+    scheduler.execute(services);
+    EXPECT_EQ(detected, (std::vector<std::string>{"reg1", "reg2"}));
+
+    // Logged phase fault is only checked during its own slice
+    detected.clear();
+    scheduler.execute(services);
+    EXPECT_EQ(detected, (std::vector<std::string>{"reg0"}));
+    detected.clear();
+    scheduler.execute(services);
+    EXPECT_EQ(detected, (std::vector<std::string>{"reg1"}));
+
+    // Test where phase fault is cleared during the next tick
+    reg2HasFault = true;
+    detected.clear();
+    scheduler.execute(services);
+    EXPECT_EQ(detected, (std::vector<std::string>{"reg2"}));
+    reg2HasFault = false;
+    detected.clear();
+    scheduler.execute(services);
+    EXPECT_EQ(detected, (std::vector<std::string>{"reg0", "reg2"}));
+    detected.clear();
+    scheduler.execute(services);
+    EXPECT_EQ(detected, (std::vector<std::string>{"reg1"}));
+}
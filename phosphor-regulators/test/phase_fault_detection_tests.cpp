@@ -727,6 +727,52 @@ TEST_F(PhaseFaultDetectionTests, Execute)
     }
 }
 
+TEST_F(PhaseFaultDetectionTests, IsConfirming)
+{
+    // Create MockAction that detects the phase faults in faultTypes
+    std::vector<PhaseFaultType> faultTypes{};
+    auto action = std::make_unique<MockAction>();
+    EXPECT_CALL(*action, execute)
+        .WillRepeatedly([&faultTypes](ActionEnvironment& environment) {
+            for (PhaseFaultType type : faultTypes)
+            {
+                environment.addPhaseFault(type);
+            }
+            return true;
+        });
+    std::vector<std::unique_ptr<Action>> actions{};
+    actions.push_back(std::move(action));
+    PhaseFaultDetection detection{std::move(actions)};
+    MockServices services{};
+    EXPECT_FALSE(detection.isConfirming());
+
+    // Test where N phase fault is detected once and then cleared
+    faultTypes = {PhaseFaultType::n};
+    detection.execute(services, *system, *chassis, *regulator);
+    EXPECT_TRUE(detection.isConfirming());
+    faultTypes.clear();
+    detection.execute(services, *system, *chassis, *regulator);
+    EXPECT_FALSE(detection.isConfirming());
+
+    // Test where N phase fault is confirmed and logged
+    faultTypes = {PhaseFaultType::n};
+    detection.execute(services, *system, *chassis, *regulator);
+    EXPECT_TRUE(detection.isConfirming());
+    detection.execute(services, *system, *chassis, *regulator);
+    EXPECT_FALSE(detection.isConfirming());
+    detection.execute(services, *system, *chassis, *regulator);
+    EXPECT_FALSE(detection.isConfirming());
+
+    // Test where N+1 phase fault is detected after N phase fault was logged
+    faultTypes = {PhaseFaultType::n, PhaseFaultType::n_plus_1};
+    detection.execute(services, *system, *chassis, *regulator);
+    EXPECT_TRUE(detection.isConfirming());
+
+    // Test where error history is cleared
+    detection.clearErrorHistory();
+    EXPECT_FALSE(detection.isConfirming());
+}
+
 TEST_F(PhaseFaultDetectionTests, GetActions)
 {
     std::vector<std::unique_ptr<Action>> actions{};
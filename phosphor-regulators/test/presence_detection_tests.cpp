@@ -31,9 +31,12 @@
 
 #include <sdbusplus/exception.hpp>
 
+#include <chrono>
 #include <memory>
+#include <optional>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <tuple>
 #include <utility>
 #include <vector>
@@ -101,6 +104,7 @@ TEST(PresenceDetectionTests, Constructor)
     PresenceDetection detection{std::move(actions)};
     EXPECT_EQ(detection.getActions().size(), 1);
     EXPECT_FALSE(detection.getCachedPresence().has_value());
+    EXPECT_FALSE(detection.getCacheTTL().has_value());
 }
 
 TEST(PresenceDetectionTests, ClearCache)
@@ -272,6 +276,36 @@ TEST(PresenceDetectionTests, Execute)
     }
 }
 
+TEST(PresenceDetectionTests, ExecuteCacheTTL)
+{
+    // Create MockAction that finds the device missing, then present
+    std::unique_ptr<MockAction> action = std::make_unique<MockAction>();
+    EXPECT_CALL(*action, execute)
+        .Times(2)
+        .WillOnce(Return(false))
+        .WillOnce(Return(true));
+
+    // Create PresenceDetection with a cache TTL
+    std::vector<std::unique_ptr<Action>> actions{};
+    actions.emplace_back(std::move(action));
+    PresenceDetection* detection = new PresenceDetection(
+        std::move(actions), std::chrono::milliseconds{50});
+
+    // Create parent System, Chassis, and Device objects
+    auto [system, chassis, device] =
+        createParentObjects(std::unique_ptr<PresenceDetection>{detection});
+
+    // Presence is cached until the TTL expires
+    MockServices services{};
+    EXPECT_FALSE(detection->execute(services, *system, *chassis, *device));
+    EXPECT_FALSE(detection->execute(services, *system, *chassis, *device));
+
+    // Presence is re-detected after the TTL expires
+    std::this_thread::sleep_for(std::chrono::milliseconds{60});
+    EXPECT_TRUE(detection->execute(services, *system, *chassis, *device));
+    EXPECT_TRUE(detection->getCachedPresence().value());
+}
+
 TEST(PresenceDetectionTests, GetActions)
 {
     std::vector<std::unique_ptr<Action>> actions{};
@@ -320,3 +354,35 @@ TEST(PresenceDetectionTests, GetCachedPresence)
     // Verify that no presence value is cached
     EXPECT_FALSE(detection->getCachedPresence().has_value());
 }
+
+TEST(PresenceDetectionTests, GetCacheTTL)
+{
+    std::vector<std::unique_ptr<Action>> actions{};
+    actions.emplace_back(std::make_unique<MockAction>());
+
+    PresenceDetection detection{std::move(actions),
+                                std::chrono::milliseconds{1000}};
+    EXPECT_EQ(detection.getCacheTTL(), std::chrono::milliseconds{1000});
+}
+
+TEST(PresenceDetectionTests, GetInventoryPaths)
+{
+    std::vector<std::unique_ptr<Action>> actions{};
+    actions.emplace_back(std::make_unique<MockAction>());
+    PresenceDetection detection{std::move(actions)};
+
+    // Verify that initially the actions might depend on other data
+    EXPECT_FALSE(detection.getInventoryPaths().has_value());
+    EXPECT_FALSE(detection.dependsOnlyOnPresence());
+
+    // Set inventory paths
+    const std::string cpu0{"/xyz/openbmc_project/inventory/system/chassis/"
+                           "motherboard/cpu0"};
+    detection.setInventoryPaths(std::vector<std::string>{cpu0});
+    EXPECT_EQ(detection.getInventoryPaths(), std::vector<std::string>{cpu0});
+    EXPECT_TRUE(detection.dependsOnlyOnPresence());
+
+    // Clear inventory paths
+    detection.setInventoryPaths(std::nullopt);
+    EXPECT_FALSE(detection.dependsOnlyOnPresence());
+}
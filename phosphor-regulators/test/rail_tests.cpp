@@ -32,6 +32,7 @@
 #include "sensors.hpp"
 #include "system.hpp"
 #include "test_sdbus_error.hpp"
+#include "voltage_setpoint.hpp"
 
 #include <memory>
 #include <optional>
@@ -45,6 +46,7 @@ using namespace phosphor::power::regulators;
 
 using ::testing::A;
 using ::testing::Return;
+using ::testing::SetArgReferee;
 using ::testing::Throw;
 using ::testing::TypedEq;
 
@@ -90,6 +92,46 @@ TEST(RailTests, Constructor)
     }
 }
 
+TEST(RailTests, ClearCache)
+{
+    // Test where VoltageSetpoint was not specified
+    {
+        Rail rail{"vdd0"};
+        rail.clearCache();
+    }
+
+    // Test where VoltageSetpoint was specified.  VOUT_MODE is read again
+    // after the cache is cleared.
+    {
+        auto i2cInterface = std::make_unique<i2c::MockedI2CInterface>();
+        EXPECT_CALL(*i2cInterface, isOpen).WillRepeatedly(Return(true));
+        EXPECT_CALL(*i2cInterface, read(TypedEq<uint8_t>(0x20), A<uint8_t&>()))
+            .Times(2)
+            .WillRepeatedly(SetArgReferee<1>(0b0001'1000));
+        EXPECT_CALL(*i2cInterface, write(TypedEq<uint8_t>(0x21),
+                                         TypedEq<uint16_t>(0x0100)))
+            .Times(3);
+
+        auto rail = std::make_unique<Rail>("vdd0");
+        rail->setVoltageSetpoint(std::make_unique<VoltageSetpoint>(0.7, 1.2));
+        Rail* railPtr = rail.get();
+        std::vector<std::unique_ptr<Rail>> rails{};
+        rails.emplace_back(std::move(rail));
+        Device device{
+            "reg1", true,
+            "/xyz/openbmc_project/inventory/system/chassis/motherboard/reg1",
+            std::move(i2cInterface), nullptr, nullptr, nullptr,
+            std::move(rails)};
+
+        railPtr->getVoltageSetpoint()->set(device, 1.0);
+        railPtr->getVoltageSetpoint()->set(device, 1.0);
+
+        // Device clears the cache of its rails
+        device.clearCache();
+        railPtr->getVoltageSetpoint()->set(device, 1.0);
+    }
+}
+
 TEST(RailTests, ClearErrorHistory)
 {
     // Create SensorMonitoring.  Will fail with a DBus exception.
@@ -217,7 +259,8 @@ TEST(RailTests, Configure)
         System system{std::move(rules), std::move(chassisVec)};
 
         // Call configure().
-        railPtr->configure(services, system, *chassisPtr, *devicePtr);
+        EXPECT_TRUE(
+            railPtr->configure(services, system, *chassisPtr, *devicePtr));
     }
 
     // Test where Configuration was specified in constructor
@@ -273,7 +316,8 @@ TEST(RailTests, Configure)
         System system{std::move(rules), std::move(chassisVec)};
 
         // Call configure().
-        railPtr->configure(services, system, *chassisPtr, *devicePtr);
+        EXPECT_TRUE(
+            railPtr->configure(services, system, *chassisPtr, *devicePtr));
     }
 }
 
@@ -445,3 +489,25 @@ TEST(RailTests, GetSensorMonitoring)
         EXPECT_EQ(rail.getSensorMonitoring()->getActions().size(), 2);
     }
 }
+
+TEST(RailTests, GetVoltageSetpoint)
+{
+    // Test where VoltageSetpoint was not specified
+    {
+        Rail rail{"vdd0"};
+        EXPECT_EQ(rail.getVoltageSetpoint(), nullptr);
+    }
+
+    // Test where VoltageSetpoint was specified
+    {
+        Rail rail{"vdd0"};
+        rail.setVoltageSetpoint(
+            std::make_unique<VoltageSetpoint>(0.7, 1.2, 0x01));
+        EXPECT_NE(rail.getVoltageSetpoint(), nullptr);
+        EXPECT_EQ(rail.getVoltageSetpoint()->getMaximum(), 1.2);
+        EXPECT_EQ(rail.getVoltageSetpoint()->getPage(), 0x01);
+
+        rail.setVoltageSetpoint(nullptr);
+        EXPECT_EQ(rail.getVoltageSetpoint(), nullptr);
+    }
+}
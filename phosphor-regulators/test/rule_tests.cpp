@@ -47,6 +47,29 @@ TEST(RuleTests, Constructor)
     EXPECT_EQ(rule.getActions().size(), 2);
 }
 
+TEST(RuleTests, ClearCache)
+{
+    IDMap idMap{};
+    MockServices services{};
+    ActionEnvironment env{idMap, "", services};
+    ON_CALL(services.getMockPresenceService(), getGeneration)
+        .WillByDefault(Return(1));
+    ON_CALL(services.getMockVPD(), getGeneration).WillByDefault(Return(1));
+
+    std::vector<std::unique_ptr<Action>> actions{};
+    std::unique_ptr<MockAction> action = std::make_unique<MockAction>();
+    EXPECT_CALL(*action, execute).Times(2).WillRepeatedly(Return(true));
+    actions.push_back(std::move(action));
+
+    // Verify the memoized result is not used after clearing the cache
+    Rule rule("is_foobar_backplane_installed_rule", std::move(actions));
+    rule.setMemoizable(true);
+    EXPECT_EQ(rule.execute(env), true);
+    EXPECT_EQ(rule.execute(env), true);
+    rule.clearCache();
+    EXPECT_EQ(rule.execute(env), true);
+}
+
 TEST(RuleTests, Execute)
 {
     // Create ActionEnvironment
@@ -96,6 +119,103 @@ TEST(RuleTests, Execute)
     {
         ADD_FAILURE() << "Should not have caught exception.";
     }
+
+    // Test where memoizable rule result is reused until the presence or VPD
+    // data changes
+    {
+        MockServices services{};
+        ActionEnvironment env{idMap, "", services};
+        EXPECT_CALL(services.getMockPresenceService(), getGeneration)
+            .WillOnce(Return(1))
+            .WillOnce(Return(1))
+            .WillOnce(Return(2))
+            .WillOnce(Return(2));
+        EXPECT_CALL(services.getMockVPD(), getGeneration)
+            .WillOnce(Return(1))
+            .WillOnce(Return(1))
+            .WillOnce(Return(1))
+            .WillOnce(Return(2));
+
+        std::vector<std::unique_ptr<Action>> actions{};
+        std::unique_ptr<MockAction> action = std::make_unique<MockAction>();
+        EXPECT_CALL(*action, execute)
+            .Times(3)
+            .WillOnce(Return(true))
+            .WillOnce(Return(false))
+            .WillOnce(Return(true));
+        actions.push_back(std::move(action));
+
+        Rule rule("is_foobar_backplane_installed_rule", std::move(actions));
+        rule.setMemoizable(true);
+        EXPECT_EQ(rule.execute(env), true);
+        EXPECT_EQ(rule.execute(env), true);
+        EXPECT_EQ(rule.execute(env), false);
+        EXPECT_EQ(rule.execute(env), true);
+    }
+
+    // Test where memoizable rule result is not reused: Changes to the
+    // presence data are not tracked
+    {
+        MockServices services{};
+        ActionEnvironment env{idMap, "", services};
+        EXPECT_CALL(services.getMockPresenceService(), getGeneration)
+            .Times(2)
+            .WillRepeatedly(Return(0));
+        EXPECT_CALL(services.getMockVPD(), getGeneration)
+            .Times(2)
+            .WillRepeatedly(Return(1));
+
+        std::vector<std::unique_ptr<Action>> actions{};
+        std::unique_ptr<MockAction> action = std::make_unique<MockAction>();
+        EXPECT_CALL(*action, execute).Times(2).WillRepeatedly(Return(true));
+        actions.push_back(std::move(action));
+
+        Rule rule("is_foobar_backplane_installed_rule", std::move(actions));
+        rule.setMemoizable(true);
+        EXPECT_EQ(rule.execute(env), true);
+        EXPECT_EQ(rule.execute(env), true);
+    }
+
+    // Test where memoizable rule result is not stored: Action throws an
+    // exception
+    {
+        MockServices services{};
+        ActionEnvironment env{idMap, "", services};
+        ON_CALL(services.getMockPresenceService(), getGeneration)
+            .WillByDefault(Return(1));
+        ON_CALL(services.getMockVPD(), getGeneration).WillByDefault(Return(1));
+
+        std::vector<std::unique_ptr<Action>> actions{};
+        std::unique_ptr<MockAction> action = std::make_unique<MockAction>();
+        EXPECT_CALL(*action, execute)
+            .Times(2)
+            .WillOnce(Throw(std::logic_error{"D-Bus error"}))
+            .WillOnce(Return(false));
+        actions.push_back(std::move(action));
+
+        Rule rule("is_foobar_backplane_installed_rule", std::move(actions));
+        rule.setMemoizable(true);
+        EXPECT_THROW(rule.execute(env), std::logic_error);
+        EXPECT_EQ(rule.execute(env), false);
+        EXPECT_EQ(rule.execute(env), false);
+    }
+
+    // Test where rule is not memoizable: Services are not used
+    {
+        MockServices services{};
+        ActionEnvironment env{idMap, "", services};
+        EXPECT_CALL(services.getMockPresenceService(), getGeneration).Times(0);
+        EXPECT_CALL(services.getMockVPD(), getGeneration).Times(0);
+
+        std::vector<std::unique_ptr<Action>> actions{};
+        std::unique_ptr<MockAction> action = std::make_unique<MockAction>();
+        EXPECT_CALL(*action, execute).Times(2).WillRepeatedly(Return(true));
+        actions.push_back(std::move(action));
+
+        Rule rule("is_foobar_backplane_installed_rule", std::move(actions));
+        EXPECT_EQ(rule.execute(env), true);
+        EXPECT_EQ(rule.execute(env), true);
+    }
 }
 
 TEST(RuleTests, GetActions)
@@ -114,8 +234,26 @@ TEST(RuleTests, GetActions)
     EXPECT_EQ(rule.getActions()[1].get(), action2);
 }
 
+TEST(RuleTests, GetDefinitionHash)
+{
+    Rule rule("read_sensor_values", std::vector<std::unique_ptr<Action>>{});
+    EXPECT_EQ(rule.getDefinitionHash(), 0);
+    rule.setDefinitionHash(0x1234'5678'9abc'def0);
+    EXPECT_EQ(rule.getDefinitionHash(), 0x1234'5678'9abc'def0);
+}
+
 TEST(RuleTests, GetID)
 {
     Rule rule("read_sensor_values", std::vector<std::unique_ptr<Action>>{});
     EXPECT_EQ(rule.getID(), "read_sensor_values");
 }
+
+TEST(RuleTests, IsMemoizable)
+{
+    Rule rule("read_sensor_values", std::vector<std::unique_ptr<Action>>{});
+    EXPECT_FALSE(rule.isMemoizable());
+    rule.setMemoizable(true);
+    EXPECT_TRUE(rule.isMemoizable());
+    rule.setMemoizable(false);
+    EXPECT_FALSE(rule.isMemoizable());
+}
@@ -0,0 +1,166 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "sensor_aggregator.hpp"
+#include "sensors.hpp"
+
+#include <chrono>
+#include <optional>
+
+#include <gtest/gtest.h>
+
+using namespace phosphor::power::regulators;
+
+using std::chrono::milliseconds;
+
+TEST(SensorAggregatorTests, Constructor)
+{
+    SensorAggregation aggregation{milliseconds{1000}, SensorStatistic::mean};
+    SensorAggregator aggregator{aggregation};
+    EXPECT_EQ(aggregator.getAggregation(), aggregation);
+    EXPECT_EQ(aggregator.getCount(), 0);
+}
+
+TEST(SensorAggregatorTests, Add)
+{
+    SensorAggregator::Clock::time_point start{};
+
+    // Test where window has not elapsed
+    {
+        SensorAggregator aggregator{
+            SensorAggregation{milliseconds{1000}, SensorStatistic::mean}};
+        EXPECT_FALSE(aggregator.add(1.0, start).has_value());
+        EXPECT_FALSE(
+            aggregator.add(2.0, start + milliseconds{100}).has_value());
+        EXPECT_FALSE(
+            aggregator.add(3.0, start + milliseconds{999}).has_value());
+        EXPECT_EQ(aggregator.getCount(), 3);
+    }
+
+    // Test where window has elapsed: value is included in the window and a new
+    // window is started
+    {
+        SensorAggregator aggregator{
+            SensorAggregation{milliseconds{1000}, SensorStatistic::mean}};
+        EXPECT_FALSE(aggregator.add(1.0, start).has_value());
+        EXPECT_FALSE(
+            aggregator.add(2.0, start + milliseconds{500}).has_value());
+        std::optional<double> value =
+            aggregator.add(6.0, start + milliseconds{1000});
+        EXPECT_TRUE(value.has_value());
+        EXPECT_DOUBLE_EQ(value.value(), 3.0);
+        EXPECT_EQ(aggregator.getCount(), 0);
+
+        // Next window starts with the next value
+        EXPECT_FALSE(
+            aggregator.add(10.0, start + milliseconds{1500}).has_value());
+        EXPECT_FALSE(
+            aggregator.add(20.0, start + milliseconds{2000}).has_value());
+        value = aggregator.add(30.0, start + milliseconds{2500});
+        EXPECT_TRUE(value.has_value());
+        EXPECT_DOUBLE_EQ(value.value(), 20.0);
+    }
+
+    // Test where each statistic is returned
+    {
+        SensorAggregator aggregator{
+            SensorAggregation{milliseconds{100}, SensorStatistic::minimum}};
+        aggregator.add(1.2, start);
+        aggregator.add(0.9, start + milliseconds{50});
+        EXPECT_DOUBLE_EQ(aggregator.add(1.1, start + milliseconds{100}).value(),
+                         0.9);
+    }
+    {
+        SensorAggregator aggregator{
+            SensorAggregation{milliseconds{100}, SensorStatistic::maximum}};
+        aggregator.add(1.2, start);
+        aggregator.add(0.9, start + milliseconds{50});
+        EXPECT_DOUBLE_EQ(aggregator.add(1.1, start + milliseconds{100}).value(),
+                         1.2);
+    }
+    {
+        SensorAggregator aggregator{SensorAggregation{
+            milliseconds{100}, SensorStatistic::peak_to_peak}};
+        aggregator.add(1.2, start);
+        aggregator.add(0.9, start + milliseconds{50});
+        EXPECT_DOUBLE_EQ(aggregator.add(1.1, start + milliseconds{100}).value(),
+                         0.3);
+    }
+
+    // Test where window contains one value
+    {
+        SensorAggregator aggregator{SensorAggregation{
+            milliseconds{100}, SensorStatistic::peak_to_peak}};
+        aggregator.add(5.0, start);
+        EXPECT_DOUBLE_EQ(aggregator.add(5.0, start + milliseconds{200}).value(),
+                         0.0);
+    }
+}
+
+TEST(SensorAggregatorTests, GetAggregation)
+{
+    SensorAggregation aggregation{milliseconds{250},
+                                  SensorStatistic::peak_to_peak};
+    SensorAggregator aggregator{aggregation};
+    EXPECT_EQ(aggregator.getAggregation().window, milliseconds{250});
+    EXPECT_EQ(aggregator.getAggregation().statistic,
+              SensorStatistic::peak_to_peak);
+}
+
+TEST(SensorAggregatorTests, GetCount)
+{
+    SensorAggregator::Clock::time_point start{};
+    SensorAggregator aggregator{
+        SensorAggregation{milliseconds{1000}, SensorStatistic::mean}};
+    EXPECT_EQ(aggregator.getCount(), 0);
+    aggregator.add(1.0, start);
+    EXPECT_EQ(aggregator.getCount(), 1);
+    aggregator.add(1.0, start + milliseconds{10});
+    EXPECT_EQ(aggregator.getCount(), 2);
+}
+
+TEST(SensorAggregatorTests, GetStatistic)
+{
+    SensorAggregator::Clock::time_point start{};
+    SensorAggregator aggregator{
+        SensorAggregation{milliseconds{1000}, SensorStatistic::mean}};
+    aggregator.add(3.0, start);
+    aggregator.add(-1.0, start + milliseconds{100});
+    aggregator.add(4.0, start + milliseconds{200});
+    EXPECT_DOUBLE_EQ(aggregator.getStatistic(SensorStatistic::minimum), -1.0);
+    EXPECT_DOUBLE_EQ(aggregator.getStatistic(SensorStatistic::maximum), 4.0);
+    EXPECT_DOUBLE_EQ(aggregator.getStatistic(SensorStatistic::mean), 2.0);
+    EXPECT_DOUBLE_EQ(aggregator.getStatistic(SensorStatistic::peak_to_peak),
+                     5.0);
+}
+
+TEST(SensorAggregatorTests, Reset)
+{
+    SensorAggregator::Clock::time_point start{};
+    SensorAggregator aggregator{
+        SensorAggregation{milliseconds{1000}, SensorStatistic::maximum}};
+    aggregator.add(100.0, start);
+    aggregator.add(50.0, start + milliseconds{500});
+    aggregator.reset();
+    EXPECT_EQ(aggregator.getCount(), 0);
+
+    // Values before reset are discarded and a new window is started
+    EXPECT_FALSE(aggregator.add(2.0, start + milliseconds{900}).has_value());
+    EXPECT_FALSE(aggregator.add(1.0, start + milliseconds{1500}).has_value());
+    std::optional<double> value =
+        aggregator.add(3.0, start + milliseconds{1900});
+    EXPECT_TRUE(value.has_value());
+    EXPECT_DOUBLE_EQ(value.value(), 3.0);
+}
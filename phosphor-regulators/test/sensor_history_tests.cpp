@@ -0,0 +1,241 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "compressed_time_series.hpp"
+#include "sensor_history.hpp"
+#include "sensors.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace phosphor::power::regulators;
+
+using Point = CompressedTimeSeries::Point;
+
+namespace
+{
+
+/**
+ * Runs one monitoring cycle that sets the specified values of rail vdd1.
+ */
+void monitorRail(SensorHistory& history, double vout, double iout,
+                 bool errorOccurred = false)
+{
+    history.startCycle();
+    history.startRail("vdd1", "/xyz/openbmc_project/inventory/reg1",
+                      "/xyz/openbmc_project/inventory/chassis");
+    history.setValue(SensorType::vout, vout);
+    SensorAggregation aggregation{std::chrono::milliseconds{5000},
+                                  SensorStatistic::mean};
+    history.setAggregatedValue(SensorType::iout, iout, aggregation);
+    history.endRail(errorOccurred);
+    history.endCycle();
+}
+
+/**
+ * Returns the values in the specified points.
+ */
+std::vector<double> getValues(const std::vector<Point>& points)
+{
+    std::vector<double> values{};
+    for (const Point& point : points)
+    {
+        values.emplace_back(point.value);
+    }
+    return values;
+}
+
+} // namespace
+
+TEST(SensorHistoryTests, Constructor)
+{
+    // Test where works
+    {
+        SensorHistory history{};
+        EXPECT_TRUE(history.getSensorNames().empty());
+        EXPECT_EQ(history.getStorageSize(), 0);
+    }
+
+    // Test where fails: Invalid time series size
+    EXPECT_THROW((SensorHistory{16, 1}), std::invalid_argument);
+}
+
+TEST(SensorHistoryTests, Disable)
+{
+    SensorHistory history{};
+    monitorRail(history, 1.1, 12.0);
+    history.disable();
+
+    // A NaN value is stored after the last value
+    std::vector<Point> points = history.getValues("vdd1_vout");
+    ASSERT_EQ(points.size(), 2);
+    EXPECT_EQ(points[0].value, 1.1);
+    EXPECT_TRUE(std::isnan(points[1].value));
+    EXPECT_GE(points[1].timestamp, points[0].timestamp);
+
+    // Only one NaN value is stored for each gap
+    history.enable();
+    history.disable();
+    EXPECT_EQ(history.getValues("vdd1_iout").size(), 2);
+}
+
+TEST(SensorHistoryTests, DisableRail)
+{
+    SensorHistory history{};
+    monitorRail(history, 1.1, 12.0);
+
+    history.startCycle();
+    history.disableRail("vdd1");
+    history.disableRail("vdd2");
+    history.endCycle();
+
+    std::vector<Point> points = history.getValues("vdd1_vout");
+    ASSERT_EQ(points.size(), 2);
+    EXPECT_TRUE(std::isnan(points[1].value));
+}
+
+TEST(SensorHistoryTests, EndRail)
+{
+    SensorHistory history{};
+
+    // Test where no error occurred
+    monitorRail(history, 1.1, 12.0);
+    EXPECT_EQ(history.getValues("vdd1_vout").size(), 1);
+
+    // Test where error occurred: NaN value is stored
+    history.startCycle();
+    history.startRail("vdd1", "/xyz/openbmc_project/inventory/reg1",
+                      "/xyz/openbmc_project/inventory/chassis");
+    history.endRail(true);
+    history.endCycle();
+    std::vector<Point> points = history.getValues("vdd1_iout");
+    ASSERT_EQ(points.size(), 2);
+    EXPECT_TRUE(std::isnan(points[1].value));
+}
+
+TEST(SensorHistoryTests, GetFFDCLines)
+{
+    SensorHistory history{};
+    monitorRail(history, 1.25, 12.5);
+    monitorRail(history, 1.5, 13.0);
+
+    // Test where device has history
+    std::vector<std::string> lines =
+        history.getFFDCLines("/xyz/openbmc_project/inventory/reg1");
+    ASSERT_EQ(lines.size(), 4);
+    int64_t timestamp = history.getValues("vdd1_iout")[0].timestamp;
+    EXPECT_EQ(lines[0], "vdd1_iout " + std::to_string(timestamp) + " 12.5");
+    EXPECT_EQ(lines[1].substr(0, 10), "vdd1_iout ");
+    EXPECT_EQ(lines[2].substr(0, 10), "vdd1_vout ");
+    EXPECT_EQ(lines[3].substr(lines[3].size() - 4), " 1.5");
+
+    // Test where values are older than the window
+    EXPECT_TRUE(history
+                    .getFFDCLines("/xyz/openbmc_project/inventory/reg1",
+                                  std::chrono::milliseconds{-60000})
+                    .empty());
+
+    // Test where device has no history
+    EXPECT_TRUE(
+        history.getFFDCLines("/xyz/openbmc_project/inventory/reg2").empty());
+}
+
+TEST(SensorHistoryTests, GetSensorNames)
+{
+    SensorHistory history{};
+    monitorRail(history, 1.1, 12.0);
+
+    history.startCycle();
+    history.startRail("vdd_2", "/xyz/openbmc_project/inventory/reg2",
+                      "/xyz/openbmc_project/inventory/chassis");
+    history.setValue(SensorType::temperature, 45.0);
+    history.endRail(false);
+    history.endCycle();
+
+    std::vector<std::string> expected{"vdd1_iout", "vdd1_vout",
+                                      "vdd_2_temperature"};
+    EXPECT_EQ(history.getSensorNames(), expected);
+}
+
+TEST(SensorHistoryTests, GetStorageSize)
+{
+    SensorHistory history{};
+    monitorRail(history, 1.1, 12.0);
+    EXPECT_EQ(history.getStorageSize(), 2 * 16 * 64 * 8);
+
+    // Memory does not grow as values are stored
+    for (int i = 0; i < 1000; ++i)
+    {
+        monitorRail(history, 1.1 + i * 0.001, 12.0 + i * 0.01);
+    }
+    EXPECT_EQ(history.getStorageSize(), 2 * 16 * 64 * 8);
+}
+
+TEST(SensorHistoryTests, GetValues)
+{
+    SensorHistory history{};
+    monitorRail(history, 1.1, 12.0);
+    monitorRail(history, 1.2, 13.0);
+    monitorRail(history, 1.3, 14.0);
+
+    // Test where all values are returned
+    std::vector<Point> points = history.getValues("vdd1_vout");
+    EXPECT_EQ(getValues(points), (std::vector<double>{1.1, 1.2, 1.3}));
+    EXPECT_LE(points[0].timestamp, points[2].timestamp);
+
+    // Test where recent values are returned
+    EXPECT_EQ(getValues(history.getValues("vdd1_iout", points[2].timestamp))
+                  .back(),
+              14.0);
+    EXPECT_TRUE(
+        history.getValues("vdd1_iout", points[2].timestamp + 1).empty());
+
+    // Test where fails: Sensor has no history
+    EXPECT_THROW(history.getValues("vdd1_temperature"), std::invalid_argument);
+    EXPECT_THROW(history.getValues("vdd2_vout"), std::invalid_argument);
+    EXPECT_THROW(history.getValues("vdd1"), std::invalid_argument);
+}
+
+TEST(SensorHistoryTests, SetValue)
+{
+    SensorHistory history{};
+
+    // Test where no rail is started: Value is ignored
+    history.startCycle();
+    history.setValue(SensorType::vout, 1.1);
+    history.endCycle();
+    EXPECT_TRUE(history.getSensorNames().empty());
+
+    // Test where rail is started
+    monitorRail(history, 1.1, 12.0);
+    EXPECT_EQ(getValues(history.getValues("vdd1_vout")),
+              (std::vector<double>{1.1}));
+}
+
+TEST(SensorHistoryTests, SkipRail)
+{
+    SensorHistory history{};
+    monitorRail(history, 1.1, 12.0);
+
+    history.startCycle();
+    history.skipRail("vdd1");
+    history.endCycle();
+    EXPECT_EQ(history.getValues("vdd1_vout").size(), 1);
+}
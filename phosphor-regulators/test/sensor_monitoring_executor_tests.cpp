@@ -0,0 +1,409 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "action.hpp"
+#include "action_environment.hpp"
+#include "chassis.hpp"
+#include "configuration.hpp"
+#include "device.hpp"
+#include "mock_action.hpp"
+#include "mock_error_logging.hpp"
+#include "mock_journal.hpp"
+#include "mock_sensors.hpp"
+#include "mock_services.hpp"
+#include "mocked_i2c_interface.hpp"
+#include "phase_fault_detection.hpp"
+#include "presence_detection.hpp"
+#include "rail.hpp"
+#include "rule.hpp"
+#include "sensor_monitoring.hpp"
+#include "sensor_monitoring_executor.hpp"
+#include "sensors.hpp"
+#include "system.hpp"
+#include "test_utils.hpp"
+
+#include <stdlib.h> // for mkdtemp()
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+using namespace phosphor::power::regulators;
+using namespace phosphor::power::regulators::test_utils;
+
+namespace fs = std::filesystem;
+
+using ::testing::_;
+using ::testing::InSequence;
+using ::testing::InvokeWithoutArgs;
+using ::testing::Ref;
+using ::testing::Return;
+using ::testing::Throw;
+
+static const std::string chassisInvPath{
+    "/xyz/openbmc_project/inventory/system/chassis"};
+
+/**
+ * Creates a Device on the specified I2C bus with one rail.
+ *
+ * Monitoring the rail sleeps for the specified read time and then sets the
+ * iout sensor to the specified value.  If value is negative, an exception is
+ * thrown instead.
+ *
+ * @param id rail ID.  The device ID is the rail ID followed by "_reg".
+ * @param bus I2C bus of the device
+ * @param readTime time it takes to read the sensors of the rail
+ * @param value iout sensor value
+ * @param readThread if not null, set to the ID of the thread that last read
+ *                   the sensors of the rail
+ * @return Device object
+ */
+static std::unique_ptr<Device> createDevice(
+    const std::string& id, uint8_t bus, std::chrono::milliseconds readTime,
+    double value, std::thread::id* readThread = nullptr)
+{
+    // Create SensorMonitoring for Rail
+    auto action = std::make_unique<MockAction>();
+    EXPECT_CALL(*action, execute)
+        .WillRepeatedly([readTime, value,
+                         readThread](ActionEnvironment& environment) {
+            if (readThread != nullptr)
+            {
+                *readThread = std::this_thread::get_id();
+            }
+            std::this_thread::sleep_for(readTime);
+            if (value < 0)
+            {
+                throw std::runtime_error{"Unable to read iout"};
+            }
+            environment.getServices().getSensors().setValue(SensorType::iout,
+                                                            value);
+            return true;
+        });
+    std::vector<std::unique_ptr<Action>> actions{};
+    actions.emplace_back(std::move(action));
+    // Read the sensors in every monitoring cycle
+    auto sensorMonitoring = std::make_unique<SensorMonitoring>(
+        std::move(actions), std::chrono::milliseconds{0});
+
+    // Create Rail
+    std::unique_ptr<Configuration> configuration{};
+    auto rail = std::make_unique<Rail>(id, std::move(configuration),
+                                       std::move(sensorMonitoring));
+
+    // Create Device
+    auto i2cInterface = std::make_unique<i2c::MockedI2CInterface>();
+    EXPECT_CALL(*i2cInterface, getBus).WillRepeatedly(Return(bus));
+    std::unique_ptr<PresenceDetection> presenceDetection{};
+    std::unique_ptr<Configuration> deviceConfiguration{};
+    std::unique_ptr<PhaseFaultDetection> phaseFaultDetection{};
+    std::vector<std::unique_ptr<Rail>> rails{};
+    rails.emplace_back(std::move(rail));
+    return std::make_unique<Device>(
+        id + "_reg", true,
+        "/xyz/openbmc_project/inventory/system/chassis/motherboard/" + id +
+            "_reg",
+        std::move(i2cInterface), std::move(presenceDetection),
+        std::move(deviceConfiguration), std::move(phaseFaultDetection),
+        std::move(rails));
+}
+
+TEST(SensorMonitoringExecutorTests, Constructor)
+{
+    // Test where system contains no devices
+    {
+        auto system = createSystem({});
+        SensorMonitoringExecutor executor{*system};
+        EXPECT_EQ(executor.getBusCount(), 0);
+    }
+
+    // Test where devices are on multiple buses
+    {
+        std::vector<std::unique_ptr<Device>> devices{};
+        devices.emplace_back(
+            createDevice("vdd0", 1, std::chrono::milliseconds{0}, 1.0));
+        devices.emplace_back(
+            createDevice("vdd1", 2, std::chrono::milliseconds{0}, 1.0));
+        devices.emplace_back(
+            createDevice("vdd2", 1, std::chrono::milliseconds{0}, 1.0));
+        auto system = createSystem(std::move(devices));
+        SensorMonitoringExecutor executor{*system};
+        EXPECT_EQ(executor.getBusCount(), 2);
+    }
+
+    // Test where only the devices in some chassis are monitored
+    {
+        std::vector<std::unique_ptr<Device>> devices{};
+        devices.emplace_back(
+            createDevice("vdd0", 1, std::chrono::milliseconds{0}, 1.0));
+        auto system = createSystem(std::move(devices));
+        std::vector<std::unique_ptr<Device>> devices2{};
+        devices2.emplace_back(
+            createDevice("vdd1", 2, std::chrono::milliseconds{0}, 1.0));
+        devices2.emplace_back(
+            createDevice("vdd2", 3, std::chrono::milliseconds{0}, 1.0));
+        std::vector<std::unique_ptr<Chassis>> chassis{};
+        chassis.emplace_back(std::make_unique<Chassis>(
+            2, chassisInvPath + "2", std::move(devices2)));
+        system->addChassis(std::move(chassis));
+
+        std::vector<Chassis*> monitoredChassis{system->getChassis()[1].get()};
+        SensorMonitoringExecutor executor{*system, monitoredChassis};
+        EXPECT_EQ(executor.getBusCount(), 2);
+
+        // Set Sensors service expectations.  Only the rails in chassis 2
+        // should be read.
+        MockServices services{};
+        MockSensors& sensors = services.getMockSensors();
+        EXPECT_CALL(sensors, startRail("vdd0", _, _)).Times(0);
+        EXPECT_CALL(sensors, startRail("vdd1", _, chassisInvPath + "2"))
+            .Times(1);
+        EXPECT_CALL(sensors, startRail("vdd2", _, chassisInvPath + "2"))
+            .Times(1);
+        EXPECT_CALL(sensors, setValue(SensorType::iout, 1.0)).Times(2);
+        EXPECT_CALL(sensors, endRail(false)).Times(2);
+
+        executor.execute(services);
+    }
+}
+
+TEST(SensorMonitoringExecutorTests, Execute)
+{
+    // Test where all devices are on one bus
+    {
+        std::vector<std::unique_ptr<Device>> devices{};
+        devices.emplace_back(
+            createDevice("vdd0", 3, std::chrono::milliseconds{0}, 1.5));
+        devices.emplace_back(
+            createDevice("vdd1", 3, std::chrono::milliseconds{0}, 2.5));
+        auto system = createSystem(std::move(devices));
+        SensorMonitoringExecutor executor{*system};
+
+        // Set Sensors service expectations.  Rails should be read in order.
+        MockServices services{};
+        MockSensors& sensors = services.getMockSensors();
+        {
+            InSequence seq;
+            EXPECT_CALL(sensors, startRail("vdd0", _, chassisInvPath));
+            EXPECT_CALL(sensors, setValue(SensorType::iout, 1.5));
+            EXPECT_CALL(sensors, endRail(false));
+            EXPECT_CALL(sensors, startRail("vdd1", _, chassisInvPath));
+            EXPECT_CALL(sensors, setValue(SensorType::iout, 2.5));
+            EXPECT_CALL(sensors, endRail(false));
+        }
+
+        executor.execute(services);
+    }
+
+    // Test where devices are on multiple buses.  Buses are read in parallel
+    // and sensor updates occur on the calling thread.
+    {
+        std::vector<std::unique_ptr<Device>> devices{};
+        for (uint8_t bus = 0; bus < 4; ++bus)
+        {
+            devices.emplace_back(
+                createDevice("vdd" + std::to_string(bus), bus,
+                             std::chrono::milliseconds{200}, bus + 1.0));
+        }
+        auto system = createSystem(std::move(devices));
+        SensorMonitoringExecutor executor{*system};
+        EXPECT_EQ(executor.getBusCount(), 4);
+
+        // Set Sensors service expectations
+        std::thread::id callingThread = std::this_thread::get_id();
+        MockServices services{};
+        MockSensors& sensors = services.getMockSensors();
+        auto checkThread = [callingThread]() {
+            EXPECT_EQ(std::this_thread::get_id(), callingThread);
+        };
+        EXPECT_CALL(sensors, startRail)
+            .Times(4)
+            .WillRepeatedly(InvokeWithoutArgs(checkThread));
+        EXPECT_CALL(sensors, setValue(SensorType::iout, _))
+            .Times(4)
+            .WillRepeatedly(InvokeWithoutArgs(checkThread));
+        EXPECT_CALL(sensors, endRail(false)).Times(4);
+
+        // Cycle should take about as long as the slowest bus
+        auto start = std::chrono::steady_clock::now();
+        executor.execute(services);
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        EXPECT_LT(elapsed, std::chrono::milliseconds{600});
+    }
+
+    // Test where an error occurs reading a device on one bus.  The error is
+    // logged on the calling thread.
+    {
+        std::vector<std::unique_ptr<Device>> devices{};
+        devices.emplace_back(
+            createDevice("vdd0", 1, std::chrono::milliseconds{0}, 1.0));
+        devices.emplace_back(
+            createDevice("vdd1", 2, std::chrono::milliseconds{0}, -1.0));
+        auto system = createSystem(std::move(devices));
+        SensorMonitoringExecutor executor{*system};
+
+        // Set Journal, ErrorLogging, and Sensors service expectations
+        std::thread::id callingThread = std::this_thread::get_id();
+        MockServices services{};
+        MockJournal& journal = services.getMockJournal();
+        std::vector<std::string> expectedErrMessages{"Unable to read iout"};
+        EXPECT_CALL(journal, logError(expectedErrMessages)).Times(1);
+        EXPECT_CALL(journal,
+                    logError("Unable to monitor sensors for rail vdd1"))
+            .Times(1);
+        MockErrorLogging& errorLogging = services.getMockErrorLogging();
+        EXPECT_CALL(errorLogging,
+                    logInternalError(Entry::Level::Warning, Ref(journal)))
+            .Times(1)
+            .WillOnce(InvokeWithoutArgs([callingThread]() {
+                EXPECT_EQ(std::this_thread::get_id(), callingThread);
+            }));
+        MockSensors& sensors = services.getMockSensors();
+        EXPECT_CALL(sensors, startRail).Times(2);
+        EXPECT_CALL(sensors, setValue(SensorType::iout, 1.0)).Times(1);
+        EXPECT_CALL(sensors, endRail(false)).Times(1);
+        EXPECT_CALL(sensors, endRail(true)).Times(1);
+
+        executor.execute(services);
+    }
+}
+
+TEST(SensorMonitoringExecutorTests, Cycles)
+{
+    // Test where the same worker threads read the buses in each cycle
+    {
+        std::thread::id readThreads[2]{};
+        std::vector<std::unique_ptr<Device>> devices{};
+        devices.emplace_back(createDevice(
+            "vdd0", 1, std::chrono::milliseconds{0}, 1.0, &readThreads[0]));
+        devices.emplace_back(createDevice(
+            "vdd1", 2, std::chrono::milliseconds{0}, 1.0, &readThreads[1]));
+        auto system = createSystem(std::move(devices));
+        SensorMonitoringExecutor executor{*system};
+
+        MockServices services{};
+        MockSensors& sensors = services.getMockSensors();
+        EXPECT_CALL(sensors, startRail).Times(6);
+        EXPECT_CALL(sensors, setValue(SensorType::iout, 1.0)).Times(6);
+        EXPECT_CALL(sensors, endRail(false)).Times(6);
+
+        executor.execute(services);
+        std::thread::id firstThreads[2]{readThreads[0], readThreads[1]};
+        EXPECT_NE(firstThreads[0], std::this_thread::get_id());
+        EXPECT_NE(firstThreads[1], std::this_thread::get_id());
+        EXPECT_NE(firstThreads[0], firstThreads[1]);
+        for (int i = 0; i < 2; ++i)
+        {
+            executor.execute(services);
+            EXPECT_EQ(readThreads[0], firstThreads[0]);
+            EXPECT_EQ(readThreads[1], firstThreads[1]);
+        }
+    }
+
+    // Test where replaying the service calls of one worker throws an
+    // exception.  The calls of the other workers are still replayed, and the
+    // next cycle works normally.
+    {
+        std::vector<std::unique_ptr<Device>> devices{};
+        devices.emplace_back(
+            createDevice("vdd0", 1, std::chrono::milliseconds{0}, 1.0));
+        devices.emplace_back(
+            createDevice("vdd1", 2, std::chrono::milliseconds{0}, 2.0));
+        auto system = createSystem(std::move(devices));
+        SensorMonitoringExecutor executor{*system};
+
+        MockServices services{};
+        MockSensors& sensors = services.getMockSensors();
+        EXPECT_CALL(sensors, startRail("vdd0", _, chassisInvPath))
+            .WillOnce(Throw(std::runtime_error{"D-Bus error"}))
+            .WillOnce(Return());
+        EXPECT_CALL(sensors, setValue(SensorType::iout, 1.0)).Times(1);
+        EXPECT_CALL(sensors, startRail("vdd1", _, chassisInvPath)).Times(2);
+        EXPECT_CALL(sensors, setValue(SensorType::iout, 2.0)).Times(2);
+        EXPECT_CALL(sensors, endRail(false)).Times(3);
+
+        EXPECT_THROW(executor.execute(services), std::runtime_error);
+        executor.execute(services);
+    }
+}
+
+TEST(SensorMonitoringExecutorTests, MuxChannels)
+{
+    // Create a fake sysfs where buses 10 and 11 are channels 0 and 1 of a mux
+    // at address 0x70 on bus 3
+    char dirTemplate[] = "/tmp/sensor_monitoring_executor_tests-XXXXXX";
+    fs::path root = mkdtemp(dirTemplate);
+    fs::create_directories(root / "3-0070");
+    for (int channel = 0; channel < 2; ++channel)
+    {
+        std::string adapter = "i2c-" + std::to_string(10 + channel);
+        std::string link = "channel-" + std::to_string(channel);
+        fs::create_directories(root / adapter);
+        fs::create_directory_symlink("../" + adapter, root / "3-0070" / link);
+        fs::create_directory_symlink("../3-0070",
+                                     root / adapter / "mux_device");
+    }
+
+    // Devices alternate between the mux channels in the configuration file
+    std::vector<std::unique_ptr<Device>> devices{};
+    devices.emplace_back(
+        createDevice("vdd0", 11, std::chrono::milliseconds{0}, 1.0));
+    devices.emplace_back(
+        createDevice("vdd1", 10, std::chrono::milliseconds{0}, 1.0));
+    devices.emplace_back(
+        createDevice("vdd2", 3, std::chrono::milliseconds{0}, 1.0));
+    devices.emplace_back(
+        createDevice("vdd3", 11, std::chrono::milliseconds{0}, 1.0));
+    devices.emplace_back(
+        createDevice("vdd4", 10, std::chrono::milliseconds{0}, 1.0));
+    auto system = createSystem(std::move(devices));
+
+    // All the devices are on the same physical bus.  Each channel is only
+    // selected once.
+    SensorMonitoringExecutor executor{*system, root};
+    EXPECT_EQ(executor.getBusCount(), 1);
+    EXPECT_EQ(executor.getChannelSwitchCount(), 2);
+
+    // Devices not behind the mux are read first, then the devices on each
+    // channel in configuration file order
+    MockServices services{};
+    MockSensors& sensors = services.getMockSensors();
+    {
+        InSequence seq;
+        for (const char* rail : {"vdd2", "vdd1", "vdd4", "vdd0", "vdd3"})
+        {
+            EXPECT_CALL(sensors, startRail(rail, _, chassisInvPath));
+            EXPECT_CALL(sensors, setValue(SensorType::iout, 1.0));
+            EXPECT_CALL(sensors, endRail(false));
+        }
+    }
+    executor.execute(services);
+
+    // Without the mux topology, each bus is read separately
+    SensorMonitoringExecutor noMuxExecutor{*system, root / "missing"};
+    EXPECT_EQ(noMuxExecutor.getBusCount(), 3);
+    EXPECT_EQ(noMuxExecutor.getChannelSwitchCount(), 0);
+
+    fs::remove_all(root);
+}
@@ -14,9 +14,13 @@
  * limitations under the License.
  */
 #include "action.hpp"
+#include "action_environment.hpp"
+#include "bus_budget.hpp"
 #include "chassis.hpp"
 #include "configuration.hpp"
 #include "device.hpp"
+#include "enable_detection.hpp"
+#include "i2c_compare_bit_action.hpp"
 #include "i2c_interface.hpp"
 #include "mock_action.hpp"
 #include "mock_error_logging.hpp"
@@ -34,10 +38,12 @@
 #include "sensors.hpp"
 #include "system.hpp"
 
+#include <chrono>
 #include <cstdint>
 #include <memory>
 #include <optional>
 #include <string>
+#include <thread>
 #include <tuple>
 #include <utility>
 #include <vector>
@@ -119,11 +125,40 @@ std::tuple<std::unique_ptr<System>, Chassis*, Device*, i2c::MockedI2CInterface*,
 
 TEST(SensorMonitoringTests, Constructor)
 {
-    std::vector<std::unique_ptr<Action>> actions{};
-    actions.push_back(std::make_unique<MockAction>());
+    // Test where only required parameters are specified
+    {
+        std::vector<std::unique_ptr<Action>> actions{};
+        actions.push_back(std::make_unique<MockAction>());
+
+        SensorMonitoring sensorMonitoring(std::move(actions));
+        EXPECT_EQ(sensorMonitoring.getActions().size(), 1);
+        EXPECT_EQ(sensorMonitoring.getInterval(),
+                  SensorMonitoring::defaultInterval);
+        EXPECT_EQ(sensorMonitoring.getCurrentInterval(),
+                  SensorMonitoring::defaultInterval);
+        EXPECT_FALSE(sensorMonitoring.getAdaptiveInterval().has_value());
+        EXPECT_TRUE(sensorMonitoring.getSamplingGroups().empty());
+        EXPECT_EQ(sensorMonitoring.getEnableDetection(), nullptr);
+        EXPECT_FALSE(sensorMonitoring.isRailDisabled());
+    }
 
-    SensorMonitoring sensorMonitoring(std::move(actions));
-    EXPECT_EQ(sensorMonitoring.getActions().size(), 1);
+    // Test where all parameters are specified
+    {
+        std::vector<std::unique_ptr<Action>> actions{};
+        actions.push_back(std::make_unique<MockAction>());
+
+        SensorMonitoring sensorMonitoring(
+            std::move(actions), std::chrono::milliseconds{4000},
+            AdaptiveInterval{std::chrono::milliseconds{200}, 2.0});
+        EXPECT_EQ(sensorMonitoring.getActions().size(), 1);
+        EXPECT_EQ(sensorMonitoring.getInterval(),
+                  std::chrono::milliseconds{4000});
+        EXPECT_EQ(sensorMonitoring.getCurrentInterval(),
+                  std::chrono::milliseconds{4000});
+        EXPECT_EQ(sensorMonitoring.getAdaptiveInterval()->minInterval,
+                  std::chrono::milliseconds{200});
+        EXPECT_EQ(sensorMonitoring.getAdaptiveInterval()->changePercent, 2.0);
+    }
 }
 
 TEST(SensorMonitoringTests, ClearErrorHistory)
@@ -256,7 +291,9 @@ TEST(SensorMonitoringTests, Execute)
         EXPECT_CALL(sensors, endRail(false)).Times(1);
 
         // Execute SensorMonitoring
-        monitoring->execute(services, *system, *chassis, *device, *rail);
+        EXPECT_EQ(
+            monitoring->execute(services, *system, *chassis, *device, *rail),
+            SensorMonitoring::Result::read);
     }
 
     // Test where fails
@@ -322,12 +359,390 @@ TEST(SensorMonitoringTests, Execute)
                                 "/dev/i2c-1", 0x70, 0))
             .Times(1);
 
-        // Execute SensorMonitoring 4 times
+        // Execute SensorMonitoring 4 times.  Should report the I2C error.
         for (int i = 1; i <= 4; ++i)
         {
-            monitoring->execute(services, *system, *chassis, *device, *rail);
+            EXPECT_EQ(monitoring->execute(services, *system, *chassis, *device,
+                                          *rail),
+                      SensorMonitoring::Result::i2cFailed);
         }
     }
+
+    // Test where existing ActionEnvironment is reused
+    {
+        // Create PMBusReadSensorAction
+        SensorType type{SensorType::iout};
+        uint8_t command{0x8C};
+        SensorDataFormat format{SensorDataFormat::linear_11};
+        std::optional<int8_t> exponent{};
+        std::unique_ptr<PMBusReadSensorAction> action =
+            std::make_unique<PMBusReadSensorAction>(type, command, format,
+                                                    exponent);
+
+        // Create SensorMonitoring
+        std::vector<std::unique_ptr<Action>> actions{};
+        actions.emplace_back(std::move(action));
+        SensorMonitoring* monitoring = new SensorMonitoring(std::move(actions));
+
+        // Create parent objects that contain SensorMonitoring
+        auto [system, chassis, device, i2cInterface, rail] =
+            createParentObjects(std::unique_ptr<SensorMonitoring>{monitoring});
+
+        // Set I2CInterface expectations
+        EXPECT_CALL(*i2cInterface, isOpen).Times(1).WillOnce(Return(true));
+        EXPECT_CALL(*i2cInterface, read(TypedEq<uint8_t>(0x8C), A<uint16_t&>()))
+            .Times(1)
+            .WillOnce(SetArgReferee<1>(0xD2E0));
+
+        // Create mock services.  Set Sensors service expectations.
+        MockServices services{};
+        MockSensors& sensors = services.getMockSensors();
+        EXPECT_CALL(sensors, startRail).Times(1);
+        EXPECT_CALL(sensors, setValue(SensorType::iout, 11.5)).Times(1);
+        EXPECT_CALL(sensors, endRail(false)).Times(1);
+
+        // Create ActionEnvironment containing data from a previous rail
+        ActionEnvironment environment{system->getIDMap(), "vdd_regulator",
+                                      services};
+        environment.addSensorValue(SensorType::vout, 1.3);
+        environment.setVolts(1.3);
+
+        // Execute SensorMonitoring.  Environment should be reset first.
+        monitoring->execute(services, *system, *chassis, *device, *rail,
+                            environment);
+        EXPECT_EQ(environment.getDeviceID(), "vdd_reg");
+        EXPECT_EQ(environment.getSensorValues().size(), 1);
+        EXPECT_EQ(environment.getSensorValues().at(SensorType::iout), 11.5);
+        EXPECT_EQ(environment.getVolts().has_value(), false);
+    }
+}
+
+TEST(SensorMonitoringTests, ExecuteEnableDetection)
+{
+    // Test where rail is disabled and then enabled
+    {
+        // Create EnableDetection that finds the rail disabled twice
+        std::unique_ptr<MockAction> detectionAction =
+            std::make_unique<MockAction>();
+        EXPECT_CALL(*detectionAction, execute)
+            .Times(3)
+            .WillOnce(Return(false))
+            .WillOnce(Return(false))
+            .WillOnce(Return(true));
+        std::vector<std::unique_ptr<Action>> detectionActions{};
+        detectionActions.emplace_back(std::move(detectionAction));
+        std::unique_ptr<EnableDetection> enableDetection =
+            std::make_unique<EnableDetection>(std::move(detectionActions));
+
+        // Create SensorMonitoring.  Sensors are only read once.
+        std::unique_ptr<MockAction> action = std::make_unique<MockAction>();
+        EXPECT_CALL(*action, execute).Times(1).WillOnce(Return(true));
+        std::vector<std::unique_ptr<Action>> actions{};
+        actions.emplace_back(std::move(action));
+        SensorMonitoring* monitoring = new SensorMonitoring(
+            std::move(actions), SensorMonitoring::defaultInterval,
+            std::nullopt, std::vector<SamplingGroup>{},
+            std::move(enableDetection));
+
+        // Create parent objects that contain SensorMonitoring
+        auto [system, chassis, device, i2cInterface, rail] =
+            createParentObjects(std::unique_ptr<SensorMonitoring>{monitoring});
+
+        // Create mock services.  Set Sensors service expectations.  The rail
+        // sensors are disabled once and then skipped.
+        MockServices services{};
+        MockSensors& sensors = services.getMockSensors();
+        EXPECT_CALL(sensors, disableRail("vdd")).Times(1);
+        EXPECT_CALL(sensors, skipRail("vdd")).Times(1);
+        EXPECT_CALL(sensors, startRail).Times(1);
+        EXPECT_CALL(sensors, endRail(false)).Times(1);
+
+        // Rail is disabled
+        monitoring->execute(services, *system, *chassis, *device, *rail);
+        EXPECT_TRUE(monitoring->isRailDisabled());
+
+        // Rail is still disabled
+        monitoring->requestRead();
+        monitoring->execute(services, *system, *chassis, *device, *rail);
+        EXPECT_TRUE(monitoring->isRailDisabled());
+
+        // Rail is enabled.  Sensors are read.
+        monitoring->requestRead();
+        monitoring->execute(services, *system, *chassis, *device, *rail);
+        EXPECT_FALSE(monitoring->isRailDisabled());
+        EXPECT_EQ(monitoring->getReadStatistics().count, 1);
+    }
+
+    // Test where enable detection fails.  Rail is assumed to be enabled.
+    {
+        // Create EnableDetection that tests the On bit of OPERATION
+        std::vector<std::unique_ptr<Action>> detectionActions{};
+        detectionActions.emplace_back(
+            std::make_unique<I2CCompareBitAction>(0x01, 7, 1));
+        std::unique_ptr<EnableDetection> enableDetection =
+            std::make_unique<EnableDetection>(std::move(detectionActions));
+
+        // Create SensorMonitoring that reads output current
+        std::vector<std::unique_ptr<Action>> actions{};
+        actions.emplace_back(std::make_unique<PMBusReadSensorAction>(
+            SensorType::iout, 0x8C, SensorDataFormat::linear_11,
+            std::optional<int8_t>{}));
+        SensorMonitoring* monitoring = new SensorMonitoring(
+            std::move(actions), SensorMonitoring::defaultInterval,
+            std::nullopt, std::vector<SamplingGroup>{},
+            std::move(enableDetection));
+
+        // Create parent objects that contain SensorMonitoring
+        auto [system, chassis, device, i2cInterface, rail] =
+            createParentObjects(std::unique_ptr<SensorMonitoring>{monitoring});
+
+        // Set I2CInterface expectations.  Reading OPERATION fails.
+        EXPECT_CALL(*i2cInterface, isOpen).WillRepeatedly(Return(true));
+        EXPECT_CALL(*i2cInterface, read(TypedEq<uint8_t>(0x01), A<uint8_t&>()))
+            .Times(1)
+            .WillOnce(Throw(i2c::I2CException{"Failed to read byte data",
+                                              "/dev/i2c-1", 0x70}));
+        EXPECT_CALL(*i2cInterface,
+                    read(TypedEq<uint8_t>(0x8C), A<uint16_t&>()))
+            .Times(1)
+            .WillOnce(SetArgReferee<1>(0xD2E0));
+
+        // Create mock services.  Set Sensors service expectations.
+        MockServices services{};
+        MockSensors& sensors = services.getMockSensors();
+        EXPECT_CALL(sensors, disableRail).Times(0);
+        EXPECT_CALL(sensors, startRail).Times(1);
+        EXPECT_CALL(sensors, setValue(SensorType::iout, 11.5)).Times(1);
+        EXPECT_CALL(sensors, endRail(false)).Times(1);
+
+        // Set Journal and ErrorLogging service expectations
+        MockJournal& journal = services.getMockJournal();
+        EXPECT_CALL(journal, logError(A<const std::vector<std::string>&>()))
+            .Times(1);
+        EXPECT_CALL(journal, logError(A<const std::string&>())).Times(1);
+        MockErrorLogging& errorLogging = services.getMockErrorLogging();
+        EXPECT_CALL(errorLogging, logI2CError).Times(1);
+
+        monitoring->execute(services, *system, *chassis, *device, *rail);
+        EXPECT_FALSE(monitoring->isRailDisabled());
+    }
+}
+
+TEST(SensorMonitoringTests, ExecuteInterval)
+{
+    // Test where sensors are skipped until the interval has elapsed
+    {
+        // Create PMBusReadSensorAction
+        std::unique_ptr<PMBusReadSensorAction> action =
+            std::make_unique<PMBusReadSensorAction>(
+                SensorType::iout, 0x8C, SensorDataFormat::linear_11,
+                std::optional<int8_t>{});
+
+        // Create SensorMonitoring with a 200ms interval
+        std::vector<std::unique_ptr<Action>> actions{};
+        actions.emplace_back(std::move(action));
+        SensorMonitoring* monitoring = new SensorMonitoring(
+            std::move(actions), std::chrono::milliseconds{200});
+
+        // Create parent objects that contain SensorMonitoring
+        auto [system, chassis, device, i2cInterface, rail] =
+            createParentObjects(std::unique_ptr<SensorMonitoring>{monitoring});
+
+        // Set I2CInterface expectations.  Should read register 0x8C 2 times.
+        EXPECT_CALL(*i2cInterface, isOpen)
+            .Times(2)
+            .WillRepeatedly(Return(true));
+        EXPECT_CALL(*i2cInterface, read(TypedEq<uint8_t>(0x8C), A<uint16_t&>()))
+            .Times(2)
+            .WillRepeatedly(SetArgReferee<1>(0xD2E0));
+
+        // Create mock services.  Set Sensors service expectations.  Rail
+        // should be read, skipped, and then read again.
+        MockServices services{};
+        MockSensors& sensors = services.getMockSensors();
+        EXPECT_CALL(sensors, startRail).Times(2);
+        EXPECT_CALL(sensors, setValue(SensorType::iout, 11.5)).Times(2);
+        EXPECT_CALL(sensors, endRail(false)).Times(2);
+        EXPECT_CALL(sensors, skipRail("vdd")).Times(1);
+
+        // Execute SensorMonitoring 2 times.  Second time should be skipped.
+        EXPECT_EQ(
+            monitoring->execute(services, *system, *chassis, *device, *rail),
+            SensorMonitoring::Result::read);
+        EXPECT_EQ(
+            monitoring->execute(services, *system, *chassis, *device, *rail),
+            SensorMonitoring::Result::skipped);
+
+        // Wait for interval to elapse and execute again
+        std::this_thread::sleep_for(std::chrono::milliseconds{200});
+        EXPECT_EQ(
+            monitoring->execute(services, *system, *chassis, *device, *rail),
+            SensorMonitoring::Result::read);
+    }
+
+    // Test where interval adapts to changing sensor values
+    {
+        // Create PMBusReadSensorAction
+        std::unique_ptr<PMBusReadSensorAction> action =
+            std::make_unique<PMBusReadSensorAction>(
+                SensorType::iout, 0x8C, SensorDataFormat::linear_11,
+                std::optional<int8_t>{});
+
+        // Create SensorMonitoring with a 400ms interval that drops to 100ms
+        // when values change by more than 1%
+        std::vector<std::unique_ptr<Action>> actions{};
+        actions.emplace_back(std::move(action));
+        SensorMonitoring* monitoring = new SensorMonitoring(
+            std::move(actions), std::chrono::milliseconds{400},
+            AdaptiveInterval{std::chrono::milliseconds{100}, 1.0});
+
+        // Create parent objects that contain SensorMonitoring
+        auto [system, chassis, device, i2cInterface, rail] =
+            createParentObjects(std::unique_ptr<SensorMonitoring>{monitoring});
+
+        // Set I2CInterface expectations.  Value is 11.5, 11.5, 12.0, 12.0.
+        EXPECT_CALL(*i2cInterface, isOpen).WillRepeatedly(Return(true));
+        EXPECT_CALL(*i2cInterface, read(TypedEq<uint8_t>(0x8C), A<uint16_t&>()))
+            .Times(4)
+            .WillOnce(SetArgReferee<1>(0xD2E0))
+            .WillOnce(SetArgReferee<1>(0xD2E0))
+            .WillOnce(SetArgReferee<1>(0xD300))
+            .WillOnce(SetArgReferee<1>(0xD300));
+
+        MockServices services{};
+        MockSensors& sensors = services.getMockSensors();
+        EXPECT_CALL(sensors, startRail).Times(4);
+        EXPECT_CALL(sensors, setValue).Times(4);
+        EXPECT_CALL(sensors, endRail(false)).Times(4);
+
+        // First read has no previous values, so values are changing
+        monitoring->execute(services, *system, *chassis, *device, *rail);
+        EXPECT_EQ(monitoring->getCurrentInterval(),
+                  std::chrono::milliseconds{100});
+
+        // Value is the same; interval backs off
+        std::this_thread::sleep_for(std::chrono::milliseconds{100});
+        monitoring->execute(services, *system, *chassis, *device, *rail);
+        EXPECT_EQ(monitoring->getCurrentInterval(),
+                  std::chrono::milliseconds{200});
+
+        // Value changed by more than 1%; interval drops to minimum
+        std::this_thread::sleep_for(std::chrono::milliseconds{200});
+        monitoring->execute(services, *system, *chassis, *device, *rail);
+        EXPECT_EQ(monitoring->getCurrentInterval(),
+                  std::chrono::milliseconds{100});
+
+        // Value is the same; interval backs off
+        std::this_thread::sleep_for(std::chrono::milliseconds{100});
+        monitoring->execute(services, *system, *chassis, *device, *rail);
+        EXPECT_EQ(monitoring->getCurrentInterval(),
+                  std::chrono::milliseconds{200});
+    }
+}
+
+TEST(SensorMonitoringTests, ExecuteOverBudget)
+{
+    // Create PMBusReadSensorAction
+    std::unique_ptr<PMBusReadSensorAction> action =
+        std::make_unique<PMBusReadSensorAction>(
+            SensorType::iout, 0x8C, SensorDataFormat::linear_11,
+            std::optional<int8_t>{});
+
+    // Create SensorMonitoring
+    std::vector<std::unique_ptr<Action>> actions{};
+    actions.emplace_back(std::move(action));
+    SensorMonitoring* monitoring = new SensorMonitoring(std::move(actions));
+
+    // Create parent objects that contain SensorMonitoring
+    auto [system, chassis, device, i2cInterface, rail] =
+        createParentObjects(std::unique_ptr<SensorMonitoring>{monitoring});
+
+    // Set I2CInterface expectations.  Device is on bus 5.  Should read
+    // register 0x8C 1 time.
+    EXPECT_CALL(*i2cInterface, getBus).WillRepeatedly(Return(5));
+    EXPECT_CALL(*i2cInterface, isOpen).WillRepeatedly(Return(true));
+    EXPECT_CALL(*i2cInterface, read(TypedEq<uint8_t>(0x8C), A<uint16_t&>()))
+        .Times(1)
+        .WillOnce(SetArgReferee<1>(0xD2E0));
+
+    // Create mock services.  Set Sensors service expectations.  Rail should
+    // be skipped, and then read.
+    MockServices services{};
+    MockSensors& sensors = services.getMockSensors();
+    EXPECT_CALL(sensors, skipRail("vdd")).Times(1);
+    EXPECT_CALL(sensors, startRail).Times(1);
+    EXPECT_CALL(sensors, setValue(SensorType::iout, 11.5)).Times(1);
+    EXPECT_CALL(sensors, endRail(false)).Times(1);
+
+    // Use up the budget of bus 5 with transactions by other devices.  Read
+    // should be deferred.
+    i2c::setBusBudget(5, i2c::BusBudget{0.001, 1.0});
+    i2c::consumeBusBudget(5, 2.0);
+    monitoring->execute(services, *system, *chassis, *device, *rail);
+    EXPECT_EQ(monitoring->getReadStatistics().count, 0);
+    EXPECT_EQ(monitoring->getReadStatistics().deferredCount, 1);
+
+    // Remove the budget.  Read should occur.
+    i2c::clearBusBudgets();
+    monitoring->execute(services, *system, *chassis, *device, *rail);
+    EXPECT_EQ(monitoring->getReadStatistics().count, 1);
+    EXPECT_EQ(monitoring->getReadStatistics().deferredCount, 1);
+}
+
+TEST(SensorMonitoringTests, ExecuteSamplingGroups)
+{
+    // Create SensorMonitoring with a 10ms interval.  Output current is read
+    // every time.  Temperature is read every third time.
+    std::vector<std::unique_ptr<Action>> actions{};
+    actions.emplace_back(std::make_unique<PMBusReadSensorAction>(
+        SensorType::iout, 0x8C, SensorDataFormat::linear_11,
+        std::optional<int8_t>{}));
+    std::vector<std::unique_ptr<Action>> groupActions{};
+    groupActions.emplace_back(std::make_unique<PMBusReadSensorAction>(
+        SensorType::temperature, 0x8D, SensorDataFormat::linear_11,
+        std::optional<int8_t>{}));
+    std::vector<SamplingGroup> samplingGroups{};
+    samplingGroups.emplace_back(SamplingGroup{3, std::move(groupActions)});
+    SensorMonitoring* monitoring = new SensorMonitoring(
+        std::move(actions), std::chrono::milliseconds{10}, std::nullopt,
+        std::move(samplingGroups));
+
+    // Create parent objects that contain SensorMonitoring
+    auto [system, chassis, device, i2cInterface, rail] =
+        createParentObjects(std::unique_ptr<SensorMonitoring>{monitoring});
+
+    // Set I2CInterface expectations.  Should read register 0x8C 5 times and
+    // register 0x8D 3 times.
+    EXPECT_CALL(*i2cInterface, isOpen).WillRepeatedly(Return(true));
+    EXPECT_CALL(*i2cInterface, read(TypedEq<uint8_t>(0x8C), A<uint16_t&>()))
+        .Times(5)
+        .WillRepeatedly(SetArgReferee<1>(0xD2E0));
+    EXPECT_CALL(*i2cInterface, read(TypedEq<uint8_t>(0x8D), A<uint16_t&>()))
+        .Times(3)
+        .WillRepeatedly(SetArgReferee<1>(0xD2E0));
+
+    // Create mock services.  Set Sensors service expectations.  The rail is
+    // marked as skipped when the temperature is not read, so the temperature
+    // sensor is kept.
+    MockServices services{};
+    MockSensors& sensors = services.getMockSensors();
+    EXPECT_CALL(sensors, startRail).Times(5);
+    EXPECT_CALL(sensors, setValue(SensorType::iout, 11.5)).Times(5);
+    EXPECT_CALL(sensors, setValue(SensorType::temperature, 11.5)).Times(3);
+    EXPECT_CALL(sensors, endRail(false)).Times(5);
+    EXPECT_CALL(sensors, skipRail("vdd")).Times(2);
+
+    // Read 4 times.  Temperature is read the first and fourth time.
+    for (int i = 0; i < 4; ++i)
+    {
+        monitoring->execute(services, *system, *chassis, *device, *rail);
+        std::this_thread::sleep_for(std::chrono::milliseconds{10});
+    }
+
+    // Request a read.  Temperature is read even though it is not due.
+    monitoring->requestRead();
+    monitoring->execute(services, *system, *chassis, *device, *rail);
+    EXPECT_EQ(monitoring->getReadStatistics().count, 5);
 }
 
 TEST(SensorMonitoringTests, GetActions)
@@ -345,3 +760,217 @@ TEST(SensorMonitoringTests, GetActions)
     EXPECT_EQ(sensorMonitoring.getActions()[0].get(), action1);
     EXPECT_EQ(sensorMonitoring.getActions()[1].get(), action2);
 }
+
+TEST(SensorMonitoringTests, GetAdaptiveInterval)
+{
+    std::vector<std::unique_ptr<Action>> actions{};
+    SensorMonitoring sensorMonitoring(
+        std::move(actions), std::chrono::milliseconds{1000},
+        AdaptiveInterval{std::chrono::milliseconds{250}, 5.0});
+    EXPECT_EQ(sensorMonitoring.getAdaptiveInterval()->minInterval,
+              std::chrono::milliseconds{250});
+    EXPECT_EQ(sensorMonitoring.getAdaptiveInterval()->changePercent, 5.0);
+}
+
+TEST(SensorMonitoringTests, GetCurrentInterval)
+{
+    std::vector<std::unique_ptr<Action>> actions{};
+    SensorMonitoring sensorMonitoring(std::move(actions),
+                                      std::chrono::milliseconds{3000});
+    EXPECT_EQ(sensorMonitoring.getCurrentInterval(),
+              std::chrono::milliseconds{3000});
+}
+
+TEST(SensorMonitoringTests, GetEnableDetection)
+{
+    std::vector<std::unique_ptr<Action>> detectionActions{};
+    detectionActions.emplace_back(std::make_unique<MockAction>());
+    EnableDetection* enableDetection =
+        new EnableDetection{std::move(detectionActions)};
+
+    std::vector<std::unique_ptr<Action>> actions{};
+    actions.emplace_back(std::make_unique<MockAction>());
+    SensorMonitoring sensorMonitoring(
+        std::move(actions), SensorMonitoring::defaultInterval, std::nullopt,
+        std::vector<SamplingGroup>{},
+        std::unique_ptr<EnableDetection>{enableDetection});
+    EXPECT_EQ(sensorMonitoring.getEnableDetection().get(), enableDetection);
+}
+
+TEST(SensorMonitoringTests, GetInterval)
+{
+    std::vector<std::unique_ptr<Action>> actions{};
+    SensorMonitoring sensorMonitoring(std::move(actions),
+                                      std::chrono::milliseconds{2000});
+    EXPECT_EQ(sensorMonitoring.getInterval(), std::chrono::milliseconds{2000});
+}
+
+TEST(SensorMonitoringTests, GetMinInterval)
+{
+    // Test where adaptive interval is not specified
+    {
+        std::vector<std::unique_ptr<Action>> actions{};
+        SensorMonitoring sensorMonitoring(std::move(actions),
+                                          std::chrono::milliseconds{2000});
+        EXPECT_EQ(sensorMonitoring.getMinInterval(),
+                  std::chrono::milliseconds{2000});
+    }
+
+    // Test where adaptive interval is specified
+    {
+        std::vector<std::unique_ptr<Action>> actions{};
+        SensorMonitoring sensorMonitoring(
+            std::move(actions), std::chrono::milliseconds{2000},
+            AdaptiveInterval{std::chrono::milliseconds{500}, 1.0});
+        EXPECT_EQ(sensorMonitoring.getMinInterval(),
+                  std::chrono::milliseconds{500});
+    }
+}
+
+TEST(SensorMonitoringTests, GetReadStatistics)
+{
+    // Create PMBusReadSensorAction
+    std::unique_ptr<PMBusReadSensorAction> action =
+        std::make_unique<PMBusReadSensorAction>(
+            SensorType::iout, 0x8C, SensorDataFormat::linear_11,
+            std::optional<int8_t>{});
+
+    // Create SensorMonitoring with a 1000ms interval
+    std::vector<std::unique_ptr<Action>> actions{};
+    actions.emplace_back(std::move(action));
+    SensorMonitoring* monitoring = new SensorMonitoring(std::move(actions));
+
+    // No reads yet
+    EXPECT_EQ(monitoring->getReadStatistics().count, 0);
+    EXPECT_EQ(monitoring->getReadStatistics().total.count(), 0);
+    EXPECT_EQ(monitoring->getReadStatistics().deferredCount, 0);
+
+    // Create parent objects that contain SensorMonitoring
+    auto [system, chassis, device, i2cInterface, rail] =
+        createParentObjects(std::unique_ptr<SensorMonitoring>{monitoring});
+
+    // Set I2CInterface expectations.  Should read register 0x8C 1 time.
+    EXPECT_CALL(*i2cInterface, isOpen).WillRepeatedly(Return(true));
+    EXPECT_CALL(*i2cInterface, read(TypedEq<uint8_t>(0x8C), A<uint16_t&>()))
+        .Times(1)
+        .WillOnce(SetArgReferee<1>(0xD2E0));
+
+    MockServices services{};
+    MockSensors& sensors = services.getMockSensors();
+    EXPECT_CALL(sensors, startRail).Times(1);
+    EXPECT_CALL(sensors, setValue).Times(1);
+    EXPECT_CALL(sensors, endRail(false)).Times(1);
+    EXPECT_CALL(sensors, skipRail("vdd")).Times(1);
+
+    // Read, then skip.  Skipped reads are not counted.
+    monitoring->execute(services, *system, *chassis, *device, *rail);
+    monitoring->execute(services, *system, *chassis, *device, *rail);
+    const SensorReadStatistics& stats = monitoring->getReadStatistics();
+    EXPECT_EQ(stats.count, 1);
+    EXPECT_EQ(stats.total, stats.last);
+    EXPECT_EQ(stats.max, stats.last);
+
+    // The first read is not scheduled, so its jitter is not measured
+    EXPECT_EQ(stats.jitterCount, 0);
+}
+
+TEST(SensorMonitoringTests, GetReadStatisticsJitter)
+{
+    // Create PMBusReadSensorAction
+    std::unique_ptr<PMBusReadSensorAction> action =
+        std::make_unique<PMBusReadSensorAction>(
+            SensorType::iout, 0x8C, SensorDataFormat::linear_11,
+            std::optional<int8_t>{});
+
+    // Create SensorMonitoring with a 100ms interval
+    std::vector<std::unique_ptr<Action>> actions{};
+    actions.emplace_back(std::move(action));
+    SensorMonitoring* monitoring = new SensorMonitoring(
+        std::move(actions), std::chrono::milliseconds{100});
+
+    // Create parent objects that contain SensorMonitoring
+    auto [system, chassis, device, i2cInterface, rail] =
+        createParentObjects(std::unique_ptr<SensorMonitoring>{monitoring});
+
+    // Set I2CInterface expectations.  Should read register 0x8C 3 times.
+    EXPECT_CALL(*i2cInterface, isOpen).WillRepeatedly(Return(true));
+    EXPECT_CALL(*i2cInterface, read(TypedEq<uint8_t>(0x8C), A<uint16_t&>()))
+        .Times(3)
+        .WillRepeatedly(SetArgReferee<1>(0xD2E0));
+
+    MockServices services{};
+    MockSensors& sensors = services.getMockSensors();
+    EXPECT_CALL(sensors, startRail).Times(3);
+    EXPECT_CALL(sensors, setValue).Times(3);
+    EXPECT_CALL(sensors, endRail(false)).Times(3);
+
+    // Read, then read again about 50ms after the scheduled time
+    monitoring->execute(services, *system, *chassis, *device, *rail);
+    std::this_thread::sleep_for(std::chrono::milliseconds{150});
+    monitoring->execute(services, *system, *chassis, *device, *rail);
+    const SensorReadStatistics& stats = monitoring->getReadStatistics();
+    EXPECT_EQ(stats.jitterCount, 1);
+    EXPECT_GE(stats.lastJitter, std::chrono::milliseconds{50});
+    EXPECT_EQ(stats.maxJitter, stats.lastJitter);
+    EXPECT_EQ(stats.totalJitter, stats.lastJitter);
+
+    // Requested reads are not scheduled
+    monitoring->requestRead();
+    monitoring->execute(services, *system, *chassis, *device, *rail);
+    EXPECT_EQ(stats.count, 3);
+    EXPECT_EQ(stats.jitterCount, 1);
+}
+
+TEST(SensorMonitoringTests, GetSamplingGroups)
+{
+    std::vector<std::unique_ptr<Action>> actions{};
+    std::vector<std::unique_ptr<Action>> groupActions{};
+    groupActions.push_back(std::make_unique<MockAction>());
+    groupActions.push_back(std::make_unique<MockAction>());
+    std::vector<SamplingGroup> samplingGroups{};
+    samplingGroups.emplace_back(SamplingGroup{10, std::move(groupActions)});
+    SensorMonitoring sensorMonitoring(
+        std::move(actions), std::chrono::milliseconds{1000}, std::nullopt,
+        std::move(samplingGroups));
+    ASSERT_EQ(sensorMonitoring.getSamplingGroups().size(), 1);
+    EXPECT_EQ(sensorMonitoring.getSamplingGroups()[0].divisor, 10);
+    EXPECT_EQ(sensorMonitoring.getSamplingGroups()[0].actions.size(), 2);
+}
+
+TEST(SensorMonitoringTests, RequestRead)
+{
+    // Create PMBusReadSensorAction
+    std::unique_ptr<PMBusReadSensorAction> action =
+        std::make_unique<PMBusReadSensorAction>(
+            SensorType::iout, 0x8C, SensorDataFormat::linear_11,
+            std::optional<int8_t>{});
+
+    // Create SensorMonitoring with a 1000ms interval
+    std::vector<std::unique_ptr<Action>> actions{};
+    actions.emplace_back(std::move(action));
+    SensorMonitoring* monitoring = new SensorMonitoring(std::move(actions));
+
+    // Create parent objects that contain SensorMonitoring
+    auto [system, chassis, device, i2cInterface, rail] =
+        createParentObjects(std::unique_ptr<SensorMonitoring>{monitoring});
+
+    // Set I2CInterface expectations.  Should read register 0x8C 2 times.
+    EXPECT_CALL(*i2cInterface, isOpen).WillRepeatedly(Return(true));
+    EXPECT_CALL(*i2cInterface, read(TypedEq<uint8_t>(0x8C), A<uint16_t&>()))
+        .Times(2)
+        .WillRepeatedly(SetArgReferee<1>(0xD2E0));
+
+    // Rail should be read twice without being skipped
+    MockServices services{};
+    MockSensors& sensors = services.getMockSensors();
+    EXPECT_CALL(sensors, startRail).Times(2);
+    EXPECT_CALL(sensors, setValue).Times(2);
+    EXPECT_CALL(sensors, endRail(false)).Times(2);
+    EXPECT_CALL(sensors, skipRail).Times(0);
+
+    // Second read is requested before the interval has elapsed
+    monitoring->execute(services, *system, *chassis, *device, *rail);
+    monitoring->requestRead();
+    monitoring->execute(services, *system, *chassis, *device, *rail);
+    EXPECT_EQ(monitoring->getReadStatistics().count, 2);
+}
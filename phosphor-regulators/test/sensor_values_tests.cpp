@@ -0,0 +1,103 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "sensor_values.hpp"
+#include "sensors.hpp"
+
+#include <exception>
+#include <stdexcept>
+
+#include <gtest/gtest.h>
+
+using namespace phosphor::power::regulators;
+
+TEST(SensorValuesTests, Constructor)
+{
+    SensorValues values{};
+    EXPECT_EQ(values.size(), 0);
+    EXPECT_FALSE(values.contains(SensorType::iout));
+    EXPECT_FALSE(values.contains(SensorType::vout_valley));
+}
+
+TEST(SensorValuesTests, At)
+{
+    SensorValues values{};
+    values.set(SensorType::temperature, 45.0);
+
+    // Test where value has been set
+    EXPECT_EQ(values.at(SensorType::temperature), 45.0);
+
+    // Test where value has not been set
+    try
+    {
+        values.at(SensorType::vout);
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const std::out_of_range& oor_error)
+    {
+        EXPECT_STREQ(oor_error.what(), "No value for sensor type vout");
+    }
+    catch (const std::exception& error)
+    {
+        ADD_FAILURE() << "Should not have caught exception.";
+    }
+}
+
+TEST(SensorValuesTests, Clear)
+{
+    SensorValues values{};
+    values.set(SensorType::iout, 11.5);
+    values.set(SensorType::vout, 1.3);
+    EXPECT_EQ(values.size(), 2);
+
+    values.clear();
+    EXPECT_EQ(values.size(), 0);
+    EXPECT_FALSE(values.contains(SensorType::iout));
+    EXPECT_FALSE(values.contains(SensorType::vout));
+}
+
+TEST(SensorValuesTests, Contains)
+{
+    SensorValues values{};
+    EXPECT_FALSE(values.contains(SensorType::iout_valley));
+    values.set(SensorType::iout_valley, 10.0);
+    EXPECT_TRUE(values.contains(SensorType::iout_valley));
+    EXPECT_FALSE(values.contains(SensorType::iout_peak));
+}
+
+TEST(SensorValuesTests, Set)
+{
+    SensorValues values{};
+
+    // Test where value has not been set
+    values.set(SensorType::iout, 11.5);
+    EXPECT_EQ(values.size(), 1);
+    EXPECT_EQ(values.at(SensorType::iout), 11.5);
+
+    // Test where value has already been set; replaces previous value
+    values.set(SensorType::iout, 12.0);
+    EXPECT_EQ(values.size(), 1);
+    EXPECT_EQ(values.at(SensorType::iout), 12.0);
+}
+
+TEST(SensorValuesTests, Size)
+{
+    SensorValues values{};
+    EXPECT_EQ(values.size(), 0);
+    values.set(SensorType::vout, 1.3);
+    values.set(SensorType::vout_peak, 1.4);
+    values.set(SensorType::temperature, 45.0);
+    EXPECT_EQ(values.size(), 3);
+}
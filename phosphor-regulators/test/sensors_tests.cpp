@@ -22,6 +22,13 @@ using namespace phosphor::power::regulators::sensors;
 
 TEST(SensorsTests, ToString)
 {
+    // SensorStatistic
+    EXPECT_EQ(toString(SensorStatistic::minimum), "minimum");
+    EXPECT_EQ(toString(SensorStatistic::maximum), "maximum");
+    EXPECT_EQ(toString(SensorStatistic::mean), "mean");
+    EXPECT_EQ(toString(SensorStatistic::peak_to_peak), "peak_to_peak");
+
+    // SensorType
     EXPECT_EQ(toString(SensorType::iout), "iout");
     EXPECT_EQ(toString(SensorType::iout_peak), "iout_peak");
     EXPECT_EQ(toString(SensorType::iout_valley), "iout_valley");
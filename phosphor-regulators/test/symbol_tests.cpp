@@ -0,0 +1,116 @@
+/**
+ * Copyright © 2019 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "symbol.hpp"
+
+#include <future>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace phosphor::power::regulators;
+
+TEST(SymbolTests, Constructor)
+{
+    // Test where the symbol is for the empty string
+    {
+        Symbol symbol{};
+        EXPECT_TRUE(symbol.empty());
+        EXPECT_EQ(symbol.str(), "");
+        EXPECT_EQ(symbol, Symbol{""});
+    }
+
+    // Test where the symbol is for a non-empty string
+    {
+        Symbol symbol{"vdd_regulator"};
+        EXPECT_FALSE(symbol.empty());
+        EXPECT_EQ(symbol.str(), "vdd_regulator");
+    }
+
+    // Test where symbols for the same string share the string
+    {
+        std::string id{"vio_regulator"};
+        Symbol symbol1{id};
+        Symbol symbol2{"vio_regulator"};
+        EXPECT_EQ(symbol1, symbol2);
+        EXPECT_EQ(&symbol1.str(), &symbol2.str());
+
+        // Changing the original string does not change the symbol
+        id = "vdd_regulator";
+        EXPECT_EQ(symbol1.str(), "vio_regulator");
+    }
+
+    // Test where symbols are for different strings
+    {
+        Symbol symbol1{"vdd0"};
+        Symbol symbol2{"vdd1"};
+        EXPECT_FALSE(symbol1 == symbol2);
+    }
+}
+
+TEST(SymbolTests, Find)
+{
+    // Test where the string is in the table
+    {
+        Symbol symbol{"symbol_tests_find_1"};
+        std::optional<Symbol> found = Symbol::find("symbol_tests_find_1");
+        ASSERT_TRUE(found.has_value());
+        EXPECT_EQ(*found, symbol);
+    }
+
+    // Test where the string is not in the table.  It is not added.
+    {
+        EXPECT_FALSE(Symbol::find("symbol_tests_find_2").has_value());
+        EXPECT_FALSE(Symbol::find("symbol_tests_find_2").has_value());
+    }
+}
+
+TEST(SymbolTests, Hash)
+{
+    std::unordered_map<Symbol, int> map{};
+    map[Symbol{"reg1"}] = 1;
+    map[Symbol{"reg2"}] = 2;
+    map[Symbol{std::string{"reg1"}}] = 3;
+    EXPECT_EQ(map.size(), 2);
+    EXPECT_EQ(map.at(Symbol{"reg1"}), 3);
+    EXPECT_EQ(map.at(Symbol{"reg2"}), 2);
+}
+
+TEST(SymbolTests, Threads)
+{
+    // Test where several threads create symbols for the same strings
+    std::vector<std::future<std::vector<Symbol>>> workers{};
+    for (int i = 0; i < 4; ++i)
+    {
+        workers.emplace_back(std::async(std::launch::async, []() {
+            std::vector<Symbol> symbols{};
+            for (int j = 0; j < 100; ++j)
+            {
+                symbols.emplace_back("symbol_tests_thread_" +
+                                     std::to_string(j));
+            }
+            return symbols;
+        }));
+    }
+
+    std::vector<Symbol> first = workers[0].get();
+    for (std::size_t i = 1; i < workers.size(); ++i)
+    {
+        EXPECT_EQ(workers[i].get(), first);
+    }
+}
@@ -0,0 +1,658 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "action.hpp"
+#include "allocation_tracker.hpp"
+#include "chassis.hpp"
+#include "configuration.hpp"
+#include "device.hpp"
+#include "error_logging.hpp"
+#include "i2c_compare_bit_action.hpp"
+#include "i2c_interface.hpp"
+#include "i2c_write_byte_action.hpp"
+#include "if_action.hpp"
+#include "journal.hpp"
+#include "log_phase_fault_action.hpp"
+#include "phase_fault.hpp"
+#include "phase_fault_detection.hpp"
+#include "pmbus_read_sensor_action.hpp"
+#include "pmbus_utils.hpp"
+#include "pmbus_write_vout_command_action.hpp"
+#include "presence_service.hpp"
+#include "rail.hpp"
+#include "replay_i2c_interface.hpp"
+#include "rule.hpp"
+#include "run_rule_action.hpp"
+#include "sensor_monitoring.hpp"
+#include "sensor_monitoring_executor.hpp"
+#include "sensors.hpp"
+#include "services.hpp"
+#include "simulated_i2c_interface.hpp"
+#include "system.hpp"
+#include "vpd.hpp"
+
+#include <sdbusplus/bus.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+using namespace phosphor::power::regulators;
+using namespace phosphor::power::regulators::pmbus_utils;
+
+namespace
+{
+
+/**
+ * Number of rails produced by each regulator device.  Each rail uses its own
+ * PMBus page.
+ */
+constexpr std::size_t railsPerDevice{2};
+
+/**
+ * Number of regulator devices on each I2C bus.
+ */
+constexpr std::size_t devicesPerBus{8};
+
+/**
+ * Implementation of the I2CInterface that returns fixed values without any
+ * I2C communication.
+ *
+ * The gmock based MockedI2CInterface is not used because the cost and heap
+ * allocations of recording the mock calls would hide those of the action
+ * engine.
+ */
+class FakeI2CInterface : public i2c::I2CInterface
+{
+  public:
+    explicit FakeI2CInterface(uint8_t bus) : bus{bus}
+    {}
+
+    void open() override
+    {}
+    bool isOpen() const override
+    {
+        return true;
+    }
+    void close() override
+    {}
+    void read(uint8_t& data) override
+    {
+        data = 0x00;
+    }
+    void read(uint8_t addr, uint8_t& data) override
+    {
+        // VOUT_MODE: linear format with an exponent of -8.  Other registers,
+        // such as the phase fault status, contain 0.
+        data = (addr == VOUT_MODE) ? 0x18 : 0x00;
+    }
+    void read(uint8_t /*addr*/, uint16_t& data) override
+    {
+        data = 0x0100;
+    }
+    void read(uint8_t /*addr*/, uint8_t& size, uint8_t* data,
+              Mode /*mode*/) override
+    {
+        for (uint8_t i = 0; i < size; ++i)
+        {
+            data[i] = 0x00;
+        }
+    }
+    void readLarge(uint8_t /*addr*/, std::span<uint8_t> data) override
+    {
+        std::fill(data.begin(), data.end(), 0x00);
+    }
+    void write(uint8_t /*data*/) override
+    {}
+    void writeQuick() override
+    {}
+    void write(uint8_t /*addr*/, uint8_t /*data*/) override
+    {}
+    void write(uint8_t /*addr*/, uint16_t /*data*/) override
+    {}
+    void write(uint8_t /*addr*/, uint8_t /*size*/, const uint8_t* /*data*/,
+               Mode /*mode*/) override
+    {}
+    void transfer(std::vector<Operation>& /*operations*/) override
+    {}
+    uint8_t getBus() const override
+    {
+        return bus;
+    }
+    uint8_t getAddress() const override
+    {
+        return 0x70;
+    }
+    uint64_t getRetryCount() const override
+    {
+        return 0;
+    }
+    uint64_t getTransactionCount() const override
+    {
+        return 0;
+    }
+    void setStatsEnabled(bool /*enable*/) override
+    {}
+    std::string getStats() const override
+    {
+        return std::string{};
+    }
+    i2c::IdleStats getIdleStats() const override
+    {
+        return i2c::IdleStats{};
+    }
+
+  private:
+    uint8_t bus;
+};
+
+/**
+ * Creates a simulated regulator device on the specified I2C bus.
+ *
+ * The timing is similar to that of a PMBus regulator on a 400 kHz bus.  The
+ * registers return the same values as FakeI2CInterface.
+ *
+ * @param bus I2C bus
+ * @return simulated I2CInterface
+ */
+std::unique_ptr<i2c::I2CInterface> createSimulatedInterface(uint8_t bus)
+{
+    i2c::SimulatedTiming timing{};
+    timing.latency = std::chrono::microseconds{50};
+    timing.byteTime = std::chrono::microseconds{23};
+    timing.jitter = std::chrono::microseconds{10};
+
+    i2c::SimulatedI2CInterface::Registers registers{};
+    registers[VOUT_MODE] = {0x18};
+    registers[0x8B] = {0x00, 0x01};
+    registers[0x8C] = {0x00, 0x01};
+    registers[0x8D] = {0x00, 0x01};
+    return std::make_unique<i2c::SimulatedI2CInterface>(
+        bus, 0x40, timing, std::move(registers), bus);
+}
+
+/**
+ * Bus trace replayed by BM_MonitorSensorsReplay, set by the --bus_trace
+ * option.
+ */
+std::string busTracePath{};
+
+/**
+ * Returns a function that creates the devices from the devices recorded in
+ * a bus trace, such as by phosphor-regulators --bus-trace.
+ *
+ * Each device replays the transactions of the next recorded device, and
+ * the recorded devices are reused in turn when there are more devices than
+ * recorded ones.  The transactions are replayed with the recorded timing
+ * and failures, and start over when they have all been replayed.
+ *
+ * @param path bus trace file
+ * @param replays filled in with the created devices, so their misses can be
+ *                reported
+ * @return function that creates the I2CInterface of a device on a bus
+ */
+std::function<std::unique_ptr<i2c::I2CInterface>(uint8_t)>
+    createReplayInterfaces(const std::string& path,
+                           std::vector<i2c::ReplayI2CInterface*>& replays)
+{
+    auto entries =
+        std::make_shared<std::vector<i2c::TraceEntry>>(i2c::readTrace(path));
+    using Address = std::pair<uint8_t, uint8_t>;
+    auto recorded = std::make_shared<std::vector<Address>>();
+    for (const auto& interface : i2c::ReplayI2CInterface::load(path))
+    {
+        recorded->emplace_back(interface->getBus(), interface->getAddress());
+    }
+    if (recorded->empty())
+    {
+        throw std::runtime_error{"No I2C transactions in " + path};
+    }
+
+    return [entries, recorded, &replays](uint8_t) {
+        const auto& [bus, addr] =
+            (*recorded)[replays.size() % recorded->size()];
+        auto interface =
+            std::make_unique<i2c::ReplayI2CInterface>(bus, addr, *entries);
+        replays.emplace_back(interface.get());
+        return interface;
+    };
+}
+
+/**
+ * Implementation of the system services that does nothing.
+ */
+class NullServices : public Services, ErrorLogging, Journal, PresenceService,
+                     Sensors, VPD
+{
+  public:
+    sdbusplus::bus::bus& getBus() override
+    {
+        return bus;
+    }
+    ErrorLogging& getErrorLogging() override
+    {
+        return *this;
+    }
+    Journal& getJournal() override
+    {
+        return *this;
+    }
+    PresenceService& getPresenceService() override
+    {
+        return *this;
+    }
+    Sensors& getSensors() override
+    {
+        return *this;
+    }
+    VPD& getVPD() override
+    {
+        return *this;
+    }
+
+    // ErrorLogging
+    void logConfigFileError(Entry::Level, Journal&) override
+    {}
+    void logDBusError(Entry::Level, Journal&) override
+    {}
+    void logI2CError(Entry::Level, Journal&, const std::string&, uint8_t,
+                     int) override
+    {}
+    void logInternalError(Entry::Level, Journal&) override
+    {}
+    void logPhaseFault(Entry::Level, Journal&, PhaseFaultType,
+                       const std::string&,
+                       std::map<std::string, std::string>) override
+    {}
+    void logPMBusError(Entry::Level, Journal&, const std::string&) override
+    {}
+    void logWriteVerificationError(Entry::Level, Journal&,
+                                   const std::string&) override
+    {}
+
+    // Journal
+    std::vector<std::string> getMessages(const std::string&,
+                                         const std::string&,
+                                         unsigned int) override
+    {
+        return std::vector<std::string>{};
+    }
+    void logDebug(const std::string&) override
+    {}
+    void logDebug(const std::vector<std::string>&) override
+    {}
+    void logError(const std::string&) override
+    {}
+    void logError(const std::vector<std::string>&) override
+    {}
+    void logInfo(const std::string&) override
+    {}
+    void logInfo(const std::vector<std::string>&) override
+    {}
+
+    // PresenceService and VPD
+    void clearCache() override
+    {}
+    uint64_t getGeneration() override
+    {
+        return 0;
+    }
+    bool isPresent(const std::string&) override
+    {
+        return true;
+    }
+    std::optional<bool> getCachedPresence(const std::string&) override
+    {
+        return true;
+    }
+    std::vector<uint8_t> getValue(const std::string&,
+                                  const std::string&) override
+    {
+        return std::vector<uint8_t>{};
+    }
+    std::optional<std::vector<uint8_t>>
+        getCachedValue(const std::string&, const std::string&) override
+    {
+        return std::vector<uint8_t>{};
+    }
+
+    // Sensors
+    void enable() override
+    {}
+    void endCycle() override
+    {}
+    void endRail(bool) override
+    {}
+    void disable() override
+    {}
+    void disableRail(const std::string&) override
+    {}
+    void setAggregatedValue(SensorType, double,
+                            const SensorAggregation&) override
+    {}
+    void setValue(SensorType, double) override
+    {}
+    void skipRail(const std::string&) override
+    {}
+    void startCycle() override
+    {}
+    void startRail(const std::string&, const std::string&,
+                   const std::string&) override
+    {}
+
+  private:
+    sdbusplus::bus::bus bus{sdbusplus::bus::new_default()};
+};
+
+/**
+ * Creates the rules used by the generated devices.
+ *
+ * The rules are similar to those in the standard config files: reading the
+ * output voltage, current, and temperature, and checking a status bit for a
+ * phase fault.
+ *
+ * @return rules
+ */
+std::vector<std::unique_ptr<Rule>> createRules()
+{
+    std::vector<std::unique_ptr<Rule>> rules{};
+
+    // Rule that reads the sensors of the selected page
+    {
+        std::vector<std::unique_ptr<Action>> actions{};
+        actions.emplace_back(std::make_unique<PMBusReadSensorAction>(
+            SensorType::vout, 0x8B, SensorDataFormat::linear_16,
+            std::nullopt));
+        actions.emplace_back(std::make_unique<PMBusReadSensorAction>(
+            SensorType::iout, 0x8C, SensorDataFormat::linear_11,
+            std::nullopt));
+        actions.emplace_back(std::make_unique<PMBusReadSensorAction>(
+            SensorType::temperature, 0x8D, SensorDataFormat::linear_11,
+            std::nullopt));
+        rules.emplace_back(
+            std::make_unique<Rule>("read_sensors", std::move(actions)));
+    }
+
+    // Rule that checks a status bit for an N phase fault
+    {
+        std::vector<std::unique_ptr<Action>> thenActions{};
+        thenActions.emplace_back(
+            std::make_unique<LogPhaseFaultAction>(PhaseFaultType::n));
+        std::vector<std::unique_ptr<Action>> actions{};
+        actions.emplace_back(std::make_unique<IfAction>(
+            std::make_unique<I2CCompareBitAction>(0x7E, 3, 1),
+            std::move(thenActions)));
+        rules.emplace_back(
+            std::make_unique<Rule>("detect_phase_fault", std::move(actions)));
+    }
+
+    return rules;
+}
+
+/**
+ * Creates a Rail on the specified PMBus page.
+ *
+ * @param id rail ID
+ * @param page PMBus page
+ * @return Rail object
+ */
+std::unique_ptr<Rail> createRail(const std::string& id, uint8_t page)
+{
+    // Configuration that sets the output voltage
+    std::vector<std::unique_ptr<Action>> configActions{};
+    configActions.emplace_back(
+        std::make_unique<I2CWriteByteAction>(PAGE, page));
+    configActions.emplace_back(std::make_unique<PMBusWriteVoutCommandAction>(
+        std::nullopt, VoutDataFormat::linear, std::nullopt, false));
+    auto configuration =
+        std::make_unique<Configuration>(1.0, std::move(configActions));
+
+    // Sensor monitoring that reads the sensors every cycle
+    std::vector<std::unique_ptr<Action>> sensorActions{};
+    sensorActions.emplace_back(
+        std::make_unique<I2CWriteByteAction>(PAGE, page));
+    sensorActions.emplace_back(std::make_unique<RunRuleAction>("read_sensors"));
+    auto sensorMonitoring = std::make_unique<SensorMonitoring>(
+        std::move(sensorActions), std::chrono::milliseconds{0});
+
+    return std::make_unique<Rail>(id, std::move(configuration),
+                                  std::move(sensorMonitoring));
+}
+
+/**
+ * Creates a System with one chassis containing the specified number of rails.
+ *
+ * The rails are produced by regulator devices with railsPerDevice rails each.
+ * The devices are spread across I2C buses with devicesPerBus devices each.
+ *
+ * @param railCount number of rails
+ * @param createInterface creates the I2CInterface of a device on a bus
+ * @return System object
+ */
+std::unique_ptr<System> createSystem(
+    std::size_t railCount,
+    const std::function<std::unique_ptr<i2c::I2CInterface>(uint8_t)>&
+        createInterface)
+{
+    std::vector<std::unique_ptr<Device>> devices{};
+    for (std::size_t railIndex = 0; railIndex < railCount;)
+    {
+        std::size_t deviceIndex = devices.size();
+        std::string deviceID = "reg" + std::to_string(deviceIndex);
+
+        std::vector<std::unique_ptr<Rail>> rails{};
+        for (uint8_t page = 0;
+             (page < railsPerDevice) && (railIndex < railCount);
+             ++page, ++railIndex)
+        {
+            rails.emplace_back(
+                createRail("rail" + std::to_string(railIndex), page));
+        }
+
+        std::vector<std::unique_ptr<Action>> phaseFaultActions{};
+        phaseFaultActions.emplace_back(
+            std::make_unique<I2CWriteByteAction>(PAGE, 0));
+        phaseFaultActions.emplace_back(
+            std::make_unique<RunRuleAction>("detect_phase_fault"));
+        auto phaseFaultDetection =
+            std::make_unique<PhaseFaultDetection>(std::move(phaseFaultActions));
+
+        uint8_t bus = deviceIndex / devicesPerBus;
+        devices.emplace_back(std::make_unique<Device>(
+            deviceID, true,
+            "/xyz/openbmc_project/inventory/system/chassis/motherboard/" +
+                deviceID,
+            createInterface(bus), nullptr, nullptr,
+            std::move(phaseFaultDetection), std::move(rails)));
+    }
+
+    std::vector<std::unique_ptr<Chassis>> chassis{};
+    chassis.emplace_back(std::make_unique<Chassis>(
+        1, "/xyz/openbmc_project/inventory/system/chassis",
+        std::move(devices)));
+    auto system = std::make_unique<System>(createRules(), std::move(chassis));
+    system->compileActions();
+    return system;
+}
+
+/**
+ * Runs the specified System operation repeatedly and reports the time and
+ * number of heap allocations per rail.
+ *
+ * By default the devices use FakeI2CInterface, so only the cost of the code
+ * is measured.  With createSimulatedInterface() the time of the I2C
+ * transactions is included.
+ *
+ * @param state benchmark state.  range(0) is the number of rails.
+ * @param operation operation to run
+ * @param createInterface creates the I2CInterface of a device on a bus
+ */
+template <typename Operation>
+void runBenchmark(
+    benchmark::State& state, Operation operation,
+    const std::function<std::unique_ptr<i2c::I2CInterface>(uint8_t)>&
+        createInterface = [](uint8_t bus) {
+            return std::make_unique<FakeI2CInterface>(bus);
+        })
+{
+    std::size_t railCount = state.range(0);
+    NullServices services{};
+    std::unique_ptr<System> system = createSystem(railCount, createInterface);
+
+    uint64_t allocations = allocation_tracker::getAllocationCount();
+    for (auto _ : state)
+    {
+        operation(*system, services);
+    }
+    allocations = allocation_tracker::getAllocationCount() - allocations;
+
+    double rails = static_cast<double>(state.iterations() * railCount);
+    state.SetItemsProcessed(state.iterations() * railCount);
+    state.counters["time/rail"] = benchmark::Counter(
+        rails, benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+    state.counters["allocs/rail"] = static_cast<double>(allocations) / rails;
+}
+
+void BM_MonitorSensors(benchmark::State& state)
+{
+    runBenchmark(state, [](System& system, Services& services) {
+        system.monitorSensors(services);
+    });
+}
+
+void BM_Configure(benchmark::State& state)
+{
+    runBenchmark(state, [](System& system, Services& services) {
+        system.configure(services);
+    });
+}
+
+void BM_DetectPhaseFaults(benchmark::State& state)
+{
+    runBenchmark(state, [](System& system, Services& services) {
+        system.detectPhaseFaults(services);
+    });
+}
+
+void BM_MonitorSensorsSimulated(benchmark::State& state)
+{
+    runBenchmark(
+        state,
+        [](System& system, Services& services) {
+            system.monitorSensors(services);
+        },
+        createSimulatedInterface);
+}
+
+void BM_MonitorSensorsSimulatedParallel(benchmark::State& state)
+{
+    std::unique_ptr<SensorMonitoringExecutor> executor{};
+    runBenchmark(
+        state,
+        [&executor](System& system, Services& services) {
+            if (!executor)
+            {
+                executor = std::make_unique<SensorMonitoringExecutor>(system);
+            }
+            executor->execute(services);
+        },
+        createSimulatedInterface);
+}
+
+void BM_MonitorSensorsReplay(benchmark::State& state)
+{
+    std::vector<i2c::ReplayI2CInterface*> replays{};
+    runBenchmark(
+        state,
+        [](System& system, Services& services) {
+            system.monitorSensors(services);
+        },
+        createReplayInterfaces(busTracePath, replays));
+
+    // Transactions the recorded system did not do, such as for registers
+    // its configuration does not read, fail without a recorded value
+    uint64_t misses{0};
+    for (const i2c::ReplayI2CInterface* replay : replays)
+    {
+        misses += replay->getMissCount();
+    }
+    state.counters["misses"] = static_cast<double>(misses);
+}
+
+} // namespace
+
+BENCHMARK(BM_MonitorSensors)->RangeMultiplier(10)->Range(10, 1000);
+BENCHMARK(BM_Configure)->RangeMultiplier(10)->Range(10, 1000);
+BENCHMARK(BM_DetectPhaseFaults)->RangeMultiplier(10)->Range(10, 1000);
+BENCHMARK(BM_MonitorSensorsSimulated)
+    ->RangeMultiplier(10)
+    ->Range(10, 100)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_MonitorSensorsSimulatedParallel)
+    ->RangeMultiplier(10)
+    ->Range(10, 100)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+int main(int argc, char** argv)
+{
+    // Remove the --bus_trace=<file> option, which the benchmark library does
+    // not know, before initializing it
+    const char* option = "--bus_trace=";
+    int count = 1;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strncmp(argv[i], option, std::strlen(option)) == 0)
+        {
+            busTracePath = argv[i] + std::strlen(option);
+        }
+        else
+        {
+            argv[count++] = argv[i];
+        }
+    }
+    argc = count;
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+    {
+        return 1;
+    }
+    if (!busTracePath.empty())
+    {
+        benchmark::RegisterBenchmark("BM_MonitorSensorsReplay",
+                                     BM_MonitorSensorsReplay)
+            ->RangeMultiplier(10)
+            ->Range(10, 100)
+            ->UseRealTime()
+            ->Unit(benchmark::kMillisecond);
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
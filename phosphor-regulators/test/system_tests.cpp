@@ -14,11 +14,16 @@
  * limitations under the License.
  */
 #include "action.hpp"
+#include "action_environment.hpp"
+#include "and_action.hpp"
 #include "chassis.hpp"
+#include "compare_presence_action.hpp"
+#include "compare_vpd_action.hpp"
 #include "configuration.hpp"
 #include "device.hpp"
 #include "i2c_interface.hpp"
 #include "id_map.hpp"
+#include "if_action.hpp"
 #include "log_phase_fault_action.hpp"
 #include "mock_action.hpp"
 #include "mock_error_logging.hpp"
@@ -26,19 +31,28 @@
 #include "mock_sensors.hpp"
 #include "mock_services.hpp"
 #include "mocked_i2c_interface.hpp"
+#include "not_action.hpp"
 #include "phase_fault.hpp"
 #include "phase_fault_detection.hpp"
+#include "power_domain.hpp"
 #include "presence_detection.hpp"
 #include "rail.hpp"
 #include "rule.hpp"
+#include "run_rule_action.hpp"
 #include "sensor_monitoring.hpp"
 #include "sensors.hpp"
 #include "services.hpp"
+#include "set_device_action.hpp"
 #include "system.hpp"
 #include "test_sdbus_error.hpp"
 #include "test_utils.hpp"
 
+#include <chrono>
+#include <cstdint>
+#include <map>
 #include <memory>
+#include <optional>
+#include <set>
 #include <stdexcept>
 #include <string>
 #include <utility>
@@ -81,6 +95,106 @@ TEST(SystemTests, Constructor)
     EXPECT_THROW(system.getIDMap().getRail("rail2"), std::invalid_argument);
     EXPECT_EQ(system.getRules().size(), 1);
     EXPECT_EQ(system.getRules()[0]->getID(), "set_voltage_rule");
+
+    // Test where actions are linked to the objects in the IDMap
+    {
+        // Create Rules.  read_sensors_rule runs set_device_rule, which sets
+        // the device to reg1.
+        std::vector<std::unique_ptr<Rule>> rules{};
+        std::vector<std::unique_ptr<Action>> actions{};
+        actions.emplace_back(std::make_unique<SetDeviceAction>("reg1"));
+        rules.emplace_back(
+            std::make_unique<Rule>("set_device_rule", std::move(actions)));
+        actions.clear();
+        actions.emplace_back(
+            std::make_unique<RunRuleAction>("set_device_rule"));
+        rules.emplace_back(
+            std::make_unique<Rule>("read_sensors_rule", std::move(actions)));
+
+        // Create Chassis
+        std::vector<std::unique_ptr<Chassis>> chassis{};
+        std::vector<std::unique_ptr<Device>> devices{};
+        devices.emplace_back(createDevice("reg1"));
+        chassis.emplace_back(
+            std::make_unique<Chassis>(1, chassisInvPath, std::move(devices)));
+
+        // Create System
+        System system{std::move(rules), std::move(chassis)};
+
+        // Execute read_sensors_rule with an empty IDMap.  The rule and device
+        // can only be found if the actions were linked.
+        IDMap emptyIDMap{};
+        MockServices services{};
+        ActionEnvironment env{emptyIDMap, "", services};
+        EXPECT_EQ(system.getRules()[1]->execute(env), true);
+        EXPECT_EQ(&(env.getDevice()),
+                  system.getChassis()[0]->getDevices()[0].get());
+    }
+}
+
+TEST(SystemTests, AddChassis)
+{
+    // Create System with one chassis.  set_device_rule sets the device to
+    // reg2, which is in a chassis that is added later.
+    std::vector<std::unique_ptr<Rule>> rules{};
+    std::vector<std::unique_ptr<Action>> actions{};
+    actions.emplace_back(std::make_unique<SetDeviceAction>("reg2"));
+    rules.emplace_back(
+        std::make_unique<Rule>("set_device_rule", std::move(actions)));
+    std::vector<std::unique_ptr<Chassis>> chassis{};
+    std::vector<std::unique_ptr<Device>> devices{};
+    devices.emplace_back(createDevice("reg1", {"rail1"}));
+    chassis.emplace_back(
+        std::make_unique<Chassis>(1, chassisInvPath, std::move(devices)));
+    System system{std::move(rules), std::move(chassis)};
+    system.compileActions();
+
+    // Test where works
+    {
+        std::vector<std::unique_ptr<Chassis>> newChassis{};
+        std::vector<std::unique_ptr<Device>> devices{};
+        devices.emplace_back(createDevice("reg2", {"rail2"}));
+        newChassis.emplace_back(std::make_unique<Chassis>(
+            2, chassisInvPath + "2", std::move(devices)));
+        system.addChassis(std::move(newChassis));
+
+        EXPECT_EQ(system.getChassis().size(), 2);
+        EXPECT_EQ(system.getChassis()[0]->getNumber(), 1);
+        EXPECT_EQ(system.getChassis()[1]->getNumber(), 2);
+        EXPECT_NO_THROW(system.getIDMap().getDevice("reg1"));
+        EXPECT_NO_THROW(system.getIDMap().getDevice("reg2"));
+        EXPECT_NO_THROW(system.getIDMap().getRail("rail2"));
+
+        // Execute set_device_rule with an empty IDMap.  The device can only
+        // be found if the actions were linked again.
+        IDMap emptyIDMap{};
+        MockServices services{};
+        ActionEnvironment env{emptyIDMap, "", services};
+        EXPECT_EQ(system.getRules()[0]->execute(env), true);
+        EXPECT_EQ(&(env.getDevice()),
+                  system.getChassis()[1]->getDevices()[0].get());
+    }
+
+    // Test where fails: Device ID already used.  No chassis added.
+    {
+        std::vector<std::unique_ptr<Chassis>> newChassis{};
+        std::vector<std::unique_ptr<Device>> devices{};
+        devices.emplace_back(createDevice("reg3", {"rail3"}));
+        newChassis.emplace_back(std::make_unique<Chassis>(
+            3, chassisInvPath + "3", std::move(devices)));
+        devices.clear();
+        devices.emplace_back(createDevice("reg1"));
+        newChassis.emplace_back(std::make_unique<Chassis>(
+            4, chassisInvPath + "4", std::move(devices)));
+        EXPECT_THROW(system.addChassis(std::move(newChassis)),
+                     std::invalid_argument);
+
+        EXPECT_EQ(system.getChassis().size(), 2);
+        EXPECT_THROW(system.getIDMap().getDevice("reg3"),
+                     std::invalid_argument);
+        EXPECT_THROW(system.getIDMap().getRail("rail3"),
+                     std::invalid_argument);
+    }
 }
 
 TEST(SystemTests, ClearCache)
@@ -203,6 +317,140 @@ TEST(SystemTests, ClearErrorHistory)
     }
 }
 
+TEST(SystemTests, ClearPresenceCache)
+{
+    const std::string cpu0{
+        "/xyz/openbmc_project/inventory/system/chassis/motherboard/cpu0"};
+    const std::string cpu1{
+        "/xyz/openbmc_project/inventory/system/chassis/motherboard/cpu1"};
+
+    // Create rule that compares the presence of cpu1
+    std::vector<std::unique_ptr<Rule>> rules{};
+    {
+        std::vector<std::unique_ptr<Action>> actions{};
+        actions.emplace_back(
+            std::make_unique<ComparePresenceAction>(cpu1, true));
+        rules.emplace_back(
+            std::make_unique<Rule>("is_cpu1_present", std::move(actions)));
+    }
+
+    // Creates a Device with PresenceDetection that runs the specified action
+    std::vector<std::unique_ptr<Device>> devices{};
+    std::vector<PresenceDetection*> presenceDetections{};
+    auto addDevice = [&](const std::string& id, std::unique_ptr<Action> action,
+                         std::optional<std::chrono::milliseconds> cacheTTL =
+                             std::nullopt) {
+        std::vector<std::unique_ptr<Action>> actions{};
+        actions.emplace_back(std::move(action));
+        auto presenceDetection =
+            std::make_unique<PresenceDetection>(std::move(actions), cacheTTL);
+        presenceDetections.emplace_back(presenceDetection.get());
+        devices.emplace_back(std::make_unique<Device>(
+            id, true,
+            "/xyz/openbmc_project/inventory/system/chassis/motherboard/" + id,
+            std::make_unique<i2c::MockedI2CInterface>(),
+            std::move(presenceDetection)));
+    };
+
+    // Device whose presence depends on cpu0
+    addDevice("reg0", std::make_unique<ComparePresenceAction>(cpu0, true));
+
+    // Device whose presence depends on cpu0 and on cpu1 using a rule
+    {
+        std::vector<std::unique_ptr<Action>> actions{};
+        actions.emplace_back(
+            std::make_unique<ComparePresenceAction>(cpu0, true));
+        actions.emplace_back(
+            std::make_unique<RunRuleAction>("is_cpu1_present"));
+        addDevice("reg1", std::make_unique<AndAction>(std::move(actions)));
+    }
+
+    // Device whose presence depends on other data
+    {
+        auto action = std::make_unique<MockAction>();
+        EXPECT_CALL(*action, execute).WillRepeatedly(Return(true));
+        addDevice("reg2", std::move(action));
+    }
+
+    // Hot-pluggable device whose presence depends on other data
+    {
+        auto action = std::make_unique<MockAction>();
+        EXPECT_CALL(*action, execute).WillRepeatedly(Return(true));
+        addDevice("reg3", std::move(action), std::chrono::seconds{60});
+    }
+
+    // Create System that contains Chassis
+    std::vector<std::unique_ptr<Chassis>> chassis{};
+    chassis.emplace_back(
+        std::make_unique<Chassis>(1, chassisInvPath, std::move(devices)));
+    Chassis* chassisPtr = chassis.back().get();
+    System system{std::move(rules), std::move(chassis)};
+
+    // Verify the inventory paths are found when the actions are compiled
+    EXPECT_FALSE(presenceDetections[0]->dependsOnlyOnPresence());
+    system.compileActions();
+    EXPECT_EQ(presenceDetections[0]->getInventoryPaths(),
+              std::vector<std::string>{cpu0});
+    EXPECT_EQ(presenceDetections[1]->getInventoryPaths(),
+              (std::vector<std::string>{cpu0, cpu1}));
+    EXPECT_FALSE(presenceDetections[2]->dependsOnlyOnPresence());
+
+    // Caches presence values in all the PresenceDetection objects
+    MockServices services{};
+    auto cachePresence = [&]() {
+        const auto& chassisDevices = chassisPtr->getDevices();
+        for (size_t i = 0; i < presenceDetections.size(); ++i)
+        {
+            presenceDetections[i]->execute(services, system, *chassisPtr,
+                                           *chassisDevices[i]);
+        }
+    };
+    auto isCached = [&](size_t i) {
+        return presenceDetections[i]->getCachedPresence().has_value();
+    };
+
+    // Clear presence that depends on cpu1
+    cachePresence();
+    system.clearPresenceCache(cpu1);
+    EXPECT_TRUE(isCached(0));
+    EXPECT_FALSE(isCached(1));
+    EXPECT_TRUE(isCached(2));
+    EXPECT_FALSE(isCached(3));
+
+    // Clear presence that depends on cpu0
+    cachePresence();
+    system.clearPresenceCache(cpu0);
+    EXPECT_FALSE(isCached(0));
+    EXPECT_FALSE(isCached(1));
+    EXPECT_TRUE(isCached(2));
+    EXPECT_FALSE(isCached(3));
+
+    // Clear presence that depends on hardware with no dependents.  Presence
+    // with a cache TTL is cleared by any presence change.
+    cachePresence();
+    system.clearPresenceCache(chassisInvPath);
+    EXPECT_TRUE(isCached(0));
+    EXPECT_TRUE(isCached(1));
+    EXPECT_TRUE(isCached(2));
+    EXPECT_FALSE(isCached(3));
+
+    // Clear all presence that depends on hardware presence
+    system.clearPresenceCache("");
+    EXPECT_FALSE(isCached(0));
+    EXPECT_FALSE(isCached(1));
+    EXPECT_TRUE(isCached(2));
+    EXPECT_FALSE(isCached(3));
+
+    // Clearing the cached data only clears presence that depends on other
+    // data
+    cachePresence();
+    system.clearCache();
+    EXPECT_TRUE(isCached(0));
+    EXPECT_TRUE(isCached(1));
+    EXPECT_FALSE(isCached(2));
+    EXPECT_FALSE(isCached(3));
+}
+
 TEST(SystemTests, CloseDevices)
 {
     // Specify an empty rules vector
@@ -228,6 +476,104 @@ TEST(SystemTests, CloseDevices)
     system.closeDevices(services);
 }
 
+TEST(SystemTests, CloseUnpoweredDevices)
+{
+    // Specify an empty rules vector
+    std::vector<std::unique_ptr<Rule>> rules{};
+
+    // Create mock services.  Expect logDebug() to be called.
+    MockServices services{};
+    MockJournal& journal = services.getMockJournal();
+    EXPECT_CALL(journal, logDebug("Closing unpowered devices in chassis 1"))
+        .Times(1);
+    EXPECT_CALL(journal, logDebug("Closing unpowered devices in chassis 3"))
+        .Times(1);
+    EXPECT_CALL(journal, logError(A<const std::string&>())).Times(0);
+
+    // Create Chassis
+    std::vector<std::unique_ptr<Chassis>> chassis{};
+    chassis.emplace_back(std::make_unique<Chassis>(1, chassisInvPath + '1'));
+    chassis.emplace_back(std::make_unique<Chassis>(3, chassisInvPath + '3'));
+
+    // Create System
+    System system{std::move(rules), std::move(chassis)};
+
+    // Call closeUnpoweredDevices()
+    system.closeUnpoweredDevices(services);
+}
+
+TEST(SystemTests, CompileActions)
+{
+    // Creates a rule with the specified ID and action
+    auto createRule = [](const std::string& id,
+                         std::unique_ptr<Action> action) {
+        std::vector<std::unique_ptr<Action>> actions{};
+        actions.emplace_back(std::move(action));
+        return std::make_unique<Rule>(id, std::move(actions));
+    };
+    const std::string fru{
+        "/xyz/openbmc_project/inventory/system/chassis/motherboard/cpu1"};
+
+    std::vector<std::unique_ptr<Rule>> rules{};
+
+    // Rule that only compares presence and VPD
+    {
+        std::vector<std::unique_ptr<Action>> actions{};
+        actions.emplace_back(
+            std::make_unique<ComparePresenceAction>(fru, true));
+        actions.emplace_back(std::make_unique<CompareVPDAction>(
+            fru, "CCIN", std::vector<uint8_t>{0x32, 0x44}));
+        rules.emplace_back(createRule(
+            "is_cpu1_present",
+            std::make_unique<AndAction>(std::move(actions))));
+    }
+
+    // Rule that runs a memoizable rule inside an if action
+    {
+        std::vector<std::unique_ptr<Action>> thenActions{};
+        thenActions.emplace_back(
+            std::make_unique<NotAction>(std::make_unique<ComparePresenceAction>(
+                fru, false)));
+        rules.emplace_back(createRule(
+            "is_cpu1_present_if",
+            std::make_unique<IfAction>(
+                std::make_unique<RunRuleAction>("is_cpu1_present"),
+                std::move(thenActions))));
+    }
+
+    // Rule that accesses the device
+    rules.emplace_back(
+        createRule("set_voltage", std::make_unique<MockAction>()));
+
+    // Rule that runs a non-memoizable rule
+    rules.emplace_back(createRule(
+        "set_voltage_wrapper", std::make_unique<RunRuleAction>("set_voltage")));
+
+    // Rule that runs itself
+    rules.emplace_back(createRule(
+        "recursive_rule", std::make_unique<RunRuleAction>("recursive_rule")));
+
+    // Rule that runs a rule that does not exist
+    rules.emplace_back(createRule(
+        "missing_rule_wrapper",
+        std::make_unique<RunRuleAction>("missing_rule")));
+
+    System system{std::move(rules), std::vector<std::unique_ptr<Chassis>>{}};
+    for (const std::unique_ptr<Rule>& rule : system.getRules())
+    {
+        EXPECT_FALSE(rule->isMemoizable());
+    }
+
+    system.compileActions();
+    const auto& systemRules = system.getRules();
+    EXPECT_TRUE(systemRules[0]->isMemoizable());
+    EXPECT_TRUE(systemRules[1]->isMemoizable());
+    EXPECT_FALSE(systemRules[2]->isMemoizable());
+    EXPECT_FALSE(systemRules[3]->isMemoizable());
+    EXPECT_FALSE(systemRules[4]->isMemoizable());
+    EXPECT_FALSE(systemRules[5]->isMemoizable());
+}
+
 TEST(SystemTests, Configure)
 {
     // Create mock services.  Expect logInfo() to be called.
@@ -250,7 +596,14 @@ TEST(SystemTests, Configure)
     System system{std::move(rules), std::move(chassis)};
 
     // Call configure()
-    system.configure(services);
+    EXPECT_EQ(system.configure(services), 0);
+
+    // Call configure() for a power domain
+    EXPECT_CALL(journal, logInfo("Configuring chassis 1 power domain cpu0"))
+        .Times(1);
+    EXPECT_CALL(journal, logInfo("Configuring chassis 3 power domain cpu0"))
+        .Times(1);
+    system.configure(services, "cpu0");
 }
 
 TEST(SystemTests, DetectPhaseFaults)
@@ -363,6 +716,48 @@ TEST(SystemTests, GetChassis)
     EXPECT_EQ(system.getChassis()[1]->getNumber(), 3);
 }
 
+TEST(SystemTests, GetPowerDomains)
+{
+    // Test where no devices are in a power domain
+    {
+        std::vector<std::unique_ptr<Device>> devices{};
+        devices.emplace_back(createDevice("vdd0_reg"));
+        std::vector<std::unique_ptr<Chassis>> chassis{};
+        chassis.emplace_back(std::make_unique<Chassis>(
+            1, chassisInvPath + '1', std::move(devices)));
+        std::vector<std::unique_ptr<Rule>> rules{};
+        System system{std::move(rules), std::move(chassis)};
+        EXPECT_TRUE(system.getPowerDomains().empty());
+    }
+
+    // Test where devices in multiple chassis are in power domains.  The rails
+    // of a power domain are combined.
+    {
+        std::vector<std::unique_ptr<Chassis>> chassis{};
+        for (unsigned int number : {1u, 2u})
+        {
+            std::string prefix{"c" + std::to_string(number) + "_"};
+            std::vector<std::unique_ptr<Device>> devices{};
+            devices.emplace_back(createDevice(prefix + "vdd_reg"));
+            devices.emplace_back(createDevice(prefix + "vmem_reg"));
+            devices.emplace_back(createDevice(prefix + "vio_reg"));
+            devices[0]->setPowerDomain(std::make_unique<PowerDomain>(
+                "cpu" + std::to_string(number - 1),
+                std::vector<unsigned int>{4 * number, 4 * number + 1}));
+            devices[1]->setPowerDomain(std::make_unique<PowerDomain>(
+                "memory", std::vector<unsigned int>{number}));
+            chassis.emplace_back(std::make_unique<Chassis>(
+                number, chassisInvPath + std::to_string(number),
+                std::move(devices)));
+        }
+        std::vector<std::unique_ptr<Rule>> rules{};
+        System system{std::move(rules), std::move(chassis)};
+        EXPECT_EQ(system.getPowerDomains(),
+                  (std::map<std::string, std::set<unsigned int>>{
+                      {"cpu0", {4, 5}}, {"cpu1", {8, 9}}, {"memory", {1, 2}}}));
+    }
+}
+
 TEST(SystemTests, GetIDMap)
 {
     // Create Rules
@@ -23,6 +23,7 @@
 #include "presence_detection.hpp"
 #include "rail.hpp"
 #include "rule.hpp"
+#include "system.hpp"
 
 #include <filesystem>
 #include <fstream>
@@ -96,6 +97,32 @@ inline std::unique_ptr<Rule> createRule(const std::string& id)
     return std::make_unique<Rule>(id, std::move(actions));
 }
 
+/**
+ * Creates a System with one chassis that contains the specified devices.
+ *
+ * The inventory path of the chassis is
+ * /xyz/openbmc_project/inventory/system/chassis.
+ *
+ * @param devices devices in the chassis
+ * @param parallelConfiguration indicates whether devices on different I2C
+ *                              buses are configured in parallel
+ * @param independentMonitoring indicates whether the sensors of the chassis
+ *                              are monitored on their own worker thread
+ * @return System object
+ */
+inline std::unique_ptr<System>
+    createSystem(std::vector<std::unique_ptr<Device>> devices,
+                 bool parallelConfiguration = false,
+                 bool independentMonitoring = false)
+{
+    std::vector<std::unique_ptr<Chassis>> chassis{};
+    chassis.emplace_back(std::make_unique<Chassis>(
+        1, "/xyz/openbmc_project/inventory/system/chassis", std::move(devices),
+        parallelConfiguration, independentMonitoring));
+    std::vector<std::unique_ptr<Rule>> rules{};
+    return std::make_unique<System>(std::move(rules), std::move(chassis));
+}
+
 /**
  * Modify the specified file so that fs::remove() fails with an exception.
  *
@@ -568,6 +568,32 @@ TEST(ValidateRegulatorsConfigTest, Chassis)
         configFile["chassis"][0].erase("devices");
         EXPECT_JSON_VALID(configFile);
     }
+    // Valid: test chassis with independent_monitoring property.
+    {
+        json configFile = validConfigFile;
+        configFile["chassis"][0]["independent_monitoring"] = true;
+        EXPECT_JSON_VALID(configFile);
+    }
+    // Invalid: test chassis with property independent_monitoring wrong type.
+    {
+        json configFile = validConfigFile;
+        configFile["chassis"][0]["independent_monitoring"] = 1;
+        EXPECT_JSON_INVALID(configFile, "Validation failed.",
+                            "1 is not of type 'boolean'");
+    }
+    // Valid: test chassis with parallel_configuration property.
+    {
+        json configFile = validConfigFile;
+        configFile["chassis"][0]["parallel_configuration"] = true;
+        EXPECT_JSON_VALID(configFile);
+    }
+    // Invalid: test chassis with property parallel_configuration wrong type.
+    {
+        json configFile = validConfigFile;
+        configFile["chassis"][0]["parallel_configuration"] = 1;
+        EXPECT_JSON_INVALID(configFile, "Validation failed.",
+                            "1 is not of type 'boolean'");
+    }
     // Invalid: test chassis with no number.
     {
         json configFile = validConfigFile;
@@ -1057,6 +1083,40 @@ TEST(ValidateRegulatorsConfigTest, Device)
         configFile["chassis"][0]["devices"][0].erase("rails");
         EXPECT_JSON_VALID(configFile);
     }
+    // Valid: test devices with depends_on property.
+    {
+        json configFile = validConfigFile;
+        configFile["chassis"][0]["devices"][0]["depends_on"][0] =
+            "vdd_regulator";
+        EXPECT_JSON_VALID(configFile);
+    }
+    // Valid: test devices with is_standby_powered property.
+    {
+        json configFile = validConfigFile;
+        configFile["chassis"][0]["devices"][0]["is_standby_powered"] = true;
+        EXPECT_JSON_VALID(configFile);
+    }
+    // Invalid: test devices with property is_standby_powered wrong type.
+    {
+        json configFile = validConfigFile;
+        configFile["chassis"][0]["devices"][0]["is_standby_powered"] = 1;
+        EXPECT_JSON_INVALID(configFile, "Validation failed.",
+                            "1 is not of type 'boolean'");
+    }
+    // Invalid: test devices with property depends_on wrong type.
+    {
+        json configFile = validConfigFile;
+        configFile["chassis"][0]["devices"][0]["depends_on"] = "vdd_regulator";
+        EXPECT_JSON_INVALID(configFile, "Validation failed.",
+                            "'vdd_regulator' is not of type 'array'");
+    }
+    // Invalid: test devices with property depends_on empty array.
+    {
+        json configFile = validConfigFile;
+        configFile["chassis"][0]["devices"][0]["depends_on"] = json::array();
+        EXPECT_JSON_INVALID(configFile, "Validation failed.",
+                            "[] is too short");
+    }
     // Invalid: test devices with no id.
     {
         json configFile = validConfigFile;
@@ -2599,6 +2659,141 @@ TEST(ValidateRegulatorsConfigTest, PmbusReadSensor)
     }
 }
 
+TEST(ValidateRegulatorsConfigTest, PmbusReadBlockSensors)
+{
+    json pmbusReadBlockSensorsFile = validConfigFile;
+    pmbusReadBlockSensorsFile["rules"][0]["actions"][1]
+                             ["pmbus_read_block_sensors"] = R"(
+            {
+              "command": "0xD8",
+              "sensors": [
+                { "type": "vout", "offset": 0, "format": "linear_16" },
+                { "type": "pout", "offset": 2, "format": "raw", "size": 1,
+                  "scale": 0.5 }
+              ],
+              "exponent": -8
+            }
+        )"_json;
+    // Valid: test pmbus_read_block_sensors.
+    {
+        json configFile = pmbusReadBlockSensorsFile;
+        EXPECT_JSON_VALID(configFile);
+    }
+    // Valid: test pmbus_read_block_sensors with required properties.
+    {
+        json configFile = pmbusReadBlockSensorsFile;
+        configFile["rules"][0]["actions"][1]["pmbus_read_block_sensors"].erase(
+            "exponent");
+        EXPECT_JSON_VALID(configFile);
+    }
+    // Invalid: test pmbus_read_block_sensors with no command.
+    {
+        json configFile = pmbusReadBlockSensorsFile;
+        configFile["rules"][0]["actions"][1]["pmbus_read_block_sensors"].erase(
+            "command");
+        EXPECT_JSON_INVALID(configFile, "Validation failed.",
+                            "'command' is a required property");
+    }
+    // Invalid: test pmbus_read_block_sensors with empty sensors array.
+    {
+        json configFile = pmbusReadBlockSensorsFile;
+        configFile["rules"][0]["actions"][1]["pmbus_read_block_sensors"]
+                  ["sensors"] = json::array();
+        EXPECT_JSON_INVALID(configFile, "Validation failed.",
+                            "[] is too short");
+    }
+    // Invalid: test pmbus_read_block_sensors with scale for linear sensor.
+    {
+        json configFile = pmbusReadBlockSensorsFile;
+        configFile["rules"][0]["actions"][1]["pmbus_read_block_sensors"]
+                  ["sensors"][0]["scale"] = 2;
+        EXPECT_JSON_INVALID(configFile, "Validation failed.",
+                            "{'format': 'linear_16', 'offset': 0, 'scale': 2, "
+                            "'type': 'vout'} is not valid under any of the "
+                            "given schemas");
+    }
+    // Invalid: test pmbus_read_block_sensors with offset out of range.
+    {
+        json configFile = pmbusReadBlockSensorsFile;
+        configFile["rules"][0]["actions"][1]["pmbus_read_block_sensors"]
+                  ["sensors"][0]["offset"] = 32;
+        EXPECT_JSON_INVALID(configFile, "Validation failed.",
+                            "{'format': 'linear_16', 'offset': 32, 'type': "
+                            "'vout'} is not valid under any of the given "
+                            "schemas");
+    }
+}
+
+TEST(ValidateRegulatorsConfigTest, PmbusReadSensors)
+{
+    json pmbusReadSensorsFile = validConfigFile;
+    pmbusReadSensorsFile["rules"][0]["actions"][1]["pmbus_read_sensors"] =
+        R"(
+            {
+              "sensors": [
+                { "type": "vout", "command": "0x8B", "format": "linear_16" },
+                { "type": "iout", "command": "0x8C", "format": "linear_11" }
+              ],
+              "page": "0x01",
+              "exponent": -8
+            }
+        )"_json;
+    // Valid: test pmbus_read_sensors.
+    {
+        json configFile = pmbusReadSensorsFile;
+        EXPECT_JSON_VALID(configFile);
+    }
+    // Valid: test pmbus_read_sensors with required properties.
+    {
+        json configFile = pmbusReadSensorsFile;
+        configFile["rules"][0]["actions"][1]["pmbus_read_sensors"].erase(
+            "page");
+        configFile["rules"][0]["actions"][1]["pmbus_read_sensors"].erase(
+            "exponent");
+        EXPECT_JSON_VALID(configFile);
+    }
+    // Invalid: test pmbus_read_sensors with no sensors.
+    {
+        json configFile = pmbusReadSensorsFile;
+        configFile["rules"][0]["actions"][1]["pmbus_read_sensors"].erase(
+            "sensors");
+        EXPECT_JSON_INVALID(configFile, "Validation failed.",
+                            "'sensors' is a required property");
+    }
+    // Invalid: test pmbus_read_sensors with empty sensors array.
+    {
+        json configFile = pmbusReadSensorsFile;
+        configFile["rules"][0]["actions"][1]["pmbus_read_sensors"]["sensors"] =
+            json::array();
+        EXPECT_JSON_INVALID(configFile, "Validation failed.",
+                            "[] is too short");
+    }
+    // Invalid: test pmbus_read_sensors with sensor that has no format.
+    {
+        json configFile = pmbusReadSensorsFile;
+        configFile["rules"][0]["actions"][1]["pmbus_read_sensors"]["sensors"][0]
+            .erase("format");
+        EXPECT_JSON_INVALID(configFile, "Validation failed.",
+                            "'format' is a required property");
+    }
+    // Invalid: test pmbus_read_sensors with property page wrong format.
+    {
+        json configFile = pmbusReadSensorsFile;
+        configFile["rules"][0]["actions"][1]["pmbus_read_sensors"]["page"] =
+            "0x100";
+        EXPECT_JSON_INVALID(configFile, "Validation failed.",
+                            "'0x100' does not match '^0x[0-9a-fA-F]{2}$'");
+    }
+    // Invalid: test pmbus_read_sensors with property exponent wrong type.
+    {
+        json configFile = pmbusReadSensorsFile;
+        configFile["rules"][0]["actions"][1]["pmbus_read_sensors"]["exponent"] =
+            true;
+        EXPECT_JSON_INVALID(configFile, "Validation failed.",
+                            "True is not of type 'integer'");
+    }
+}
+
 TEST(ValidateRegulatorsConfigTest, PmbusWriteVoutCommand)
 {
     json pmbusWriteVoutCommandFile = validConfigFile;
@@ -2677,6 +2872,83 @@ TEST(ValidateRegulatorsConfigTest, PmbusWriteVoutCommand)
     }
 }
 
+TEST(ValidateRegulatorsConfigTest, PowerDomain)
+{
+    json powerDomainFile = validConfigFile;
+    powerDomainFile["chassis"][0]["devices"][0]["power_domain"]["comments"][0] =
+        "Regulator is powered by the CPU 0 standby rails";
+    powerDomainFile["chassis"][0]["devices"][0]["power_domain"]["name"] =
+        "cpu0";
+    powerDomainFile["chassis"][0]["devices"][0]["power_domain"]
+                   ["sequencer_rails"] = {4, 5};
+    // Valid: test power_domain with all properties.
+    {
+        json configFile = powerDomainFile;
+        EXPECT_JSON_VALID(configFile);
+    }
+    // Valid: test power_domain with only required properties.
+    {
+        json configFile = powerDomainFile;
+        configFile["chassis"][0]["devices"][0]["power_domain"].erase(
+            "comments");
+        EXPECT_JSON_VALID(configFile);
+    }
+    // Invalid: test power_domain with no name.
+    {
+        json configFile = powerDomainFile;
+        configFile["chassis"][0]["devices"][0]["power_domain"].erase("name");
+        EXPECT_JSON_INVALID(configFile, "Validation failed.",
+                            "'name' is a required property");
+    }
+    // Invalid: test power_domain with no sequencer_rails.
+    {
+        json configFile = powerDomainFile;
+        configFile["chassis"][0]["devices"][0]["power_domain"].erase(
+            "sequencer_rails");
+        EXPECT_JSON_INVALID(configFile, "Validation failed.",
+                            "'sequencer_rails' is a required property");
+    }
+    // Invalid: test power_domain with property name empty string.
+    {
+        json configFile = powerDomainFile;
+        configFile["chassis"][0]["devices"][0]["power_domain"]["name"] = "";
+        EXPECT_JSON_INVALID(configFile, "Validation failed.",
+                            "'' is too short");
+    }
+    // Invalid: test power_domain with property sequencer_rails empty array.
+    {
+        json configFile = powerDomainFile;
+        configFile["chassis"][0]["devices"][0]["power_domain"]
+                  ["sequencer_rails"] = json::array();
+        EXPECT_JSON_INVALID(configFile, "Validation failed.",
+                            "[] is too short");
+    }
+    // Invalid: test power_domain with property sequencer_rails wrong type.
+    {
+        json configFile = powerDomainFile;
+        configFile["chassis"][0]["devices"][0]["power_domain"]
+                  ["sequencer_rails"][0] = "4";
+        EXPECT_JSON_INVALID(configFile, "Validation failed.",
+                            "'4' is not of type 'integer'");
+    }
+    // Invalid: test power_domain with property sequencer_rails less than 0.
+    {
+        json configFile = powerDomainFile;
+        configFile["chassis"][0]["devices"][0]["power_domain"]
+                  ["sequencer_rails"][0] = -1;
+        EXPECT_JSON_INVALID(configFile, "Validation failed.",
+                            "-1 is less than the minimum of 0");
+    }
+    // Invalid: test power_domain with invalid property.
+    {
+        json configFile = powerDomainFile;
+        configFile["chassis"][0]["devices"][0]["power_domain"]["foo"] = true;
+        EXPECT_JSON_INVALID(
+            configFile, "Validation failed.",
+            "Additional properties are not allowed ('foo' was unexpected)");
+    }
+}
+
 TEST(ValidateRegulatorsConfigTest, PresenceDetection)
 {
     json presenceDetectionFile = validConfigFile;
@@ -3053,6 +3325,63 @@ TEST(ValidateRegulatorsConfigTest, SensorMonitoring)
         EXPECT_JSON_INVALID(configFile, "Validation failed.",
                             "[] is too short");
     }
+    // Valid: test rails sensor_monitoring with property sampling_groups.
+    {
+        json configFile = validConfigFile;
+        configFile["chassis"][0]["devices"][0]["rails"][0]["sensor_monitoring"]
+                  ["sampling_groups"][0]["divisor"] = 10;
+        configFile["chassis"][0]["devices"][0]["rails"][0]["sensor_monitoring"]
+                  ["sampling_groups"][0]["rule_id"] = "read_sensors_rule";
+        EXPECT_JSON_VALID(configFile);
+    }
+    // Invalid: test rails sensor_monitoring with property sampling_groups
+    // empty array.
+    {
+        json configFile = validConfigFile;
+        configFile["chassis"][0]["devices"][0]["rails"][0]["sensor_monitoring"]
+                  ["sampling_groups"] = json::array();
+        EXPECT_JSON_INVALID(configFile, "Validation failed.",
+                            "[] is too short");
+    }
+    // Invalid: test rails sensor_monitoring with sampling group divisor
+    // below the minimum.
+    {
+        json configFile = validConfigFile;
+        configFile["chassis"][0]["devices"][0]["rails"][0]["sensor_monitoring"]
+                  ["sampling_groups"][0]["divisor"] = 0;
+        configFile["chassis"][0]["devices"][0]["rails"][0]["sensor_monitoring"]
+                  ["sampling_groups"][0]["rule_id"] = "read_sensors_rule";
+        EXPECT_JSON_INVALID(configFile, "Validation failed.",
+                            "0 is less than the minimum of 1");
+    }
+    // Invalid: test rails sensor_monitoring with sampling group divisor
+    // missing.
+    {
+        json configFile = validConfigFile;
+        configFile["chassis"][0]["devices"][0]["rails"][0]["sensor_monitoring"]
+                  ["sampling_groups"][0]["rule_id"] = "read_sensors_rule";
+        EXPECT_JSON_INVALID(configFile, "Validation failed.",
+                            "'divisor' is a required property");
+    }
+    // Valid: test rails sensor_monitoring with property enable_detection.
+    {
+        json configFile = validConfigFile;
+        configFile["chassis"][0]["devices"][0]["rails"][0]["sensor_monitoring"]
+                  ["enable_detection"]["rule_id"] = "read_sensors_rule";
+        EXPECT_JSON_VALID(configFile);
+    }
+    // Invalid: test rails sensor_monitoring with enable_detection that has
+    // an invalid property.
+    {
+        json configFile = validConfigFile;
+        configFile["chassis"][0]["devices"][0]["rails"][0]["sensor_monitoring"]
+                  ["enable_detection"]["rule_id"] = "read_sensors_rule";
+        configFile["chassis"][0]["devices"][0]["rails"][0]["sensor_monitoring"]
+                  ["enable_detection"]["foo"] = true;
+        EXPECT_JSON_INVALID(
+            configFile, "Validation failed.",
+            "Additional properties are not allowed ('foo' was unexpected)");
+    }
 }
 
 TEST(ValidateRegulatorsConfigTest, SetDevice)
@@ -3261,6 +3590,50 @@ TEST(ValidateRegulatorsConfigTest, DeviceIDExists)
     }
 }
 
+TEST(ValidateRegulatorsConfigTest, DependsOnValueExists)
+{
+    // Invalid: test depends_on property specifies a device ID that does not
+    // exist.
+    {
+        json configFile = validConfigFile;
+        configFile["chassis"][0]["devices"][0]["depends_on"][0] =
+            "vdd_regulator2";
+        EXPECT_JSON_INVALID(configFile, "Error: Device ID does not exist.", "");
+    }
+}
+
+TEST(ValidateRegulatorsConfigTest, IndependentMonitoringBuses)
+{
+    json configFile = validConfigFile;
+    configFile["chassis"][1]["number"] = 2;
+    configFile["chassis"][1]["inventory_path"] = "system/chassis2";
+    configFile["chassis"][1]["devices"][0] =
+        configFile["chassis"][0]["devices"][0];
+    configFile["chassis"][1]["devices"][0]["id"] = "vdd_regulator2";
+    configFile["chassis"][1]["devices"][0]["fru"] =
+        "system/chassis2/motherboard/regulator1";
+    configFile["chassis"][1]["devices"][0].erase("rails");
+
+    // Valid: test chassis sharing an I2C bus without independent monitoring.
+    {
+        EXPECT_JSON_VALID(configFile);
+    }
+    // Valid: test chassis with independent monitoring on its own I2C bus.
+    {
+        configFile["chassis"][0]["independent_monitoring"] = true;
+        configFile["chassis"][1]["devices"][0]["i2c_interface"]["bus"] = 2;
+        EXPECT_JSON_VALID(configFile);
+    }
+    // Invalid: test chassis with independent monitoring sharing an I2C bus.
+    {
+        configFile["chassis"][1]["devices"][0]["i2c_interface"]["bus"] = 1;
+        EXPECT_JSON_INVALID(configFile,
+                            "Error: Chassis with independent monitoring "
+                            "shares I2C bus.",
+                            "");
+    }
+}
+
 TEST(ValidateRegulatorsConfigTest, NumberOfElementsInMasks)
 {
     // Invalid: test number of elements in masks not equal to number in values
@@ -0,0 +1,196 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "device.hpp"
+#include "i2c_interface.hpp"
+#include "mocked_i2c_interface.hpp"
+#include "pmbus_error.hpp"
+#include "voltage_setpoint.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+using namespace phosphor::power::regulators;
+
+using ::testing::A;
+using ::testing::Return;
+using ::testing::SetArgReferee;
+using ::testing::Throw;
+using ::testing::TypedEq;
+
+static const std::string deviceInvPath{
+    "/xyz/openbmc_project/inventory/system/chassis/motherboard/reg1"};
+
+TEST(VoltageSetpointTests, Constructor)
+{
+    // Test where only required parameters are specified
+    {
+        VoltageSetpoint setpoint{0.7, 1.2};
+        EXPECT_EQ(setpoint.getMinimum(), 0.7);
+        EXPECT_EQ(setpoint.getMaximum(), 1.2);
+        EXPECT_FALSE(setpoint.getPage().has_value());
+        EXPECT_FALSE(setpoint.getExponent().has_value());
+    }
+
+    // Test where all parameters are specified
+    {
+        VoltageSetpoint setpoint{0.7, 1.2, 0x01, -8};
+        EXPECT_EQ(setpoint.getMinimum(), 0.7);
+        EXPECT_EQ(setpoint.getMaximum(), 1.2);
+        EXPECT_EQ(setpoint.getPage(), 0x01);
+        EXPECT_EQ(setpoint.getExponent(), -8);
+    }
+}
+
+TEST(VoltageSetpointTests, IsInRange)
+{
+    VoltageSetpoint setpoint{0.7, 1.2};
+    EXPECT_TRUE(setpoint.isInRange(0.7));
+    EXPECT_TRUE(setpoint.isInRange(1.0));
+    EXPECT_TRUE(setpoint.isInRange(1.2));
+    EXPECT_FALSE(setpoint.isInRange(0.69));
+    EXPECT_FALSE(setpoint.isInRange(1.21));
+}
+
+TEST(VoltageSetpointTests, Set)
+{
+    // Test where volts value is outside the limits.  Device is not accessed.
+    {
+        auto i2cInterface = std::make_unique<i2c::MockedI2CInterface>();
+        EXPECT_CALL(*i2cInterface, open).Times(0);
+        EXPECT_CALL(*i2cInterface, write(A<uint8_t>(), A<uint16_t>()))
+            .Times(0);
+        Device device{"reg1", true, deviceInvPath, std::move(i2cInterface)};
+
+        VoltageSetpoint setpoint{0.7, 1.2, std::nullopt, -8};
+        EXPECT_THROW(setpoint.set(device, 1.3), std::invalid_argument);
+        EXPECT_THROW(setpoint.set(device, 0.6), std::invalid_argument);
+    }
+
+    // Test where page is selected and exponent is read from VOUT_MODE once.
+    // I2C interface is opened the first time.
+    {
+        auto i2cInterface = std::make_unique<i2c::MockedI2CInterface>();
+        EXPECT_CALL(*i2cInterface, isOpen)
+            .WillOnce(Return(false))
+            .WillRepeatedly(Return(true));
+        EXPECT_CALL(*i2cInterface, open).Times(1);
+        EXPECT_CALL(*i2cInterface,
+                    write(TypedEq<uint8_t>(0x00), TypedEq<uint8_t>(0x01)))
+            .Times(1);
+        EXPECT_CALL(*i2cInterface, read(TypedEq<uint8_t>(0x20), A<uint8_t&>()))
+            .Times(1)
+            .WillOnce(SetArgReferee<1>(0b0001'1000));
+        EXPECT_CALL(*i2cInterface,
+                    write(TypedEq<uint8_t>(0x21), TypedEq<uint16_t>(0x0100)))
+            .Times(1);
+        EXPECT_CALL(*i2cInterface,
+                    write(TypedEq<uint8_t>(0x21), TypedEq<uint16_t>(0x00E6)))
+            .Times(1);
+        Device device{"reg1", true, deviceInvPath, std::move(i2cInterface)};
+
+        VoltageSetpoint setpoint{0.7, 1.2, 0x01};
+        setpoint.set(device, 1.0);
+        EXPECT_EQ(device.getCurrentPage(), 0x01);
+        setpoint.set(device, 0.9);
+    }
+
+    // Test where cached exponent is cleared
+    {
+        auto i2cInterface = std::make_unique<i2c::MockedI2CInterface>();
+        EXPECT_CALL(*i2cInterface, isOpen).WillRepeatedly(Return(true));
+        EXPECT_CALL(*i2cInterface, read(TypedEq<uint8_t>(0x20), A<uint8_t&>()))
+            .Times(2)
+            .WillRepeatedly(SetArgReferee<1>(0b0001'1000));
+        EXPECT_CALL(*i2cInterface,
+                    write(TypedEq<uint8_t>(0x21), TypedEq<uint16_t>(0x0100)))
+            .Times(2);
+        Device device{"reg1", true, deviceInvPath, std::move(i2cInterface)};
+
+        VoltageSetpoint setpoint{0.7, 1.2};
+        setpoint.set(device, 1.0);
+        setpoint.clearCache();
+        device.clearCache();
+        setpoint.set(device, 1.0);
+    }
+
+    // Test where exponent is specified.  VOUT_MODE is not read.
+    {
+        auto i2cInterface = std::make_unique<i2c::MockedI2CInterface>();
+        EXPECT_CALL(*i2cInterface, isOpen).WillRepeatedly(Return(true));
+        EXPECT_CALL(*i2cInterface, read(A<uint8_t>(), A<uint8_t&>()))
+            .Times(0);
+        EXPECT_CALL(*i2cInterface,
+                    write(TypedEq<uint8_t>(0x21), TypedEq<uint16_t>(0x0200)))
+            .Times(1);
+        Device device{"reg1", true, deviceInvPath, std::move(i2cInterface)};
+
+        VoltageSetpoint setpoint{0.7, 1.2, std::nullopt, -9};
+        setpoint.set(device, 1.0);
+    }
+
+    // Test where VOUT_MODE contains an unsupported data format
+    {
+        auto i2cInterface = std::make_unique<i2c::MockedI2CInterface>();
+        EXPECT_CALL(*i2cInterface, isOpen).WillRepeatedly(Return(true));
+        EXPECT_CALL(*i2cInterface, read(TypedEq<uint8_t>(0x20), A<uint8_t&>()))
+            .Times(1)
+            .WillOnce(SetArgReferee<1>(0b0010'0000));
+        EXPECT_CALL(*i2cInterface, write(A<uint8_t>(), A<uint16_t>()))
+            .Times(0);
+        Device device{"reg1", true, deviceInvPath, std::move(i2cInterface)};
+
+        VoltageSetpoint setpoint{0.7, 1.2};
+        try
+        {
+            setpoint.set(device, 1.0);
+            ADD_FAILURE() << "Should not have reached this line.";
+        }
+        catch (const PMBusError& e)
+        {
+            EXPECT_STREQ(e.what(),
+                         "PMBusError: VOUT_MODE contains unsupported data "
+                         "format");
+            EXPECT_EQ(e.getDeviceID(), "reg1");
+            EXPECT_EQ(e.getInventoryPath(), deviceInvPath);
+        }
+    }
+
+    // Test where writing PAGE fails.  Page is unknown.
+    {
+        auto i2cInterface = std::make_unique<i2c::MockedI2CInterface>();
+        EXPECT_CALL(*i2cInterface, isOpen).WillRepeatedly(Return(true));
+        EXPECT_CALL(*i2cInterface,
+                    write(TypedEq<uint8_t>(0x00), TypedEq<uint8_t>(0x02)))
+            .Times(1)
+            .WillOnce(Throw(i2c::I2CException{"Failed to write byte",
+                                              "/dev/i2c-1", 0x70}));
+        EXPECT_CALL(*i2cInterface, write(A<uint8_t>(), A<uint16_t>()))
+            .Times(0);
+        Device device{"reg1", true, deviceInvPath, std::move(i2cInterface)};
+        device.pageSelected(0x00);
+
+        VoltageSetpoint setpoint{0.7, 1.2, 0x02, -8};
+        EXPECT_THROW(setpoint.set(device, 1.0), i2c::I2CException);
+        EXPECT_FALSE(device.getCurrentPage().has_value());
+    }
+}
@@ -0,0 +1,209 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "mock_journal.hpp"
+#include "mock_presence_service.hpp"
+#include "mock_sensors.hpp"
+#include "mock_services.hpp"
+#include "mock_vpd.hpp"
+#include "sensors.hpp"
+#include "worker_services.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <optional>
+#include <shared_mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+using namespace phosphor::power::regulators;
+using namespace std::chrono_literals;
+
+using ::testing::An;
+using ::testing::InSequence;
+using ::testing::Return;
+
+TEST(LockedPresenceServiceTests, IsPresent)
+{
+    // Test where the presence value is cached
+    {
+        MockPresenceService presenceService{};
+        EXPECT_CALL(presenceService,
+                    getCachedPresence("/xyz/openbmc_project/inventory/cpu0"))
+            .Times(1)
+            .WillOnce(Return(std::optional<bool>{true}));
+        EXPECT_CALL(presenceService, isPresent).Times(0);
+
+        std::shared_mutex mutex{};
+        LockedPresenceService locked{presenceService, mutex};
+        EXPECT_TRUE(locked.isPresent("/xyz/openbmc_project/inventory/cpu0"));
+    }
+
+    // Test where the presence value is not cached
+    {
+        MockPresenceService presenceService{};
+        EXPECT_CALL(presenceService,
+                    getCachedPresence("/xyz/openbmc_project/inventory/cpu0"))
+            .Times(1)
+            .WillOnce(Return(std::nullopt));
+        EXPECT_CALL(presenceService,
+                    isPresent("/xyz/openbmc_project/inventory/cpu0"))
+            .Times(1)
+            .WillOnce(Return(false));
+
+        std::shared_mutex mutex{};
+        LockedPresenceService locked{presenceService, mutex};
+        EXPECT_FALSE(locked.isPresent("/xyz/openbmc_project/inventory/cpu0"));
+    }
+
+    // Test where the presence value is not cached and only cached values are
+    // used
+    {
+        MockPresenceService presenceService{};
+        EXPECT_CALL(presenceService,
+                    getCachedPresence("/xyz/openbmc_project/inventory/cpu0"))
+            .Times(1)
+            .WillOnce(Return(std::nullopt));
+        EXPECT_CALL(presenceService, isPresent).Times(0);
+
+        std::shared_mutex mutex{};
+        LockedPresenceService locked{presenceService, mutex, true};
+        EXPECT_THROW(locked.isPresent("/xyz/openbmc_project/inventory/cpu0"),
+                     std::runtime_error);
+    }
+
+    // Test where a cached value is read while another worker holds the lock
+    // to read a cached value
+    {
+        MockPresenceService presenceService{};
+        EXPECT_CALL(presenceService, getCachedPresence)
+            .WillRepeatedly(Return(std::optional<bool>{true}));
+        EXPECT_CALL(presenceService, isPresent).Times(0);
+
+        std::shared_mutex mutex{};
+        LockedPresenceService locked{presenceService, mutex};
+        std::shared_lock<std::shared_mutex> lock{mutex};
+        auto result = std::async(std::launch::async, [&locked]() {
+            return locked.isPresent("/xyz/openbmc_project/inventory/cpu0");
+        });
+        ASSERT_EQ(result.wait_for(10s), std::future_status::ready);
+        EXPECT_TRUE(result.get());
+    }
+}
+
+TEST(LockedVPDTests, GetValue)
+{
+    // Test where the keyword value is cached
+    {
+        MockVPD vpd{};
+        EXPECT_CALL(vpd, getCachedValue("/xyz/openbmc_project/inventory/cpu0",
+                                        "CCIN"))
+            .Times(1)
+            .WillOnce(Return(
+                std::optional<std::vector<uint8_t>>{{0x31, 0x32, 0x33}}));
+        EXPECT_CALL(vpd, getValue).Times(0);
+
+        std::shared_mutex mutex{};
+        LockedVPD locked{vpd, mutex};
+        EXPECT_EQ(locked.getValue("/xyz/openbmc_project/inventory/cpu0",
+                                  "CCIN"),
+                  (std::vector<uint8_t>{0x31, 0x32, 0x33}));
+    }
+
+    // Test where the keyword value is not cached
+    {
+        MockVPD vpd{};
+        EXPECT_CALL(vpd, getCachedValue("/xyz/openbmc_project/inventory/cpu0",
+                                        "CCIN"))
+            .Times(1)
+            .WillOnce(Return(std::nullopt));
+        EXPECT_CALL(vpd,
+                    getValue("/xyz/openbmc_project/inventory/cpu0", "CCIN"))
+            .Times(1)
+            .WillOnce(Return(std::vector<uint8_t>{0x34}));
+
+        std::shared_mutex mutex{};
+        LockedVPD locked{vpd, mutex};
+        EXPECT_EQ(locked.getValue("/xyz/openbmc_project/inventory/cpu0",
+                                  "CCIN"),
+                  (std::vector<uint8_t>{0x34}));
+    }
+
+    // Test where the keyword value is not cached and only cached values are
+    // used
+    {
+        MockVPD vpd{};
+        EXPECT_CALL(vpd, getCachedValue("/xyz/openbmc_project/inventory/cpu0",
+                                        "CCIN"))
+            .Times(1)
+            .WillOnce(Return(std::nullopt));
+        EXPECT_CALL(vpd, getValue).Times(0);
+
+        std::shared_mutex mutex{};
+        LockedVPD locked{vpd, mutex, true};
+        EXPECT_THROW(
+            locked.getValue("/xyz/openbmc_project/inventory/cpu0", "CCIN"),
+            std::runtime_error);
+    }
+}
+
+TEST(WorkerServicesTests, Replay)
+{
+    MockServices services{};
+    MockSensors& sensors = services.getMockSensors();
+    MockJournal& journal = services.getMockJournal();
+
+    // Test where the calls are made on another thread.  They are recorded and
+    // not made to the real services.
+    EXPECT_CALL(sensors, startRail).Times(0);
+    EXPECT_CALL(sensors, setValue).Times(0);
+    EXPECT_CALL(sensors, endRail).Times(0);
+    EXPECT_CALL(journal, logInfo(An<const std::string&>())).Times(0);
+
+    std::shared_mutex mutex{};
+    WorkerServices worker{services, mutex};
+    auto result = std::async(std::launch::async, [&worker]() {
+        Sensors& workerSensors = worker.getSensors();
+        workerSensors.startRail("vdd0", "/xyz/openbmc_project/inventory/reg0",
+                                "/xyz/openbmc_project/inventory/chassis");
+        workerSensors.setValue(SensorType::vout, 1.1);
+        workerSensors.endRail(false);
+        worker.getJournal().logInfo("Rail vdd0 read");
+    });
+    result.get();
+    ::testing::Mock::VerifyAndClearExpectations(&sensors);
+    ::testing::Mock::VerifyAndClearExpectations(&journal);
+
+    // Test where the recorded calls are replayed in order on this thread
+    {
+        InSequence seq;
+        EXPECT_CALL(sensors,
+                    startRail("vdd0", "/xyz/openbmc_project/inventory/reg0",
+                              "/xyz/openbmc_project/inventory/chassis"))
+            .Times(1);
+        EXPECT_CALL(sensors, setValue(SensorType::vout, 1.1)).Times(1);
+        EXPECT_CALL(sensors, endRail(false)).Times(1);
+        EXPECT_CALL(journal, logInfo("Rail vdd0 read")).Times(1);
+    }
+    worker.replay();
+
+    // Test where the calls are only replayed once
+    worker.replay();
+}
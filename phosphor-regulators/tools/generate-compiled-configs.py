@@ -0,0 +1,174 @@
+#!/usr/bin/env python3
+
+import argparse
+import json
+import os
+import struct
+import subprocess
+import sys
+
+r"""
+Generates a C++ source file containing phosphor-regulators configuration files
+that are compiled into the binary.
+
+Each configuration file is validated and converted to a constexpr table
+containing the tree of JSON elements in CBOR format.  This is the same format
+as the binary cache file, so the configuration file parser can create the
+C++ objects without reading or parsing the JSON text at runtime.
+"""
+
+def encode_head(major_type, value):
+    r"""
+    Encodes the initial bytes of a CBOR data item.
+    major_type: CBOR major type.
+    value: argument of the data item, such as an integer or a length.
+    """
+
+    if value < 24:
+        return bytes([(major_type << 5) | value])
+    elif value < 0x100:
+        return bytes([(major_type << 5) | 24]) + struct.pack('>B', value)
+    elif value < 0x10000:
+        return bytes([(major_type << 5) | 25]) + struct.pack('>H', value)
+    elif value < 0x100000000:
+        return bytes([(major_type << 5) | 26]) + struct.pack('>I', value)
+    return bytes([(major_type << 5) | 27]) + struct.pack('>Q', value)
+
+def encode_cbor(element):
+    r"""
+    Encodes a JSON element in CBOR format.
+    element: JSON element from json.load().
+    """
+
+    if element is None:
+        return b'\xf6'
+    if element is True:
+        return b'\xf5'
+    if element is False:
+        return b'\xf4'
+    if isinstance(element, int):
+        if element >= 0:
+            return encode_head(0, element)
+        return encode_head(1, -1 - element)
+    if isinstance(element, float):
+        return b'\xfb' + struct.pack('>d', element)
+    if isinstance(element, str):
+        data = element.encode('utf-8')
+        return encode_head(3, len(data)) + data
+    if isinstance(element, list):
+        return encode_head(4, len(element)) + b''.join(
+            encode_cbor(item) for item in element)
+    if isinstance(element, dict):
+        return encode_head(5, len(element)) + b''.join(
+            encode_cbor(key) + encode_cbor(value)
+            for key, value in element.items())
+    sys.exit("Error: Unsupported JSON element type " + str(type(element)))
+
+def validate_config_file(schema_file, config_file):
+    r"""
+    Validates a configuration file using validate-regulators-config.py.
+    schema_file: The phosphor-regulators schema file.
+    config_file: The phosphor-regulators configuration file.
+    """
+
+    validator = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                             'validate-regulators-config.py')
+    result = subprocess.run([sys.executable, validator, '-s', schema_file,
+                             '-c', config_file])
+    if result.returncode != 0:
+        sys.exit("Error: Configuration file " + config_file + " is not valid.")
+
+def write_table(output, name, data):
+    r"""
+    Writes a constexpr byte table.
+    output: output file.
+    name: C++ variable name.
+    data: table contents.
+    """
+
+    output.write('constexpr uint8_t ' + name + '[] = {\n')
+    for offset in range(0, len(data), 12):
+        row = data[offset:offset + 12]
+        output.write('    ' + ', '.join('0x{:02x}'.format(b) for b in row) +
+                     ',\n')
+    output.write('};\n\n')
+
+def write_source_file(output, config_files):
+    r"""
+    Writes the C++ source file.
+    output: output file.
+    config_files: The phosphor-regulators configuration files.
+    """
+
+    output.write('// Generated by generate-compiled-configs.py; do not edit.\n'
+                 '\n'
+                 '#include "compiled_config.hpp"\n'
+                 '\n'
+                 '#include <array>\n'
+                 '#include <cstdint>\n'
+                 '#include <span>\n'
+                 '\n'
+                 'namespace phosphor::power::regulators::compiled_configs\n'
+                 '{\n'
+                 '\n'
+                 'namespace\n'
+                 '{\n'
+                 '\n')
+
+    entries = []
+    for index, config_file in enumerate(config_files):
+        with open(config_file) as json_data:
+            config_json = json.load(json_data)
+        name = 'config' + str(index)
+        output.write('// ' + os.path.basename(config_file) + '\n')
+        write_table(output, name, encode_cbor(config_json))
+        entries.append('    {"' + os.path.basename(config_file) + '", ' +
+                       name + ', sizeof(' + name + ')},\n')
+
+    output.write('constexpr std::array<CompiledConfig, ' +
+                 str(len(entries)) + '> configs{{\n')
+    output.write(''.join(entries))
+    output.write('}};\n'
+                 '\n'
+                 '} // namespace\n'
+                 '\n'
+                 'std::span<const CompiledConfig> getAll()\n'
+                 '{\n'
+                 '    return configs;\n'
+                 '}\n'
+                 '\n'
+                 '} // namespace '
+                 'phosphor::power::regulators::compiled_configs\n')
+
+if __name__ == '__main__':
+
+    parser = argparse.ArgumentParser(
+        description='phosphor-regulators compiled configuration file generator')
+
+    parser.add_argument('-s', '--schema-file', dest='schema_file',
+                        help='The phosphor-regulators schema file')
+
+    parser.add_argument('-o', '--output-file', dest='output_file',
+                        help='The C++ source file to generate')
+
+    parser.add_argument('configuration_files', nargs='*',
+                        help='The phosphor-regulators configuration files')
+
+    args = parser.parse_args()
+
+    if not args.output_file:
+        parser.print_help()
+        sys.exit("Error: Output file is required.")
+    if args.configuration_files and not args.schema_file:
+        parser.print_help()
+        sys.exit("Error: Schema file is required.")
+
+    names = [os.path.basename(f) for f in args.configuration_files]
+    if len(set(names)) != len(names):
+        sys.exit("Error: Configuration file names are not unique.")
+
+    for config_file in args.configuration_files:
+        validate_config_file(args.schema_file, config_file)
+
+    with open(args.output_file, 'w') as output:
+        write_source_file(output, args.configuration_files)
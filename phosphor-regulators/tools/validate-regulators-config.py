@@ -117,6 +117,46 @@ def check_device_id_exists(config_json):
             device_id+'\n')
             handle_validation_error()
 
+def check_depends_on_value_exists(config_json):
+    r"""
+    Check if a depends_on property specifies a device ID that does not exist
+    in the same chassis.
+    config_json: Configuration file JSON
+    """
+
+    for chassis in config_json.get('chassis', {}):
+        devices = chassis.get('devices', {})
+        valid_device_ids = [device['id'] for device in devices]
+        for device in devices:
+            for device_id in device.get('depends_on', []):
+                if device_id not in valid_device_ids:
+                    sys.stderr.write("Error: Device ID does not exist.\n"+\
+                    "Found depends_on value that specifies invalid device ID "+\
+                    device_id+'\n')
+                    handle_validation_error()
+
+def check_independent_monitoring_buses(config_json):
+    r"""
+    Check that a chassis with independent monitoring does not share an I2C bus
+    with another chassis.
+    config_json: Configuration file JSON
+    """
+
+    bus_chassis = {}
+    for chassis in config_json.get('chassis', {}):
+        for device in chassis.get('devices', {}):
+            bus = device['i2c_interface']['bus']
+            bus_chassis.setdefault(bus, []).append(chassis)
+    for bus, chassis_list in bus_chassis.items():
+        numbers = set(chassis['number'] for chassis in chassis_list)
+        if len(numbers) > 1 and \
+            any(chassis.get('independent_monitoring', False)
+                for chassis in chassis_list):
+            sys.stderr.write("Error: Chassis with independent monitoring "+\
+            "shares I2C bus.\n"+\
+            "Found multiple chassis using the I2C bus "+str(bus)+'\n')
+            handle_validation_error()
+
 def check_set_device_value_exists(config_json):
     r"""
     Check if a set_device action specifies a device ID that does not exist.
@@ -359,4 +399,8 @@ if __name__ == '__main__':
 
     check_device_id_exists(config_json)
 
+    check_depends_on_value_exists(config_json)
+
+    check_independent_monitoring_buses(config_json)
+
     check_number_of_elements_in_masks(config_json)
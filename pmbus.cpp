@@ -15,13 +15,24 @@
  */
 #include "pmbus.hpp"
 
+#include "hwmon_index.hpp"
+#include "trace.hpp"
+
 #include <phosphor-logging/elog-errors.hpp>
 #include <phosphor-logging/elog.hpp>
 #include <xyz/openbmc_project/Common/Device/error.hpp>
 #include <xyz/openbmc_project/Common/error.hpp>
 
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <charconv>
+#include <cstdlib>
 #include <filesystem>
 #include <fstream>
+#include <string_view>
+#include <system_error>
 
 namespace phosphor
 {
@@ -44,21 +55,85 @@ struct FileCloser
     }
 };
 
+/**
+ * @brief Parses a hexadecimal value from the contents of a sysfs file
+ *
+ * Leading whitespace and an optional "0x" prefix are skipped, and parsing
+ * stops at the first character that is not a hex digit.
+ *
+ * @param[in] contents - the file contents
+ * @param[out] value - the parsed value
+ *
+ * @return bool - true if a value was parsed, false otherwise
+ */
+static bool parseHex(std::string_view contents, uint64_t& value)
+{
+    auto start = contents.find_first_not_of(" \t\n\r\f\v");
+    if (start == std::string_view::npos)
+    {
+        return false;
+    }
+    contents.remove_prefix(start);
+
+    if ((contents.size() > 2) && (contents[0] == '0') &&
+        ((contents[1] == 'x') || (contents[1] == 'X')))
+    {
+        contents.remove_prefix(2);
+    }
+
+    auto [ptr, ec] = std::from_chars(contents.data(),
+                                     contents.data() + contents.size(), value,
+                                     16);
+    return (ec == std::errc{});
+}
+
+/**
+ * @brief Throws the ReadFailure for a file the device does not have
+ *
+ * The file is not accessed and the failure is not logged, since nothing is
+ * wrong with the device.
+ *
+ * @param[in] basePath - the sysfs device path
+ */
+static void throwUnsupported(const fs::path& basePath)
+{
+    using metadata = xyz::openbmc_project::Common::Device::ReadFailure;
+
+    elog<ReadFailure>(metadata::CALLOUT_ERRNO(ENOENT),
+                      metadata::CALLOUT_DEVICE_PATH(basePath.c_str()));
+}
+
 std::string PMBus::insertPageNum(const std::string& templateName, size_t page)
 {
-    auto name = templateName;
+    return getPagedName(templateName, page);
+}
+
+const std::string& PMBus::getPagedName(const std::string& templateName,
+                                       size_t page)
+{
+    auto& names = pagedNames[templateName];
+    if (page >= names.size())
+    {
+        names.resize(page + 1);
+    }
 
-    // insert the page where the P was
-    auto pos = name.find('P');
-    if (pos != std::string::npos)
+    auto& name = names[page];
+    if (name.empty())
     {
-        name.replace(pos, 1, std::to_string(page));
+        name = templateName;
+
+        // insert the page where the P was
+        auto pos = name.find('P');
+        if (pos != std::string::npos)
+        {
+            name.replace(pos, 1, std::to_string(page));
+        }
     }
 
     return name;
 }
 
-fs::path PMBus::getPath(Type type)
+const fs::path& PMBus::getPath(Type type)
 {
     switch (type)
     {
@@ -68,19 +143,26 @@ fs::path PMBus::getPath(Type type)
             return basePath;
             break;
         case Type::Hwmon:
-            return basePath / "hwmon" / hwmonDir;
+            return hwmonPath;
             break;
         case Type::Debug:
-            return debugPath / "pmbus" / hwmonDir;
+            return debugDirPath;
             break;
         case Type::DeviceDebug:
-        {
-            auto dir = driverName + "." + std::to_string(instance);
-            return debugPath / dir;
+            return deviceDebugPath;
             break;
-        }
         case Type::HwmonDeviceDebug:
-            return debugPath / "pmbus" / hwmonDir / getDeviceName();
+            if (hwmonDeviceDebugPath.empty())
+            {
+                // Only save the path once the device name can be read
+                auto name = getDeviceName();
+                if (name.empty())
+                {
+                    return debugDirPath;
+                }
+                hwmonDeviceDebugPath = debugDirPath / name;
+            }
+            return hwmonDeviceDebugPath;
             break;
     }
 }
@@ -111,17 +193,18 @@ std::string PMBus::getDeviceName()
 
 bool PMBus::readBitInPage(const std::string& name, size_t page, Type type)
 {
-    auto pagedBit = insertPageNum(name, page);
-    return readBit(pagedBit, type);
+    return readBit(getPagedName(name, page), type);
 }
 
 bool PMBus::readBit(const std::string& name, Type type)
 {
+    if (!isSupported(name, type))
+    {
+        throwUnsupported(basePath);
+    }
+
     unsigned long int value = 0;
     std::ifstream file;
-    fs::path path = getPath(type);
-
-    path /= name;
 
     file.exceptions(std::ifstream::failbit | std::ifstream::badbit |
                     std::ifstream::eofbit);
@@ -131,8 +214,18 @@ bool PMBus::readBit(const std::string& name, Type type)
         char* err = NULL;
         std::string val{1, '\0'};
 
-        file.open(path);
-        file.read(&val[0], 1);
+        if (fileCacheEnabled)
+        {
+            if (readFile(type, name, &val[0], 1) < 0)
+            {
+                throw std::system_error{errno, std::generic_category()};
+            }
+        }
+        else
+        {
+            file.open(getPath(type) / name);
+            file.read(&val[0], 1);
+        }
 
         value = strtoul(val.c_str(), &err, 10);
 
@@ -140,7 +233,8 @@ bool PMBus::readBit(const std::string& name, Type type)
         {
             log<level::ERR>((std::string("Invalid character in sysfs file"
                                          " FILE=") +
-                             path.string() + std::string(" CONTENTS=") + val)
+                             (getPath(type) / name).string() +
+                             std::string(" CONTENTS=") + val)
                                 .c_str());
 
             // Catch below and handle as a read failure
@@ -154,7 +248,7 @@ bool PMBus::readBit(const std::string& name, Type type)
         log<level::ERR>((std::string("Failed to read sysfs file "
                                      "errno=") +
                          std::to_string(rc) + std::string(" FILENAME=") +
-                         path.string())
+                         (getPath(type) / name).string())
                             .c_str());
 
         using metadata = xyz::openbmc_project::Common::Device::ReadFailure;
@@ -169,32 +263,118 @@ bool PMBus::readBit(const std::string& name, Type type)
 
 bool PMBus::exists(const std::string& name, Type type)
 {
+    if ((name.find('/') == std::string::npos) && getCapabilities(type))
+    {
+        return isSupported(name, type);
+    }
+
     auto path = getPath(type);
     path /= name;
     return fs::exists(path);
 }
 
-uint64_t PMBus::read(const std::string& name, Type type)
+bool PMBus::isSupported(const std::string& name, Type type)
 {
-    uint64_t data = 0;
-    std::ifstream file;
-    auto path = getPath(type);
-    path /= name;
+    // Only the files directly in the directory are discovered
+    if (name.find('/') != std::string::npos)
+    {
+        return true;
+    }
 
-    file.exceptions(std::ifstream::failbit | std::ifstream::badbit |
-                    std::ifstream::eofbit);
+    const auto* names = getCapabilities(type);
+    return !names || std::binary_search(names->begin(), names->end(), name);
+}
 
-    try
+bool PMBus::hasPage(size_t page)
+{
+    if (!getCapabilities(Type::Debug))
     {
-        file.open(path);
-        file >> std::hex >> data;
+        return true;
     }
-    catch (const std::exception& e)
+    return (page < 32) && (pages & (uint32_t{1} << page));
+}
+
+const std::vector<std::string>* PMBus::getCapabilities(Type type)
+{
+    auto& names = capabilities[static_cast<size_t>(type)];
+    if (names)
     {
-        auto rc = errno;
+        return &*names;
+    }
+
+    // The driver creates all of the files when it is bound, which is also
+    // when the hwmon directory appears
+    if (hwmonDir.empty())
+    {
+        return nullptr;
+    }
+
+    const auto& dir = getPath(type);
+    if ((type == Type::HwmonDeviceDebug) && hwmonDeviceDebugPath.empty())
+    {
+        return nullptr;
+    }
+
+    std::vector<std::string> found;
+    std::error_code ec;
+    fs::directory_iterator it{dir, ec};
+    for (; !ec && (it != fs::directory_iterator{}); it.increment(ec))
+    {
+        found.push_back(it->path().filename().string());
+    }
+    if (ec)
+    {
+        return nullptr;
+    }
+    std::sort(found.begin(), found.end());
+
+    if (type == Type::Debug)
+    {
+        // The pmbus core has a statusN file for each page
+        constexpr std::string_view prefix{"status"};
+        pages = 0;
+        for (const auto& name : found)
+        {
+            size_t page = 0;
+            const char* end = name.data() + name.size();
+            if ((name.size() > prefix.size()) &&
+                (name.compare(0, prefix.size(), prefix) == 0) &&
+                (std::from_chars(name.data() + prefix.size(), end, page).ptr ==
+                 end) &&
+                (page < 32))
+            {
+                pages |= uint32_t{1} << page;
+            }
+        }
+    }
+
+    names = std::move(found);
+    return &*names;
+}
+
+uint64_t PMBus::read(const std::string& name, Type type)
+{
+    POWER_TRACE_SCOPE("PMBus::read", basePath.string(), name);
+
+    if (!isSupported(name, type))
+    {
+        throwUnsupported(basePath);
+    }
+
+    uint64_t data = 0;
+
+    // Read into a stack buffer and parse without iostreams, since this is
+    // called for every status register on every poll.
+    char buffer[32];
+    auto bytes = readFile(type, name, buffer, sizeof(buffer));
+    if ((bytes < 0) ||
+        !parseHex(std::string_view{buffer, static_cast<size_t>(bytes)}, data))
+    {
+        auto rc = (bytes < 0) ? errno : EINVAL;
         log<level::ERR>((std::string("Failed to read sysfs file "
                                      "errno=") +
-                         std::to_string(rc) + " FILENAME=" + path.string())
+                         std::to_string(rc) +
+                         " FILENAME=" + (getPath(type) / name).string())
                             .c_str());
 
         using metadata = xyz::openbmc_project::Common::Device::ReadFailure;
@@ -207,27 +387,172 @@ uint64_t PMBus::read(const std::string& name, Type type)
     return data;
 }
 
+std::vector<fs::path> PMBus::getAlarmFiles()
+{
+    std::vector<fs::path> files;
+    const auto& dir = getPath(Type::Hwmon);
+
+    std::error_code ec;
+    if (hwmonDir.empty() || !fs::is_directory(dir, ec))
+    {
+        return files;
+    }
+
+    constexpr std::string_view suffix{"_alarm"};
+    for (const auto& entry : fs::directory_iterator(dir, ec))
+    {
+        const auto name = entry.path().filename().string();
+        if ((name.size() > suffix.size()) &&
+            (name.compare(name.size() - suffix.size(), suffix.size(),
+                          suffix) == 0))
+        {
+            files.push_back(entry.path());
+        }
+    }
+
+    return files;
+}
+
+StatusSnapshot PMBus::readStatusSnapshot(const std::vector<std::string>& names,
+                                         Type type)
+{
+    StatusSnapshot snapshot;
+    snapshot.timestamp = std::chrono::steady_clock::now();
+    snapshot.values.resize(names.size(), 0);
+    snapshot.valid.resize(names.size(), false);
+
+    for (size_t i = 0; i < names.size(); i++)
+    {
+        if (!isSupported(names[i], type))
+        {
+            continue;
+        }
+
+        char buffer[32];
+        auto bytes = readFile(type, names[i], buffer, sizeof(buffer));
+        if (bytes >= 0)
+        {
+            snapshot.valid[i] = parseHex(
+                std::string_view{buffer, static_cast<size_t>(bytes)},
+                snapshot.values[i]);
+        }
+    }
+
+    return snapshot;
+}
+
+bool PMBus::prepareSnapshot(const std::vector<std::string>& names, Type type,
+                            std::vector<int>& fds)
+{
+    if (!fileCacheEnabled)
+    {
+        return false;
+    }
+
+    fds.assign(names.size(), -1);
+    auto& cache = fileCache[static_cast<size_t>(type)];
+    for (size_t i = 0; i < names.size(); i++)
+    {
+        if (!isSupported(names[i], type))
+        {
+            continue;
+        }
+
+        auto it = cache.find(names[i]);
+        if (it == cache.end())
+        {
+            auto path = getPath(type) / names[i];
+            int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd == -1)
+            {
+                continue;
+            }
+            it = cache.emplace(names[i], fd).first;
+        }
+        fds[i] = it->second();
+    }
+
+    return true;
+}
+
+StatusSnapshot
+    PMBus::completeSnapshot(const std::vector<std::string>& names, Type type,
+                            std::span<const power::util::BatchRead> reads)
+{
+    StatusSnapshot snapshot;
+    snapshot.timestamp = std::chrono::steady_clock::now();
+    snapshot.values.resize(names.size(), 0);
+    snapshot.valid.resize(names.size(), false);
+
+    auto& cache = fileCache[static_cast<size_t>(type)];
+    for (size_t i = 0; (i < names.size()) && (i < reads.size()); i++)
+    {
+        if (reads[i].result > 0)
+        {
+            snapshot.valid[i] = parseHex(
+                std::string_view{reads[i].buffer.data(),
+                                 static_cast<size_t>(reads[i].result)},
+                snapshot.values[i]);
+        }
+        else if (reads[i].fd >= 0)
+        {
+            // The file may no longer be valid, such as when the device driver
+            // was unbound, so close it.  It will be re-opened on the next
+            // read.
+            cache.erase(names[i]);
+        }
+    }
+
+    return snapshot;
+}
+
 std::string PMBus::readString(const std::string& name, Type type)
 {
+    if (!isSupported(name, type))
+    {
+        throwUnsupported(basePath);
+    }
+
     std::string data;
     std::ifstream file;
-    auto path = getPath(type);
-    path /= name;
 
     file.exceptions(std::ifstream::failbit | std::ifstream::badbit |
                     std::ifstream::eofbit);
 
     try
     {
-        file.open(path);
-        file >> data;
+        if (fileCacheEnabled)
+        {
+            char buffer[4096];
+            auto bytes = readFile(type, name, buffer, sizeof(buffer));
+            if (bytes < 0)
+            {
+                throw std::system_error{errno, std::generic_category()};
+            }
+
+            // Extract the first whitespace-delimited word, like operator>>
+            std::string_view contents{buffer, static_cast<size_t>(bytes)};
+            auto start = contents.find_first_not_of(" \t\n\r\f\v");
+            if (start == std::string_view::npos)
+            {
+                throw std::runtime_error{"No data in file"};
+            }
+            contents.remove_prefix(start);
+            data = contents.substr(0, contents.find_first_of(" \t\n\r\f\v"));
+        }
+        else
+        {
+            file.open(getPath(type) / name);
+            file >> data;
+        }
     }
     catch (const std::exception& e)
     {
         auto rc = errno;
         log<level::ERR>((std::string("Failed to read sysfs file "
                                      "errno=") +
-                         std::to_string(rc) + " FILENAME=" + path.string())
+                         std::to_string(rc) +
+                         " FILENAME=" + (getPath(type) / name).string())
                             .c_str());
 
         using metadata = xyz::openbmc_project::Common::Device::ReadFailure;
@@ -240,72 +565,124 @@ std::string PMBus::readString(const std::string& name, Type type)
     return data;
 }
 
+ReadResult<uint64_t> PMBus::tryRead(const std::string& name, Type type)
+{
+    ReadResult<uint64_t> result;
+    if (!isSupported(name, type))
+    {
+        result.error = ENOENT;
+        return result;
+    }
+
+    char buffer[32];
+    auto bytes = readFile(type, name, buffer, sizeof(buffer));
+    if (bytes < 0)
+    {
+        result.error = errno;
+    }
+    else if (!parseHex(std::string_view{buffer, static_cast<size_t>(bytes)},
+                       result.value))
+    {
+        result.value = 0;
+        result.error = EINVAL;
+    }
+
+    return result;
+}
+
+ReadResult<std::string> PMBus::tryReadString(const std::string& name,
+                                             Type type)
+{
+    ReadResult<std::string> result;
+    if (!isSupported(name, type))
+    {
+        result.error = ENOENT;
+        return result;
+    }
+
+    char buffer[4096];
+    auto bytes = readFile(type, name, buffer, sizeof(buffer));
+    if (bytes < 0)
+    {
+        result.error = errno;
+        return result;
+    }
+
+    // Extract the first whitespace-delimited word, like readString()
+    std::string_view contents{buffer, static_cast<size_t>(bytes)};
+    auto start = contents.find_first_not_of(" \t\n\r\f\v");
+    if (start == std::string_view::npos)
+    {
+        result.error = ENODATA;
+        return result;
+    }
+    contents.remove_prefix(start);
+    result.value = contents.substr(0, contents.find_first_of(" \t\n\r\f\v"));
+
+    return result;
+}
+
 std::vector<uint8_t> PMBus::readBinary(const std::string& name, Type type,
                                        size_t length)
 {
+    std::vector<uint8_t> data(length, 0);
+    data.resize(readBinary(name, type, data));
+    return data;
+}
+
+size_t PMBus::readBinary(const std::string& name, Type type,
+                         std::span<uint8_t> buffer)
+{
+    if (!isSupported(name, type))
+    {
+        return 0;
+    }
+
     auto path = getPath(type) / name;
 
     // Use C style IO because it's easier to handle telling the difference
     // between hitting EOF or getting an actual error.
     std::unique_ptr<FILE, FileCloser> file{fopen(path.c_str(), "rb")};
 
-    if (file)
+    if (!file)
     {
-        std::vector<uint8_t> data(length, 0);
+        return 0;
+    }
 
-        auto bytes =
-            fread(data.data(), sizeof(decltype(data[0])), length, file.get());
+    auto bytes = fread(buffer.data(), sizeof(uint8_t), buffer.size(),
+                       file.get());
 
-        if (bytes != length)
-        {
-            // If hit EOF, just return the amount of data that was read.
-            if (feof(file.get()))
-            {
-                data.erase(data.begin() + bytes, data.end());
-            }
-            else if (ferror(file.get()))
-            {
-                auto rc = errno;
-                log<level::ERR>((std::string("Failed to read sysfs file "
-                                             "errno=") +
-                                 std::to_string(rc) +
-                                 " FILENAME=" + path.string())
-                                    .c_str());
-                using metadata =
-                    xyz::openbmc_project::Common::Device::ReadFailure;
-
-                elog<ReadFailure>(metadata::CALLOUT_ERRNO(rc),
-                                  metadata::CALLOUT_DEVICE_PATH(
-                                      fs::canonical(basePath).c_str()));
-            }
-        }
-        return data;
+    if ((bytes != buffer.size()) && !feof(file.get()) && ferror(file.get()))
+    {
+        auto rc = errno;
+        log<level::ERR>((std::string("Failed to read sysfs file "
+                                     "errno=") +
+                         std::to_string(rc) + " FILENAME=" + path.string())
+                            .c_str());
+        using metadata = xyz::openbmc_project::Common::Device::ReadFailure;
+
+        elog<ReadFailure>(
+            metadata::CALLOUT_ERRNO(rc),
+            metadata::CALLOUT_DEVICE_PATH(fs::canonical(basePath).c_str()));
     }
 
-    return std::vector<uint8_t>{};
+    // If hit EOF, the amount of data that was read is returned.
+    return bytes;
 }
 
 void PMBus::write(const std::string& name, int value, Type type)
 {
-    std::ofstream file;
-    fs::path path = getPath(type);
+    // Large enough for any int, including the sign
+    char buffer[16];
+    char* end = std::to_chars(buffer, buffer + sizeof(buffer), value).ptr;
 
-    path /= name;
-
-    file.exceptions(std::ofstream::failbit | std::ofstream::badbit |
-                    std::ofstream::eofbit);
-
-    try
-    {
-        file.open(path);
-        file << value;
-    }
-    catch (const std::exception& e)
+    if (writeFile(type, name, buffer, end - buffer) < 0)
     {
         auto rc = errno;
         log<level::ERR>((std::string("Failed to write sysfs file "
                                      "errno=") +
-                         std::to_string(rc) + " FILENAME=" + path.string())
+                         std::to_string(rc) +
+                         " FILENAME=" + (getPath(type) / name).string())
                             .c_str());
 
         using metadata = xyz::openbmc_project::Common::Device::WriteFailure;
@@ -316,28 +693,19 @@ void PMBus::write(const std::string& name, int value, Type type)
     }
 }
 
-void PMBus::writeBinary(const std::string& name, std::vector<uint8_t> data,
-                        Type type)
+void PMBus::writeBinary(const std::string& name,
+                        std::span<const uint8_t> data, Type type)
 {
-    std::ofstream file;
     fs::path path = getPath(type);
 
     path /= name;
 
-    file.exceptions(std::ofstream::failbit | std::ofstream::badbit |
-                    std::ofstream::eofbit);
+    log<level::DEBUG>(
+        std::string("Write data to sysfs file FILENAME=" + path.string())
+            .c_str());
 
-    try
-    {
-        // I need to specify binary mode when I construct the ofstream
-        file.open(path, std::ios::out | std::ios_base::binary);
-        log<level::DEBUG>(std::string("Write data to sysfs file "
-                                      "FILENAME=" +
-                                      path.string())
-                              .c_str());
-        file.write(reinterpret_cast<const char*>(&data[0]), data.size());
-    }
-    catch (const std::exception& e)
+    if (writeFile(type, name, reinterpret_cast<const char*>(data.data()),
+                  data.size()) < 0)
     {
         auto rc = errno;
         log<level::ERR>(
@@ -354,28 +722,152 @@ void PMBus::writeBinary(const std::string& name, std::vector<uint8_t> data,
     }
 }
 
-void PMBus::findHwmonDir()
+std::string PMBus::readCachedString(const std::string& name, Type type,
+                                    bool refresh)
+{
+    auto& cache = stringCache[static_cast<size_t>(type)];
+    if (!refresh)
+    {
+        auto it = cache.find(name);
+        if (it != cache.end())
+        {
+            return it->second;
+        }
+    }
+
+    // Throws if the read fails, so only values read are cached
+    std::string value = readString(name, type);
+    cache.insert_or_assign(name, value);
+    return value;
+}
+
+ssize_t PMBus::readFile(Type type, std::string_view name, char* buffer,
+                        size_t size)
+{
+    ssize_t bytes = -1;
+
+    if (fileCacheEnabled)
+    {
+        auto& cache = fileCache[static_cast<size_t>(type)];
+        auto it = cache.find(name);
+        if (it == cache.end())
+        {
+            auto path = getPath(type) / name;
+            int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd == -1)
+            {
+                return -1;
+            }
+            it = cache.emplace(name, fd).first;
+        }
+
+        bytes = pread(it->second(), buffer, size, 0);
+        if (bytes <= 0)
+        {
+            int rc = (bytes < 0) ? errno : ENODATA;
+
+            // The file may no longer be valid, such as when the device driver
+            // was unbound, so close it.  It will be re-opened on the next
+            // read.
+            cache.erase(it);
+
+            errno = rc;
+            return -1;
+        }
+    }
+    else
+    {
+        auto path = getPath(type) / name;
+        phosphor::power::util::FileDescriptor fd{
+            ::open(path.c_str(), O_RDONLY | O_CLOEXEC)};
+        if (!fd)
+        {
+            return -1;
+        }
+
+        bytes = ::read(fd(), buffer, size);
+        if (bytes <= 0)
+        {
+            int rc = (bytes < 0) ? errno : ENODATA;
+            fd.close();
+            errno = rc;
+            return -1;
+        }
+    }
+
+    return bytes;
+}
+
+ssize_t PMBus::writeFile(Type type, std::string_view name, const char* buffer,
+                         size_t size)
 {
-    fs::path path{basePath};
-    path /= "hwmon";
+    ssize_t bytes = -1;
 
-    // Make sure the directory exists, otherwise for things that can be
-    // dynamically present or not present an exception will be thrown if the
-    // hwmon directory is not there, resulting in a program termination.
-    if (fs::is_directory(path))
+    if (fileCacheEnabled)
     {
-        // look for <basePath>/hwmon/hwmonN/
-        for (auto& f : fs::directory_iterator(path))
+        auto& cache = writeFileCache[static_cast<size_t>(type)];
+        auto it = cache.find(name);
+        if (it == cache.end())
         {
-            if ((f.path().filename().string().find("hwmon") !=
-                 std::string::npos) &&
-                (fs::is_directory(f.path())))
+            auto path = getPath(type) / name;
+            int fd = ::open(path.c_str(), O_WRONLY | O_CLOEXEC);
+            if (fd == -1)
             {
-                hwmonDir = f.path().filename();
-                break;
+                return -1;
             }
+            it = cache.emplace(name, fd).first;
+        }
+
+        bytes = pwrite(it->second(), buffer, size, 0);
+        if (bytes != static_cast<ssize_t>(size))
+        {
+            int rc = (bytes < 0) ? errno : EIO;
+
+            // The file may no longer be valid, such as when the device driver
+            // was unbound, so close it.  It will be re-opened on the next
+            // write.
+            cache.erase(it);
+
+            errno = rc;
+            return -1;
         }
     }
+    else
+    {
+        auto path = getPath(type) / name;
+        phosphor::power::util::FileDescriptor fd{
+            ::open(path.c_str(), O_WRONLY | O_CLOEXEC)};
+        if (!fd)
+        {
+            return -1;
+        }
+
+        bytes = pwrite(fd(), buffer, size, 0);
+        if (bytes != static_cast<ssize_t>(size))
+        {
+            int rc = (bytes < 0) ? errno : EIO;
+            fd.close();
+            errno = rc;
+            return -1;
+        }
+    }
+
+    return bytes;
+}
+
+void PMBus::findHwmonDir()
+{
+    // Any cached files may be under a previous hwmon directory
+    clearFileCaches();
+
+    // A rebound device may have different VPD or firmware
+    clearStringCache();
+
+    // look for <basePath>/hwmon/hwmonN/.  The index shared by all the
+    // PMBus objects avoids scanning sysfs for each one.  It does not throw
+    // if the hwmon directory is not there, since things can be dynamically
+    // present or not present.
+    hwmonDir = HwmonIndex::getInstance().find(basePath);
 
     // Don't really want to crash here, just log it
     // and let accesses fail later
@@ -387,6 +879,18 @@ void PMBus::findHwmonDir()
                                      basePath.string())
                              .c_str());
     }
+
+    hwmonPath = basePath / "hwmon" / hwmonDir;
+    debugDirPath = debugPath / "pmbus" / hwmonDir;
+    deviceDebugPath = debugPath / (driverName + "." + std::to_string(instance));
+    hwmonDeviceDebugPath.clear();
+
+    // The files are discovered again on first use
+    for (auto& names : capabilities)
+    {
+        names.reset();
+    }
+    pages = 0;
 }
 
 std::unique_ptr<PMBusBase> PMBus::createPMBus(std::uint8_t bus,
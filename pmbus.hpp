@@ -1,7 +1,21 @@
 #pragma once
 
+#include "batch_reader.hpp"
+#include "file_descriptor.hpp"
+
+#include <sys/types.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
 #include <filesystem>
+#include <functional>
+#include <map>
+#include <optional>
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace phosphor
@@ -14,6 +28,11 @@ namespace fs = std::filesystem;
 // The file name Linux uses to capture the READ_VIN from pmbus.
 constexpr auto READ_VIN = "in1_input";
 
+// The file names of the raw READ_EIN and READ_EOUT energy accumulator blocks,
+// in the debugfs directory of the device driver.
+constexpr auto READ_EIN = "read_ein";
+constexpr auto READ_EOUT = "read_eout";
+
 namespace in_input
 {
 // VIN thresholds in Volts
@@ -73,6 +92,10 @@ constexpr auto VOUT_FAULT = 0x8000;
 // to see if the INPUT FAULT OR WARNING bit is on.
 constexpr auto INPUT_FAULT_WARN = 0x2000;
 
+// The bit mask representing the IOUT/POUT fault or warning bit of the
+// STATUS_WORD. Bit 6 of the high byte.
+constexpr auto IOUT_POUT_FAULT = 0x4000;
+
 // The bit mask representing the MFRSPECIFIC fault, bit 4 of STATUS_WORD high
 // byte. A manufacturer specific fault or warning has occurred.
 constexpr auto MFR_SPECIFIC_FAULT = 0x1000;
@@ -155,6 +178,86 @@ enum class Type
     HwmonDeviceDebug // hwmon device debug directory
 };
 
+/**
+ * The number of values of Type
+ */
+constexpr size_t NUM_TYPES = 5;
+
+/**
+ * How the device is accessed
+ */
+enum class Backend
+{
+    Sysfs, // device driver hwmon and debugfs files
+    I2C    // SMBus transactions using the I2C device interface
+};
+
+/**
+ * @struct StatusSnapshot
+ *
+ * The values of a set of registers that were read together by
+ * PMBusBase::readStatusSnapshot().
+ */
+struct StatusSnapshot
+{
+    /**
+     * The time the registers were read
+     */
+    std::chrono::steady_clock::time_point timestamp;
+
+    /**
+     * The register values, in the same order as the names that were read.
+     * The value is 0 if the read failed.
+     */
+    std::vector<uint64_t> values;
+
+    /**
+     * Whether each register was read successfully, in the same order as the
+     * values.
+     */
+    std::vector<bool> valid;
+
+    /**
+     * Returns whether all of the registers were read successfully.
+     *
+     * @return bool - true if all reads succeeded, false otherwise
+     */
+    bool isValid() const
+    {
+        return std::find(valid.begin(), valid.end(), false) == valid.end();
+    }
+};
+
+/**
+ * @struct ReadResult
+ *
+ * The value of a read that does not throw an exception, or the errno of why
+ * it failed.  See PMBusBase::tryRead().
+ */
+template <typename T>
+struct ReadResult
+{
+    /**
+     * The value read.  Default constructed if the read failed.
+     */
+    T value{};
+
+    /**
+     * The errno of the failure, or 0 if the read succeeded
+     */
+    int error = 0;
+
+    /**
+     * Returns whether the read succeeded.
+     *
+     * @return bool - true if the value is valid, false otherwise
+     */
+    explicit operator bool() const
+    {
+        return error == 0;
+    }
+};
+
 /**
  * @class PMBusBase
  *
@@ -166,9 +269,157 @@ class PMBusBase
     virtual ~PMBusBase() = default;
 
     virtual uint64_t read(const std::string& name, Type type) = 0;
+
+    /**
+     * Reads a set of registers in one call.
+     *
+     * A failed read does not throw an exception.  Instead the corresponding
+     * value is marked as not valid in the returned snapshot.  Callers that
+     * need the standard error handling for a failed value can read that
+     * register again with read().
+     *
+     * The default implementation calls read() for each register.
+     *
+     * @param[in] names - the file names of the registers to read
+     * @param[in] type - Path type
+     *
+     * @return StatusSnapshot - the values read
+     */
+    virtual StatusSnapshot
+        readStatusSnapshot(const std::vector<std::string>& names, Type type);
+
     virtual std::string readString(const std::string& name, Type type) = 0;
-    virtual void writeBinary(const std::string& name, std::vector<uint8_t> data,
-                             Type type) = 0;
+
+    /**
+     * Reads a file like read(), but returns the failure instead of throwing
+     * an exception, and does not log it or create an error entry.
+     *
+     * This is for callers that read a file repeatedly while it may be
+     * failing, such as during a device outage, and limit how often they log
+     * the failure themselves.
+     *
+     * The default implementation calls read() and returns EIO if it throws.
+     *
+     * @param[in] name - the file name
+     * @param[in] type - Path type
+     *
+     * @return ReadResult<uint64_t> - the value, or the errno of the failure
+     */
+    virtual ReadResult<uint64_t> tryRead(const std::string& name, Type type);
+
+    /**
+     * Reads a file like readString(), but returns the failure instead of
+     * throwing an exception, and does not log it or create an error entry.
+     * See tryRead().
+     *
+     * The default implementation calls readString() and returns EIO if it
+     * throws.
+     *
+     * @param[in] name - the file name
+     * @param[in] type - Path type
+     *
+     * @return ReadResult<std::string> - the value, or the errno of the
+     *                                   failure
+     */
+    virtual ReadResult<std::string> tryReadString(const std::string& name,
+                                                  Type type);
+
+    /**
+     * Reads a string that does not change while the device driver stays
+     * bound, such as a VPD field or the firmware version.
+     *
+     * The value is read with readString() the first time, and then returned
+     * from a cache until clearStringCache() or findHwmonDir() is called.  A
+     * failed read is not cached.
+     *
+     * The default implementation does not cache the value.
+     *
+     * @param[in] name - the file name
+     * @param[in] type - Path type
+     * @param[in] refresh - read the file even if the value is cached, and
+     *                      cache the new value
+     *
+     * @return string - the value
+     */
+    virtual std::string readCachedString(const std::string& name, Type type,
+                                         bool refresh);
+
+    /**
+     * Clears the values cached by readCachedString(), such as when the
+     * device has been removed.
+     *
+     * The default implementation does nothing.
+     */
+    virtual void clearStringCache();
+
+    /**
+     * Returns the paths of the hwmon alarm files for the device.
+     *
+     * The device driver notifies pollers of these files with POLLPRI when
+     * an alarm changes state, so they can be used to detect faults without
+     * periodically reading the status registers.
+     *
+     * The default implementation returns an empty vector, meaning alarms
+     * are not available and the device must be polled.
+     *
+     * @return vector<fs::path> - full paths of the *_alarm files
+     */
+    virtual std::vector<fs::path> getAlarmFiles();
+
+    /**
+     * Reads the raw data of a block command, such as READ_EIN.
+     *
+     * The default implementation reads no data, meaning the command is not
+     * available.
+     *
+     * @param[in] name - the file name of the command
+     * @param[in] type - Path type
+     * @param[out] buffer - filled in with the data read, without the block
+     *                      count
+     *
+     * @return size_t - The number of bytes read.  Zero if the command could
+     *                  not be read.
+     */
+    virtual size_t readBlock(const std::string& name, Type type,
+                             std::span<uint8_t> buffer);
+
+    /**
+     * Gets the open files of a set of registers, so they can be read in a
+     * batch with the registers of other devices.  The snapshot is then
+     * built from the reads with completeSnapshot().
+     *
+     * The default implementation returns false, meaning the registers must
+     * be read with readStatusSnapshot().
+     *
+     * @param[in] names - the file names of the registers to read
+     * @param[in] type - Path type
+     * @param[out] fds - set to the open file of each register, or -1 if the
+     *                   register cannot be read.  The files stay owned by
+     *                   the device.
+     *
+     * @return bool - true if the registers can be read in a batch
+     */
+    virtual bool prepareSnapshot(const std::vector<std::string>& names,
+                                 Type type, std::vector<int>& fds);
+
+    /**
+     * Builds the snapshot of a set of registers from the batched reads of
+     * the files returned by prepareSnapshot().
+     *
+     * The default implementation marks all the registers as not valid.
+     *
+     * @param[in] names - the file names of the registers
+     * @param[in] type - Path type
+     * @param[in] reads - the reads of the files, in the same order
+     *
+     * @return StatusSnapshot - the values read
+     */
+    virtual StatusSnapshot
+        completeSnapshot(const std::vector<std::string>& names, Type type,
+                         std::span<const power::util::BatchRead> reads);
+
+    virtual void writeBinary(const std::string& name,
+                             std::span<const uint8_t> data, Type type) = 0;
     virtual void findHwmonDir() = 0;
     virtual const fs::path& path() const = 0;
     virtual std::string insertPageNum(const std::string& templateName,
@@ -201,8 +452,8 @@ class PMBus : public PMBusBase
   public:
     PMBus() = delete;
     virtual ~PMBus() = default;
-    PMBus(const PMBus&) = default;
-    PMBus& operator=(const PMBus&) = default;
+    PMBus(const PMBus&) = delete;
+    PMBus& operator=(const PMBus&) = delete;
     PMBus(PMBus&&) = default;
     PMBus& operator=(PMBus&&) = default;
 
@@ -234,6 +485,25 @@ class PMBus : public PMBusBase
         findHwmonDir();
     }
 
+    /**
+     * Constructor
+     *
+     * This version uses a different debugfs directory, such as one in
+     * a fake sysfs tree used by a benchmark.
+     *
+     * @param[in] path - path to the sysfs directory
+     * @param[in] driverName - the device driver name
+     * @param[in] instance - chip instance number
+     * @param[in] debugPath - path to the debugfs directory
+     */
+    PMBus(const std::string& path, const std::string& driverName,
+          size_t instance, const fs::path& debugPath) :
+        basePath(path),
+        driverName(driverName), instance(instance), debugPath(debugPath)
+    {
+        findHwmonDir();
+    }
+
     /**
      * Wrapper function for PMBus
      *
@@ -273,6 +543,9 @@ class PMBus : public PMBusBase
     /**
      * Checks if the file for the given name and type exists.
      *
+     * Once the capabilities of the type have been discovered, see
+     * isSupported(), this does not access the file system.
+     *
      * @param[in] name   - path concatenated to basePath to read
      * @param[in] type   - Path type
      *
@@ -280,6 +553,39 @@ class PMBus : public PMBusBase
      */
     bool exists(const std::string& name, Type type);
 
+    /**
+     * Returns whether the device may have the file for the given name and
+     * type.
+     *
+     * The first time a type is used after the device driver is bound, the
+     * names of the files in its directory are read, and then kept until
+     * findHwmonDir() is called again.  The reads return a ReadFailure for a
+     * file that is not there without accessing the file system or logging
+     * an error.
+     *
+     * Until the directory can be read, such as before the device driver is
+     * bound, every file may be there.
+     *
+     * @param[in] name - path concatenated to basePath to read
+     * @param[in] type - Path type
+     *
+     * @return bool - false if the file is known not to exist
+     */
+    bool isSupported(const std::string& name, Type type);
+
+    /**
+     * Returns whether the device has a PMBus page.
+     *
+     * The pages are found from the status files of the pmbus debug
+     * directory when its capabilities are discovered.  Every page may be
+     * there until the directory can be read.
+     *
+     * @param[in] page - the page number
+     *
+     * @return bool - false if the page is known not to exist
+     */
+    bool hasPage(size_t page);
+
     /**
      * Read byte(s) from file in sysfs.
      *
@@ -290,6 +596,20 @@ class PMBus : public PMBusBase
      */
     uint64_t read(const std::string& name, Type type) override;
 
+    /**
+     * Reads a set of registers in one call.
+     *
+     * Reads each file without iostreams or exceptions.  Failed reads are not
+     * logged; see PMBusBase::readStatusSnapshot().
+     *
+     * @param[in] names - the file names of the registers to read
+     * @param[in] type - Path type
+     *
+     * @return StatusSnapshot - the values read
+     */
+    StatusSnapshot readStatusSnapshot(const std::vector<std::string>& names,
+                                      Type type) override;
+
     /**
      * Read a string from file in sysfs.
      *
@@ -300,6 +620,118 @@ class PMBus : public PMBusBase
      */
     std::string readString(const std::string& name, Type type) override;
 
+    /**
+     * Reads a file like read() without exceptions or logging.  See
+     * PMBusBase::tryRead().
+     *
+     * A file the device does not have fails with ENOENT, and contents that
+     * are not a hex value fail with EINVAL.
+     *
+     * @param[in] name   - path concatenated to basePath to read
+     * @param[in] type   - Path type
+     *
+     * @return ReadResult<uint64_t> - the value, or the errno of the failure
+     */
+    ReadResult<uint64_t> tryRead(const std::string& name, Type type) override;
+
+    /**
+     * Reads a file like readString() without exceptions or logging.  See
+     * PMBusBase::tryReadString().
+     *
+     * A file the device does not have fails with ENOENT, and an empty file
+     * fails with ENODATA.
+     *
+     * @param[in] name   - path concatenated to basePath to read
+     * @param[in] type   - Path type
+     *
+     * @return ReadResult<std::string> - the value, or the errno of the
+     *                                   failure
+     */
+    ReadResult<std::string> tryReadString(const std::string& name,
+                                          Type type) override;
+
+    /**
+     * Reads a string that does not change while the device driver stays
+     * bound.  See PMBusBase::readCachedString().
+     *
+     * @param[in] name - path concatenated to basePath to read
+     * @param[in] type - Path type
+     * @param[in] refresh - read the file even if the value is cached
+     *
+     * @return string - The data read from the file.
+     */
+    std::string readCachedString(const std::string& name, Type type,
+                                 bool refresh) override;
+
+    /**
+     * Clears the values cached by readCachedString().
+     */
+    void clearStringCache() override
+    {
+        for (auto& cache : stringCache)
+        {
+            cache.clear();
+        }
+    }
+
+    /**
+     * Returns the paths of the *_alarm files in the hwmon directory.
+     *
+     * Returns an empty vector if the hwmon directory does not exist, such as
+     * when the device driver is not bound.
+     *
+     * @return vector<fs::path> - full paths of the *_alarm files
+     */
+    std::vector<fs::path> getAlarmFiles() override;
+
+    /**
+     * Reads the raw data of a block command from its file with readBinary().
+     *
+     * @param[in] name - the file name of the command
+     * @param[in] type - Path type
+     * @param[out] buffer - filled in with the data read
+     *
+     * @return size_t - The number of bytes read.  Zero if the file could not
+     *                  be opened.
+     */
+    size_t readBlock(const std::string& name, Type type,
+                     std::span<uint8_t> buffer) override
+    {
+        return readBinary(name, type, buffer);
+    }
+
+    /**
+     * Gets the open files of a set of registers for a batched read.  See
+     * PMBusBase::prepareSnapshot().
+     *
+     * The files are opened and kept in the file descriptor cache, so this
+     * returns false unless caching is enabled.
+     *
+     * @param[in] names - the file names of the registers to read
+     * @param[in] type - Path type
+     * @param[out] fds - set to the open file of each register, or -1
+     *
+     * @return bool - true if the file descriptor cache is enabled
+     */
+    bool prepareSnapshot(const std::vector<std::string>& names, Type type,
+                         std::vector<int>& fds) override;
+
+    /**
+     * Builds the snapshot of a set of registers from batched reads.  See
+     * PMBusBase::completeSnapshot().
+     *
+     * A file that could not be read is closed, like with readFile().
+     *
+     * @param[in] names - the file names of the registers
+     * @param[in] type - Path type
+     * @param[in] reads - the reads of the files, in the same order
+     *
+     * @return StatusSnapshot - the values read
+     */
+    StatusSnapshot completeSnapshot(
+        const std::vector<std::string>& names, Type type,
+        std::span<const power::util::BatchRead> reads) override;
+
     /**
      * Read data from a binary file in sysfs.
      *
@@ -312,6 +744,22 @@ class PMBus : public PMBusBase
     std::vector<uint8_t> readBinary(const std::string& name, Type type,
                                     size_t length);
 
+    /**
+     * Read data from a binary file in sysfs into a buffer.
+     *
+     * Reads up to buffer.size() bytes, without allocating memory for the
+     * data.
+     *
+     * @param[in] name   - path concatenated to basePath to read
+     * @param[in] type   - Path type
+     * @param[out] buffer - filled in with the data read from the file
+     *
+     * @return size_t - The number of bytes read.  Zero if the file could not
+     *                  be opened.
+     */
+    size_t readBinary(const std::string& name, Type type,
+                      std::span<uint8_t> buffer);
+
     /**
      * Writes an integer value to the file, therefore doing
      * a PMBus write.
@@ -330,7 +778,7 @@ class PMBus : public PMBusBase
      * @param[in] data - The data to write to the file
      * @param[in] type - Path type
      */
-    void writeBinary(const std::string& name, std::vector<uint8_t> data,
+    void writeBinary(const std::string& name, std::span<const uint8_t> data,
                      Type type) override;
 
     /**
@@ -349,6 +797,8 @@ class PMBus : public PMBusBase
      *   insertPageNum("inP_enable", 42)
      *   returns "in42_enable"
      *
+     * The resulting names are saved, so each one is only built once.
+     *
      * @param[in] templateName - the name string, with a 'P' in it
      * @param[in] page - the page number to insert where the P was
      *
@@ -366,13 +816,132 @@ class PMBus : public PMBusBase
     /**
      * Returns the path to use for the passed in type.
      *
+     * The paths are resolved when findHwmonDir() is called rather than on
+     * every access.
+     *
      * @param[in] type - Path type
      *
      * @return fs::path - the full path
      */
-    fs::path getPath(Type type);
+    const fs::path& getPath(Type type);
+
+    /**
+     * Enables or disables caching of open file descriptors.
+     *
+     * When enabled, the files accessed by read(), readBit(), and readString()
+     * are kept open after the first access, and later reads use pread() at
+     * offset 0 instead of opening and closing the file each time.  Likewise
+     * the files written by write() and writeBinary() are kept open, and later
+     * writes use pwrite().
+     *
+     * The cache is cleared when findHwmonDir() is called, and a cached file
+     * is closed if an access to it fails, such as when the device driver has
+     * been unbound.
+     *
+     * Disabled by default.
+     *
+     * @param[in] enable - true to enable caching, false to disable it
+     */
+    void setFileCacheEnabled(bool enable)
+    {
+        fileCacheEnabled = enable;
+        if (!enable)
+        {
+            clearFileCaches();
+        }
+    }
+
+    /**
+     * Returns whether caching of open file descriptors is enabled.
+     *
+     * @return bool - true if caching is enabled, false otherwise
+     */
+    bool isFileCacheEnabled() const
+    {
+        return fileCacheEnabled;
+    }
 
   private:
+    /**
+     * Open file descriptors keyed by file name.  The transparent comparator
+     * allows finding a name without building a string.
+     */
+    using FileCache =
+        std::map<std::string, phosphor::power::util::FileDescriptor,
+                 std::less<>>;
+
+    /**
+     * Returns the name built by insertPageNum(), without copying it.
+     *
+     * The reference is valid until the next call for the same template name.
+     *
+     * @param[in] templateName - the name string, with a 'P' in it
+     * @param[in] page - the page number to insert where the P was
+     *
+     * @return const string& - the new string with the page number in it
+     */
+    const std::string& getPagedName(const std::string& templateName,
+                                    size_t page);
+
+    /**
+     * Reads the contents of a file into a caller-provided buffer.
+     *
+     * Does not allocate memory or throw exceptions for the read itself.
+     *
+     * If file descriptor caching is enabled, the file is opened and added to
+     * the cache if necessary and then read starting at offset 0 so that
+     * sysfs and debugfs regenerate the file contents.  The file is removed
+     * from the cache if the read fails.  A file found in the cache is read
+     * without building its path.
+     *
+     * @param[in] type - Path type of the file
+     * @param[in] name - name of the file in the directory of the type
+     * @param[out] buffer - buffer to read the file contents into
+     * @param[in] size - maximum number of bytes to read
+     *
+     * @return ssize_t - the number of bytes read, or -1 with errno set if the
+     *                   file could not be read or was empty
+     */
+    ssize_t readFile(Type type, std::string_view name, char* buffer,
+                     size_t size);
+
+    /**
+     * Writes a caller-provided buffer to a file.
+     *
+     * Does not allocate memory or throw exceptions for the write itself.
+     *
+     * If file descriptor caching is enabled, the file is opened and added to
+     * the cache if necessary and then written starting at offset 0.  The file
+     * is removed from the cache if the write fails.  A file found in the
+     * cache is written without building its path.
+     *
+     * @param[in] type - Path type of the file
+     * @param[in] name - name of the file in the directory of the type
+     * @param[in] buffer - data to write
+     * @param[in] size - number of bytes to write
+     *
+     * @return ssize_t - the number of bytes written, or -1 with errno set if
+     *                   the file could not be opened or not all the bytes
+     *                   were written
+     */
+    ssize_t writeFile(Type type, std::string_view name, const char* buffer,
+                      size_t size);
+
+    /**
+     * Closes the cached file descriptors.
+     */
+    void clearFileCaches()
+    {
+        for (auto& cache : fileCache)
+        {
+            cache.clear();
+        }
+        for (auto& cache : writeFileCache)
+        {
+            cache.clear();
+        }
+    }
+
     /**
      * Returns the device name
      *
@@ -382,6 +951,18 @@ class PMBus : public PMBusBase
      */
     std::string getDeviceName();
 
+    /**
+     * Returns the names of the files in the directory of a type, reading
+     * them the first time the type is used after the device driver is
+     * bound.
+     *
+     * @param[in] type - Path type
+     *
+     * @return const vector<string>* - the sorted names, or nullptr if the
+     *                                 directory could not be read yet
+     */
+    const std::vector<std::string>* getCapabilities(Type type);
+
     /**
      * The sysfs device path
      */
@@ -412,6 +993,62 @@ class PMBus : public PMBusBase
      * The pmbus debug path with status files
      */
     const fs::path debugPath = "/sys/kernel/debug/";
+
+    /**
+     * The resolved paths for the Hwmon, Debug, DeviceDebug, and
+     * HwmonDeviceDebug types.  Set by findHwmonDir().
+     *
+     * The HwmonDeviceDebug path requires reading the device name, so it is
+     * resolved on first use instead.
+     */
+    fs::path hwmonPath;
+    fs::path debugDirPath;
+    fs::path deviceDebugPath;
+    fs::path hwmonDeviceDebugPath;
+
+    /**
+     * The sorted names of the files in the directory of each type, indexed
+     * by type.  Not set for a type until its directory has been read after
+     * the device driver was bound, and cleared by findHwmonDir().
+     */
+    std::array<std::optional<std::vector<std::string>>, NUM_TYPES>
+        capabilities;
+
+    /**
+     * The pages of the device, bit N set for page N.  Found with the
+     * capabilities of the Debug type.
+     */
+    uint32_t pages = 0;
+
+    /**
+     * The names built by insertPageNum(), keyed by the template name and
+     * indexed by page number.
+     */
+    std::map<std::string, std::vector<std::string>> pagedNames;
+
+    /**
+     * Indicates whether open file descriptors are cached.
+     */
+    bool fileCacheEnabled = false;
+
+    /**
+     * Open file descriptors, indexed by type and keyed by the file name.
+     */
+    std::array<FileCache, NUM_TYPES> fileCache;
+
+    /**
+     * The values read by readCachedString(), indexed by type and keyed by
+     * the file name.
+     */
+    std::array<std::map<std::string, std::string, std::less<>>, NUM_TYPES>
+        stringCache;
+
+    /**
+     * Open file descriptors of written files, indexed by type and keyed by
+     * the file name.  Separate from fileCache since the files are opened
+     * write-only.
+     */
+    std::array<FileCache, NUM_TYPES> writeFileCache;
 };
 
 } // namespace pmbus
@@ -0,0 +1,118 @@
+/**
+ * Copyright © 2026 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "pmbus.hpp"
+
+#include <cerrno>
+#include <chrono>
+#include <exception>
+
+namespace phosphor
+{
+namespace pmbus
+{
+
+StatusSnapshot PMBusBase::readStatusSnapshot(
+    const std::vector<std::string>& names, Type type)
+{
+    StatusSnapshot snapshot;
+    snapshot.timestamp = std::chrono::steady_clock::now();
+    snapshot.values.resize(names.size(), 0);
+    snapshot.valid.resize(names.size(), false);
+
+    for (size_t i = 0; i < names.size(); i++)
+    {
+        try
+        {
+            snapshot.values[i] = read(names[i], type);
+            snapshot.valid[i] = true;
+        }
+        catch (const std::exception& e)
+        {
+            // Leave the value marked as not valid
+        }
+    }
+
+    return snapshot;
+}
+
+ReadResult<uint64_t> PMBusBase::tryRead(const std::string& name, Type type)
+{
+    ReadResult<uint64_t> result;
+    try
+    {
+        result.value = read(name, type);
+    }
+    catch (const std::exception& e)
+    {
+        result.error = EIO;
+    }
+    return result;
+}
+
+ReadResult<std::string> PMBusBase::tryReadString(const std::string& name,
+                                                 Type type)
+{
+    ReadResult<std::string> result;
+    try
+    {
+        result.value = readString(name, type);
+    }
+    catch (const std::exception& e)
+    {
+        result.error = EIO;
+    }
+    return result;
+}
+
+std::string PMBusBase::readCachedString(const std::string& name, Type type,
+                                        bool /*refresh*/)
+{
+    return readString(name, type);
+}
+
+void PMBusBase::clearStringCache()
+{}
+
+std::vector<fs::path> PMBusBase::getAlarmFiles()
+{
+    return {};
+}
+
+size_t PMBusBase::readBlock(const std::string& /*name*/, Type /*type*/,
+                            std::span<uint8_t> /*buffer*/)
+{
+    return 0;
+}
+
+bool PMBusBase::prepareSnapshot(const std::vector<std::string>& /*names*/,
+                                Type /*type*/, std::vector<int>& /*fds*/)
+{
+    return false;
+}
+
+StatusSnapshot PMBusBase::completeSnapshot(
+    const std::vector<std::string>& names, Type /*type*/,
+    std::span<const power::util::BatchRead> /*reads*/)
+{
+    StatusSnapshot snapshot;
+    snapshot.timestamp = std::chrono::steady_clock::now();
+    snapshot.values.resize(names.size(), 0);
+    snapshot.valid.resize(names.size(), false);
+    return snapshot;
+}
+
+} // namespace pmbus
+} // namespace phosphor
@@ -0,0 +1,304 @@
+/**
+ * Copyright © 2026 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "pmbus_broker.hpp"
+
+#include <exception>
+#include <span>
+#include <stdexcept>
+
+namespace phosphor
+{
+namespace pmbus
+{
+
+PMBusBroker::PMBusBroker(bool batchReads)
+{
+    if (batchReads)
+    {
+        batchReader = std::make_unique<power::util::BatchReader>();
+    }
+}
+
+void PMBusBroker::addDevice(const std::string& device,
+                            std::unique_ptr<PMBusBase> pmbus)
+{
+    auto [it, added] = devices.try_emplace(device, Device{std::move(pmbus)});
+    if (!added)
+    {
+        throw std::invalid_argument{"Duplicate PMBus device: " + device};
+    }
+}
+
+size_t PMBusBroker::getRegisterCount() const
+{
+    size_t count{0};
+    for (const auto& [id, device] : devices)
+    {
+        count += device.registers.size();
+    }
+    return count;
+}
+
+std::optional<Reading> PMBusBroker::getReading(const std::string& device,
+                                               const std::string& name,
+                                               Type type) const
+{
+    auto deviceIt = devices.find(device);
+    if (deviceIt == devices.end())
+    {
+        return std::nullopt;
+    }
+    auto registerIt = deviceIt->second.registers.find(RegisterKey{type, name});
+    if (registerIt == deviceIt->second.registers.end())
+    {
+        return std::nullopt;
+    }
+    return registerIt->second.reading;
+}
+
+void PMBusBroker::poll()
+{
+    if (batchReader)
+    {
+        pollBatch();
+        return;
+    }
+
+    std::vector<std::string> names;
+    std::vector<std::pair<Callback, Reading>> notifications;
+    for (auto& [id, device] : devices)
+    {
+        // Read the registers of each path type with one snapshot
+        auto it = device.registers.begin();
+        while (it != device.registers.end())
+        {
+            Type type = it->first.first;
+            auto groupEnd = it;
+            names.clear();
+            while ((groupEnd != device.registers.end()) &&
+                   (groupEnd->first.first == type))
+            {
+                names.emplace_back(groupEnd->first.second);
+                ++groupEnd;
+            }
+
+            StatusSnapshot snapshot = read(*device.pmbus, names, type);
+            for (size_t i = 0; it != groupEnd; ++it, ++i)
+            {
+                Reading reading{snapshot.values[i], snapshot.valid[i],
+                                snapshot.timestamp};
+                Register& reg = it->second;
+                reg.reading = reading;
+                for (const auto& [subscriber, callback] : reg.subscribers)
+                {
+                    if (callback)
+                    {
+                        notifications.emplace_back(callback, reading);
+                    }
+                }
+            }
+        }
+
+        // Call the subscribers after the device has been read.  The
+        // callbacks were copied so they may change the subscriptions.
+        for (const auto& [callback, reading] : notifications)
+        {
+            callback(reading);
+        }
+        notifications.clear();
+    }
+}
+
+void PMBusBroker::pollBatch()
+{
+    /**
+     * The registers of one path type of a device, which are read together.
+     */
+    struct Group
+    {
+        Device* device;
+        std::map<RegisterKey, Register>::iterator begin;
+        std::map<RegisterKey, Register>::iterator end;
+        std::vector<std::string> names{};
+        bool batched{false};
+        size_t firstRead{0};
+    };
+
+    // Find the files of all the registers that can be read in the batch
+    std::vector<Group> groups;
+    std::vector<int> fds;
+    batchReads.clear();
+    for (auto& [id, device] : devices)
+    {
+        auto it = device.registers.begin();
+        while (it != device.registers.end())
+        {
+            Type type = it->first.first;
+            Group group{&device, it, it};
+            while ((group.end != device.registers.end()) &&
+                   (group.end->first.first == type))
+            {
+                group.names.emplace_back(group.end->first.second);
+                ++group.end;
+            }
+            it = group.end;
+
+            try
+            {
+                group.batched =
+                    device.pmbus->prepareSnapshot(group.names, type, fds) &&
+                    (fds.size() == group.names.size());
+            }
+            catch (const std::exception& e)
+            {
+                // Read the registers with readStatusSnapshot() below
+                group.batched = false;
+            }
+            if (group.batched)
+            {
+                group.firstRead = batchReads.size();
+                for (int fd : fds)
+                {
+                    batchReads.push_back(power::util::BatchRead{fd});
+                }
+            }
+            groups.push_back(std::move(group));
+        }
+    }
+
+    // The buffers are only assigned once the number of reads is known, since
+    // the vector may move them while it grows
+    if (batchBuffers.size() < batchReads.size())
+    {
+        batchBuffers.resize(batchReads.size());
+    }
+    for (size_t i = 0; i < batchReads.size(); ++i)
+    {
+        batchReads[i].buffer = batchBuffers[i];
+    }
+    batchReader->read(batchReads);
+
+    // Store all the readings before calling the subscribers, since the
+    // callbacks may change the registers of the groups
+    std::vector<std::pair<Callback, Reading>> notifications;
+    for (auto& group : groups)
+    {
+        Type type = group.begin->first.first;
+        StatusSnapshot snapshot;
+        if (group.batched)
+        {
+            snapshot = group.device->pmbus->completeSnapshot(
+                group.names, type,
+                std::span{batchReads}.subspan(group.firstRead,
+                                              group.names.size()));
+        }
+        else
+        {
+            snapshot = read(*group.device->pmbus, group.names, type);
+        }
+        if ((snapshot.values.size() != group.names.size()) ||
+            (snapshot.valid.size() != group.names.size()))
+        {
+            snapshot.values.assign(group.names.size(), 0);
+            snapshot.valid.assign(group.names.size(), false);
+        }
+
+        size_t i{0};
+        for (auto it = group.begin; it != group.end; ++it, ++i)
+        {
+            Reading reading{snapshot.values[i], snapshot.valid[i],
+                            snapshot.timestamp};
+            Register& reg = it->second;
+            reg.reading = reading;
+            for (const auto& [subscriber, callback] : reg.subscribers)
+            {
+                if (callback)
+                {
+                    notifications.emplace_back(callback, reading);
+                }
+            }
+        }
+    }
+
+    for (const auto& [callback, reading] : notifications)
+    {
+        callback(reading);
+    }
+}
+
+StatusSnapshot PMBusBroker::read(PMBusBase& pmbus,
+                                 const std::vector<std::string>& names,
+                                 Type type)
+{
+    StatusSnapshot snapshot;
+    try
+    {
+        snapshot = pmbus.readStatusSnapshot(names, type);
+    }
+    catch (const std::exception& e)
+    {
+        // Mark all the registers as not valid below
+        snapshot.timestamp = std::chrono::steady_clock::now();
+    }
+
+    if ((snapshot.values.size() != names.size()) ||
+        (snapshot.valid.size() != names.size()))
+    {
+        snapshot.values.assign(names.size(), 0);
+        snapshot.valid.assign(names.size(), false);
+    }
+    return snapshot;
+}
+
+PMBusBroker::Subscription PMBusBroker::subscribe(const std::string& device,
+                                                 const std::string& name,
+                                                 Type type, Callback callback)
+{
+    auto deviceIt = devices.find(device);
+    if (deviceIt == devices.end())
+    {
+        throw std::invalid_argument{"Unknown PMBus device: " + device};
+    }
+
+    RegisterKey key{type, name};
+    size_t id = nextID++;
+    deviceIt->second.registers[key].subscribers.emplace(id,
+                                                        std::move(callback));
+    return Subscription{this, device, key, id};
+}
+
+void PMBusBroker::unsubscribe(const std::string& device, const RegisterKey& key,
+                              size_t id)
+{
+    auto deviceIt = devices.find(device);
+    if (deviceIt == devices.end())
+    {
+        return;
+    }
+    auto registerIt = deviceIt->second.registers.find(key);
+    if (registerIt == deviceIt->second.registers.end())
+    {
+        return;
+    }
+    registerIt->second.subscribers.erase(id);
+    if (registerIt->second.subscribers.empty())
+    {
+        deviceIt->second.registers.erase(registerIt);
+    }
+}
+
+} // namespace pmbus
+} // namespace phosphor
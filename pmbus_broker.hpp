@@ -0,0 +1,381 @@
+#pragma once
+
+#include "batch_reader.hpp"
+#include "pmbus.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace phosphor
+{
+namespace pmbus
+{
+
+/**
+ * @struct Reading
+ *
+ * The value of one PMBus register read by the PMBusBroker.
+ */
+struct Reading
+{
+    /**
+     * The register value, parsed the same way as PMBusBase::read().  The
+     * value is 0 if the read failed.
+     */
+    uint64_t value;
+
+    /**
+     * Whether the register was read successfully.
+     */
+    bool valid;
+
+    /**
+     * The time the register was read.
+     */
+    std::chrono::steady_clock::time_point timestamp;
+};
+
+/**
+ * @class PMBusBroker
+ *
+ * Owns the reads of the PMBus registers of a set of devices, so each
+ * register is read once per poll no matter how many clients use it.
+ *
+ * Clients subscribe to the registers they need.  Each call to poll() reads
+ * all the subscribed registers of a device with one readStatusSnapshot()
+ * call per path type, stores the readings, and then calls the subscribers'
+ * callbacks.  Registers without subscribers are not read.
+ *
+ * A device that cannot be read does not stop the poll; its readings are
+ * marked as not valid.
+ *
+ * With batched reads, the registers of all the devices that support them
+ * are read with one BatchReader submission per poll, using io_uring when
+ * the kernel provides it.  The other devices are read with
+ * readStatusSnapshot() as usual.
+ *
+ * The broker is not thread safe.  It is normally used from the event loop,
+ * with a timer calling poll() once per period.
+ */
+class PMBusBroker
+{
+  public:
+    /**
+     * Called with the new reading of a register after each poll.
+     */
+    using Callback = std::function<void(const Reading&)>;
+
+    /**
+     * Identifies a register of a device by path type and file name.
+     */
+    using RegisterKey = std::pair<Type, std::string>;
+
+    /**
+     * @class Subscription
+     *
+     * Keeps a subscription to a register active.  The subscription ends when
+     * this object is destroyed.  Must not outlive the broker.
+     */
+    class Subscription
+    {
+      public:
+        Subscription() = default;
+        Subscription(const Subscription&) = delete;
+        Subscription& operator=(const Subscription&) = delete;
+
+        Subscription(Subscription&& other) noexcept :
+            broker{std::exchange(other.broker, nullptr)},
+            device{std::move(other.device)}, key{std::move(other.key)},
+            id{other.id}
+        {}
+
+        Subscription& operator=(Subscription&& other) noexcept
+        {
+            if (this != &other)
+            {
+                reset();
+                broker = std::exchange(other.broker, nullptr);
+                device = std::move(other.device);
+                key = std::move(other.key);
+                id = other.id;
+            }
+            return *this;
+        }
+
+        ~Subscription()
+        {
+            reset();
+        }
+
+        /**
+         * Returns whether the subscription is active.
+         *
+         * @return bool - true if active, false otherwise
+         */
+        bool isActive() const
+        {
+            return broker != nullptr;
+        }
+
+        /**
+         * Ends the subscription.  Does nothing if it is not active.
+         */
+        void reset()
+        {
+            if (broker != nullptr)
+            {
+                broker->unsubscribe(device, key, id);
+                broker = nullptr;
+            }
+        }
+
+      private:
+        friend class PMBusBroker;
+
+        /**
+         * Constructor
+         *
+         * @param[in] broker - the broker
+         * @param[in] device - the device ID
+         * @param[in] key - the register path type and name
+         * @param[in] id - the subscriber ID
+         */
+        Subscription(PMBusBroker* broker, const std::string& device,
+                     const RegisterKey& key, size_t id) :
+            broker{broker},
+            device{device}, key{key}, id{id}
+        {}
+
+        /**
+         * The broker, or nullptr if not active.
+         */
+        PMBusBroker* broker{nullptr};
+
+        /**
+         * The device ID.
+         */
+        std::string device{};
+
+        /**
+         * The register path type and name.
+         */
+        RegisterKey key{};
+
+        /**
+         * The subscriber ID.
+         */
+        size_t id{0};
+    };
+
+    ~PMBusBroker() = default;
+    PMBusBroker(const PMBusBroker&) = delete;
+    PMBusBroker& operator=(const PMBusBroker&) = delete;
+    PMBusBroker(PMBusBroker&&) = delete;
+    PMBusBroker& operator=(PMBusBroker&&) = delete;
+
+    /**
+     * Constructor
+     *
+     * @param[in] batchReads - true to read the registers of all the devices
+     *                         in one batch; see PMBusBase::prepareSnapshot()
+     */
+    explicit PMBusBroker(bool batchReads = false);
+
+    /**
+     * Returns whether the reads are batched.
+     *
+     * @return bool - true if batched, false otherwise
+     */
+    bool isBatched() const
+    {
+        return batchReader != nullptr;
+    }
+
+    /**
+     * Returns whether the batched reads use io_uring.
+     *
+     * @return bool - true if io_uring is used, false if the reads are not
+     *                batched or are done with pread()
+     */
+    bool isAsync() const
+    {
+        return batchReader && batchReader->isAsync();
+    }
+
+    /**
+     * Adds a device.
+     *
+     * Throws std::invalid_argument if a device with the same ID exists.
+     *
+     * @param[in] device - the device ID, such as "3-0068"
+     * @param[in] pmbus - the interface used to read the device
+     */
+    void addDevice(const std::string& device,
+                   std::unique_ptr<PMBusBase> pmbus);
+
+    /**
+     * Returns the number of registers that are read by each poll.
+     *
+     * @return size_t - the number of subscribed registers
+     */
+    size_t getRegisterCount() const;
+
+    /**
+     * Returns the latest reading of a register.
+     *
+     * @param[in] device - the device ID
+     * @param[in] name - the register file name
+     * @param[in] type - the path type
+     *
+     * @return optional<Reading> - the reading, or no value if the register
+     *                             is not subscribed or has not been polled
+     */
+    std::optional<Reading> getReading(const std::string& device,
+                                      const std::string& name,
+                                      Type type) const;
+
+    /**
+     * Returns whether a device with the specified ID exists.
+     *
+     * @param[in] device - the device ID
+     *
+     * @return bool - true if the device exists, false otherwise
+     */
+    bool hasDevice(const std::string& device) const
+    {
+        return devices.contains(device);
+    }
+
+    /**
+     * Reads all the subscribed registers and calls the subscribers.
+     *
+     * The registers of each device are read before any of its subscribers
+     * are called.  Callbacks may end subscriptions or add new ones; new
+     * subscriptions are first read by the next poll.
+     */
+    void poll();
+
+    /**
+     * Subscribes to a register.
+     *
+     * The register is read by every poll while it has subscribers.
+     *
+     * Throws std::invalid_argument if the device does not exist.
+     *
+     * @param[in] device - the device ID
+     * @param[in] name - the register file name
+     * @param[in] type - the path type
+     * @param[in] callback - called with each new reading; may be empty if
+     *                       the client only uses getReading()
+     *
+     * @return Subscription - the subscription
+     */
+    [[nodiscard]] Subscription subscribe(const std::string& device,
+                                         const std::string& name, Type type,
+                                         Callback callback = {});
+
+  private:
+    /**
+     * A subscribed register.
+     */
+    struct Register
+    {
+        /**
+         * The latest reading.
+         */
+        std::optional<Reading> reading{};
+
+        /**
+         * The subscribers' callbacks, by subscriber ID.
+         */
+        std::map<size_t, Callback> subscribers{};
+    };
+
+    /**
+     * A device and its subscribed registers.
+     */
+    struct Device
+    {
+        /**
+         * The interface used to read the device.
+         */
+        std::unique_ptr<PMBusBase> pmbus;
+
+        /**
+         * The subscribed registers, ordered by path type so the registers
+         * of each type can be read together.
+         */
+        std::map<RegisterKey, Register> registers{};
+    };
+
+    /**
+     * Reads a set of registers of a device.
+     *
+     * If the read throws an exception, or does not return one value per
+     * register, all the registers are marked as not valid.
+     *
+     * @param[in] pmbus - the interface used to read the device
+     * @param[in] names - the file names of the registers to read
+     * @param[in] type - the path type
+     *
+     * @return StatusSnapshot - the values read
+     */
+    static StatusSnapshot read(PMBusBase& pmbus,
+                               const std::vector<std::string>& names,
+                               Type type);
+
+    /**
+     * Reads all the subscribed registers with the batch reader, and then
+     * calls the subscribers.
+     */
+    void pollBatch();
+
+    /**
+     * Ends a subscription.  Removes the register if it has no more
+     * subscribers.
+     *
+     * @param[in] device - the device ID
+     * @param[in] key - the register path type and name
+     * @param[in] id - the subscriber ID
+     */
+    void unsubscribe(const std::string& device,
+                     const RegisterKey& key, size_t id);
+
+    /**
+     * The devices, by device ID.
+     */
+    std::map<std::string, Device> devices{};
+
+    /**
+     * The ID of the next subscriber.
+     */
+    size_t nextID{0};
+
+    /**
+     * Reads the registers in batches, or nullptr to read each device with
+     * readStatusSnapshot().
+     */
+    std::unique_ptr<power::util::BatchReader> batchReader{};
+
+    /**
+     * The buffers of the batched reads, kept between polls.
+     */
+    std::vector<std::array<char, 32>> batchBuffers{};
+
+    /**
+     * The batched reads, kept between polls.
+     */
+    std::vector<power::util::BatchRead> batchReads{};
+};
+
+} // namespace pmbus
+} // namespace phosphor
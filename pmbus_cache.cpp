@@ -0,0 +1,207 @@
+/**
+ * Copyright © 2026 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "pmbus_cache.hpp"
+
+#include <type_traits>
+
+namespace phosphor
+{
+namespace pmbus
+{
+
+size_t CachedPMBus::getHitCount() const
+{
+    std::lock_guard lock{mutex};
+    return hits;
+}
+
+size_t CachedPMBus::getMissCount() const
+{
+    std::lock_guard lock{mutex};
+    return misses;
+}
+
+void CachedPMBus::invalidate()
+{
+    std::lock_guard lock{mutex};
+    ++generation;
+
+    // The entries are kept, since other threads may be waiting on them
+    for (auto& [key, entry] : numbers)
+    {
+        entry.value.reset();
+    }
+    for (auto& [key, entry] : strings)
+    {
+        entry.value.reset();
+    }
+}
+
+std::chrono::milliseconds CachedPMBus::getTTL(const RegisterKey& key) const
+{
+    auto it = ttls.find(key);
+    return (it != ttls.end()) ? it->second : std::chrono::milliseconds{0};
+}
+
+template <typename T, typename Read>
+auto CachedPMBus::cachedRead(Cache<T>& cache, const RegisterKey& key,
+                             Read read) -> decltype(read())
+{
+    using Result = decltype(read());
+
+    auto ttl = getTTL(key);
+    if (ttl.count() <= 0)
+    {
+        return read();
+    }
+
+    uint64_t readGeneration{0};
+    {
+        std::unique_lock lock{mutex};
+        Entry<T>& entry = cache[key];
+
+        // Use the value of a read that is in flight instead of reading again
+        readDone.wait(lock, [&entry]() { return !entry.inFlight; });
+        if (entry.value && (std::chrono::steady_clock::now() < entry.expiry))
+        {
+            ++hits;
+            if constexpr (std::is_same_v<Result, T>)
+            {
+                return *entry.value;
+            }
+            else
+            {
+                return Result{*entry.value, 0};
+            }
+        }
+
+        ++misses;
+        entry.inFlight = true;
+        readGeneration = generation;
+    }
+
+    // Caches the value, unless the read failed or the cache was invalidated
+    auto finish = [&](std::optional<T> value) {
+        {
+            std::lock_guard lock{mutex};
+            Entry<T>& entry = cache[key];
+            entry.inFlight = false;
+            if (value && (generation == readGeneration))
+            {
+                entry.value = std::move(value);
+                entry.expiry = std::chrono::steady_clock::now() + ttl;
+            }
+        }
+        readDone.notify_all();
+    };
+
+    try
+    {
+        Result result = read();
+        if constexpr (std::is_same_v<Result, T>)
+        {
+            finish(result);
+        }
+        else
+        {
+            finish(result ? std::optional<T>{result.value} : std::nullopt);
+        }
+        return result;
+    }
+    catch (...)
+    {
+        finish(std::nullopt);
+        throw;
+    }
+}
+
+uint64_t CachedPMBus::read(const std::string& name, Type type)
+{
+    return cachedRead(numbers, RegisterKey{type, name},
+                      [&]() { return pmbus->read(name, type); });
+}
+
+StatusSnapshot
+    CachedPMBus::readStatusSnapshot(const std::vector<std::string>& names,
+                                    Type type)
+{
+    return pmbus->readStatusSnapshot(names, type);
+}
+
+std::string CachedPMBus::readString(const std::string& name, Type type)
+{
+    return cachedRead(strings, RegisterKey{type, name},
+                      [&]() { return pmbus->readString(name, type); });
+}
+
+ReadResult<uint64_t> CachedPMBus::tryRead(const std::string& name, Type type)
+{
+    return cachedRead(numbers, RegisterKey{type, name},
+                      [&]() { return pmbus->tryRead(name, type); });
+}
+
+ReadResult<std::string> CachedPMBus::tryReadString(const std::string& name,
+                                                   Type type)
+{
+    return cachedRead(strings, RegisterKey{type, name},
+                      [&]() { return pmbus->tryReadString(name, type); });
+}
+
+std::string CachedPMBus::readCachedString(const std::string& name, Type type,
+                                          bool refresh)
+{
+    return pmbus->readCachedString(name, type, refresh);
+}
+
+void CachedPMBus::clearStringCache()
+{
+    invalidate();
+    pmbus->clearStringCache();
+}
+
+std::vector<fs::path> CachedPMBus::getAlarmFiles()
+{
+    return pmbus->getAlarmFiles();
+}
+
+size_t CachedPMBus::readBlock(const std::string& name, Type type,
+                              std::span<uint8_t> buffer)
+{
+    return pmbus->readBlock(name, type, buffer);
+}
+
+void CachedPMBus::writeBinary(const std::string& name,
+                              std::span<const uint8_t> data, Type type)
+{
+    // A write can change the values of other registers
+    invalidate();
+    pmbus->writeBinary(name, data, type);
+}
+
+void CachedPMBus::findHwmonDir()
+{
+    invalidate();
+    pmbus->findHwmonDir();
+}
+
+std::string CachedPMBus::insertPageNum(const std::string& templateName,
+                                       size_t page)
+{
+    return pmbus->insertPageNum(templateName, page);
+}
+
+} // namespace pmbus
+} // namespace phosphor
@@ -0,0 +1,219 @@
+#pragma once
+
+#include "pmbus.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace phosphor
+{
+namespace pmbus
+{
+
+/**
+ * @class CachedPMBus
+ *
+ * Keeps the values read from a PMBus device for a time to live (TTL) set
+ * per register, so callers that read the same register several times per
+ * cycle do not each access the bus.
+ *
+ * Registers without a TTL, such as the status registers, are always read
+ * from the device.  Failed reads are not cached.  When several threads
+ * read an expired register at the same time, one reads the device and the
+ * others wait for its value.
+ *
+ * read() and tryRead() share the cached numbers, and readString() and
+ * tryReadString() the cached strings.  Snapshots are not cached.  Writes,
+ * findHwmonDir(), and clearStringCache() discard the cached values.
+ */
+class CachedPMBus : public PMBusBase
+{
+  public:
+    /**
+     * Identifies a register of a device by path type and file name.
+     */
+    using RegisterKey = std::pair<Type, std::string>;
+
+    CachedPMBus() = delete;
+    CachedPMBus(const CachedPMBus&) = delete;
+    CachedPMBus& operator=(const CachedPMBus&) = delete;
+    CachedPMBus(CachedPMBus&&) = delete;
+    CachedPMBus& operator=(CachedPMBus&&) = delete;
+    ~CachedPMBus() override = default;
+
+    /**
+     * Constructor
+     *
+     * @param[in] pmbus - the interface used to access the device
+     * @param[in] ttls - the time each register is cached, by path type and
+     *                   file name
+     */
+    explicit CachedPMBus(
+        std::unique_ptr<PMBusBase> pmbus,
+        std::map<RegisterKey, std::chrono::milliseconds> ttls = {}) :
+        pmbus{std::move(pmbus)},
+        ttls{std::move(ttls)}
+    {}
+
+    /**
+     * Returns the interface used to access the device.
+     *
+     * @return PMBusBase& - the interface
+     */
+    PMBusBase& getPMBus() const
+    {
+        return *pmbus;
+    }
+
+    /**
+     * Returns the number of reads returned from the cache.
+     *
+     * @return size_t - the number of hits
+     */
+    size_t getHitCount() const;
+
+    /**
+     * Returns the number of reads of registers with a TTL that accessed the
+     * device.
+     *
+     * @return size_t - the number of misses
+     */
+    size_t getMissCount() const;
+
+    /**
+     * Discards the cached values.
+     */
+    void invalidate();
+
+    uint64_t read(const std::string& name, Type type) override;
+    StatusSnapshot readStatusSnapshot(const std::vector<std::string>& names,
+                                      Type type) override;
+    std::string readString(const std::string& name, Type type) override;
+    ReadResult<uint64_t> tryRead(const std::string& name, Type type) override;
+    ReadResult<std::string> tryReadString(const std::string& name,
+                                          Type type) override;
+    std::string readCachedString(const std::string& name, Type type,
+                                 bool refresh) override;
+    void clearStringCache() override;
+    std::vector<fs::path> getAlarmFiles() override;
+    size_t readBlock(const std::string& name, Type type,
+                     std::span<uint8_t> buffer) override;
+    void writeBinary(const std::string& name, std::span<const uint8_t> data,
+                     Type type) override;
+    void findHwmonDir() override;
+    std::string insertPageNum(const std::string& templateName,
+                              size_t page) override;
+
+    const fs::path& path() const override
+    {
+        return pmbus->path();
+    }
+
+  private:
+    /**
+     * A cached register value.
+     */
+    template <typename T>
+    struct Entry
+    {
+        /**
+         * The value, or no value if it was discarded.
+         */
+        std::optional<T> value{};
+
+        /**
+         * The time the value expires.
+         */
+        std::chrono::steady_clock::time_point expiry{};
+
+        /**
+         * Whether a thread is reading the register from the device.
+         */
+        bool inFlight{false};
+    };
+
+    template <typename T>
+    using Cache = std::map<RegisterKey, Entry<T>>;
+
+    /**
+     * Returns the time a register is cached.
+     *
+     * @param[in] key - the register
+     *
+     * @return milliseconds - the TTL, or 0 if the register is not cached
+     */
+    std::chrono::milliseconds getTTL(const RegisterKey& key) const;
+
+    /**
+     * Reads a register through the cache.
+     *
+     * @param[in] cache - the cached values of the type
+     * @param[in] key - the register
+     * @param[in] read - reads the device; returns an empty optional or
+     *                   throws if the read failed
+     *
+     * @return the result of read, or the cached value
+     */
+    template <typename T, typename Read>
+    auto cachedRead(Cache<T>& cache, const RegisterKey& key, Read read)
+        -> decltype(read());
+
+    /**
+     * The interface used to access the device.
+     */
+    std::unique_ptr<PMBusBase> pmbus;
+
+    /**
+     * The time each register is cached.
+     */
+    std::map<RegisterKey, std::chrono::milliseconds> ttls;
+
+    /**
+     * Protects the members below.
+     */
+    mutable std::mutex mutex;
+
+    /**
+     * Signaled when a read of the device finishes.
+     */
+    std::condition_variable readDone;
+
+    /**
+     * Incremented when the values are discarded, so a read that was in
+     * flight does not cache its value.
+     */
+    uint64_t generation{0};
+
+    /**
+     * The cached numbers.
+     */
+    Cache<uint64_t> numbers{};
+
+    /**
+     * The cached strings.
+     */
+    Cache<std::string> strings{};
+
+    /**
+     * The number of hits.
+     */
+    size_t hits{0};
+
+    /**
+     * The number of misses.
+     */
+    size_t misses{0};
+};
+
+} // namespace pmbus
+} // namespace phosphor
@@ -0,0 +1,199 @@
+/**
+ * Copyright © 2026 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "pmbus_scheduler.hpp"
+
+#include <algorithm>
+
+namespace phosphor
+{
+namespace pmbus
+{
+
+PMBusScheduler::PMBusScheduler(unsigned int criticalWeight) :
+    criticalWeight{std::max(criticalWeight, 1u)}
+{}
+
+PMBusScheduler::Grant PMBusScheduler::acquire(Priority priority)
+{
+    auto index = static_cast<size_t>(priority);
+    auto start = std::chrono::steady_clock::now();
+
+    std::unique_lock lock{mutex};
+    ++waiting[index];
+    released.wait(lock, [this, priority]() { return canRun(priority); });
+    --waiting[index];
+
+    busy = true;
+    criticalRun = (priority == Priority::critical) ? criticalRun + 1 : 0;
+    ++grants[index];
+    maxWait[index] = std::max(
+        maxWait[index], std::chrono::duration_cast<std::chrono::microseconds>(
+                            std::chrono::steady_clock::now() - start));
+    return Grant{*this};
+}
+
+size_t PMBusScheduler::getGrantCount(Priority priority) const
+{
+    std::lock_guard lock{mutex};
+    return grants[static_cast<size_t>(priority)];
+}
+
+std::chrono::microseconds PMBusScheduler::getMaxWait(Priority priority) const
+{
+    std::lock_guard lock{mutex};
+    return maxWait[static_cast<size_t>(priority)];
+}
+
+size_t PMBusScheduler::getWaitingCount(Priority priority) const
+{
+    std::lock_guard lock{mutex};
+    return waiting[static_cast<size_t>(priority)];
+}
+
+bool PMBusScheduler::canRun(Priority priority) const
+{
+    if (busy)
+    {
+        return false;
+    }
+
+    // A bulk request runs once criticalWeight critical requests have run
+    // while it waited
+    if (priority == Priority::critical)
+    {
+        return (waiting[static_cast<size_t>(Priority::bulk)] == 0) ||
+               (criticalRun < criticalWeight);
+    }
+    return (waiting[static_cast<size_t>(Priority::critical)] == 0) ||
+           (criticalRun >= criticalWeight);
+}
+
+void PMBusScheduler::release()
+{
+    {
+        std::lock_guard lock{mutex};
+        busy = false;
+    }
+    released.notify_all();
+}
+
+uint64_t ScheduledPMBus::read(const std::string& name, Type type)
+{
+    auto grant = scheduler->acquire(priority);
+    return pmbus->read(name, type);
+}
+
+StatusSnapshot
+    ScheduledPMBus::readStatusSnapshot(const std::vector<std::string>& names,
+                                       Type type)
+{
+    if (priority == Priority::critical)
+    {
+        auto grant = scheduler->acquire(priority);
+        return pmbus->readStatusSnapshot(names, type);
+    }
+
+    // Read one register per grant so critical requests can run in between
+    StatusSnapshot snapshot;
+    snapshot.values.reserve(names.size());
+    snapshot.valid.reserve(names.size());
+    for (const auto& name : names)
+    {
+        StatusSnapshot part;
+        {
+            auto grant = scheduler->acquire(priority);
+            part = pmbus->readStatusSnapshot({name}, type);
+        }
+        if (snapshot.values.empty())
+        {
+            snapshot.timestamp = part.timestamp;
+        }
+        bool valid = (part.values.size() == 1) && (part.valid.size() == 1);
+        snapshot.values.push_back(valid ? part.values[0] : 0);
+        snapshot.valid.push_back(valid && part.valid[0]);
+    }
+    return snapshot;
+}
+
+std::string ScheduledPMBus::readString(const std::string& name, Type type)
+{
+    auto grant = scheduler->acquire(priority);
+    return pmbus->readString(name, type);
+}
+
+ReadResult<uint64_t> ScheduledPMBus::tryRead(const std::string& name,
+                                             Type type)
+{
+    auto grant = scheduler->acquire(priority);
+    return pmbus->tryRead(name, type);
+}
+
+ReadResult<std::string> ScheduledPMBus::tryReadString(const std::string& name,
+                                                      Type type)
+{
+    auto grant = scheduler->acquire(priority);
+    return pmbus->tryReadString(name, type);
+}
+
+std::string ScheduledPMBus::readCachedString(const std::string& name,
+                                             Type type, bool refresh)
+{
+    auto grant = scheduler->acquire(priority);
+    return pmbus->readCachedString(name, type, refresh);
+}
+
+void ScheduledPMBus::clearStringCache()
+{
+    auto grant = scheduler->acquire(priority);
+    pmbus->clearStringCache();
+}
+
+std::vector<fs::path> ScheduledPMBus::getAlarmFiles()
+{
+    auto grant = scheduler->acquire(priority);
+    return pmbus->getAlarmFiles();
+}
+
+size_t ScheduledPMBus::readBlock(const std::string& name, Type type,
+                                 std::span<uint8_t> buffer)
+{
+    auto grant = scheduler->acquire(priority);
+    return pmbus->readBlock(name, type, buffer);
+}
+
+void ScheduledPMBus::writeBinary(const std::string& name,
+                                 std::span<const uint8_t> data, Type type)
+{
+    auto grant = scheduler->acquire(priority);
+    pmbus->writeBinary(name, data, type);
+}
+
+void ScheduledPMBus::findHwmonDir()
+{
+    auto grant = scheduler->acquire(priority);
+    pmbus->findHwmonDir();
+}
+
+std::string ScheduledPMBus::insertPageNum(const std::string& templateName,
+                                          size_t page)
+{
+    // The names are cached by the device, so this is serialized too
+    auto grant = scheduler->acquire(priority);
+    return pmbus->insertPageNum(templateName, page);
+}
+
+} // namespace pmbus
+} // namespace phosphor
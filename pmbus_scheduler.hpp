@@ -0,0 +1,287 @@
+#pragma once
+
+#include "pmbus.hpp"
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace phosphor
+{
+namespace pmbus
+{
+
+/**
+ * The scheduling class of a PMBus request.
+ */
+enum class Priority
+{
+    critical, // fault detection, such as STATUS_WORD reads
+    bulk      // telemetry, energy, and history reads
+};
+
+/**
+ * The number of values of Priority
+ */
+constexpr size_t NUM_PRIORITIES = 2;
+
+/**
+ * @class PMBusScheduler
+ *
+ * Orders the requests to the PMBus devices that share a bus, so fault
+ * detection is not delayed by telemetry.
+ *
+ * One request runs at a time.  When both classes are waiting, up to
+ * criticalWeight critical requests run for each bulk request, so a
+ * critical request waits for at most one bulk request, and bulk requests
+ * still progress during a stream of critical ones.
+ *
+ * The scheduler is thread safe.  ScheduledPMBus takes a grant for each
+ * request; large bulk requests are split so critical ones can run between
+ * the parts.
+ */
+class PMBusScheduler
+{
+  public:
+    /**
+     * The default number of critical requests run for each bulk request.
+     */
+    static constexpr unsigned int defaultCriticalWeight{4};
+
+    /**
+     * @class Grant
+     *
+     * Permission to run one request.  The next request is scheduled when
+     * the grant is destroyed.
+     */
+    class Grant
+    {
+      public:
+        Grant(const Grant&) = delete;
+        Grant& operator=(const Grant&) = delete;
+        Grant(Grant&&) = delete;
+        Grant& operator=(Grant&&) = delete;
+
+        ~Grant()
+        {
+            scheduler.release();
+        }
+
+      private:
+        friend class PMBusScheduler;
+
+        explicit Grant(PMBusScheduler& scheduler) : scheduler{scheduler} {}
+
+        /**
+         * The scheduler that gave the grant.
+         */
+        PMBusScheduler& scheduler;
+    };
+
+    PMBusScheduler(const PMBusScheduler&) = delete;
+    PMBusScheduler& operator=(const PMBusScheduler&) = delete;
+    PMBusScheduler(PMBusScheduler&&) = delete;
+    PMBusScheduler& operator=(PMBusScheduler&&) = delete;
+    ~PMBusScheduler() = default;
+
+    /**
+     * Constructor
+     *
+     * @param[in] criticalWeight - the number of critical requests run for
+     *                             each bulk request when both are waiting;
+     *                             at least 1
+     */
+    explicit PMBusScheduler(
+        unsigned int criticalWeight = defaultCriticalWeight);
+
+    /**
+     * Waits until a request of the specified class may run.
+     *
+     * @param[in] priority - the class of the request
+     *
+     * @return Grant - held while the request runs
+     */
+    [[nodiscard]] Grant acquire(Priority priority);
+
+    /**
+     * Returns the number of requests of a class that have run.
+     *
+     * @param[in] priority - the class of the requests
+     *
+     * @return size_t - the number of grants
+     */
+    size_t getGrantCount(Priority priority) const;
+
+    /**
+     * Returns the longest time a request of a class waited for its grant.
+     *
+     * @param[in] priority - the class of the requests
+     *
+     * @return microseconds - the longest wait
+     */
+    std::chrono::microseconds getMaxWait(Priority priority) const;
+
+    /**
+     * Returns the number of requests of a class waiting for a grant.
+     *
+     * @param[in] priority - the class of the requests
+     *
+     * @return size_t - the number of waiting requests
+     */
+    size_t getWaitingCount(Priority priority) const;
+
+  private:
+    /**
+     * Returns whether a request of the specified class may run now.  Must
+     * be called with the mutex locked.
+     *
+     * @param[in] priority - the class of the request
+     *
+     * @return bool - true if it may run
+     */
+    bool canRun(Priority priority) const;
+
+    /**
+     * Ends the running request and wakes the waiting ones.
+     */
+    void release();
+
+    /**
+     * The number of critical requests run for each bulk request.
+     */
+    unsigned int criticalWeight;
+
+    /**
+     * Protects the members below.
+     */
+    mutable std::mutex mutex;
+
+    /**
+     * Signaled when a request ends.
+     */
+    std::condition_variable released;
+
+    /**
+     * Whether a request is running.
+     */
+    bool busy{false};
+
+    /**
+     * The number of critical requests run since the last bulk one.
+     */
+    unsigned int criticalRun{0};
+
+    /**
+     * The number of waiting requests, by class.
+     */
+    std::array<size_t, NUM_PRIORITIES> waiting{};
+
+    /**
+     * The number of grants, by class.
+     */
+    std::array<size_t, NUM_PRIORITIES> grants{};
+
+    /**
+     * The longest wait for a grant, by class.
+     */
+    std::array<std::chrono::microseconds, NUM_PRIORITIES> maxWait{};
+};
+
+/**
+ * @class ScheduledPMBus
+ *
+ * Accesses a PMBus device through a PMBusScheduler with one priority class.
+ *
+ * Several instances with different classes may share the device and the
+ * scheduler, such as one for the status reads of the fault path and one
+ * for telemetry.  Since the scheduler runs one request at a time, the
+ * shared device is never accessed concurrently.
+ *
+ * Bulk snapshots are read one register per grant, so critical requests can
+ * run between them.  Other requests are not split.
+ */
+class ScheduledPMBus : public PMBusBase
+{
+  public:
+    ScheduledPMBus() = delete;
+    ScheduledPMBus(const ScheduledPMBus&) = delete;
+    ScheduledPMBus& operator=(const ScheduledPMBus&) = delete;
+    ScheduledPMBus(ScheduledPMBus&&) = delete;
+    ScheduledPMBus& operator=(ScheduledPMBus&&) = delete;
+    ~ScheduledPMBus() override = default;
+
+    /**
+     * Constructor
+     *
+     * @param[in] pmbus - the interface used to access the device
+     * @param[in] scheduler - the scheduler of the bus the device is on
+     * @param[in] priority - the class of the requests
+     */
+    ScheduledPMBus(std::shared_ptr<PMBusBase> pmbus,
+                   std::shared_ptr<PMBusScheduler> scheduler,
+                   Priority priority) :
+        pmbus{std::move(pmbus)},
+        scheduler{std::move(scheduler)}, priority{priority}
+    {}
+
+    /**
+     * Returns the interface used to access the device.
+     *
+     * @return PMBusBase& - the interface
+     */
+    PMBusBase& getPMBus() const
+    {
+        return *pmbus;
+    }
+
+    uint64_t read(const std::string& name, Type type) override;
+    StatusSnapshot readStatusSnapshot(const std::vector<std::string>& names,
+                                      Type type) override;
+    std::string readString(const std::string& name, Type type) override;
+    ReadResult<uint64_t> tryRead(const std::string& name, Type type) override;
+    ReadResult<std::string> tryReadString(const std::string& name,
+                                          Type type) override;
+    std::string readCachedString(const std::string& name, Type type,
+                                 bool refresh) override;
+    void clearStringCache() override;
+    std::vector<fs::path> getAlarmFiles() override;
+    size_t readBlock(const std::string& name, Type type,
+                     std::span<uint8_t> buffer) override;
+    void writeBinary(const std::string& name, std::span<const uint8_t> data,
+                     Type type) override;
+    void findHwmonDir() override;
+    std::string insertPageNum(const std::string& templateName,
+                              size_t page) override;
+
+    const fs::path& path() const override
+    {
+        return pmbus->path();
+    }
+
+  private:
+    /**
+     * The interface used to access the device.
+     */
+    std::shared_ptr<PMBusBase> pmbus;
+
+    /**
+     * The scheduler of the bus the device is on.
+     */
+    std::shared_ptr<PMBusScheduler> scheduler;
+
+    /**
+     * The class of the requests.
+     */
+    Priority priority;
+};
+
+} // namespace pmbus
+} // namespace phosphor
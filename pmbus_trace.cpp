@@ -0,0 +1,521 @@
+/**
+ * Copyright © 2026 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "pmbus_trace.hpp"
+
+#include "flight_recorder.hpp"
+
+#include <phosphor-logging/elog-errors.hpp>
+#include <phosphor-logging/elog.hpp>
+#include <xyz/openbmc_project/Common/Device/error.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstdio>
+#include <limits>
+#include <thread>
+#include <utility>
+
+namespace phosphor
+{
+namespace pmbus
+{
+
+using namespace phosphor::logging;
+using namespace sdbusplus::xyz::openbmc_project::Common::Device::Error;
+
+namespace
+{
+
+/**
+ * Returns whether a recorded access is a PMBus file access.
+ *
+ * @param[in] record - the recorded access
+ *
+ * @return bool - true if it was recorded by a TracedPMBus
+ */
+bool isPMBusRecord(const i2c::TraceRecord& record)
+{
+    return record.op >= static_cast<uint8_t>(i2c::TraceOp::pmbusRead);
+}
+
+/**
+ * Returns the bytes of a string.
+ *
+ * @param[in] value - the string
+ *
+ * @return span - the bytes, valid while the string is
+ */
+std::span<const uint8_t> getBytes(const std::string& value)
+{
+    return {reinterpret_cast<const uint8_t*>(value.data()), value.size()};
+}
+
+} // namespace
+
+void TracedPMBus::record(i2c::TraceOp op, const std::string& name, Type type,
+                         std::chrono::steady_clock::time_point start,
+                         std::chrono::steady_clock::duration duration,
+                         int error, std::span<const uint8_t> data)
+{
+    std::shared_ptr<i2c::TraceWriter> writer = i2c::getTraceWriter();
+    if (!writer)
+    {
+        return;
+    }
+
+    using namespace std::chrono;
+    i2c::TraceRecord record{};
+    record.time = static_cast<uint64_t>(
+        duration_cast<nanoseconds>(start.time_since_epoch()).count());
+    record.duration = static_cast<uint32_t>(std::min<int64_t>(
+        duration_cast<microseconds>(duration).count(),
+        std::numeric_limits<uint32_t>::max()));
+    record.result = error;
+    record.command = i2c::FlightRecorder::noCommand;
+    record.op = static_cast<uint8_t>(op);
+    record.busId = busId;
+    record.addr = addr;
+    record.pathType = static_cast<uint8_t>(type);
+    writer->record(record, name,
+                   (error == 0) ? data : std::span<const uint8_t>{});
+}
+
+void TracedPMBus::recordValue(const std::string& name, Type type,
+                              std::chrono::steady_clock::time_point start,
+                              std::chrono::steady_clock::duration duration,
+                              int error, uint64_t value)
+{
+    std::array<uint8_t, sizeof(value)> bytes{};
+    for (size_t i = 0; i < bytes.size(); ++i)
+    {
+        bytes[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+    record(i2c::TraceOp::pmbusRead, name, type, start, duration, error,
+           bytes);
+}
+
+void TracedPMBus::recordSnapshot(const std::vector<std::string>& names,
+                                 Type type,
+                                 std::chrono::steady_clock::time_point start,
+                                 std::chrono::steady_clock::duration duration,
+                                 const StatusSnapshot& snapshot)
+{
+    if (names.empty())
+    {
+        return;
+    }
+    auto each = duration / static_cast<int64_t>(names.size());
+    for (size_t i = 0; i < names.size(); ++i)
+    {
+        bool valid = (i < snapshot.valid.size()) && snapshot.valid[i];
+        uint64_t value = (i < snapshot.values.size()) ? snapshot.values[i] : 0;
+        recordValue(names[i], type, start + each * static_cast<int64_t>(i),
+                    each, valid ? 0 : EIO, value);
+    }
+}
+
+uint64_t TracedPMBus::read(const std::string& name, Type type)
+{
+    if (!i2c::isTracing())
+    {
+        return pmbus->read(name, type);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    uint64_t value{0};
+    try
+    {
+        value = pmbus->read(name, type);
+    }
+    catch (...)
+    {
+        recordValue(name, type, start, std::chrono::steady_clock::now() - start,
+                    EIO, 0);
+        throw;
+    }
+    recordValue(name, type, start, std::chrono::steady_clock::now() - start, 0,
+                value);
+    return value;
+}
+
+StatusSnapshot
+    TracedPMBus::readStatusSnapshot(const std::vector<std::string>& names,
+                                    Type type)
+{
+    if (!i2c::isTracing())
+    {
+        return pmbus->readStatusSnapshot(names, type);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    StatusSnapshot snapshot = pmbus->readStatusSnapshot(names, type);
+    recordSnapshot(names, type, start, std::chrono::steady_clock::now() - start,
+                   snapshot);
+    return snapshot;
+}
+
+std::string TracedPMBus::readString(const std::string& name, Type type)
+{
+    if (!i2c::isTracing())
+    {
+        return pmbus->readString(name, type);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::string value{};
+    try
+    {
+        value = pmbus->readString(name, type);
+    }
+    catch (...)
+    {
+        record(i2c::TraceOp::pmbusReadString, name, type, start,
+               std::chrono::steady_clock::now() - start, EIO, {});
+        throw;
+    }
+    record(i2c::TraceOp::pmbusReadString, name, type, start,
+           std::chrono::steady_clock::now() - start, 0, getBytes(value));
+    return value;
+}
+
+ReadResult<uint64_t> TracedPMBus::tryRead(const std::string& name, Type type)
+{
+    if (!i2c::isTracing())
+    {
+        return pmbus->tryRead(name, type);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    ReadResult<uint64_t> result = pmbus->tryRead(name, type);
+    recordValue(name, type, start, std::chrono::steady_clock::now() - start,
+                result.error, result.value);
+    return result;
+}
+
+ReadResult<std::string> TracedPMBus::tryReadString(const std::string& name,
+                                                   Type type)
+{
+    if (!i2c::isTracing())
+    {
+        return pmbus->tryReadString(name, type);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    ReadResult<std::string> result = pmbus->tryReadString(name, type);
+    record(i2c::TraceOp::pmbusReadString, name, type, start,
+           std::chrono::steady_clock::now() - start, result.error,
+           getBytes(result.value));
+    return result;
+}
+
+std::string TracedPMBus::readCachedString(const std::string& name, Type type,
+                                          bool refresh)
+{
+    if (!i2c::isTracing())
+    {
+        return pmbus->readCachedString(name, type, refresh);
+    }
+
+    // Recorded as a string read, so the replay does not depend on what the
+    // wrapped interface had cached
+    auto start = std::chrono::steady_clock::now();
+    std::string value{};
+    try
+    {
+        value = pmbus->readCachedString(name, type, refresh);
+    }
+    catch (...)
+    {
+        record(i2c::TraceOp::pmbusReadString, name, type, start,
+               std::chrono::steady_clock::now() - start, EIO, {});
+        throw;
+    }
+    record(i2c::TraceOp::pmbusReadString, name, type, start,
+           std::chrono::steady_clock::now() - start, 0, getBytes(value));
+    return value;
+}
+
+void TracedPMBus::clearStringCache()
+{
+    pmbus->clearStringCache();
+}
+
+std::vector<fs::path> TracedPMBus::getAlarmFiles()
+{
+    return pmbus->getAlarmFiles();
+}
+
+size_t TracedPMBus::readBlock(const std::string& name, Type type,
+                              std::span<uint8_t> buffer)
+{
+    if (!i2c::isTracing())
+    {
+        return pmbus->readBlock(name, type, buffer);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    size_t size = pmbus->readBlock(name, type, buffer);
+    record(i2c::TraceOp::pmbusReadBlock, name, type, start,
+           std::chrono::steady_clock::now() - start, 0, buffer.first(size));
+    return size;
+}
+
+bool TracedPMBus::prepareSnapshot(const std::vector<std::string>& names,
+                                  Type type, std::vector<int>& fds)
+{
+    return pmbus->prepareSnapshot(names, type, fds);
+}
+
+StatusSnapshot TracedPMBus::completeSnapshot(
+    const std::vector<std::string>& names, Type type,
+    std::span<const power::util::BatchRead> reads)
+{
+    StatusSnapshot snapshot = pmbus->completeSnapshot(names, type, reads);
+    if (i2c::isTracing())
+    {
+        // The batch was read with the files of other devices, so the time
+        // of these reads is not known
+        recordSnapshot(names, type, snapshot.timestamp,
+                       std::chrono::steady_clock::duration{0}, snapshot);
+    }
+    return snapshot;
+}
+
+void TracedPMBus::writeBinary(const std::string& name,
+                              std::span<const uint8_t> data, Type type)
+{
+    if (!i2c::isTracing())
+    {
+        pmbus->writeBinary(name, data, type);
+        return;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    try
+    {
+        pmbus->writeBinary(name, data, type);
+    }
+    catch (...)
+    {
+        record(i2c::TraceOp::pmbusWrite, name, type, start,
+               std::chrono::steady_clock::now() - start, EIO, {});
+        throw;
+    }
+    record(i2c::TraceOp::pmbusWrite, name, type, start,
+           std::chrono::steady_clock::now() - start, 0, data);
+}
+
+void TracedPMBus::findHwmonDir()
+{
+    pmbus->findHwmonDir();
+}
+
+std::string TracedPMBus::insertPageNum(const std::string& templateName,
+                                       size_t page)
+{
+    return pmbus->insertPageNum(templateName, page);
+}
+
+ReplayPMBus::ReplayPMBus(uint8_t busId, uint8_t addr,
+                         const std::vector<i2c::TraceEntry>& entries,
+                         bool loop, bool useRecordedTiming) :
+    busId{busId},
+    addr{addr}, loop{loop}, useRecordedTiming{useRecordedTiming}
+{
+    // Named like the devices created by createPMBus()
+    char address[8]{};
+    std::snprintf(address, sizeof(address), "%04x", addr);
+    devicePath = fs::path{"/sys/bus/i2c/devices"} /
+                 (std::to_string(busId) + "-" + address);
+
+    for (const i2c::TraceEntry& entry : entries)
+    {
+        if ((entry.record.busId == busId) && (entry.record.addr == addr) &&
+            isPMBusRecord(entry.record))
+        {
+            QueueKey key{static_cast<i2c::TraceOp>(entry.record.op),
+                         static_cast<Type>(entry.record.pathType), entry.name};
+            queues[key].entries.emplace_back(entry);
+        }
+    }
+}
+
+std::vector<std::unique_ptr<ReplayPMBus>>
+    ReplayPMBus::load(const std::filesystem::path& path, bool loop,
+                      bool useRecordedTiming)
+{
+    std::vector<i2c::TraceEntry> entries = i2c::readTrace(path);
+
+    std::map<std::pair<uint8_t, uint8_t>, std::vector<i2c::TraceEntry>>
+        devices{};
+    for (i2c::TraceEntry& entry : entries)
+    {
+        if (isPMBusRecord(entry.record))
+        {
+            devices[{entry.record.busId, entry.record.addr}].emplace_back(
+                std::move(entry));
+        }
+    }
+
+    std::vector<std::unique_ptr<ReplayPMBus>> interfaces{};
+    for (const auto& [device, deviceEntries] : devices)
+    {
+        interfaces.emplace_back(std::make_unique<ReplayPMBus>(
+            device.first, device.second, deviceEntries, loop,
+            useRecordedTiming));
+    }
+    return interfaces;
+}
+
+size_t ReplayPMBus::getMissCount() const
+{
+    std::lock_guard lock{mutex};
+    return misses;
+}
+
+int ReplayPMBus::replay(const QueueKey& key, std::vector<uint8_t>& data)
+{
+    std::chrono::microseconds duration{0};
+    int error{0};
+    {
+        std::lock_guard lock{mutex};
+        auto it = queues.find(key);
+        if ((it != queues.end()) && loop &&
+            (it->second.next == it->second.entries.size()))
+        {
+            it->second.next = 0;
+        }
+        if ((it == queues.end()) ||
+            (it->second.next == it->second.entries.size()))
+        {
+            ++misses;
+            return ENODATA;
+        }
+
+        const i2c::TraceEntry& entry = it->second.entries[it->second.next++];
+        duration = std::chrono::microseconds{entry.record.duration};
+        error = entry.record.result;
+        if (error == 0)
+        {
+            data = entry.data;
+        }
+    }
+
+    if (useRecordedTiming)
+    {
+        std::this_thread::sleep_for(duration);
+    }
+    return error;
+}
+
+void ReplayPMBus::fail(bool write, int error) const
+{
+    if (write)
+    {
+        using metadata = xyz::openbmc_project::Common::Device::WriteFailure;
+
+        elog<WriteFailure>(metadata::CALLOUT_ERRNO(error),
+                           metadata::CALLOUT_DEVICE_PATH(devicePath.c_str()));
+    }
+
+    using metadata = xyz::openbmc_project::Common::Device::ReadFailure;
+
+    elog<ReadFailure>(metadata::CALLOUT_ERRNO(error),
+                      metadata::CALLOUT_DEVICE_PATH(devicePath.c_str()));
+}
+
+uint64_t ReplayPMBus::read(const std::string& name, Type type)
+{
+    ReadResult<uint64_t> result = tryRead(name, type);
+    if (!result)
+    {
+        fail(false, result.error);
+    }
+    return result.value;
+}
+
+std::string ReplayPMBus::readString(const std::string& name, Type type)
+{
+    ReadResult<std::string> result = tryReadString(name, type);
+    if (!result)
+    {
+        fail(false, result.error);
+    }
+    return result.value;
+}
+
+ReadResult<uint64_t> ReplayPMBus::tryRead(const std::string& name, Type type)
+{
+    std::vector<uint8_t> data{};
+    ReadResult<uint64_t> result{};
+    result.error = replay({i2c::TraceOp::pmbusRead, type, name}, data);
+    for (size_t i = 0; i < std::min(data.size(), sizeof(uint64_t)); ++i)
+    {
+        result.value |= static_cast<uint64_t>(data[i]) << (8 * i);
+    }
+    return result;
+}
+
+ReadResult<std::string> ReplayPMBus::tryReadString(const std::string& name,
+                                                   Type type)
+{
+    std::vector<uint8_t> data{};
+    ReadResult<std::string> result{};
+    result.error = replay({i2c::TraceOp::pmbusReadString, type, name}, data);
+    result.value.assign(data.begin(), data.end());
+    return result;
+}
+
+size_t ReplayPMBus::readBlock(const std::string& name, Type type,
+                              std::span<uint8_t> buffer)
+{
+    std::vector<uint8_t> data{};
+    if (replay({i2c::TraceOp::pmbusReadBlock, type, name}, data) != 0)
+    {
+        return 0;
+    }
+    size_t size = std::min(data.size(), buffer.size());
+    std::copy_n(data.begin(), size, buffer.begin());
+    return size;
+}
+
+void ReplayPMBus::writeBinary(const std::string& name,
+                              std::span<const uint8_t> /*data*/, Type type)
+{
+    std::vector<uint8_t> recorded{};
+    int error = replay({i2c::TraceOp::pmbusWrite, type, name}, recorded);
+    if (error != 0)
+    {
+        fail(true, error);
+    }
+}
+
+std::string ReplayPMBus::insertPageNum(const std::string& templateName,
+                                       size_t page)
+{
+    // Insert the page where the P is, like PMBus
+    std::string name = templateName;
+    auto pos = name.find('P');
+    if (pos != std::string::npos)
+    {
+        name.replace(pos, 1, std::to_string(page));
+    }
+    return name;
+}
+
+} // namespace pmbus
+} // namespace phosphor
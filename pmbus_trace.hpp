@@ -0,0 +1,354 @@
+#pragma once
+
+#include "bus_trace.hpp"
+#include "pmbus.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace phosphor
+{
+namespace pmbus
+{
+
+/**
+ * @class TracedPMBus
+ *
+ * Records the accesses to a PMBus device in the bus trace of the process,
+ * see i2c::startTrace(), so the values the device returned can be replayed
+ * with ReplayPMBus.
+ *
+ * Each read, string read, block read, and write is recorded with the path
+ * type and file name, the time it took, and the value read or the data
+ * written.  The registers of a snapshot are recorded as separate reads.  A
+ * failure is recorded with the errno returned by tryRead(), or EIO when the
+ * wrapped interface threw an exception.  Nothing is recorded while no trace
+ * is started, so wrapping a device costs one check per access.
+ */
+class TracedPMBus : public PMBusBase
+{
+  public:
+    TracedPMBus() = delete;
+    TracedPMBus(const TracedPMBus&) = delete;
+    TracedPMBus& operator=(const TracedPMBus&) = delete;
+    TracedPMBus(TracedPMBus&&) = delete;
+    TracedPMBus& operator=(TracedPMBus&&) = delete;
+    ~TracedPMBus() override = default;
+
+    /**
+     * Constructor
+     *
+     * @param[in] pmbus - the interface used to access the device
+     * @param[in] busId - the I2C bus of the device, recorded in the trace
+     * @param[in] addr - the I2C address of the device, recorded in the trace
+     */
+    TracedPMBus(std::unique_ptr<PMBusBase> pmbus, uint8_t busId,
+                uint8_t addr) :
+        pmbus{std::move(pmbus)},
+        busId{busId}, addr{addr}
+    {}
+
+    /**
+     * Returns the interface used to access the device.
+     *
+     * @return PMBusBase& - the interface
+     */
+    PMBusBase& getPMBus() const
+    {
+        return *pmbus;
+    }
+
+    uint64_t read(const std::string& name, Type type) override;
+    StatusSnapshot readStatusSnapshot(const std::vector<std::string>& names,
+                                      Type type) override;
+    std::string readString(const std::string& name, Type type) override;
+    ReadResult<uint64_t> tryRead(const std::string& name, Type type) override;
+    ReadResult<std::string> tryReadString(const std::string& name,
+                                          Type type) override;
+    std::string readCachedString(const std::string& name, Type type,
+                                 bool refresh) override;
+    void clearStringCache() override;
+    std::vector<fs::path> getAlarmFiles() override;
+    size_t readBlock(const std::string& name, Type type,
+                     std::span<uint8_t> buffer) override;
+    bool prepareSnapshot(const std::vector<std::string>& names, Type type,
+                         std::vector<int>& fds) override;
+    StatusSnapshot completeSnapshot(
+        const std::vector<std::string>& names, Type type,
+        std::span<const power::util::BatchRead> reads) override;
+    void writeBinary(const std::string& name, std::span<const uint8_t> data,
+                     Type type) override;
+    void findHwmonDir() override;
+    std::string insertPageNum(const std::string& templateName,
+                              size_t page) override;
+
+    const fs::path& path() const override
+    {
+        return pmbus->path();
+    }
+
+  private:
+    /**
+     * Records an access in the bus trace, if a trace is started.
+     *
+     * @param[in] op - the kind of access
+     * @param[in] name - the file name
+     * @param[in] type - Path type
+     * @param[in] start - the time the access started
+     * @param[in] duration - the time the access took
+     * @param[in] error - the errno of the failure, or 0 if it succeeded
+     * @param[in] data - the data read or written; ignored if it failed
+     */
+    void record(i2c::TraceOp op, const std::string& name, Type type,
+                std::chrono::steady_clock::time_point start,
+                std::chrono::steady_clock::duration duration, int error,
+                std::span<const uint8_t> data);
+
+    /**
+     * Records a numeric read in the bus trace, if a trace is started.
+     *
+     * @param[in] name - the file name
+     * @param[in] type - Path type
+     * @param[in] start - the time the read started
+     * @param[in] duration - the time the read took
+     * @param[in] error - the errno of the failure, or 0 if it succeeded
+     * @param[in] value - the value read
+     */
+    void recordValue(const std::string& name, Type type,
+                     std::chrono::steady_clock::time_point start,
+                     std::chrono::steady_clock::duration duration, int error,
+                     uint64_t value);
+
+    /**
+     * Records the registers of a snapshot as separate reads, which share
+     * the time the snapshot took.
+     *
+     * @param[in] names - the file names of the registers
+     * @param[in] type - Path type
+     * @param[in] start - the time the snapshot was started
+     * @param[in] duration - the time the snapshot took
+     * @param[in] snapshot - the values read
+     */
+    void recordSnapshot(const std::vector<std::string>& names, Type type,
+                        std::chrono::steady_clock::time_point start,
+                        std::chrono::steady_clock::duration duration,
+                        const StatusSnapshot& snapshot);
+
+    /**
+     * The interface used to access the device.
+     */
+    std::unique_ptr<PMBusBase> pmbus;
+
+    /**
+     * The I2C bus of the device.
+     */
+    uint8_t busId;
+
+    /**
+     * The I2C address of the device.
+     */
+    uint8_t addr;
+};
+
+/**
+ * @class ReplayPMBus
+ *
+ * PMBus device that replays the accesses to one device recorded by a
+ * TracedPMBus, so the code that analyzes the devices can be measured and
+ * tested with what real devices returned, without the hardware.
+ *
+ * The recorded accesses are queued by kind, path type, and file name, so a
+ * replay that reads the files in a different order than the recording
+ * still gets the values each file returned, in the order it returned them.
+ * A failed access fails the same way as the sysfs device: read() and
+ * readString() create a ReadFailure error with the recorded errno,
+ * tryRead() and tryReadString() return it, readBlock() returns 0, and
+ * writeBinary() creates a WriteFailure error.  An access with no recorded
+ * access left fails with ENODATA and is counted as a miss.  Writes are not
+ * compared with the recorded data.  Snapshots are read file by file.
+ */
+class ReplayPMBus : public PMBusBase
+{
+  public:
+    ReplayPMBus() = delete;
+    ReplayPMBus(const ReplayPMBus&) = delete;
+    ReplayPMBus& operator=(const ReplayPMBus&) = delete;
+    ReplayPMBus(ReplayPMBus&&) = delete;
+    ReplayPMBus& operator=(ReplayPMBus&&) = delete;
+    ~ReplayPMBus() override = default;
+
+    /**
+     * Constructor
+     *
+     * @param[in] busId - the I2C bus of the device
+     * @param[in] addr - the I2C address of the device
+     * @param[in] entries - the recorded accesses; those of other devices and
+     *                      the I2C transactions are ignored
+     * @param[in] loop - whether to start a queue over when all of its
+     *                   accesses were replayed
+     * @param[in] useRecordedTiming - whether each access takes the time the
+     *                                recorded one took
+     */
+    ReplayPMBus(uint8_t busId, uint8_t addr,
+                const std::vector<i2c::TraceEntry>& entries, bool loop = true,
+                bool useRecordedTiming = true);
+
+    /**
+     * Creates a replayed device for each PMBus device in a bus trace.
+     *
+     * @param[in] path - the trace file
+     * @param[in] loop - see the constructor
+     * @param[in] useRecordedTiming - see the constructor
+     *
+     * @return the devices, ordered by bus and address
+     *
+     * @throw std::runtime_error if the file cannot be read or is not a bus
+     *        trace
+     */
+    static std::vector<std::unique_ptr<ReplayPMBus>>
+        load(const std::filesystem::path& path, bool loop = true,
+             bool useRecordedTiming = true);
+
+    /**
+     * Returns the I2C bus of the device.
+     *
+     * @return uint8_t - the bus
+     */
+    uint8_t getBus() const
+    {
+        return busId;
+    }
+
+    /**
+     * Returns the I2C address of the device.
+     *
+     * @return uint8_t - the address
+     */
+    uint8_t getAddress() const
+    {
+        return addr;
+    }
+
+    /**
+     * Returns the number of accesses with no recorded access to replay.
+     *
+     * @return size_t - the number of misses
+     */
+    size_t getMissCount() const;
+
+    uint64_t read(const std::string& name, Type type) override;
+    std::string readString(const std::string& name, Type type) override;
+    ReadResult<uint64_t> tryRead(const std::string& name, Type type) override;
+    ReadResult<std::string> tryReadString(const std::string& name,
+                                          Type type) override;
+    size_t readBlock(const std::string& name, Type type,
+                     std::span<uint8_t> buffer) override;
+    void writeBinary(const std::string& name, std::span<const uint8_t> data,
+                     Type type) override;
+    std::string insertPageNum(const std::string& templateName,
+                              size_t page) override;
+
+    void findHwmonDir() override
+    {}
+
+    const fs::path& path() const override
+    {
+        return devicePath;
+    }
+
+  private:
+    /**
+     * Identifies the recorded accesses of a file by kind, path type, and
+     * file name.
+     */
+    using QueueKey = std::tuple<i2c::TraceOp, Type, std::string>;
+
+    /**
+     * The recorded accesses of a file.
+     */
+    struct Queue
+    {
+        /**
+         * The accesses, from oldest to newest.
+         */
+        std::vector<i2c::TraceEntry> entries{};
+
+        /**
+         * The index of the next access to replay.
+         */
+        size_t next{0};
+    };
+
+    /**
+     * Replays the next recorded access of a file.
+     *
+     * @param[in] key - the kind, path type, and file name
+     * @param[out] data - set to the data of the access if it succeeded
+     *
+     * @return int - the recorded errno, ENODATA if there is no access to
+     *               replay, or 0 if it succeeded
+     */
+    int replay(const QueueKey& key, std::vector<uint8_t>& data);
+
+    /**
+     * Creates the error of a failed access.
+     *
+     * @param[in] write - whether the access was a write
+     * @param[in] error - the errno
+     *
+     * @throw ReadFailure or WriteFailure
+     */
+    [[noreturn]] void fail(bool write, int error) const;
+
+    /**
+     * The I2C bus of the device.
+     */
+    uint8_t busId;
+
+    /**
+     * The I2C address of the device.
+     */
+    uint8_t addr;
+
+    /**
+     * The sysfs path of the device, used in the errors.
+     */
+    fs::path devicePath;
+
+    /**
+     * Whether to start a queue over when it is replayed.
+     */
+    bool loop;
+
+    /**
+     * Whether each access takes the recorded time.
+     */
+    bool useRecordedTiming;
+
+    /**
+     * Protects the members below.
+     */
+    mutable std::mutex mutex;
+
+    /**
+     * The recorded accesses.
+     */
+    std::map<QueueKey, Queue> queues{};
+
+    /**
+     * The number of misses.
+     */
+    size_t misses{0};
+};
+
+} // namespace pmbus
+} // namespace phosphor
@@ -34,6 +34,13 @@ void ArgumentParser::usage(char** argv)
     std::cerr << "    --interval=<interval> Interval in milliseconds:\n";
     std::cerr << "      PGOOD monitor:   time allowed for PGOOD to come up\n";
     std::cerr << "      Runtime monitor: polling interval.\n";
+    std::cerr << "    --watchdog=<interval> Runtime monitor only: analyze on\n";
+    std::cerr << "      device alerts and poll on this slower interval.\n";
+    std::cerr << "    --fault-priority=<priority> SCHED_FIFO priority from 1\n";
+    std::cerr << "      to 99 of the monitor, or 0 for the normal policy.\n";
+    std::cerr << "    --fault-cpus=<cpus>   CPUs the monitor runs on, such\n";
+    std::cerr << "      as 0,2-3.\n";
+    std::cerr << "    --lock-memory         Lock the memory of the process.\n";
 
     std::cerr << std::flush;
 }
@@ -41,11 +48,15 @@ void ArgumentParser::usage(char** argv)
 const option ArgumentParser::options[] = {
     {"action", required_argument, NULL, 'a'},
     {"interval", required_argument, NULL, 'i'},
+    {"watchdog", required_argument, NULL, 'w'},
+    {"fault-priority", required_argument, NULL, 'r'},
+    {"fault-cpus", required_argument, NULL, 'c'},
+    {"lock-memory", no_argument, NULL, 'l'},
     {"help", no_argument, NULL, 'h'},
     {0, 0, 0, 0},
 };
 
-const char* ArgumentParser::optionStr = "a:i:h?";
+const char* ArgumentParser::optionStr = "a:i:w:r:c:lh?";
 ArgumentParser::ArgumentParser(int argc, char** argv)
 {
     int option = 0;
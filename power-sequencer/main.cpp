@@ -18,6 +18,7 @@
 #include "argument.hpp"
 #include "mihawk-cpld.hpp"
 #include "pgood_monitor.hpp"
+#include "realtime.hpp"
 #include "runtime_monitor.hpp"
 #include "ucd90160.hpp"
 
@@ -25,6 +26,7 @@
 #include <sdeventplus/event.hpp>
 
 #include <chrono>
+#include <exception>
 #include <iostream>
 
 using namespace phosphor::power;
@@ -51,6 +53,61 @@ int main(int argc, char** argv)
 
     std::chrono::milliseconds interval{i};
 
+    std::chrono::milliseconds watchdog{0};
+    if (!args["watchdog"].empty())
+    {
+        watchdog = std::chrono::milliseconds{
+            strtoul(args["watchdog"].c_str(), nullptr, 10)};
+        if ((watchdog.count() == 0) || (action != "runtime-monitor"))
+        {
+            std::cerr << "Invalid watchdog value\n";
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    // The monitor only polls the device for faults, so all of its work is on
+    // the fault path and runs with the fault path options
+    util::RealtimeOptions faultPathOptions{};
+    if (!args["fault-priority"].empty())
+    {
+        faultPathOptions.priority =
+            strtol(args["fault-priority"].c_str(), nullptr, 10);
+        if ((faultPathOptions.priority < 0) || (faultPathOptions.priority > 99))
+        {
+            std::cerr << "Invalid fault priority value\n";
+            exit(EXIT_FAILURE);
+        }
+    }
+    if (!args["fault-cpus"].empty())
+    {
+        try
+        {
+            faultPathOptions.cpus = util::parseCPUList(args["fault-cpus"]);
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << e.what() << '\n';
+            exit(EXIT_FAILURE);
+        }
+    }
+    faultPathOptions.lockMemory = !args["lock-memory"].empty();
+    try
+    {
+        util::lockProcessMemory(faultPathOptions);
+    }
+    catch (const std::exception& e)
+    {
+        log<level::ERR>(e.what());
+    }
+    try
+    {
+        util::setThreadRealtime(faultPathOptions);
+    }
+    catch (const std::exception& e)
+    {
+        log<level::ERR>(e.what());
+    }
+
     auto event = sdeventplus::Event::get_default();
     auto bus = sdbusplus::bus::new_default();
     bus.attach_event(event.get(), SD_EVENT_PRIORITY_NORMAL);
@@ -72,6 +129,15 @@ int main(int argc, char** argv)
         // and on 'power lost' signals.
         monitor = std::make_unique<RuntimeMonitor>(std::move(device), bus,
                                                    event, interval);
+
+#ifdef DEVICE_ACCESS
+        // Analyze on the device alert lines, if it has any, and
+        // only poll as a watchdog.
+        if (watchdog.count() != 0)
+        {
+            monitor->watchAlerts(watchdog);
+        }
+#endif
     }
 
     return monitor->run();
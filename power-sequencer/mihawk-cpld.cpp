@@ -57,7 +57,7 @@ MihawkCPLD::MihawkCPLD(size_t instance, sdbusplus::bus::bus& bus) :
 
 void MihawkCPLD::onFailure()
 {
-    bool poweronError = checkPoweronFault();
+    bool poweronError = checkPoweronFault(readInterruptStatus());
 
     // If the interrupt of power_on_error is switch on,
     // read CPLD_register error code to analyze
@@ -191,22 +191,20 @@ void MihawkCPLD::onFailure()
 
 void MihawkCPLD::analyze()
 {
-    bool powerreadyError = checkPowerreadyFault();
-
     // Use the function of GPIO class to check
     // GPIOF0(CPLD uses).
     using namespace phosphor::gpio;
-    GPIO gpio{"/dev/gpiochip0", static_cast<gpioNum_t>(40), Direction::input};
+    auto gpioValue = faultGPIO.read();
 
     // Check GPIOFO pin whether is switched off.
     // if GPIOF0 has been switched off,
     // check CPLD's errorcode & report error.
-    if (gpio.read() == Value::low)
+    if (gpioValue == Value::low)
     {
         // If the interrupt of power_ready_error is switch on,
         // read CPLD_register error code to analyze and
         // report the error event.
-        if (powerreadyError)
+        if (checkPowerreadyFault(readInterruptStatus()))
         {
             ErrorCode code;
             code = static_cast<ErrorCode>(readFromCPLDErrorCode(StatusReg_3));
@@ -376,7 +374,7 @@ void MihawkCPLD::analyze()
         }
     }
 
-    if (gpio.read() == Value::high)
+    if (gpioValue == Value::high)
     {
         // If there isn't an error(GPIOF0
         // which CPLD uses is switched on),
@@ -385,11 +383,29 @@ void MihawkCPLD::analyze()
     }
 }
 
-// Check for PoweronFault
-bool MihawkCPLD::checkPoweronFault()
+std::vector<int> MihawkCPLD::getAlertFDs()
+{
+    try
+    {
+        return {faultGPIO.requestEvents()};
+    }
+    catch (const std::exception&)
+    {
+        // Fall back to polling
+        log<level::ERR>("Unable to request GPIOF0 events");
+        return {};
+    }
+}
+
+void MihawkCPLD::clearAlert(int /*fd*/)
+{
+    faultGPIO.readEvent();
+}
+
+// Read the interrupt-control-bit register
+uint16_t MihawkCPLD::readInterruptStatus()
 {
     uint16_t statusValue_1;
-    bool result;
 
     if (!i2c)
     {
@@ -397,11 +413,13 @@ bool MihawkCPLD::checkPoweronFault()
     }
     i2c->read(StatusReg_1, statusValue_1);
 
-    if (statusValue_1 < 0)
-    {
-        std::cerr << "i2c->read() reads data failed \n";
-        result = 0;
-    }
+    return statusValue_1;
+}
+
+// Check for PoweronFault
+bool MihawkCPLD::checkPoweronFault(uint16_t statusValue_1)
+{
+    bool result;
 
     if ((statusValue_1 >> 5) & 1)
     {
@@ -441,24 +459,11 @@ int MihawkCPLD::readFromCPLDErrorCode(int statusReg)
 }
 
 // Check for PowerreadyFault
-bool MihawkCPLD::checkPowerreadyFault()
+bool MihawkCPLD::checkPowerreadyFault(uint16_t statusValue_1)
 {
-    uint16_t statusValue_3;
     bool result;
 
-    if (!i2c)
-    {
-        openCPLDDevice();
-    }
-    i2c->read(StatusReg_1, statusValue_3);
-
-    if (statusValue_3 < 0)
-    {
-        std::cerr << "i2c->read() reads data failed \n";
-        result = 0;
-    }
-
-    if ((statusValue_3 >> 6) & 1)
+    if ((statusValue_1 >> 6) & 1)
     {
         // If power_ready-interrupt-bit is read as 1,
         // switch on the flag.
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "device.hpp"
+#include "gpio.hpp"
 #include "pmbus.hpp"
 #include "tools/i2c/i2c_interface.hpp"
 
@@ -57,6 +58,22 @@ class MihawkCPLD : public Device
     void clearFaults() override
     {}
 
+    /**
+     * Returns the event descriptor for GPIOF0, which the
+     * CPLD drives low on a power fault.
+     *
+     * @return the alert file descriptors, empty if GPIOF0
+     *         could not be requested for events
+     */
+    std::vector<int> getAlertFDs() override;
+
+    /**
+     * Reads the pending GPIOF0 event
+     *
+     * @param[in] fd - the alert file descriptor
+     */
+    void clearAlert(int fd) override;
+
   private:
     /**
      * If checkPoweronFault() or checkPowerreadyFault()
@@ -81,9 +98,11 @@ class MihawkCPLD : public Device
      * CPLD-power_on-error-interrupt-bit-register
      * whether is transfered to "1".
      *
+     * @param[in] statusValue_1 - value from readInterruptStatus()
+     *
      * @return bool - true if power_on fail.
      */
-    bool checkPoweronFault();
+    bool checkPoweronFault(uint16_t statusValue_1);
 
     /**
      * Clear CPLD intrupt record after reading CPLD_register.
@@ -95,9 +114,20 @@ class MihawkCPLD : public Device
      * CPLD-power_ready-error-interrupt-bit-register
      * whether is transfered to "1".
      *
+     * @param[in] statusValue_1 - value from readInterruptStatus()
+     *
      * @return bool - true if power_ready fail.
      */
-    bool checkPowerreadyFault();
+    bool checkPowerreadyFault(uint16_t statusValue_1);
+
+    /**
+     * Reads CPLD-interrupt-control-bit-register(StatusReg_1)
+     * once, so it can be shared by checkPoweronFault() and
+     * checkPowerreadyFault().
+     *
+     * @return uint16_t - the register value.
+     */
+    uint16_t readInterruptStatus();
 
     /**
      * Use I2CInterface to read & write CPLD_register.
@@ -109,6 +139,12 @@ class MihawkCPLD : public Device
      */
     sdbusplus::bus::bus& bus;
 
+    /**
+     * GPIOF0, which the CPLD uses to signal a fault
+     */
+    gpio::GPIO faultGPIO{"/dev/gpiochip0", static_cast<gpio::gpioNum_t>(40),
+                         gpio::Direction::input};
+
     /**
      * Open CPLD_register via i2c.
      */
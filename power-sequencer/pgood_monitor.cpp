@@ -68,7 +68,7 @@ void PGOODMonitor::analyze()
     if (pgoodPending())
     {
 #ifdef DEVICE_ACCESS
-        device->onFailure();
+        devices.front()->onFailure();
 #endif
         report<PowerOnFailure>();
     }
@@ -47,9 +47,10 @@ void RuntimeMonitor::onPowerLost(sdbusplus::message::message&)
     try
     {
         timer.setEnabled(false);
+        alertSources.clear();
 
 #ifdef DEVICE_ACCESS
-        device->onFailure();
+        devices.front()->onFailure();
 #endif
         // Note: This application only runs when the system has
         // power, so it will be killed by systemd sometime shortly
@@ -25,6 +25,8 @@ namespace power
  *    driving power to a faulted component.
  *
  * 2) Polls for faults, as some won't always drop PGOOD.
+ *    If watchAlerts() is called, the device alert lines are
+ *    watched instead and the poll becomes a slower watchdog.
  *
  * The application this runs in will only run while PGOOD is
  * expected to be asserted, so any loss of PGOOD is considered
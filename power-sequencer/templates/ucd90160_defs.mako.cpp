@@ -2,58 +2,86 @@
 
 #include "ucd90160.hpp"
 
+#include <array>
+#include <stdexcept>
+#include <string>
+
 namespace phosphor
 {
 namespace power
 {
 
 using namespace ucd90160;
-using namespace std::string_literals;
 
-const DeviceMap UCD90160::deviceMap{
+const DeviceDefinition& UCD90160::getDefinition(size_t instance)
+{
 %for ucd_data in ucd90160s:
-    {${ucd_data['index']},
-     DeviceDefinition{
-       "${ucd_data['path']}",
+<%
+    n = loop.index
+    gpio_analyses = ucd_data.get('GPIOAnalysis', [])
+%>\
+    static constexpr std::array<const char*, ${len(ucd_data['RailNames'])}> railNames${n}{
+    %for rail in ucd_data['RailNames']:
+        "${rail}",
+    %endfor
+    };
+
+    static constexpr std::array<GPIConfig, ${len(ucd_data['GPIConfigs'])}> gpiConfigs${n}{
+    %for gpi_config in ucd_data['GPIConfigs']:
+    <%
+        poll = str(gpi_config['poll']).lower()
+    %>\
+        GPIConfig{${gpi_config['gpi']}, ${gpi_config['pinID']}, "${gpi_config['name']}", ${poll}, extraAnalysisType::${gpi_config['analysis']}},
+    %endfor
+    };
 
-        RailNames{
-        %for rail in ucd_data['RailNames']:
-            "${rail}"s,
+    %for gpio_analysis in gpio_analyses:
+    static constexpr std::array<GPIODefinition, ${len(gpio_analysis['GPIODefinitions'])}> gpioDefinitions${n}_${loop.index}{
+        %for gpio_defs in gpio_analysis['GPIODefinitions']:
+        GPIODefinition{${gpio_defs['gpio']}, "${gpio_defs['callout']}"},
         %endfor
+    };
+
+    %endfor
+    static constexpr std::array<GPIOAnalysisEntry, ${len(gpio_analyses)}> gpioAnalysis${n}{
+    %for gpio_analysis in gpio_analyses:
+        GPIOAnalysisEntry{
+            extraAnalysisType::${gpio_analysis['type']},
+            GPIOGroup{
+                "${gpio_analysis['path']}",
+                gpio::Value::${gpio_analysis['gpio_value']},
+                [](UCD90160& ucd, const std::string& callout) {
+                    ucd.${gpio_analysis['error_function']}(callout);
+                },
+                optionFlags::${gpio_analysis['option_flags']},
+                gpioDefinitions${n}_${loop.index}
+            }
         },
+    %endfor
+    };
 
-        GPIConfigs{
-        %for gpi_config in ucd_data['GPIConfigs']:
-        <%
-            poll = str(gpi_config['poll']).lower()
-        %>\
-            GPIConfig{${gpi_config['gpi']}, ${gpi_config['pinID']}, "${gpi_config['name']}"s, ${poll}, extraAnalysisType::${gpi_config['analysis']}},
-        %endfor
+%endfor
+    static constexpr std::array<std::tuple<size_t, DeviceDefinition>, ${len(ucd90160s)}> devices{
+%for ucd_data in ucd90160s:
+        std::tuple<size_t, DeviceDefinition>{
+            ${ucd_data['index']},
+            DeviceDefinition{"${ucd_data['path']}", railNames${loop.index},
+                             gpiConfigs${loop.index}, gpioAnalysis${loop.index}}
         },
+%endfor
+    };
 
-        GPIOAnalysis{
-        %for gpio_analysis in ucd_data.get('GPIOAnalysis', []):
-             {extraAnalysisType::${gpio_analysis['type']},
-              GPIOGroup{
-                  "${gpio_analysis['path']}",
-                  gpio::Value::${gpio_analysis['gpio_value']},
-                  [](auto& ucd, const auto& callout) {
-                      ucd.${gpio_analysis['error_function']}(callout);
-                  },
-                  optionFlags::${gpio_analysis['option_flags']},
-                  GPIODefinitions{
-                  %for gpio_defs in gpio_analysis['GPIODefinitions']:
-                      GPIODefinition{${gpio_defs['gpio']}, "${gpio_defs['callout']}"s},
-                  %endfor
-                  }
-              }
-             },
-        %endfor
+    for (const auto& [index, device] : devices)
+    {
+        if (index == instance)
+        {
+            return device;
         }
-     }
-    },
-%endfor
-};
+    }
+
+    throw std::invalid_argument{"No UCD90160 definition for instance " +
+                                std::to_string(instance)};
+}
 
 } // namespace power
 } // namespace phosphor
@@ -1,10 +1,8 @@
 #pragma once
 
-#include <functional>
-#include <map>
+#include <span>
 #include <string>
 #include <tuple>
-#include <vector>
 
 namespace phosphor
 {
@@ -40,10 +38,13 @@ enum class optionFlags
     shutdownOnFault = 1
 };
 
+// The definitions below are generated from the YAML as constexpr arrays,
+// so the strings are C strings and the lists are spans over the arrays.
+
 constexpr auto gpioNumField = 0;
 constexpr auto gpioCalloutField = 1;
-using GPIODefinition = std::tuple<gpio::gpioNum_t, std::string>;
-using GPIODefinitions = std::vector<GPIODefinition>;
+using GPIODefinition = std::tuple<gpio::gpioNum_t, const char*>;
+using GPIODefinitions = std::span<const GPIODefinition>;
 
 constexpr auto gpioDevicePathField = 0;
 constexpr auto gpioPolarityField = 1;
@@ -51,12 +52,16 @@ constexpr auto errorFunctionField = 2;
 constexpr auto optionFlagsField = 3;
 constexpr auto gpioDefinitionField = 4;
 
-using ErrorFunction = std::function<void(UCD90160&, const std::string&)>;
+using ErrorFunction = void (*)(UCD90160&, const std::string&);
 
-using GPIOGroup = std::tuple<std::string, gpio::Value, ErrorFunction,
+using GPIOGroup = std::tuple<const char*, gpio::Value, ErrorFunction,
                              optionFlags, GPIODefinitions>;
 
-using GPIOAnalysis = std::map<extraAnalysisType, GPIOGroup>;
+constexpr auto analysisTypeField = 0;
+constexpr auto gpioGroupField = 1;
+using GPIOAnalysisEntry = std::tuple<extraAnalysisType, GPIOGroup>;
+
+using GPIOAnalysis = std::span<const GPIOAnalysisEntry>;
 
 constexpr auto gpiNumField = 0;
 constexpr auto pinIDField = 1;
@@ -65,11 +70,11 @@ constexpr auto pollField = 3;
 constexpr auto extraAnalysisField = 4;
 
 using GPIConfig =
-    std::tuple<size_t, size_t, std::string, bool, extraAnalysisType>;
+    std::tuple<size_t, size_t, const char*, bool, extraAnalysisType>;
 
-using GPIConfigs = std::vector<GPIConfig>;
+using GPIConfigs = std::span<const GPIConfig>;
 
-using RailNames = std::vector<std::string>;
+using RailNames = std::span<const char* const>;
 
 constexpr auto pathField = 0;
 constexpr auto railNamesField = 1;
@@ -77,10 +82,7 @@ constexpr auto gpiConfigField = 2;
 constexpr auto gpioAnalysisField = 3;
 
 using DeviceDefinition =
-    std::tuple<std::string, RailNames, GPIConfigs, GPIOAnalysis>;
-
-// Maps a device instance to its definition
-using DeviceMap = std::map<size_t, DeviceDefinition>;
+    std::tuple<const char*, RailNames, GPIConfigs, GPIOAnalysis>;
 
 } // namespace ucd90160
 } // namespace power
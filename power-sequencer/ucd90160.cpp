@@ -24,8 +24,11 @@
 #include <phosphor-logging/log.hpp>
 #include <xyz/openbmc_project/Common/Device/error.hpp>
 
+#include <algorithm>
 #include <map>
 #include <memory>
+#include <optional>
+#include <vector>
 
 namespace phosphor
 {
@@ -51,25 +54,46 @@ namespace device_error = sdbusplus::xyz::openbmc_project::Common::Device::Error;
 namespace power_error = sdbusplus::org::open_power::Witherspoon::Fault::Error;
 
 UCD90160::UCD90160(size_t instance, sdbusplus::bus::bus& bus) :
-    Device(DEVICE_NAME, instance),
-    interface(std::get<ucd90160::pathField>(deviceMap.find(instance)->second),
-              DRIVER_NAME, instance),
+    Device(DEVICE_NAME, instance), definition(getDefinition(instance)),
+    interface(std::get<ucd90160::pathField>(definition), DRIVER_NAME,
+              instance),
     gpioDevice(findGPIODevice(interface.path())), bus(bus)
 {}
 
+/**
+ * Adds the STATUS_WORD and MFR_STATUS in a snapshot to error log metadata.
+ *
+ * @param[in] snapshot - the device state
+ * @param[in,out] nv - the metadata
+ */
+static void addStatusRegisters(const ucd90160::FaultSnapshot& snapshot,
+                               util::FixedNamesValues<>& nv)
+{
+    if (snapshot.statusWord)
+    {
+        nv.add("STATUS_WORD", *snapshot.statusWord);
+    }
+    if (snapshot.mfrStatus)
+    {
+        nv.add("MFR_STATUS", *snapshot.mfrStatus);
+    }
+}
+
 void UCD90160::onFailure()
 {
     try
     {
-        auto voutError = checkVOUTFaults();
+        currentSnapshot = readFaultSnapshot(false);
+
+        auto voutError = checkVOUTFaults(currentSnapshot);
 
-        auto pgoodError = checkPGOODFaults(false);
+        auto pgoodError = checkPGOODFaults(currentSnapshot);
 
         // Not a voltage or PGOOD fault, but we know something
         // failed so still create an error log.
         if (!voutError && !pgoodError)
         {
-            createPowerFaultLog();
+            createPowerFaultLog(currentSnapshot);
         }
     }
     catch (const device_error::ReadFailure& e)
@@ -89,7 +113,9 @@ void UCD90160::analyze()
         // Note: Voltage faults are always fatal, so they just
         // need to be analyzed in onFailure().
 
-        checkPGOODFaults(true);
+        currentSnapshot = readFaultSnapshot(true);
+
+        checkPGOODFaults(currentSnapshot);
     }
     catch (const device_error::ReadFailure& e)
     {
@@ -111,75 +137,9 @@ uint32_t UCD90160::readMFRStatus()
     return interface.read(MFR_STATUS, Type::HwmonDeviceDebug);
 }
 
-bool UCD90160::checkVOUTFaults()
-{
-    bool errorCreated = false;
-    auto statusWord = readStatusWord();
-
-    // The status_word register has a summary bit to tell us
-    // if each page even needs to be checked
-    if (!(statusWord & status_word::VOUT_FAULT))
-    {
-        return errorCreated;
-    }
-
-    for (size_t page = 0; page < NUM_PAGES; page++)
-    {
-        if (isVoutFaultLogged(page))
-        {
-            continue;
-        }
-
-        auto statusVout = interface.insertPageNum(STATUS_VOUT, page);
-        uint8_t vout = interface.read(statusVout, Type::Debug);
-
-        // If any bits are on log them, though some are just
-        // warnings so they won't cause errors
-        if (vout)
-        {
-            log<level::INFO>("A voltage rail has bits on in STATUS_VOUT",
-                             entry("STATUS_VOUT=0x%X", vout),
-                             entry("PAGE=%d", page));
-        }
-
-        // Log errors if any non-warning bits on
-        if (vout & ~status_vout::WARNING_MASK)
-        {
-            auto& railNames = std::get<ucd90160::railNamesField>(
-                deviceMap.find(getInstance())->second);
-            auto railName = railNames.at(page);
-
-            util::NamesValues nv;
-            try
-            {
-                nv.add("STATUS_WORD", statusWord);
-                nv.add("STATUS_VOUT", vout);
-                nv.add("MFR_STATUS", readMFRStatus());
-            }
-            catch (const device_error::ReadFailure& e)
-            {
-                log<level::ERR>("ReadFailure when collecting metadata");
-                commit<device_error::ReadFailure>();
-            }
-
-            using metadata =
-                org::open_power::Witherspoon::Fault::PowerSequencerVoltageFault;
-
-            report<power_error::PowerSequencerVoltageFault>(
-                metadata::RAIL(page), metadata::RAIL_NAME(railName.c_str()),
-                metadata::RAW_STATUS(nv.get().c_str()));
-
-            setVoutFaultLogged(page);
-            errorCreated = true;
-        }
-    }
-
-    return errorCreated;
-}
-
-bool UCD90160::checkPGOODFaults(bool polling)
+ucd90160::FaultSnapshot UCD90160::readFaultSnapshot(bool polling)
 {
-    bool errorCreated = false;
+    ucd90160::FaultSnapshot snapshot;
 
     // While PGOOD faults could show up in MFR_STATUS (and we could then
     // check the summary bit in STATUS_WORD first), they are edge triggered,
@@ -188,8 +148,8 @@ bool UCD90160::checkPGOODFaults(bool polling)
     // real time GPI status GPIO.
 
     // Check only the GPIs configured on this system.
-    auto& gpiConfigs = std::get<ucd90160::gpiConfigField>(
-        deviceMap.find(getInstance())->second);
+    auto gpiConfigs = std::get<ucd90160::gpiConfigField>(definition);
+    bool gpiFault = false;
 
     for (const auto& gpiConfig : gpiConfigs)
     {
@@ -231,42 +191,171 @@ bool UCD90160::checkPGOODFaults(bool polling)
             continue;
         }
 
+        snapshot.gpiStatus.emplace(gpiNum, gpiStatus);
+
         if (gpiStatus == Value::low)
         {
-            // There may be some extra analysis we can do to narrow the
-            // error down further.  Note that finding an error here won't
-            // prevent us from checking this GPI again.
-            errorCreated = doExtraAnalysis(gpiConfig);
+            gpiFault = true;
 
-            if (errorCreated)
+            // Read the GPIOs of its extra analysis, once per type
+            auto type = std::get<ucd90160::extraAnalysisField>(gpiConfig);
+            if ((type != ucd90160::extraAnalysisType::none) &&
+                !snapshot.gpioValues.contains(type))
             {
-                continue;
+                readGPIOAnalysis(type, snapshot);
             }
+        }
+    }
+
+    // The registers are only error log metadata for PGOOD faults
+    if (polling && !gpiFault)
+    {
+        return snapshot;
+    }
+
+    if (!polling)
+    {
+        snapshot.statusWord = readStatusWord();
+
+        // The status_word register has a summary bit to tell us
+        // if each page even needs to be checked
+        if (*snapshot.statusWord & status_word::VOUT_FAULT)
+        {
+            // Read STATUS_VOUT for all of the pages that still need to be
+            // checked
+            std::vector<size_t> pages;
+            std::vector<std::string> statusVoutNames;
+            for (size_t page = 0; page < NUM_PAGES; page++)
+            {
+                if (!isVoutFaultLogged(page))
+                {
+                    pages.push_back(page);
+                    statusVoutNames.push_back(
+                        interface.insertPageNum(STATUS_VOUT, page));
+                }
+            }
+
+            auto vouts =
+                interface.readStatusSnapshot(statusVoutNames, Type::Debug);
+
+            for (size_t i = 0; i < pages.size(); i++)
+            {
+                // If the read failed, read it again to get the standard
+                // ReadFailure handling.
+                snapshot.statusVout[pages[i]] =
+                    vouts.valid[i]
+                        ? vouts.values[i]
+                        : interface.read(statusVoutNames[i], Type::Debug);
+            }
+        }
+    }
+
+    try
+    {
+        if (!snapshot.statusWord)
+        {
+            snapshot.statusWord = readStatusWord();
+        }
+        snapshot.mfrStatus = readMFRStatus();
+    }
+    catch (const device_error::ReadFailure& e)
+    {
+        log<level::ERR>("ReadFailure when collecting metadata");
+        commit<device_error::ReadFailure>();
+    }
 
-            auto& gpiName = std::get<ucd90160::gpiNameField>(gpiConfig);
-            auto status = (gpiStatus == Value::low) ? 0 : 1;
+    return snapshot;
+}
 
-            util::NamesValues nv;
+bool UCD90160::checkVOUTFaults(const ucd90160::FaultSnapshot& snapshot)
+{
+    bool errorCreated = false;
 
-            try
+    for (const auto& [page, vout] : snapshot.statusVout)
+    {
+        // If any bits are on log them, though some are just
+        // warnings so they won't cause errors
+        if (vout)
+        {
+            log<level::INFO>("A voltage rail has bits on in STATUS_VOUT",
+                             entry("STATUS_VOUT=0x%X", vout),
+                             entry("PAGE=%d", page));
+        }
+
+        // Log errors if any non-warning bits on
+        if (vout & ~status_vout::WARNING_MASK)
+        {
+            auto railNames = std::get<ucd90160::railNamesField>(definition);
+            auto railName = (page < railNames.size()) ? railNames[page] : "";
+
+            util::FixedNamesValues<> nv;
+            if (snapshot.statusWord)
             {
-                nv.add("STATUS_WORD", readStatusWord());
-                nv.add("MFR_STATUS", readMFRStatus());
-                nv.add("INPUT_STATUS", status);
+                nv.add("STATUS_WORD", *snapshot.statusWord);
             }
-            catch (const device_error::ReadFailure& e)
+            nv.add("STATUS_VOUT", vout);
+            if (snapshot.mfrStatus)
             {
-                log<level::ERR>("ReadFailure when collecting metadata");
-                commit<device_error::ReadFailure>();
+                nv.add("MFR_STATUS", *snapshot.mfrStatus);
             }
 
+            using metadata =
+                org::open_power::Witherspoon::Fault::PowerSequencerVoltageFault;
+
+            report<power_error::PowerSequencerVoltageFault>(
+                metadata::RAIL(page), metadata::RAIL_NAME(railName),
+                metadata::RAW_STATUS(nv.c_str()));
+
+            setVoutFaultLogged(page);
+            errorCreated = true;
+        }
+    }
+
+    return errorCreated;
+}
+
+bool UCD90160::checkPGOODFaults(const ucd90160::FaultSnapshot& snapshot)
+{
+    bool errorCreated = false;
+
+    auto gpiConfigs = std::get<ucd90160::gpiConfigField>(definition);
+
+    for (const auto& gpiConfig : gpiConfigs)
+    {
+        // The GPIs that didn't need checking or couldn't be read
+        // aren't in the snapshot
+        auto gpiNum = std::get<ucd90160::gpiNumField>(gpiConfig);
+        auto gpiStatus = snapshot.gpiStatus.find(gpiNum);
+        if ((gpiStatus == snapshot.gpiStatus.end()) ||
+            isPGOODFaultLogged(gpiNum))
+        {
+            continue;
+        }
+
+        if (gpiStatus->second == Value::low)
+        {
+            // There may be some extra analysis we can do to narrow the
+            // error down further.  Note that finding an error here won't
+            // prevent us from checking this GPI again.
+            if (doExtraAnalysis(gpiConfig, snapshot))
+            {
+                errorCreated = true;
+                continue;
+            }
+
+            auto gpiName = std::get<ucd90160::gpiNameField>(gpiConfig);
+
+            util::FixedNamesValues<> nv;
+            addStatusRegisters(snapshot, nv);
+            nv.add("INPUT_STATUS", 0);
+
             using metadata =
                 org::open_power::Witherspoon::Fault::PowerSequencerPGOODFault;
 
             report<power_error::PowerSequencerPGOODFault>(
                 metadata::INPUT_NUM(gpiNum),
-                metadata::INPUT_NAME(gpiName.c_str()),
-                metadata::RAW_STATUS(nv.get().c_str()));
+                metadata::INPUT_NAME(gpiName),
+                metadata::RAW_STATUS(nv.c_str()));
 
             setPGOODFaultLogged(gpiNum);
             errorCreated = true;
@@ -276,25 +365,15 @@ bool UCD90160::checkPGOODFaults(bool polling)
     return errorCreated;
 }
 
-void UCD90160::createPowerFaultLog()
+void UCD90160::createPowerFaultLog(const ucd90160::FaultSnapshot& snapshot)
 {
-    util::NamesValues nv;
-
-    try
-    {
-        nv.add("STATUS_WORD", readStatusWord());
-        nv.add("MFR_STATUS", readMFRStatus());
-    }
-    catch (const device_error::ReadFailure& e)
-    {
-        log<level::ERR>("ReadFailure when collecting metadata");
-        commit<device_error::ReadFailure>();
-    }
+    util::FixedNamesValues<> nv;
+    addStatusRegisters(snapshot, nv);
 
     using metadata = org::open_power::Witherspoon::Fault::PowerSequencerFault;
 
     report<power_error::PowerSequencerFault>(
-        metadata::RAW_STATUS(nv.get().c_str()));
+        metadata::RAW_STATUS(nv.c_str()));
 }
 
 fs::path UCD90160::findGPIODevice(const fs::path& path)
@@ -326,7 +405,8 @@ fs::path UCD90160::findGPIODevice(const fs::path& path)
     return gpioDevicePath;
 }
 
-bool UCD90160::doExtraAnalysis(const ucd90160::GPIConfig& config)
+bool UCD90160::doExtraAnalysis(const ucd90160::GPIConfig& config,
+                               const ucd90160::FaultSnapshot& snapshot)
 {
 
     auto type = std::get<ucd90160::extraAnalysisField>(config);
@@ -336,24 +416,42 @@ bool UCD90160::doExtraAnalysis(const ucd90160::GPIConfig& config)
     }
 
     // Currently the only extra analysis to do is to check other GPIOs.
-    return doGPIOAnalysis(type);
+    return doGPIOAnalysis(type, snapshot);
 }
 
-bool UCD90160::doGPIOAnalysis(ucd90160::extraAnalysisType type)
+/**
+ * Finds the GPIO analysis configuration of an analysis type.
+ *
+ * @param[in] definition - the device definition
+ * @param[in] type - the type of analysis
+ *
+ * @return const GPIOAnalysisEntry* - the configuration, or nullptr if
+ *                                    there isn't one
+ */
+static const ucd90160::GPIOAnalysisEntry*
+    findGPIOAnalysis(const ucd90160::DeviceDefinition& definition,
+                     ucd90160::extraAnalysisType type)
 {
-    bool errorFound = false;
-    bool shutdown = false;
+    auto analysisConfig = std::get<ucd90160::gpioAnalysisField>(definition);
 
-    const auto& analysisConfig = std::get<ucd90160::gpioAnalysisField>(
-        deviceMap.find(getInstance())->second);
+    auto analysis = std::find_if(
+        analysisConfig.begin(), analysisConfig.end(), [type](const auto& a) {
+            return std::get<ucd90160::analysisTypeField>(a) == type;
+        });
+    return (analysis != analysisConfig.end()) ? &*analysis : nullptr;
+}
 
-    auto gpioConfig = analysisConfig.find(type);
-    if (gpioConfig == analysisConfig.end())
+void UCD90160::readGPIOAnalysis(ucd90160::extraAnalysisType type,
+                                ucd90160::FaultSnapshot& snapshot)
+{
+    const auto* analysis = findGPIOAnalysis(definition, type);
+    if (analysis == nullptr)
     {
-        return errorFound;
+        return;
     }
+    const auto& gpioConfig = std::get<ucd90160::gpioGroupField>(*analysis);
 
-    auto path = std::get<ucd90160::gpioDevicePathField>(gpioConfig->second);
+    auto path = std::get<ucd90160::gpioDevicePathField>(gpioConfig);
 
     // The /dev/gpiochipX device
     auto device = findGPIODevice(path);
@@ -363,41 +461,64 @@ bool UCD90160::doGPIOAnalysis(ucd90160::extraAnalysisType type)
         log<level::ERR>(
             "Missing GPIO device - cannot do GPIO analysis of fault",
             entry("ANALYSIS_TYPE=%d\n", type));
-        return errorFound;
+        return;
     }
 
-    // The GPIO value of the fault condition
-    auto polarity = std::get<ucd90160::gpioPolarityField>(gpioConfig->second);
-
     // The GPIOs to check
-    auto& gpios = std::get<ucd90160::gpioDefinitionField>(gpioConfig->second);
+    auto gpios = std::get<ucd90160::gpioDefinitionField>(gpioConfig);
 
+    // Read all of the GPIOs together with one request
+    std::vector<gpioNum_t> gpioNums;
+    gpioNums.reserve(gpios.size());
     for (const auto& gpio : gpios)
     {
-        gpio::Value value;
+        gpioNums.push_back(std::get<ucd90160::gpioNumField>(gpio));
+    }
 
-        try
+    try
+    {
+        gpio::GPIOGroup group{device, gpioNums};
+        snapshot.gpioValues.emplace(type, group.read());
+    }
+    catch (const std::exception& e)
+    {
+        if (!gpioAccessError)
         {
-            GPIO g{device, std::get<ucd90160::gpioNumField>(gpio),
-                   Direction::input};
+            // GPIO only throws InternalErrors - not worth committing.
+            log<level::ERR>("GPIO read failed while analyzing a power fault",
+                            entry("CHIP_PATH=%s", path));
 
-            value = g.read();
+            gpioAccessError = true;
         }
-        catch (const std::exception& e)
-        {
-            if (!gpioAccessError)
-            {
-                // GPIO only throws InternalErrors - not worth committing.
-                log<level::ERR>(
-                    "GPIO read failed while analyzing a power fault",
-                    entry("CHIP_PATH=%s", path.c_str()));
+    }
+}
 
-                gpioAccessError = true;
-            }
-            continue;
-        }
+bool UCD90160::doGPIOAnalysis(ucd90160::extraAnalysisType type,
+                              const ucd90160::FaultSnapshot& snapshot)
+{
+    bool errorFound = false;
+    bool shutdown = false;
 
-        if (value == polarity)
+    // Not in the snapshot if the GPIOs couldn't be read
+    const auto* analysis = findGPIOAnalysis(definition, type);
+    auto values = snapshot.gpioValues.find(type);
+    if ((analysis == nullptr) || (values == snapshot.gpioValues.end()))
+    {
+        return errorFound;
+    }
+    const auto& gpioConfig = std::get<ucd90160::gpioGroupField>(*analysis);
+
+    // The GPIO value of the fault condition
+    auto polarity = std::get<ucd90160::gpioPolarityField>(gpioConfig);
+
+    // The GPIOs to check
+    auto gpios = std::get<ucd90160::gpioDefinitionField>(gpioConfig);
+
+    for (size_t i = 0; i < gpios.size(); i++)
+    {
+        const auto& gpio = gpios[i];
+
+        if (values->second[i] == polarity)
         {
             errorFound = true;
 
@@ -411,8 +532,7 @@ bool UCD90160::doGPIOAnalysis(ucd90160::extraAnalysisType type)
             }
 
             // Look up and call the error creation function
-            auto logError =
-                std::get<ucd90160::errorFunctionField>(gpioConfig->second);
+            auto logError = std::get<ucd90160::errorFunctionField>(gpioConfig);
 
             logError(*this, part);
 
@@ -421,7 +541,7 @@ bool UCD90160::doGPIOAnalysis(ucd90160::extraAnalysisType type)
 
             // Some errors (like overtemps) require a shutdown
             auto actions = static_cast<uint32_t>(
-                std::get<ucd90160::optionFlagsField>(gpioConfig->second));
+                std::get<ucd90160::optionFlagsField>(gpioConfig));
 
             if (actions & static_cast<decltype(actions)>(
                               ucd90160::optionFlags::shutdownOnFault))
@@ -442,67 +562,37 @@ bool UCD90160::doGPIOAnalysis(ucd90160::extraAnalysisType type)
 
 void UCD90160::gpuPGOODError(const std::string& callout)
 {
-    util::NamesValues nv;
-
-    try
-    {
-        nv.add("STATUS_WORD", readStatusWord());
-        nv.add("MFR_STATUS", readMFRStatus());
-    }
-    catch (const device_error::ReadFailure& e)
-    {
-        log<level::ERR>("ReadFailure when collecting metadata");
-        commit<device_error::ReadFailure>();
-    }
+    util::FixedNamesValues<> nv;
+    addStatusRegisters(currentSnapshot, nv);
 
     using metadata = org::open_power::Witherspoon::Fault::GPUPowerFault;
 
     report<power_error::GPUPowerFault>(
-        metadata::RAW_STATUS(nv.get().c_str()),
+        metadata::RAW_STATUS(nv.c_str()),
         metadata::CALLOUT_INVENTORY_PATH(callout.c_str()));
 }
 
 void UCD90160::gpuOverTempError(const std::string& callout)
 {
-    util::NamesValues nv;
-
-    try
-    {
-        nv.add("STATUS_WORD", readStatusWord());
-        nv.add("MFR_STATUS", readMFRStatus());
-    }
-    catch (const device_error::ReadFailure& e)
-    {
-        log<level::ERR>("ReadFailure when collecting metadata");
-        commit<device_error::ReadFailure>();
-    }
+    util::FixedNamesValues<> nv;
+    addStatusRegisters(currentSnapshot, nv);
 
     using metadata = org::open_power::Witherspoon::Fault::GPUOverTemp;
 
     report<power_error::GPUOverTemp>(
-        metadata::RAW_STATUS(nv.get().c_str()),
+        metadata::RAW_STATUS(nv.c_str()),
         metadata::CALLOUT_INVENTORY_PATH(callout.c_str()));
 }
 
 void UCD90160::memGoodError(const std::string& callout)
 {
-    util::NamesValues nv;
-
-    try
-    {
-        nv.add("STATUS_WORD", readStatusWord());
-        nv.add("MFR_STATUS", readMFRStatus());
-    }
-    catch (const device_error::ReadFailure& e)
-    {
-        log<level::ERR>("ReadFailure when collecting metadata");
-        commit<device_error::ReadFailure>();
-    }
+    util::FixedNamesValues<> nv;
+    addStatusRegisters(currentSnapshot, nv);
 
     using metadata = org::open_power::Witherspoon::Fault::MemoryPowerFault;
 
     report<power_error::MemoryPowerFault>(
-        metadata::RAW_STATUS(nv.get().c_str()),
+        metadata::RAW_STATUS(nv.c_str()),
         metadata::CALLOUT_INVENTORY_PATH(callout.c_str()));
 }
 
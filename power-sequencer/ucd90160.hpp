@@ -8,8 +8,10 @@
 #include <sdbusplus/bus.hpp>
 
 #include <algorithm>
+#include <cstdint>
 #include <filesystem>
 #include <map>
+#include <optional>
 #include <vector>
 
 namespace phosphor
@@ -20,6 +22,46 @@ namespace power
 // Error type, callout
 using PartCallout = std::tuple<ucd90160::extraAnalysisType, std::string>;
 
+namespace ucd90160
+{
+
+/**
+ * @struct FaultSnapshot
+ *
+ * The registers and GPIOs the fault analysis uses, all read before the
+ * analysis starts so every check sees the same device state.
+ */
+struct FaultSnapshot
+{
+    /**
+     * STATUS_WORD, if it was read
+     */
+    std::optional<uint16_t> statusWord;
+
+    /**
+     * MFR_STATUS, if it was read
+     */
+    std::optional<uint32_t> mfrStatus;
+
+    /**
+     * STATUS_VOUT of the pages that were read, by page
+     */
+    std::map<size_t, uint8_t> statusVout;
+
+    /**
+     * The real time status of the GPIs that were read, by GPI number
+     */
+    std::map<size_t, gpio::Value> gpiStatus;
+
+    /**
+     * The GPIO values read for each extra analysis, in the order of the
+     * GPIO definitions of the analysis
+     */
+    std::map<extraAnalysisType, std::vector<gpio::Value>> gpioValues;
+};
+
+} // namespace ucd90160
+
 /**
  * @class UCD90160
  *
@@ -85,6 +127,18 @@ class UCD90160 : public Device
      */
     void memGoodError(const std::string& callout);
 
+    /**
+     * Returns the instance specific data of a device, from the
+     * tables generated from the UCD90160 YAML
+     *
+     * Throws an exception if there are no data for the instance.
+     *
+     * @param[in] instance - the device instance number
+     *
+     * @return the device definition
+     */
+    static const ucd90160::DeviceDefinition& getDefinition(size_t instance);
+
     /**
      * Given the device path for a chip, find its gpiochip
      * path
@@ -98,6 +152,33 @@ class UCD90160 : public Device
     static std::filesystem::path
         findGPIODevice(const std::filesystem::path& path);
 
+    /**
+     * Reads everything the fault analysis needs into a snapshot.
+     *
+     * The GPIs that still need checking are read first.  When polling,
+     * the registers are only read if one of them shows a fault, and
+     * STATUS_VOUT is not read since voltage faults are always fatal.
+     *
+     * A GPIO that cannot be read is left out of the snapshot.  When not
+     * polling, a failure to read STATUS_WORD or STATUS_VOUT throws a
+     * ReadFailure, since the analysis cannot be done without them.
+     *
+     * @param[in] polling - If this is running while polling for errors,
+     *                      as opposing to analyzing a fail condition.
+     *
+     * @return FaultSnapshot - the device state
+     */
+    ucd90160::FaultSnapshot readFaultSnapshot(bool polling);
+
+    /**
+     * Reads the GPIOs of an extra analysis into the snapshot.
+     *
+     * @param[in] type - the type of analysis
+     * @param[in,out] snapshot - the snapshot
+     */
+    void readGPIOAnalysis(ucd90160::extraAnalysisType type,
+                          ucd90160::FaultSnapshot& snapshot);
+
     /**
      * Checks for VOUT faults on the device.
      *
@@ -105,29 +186,32 @@ class UCD90160 : public Device
      * devices, and VOUT faults are voltage faults
      * on these devices.
      *
+     * @param[in] snapshot - the device state
+     *
      * @return bool - true if an error log was created
      */
-    bool checkVOUTFaults();
+    bool checkVOUTFaults(const ucd90160::FaultSnapshot& snapshot);
 
     /**
      * Checks for PGOOD faults on the device.
      *
      * This device can monitor the PGOOD signals of its dependent
      * devices, and this check will look for faults of
-     * those PGOODs.
+     * those PGOODs.  Only the GPIs in the snapshot are checked.
      *
-     * @param[in] polling - If this is running while polling for errors,
-     *                      as opposing to analyzing a fail condition.
+     * @param[in] snapshot - the device state
      *
      * @return bool - true if an error log was created
      */
-    bool checkPGOODFaults(bool polling);
+    bool checkPGOODFaults(const ucd90160::FaultSnapshot& snapshot);
 
     /**
      * Creates an error log when the device has an error
      * but it isn't a PGOOD or voltage failure.
+     *
+     * @param[in] snapshot - the device state
      */
-    void createPowerFaultLog();
+    void createPowerFaultLog(const ucd90160::FaultSnapshot& snapshot);
 
     /**
      * Reads the status_word register
@@ -151,10 +235,12 @@ class UCD90160 : public Device
      * Used to get better callouts.
      *
      * @param[in] config - the GPIOConfig entry to use
+     * @param[in] snapshot - the device state
      *
      * @return bool - true if a HW error was found, false else
      */
-    bool doExtraAnalysis(const ucd90160::GPIConfig& config);
+    bool doExtraAnalysis(const ucd90160::GPIConfig& config,
+                         const ucd90160::FaultSnapshot& snapshot);
 
     /**
      * Does additional fault analysis using GPIOs to
@@ -167,10 +253,12 @@ class UCD90160 : public Device
      * like an IO expander.
      *
      * @param[in] type - the type of analysis to do
+     * @param[in] snapshot - the device state
      *
      * @return bool - true if a HW error was found, false else
      */
-    bool doGPIOAnalysis(ucd90160::extraAnalysisType type);
+    bool doGPIOAnalysis(ucd90160::extraAnalysisType type,
+                        const ucd90160::FaultSnapshot& snapshot);
 
     /**
      * Says if we've already logged a Vout fault
@@ -268,6 +356,17 @@ class UCD90160 : public Device
      */
     std::vector<PartCallout> callouts;
 
+    /**
+     * The snapshot being analyzed.  The GPIO error functions take their
+     * metadata from it.
+     */
+    ucd90160::FaultSnapshot currentSnapshot;
+
+    /**
+     * The instance specific data of this device
+     */
+    const ucd90160::DeviceDefinition& definition;
+
     /**
      * The read/write interface to this hardware
      */
@@ -302,11 +401,6 @@ class UCD90160 : public Device
      * The D-Bus bus object
      */
     sdbusplus::bus::bus& bus;
-
-    /**
-     * Map of device instance to the instance specific data
-     */
-    static const ucd90160::DeviceMap deviceMap;
 };
 
 } // namespace power
@@ -67,6 +67,9 @@ void ArgumentParser::usage(char** argv)
     std::cerr << "Usage: " << argv[0] << " [options]\n";
     std::cerr << "Options:\n";
     std::cerr << "    --help                              Print this menu\n";
+    std::cerr << "    --all                               Monitor all the"
+                 " power supplies in the PSU JSON file, instead of --path,"
+                 " --instance, and --inventory\n";
     std::cerr << "    --path=<objpath>                    Path to location to"
                  " monitor\n";
     std::cerr << "    --instance=<instance number>        Instance number for"
@@ -79,21 +82,31 @@ void ArgumentParser::usage(char** argv)
                  " for the GPIO that performs the sync function\n";
     std::cerr << "    --sync-gpio-num=<path>              GPIO number for the"
                  " GPIO that performs the sync function\n";
+    std::cerr << "    --history-dir=<path>                Directory to keep"
+                 " the input power history in across restarts\n";
+    std::cerr << "    --record-signals                    Send only new input"
+                 " power history records in signals\n";
+    std::cerr << "    --poll-interval=<ms>                Interval to"
+                 " check each power supply for faults on\n";
     std::cerr << std::flush;
 }
 
 const option ArgumentParser::options[] = {
+    {"all", no_argument, NULL, 'c'},
     {"path", required_argument, NULL, 'p'},
     {"instance", required_argument, NULL, 'n'},
     {"inventory", required_argument, NULL, 'i'},
     {"num-history-records", required_argument, NULL, 'r'},
     {"sync-gpio-path", required_argument, NULL, 'a'},
     {"sync-gpio-num", required_argument, NULL, 'u'},
+    {"history-dir", required_argument, NULL, 'd'},
+    {"record-signals", no_argument, NULL, 's'},
+    {"poll-interval", required_argument, NULL, 't'},
     {"help", no_argument, NULL, 'h'},
     {0, 0, 0, 0},
 };
 
-const char* ArgumentParser::optionStr = "p:n:i:r:a:u:h";
+const char* ArgumentParser::optionStr = "cp:n:i:r:a:u:d:st:h";
 
 const std::string ArgumentParser::trueString = "true";
 const std::string ArgumentParser::emptyString = "";
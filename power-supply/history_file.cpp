@@ -0,0 +1,166 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "history_file.hpp"
+
+#include <errno.h>    // for errno
+#include <fcntl.h>    // for open()
+#include <string.h>   // for strerror()
+#include <sys/mman.h> // for mmap(), msync(), and munmap()
+#include <sys/stat.h> // for fstat()
+#include <unistd.h>   // for ftruncate()
+
+#include <bit>
+#include <stdexcept>
+
+namespace phosphor
+{
+namespace power
+{
+namespace history
+{
+
+namespace
+{
+
+// Identifies a history file.  Contains "PWRH".
+constexpr uint32_t MAGIC = 0x48525750;
+
+// Version of the file layout.  Must be incremented when the layout changes.
+constexpr uint32_t VERSION = 1;
+
+} // namespace
+
+HistoryFile::HistoryFile(const std::filesystem::path& path, size_t capacity) :
+    capacity(capacity), size(sizeof(Header) + capacity * sizeof(Slot))
+{
+    descriptor.set(open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644));
+    if (!descriptor)
+    {
+        throwError("Unable to open history file " + path.string());
+    }
+
+    struct stat info
+    {};
+    if (fstat(descriptor(), &info) == -1)
+    {
+        throwError("Unable to get size of history file " + path.string());
+    }
+
+    // A file of another size is emptied, which also zeroes the records
+    bool sizeMatches = (static_cast<size_t>(info.st_size) == size);
+    if (!sizeMatches && ((ftruncate(descriptor(), 0) == -1) ||
+                         (ftruncate(descriptor(), size) == -1)))
+    {
+        throwError("Unable to set size of history file " + path.string());
+    }
+
+    void* ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED,
+                     descriptor(), 0);
+    if (ptr == MAP_FAILED)
+    {
+        throwError("Unable to map history file " + path.string());
+    }
+    header = static_cast<Header*>(ptr);
+    slots = reinterpret_cast<Slot*>(header + 1);
+
+    if (sizeMatches && (header->magic == MAGIC) &&
+        (header->version == VERSION) && (header->slotSize == sizeof(Slot)) &&
+        (header->capacity == capacity))
+    {
+        load();
+    }
+    else
+    {
+        header->magic = MAGIC;
+        header->version = VERSION;
+        header->slotSize = sizeof(Slot);
+        header->capacity = capacity;
+        commit(0, 0);
+    }
+}
+
+HistoryFile::~HistoryFile()
+{
+    if (header != nullptr)
+    {
+        munmap(header, size);
+    }
+}
+
+void HistoryFile::put(size_t index, const Slot& slot)
+{
+    slots[index] = slot;
+    slots[index].check = getCheck(slot);
+}
+
+void HistoryFile::commit(size_t newestIndex, size_t count)
+{
+    newest = newestIndex;
+    numRecords = count;
+
+    // Release ordering keeps the record writes ahead of the header update
+    header->state.store(static_cast<uint64_t>(newest) |
+                            (static_cast<uint64_t>(numRecords) << 32),
+                        std::memory_order_release);
+    msync(header, size, MS_ASYNC);
+}
+
+uint64_t HistoryFile::getCheck(const Slot& slot)
+{
+    return MAGIC ^ slot.id ^ std::rotl(static_cast<uint64_t>(slot.time), 16) ^
+           std::rotl(static_cast<uint64_t>(slot.average), 32) ^
+           std::rotl(static_cast<uint64_t>(slot.maximum), 48);
+}
+
+void HistoryFile::load()
+{
+    auto state = header->state.load(std::memory_order_acquire);
+    size_t index = state & 0xFFFFFFFF;
+    size_t count = state >> 32;
+    if ((index >= capacity) || (count > capacity))
+    {
+        commit(0, 0);
+        return;
+    }
+
+    auto isValid = [this](size_t i) {
+        return slots[i].check == getCheck(slots[i]);
+    };
+
+    // After a power loss the header may have been written back without the
+    // newest record, so start from the one before it if needed
+    if ((count > 0) && !isValid(index))
+    {
+        index = (index + capacity - 1) % capacity;
+        count--;
+    }
+
+    size_t valid = 0;
+    while ((valid < count) && isValid((index + capacity - valid) % capacity))
+    {
+        valid++;
+    }
+    commit(index, valid);
+}
+
+void HistoryFile::throwError(const std::string& message)
+{
+    throw std::runtime_error{message + ": " + strerror(errno)};
+}
+
+} // namespace history
+} // namespace power
+} // namespace phosphor
@@ -0,0 +1,193 @@
+#pragma once
+
+#include "file_descriptor.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+namespace phosphor
+{
+namespace power
+{
+namespace history
+{
+
+/**
+ * @class HistoryFile
+ *
+ * A fixed size ring of input power history records, stored in a memory
+ * mapped file so the history survives a restart of the application.
+ *
+ * The file has a header followed by room for a fixed number of records.
+ * The header holds the index of the newest record and the number of
+ * records, packed into one word that is only updated after the record it
+ * refers to has been written, so a crash of the application never leaves
+ * the header pointing to a partly written record.  Each record also holds
+ * a check value, and when the file is opened the records are only kept up
+ * to the first one that fails its check, which drops the records torn by a
+ * power loss before the kernel wrote back all of the changed pages.
+ *
+ * A file that does not have the expected layout or capacity is emptied.
+ */
+class HistoryFile
+{
+  public:
+    /**
+     * @brief A record as stored in the file.
+     */
+    struct Slot
+    {
+        uint64_t id;
+        int64_t time;
+        int64_t average;
+        int64_t maximum;
+        uint64_t check;
+    };
+
+    HistoryFile() = delete;
+    HistoryFile(const HistoryFile&) = delete;
+    HistoryFile& operator=(const HistoryFile&) = delete;
+    HistoryFile(HistoryFile&&) = delete;
+    HistoryFile& operator=(HistoryFile&&) = delete;
+
+    /**
+     * @brief Constructor
+     *
+     * Opens the file, creating it if needed, and maps it.
+     *
+     * Throws an exception if an error occurs.
+     *
+     * @param[in] path - the path of the file
+     * @param[in] capacity - the maximum number of records in the file
+     */
+    HistoryFile(const std::filesystem::path& path, size_t capacity);
+
+    /**
+     * @brief Destructor.  Unmaps the file.
+     */
+    ~HistoryFile();
+
+    /**
+     * @brief Returns the index of the newest record
+     */
+    size_t getNewest() const
+    {
+        return newest;
+    }
+
+    /**
+     * @brief Returns the number of records
+     */
+    size_t getNumRecords() const
+    {
+        return numRecords;
+    }
+
+    /**
+     * @brief Returns a record
+     *
+     * @param[in] index - the index of the record, less than the capacity
+     */
+    const Slot& get(size_t index) const
+    {
+        return slots[index];
+    }
+
+    /**
+     * @brief Writes a record.  It is not part of the history until it is
+     *        included by commit().
+     *
+     * @param[in] index - the index of the record, less than the capacity
+     * @param[in] slot - the record; the check value is filled in
+     */
+    void put(size_t index, const Slot& slot);
+
+    /**
+     * @brief Updates the header to refer to the records written
+     *
+     * @param[in] newestIndex - the index of the newest record
+     * @param[in] count - the number of records
+     */
+    void commit(size_t newestIndex, size_t count);
+
+  private:
+    /**
+     * @brief The header at the beginning of the file.
+     */
+    struct Header
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t slotSize;
+        uint32_t capacity;
+
+        /**
+         * The index of the newest record in the low 32 bits, and the number
+         * of records in the high 32 bits.
+         */
+        std::atomic<uint64_t> state;
+    };
+
+    /**
+     * @brief Returns the check value of a record
+     *
+     * @param[in] slot - the record
+     */
+    static uint64_t getCheck(const Slot& slot);
+
+    /**
+     * @brief Finds the newest record and the number of records from the
+     *        header, dropping the records that fail their check.
+     */
+    void load();
+
+    /**
+     * @brief Throws an exception with the specified message and errno
+     *        description.
+     *
+     * @param[in] message - Error message
+     */
+    [[noreturn]] static void throwError(const std::string& message);
+
+    /**
+     * @brief The file descriptor of the file
+     */
+    util::FileDescriptor descriptor{};
+
+    /**
+     * @brief The maximum number of records in the file
+     */
+    size_t capacity;
+
+    /**
+     * @brief The size of the mapped file in bytes
+     */
+    size_t size;
+
+    /**
+     * @brief The mapped header
+     */
+    Header* header = nullptr;
+
+    /**
+     * @brief The mapped records
+     */
+    Slot* slots = nullptr;
+
+    /**
+     * @brief The index of the newest record
+     */
+    size_t newest = 0;
+
+    /**
+     * @brief The number of records
+     */
+    size_t numRecords = 0;
+};
+
+} // namespace history
+} // namespace power
+} // namespace phosphor
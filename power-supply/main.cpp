@@ -16,47 +16,133 @@
 #include "config.h"
 
 #include "argument.hpp"
+#include "config_cache.hpp"
 #include "device_monitor.hpp"
 #include "power_supply.hpp"
+#include "utility.hpp"
 
 #include <phosphor-logging/log.hpp>
 #include <sdeventplus/event.hpp>
 
 #include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
 
 using namespace phosphor::power;
 using namespace phosphor::logging;
 
-int main(int argc, char* argv[])
+namespace
 {
-    auto options = ArgumentParser(argc, argv);
 
-    auto objpath = (options)["path"];
-    auto instnum = (options)["instance"];
-    auto invpath = (options)["inventory"];
-    if (argc < 4)
+/**
+ * A power supply to monitor
+ */
+struct PSUConfig
+{
+    std::string objpath;
+    std::string instnum;
+    std::string invpath;
+};
+
+/**
+ * Reads the power supplies to monitor from the psuDevices of the PSU
+ * JSON file.  The instance number is the number at the end of the
+ * inventory path.
+ *
+ * @return the power supplies, empty if none could be read
+ */
+std::vector<PSUConfig> getPSUConfigs()
+{
+    std::vector<PSUConfig> psus;
+    auto config = util::loadConfigFile(PSU_JSON_PATH);
+    if (!config)
+    {
+        return psus;
+    }
+
+    const auto& devices = config->getPSUDevices();
+    if (devices.empty())
     {
-        std::cerr << std::endl << "Too few arguments" << std::endl;
-        options.usage(argv);
-        return -1;
+        log<level::ERR>("Unable to find psuDevices in the PSU JSON file");
+        return psus;
     }
 
-    if (objpath == ArgumentParser::emptyString)
+    for (const auto& [invpath, objpath] : devices)
     {
-        log<level::ERR>("Device monitoring path argument required");
-        return -2;
+        auto pos = invpath.find_last_not_of("0123456789");
+        if ((pos == std::string::npos) || (pos + 1 == invpath.size()))
+        {
+            log<level::ERR>("Invalid entry in psuDevices",
+                            entry("INVENTORY=%s", invpath.c_str()));
+            continue;
+        }
+        psus.push_back({objpath, invpath.substr(pos + 1), invpath});
     }
+    return psus;
+}
+
+} // namespace
 
-    if (instnum == ArgumentParser::emptyString)
+int main(int argc, char* argv[])
+{
+    auto options = ArgumentParser(argc, argv);
+
+    std::vector<PSUConfig> psus;
+    if ((options)["all"] == ArgumentParser::trueString)
+    {
+        psus = getPSUConfigs();
+        if (psus.empty())
+        {
+            log<level::ERR>("No power supplies found to monitor");
+            return -5;
+        }
+    }
+    else
     {
-        log<level::ERR>("Device monitoring instance number argument required");
-        return -3;
+        auto objpath = (options)["path"];
+        auto instnum = (options)["instance"];
+        auto invpath = (options)["inventory"];
+        if (argc < 4)
+        {
+            std::cerr << std::endl << "Too few arguments" << std::endl;
+            options.usage(argv);
+            return -1;
+        }
+
+        if (objpath == ArgumentParser::emptyString)
+        {
+            log<level::ERR>("Device monitoring path argument required");
+            return -2;
+        }
+
+        if (instnum == ArgumentParser::emptyString)
+        {
+            log<level::ERR>(
+                "Device monitoring instance number argument required");
+            return -3;
+        }
+
+        if (invpath == ArgumentParser::emptyString)
+        {
+            log<level::ERR>(
+                "Device monitoring inventory path argument required");
+            return -4;
+        }
+
+        psus.push_back({objpath, instnum, invpath});
     }
 
-    if (invpath == ArgumentParser::emptyString)
+    auto pollInterval = std::chrono::milliseconds(1000);
+    auto interval = (options)["poll-interval"];
+    if (interval != ArgumentParser::emptyString)
     {
-        log<level::ERR>("Device monitoring inventory path argument required");
-        return -4;
+        pollInterval = std::chrono::milliseconds(std::stol(interval));
+        if (pollInterval.count() <= 0)
+        {
+            std::cerr << "Invalid poll interval specified.\n";
+            return -8;
+        }
     }
 
     auto bus = sdbusplus::bus::new_default();
@@ -66,8 +152,6 @@ int main(int argc, char* argv[])
     // handle both sd_events (for the timers) and dbus signals.
     bus.attach_event(event.get(), SD_EVENT_PRIORITY_NORMAL);
 
-    auto objname = "power_supply" + instnum;
-    auto instance = std::stoul(instnum);
     // The state changes from 0 to 1 when the BMC_POWER_UP line to the power
     // sequencer is asserted. It can take 50ms for the sequencer to assert the
     // ENABLE# line that goes to the power supplies. The Witherspoon power
@@ -81,9 +165,6 @@ int main(int argc, char* argv[])
     // Timer to delay setting internal presence tracking. Allows for servicing
     // the power supply.
     std::chrono::seconds presentDelay(2);
-    auto psuDevice = std::make_unique<psu::PowerSupply>(
-        objname, std::move(instance), std::move(objpath), std::move(invpath),
-        bus, event, powerOnDelay, presentDelay);
 
     // Get the number of input power history records to keep in D-Bus.
     long int numRecords = 0;
@@ -98,42 +179,66 @@ int main(int argc, char* argv[])
         }
     }
 
-    if (numRecords != 0)
+    // Get the GPIO information for controlling the SYNC signal.
+    // If one is there, they both must be.
+    auto syncGPIOPath = (options)["sync-gpio-path"];
+    auto syncGPIONum = (options)["sync-gpio-num"];
+
+    if (((syncGPIOPath == ArgumentParser::emptyString) &&
+         (syncGPIONum != ArgumentParser::emptyString)) ||
+        ((syncGPIOPath != ArgumentParser::emptyString) &&
+         (syncGPIONum == ArgumentParser::emptyString)))
     {
-        // Get the GPIO information for controlling the SYNC signal.
-        // If one is there, they both must be.
-        auto syncGPIOPath = (options)["sync-gpio-path"];
-        auto syncGPIONum = (options)["sync-gpio-num"];
-
-        if (((syncGPIOPath == ArgumentParser::emptyString) &&
-             (syncGPIONum != ArgumentParser::emptyString)) ||
-            ((syncGPIOPath != ArgumentParser::emptyString) &&
-             (syncGPIONum == ArgumentParser::emptyString)))
-        {
-            std::cerr << "Invalid sync GPIO number or path\n";
-            return -7;
-        }
+        std::cerr << "Invalid sync GPIO number or path\n";
+        return -7;
+    }
 
-        size_t gpioNum = 0;
-        if (syncGPIONum != ArgumentParser::emptyString)
-        {
-            gpioNum = stoul(syncGPIONum);
-        }
+    size_t gpioNum = 0;
+    if (syncGPIONum != ArgumentParser::emptyString)
+    {
+        gpioNum = stoul(syncGPIONum);
+    }
 
-        std::string name{"ps" + instnum + "_input_power"};
-        std::string basePath =
-            std::string{INPUT_HISTORY_SENSOR_ROOT} + '/' + name;
+    auto historyDir = (options)["history-dir"];
+    bool recordSignals =
+        ((options)["record-signals"] == ArgumentParser::trueString);
 
-        psuDevice->enableHistory(basePath, numRecords, syncGPIOPath, gpioNum);
+    std::vector<std::unique_ptr<Device>> psuDevices;
+    std::vector<sdbusplus::server::manager::manager> objManagers;
+    for (const auto& psu : psus)
+    {
+        auto objname = "power_supply" + psu.instnum;
+        auto instance = std::stoul(psu.instnum);
+        auto psuDevice = std::make_unique<psu::PowerSupply>(
+            objname, instance, psu.objpath, psu.invpath, bus, event,
+            powerOnDelay, presentDelay);
 
-        // Systemd object manager
-        sdbusplus::server::manager::manager objManager{bus, basePath.c_str()};
+        if (numRecords != 0)
+        {
+            std::string name{"ps" + psu.instnum + "_input_power"};
+            std::string basePath =
+                std::string{INPUT_HISTORY_SENSOR_ROOT} + '/' + name;
+
+            // Keep the history in a file if a directory was specified
+            std::string historyFile;
+            if (historyDir != ArgumentParser::emptyString)
+            {
+                historyFile = historyDir + '/' + name;
+            }
+
+            psuDevice->enableHistory(basePath, numRecords, syncGPIOPath,
+                                     gpioNum, historyFile, recordSignals);
+
+            // Systemd object manager
+            objManagers.emplace_back(bus, basePath.c_str());
+
+            std::string busName =
+                std::string{INPUT_HISTORY_BUSNAME_ROOT} + '.' + name;
+            bus.request_name(busName.c_str());
+        }
 
-        std::string busName =
-            std::string{INPUT_HISTORY_BUSNAME_ROOT} + '.' + name;
-        bus.request_name(busName.c_str());
+        psuDevices.push_back(std::move(psuDevice));
     }
 
-    auto pollInterval = std::chrono::milliseconds(1000);
-    return DeviceMonitor(std::move(psuDevice), event, pollInterval).run();
+    return DeviceMonitor(std::move(psuDevices), event, pollInterval).run();
 }
@@ -19,6 +19,7 @@
 
 #include "elog-errors.hpp"
 #include "gpio.hpp"
+#include "i2c_pmbus.hpp"
 #include "names_values.hpp"
 #include "pmbus.hpp"
 #include "types.hpp"
@@ -28,7 +29,9 @@
 #include <phosphor-logging/log.hpp>
 #include <xyz/openbmc_project/Common/Device/error.hpp>
 
+#include <array>
 #include <functional>
+#include <span>
 
 namespace phosphor
 {
@@ -70,7 +73,7 @@ PowerSupply::PowerSupply(const std::string& name, size_t inst,
     try
     {
         // Read the 2 byte STATUS_WORD value to check for faults.
-        statusWord = pmbusIntf.read(STATUS_WORD, Type::Debug);
+        statusWord = statusIntf().read(STATUS_WORD, Type::Debug);
         if (!((statusWord & status_word::INPUT_FAULT_WARN) ||
               (statusWord & status_word::VIN_UV_FAULT)))
         {
@@ -103,29 +106,27 @@ PowerSupply::PowerSupply(const std::string& name, size_t inst,
 void PowerSupply::getAccessType()
 {
     using namespace phosphor::power::util;
-    fruJson = loadJSONFromFile(PSU_JSON_PATH);
-    if (fruJson == nullptr)
+    fruConfig = loadConfigFile(PSU_JSON_PATH);
+    if (!fruConfig)
     {
         log<level::ERR>("InternalFailure when parsing the JSON file");
         return;
     }
+    const auto& fruJson = fruConfig->getJSON();
     inventoryPMBusAccessType = getPMBusAccessType(fruJson);
-}
 
-void PowerSupply::captureCmd(util::NamesValues& nv, const std::string& cmd,
-                             phosphor::pmbus::Type type)
-{
-    if (pmbusIntf.exists(cmd, type))
+    using namespace phosphor::pmbus;
+    if (getPMBusBackend(fruJson, inventoryPath) == Backend::I2C)
     {
         try
         {
-            auto val = pmbusIntf.read(cmd, type);
-            nv.add(cmd, val);
+            i2cIntf = I2CPMBus::create(monitorPath);
         }
         catch (const std::exception& e)
         {
-            log<level::INFO>("Unable to capture metadata",
-                             entry("CMD=%s", cmd.c_str()));
+            log<level::ERR>("Unable to use the I2C PMBus backend",
+                            entry("PATH=%s", monitorPath.c_str()),
+                            entry("ERROR=%s", e.what()));
         }
     }
 }
@@ -141,7 +142,7 @@ void PowerSupply::analyze()
             std::uint16_t statusWord = 0;
 
             // Read the 2 byte STATUS_WORD value to check for faults.
-            statusWord = pmbusIntf.read(STATUS_WORD, Type::Debug);
+            statusWord = statusIntf().read(STATUS_WORD, Type::Debug);
             readFail = 0;
 
             checkInputFault(statusWord);
@@ -297,15 +298,14 @@ void PowerSupply::checkInputFault(const uint16_t statusWord)
         // If the power is on, report the fault in an error log entry.
         if (powerOn)
         {
-            util::NamesValues nv;
-            nv.add("STATUS_WORD", statusWord);
-            captureCmd(nv, STATUS_INPUT, Type::Debug);
+            faultDump = StatusDump::capture(statusIntf(), statusWord);
+            auto nv = faultDump.getNamesValues();
 
             using metadata =
                 org::open_power::Witherspoon::Fault::PowerSupplyInputFault;
 
             report<PowerSupplyInputFault>(
-                metadata::RAW_STATUS(nv.get().c_str()),
+                metadata::RAW_STATUS(nv.c_str()),
                 metadata::CALLOUT_INVENTORY_PATH(inventoryPath.c_str()));
 
             faultFound = true;
@@ -340,20 +340,15 @@ void PowerSupply::checkPGOrUnitOffFault(const uint16_t statusWord)
         {
             faultFound = true;
 
-            util::NamesValues nv;
-            nv.add("STATUS_WORD", statusWord);
-            captureCmd(nv, STATUS_INPUT, Type::Debug);
-            auto status0Vout = pmbusIntf.insertPageNum(STATUS_VOUT, 0);
-            captureCmd(nv, status0Vout, Type::Debug);
-            captureCmd(nv, STATUS_IOUT, Type::Debug);
-            captureCmd(nv, STATUS_MFR, Type::Debug);
+            faultDump = StatusDump::capture(statusIntf(), statusWord);
+            auto nv = faultDump.getNamesValues();
 
             using metadata =
                 org::open_power::Witherspoon::Fault::PowerSupplyShouldBeOn;
 
             // A power supply is OFF (or pgood low) but should be on.
             report<PowerSupplyShouldBeOn>(
-                metadata::RAW_STATUS(nv.get().c_str()),
+                metadata::RAW_STATUS(nv.c_str()),
                 metadata::CALLOUT_INVENTORY_PATH(inventoryPath.c_str()));
         }
     }
@@ -380,19 +375,14 @@ void PowerSupply::checkCurrentOutOverCurrentFault(const uint16_t statusWord)
 
         if (!faultFound && (outputOCFault >= FAULT_COUNT))
         {
-            util::NamesValues nv;
-            nv.add("STATUS_WORD", statusWord);
-            captureCmd(nv, STATUS_INPUT, Type::Debug);
-            auto status0Vout = pmbusIntf.insertPageNum(STATUS_VOUT, 0);
-            captureCmd(nv, status0Vout, Type::Debug);
-            captureCmd(nv, STATUS_IOUT, Type::Debug);
-            captureCmd(nv, STATUS_MFR, Type::Debug);
+            faultDump = StatusDump::capture(statusIntf(), statusWord);
+            auto nv = faultDump.getNamesValues();
 
             using metadata = org::open_power::Witherspoon::Fault::
                 PowerSupplyOutputOvercurrent;
 
             report<PowerSupplyOutputOvercurrent>(
-                metadata::RAW_STATUS(nv.get().c_str()),
+                metadata::RAW_STATUS(nv.c_str()),
                 metadata::CALLOUT_INVENTORY_PATH(inventoryPath.c_str()));
 
             faultFound = true;
@@ -421,19 +411,14 @@ void PowerSupply::checkOutputOvervoltageFault(const uint16_t statusWord)
 
         if (!faultFound && (outputOVFault >= FAULT_COUNT))
         {
-            util::NamesValues nv;
-            nv.add("STATUS_WORD", statusWord);
-            captureCmd(nv, STATUS_INPUT, Type::Debug);
-            auto status0Vout = pmbusIntf.insertPageNum(STATUS_VOUT, 0);
-            captureCmd(nv, status0Vout, Type::Debug);
-            captureCmd(nv, STATUS_IOUT, Type::Debug);
-            captureCmd(nv, STATUS_MFR, Type::Debug);
+            faultDump = StatusDump::capture(statusIntf(), statusWord);
+            auto nv = faultDump.getNamesValues();
 
             using metadata = org::open_power::Witherspoon::Fault::
                 PowerSupplyOutputOvervoltage;
 
             report<PowerSupplyOutputOvervoltage>(
-                metadata::RAW_STATUS(nv.get().c_str()),
+                metadata::RAW_STATUS(nv.c_str()),
                 metadata::CALLOUT_INVENTORY_PATH(inventoryPath.c_str()));
 
             faultFound = true;
@@ -462,17 +447,14 @@ void PowerSupply::checkFanFault(const uint16_t statusWord)
 
         if (!faultFound && (fanFault >= FAULT_COUNT))
         {
-            util::NamesValues nv;
-            nv.add("STATUS_WORD", statusWord);
-            captureCmd(nv, STATUS_MFR, Type::Debug);
-            captureCmd(nv, STATUS_TEMPERATURE, Type::Debug);
-            captureCmd(nv, STATUS_FANS_1_2, Type::Debug);
+            faultDump = StatusDump::capture(statusIntf(), statusWord);
+            auto nv = faultDump.getNamesValues();
 
             using metadata =
                 org::open_power::Witherspoon::Fault::PowerSupplyFanFault;
 
             report<PowerSupplyFanFault>(
-                metadata::RAW_STATUS(nv.get().c_str()),
+                metadata::RAW_STATUS(nv.c_str()),
                 metadata::CALLOUT_INVENTORY_PATH(inventoryPath.c_str()));
 
             faultFound = true;
@@ -490,7 +472,7 @@ void PowerSupply::checkTemperatureFault(const uint16_t statusWord)
     // STATUS_TEMPERATURE bits. If either indicates a fault, proceed with
     // logging the over-temperature condition.
     std::uint8_t statusTemperature = 0;
-    statusTemperature = pmbusIntf.read(STATUS_TEMPERATURE, Type::Debug);
+    statusTemperature = statusIntf().read(STATUS_TEMPERATURE, Type::Debug);
     if (temperatureFault < FAULT_COUNT)
     {
         if ((statusWord & status_word::TEMPERATURE_FAULT_WARN) ||
@@ -516,18 +498,15 @@ void PowerSupply::checkTemperatureFault(const uint16_t statusWord)
             // putting out less current.
             // Capture command responses with potentially relevant information,
             // and call out the power supply reporting the condition.
-            util::NamesValues nv;
-            nv.add("STATUS_WORD", statusWord);
-            captureCmd(nv, STATUS_MFR, Type::Debug);
-            captureCmd(nv, STATUS_IOUT, Type::Debug);
+            faultDump = StatusDump::capture(statusIntf(), statusWord);
+            auto nv = faultDump.getNamesValues();
             nv.add("STATUS_TEMPERATURE", statusTemperature);
-            captureCmd(nv, STATUS_FANS_1_2, Type::Debug);
 
             using metadata = org::open_power::Witherspoon::Fault::
                 PowerSupplyTemperatureFault;
 
             report<PowerSupplyTemperatureFault>(
-                metadata::RAW_STATUS(nv.get().c_str()),
+                metadata::RAW_STATUS(nv.c_str()),
                 metadata::CALLOUT_INVENTORY_PATH(inventoryPath.c_str()));
 
             faultFound = true;
@@ -619,21 +598,27 @@ void PowerSupply::updateInventory()
     Interfaces interfaces;
     Object object;
 
+    if (!fruConfig)
+    {
+        // The FRU JSON file could not be parsed, already logged
+        return;
+    }
+
     // If any of these accesses fail, the fields will just be
     // blank in the inventory.  Leave logging ReadFailure errors
     // to analyze() as it runs continuously and will most
     // likely hit and threshold them first anyway.  The
     // readString() function will do the tracing of the failing
     // path so this code doesn't need to.
-    for (const auto& fru : fruJson.at("fruConfigs"))
+    for (const auto& fru : fruConfig->getFRUConfigs())
     {
-        if (fru.at("interface") == ASSET_IFACE)
+        if (fru.interface == ASSET_IFACE)
         {
             try
             {
                 assetProps.emplace(
-                    fru.at("propertyName"),
-                    present ? pmbusIntf.readString(fru.at("fileName"),
+                    fru.propertyName,
+                    present ? pmbusIntf.readString(fru.fileName,
                                                    inventoryPMBusAccessType)
                             : "");
             }
@@ -708,13 +693,34 @@ void PowerSupply::syncHistory()
 void PowerSupply::enableHistory(const std::string& objectPath,
                                 size_t numRecords,
                                 const std::string& syncGPIOPath,
-                                size_t syncGPIONum)
+                                size_t syncGPIONum,
+                                const std::string& historyFile,
+                                bool recordSignals)
 {
     historyObjectPath = objectPath;
+    this->recordSignals = recordSignals;
     syncGPIODevPath = syncGPIOPath;
     syncGPIONumber = syncGPIONum;
 
-    recordManager = std::make_unique<history::RecordManager>(numRecords);
+    if (!historyFile.empty())
+    {
+        try
+        {
+            recordManager = std::make_unique<history::RecordManager>(
+                numRecords, history::RecordManager::LAST_SEQUENCE_ID,
+                historyFile);
+        }
+        catch (const std::exception& e)
+        {
+            log<level::ERR>("Unable to use input power history file",
+                            entry("FILE=%s", historyFile.c_str()),
+                            entry("ERROR=%s", e.what()));
+        }
+    }
+    if (!recordManager)
+    {
+        recordManager = std::make_unique<history::RecordManager>(numRecords);
+    }
 
     auto avgPath = historyObjectPath + '/' + history::Average::name;
     auto maxPath = historyObjectPath + '/' + history::Maximum::name;
@@ -722,6 +728,13 @@ void PowerSupply::enableHistory(const std::string& objectPath,
     average = std::make_unique<history::Average>(bus, avgPath);
 
     maximum = std::make_unique<history::Maximum>(bus, maxPath);
+
+    // Serve the history restored from the file right away
+    if (recordManager->getNumRecords() > 0)
+    {
+        average->values(recordManager->getAverageRecords());
+        maximum->values(recordManager->getMaximumRecords());
+    }
 }
 
 void PowerSupply::updateHistory()
@@ -733,16 +746,53 @@ void PowerSupply::updateHistory()
     }
 
     // Read just the most recent average/max record
-    auto data =
-        pmbusIntf.readBinary(INPUT_HISTORY, pmbus::Type::HwmonDeviceDebug,
-                             history::RecordManager::RAW_RECORD_SIZE);
+    std::array<uint8_t, history::RecordManager::RAW_RECORD_SIZE> data;
+    auto bytes = pmbusIntf.readBinary(
+        INPUT_HISTORY, pmbus::Type::HwmonDeviceDebug, std::span{data});
 
     // Update D-Bus only if something changed (a new record ID, or cleared out)
-    auto changed = recordManager->add(data);
+    auto changed =
+        recordManager->add(std::span<const uint8_t>{data.data(), bytes});
     if (changed)
     {
-        average->values(std::move(recordManager->getAverageRecords()));
-        maximum->values(std::move(recordManager->getMaximumRecords()));
+        const auto& averages = recordManager->getAverageRecords();
+        const auto& maximums = recordManager->getMaximumRecords();
+
+        // After the history was cleared or restarted the full lists are
+        // no bigger than the signal, so send them as usual
+        if (recordSignals && (averages.size() > 1))
+        {
+            average->values(averages, true);
+            maximum->values(maximums, true);
+            sendRecordAdded(historyObjectPath + '/' + history::Average::name,
+                            averages);
+            sendRecordAdded(historyObjectPath + '/' + history::Maximum::name,
+                            maximums);
+        }
+        else
+        {
+            average->values(averages);
+            maximum->values(maximums);
+        }
+    }
+}
+
+void PowerSupply::sendRecordAdded(
+    const std::string& objectPath,
+    const history::RecordManager::DBusRecordList& records)
+{
+    try
+    {
+        auto msg = bus.new_signal(objectPath.c_str(), RECORD_ADDED_INTERFACE,
+                                  RECORD_ADDED_SIGNAL);
+        msg.append(records.front());
+        msg.signal_send();
+    }
+    catch (const std::exception& e)
+    {
+        log<level::ERR>("Failed to send the RecordAdded signal",
+                        entry("PATH=%s", objectPath.c_str()),
+                        entry("ERROR=%s", e.what()));
     }
 }
 
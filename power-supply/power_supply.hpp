@@ -1,10 +1,12 @@
 #pragma once
 #include "average.hpp"
+#include "config_cache.hpp"
 #include "device.hpp"
 #include "maximum.hpp"
 #include "names_values.hpp"
 #include "pmbus.hpp"
 #include "record_manager.hpp"
+#include "status_dump.hpp"
 
 #include <nlohmann/json.hpp>
 #include <sdbusplus/bus/match.hpp>
@@ -22,6 +24,14 @@ namespace sdbusRule = sdbusplus::bus::match::rules;
 
 constexpr auto FAULT_COUNT = 3;
 
+// The signal the average and maximum history objects send with just the
+// newest record, instead of a PropertiesChanged signal with all of them,
+// when record signals are enabled.  The argument is the (timestamp, value)
+// tuple of the record.
+constexpr auto RECORD_ADDED_INTERFACE =
+    "org.open_power.Sensor.Aggregation.History.Records";
+constexpr auto RECORD_ADDED_SIGNAL = "RecordAdded";
+
 /**
  * @class PowerSupply
  * Represents a PMBus power supply device.
@@ -90,9 +100,18 @@ class PowerSupply : public Device
      * @param[in] syncGPIOPath - The gpiochip device path to use for
      *                           sending the sync command
      * @paramp[in] syncGPIONum - the GPIO number for the sync command
+     * @param[in] historyFile - the file to keep the records in across
+     *                          restarts, or empty to keep them in memory
+     * @param[in] recordSignals - true to send each new record in a
+     *                            RecordAdded signal, and update the values
+     *                            properties without PropertiesChanged
+     *                            signals, so the full lists are only sent
+     *                            when a client reads them
      */
     void enableHistory(const std::string& objectPath, size_t numRecords,
-                       const std::string& syncGPIOPath, size_t syncGPIONum);
+                       const std::string& syncGPIOPath, size_t syncGPIONum,
+                       const std::string& historyFile = "",
+                       bool recordSignals = false);
 
   private:
     /**
@@ -109,6 +128,30 @@ class PowerSupply : public Device
      */
     phosphor::pmbus::PMBus pmbusIntf;
 
+    /**
+     * @brief The I2C PMBus interface, if the JSON selects that backend
+     *
+     * Used instead of pmbusIntf to read the status commands.
+     */
+    std::unique_ptr<phosphor::pmbus::PMBusBase> i2cIntf;
+
+    /**
+     * @brief Returns the interface to read the status commands with
+     */
+    phosphor::pmbus::PMBusBase& statusIntf()
+    {
+        if (i2cIntf)
+        {
+            return *i2cIntf;
+        }
+        return pmbusIntf;
+    }
+
+    /**
+     * @brief The status registers captured for the last fault reported
+     */
+    StatusDump faultDump;
+
     /**
      * @brief D-Bus path to use for this power supply's inventory status.
      */
@@ -250,6 +293,12 @@ class PowerSupply : public Device
      */
     std::string historyObjectPath;
 
+    /**
+     * @brief If new history records are sent in RecordAdded signals
+     *        instead of PropertiesChanged signals.
+     */
+    bool recordSignals = false;
+
     /**
      * @brief The GPIO device path to use for sending the 'sync'
      *        command to the PS.
@@ -269,9 +318,10 @@ class PowerSupply : public Device
         phosphor::pmbus::Type::Base;
 
     /**
-     * @brief The JSON from the parsed power supply FRU JSON File.
+     * @brief The parsed power supply FRU JSON File, shared by the power
+     *        supplies monitored by the process.
      */
-    nlohmann::json fruJson;
+    std::shared_ptr<const phosphor::power::util::ConfigFile> fruConfig;
 
     /**
      * @brief get the power supply access type from the JSON file.
@@ -315,16 +365,6 @@ class PowerSupply : public Device
      */
     void powerStateChanged(sdbusplus::message::message& msg);
 
-    /**
-     * @brief Wrapper for PMBus::read() and adding metadata
-     *
-     * @param[out] nv - NamesValues instance to store cmd string and value
-     * @param[in] cmd - String for the command to read data from.
-     * @param[in] type - The type of file to read the command from.
-     */
-    void captureCmd(util::NamesValues& nv, const std::string& cmd,
-                    phosphor::pmbus::Type type);
-
     /**
      * @brief Checks for input voltage faults and logs error if needed.
      *
@@ -426,6 +466,16 @@ class PowerSupply : public Device
      * records.
      */
     void updateHistory();
+
+    /**
+     * @brief Sends a RecordAdded signal for the newest record of a history
+     *        object.
+     *
+     * @param[in] objectPath - the path of the average or maximum object
+     * @param[in] records - the records of the object, newest first
+     */
+    void sendRecordAdded(const std::string& objectPath,
+                         const history::RecordManager::DBusRecordList& records);
 };
 
 } // namespace psu
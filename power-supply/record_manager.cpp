@@ -30,13 +30,28 @@ namespace history
 
 using namespace phosphor::logging;
 
-bool RecordManager::add(const std::vector<uint8_t>& rawRecord)
+RecordManager::RecordManager(size_t maxRec, size_t lastSequenceID,
+                             const std::filesystem::path& path) :
+    maxRecords(maxRec),
+    lastSequenceID(lastSequenceID),
+    file(std::make_unique<HistoryFile>(path, maxRec))
+{
+    averageRecords.reserve(maxRec);
+    maximumRecords.reserve(maxRec);
+
+    newest = file->getNewest();
+    numRecords = file->getNumRecords();
+    restored = (numRecords > 0);
+    listsCurrent = !restored;
+}
+
+bool RecordManager::add(std::span<const uint8_t> rawRecord)
 {
     if (rawRecord.size() == 0)
     {
         // The PS has no data - either the power supply just started up,
         // or it just got a SYNC.  Clear the history.
-        records.clear();
+        clear();
         return true;
     }
 
@@ -45,9 +60,9 @@ bool RecordManager::add(const std::vector<uint8_t>& rawRecord)
         // Peek at the ID to see if more processing is needed.
         auto id = getRawRecordID(rawRecord);
 
-        if (!records.empty())
+        if (numRecords > 0)
         {
-            auto previousID = std::get<recIDPos>(records.front());
+            auto previousID = std::get<recIDPos>(getRecord(newest));
 
             // Already have this record.  Done.
             if (previousID == id)
@@ -65,7 +80,16 @@ bool RecordManager::add(const std::vector<uint8_t>& rawRecord)
                 auto rolledOver =
                     (previousID == lastSequenceID) && (id == FIRST_SEQUENCE_ID);
 
-                if (!rolledOver)
+                if (!rolledOver && restored)
+                {
+                    // The records stopped while the application was not
+                    // running, so there is nothing wrong with them
+                    log<level::INFO>("Restored INPUT_HISTORY continues "
+                                     "after a gap",
+                                     entry("OLD_ID=%ld", previousID),
+                                     entry("NEW_ID=%ld", id));
+                }
+                else if (!rolledOver)
                 {
                     if (id != FIRST_SEQUENCE_ID)
                     {
@@ -75,18 +99,26 @@ bool RecordManager::add(const std::vector<uint8_t>& rawRecord)
                             entry("OLD_ID=%ld", previousID),
                             entry("NEW_ID=%ld", id));
                     }
-                    records.clear();
+                    clear();
                 }
             }
         }
 
-        records.push_front(std::move(createRecord(rawRecord)));
+        auto record = createRecord(rawRecord);
 
-        // If no more should be stored, prune the oldest
-        if (records.size() > maxRecords)
+        // If no more should be stored, replace the oldest
+        if (maxRecords > 0)
         {
-            records.pop_back();
+            newest = (newest + 1) % maxRecords;
+            setRecord(newest, record);
+            if (numRecords < maxRecords)
+            {
+                numRecords++;
+            }
+            commit();
         }
+        restored = false;
+        listsCurrent = false;
     }
     catch (const InvalidRecordException& e)
     {
@@ -96,31 +128,73 @@ bool RecordManager::add(const std::vector<uint8_t>& rawRecord)
     return true;
 }
 
-auto RecordManager::getAverageRecords() -> DBusRecordList
+auto RecordManager::getAverageRecords() -> const DBusRecordList&
+{
+    updateLists();
+    return averageRecords;
+}
+
+auto RecordManager::getMaximumRecords() -> const DBusRecordList&
 {
-    DBusRecordList list;
+    updateLists();
+    return maximumRecords;
+}
 
-    for (const auto& r : records)
+void RecordManager::updateLists()
+{
+    if (listsCurrent)
     {
-        list.emplace_back(std::get<recTimePos>(r), std::get<recAvgPos>(r));
+        return;
     }
 
-    return list;
+    // The lists have capacity for maxRecords, so this does not allocate
+    averageRecords.clear();
+    maximumRecords.clear();
+    for (size_t i = 0; i < numRecords; i++)
+    {
+        auto r = getRecord((newest + maxRecords - i) % maxRecords);
+        averageRecords.emplace_back(std::get<recTimePos>(r),
+                                    std::get<recAvgPos>(r));
+        maximumRecords.emplace_back(std::get<recTimePos>(r),
+                                    std::get<recMaxPos>(r));
+    }
+    listsCurrent = true;
 }
 
-auto RecordManager::getMaximumRecords() -> DBusRecordList
+Record RecordManager::getRecord(size_t index) const
 {
-    DBusRecordList list;
+    if (file)
+    {
+        const auto& slot = file->get(index);
+        return Record{slot.id, slot.time, slot.average, slot.maximum};
+    }
+    return records[index];
+}
 
-    for (const auto& r : records)
+void RecordManager::setRecord(size_t index, const Record& record)
+{
+    if (file)
     {
-        list.emplace_back(std::get<recTimePos>(r), std::get<recMaxPos>(r));
+        file->put(index, HistoryFile::Slot{std::get<recIDPos>(record),
+                                           std::get<recTimePos>(record),
+                                           std::get<recAvgPos>(record),
+                                           std::get<recMaxPos>(record), 0});
     }
+    else
+    {
+        records[index] = record;
+    }
+}
 
-    return list;
+void RecordManager::commit()
+{
+    if (file)
+    {
+        file->commit(newest, numRecords);
+    }
 }
 
-size_t RecordManager::getRawRecordID(const std::vector<uint8_t>& data) const
+size_t RecordManager::getRawRecordID(std::span<const uint8_t> data) const
 {
     if (data.size() != RAW_RECORD_SIZE)
     {
@@ -132,7 +206,7 @@ size_t RecordManager::getRawRecordID(const std::vector<uint8_t>& data) const
     return data[RAW_RECORD_ID_OFFSET];
 }
 
-Record RecordManager::createRecord(const std::vector<uint8_t>& data)
+Record RecordManager::createRecord(std::span<const uint8_t> data)
 {
     // The raw record format is:
     //  0xAABBCCDDEE
@@ -178,7 +252,7 @@ int64_t RecordManager::linearToInteger(uint16_t data)
         mantissa = (mantissa + 1) * -1;
     }
 
-    auto value = static_cast<float>(mantissa) * pow(2, exponent);
+    auto value = ldexp(static_cast<double>(mantissa), exponent);
     return value;
 }
 
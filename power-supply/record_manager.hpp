@@ -1,7 +1,11 @@
 #pragma once
 
+#include "history_file.hpp"
+
 #include <cstdint>
-#include <deque>
+#include <filesystem>
+#include <memory>
+#include <span>
 #include <stdexcept>
 #include <tuple>
 #include <vector>
@@ -59,8 +63,8 @@ class RecordManager
 
     RecordManager() = delete;
     ~RecordManager() = default;
-    RecordManager(const RecordManager&) = default;
-    RecordManager& operator=(const RecordManager&) = default;
+    RecordManager(const RecordManager&) = delete;
+    RecordManager& operator=(const RecordManager&) = delete;
     RecordManager(RecordManager&&) = default;
     RecordManager& operator=(RecordManager&&) = default;
 
@@ -82,8 +86,31 @@ class RecordManager
      *                             will use before starting over
      */
     RecordManager(size_t maxRec, size_t lastSequenceID) :
-        maxRecords(maxRec), lastSequenceID(lastSequenceID)
-    {}
+        maxRecords(maxRec), lastSequenceID(lastSequenceID), records(maxRec)
+    {
+        averageRecords.reserve(maxRec);
+        maximumRecords.reserve(maxRec);
+    }
+
+    /**
+     * @brief Constructor
+     *
+     * Keeps the records in a memory mapped file instead of on the heap, so
+     * they are restored when the application restarts.  The restored
+     * records are kept even if the sequence ID of the next record from the
+     * power supply does not follow them, since the gap is the time the
+     * application was not running.
+     *
+     * Throws an exception if the file cannot be opened.
+     *
+     * @param[in] maxRec - the maximum number of history
+     *                     records to keep at a time
+     * @param[in] lastSequenceID - the last sequence ID the power supply
+     *                             will use before starting over
+     * @param[in] path - the path of the history file
+     */
+    RecordManager(size_t maxRec, size_t lastSequenceID,
+                  const std::filesystem::path& path);
 
     /**
      * @brief Adds a new entry to the history
@@ -99,25 +126,33 @@ class RecordManager
      *                history records that needs to be
      *                reflected in D-Bus.
      */
-    bool add(const std::vector<uint8_t>& rawRecord);
+    bool add(std::span<const uint8_t> rawRecord);
 
     /**
      * @brief Returns the history of average input power
      *        in a representation used by D-Bus.
      *
-     * @return DBusRecordList - A list of averages with
-     *         a timestamp for each entry.
+     * The list is only refilled after the records change,
+     * and reuses its storage.  It is valid until the next
+     * call that changes the records.
+     *
+     * @return const DBusRecordList& - A list of averages
+     *         with a timestamp for each entry.
      */
-    DBusRecordList getAverageRecords();
+    const DBusRecordList& getAverageRecords();
 
     /**
      * @brief Returns the history of maximum input power
      *        in a representation used by D-Bus.
      *
-     * @return DBusRecordList - A list of maximums with
-     *         a timestamp for each entry.
+     * The list is only refilled after the records change,
+     * and reuses its storage.  It is valid until the next
+     * call that changes the records.
+     *
+     * @return const DBusRecordList& - A list of maximums
+     *         with a timestamp for each entry.
      */
-    DBusRecordList getMaximumRecords();
+    const DBusRecordList& getMaximumRecords();
 
     /**
      * @brief Converts a Linear Format power number to an integer
@@ -140,7 +175,7 @@ class RecordManager
      */
     inline size_t getNumRecords() const
     {
-        return records.size();
+        return numRecords;
     }
 
     /**
@@ -148,7 +183,9 @@ class RecordManager
      */
     inline void clear()
     {
-        records.clear();
+        numRecords = 0;
+        listsCurrent = false;
+        commit();
     }
 
   private:
@@ -161,7 +198,7 @@ class RecordManager
      *
      * @return size_t - the ID from byte 0
      */
-    size_t getRawRecordID(const std::vector<uint8_t>& data) const;
+    size_t getRawRecordID(std::span<const uint8_t> data) const;
 
     /**
      * @brief Creates an instance of a Record from the raw PS data
@@ -170,7 +207,37 @@ class RecordManager
      *
      * @return Record - A filled in Record instance
      */
-    Record createRecord(const std::vector<uint8_t>& data);
+    Record createRecord(std::span<const uint8_t> data);
+
+    /**
+     * @brief Returns a record from the ring buffer
+     *
+     * @param[in] index - the index of the record
+     *
+     * @return Record - the record
+     */
+    Record getRecord(size_t index) const;
+
+    /**
+     * @brief Stores a record in the ring buffer
+     *
+     * @param[in] index - the index of the record
+     * @param[in] record - the record
+     */
+    void setRecord(size_t index, const Record& record);
+
+    /**
+     * @brief Writes the newest index and the number of records to the
+     *        history file, if there is one.
+     */
+    void commit();
+
+    /**
+     * @brief Fills in the D-Bus record lists from the records,
+     *        newest first, if the records changed since they
+     *        were last filled in.
+     */
+    void updateLists();
 
     /**
      * @brief The maximum number of entries to keep in the history.
@@ -186,11 +253,50 @@ class RecordManager
     const size_t lastSequenceID;
 
     /**
-     * @brief The list of timestamp/average/maximum records.
-     *        Newer records are added to the front, and older ones
-     *        removed from the back.
+     * @brief The timestamp/average/maximum records.
+     *
+     * A ring buffer with room for maxRecords entries.  A new record
+     * is stored after the newest one, replacing the oldest record
+     * once the buffer is full.  Empty if the records are kept in
+     * the history file.
+     */
+    std::vector<Record> records;
+
+    /**
+     * @brief The history file holding the ring buffer, if any.
+     */
+    std::unique_ptr<HistoryFile> file;
+
+    /**
+     * @brief If the records were restored from the history file
+     *        and no record has been added since.
+     */
+    bool restored = false;
+
+    /**
+     * @brief The index of the newest record.
+     */
+    size_t newest = 0;
+
+    /**
+     * @brief The number of records in the buffer.
+     */
+    size_t numRecords = 0;
+
+    /**
+     * @brief The D-Bus list of average records, newest first.
+     */
+    DBusRecordList averageRecords;
+
+    /**
+     * @brief The D-Bus list of maximum records, newest first.
+     */
+    DBusRecordList maximumRecords;
+
+    /**
+     * @brief If the D-Bus record lists match the records.
      */
-    std::deque<Record> records;
+    bool listsCurrent = true;
 };
 
 } // namespace history
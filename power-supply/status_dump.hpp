@@ -0,0 +1,182 @@
+#pragma once
+#include "names_values.hpp"
+#include "pmbus.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace phosphor
+{
+namespace power
+{
+namespace psu
+{
+
+/**
+ * @class StatusDump
+ *
+ * The status registers of a power supply, captured together when a fault
+ * is found.
+ *
+ * All of the registers are read with a single readStatusSnapshot() call,
+ * so the backend can read them in as few transactions as it allows, and
+ * bits that are only set briefly are less likely to be missed.  The values
+ * are kept as raw bytes, and the name=value text for the error log metadata
+ * is only built by getNamesValues().
+ */
+class StatusDump
+{
+  public:
+    /**
+     * The registers in a dump, in the order they are read and added to the
+     * metadata.
+     */
+    enum class Register : uint8_t
+    {
+        input,
+        vout,
+        iout,
+        temperature,
+        cml,
+        mfr,
+        fans12
+    };
+
+    /**
+     * The number of Register values
+     */
+    static constexpr size_t numRegisters = 7;
+
+    StatusDump() = default;
+    StatusDump(const StatusDump&) = default;
+    StatusDump& operator=(const StatusDump&) = default;
+    StatusDump(StatusDump&&) = default;
+    StatusDump& operator=(StatusDump&&) = default;
+    ~StatusDump() = default;
+
+    /**
+     * Captures the status registers of a power supply.
+     *
+     * A register that cannot be read is left out of the dump.
+     *
+     * @param[in] pmbus - the interface to read the registers with
+     * @param[in] statusWord - the STATUS_WORD value the fault was found in
+     *
+     * @return StatusDump - the registers read
+     */
+    static StatusDump capture(phosphor::pmbus::PMBusBase& pmbus,
+                              uint16_t statusWord)
+    {
+        using namespace phosphor::pmbus;
+
+        std::vector<std::string> names{STATUS_INPUT,
+                                       pmbus.insertPageNum(STATUS_VOUT, 0),
+                                       STATUS_IOUT,
+                                       STATUS_TEMPERATURE,
+                                       STATUS_CML,
+                                       STATUS_MFR,
+                                       STATUS_FANS_1_2};
+
+        StatusDump dump;
+        dump.statusWord = statusWord;
+
+        auto snapshot = pmbus.readStatusSnapshot(names, Type::Debug);
+        for (size_t i = 0; i < numRegisters; i++)
+        {
+            if (snapshot.valid[i])
+            {
+                dump.values[i] = static_cast<uint8_t>(snapshot.values[i]);
+                dump.validMask |= 1 << i;
+            }
+        }
+
+        return dump;
+    }
+
+    /**
+     * Returns the STATUS_WORD value the fault was found in.
+     *
+     * @return uint16_t - the STATUS_WORD value
+     */
+    uint16_t getStatusWord() const
+    {
+        return statusWord;
+    }
+
+    /**
+     * Returns whether a register was read.
+     *
+     * @param[in] reg - the register
+     *
+     * @return bool - true if the register is in the dump
+     */
+    bool isValid(Register reg) const
+    {
+        return validMask & (1 << static_cast<size_t>(reg));
+    }
+
+    /**
+     * Returns the value of a register.
+     *
+     * @param[in] reg - the register
+     *
+     * @return uint8_t - the value, or 0 if it was not read
+     */
+    uint8_t getValue(Register reg) const
+    {
+        return values[static_cast<size_t>(reg)];
+    }
+
+    /**
+     * Builds the error log metadata for the dump.
+     *
+     * STATUS_WORD is first, followed by the registers that were read, named
+     * by their PMBus file names.
+     *
+     * @return FixedNamesValues - the name=value pairs
+     */
+    util::FixedNamesValues<> getNamesValues() const
+    {
+        using namespace phosphor::pmbus;
+
+        // The names used for the metadata, in Register order.  STATUS_VOUT
+        // is always read from page 0.
+        static constexpr std::array<const char*, numRegisters> names{
+            STATUS_INPUT, "status0_vout", STATUS_IOUT,     STATUS_TEMPERATURE,
+            STATUS_CML,   STATUS_MFR,     STATUS_FANS_1_2};
+
+        util::FixedNamesValues<> nv;
+        nv.add("STATUS_WORD", statusWord);
+        for (size_t i = 0; i < numRegisters; i++)
+        {
+            if (validMask & (1 << i))
+            {
+                nv.add(names[i], values[i]);
+            }
+        }
+        return nv;
+    }
+
+  private:
+    /**
+     * The STATUS_WORD value the fault was found in
+     */
+    uint16_t statusWord = 0;
+
+    /**
+     * The bits of the registers that were read, by Register value
+     */
+    uint8_t validMask = 0;
+
+    /**
+     * The register values, by Register value
+     */
+    std::array<uint8_t, numRegisters> values{};
+};
+
+} // namespace psu
+} // namespace power
+} // namespace phosphor
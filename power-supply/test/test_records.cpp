@@ -16,6 +16,10 @@
 #include "../record_manager.hpp"
 #include "names_values.hpp"
 
+#include <stdlib.h> // for mkdtemp()
+
+#include <filesystem>
+#include <fstream>
 #include <iostream>
 
 #include <gtest/gtest.h>
@@ -178,3 +182,108 @@ TEST(ManagerTest, TestRecordAdds)
     mgr.add(std::vector<uint8_t>{});
     EXPECT_EQ(0, mgr.getNumRecords());
 }
+
+/**
+ * Test that the D-Bus record lists reuse their storage
+ */
+TEST(ManagerTest, TestRecordListStorage)
+{
+    RecordManager mgr{3};
+
+    // Fill the buffer, then replace the oldest record
+    for (uint8_t id = 0; id < 4; id++)
+    {
+        mgr.add(makeRawRecord(id, id, id + 10));
+    }
+    EXPECT_EQ(3, mgr.getNumRecords());
+
+    const auto& avgRecords = mgr.getAverageRecords();
+    ASSERT_EQ(3, avgRecords.size());
+    EXPECT_EQ(3, std::get<1>(avgRecords[0]));
+    EXPECT_EQ(1, std::get<1>(avgRecords[2]));
+    auto storage = avgRecords.data();
+
+    // Same ID, no change
+    EXPECT_FALSE(mgr.add(makeRawRecord(3, 5, 15)));
+
+    EXPECT_TRUE(mgr.add(makeRawRecord(4, 7, 17)));
+    const auto& newAvgRecords = mgr.getAverageRecords();
+    EXPECT_EQ(storage, newAvgRecords.data());
+    EXPECT_EQ(7, std::get<1>(newAvgRecords[0]));
+    EXPECT_EQ(2, std::get<1>(newAvgRecords[2]));
+    EXPECT_EQ(17, std::get<1>(mgr.getMaximumRecords()[0]));
+}
+
+/**
+ * Test that the records kept in a history file are restored
+ */
+TEST(ManagerTest, TestRecordFile)
+{
+    char dirTemplate[] = "/tmp/test_records-XXXXXX";
+    std::filesystem::path dir = mkdtemp(dirTemplate);
+    auto path = dir / "ps0_input_power";
+
+    {
+        RecordManager mgr{3, 8, path};
+        EXPECT_EQ(0, mgr.getNumRecords());
+        for (uint8_t id = 0; id < 4; id++)
+        {
+            mgr.add(makeRawRecord(id, id, id + 10));
+        }
+        EXPECT_EQ(3, mgr.getNumRecords());
+    }
+
+    {
+        // Restored, and kept even though the next ID does not follow
+        RecordManager mgr{3, 8, path};
+        ASSERT_EQ(3, mgr.getNumRecords());
+        EXPECT_EQ(3, std::get<1>(mgr.getAverageRecords()[0]));
+        EXPECT_EQ(1, std::get<1>(mgr.getAverageRecords()[2]));
+        EXPECT_EQ(13, std::get<1>(mgr.getMaximumRecords()[0]));
+
+        EXPECT_TRUE(mgr.add(makeRawRecord(6, 6, 16)));
+        ASSERT_EQ(3, mgr.getNumRecords());
+        EXPECT_EQ(6, std::get<1>(mgr.getAverageRecords()[0]));
+        EXPECT_EQ(2, std::get<1>(mgr.getAverageRecords()[2]));
+
+        // Only the first record after the restore may skip IDs
+        EXPECT_TRUE(mgr.add(makeRawRecord(2, 2, 12)));
+        EXPECT_EQ(1, mgr.getNumRecords());
+        EXPECT_TRUE(mgr.add(makeRawRecord(3, 3, 13)));
+    }
+
+    {
+        // Corrupt the oldest record, the first one in the file after the
+        // 24 byte header, as a power loss could
+        std::fstream file{path, std::ios::in | std::ios::out |
+                                    std::ios::binary};
+        file.seekp(24);
+        file.put(0x5A);
+    }
+
+    {
+        RecordManager mgr{3, 8, path};
+        ASSERT_EQ(1, mgr.getNumRecords());
+        EXPECT_EQ(3, std::get<1>(mgr.getAverageRecords()[0]));
+
+        // Cleared records stay cleared
+        mgr.add(std::vector<uint8_t>{});
+    }
+
+    {
+        RecordManager mgr{3, 8, path};
+        EXPECT_EQ(0, mgr.getNumRecords());
+    }
+
+    {
+        // A file with another capacity starts over
+        RecordManager mgr{3, 8, path};
+        mgr.add(makeRawRecord(0, 1, 11));
+    }
+    {
+        RecordManager mgr{5, 8, path};
+        EXPECT_EQ(0, mgr.getNumRecords());
+    }
+
+    std::filesystem::remove_all(dir);
+}
@@ -0,0 +1,67 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "../status_dump.hpp"
+#include "test/fake_pmbus.hpp"
+
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace phosphor::power::psu;
+using namespace phosphor::pmbus;
+
+TEST(StatusDumpTest, Capture)
+{
+    FakePMBus pmbus;
+    pmbus.values = {{STATUS_INPUT, 0x10},       {"status0_vout", 0x80},
+                    {STATUS_IOUT, 0x00},        {STATUS_TEMPERATURE, 0x40},
+                    {STATUS_CML, 0x02},         {STATUS_MFR, 0x20},
+                    {STATUS_FANS_1_2, 0x08}};
+
+    // All of the registers are read together
+    auto dump = StatusDump::capture(pmbus, 0x0844);
+    EXPECT_EQ(pmbus.snapshotCount, 1);
+    EXPECT_EQ(dump.getStatusWord(), 0x0844);
+    EXPECT_TRUE(dump.isValid(StatusDump::Register::vout));
+    EXPECT_EQ(dump.getValue(StatusDump::Register::vout), 0x80);
+    EXPECT_EQ(dump.getValue(StatusDump::Register::fans12), 0x08);
+
+    EXPECT_EQ(dump.getNamesValues().get(),
+              "STATUS_WORD=0x844|status0_input=0x10|status0_vout=0x80|"
+              "status0_iout=0x0|status0_temp=0x40|status0_cml=0x2|"
+              "status0_mfr=0x20|status0_fan12=0x8");
+}
+
+TEST(StatusDumpTest, CaptureFailures)
+{
+    // The registers that cannot be read are left out
+    FakePMBus pmbus;
+    pmbus.values = {{STATUS_INPUT, 0x10}, {STATUS_MFR, 0x20}};
+
+    auto dump = StatusDump::capture(pmbus, 0x2000);
+    EXPECT_TRUE(dump.isValid(StatusDump::Register::input));
+    EXPECT_FALSE(dump.isValid(StatusDump::Register::vout));
+    EXPECT_EQ(dump.getValue(StatusDump::Register::vout), 0);
+    EXPECT_EQ(dump.getNamesValues().get(),
+              "STATUS_WORD=0x2000|status0_input=0x10|status0_mfr=0x20");
+
+    // Nothing was captured
+    StatusDump empty;
+    EXPECT_EQ(empty.getNamesValues().get(), "STATUS_WORD=0x0");
+}
@@ -0,0 +1,133 @@
+/**
+ * Copyright © 2026 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "power_state_watcher.hpp"
+
+#include "types.hpp"
+#include "utility.hpp"
+
+#include <phosphor-logging/log.hpp>
+
+#include <exception>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace phosphor::power::util
+{
+
+using namespace phosphor::logging;
+namespace rules = sdbusplus::bus::match::rules;
+
+PowerStateWatcher::PowerStateWatcher(sdbusplus::bus::bus& bus,
+                                     bool defaultState) :
+    bus{bus},
+    defaultState{defaultState}
+{
+    // Add the match first so a change after the read is not missed
+    match = std::make_unique<sdbusplus::bus::match_t>(
+        bus, rules::propertiesChanged(POWER_OBJ_PATH, POWER_IFACE),
+        [this](sdbusplus::message::message& msg) { propertiesChanged(msg); });
+    readState();
+}
+
+bool PowerStateWatcher::isPoweredOn()
+{
+    if (!state)
+    {
+        readState();
+    }
+    return state.value_or(defaultState);
+}
+
+uint64_t PowerStateWatcher::addCallback(Callback callback)
+{
+    uint64_t id = nextID++;
+    callbacks.emplace(id, std::move(callback));
+    return id;
+}
+
+void PowerStateWatcher::removeCallback(uint64_t id)
+{
+    callbacks.erase(id);
+}
+
+void PowerStateWatcher::readState()
+{
+    try
+    {
+        // When state = 1, system is powered on
+        int32_t value{0};
+        auto service = getService(POWER_OBJ_PATH, POWER_IFACE, bus, false);
+        getProperty<int32_t>(POWER_IFACE, "state", POWER_OBJ_PATH, service, bus,
+                             value);
+        state = (value != 0);
+    }
+    catch (const std::exception& e)
+    {
+        log<level::INFO>("Failed to get power state.");
+    }
+}
+
+void PowerStateWatcher::propertiesChanged(sdbusplus::message::message& msg)
+{
+    try
+    {
+        std::string interface;
+        std::map<std::string, std::variant<int32_t>> properties;
+        msg.read(interface, properties);
+
+        auto it = properties.find("state");
+        if (it != properties.end())
+        {
+            setState(std::get<int32_t>(it->second) != 0);
+        }
+    }
+    catch (const std::exception& e)
+    {
+        // Ignore, the property may be of a different type than expected.
+    }
+}
+
+void PowerStateWatcher::setState(bool powerOn)
+{
+    bool changed = (state != powerOn);
+    state = powerOn;
+    if (!changed)
+    {
+        return;
+    }
+
+    // A callback can remove itself or others, so call them from a copy of
+    // the IDs
+    std::vector<uint64_t> ids;
+    for (const auto& [id, callback] : callbacks)
+    {
+        ids.push_back(id);
+    }
+    for (uint64_t id : ids)
+    {
+        auto it = callbacks.find(id);
+        if (it != callbacks.end())
+        {
+            // Copy, so removing the callback while it runs is safe
+            Callback callback = it->second;
+            callback(powerOn);
+        }
+    }
+}
+
+} // namespace phosphor::power::util
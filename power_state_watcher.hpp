@@ -0,0 +1,140 @@
+#pragma once
+
+#include <sdbusplus/bus.hpp>
+#include <sdbusplus/bus/match.hpp>
+#include <sdbusplus/message.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <optional>
+
+namespace phosphor::power::util
+{
+
+/**
+ * @class PowerStateWatcher
+ *
+ * Tracks whether the system is powered on, so a daemon does not need a D-Bus
+ * property get each time it checks.
+ *
+ * Adds one match for the PropertiesChanged signals of the power control
+ * object and reads the state once when constructed.  isPoweredOn() then
+ * returns the cached state.  If the state could not be read, such as when
+ * the power control service is not running yet, it is read again by
+ * isPoweredOn() until it is known.
+ *
+ * The registered callbacks are called from the event loop when the state
+ * changes.
+ */
+class PowerStateWatcher
+{
+  public:
+    using Callback = std::function<void(bool powerOn)>;
+
+    PowerStateWatcher() = delete;
+    ~PowerStateWatcher() = default;
+    PowerStateWatcher(const PowerStateWatcher&) = delete;
+    PowerStateWatcher& operator=(const PowerStateWatcher&) = delete;
+    PowerStateWatcher(PowerStateWatcher&&) = delete;
+    PowerStateWatcher& operator=(PowerStateWatcher&&) = delete;
+
+    /**
+     * Constructor
+     *
+     * @param[in] bus - the D-Bus object
+     * @param[in] defaultState - the state returned while the power state is
+     *                           not known
+     */
+    explicit PowerStateWatcher(sdbusplus::bus::bus& bus,
+                               bool defaultState = false);
+
+    /**
+     * Returns whether the system is powered on.
+     *
+     * @return bool - true if power is on, otherwise false; the default state
+     *                if the power state is not known
+     */
+    bool isPoweredOn();
+
+    /**
+     * Returns whether the power state is known, because it was read or a
+     * signal with it was received.
+     *
+     * @return bool - true if the power state is known
+     */
+    bool isKnown() const
+    {
+        return state.has_value();
+    }
+
+    /**
+     * Registers a callback called when the power state changes.
+     *
+     * @param[in] callback - called with the new state
+     *
+     * @return uint64_t - the ID of the callback, for removeCallback()
+     */
+    uint64_t addCallback(Callback callback);
+
+    /**
+     * Removes a callback.  Does nothing if it was already removed.
+     *
+     * @param[in] id - the ID of the callback
+     */
+    void removeCallback(uint64_t id);
+
+  private:
+    /**
+     * Reads the power state from D-Bus.  The state is not changed if it
+     * cannot be read.
+     */
+    void readState();
+
+    /**
+     * Updates the state from a PropertiesChanged signal.
+     *
+     * @param[in] msg - the signal
+     */
+    void propertiesChanged(sdbusplus::message::message& msg);
+
+    /**
+     * Sets the power state and calls the callbacks if it changed.
+     *
+     * @param[in] powerOn - the new state
+     */
+    void setState(bool powerOn);
+
+    /**
+     * The D-Bus object.
+     */
+    sdbusplus::bus::bus& bus;
+
+    /**
+     * The state returned while the power state is not known.
+     */
+    bool defaultState;
+
+    /**
+     * The power state, or std::nullopt if not known.
+     */
+    std::optional<bool> state{};
+
+    /**
+     * The ID of the next callback.
+     */
+    uint64_t nextID{0};
+
+    /**
+     * The callbacks, by ID.
+     */
+    std::map<uint64_t, Callback> callbacks{};
+
+    /**
+     * The match for the power state signals.
+     */
+    std::unique_ptr<sdbusplus::bus::match_t> match{};
+};
+
+} // namespace phosphor::power::util
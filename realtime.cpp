@@ -0,0 +1,225 @@
+/**
+ * Copyright © 2026 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "realtime.hpp"
+
+#include <poll.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <phosphor-logging/log.hpp>
+
+#include <cerrno>
+#include <cstdint>
+#include <exception>
+#include <stdexcept>
+#include <system_error>
+
+namespace phosphor::power::util
+{
+
+using namespace phosphor::logging;
+
+std::vector<int> parseCPUList(const std::string& list)
+{
+    auto parseCPU = [&list](const std::string& text) {
+        std::size_t length{0};
+        int cpu{-1};
+        try
+        {
+            cpu = std::stoi(text, &length);
+        }
+        catch (const std::exception&)
+        {}
+        if (text.empty() || (length != text.size()) || (cpu < 0) ||
+            (cpu >= CPU_SETSIZE))
+        {
+            throw std::invalid_argument{"Invalid CPU list: " + list};
+        }
+        return cpu;
+    };
+
+    std::vector<int> cpus{};
+    std::size_t start{0};
+    while (start <= list.size())
+    {
+        std::size_t end = list.find(',', start);
+        if (end == std::string::npos)
+        {
+            end = list.size();
+        }
+        std::string item = list.substr(start, end - start);
+
+        std::size_t dash = item.find('-');
+        int first = parseCPU(item.substr(0, dash));
+        int last = (dash == std::string::npos)
+                       ? first
+                       : parseCPU(item.substr(dash + 1));
+        if (last < first)
+        {
+            throw std::invalid_argument{"Invalid CPU list: " + list};
+        }
+        for (int cpu = first; cpu <= last; ++cpu)
+        {
+            cpus.emplace_back(cpu);
+        }
+        start = end + 1;
+    }
+    return cpus;
+}
+
+void setThreadRealtime(const RealtimeOptions& options)
+{
+    if (!options.cpus.empty())
+    {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int cpu : options.cpus)
+        {
+            CPU_SET(cpu, &set);
+        }
+        int rc = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+        if (rc != 0)
+        {
+            throw std::system_error{rc, std::generic_category(),
+                                    "Unable to set CPU affinity"};
+        }
+    }
+
+    if (options.priority > 0)
+    {
+        sched_param param{};
+        param.sched_priority = options.priority;
+        int rc = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+        if (rc != 0)
+        {
+            throw std::system_error{rc, std::generic_category(),
+                                    "Unable to set SCHED_FIFO priority " +
+                                        std::to_string(options.priority)};
+        }
+    }
+}
+
+void lockProcessMemory(const RealtimeOptions& options)
+{
+    if (options.lockMemory && (mlockall(MCL_CURRENT | MCL_FUTURE) != 0))
+    {
+        throw std::system_error{errno, std::generic_category(),
+                                "Unable to lock memory"};
+    }
+}
+
+FaultPathThread::FaultPathThread(const RealtimeOptions& options) :
+    options{options}
+{}
+
+FaultPathThread::~FaultPathThread()
+{
+    stop();
+}
+
+void FaultPathThread::start()
+{
+    stopFD = FileDescriptor{eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)};
+    if (!stopFD)
+    {
+        throw std::system_error{errno, std::generic_category(),
+                                "Unable to create eventfd"};
+    }
+    thread = std::thread{&FaultPathThread::run, this};
+}
+
+void FaultPathThread::stop()
+{
+    if (thread.joinable())
+    {
+        uint64_t value{1};
+        if (write(stopFD(), &value, sizeof(value)) == sizeof(value))
+        {
+            thread.join();
+        }
+        else
+        {
+            // Unable to wake the thread; leave it waiting
+            thread.detach();
+        }
+    }
+    stopFD.close();
+}
+
+void FaultPathThread::run()
+{
+    try
+    {
+        setThreadRealtime(options);
+    }
+    catch (const std::exception& e)
+    {
+        log<level::ERR>(e.what());
+    }
+
+    std::vector<pollfd> fds{};
+    for (const auto& [fd, handler] : watches)
+    {
+        fds.push_back(pollfd{fd, POLLIN | POLLPRI, 0});
+    }
+    fds.push_back(pollfd{stopFD(), POLLIN, 0});
+
+    while (true)
+    {
+        if (poll(fds.data(), fds.size(), -1) < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            log<level::ERR>("Fault path thread unable to poll",
+                            entry("ERRNO=%d", errno));
+            return;
+        }
+
+        if (fds.back().revents != 0)
+        {
+            return;
+        }
+
+        for (std::size_t i = 0; i < watches.size(); ++i)
+        {
+            if (fds[i].revents == 0)
+            {
+                continue;
+            }
+            if ((fds[i].revents & POLLNVAL) != 0)
+            {
+                // Stop waiting for a file descriptor that is no longer open
+                fds[i].fd = -1;
+                continue;
+            }
+            try
+            {
+                watches[i].second();
+            }
+            catch (const std::exception& e)
+            {
+                log<level::ERR>(e.what());
+            }
+        }
+    }
+}
+
+} // namespace phosphor::power::util
@@ -0,0 +1,182 @@
+#pragma once
+
+#include "file_descriptor.hpp"
+
+#include <functional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace phosphor::power::util
+{
+
+/**
+ * @struct RealtimeOptions
+ *
+ * Scheduling options for the threads that handle fault-critical event
+ * sources, such as power good changes and power supply status reads.
+ */
+struct RealtimeOptions
+{
+    /**
+     * SCHED_FIFO priority from 1 to 99, or 0 to keep the normal scheduling
+     * policy.
+     */
+    int priority{0};
+
+    /**
+     * The CPUs the threads may run on, or empty to allow any CPU.
+     */
+    std::vector<int> cpus{};
+
+    /**
+     * Whether to lock the memory of the process, so the critical threads do
+     * not wait for page faults.
+     */
+    bool lockMemory{false};
+
+    /**
+     * Returns whether the critical threads need a scheduling policy or CPU
+     * affinity other than the default.
+     *
+     * @return bool - true if the priority or the CPUs are set
+     */
+    bool isThreadRealtime() const
+    {
+        return (priority > 0) || !cpus.empty();
+    }
+};
+
+/**
+ * Parses a list of CPUs, such as "0,2-3".
+ *
+ * @param[in] list - the CPU numbers and ranges, separated by commas
+ *
+ * @return std::vector<int> - the CPU numbers
+ *
+ * Throws std::invalid_argument if the list is not valid.
+ */
+std::vector<int> parseCPUList(const std::string& list);
+
+/**
+ * Sets the scheduling policy, priority, and CPU affinity of the calling
+ * thread.
+ *
+ * Does nothing for the options that are not set.
+ *
+ * @param[in] options - the scheduling options
+ *
+ * Throws std::system_error if the options cannot be set, such as when the
+ * process does not have permission to use SCHED_FIFO.
+ */
+void setThreadRealtime(const RealtimeOptions& options);
+
+/**
+ * Locks the current and future memory of the process if requested in the
+ * options.
+ *
+ * @param[in] options - the scheduling options
+ *
+ * Throws std::system_error if the memory cannot be locked.
+ */
+void lockProcessMemory(const RealtimeOptions& options);
+
+/**
+ * @class FaultPathThread
+ *
+ * A dedicated thread that waits for fault-critical file descriptors, such as
+ * GPIO line events, and calls their handlers.
+ *
+ * The thread runs with the specified scheduling options, so it is not
+ * delayed by the telemetry and inventory work on the normal priority event
+ * loop.  The handlers run on the thread, and should only do the work that
+ * must happen right away, like capturing the fault registers.  They wake the
+ * event loop for the rest.
+ *
+ * If the scheduling options cannot be set, an error is journaled and the
+ * thread runs with the normal scheduling policy.
+ */
+class FaultPathThread
+{
+  public:
+    /**
+     * Handler called on the thread when a file descriptor is readable.
+     */
+    using Handler = std::function<void()>;
+
+    FaultPathThread() = delete;
+    FaultPathThread(const FaultPathThread&) = delete;
+    FaultPathThread& operator=(const FaultPathThread&) = delete;
+    FaultPathThread(FaultPathThread&&) = delete;
+    FaultPathThread& operator=(FaultPathThread&&) = delete;
+
+    /**
+     * Constructor
+     *
+     * @param[in] options - the scheduling options of the thread
+     */
+    explicit FaultPathThread(const RealtimeOptions& options);
+
+    /**
+     * Destructor.  Stops the thread.
+     */
+    ~FaultPathThread();
+
+    /**
+     * Adds a file descriptor to wait for.
+     *
+     * Must be called before start().
+     *
+     * @param[in] fd - the file descriptor; owned by the caller, and must stay
+     *                 open while the thread runs
+     * @param[in] handler - called on the thread when fd is readable
+     */
+    void watch(int fd, Handler handler)
+    {
+        watches.emplace_back(fd, std::move(handler));
+    }
+
+    /**
+     * Starts the thread.
+     *
+     * Throws std::system_error if the thread cannot be started.
+     */
+    void start();
+
+    /**
+     * Stops the thread and waits for it to finish.
+     *
+     * Does nothing if the thread is not running.
+     */
+    void stop();
+
+  private:
+    /**
+     * Waits for the file descriptors and calls their handlers until the
+     * thread is stopped.
+     */
+    void run();
+
+    /**
+     * The scheduling options of the thread.
+     */
+    RealtimeOptions options;
+
+    /**
+     * The file descriptors to wait for, and their handlers.
+     */
+    std::vector<std::pair<int, Handler>> watches;
+
+    /**
+     * The eventfd used to stop the thread.
+     */
+    FileDescriptor stopFD;
+
+    /**
+     * The thread.
+     */
+    std::thread thread;
+};
+
+} // namespace phosphor::power::util
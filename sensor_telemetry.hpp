@@ -0,0 +1,751 @@
+#pragma once
+
+#include "file_descriptor.hpp"
+
+#include <errno.h>    // for errno
+#include <fcntl.h>    // for O_* constants
+#include <string.h>   // for strerror() and strncpy()
+#include <sys/mman.h> // for shm_open(), shm_unlink(), mmap(), and munmap()
+#include <sys/stat.h> // for fstat()
+#include <unistd.h>   // for ftruncate()
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+/**
+ * Shared memory segment containing the latest values of sensors.
+ *
+ * The segment allows other processes to read sensor values at a high rate
+ * without using D-Bus.  One process writes the segment using Writer.  Any
+ * number of processes read it using Reader.
+ *
+ * The segment has a fixed layout: a Header followed by an array of Record
+ * structures, one for each sensor.  A Record is assigned to a sensor ID the
+ * first time a value is written for it, and keeps that ID while the segment
+ * exists.
+ *
+ * Each Record is protected by a sequence lock.  The writer increments the
+ * sequence number before and after changing the record, so it is odd while the
+ * record is being changed.  A reader copies the record and then checks that the
+ * sequence number is even and did not change.  Otherwise it tries again.
+ * Neither the writer nor the readers ever block.
+ */
+namespace phosphor::power::util::sensor_telemetry
+{
+
+/**
+ * Value that identifies a sensor telemetry segment.  Contains "PWRT".
+ */
+constexpr uint32_t magic{0x54525750};
+
+/**
+ * Version of the segment layout.  Must be incremented when the layout changes.
+ */
+constexpr uint32_t version{2};
+
+/**
+ * Maximum length of a sensor ID, not including the null terminator.
+ */
+constexpr std::size_t maxIDLength{63};
+
+/**
+ * Status of a sensor value.
+ */
+enum class Status : uint32_t
+{
+    /**
+     * Value is valid.
+     */
+    ok = 0,
+
+    /**
+     * Value could not be read due to an error.  The value is NaN.
+     */
+    error = 1,
+
+    /**
+     * Sensor is not currently being monitored, such as when the system is
+     * powered off.  The value is NaN.
+     */
+    unavailable = 2,
+
+    /**
+     * Sensor no longer exists.  The value is NaN.
+     */
+    removed = 3
+};
+
+/**
+ * Returns the name of the specified sensor value status.
+ *
+ * @param status sensor value status
+ * @return status name
+ */
+inline std::string toString(Status status)
+{
+    switch (status)
+    {
+        case Status::ok:
+            return "ok";
+        case Status::error:
+            return "error";
+        case Status::unavailable:
+            return "unavailable";
+        case Status::removed:
+            return "removed";
+    }
+    return "unknown";
+}
+
+/**
+ * Header at the beginning of the segment.
+ */
+struct Header
+{
+    /**
+     * Identifies the segment.  Contains the magic constant.
+     */
+    uint32_t magic;
+
+    /**
+     * Version of the segment layout.
+     */
+    uint32_t version;
+
+    /**
+     * Size of each Record in bytes.
+     */
+    uint32_t recordSize;
+
+    /**
+     * Maximum number of Records in the segment.
+     */
+    uint32_t capacity;
+
+    /**
+     * Number of Records that have been assigned to a sensor.  The sensor ID in
+     * a Record does not change after the Record has been counted.
+     */
+    std::atomic<uint32_t> recordCount;
+};
+
+/**
+ * Latest value of one sensor.
+ */
+struct alignas(64) Record
+{
+    /**
+     * Sequence number.  Odd while the writer is changing the record.
+     */
+    std::atomic<uint32_t> sequence;
+
+    /**
+     * Status of the value.  Contains a Status value.
+     */
+    std::atomic<uint32_t> status;
+
+    /**
+     * Sensor value.  Contains the bits of a double.
+     */
+    std::atomic<uint64_t> value;
+
+    /**
+     * Time when the value was read from the hardware in microseconds since
+     * the epoch.
+     */
+    std::atomic<uint64_t> timestamp;
+
+    /**
+     * Time when the value was read from the hardware in microseconds of
+     * std::chrono::steady_clock (CLOCK_MONOTONIC).  Used to correlate the
+     * samples of different sensors; not affected by changes to the system
+     * time.
+     */
+    std::atomic<uint64_t> readTime;
+
+    /**
+     * Sensor ID.  Null terminated.
+     */
+    char id[maxIDLength + 1];
+};
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free);
+static_assert(std::atomic<uint64_t>::is_always_lock_free);
+static_assert(sizeof(Header) <= sizeof(Record));
+
+/**
+ * Maximum number of times a Reader tries to read a Record that is being
+ * changed.
+ */
+constexpr unsigned int maxReadAttempts{1000};
+
+/**
+ * Returns the size of a segment with the specified capacity in bytes.
+ *
+ * @param[in] capacity - Maximum number of sensors
+ * @return Size in bytes
+ */
+constexpr std::size_t getSegmentSize(std::size_t capacity)
+{
+    return sizeof(Record) + (capacity * sizeof(Record));
+}
+
+/**
+ * Returns the Record with the specified index in a segment.
+ *
+ * The Header is stored in a space the size of a Record so that all Records are
+ * aligned.
+ *
+ * @param[in] segment - Beginning of the segment
+ * @param[in] index - Record index
+ * @return Record
+ */
+inline Record* getRecord(void* segment, std::size_t index)
+{
+    return static_cast<Record*>(segment) + 1 + index;
+}
+
+/**
+ * Latest value of a sensor obtained by a Reader.
+ */
+struct Sample
+{
+    /**
+     * Sensor ID.  Refers to the shared memory segment; no copy is made.
+     */
+    std::string_view id{};
+
+    /**
+     * Sensor value.
+     */
+    double value{0.0};
+
+    /**
+     * Status of the value.
+     */
+    Status status{Status::ok};
+
+    /**
+     * Time when the value was read from the hardware.
+     */
+    std::chrono::system_clock::time_point timestamp{};
+
+    /**
+     * Time when the value was read from the hardware on the monotonic clock.
+     */
+    std::chrono::steady_clock::time_point readTime{};
+};
+
+/**
+ * @class Segment
+ *
+ * This class manages the memory mapping of a shared memory segment.
+ *
+ * Segment objects cannot be copied, but they can be moved.
+ */
+class Segment
+{
+  public:
+    Segment() = default;
+    Segment(const Segment&) = delete;
+    Segment& operator=(const Segment&) = delete;
+
+    /**
+     * Move constructor.
+     *
+     * @param[in] other - Segment object to move from
+     */
+    Segment(Segment&& other) :
+        descriptor{std::move(other.descriptor)}, address{other.address},
+        size{other.size}
+    {
+        other.address = nullptr;
+        other.size = 0;
+    }
+
+    /**
+     * Move assignment operator.
+     *
+     * @param[in] other - Segment object to move from
+     * @return Reference to this object
+     */
+    Segment& operator=(Segment&& other)
+    {
+        if (this != &other)
+        {
+            unmap();
+            descriptor = std::move(other.descriptor);
+            address = other.address;
+            size = other.size;
+            other.address = nullptr;
+            other.size = 0;
+        }
+        return *this;
+    }
+
+    /**
+     * Destructor.
+     *
+     * Unmaps the segment.
+     */
+    ~Segment()
+    {
+        unmap();
+    }
+
+    /**
+     * Opens and maps the shared memory segment with the specified name.
+     *
+     * If the segment is writable, it is created with the specified size,
+     * replacing any existing segment with the same name.  Otherwise the
+     * existing segment is mapped read-only and the size is obtained from the
+     * segment.
+     *
+     * Throws an exception if an error occurs.
+     *
+     * @param[in] name - Segment name, such as "/phosphor-regulators-sensors"
+     * @param[in] isWritable - Specifies whether to create a writable segment
+     * @param[in] createSize - Size of the segment to create in bytes
+     */
+    Segment(const std::string& name, bool isWritable,
+            std::size_t createSize = 0)
+    {
+        int flags = isWritable ? (O_RDWR | O_CREAT | O_EXCL) : O_RDONLY;
+        if (isWritable)
+        {
+            // Replace any segment left by a previous instance of the writer
+            shm_unlink(name.c_str());
+        }
+        descriptor.set(shm_open(name.c_str(), flags | O_CLOEXEC, 0644));
+        if (!descriptor)
+        {
+            throwError("Unable to open shared memory segment " + name);
+        }
+
+        if (isWritable)
+        {
+            if (ftruncate(descriptor(), createSize) == -1)
+            {
+                throwError("Unable to set size of shared memory segment");
+            }
+            size = createSize;
+        }
+        else
+        {
+            struct stat info
+            {};
+            if (fstat(descriptor(), &info) == -1)
+            {
+                throwError("Unable to get size of shared memory segment");
+            }
+            size = info.st_size;
+        }
+
+        int protection = isWritable ? (PROT_READ | PROT_WRITE) : PROT_READ;
+        void* ptr = mmap(nullptr, size, protection, MAP_SHARED, descriptor(),
+                         0);
+        if (ptr == MAP_FAILED)
+        {
+            throwError("Unable to map shared memory segment");
+        }
+        address = ptr;
+    }
+
+    /**
+     * Returns the address of the mapped segment.
+     *
+     * @return Address.  Returns nullptr if the segment is not mapped.
+     */
+    void* getAddress() const
+    {
+        return address;
+    }
+
+    /**
+     * Returns the file descriptor for the segment.
+     *
+     * @return File descriptor.  Returns -1 if the segment is not open.
+     */
+    int getFileDescriptor()
+    {
+        return descriptor();
+    }
+
+    /**
+     * Returns the size of the mapped segment in bytes.
+     *
+     * @return Size in bytes
+     */
+    std::size_t getSize() const
+    {
+        return size;
+    }
+
+  private:
+    /**
+     * Throws an exception with the specified message and errno description.
+     *
+     * @param[in] message - Error message
+     */
+    [[noreturn]] static void throwError(const std::string& message)
+    {
+        throw std::runtime_error{message + ": " + strerror(errno)};
+    }
+
+    /**
+     * Unmaps the segment if it is mapped.
+     */
+    void unmap()
+    {
+        if (address != nullptr)
+        {
+            munmap(address, size);
+            address = nullptr;
+            size = 0;
+        }
+    }
+
+    /**
+     * File descriptor for the segment.
+     */
+    FileDescriptor descriptor{};
+
+    /**
+     * Address of the mapped segment.
+     */
+    void* address{nullptr};
+
+    /**
+     * Size of the mapped segment in bytes.
+     */
+    std::size_t size{0};
+};
+
+/**
+ * @class Writer
+ *
+ * This class writes sensor values to a shared memory segment.
+ *
+ * Only one Writer should exist for a segment name.  The segment is created by
+ * the constructor and deleted by the destructor.
+ */
+class Writer
+{
+  public:
+    Writer() = delete;
+    Writer(const Writer&) = delete;
+    Writer(Writer&&) = delete;
+    Writer& operator=(const Writer&) = delete;
+    Writer& operator=(Writer&&) = delete;
+
+    /**
+     * Constructor.
+     *
+     * Creates the shared memory segment.
+     *
+     * Throws an exception if an error occurs.
+     *
+     * @param[in] name - Segment name, such as "/phosphor-regulators-sensors"
+     * @param[in] capacity - Maximum number of sensors
+     */
+    Writer(const std::string& name, std::size_t capacity) :
+        name{name}, capacity{capacity},
+        segment{name, true, getSegmentSize(capacity)}
+    {
+        // Create the records and the header in the segment
+        for (std::size_t index = 0; index < capacity; ++index)
+        {
+            new (getRecord(segment.getAddress(), index)) Record{};
+        }
+        Header* header = new (segment.getAddress()) Header{};
+        header->magic = sensor_telemetry::magic;
+        header->version = sensor_telemetry::version;
+        header->recordSize = sizeof(Record);
+        header->capacity = capacity;
+        header->recordCount.store(0, std::memory_order_release);
+    }
+
+    /**
+     * Destructor.
+     *
+     * Deletes the shared memory segment name.  Readers that have already
+     * mapped the segment can still read the last values written.
+     */
+    ~Writer()
+    {
+        shm_unlink(name.c_str());
+    }
+
+    /**
+     * Returns the Record index of the sensor with the specified ID.
+     *
+     * Assigns a new Record to the sensor if necessary.  IDs longer than
+     * maxIDLength are truncated.
+     *
+     * @param[in] id - Sensor ID
+     * @return Record index.  Returns no value if the segment is full.
+     */
+    std::optional<std::size_t> addSensor(const std::string& id)
+    {
+        auto it = indexes.find(id);
+        if (it != indexes.end())
+        {
+            return it->second;
+        }
+
+        Header* header = static_cast<Header*>(segment.getAddress());
+        std::size_t index = header->recordCount.load(std::memory_order_relaxed);
+        if (index >= capacity)
+        {
+            return std::nullopt;
+        }
+
+        // Store ID before publishing the record by incrementing the count
+        Record* record = getRecord(segment.getAddress(), index);
+        strncpy(record->id, id.c_str(), maxIDLength);
+        record->status.store(static_cast<uint32_t>(Status::unavailable),
+                             std::memory_order_relaxed);
+        header->recordCount.store(index + 1, std::memory_order_release);
+
+        indexes.emplace(id, index);
+        return index;
+    }
+
+    /**
+     * Writes a sensor value.
+     *
+     * @param[in] index - Record index from addSensor()
+     * @param[in] value - Sensor value
+     * @param[in] status - Status of the value
+     * @param[in] readTime - Time when the value was read from the hardware
+     */
+    void write(std::size_t index, double value, Status status,
+               std::chrono::steady_clock::time_point readTime =
+                   std::chrono::steady_clock::now())
+    {
+        using namespace std::chrono;
+        Record* record = getRecord(segment.getAddress(), index);
+        auto age = steady_clock::now() - readTime;
+        uint64_t timestamp =
+            duration_cast<microseconds>(
+                (system_clock::now() - age).time_since_epoch())
+                .count();
+        uint64_t readTimeValue =
+            duration_cast<microseconds>(readTime.time_since_epoch()).count();
+        uint64_t valueBits{0};
+        std::memcpy(&valueBits, &value, sizeof(valueBits));
+
+        // Make the sequence number odd while changing the record
+        uint32_t sequence = record->sequence.load(std::memory_order_relaxed);
+        record->sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        record->status.store(static_cast<uint32_t>(status),
+                             std::memory_order_relaxed);
+        record->value.store(valueBits, std::memory_order_relaxed);
+        record->timestamp.store(timestamp, std::memory_order_relaxed);
+        record->readTime.store(readTimeValue, std::memory_order_relaxed);
+        record->sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    /**
+     * Writes the value of a sensor that no longer exists.
+     *
+     * @param[in] index - Record index from addSensor()
+     */
+    void writeRemoved(std::size_t index)
+    {
+        write(index, std::nan(""), Status::removed);
+    }
+
+  private:
+    /**
+     * Segment name.
+     */
+    const std::string name;
+
+    /**
+     * Maximum number of sensors.
+     */
+    const std::size_t capacity;
+
+    /**
+     * Shared memory segment.
+     */
+    Segment segment;
+
+    /**
+     * Map from sensor IDs to Record indexes.
+     */
+    std::unordered_map<std::string, std::size_t> indexes{};
+};
+
+/**
+ * @class Reader
+ *
+ * This class reads sensor values from a shared memory segment.
+ *
+ * Reading does not block the writer or other readers and does not allocate
+ * memory.
+ */
+class Reader
+{
+  public:
+    Reader() = delete;
+    Reader(const Reader&) = delete;
+    Reader(Reader&&) = default;
+    Reader& operator=(const Reader&) = delete;
+    Reader& operator=(Reader&&) = default;
+    ~Reader() = default;
+
+    /**
+     * Constructor.
+     *
+     * Maps the shared memory segment read-only and verifies its layout.
+     *
+     * Throws an exception if an error occurs.
+     *
+     * @param[in] name - Segment name, such as "/phosphor-regulators-sensors"
+     */
+    explicit Reader(const std::string& name) : name{name}, segment{name, false}
+    {
+        if (segment.getSize() < sizeof(Record))
+        {
+            throw std::runtime_error{"Shared memory segment is too small"};
+        }
+        const Header* header = getHeader();
+        if ((header->magic != sensor_telemetry::magic) ||
+            (header->version != sensor_telemetry::version) ||
+            (header->recordSize != sizeof(Record)) ||
+            (segment.getSize() < getSegmentSize(header->capacity)))
+        {
+            throw std::runtime_error{
+                "Shared memory segment has an unsupported layout"};
+        }
+    }
+
+    /**
+     * Returns the number of sensors in the segment.
+     *
+     * Sensors are never removed from the segment, so the number only grows.
+     *
+     * @return Number of sensors
+     */
+    std::size_t getSensorCount() const
+    {
+        return getHeader()->recordCount.load(std::memory_order_acquire);
+    }
+
+    /**
+     * Returns whether the segment is still the current segment with this name.
+     *
+     * Returns false if the writer has been restarted and has created a new
+     * segment.  Create a new Reader to read the new segment.
+     *
+     * @return true if segment is current, false otherwise
+     */
+    bool isCurrent()
+    {
+        Segment current{};
+        try
+        {
+            current = Segment{name, false};
+        }
+        catch (const std::exception&)
+        {
+            return false;
+        }
+
+        struct stat currentInfo
+        {};
+        struct stat info
+        {};
+        if ((fstat(current.getFileDescriptor(), &currentInfo) == -1) ||
+            (fstat(segment.getFileDescriptor(), &info) == -1))
+        {
+            return false;
+        }
+        return (currentInfo.st_ino == info.st_ino);
+    }
+
+    /**
+     * Reads the latest value of the sensor with the specified index.
+     *
+     * If the writer is changing the value, tries again up to maxReadAttempts
+     * times.
+     *
+     * @param[in] index - Sensor index; must be less than getSensorCount()
+     * @return Sensor value.  Returns no value if a consistent value could not
+     *         be read, such as when the writer stopped while changing it.
+     */
+    std::optional<Sample> read(std::size_t index) const
+    {
+        const Record* record = getRecord(segment.getAddress(), index);
+        for (unsigned int attempt = 0; attempt < maxReadAttempts; ++attempt)
+        {
+            // Skip attempt if the writer is changing the record
+            uint32_t sequence =
+                record->sequence.load(std::memory_order_acquire);
+            if (sequence & 1)
+            {
+                continue;
+            }
+
+            uint32_t status = record->status.load(std::memory_order_relaxed);
+            uint64_t valueBits = record->value.load(std::memory_order_relaxed);
+            uint64_t timestamp =
+                record->timestamp.load(std::memory_order_relaxed);
+            uint64_t readTime =
+                record->readTime.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (record->sequence.load(std::memory_order_relaxed) != sequence)
+            {
+                continue;
+            }
+
+            Sample sample{};
+            sample.id = std::string_view{record->id};
+            std::memcpy(&sample.value, &valueBits, sizeof(sample.value));
+            sample.status = static_cast<Status>(status);
+            sample.timestamp = std::chrono::system_clock::time_point{
+                std::chrono::microseconds{timestamp}};
+            sample.readTime = std::chrono::steady_clock::time_point{
+                std::chrono::microseconds{readTime}};
+            return sample;
+        }
+        return std::nullopt;
+    }
+
+  private:
+    /**
+     * Returns the Header of the segment.
+     *
+     * @return Header
+     */
+    const Header* getHeader() const
+    {
+        return static_cast<const Header*>(segment.getAddress());
+    }
+
+    /**
+     * Segment name.
+     */
+    std::string name;
+
+    /**
+     * Shared memory segment.
+     */
+    Segment segment;
+};
+
+} // namespace phosphor::power::util::sensor_telemetry
@@ -0,0 +1,154 @@
+/**
+ * Copyright © 2026 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "startup_times.hpp"
+
+#include <systemd/sd-daemon.h>
+
+#include <phosphor-logging/log.hpp>
+
+#include <memory>
+#include <utility>
+
+namespace phosphor::power::util
+{
+
+using namespace phosphor::logging;
+
+const char* StartupTimes::getName(Phase phase)
+{
+    switch (phase)
+    {
+        case Phase::configLoad:
+            return "ConfigLoad";
+        case Phase::hardwareDiscovery:
+            return "HardwareDiscovery";
+        case Phase::firstCycle:
+            return "FirstCycle";
+    }
+    return "";
+}
+
+void StartupTimes::complete(Phase phase, Clock::time_point time)
+{
+    // Earlier phases that were skipped complete at the same time
+    for (std::size_t i = 0; i <= static_cast<std::size_t>(phase); ++i)
+    {
+        if (!phases[i])
+        {
+            phases[i] = sinceStart(time);
+        }
+    }
+}
+
+void StartupTimes::setReady(Clock::time_point time)
+{
+    if (ready)
+    {
+        return;
+    }
+    ready = sinceStart(time);
+    if (readyCallback)
+    {
+        readyCallback();
+    }
+}
+
+void StartupTimes::setReadyCallback(ReadyCallback callback)
+{
+    readyCallback = std::move(callback);
+    if (ready && readyCallback)
+    {
+        readyCallback();
+    }
+}
+
+std::map<std::string, uint64_t> StartupTimes::getValues() const
+{
+    std::map<std::string, uint64_t> values;
+    for (std::size_t i = 0; i < phaseCount; ++i)
+    {
+        if (phases[i])
+        {
+            values.emplace(std::string{getName(static_cast<Phase>(i))} + "Us",
+                           static_cast<uint64_t>(phases[i]->count()));
+        }
+    }
+    if (ready)
+    {
+        values.emplace("ReadyUs", static_cast<uint64_t>(ready->count()));
+    }
+    return values;
+}
+
+std::string StartupTimes::toString() const
+{
+    std::string text;
+    auto add = [&text](const char* name, std::chrono::microseconds time) {
+        if (!text.empty())
+        {
+            text += ", ";
+        }
+        text += std::string{name} + ": " + std::to_string(time.count() / 1000) +
+                " ms";
+    };
+    for (std::size_t i = 0; i < phaseCount; ++i)
+    {
+        if (phases[i])
+        {
+            add(getName(static_cast<Phase>(i)), *phases[i]);
+        }
+    }
+    if (ready)
+    {
+        add("Ready", *ready);
+    }
+    return text;
+}
+
+std::chrono::microseconds
+    StartupTimes::sinceStart(Clock::time_point time) const
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(time - start);
+}
+
+void notifyReady(const std::vector<std::pair<std::string, StartupTimes*>>&
+                     startups)
+{
+    auto remaining = std::make_shared<std::size_t>(startups.size());
+    auto notify = []() {
+        // Does nothing if NOTIFY_SOCKET is not set
+        sd_notify(0, "READY=1");
+    };
+    if (startups.empty())
+    {
+        notify();
+        return;
+    }
+
+    for (const auto& [name, startup] : startups)
+    {
+        startup->setReadyCallback([name, startup, remaining, notify]() {
+            log<level::INFO>(
+                (name + " started: " + startup->toString()).c_str());
+            if (--*remaining == 0)
+            {
+                notify();
+            }
+        });
+    }
+}
+
+} // namespace phosphor::power::util
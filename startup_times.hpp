@@ -0,0 +1,212 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace phosphor::power::util
+{
+
+/**
+ * @class StartupTimes
+ *
+ * Times the startup of a daemon, so it is visible where the time goes before
+ * the daemon is operational.
+ *
+ * Records when each startup phase completes and when the daemon became
+ * ready, relative to when this object was created.  Only the first
+ * completion of each phase is recorded, since a phase such as loading the
+ * config file can be repeated later.  Completing a phase also completes any
+ * earlier phases that were skipped.
+ */
+class StartupTimes
+{
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * The startup phases, in the order they complete.
+     */
+    enum class Phase
+    {
+        /**
+         * The configuration, such as a config file or the Entity Manager
+         * objects, was loaded.
+         */
+        configLoad,
+
+        /**
+         * The hardware described by the configuration was found.
+         */
+        hardwareDiscovery,
+
+        /**
+         * The first monitoring cycle of the hardware completed.
+         */
+        firstCycle
+    };
+
+    /**
+     * The number of phases.
+     */
+    static constexpr std::size_t phaseCount{3};
+
+    using ReadyCallback = std::function<void()>;
+
+    StartupTimes(const StartupTimes&) = delete;
+    StartupTimes& operator=(const StartupTimes&) = delete;
+    StartupTimes(StartupTimes&&) = delete;
+    StartupTimes& operator=(StartupTimes&&) = delete;
+    ~StartupTimes() = default;
+
+    /**
+     * Constructor
+     *
+     * @param[in] start - when the startup began
+     */
+    explicit StartupTimes(Clock::time_point start = Clock::now()) :
+        start{start}
+    {}
+
+    /**
+     * Returns the name of a phase, such as "ConfigLoad".
+     *
+     * @param[in] phase - the phase
+     *
+     * @return const char* - the name
+     */
+    static const char* getName(Phase phase);
+
+    /**
+     * Records that a phase completed.  Does nothing if it already completed.
+     *
+     * @param[in] phase - the phase
+     * @param[in] time - when the phase completed
+     */
+    void complete(Phase phase, Clock::time_point time = Clock::now());
+
+    /**
+     * Returns whether a phase completed.
+     *
+     * @param[in] phase - the phase
+     *
+     * @return bool - true if the phase completed
+     */
+    bool isComplete(Phase phase) const
+    {
+        return phases[static_cast<std::size_t>(phase)].has_value();
+    }
+
+    /**
+     * Returns the time from the start until a phase completed.
+     *
+     * @param[in] phase - the phase
+     *
+     * @return microseconds - the time, or std::nullopt if the phase has not
+     *                        completed
+     */
+    std::optional<std::chrono::microseconds> getElapsed(Phase phase) const
+    {
+        return phases[static_cast<std::size_t>(phase)];
+    }
+
+    /**
+     * Records that the daemon is ready and calls the ready callback.  Does
+     * nothing if it was already ready.
+     *
+     * @param[in] time - when the daemon became ready
+     */
+    void setReady(Clock::time_point time = Clock::now());
+
+    /**
+     * Returns whether the daemon is ready.
+     *
+     * @return bool - true if it is ready
+     */
+    bool isReady() const
+    {
+        return ready.has_value();
+    }
+
+    /**
+     * Returns the time from the start until the daemon became ready.
+     *
+     * @return microseconds - the time, or std::nullopt if it is not ready
+     */
+    std::optional<std::chrono::microseconds> getReadyElapsed() const
+    {
+        return ready;
+    }
+
+    /**
+     * Sets the function called when the daemon becomes ready.  It is called
+     * right away if the daemon is already ready.
+     *
+     * @param[in] callback - the function
+     */
+    void setReadyCallback(ReadyCallback callback);
+
+    /**
+     * Returns the times in microseconds for the debug D-Bus interface, such
+     * as "ConfigLoadUs" and "ReadyUs".  Only the phases that completed are
+     * included.
+     *
+     * @return map - the times, by name
+     */
+    std::map<std::string, uint64_t> getValues() const;
+
+    /**
+     * Returns the times for the journal, such as
+     * "ConfigLoad: 120 ms, HardwareDiscovery: 300 ms, Ready: 300 ms".
+     *
+     * @return std::string - the times
+     */
+    std::string toString() const;
+
+  private:
+    /**
+     * Returns the time from the start to a time point.
+     */
+    std::chrono::microseconds sinceStart(Clock::time_point time) const;
+
+    /**
+     * When the startup began.
+     */
+    Clock::time_point start;
+
+    /**
+     * The time from the start until each phase completed, by phase.
+     */
+    std::optional<std::chrono::microseconds> phases[phaseCount]{};
+
+    /**
+     * The time from the start until the daemon became ready.
+     */
+    std::optional<std::chrono::microseconds> ready{};
+
+    /**
+     * Called when the daemon becomes ready.
+     */
+    ReadyCallback readyCallback{};
+};
+
+/**
+ * Tells systemd the daemon is ready, with sd_notify(READY=1), once all of
+ * the specified startups are ready.
+ *
+ * Logs the startup times in the journal when each one is ready.  Does
+ * nothing if the daemon was not started by a Type=notify service.
+ *
+ * @param[in] startups - the startups of the subsystems of the daemon, by
+ *                       name; must outlive the event loop
+ */
+void notifyReady(const std::vector<std::pair<std::string, StartupTimes*>>&
+                     startups);
+
+} // namespace phosphor::power::util
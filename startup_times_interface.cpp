@@ -0,0 +1,73 @@
+/**
+ * Copyright © 2026 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "startup_times_interface.hpp"
+
+#include <phosphor-logging/log.hpp>
+#include <sdbusplus/exception.hpp>
+#include <sdbusplus/server.hpp>
+
+namespace phosphor::power::util
+{
+
+StartupTimesInterface::StartupTimesInterface(sdbusplus::bus::bus& bus,
+                                             const char* path,
+                                             const StartupTimes& times) :
+    times{times},
+    _serverInterface(bus, path, interface, _vtable, this)
+{}
+
+int StartupTimesInterface::callbackGetStartupTimes(sd_bus_message* msg,
+                                                   void* context,
+                                                   sd_bus_error* error)
+{
+    if (msg != nullptr && context != nullptr)
+    {
+        try
+        {
+            auto m = sdbusplus::message::message(msg);
+
+            auto obj = static_cast<StartupTimesInterface*>(context);
+
+            auto reply = m.new_method_return();
+            reply.append(obj->times.getValues());
+
+            reply.method_return();
+        }
+        catch (const sdbusplus::exception_t& e)
+        {
+            return sd_bus_error_set(error, e.name(), e.description());
+        }
+    }
+    else
+    {
+        // The message or context were null
+        using namespace phosphor::logging;
+        log<level::ERR>("Unable to service GetStartupTimes method callback");
+        return -1;
+    }
+
+    return 1;
+}
+
+const sdbusplus::vtable::vtable_t StartupTimesInterface::_vtable[] = {
+    sdbusplus::vtable::start(),
+    // No GetStartupTimes method parameters and returns a dictionary of time
+    // names and values
+    sdbusplus::vtable::method("GetStartupTimes", "", "a{st}",
+                              callbackGetStartupTimes),
+    sdbusplus::vtable::end()};
+
+} // namespace phosphor::power::util
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "startup_times.hpp"
+
+#include <systemd/sd-bus.h>
+
+#include <sdbusplus/bus.hpp>
+#include <sdbusplus/sdbus.hpp>
+#include <sdbusplus/server/interface.hpp>
+#include <sdbusplus/vtable.hpp>
+
+namespace phosphor::power::util
+{
+
+/**
+ * @class StartupTimesInterface
+ *
+ * Debug D-Bus interface that shows the StartupTimes of a daemon.
+ *
+ * Methods:
+ * - GetStartupTimes: returns a dictionary of the times from the start of the
+ *   daemon until each startup phase completed and until it was ready, in
+ *   microseconds
+ */
+class StartupTimesInterface
+{
+  public:
+    StartupTimesInterface() = delete;
+    StartupTimesInterface(const StartupTimesInterface&) = delete;
+    StartupTimesInterface& operator=(const StartupTimesInterface&) = delete;
+    StartupTimesInterface(StartupTimesInterface&&) = delete;
+    StartupTimesInterface& operator=(StartupTimesInterface&&) = delete;
+    ~StartupTimesInterface() = default;
+
+    /**
+     * @brief Constructor to put the interface onto the bus at a path.
+     *
+     * @param[in] bus - Bus to attach to.
+     * @param[in] path - Path to attach at.
+     * @param[in] times - Startup times to show.  Must outlive this object.
+     */
+    StartupTimesInterface(sdbusplus::bus::bus& bus, const char* path,
+                          const StartupTimes& times);
+
+    /**
+     * @brief This dbus interface's name
+     */
+    static constexpr auto interface =
+        "xyz.openbmc_project.Power.Debug.StartupTimes";
+
+  private:
+    /**
+     * @brief Systemd bus callback for the GetStartupTimes method
+     */
+    static int callbackGetStartupTimes(sd_bus_message* msg, void* context,
+                                       sd_bus_error* error);
+
+    /**
+     * @brief Systemd vtable structure that contains all the
+     * methods of this interface with their respective systemd attributes
+     */
+    static const sdbusplus::vtable::vtable_t _vtable[];
+
+    /**
+     * @brief The startup times shown by this interface
+     */
+    const StartupTimes& times;
+
+    /**
+     * @brief Holder for the instance of this interface to be
+     * on dbus
+     */
+    sdbusplus::server::interface::interface _serverInterface;
+};
+
+} // namespace phosphor::power::util
@@ -0,0 +1,240 @@
+/**
+ * Copyright © 2026 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "state_handoff.hpp"
+
+#include "file_descriptor.hpp"
+
+#include <fcntl.h>    // for fcntl()
+#include <stdlib.h>   // for free() and getenv()
+#include <string.h>   // for strerror()
+#include <sys/stat.h> // for fstat()
+#include <unistd.h>   // for pread()
+
+#include <systemd/sd-daemon.h>
+
+#include <phosphor-logging/log.hpp>
+
+#include <cstddef>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace phosphor::power::util
+{
+
+using namespace phosphor::logging;
+
+namespace
+{
+
+/**
+ * Identifies a state snapshot.
+ */
+constexpr auto snapshotFormat = "phosphor-power-state";
+
+/**
+ * Largest snapshot that is read.
+ */
+constexpr off_t maxSnapshotSize{16 * 1024 * 1024};
+
+/**
+ * Returns the files passed by systemd from the file descriptor store, by
+ * name.
+ *
+ * The files are taken from the environment the first time this is called,
+ * so the daemons that run in the same process each find theirs.  Must be
+ * called with the mutex locked.
+ *
+ * @return the files not taken yet
+ */
+std::map<std::string, FileDescriptor>& getStoredFiles()
+{
+    static std::map<std::string, FileDescriptor> files = []() {
+        std::map<std::string, FileDescriptor> files{};
+        char** names = nullptr;
+        int count = sd_listen_fds_with_names(1, &names);
+        for (int i = 0; i < count; ++i)
+        {
+            int fd = SD_LISTEN_FDS_START + i;
+            fcntl(fd, F_SETFD, FD_CLOEXEC);
+            std::string name = (names != nullptr) ? names[i] : "";
+            files.try_emplace(name, fd);
+        }
+        if (names != nullptr)
+        {
+            for (int i = 0; i < count; ++i)
+            {
+                free(names[i]);
+            }
+            free(names);
+        }
+        return files;
+    }();
+    return files;
+}
+
+/**
+ * Protects the files passed by systemd.
+ */
+std::mutex storedFilesMutex{};
+
+} // namespace
+
+std::optional<nlohmann::json> StateHandoff::take()
+{
+    FileDescriptor file{};
+    {
+        std::lock_guard<std::mutex> lock{storedFilesMutex};
+        auto& files = getStoredFiles();
+        auto it = files.find(name);
+        if (it == files.end())
+        {
+            return std::nullopt;
+        }
+        file = std::move(it->second);
+        files.erase(it);
+    }
+
+    // A crash while resuming with the state must not be repeated by the
+    // next instance, so the state is removed until it is saved again
+    discard();
+
+    std::optional<nlohmann::json> state =
+        readStateSnapshot(file(), version, maxAge);
+    if (!state)
+    {
+        log<level::INFO>(
+            ("Ignoring the saved state " + name + ", starting cold").c_str());
+    }
+    return state;
+}
+
+bool StateHandoff::save(const nlohmann::json& state)
+{
+    // Not started by a service that can store the file
+    if (getenv("NOTIFY_SOCKET") == nullptr)
+    {
+        return false;
+    }
+
+    try
+    {
+        MemFDFile file = writeStateSnapshot(name, version, state);
+        int fd = file.getFileDescriptor();
+
+        // Files with the same name are kept side by side, so the old one is
+        // removed first
+        discard();
+        int rc = sd_pid_notify_with_fds(
+            0, 0, ("FDSTORE=1\nFDNAME=" + name).c_str(), &fd, 1);
+        if (rc <= 0)
+        {
+            log<level::ERR>(("Unable to store the state " + name + ": " +
+                             strerror(-rc))
+                                .c_str());
+            return false;
+        }
+        return true;
+    }
+    catch (const std::exception& e)
+    {
+        log<level::ERR>(
+            ("Unable to save the state " + name + ": " + e.what()).c_str());
+        return false;
+    }
+}
+
+void StateHandoff::discard()
+{
+    // Does nothing if NOTIFY_SOCKET is not set
+    sd_notify(0, ("FDSTOREREMOVE=1\nFDNAME=" + name).c_str());
+}
+
+MemFDFile writeStateSnapshot(const std::string& name, uint32_t version,
+                             const nlohmann::json& state,
+                             StateHandoff::Clock::time_point time)
+{
+    nlohmann::json snapshot{
+        {"format", snapshotFormat},
+        {"version", version},
+        {"time", std::chrono::duration_cast<std::chrono::microseconds>(
+                     time.time_since_epoch())
+                     .count()},
+        {"state", state}};
+    std::vector<uint8_t> data = nlohmann::json::to_cbor(snapshot);
+
+    MemFDFile file{name};
+    file.write(data);
+    file.seal();
+    return file;
+}
+
+std::optional<nlohmann::json>
+    readStateSnapshot(int fd, uint32_t version, std::chrono::seconds maxAge,
+                      StateHandoff::Clock::time_point time)
+{
+    struct stat status
+    {};
+    if ((fstat(fd, &status) != 0) || (status.st_size <= 0) ||
+        (status.st_size > maxSnapshotSize))
+    {
+        return std::nullopt;
+    }
+
+    std::vector<uint8_t> data(static_cast<size_t>(status.st_size));
+    size_t offset = 0;
+    while (offset < data.size())
+    {
+        ssize_t count =
+            pread(fd, data.data() + offset, data.size() - offset, offset);
+        if (count <= 0)
+        {
+            return std::nullopt;
+        }
+        offset += static_cast<size_t>(count);
+    }
+
+    try
+    {
+        nlohmann::json snapshot = nlohmann::json::from_cbor(data, true, false);
+        if (!snapshot.is_object() ||
+            (snapshot.value("format", "") != snapshotFormat) ||
+            (snapshot.value("version", uint32_t{0}) != version) ||
+            !snapshot.contains("state"))
+        {
+            return std::nullopt;
+        }
+
+        // The clock does not go back, so a snapshot from the future is from
+        // another boot
+        std::chrono::microseconds saved{snapshot.value("time", int64_t{0})};
+        auto now = std::chrono::duration_cast<std::chrono::microseconds>(
+            time.time_since_epoch());
+        if ((saved > now) || ((now - saved) > maxAge))
+        {
+            return std::nullopt;
+        }
+        return std::move(snapshot["state"]);
+    }
+    catch (const nlohmann::json::exception&)
+    {
+        // A field has the wrong type
+        return std::nullopt;
+    }
+}
+
+} // namespace phosphor::power::util
@@ -0,0 +1,150 @@
+#pragma once
+
+#include "memfd_file.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+namespace phosphor::power::util
+{
+
+/**
+ * @class StateHandoff
+ *
+ * Hands the state a daemon discovered over to the next instance of the
+ * daemon, so a daemon restarted for an update or after a crash resumes
+ * without discovering everything again.
+ *
+ * The state is serialized into a sealed in-memory file, which is stored in
+ * the systemd file descriptor store of the service with
+ * sd_pid_notify_with_fds(FDSTORE=1).  systemd passes the stored file to the
+ * next instance of the service, which restores the state with take().  The
+ * service needs FileDescriptorStoreMax= to store the file, and
+ * FileDescriptorStorePreserve=yes to keep it when the service is restarted
+ * rather than failing.  Nothing is stored when the daemon was not started
+ * by systemd.
+ *
+ * A snapshot is only restored if it has the same format version and is
+ * not older than the maximum age, since the hardware could have changed
+ * while no daemon was watching it.
+ */
+class StateHandoff
+{
+  public:
+    StateHandoff() = delete;
+    StateHandoff(const StateHandoff&) = delete;
+    StateHandoff& operator=(const StateHandoff&) = delete;
+    StateHandoff(StateHandoff&&) = delete;
+    StateHandoff& operator=(StateHandoff&&) = delete;
+    ~StateHandoff() = default;
+
+    /**
+     * The clock used to find the age of a snapshot; the same for all the
+     * processes since the system booted.
+     */
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * Default maximum age of a snapshot that is restored.
+     */
+    static constexpr std::chrono::seconds defaultMaxAge{60};
+
+    /**
+     * Constructor
+     *
+     * @param[in] name - the name of the stored file, unique within the
+     *                   service
+     * @param[in] version - the format version of the state; change it when
+     *                      a new daemon cannot read the state of an old one
+     * @param[in] maxAge - the maximum age of a snapshot that is restored
+     */
+    StateHandoff(const std::string& name, uint32_t version,
+                 std::chrono::seconds maxAge = defaultMaxAge) :
+        name{name},
+        version{version}, maxAge{maxAge}
+    {}
+
+    /**
+     * Returns the state stored by the previous instance of the daemon, and
+     * removes it from the file descriptor store.
+     *
+     * Returns no state if none was stored, or if the snapshot cannot be
+     * read, has another version, or is too old.
+     *
+     * @return std::optional<nlohmann::json> - the state
+     */
+    std::optional<nlohmann::json> take();
+
+    /**
+     * Stores the state for the next instance of the daemon, replacing the
+     * state stored before.
+     *
+     * Logs an error if the state cannot be stored.
+     *
+     * @param[in] state - the state
+     *
+     * @return bool - true if the state was stored, false if it could not be
+     *                or the daemon was not started by systemd
+     */
+    bool save(const nlohmann::json& state);
+
+    /**
+     * Removes the stored state, so the next instance starts cold.
+     */
+    void discard();
+
+  private:
+    /**
+     * The name of the stored file
+     */
+    const std::string name;
+
+    /**
+     * The format version of the state
+     */
+    const uint32_t version;
+
+    /**
+     * The maximum age of a snapshot that is restored
+     */
+    const std::chrono::seconds maxAge;
+};
+
+/**
+ * Writes a snapshot of a state to a sealed in-memory file.
+ *
+ * @param[in] name - the name of the file
+ * @param[in] version - the format version of the state
+ * @param[in] state - the state
+ * @param[in] time - the time the snapshot is taken
+ *
+ * @return MemFDFile - the file, positioned at the start
+ *
+ * @throw std::runtime_error if the file cannot be created or written
+ */
+MemFDFile writeStateSnapshot(
+    const std::string& name, uint32_t version, const nlohmann::json& state,
+    StateHandoff::Clock::time_point time = StateHandoff::Clock::now());
+
+/**
+ * Reads the state from a snapshot written by writeStateSnapshot().
+ *
+ * @param[in] fd - the file descriptor of the snapshot
+ * @param[in] version - the expected format version
+ * @param[in] maxAge - the maximum age of the snapshot
+ * @param[in] time - the current time
+ *
+ * @return std::optional<nlohmann::json> - the state, or no value if the
+ *                                         file cannot be read, is not a
+ *                                         snapshot, has another version,
+ *                                         or is too old
+ */
+std::optional<nlohmann::json> readStateSnapshot(
+    int fd, uint32_t version, std::chrono::seconds maxAge,
+    StateHandoff::Clock::time_point time = StateHandoff::Clock::now());
+
+} // namespace phosphor::power::util
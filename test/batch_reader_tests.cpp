@@ -0,0 +1,96 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "batch_reader.hpp"
+#include "file_descriptor.hpp"
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <array>
+#include <cerrno>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace phosphor::power::util;
+
+namespace
+{
+
+/**
+ * Returns a memory file containing the specified text.
+ */
+FileDescriptor createFile(const std::string& text)
+{
+    FileDescriptor fd{memfd_create("batch_reader_tests", MFD_CLOEXEC)};
+    EXPECT_TRUE(fd);
+    EXPECT_EQ(write(fd(), text.data(), text.size()),
+              static_cast<ssize_t>(text.size()));
+    return fd;
+}
+
+/**
+ * Reads files with a BatchReader and checks their contents.
+ */
+void checkReads(BatchReader& reader)
+{
+    std::vector<FileDescriptor> files;
+    for (int i = 0; i < 5; ++i)
+    {
+        files.emplace_back(createFile("0x" + std::to_string(i) + "\n"));
+    }
+
+    std::vector<std::array<char, 32>> buffers(files.size() + 1);
+    std::vector<BatchRead> reads;
+    for (size_t i = 0; i < files.size(); ++i)
+    {
+        reads.push_back(BatchRead{files[i](), buffers[i]});
+    }
+    reads.push_back(BatchRead{-1, buffers.back()});
+
+    // The files are read from offset 0 every time
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        reader.read(reads);
+        for (size_t i = 0; i < files.size(); ++i)
+        {
+            ASSERT_EQ(reads[i].result, 4);
+            EXPECT_EQ((std::string_view{reads[i].buffer.data(), 4}),
+                      "0x" + std::to_string(i) + "\n");
+        }
+        EXPECT_EQ(reads.back().result, -EBADF);
+    }
+}
+
+} // namespace
+
+TEST(BatchReaderTests, Read)
+{
+    // Fewer entries than reads, so they are submitted in parts
+    BatchReader reader{2};
+    checkReads(reader);
+
+    std::vector<BatchRead> none;
+    reader.read(none);
+}
+
+TEST(BatchReaderTests, ReadDefaultEntries)
+{
+    BatchReader reader;
+    checkReads(reader);
+}
@@ -0,0 +1,155 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "config_cache.hpp"
+
+#include <stdlib.h> // for mkdtemp()
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include <gtest/gtest.h>
+
+using namespace phosphor::power::util;
+
+namespace fs = std::filesystem;
+
+/**
+ * Test fixture that creates a temporary directory for the config files.
+ */
+class ConfigCacheTests : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        char dirTemplate[] = "/tmp/config_cache_tests-XXXXXX";
+        root = mkdtemp(dirTemplate);
+        path = root / "psu.json";
+    }
+
+    void TearDown() override
+    {
+        fs::remove_all(root);
+    }
+
+    /**
+     * Writes the config file.
+     *
+     * @param[in] contents - the contents of the file
+     */
+    void writeFile(const std::string& contents)
+    {
+        std::ofstream file{path};
+        file << contents;
+    }
+
+    fs::path root;
+    fs::path path;
+};
+
+TEST_F(ConfigCacheTests, Load)
+{
+    writeFile(R"({"psuDevices": {"/psu0": "/dev0", "/psu1": "/dev1"}})");
+
+    // File is parsed once and shared
+    ConfigCache cache;
+    auto file = cache.load(path);
+    ASSERT_NE(file, nullptr);
+    EXPECT_EQ(cache.load(path), file);
+    EXPECT_EQ(cache.getParseCount(), 1);
+
+    EXPECT_EQ(file->getJSON()["psuDevices"]["/psu0"], "/dev0");
+    EXPECT_EQ(file->getPSUDevices().size(), 2);
+    ASSERT_NE(file->getDevicePath("/psu1"), nullptr);
+    EXPECT_EQ(*file->getDevicePath("/psu1"), "/dev1");
+    EXPECT_EQ(file->getDevicePath("/psu2"), nullptr);
+    EXPECT_TRUE(file->getFRUConfigs().empty());
+
+    // Invalidate
+    cache.invalidate();
+    EXPECT_NE(cache.load(path), nullptr);
+    EXPECT_EQ(cache.getParseCount(), 2);
+}
+
+TEST_F(ConfigCacheTests, LoadAfterChange)
+{
+    writeFile(R"({"psuDevices": {"/psu0": "/dev0"}})");
+
+    ConfigCache cache;
+    auto file = cache.load(path);
+    ASSERT_NE(file, nullptr);
+
+    // Replaced file is parsed again, and the old version stays valid
+    fs::path newPath = root / "new.json";
+    {
+        std::ofstream newFile{newPath};
+        newFile << R"({"psuDevices": {"/psu0": "/dev0", "/psu1": "/dev1"}})";
+    }
+    fs::rename(newPath, path);
+
+    auto newFile = cache.load(path);
+    ASSERT_NE(newFile, nullptr);
+    EXPECT_NE(newFile, file);
+    EXPECT_EQ(cache.getParseCount(), 2);
+    EXPECT_EQ(newFile->getPSUDevices().size(), 2);
+    EXPECT_EQ(file->getPSUDevices().size(), 1);
+}
+
+TEST_F(ConfigCacheTests, FRUConfigs)
+{
+    writeFile(R"(
+        {
+            "fruConfigs": [
+                {
+                    "propertyName": "PartNumber",
+                    "fileName": "part_number",
+                    "interface": "xyz.openbmc_project.Inventory.Decorator.Asset"
+                },
+                {
+                    "propertyName": "Version",
+                    "fileName": "fw_version"
+                }
+            ]
+        }
+    )");
+
+    // The entry without an interface is skipped
+    ConfigCache cache;
+    auto file = cache.load(path);
+    ASSERT_NE(file, nullptr);
+    ASSERT_EQ(file->getFRUConfigs().size(), 1);
+    const auto& fru = file->getFRUConfigs()[0];
+    EXPECT_EQ(fru.propertyName, "PartNumber");
+    EXPECT_EQ(fru.fileName, "part_number");
+    EXPECT_EQ(fru.interface, "xyz.openbmc_project.Inventory.Decorator.Asset");
+    EXPECT_TRUE(file->getPSUDevices().empty());
+}
+
+TEST_F(ConfigCacheTests, LoadFailure)
+{
+    ConfigCache cache;
+
+    // File does not exist
+    EXPECT_EQ(cache.load(path), nullptr);
+
+    // File is not valid JSON
+    writeFile("{");
+    EXPECT_EQ(cache.load(path), nullptr);
+
+    // File is parsed again once it is fixed
+    writeFile("{}");
+    EXPECT_NE(cache.load(path), nullptr);
+}
@@ -0,0 +1,101 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "cycle_stats.hpp"
+
+#include <chrono>
+
+#include <gtest/gtest.h>
+
+using namespace phosphor::power::util;
+using std::chrono::microseconds;
+
+TEST(CycleStatisticsTests, Constructor)
+{
+    CycleStatistics stats{microseconds{1000}};
+    EXPECT_EQ(stats.getInterval(), microseconds{1000});
+    EXPECT_EQ(stats.getCount(), 0);
+    EXPECT_EQ(stats.getLast(), microseconds{0});
+    EXPECT_EQ(stats.getMax(), microseconds{0});
+    EXPECT_EQ(stats.getPercentile(50), microseconds{0});
+    EXPECT_EQ(stats.getOverrunCount(), 0);
+    EXPECT_FALSE(stats.isOverrunWarningEnabled());
+}
+
+TEST(CycleStatisticsTests, GetPercentile)
+{
+    CycleStatistics stats{};
+    for (int i = 100; i >= 1; --i)
+    {
+        stats.record(microseconds{i});
+    }
+    EXPECT_EQ(stats.getPercentile(0), microseconds{1});
+    EXPECT_EQ(stats.getPercentile(50), microseconds{50});
+    EXPECT_EQ(stats.getPercentile(99), microseconds{99});
+    EXPECT_EQ(stats.getPercentile(100), microseconds{100});
+    EXPECT_EQ(stats.getPercentile(150), microseconds{100});
+
+    // Only the most recent samples are used
+    for (std::size_t i = 0; i < CycleStatistics::sampleCount; ++i)
+    {
+        stats.record(microseconds{7});
+    }
+    EXPECT_EQ(stats.getPercentile(100), microseconds{7});
+    EXPECT_EQ(stats.getMax(), microseconds{100});
+    EXPECT_EQ(stats.getCount(), 100 + CycleStatistics::sampleCount);
+}
+
+TEST(CycleStatisticsTests, Record)
+{
+    CycleStatistics stats{microseconds{1000}};
+    EXPECT_FALSE(stats.record(microseconds{400}));
+    EXPECT_FALSE(stats.record(microseconds{1000}));
+    EXPECT_TRUE(stats.record(microseconds{1500}));
+    EXPECT_FALSE(stats.record(microseconds{600}));
+    EXPECT_EQ(stats.getCount(), 4);
+    EXPECT_EQ(stats.getLast(), microseconds{600});
+    EXPECT_EQ(stats.getMax(), microseconds{1500});
+    EXPECT_EQ(stats.getOverrunCount(), 1);
+
+    // No overruns without an interval
+    stats.setInterval(microseconds{0});
+    EXPECT_FALSE(stats.record(microseconds{5000}));
+    EXPECT_EQ(stats.getOverrunCount(), 1);
+}
+
+TEST(CycleStatisticsTests, Reset)
+{
+    CycleStatistics stats{microseconds{10}};
+    stats.setOverrunWarningEnabled(true);
+    stats.record(microseconds{20});
+    stats.reset();
+    EXPECT_EQ(stats.getCount(), 0);
+    EXPECT_EQ(stats.getLast(), microseconds{0});
+    EXPECT_EQ(stats.getMax(), microseconds{0});
+    EXPECT_EQ(stats.getPercentile(99), microseconds{0});
+    EXPECT_EQ(stats.getOverrunCount(), 0);
+    EXPECT_EQ(stats.getInterval(), microseconds{10});
+    EXPECT_TRUE(stats.isOverrunWarningEnabled());
+}
+
+TEST(CycleStatisticsTests, ToString)
+{
+    CycleStatistics stats{microseconds{100}};
+    stats.record(microseconds{50});
+    stats.record(microseconds{150});
+    EXPECT_EQ(stats.toString(),
+              "cycles: 2, last: 150 us, p50: 50 us, p99: 150 us, "
+              "max: 150 us, interval: 100 us, overruns: 1");
+}
@@ -0,0 +1,133 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "energy_history.hpp"
+
+#include <array>
+#include <cstdint>
+
+#include <gtest/gtest.h>
+
+using namespace phosphor::power::history;
+
+using Record = EnergyHistory::DBusRecord;
+
+namespace
+{
+
+/**
+ * Returns the raw data of an energy accumulator reading.
+ */
+std::array<uint8_t, EnergyHistory::RAW_READING_SIZE>
+    makeReading(uint16_t accumulator, uint8_t rolloverCount,
+                uint32_t sampleCount)
+{
+    return {static_cast<uint8_t>(accumulator & 0xFF),
+            static_cast<uint8_t>(accumulator >> 8),
+            rolloverCount,
+            static_cast<uint8_t>(sampleCount & 0xFF),
+            static_cast<uint8_t>((sampleCount >> 8) & 0xFF),
+            static_cast<uint8_t>((sampleCount >> 16) & 0xFF)};
+}
+
+} // namespace
+
+TEST(EnergyHistoryTests, Parse)
+{
+    auto reading = EnergyHistory::parse(makeReading(0x1234, 0x56, 0x789ABC));
+    ASSERT_TRUE(reading);
+    EXPECT_EQ(reading->accumulator, 0x1234);
+    EXPECT_EQ(reading->rolloverCount, 0x56);
+    EXPECT_EQ(reading->sampleCount, 0x789ABC);
+
+    // Wrong length
+    std::array<uint8_t, 5> shortData{};
+    EXPECT_FALSE(EnergyHistory::parse(shortData));
+
+    // Accumulator out of range
+    EXPECT_FALSE(EnergyHistory::parse(makeReading(0x8000, 0, 0)));
+}
+
+TEST(EnergyHistoryTests, Add)
+{
+    EnergyHistory history{2, 2};
+
+    // The first reading only starts the interval
+    EXPECT_FALSE(history.add(makeReading(1000, 0, 10), 1));
+
+    // 100 W for 10 samples, then 300 W for 10 samples
+    EXPECT_FALSE(history.add(makeReading(2000, 0, 20), 2));
+    EXPECT_TRUE(history.add(makeReading(5000, 0, 30), 3));
+    ASSERT_EQ(history.getNumRecords(), 1);
+    EXPECT_EQ(history.getAverageRecords()[0], Record(3, 200));
+    EXPECT_EQ(history.getMaximumRecords()[0], Record(3, 300));
+
+    // Accumulator rolls over: 400 W for 100 samples, twice
+    EXPECT_FALSE(history.add(makeReading(5000 + 40000 - 32768, 1, 130), 4));
+    EXPECT_TRUE(history.add(makeReading(5000 + 80000 - 65536, 2, 230), 5));
+    ASSERT_EQ(history.getNumRecords(), 2);
+    EXPECT_EQ(history.getAverageRecords()[0], Record(5, 400));
+    EXPECT_EQ(history.getAverageRecords()[1], Record(3, 200));
+
+    // Oldest record is pruned
+    EXPECT_FALSE(history.add(makeReading(20464, 2, 240), 6));
+    EXPECT_TRUE(history.add(makeReading(21464, 2, 250), 7));
+    ASSERT_EQ(history.getNumRecords(), 2);
+    EXPECT_EQ(history.getAverageRecords()[0], Record(7, 100));
+    EXPECT_EQ(history.getAverageRecords()[1], Record(5, 400));
+
+    history.clear();
+    EXPECT_EQ(history.getNumRecords(), 0);
+}
+
+TEST(EnergyHistoryTests, Wrap)
+{
+    // The rollover count and the sample count both wrap: 100 W for 10
+    // samples
+    EnergyHistory history{10, 1};
+    EXPECT_FALSE(history.add(makeReading(32000, 255, 0xFFFFF8), 1));
+    EXPECT_TRUE(history.add(makeReading(32000 + 1000 - 32768, 0, 2), 2));
+    EXPECT_EQ(history.getAverageRecords()[0], Record(2, 100));
+}
+
+TEST(EnergyHistoryTests, Restart)
+{
+    EnergyHistory history{10, 2};
+    EXPECT_FALSE(history.add(makeReading(0, 0, 0), 1));
+    EXPECT_FALSE(history.add(makeReading(1000, 0, 10), 2));
+
+    // A bad reading discards the partial record and the interval
+    std::array<uint8_t, 0> noData{};
+    EXPECT_FALSE(history.add(noData, 3));
+    EXPECT_FALSE(history.add(makeReading(1000, 0, 10), 4));
+    EXPECT_FALSE(history.add(makeReading(2000, 0, 20), 5));
+
+    // No new samples also discards the partial record
+    EXPECT_FALSE(history.add(makeReading(2000, 0, 20), 6));
+    EXPECT_FALSE(history.add(makeReading(2500, 0, 30), 7));
+    EXPECT_TRUE(history.add(makeReading(3000, 0, 40), 8));
+    ASSERT_EQ(history.getNumRecords(), 1);
+    EXPECT_EQ(history.getAverageRecords()[0], Record(8, 50));
+}
+
+TEST(EnergyHistoryTests, Coefficients)
+{
+    // X = (Y * 10^-1 - 20) / 2
+    EnergyHistory history{10, 1, Coefficients{2, 20, 1}};
+    EXPECT_FALSE(history.add(makeReading(0, 0, 0), 1));
+    EXPECT_TRUE(history.add(makeReading(10000, 0, 10), 2));
+    EXPECT_EQ(history.getAverageRecords()[0], Record(2, 40));
+    EXPECT_EQ(history.getMaximumRecords()[0], Record(2, 40));
+}
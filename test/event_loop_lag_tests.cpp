@@ -0,0 +1,234 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "event_loop_lag.hpp"
+
+#include <chrono>
+#include <optional>
+#include <string>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+using namespace phosphor::power::util;
+using std::chrono::microseconds;
+using std::chrono::milliseconds;
+
+TEST(EventLoopLagTests, Constructor)
+{
+    // Test where works: default block threshold
+    {
+        EventLoopLag lag{};
+        EXPECT_EQ(lag.getBlockThreshold(), EventLoopLag::defaultBlockThreshold);
+        EXPECT_EQ(lag.getCount(), 0);
+        EXPECT_EQ(lag.getBlockedCount(), 0);
+        EXPECT_EQ(lag.getMax(), microseconds{0});
+        EXPECT_EQ(lag.getMean(), microseconds{0});
+        EXPECT_TRUE(lag.getTop().empty());
+        for (auto value : lag.getHistogram())
+        {
+            EXPECT_EQ(value, 0);
+        }
+    }
+
+    // Test where works: block threshold specified
+    {
+        EventLoopLag lag{microseconds{500}};
+        EXPECT_EQ(lag.getBlockThreshold(), microseconds{500});
+    }
+}
+
+TEST(EventLoopLagTests, GetBucketLimit)
+{
+    EXPECT_EQ(EventLoopLag::getBucketLimit(0), milliseconds{1});
+    EXPECT_EQ(EventLoopLag::getBucketLimit(1), milliseconds{2});
+    EXPECT_EQ(EventLoopLag::getBucketLimit(4), milliseconds{16});
+    EXPECT_EQ(EventLoopLag::getBucketLimit(EventLoopLag::bucketCount - 2),
+              milliseconds{1 << (EventLoopLag::bucketCount - 2)});
+    EXPECT_EQ(EventLoopLag::getBucketLimit(EventLoopLag::bucketCount - 1),
+              microseconds::max());
+}
+
+TEST(EventLoopLagTests, Record)
+{
+    // Test where works: lags are counted in the histogram buckets
+    {
+        EventLoopLag lag{};
+        EXPECT_FALSE(lag.record(microseconds{0}));
+        EXPECT_FALSE(lag.record(microseconds{999}));
+        EXPECT_FALSE(lag.record(microseconds{1000}));
+        EXPECT_FALSE(lag.record(microseconds{3999}));
+        EXPECT_FALSE(lag.record(microseconds{4000}));
+        lag.record(milliseconds{100000});
+
+        const auto& histogram = lag.getHistogram();
+        EXPECT_EQ(histogram[0], 2);
+        EXPECT_EQ(histogram[1], 1);
+        EXPECT_EQ(histogram[2], 1);
+        EXPECT_EQ(histogram[3], 1);
+        EXPECT_EQ(histogram[EventLoopLag::bucketCount - 1], 1);
+
+        EXPECT_EQ(lag.getCount(), 6);
+        EXPECT_EQ(lag.getBlockedCount(), 1);
+        EXPECT_EQ(lag.getMax(), milliseconds{100000});
+    }
+
+    // Test where works: mean
+    {
+        EventLoopLag lag{};
+        lag.record(microseconds{100});
+        lag.record(microseconds{300});
+        EXPECT_EQ(lag.getMean(), microseconds{200});
+    }
+
+    // Test where works: negative lag is counted as 0
+    {
+        EventLoopLag lag{};
+        lag.record(microseconds{-50});
+        EXPECT_EQ(lag.getCount(), 1);
+        EXPECT_EQ(lag.getHistogram()[0], 1);
+        EXPECT_EQ(lag.getMax(), microseconds{0});
+        EXPECT_EQ(lag.getMean(), microseconds{0});
+    }
+
+    // Test where works: lag at the block threshold is a blocker
+    {
+        EventLoopLag lag{microseconds{500}};
+        EXPECT_FALSE(lag.record(microseconds{499}));
+        std::optional<EventLoopLag::Blocker> blocker =
+            lag.record(microseconds{500});
+        ASSERT_TRUE(blocker);
+        EXPECT_EQ(blocker->lag, microseconds{500});
+        EXPECT_EQ(blocker->handler, nullptr);
+        EXPECT_EQ(blocker->handlerDuration, microseconds{0});
+        EXPECT_EQ(lag.getBlockedCount(), 1);
+        ASSERT_EQ(lag.getTop().size(), 1);
+        EXPECT_EQ(lag.getTop()[0].lag, microseconds{500});
+    }
+}
+
+TEST(EventLoopLagTests, Top)
+{
+    EventLoopLag lag{microseconds{100}};
+
+    // Test where works: longest lags first
+    lag.record(microseconds{200});
+    lag.record(microseconds{400});
+    lag.record(microseconds{300});
+    ASSERT_EQ(lag.getTop().size(), 3);
+    EXPECT_EQ(lag.getTop()[0].lag, microseconds{400});
+    EXPECT_EQ(lag.getTop()[1].lag, microseconds{300});
+    EXPECT_EQ(lag.getTop()[2].lag, microseconds{200});
+
+    // Test where works: at most topCount lags are kept
+    for (size_t i = 0; i < EventLoopLag::topCount; ++i)
+    {
+        lag.record(microseconds{1000 + i});
+    }
+    ASSERT_EQ(lag.getTop().size(), EventLoopLag::topCount);
+    EXPECT_EQ(lag.getTop().front().lag,
+              microseconds{1000 + EventLoopLag::topCount - 1});
+    EXPECT_EQ(lag.getTop().back().lag, microseconds{1000});
+    EXPECT_EQ(lag.getBlockedCount(), 3 + EventLoopLag::topCount);
+
+    // Test where works: shorter lag than all kept is not a new blocker
+    EXPECT_FALSE(lag.record(microseconds{500}));
+    EXPECT_EQ(lag.getTop().back().lag, microseconds{1000});
+    EXPECT_EQ(lag.getBlockedCount(), 4 + EventLoopLag::topCount);
+
+    // Test where works: longer lag replaces the shortest one kept
+    EXPECT_TRUE(lag.record(microseconds{5000}));
+    ASSERT_EQ(lag.getTop().size(), EventLoopLag::topCount);
+    EXPECT_EQ(lag.getTop().front().lag, microseconds{5000});
+    EXPECT_EQ(lag.getTop().back().lag, microseconds{1001});
+}
+
+TEST(EventLoopLagTests, Scope)
+{
+    EventLoopLag lag{microseconds{100}};
+
+    // Test where works: lag is attributed to the longest handler
+    {
+        EventLoopLag::Scope scope{lag, "short"};
+    }
+    {
+        EventLoopLag::Scope scope{lag, "long"};
+        std::this_thread::sleep_for(milliseconds{2});
+    }
+    {
+        EventLoopLag::Scope scope{lag, "short"};
+    }
+    std::optional<EventLoopLag::Blocker> blocker =
+        lag.record(microseconds{2000});
+    ASSERT_TRUE(blocker);
+    EXPECT_EQ(std::string{blocker->handler}, "long");
+    EXPECT_GE(blocker->handlerDuration, milliseconds{2});
+    ASSERT_EQ(lag.getTop().size(), 1);
+    EXPECT_EQ(std::string{lag.getTop()[0].handler}, "long");
+
+    // Test where works: handlers are forgotten after each probe
+    blocker = lag.record(microseconds{3000});
+    ASSERT_TRUE(blocker);
+    EXPECT_EQ(blocker->handler, nullptr);
+    EXPECT_EQ(blocker->handlerDuration, microseconds{0});
+}
+
+TEST(EventLoopLagTests, Reset)
+{
+    EventLoopLag lag{microseconds{100}};
+    {
+        EventLoopLag::Scope scope{lag, "handler"};
+    }
+    lag.record(microseconds{2000});
+    {
+        EventLoopLag::Scope scope{lag, "handler"};
+    }
+
+    lag.reset();
+    EXPECT_EQ(lag.getBlockThreshold(), microseconds{100});
+    EXPECT_EQ(lag.getCount(), 0);
+    EXPECT_EQ(lag.getBlockedCount(), 0);
+    EXPECT_EQ(lag.getMax(), microseconds{0});
+    EXPECT_EQ(lag.getMean(), microseconds{0});
+    EXPECT_TRUE(lag.getTop().empty());
+    for (auto value : lag.getHistogram())
+    {
+        EXPECT_EQ(value, 0);
+    }
+
+    // The handler that ran before the reset is forgotten too
+    std::optional<EventLoopLag::Blocker> blocker =
+        lag.record(microseconds{2000});
+    ASSERT_TRUE(blocker);
+    EXPECT_EQ(blocker->handler, nullptr);
+}
+
+TEST(EventLoopLagTests, ToString)
+{
+    EventLoopLag lag{microseconds{100}};
+    EXPECT_EQ(lag.toString(), "probes: 0, mean: 0 us, max: 0 us, blocked: 0");
+
+    lag.record(microseconds{50});
+    lag.record(microseconds{150});
+    EXPECT_EQ(lag.toString(), "probes: 2, mean: 100 us, max: 150 us, "
+                              "blocked: 1, longest: 150 us in unknown");
+
+    {
+        EventLoopLag::Scope scope{lag, "handler"};
+    }
+    lag.record(microseconds{250});
+    EXPECT_EQ(lag.toString(), "probes: 3, mean: 150 us, max: 250 us, "
+                              "blocked: 2, longest: 250 us in handler");
+}
@@ -0,0 +1,156 @@
+/**
+ * Copyright © 2026 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "pmbus.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace phosphor::pmbus
+{
+
+/**
+ * @class FakePMBus
+ *
+ * PMBusBase implementation for the tests of the PMBus wrappers.
+ *
+ * Returns fixed register values, records the binary writes, and counts the
+ * reads and status snapshots.  Reading a register without a value throws an
+ * exception.
+ */
+class FakePMBus : public PMBusBase
+{
+  public:
+    uint64_t read(const std::string& name, Type) override
+    {
+        ++readCount;
+        entered = true;
+        while (block)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        }
+        auto it = values.find(name);
+        if (it == values.end())
+        {
+            throw std::runtime_error{"Unable to read " + name};
+        }
+        return it->second;
+    }
+
+    StatusSnapshot readStatusSnapshot(const std::vector<std::string>& names,
+                                      Type type) override
+    {
+        ++snapshotCount;
+        lastNames = names;
+        if (throwOnSnapshot)
+        {
+            throw std::runtime_error{"Device not present"};
+        }
+        return PMBusBase::readStatusSnapshot(names, type);
+    }
+
+    std::string readString(const std::string& name, Type) override
+    {
+        ++readCount;
+        auto it = values.find(name);
+        if (it == values.end())
+        {
+            throw std::runtime_error{"Unable to read " + name};
+        }
+        return std::to_string(it->second);
+    }
+
+    void writeBinary(const std::string& name, std::span<const uint8_t> data,
+                     Type) override
+    {
+        written[name].assign(data.begin(), data.end());
+    }
+
+    void findHwmonDir() override
+    {}
+
+    const fs::path& path() const override
+    {
+        return devicePath;
+    }
+
+    std::string insertPageNum(const std::string& templateName,
+                              size_t page) override
+    {
+        auto name = templateName;
+        auto pos = name.find('P');
+        if (pos != std::string::npos)
+        {
+            name.replace(pos, 1, std::to_string(page));
+        }
+        return name;
+    }
+
+    /**
+     * Register values by file name.
+     */
+    std::map<std::string, uint64_t> values{};
+
+    /**
+     * Data of the last binary write by file name.
+     */
+    std::map<std::string, std::vector<uint8_t>> written{};
+
+    /**
+     * File names of the last status snapshot.
+     */
+    std::vector<std::string> lastNames{};
+
+    /**
+     * Number of read() and readString() calls.
+     */
+    std::atomic<size_t> readCount{0};
+
+    /**
+     * Number of readStatusSnapshot() calls.
+     */
+    size_t snapshotCount{0};
+
+    /**
+     * Indicates whether readStatusSnapshot() throws an exception.
+     */
+    bool throwOnSnapshot{false};
+
+    /**
+     * Makes read() wait until cleared.
+     */
+    std::atomic<bool> block{false};
+
+    /**
+     * Set when read() is called.
+     */
+    std::atomic<bool> entered{false};
+
+    /**
+     * Path returned by path().
+     */
+    fs::path devicePath{"/sys/bus/i2c/devices/3-0068"};
+};
+
+} // namespace phosphor::pmbus
@@ -0,0 +1,159 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "hwmon_index.hpp"
+
+#include <stdlib.h> // for mkdtemp()
+
+#include <filesystem>
+#include <string>
+
+#include <gtest/gtest.h>
+
+using namespace phosphor::pmbus;
+
+namespace fs = std::filesystem;
+
+/**
+ * Test fixture that creates a fake sysfs with a hwmon class directory and a
+ * device directory.
+ */
+class HwmonIndexTests : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        char dirTemplate[] = "/tmp/hwmon_index_tests-XXXXXX";
+        root = mkdtemp(dirTemplate);
+        classPath = root / "class" / "hwmon";
+        devicePath = root / "devices" / "3-0069";
+        fs::create_directories(classPath);
+        fs::create_directories(devicePath);
+    }
+
+    void TearDown() override
+    {
+        fs::remove_all(root);
+    }
+
+    /**
+     * Creates a hwmon directory for a device and its link in the class
+     * directory.
+     *
+     * @param[in] device - the device directory
+     * @param[in] name - the hwmon directory name
+     */
+    void addHwmon(const fs::path& device, const std::string& name)
+    {
+        fs::create_directories(device / "hwmon" / name);
+        fs::create_directory_symlink(device / "hwmon" / name,
+                                     classPath / name);
+    }
+
+    /**
+     * Removes a hwmon directory of a device and its link in the class
+     * directory.
+     *
+     * @param[in] device - the device directory
+     * @param[in] name - the hwmon directory name
+     */
+    void removeHwmon(const fs::path& device, const std::string& name)
+    {
+        fs::remove(classPath / name);
+        fs::remove_all(device / "hwmon" / name);
+    }
+
+    fs::path root;
+    fs::path classPath;
+    fs::path devicePath;
+};
+
+TEST_F(HwmonIndexTests, Find)
+{
+    fs::path otherPath = root / "devices" / "4-0058";
+    addHwmon(devicePath, "hwmon3");
+    addHwmon(otherPath, "hwmon7");
+
+    // Index is built once and shared by all the devices
+    HwmonIndex index{classPath};
+    EXPECT_EQ(index.find(devicePath), "hwmon3");
+    EXPECT_EQ(index.find(otherPath), "hwmon7");
+    EXPECT_EQ(index.find(devicePath), "hwmon3");
+    EXPECT_EQ(index.getScanCount(), 1);
+
+    // Device without a hwmon directory
+    EXPECT_EQ(index.find(root / "devices" / "5-0040"), fs::path{});
+}
+
+TEST_F(HwmonIndexTests, FindAfterChange)
+{
+    addHwmon(devicePath, "hwmon3");
+    HwmonIndex index{classPath};
+    EXPECT_EQ(index.find(devicePath), "hwmon3");
+
+    // Driver is rebound and the device gets a new hwmon directory.  The
+    // class directory is watched, so the index is built again.
+    removeHwmon(devicePath, "hwmon3");
+    addHwmon(devicePath, "hwmon4");
+    EXPECT_EQ(index.find(devicePath), "hwmon4");
+    EXPECT_EQ(index.getScanCount(), 2);
+
+    // Device directory changes without a change in the class directory.  The
+    // stale directory is detected and the device directory is scanned.
+    fs::remove_all(devicePath / "hwmon" / "hwmon4");
+    fs::create_directories(devicePath / "hwmon" / "hwmon5");
+    EXPECT_EQ(index.find(devicePath), "hwmon5");
+    EXPECT_EQ(index.getScanCount(), 2);
+
+    // Driver is unbound
+    fs::remove_all(devicePath / "hwmon");
+    EXPECT_EQ(index.find(devicePath), fs::path{});
+}
+
+TEST_F(HwmonIndexTests, Invalidate)
+{
+    addHwmon(devicePath, "hwmon3");
+    HwmonIndex index{classPath};
+    EXPECT_EQ(index.find(devicePath), "hwmon3");
+    EXPECT_EQ(index.getScanCount(), 1);
+
+    index.invalidate();
+    EXPECT_EQ(index.find(devicePath), "hwmon3");
+    EXPECT_EQ(index.getScanCount(), 2);
+}
+
+TEST_F(HwmonIndexTests, Restore)
+{
+    fs::path otherPath = root / "devices" / "4-0058";
+    addHwmon(devicePath, "hwmon3");
+    addHwmon(otherPath, "hwmon7");
+    HwmonIndex index{classPath};
+    EXPECT_EQ(index.find(devicePath), "hwmon3");
+    EXPECT_EQ(index.find(otherPath), "hwmon7");
+    auto entries = index.getEntries();
+    EXPECT_EQ(entries.size(), 2);
+
+    // The index of a previous daemon is used without scanning
+    HwmonIndex restored{classPath};
+    restored.restore(entries);
+    EXPECT_EQ(restored.find(devicePath), "hwmon3");
+    EXPECT_EQ(restored.getScanCount(), 0);
+
+    // A directory that no longer exists is not returned
+    fs::remove_all(otherPath / "hwmon" / "hwmon7");
+    fs::create_directories(otherPath / "hwmon" / "hwmon8");
+    EXPECT_EQ(restored.find(otherPath), "hwmon8");
+    EXPECT_EQ(restored.getScanCount(), 0);
+}
@@ -0,0 +1,182 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "memfd_file.hpp"
+
+#include <errno.h>  // for errno
+#include <fcntl.h>  // for fcntl()
+#include <string.h> // for memset()
+#include <unistd.h> // for read(), write(), lseek(), close()
+
+#include <algorithm>
+#include <array>
+#include <exception>
+#include <span>
+#include <string>
+#include <utility>
+
+#include <gtest/gtest.h>
+
+using namespace phosphor::power::util;
+
+/**
+ * Returns whether the specified file descriptor is valid/open.
+ *
+ * @param[in] fd - File descriptor
+ * @return true if descriptor is valid/open, false otherwise
+ */
+bool isValid(int fd)
+{
+    return (fcntl(fd, F_GETFL) != -1) || (errno != EBADF);
+}
+
+TEST(MemFDFileTests, Constructor)
+{
+    MemFDFile file{"ffdc"};
+    EXPECT_NE(file.getFileDescriptor(), -1);
+    EXPECT_TRUE(isValid(file.getFileDescriptor()));
+    EXPECT_FALSE(file.isSealed());
+}
+
+TEST(MemFDFileTests, MoveConstructor)
+{
+    MemFDFile file1{"ffdc"};
+    int fd = file1.getFileDescriptor();
+
+    MemFDFile file2{std::move(file1)};
+    EXPECT_EQ(file1.getFileDescriptor(), -1);
+    EXPECT_EQ(file2.getFileDescriptor(), fd);
+    EXPECT_TRUE(isValid(fd));
+}
+
+TEST(MemFDFileTests, Write)
+{
+    // Test where works
+    {
+        MemFDFile file{"ffdc"};
+        file.write("First line\n");
+        file.write("Second line\n");
+
+        // Read and verify file contents
+        int fd = file.getFileDescriptor();
+        EXPECT_EQ(lseek(fd, 0, SEEK_SET), 0);
+        char buffer[32];
+        memset(buffer, '\0', sizeof(buffer));
+        EXPECT_EQ(read(fd, buffer, sizeof(buffer)), 23);
+        EXPECT_STREQ(buffer, "First line\nSecond line\n");
+    }
+
+    // Test where works: Binary data
+    {
+        MemFDFile file{"ffdc"};
+        std::array<uint8_t, 4> data{0x00, 0xEA, 0xFF, 0x01};
+        file.write(std::span<const uint8_t>{data});
+
+        int fd = file.getFileDescriptor();
+        EXPECT_EQ(lseek(fd, 0, SEEK_SET), 0);
+        std::array<uint8_t, 8> buffer{};
+        EXPECT_EQ(read(fd, buffer.data(), buffer.size()), 4);
+        EXPECT_TRUE(std::equal(data.begin(), data.end(), buffer.begin()));
+    }
+
+    // Test where fails: File has been closed
+    {
+        MemFDFile file{"ffdc"};
+        file.close();
+        EXPECT_THROW(file.write("data"), std::runtime_error);
+    }
+}
+
+TEST(MemFDFileTests, Seal)
+{
+    MemFDFile file{"ffdc"};
+    file.write("FFDC data");
+    file.seal();
+    EXPECT_TRUE(file.isSealed());
+
+    // Verify file offset is at the beginning and data can be read
+    int fd = file.getFileDescriptor();
+    char buffer[16];
+    memset(buffer, '\0', sizeof(buffer));
+    EXPECT_EQ(read(fd, buffer, sizeof(buffer)), 9);
+    EXPECT_STREQ(buffer, "FFDC data");
+
+    // Verify contents can no longer be changed
+    EXPECT_THROW(file.write("more"), std::runtime_error);
+    EXPECT_EQ(ftruncate(fd, 0), -1);
+    EXPECT_EQ(fcntl(fd, F_GET_SEALS) & F_SEAL_WRITE, F_SEAL_WRITE);
+
+    // Verify seals can no longer be changed
+    EXPECT_THROW(file.seal(), std::runtime_error);
+}
+
+TEST(MemFDFileTests, Reopen)
+{
+    // Test where works
+    {
+        MemFDFile file{"ffdc"};
+        file.write("FFDC data");
+        file.seal();
+
+        // Each descriptor has its own file offset
+        FileDescriptor fd1 = file.reopen();
+        FileDescriptor fd2 = file.reopen();
+        EXPECT_NE(fd1(), file.getFileDescriptor());
+        char buffer[16];
+        memset(buffer, '\0', sizeof(buffer));
+        EXPECT_EQ(read(fd1(), buffer, sizeof(buffer)), 9);
+        EXPECT_STREQ(buffer, "FFDC data");
+        memset(buffer, '\0', sizeof(buffer));
+        EXPECT_EQ(read(fd2(), buffer, sizeof(buffer)), 9);
+        EXPECT_STREQ(buffer, "FFDC data");
+
+        // The descriptors are read-only
+        EXPECT_EQ(write(fd1(), "x", 1), -1);
+    }
+
+    // Test where file was closed
+    {
+        MemFDFile file{"ffdc"};
+        file.close();
+        EXPECT_THROW(file.reopen(), std::runtime_error);
+    }
+}
+
+TEST(MemFDFileTests, Close)
+{
+    // Test where works
+    {
+        MemFDFile file{"ffdc"};
+        int fd = file.getFileDescriptor();
+        file.close();
+        EXPECT_EQ(file.getFileDescriptor(), -1);
+        EXPECT_FALSE(isValid(fd));
+    }
+
+    // Test where file was already closed
+    {
+        MemFDFile file{"ffdc"};
+        file.close();
+        file.close();
+        EXPECT_EQ(file.getFileDescriptor(), -1);
+    }
+
+    // Test where closing the file fails
+    {
+        MemFDFile file{"ffdc"};
+        EXPECT_EQ(close(file.getFileDescriptor()), 0);
+        EXPECT_THROW(file.close(), std::runtime_error);
+    }
+}
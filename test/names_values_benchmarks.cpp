@@ -0,0 +1,71 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "names_values.hpp"
+
+#include <cstdint>
+
+#include <benchmark/benchmark.h>
+
+using namespace phosphor::power::util;
+
+namespace
+{
+
+/**
+ * Adds the registers of a power supply fault to the metadata, like the
+ * fault capture of the legacy power supply monitor.
+ */
+template <typename T>
+void addStatus(T& nv, uint64_t seed)
+{
+    nv.add("STATUS_WORD", 0x0844 ^ seed);
+    nv.add("status0_input", 0x10);
+    nv.add("status0_vout", 0x80);
+    nv.add("status0_iout", 0x00);
+    nv.add("status0_temp", 0x40);
+    nv.add("status0_cml", 0x02);
+    nv.add("status0_mfr", 0x20);
+    nv.add("status0_fan12", 0x08);
+}
+
+void BM_NamesValues(benchmark::State& state)
+{
+    uint64_t seed = 0;
+    for (auto _ : state)
+    {
+        NamesValues nv;
+        addStatus(nv, seed++);
+        benchmark::DoNotOptimize(nv.get().c_str());
+    }
+}
+
+void BM_FixedNamesValues(benchmark::State& state)
+{
+    uint64_t seed = 0;
+    for (auto _ : state)
+    {
+        FixedNamesValues<> nv;
+        addStatus(nv, seed++);
+        benchmark::DoNotOptimize(nv.c_str());
+    }
+}
+
+} // namespace
+
+BENCHMARK(BM_NamesValues);
+BENCHMARK(BM_FixedNamesValues);
+
+BENCHMARK_MAIN();
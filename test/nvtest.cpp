@@ -33,3 +33,48 @@ TEST(NamesValuesTest, TestValues)
 
     EXPECT_EQ(nv.get(), expected);
 }
+
+TEST(NamesValuesTest, TestFixedValues)
+{
+    phosphor::power::util::FixedNamesValues<> nv;
+
+    std::string expected;
+    EXPECT_EQ(nv.get(), expected); // empty
+    EXPECT_STREQ(nv.c_str(), expected.c_str());
+
+    nv.add("name1", 0);
+    nv.add("name2", 0xC0FFEE);
+    nv.add("name3", 0x12345678abcdef12);
+    nv.add("name4", 0x0000000001);
+
+    expected = "name1=0x0|name2=0xc0ffee|name3=0x12345678abcdef12|name4=0x1";
+
+    EXPECT_EQ(nv.get(), expected);
+    EXPECT_STREQ(nv.c_str(), expected.c_str());
+    EXPECT_FALSE(nv.truncated());
+}
+
+TEST(NamesValuesTest, TestFixedTruncated)
+{
+    // Room for "name1=0x1|name2=0xff" and the null
+    phosphor::power::util::FixedNamesValues<21> nv;
+
+    nv.add("name1", 1);
+    nv.add("name2", 0xFF);
+    EXPECT_EQ(nv.get(), "name1=0x1|name2=0xff");
+    EXPECT_FALSE(nv.truncated());
+
+    // Pairs that do not fit are left out
+    nv.add("name3", 2);
+    EXPECT_EQ(nv.get(), "name1=0x1|name2=0xff");
+    EXPECT_STREQ(nv.c_str(), "name1=0x1|name2=0xff");
+    EXPECT_TRUE(nv.truncated());
+
+    // The value does not fit after the name
+    phosphor::power::util::FixedNamesValues<16> small;
+    small.add("name1", 1);
+    small.add("n", 0xABCDEF);
+    EXPECT_EQ(small.get(), "name1=0x1");
+    EXPECT_STREQ(small.c_str(), "name1=0x1");
+    EXPECT_TRUE(small.truncated());
+}
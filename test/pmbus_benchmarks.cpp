@@ -0,0 +1,199 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "phosphor-regulators/test/allocation_tracker.hpp"
+#include "pmbus.hpp"
+
+#include <stdlib.h> // for mkdtemp()
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+using namespace phosphor::pmbus;
+namespace allocation_tracker = phosphor::power::regulators::allocation_tracker;
+namespace fs = std::filesystem;
+
+namespace
+{
+
+/**
+ * A fake sysfs and debugfs tree for one power supply, in the layout that
+ * PMBus::getPath() expects for each Type.
+ *
+ * The tree is created on tmpfs when /dev/shm exists, so the benchmarks
+ * measure the PMBus code and the system calls rather than a disk.  Each
+ * directory has the same files, so every benchmark can run for every Type.
+ */
+class FakeSysfs
+{
+  public:
+    FakeSysfs()
+    {
+        std::string dirTemplate =
+            (fs::is_directory("/dev/shm") ? "/dev/shm" : "/tmp") +
+            std::string{"/pmbus_benchmarks-XXXXXX"};
+        root = mkdtemp(dirTemplate.data());
+
+        basePath = root / "devices" / "3-0069";
+        debugPath = root / "debug";
+        std::vector<fs::path> dirs{
+            basePath, basePath / "hwmon" / "hwmon7",
+            debugPath / "pmbus" / "hwmon7",
+            debugPath / (std::string{driverName} + ".0"),
+            debugPath / "pmbus" / "hwmon7" / driverName};
+        for (const fs::path& dir : dirs)
+        {
+            fs::create_directories(dir);
+            writeFile(dir / "status0", "0x0844\n");
+            writeFile(dir / "power1_alarm", "1\n");
+            writeFile(dir / "fw_version", "0x00-0x01-0x02-0x03\n");
+            writeFile(dir / "operation", "0\n");
+            writeFile(dir / "vpd", std::string(64, 'V'));
+        }
+        writeFile(basePath / "name", std::string{driverName} + "\n");
+    }
+
+    ~FakeSysfs()
+    {
+        std::error_code ec;
+        fs::remove_all(root, ec);
+    }
+
+    FakeSysfs(const FakeSysfs&) = delete;
+    FakeSysfs& operator=(const FakeSysfs&) = delete;
+
+    /**
+     * Creates a PMBus object for the fake power supply.
+     *
+     * @param[in] fileCache - whether the open file cache is enabled
+     */
+    PMBus createPMBus(bool fileCache) const
+    {
+        PMBus pmbus{basePath.string(), driverName, 0, debugPath};
+        pmbus.setFileCacheEnabled(fileCache);
+        return pmbus;
+    }
+
+  private:
+    static void writeFile(const fs::path& path, const std::string& contents)
+    {
+        std::ofstream file{path, std::ios::binary};
+        file << contents;
+    }
+
+    /** The device driver, which is also the device name. */
+    static constexpr const char* driverName = "ibm-cffps";
+
+    fs::path root;
+    fs::path basePath;
+    fs::path debugPath;
+};
+
+const FakeSysfs& getFakeSysfs()
+{
+    static FakeSysfs sysfs;
+    return sysfs;
+}
+
+/**
+ * Runs an access for each benchmark iteration and reports the heap
+ * allocations made per call.
+ *
+ * The first argument of the benchmark is the Type and the second is whether
+ * the open file cache is enabled.
+ */
+template <typename Access>
+void runAccess(benchmark::State& state, Access&& access)
+{
+    PMBus pmbus = getFakeSysfs().createPMBus(state.range(1) != 0);
+    auto type = static_cast<Type>(state.range(0));
+
+    // Warm up any caches, so only the steady state is measured
+    access(pmbus, type);
+
+    uint64_t allocations = allocation_tracker::getAllocationCount();
+    for (auto _ : state)
+    {
+        access(pmbus, type);
+    }
+    state.counters["allocs_per_call"] = benchmark::Counter(
+        static_cast<double>(allocation_tracker::getAllocationCount() -
+                            allocations),
+        benchmark::Counter::kAvgIterations);
+}
+
+void BM_Read(benchmark::State& state)
+{
+    runAccess(state, [](PMBus& pmbus, Type type) {
+        benchmark::DoNotOptimize(pmbus.read("status0", type));
+    });
+}
+
+void BM_ReadBit(benchmark::State& state)
+{
+    runAccess(state, [](PMBus& pmbus, Type type) {
+        benchmark::DoNotOptimize(pmbus.readBit("power1_alarm", type));
+    });
+}
+
+void BM_ReadString(benchmark::State& state)
+{
+    runAccess(state, [](PMBus& pmbus, Type type) {
+        benchmark::DoNotOptimize(pmbus.readString("fw_version", type));
+    });
+}
+
+void BM_ReadBinary(benchmark::State& state)
+{
+    runAccess(state, [](PMBus& pmbus, Type type) {
+        benchmark::DoNotOptimize(pmbus.readBinary("vpd", type, 64));
+    });
+}
+
+void BM_Write(benchmark::State& state)
+{
+    runAccess(state, [](PMBus& pmbus, Type type) {
+        pmbus.write("operation", 0x80, type);
+    });
+}
+
+/**
+ * Runs a benchmark for each Type, with and without the open file cache.
+ */
+void allTypes(benchmark::internal::Benchmark* benchmark)
+{
+    benchmark->ArgNames({"type", "cache"});
+    for (int64_t type = 0; type < static_cast<int64_t>(NUM_TYPES); ++type)
+    {
+        benchmark->Args({type, 0});
+        benchmark->Args({type, 1});
+    }
+}
+
+} // namespace
+
+BENCHMARK(BM_Read)->Apply(allTypes);
+BENCHMARK(BM_ReadBit)->Apply(allTypes);
+BENCHMARK(BM_ReadString)->Apply(allTypes);
+BENCHMARK(BM_ReadBinary)->Apply(allTypes);
+BENCHMARK(BM_Write)->Apply(allTypes);
+
+BENCHMARK_MAIN();
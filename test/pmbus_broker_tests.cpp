@@ -0,0 +1,295 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "batch_reader.hpp"
+#include "file_descriptor.hpp"
+#include "pmbus.hpp"
+#include "pmbus_broker.hpp"
+#include "test/fake_pmbus.hpp"
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace phosphor::pmbus;
+using namespace phosphor::power::util;
+
+namespace
+{
+
+/**
+ * FakePMBus that supports batched reads of memory files containing the
+ * register values.
+ */
+class FakeBatchPMBus : public FakePMBus
+{
+  public:
+    bool prepareSnapshot(const std::vector<std::string>& names, Type,
+                         std::vector<int>& fds) override
+    {
+        ++prepareCount;
+        files.clear();
+        fds.clear();
+        for (const auto& name : names)
+        {
+            auto it = values.find(name);
+            if (it == values.end())
+            {
+                fds.push_back(-1);
+                continue;
+            }
+            auto text = std::to_string(it->second);
+            files.emplace_back(memfd_create("pmbus_broker_tests", 0));
+            EXPECT_EQ(write(files.back()(), text.data(), text.size()),
+                      static_cast<ssize_t>(text.size()));
+            fds.push_back(files.back()());
+        }
+        return true;
+    }
+
+    StatusSnapshot
+        completeSnapshot(const std::vector<std::string>& names, Type,
+                         std::span<const BatchRead> reads) override
+    {
+        StatusSnapshot snapshot;
+        snapshot.values.resize(names.size(), 0);
+        snapshot.valid.resize(names.size(), false);
+        for (size_t i = 0; i < reads.size(); ++i)
+        {
+            if (reads[i].result > 0)
+            {
+                snapshot.values[i] = std::stoull(std::string{
+                    reads[i].buffer.data(),
+                    static_cast<size_t>(reads[i].result)});
+                snapshot.valid[i] = true;
+            }
+        }
+        return snapshot;
+    }
+
+    size_t prepareCount{0};
+    std::vector<FileDescriptor> files{};
+};
+
+} // namespace
+
+TEST(PMBusBrokerTests, AddDevice)
+{
+    PMBusBroker broker;
+    EXPECT_FALSE(broker.isBatched());
+    EXPECT_FALSE(broker.isAsync());
+    EXPECT_FALSE(broker.hasDevice("3-0068"));
+    broker.addDevice("3-0068", std::make_unique<FakePMBus>());
+    EXPECT_TRUE(broker.hasDevice("3-0068"));
+
+    // Duplicate device
+    EXPECT_THROW(broker.addDevice("3-0068", std::make_unique<FakePMBus>()),
+                 std::invalid_argument);
+}
+
+TEST(PMBusBrokerTests, Poll)
+{
+    // Registers shared by several subscribers are read once per poll
+    {
+        PMBusBroker broker;
+        auto pmbus = std::make_unique<FakePMBus>();
+        FakePMBus& fake = *pmbus;
+        fake.values = {{"status0", 0x12}, {"status0_vout", 0x80}};
+        broker.addDevice("3-0068", std::move(pmbus));
+
+        std::vector<uint64_t> first, second;
+        auto sub1 = broker.subscribe(
+            "3-0068", "status0", Type::Debug,
+            [&first](const Reading& r) { first.emplace_back(r.value); });
+        auto sub2 = broker.subscribe(
+            "3-0068", "status0", Type::Debug,
+            [&second](const Reading& r) { second.emplace_back(r.value); });
+        auto sub3 = broker.subscribe("3-0068", "status0_vout", Type::Debug);
+        EXPECT_EQ(broker.getRegisterCount(), 2);
+
+        broker.poll();
+        EXPECT_EQ(fake.snapshotCount, 1);
+        EXPECT_EQ(fake.lastNames,
+                  (std::vector<std::string>{"status0", "status0_vout"}));
+        EXPECT_EQ(first, std::vector<uint64_t>{0x12});
+        EXPECT_EQ(second, std::vector<uint64_t>{0x12});
+
+        auto reading = broker.getReading("3-0068", "status0_vout", Type::Debug);
+        ASSERT_TRUE(reading.has_value());
+        EXPECT_TRUE(reading->valid);
+        EXPECT_EQ(reading->value, 0x80);
+    }
+
+    // One snapshot per path type
+    {
+        PMBusBroker broker;
+        auto pmbus = std::make_unique<FakePMBus>();
+        FakePMBus& fake = *pmbus;
+        fake.values = {{"status0", 0x12}};
+        broker.addDevice("3-0068", std::move(pmbus));
+
+        auto sub1 = broker.subscribe("3-0068", "status0", Type::Debug);
+        auto sub2 = broker.subscribe("3-0068", "status0", Type::Hwmon);
+        broker.poll();
+        EXPECT_EQ(fake.snapshotCount, 2);
+    }
+
+    // Failed read
+    {
+        PMBusBroker broker;
+        broker.addDevice("3-0068", std::make_unique<FakePMBus>());
+
+        bool called{false};
+        auto sub = broker.subscribe("3-0068", "status0", Type::Debug,
+                                    [&called](const Reading& r) {
+                                        called = true;
+                                        EXPECT_FALSE(r.valid);
+                                        EXPECT_EQ(r.value, 0);
+                                    });
+        broker.poll();
+        EXPECT_TRUE(called);
+    }
+
+    // Snapshot throws an exception
+    {
+        PMBusBroker broker;
+        auto pmbus = std::make_unique<FakePMBus>();
+        pmbus->throwOnSnapshot = true;
+        broker.addDevice("3-0068", std::move(pmbus));
+        broker.addDevice("3-0069", std::make_unique<FakePMBus>());
+
+        auto sub1 = broker.subscribe("3-0068", "status0", Type::Debug);
+        auto sub2 = broker.subscribe("3-0069", "status0", Type::Debug);
+        EXPECT_NO_THROW(broker.poll());
+
+        auto reading = broker.getReading("3-0068", "status0", Type::Debug);
+        ASSERT_TRUE(reading.has_value());
+        EXPECT_FALSE(reading->valid);
+        EXPECT_TRUE(
+            broker.getReading("3-0069", "status0", Type::Debug).has_value());
+    }
+
+    // Callback ends its own subscription
+    {
+        PMBusBroker broker;
+        broker.addDevice("3-0068", std::make_unique<FakePMBus>());
+
+        PMBusBroker::Subscription sub;
+        int count{0};
+        sub = broker.subscribe("3-0068", "status0", Type::Debug,
+                               [&sub, &count](const Reading&) {
+                                   ++count;
+                                   sub.reset();
+                               });
+        broker.poll();
+        broker.poll();
+        EXPECT_EQ(count, 1);
+        EXPECT_EQ(broker.getRegisterCount(), 0);
+    }
+}
+
+TEST(PMBusBrokerTests, BatchPoll)
+{
+    PMBusBroker broker{true};
+    EXPECT_TRUE(broker.isBatched());
+    auto batchPMBus = std::make_unique<FakeBatchPMBus>();
+    FakeBatchPMBus& batchFake = *batchPMBus;
+    batchFake.values = {{"status0", 12}, {"status0_vout", 80}};
+    broker.addDevice("3-0068", std::move(batchPMBus));
+
+    // A device without batched reads is read with a snapshot
+    auto pmbus = std::make_unique<FakePMBus>();
+    FakePMBus& fake = *pmbus;
+    fake.values = {{"status0", 34}};
+    broker.addDevice("3-0069", std::move(pmbus));
+
+    std::vector<uint64_t> values;
+    PMBusBroker::Subscription sub1;
+    sub1 = broker.subscribe("3-0068", "status0", Type::Debug,
+                            [&values, &sub1](const Reading& r) {
+                                values.emplace_back(r.value);
+                                sub1.reset();
+                            });
+    auto sub2 = broker.subscribe("3-0068", "status0_vout", Type::Debug);
+    auto sub3 = broker.subscribe("3-0068", "status1", Type::Debug);
+    auto sub4 = broker.subscribe("3-0069", "status0", Type::Debug);
+
+    broker.poll();
+    EXPECT_EQ(batchFake.prepareCount, 1);
+    EXPECT_EQ(batchFake.snapshotCount, 0);
+    EXPECT_EQ(fake.snapshotCount, 1);
+    EXPECT_EQ(values, std::vector<uint64_t>{12});
+
+    auto reading = broker.getReading("3-0068", "status0_vout", Type::Debug);
+    ASSERT_TRUE(reading.has_value());
+    EXPECT_TRUE(reading->valid);
+    EXPECT_EQ(reading->value, 80);
+    reading = broker.getReading("3-0068", "status1", Type::Debug);
+    ASSERT_TRUE(reading.has_value());
+    EXPECT_FALSE(reading->valid);
+    reading = broker.getReading("3-0069", "status0", Type::Debug);
+    ASSERT_TRUE(reading.has_value());
+    EXPECT_EQ(reading->value, 34);
+
+    // The callback ended its subscription
+    EXPECT_EQ(broker.getRegisterCount(), 3);
+    broker.poll();
+    EXPECT_EQ(values, std::vector<uint64_t>{12});
+    EXPECT_EQ(batchFake.prepareCount, 2);
+}
+
+TEST(PMBusBrokerTests, Subscribe)
+{
+    PMBusBroker broker;
+    auto pmbus = std::make_unique<FakePMBus>();
+    FakePMBus& fake = *pmbus;
+    broker.addDevice("3-0068", std::move(pmbus));
+
+    // Unknown device
+    EXPECT_THROW(auto sub = broker.subscribe("3-0069", "status0", Type::Debug),
+                 std::invalid_argument);
+
+    // Register is not read after the last subscription ends
+    auto sub1 = broker.subscribe("3-0068", "status0", Type::Debug);
+    EXPECT_TRUE(sub1.isActive());
+    {
+        auto sub2 = broker.subscribe("3-0068", "status0", Type::Debug);
+        EXPECT_EQ(broker.getRegisterCount(), 1);
+    }
+    EXPECT_EQ(broker.getRegisterCount(), 1);
+
+    // Move the subscription
+    PMBusBroker::Subscription sub3{std::move(sub1)};
+    EXPECT_FALSE(sub1.isActive());
+    EXPECT_TRUE(sub3.isActive());
+    EXPECT_EQ(broker.getRegisterCount(), 1);
+
+    sub3.reset();
+    EXPECT_FALSE(sub3.isActive());
+    EXPECT_EQ(broker.getRegisterCount(), 0);
+    EXPECT_FALSE(broker.getReading("3-0068", "status0", Type::Debug));
+
+    broker.poll();
+    EXPECT_EQ(fake.snapshotCount, 0);
+}
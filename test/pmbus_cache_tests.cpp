@@ -0,0 +1,146 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "pmbus.hpp"
+#include "pmbus_cache.hpp"
+#include "test/fake_pmbus.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace phosphor::pmbus;
+using namespace std::chrono_literals;
+
+TEST(CachedPMBusTests, NoTTL)
+{
+    auto pmbus = std::make_unique<FakePMBus>();
+    FakePMBus& fake = *pmbus;
+    fake.values = {{"status0", 0x12}};
+    CachedPMBus cache{std::move(pmbus)};
+
+    EXPECT_EQ(&cache.getPMBus(), &fake);
+    EXPECT_EQ(cache.path(), fake.devicePath);
+    EXPECT_EQ(cache.read("status0", Type::Debug), 0x12);
+    EXPECT_EQ(cache.read("status0", Type::Debug), 0x12);
+    EXPECT_EQ(fake.readCount, 2);
+    EXPECT_EQ(cache.getHitCount(), 0);
+    EXPECT_EQ(cache.getMissCount(), 0);
+}
+
+TEST(CachedPMBusTests, TTL)
+{
+    auto pmbus = std::make_unique<FakePMBus>();
+    FakePMBus& fake = *pmbus;
+    fake.values = {{"in1_input", 12000}, {"status0", 0x12}};
+    CachedPMBus cache{std::move(pmbus), {{{Type::Hwmon, "in1_input"}, 50ms}}};
+
+    // read() and tryRead() share the value
+    EXPECT_EQ(cache.read("in1_input", Type::Hwmon), 12000);
+    fake.values["in1_input"] = 11000;
+    EXPECT_EQ(cache.read("in1_input", Type::Hwmon), 12000);
+    EXPECT_EQ(cache.tryRead("in1_input", Type::Hwmon).value, 12000);
+    EXPECT_EQ(fake.readCount, 1);
+    EXPECT_EQ(cache.getHitCount(), 2);
+    EXPECT_EQ(cache.getMissCount(), 1);
+
+    // Strings are cached separately
+    EXPECT_EQ(cache.readString("in1_input", Type::Hwmon), "11000");
+    EXPECT_EQ(fake.readCount, 2);
+
+    // The TTL is per path type and name
+    EXPECT_EQ(cache.read("in1_input", Type::Debug), 11000);
+    EXPECT_EQ(fake.readCount, 3);
+
+    // Expired
+    std::this_thread::sleep_for(60ms);
+    EXPECT_EQ(cache.read("in1_input", Type::Hwmon), 11000);
+    EXPECT_EQ(fake.readCount, 4);
+    EXPECT_EQ(cache.getMissCount(), 3);
+}
+
+TEST(CachedPMBusTests, FailedRead)
+{
+    auto pmbus = std::make_unique<FakePMBus>();
+    FakePMBus& fake = *pmbus;
+    CachedPMBus cache{std::move(pmbus), {{{Type::Hwmon, "in1_input"}, 10s}}};
+
+    // Failures are not cached
+    EXPECT_THROW(cache.read("in1_input", Type::Hwmon), std::runtime_error);
+    EXPECT_FALSE(cache.tryRead("in1_input", Type::Hwmon));
+    fake.values = {{"in1_input", 12000}};
+    EXPECT_EQ(cache.read("in1_input", Type::Hwmon), 12000);
+    EXPECT_EQ(fake.readCount, 3);
+    EXPECT_EQ(cache.getHitCount(), 0);
+}
+
+TEST(CachedPMBusTests, Invalidate)
+{
+    auto pmbus = std::make_unique<FakePMBus>();
+    FakePMBus& fake = *pmbus;
+    fake.values = {{"in1_input", 12000}};
+    CachedPMBus cache{std::move(pmbus), {{{Type::Hwmon, "in1_input"}, 10s}}};
+
+    EXPECT_EQ(cache.read("in1_input", Type::Hwmon), 12000);
+    std::vector<uint8_t> data{0x15};
+    cache.writeBinary("on_off_config", data, Type::Debug);
+    EXPECT_EQ(cache.read("in1_input", Type::Hwmon), 12000);
+    cache.findHwmonDir();
+    EXPECT_EQ(cache.read("in1_input", Type::Hwmon), 12000);
+    cache.clearStringCache();
+    EXPECT_EQ(cache.read("in1_input", Type::Hwmon), 12000);
+    EXPECT_EQ(fake.readCount, 4);
+    EXPECT_EQ(cache.read("in1_input", Type::Hwmon), 12000);
+    EXPECT_EQ(fake.readCount, 4);
+}
+
+TEST(CachedPMBusTests, InFlight)
+{
+    // A read of a register that is being read waits for its value
+    auto pmbus = std::make_unique<FakePMBus>();
+    FakePMBus& fake = *pmbus;
+    fake.values = {{"in1_input", 12000}};
+    fake.block = true;
+    CachedPMBus cache{std::move(pmbus), {{{Type::Hwmon, "in1_input"}, 10s}}};
+
+    uint64_t first{0};
+    uint64_t second{0};
+    std::thread reader1{
+        [&]() { first = cache.read("in1_input", Type::Hwmon); }};
+    while (!fake.entered)
+    {
+        std::this_thread::sleep_for(1ms);
+    }
+    std::thread reader2{
+        [&]() { second = cache.read("in1_input", Type::Hwmon); }};
+    std::this_thread::sleep_for(20ms);
+    fake.block = false;
+    reader1.join();
+    reader2.join();
+
+    EXPECT_EQ(first, 12000);
+    EXPECT_EQ(second, 12000);
+    EXPECT_EQ(fake.readCount, 1);
+    EXPECT_EQ(cache.getHitCount(), 1);
+    EXPECT_EQ(cache.getMissCount(), 1);
+}
@@ -0,0 +1,166 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "pmbus.hpp"
+#include "pmbus_scheduler.hpp"
+#include "test/fake_pmbus.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace phosphor::pmbus;
+
+namespace
+{
+
+/**
+ * Waits until the number of waiting requests of a class reaches a count.
+ */
+void waitFor(const PMBusScheduler& scheduler, Priority priority, size_t count)
+{
+    while (scheduler.getWaitingCount(priority) != count)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+} // namespace
+
+TEST(PMBusSchedulerTests, Acquire)
+{
+    PMBusScheduler scheduler;
+    {
+        auto grant = scheduler.acquire(Priority::critical);
+    }
+    {
+        auto grant = scheduler.acquire(Priority::bulk);
+    }
+    {
+        auto grant = scheduler.acquire(Priority::critical);
+    }
+    EXPECT_EQ(scheduler.getGrantCount(Priority::critical), 2);
+    EXPECT_EQ(scheduler.getGrantCount(Priority::bulk), 1);
+    EXPECT_EQ(scheduler.getWaitingCount(Priority::critical), 0);
+    EXPECT_EQ(scheduler.getWaitingCount(Priority::bulk), 0);
+}
+
+TEST(PMBusSchedulerTests, WeightedOrder)
+{
+    // With a weight of 2, a waiting bulk request runs after two critical
+    // requests, and the rest of the critical requests run after it
+    PMBusScheduler scheduler{2};
+    std::mutex orderMutex;
+    std::vector<Priority> order;
+    auto run = [&](Priority priority) {
+        auto grant = scheduler.acquire(priority);
+        std::lock_guard lock{orderMutex};
+        order.push_back(priority);
+    };
+
+    std::vector<std::thread> threads;
+    {
+        auto grant = scheduler.acquire(Priority::critical);
+        threads.emplace_back(run, Priority::bulk);
+        waitFor(scheduler, Priority::bulk, 1);
+        for (int i = 0; i < 3; ++i)
+        {
+            threads.emplace_back(run, Priority::critical);
+        }
+        waitFor(scheduler, Priority::critical, 3);
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    EXPECT_EQ(order,
+              (std::vector<Priority>{Priority::critical, Priority::bulk,
+                                     Priority::critical, Priority::critical}));
+}
+
+TEST(PMBusSchedulerTests, CriticalBeforeBulk)
+{
+    // Critical requests run before the bulk ones that waited as long
+    PMBusScheduler scheduler;
+    std::mutex orderMutex;
+    std::vector<Priority> order;
+    auto run = [&](Priority priority) {
+        auto grant = scheduler.acquire(priority);
+        std::lock_guard lock{orderMutex};
+        order.push_back(priority);
+    };
+
+    std::vector<std::thread> threads;
+    {
+        auto grant = scheduler.acquire(Priority::bulk);
+        for (int i = 0; i < 2; ++i)
+        {
+            threads.emplace_back(run, Priority::bulk);
+        }
+        waitFor(scheduler, Priority::bulk, 2);
+        threads.emplace_back(run, Priority::critical);
+        waitFor(scheduler, Priority::critical, 1);
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    ASSERT_EQ(order.size(), 3);
+    EXPECT_EQ(order[0], Priority::critical);
+}
+
+TEST(PMBusSchedulerTests, ScheduledPMBus)
+{
+    auto fake = std::make_shared<FakePMBus>();
+    fake->values = {{"status0", 0x12}, {"status0_vout", 0x80}};
+    auto scheduler = std::make_shared<PMBusScheduler>();
+    ScheduledPMBus critical{fake, scheduler, Priority::critical};
+    ScheduledPMBus bulk{fake, scheduler, Priority::bulk};
+
+    EXPECT_EQ(&critical.getPMBus(), fake.get());
+    EXPECT_EQ(critical.path(), fake->devicePath);
+    EXPECT_EQ(critical.read("status0", Type::Debug), 0x12);
+    EXPECT_THROW(critical.read("status1", Type::Debug), std::runtime_error);
+    EXPECT_EQ(bulk.tryRead("status0_vout", Type::Debug).value, 0x80);
+    EXPECT_EQ(scheduler->getGrantCount(Priority::critical), 2);
+    EXPECT_EQ(scheduler->getGrantCount(Priority::bulk), 1);
+
+    // A critical snapshot is read with one grant
+    auto snapshot =
+        critical.readStatusSnapshot({"status0", "status0_vout"}, Type::Debug);
+    EXPECT_EQ(fake->snapshotCount, 1);
+    EXPECT_EQ(scheduler->getGrantCount(Priority::critical), 3);
+    EXPECT_EQ(snapshot.values, (std::vector<uint64_t>{0x12, 0x80}));
+    EXPECT_TRUE(snapshot.isValid());
+
+    // A bulk snapshot is read one register per grant
+    snapshot = bulk.readStatusSnapshot({"status0", "status1", "status0_vout"},
+                                       Type::Debug);
+    EXPECT_EQ(fake->snapshotCount, 4);
+    EXPECT_EQ(scheduler->getGrantCount(Priority::bulk), 4);
+    EXPECT_EQ(snapshot.values, (std::vector<uint64_t>{0x12, 0, 0x80}));
+    EXPECT_EQ(snapshot.valid, (std::vector<bool>{true, false, true}));
+    EXPECT_FALSE(snapshot.isValid());
+}
@@ -0,0 +1,184 @@
+#include "bus_trace.hpp"
+#include "pmbus.hpp"
+#include "pmbus_trace.hpp"
+#include "test/fake_pmbus.hpp"
+
+#include <stdlib.h> // for mkdtemp()
+
+#include <cerrno>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace phosphor::pmbus;
+
+/**
+ * Test fixture that creates a temporary directory for the trace file.
+ */
+class PMBusTraceTests : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        char dirTemplate[] = "/tmp/pmbus_trace_tests-XXXXXX";
+        root = mkdtemp(dirTemplate);
+        path = root / "trace";
+    }
+
+    void TearDown() override
+    {
+        i2c::stopTrace();
+        fs::remove_all(root);
+    }
+
+    fs::path root;
+    fs::path path;
+};
+
+TEST_F(PMBusTraceTests, RoundTrip)
+{
+    auto pmbus = std::make_unique<FakePMBus>();
+    FakePMBus& fake = *pmbus;
+    fake.values = {{"status0", 0x12}, {"in1_input", 12000}};
+    TracedPMBus traced{std::move(pmbus), 3, 0x68};
+    EXPECT_EQ(&traced.getPMBus(), &fake);
+    EXPECT_EQ(traced.path(), fake.devicePath);
+
+    i2c::startTrace(path);
+    EXPECT_TRUE(i2c::isTracing());
+    EXPECT_EQ(traced.read("status0", Type::Debug), 0x12);
+    fake.values["status0"] = 0x34;
+    EXPECT_EQ(traced.read("status0", Type::Debug), 0x34);
+    EXPECT_EQ(traced.readString("in1_input", Type::Hwmon), "12000");
+    EXPECT_EQ(traced.tryRead("missing", Type::Hwmon).error, EIO);
+    EXPECT_THROW(traced.read("missing", Type::Debug), std::runtime_error);
+    std::vector<uint8_t> data{0x15};
+    traced.writeBinary("on_off_config", data, Type::Debug);
+    EXPECT_EQ(fake.written["on_off_config"], data);
+    i2c::stopTrace();
+    EXPECT_FALSE(i2c::isTracing());
+
+    // Not recorded once the trace is stopped
+    EXPECT_EQ(traced.read("status0", Type::Debug), 0x34);
+
+    std::vector<i2c::TraceEntry> entries = i2c::readTrace(path);
+    ASSERT_EQ(entries.size(), 6);
+    EXPECT_EQ(entries[0].name, "status0");
+    EXPECT_EQ(entries[0].record.op,
+              static_cast<uint8_t>(i2c::TraceOp::pmbusRead));
+    EXPECT_EQ(entries[0].record.pathType, static_cast<uint8_t>(Type::Debug));
+    EXPECT_EQ(entries[0].record.busId, 3);
+    EXPECT_EQ(entries[0].record.addr, 0x68);
+    EXPECT_EQ(entries[0].record.result, 0);
+    EXPECT_EQ(entries[0].data.size(), sizeof(uint64_t));
+    EXPECT_EQ(entries[0].data[0], 0x12);
+    EXPECT_EQ(entries[3].record.result, EIO);
+    EXPECT_TRUE(entries[3].data.empty());
+    EXPECT_EQ(entries[5].data, data);
+    EXPECT_LE(entries[0].record.time, entries[1].record.time);
+
+    auto devices = ReplayPMBus::load(path, true, false);
+    ASSERT_EQ(devices.size(), 1);
+    ReplayPMBus& replay = *devices[0];
+    EXPECT_EQ(replay.getBus(), 3);
+    EXPECT_EQ(replay.getAddress(), 0x68);
+    EXPECT_EQ(replay.path(), fake.devicePath);
+
+    // Each file returns its values in order, and starts over at the end
+    EXPECT_EQ(replay.readString("in1_input", Type::Hwmon), "12000");
+    EXPECT_EQ(replay.read("status0", Type::Debug), 0x12);
+    EXPECT_EQ(replay.read("status0", Type::Debug), 0x34);
+    EXPECT_EQ(replay.tryRead("status0", Type::Debug).value, 0x12);
+
+    // Failures are replayed
+    EXPECT_EQ(replay.tryRead("missing", Type::Hwmon).error, EIO);
+    EXPECT_ANY_THROW(replay.read("missing", Type::Debug));
+    EXPECT_NO_THROW(replay.writeBinary("on_off_config", data, Type::Debug));
+    EXPECT_EQ(replay.getMissCount(), 0);
+
+    // Files that were not recorded, including with another path type
+    EXPECT_EQ(replay.tryRead("status0", Type::Hwmon).error, ENODATA);
+    EXPECT_EQ(replay.tryReadString("mfr_id", Type::HwmonDeviceDebug).error,
+              ENODATA);
+    EXPECT_EQ(replay.readBlock("read_ein", Type::Debug, data), 0);
+    EXPECT_EQ(replay.getMissCount(), 3);
+}
+
+TEST_F(PMBusTraceTests, Snapshot)
+{
+    auto pmbus = std::make_unique<FakePMBus>();
+    pmbus->values = {{"status0", 0x12}, {"status0_vout", 0x80}};
+    TracedPMBus traced{std::move(pmbus), 4, 0x58};
+
+    i2c::startTrace(path);
+    std::vector<std::string> names{"status0", "status0_vout", "status0_iout"};
+    StatusSnapshot snapshot = traced.readStatusSnapshot(names, Type::Debug);
+    i2c::stopTrace();
+    EXPECT_FALSE(snapshot.isValid());
+
+    // The registers are recorded as separate reads
+    auto devices = ReplayPMBus::load(path, false, false);
+    ASSERT_EQ(devices.size(), 1);
+    snapshot = devices[0]->readStatusSnapshot(names, Type::Debug);
+    ASSERT_EQ(snapshot.values.size(), 3);
+    EXPECT_EQ(snapshot.values[0], 0x12);
+    EXPECT_EQ(snapshot.values[1], 0x80);
+    EXPECT_TRUE(snapshot.valid[0]);
+    EXPECT_TRUE(snapshot.valid[1]);
+    EXPECT_FALSE(snapshot.valid[2]);
+
+    // Without looping, each value is replayed once
+    EXPECT_EQ(devices[0]->tryRead("status0", Type::Debug).error, ENODATA);
+    EXPECT_EQ(devices[0]->getMissCount(), 1);
+}
+
+TEST_F(PMBusTraceTests, Devices)
+{
+    i2c::TraceEntry first{};
+    first.record.op = static_cast<uint8_t>(i2c::TraceOp::pmbusRead);
+    first.record.busId = 3;
+    first.record.addr = 0x68;
+    first.record.pathType = static_cast<uint8_t>(Type::Hwmon);
+    first.name = "in1_input";
+    first.data = {0x01};
+
+    i2c::TraceEntry other = first;
+    other.record.addr = 0x69;
+    other.data = {0x02};
+
+    // An I2C transaction of the same device is not a PMBus access
+    i2c::TraceEntry transaction = first;
+    transaction.record.op = static_cast<uint8_t>(i2c::TraceOp::readWordData);
+    transaction.name.clear();
+
+    std::vector<i2c::TraceEntry> entries{other, transaction, first};
+    ReplayPMBus replay{3, 0x68, entries, true, false};
+    EXPECT_EQ(replay.read("in1_input", Type::Hwmon), 0x01);
+    EXPECT_EQ(replay.read("in1_input", Type::Hwmon), 0x01);
+    EXPECT_EQ(replay.insertPageNum("statusP_vout", 1), "status1_vout");
+
+    {
+        i2c::TraceWriter writer{path};
+        for (const i2c::TraceEntry& entry : entries)
+        {
+            writer.record(entry.record, entry.name, entry.data);
+        }
+    }
+    auto devices = ReplayPMBus::load(path, true, false);
+    ASSERT_EQ(devices.size(), 2);
+    EXPECT_EQ(devices[0]->getAddress(), 0x68);
+    EXPECT_EQ(devices[1]->getAddress(), 0x69);
+    EXPECT_EQ(devices[1]->read("in1_input", Type::Hwmon), 0x02);
+}
+
+TEST_F(PMBusTraceTests, NotATrace)
+{
+    EXPECT_THROW(i2c::readTrace(root / "missing"), std::runtime_error);
+    EXPECT_THROW(ReplayPMBus::load(root), std::runtime_error);
+}
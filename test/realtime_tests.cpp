@@ -0,0 +1,154 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "file_descriptor.hpp"
+#include "realtime.hpp"
+
+#include <sched.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace phosphor::power::util;
+
+TEST(RealtimeTests, ParseCPUList)
+{
+    EXPECT_EQ(parseCPUList("0"), (std::vector<int>{0}));
+    EXPECT_EQ(parseCPUList("1,3"), (std::vector<int>{1, 3}));
+    EXPECT_EQ(parseCPUList("0,2-4"), (std::vector<int>{0, 2, 3, 4}));
+    EXPECT_EQ(parseCPUList("5-5"), (std::vector<int>{5}));
+
+    // Invalid lists
+    EXPECT_THROW(parseCPUList(""), std::invalid_argument);
+    EXPECT_THROW(parseCPUList("0,"), std::invalid_argument);
+    EXPECT_THROW(parseCPUList("a"), std::invalid_argument);
+    EXPECT_THROW(parseCPUList("1x"), std::invalid_argument);
+    EXPECT_THROW(parseCPUList("-1"), std::invalid_argument);
+    EXPECT_THROW(parseCPUList("3-1"), std::invalid_argument);
+    EXPECT_THROW(parseCPUList("1-"), std::invalid_argument);
+    EXPECT_THROW(parseCPUList("100000"), std::invalid_argument);
+}
+
+TEST(RealtimeTests, IsThreadRealtime)
+{
+    RealtimeOptions options{};
+    EXPECT_FALSE(options.isThreadRealtime());
+
+    // Locking memory does not change the threads
+    options.lockMemory = true;
+    EXPECT_FALSE(options.isThreadRealtime());
+
+    options.priority = 50;
+    EXPECT_TRUE(options.isThreadRealtime());
+
+    options.priority = 0;
+    options.cpus = {0};
+    EXPECT_TRUE(options.isThreadRealtime());
+}
+
+TEST(RealtimeTests, SetThreadRealtime)
+{
+    // Options that are not set do nothing
+    EXPECT_NO_THROW(setThreadRealtime(RealtimeOptions{}));
+    EXPECT_NO_THROW(lockProcessMemory(RealtimeOptions{}));
+
+    // Set the affinity of a new thread to the CPU it runs on
+    std::thread thread{[]() {
+        int cpu = sched_getcpu();
+        ASSERT_GE(cpu, 0);
+        RealtimeOptions options{};
+        options.cpus = {cpu};
+        EXPECT_NO_THROW(setThreadRealtime(options));
+        cpu_set_t set;
+        ASSERT_EQ(sched_getaffinity(0, sizeof(set), &set), 0);
+        EXPECT_EQ(CPU_COUNT(&set), 1);
+        EXPECT_TRUE(CPU_ISSET(cpu, &set));
+    }};
+    thread.join();
+}
+
+TEST(RealtimeTests, FaultPathThread)
+{
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+    FileDescriptor readFD{fds[0]};
+    FileDescriptor writeFD{fds[1]};
+
+    std::atomic<int> count{0};
+    {
+        FaultPathThread thread{RealtimeOptions{}};
+        thread.watch(readFD(), [&readFD, &count]() {
+            char byte{};
+            if (read(readFD(), &byte, 1) == 1)
+            {
+                ++count;
+            }
+        });
+        thread.start();
+
+        // Handler is called on the thread for each write
+        for (int i = 1; i <= 3; ++i)
+        {
+            char byte{'x'};
+            ASSERT_EQ(write(writeFD(), &byte, 1), 1);
+            auto deadline =
+                std::chrono::steady_clock::now() + std::chrono::seconds{5};
+            while ((count < i) && (std::chrono::steady_clock::now() < deadline))
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds{1});
+            }
+            EXPECT_EQ(count, i);
+        }
+
+        // Stopping twice does nothing
+        thread.stop();
+        thread.stop();
+    }
+
+    // Handler exceptions do not stop the thread, and the thread is stopped by
+    // the destructor
+    {
+        FaultPathThread thread{RealtimeOptions{}};
+        thread.watch(readFD(), [&readFD, &count]() {
+            char byte{};
+            if (read(readFD(), &byte, 1) == 1)
+            {
+                ++count;
+            }
+            throw std::runtime_error{"error"};
+        });
+        thread.start();
+
+        for (int i = 4; i <= 5; ++i)
+        {
+            char byte{'x'};
+            ASSERT_EQ(write(writeFD(), &byte, 1), 1);
+            auto deadline =
+                std::chrono::steady_clock::now() + std::chrono::seconds{5};
+            while ((count < i) && (std::chrono::steady_clock::now() < deadline))
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds{1});
+            }
+            EXPECT_EQ(count, i);
+        }
+    }
+    EXPECT_EQ(count, 5);
+}
@@ -0,0 +1,236 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "sensor_telemetry.hpp"
+
+#include <fcntl.h>    // for O_* constants
+#include <sys/mman.h> // for shm_open() and shm_unlink()
+#include <unistd.h>   // for getpid()
+
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <exception>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include <gtest/gtest.h>
+
+using namespace phosphor::power::util::sensor_telemetry;
+
+/**
+ * Returns a shared memory segment name that is unique to this process.
+ *
+ * @param[in] suffix - Suffix that makes the name unique within this process
+ * @return Segment name
+ */
+std::string getSegmentName(const std::string& suffix)
+{
+    return "/sensor_telemetry_tests-" + std::to_string(getpid()) + '-' +
+           suffix;
+}
+
+TEST(SensorTelemetryTests, Writer)
+{
+    std::string name = getSegmentName("writer");
+
+    // Test where works: Segment created and deleted by destructor
+    {
+        Writer writer{name, 4};
+        Reader reader{name};
+        EXPECT_EQ(reader.getSensorCount(), 0);
+    }
+    EXPECT_THROW(Reader{name}, std::runtime_error);
+
+    // Test where works: Existing segment replaced
+    {
+        Writer writer{name, 4};
+        writer.addSensor("vdd_vout");
+        Writer newWriter{name, 4};
+        Reader reader{name};
+        EXPECT_EQ(reader.getSensorCount(), 0);
+    }
+}
+
+TEST(SensorTelemetryTests, AddSensor)
+{
+    std::string name = getSegmentName("add_sensor");
+    Writer writer{name, 2};
+    Reader reader{name};
+
+    // Test where new sensor added
+    EXPECT_EQ(writer.addSensor("vdd_vout"), 0);
+    EXPECT_EQ(writer.addSensor("vdd_iout"), 1);
+    EXPECT_EQ(reader.getSensorCount(), 2);
+
+    // Test where sensor already added
+    EXPECT_EQ(writer.addSensor("vdd_vout"), 0);
+    EXPECT_EQ(reader.getSensorCount(), 2);
+
+    // Test where segment full
+    EXPECT_EQ(writer.addSensor("vdd_temperature"), std::nullopt);
+    EXPECT_EQ(reader.getSensorCount(), 2);
+
+    // Test where sensor has no value yet
+    std::optional<Sample> sample = reader.read(1);
+    ASSERT_TRUE(sample.has_value());
+    EXPECT_EQ(sample->id, "vdd_iout");
+    EXPECT_EQ(sample->status, Status::unavailable);
+
+    // Test where ID is too long; truncated
+    {
+        std::string longName = getSegmentName("add_sensor_long");
+        Writer longWriter{longName, 1};
+        Reader longReader{longName};
+        EXPECT_EQ(longWriter.addSensor(std::string(100, 'x')), 0);
+        EXPECT_EQ(longReader.read(0)->id, std::string(maxIDLength, 'x'));
+    }
+}
+
+TEST(SensorTelemetryTests, Write)
+{
+    std::string name = getSegmentName("write");
+    Writer writer{name, 4};
+    Reader reader{name};
+    std::size_t index = *writer.addSensor("vdd_vout");
+
+    // Test where value is valid
+    auto beforeTime = std::chrono::system_clock::now();
+    writer.write(index, 1.03, Status::ok);
+    std::optional<Sample> sample = reader.read(index);
+    ASSERT_TRUE(sample.has_value());
+    EXPECT_EQ(sample->id, "vdd_vout");
+    EXPECT_EQ(sample->value, 1.03);
+    EXPECT_EQ(sample->status, Status::ok);
+    EXPECT_GE(sample->timestamp + std::chrono::microseconds{1}, beforeTime);
+    EXPECT_LE(sample->timestamp, std::chrono::system_clock::now());
+
+    // Test where the time the value was read is specified.  The timestamp is
+    // the time it was read rather than written.
+    auto readTime = std::chrono::steady_clock::now() - std::chrono::seconds{2};
+    beforeTime = std::chrono::system_clock::now();
+    writer.write(index, 1.04, Status::ok, readTime);
+    sample = reader.read(index);
+    ASSERT_TRUE(sample.has_value());
+    EXPECT_EQ(sample->value, 1.04);
+    EXPECT_LE(sample->readTime, readTime);
+    EXPECT_GT(sample->readTime + std::chrono::microseconds{1}, readTime);
+    EXPECT_LE(sample->timestamp, beforeTime - std::chrono::milliseconds{1900});
+    EXPECT_GE(sample->timestamp, beforeTime - std::chrono::milliseconds{2100});
+
+    // Test where value could not be read
+    writer.write(index, std::nan(""), Status::error);
+    sample = reader.read(index);
+    ASSERT_TRUE(sample.has_value());
+    EXPECT_TRUE(std::isnan(sample->value));
+    EXPECT_EQ(sample->status, Status::error);
+}
+
+TEST(SensorTelemetryTests, WriteRemoved)
+{
+    std::string name = getSegmentName("write_removed");
+    Writer writer{name, 4};
+    Reader reader{name};
+    std::size_t index = *writer.addSensor("vdd_vout");
+    writer.write(index, 1.03, Status::ok);
+
+    writer.writeRemoved(index);
+    std::optional<Sample> sample = reader.read(index);
+    ASSERT_TRUE(sample.has_value());
+    EXPECT_TRUE(std::isnan(sample->value));
+    EXPECT_EQ(sample->status, Status::removed);
+}
+
+TEST(SensorTelemetryTests, Reader)
+{
+    std::string name = getSegmentName("reader");
+
+    // Test where fails: Segment does not exist
+    EXPECT_THROW(Reader{name}, std::runtime_error);
+
+    // Test where fails: Segment does not have the expected layout
+    {
+        int fd = shm_open(name.c_str(), O_RDWR | O_CREAT, 0644);
+        ASSERT_NE(fd, -1);
+        ASSERT_EQ(ftruncate(fd, getSegmentSize(1)), 0);
+        close(fd);
+        EXPECT_THROW(Reader{name}, std::runtime_error);
+        shm_unlink(name.c_str());
+    }
+
+    // Test where works: Reader can be moved
+    {
+        Writer writer{name, 4};
+        writer.write(*writer.addSensor("vdd_vout"), 1.03, Status::ok);
+        Reader reader{name};
+        Reader movedReader{std::move(reader)};
+        EXPECT_EQ(movedReader.getSensorCount(), 1);
+        EXPECT_EQ(movedReader.read(0)->value, 1.03);
+    }
+}
+
+TEST(SensorTelemetryTests, IsCurrent)
+{
+    std::string name = getSegmentName("is_current");
+    std::optional<Writer> writer{};
+    writer.emplace(name, 4);
+    Reader reader{name};
+
+    // Test where segment is current
+    EXPECT_TRUE(reader.isCurrent());
+
+    // Test where segment was replaced by a new writer
+    writer.reset();
+    writer.emplace(name, 4);
+    EXPECT_FALSE(reader.isCurrent());
+
+    // Test where segment was deleted
+    writer.reset();
+    EXPECT_FALSE(reader.isCurrent());
+}
+
+TEST(SensorTelemetryTests, ReadWhileWriting)
+{
+    std::string name = getSegmentName("read_while_writing");
+    Writer writer{name, 1};
+    Reader reader{name};
+    std::size_t index = *writer.addSensor("vdd_vout");
+    writer.write(index, 0.0, Status::ok);
+
+    // Write increasing values on another thread.  The reader must never see a
+    // value that is older than one it has already seen.
+    constexpr int writeCount{100000};
+    std::thread writerThread{[&writer, index]() {
+        for (int i = 1; i <= writeCount; ++i)
+        {
+            writer.write(index, static_cast<double>(i), Status::ok);
+        }
+    }};
+
+    double lastValue{0.0};
+    while (lastValue < writeCount)
+    {
+        std::optional<Sample> sample = reader.read(index);
+        if (sample)
+        {
+            EXPECT_GE(sample->value, lastValue);
+            EXPECT_EQ(sample->status, Status::ok);
+            lastValue = sample->value;
+        }
+    }
+    writerThread.join();
+}
@@ -0,0 +1,128 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "startup_times.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace phosphor::power::util;
+using std::chrono::microseconds;
+using std::chrono::milliseconds;
+using Phase = StartupTimes::Phase;
+
+TEST(StartupTimesTests, Complete)
+{
+    auto start = StartupTimes::Clock::now();
+    StartupTimes times{start};
+    EXPECT_FALSE(times.isComplete(Phase::configLoad));
+    EXPECT_FALSE(times.getElapsed(Phase::configLoad));
+
+    times.complete(Phase::configLoad, start + milliseconds{120});
+    EXPECT_TRUE(times.isComplete(Phase::configLoad));
+    EXPECT_EQ(times.getElapsed(Phase::configLoad), milliseconds{120});
+    EXPECT_FALSE(times.isComplete(Phase::hardwareDiscovery));
+
+    // Only the first completion is recorded
+    times.complete(Phase::configLoad, start + milliseconds{500});
+    EXPECT_EQ(times.getElapsed(Phase::configLoad), milliseconds{120});
+
+    // Skipped phases complete at the same time
+    times.complete(Phase::firstCycle, start + milliseconds{300});
+    EXPECT_EQ(times.getElapsed(Phase::hardwareDiscovery), milliseconds{300});
+    EXPECT_EQ(times.getElapsed(Phase::firstCycle), milliseconds{300});
+}
+
+TEST(StartupTimesTests, GetName)
+{
+    EXPECT_STREQ(StartupTimes::getName(Phase::configLoad), "ConfigLoad");
+    EXPECT_STREQ(StartupTimes::getName(Phase::hardwareDiscovery),
+                 "HardwareDiscovery");
+    EXPECT_STREQ(StartupTimes::getName(Phase::firstCycle), "FirstCycle");
+}
+
+TEST(StartupTimesTests, GetValues)
+{
+    auto start = StartupTimes::Clock::now();
+    StartupTimes times{start};
+    EXPECT_TRUE(times.getValues().empty());
+
+    times.complete(Phase::hardwareDiscovery, start + microseconds{2500});
+    times.setReady(start + microseconds{3000});
+    std::map<std::string, uint64_t> expected{{"ConfigLoadUs", 2500},
+                                             {"HardwareDiscoveryUs", 2500},
+                                             {"ReadyUs", 3000}};
+    EXPECT_EQ(times.getValues(), expected);
+}
+
+TEST(StartupTimesTests, NotifyReady)
+{
+    StartupTimes first{};
+    StartupTimes second{};
+    std::vector<std::pair<std::string, StartupTimes*>> startups{
+        {"first", &first}, {"second", &second}};
+    notifyReady(startups);
+    first.setReady();
+    second.setReady();
+    EXPECT_TRUE(first.isReady());
+    EXPECT_TRUE(second.isReady());
+
+    // No startups
+    notifyReady({});
+}
+
+TEST(StartupTimesTests, SetReady)
+{
+    auto start = StartupTimes::Clock::now();
+    StartupTimes times{start};
+    int calls{0};
+    times.setReadyCallback([&calls]() { ++calls; });
+    EXPECT_FALSE(times.isReady());
+    EXPECT_FALSE(times.getReadyElapsed());
+
+    times.setReady(start + milliseconds{40});
+    EXPECT_TRUE(times.isReady());
+    EXPECT_EQ(times.getReadyElapsed(), milliseconds{40});
+    EXPECT_EQ(calls, 1);
+
+    // Only the first time is recorded
+    times.setReady(start + milliseconds{90});
+    EXPECT_EQ(times.getReadyElapsed(), milliseconds{40});
+    EXPECT_EQ(calls, 1);
+
+    // The callback is called right away if already ready
+    int lateCalls{0};
+    times.setReadyCallback([&lateCalls]() { ++lateCalls; });
+    EXPECT_EQ(lateCalls, 1);
+}
+
+TEST(StartupTimesTests, ToString)
+{
+    auto start = StartupTimes::Clock::now();
+    StartupTimes times{start};
+    EXPECT_EQ(times.toString(), "");
+
+    times.complete(Phase::configLoad, start + milliseconds{120});
+    times.complete(Phase::hardwareDiscovery, start + milliseconds{300});
+    times.setReady(start + milliseconds{301});
+    EXPECT_EQ(times.toString(),
+              "ConfigLoad: 120 ms, HardwareDiscovery: 300 ms, Ready: 301 ms");
+}
@@ -0,0 +1,94 @@
+#include "memfd_file.hpp"
+#include "state_handoff.hpp"
+
+#include <stdlib.h> // for unsetenv()
+
+#include <nlohmann/json.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace phosphor::power::util;
+
+TEST(StateHandoffTests, RoundTrip)
+{
+    nlohmann::json state{{"types", {"com.acme.Hardware.Chassis.Model.A"}},
+                         {"present", {{"/chassis/psu0", true}}}};
+    auto time = StateHandoff::Clock::now();
+    MemFDFile file = writeStateSnapshot("test", 3, state, time);
+    EXPECT_TRUE(file.isSealed());
+
+    std::optional<nlohmann::json> restored = readStateSnapshot(
+        file.getFileDescriptor(), 3, std::chrono::seconds{60}, time);
+    ASSERT_TRUE(restored);
+    EXPECT_EQ(*restored, state);
+
+    // The file can be read again, since it is not read from its position
+    restored = readStateSnapshot(file.getFileDescriptor(), 3,
+                                 std::chrono::seconds{60},
+                                 time + std::chrono::seconds{60});
+    ASSERT_TRUE(restored);
+    EXPECT_EQ(*restored, state);
+}
+
+TEST(StateHandoffTests, Ignored)
+{
+    auto time = StateHandoff::Clock::now();
+    nlohmann::json state{{"monitoring", true}};
+    MemFDFile file = writeStateSnapshot("test", 2, state, time);
+    int fd = file.getFileDescriptor();
+
+    // Another format version
+    EXPECT_FALSE(readStateSnapshot(fd, 1, std::chrono::seconds{60}, time));
+    EXPECT_FALSE(readStateSnapshot(fd, 3, std::chrono::seconds{60}, time));
+
+    // Too old
+    EXPECT_FALSE(readStateSnapshot(fd, 2, std::chrono::seconds{60},
+                                   time + std::chrono::seconds{61}));
+
+    // Saved later than the current time
+    EXPECT_FALSE(readStateSnapshot(fd, 2, std::chrono::seconds{60},
+                                   time - std::chrono::seconds{1}));
+}
+
+TEST(StateHandoffTests, NotASnapshot)
+{
+    auto time = StateHandoff::Clock::now();
+
+    // Empty file
+    MemFDFile empty{"empty"};
+    EXPECT_FALSE(readStateSnapshot(empty.getFileDescriptor(), 1,
+                                   std::chrono::seconds{60}, time));
+
+    // Not CBOR
+    MemFDFile text{"text"};
+    text.write(std::string{"not a snapshot"});
+    EXPECT_FALSE(readStateSnapshot(text.getFileDescriptor(), 1,
+                                   std::chrono::seconds{60}, time));
+
+    // CBOR without the snapshot fields, or with fields of the wrong type
+    MemFDFile other{"other"};
+    std::vector<uint8_t> data =
+        nlohmann::json::to_cbor(nlohmann::json{{"version", "1"}});
+    other.write(data);
+    EXPECT_FALSE(readStateSnapshot(other.getFileDescriptor(), 1,
+                                   std::chrono::seconds{60}, time));
+
+    // Closed file
+    EXPECT_FALSE(readStateSnapshot(-1, 1, std::chrono::seconds{60}, time));
+}
+
+TEST(StateHandoffTests, NotStartedBySystemd)
+{
+    unsetenv("NOTIFY_SOCKET");
+    StateHandoff handoff{"test", 1};
+    EXPECT_FALSE(handoff.take());
+    EXPECT_FALSE(handoff.save(nlohmann::json{{"monitoring", true}}));
+    EXPECT_NO_THROW(handoff.discard());
+    EXPECT_FALSE(handoff.take());
+}
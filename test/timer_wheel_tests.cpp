@@ -0,0 +1,157 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "timer_wheel.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace phosphor::power::util;
+
+TEST(TimerWheelTests, Add)
+{
+    // Invalid period and phase
+    {
+        TimerWheel wheel;
+        EXPECT_THROW(auto task = wheel.add(0, [] {}), std::invalid_argument);
+        EXPECT_THROW(auto task = wheel.add(4, [] {}, 4),
+                     std::invalid_argument);
+        EXPECT_EQ(wheel.getTaskCount(), 0);
+    }
+
+    // Tasks without a phase are spread across the ticks
+    {
+        TimerWheel wheel;
+        auto task1 = wheel.add(4, [] {});
+        auto task2 = wheel.add(4, [] {});
+        auto task3 = wheel.add(2, [] {});
+        auto task4 = wheel.add(4, [] {});
+        EXPECT_EQ(wheel.getPhase(task1), 0);
+        EXPECT_EQ(wheel.getPhase(task2), 1);
+
+        // Phase 0 and 2 of period 2 collide with task1; phase 1 with task2
+        EXPECT_EQ(wheel.getPhase(task3), 0);
+
+        // The least used phase of period 4 is now 3
+        EXPECT_EQ(wheel.getPhase(task4), 3);
+        EXPECT_EQ(wheel.getTaskCount(), 4);
+    }
+
+    // First run is on the next tick that matches the phase
+    {
+        TimerWheel wheel;
+        wheel.advance(5);
+        int count{0};
+        auto task = wheel.add(10, [&count] { ++count; }, 3);
+        EXPECT_EQ(wheel.getTicksUntilNext(), 8);
+        wheel.advance(7);
+        EXPECT_EQ(count, 0);
+        wheel.advance();
+        EXPECT_EQ(count, 1);
+        EXPECT_EQ(wheel.getTicksUntilNext(), 10);
+    }
+}
+
+TEST(TimerWheelTests, Advance)
+{
+    // Tasks run on the ticks matching their period and phase, including
+    // periods that span several levels of the wheel
+    {
+        TimerWheel wheel;
+        std::vector<uint64_t> short1, long1, long2;
+        auto task1 = wheel.add(
+            3, [&] { short1.emplace_back(wheel.getTick()); }, 1);
+        auto task2 = wheel.add(
+            100, [&] { long1.emplace_back(wheel.getTick()); }, 99);
+        auto task3 = wheel.add(
+            5000, [&] { long2.emplace_back(wheel.getTick()); }, 7);
+        wheel.advance(10007);
+
+        EXPECT_EQ(short1.size(), 3336);
+        for (auto tick : short1)
+        {
+            EXPECT_EQ(tick % 3, 1);
+        }
+        EXPECT_EQ(long1.size(), 100);
+        for (auto tick : long1)
+        {
+            EXPECT_EQ(tick % 100, 99);
+        }
+        EXPECT_EQ(long2, (std::vector<uint64_t>{7, 5007, 10007}));
+    }
+
+    // Period longer than the range of the wheel
+    {
+        TimerWheel wheel;
+        constexpr uint64_t period = 20'000'000;
+        std::vector<uint64_t> ticks;
+        auto task = wheel.add(
+            period, [&] { ticks.emplace_back(wheel.getTick()); }, 1);
+        wheel.advance(2 * period);
+        EXPECT_EQ(ticks, (std::vector<uint64_t>{1, period + 1}));
+    }
+
+    // Task removes itself and adds another task
+    {
+        TimerWheel wheel;
+        TimerWheel::Task task1, task2;
+        int count1{0}, count2{0};
+        task1 = wheel.add(2, [&] {
+            ++count1;
+            task1.reset();
+            task2 = wheel.add(1, [&count2] { ++count2; });
+        });
+        wheel.advance(10);
+        EXPECT_EQ(count1, 1);
+        EXPECT_FALSE(task1.isActive());
+        EXPECT_EQ(count2, 8);
+        EXPECT_EQ(wheel.getTaskCount(), 1);
+    }
+}
+
+TEST(TimerWheelTests, Task)
+{
+    TimerWheel wheel;
+    int count{0};
+    auto task1 = wheel.add(1, [&count] { ++count; });
+    EXPECT_TRUE(task1.isActive());
+
+    // Move the task
+    TimerWheel::Task task2{std::move(task1)};
+    EXPECT_FALSE(task1.isActive());
+    EXPECT_TRUE(task2.isActive());
+    EXPECT_FALSE(wheel.getPhase(task1));
+    wheel.advance(2);
+    EXPECT_EQ(count, 2);
+
+    // Removing the task stops it
+    task2.reset();
+    EXPECT_FALSE(task2.isActive());
+    EXPECT_EQ(wheel.getTaskCount(), 0);
+    EXPECT_FALSE(wheel.getTicksUntilNext());
+    wheel.advance(2);
+    EXPECT_EQ(count, 2);
+
+    // Destroying the task stops it
+    {
+        auto task3 = wheel.add(1, [&count] { ++count; });
+        EXPECT_EQ(wheel.getTaskCount(), 1);
+    }
+    EXPECT_EQ(wheel.getTaskCount(), 0);
+}
@@ -0,0 +1,83 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+// Test the tracepoints even if the tracing meson option is not enabled
+#ifndef POWER_TRACING
+#define POWER_TRACING
+#endif
+
+#include "trace.hpp"
+
+#include <stdlib.h> // for setenv()
+#include <unistd.h> // for getpid()
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+using namespace phosphor::power::trace;
+
+namespace
+{
+
+void traced(const std::string& device)
+{
+    POWER_TRACE_SCOPE("traced", device, "status0");
+}
+
+} // namespace
+
+TEST(TraceTests, Scope)
+{
+    std::string path = "/tmp/trace_tests_" + std::to_string(getpid()) + ".json";
+    ASSERT_EQ(setenv(traceFileVariable, path.c_str(), 1), 0);
+    Tracer& tracer = Tracer::get();
+    ASSERT_TRUE(tracer.isEnabled());
+
+    traced("3-0068");
+    std::thread thread{[] { traced("dev\"ice\\"); }};
+    thread.join();
+    fflush(nullptr);
+
+    std::ifstream file{path};
+    std::stringstream contents;
+    contents << file.rdbuf();
+    std::string text = contents.str();
+    std::filesystem::remove(path);
+
+    EXPECT_TRUE(text.starts_with("[\n{\"name\":\"traced\""));
+    EXPECT_NE(text.find("\"ph\":\"B\""), std::string::npos);
+    EXPECT_NE(text.find("\"ph\":\"E\""), std::string::npos);
+    EXPECT_NE(text.find("\"args\":{\"device\":\"3-0068\","
+                        "\"command\":\"status0\"}"),
+              std::string::npos);
+
+    // Special characters are escaped
+    EXPECT_NE(text.find("\"device\":\"dev\\\"ice\\\\\""), std::string::npos);
+
+    // Events are separated by commas
+    size_t events{0};
+    for (size_t pos = text.find('{'); pos != std::string::npos;
+         pos = text.find("\n{", pos + 1))
+    {
+        ++events;
+    }
+    EXPECT_EQ(events, 4);
+    EXPECT_EQ(text.find("}\n{"), std::string::npos);
+}
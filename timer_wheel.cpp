@@ -0,0 +1,194 @@
+/**
+ * Copyright © 2026 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "timer_wheel.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+namespace phosphor::power::util
+{
+
+/**
+ * Number of bits of the tick used by each level.
+ */
+constexpr unsigned int slotBits = std::countr_zero(TimerWheel::slotCount);
+
+/**
+ * Maximum number of phases compared when choosing the phase of a task.
+ */
+constexpr uint64_t maxPhaseCandidates{4096};
+
+TimerWheel::Task TimerWheel::add(uint64_t period, Callback callback,
+                                 std::optional<uint64_t> phase)
+{
+    if (period == 0)
+    {
+        throw std::invalid_argument{"Task period must not be 0"};
+    }
+    if (phase && (*phase >= period))
+    {
+        throw std::invalid_argument{"Task phase must be less than the period"};
+    }
+
+    uint64_t taskPhase = phase ? *phase : choosePhase(period);
+
+    // First tick after the current one that matches the phase
+    uint64_t next = tick + 1;
+    uint64_t expiry = next + (taskPhase + period - (next % period)) % period;
+
+    std::size_t id = nextID++;
+    tasks.emplace(id, TaskInfo{period, taskPhase, expiry, std::move(callback)});
+    insert(Entry{id, expiry});
+    return Task{this, id};
+}
+
+void TimerWheel::advance(uint64_t ticks)
+{
+    for (uint64_t i = 0; i < ticks; ++i)
+    {
+        ++tick;
+
+        // Move entries down from the higher levels whose slot boundary was
+        // reached, highest level first
+        for (std::size_t level = levelCount - 1; level > 0; --level)
+        {
+            uint64_t mask = (uint64_t{1} << (slotBits * level)) - 1;
+            if ((tick & mask) == 0)
+            {
+                cascade(level);
+            }
+        }
+
+        runTick();
+    }
+}
+
+std::optional<uint64_t> TimerWheel::getPhase(const Task& task) const
+{
+    if (task.wheel != this)
+    {
+        return std::nullopt;
+    }
+    auto it = tasks.find(task.id);
+    if (it == tasks.end())
+    {
+        return std::nullopt;
+    }
+    return it->second.phase;
+}
+
+std::optional<uint64_t> TimerWheel::getTicksUntilNext() const
+{
+    if (tasks.empty())
+    {
+        return std::nullopt;
+    }
+    uint64_t expiry = std::numeric_limits<uint64_t>::max();
+    for (const auto& [id, task] : tasks)
+    {
+        expiry = std::min(expiry, task.expiry);
+    }
+    return expiry - tick;
+}
+
+uint64_t TimerWheel::choosePhase(uint64_t period) const
+{
+    uint64_t bestPhase{0};
+    std::size_t bestCount = std::numeric_limits<std::size_t>::max();
+    uint64_t candidates = std::min(period, maxPhaseCandidates);
+    for (uint64_t phase = 0; (phase < candidates) && (bestCount > 0); ++phase)
+    {
+        std::size_t count{0};
+        for (const auto& [id, task] : tasks)
+        {
+            uint64_t divisor = std::gcd(period, task.period);
+            if ((phase % divisor) == (task.phase % divisor))
+            {
+                ++count;
+            }
+        }
+        if (count < bestCount)
+        {
+            bestPhase = phase;
+            bestCount = count;
+        }
+    }
+    return bestPhase;
+}
+
+void TimerWheel::cascade(std::size_t level)
+{
+    std::size_t slot =
+        (tick >> (slotBits * level)) & (uint64_t{slotCount} - 1);
+    std::vector<Entry> entries;
+    entries.swap(levels[level][slot]);
+    for (const auto& entry : entries)
+    {
+        insert(entry);
+    }
+}
+
+void TimerWheel::insert(const Entry& entry)
+{
+    // Use the lowest level whose range contains the expiry tick.  Entries
+    // beyond the highest level are placed again when their slot is reached.
+    uint64_t delta = entry.expiry - tick;
+    std::size_t level{0};
+    while ((level < levelCount - 1) &&
+           (delta >= (uint64_t{1} << (slotBits * (level + 1)))))
+    {
+        ++level;
+    }
+    std::size_t slot =
+        (entry.expiry >> (slotBits * level)) & (uint64_t{slotCount} - 1);
+    levels[level][slot].emplace_back(entry);
+}
+
+void TimerWheel::runTick()
+{
+    std::vector<Entry> entries;
+    entries.swap(levels[0][tick & (uint64_t{slotCount} - 1)]);
+    for (const auto& entry : entries)
+    {
+        // Discard the entries of removed tasks
+        auto it = tasks.find(entry.id);
+        if ((it == tasks.end()) || (it->second.expiry != entry.expiry))
+        {
+            continue;
+        }
+        if (entry.expiry != tick)
+        {
+            insert(entry);
+            continue;
+        }
+
+        // Schedule the next run before calling the task, so the callback
+        // may remove the task.  The callback is copied for the same reason.
+        TaskInfo& task = it->second;
+        task.expiry += task.period;
+        insert(Entry{entry.id, task.expiry});
+        Callback callback = task.callback;
+        if (callback)
+        {
+            callback();
+        }
+    }
+}
+
+} // namespace phosphor::power::util
@@ -0,0 +1,310 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace phosphor::power::util
+{
+
+/**
+ * @class TimerWheel
+ *
+ * Schedules periodic tasks using a hierarchical timer wheel.
+ *
+ * Time is measured in ticks.  Each task runs on the ticks where
+ * (tick % period) == phase.  If a task is added without a phase, the phase
+ * with the fewest other tasks on the same ticks is chosen, so tasks are
+ * spread across the ticks instead of all running on the same one.
+ *
+ * The wheel has levelCount levels of slotCount slots.  A slot of level N
+ * covers slotCount^N ticks.  Tasks that are due soon are in level 0; tasks
+ * that are due later are moved down a level each time the wheel reaches
+ * their slot.  Adding a task and running its tick are both constant time.
+ *
+ * The wheel does not measure time.  Call advance() when ticks elapse; see
+ * PeriodicScheduler for a wheel driven by the event loop.
+ */
+class TimerWheel
+{
+  public:
+    /**
+     * Called each time a task is due.
+     */
+    using Callback = std::function<void()>;
+
+    /**
+     * Number of slots in each level.  Must be a power of two.
+     */
+    static constexpr std::size_t slotCount{64};
+
+    /**
+     * Number of levels.  With 64 slots, tasks due within 64^4 ticks are
+     * placed directly; later ones are placed again when they are reached.
+     */
+    static constexpr std::size_t levelCount{4};
+
+    /**
+     * @class Task
+     *
+     * Keeps a task scheduled.  The task is removed when this object is
+     * destroyed.  Must not outlive the wheel.
+     */
+    class Task
+    {
+      public:
+        Task() = default;
+        Task(const Task&) = delete;
+        Task& operator=(const Task&) = delete;
+
+        Task(Task&& other) noexcept :
+            wheel{std::exchange(other.wheel, nullptr)}, id{other.id}
+        {}
+
+        Task& operator=(Task&& other) noexcept
+        {
+            if (this != &other)
+            {
+                reset();
+                wheel = std::exchange(other.wheel, nullptr);
+                id = other.id;
+            }
+            return *this;
+        }
+
+        ~Task()
+        {
+            reset();
+        }
+
+        /**
+         * Returns whether the task is scheduled.
+         *
+         * @return bool - true if scheduled, false otherwise
+         */
+        bool isActive() const
+        {
+            return wheel != nullptr;
+        }
+
+        /**
+         * Removes the task.  Does nothing if it is not scheduled.
+         *
+         * May be called from the task's own callback.
+         */
+        void reset()
+        {
+            if (wheel != nullptr)
+            {
+                wheel->remove(id);
+                wheel = nullptr;
+            }
+        }
+
+      private:
+        friend class TimerWheel;
+
+        /**
+         * Constructor
+         *
+         * @param[in] wheel - the wheel
+         * @param[in] id - the task ID
+         */
+        Task(TimerWheel* wheel, std::size_t id) : wheel{wheel}, id{id}
+        {}
+
+        /**
+         * The wheel, or nullptr if not scheduled.
+         */
+        TimerWheel* wheel{nullptr};
+
+        /**
+         * The task ID.
+         */
+        std::size_t id{0};
+    };
+
+    TimerWheel() = default;
+    ~TimerWheel() = default;
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+    TimerWheel(TimerWheel&&) = delete;
+    TimerWheel& operator=(TimerWheel&&) = delete;
+
+    /**
+     * Adds a periodic task.
+     *
+     * The task first runs on the next tick that matches its phase.
+     *
+     * Throws std::invalid_argument if the period is 0 or the phase is not
+     * less than the period.
+     *
+     * @param[in] period - the number of ticks between runs
+     * @param[in] callback - called each time the task is due
+     * @param[in] phase - the tick within the period to run on; if not
+     *                    specified, the least used phase is chosen
+     *
+     * @return Task - the task
+     */
+    [[nodiscard]] Task add(uint64_t period, Callback callback,
+                           std::optional<uint64_t> phase = std::nullopt);
+
+    /**
+     * Advances the wheel, running the tasks that are due on each tick.
+     *
+     * Callbacks may add and remove tasks.
+     *
+     * @param[in] ticks - the number of ticks that elapsed
+     */
+    void advance(uint64_t ticks = 1);
+
+    /**
+     * Returns the phase of a task.
+     *
+     * @param[in] task - the task
+     *
+     * @return optional<uint64_t> - the phase, or no value if the task is
+     *                               not scheduled on this wheel
+     */
+    std::optional<uint64_t> getPhase(const Task& task) const;
+
+    /**
+     * Returns the number of scheduled tasks.
+     *
+     * @return size_t - the number of tasks
+     */
+    std::size_t getTaskCount() const
+    {
+        return tasks.size();
+    }
+
+    /**
+     * Returns the current tick.  The wheel starts at tick 0.
+     *
+     * @return uint64_t - the current tick
+     */
+    uint64_t getTick() const
+    {
+        return tick;
+    }
+
+    /**
+     * Returns the number of ticks until the next task is due.
+     *
+     * @return optional<uint64_t> - the number of ticks, or no value if there
+     *                               are no tasks
+     */
+    std::optional<uint64_t> getTicksUntilNext() const;
+
+  private:
+    /**
+     * A scheduled run of a task in a slot.
+     */
+    struct Entry
+    {
+        /**
+         * The task ID.
+         */
+        std::size_t id;
+
+        /**
+         * The tick the task is due on.
+         */
+        uint64_t expiry;
+    };
+
+    /**
+     * A periodic task.
+     */
+    struct TaskInfo
+    {
+        /**
+         * The number of ticks between runs.
+         */
+        uint64_t period;
+
+        /**
+         * The tick within the period to run on.
+         */
+        uint64_t phase;
+
+        /**
+         * The tick of the next run.
+         */
+        uint64_t expiry;
+
+        /**
+         * Called each time the task is due.
+         */
+        Callback callback;
+    };
+
+    /**
+     * Chooses the phase with the fewest other tasks on the same ticks.
+     *
+     * Two tasks run on the same tick at some point if their phases are
+     * equal modulo the greatest common divisor of their periods.
+     *
+     * @param[in] period - the period of the new task
+     *
+     * @return uint64_t - the phase
+     */
+    uint64_t choosePhase(uint64_t period) const;
+
+    /**
+     * Moves the entries of a slot to the levels where they now belong.
+     *
+     * @param[in] level - the level of the slot
+     */
+    void cascade(std::size_t level);
+
+    /**
+     * Adds an entry to the slot of its expiry tick.
+     *
+     * @param[in] entry - the entry
+     */
+    void insert(const Entry& entry);
+
+    /**
+     * Removes a task.  Its entries are discarded when their slot is reached.
+     *
+     * @param[in] id - the task ID
+     */
+    void remove(std::size_t id)
+    {
+        tasks.erase(id);
+    }
+
+    /**
+     * Runs the tasks that are due on the current tick.
+     */
+    void runTick();
+
+    /**
+     * The slots of each level.
+     */
+    std::array<std::array<std::vector<Entry>, slotCount>, levelCount>
+        levels{};
+
+    /**
+     * The scheduled tasks, by task ID.
+     */
+    std::map<std::size_t, TaskInfo> tasks{};
+
+    /**
+     * The current tick.
+     */
+    uint64_t tick{0};
+
+    /**
+     * The ID of the next task.
+     */
+    std::size_t nextID{0};
+};
+
+} // namespace phosphor::power::util
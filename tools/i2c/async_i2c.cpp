@@ -0,0 +1,281 @@
+#include "async_i2c.hpp"
+
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <functional>
+#include <memory>
+#include <system_error>
+#include <utility>
+
+namespace i2c
+{
+
+CompletionQueue::CompletionQueue() :
+    fd(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC))
+{
+    if (fd < 0)
+    {
+        throw std::system_error(errno, std::generic_category(),
+                                "Unable to create eventfd");
+    }
+}
+
+CompletionQueue::~CompletionQueue()
+{
+    ::close(fd);
+}
+
+size_t CompletionQueue::dispatch()
+{
+    // Reset the eventfd before taking the callbacks, so a callback posted
+    // after this point makes it readable again
+    uint64_t count{0};
+    ssize_t rc = ::read(fd, &count, sizeof(count));
+    (void)rc;
+
+    std::vector<std::function<void()>> ready;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ready.swap(callbacks);
+    }
+    for (auto& callback : ready)
+    {
+        callback();
+    }
+    return ready.size();
+}
+
+void CompletionQueue::post(std::function<void()> callback)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        callbacks.emplace_back(std::move(callback));
+    }
+    uint64_t one{1};
+    ssize_t rc = ::write(fd, &one, sizeof(one));
+    (void)rc;
+}
+
+AsyncI2CExecutor::AsyncI2CExecutor(Poster poster, size_t queueCapacity) :
+    poster(std::move(poster)), queueCapacity(queueCapacity)
+{}
+
+AsyncI2CExecutor::~AsyncI2CExecutor()
+{
+    for (auto& [bus, queue] : buses)
+    {
+        {
+            std::lock_guard<std::mutex> lock(queue->mutex);
+            queue->stopping = true;
+        }
+        queue->ready.notify_one();
+    }
+    for (auto& [bus, queue] : buses)
+    {
+        if (queue->worker.joinable())
+        {
+            queue->worker.join();
+        }
+    }
+}
+
+size_t AsyncI2CExecutor::getPendingCount(uint8_t bus) const
+{
+    BusQueue* queue{nullptr};
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = buses.find(bus);
+        if (it == buses.end())
+        {
+            return 0;
+        }
+        queue = it->second.get();
+    }
+    std::lock_guard<std::mutex> lock(queue->mutex);
+    return queue->high.size() + queue->normal.size();
+}
+
+bool AsyncI2CExecutor::submit(uint8_t bus, Priority priority, Work work,
+                              Completion done)
+{
+    BusQueue& queue = getQueue(bus);
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if ((queue.high.size() + queue.normal.size()) >= queueCapacity)
+        {
+            return false;
+        }
+        auto& requests = (priority == Priority::high) ? queue.high
+                                                      : queue.normal;
+        requests.emplace_back(Request{std::move(work), std::move(done)});
+    }
+    queue.ready.notify_one();
+    return true;
+}
+
+AsyncI2CExecutor::BusQueue& AsyncI2CExecutor::getQueue(uint8_t bus)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = buses.find(bus);
+    if (it == buses.end())
+    {
+        // Start the worker before adding the queue, so the destructor only
+        // sees queues that have a worker
+        auto queue = std::make_unique<BusQueue>();
+        queue->worker =
+            std::thread(&AsyncI2CExecutor::run, this, std::ref(*queue));
+        it = buses.emplace(bus, std::move(queue)).first;
+    }
+    return *(it->second);
+}
+
+void AsyncI2CExecutor::run(BusQueue& queue)
+{
+    while (true)
+    {
+        Request request;
+        {
+            std::unique_lock<std::mutex> lock(queue.mutex);
+            queue.ready.wait(lock, [&queue] {
+                return queue.stopping || !queue.high.empty() ||
+                       !queue.normal.empty();
+            });
+            if (queue.stopping)
+            {
+                return;
+            }
+            auto& requests = queue.high.empty() ? queue.normal : queue.high;
+            request = std::move(requests.front());
+            requests.pop_front();
+        }
+
+        std::exception_ptr error;
+        try
+        {
+            if (request.work)
+            {
+                request.work();
+            }
+        }
+        catch (...)
+        {
+            error = std::current_exception();
+        }
+
+        if (request.done)
+        {
+            if (poster)
+            {
+                poster([done = std::move(request.done), error]() {
+                    done(error);
+                });
+            }
+            else
+            {
+                request.done(error);
+            }
+        }
+    }
+}
+
+bool AsyncI2CInterface::readBlock(uint8_t addr, uint8_t size,
+                                  I2CInterface::Mode mode, Priority priority,
+                                  ReadBlockCallback callback)
+{
+    // SMBus allows at most 32 bytes; the device returns the size
+    auto data = std::make_shared<std::vector<uint8_t>>(
+        (mode == I2CInterface::Mode::SMBUS) ? 32 : size);
+    return submit(
+        priority,
+        [addr, size, mode, data](I2CInterface& device) {
+            uint8_t count = size;
+            device.read(addr, count, data->data(), mode);
+            data->resize(count);
+        },
+        [data, callback = std::move(callback)](std::exception_ptr error) {
+            if (error)
+            {
+                data->clear();
+            }
+            if (callback)
+            {
+                callback(error, std::move(*data));
+            }
+        });
+}
+
+bool AsyncI2CInterface::readByte(uint8_t addr, Priority priority,
+                                 ReadByteCallback callback)
+{
+    auto data = std::make_shared<uint8_t>(0);
+    return submit(
+        priority,
+        [addr, data](I2CInterface& device) { device.read(addr, *data); },
+        [data, callback = std::move(callback)](std::exception_ptr error) {
+            if (callback)
+            {
+                callback(error, *data);
+            }
+        });
+}
+
+bool AsyncI2CInterface::readWord(uint8_t addr, Priority priority,
+                                 ReadWordCallback callback)
+{
+    auto data = std::make_shared<uint16_t>(0);
+    return submit(
+        priority,
+        [addr, data](I2CInterface& device) { device.read(addr, *data); },
+        [data, callback = std::move(callback)](std::exception_ptr error) {
+            if (callback)
+            {
+                callback(error, *data);
+            }
+        });
+}
+
+bool AsyncI2CInterface::submit(Priority priority,
+                               std::function<void(I2CInterface&)> work,
+                               WriteCallback callback)
+{
+    I2CInterface* target = &device;
+    return executor.submit(
+        device.getBus(), priority,
+        [target, work = std::move(work)]() { work(*target); },
+        std::move(callback));
+}
+
+bool AsyncI2CInterface::writeBlock(uint8_t addr, std::vector<uint8_t> data,
+                                   I2CInterface::Mode mode, Priority priority,
+                                   WriteCallback callback)
+{
+    return submit(
+        priority,
+        [addr, data = std::move(data), mode](I2CInterface& device) {
+            device.write(addr, static_cast<uint8_t>(data.size()), data.data(),
+                         mode);
+        },
+        std::move(callback));
+}
+
+bool AsyncI2CInterface::writeByte(uint8_t addr, uint8_t data,
+                                  Priority priority, WriteCallback callback)
+{
+    return submit(
+        priority,
+        [addr, data](I2CInterface& device) { device.write(addr, data); },
+        std::move(callback));
+}
+
+bool AsyncI2CInterface::writeWord(uint8_t addr, uint16_t data,
+                                  Priority priority, WriteCallback callback)
+{
+    return submit(
+        priority,
+        [addr, data](I2CInterface& device) { device.write(addr, data); },
+        std::move(callback));
+}
+
+} // namespace i2c
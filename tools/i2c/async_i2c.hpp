@@ -0,0 +1,383 @@
+#pragma once
+
+#include "i2c_interface.hpp"
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace i2c
+{
+
+/** @brief Priority of an asynchronous I2C request
+ *
+ * High priority requests, such as fault status reads, are performed before
+ * any normal priority requests, such as telemetry reads, that are waiting on
+ * the same bus.
+ */
+enum class Priority
+{
+    high,
+    normal
+};
+
+/** @brief Function that runs a callback on the thread of an event loop
+ *
+ * Called from the worker threads.  Must be thread safe.
+ */
+using Poster = std::function<void(std::function<void()>)>;
+
+/** @class CompletionQueue
+ *
+ * Runs callbacks posted by other threads on the thread of an event loop.
+ *
+ * The event loop watches getFD() for EPOLLIN, for example using an
+ * sdeventplus::source::IO, and calls dispatch() when it becomes readable.
+ * getPoster() returns a Poster for an AsyncI2CExecutor.
+ */
+class CompletionQueue
+{
+  public:
+    CompletionQueue(const CompletionQueue&) = delete;
+    CompletionQueue& operator=(const CompletionQueue&) = delete;
+    CompletionQueue(CompletionQueue&&) = delete;
+    CompletionQueue& operator=(CompletionQueue&&) = delete;
+
+    /** @brief Constructor
+     *
+     * @throw std::system_error if the eventfd cannot be created
+     */
+    CompletionQueue();
+
+    /** @brief Destructor.  Callbacks that were not dispatched are discarded.
+     */
+    ~CompletionQueue();
+
+    /** @brief Run the posted callbacks on the calling thread
+     *
+     * @return number of callbacks run
+     */
+    size_t dispatch();
+
+    /** @brief Get the file descriptor that is readable while callbacks are
+     *         waiting to be dispatched
+     *
+     * @return file descriptor
+     */
+    int getFD() const
+    {
+        return fd;
+    }
+
+    /** @brief Get a Poster that posts callbacks to this queue
+     *
+     * The queue must exist as long as the poster is used.
+     *
+     * @return poster
+     */
+    Poster getPoster()
+    {
+        return [this](std::function<void()> callback) {
+            post(std::move(callback));
+        };
+    }
+
+    /** @brief Post a callback.  Thread safe.
+     *
+     * @param[in] callback - Callback to run when dispatch() is called
+     */
+    void post(std::function<void()> callback);
+
+  private:
+    /** @brief The eventfd */
+    int fd;
+
+    /** @brief Serializes access to callbacks */
+    std::mutex mutex;
+
+    /** @brief Callbacks waiting to be dispatched */
+    std::vector<std::function<void()>> callbacks;
+};
+
+/** @class AsyncI2CExecutor
+ *
+ * Performs I2C requests on one worker thread per bus, so the thread that
+ * submits them does not block on slow or clock stretching devices.
+ *
+ * Each bus has a bounded queue of requests that can be submitted from any
+ * thread.  The worker of a bus performs its high priority requests first,
+ * and the requests of the same priority in the order they were submitted.
+ * The worker is started by the first request for its bus.
+ *
+ * The completion callback of each request is run using the Poster given to
+ * the constructor, normally on the thread of an event loop.  Without a
+ * poster, it is run on the worker thread.
+ *
+ * An I2CInterface must only be used by the worker of its bus while it has
+ * requests waiting.
+ */
+class AsyncI2CExecutor
+{
+  public:
+    /** @brief Function that performs a request on the worker thread */
+    using Work = std::function<void()>;
+
+    /** @brief Function called with the exception thrown by Work, or nullptr
+     *         if none */
+    using Completion = std::function<void(std::exception_ptr)>;
+
+    /** @brief Default maximum number of requests waiting on each bus */
+    static constexpr size_t defaultQueueCapacity = 64;
+
+    AsyncI2CExecutor(const AsyncI2CExecutor&) = delete;
+    AsyncI2CExecutor& operator=(const AsyncI2CExecutor&) = delete;
+    AsyncI2CExecutor(AsyncI2CExecutor&&) = delete;
+    AsyncI2CExecutor& operator=(AsyncI2CExecutor&&) = delete;
+
+    /** @brief Constructor
+     *
+     * @param[in] poster - Runs the completion callbacks; nullptr to run them
+     *                     on the worker threads
+     * @param[in] queueCapacity - Maximum number of requests waiting on each
+     *                            bus
+     */
+    explicit AsyncI2CExecutor(Poster poster = nullptr,
+                              size_t queueCapacity = defaultQueueCapacity);
+
+    /** @brief Destructor
+     *
+     * Waits for the request being performed on each bus, then stops the
+     * workers.  The requests that are still waiting are discarded without
+     * calling their completion callbacks.
+     */
+    ~AsyncI2CExecutor();
+
+    /** @brief Get the number of requests waiting on a bus
+     *
+     * @param[in] bus - I2C bus ID
+     *
+     * @return number of requests, not including the one being performed
+     */
+    size_t getPendingCount(uint8_t bus) const;
+
+    /** @brief Submit a request.  Thread safe.
+     *
+     * @param[in] bus - I2C bus ID of the device
+     * @param[in] priority - Priority of the request
+     * @param[in] work - Performs the request on the worker of the bus
+     * @param[in] done - Called when the request completes; may be empty
+     *
+     * @return true if the request was queued, false if the queue of the bus
+     *         is full.  The completion callback is not called if the request
+     *         was not queued.
+     *
+     * @throw std::system_error if the worker thread cannot be started
+     */
+    bool submit(uint8_t bus, Priority priority, Work work, Completion done);
+
+  private:
+    /** @brief A request waiting to be performed */
+    struct Request
+    {
+        Work work;
+        Completion done;
+    };
+
+    /** @brief The requests and worker of one bus */
+    struct BusQueue
+    {
+        /** @brief Serializes access to the queues and stopping */
+        std::mutex mutex;
+
+        /** @brief Notified when a request is queued or the worker stops */
+        std::condition_variable ready;
+
+        /** @brief High priority requests */
+        std::deque<Request> high;
+
+        /** @brief Normal priority requests */
+        std::deque<Request> normal;
+
+        /** @brief Indicates whether the worker must stop */
+        bool stopping = false;
+
+        /** @brief The worker thread */
+        std::thread worker;
+    };
+
+    /** @brief Get the queue of a bus, starting its worker if needed
+     *
+     * @param[in] bus - I2C bus ID
+     *
+     * @return queue of the bus
+     */
+    BusQueue& getQueue(uint8_t bus);
+
+    /** @brief Perform the requests of a bus until the worker is stopped
+     *
+     * @param[in] queue - Queue of the bus
+     */
+    void run(BusQueue& queue);
+
+    /** @brief Runs the completion callbacks, or nullptr */
+    Poster poster;
+
+    /** @brief Maximum number of requests waiting on each bus */
+    size_t queueCapacity;
+
+    /** @brief Serializes access to buses */
+    mutable std::mutex mutex;
+
+    /** @brief Queue of each bus that has been used */
+    std::map<uint8_t, std::unique_ptr<BusQueue>> buses;
+};
+
+/** @class AsyncI2CInterface
+ *
+ * Asynchronous access to an I2C device using an AsyncI2CExecutor.
+ *
+ * Each method queues a request on the worker of the device's bus and
+ * returns false, without calling the callback, if the queue is full.  The
+ * callback receives the exception thrown by the request, or nullptr if it
+ * succeeded, and the data read.
+ *
+ * The device and the executor must exist until all the callbacks have been
+ * called.
+ */
+class AsyncI2CInterface
+{
+  public:
+    /** @brief Callback of a request that does not read data */
+    using WriteCallback = std::function<void(std::exception_ptr)>;
+
+    /** @brief Callback of a byte read */
+    using ReadByteCallback = std::function<void(std::exception_ptr, uint8_t)>;
+
+    /** @brief Callback of a word read */
+    using ReadWordCallback =
+        std::function<void(std::exception_ptr, uint16_t)>;
+
+    /** @brief Callback of a block read */
+    using ReadBlockCallback =
+        std::function<void(std::exception_ptr, std::vector<uint8_t>)>;
+
+    /** @brief Constructor
+     *
+     * @param[in] device - I2C device
+     * @param[in] executor - Executor that performs the requests
+     */
+    AsyncI2CInterface(I2CInterface& device, AsyncI2CExecutor& executor) :
+        device(device), executor(executor)
+    {}
+
+    /** @brief Get the I2C device
+     *
+     * @return device
+     */
+    I2CInterface& getDevice()
+    {
+        return device;
+    }
+
+    /** @brief Read a block from a register
+     *
+     * See I2CInterface::read(uint8_t, uint8_t&, uint8_t*, Mode).
+     *
+     * @param[in] addr - The register address of the i2c device
+     * @param[in] size - Number of bytes to read when mode is I2C; ignored
+     *                   for SMBus
+     * @param[in] mode - The block read mode
+     * @param[in] priority - Priority of the request
+     * @param[in] callback - Receives the bytes read
+     *
+     * @return true if the request was queued, false if the queue is full
+     */
+    bool readBlock(uint8_t addr, uint8_t size, I2CInterface::Mode mode,
+                   Priority priority, ReadBlockCallback callback);
+
+    /** @brief Read a byte from a register
+     *
+     * @param[in] addr - The register address of the i2c device
+     * @param[in] priority - Priority of the request
+     * @param[in] callback - Receives the byte read
+     *
+     * @return true if the request was queued, false if the queue is full
+     */
+    bool readByte(uint8_t addr, Priority priority, ReadByteCallback callback);
+
+    /** @brief Read a word from a register
+     *
+     * @param[in] addr - The register address of the i2c device
+     * @param[in] priority - Priority of the request
+     * @param[in] callback - Receives the word read
+     *
+     * @return true if the request was queued, false if the queue is full
+     */
+    bool readWord(uint8_t addr, Priority priority, ReadWordCallback callback);
+
+    /** @brief Perform any request on the device
+     *
+     * @param[in] priority - Priority of the request
+     * @param[in] work - Performs the request on the worker of the bus
+     * @param[in] callback - Called when the request completes
+     *
+     * @return true if the request was queued, false if the queue is full
+     */
+    bool submit(Priority priority, std::function<void(I2CInterface&)> work,
+                WriteCallback callback);
+
+    /** @brief Write a block to a register
+     *
+     * @param[in] addr - The register address of the i2c device
+     * @param[in] data - The data to write
+     * @param[in] mode - The block write mode
+     * @param[in] priority - Priority of the request
+     * @param[in] callback - Called when the request completes
+     *
+     * @return true if the request was queued, false if the queue is full
+     */
+    bool writeBlock(uint8_t addr, std::vector<uint8_t> data,
+                    I2CInterface::Mode mode, Priority priority,
+                    WriteCallback callback);
+
+    /** @brief Write a byte to a register
+     *
+     * @param[in] addr - The register address of the i2c device
+     * @param[in] data - The data to write
+     * @param[in] priority - Priority of the request
+     * @param[in] callback - Called when the request completes
+     *
+     * @return true if the request was queued, false if the queue is full
+     */
+    bool writeByte(uint8_t addr, uint8_t data, Priority priority,
+                   WriteCallback callback);
+
+    /** @brief Write a word to a register
+     *
+     * @param[in] addr - The register address of the i2c device
+     * @param[in] data - The data to write
+     * @param[in] priority - Priority of the request
+     * @param[in] callback - Called when the request completes
+     *
+     * @return true if the request was queued, false if the queue is full
+     */
+    bool writeWord(uint8_t addr, uint16_t data, Priority priority,
+                   WriteCallback callback);
+
+  private:
+    /** @brief The I2C device */
+    I2CInterface& device;
+
+    /** @brief Executor that performs the requests */
+    AsyncI2CExecutor& executor;
+};
+
+} // namespace i2c
@@ -0,0 +1,123 @@
+#include "bus_budget.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+
+namespace i2c
+{
+
+namespace
+{
+
+/** @brief Mutex protecting the buckets */
+std::mutex bucketsMutex;
+
+/** @brief Bucket of each bus that has a budget */
+std::map<uint8_t, TokenBucket>& getBuckets()
+{
+    static std::map<uint8_t, TokenBucket> buckets;
+    return buckets;
+}
+
+/** @brief Indicates whether any bus has a budget, so transactions on
+ *         unlimited buses do not lock the mutex */
+std::atomic<bool> haveBudgets{false};
+
+} // namespace
+
+TokenBucket::TokenBucket(const BusBudget& budget, Clock::time_point now) :
+    budget(budget),
+    capacity(std::max((budget.burst > 0.0) ? budget.burst
+                                           : budget.transactionsPerSecond,
+                      1.0)),
+    tokens(capacity), lastRefill(now)
+{}
+
+void TokenBucket::consume(double count, Clock::time_point now)
+{
+    refill(now);
+    tokens = std::max(tokens - count, -capacity);
+}
+
+double TokenBucket::getTokens(Clock::time_point now)
+{
+    refill(now);
+    return tokens;
+}
+
+void TokenBucket::refill(Clock::time_point now)
+{
+    if (now > lastRefill)
+    {
+        std::chrono::duration<double> elapsed = now - lastRefill;
+        tokens = std::min(
+            tokens + elapsed.count() * budget.transactionsPerSecond, capacity);
+        lastRefill = now;
+    }
+}
+
+void clearBusBudgets()
+{
+    std::lock_guard<std::mutex> lock{bucketsMutex};
+    getBuckets().clear();
+    haveBudgets = false;
+}
+
+void consumeBusBudget(uint8_t busId, double count)
+{
+    if (!haveBudgets.load(std::memory_order_relaxed))
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock{bucketsMutex};
+    auto& buckets = getBuckets();
+    auto it = buckets.find(busId);
+    if (it != buckets.end())
+    {
+        it->second.consume(count);
+    }
+}
+
+std::optional<BusBudget> getBusBudget(uint8_t busId)
+{
+    std::lock_guard<std::mutex> lock{bucketsMutex};
+    auto& buckets = getBuckets();
+    auto it = buckets.find(busId);
+    if (it == buckets.end())
+    {
+        return std::nullopt;
+    }
+    return it->second.getBudget();
+}
+
+bool isBusOverBudget(uint8_t busId)
+{
+    if (!haveBudgets.load(std::memory_order_relaxed))
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock{bucketsMutex};
+    auto& buckets = getBuckets();
+    auto it = buckets.find(busId);
+    return (it != buckets.end()) && it->second.isEmpty();
+}
+
+void setBusBudget(uint8_t busId, const BusBudget& budget)
+{
+    if (!(budget.transactionsPerSecond > 0.0) || (budget.burst < 0.0))
+    {
+        throw std::invalid_argument{"Invalid I2C bus budget"};
+    }
+
+    std::lock_guard<std::mutex> lock{bucketsMutex};
+    auto& buckets = getBuckets();
+    buckets.insert_or_assign(busId, TokenBucket{budget});
+    haveBudgets = true;
+}
+
+} // namespace i2c
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+
+namespace i2c
+{
+
+/** @brief Limit on the I2C transactions performed on a bus by this process
+ *
+ * The transactions of all the I2CDevice objects on the bus are counted.
+ */
+struct BusBudget
+{
+    /** @brief Sustained number of transactions per second */
+    double transactionsPerSecond = 0.0;
+
+    /** @brief Number of transactions that may be performed at once after the
+     *         bus has been idle; 0 to use transactionsPerSecond */
+    double burst = 0.0;
+};
+
+/** @class TokenBucket
+ *
+ * Token bucket that tracks the use of a BusBudget.
+ *
+ * The bucket holds up to burst tokens and is refilled at
+ * transactionsPerSecond.  Each transaction takes one token.  Transactions are
+ * never refused, since configuration and fault handling must not be delayed;
+ * instead the bucket goes into debt, down to -burst tokens, and is empty
+ * until the debt has been refilled.  Deferrable work, like sensor
+ * monitoring, checks isEmpty() before using the bus so that it slows down to
+ * the budget and leaves the rest of the bus time to other bus users.
+ */
+class TokenBucket
+{
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    /** @brief Constructor.  The bucket starts full.
+     *
+     * @param[in] budget - Budget of the bus
+     * @param[in] now - Current time
+     */
+    explicit TokenBucket(const BusBudget& budget,
+                         Clock::time_point now = Clock::now());
+
+    /** @brief Take tokens for transactions
+     *
+     * @param[in] count - Number of transactions
+     * @param[in] now - Current time
+     */
+    void consume(double count, Clock::time_point now = Clock::now());
+
+    /** @brief Get the budget of the bus
+     *
+     * @return budget
+     */
+    const BusBudget& getBudget() const
+    {
+        return budget;
+    }
+
+    /** @brief Get the number of tokens, which is negative while in debt
+     *
+     * @param[in] now - Current time
+     *
+     * @return number of tokens
+     */
+    double getTokens(Clock::time_point now = Clock::now());
+
+    /** @brief Check whether there is no token for another transaction
+     *
+     * @param[in] now - Current time
+     *
+     * @return true if the bus is over budget
+     */
+    bool isEmpty(Clock::time_point now = Clock::now())
+    {
+        return getTokens(now) < 1.0;
+    }
+
+  private:
+    /** @brief Add the tokens earned since the last refill
+     *
+     * @param[in] now - Current time
+     */
+    void refill(Clock::time_point now);
+
+    /** @brief Budget of the bus */
+    BusBudget budget;
+
+    /** @brief Maximum number of tokens */
+    double capacity;
+
+    /** @brief Number of tokens at lastRefill */
+    double tokens;
+
+    /** @brief Time tokens was last updated */
+    Clock::time_point lastRefill;
+};
+
+/** @brief Remove the budgets of all the buses
+ *
+ * Thread safe.
+ */
+void clearBusBudgets();
+
+/** @brief Count transactions against the budget of a bus
+ *
+ * Called by I2CDevice for each transaction.  Does nothing if the bus has no
+ * budget.  Thread safe.
+ *
+ * @param[in] busId - The i2c bus ID
+ * @param[in] count - Number of transactions
+ */
+void consumeBusBudget(uint8_t busId, double count = 1.0);
+
+/** @brief Get the budget of a bus
+ *
+ * Thread safe.
+ *
+ * @param[in] busId - The i2c bus ID
+ *
+ * @return budget, or std::nullopt if the bus is not limited
+ */
+std::optional<BusBudget> getBusBudget(uint8_t busId);
+
+/** @brief Check whether a bus has used up its budget
+ *
+ * Deferrable work should not use the bus while this returns true.  Thread
+ * safe.
+ *
+ * @param[in] busId - The i2c bus ID
+ *
+ * @return true if the bus is over budget, false if it is within budget or
+ *         not limited
+ */
+bool isBusOverBudget(uint8_t busId);
+
+/** @brief Set the budget of a bus, replacing any previous budget
+ *
+ * The bucket of the bus starts full.  Thread safe.
+ *
+ * @param[in] busId - The i2c bus ID
+ * @param[in] budget - Budget; transactionsPerSecond must be greater than 0
+ *
+ * @throw std::invalid_argument if transactionsPerSecond is not greater than 0
+ *        or burst is negative
+ */
+void setBusBudget(uint8_t busId, const BusBudget& budget);
+
+} // namespace i2c
@@ -0,0 +1,255 @@
+#include "bus_trace.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <system_error>
+
+namespace i2c
+{
+
+namespace
+{
+
+/** @brief Write all bytes to a file, continuing after partial writes
+ *
+ * @param[in] fd - The file
+ * @param[in] data - Bytes to write
+ *
+ * @return true if all bytes were written
+ */
+bool writeAll(int fd, std::span<const uint8_t> data) noexcept
+{
+    while (!data.empty())
+    {
+        ssize_t written = ::write(fd, data.data(), data.size());
+        if (written < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return false;
+        }
+        data = data.subspan(static_cast<size_t>(written));
+    }
+    return true;
+}
+
+/** @brief Protects the current trace writer */
+std::mutex traceMutex;
+
+/** @brief The current trace writer; protected by traceMutex */
+std::shared_ptr<TraceWriter> traceWriter;
+
+/** @brief Whether traceWriter is set, for the lock free check */
+std::atomic<bool> tracing{false};
+
+} // namespace
+
+TraceWriter::TraceWriter(const std::filesystem::path& path) :
+    fd(::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644))
+{
+    if (fd < 0)
+    {
+        throw std::system_error{errno, std::generic_category(),
+                                "Unable to create bus trace " + path.string()};
+    }
+
+    TraceHeader header{};
+    header.steadyTime = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            std::chrono::steady_clock::now().time_since_epoch())
+                            .count();
+    header.realTime = std::chrono::duration_cast<std::chrono::microseconds>(
+                          std::chrono::system_clock::now().time_since_epoch())
+                          .count();
+    if (!writeAll(fd, std::span{reinterpret_cast<const uint8_t*>(&header),
+                                sizeof(header)}))
+    {
+        int error = errno;
+        ::close(fd);
+        throw std::system_error{error, std::generic_category(),
+                                "Unable to write bus trace " + path.string()};
+    }
+
+    // Allocate the buffer up front, so recording does not allocate
+    buffer.reserve(bufferSize);
+}
+
+TraceWriter::~TraceWriter()
+{
+    flush();
+    ::close(fd);
+}
+
+void TraceWriter::record(TraceRecord record, std::string_view name,
+                         std::span<const uint8_t> data) noexcept
+{
+    constexpr size_t maxSize = std::numeric_limits<uint16_t>::max();
+    record.nameSize = static_cast<uint16_t>(std::min(name.size(), maxSize));
+    record.dataSize = static_cast<uint16_t>(std::min(data.size(), maxSize));
+    size_t size = sizeof(record) + record.nameSize + record.dataSize;
+
+    std::lock_guard<std::mutex> lock{mutex};
+    if ((buffer.size() + size) > bufferSize)
+    {
+        flushBuffer();
+    }
+
+    if (size > bufferSize)
+    {
+        // Too large to buffer; write the parts directly
+        bool written =
+            writeAll(fd, std::span{reinterpret_cast<const uint8_t*>(&record),
+                                   sizeof(record)}) &&
+            writeAll(fd, std::span{reinterpret_cast<const uint8_t*>(
+                                       name.data()),
+                                   record.nameSize}) &&
+            writeAll(fd, data.first(record.dataSize));
+        if (!written)
+        {
+            ++droppedCount;
+        }
+        return;
+    }
+
+    const auto* bytes = reinterpret_cast<const uint8_t*>(&record);
+    buffer.insert(buffer.end(), bytes, bytes + sizeof(record));
+    buffer.insert(buffer.end(), name.begin(), name.begin() + record.nameSize);
+    buffer.insert(buffer.end(), data.begin(), data.begin() + record.dataSize);
+    ++bufferedCount;
+}
+
+void TraceWriter::flush() noexcept
+{
+    std::lock_guard<std::mutex> lock{mutex};
+    flushBuffer();
+}
+
+uint64_t TraceWriter::getDroppedCount() const
+{
+    std::lock_guard<std::mutex> lock{mutex};
+    return droppedCount;
+}
+
+void TraceWriter::flushBuffer() noexcept
+{
+    if (!buffer.empty() && !writeAll(fd, buffer))
+    {
+        droppedCount += bufferedCount;
+    }
+    buffer.clear();
+    bufferedCount = 0;
+}
+
+void startTrace(const std::filesystem::path& path)
+{
+    // Create the file before stopping the current trace, so a failure leaves
+    // it running
+    auto writer = std::make_shared<TraceWriter>(path);
+
+    std::shared_ptr<TraceWriter> previous{};
+    {
+        std::lock_guard<std::mutex> lock{traceMutex};
+        previous = std::move(traceWriter);
+        traceWriter = std::move(writer);
+        tracing.store(true, std::memory_order_release);
+    }
+    if (previous)
+    {
+        previous->flush();
+    }
+}
+
+void stopTrace()
+{
+    std::shared_ptr<TraceWriter> previous{};
+    {
+        std::lock_guard<std::mutex> lock{traceMutex};
+        previous = std::move(traceWriter);
+        tracing.store(false, std::memory_order_release);
+    }
+    if (previous)
+    {
+        // Transactions still holding the writer add their records to the
+        // buffer, which is written when the last of them releases it
+        previous->flush();
+    }
+}
+
+bool isTracing() noexcept
+{
+    return tracing.load(std::memory_order_acquire);
+}
+
+std::shared_ptr<TraceWriter> getTraceWriter()
+{
+    if (!isTracing())
+    {
+        return nullptr;
+    }
+    std::lock_guard<std::mutex> lock{traceMutex};
+    return traceWriter;
+}
+
+std::vector<TraceEntry> readTrace(const std::filesystem::path& path)
+{
+    std::ifstream file{path, std::ios::binary};
+    if (!file)
+    {
+        throw std::runtime_error{"Unable to open bus trace " + path.string()};
+    }
+    std::vector<char> contents{std::istreambuf_iterator<char>{file},
+                               std::istreambuf_iterator<char>{}};
+
+    TraceHeader header{};
+    TraceHeader expected{};
+    if (contents.size() < sizeof(header))
+    {
+        throw std::runtime_error{"Bus trace is too short: " + path.string()};
+    }
+    std::memcpy(&header, contents.data(), sizeof(header));
+    if ((header.magic != expected.magic) ||
+        (header.version < expected.version) ||
+        (header.recordSize < sizeof(TraceRecord)))
+    {
+        throw std::runtime_error{"Not a supported bus trace: " +
+                                 path.string()};
+    }
+
+    // Records written by a later version can be longer; the added fields are
+    // skipped
+    std::vector<TraceEntry> entries{};
+    size_t offset = sizeof(header);
+    while ((contents.size() - offset) >= header.recordSize)
+    {
+        TraceEntry entry{};
+        std::memcpy(&entry.record, contents.data() + offset,
+                    sizeof(entry.record));
+        size_t size = header.recordSize + entry.record.nameSize +
+                      entry.record.dataSize;
+        if ((contents.size() - offset) < size)
+        {
+            break;
+        }
+
+        const char* name = contents.data() + offset + header.recordSize;
+        entry.name.assign(name, entry.record.nameSize);
+        const char* data = name + entry.record.nameSize;
+        entry.data.assign(data, data + entry.record.dataSize);
+        entries.emplace_back(std::move(entry));
+        offset += size;
+    }
+    return entries;
+}
+
+} // namespace i2c
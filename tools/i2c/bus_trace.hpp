@@ -0,0 +1,294 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace i2c
+{
+
+/** @brief Kind of transaction in a bus trace
+ *
+ * The values are part of the trace file format, so they must not change.
+ */
+enum class TraceOp : uint8_t
+{
+    /** @brief I2CInterface::read(uint8_t&); data is the byte read */
+    readByte = 0,
+
+    /** @brief I2CInterface::read(uint8_t,uint8_t&); data is the byte read */
+    readByteData = 1,
+
+    /** @brief I2CInterface::read(uint8_t,uint16_t&); data is the word read,
+     *         low byte first */
+    readWordData = 2,
+
+    /** @brief SMBus block read; data is the bytes read */
+    readBlockData = 3,
+
+    /** @brief I2C block read; data is the bytes read */
+    readI2CBlockData = 4,
+
+    /** @brief I2CInterface::readLarge(); data is the bytes read */
+    readLarge = 5,
+
+    /** @brief I2CInterface::write(uint8_t); data is the byte written */
+    writeByte = 6,
+
+    /** @brief I2CInterface::writeQuick(); no data */
+    writeQuick = 7,
+
+    /** @brief I2CInterface::write(uint8_t,uint8_t); data is the byte
+     *         written */
+    writeByteData = 8,
+
+    /** @brief I2CInterface::write(uint8_t,uint16_t); data is the word
+     *         written, low byte first */
+    writeWordData = 9,
+
+    /** @brief SMBus block write; data is the bytes written */
+    writeBlockData = 10,
+
+    /** @brief I2C block write; data is the bytes written */
+    writeI2CBlockData = 11,
+
+    /** @brief I2CInterface::transfer(); data is the bytes of all the
+     *         messages, in the order they are sent on the bus */
+    transfer = 12,
+
+    /** @brief Numeric PMBus file read; data is the value, low byte first */
+    pmbusRead = 64,
+
+    /** @brief String PMBus file read; data is the string */
+    pmbusReadString = 65,
+
+    /** @brief PMBus block read; data is the bytes read */
+    pmbusReadBlock = 66,
+
+    /** @brief PMBus file write; data is the bytes written */
+    pmbusWrite = 67,
+};
+
+/** @brief One transaction in a bus trace
+ *
+ * The record is followed in the file by nameSize bytes of PMBus file name
+ * and dataSize bytes of data.  The layout is part of the trace file format,
+ * so fields must only be added to the end.
+ */
+struct TraceRecord
+{
+    /** @brief Start time, in steady_clock nanoseconds */
+    uint64_t time = 0;
+
+    /** @brief Time the transaction took in microseconds, including retries */
+    uint32_t duration = 0;
+
+    /** @brief errno value of the last attempt, or 0 if it succeeded */
+    int32_t result = 0;
+
+    /** @brief Command code, or FlightRecorder::noCommand */
+    uint16_t command = 0;
+
+    /** @brief Number of bytes of the PMBus file name; 0 for I2C
+     *         transactions */
+    uint16_t nameSize = 0;
+
+    /** @brief Number of data bytes; 0 if the transaction failed */
+    uint16_t dataSize = 0;
+
+    /** @brief The TraceOp value */
+    uint8_t op = 0;
+
+    /** @brief The i2c bus ID */
+    uint8_t busId = 0;
+
+    /** @brief Device address */
+    uint8_t addr = 0;
+
+    /** @brief PMBus path type; 0 for I2C transactions */
+    uint8_t pathType = 0;
+
+    /** @brief Number of retries, up to 255 */
+    uint8_t retries = 0;
+
+    /** @brief Padding; always 0 */
+    std::array<uint8_t, 5> reserved{};
+};
+
+static_assert(sizeof(TraceRecord) == 32);
+
+/** @brief Header of a bus trace file
+ *
+ * The header is followed by the records, from oldest to newest.  All values
+ * are in host byte order.  The two clock values were read together when the
+ * trace was started, so the record times can be converted to wall clock time
+ * to line them up with the journal.
+ */
+struct TraceHeader
+{
+    /** @brief Identifies the file as a bus trace; always "PBTR" */
+    std::array<char, 4> magic{'P', 'B', 'T', 'R'};
+
+    /** @brief Format version; currently 1 */
+    uint8_t version = 1;
+
+    /** @brief Padding; always 0 */
+    uint8_t reserved = 0;
+
+    /** @brief Size of each TraceRecord in bytes */
+    uint16_t recordSize = sizeof(TraceRecord);
+
+    /** @brief steady_clock time the trace was started, in nanoseconds */
+    uint64_t steadyTime = 0;
+
+    /** @brief system_clock time the trace was started, in microseconds since
+     *         the epoch */
+    uint64_t realTime = 0;
+};
+
+static_assert(sizeof(TraceHeader) == 24);
+
+/** @brief A transaction read from a bus trace file */
+struct TraceEntry
+{
+    /** @brief The record */
+    TraceRecord record{};
+
+    /** @brief PMBus file name; empty for I2C transactions */
+    std::string name{};
+
+    /** @brief Data written or read */
+    std::vector<uint8_t> data{};
+};
+
+/** @class TraceWriter
+ *
+ * Writes the transactions of a process to a bus trace file.
+ *
+ * The records are collected in a buffer and written to the file when it is
+ * full, so recording costs a copy rather than a system call per
+ * transaction.  Thread safe.  Records that cannot be written are counted and
+ * dropped, so a full disk does not make the transactions fail.
+ */
+class TraceWriter
+{
+  public:
+    /** @brief Size of the buffer written to the file at once */
+    static constexpr size_t bufferSize = 64 * 1024;
+
+    TraceWriter() = delete;
+    TraceWriter(const TraceWriter&) = delete;
+    TraceWriter& operator=(const TraceWriter&) = delete;
+    TraceWriter(TraceWriter&&) = delete;
+    TraceWriter& operator=(TraceWriter&&) = delete;
+
+    /** @brief Constructor.  Creates the file and writes the header.
+     *
+     * An existing file is replaced.
+     *
+     * @param[in] path - The trace file
+     *
+     * @throw std::system_error if the file cannot be created
+     */
+    explicit TraceWriter(const std::filesystem::path& path);
+
+    /** @brief Destructor.  Writes the buffered records and closes the file */
+    ~TraceWriter();
+
+    /** @brief Record a transaction
+     *
+     * The name and data are truncated to 65535 bytes.
+     *
+     * @param[in] record - The transaction; nameSize and dataSize are set
+     *                     from name and data
+     * @param[in] name - PMBus file name; empty for I2C transactions
+     * @param[in] data - Data written or read
+     */
+    void record(TraceRecord record, std::string_view name,
+                std::span<const uint8_t> data) noexcept;
+
+    /** @brief Write the buffered records to the file */
+    void flush() noexcept;
+
+    /** @brief Get the number of records that could not be written
+     *
+     * @return number of records dropped
+     */
+    uint64_t getDroppedCount() const;
+
+  private:
+    /** @brief Write the buffered records; mutex must be held */
+    void flushBuffer() noexcept;
+
+    /** @brief The open trace file */
+    int fd;
+
+    /** @brief Protects the members below */
+    mutable std::mutex mutex;
+
+    /** @brief Records not written to the file yet */
+    std::vector<uint8_t> buffer;
+
+    /** @brief Number of records in buffer */
+    uint64_t bufferedCount = 0;
+
+    /** @brief Number of records that could not be written */
+    uint64_t droppedCount = 0;
+};
+
+/** @brief Start recording the transactions of this process
+ *
+ * The I2CDevice transactions, and those of the PMBus devices wrapped in a
+ * TracedPMBus, are written to the file until stopTrace() is called.  A
+ * trace that was already started is stopped first.  Thread safe.
+ *
+ * @param[in] path - The trace file
+ *
+ * @throw std::system_error if the file cannot be created
+ */
+void startTrace(const std::filesystem::path& path);
+
+/** @brief Stop recording and write the buffered records to the file
+ *
+ * Thread safe.
+ */
+void stopTrace();
+
+/** @brief Check whether transactions are being recorded
+ *
+ * Thread safe and lock free, so transactions can check it cheaply.
+ *
+ * @return true if a trace is started
+ */
+bool isTracing() noexcept;
+
+/** @brief Get the writer of the current trace
+ *
+ * The writer stays valid while the returned pointer is held, even if the
+ * trace is stopped.  Thread safe.
+ *
+ * @return writer, or nullptr if no trace is started
+ */
+std::shared_ptr<TraceWriter> getTraceWriter();
+
+/** @brief Read the transactions in a bus trace file
+ *
+ * A record cut off at the end of the file, such as when the process was
+ * stopped while writing it, is ignored.
+ *
+ * @param[in] path - The trace file
+ *
+ * @return transactions, from oldest to newest
+ *
+ * @throw std::runtime_error if the file cannot be read or is not a bus trace
+ */
+std::vector<TraceEntry> readTrace(const std::filesystem::path& path);
+
+} // namespace i2c
@@ -0,0 +1,115 @@
+#include "flight_recorder.hpp"
+
+#include <bit>
+#include <cstring>
+#include <limits>
+
+namespace i2c
+{
+
+void FlightRecorder::record(const FlightRecord& record) noexcept
+{
+    uint64_t index = next.fetch_add(1, std::memory_order_relaxed);
+    Slot& slot = slots[index & (capacity - 1)];
+
+    auto words = std::bit_cast<std::array<uint64_t, recordWords>>(record);
+
+    slot.sequence.store(2 * index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (size_t i = 0; i < recordWords; ++i)
+    {
+        slot.words[i].store(words[i], std::memory_order_relaxed);
+    }
+    slot.sequence.store(2 * (index + 1), std::memory_order_release);
+}
+
+std::vector<FlightRecord> FlightRecorder::getRecords() const
+{
+    uint64_t end = next.load(std::memory_order_acquire);
+    uint64_t begin = (end > capacity) ? (end - capacity) : 0;
+
+    std::vector<FlightRecord> records;
+    records.reserve(end - begin);
+    for (uint64_t index = begin; index < end; ++index)
+    {
+        const Slot& slot = slots[index & (capacity - 1)];
+        uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+
+        std::array<uint64_t, recordWords> words;
+        for (size_t i = 0; i < recordWords; ++i)
+        {
+            words[i] = slot.words[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        // Skip the record if it was not written yet, was being written, or
+        // was replaced while it was copied
+        if ((sequence != 2 * (index + 1)) ||
+            (slot.sequence.load(std::memory_order_relaxed) != sequence))
+        {
+            continue;
+        }
+
+        records.push_back(std::bit_cast<FlightRecord>(words));
+    }
+    return records;
+}
+
+std::vector<uint8_t> FlightRecorder::dump(uint8_t busId) const
+{
+    std::vector<FlightRecord> records = getRecords();
+
+    FlightRecorderHeader header{};
+    header.busId = busId;
+    header.count = static_cast<uint32_t>(records.size());
+    header.steadyTime = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            std::chrono::steady_clock::now().time_since_epoch())
+                            .count();
+    header.realTime = std::chrono::duration_cast<std::chrono::microseconds>(
+                          std::chrono::system_clock::now().time_since_epoch())
+                          .count();
+
+    std::vector<uint8_t> data(sizeof(header) +
+                              records.size() * sizeof(FlightRecord));
+    std::memcpy(data.data(), &header, sizeof(header));
+    if (!records.empty())
+    {
+        std::memcpy(data.data() + sizeof(header), records.data(),
+                    records.size() * sizeof(FlightRecord));
+    }
+    return data;
+}
+
+FlightRecorder& getFlightRecorder(uint8_t busId)
+{
+    // The recorders are never freed, so a recorder can be used without
+    // holding a lock or a reference count
+    static std::array<std::atomic<FlightRecorder*>,
+                      std::numeric_limits<uint8_t>::max() + 1>
+        recorders{};
+
+    std::atomic<FlightRecorder*>& entry = recorders[busId];
+    FlightRecorder* recorder = entry.load(std::memory_order_acquire);
+    if (recorder == nullptr)
+    {
+        auto* created = new FlightRecorder{};
+        if (entry.compare_exchange_strong(recorder, created,
+                                          std::memory_order_acq_rel))
+        {
+            recorder = created;
+        }
+        else
+        {
+            // Another thread created the recorder first
+            delete created;
+        }
+    }
+    return *recorder;
+}
+
+std::vector<uint8_t> dumpFlightRecorder(uint8_t busId)
+{
+    return getFlightRecorder(busId).dump(busId);
+}
+
+} // namespace i2c
@@ -0,0 +1,170 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace i2c
+{
+
+/** @brief One I2C transaction recorded by a FlightRecorder
+ *
+ * The layout is part of the binary FFDC format written by
+ * FlightRecorder::dump(), so fields must only be added to the end.
+ */
+struct FlightRecord
+{
+    /** @brief Start time, in steady_clock nanoseconds */
+    uint64_t time = 0;
+
+    /** @brief Time the transaction took in microseconds, including retries */
+    uint32_t duration = 0;
+
+    /** @brief errno value of the last attempt, or 0 if it succeeded */
+    int32_t result = 0;
+
+    /** @brief Command code, or noCommand */
+    uint16_t command = 0;
+
+    /** @brief Number of data bytes requested */
+    uint16_t length = 0;
+
+    /** @brief Device address */
+    uint8_t addr = 0;
+
+    /** @brief Number of retries, up to 255 */
+    uint8_t retries = 0;
+
+    /** @brief Padding; always 0 */
+    uint16_t reserved = 0;
+};
+
+static_assert(sizeof(FlightRecord) == 24);
+
+/** @brief Header of the binary FFDC written by FlightRecorder::dump()
+ *
+ * The header is followed by count FlightRecord structures, from oldest to
+ * newest.  All values are in host byte order.  The two clock values were
+ * read together when the dump was written, so the steady_clock record times
+ * can be converted to wall clock time to line them up with the journal.
+ */
+struct FlightRecorderHeader
+{
+    /** @brief Format version; currently 1 */
+    uint8_t version = 1;
+
+    /** @brief The i2c bus ID */
+    uint8_t busId = 0;
+
+    /** @brief Size of each record in bytes */
+    uint16_t recordSize = sizeof(FlightRecord);
+
+    /** @brief Number of records following the header */
+    uint32_t count = 0;
+
+    /** @brief steady_clock time of the dump, in nanoseconds */
+    uint64_t steadyTime = 0;
+
+    /** @brief system_clock time of the dump, in microseconds since the epoch
+     */
+    uint64_t realTime = 0;
+};
+
+static_assert(sizeof(FlightRecorderHeader) == 24);
+
+/** @class FlightRecorder
+ *
+ * Ring buffer of the most recent I2C transactions on one bus.
+ *
+ * Recording is always on, so it must stay cheap: a transaction claims a slot
+ * with one atomic increment and writes it without taking a lock.  Each slot
+ * has a sequence number that is odd while the slot is being written, so a
+ * reader can detect and skip a record that was overwritten while it was
+ * being copied.
+ */
+class FlightRecorder
+{
+  public:
+    /** @brief Number of transactions kept; a power of 2 */
+    static constexpr size_t capacity = 64;
+
+    /** @brief Value of FlightRecord::command for transactions that have no
+     *         command code, such as byte reads and combined transfers */
+    static constexpr uint16_t noCommand = 256;
+
+    /** @brief Record a transaction, replacing the oldest one if full
+     *
+     * Thread safe and lock free.
+     *
+     * @param[in] record - The transaction
+     */
+    void record(const FlightRecord& record) noexcept;
+
+    /** @brief Get the recorded transactions
+     *
+     * Thread safe.  Records being written during the call are left out.
+     *
+     * @return transactions, from oldest to newest
+     */
+    std::vector<FlightRecord> getRecords() const;
+
+    /** @brief Get the recorded transactions in the binary FFDC format
+     *
+     * Thread safe.
+     *
+     * @param[in] busId - The i2c bus ID to put in the header
+     *
+     * @return FlightRecorderHeader followed by the records
+     */
+    std::vector<uint8_t> dump(uint8_t busId) const;
+
+  private:
+    static_assert((capacity & (capacity - 1)) == 0);
+
+    /** @brief Number of 64-bit words in a FlightRecord */
+    static constexpr size_t recordWords = sizeof(FlightRecord) / 8;
+
+    /** @brief A record and its sequence number */
+    struct Slot
+    {
+        /** @brief 2 * (index + 1) once the record at index is written, and
+         *         odd while it is being written */
+        std::atomic<uint64_t> sequence{0};
+
+        /** @brief The record, stored as atomic words so it can be read
+         *         while it is written */
+        std::array<std::atomic<uint64_t>, recordWords> words{};
+    };
+
+    /** @brief Index of the next record */
+    std::atomic<uint64_t> next{0};
+
+    /** @brief The records, by index modulo capacity */
+    std::array<Slot, capacity> slots{};
+};
+
+/** @brief Get the flight recorder of a bus
+ *
+ * The recorder is created the first time it is needed and lasts for the
+ * life of the process.  Thread safe.
+ *
+ * @param[in] busId - The i2c bus ID
+ *
+ * @return flight recorder
+ */
+FlightRecorder& getFlightRecorder(uint8_t busId);
+
+/** @brief Get the recorded transactions of a bus in the binary FFDC format
+ *
+ * Thread safe.
+ *
+ * @param[in] busId - The i2c bus ID
+ *
+ * @return FlightRecorderHeader followed by the records
+ */
+std::vector<uint8_t> dumpFlightRecorder(uint8_t busId);
+
+} // namespace i2c
@@ -1,12 +1,21 @@
 #include "i2c.hpp"
 
+#include "bus_budget.hpp"
+#include "trace.hpp"
+
 #include <fcntl.h>
 #include <sys/ioctl.h>
 #include <sys/stat.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <cassert>
 #include <cerrno>
+#include <limits>
+#include <mutex>
+#include <random>
+#include <set>
+#include <thread>
 
 extern "C"
 {
@@ -18,25 +27,322 @@ extern "C"
 namespace i2c
 {
 
+namespace
+{
+
+/** @brief Get the bytes of an SMBus byte or word value for the bus trace
+ *
+ * @param[in] value - The value read or written
+ * @param[in] size - Number of bytes; 1 or 2
+ *
+ * @return bytes, low byte first as on the bus
+ */
+std::vector<uint8_t> getValueBytes(int value, size_t size)
+{
+    std::vector<uint8_t> bytes(size);
+    for (size_t i = 0; i < size; ++i)
+    {
+        bytes[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+    return bytes;
+}
+
+} // namespace
+
+std::mutex I2CDevice::busesMutex;
+
+std::mutex I2CDevice::idleDevicesMutex;
+
+I2CDevice::Bus::~Bus()
+{
+    if (fd != INVALID_FD)
+    {
+        ::close(fd);
+    }
+}
+
+std::map<uint8_t, std::weak_ptr<I2CDevice::Bus>>& I2CDevice::getBuses()
+{
+    static std::map<uint8_t, std::weak_ptr<Bus>> buses{};
+    return buses;
+}
+
+std::set<I2CDevice*>& I2CDevice::getIdleDevices()
+{
+    static std::set<I2CDevice*> devices{};
+    return devices;
+}
+
+I2CDevice::I2CDevice(uint8_t busId, uint8_t devAddr, InitialState initialState,
+                     const RetryPolicy& retryPolicy,
+                     const IdlePolicy& idlePolicy) :
+    busId(busId),
+    devAddr(devAddr), retryPolicy(retryPolicy), idlePolicy(idlePolicy),
+    recorder(&getFlightRecorder(busId))
+{
+    busStr = "/dev/i2c-" + std::to_string(busId);
+    if (initialState == InitialState::OPEN)
+    {
+        openDevice();
+    }
+    if (hasIdleTimeout())
+    {
+        std::lock_guard<std::mutex> lock{idleDevicesMutex};
+        getIdleDevices().insert(this);
+    }
+}
+
+I2CDevice::~I2CDevice()
+{
+    if (hasIdleTimeout())
+    {
+        std::lock_guard<std::mutex> lock{idleDevicesMutex};
+        getIdleDevices().erase(this);
+    }
+    if (isOpen())
+    {
+        // Note: destructors must not throw exceptions
+        closeWithoutException();
+    }
+}
+
+size_t I2CDevice::closeIdleDevices()
+{
+    auto now = std::chrono::steady_clock::now();
+    size_t count = 0;
+    std::lock_guard<std::mutex> lock{idleDevicesMutex};
+    for (I2CDevice* device : getIdleDevices())
+    {
+        // A device whose lock is held is in use, so it is not idle
+        std::unique_lock<std::mutex> deviceLock{device->idleMutex,
+                                                std::try_to_lock};
+        if (!deviceLock.owns_lock() || !device->isOpen() ||
+            ((now - device->lastUsedTime) < device->idlePolicy.idleTimeout))
+        {
+            continue;
+        }
+
+        device->closeWithoutException();
+        if (!device->isOpen())
+        {
+            device->isIdleClosed = true;
+            ++device->idleStats.idleCloseCount;
+            ++count;
+        }
+    }
+    return count;
+}
+
+std::unique_lock<std::mutex> I2CDevice::lockIfIdlePolicy() const
+{
+    if (!hasIdleTimeout())
+    {
+        return std::unique_lock<std::mutex>{};
+    }
+    return std::unique_lock<std::mutex>{idleMutex};
+}
+
+I2CDevice::TransactionLock I2CDevice::prepareTransaction()
+{
+    TransactionLock lock{lockIfIdlePolicy(), {}};
+    if (hasIdleTimeout() && !isOpen())
+    {
+        // Open the device on the first transaction after it was closed
+        openDevice();
+    }
+    checkIsOpen();
+    lock.busLock = std::unique_lock<std::mutex>{bus->mutex};
+    return lock;
+}
+
+template <typename Func>
+int I2CDevice::retry(Func operation)
+{
+    int ret = operation();
+    if ((ret < 0) && (retryPolicy.maxRetries > 0))
+    {
+        int lastErrno = errno;
+        auto start = std::chrono::steady_clock::now();
+        auto delay = retryPolicy.initialDelay;
+        for (int retries = 0; (ret < 0) && (retries < retryPolicy.maxRetries);
+             ++retries)
+        {
+            // Retrying on a stuck bus would only wait for more timeouts
+            if ((bus && bus->stuckBus.isStuck()) || !waitToRetry(start, delay))
+            {
+                break;
+            }
+            ++retryCount;
+            consumeBusBudget(busId);
+            ret = operation();
+            lastErrno = errno;
+        }
+        errno = lastErrno;
+    }
+    return ret;
+}
+
+template <typename Func, typename Data>
+int I2CDevice::transaction(size_t command, size_t length, TraceOp op,
+                           Func operation, Data traceData)
+{
+    POWER_TRACE_SCOPE(
+        "I2CDevice::transaction", busStr + "-" + std::to_string(devAddr),
+        (command == DeviceStats::noCommand) ? "" : std::to_string(command));
+
+    auto start = std::chrono::steady_clock::now();
+    if (!bus->stuckBus.startTransaction(start))
+    {
+        throw I2CException("Bus stuck, transaction not attempted", busStr,
+                           devAddr, ETIMEDOUT);
+    }
+
+    ++transactionCount;
+    consumeBusBudget(busId);
+    lastUsedTime = start;
+
+    uint64_t previousRetryCount = retryCount;
+    int ret = retry([&]() {
+        int result = operation();
+        if (result < 0)
+        {
+            bus->stuckBus.recordFailure(errno);
+        }
+        else
+        {
+            bus->stuckBus.recordSuccess();
+        }
+        return result;
+    });
+    auto latency = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start);
+    int lastErrno = errno;
+    uint64_t retries = retryCount - previousRetryCount;
+
+    FlightRecord record{};
+    record.time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                      start.time_since_epoch())
+                      .count();
+    record.duration = static_cast<uint32_t>(std::min<uint64_t>(
+        latency.count(), std::numeric_limits<uint32_t>::max()));
+    record.result = (ret < 0) ? lastErrno : 0;
+    record.command = static_cast<uint16_t>(command);
+    record.length = static_cast<uint16_t>(
+        std::min<size_t>(length, std::numeric_limits<uint16_t>::max()));
+    record.addr = devAddr;
+    record.retries = static_cast<uint8_t>(
+        std::min<uint64_t>(retries, std::numeric_limits<uint8_t>::max()));
+    recorder->record(record);
+
+    if (isTracing())
+    {
+        if (std::shared_ptr<TraceWriter> writer = getTraceWriter())
+        {
+            TraceRecord traced{};
+            traced.time = record.time;
+            traced.duration = record.duration;
+            traced.result = record.result;
+            traced.command = record.command;
+            traced.op = static_cast<uint8_t>(op);
+            traced.busId = busId;
+            traced.addr = devAddr;
+            traced.retries = record.retries;
+            if (ret < 0)
+            {
+                writer->record(traced, {}, {});
+            }
+            else
+            {
+                std::vector<uint8_t> data = traceData(ret);
+                writer->record(traced, {}, data);
+            }
+        }
+    }
+
+    if (stats)
+    {
+        stats->get(command).record(latency, (ret < 0), retries);
+    }
+    errno = lastErrno;
+    return ret;
+}
+
+void I2CDevice::setStatsEnabled(bool enable)
+{
+    if (!enable)
+    {
+        stats.reset();
+    }
+    else if (!stats)
+    {
+        stats = std::make_unique<DeviceStats>();
+    }
+}
+
+bool I2CDevice::waitToRetry(std::chrono::steady_clock::time_point start,
+                            std::chrono::microseconds& delay)
+{
+    using namespace std::chrono;
+    microseconds wait = delay;
+    if (retryPolicy.maxJitter.count() > 0)
+    {
+        static thread_local std::minstd_rand generator{std::random_device{}()};
+        std::uniform_int_distribution<microseconds::rep> jitter{
+            0, retryPolicy.maxJitter.count()};
+        wait += microseconds{jitter(generator)};
+    }
+
+    if ((retryPolicy.deadline.count() > 0) &&
+        ((steady_clock::now() + wait - start) > retryPolicy.deadline))
+    {
+        return false;
+    }
+
+    if (wait.count() > 0)
+    {
+        std::this_thread::sleep_for(wait);
+    }
+
+    delay = std::min(delay * 2, std::max(retryPolicy.maxDelay, delay));
+    return true;
+}
+
 unsigned long I2CDevice::getFuncs()
 {
     // If functionality has not been cached
-    if (cachedFuncs == NO_FUNCS)
+    if (bus->funcs == NO_FUNCS)
     {
         // Get functionality from adapter
-        int ret = 0, retries = 0;
-        do
-        {
-            ret = ioctl(fd, I2C_FUNCS, &cachedFuncs);
-        } while ((ret < 0) && (++retries <= maxRetries));
+        unsigned long funcs = NO_FUNCS;
+        int ret = retry([&]() { return ioctl(fd, I2C_FUNCS, &funcs); });
 
         if (ret < 0)
         {
             throw I2CException("Failed to get funcs", busStr, devAddr, errno);
         }
+        bus->funcs = funcs;
     }
 
-    return cachedFuncs;
+    return bus->funcs;
+}
+
+void I2CDevice::selectDevice()
+{
+    if (bus->selectedAddr == devAddr)
+    {
+        return;
+    }
+
+    int ret = retry([&]() { return ioctl(fd, I2C_SLAVE, devAddr); });
+
+    if (ret < 0)
+    {
+        // The previously selected device is unknown now
+        bus->selectedAddr = NO_ADDR;
+        throw I2CException("Failed to set I2C_SLAVE", busStr, devAddr, errno);
+    }
+
+    bus->selectedAddr = devAddr;
 }
 
 void I2CDevice::checkReadFuncs(int type)
@@ -90,6 +396,12 @@ void I2CDevice::checkWriteFuncs(int type)
     unsigned long funcs = getFuncs();
     switch (type)
     {
+        case I2C_SMBUS_QUICK:
+            if (!(funcs & I2C_FUNC_SMBUS_QUICK))
+            {
+                throw I2CException("Missing SMBUS_QUICK", busStr, devAddr);
+            }
+            break;
         case I2C_SMBUS_BYTE:
             if (!(funcs & I2C_FUNC_SMBUS_WRITE_BYTE))
             {
@@ -131,68 +443,111 @@ void I2CDevice::checkWriteFuncs(int type)
 }
 
 void I2CDevice::open()
+{
+    auto lock = lockIfIdlePolicy();
+    openDevice();
+}
+
+void I2CDevice::openDevice()
 {
     if (isOpen())
     {
         throw I2CException("Device already open", busStr, devAddr);
     }
+    auto start = std::chrono::steady_clock::now();
 
-    int retries = 0;
-    do
     {
-        fd = ::open(busStr.c_str(), O_RDWR);
-    } while ((fd == -1) && (++retries <= maxRetries));
+        std::lock_guard<std::mutex> lock{busesMutex};
+        auto& buses = getBuses();
+        bus = buses[busId].lock();
+        if (!bus)
+        {
+            // First device opened on this bus
+            auto newBus = std::make_shared<Bus>();
+            newBus->fd = retry(
+                [&]() { return ::open(busStr.c_str(), O_RDWR); });
 
-    if (fd == -1)
-    {
-        throw I2CException("Failed to open", busStr, devAddr, errno);
+            if (newBus->fd == -1)
+            {
+                throw I2CException("Failed to open", busStr, devAddr, errno);
+            }
+
+            bus = newBus;
+            buses[busId] = bus;
+        }
     }
+    fd = bus->fd;
 
-    retries = 0;
-    int ret = 0;
-    do
+    try
     {
-        ret = ioctl(fd, I2C_SLAVE, devAddr);
-    } while ((ret < 0) && (++retries <= maxRetries));
-
-    if (ret < 0)
+        // Make sure this device can be selected
+        std::lock_guard<std::mutex> busLock{bus->mutex};
+        selectDevice();
+    }
+    catch (const I2CException&)
     {
         // Close device since setting slave address failed
         closeWithoutException();
+        throw;
+    }
 
-        throw I2CException("Failed to set I2C_SLAVE", busStr, devAddr, errno);
+    lastUsedTime = std::chrono::steady_clock::now();
+    if (isIdleClosed)
+    {
+        // Record the cost of re-opening a device closed for being idle
+        isIdleClosed = false;
+        ++idleStats.reopenCount;
+        idleStats.reopenTime +=
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                lastUsedTime - start);
     }
 }
 
 void I2CDevice::close()
+{
+    auto lock = lockIfIdlePolicy();
+    closeDevice();
+}
+
+IdleStats I2CDevice::getIdleStats() const
+{
+    auto lock = lockIfIdlePolicy();
+    return idleStats;
+}
+
+void I2CDevice::closeDevice()
 {
     checkIsOpen();
 
-    int ret = 0, retries = 0;
-    do
+    std::lock_guard<std::mutex> lock{busesMutex};
+    if (bus.use_count() == 1)
     {
-        ret = ::close(fd);
-    } while ((ret == -1) && (++retries <= maxRetries));
+        // Last device on this bus, so close the bus
+        int ret = retry([&]() { return ::close(fd); });
 
-    if (ret == -1)
-    {
-        throw I2CException("Failed to close", busStr, devAddr, errno);
+        if (ret == -1)
+        {
+            throw I2CException("Failed to close", busStr, devAddr, errno);
+        }
+
+        bus->fd = INVALID_FD;
+        getBuses().erase(busId);
     }
 
     fd = INVALID_FD;
-    cachedFuncs = NO_FUNCS;
+    bus.reset();
 }
 
 void I2CDevice::read(uint8_t& data)
 {
-    checkIsOpen();
+    auto lock = prepareTransaction();
     checkReadFuncs(I2C_SMBUS_BYTE);
+    selectDevice();
 
-    int ret = 0, retries = 0;
-    do
-    {
-        ret = i2c_smbus_read_byte(fd);
-    } while ((ret < 0) && (++retries <= maxRetries));
+    int ret = transaction(
+        DeviceStats::noCommand, 1, TraceOp::readByte,
+        [&]() { return i2c_smbus_read_byte(fd); },
+        [](int value) { return getValueBytes(value, 1); });
 
     if (ret < 0)
     {
@@ -204,14 +559,14 @@ void I2CDevice::read(uint8_t& data)
 
 void I2CDevice::read(uint8_t addr, uint8_t& data)
 {
-    checkIsOpen();
+    auto lock = prepareTransaction();
     checkReadFuncs(I2C_SMBUS_BYTE_DATA);
+    selectDevice();
 
-    int ret = 0, retries = 0;
-    do
-    {
-        ret = i2c_smbus_read_byte_data(fd, addr);
-    } while ((ret < 0) && (++retries <= maxRetries));
+    int ret = transaction(
+        addr, 1, TraceOp::readByteData,
+        [&]() { return i2c_smbus_read_byte_data(fd, addr); },
+        [](int value) { return getValueBytes(value, 1); });
 
     if (ret < 0)
     {
@@ -223,14 +578,14 @@ void I2CDevice::read(uint8_t addr, uint8_t& data)
 
 void I2CDevice::read(uint8_t addr, uint16_t& data)
 {
-    checkIsOpen();
+    auto lock = prepareTransaction();
     checkReadFuncs(I2C_SMBUS_WORD_DATA);
+    selectDevice();
 
-    int ret = 0, retries = 0;
-    do
-    {
-        ret = i2c_smbus_read_word_data(fd, addr);
-    } while ((ret < 0) && (++retries <= maxRetries));
+    int ret = transaction(
+        addr, 2, TraceOp::readWordData,
+        [&]() { return i2c_smbus_read_word_data(fd, addr); },
+        [](int value) { return getValueBytes(value, 2); });
 
     if (ret < 0)
     {
@@ -242,24 +597,31 @@ void I2CDevice::read(uint8_t addr, uint16_t& data)
 
 void I2CDevice::read(uint8_t addr, uint8_t& size, uint8_t* data, Mode mode)
 {
-    checkIsOpen();
+    auto lock = prepareTransaction();
+    selectDevice();
 
-    int ret = -1, retries = 0;
+    int ret = -1;
     switch (mode)
     {
         case Mode::SMBUS:
             checkReadFuncs(I2C_SMBUS_BLOCK_DATA);
-            do
-            {
-                ret = i2c_smbus_read_block_data(fd, addr, data);
-            } while ((ret < 0) && (++retries <= maxRetries));
+            ret = transaction(
+                addr, I2C_SMBUS_BLOCK_MAX, TraceOp::readBlockData,
+                [&]() { return i2c_smbus_read_block_data(fd, addr, data); },
+                [&](int count) {
+                    return std::vector<uint8_t>(data, data + count);
+                });
             break;
         case Mode::I2C:
             checkReadFuncs(I2C_SMBUS_I2C_BLOCK_DATA);
-            do
-            {
-                ret = i2c_smbus_read_i2c_block_data(fd, addr, size, data);
-            } while ((ret < 0) && (++retries <= maxRetries));
+            ret = transaction(
+                addr, size, TraceOp::readI2CBlockData,
+                [&]() {
+                    return i2c_smbus_read_i2c_block_data(fd, addr, size, data);
+                },
+                [&](int count) {
+                    return std::vector<uint8_t>(data, data + count);
+                });
             if (ret != size)
             {
                 throw I2CException("Failed to read i2c block data", busStr,
@@ -276,16 +638,51 @@ void I2CDevice::read(uint8_t addr, uint8_t& size, uint8_t* data, Mode mode)
     size = static_cast<uint8_t>(ret);
 }
 
+void I2CDevice::readLarge(uint8_t addr, std::span<uint8_t> data)
+{
+    auto lock = prepareTransaction();
+    if (!(getFuncs() & I2C_FUNC_I2C))
+    {
+        throw I2CException("Missing I2C_FUNC_I2C", busStr, devAddr);
+    }
+    if (data.size() > std::numeric_limits<uint16_t>::max())
+    {
+        throw I2CException("Too many bytes in large read", busStr, devAddr,
+                           EINVAL);
+    }
+    if (data.empty())
+    {
+        return;
+    }
+
+    // Write the register address, then read the data after a repeated start
+    i2c_msg msgs[2]{{devAddr, 0, 1, &addr},
+                    {devAddr, I2C_M_RD, static_cast<uint16_t>(data.size()),
+                     data.data()}};
+    i2c_rdwr_ioctl_data rdwr{msgs, 2};
+
+    int ret = transaction(
+        addr, 1 + data.size(), TraceOp::readLarge,
+        [&]() { return ioctl(fd, I2C_RDWR, &rdwr); },
+        [&](int) { return std::vector<uint8_t>(data.begin(), data.end()); });
+
+    if (ret < 0)
+    {
+        throw I2CException("Failed to read large data", busStr, devAddr,
+                           errno);
+    }
+}
+
 void I2CDevice::write(uint8_t data)
 {
-    checkIsOpen();
+    auto lock = prepareTransaction();
     checkWriteFuncs(I2C_SMBUS_BYTE);
+    selectDevice();
 
-    int ret = 0, retries = 0;
-    do
-    {
-        ret = i2c_smbus_write_byte(fd, data);
-    } while ((ret < 0) && (++retries <= maxRetries));
+    int ret = transaction(
+        DeviceStats::noCommand, 1, TraceOp::writeByte,
+        [&]() { return i2c_smbus_write_byte(fd, data); },
+        [&](int) { return getValueBytes(data, 1); });
 
     if (ret < 0)
     {
@@ -293,16 +690,33 @@ void I2CDevice::write(uint8_t data)
     }
 }
 
+void I2CDevice::writeQuick()
+{
+    auto lock = prepareTransaction();
+    checkWriteFuncs(I2C_SMBUS_QUICK);
+    selectDevice();
+
+    int ret = transaction(
+        DeviceStats::noCommand, 0, TraceOp::writeQuick,
+        [&]() { return i2c_smbus_write_quick(fd, I2C_SMBUS_WRITE); },
+        [](int) { return std::vector<uint8_t>{}; });
+
+    if (ret < 0)
+    {
+        throw I2CException("Failed to write quick", busStr, devAddr, errno);
+    }
+}
+
 void I2CDevice::write(uint8_t addr, uint8_t data)
 {
-    checkIsOpen();
+    auto lock = prepareTransaction();
     checkWriteFuncs(I2C_SMBUS_BYTE_DATA);
+    selectDevice();
 
-    int ret = 0, retries = 0;
-    do
-    {
-        ret = i2c_smbus_write_byte_data(fd, addr, data);
-    } while ((ret < 0) && (++retries <= maxRetries));
+    int ret = transaction(
+        addr, 1, TraceOp::writeByteData,
+        [&]() { return i2c_smbus_write_byte_data(fd, addr, data); },
+        [&](int) { return getValueBytes(data, 1); });
 
     if (ret < 0)
     {
@@ -312,14 +726,14 @@ void I2CDevice::write(uint8_t addr, uint8_t data)
 
 void I2CDevice::write(uint8_t addr, uint16_t data)
 {
-    checkIsOpen();
+    auto lock = prepareTransaction();
     checkWriteFuncs(I2C_SMBUS_WORD_DATA);
+    selectDevice();
 
-    int ret = 0, retries = 0;
-    do
-    {
-        ret = i2c_smbus_write_word_data(fd, addr, data);
-    } while ((ret < 0) && (++retries <= maxRetries));
+    int ret = transaction(
+        addr, 2, TraceOp::writeWordData,
+        [&]() { return i2c_smbus_write_word_data(fd, addr, data); },
+        [&](int) { return getValueBytes(data, 2); });
 
     if (ret < 0)
     {
@@ -330,24 +744,30 @@ void I2CDevice::write(uint8_t addr, uint16_t data)
 void I2CDevice::write(uint8_t addr, uint8_t size, const uint8_t* data,
                       Mode mode)
 {
-    checkIsOpen();
+    auto lock = prepareTransaction();
+    selectDevice();
 
-    int ret = -1, retries = 0;
+    int ret = -1;
     switch (mode)
     {
         case Mode::SMBUS:
             checkWriteFuncs(I2C_SMBUS_BLOCK_DATA);
-            do
-            {
-                ret = i2c_smbus_write_block_data(fd, addr, size, data);
-            } while ((ret < 0) && (++retries <= maxRetries));
+            ret = transaction(
+                addr, size, TraceOp::writeBlockData,
+                [&]() {
+                    return i2c_smbus_write_block_data(fd, addr, size, data);
+                },
+                [&](int) { return std::vector<uint8_t>(data, data + size); });
             break;
         case Mode::I2C:
             checkWriteFuncs(I2C_SMBUS_I2C_BLOCK_DATA);
-            do
-            {
-                ret = i2c_smbus_write_i2c_block_data(fd, addr, size, data);
-            } while ((ret < 0) && (++retries <= maxRetries));
+            ret = transaction(
+                addr, size, TraceOp::writeI2CBlockData,
+                [&]() {
+                    return i2c_smbus_write_i2c_block_data(fd, addr, size,
+                                                          data);
+                },
+                [&](int) { return std::vector<uint8_t>(data, data + size); });
             break;
     }
 
@@ -358,12 +778,101 @@ void I2CDevice::write(uint8_t addr, uint8_t size, const uint8_t* data,
     }
 }
 
+void I2CDevice::transfer(std::vector<Operation>& operations)
+{
+    auto lock = prepareTransaction();
+    if (!(getFuncs() & I2C_FUNC_I2C))
+    {
+        throw I2CException("Missing I2C_FUNC_I2C", busStr, devAddr);
+    }
+
+    // A write is one message containing the register address and the data.
+    // A read is a message writing the register address followed by a message
+    // reading the data.  Store all the bytes written in one buffer sized up
+    // front so the message pointers into it remain valid.
+    size_t writeSize = 0;
+    for (const Operation& op : operations)
+    {
+        writeSize += 1 + (op.isRead ? 0 : op.size);
+    }
+    std::vector<uint8_t> writeBuffer(writeSize);
+    std::vector<i2c_msg> msgs;
+    msgs.reserve(operations.size() * 2);
+
+    uint8_t* buffer = writeBuffer.data();
+    for (Operation& op : operations)
+    {
+        buffer[0] = op.addr;
+        if (op.isRead)
+        {
+            msgs.push_back({devAddr, 0, 1, buffer});
+            msgs.push_back({devAddr, I2C_M_RD, op.size, op.data});
+            buffer += 1;
+        }
+        else
+        {
+            std::copy(op.data, op.data + op.size, buffer + 1);
+            msgs.push_back(
+                {devAddr, 0, static_cast<uint16_t>(op.size + 1), buffer});
+            buffer += op.size + 1;
+        }
+    }
+
+    if (msgs.empty())
+    {
+        return;
+    }
+    if (msgs.size() > I2C_RDWR_IOCTL_MAX_MSGS)
+    {
+        throw I2CException("Too many messages in transfer", busStr, devAddr,
+                           EINVAL);
+    }
+
+    i2c_rdwr_ioctl_data data{msgs.data(), static_cast<uint32_t>(msgs.size())};
+
+    // Record the bytes of all the messages as the transaction length
+    size_t length = 0;
+    for (const i2c_msg& msg : msgs)
+    {
+        length += msg.len;
+    }
+
+    int ret = transaction(
+        DeviceStats::noCommand, length, TraceOp::transfer,
+        [&]() { return ioctl(fd, I2C_RDWR, &data); },
+        [&](int) {
+            std::vector<uint8_t> bytes;
+            bytes.reserve(length);
+            for (const i2c_msg& msg : msgs)
+            {
+                bytes.insert(bytes.end(), msg.buf, msg.buf + msg.len);
+            }
+            return bytes;
+        });
+
+    if (ret < 0)
+    {
+        throw I2CException("Failed to transfer", busStr, devAddr, errno);
+    }
+}
+
 std::unique_ptr<I2CInterface> I2CDevice::create(uint8_t busId, uint8_t devAddr,
                                                 InitialState initialState,
                                                 int maxRetries)
+{
+    RetryPolicy retryPolicy{};
+    retryPolicy.maxRetries = maxRetries;
+    return create(busId, devAddr, initialState, retryPolicy);
+}
+
+std::unique_ptr<I2CInterface>
+    I2CDevice::create(uint8_t busId, uint8_t devAddr,
+                      InitialState initialState,
+                      const RetryPolicy& retryPolicy,
+                      const IdlePolicy& idlePolicy)
 {
     std::unique_ptr<I2CDevice> dev(
-        new I2CDevice(busId, devAddr, initialState, maxRetries));
+        new I2CDevice(busId, devAddr, initialState, retryPolicy, idlePolicy));
     return dev;
 }
 
@@ -374,4 +883,18 @@ std::unique_ptr<I2CInterface> create(uint8_t busId, uint8_t devAddr,
     return I2CDevice::create(busId, devAddr, initialState, maxRetries);
 }
 
+std::unique_ptr<I2CInterface> create(uint8_t busId, uint8_t devAddr,
+                                     I2CInterface::InitialState initialState,
+                                     const RetryPolicy& retryPolicy,
+                                     const IdlePolicy& idlePolicy)
+{
+    return I2CDevice::create(busId, devAddr, initialState, retryPolicy,
+                             idlePolicy);
+}
+
+size_t closeIdleDevices()
+{
+    return I2CDevice::closeIdleDevices();
+}
+
 } // namespace i2c
@@ -1,6 +1,17 @@
 #pragma once
 
+#include "bus_trace.hpp"
+#include "flight_recorder.hpp"
 #include "i2c_interface.hpp"
+#include "i2c_stats.hpp"
+#include "stuck_bus.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
 
 namespace i2c
 {
@@ -19,20 +30,13 @@ class I2CDevice : public I2CInterface
      * @param[in] busId - The i2c bus ID
      * @param[in] devAddr - The device address of the I2C device
      * @param[in] initialState - Initial state of the I2CDevice object
-     * @param[in] maxRetries - Maximum number of times to retry an I2C operation
+     * @param[in] retryPolicy - Policy for retrying failed I2C operations
+     * @param[in] idlePolicy - Policy for closing the device when idle
      */
     explicit I2CDevice(uint8_t busId, uint8_t devAddr,
                        InitialState initialState = InitialState::OPEN,
-                       int maxRetries = 0) :
-        busId(busId),
-        devAddr(devAddr), maxRetries(maxRetries)
-    {
-        busStr = "/dev/i2c-" + std::to_string(busId);
-        if (initialState == InitialState::OPEN)
-        {
-            open();
-        }
-    }
+                       const RetryPolicy& retryPolicy = RetryPolicy{},
+                       const IdlePolicy& idlePolicy = IdlePolicy{});
 
     /** @brief Invalid file descriptor */
     static constexpr int INVALID_FD = -1;
@@ -40,24 +44,104 @@ class I2CDevice : public I2CInterface
     /** @brief Empty adapter functionality value with no bit flags set */
     static constexpr unsigned long NO_FUNCS = 0;
 
+    /** @brief No device address selected on a bus */
+    static constexpr int NO_ADDR = -1;
+
+    /** @brief An open i2c bus shared by all the devices on the bus
+     *
+     * The bus is opened when the first device on it is opened, and closed
+     * when the last device on it is closed.  I2C_SLAVE is only sent when a
+     * transaction is for a different device than the previous one.  Since
+     * devices on the same bus may be used from different threads, mutex is
+     * held from selecting the device to the end of the transfer, so a
+     * transfer always goes to the device that was selected for it.
+     */
+    struct Bus
+    {
+        /** @brief Mutex protecting the members below and the transfers */
+        std::mutex mutex;
+
+        /** @brief The file descriptor of the opened i2c bus */
+        int fd = INVALID_FD;
+
+        /** @brief The device address currently set with I2C_SLAVE */
+        int selectedAddr = NO_ADDR;
+
+        /** @brief Cached I2C adapter functionality value */
+        unsigned long funcs = NO_FUNCS;
+
+        /** @brief Detects that the bus is stuck */
+        StuckBusDetector stuckBus{getStuckBusPolicy()};
+
+        ~Bus();
+    };
+
+    /** @brief Get the open i2c buses in this process, by bus ID
+     *
+     * Entries expire when the last device on the bus is closed.
+     */
+    static std::map<uint8_t, std::weak_ptr<Bus>>& getBuses();
+
+    /** @brief Mutex protecting the map returned by getBuses() */
+    static std::mutex busesMutex;
+
+    /** @brief Get the devices in this process that have an idle timeout */
+    static std::set<I2CDevice*>& getIdleDevices();
+
+    /** @brief Mutex protecting the set returned by getIdleDevices() */
+    static std::mutex idleDevicesMutex;
+
     /** @brief The I2C bus ID */
     uint8_t busId;
 
     /** @brief The i2c device address in the bus */
     uint8_t devAddr;
 
-    /** @brief Maximum number of times to retry an I2C operation */
-    int maxRetries = 0;
+    /** @brief Policy for retrying failed I2C operations */
+    RetryPolicy retryPolicy;
+
+    /** @brief Policy for closing the device when idle */
+    IdlePolicy idlePolicy;
+
+    /** @brief Counters of the closes and re-opens done by the idle policy */
+    IdleStats idleStats{};
+
+    /** @brief Indicates whether the device was closed for being idle */
+    bool isIdleClosed = false;
+
+    /** @brief Time of the last open or transaction */
+    std::chrono::steady_clock::time_point lastUsedTime{};
+
+    /** @brief Mutex held while the device is used if it has an idle timeout,
+     *         so closeIdleDevices() does not close it in another thread
+     */
+    mutable std::mutex idleMutex;
+
+    /** @brief Number of times failed operations have been retried */
+    uint64_t retryCount = 0;
+
+    /** @brief Number of reads, writes and transfers performed */
+    uint64_t transactionCount = 0;
 
-    /** @brief The file descriptor of the opened i2c device */
-    int fd = INVALID_FD;
+    /** @brief Transaction statistics; null if statistics are disabled */
+    std::unique_ptr<DeviceStats> stats;
+
+    /** @brief Flight recorder of the bus; always enabled */
+    FlightRecorder* recorder;
+
+    /** @brief The file descriptor of the opened i2c bus
+     *
+     * Atomic since closeIdleDevices() may close the device while another
+     * thread checks isOpen().
+     */
+    std::atomic<int> fd = INVALID_FD;
+
+    /** @brief The opened i2c bus */
+    std::shared_ptr<Bus> bus;
 
     /** @brief The i2c bus path in /dev */
     std::string busStr;
 
-    /** @brief Cached I2C adapter functionality value */
-    unsigned long cachedFuncs = NO_FUNCS;
-
     /** @brief Check that device interface is open
      *
      * @throw I2CException if device is not open
@@ -70,12 +154,118 @@ class I2CDevice : public I2CInterface
         }
     }
 
-    /** @brief Close device without throwing an exception if an error occurs */
+    /** @brief Check whether the device is closed when idle */
+    bool hasIdleTimeout() const
+    {
+        return (idlePolicy.idleTimeout.count() > 0);
+    }
+
+    /** @brief Lock idleMutex if the device has an idle timeout
+     *
+     * @return The lock; does not own a mutex if there is no idle timeout
+     */
+    std::unique_lock<std::mutex> lockIfIdlePolicy() const;
+
+    /** @brief Locks held during a transaction */
+    struct TransactionLock
+    {
+        /** @brief Lock of idleMutex; does not own it if there is no idle
+         *         timeout
+         */
+        std::unique_lock<std::mutex> idleLock;
+
+        /** @brief Lock of the bus mutex, released first */
+        std::unique_lock<std::mutex> busLock;
+    };
+
+    /** @brief Prepare the device for a transaction
+     *
+     * Locks idleMutex if the device has an idle timeout, opens the device if
+     * it is closed, and locks the bus mutex.
+     *
+     * @throw I2CException if the device is not open and cannot be opened
+     * @return The locks held during the transaction
+     */
+    TransactionLock prepareTransaction();
+
+    /** @brief Open the device without locking idleMutex
+     *
+     * @throw I2CException on error
+     */
+    void openDevice();
+
+    /** @brief Close the device without locking idleMutex
+     *
+     * @throw I2CException on error
+     */
+    void closeDevice();
+
+    /** @brief Select this device on the shared bus with I2C_SLAVE
+     *
+     * Does nothing if this device was the last one selected on the bus.
+     * Must be called with the bus mutex locked.
+     *
+     * @throw I2CException on error
+     */
+    void selectDevice();
+
+    /** @brief Perform an operation, retrying it based on the retry policy
+     *
+     * Stops retrying if the bus is stuck.  The errno value from the last
+     * attempt is preserved.
+     *
+     * @param[in] operation - Function performing the operation.  Returns a
+     *                        negative value and sets errno on failure.
+     *
+     * @return Value returned by the last attempt
+     */
+    template <typename Func>
+    int retry(Func operation);
+
+    /** @brief Perform a transaction and record it in the flight recorder,
+     *         statistics, and bus trace
+     *
+     * Retries the transaction based on the retry policy, unless the bus is
+     * stuck (see StuckBusPolicy).
+     *
+     * @param[in] command - Command code, or DeviceStats::noCommand
+     * @param[in] length - Number of data bytes requested
+     * @param[in] op - Kind of transaction, for the bus trace
+     * @param[in] operation - Function performing the transaction.  Returns a
+     *                        negative value and sets errno on failure.
+     * @param[in] traceData - Function returning the bytes written or read,
+     *                        given the value returned by the operation.
+     *                        Only called if the transaction succeeded while
+     *                        a bus trace is started.
+     *
+     * @throw I2CException if the bus is stuck and the transaction is not
+     *        attempted
+     * @return Value returned by the last attempt
+     */
+    template <typename Func, typename Data>
+    int transaction(size_t command, size_t length, TraceOp op, Func operation,
+                    Data traceData);
+
+    /** @brief Wait before a retry
+     *
+     * @param[in] start - Time of the first attempt
+     * @param[in,out] delay - Time to wait, not including jitter.  Updated to
+     *                        the time to wait before the next retry.
+     *
+     * @return true if waited, false if the retry would pass the deadline
+     */
+    bool waitToRetry(std::chrono::steady_clock::time_point start,
+                     std::chrono::microseconds& delay);
+
+    /** @brief Close device without throwing an exception if an error occurs
+     *
+     * Does not lock idleMutex.
+     */
     void closeWithoutException() noexcept
     {
         try
         {
-            close();
+            closeDevice();
         }
         catch (...)
         {}
@@ -84,7 +274,8 @@ class I2CDevice : public I2CInterface
     /** @brief Get I2C adapter functionality
      *
      * Caches the adapter functionality value since it shouldn't change after
-     * opening the device.
+     * opening the bus.  The value is shared by all devices on the bus, so
+     * this must be called with the bus mutex locked.
      *
      * @throw I2CException on error
      * @return Adapter functionality value
@@ -115,14 +306,7 @@ class I2CDevice : public I2CInterface
 
   public:
     /** @copydoc I2CInterface::~I2CInterface() */
-    ~I2CDevice()
-    {
-        if (isOpen())
-        {
-            // Note: destructors must not throw exceptions
-            closeWithoutException();
-        }
-    }
+    ~I2CDevice();
 
     /** @copydoc I2CInterface::open() */
     void open();
@@ -149,9 +333,15 @@ class I2CDevice : public I2CInterface
     void read(uint8_t addr, uint8_t& size, uint8_t* data,
               Mode mode = Mode::SMBUS) override;
 
+    /** @copydoc I2CInterface::readLarge(uint8_t,std::span<uint8_t>) */
+    void readLarge(uint8_t addr, std::span<uint8_t> data) override;
+
     /** @copydoc I2CInterface::write(uint8_t) */
     void write(uint8_t data) override;
 
+    /** @copydoc I2CInterface::writeQuick() */
+    void writeQuick() override;
+
     /** @copydoc I2CInterface::write(uint8_t,uint8_t) */
     void write(uint8_t addr, uint8_t data) override;
 
@@ -162,6 +352,53 @@ class I2CDevice : public I2CInterface
     void write(uint8_t addr, uint8_t size, const uint8_t* data,
                Mode mode = Mode::SMBUS) override;
 
+    /** @copydoc I2CInterface::transfer(std::vector<Operation>&) */
+    void transfer(std::vector<Operation>& operations) override;
+
+    /** @copydoc I2CInterface::getBus() */
+    uint8_t getBus() const override
+    {
+        return busId;
+    }
+
+    /** @copydoc I2CInterface::getAddress() */
+    uint8_t getAddress() const override
+    {
+        return devAddr;
+    }
+
+    /** @copydoc I2CInterface::getRetryCount() */
+    uint64_t getRetryCount() const override
+    {
+        return retryCount;
+    }
+
+    /** @copydoc I2CInterface::getTransactionCount() */
+    uint64_t getTransactionCount() const override
+    {
+        return transactionCount;
+    }
+
+    /** @copydoc I2CInterface::setStatsEnabled(bool) */
+    void setStatsEnabled(bool enable) override;
+
+    /** @copydoc I2CInterface::getStats() */
+    std::string getStats() const override
+    {
+        return stats ? stats->toString() : std::string{};
+    }
+
+    /** @copydoc I2CInterface::getIdleStats() */
+    IdleStats getIdleStats() const override;
+
+    /** @brief Close the devices that have been idle for their idle timeout
+     *
+     * Devices that are being used by another thread are skipped.
+     *
+     * @return The number of devices closed
+     */
+    static size_t closeIdleDevices();
+
     /** @brief Create an I2CInterface instance
      *
      * Automatically opens the I2CInterface if initialState is OPEN.
@@ -177,6 +414,23 @@ class I2CDevice : public I2CInterface
         create(uint8_t busId, uint8_t devAddr,
                InitialState initialState = InitialState::OPEN,
                int maxRetries = 0);
+
+    /** @brief Create an I2CInterface instance that retries based on a policy
+     *
+     * Automatically opens the I2CInterface if initialState is OPEN.
+     *
+     * @param[in] busId - The i2c bus ID
+     * @param[in] devAddr - The device address of the i2c
+     * @param[in] initialState - Initial state of the I2CInterface object
+     * @param[in] retryPolicy - Policy for retrying failed I2C operations
+     * @param[in] idlePolicy - Policy for closing the device when idle
+     *
+     * @return The unique_ptr holding the I2CInterface
+     */
+    static std::unique_ptr<I2CInterface>
+        create(uint8_t busId, uint8_t devAddr, InitialState initialState,
+               const RetryPolicy& retryPolicy,
+               const IdlePolicy& idlePolicy = IdlePolicy{});
 };
 
 } // namespace i2c
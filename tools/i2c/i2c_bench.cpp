@@ -0,0 +1,212 @@
+#include "i2c_interface.hpp"
+
+#include <CLI/CLI.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+/** @brief Results of running one kind of transaction repeatedly */
+struct Result
+{
+    /** @brief Number of transactions that failed */
+    size_t errors = 0;
+
+    /** @brief Time taken by all the transactions */
+    Clock::duration elapsed{0};
+
+    /** @brief Time taken by each transaction, sorted */
+    std::vector<std::chrono::microseconds> latencies;
+};
+
+/** @brief Parse an integer that may have a 0x prefix */
+unsigned long parseNumber(const std::string& text)
+{
+    size_t end = 0;
+    unsigned long value = std::stoul(text, &end, 0);
+    if (end != text.size())
+    {
+        throw std::invalid_argument{"Invalid number: " + text};
+    }
+    return value;
+}
+
+/** @brief Run a transaction count times, timing each one */
+Result run(const std::function<void()>& transaction, size_t count)
+{
+    Result result;
+    result.latencies.reserve(count);
+
+    auto start = Clock::now();
+    for (size_t i = 0; i < count; ++i)
+    {
+        auto begin = Clock::now();
+        try
+        {
+            transaction();
+        }
+        catch (const i2c::I2CException&)
+        {
+            ++result.errors;
+        }
+        result.latencies.push_back(
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                Clock::now() - begin));
+    }
+    result.elapsed = Clock::now() - start;
+
+    std::sort(result.latencies.begin(), result.latencies.end());
+    return result;
+}
+
+/** @brief Get a percentile of the sorted latencies, in microseconds */
+long long percentile(const Result& result, size_t percent)
+{
+    if (result.latencies.empty())
+    {
+        return 0;
+    }
+    size_t index = (result.latencies.size() - 1) * percent / 100;
+    return result.latencies[index].count();
+}
+
+/** @brief Print one row of the results table */
+void print(const std::string& test, int retries, size_t bytes,
+           const Result& result)
+{
+    double seconds = std::chrono::duration<double>(result.elapsed).count();
+    size_t count = result.latencies.size();
+    double perSecond = (seconds > 0.0) ? (count / seconds) : 0.0;
+    std::printf("%-12s %7d %5zu %8zu %8zu %10.1f %10.1f %7lld %7lld %7lld "
+                "%7lld\n",
+                test.c_str(), retries, bytes, count, result.errors, perSecond,
+                perSecond * bytes, percentile(result, 0),
+                percentile(result, 50), percentile(result, 99),
+                percentile(result, 100));
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    std::string busText;
+    std::string addressText;
+    std::string registerText{"0x00"};
+    size_t count = 1000;
+    size_t blockSize = 32;
+    int retries = 3;
+    std::vector<std::string> tests{"byte", "word", "smbus-block",
+                                   "i2c-block"};
+
+    CLI::App app{"Measure the I2C transaction rate and latency for a device"};
+    app.add_option("-b,--bus", busText, "I2C bus number")->required();
+    app.add_option("-a,--address", addressText, "7-bit device address")
+        ->required();
+    app.add_option("-r,--register", registerText,
+                   "Register to read (default 0x00)");
+    app.add_option("-n,--count", count,
+                   "Transactions per test (default 1000)");
+    app.add_option("-s,--block-size", blockSize,
+                   "Bytes per I2C block read, 1 to 32 (default 32)");
+    app.add_option("--retries", retries,
+                   "Retries for the runs with retries; 0 runs only without "
+                   "retries (default 3)");
+    app.add_option("-t,--tests", tests,
+                   "Tests to run: byte, word, smbus-block, i2c-block "
+                   "(default all)");
+    CLI11_PARSE(app, argc, argv);
+
+    try
+    {
+        auto bus = static_cast<uint8_t>(parseNumber(busText));
+        auto address = static_cast<uint8_t>(parseNumber(addressText));
+        auto reg = static_cast<uint8_t>(parseNumber(registerText));
+        if ((blockSize < 1) || (blockSize > 32))
+        {
+            throw std::invalid_argument{"Invalid block size"};
+        }
+
+        std::vector<int> retryCounts{0};
+        if (retries > 0)
+        {
+            retryCounts.push_back(retries);
+        }
+
+        std::printf("%-12s %7s %5s %8s %8s %10s %10s %7s %7s %7s %7s\n",
+                    "test", "retries", "bytes", "count", "errors", "xfers/s",
+                    "bytes/s", "min_us", "p50_us", "p99_us", "max_us");
+
+        for (const std::string& test : tests)
+        {
+            for (int retryCount : retryCounts)
+            {
+                auto device = i2c::create(
+                    bus, address, i2c::I2CInterface::InitialState::OPEN,
+                    retryCount);
+
+                std::array<uint8_t, 32> data{};
+                std::function<void()> transaction;
+                size_t bytes = 0;
+                if (test == "byte")
+                {
+                    bytes = 1;
+                    transaction = [&]() { device->read(reg, data[0]); };
+                }
+                else if (test == "word")
+                {
+                    bytes = 2;
+                    transaction = [&]() {
+                        uint16_t word = 0;
+                        device->read(reg, word);
+                    };
+                }
+                else if (test == "smbus-block")
+                {
+                    // The device chooses the size
+                    transaction = [&]() {
+                        uint8_t size = 0;
+                        device->read(reg, size, data.data(),
+                                     i2c::I2CInterface::Mode::SMBUS);
+                        bytes = size;
+                    };
+                }
+                else if (test == "i2c-block")
+                {
+                    bytes = blockSize;
+                    transaction = [&]() {
+                        auto size = static_cast<uint8_t>(blockSize);
+                        device->read(reg, size, data.data(),
+                                     i2c::I2CInterface::Mode::I2C);
+                    };
+                }
+                else
+                {
+                    throw std::invalid_argument{"Invalid test: " + test};
+                }
+
+                Result result = run(transaction, count);
+                print(test, retryCount, bytes, result);
+            }
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+
+    return 0;
+}
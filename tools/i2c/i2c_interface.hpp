@@ -1,10 +1,13 @@
 #pragma once
 
+#include <chrono>
+#include <cstddef>
 #include <cstdint>
 #include <cstring>
 #include <exception>
 #include <iostream>
 #include <memory>
+#include <span>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -42,6 +45,70 @@ class I2CException : public std::exception
     std::string errStr;
 };
 
+/** @brief Policy for retrying failed I2C operations
+ *
+ * A failed operation is retried up to maxRetries times.  The first retry
+ * waits initialDelay, and each later retry waits twice as long as the
+ * previous one, up to maxDelay.  A random amount of time up to maxJitter is
+ * added to each wait so that devices contending for a bus do not retry in
+ * lock step.  No retry is started if it would end after deadline has passed
+ * since the first attempt; a deadline of zero means no deadline.
+ *
+ * The default policy retries immediately, which is the behavior of the
+ * maxRetries parameter of create().
+ */
+struct RetryPolicy
+{
+    /** @brief Maximum number of times to retry an I2C operation */
+    int maxRetries = 0;
+
+    /** @brief Time to wait before the first retry */
+    std::chrono::microseconds initialDelay{0};
+
+    /** @brief Maximum time to wait before a retry, not including jitter */
+    std::chrono::microseconds maxDelay{0};
+
+    /** @brief Maximum random time added to each wait */
+    std::chrono::microseconds maxJitter{0};
+
+    /** @brief Maximum time from the first attempt to the end of a retry */
+    std::chrono::microseconds deadline{0};
+};
+
+/** @brief Policy for closing an I2C interface that is not being used
+ *
+ * An interface with an idle timeout is opened by a transaction if it is not
+ * open, so open() does not need to be called first.  It is closed by
+ * closeIdleDevices() when it has not been used for idleTimeout.  Devices that
+ * are rarely used, such as ones only used when they are configured, then do
+ * not keep their i2c bus open, while devices that are used often stay open.
+ *
+ * The default policy has no idle timeout, so the interface stays open until
+ * close() is called.
+ */
+struct IdlePolicy
+{
+    /** @brief Time without transactions after which the interface is closed;
+     *         zero means never
+     */
+    std::chrono::milliseconds idleTimeout{0};
+};
+
+/** @brief Counters of the closes and re-opens done by an idle policy */
+struct IdleStats
+{
+    /** @brief Number of times the interface was closed for being idle */
+    uint64_t idleCloseCount = 0;
+
+    /** @brief Number of times the interface was opened after being closed
+     *         for being idle
+     */
+    uint64_t reopenCount = 0;
+
+    /** @brief Total time spent re-opening the interface */
+    std::chrono::microseconds reopenTime{0};
+};
+
 class I2CInterface
 {
   public:
@@ -65,6 +132,29 @@ class I2CInterface
         I2C,
     };
 
+    /** @brief A register read or write in a combined transaction
+     *
+     * A read sends the register address and then reads size bytes into
+     * data.  A write sends the register address followed by the size bytes
+     * in data.  The data uses the plain I2C format (like Mode::I2C block
+     * transactions), so no SMBus byte count or PEC is sent or expected.
+     */
+    struct Operation
+    {
+        /** @brief Indicates whether this is a read or a write */
+        bool isRead;
+
+        /** @brief The register address of the i2c device */
+        uint8_t addr;
+
+        /** @brief Number of bytes to read or write */
+        uint8_t size;
+
+        /** @brief Buffer holding the data to write or receiving the data read
+         */
+        uint8_t* data;
+    };
+
     /** @brief Open the I2C interface to the device
      *
      * Throws an I2CException if the interface is already open.  See isOpen().
@@ -141,6 +231,25 @@ class I2CInterface
     virtual void read(uint8_t addr, uint8_t& size, uint8_t* data,
                       Mode mode = Mode::SMBUS) = 0;
 
+    /** @brief Read a large block of data from i2c
+     *
+     * Writes the register address and then reads data.size() bytes with a
+     * repeated start, all in one combined I2C transaction.  Unlike the block
+     * reads, the size is not limited to the 32 bytes of SMBus, so large
+     * objects such as input history or fault logs can be read at once.  The
+     * Linux i2c-dev driver allows at most 8192 bytes.
+     *
+     * The data uses the plain I2C format (like Mode::I2C block reads), so no
+     * SMBus byte count or PEC is expected.
+     *
+     * @param[in] addr - The register address of the i2c device
+     * @param[out] data - The buffer receiving the data read; its size is the
+     *                    number of bytes to read
+     *
+     * @throw I2CException on error
+     */
+    virtual void readLarge(uint8_t addr, std::span<uint8_t> data) = 0;
+
     /** @brief Write byte data to i2c
      *
      * @param[in] data - The data to write to the i2c device
@@ -149,6 +258,15 @@ class I2CInterface
      */
     virtual void write(uint8_t data) = 0;
 
+    /** @brief Send an SMBus quick command to i2c
+     *
+     * Only the device address is sent, with the write bit, so the command
+     * can be used to detect whether a device acknowledges its address.
+     *
+     * @throw I2CException on error
+     */
+    virtual void writeQuick() = 0;
+
     /** @brief Write byte data to i2c
      *
      * @param[in] addr - The register address of the i2c device
@@ -185,6 +303,80 @@ class I2CInterface
      */
     virtual void write(uint8_t addr, uint8_t size, const uint8_t* data,
                        Mode mode = Mode::SMBUS) = 0;
+
+    /** @brief Perform several reads and writes in one combined transaction
+     *
+     * The operations are sent to the device in order as a single combined
+     * I2C transaction, with a repeated start between the messages.  This
+     * costs one system call no matter how many operations there are.
+     *
+     * Word values are transferred low-order byte first, the same as the SMBus
+     * Read Word and Write Word protocols.
+     *
+     * @param[in,out] operations - The reads and writes to perform.  The data
+     *                             buffers of reads are filled in.
+     *
+     * @throw I2CException on error
+     */
+    virtual void transfer(std::vector<Operation>& operations) = 0;
+
+    /** @brief Get the i2c bus ID of the device
+     *
+     * @return bus ID
+     */
+    virtual uint8_t getBus() const = 0;
+
+    /** @brief Get the i2c address of the device
+     *
+     * @return device address
+     */
+    virtual uint8_t getAddress() const = 0;
+
+    /** @brief Get the number of times failed operations have been retried
+     *
+     * The count accumulates over the lifetime of this object.
+     *
+     * @return retry count
+     */
+    virtual uint64_t getRetryCount() const = 0;
+
+    /** @brief Get the number of reads, writes and transfers performed
+     *
+     * Retries are not counted separately.  The count accumulates over the
+     * lifetime of this object.
+     *
+     * @return transaction count
+     */
+    virtual uint64_t getTransactionCount() const = 0;
+
+    /** @brief Enable or disable collecting transaction statistics
+     *
+     * When enabled, the latency, errors and retries of each read and write
+     * are recorded by command code.  Disabling discards the statistics.
+     *
+     * @param[in] enable - Enable or disable statistics
+     */
+    virtual void setStatsEnabled(bool enable) = 0;
+
+    /** @brief Get the transaction statistics as text
+     *
+     * Contains one line per command code with the transaction count, error
+     * count, retry count, and a log2 histogram of the latencies in
+     * microseconds.  Histogram buckets are written as <lower bound>:<count>.
+     *
+     * @return statistics text, or an empty string if statistics are disabled
+     */
+    virtual std::string getStats() const = 0;
+
+    /** @brief Get the counters of the closes and re-opens done by the idle
+     *         policy
+     *
+     * The counters accumulate over the lifetime of this object.  See
+     * IdlePolicy.
+     *
+     * @return idle policy counters; all zero if there is no idle timeout
+     */
+    virtual IdleStats getIdleStats() const = 0;
 };
 
 /** @brief Create an I2CInterface instance
@@ -203,4 +395,35 @@ std::unique_ptr<I2CInterface> create(
     I2CInterface::InitialState initialState = I2CInterface::InitialState::OPEN,
     int maxRetries = 0);
 
+/** @brief Create an I2CInterface instance that retries based on a policy
+ *
+ * Automatically opens the I2CInterface if initialState is OPEN.  If the idle
+ * policy has an idle timeout, the interface is also opened by the first
+ * transaction and closed by closeIdleDevices() when idle.
+ *
+ * @param[in] busId - The i2c bus ID
+ * @param[in] devAddr - The device address of the i2c
+ * @param[in] initialState - Initial state of the I2CInterface object
+ * @param[in] retryPolicy - Policy for retrying failed I2C operations
+ * @param[in] idlePolicy - Policy for closing the interface when idle
+ *
+ * @return The unique_ptr holding the I2CInterface
+ */
+std::unique_ptr<I2CInterface>
+    create(uint8_t busId, uint8_t devAddr,
+           I2CInterface::InitialState initialState,
+           const RetryPolicy& retryPolicy,
+           const IdlePolicy& idlePolicy = IdlePolicy{});
+
+/** @brief Close the I2CInterface instances that have been idle for the idle
+ *         timeout of their idle policy
+ *
+ * Should be called periodically, such as from a timer, by a process that
+ * creates interfaces with an idle timeout.  An interface that is being used
+ * by another thread is not closed.
+ *
+ * @return The number of interfaces closed
+ */
+size_t closeIdleDevices();
+
 } // namespace i2c
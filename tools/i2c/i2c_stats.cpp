@@ -0,0 +1,69 @@
+#include "i2c_stats.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <sstream>
+
+namespace i2c
+{
+
+void TransactionStats::record(std::chrono::microseconds latency, bool failed,
+                              uint64_t retryCount) noexcept
+{
+    using rep = std::chrono::microseconds::rep;
+    auto us = static_cast<uint64_t>(std::max<rep>(latency.count(), 1));
+    size_t bucket = std::bit_width(us) - 1;
+    if (bucket >= bucketCount)
+    {
+        bucket = bucketCount - 1;
+    }
+
+    buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    count.fetch_add(1, std::memory_order_relaxed);
+    if (failed)
+    {
+        errors.fetch_add(1, std::memory_order_relaxed);
+    }
+    retries.fetch_add(retryCount, std::memory_order_relaxed);
+}
+
+std::string DeviceStats::toString() const
+{
+    std::stringstream ss;
+    for (size_t command = 0; command < stats.size(); ++command)
+    {
+        const TransactionStats& cmdStats = stats[command];
+        if (cmdStats.getCount() == 0)
+        {
+            continue;
+        }
+
+        if (command == noCommand)
+        {
+            ss << "cmd none";
+        }
+        else
+        {
+            ss << "cmd 0x" << std::hex << command << std::dec;
+        }
+        ss << " count " << cmdStats.getCount() << " errors "
+           << cmdStats.getErrorCount() << " retries "
+           << cmdStats.getRetryCount() << " latency_us";
+
+        // Print the non-empty buckets as <lower bound>:<count>
+        for (size_t bucket = 0; bucket < TransactionStats::bucketCount;
+             ++bucket)
+        {
+            uint64_t bucketCount = cmdStats.getBucketCount(bucket);
+            if (bucketCount != 0)
+            {
+                ss << ' ' << (bucket == 0 ? 0 : (1ULL << bucket)) << ':'
+                   << bucketCount;
+            }
+        }
+        ss << '\n';
+    }
+    return ss.str();
+}
+
+} // namespace i2c
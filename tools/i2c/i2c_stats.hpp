@@ -0,0 +1,126 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace i2c
+{
+
+/** @class TransactionStats
+ *
+ * Latency histogram and counters for one kind of I2C transaction.
+ *
+ * Latencies are counted in log2 buckets.  Bucket 0 counts transactions that
+ * took less than 2 microseconds, and bucket n counts transactions that took
+ * from 2^n up to 2^(n+1) microseconds.  The last bucket also counts all
+ * slower transactions.  The latency of a transaction includes its retries.
+ *
+ * The counters are atomic so they can be read while they are being updated.
+ */
+class TransactionStats
+{
+  public:
+    /** @brief Number of latency buckets */
+    static constexpr size_t bucketCount = 21;
+
+    /** @brief Record a transaction
+     *
+     * @param[in] latency - Time the transaction took, including retries
+     * @param[in] failed - Indicates whether the transaction failed
+     * @param[in] retries - Number of times the transaction was retried
+     */
+    void record(std::chrono::microseconds latency, bool failed,
+                uint64_t retries) noexcept;
+
+    /** @brief Get the number of transactions
+     *
+     * @return transaction count
+     */
+    uint64_t getCount() const noexcept
+    {
+        return count.load(std::memory_order_relaxed);
+    }
+
+    /** @brief Get the number of failed transactions
+     *
+     * @return error count
+     */
+    uint64_t getErrorCount() const noexcept
+    {
+        return errors.load(std::memory_order_relaxed);
+    }
+
+    /** @brief Get the number of retries across all transactions
+     *
+     * @return retry count
+     */
+    uint64_t getRetryCount() const noexcept
+    {
+        return retries.load(std::memory_order_relaxed);
+    }
+
+    /** @brief Get the number of transactions counted in a latency bucket
+     *
+     * @param[in] bucket - Bucket index, less than bucketCount
+     *
+     * @return transaction count
+     */
+    uint64_t getBucketCount(size_t bucket) const noexcept
+    {
+        return buckets[bucket].load(std::memory_order_relaxed);
+    }
+
+  private:
+    /** @brief Transaction count of each latency bucket */
+    std::array<std::atomic<uint64_t>, bucketCount> buckets{};
+
+    /** @brief Number of transactions */
+    std::atomic<uint64_t> count{0};
+
+    /** @brief Number of failed transactions */
+    std::atomic<uint64_t> errors{0};
+
+    /** @brief Number of retries */
+    std::atomic<uint64_t> retries{0};
+};
+
+/** @class DeviceStats
+ *
+ * Transaction statistics for one I2C device, by command code.
+ */
+class DeviceStats
+{
+  public:
+    /** @brief Index of the transactions that have no command code, such as
+     *         byte reads and combined transfers */
+    static constexpr size_t noCommand = 256;
+
+    /** @brief Get the statistics for a command code
+     *
+     * @param[in] command - Command code, or noCommand
+     *
+     * @return statistics
+     */
+    TransactionStats& get(size_t command)
+    {
+        return stats[command];
+    }
+
+    /** @brief Get the statistics as text
+     *
+     * Contains one line for each command code that has been used.
+     *
+     * @return statistics text
+     */
+    std::string toString() const;
+
+  private:
+    /** @brief Statistics of each command code, followed by noCommand */
+    std::array<TransactionStats, noCommand + 1> stats{};
+};
+
+} // namespace i2c
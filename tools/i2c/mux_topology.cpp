@@ -0,0 +1,119 @@
+#include "mux_topology.hpp"
+
+#include <charconv>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+namespace i2c
+{
+
+namespace fs = std::filesystem;
+
+namespace
+{
+
+/** @brief Maximum number of muxes between a bus and its root adapter */
+constexpr size_t maxMuxDepth = 8;
+
+/** @brief Parse a number that must fill the whole string */
+template <typename T>
+std::optional<T> parseNumber(std::string_view text, int base)
+{
+    T value{};
+    auto [end, ec] =
+        std::from_chars(text.data(), text.data() + text.size(), value, base);
+    if ((ec != std::errc{}) || (end != text.data() + text.size()) ||
+        text.empty())
+    {
+        return std::nullopt;
+    }
+    return value;
+}
+
+/** @brief Get the bus ID of an adapter directory name, like i2c-10 */
+std::optional<uint8_t> parseAdapterName(std::string_view name)
+{
+    constexpr std::string_view prefix{"i2c-"};
+    if (!name.starts_with(prefix))
+    {
+        return std::nullopt;
+    }
+    return parseNumber<uint8_t>(name.substr(prefix.size()), 10);
+}
+
+/** @brief Find the channel of a mux that created an adapter
+ *
+ * The mux device directory has a channel-C link to the adapter of each
+ * channel.
+ */
+uint8_t findChannel(const fs::path& muxDir, uint8_t busId)
+{
+    constexpr std::string_view prefix{"channel-"};
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator(muxDir, ec))
+    {
+        std::string name = entry.path().filename().string();
+        if (!std::string_view{name}.starts_with(prefix))
+        {
+            continue;
+        }
+
+        fs::path target = fs::read_symlink(entry.path(), ec);
+        if (!ec && (parseAdapterName(target.filename().string()) == busId))
+        {
+            auto channel = parseNumber<uint8_t>(
+                std::string_view{name}.substr(prefix.size()), 10);
+            if (channel)
+            {
+                return *channel;
+            }
+        }
+    }
+    return MuxChannel::unknownChannel;
+}
+
+} // namespace
+
+BusTopology getBusTopology(uint8_t busId, const fs::path& devicesDir)
+{
+    std::vector<MuxChannel> channels;
+    uint8_t bus = busId;
+    for (size_t depth = 0; depth < maxMuxDepth; ++depth)
+    {
+        // The adapter of a mux channel links to the mux device, which is
+        // named <parent bus>-<4 digit hex address>
+        fs::path muxDir = devicesDir / ("i2c-" + std::to_string(bus)) /
+                          "mux_device";
+        std::error_code ec;
+        fs::path muxDevice = fs::read_symlink(muxDir, ec);
+        if (ec)
+        {
+            break;
+        }
+
+        std::string name = muxDevice.filename().string();
+        auto dash = name.find('-');
+        if (dash == std::string::npos)
+        {
+            break;
+        }
+        auto parentBus =
+            parseNumber<uint8_t>(std::string_view{name}.substr(0, dash), 10);
+        auto address =
+            parseNumber<uint16_t>(std::string_view{name}.substr(dash + 1), 16);
+        if (!parentBus || !address || (*address > 0x7F))
+        {
+            break;
+        }
+
+        channels.insert(channels.begin(),
+                        MuxChannel{*parentBus, static_cast<uint8_t>(*address),
+                                   findChannel(muxDir, bus)});
+        bus = *parentBus;
+    }
+    return BusTopology{bus, std::move(channels)};
+}
+
+} // namespace i2c
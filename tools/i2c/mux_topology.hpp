@@ -0,0 +1,70 @@
+#pragma once
+
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+namespace i2c
+{
+
+/** @brief Directory containing the I2C adapters and devices in sysfs */
+constexpr auto sysfsI2CDevicesDir = "/sys/bus/i2c/devices";
+
+/** @brief One channel of an I2C mux, such as a PCA954x
+ *
+ * The kernel creates an adapter, /dev/i2c-N, for each channel.  A
+ * transaction on the adapter first writes the mux to select the channel,
+ * unless the channel is already selected.
+ */
+struct MuxChannel
+{
+    /** @brief Value of channel if the channel number is not known */
+    static constexpr uint8_t unknownChannel = 0xFF;
+
+    /** @brief The i2c bus ID the mux is on */
+    uint8_t parentBus = 0;
+
+    /** @brief The mux device address */
+    uint8_t address = 0;
+
+    /** @brief The channel number, or unknownChannel */
+    uint8_t channel = unknownChannel;
+
+    auto operator<=>(const MuxChannel&) const = default;
+};
+
+/** @brief Where an i2c bus is in the mux topology
+ *
+ * Buses with the same rootBus share the same physical bus, so only one
+ * transaction can be performed on them at a time.  Ordering buses by this
+ * structure puts the channels of each mux next to each other.
+ */
+struct BusTopology
+{
+    /** @brief The i2c bus ID of the adapter that is not behind a mux */
+    uint8_t rootBus = 0;
+
+    /** @brief The mux channels from rootBus down to the bus; empty if the
+     *         bus is not behind a mux */
+    std::vector<MuxChannel> channels{};
+
+    auto operator<=>(const BusTopology&) const = default;
+};
+
+/** @brief Get where an i2c bus is in the mux topology
+ *
+ * Reads the mux_device links of the adapters in sysfs.  If the topology
+ * cannot be read, the bus is treated as not being behind a mux.
+ *
+ * @param[in] busId - The i2c bus ID
+ * @param[in] devicesDir - Directory containing the I2C adapters and devices
+ *
+ * @return topology of the bus
+ */
+BusTopology getBusTopology(uint8_t busId,
+                           const std::filesystem::path& devicesDir =
+                               sysfsI2CDevicesDir);
+
+} // namespace i2c
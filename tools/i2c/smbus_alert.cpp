@@ -0,0 +1,58 @@
+#include "smbus_alert.hpp"
+
+#include <algorithm>
+#include <cerrno>
+
+namespace i2c
+{
+
+std::optional<uint8_t> readAlertResponse(I2CInterface& ara)
+{
+    uint8_t data = 0;
+    try
+    {
+        ara.read(data);
+    }
+    catch (const I2CException& e)
+    {
+        // No device acknowledged the address, so none is alerting
+        if ((e.errorCode == ENXIO) || (e.errorCode == EREMOTEIO))
+        {
+            return std::nullopt;
+        }
+        throw;
+    }
+
+    // The device address is in the upper 7 bits
+    return static_cast<uint8_t>(data >> 1);
+}
+
+std::vector<uint8_t> AlertSource::getAlertingAddresses()
+{
+    std::vector<uint8_t> addresses;
+    if (!ara->isOpen())
+    {
+        ara->open();
+    }
+
+    while ((addresses.size() < maxAddresses) && isAsserted())
+    {
+        auto address = readAlertResponse(*ara);
+        if (!address)
+        {
+            break;
+        }
+
+        if (std::find(addresses.begin(), addresses.end(), *address) !=
+            addresses.end())
+        {
+            // The device is still asserting SMBALERT#; reading again would
+            // only return it again
+            break;
+        }
+        addresses.push_back(*address);
+    }
+    return addresses;
+}
+
+} // namespace i2c
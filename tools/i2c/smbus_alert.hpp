@@ -0,0 +1,107 @@
+#pragma once
+
+#include "i2c_interface.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace i2c
+{
+
+/** @brief SMBus Alert Response Address
+ *
+ * A device asserting SMBALERT# answers a receive byte from this address with
+ * its own address.  If several devices are asserting it, the one with the
+ * lowest address wins arbitration and stops asserting SMBALERT#.
+ */
+constexpr uint8_t alertResponseAddress = 0x0C;
+
+/** @brief Read the Alert Response Address on a bus
+ *
+ * @param[in] ara - Interface to the Alert Response Address of the bus
+ *
+ * @return 7-bit address of the device that responded, or std::nullopt if no
+ *         device is asserting SMBALERT#
+ *
+ * @throw I2CException on an error other than no device responding
+ */
+std::optional<uint8_t> readAlertResponse(I2CInterface& ara);
+
+/** @class AlertSource
+ *
+ * The SMBALERT# line of an I2C bus.
+ *
+ * The line is typically a GPIO watched for edge events by the daemon.  When
+ * it is asserted, getAlertingAddresses() finds the devices asserting it by
+ * reading the Alert Response Address until the line is released, so only
+ * those devices need to be checked for faults.
+ *
+ * The GPIO is read through a function so this library does not depend on a
+ * GPIO library.  If the line cannot be read, the function can return true
+ * and the Alert Response Address is read until no device responds.
+ */
+class AlertSource
+{
+  public:
+    /** @brief Default maximum number of addresses read for one alert */
+    static constexpr size_t defaultMaxAddresses = 16;
+
+    AlertSource() = delete;
+    AlertSource(const AlertSource&) = delete;
+    AlertSource& operator=(const AlertSource&) = delete;
+    AlertSource(AlertSource&&) = default;
+    AlertSource& operator=(AlertSource&&) = default;
+    ~AlertSource() = default;
+
+    /** @brief Constructor
+     *
+     * @param[in] ara - Interface to the Alert Response Address of the bus
+     * @param[in] isAsserted - Function returning whether SMBALERT# is
+     *                         asserted
+     * @param[in] maxAddresses - Maximum number of addresses read for one
+     *                           alert, in case a device keeps SMBALERT#
+     *                           asserted after responding
+     */
+    AlertSource(std::unique_ptr<I2CInterface> ara,
+                std::function<bool()> isAsserted,
+                size_t maxAddresses = defaultMaxAddresses) :
+        ara(std::move(ara)),
+        isAsserted(std::move(isAsserted)), maxAddresses(maxAddresses)
+    {}
+
+    /** @brief Get the i2c bus ID
+     *
+     * @return bus ID
+     */
+    uint8_t getBus() const
+    {
+        return ara->getBus();
+    }
+
+    /** @brief Find the devices asserting SMBALERT#
+     *
+     * Reads the Alert Response Address while the line is asserted.  Each
+     * address is only returned once.
+     *
+     * @return 7-bit addresses of the devices, in the order they responded
+     *
+     * @throw I2CException if the Alert Response Address cannot be read
+     */
+    std::vector<uint8_t> getAlertingAddresses();
+
+  private:
+    /** @brief Interface to the Alert Response Address */
+    std::unique_ptr<I2CInterface> ara;
+
+    /** @brief Function returning whether SMBALERT# is asserted */
+    std::function<bool()> isAsserted;
+
+    /** @brief Maximum number of addresses read for one alert */
+    size_t maxAddresses;
+};
+
+} // namespace i2c
@@ -0,0 +1,83 @@
+#include "stuck_bus.hpp"
+
+#include <cerrno>
+#include <mutex>
+
+namespace i2c
+{
+
+namespace
+{
+
+/** @brief Mutex protecting the policy */
+std::mutex policyMutex;
+
+/** @brief Policy of the buses opened from now on */
+StuckBusPolicy& getPolicy()
+{
+    static StuckBusPolicy policy{};
+    return policy;
+}
+
+} // namespace
+
+bool StuckBusDetector::startTransaction(Clock::time_point now)
+{
+    if (!stuck)
+    {
+        return true;
+    }
+
+    if ((now - lastAttempt) >= policy.recoveryInterval)
+    {
+        // Let this transaction try to recover the bus
+        lastAttempt = now;
+        return true;
+    }
+
+    ++stats.fastFailCount;
+    return false;
+}
+
+void StuckBusDetector::recordFailure(int error, Clock::time_point now)
+{
+    if (!isBusTimeout(error))
+    {
+        // The bus responded, even if the device did not
+        recordSuccess();
+        return;
+    }
+
+    if ((policy.timeoutThreshold == 0) ||
+        (timeoutCount >= policy.timeoutThreshold))
+    {
+        return;
+    }
+
+    ++timeoutCount;
+    if (timeoutCount == policy.timeoutThreshold)
+    {
+        stuck = true;
+        lastAttempt = now;
+        ++stats.stuckCount;
+    }
+}
+
+bool isBusTimeout(int error)
+{
+    return (error == ETIMEDOUT) || (error == EBUSY);
+}
+
+StuckBusPolicy getStuckBusPolicy()
+{
+    std::lock_guard<std::mutex> lock{policyMutex};
+    return getPolicy();
+}
+
+void setStuckBusPolicy(const StuckBusPolicy& policy)
+{
+    std::lock_guard<std::mutex> lock{policyMutex};
+    getPolicy() = policy;
+}
+
+} // namespace i2c
@@ -0,0 +1,157 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+namespace i2c
+{
+
+/** @brief Policy for detecting I2C buses that are stuck
+ *
+ * A device holding SDA low makes every transaction on the bus time out, so
+ * after timeoutThreshold consecutive timeouts on the bus, from any device, the
+ * bus is stuck.  Transactions on a stuck bus fail right away, without waiting
+ * for another timeout, except for one recovery attempt each recoveryInterval.
+ * The recovery attempt is a normal transaction, which lets the bus driver run
+ * the kernel bus recovery (clocking SCL until SDA is released) if it supports
+ * it.  The first transaction that does not time out ends the stuck state.
+ */
+struct StuckBusPolicy
+{
+    /** @brief Number of consecutive timeouts after which a bus is stuck;
+     *         0 disables the detection
+     */
+    unsigned int timeoutThreshold = 3;
+
+    /** @brief Time between recovery attempts on a stuck bus */
+    std::chrono::milliseconds recoveryInterval{1000};
+};
+
+/** @brief Counters of the stuck states of a bus */
+struct StuckBusStats
+{
+    /** @brief Number of times the bus was found stuck */
+    uint64_t stuckCount = 0;
+
+    /** @brief Number of times the bus recovered */
+    uint64_t recoveryCount = 0;
+
+    /** @brief Number of transactions failed without being attempted */
+    uint64_t fastFailCount = 0;
+};
+
+/** @class StuckBusDetector
+ *
+ * Tracks the transaction results of one bus based on a StuckBusPolicy.
+ *
+ * Not thread safe.  I2CDevice keeps one in the state it shares between the
+ * devices on a bus, and uses it with the bus mutex locked from
+ * startTransaction() to the last attempt of the transaction, so a bus that is
+ * working normally only costs a counter reset per transaction.
+ */
+class StuckBusDetector
+{
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    /** @brief Constructor
+     *
+     * @param[in] policy - Policy for detecting a stuck bus
+     */
+    explicit StuckBusDetector(const StuckBusPolicy& policy = StuckBusPolicy{}) :
+        policy(policy)
+    {}
+
+    /** @brief Check whether a transaction may be attempted
+     *
+     * While the bus is stuck, a transaction is only allowed once each
+     * recovery interval, as the recovery attempt.
+     *
+     * @param[in] now - Current time
+     *
+     * @return true if the transaction may be attempted, false if it should
+     *         fail right away
+     */
+    bool startTransaction(Clock::time_point now = Clock::now());
+
+    /** @brief Record a transaction attempt that succeeded */
+    void recordSuccess()
+    {
+        timeoutCount = 0;
+        if (stuck)
+        {
+            stuck = false;
+            ++stats.recoveryCount;
+        }
+    }
+
+    /** @brief Record a transaction attempt that failed
+     *
+     * @param[in] error - errno value of the attempt
+     * @param[in] now - Current time
+     */
+    void recordFailure(int error, Clock::time_point now = Clock::now());
+
+    /** @brief Check whether the bus is stuck
+     *
+     * @return true if the bus is stuck
+     */
+    bool isStuck() const
+    {
+        return stuck;
+    }
+
+    /** @brief Get the counters of the stuck states of the bus
+     *
+     * @return counters
+     */
+    const StuckBusStats& getStats() const
+    {
+        return stats;
+    }
+
+  private:
+    /** @brief Policy for detecting a stuck bus */
+    StuckBusPolicy policy;
+
+    /** @brief Number of consecutive timeouts */
+    unsigned int timeoutCount = 0;
+
+    /** @brief Indicates whether the bus is stuck */
+    bool stuck = false;
+
+    /** @brief Time the bus was found stuck, or of the last recovery attempt */
+    Clock::time_point lastAttempt{};
+
+    /** @brief Counters of the stuck states */
+    StuckBusStats stats{};
+};
+
+/** @brief Check whether an errno value means the bus itself did not respond
+ *
+ * A timeout or a bus that stays busy is caused by the bus, while other errors,
+ * like a device that does not acknowledge its address, are not.
+ *
+ * @param[in] error - errno value
+ *
+ * @return true if the error is a bus timeout
+ */
+bool isBusTimeout(int error);
+
+/** @brief Get the policy used to detect stuck buses
+ *
+ * Thread safe.
+ *
+ * @return policy
+ */
+StuckBusPolicy getStuckBusPolicy();
+
+/** @brief Set the policy used to detect stuck buses
+ *
+ * Applies to the buses opened afterwards.  Thread safe.
+ *
+ * @param[in] policy - Policy for detecting stuck buses
+ */
+void setStuckBusPolicy(const StuckBusPolicy& policy);
+
+} // namespace i2c
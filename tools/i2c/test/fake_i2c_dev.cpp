@@ -0,0 +1,177 @@
+#include "fake_i2c_dev.hpp"
+
+// The C library functions are replaced below, so their declarations in
+// <fcntl.h> and <sys/ioctl.h> are not included
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdarg>
+#include <cstring>
+#include <set>
+#include <string>
+
+extern "C"
+{
+#include <linux/fcntl.h>
+#include <linux/i2c-dev.h>
+#include <linux/i2c.h>
+}
+
+namespace i2c
+{
+
+namespace
+{
+
+/** @brief File descriptors opened on the fake bus
+ *
+ * close() is not replaced, so a descriptor stays in the set until its number
+ * is returned by another open().
+ */
+std::set<int>& getFakeFds()
+{
+    static std::set<int> fds{};
+    return fds;
+}
+
+/** @brief Perform a transfer on the fake bus
+ *
+ * @param[in] clear - Function clearing the bytes read by the transfer
+ * @param[in] result - Value returned by a transfer that succeeds
+ *
+ * @return result, or -1 with errno set if the transfer fails
+ */
+template <typename Func>
+int fakeTransfer(Func clear, int result)
+{
+    FakeI2CDev& dev = getFakeI2CDev();
+    ++dev.transferCount;
+    ++dev.addrTransferCounts[dev.selectedAddr];
+    if (dev.error != 0)
+    {
+        errno = dev.error;
+        return -1;
+    }
+    clear();
+    return result;
+}
+
+/** @brief Perform an ioctl() on the fake bus
+ *
+ * @param[in] request - ioctl request
+ * @param[in] arg - ioctl argument
+ *
+ * @return 0 or the number of messages transferred, or -1 with errno set
+ */
+int fakeIoctl(unsigned long request, void* arg)
+{
+    switch (request)
+    {
+        case I2C_SLAVE:
+        case I2C_SLAVE_FORCE:
+            // The address is passed as the value of the argument
+            getFakeI2CDev().selectedAddr =
+                static_cast<int>(reinterpret_cast<uintptr_t>(arg));
+            return 0;
+        case I2C_FUNCS:
+            *static_cast<unsigned long*>(arg) = ~0UL;
+            return 0;
+        case I2C_SMBUS:
+        {
+            auto* args = static_cast<i2c_smbus_ioctl_data*>(arg);
+            return fakeTransfer(
+                [args]() {
+                    if ((args->read_write != I2C_SMBUS_READ) ||
+                        (args->data == nullptr))
+                    {
+                        return;
+                    }
+                    // An I2C block read returns the requested length
+                    size_t offset =
+                        (args->size == I2C_SMBUS_I2C_BLOCK_DATA) ? 1 : 0;
+                    std::memset(args->data->block + offset, 0,
+                                sizeof(args->data->block) - offset);
+                },
+                0);
+        }
+        case I2C_RDWR:
+        {
+            auto* data = static_cast<i2c_rdwr_ioctl_data*>(arg);
+            return fakeTransfer(
+                [data]() {
+                    for (uint32_t i = 0; i < data->nmsgs; ++i)
+                    {
+                        if (data->msgs[i].flags & I2C_M_RD)
+                        {
+                            std::memset(data->msgs[i].buf, 0,
+                                        data->msgs[i].len);
+                        }
+                    }
+                },
+                static_cast<int>(data->nmsgs));
+        }
+        default:
+            errno = ENOTTY;
+            return -1;
+    }
+}
+
+} // namespace
+
+FakeI2CDev& getFakeI2CDev()
+{
+    static FakeI2CDev dev{};
+    return dev;
+}
+
+} // namespace i2c
+
+extern "C" int open(const char* path, int flags, ...)
+{
+    mode_t mode = 0;
+    if ((flags & O_CREAT) || ((flags & O_TMPFILE) == O_TMPFILE))
+    {
+        va_list args;
+        va_start(args, flags);
+        mode = va_arg(args, mode_t);
+        va_end(args);
+    }
+
+    std::string fakePath =
+        "/dev/i2c-" + std::to_string(i2c::getFakeI2CDev().busId);
+    if (path == fakePath)
+    {
+        // Any file will do, since its ioctl() calls are faked
+        int fd = static_cast<int>(
+            syscall(SYS_openat, AT_FDCWD, "/dev/null", flags, mode));
+        if (fd >= 0)
+        {
+            i2c::getFakeFds().insert(fd);
+        }
+        return fd;
+    }
+
+    // The number of a closed fake bus file may be reused by another file
+    int fd =
+        static_cast<int>(syscall(SYS_openat, AT_FDCWD, path, flags, mode));
+    if (fd >= 0)
+    {
+        i2c::getFakeFds().erase(fd);
+    }
+    return fd;
+}
+
+extern "C" int ioctl(int fd, unsigned long request, ...)
+{
+    va_list args;
+    va_start(args, request);
+    void* arg = va_arg(args, void*);
+    va_end(args);
+
+    if (i2c::getFakeFds().count(fd) != 0)
+    {
+        return i2c::fakeIoctl(request, arg);
+    }
+    return static_cast<int>(syscall(SYS_ioctl, fd, request, arg));
+}
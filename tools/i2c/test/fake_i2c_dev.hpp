@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+
+namespace i2c
+{
+
+/** @brief Fake of the i2c-dev driver used to test I2CDevice
+ *
+ * Linked into a test executable, fake_i2c_dev.cpp replaces the open() and
+ * ioctl() functions of the C library, so opening /dev/i2c-<busId> opens the
+ * fake bus instead.  Every other file is opened and controlled as usual.
+ *
+ * The fake bus supports all the adapter functionality.  Each I2C_SMBUS or
+ * I2C_RDWR transfer fails with the errno value in error, or succeeds and
+ * reads zeros if error is 0.  Transfers are counted by the device address last
+ * set with I2C_SLAVE.
+ */
+struct FakeI2CDev
+{
+    /** @brief ID of the fake bus */
+    uint8_t busId = 0;
+
+    /** @brief errno value the transfers fail with, or 0 */
+    int error = 0;
+
+    /** @brief Number of transfers attempted */
+    size_t transferCount = 0;
+
+    /** @brief Device address last set with I2C_SLAVE, or -1 */
+    int selectedAddr = -1;
+
+    /** @brief Number of transfers attempted, by selected device address */
+    std::map<int, size_t> addrTransferCounts{};
+};
+
+/** @brief Get the fake i2c-dev driver
+ *
+ * Not thread safe.  Tests using devices from several threads may only change
+ * the fake from one thread, while I2CDevice holds the bus mutex for each
+ * I2C_SLAVE and transfer.
+ *
+ * @return fake driver
+ */
+FakeI2CDev& getFakeI2CDev();
+
+} // namespace i2c
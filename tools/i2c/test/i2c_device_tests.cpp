@@ -0,0 +1,202 @@
+#include "bus_budget.hpp"
+#include "fake_i2c_dev.hpp"
+#include "i2c.hpp"
+#include "i2c_interface.hpp"
+#include "stuck_bus.hpp"
+
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace i2c;
+
+/**
+ * Test fixture that resets the fake bus.
+ */
+class I2CDeviceTests : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        getFakeI2CDev() = FakeI2CDev{busId};
+    }
+
+    void TearDown() override
+    {
+        clearBusBudgets();
+        setStuckBusPolicy(StuckBusPolicy{});
+    }
+
+    static constexpr uint8_t busId{7};
+    static constexpr uint8_t devAddr{0x40};
+};
+
+TEST_F(I2CDeviceTests, Transactions)
+{
+    std::unique_ptr<I2CInterface> device = create(busId, devAddr);
+    EXPECT_TRUE(device->isOpen());
+
+    uint8_t byte{0xff};
+    device->read(0x01, byte);
+    EXPECT_EQ(byte, 0);
+    uint16_t word{0xffff};
+    device->read(0x02, word);
+    EXPECT_EQ(word, 0);
+    uint8_t block[4]{1, 2, 3, 4};
+    uint8_t size{4};
+    device->read(0x03, size, block, I2CInterface::Mode::I2C);
+    EXPECT_EQ(size, 4);
+    EXPECT_EQ(block[3], 0);
+
+    device->write(0x01, uint8_t{0x12});
+    device->write(0x02, uint16_t{0x1234});
+    device->write(0x03, 4, block, I2CInterface::Mode::SMBUS);
+    EXPECT_EQ(device->getTransactionCount(), 6);
+    EXPECT_EQ(getFakeI2CDev().transferCount, 6);
+
+    getFakeI2CDev().error = ENXIO;
+    try
+    {
+        device->write(0x01, uint8_t{0x12});
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const I2CException& e)
+    {
+        EXPECT_EQ(e.errorCode, ENXIO);
+    }
+    device->close();
+}
+
+TEST_F(I2CDeviceTests, SharedBusThreads)
+{
+    // Each transfer goes to the device selected for it, even when another
+    // thread selects another device on the bus
+    constexpr size_t transfers{20000};
+    std::vector<std::thread> threads;
+    for (uint8_t addr : {devAddr, static_cast<uint8_t>(devAddr + 1)})
+    {
+        threads.emplace_back([addr]() {
+            std::unique_ptr<I2CInterface> device = create(busId, addr);
+            uint8_t data{0};
+            for (size_t i = 0; i < transfers; ++i)
+            {
+                device->read(0x01, data);
+            }
+        });
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    EXPECT_EQ(getFakeI2CDev().transferCount, 2 * transfers);
+    EXPECT_EQ(getFakeI2CDev().addrTransferCounts[devAddr], transfers);
+    EXPECT_EQ(getFakeI2CDev().addrTransferCounts[devAddr + 1], transfers);
+}
+
+TEST_F(I2CDeviceTests, BusBudget)
+{
+    // Every transaction, including the writes, is counted against the budget
+    setBusBudget(busId, BusBudget{1.0, 3.0});
+    std::unique_ptr<I2CInterface> device = create(busId, devAddr);
+    uint8_t data[2]{0x01, 0x02};
+
+    device->write(0x01, uint8_t{0x12});
+    device->write(0x02, uint16_t{0x1234});
+    EXPECT_FALSE(isBusOverBudget(busId));
+    device->write(0x03, 2, data, I2CInterface::Mode::SMBUS);
+    EXPECT_TRUE(isBusOverBudget(busId));
+
+    // Retries are counted as well
+    setBusBudget(busId, BusBudget{1.0, 3.0});
+    std::unique_ptr<I2CInterface> retried =
+        create(busId, devAddr + 1, I2CInterface::InitialState::OPEN, 2);
+    getFakeI2CDev().error = ENXIO;
+    EXPECT_THROW(retried->write(0x01, uint8_t{0x12}), I2CException);
+    EXPECT_EQ(retried->getRetryCount(), 2);
+    EXPECT_TRUE(isBusOverBudget(busId));
+}
+
+TEST_F(I2CDeviceTests, StuckBus)
+{
+    setStuckBusPolicy(StuckBusPolicy{3, std::chrono::hours{1}});
+    std::unique_ptr<I2CInterface> device =
+        create(busId, devAddr, I2CInterface::InitialState::OPEN, 5);
+    std::unique_ptr<I2CInterface> other = create(busId, devAddr + 1);
+    uint8_t data{0};
+
+    // Retries stop once the bus is stuck
+    getFakeI2CDev().error = ETIMEDOUT;
+    EXPECT_THROW(device->read(0x01, data), I2CException);
+    EXPECT_EQ(getFakeI2CDev().transferCount, 3);
+    EXPECT_EQ(device->getRetryCount(), 2);
+
+    // Every device on the bus then fails without a transfer, even once the
+    // bus works again, until the next recovery attempt
+    getFakeI2CDev().error = 0;
+    try
+    {
+        other->write(0x01, uint8_t{0x12});
+        ADD_FAILURE() << "Should not have reached this line.";
+    }
+    catch (const I2CException& e)
+    {
+        EXPECT_EQ(e.errorCode, ETIMEDOUT);
+    }
+    EXPECT_THROW(device->read(0x01, data), I2CException);
+    EXPECT_EQ(getFakeI2CDev().transferCount, 3);
+}
+
+TEST_F(I2CDeviceTests, StuckBusThreads)
+{
+    // Devices used from different threads share the stuck state, so the bus
+    // is attempted exactly until it is found stuck
+    setStuckBusPolicy(StuckBusPolicy{3, std::chrono::hours{1}});
+    getFakeI2CDev().error = ETIMEDOUT;
+    std::vector<std::thread> threads;
+    for (uint8_t addr : {devAddr, static_cast<uint8_t>(devAddr + 1)})
+    {
+        threads.emplace_back([addr]() {
+            std::unique_ptr<I2CInterface> device = create(busId, addr);
+            uint8_t data{0};
+            for (int i = 0; i < 1000; ++i)
+            {
+                EXPECT_THROW(device->read(0x01, data), I2CException);
+            }
+        });
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    EXPECT_EQ(getFakeI2CDev().transferCount, 3);
+}
+
+TEST_F(I2CDeviceTests, StuckBusRecovery)
+{
+    // Every transaction is a recovery attempt
+    setStuckBusPolicy(StuckBusPolicy{2, std::chrono::milliseconds{0}});
+    std::unique_ptr<I2CInterface> device = create(busId, devAddr);
+    uint8_t data{0};
+
+    getFakeI2CDev().error = ETIMEDOUT;
+    EXPECT_THROW(device->read(0x01, data), I2CException);
+    EXPECT_THROW(device->read(0x01, data), I2CException);
+    EXPECT_THROW(device->read(0x01, data), I2CException);
+    EXPECT_EQ(getFakeI2CDev().transferCount, 3);
+
+    // A device that does not acknowledge shows the bus works
+    getFakeI2CDev().error = ENXIO;
+    EXPECT_THROW(device->read(0x01, data), I2CException);
+    getFakeI2CDev().error = ETIMEDOUT;
+    EXPECT_THROW(device->read(0x01, data), I2CException);
+    getFakeI2CDev().error = 0;
+    device->read(0x01, data);
+    EXPECT_EQ(getFakeI2CDev().transferCount, 6);
+}
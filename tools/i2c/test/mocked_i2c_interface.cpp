@@ -12,4 +12,12 @@ std::unique_ptr<I2CInterface>
     return std::make_unique<MockedI2CInterface>();
 }
 
+std::unique_ptr<I2CInterface>
+    create(uint8_t /*busId*/, uint8_t /*devAddr*/,
+           I2CInterface::InitialState /*initialState*/,
+           const RetryPolicy& /*retryPolicy*/)
+{
+    return std::make_unique<MockedI2CInterface>();
+}
+
 } // namespace i2c
@@ -22,13 +22,27 @@ class MockedI2CInterface : public I2CInterface
     MOCK_METHOD(void, read,
                 (uint8_t addr, uint8_t& size, uint8_t* data, Mode mode),
                 (override));
+    MOCK_METHOD(void, readLarge, (uint8_t addr, std::span<uint8_t> data),
+                (override));
 
     MOCK_METHOD(void, write, (uint8_t data), (override));
+    MOCK_METHOD(void, writeQuick, (), (override));
     MOCK_METHOD(void, write, (uint8_t addr, uint8_t data), (override));
     MOCK_METHOD(void, write, (uint8_t addr, uint16_t data), (override));
     MOCK_METHOD(void, write,
                 (uint8_t addr, uint8_t size, const uint8_t* data, Mode mode),
                 (override));
+
+    MOCK_METHOD(void, transfer, (std::vector<Operation> & operations),
+                (override));
+
+    MOCK_METHOD(uint8_t, getBus, (), (const, override));
+    MOCK_METHOD(uint8_t, getAddress, (), (const, override));
+    MOCK_METHOD(uint64_t, getRetryCount, (), (const, override));
+    MOCK_METHOD(uint64_t, getTransactionCount, (), (const, override));
+    MOCK_METHOD(void, setStatsEnabled, (bool enable), (override));
+    MOCK_METHOD(std::string, getStats, (), (const, override));
+    MOCK_METHOD(IdleStats, getIdleStats, (), (const, override));
 };
 
 } // namespace i2c
@@ -0,0 +1,245 @@
+#include "replay_i2c_interface.hpp"
+
+#include "../flight_recorder.hpp"
+
+#include <linux/i2c.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <thread>
+
+namespace i2c
+{
+
+namespace
+{
+
+/** @brief Check whether a recorded transaction is a PMBus file access
+ *
+ * @param[in] record - The recorded transaction
+ *
+ * @return true if it was recorded by a TracedPMBus
+ */
+bool isPMBusRecord(const TraceRecord& record)
+{
+    return record.op >= static_cast<uint8_t>(TraceOp::pmbusRead);
+}
+
+/** @brief Copy recorded bytes to a buffer, padded with zeros
+ *
+ * @param[in] bytes - The recorded bytes
+ * @param[in] offset - Index of the first recorded byte to copy
+ * @param[out] data - The buffer
+ * @param[in] size - Number of bytes to fill in
+ */
+void copyBytes(const std::vector<uint8_t>& bytes, size_t offset,
+               uint8_t* data, size_t size)
+{
+    size_t count = (offset < bytes.size())
+                       ? std::min(size, bytes.size() - offset)
+                       : 0;
+    std::copy_n(bytes.begin() + offset, count, data);
+    std::fill(data + count, data + size, 0);
+}
+
+} // namespace
+
+ReplayI2CInterface::ReplayI2CInterface(uint8_t busId, uint8_t devAddr,
+                                       const std::vector<TraceEntry>& entries,
+                                       bool loop, bool useRecordedTiming) :
+    busId(busId),
+    devAddr(devAddr), busStr("/dev/i2c-" + std::to_string(busId)),
+    loop(loop), useRecordedTiming(useRecordedTiming)
+{
+    for (const TraceEntry& entry : entries)
+    {
+        if ((entry.record.busId == busId) && (entry.record.addr == devAddr) &&
+            !isPMBusRecord(entry.record))
+        {
+            queues[{entry.record.op, entry.record.command}]
+                .entries.emplace_back(entry);
+        }
+    }
+}
+
+std::vector<std::unique_ptr<ReplayI2CInterface>>
+    ReplayI2CInterface::load(const std::filesystem::path& path, bool loop,
+                             bool useRecordedTiming)
+{
+    std::vector<TraceEntry> entries = readTrace(path);
+
+    std::map<std::pair<uint8_t, uint8_t>, std::vector<TraceEntry>> devices{};
+    for (TraceEntry& entry : entries)
+    {
+        if (!isPMBusRecord(entry.record))
+        {
+            devices[{entry.record.busId, entry.record.addr}].emplace_back(
+                std::move(entry));
+        }
+    }
+
+    std::vector<std::unique_ptr<ReplayI2CInterface>> interfaces{};
+    for (const auto& [device, deviceEntries] : devices)
+    {
+        interfaces.emplace_back(std::make_unique<ReplayI2CInterface>(
+            device.first, device.second, deviceEntries, loop,
+            useRecordedTiming));
+    }
+    return interfaces;
+}
+
+const TraceEntry& ReplayI2CInterface::replay(TraceOp op, uint16_t command)
+{
+    if (!opened)
+    {
+        throw I2CException("Device not open", busStr, devAddr);
+    }
+    ++transactionCount;
+
+    auto it = queues.find({static_cast<uint8_t>(op), command});
+    if ((it != queues.end()) && loop &&
+        (it->second.next == it->second.entries.size()))
+    {
+        it->second.next = 0;
+    }
+    if ((it == queues.end()) || (it->second.next == it->second.entries.size()))
+    {
+        ++missCount;
+        throw I2CException("No recorded transaction to replay", busStr,
+                           devAddr, ENODATA);
+    }
+
+    const TraceEntry& entry = it->second.entries[it->second.next++];
+    if (useRecordedTiming)
+    {
+        std::this_thread::sleep_for(
+            std::chrono::microseconds{entry.record.duration});
+    }
+    if (entry.record.result != 0)
+    {
+        throw I2CException("Replayed failure", busStr, devAddr,
+                           entry.record.result);
+    }
+    return entry;
+}
+
+void ReplayI2CInterface::open()
+{
+    if (opened)
+    {
+        throw I2CException("Device already open", busStr, devAddr);
+    }
+    opened = true;
+}
+
+void ReplayI2CInterface::close()
+{
+    if (!opened)
+    {
+        throw I2CException("Device not open", busStr, devAddr);
+    }
+    opened = false;
+}
+
+void ReplayI2CInterface::read(uint8_t& data)
+{
+    const TraceEntry& entry = replay(TraceOp::readByte,
+                                     FlightRecorder::noCommand);
+    copyBytes(entry.data, 0, &data, 1);
+}
+
+void ReplayI2CInterface::read(uint8_t addr, uint8_t& data)
+{
+    const TraceEntry& entry = replay(TraceOp::readByteData, addr);
+    copyBytes(entry.data, 0, &data, 1);
+}
+
+void ReplayI2CInterface::read(uint8_t addr, uint16_t& data)
+{
+    const TraceEntry& entry = replay(TraceOp::readWordData, addr);
+    uint8_t bytes[2];
+    copyBytes(entry.data, 0, bytes, 2);
+    data = static_cast<uint16_t>(bytes[0] | (bytes[1] << 8));
+}
+
+void ReplayI2CInterface::read(uint8_t addr, uint8_t& size, uint8_t* data,
+                              Mode mode)
+{
+    if (mode == Mode::SMBUS)
+    {
+        const TraceEntry& entry = replay(TraceOp::readBlockData, addr);
+        size = static_cast<uint8_t>(
+            std::min<size_t>(entry.data.size(), I2C_SMBUS_BLOCK_MAX));
+        copyBytes(entry.data, 0, data, size);
+    }
+    else
+    {
+        const TraceEntry& entry = replay(TraceOp::readI2CBlockData, addr);
+        copyBytes(entry.data, 0, data, size);
+    }
+}
+
+void ReplayI2CInterface::readLarge(uint8_t addr, std::span<uint8_t> data)
+{
+    if (data.empty())
+    {
+        return;
+    }
+    const TraceEntry& entry = replay(TraceOp::readLarge, addr);
+    copyBytes(entry.data, 0, data.data(), data.size());
+}
+
+void ReplayI2CInterface::write(uint8_t /*data*/)
+{
+    replay(TraceOp::writeByte, FlightRecorder::noCommand);
+}
+
+void ReplayI2CInterface::writeQuick()
+{
+    replay(TraceOp::writeQuick, FlightRecorder::noCommand);
+}
+
+void ReplayI2CInterface::write(uint8_t addr, uint8_t /*data*/)
+{
+    replay(TraceOp::writeByteData, addr);
+}
+
+void ReplayI2CInterface::write(uint8_t addr, uint16_t /*data*/)
+{
+    replay(TraceOp::writeWordData, addr);
+}
+
+void ReplayI2CInterface::write(uint8_t addr, uint8_t /*size*/,
+                               const uint8_t* /*data*/, Mode mode)
+{
+    replay((mode == Mode::SMBUS) ? TraceOp::writeBlockData
+                                 : TraceOp::writeI2CBlockData,
+           addr);
+}
+
+void ReplayI2CInterface::transfer(std::vector<Operation>& operations)
+{
+    if (operations.empty())
+    {
+        return;
+    }
+
+    // The recorded data holds the bytes of all the messages; each operation
+    // starts with the register address, followed by the bytes read or
+    // written
+    const TraceEntry& entry = replay(TraceOp::transfer,
+                                     FlightRecorder::noCommand);
+    size_t offset = 0;
+    for (Operation& operation : operations)
+    {
+        offset += 1;
+        if (operation.isRead)
+        {
+            copyBytes(entry.data, offset, operation.data, operation.size);
+        }
+        offset += operation.size;
+    }
+}
+
+} // namespace i2c
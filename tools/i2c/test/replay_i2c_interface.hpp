@@ -0,0 +1,215 @@
+#pragma once
+
+#include "../bus_trace.hpp"
+#include "../i2c_interface.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace i2c
+{
+
+/** @class ReplayI2CInterface
+ *
+ * I2CInterface that replays the transactions of one device recorded in a
+ * bus trace, see startTrace().  Used to measure and test the code that uses
+ * the I2C devices against what real hardware returned, without the
+ * hardware.
+ *
+ * The recorded transactions are queued by kind and command code, so a
+ * replay that polls the registers in a different order than the recording
+ * still gets the values each register returned, in the order it returned
+ * them.  A transaction returns the data of the next recorded transaction
+ * in its queue, or throws an I2CException with the recorded errno if that
+ * transaction failed.  Writes are not compared with the recorded data.  A
+ * transaction with no recorded transaction left throws an I2CException with
+ * ENODATA and is counted as a miss.
+ */
+class ReplayI2CInterface : public I2CInterface
+{
+  public:
+    /** @brief Constructor.  The interface starts open.
+     *
+     * @param[in] busId - The i2c bus ID
+     * @param[in] devAddr - The device address of the I2C device
+     * @param[in] entries - The recorded transactions; those of other devices
+     *                      and the PMBus transactions are ignored
+     * @param[in] loop - Whether to start a queue over when all of its
+     *                   transactions were replayed
+     * @param[in] useRecordedTiming - Whether each transaction takes the time
+     *                                the recorded one took
+     */
+    ReplayI2CInterface(uint8_t busId, uint8_t devAddr,
+                       const std::vector<TraceEntry>& entries,
+                       bool loop = true, bool useRecordedTiming = true);
+
+    /** @brief Create a replayed device for each device in a bus trace
+     *
+     * @param[in] path - The trace file
+     * @param[in] loop - See the constructor
+     * @param[in] useRecordedTiming - See the constructor
+     *
+     * @return the devices, ordered by bus ID and address
+     *
+     * @throw std::runtime_error if the file cannot be read or is not a bus
+     *        trace
+     */
+    static std::vector<std::unique_ptr<ReplayI2CInterface>>
+        load(const std::filesystem::path& path, bool loop = true,
+             bool useRecordedTiming = true);
+
+    /** @brief Get the number of transactions with no recorded transaction
+     *         to replay
+     *
+     * @return number of misses
+     */
+    uint64_t getMissCount() const
+    {
+        return missCount;
+    }
+
+    /** @copydoc I2CInterface::open() */
+    void open() override;
+
+    /** @copydoc I2CInterface::isOpen() */
+    bool isOpen() const override
+    {
+        return opened;
+    }
+
+    /** @copydoc I2CInterface::close() */
+    void close() override;
+
+    /** @copydoc I2CInterface::read(uint8_t&) */
+    void read(uint8_t& data) override;
+
+    /** @copydoc I2CInterface::read(uint8_t,uint8_t&) */
+    void read(uint8_t addr, uint8_t& data) override;
+
+    /** @copydoc I2CInterface::read(uint8_t,uint16_t&) */
+    void read(uint8_t addr, uint16_t& data) override;
+
+    /** @copydoc I2CInterface::read(uint8_t,uint8_t&,uint8_t*,Mode) */
+    void read(uint8_t addr, uint8_t& size, uint8_t* data,
+              Mode mode = Mode::SMBUS) override;
+
+    /** @copydoc I2CInterface::readLarge() */
+    void readLarge(uint8_t addr, std::span<uint8_t> data) override;
+
+    /** @copydoc I2CInterface::write(uint8_t) */
+    void write(uint8_t data) override;
+
+    /** @copydoc I2CInterface::writeQuick() */
+    void writeQuick() override;
+
+    /** @copydoc I2CInterface::write(uint8_t,uint8_t) */
+    void write(uint8_t addr, uint8_t data) override;
+
+    /** @copydoc I2CInterface::write(uint8_t,uint16_t) */
+    void write(uint8_t addr, uint16_t data) override;
+
+    /** @copydoc I2CInterface::write(uint8_t,uint8_t,const uint8_t*,Mode) */
+    void write(uint8_t addr, uint8_t size, const uint8_t* data,
+               Mode mode = Mode::SMBUS) override;
+
+    /** @copydoc I2CInterface::transfer() */
+    void transfer(std::vector<Operation>& operations) override;
+
+    /** @copydoc I2CInterface::getBus() */
+    uint8_t getBus() const override
+    {
+        return busId;
+    }
+
+    /** @copydoc I2CInterface::getAddress() */
+    uint8_t getAddress() const override
+    {
+        return devAddr;
+    }
+
+    /** @copydoc I2CInterface::getRetryCount() */
+    uint64_t getRetryCount() const override
+    {
+        return 0;
+    }
+
+    /** @copydoc I2CInterface::getTransactionCount() */
+    uint64_t getTransactionCount() const override
+    {
+        return transactionCount;
+    }
+
+    /** @copydoc I2CInterface::setStatsEnabled() */
+    void setStatsEnabled(bool /*enable*/) override
+    {}
+
+    /** @copydoc I2CInterface::getStats() */
+    std::string getStats() const override
+    {
+        return std::string{};
+    }
+
+    /** @copydoc I2CInterface::getIdleStats() */
+    IdleStats getIdleStats() const override
+    {
+        return IdleStats{};
+    }
+
+  private:
+    /** @brief Recorded transactions of one kind and command code */
+    struct Queue
+    {
+        /** @brief The transactions, from oldest to newest */
+        std::vector<TraceEntry> entries{};
+
+        /** @brief Index of the next transaction to replay */
+        size_t next = 0;
+    };
+
+    /** @brief Replay the next recorded transaction of a kind and command
+     *
+     * @param[in] op - Kind of transaction
+     * @param[in] command - Command code, or FlightRecorder::noCommand
+     *
+     * @return the recorded transaction, which succeeded
+     *
+     * @throw I2CException if the device is not open, no transaction is left
+     *        to replay, or the recorded transaction failed
+     */
+    const TraceEntry& replay(TraceOp op, uint16_t command);
+
+    /** @brief The I2C bus ID */
+    uint8_t busId;
+
+    /** @brief The i2c device address in the bus */
+    uint8_t devAddr;
+
+    /** @brief The i2c bus path in /dev, used in exceptions */
+    std::string busStr;
+
+    /** @brief Whether to start a queue over when it is replayed */
+    bool loop;
+
+    /** @brief Whether each transaction takes the recorded time */
+    bool useRecordedTiming;
+
+    /** @brief Recorded transactions, by TraceOp value and command code */
+    std::map<std::pair<uint8_t, uint16_t>, Queue> queues;
+
+    /** @brief Indicates whether the interface is open */
+    bool opened = true;
+
+    /** @brief Number of transactions performed, including failed ones */
+    uint64_t transactionCount = 0;
+
+    /** @brief Number of transactions with nothing to replay */
+    uint64_t missCount = 0;
+};
+
+} // namespace i2c
@@ -0,0 +1,394 @@
+#include "simulated_i2c_interface.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+namespace i2c
+{
+
+namespace
+{
+
+/** @brief Get the mutex that serializes the transactions on a bus
+ *
+ * @param[in] busId - The i2c bus ID
+ *
+ * @return mutex of the bus
+ */
+std::mutex& getBusMutex(uint8_t busId)
+{
+    static std::mutex busesMutex;
+    static std::map<uint8_t, std::mutex> buses;
+    std::lock_guard<std::mutex> lock{busesMutex};
+    return buses[busId];
+}
+
+/** @brief Parse a byte expressed in hexadecimal, like "0x4A"
+ *
+ * @param[in] element - JSON string
+ *
+ * @return byte value
+ *
+ * @throw std::invalid_argument if the element is not a hexadecimal byte
+ */
+uint8_t parseHexByte(const nlohmann::json& element)
+{
+    if (element.is_string())
+    {
+        const std::string& value = element.get_ref<const std::string&>();
+        if ((value.size() > 2) && (value.size() <= 4) &&
+            (value.compare(0, 2, "0x") == 0) &&
+            (value.find_first_not_of("0123456789abcdefABCDEF", 2) ==
+             std::string::npos))
+        {
+            return static_cast<uint8_t>(std::stoul(value, nullptr, 16));
+        }
+    }
+    throw std::invalid_argument{"Element is not a hexadecimal byte"};
+}
+
+/** @brief Get an optional time property in microseconds
+ *
+ * @param[in] element - JSON object
+ * @param[in] name - Property name
+ *
+ * @return time, or 0 if the property is not specified
+ *
+ * @throw std::invalid_argument if the value is not a non-negative integer
+ */
+std::chrono::microseconds getTime(const nlohmann::json& element,
+                                  const char* name)
+{
+    auto it = element.find(name);
+    if (it == element.end())
+    {
+        return std::chrono::microseconds{0};
+    }
+    if (!it->is_number_unsigned())
+    {
+        throw std::invalid_argument{std::string{"Invalid "} + name + " value"};
+    }
+    return std::chrono::microseconds{it->get<uint64_t>()};
+}
+
+/** @brief Get an optional probability property
+ *
+ * @param[in] element - JSON object
+ * @param[in] name - Property name
+ *
+ * @return probability, or 0 if the property is not specified
+ *
+ * @throw std::invalid_argument if the value is not from 0 to 1
+ */
+double getProbability(const nlohmann::json& element, const char* name)
+{
+    auto it = element.find(name);
+    if (it == element.end())
+    {
+        return 0.0;
+    }
+    if (!it->is_number() || (it->get<double>() < 0.0) ||
+        (it->get<double>() > 1.0))
+    {
+        throw std::invalid_argument{std::string{"Invalid "} + name + " value"};
+    }
+    return it->get<double>();
+}
+
+} // namespace
+
+template <typename Func>
+void SimulatedI2CInterface::transaction(size_t byteCount, Func operation)
+{
+    if (!opened)
+    {
+        throw I2CException("Device not open", busStr, devAddr);
+    }
+
+    std::lock_guard<std::mutex> lock{getBusMutex(busId)};
+    ++transactionCount;
+
+    std::uniform_real_distribution<double> probability{0.0, 1.0};
+    if ((timing.nackProbability > 0.0) &&
+        (probability(generator) < timing.nackProbability))
+    {
+        ++nackCount;
+        std::this_thread::sleep_for(timing.latency);
+        throw I2CException("Simulated NACK", busStr, devAddr, ENXIO);
+    }
+
+    std::chrono::microseconds duration =
+        timing.latency + timing.byteTime * byteCount;
+    if (timing.jitter.count() > 0)
+    {
+        std::uniform_int_distribution<std::chrono::microseconds::rep> jitter{
+            0, timing.jitter.count()};
+        duration += std::chrono::microseconds{jitter(generator)};
+    }
+    if ((timing.clockStretchProbability > 0.0) &&
+        (probability(generator) < timing.clockStretchProbability))
+    {
+        ++clockStretchCount;
+        duration += timing.clockStretch;
+    }
+    if (duration.count() > 0)
+    {
+        std::this_thread::sleep_for(duration);
+    }
+
+    operation();
+}
+
+SimulatedI2CInterface::SimulatedI2CInterface(uint8_t busId, uint8_t devAddr,
+                                             const SimulatedTiming& timing,
+                                             Registers registers,
+                                             uint32_t seed) :
+    busId(busId),
+    devAddr(devAddr), busStr("/dev/i2c-" + std::to_string(busId)),
+    timing(timing), registers(std::move(registers)), generator(seed)
+{}
+
+std::unique_ptr<SimulatedI2CInterface>
+    SimulatedI2CInterface::fromJSON(const nlohmann::json& element)
+{
+    if (!element.is_object())
+    {
+        throw std::invalid_argument{"Element is not an object"};
+    }
+
+    auto busIt = element.find("bus");
+    if ((busIt == element.end()) || !busIt->is_number_unsigned() ||
+        (busIt->get<uint64_t>() > 0xFF))
+    {
+        throw std::invalid_argument{"Invalid bus value"};
+    }
+    uint8_t bus = busIt->get<uint8_t>();
+
+    auto addressIt = element.find("address");
+    if (addressIt == element.end())
+    {
+        throw std::invalid_argument{"Required property missing: address"};
+    }
+    uint8_t address = parseHexByte(*addressIt);
+
+    SimulatedTiming timing{};
+    timing.latency = getTime(element, "latency_us");
+    timing.byteTime = getTime(element, "byte_time_us");
+    timing.jitter = getTime(element, "jitter_us");
+    timing.nackProbability = getProbability(element, "nack_probability");
+    timing.clockStretchProbability =
+        getProbability(element, "clock_stretch_probability");
+    timing.clockStretch = getTime(element, "clock_stretch_us");
+
+    uint32_t seed{0};
+    auto seedIt = element.find("seed");
+    if (seedIt != element.end())
+    {
+        if (!seedIt->is_number_unsigned())
+        {
+            throw std::invalid_argument{"Invalid seed value"};
+        }
+        seed = seedIt->get<uint32_t>();
+    }
+
+    Registers registers{};
+    auto registersIt = element.find("registers");
+    if (registersIt != element.end())
+    {
+        if (!registersIt->is_object())
+        {
+            throw std::invalid_argument{"Invalid registers value"};
+        }
+        for (const auto& [addr, bytes] : registersIt->items())
+        {
+            if (!bytes.is_array() || (bytes.size() > 32))
+            {
+                throw std::invalid_argument{"Invalid register value: " + addr};
+            }
+            std::vector<uint8_t>& data =
+                registers[parseHexByte(nlohmann::json(addr))];
+            for (const auto& byte : bytes)
+            {
+                data.emplace_back(parseHexByte(byte));
+            }
+        }
+    }
+
+    return std::make_unique<SimulatedI2CInterface>(
+        bus, address, timing, std::move(registers), seed);
+}
+
+std::vector<std::unique_ptr<SimulatedI2CInterface>>
+    SimulatedI2CInterface::load(const std::filesystem::path& path)
+{
+    std::ifstream file{path};
+    if (!file)
+    {
+        throw std::runtime_error{"Unable to open " + path.string()};
+    }
+    nlohmann::json root = nlohmann::json::parse(file);
+
+    auto devicesIt = root.find("devices");
+    if ((devicesIt == root.end()) || !devicesIt->is_array())
+    {
+        throw std::invalid_argument{"Required property missing: devices"};
+    }
+
+    std::vector<std::unique_ptr<SimulatedI2CInterface>> devices{};
+    for (const auto& element : *devicesIt)
+    {
+        devices.emplace_back(fromJSON(element));
+    }
+    return devices;
+}
+
+std::vector<uint8_t> SimulatedI2CInterface::getRegister(uint8_t addr) const
+{
+    auto it = registers.find(addr);
+    if (it == registers.end())
+    {
+        return std::vector<uint8_t>{};
+    }
+    return it->second;
+}
+
+void SimulatedI2CInterface::setRegister(uint8_t addr,
+                                        std::vector<uint8_t> data)
+{
+    registers[addr] = std::move(data);
+}
+
+void SimulatedI2CInterface::open()
+{
+    if (opened)
+    {
+        throw I2CException("Device already open", busStr, devAddr);
+    }
+    opened = true;
+}
+
+void SimulatedI2CInterface::close()
+{
+    if (!opened)
+    {
+        throw I2CException("Device not open", busStr, devAddr);
+    }
+    opened = false;
+}
+
+void SimulatedI2CInterface::read(uint8_t& data)
+{
+    transaction(1, [this, &data]() {
+        data = getBytes(currentRegister, 1)[0];
+    });
+}
+
+void SimulatedI2CInterface::read(uint8_t addr, uint8_t& data)
+{
+    transaction(2, [this, addr, &data]() { data = getBytes(addr, 1)[0]; });
+}
+
+void SimulatedI2CInterface::read(uint8_t addr, uint16_t& data)
+{
+    transaction(3, [this, addr, &data]() {
+        std::vector<uint8_t> bytes = getBytes(addr, 2);
+        data = static_cast<uint16_t>(bytes[0] | (bytes[1] << 8));
+    });
+}
+
+void SimulatedI2CInterface::read(uint8_t addr, uint8_t& size, uint8_t* data,
+                                 Mode mode)
+{
+    // An SMBus block read returns every byte of the register after a count
+    if (mode == Mode::SMBUS)
+    {
+        size = static_cast<uint8_t>(getRegister(addr).size());
+    }
+    transaction(2 + size, [this, addr, size, data]() {
+        std::vector<uint8_t> bytes = getBytes(addr, size);
+        std::copy_n(bytes.begin(), size, data);
+    });
+}
+
+void SimulatedI2CInterface::readLarge(uint8_t addr, std::span<uint8_t> data)
+{
+    transaction(2 + data.size(), [this, addr, data]() {
+        std::vector<uint8_t> bytes = getBytes(addr, data.size());
+        std::copy_n(bytes.begin(), data.size(), data.begin());
+    });
+}
+
+void SimulatedI2CInterface::write(uint8_t data)
+{
+    transaction(1, [this, data]() { currentRegister = data; });
+}
+
+void SimulatedI2CInterface::writeQuick()
+{
+    transaction(0, []() {});
+}
+
+void SimulatedI2CInterface::write(uint8_t addr, uint8_t data)
+{
+    transaction(2, [this, addr, data]() { registers[addr] = {data}; });
+}
+
+void SimulatedI2CInterface::write(uint8_t addr, uint16_t data)
+{
+    transaction(3, [this, addr, data]() {
+        registers[addr] = {static_cast<uint8_t>(data & 0xFF),
+                           static_cast<uint8_t>(data >> 8)};
+    });
+}
+
+void SimulatedI2CInterface::write(uint8_t addr, uint8_t size,
+                                  const uint8_t* data, Mode mode)
+{
+    size_t byteCount = (mode == Mode::SMBUS) ? (2 + size) : (1 + size);
+    transaction(byteCount, [this, addr, size, data]() {
+        registers[addr].assign(data, data + size);
+    });
+}
+
+void SimulatedI2CInterface::transfer(std::vector<Operation>& operations)
+{
+    size_t byteCount{0};
+    for (const Operation& operation : operations)
+    {
+        byteCount += 1 + operation.size;
+    }
+    transaction(byteCount, [this, &operations]() {
+        for (Operation& operation : operations)
+        {
+            if (operation.isRead)
+            {
+                std::vector<uint8_t> bytes =
+                    getBytes(operation.addr, operation.size);
+                std::copy_n(bytes.begin(), operation.size, operation.data);
+            }
+            else
+            {
+                registers[operation.addr].assign(
+                    operation.data, operation.data + operation.size);
+            }
+        }
+    });
+}
+
+std::vector<uint8_t> SimulatedI2CInterface::getBytes(uint8_t addr,
+                                                     size_t size) const
+{
+    std::vector<uint8_t> bytes = getRegister(addr);
+    if (bytes.size() < size)
+    {
+        bytes.resize(size, 0x00);
+    }
+    return bytes;
+}
+
+} // namespace i2c
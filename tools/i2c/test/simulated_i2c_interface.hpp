@@ -0,0 +1,314 @@
+#pragma once
+
+#include "../i2c_interface.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace i2c
+{
+
+/** @brief Timing and failure model of simulated I2C transactions
+ *
+ * Each transaction takes latency plus byteTime for each byte sent or
+ * received after the device address, plus a random time up to jitter.  With
+ * clockStretchProbability the device also stretches the clock for
+ * clockStretch.  With nackProbability the device does not acknowledge its
+ * address; the transaction then only takes latency and fails.
+ */
+struct SimulatedTiming
+{
+    /** @brief Time of each transaction, including the device address */
+    std::chrono::microseconds latency{0};
+
+    /** @brief Time of each register address or data byte */
+    std::chrono::microseconds byteTime{0};
+
+    /** @brief Maximum random time added to each transaction */
+    std::chrono::microseconds jitter{0};
+
+    /** @brief Probability, from 0 to 1, that a transaction is not
+     *         acknowledged */
+    double nackProbability = 0.0;
+
+    /** @brief Probability, from 0 to 1, that the device stretches the clock
+     *         during a transaction */
+    double clockStretchProbability = 0.0;
+
+    /** @brief Time the clock is stretched */
+    std::chrono::microseconds clockStretch{0};
+};
+
+/** @class SimulatedI2CInterface
+ *
+ * I2CInterface backed by a register file instead of a device, with a model
+ * of the time taken and the failures of the transactions.  Used to measure
+ * the code that uses the I2C devices without the hardware.
+ *
+ * Each register holds the bytes read from it, in the order they are sent on
+ * the bus.  A byte read returns the first byte of the register, a word read
+ * returns the first two bytes, and a block read returns all of them.  A
+ * write replaces the bytes of the register.  Registers that were never
+ * written read as zeros.  read(uint8_t&) and write(uint8_t) use the
+ * register last addressed by write(uint8_t).
+ *
+ * The transactions of all the SimulatedI2CInterface objects on the same bus
+ * are serialized, like on a real bus, so that the effect of accessing
+ * several buses in parallel can be measured.  The transaction time is spent
+ * sleeping while the bus is held.
+ *
+ * A device can be loaded from JSON in this format; the times are in
+ * microseconds and every property other than bus and address is optional:
+ *
+ *     {
+ *       "bus": 3,
+ *       "address": "0x40",
+ *       "latency_us": 100,
+ *       "byte_time_us": 23,
+ *       "jitter_us": 20,
+ *       "nack_probability": 0.001,
+ *       "clock_stretch_probability": 0.01,
+ *       "clock_stretch_us": 2000,
+ *       "seed": 1,
+ *       "registers": { "0x20": [ "0x18" ], "0x8B": [ "0x00", "0x01" ] }
+ *     }
+ */
+class SimulatedI2CInterface : public I2CInterface
+{
+  public:
+    /** @brief Register file of a simulated device, by register address */
+    using Registers = std::map<uint8_t, std::vector<uint8_t>>;
+
+    /** @brief Constructor.  The interface starts open.
+     *
+     * @param[in] busId - The i2c bus ID
+     * @param[in] devAddr - The device address of the I2C device
+     * @param[in] timing - Timing and failure model of the transactions
+     * @param[in] registers - Initial contents of the registers
+     * @param[in] seed - Seed of the random jitter, NACKs and clock stretching
+     */
+    SimulatedI2CInterface(uint8_t busId, uint8_t devAddr,
+                          const SimulatedTiming& timing = SimulatedTiming{},
+                          Registers registers = Registers{},
+                          uint32_t seed = 0);
+
+    /** @brief Create a simulated device from a JSON element
+     *
+     * @param[in] element - JSON object in the format shown above
+     *
+     * @return the device
+     *
+     * @throw std::invalid_argument if the element is not valid
+     */
+    static std::unique_ptr<SimulatedI2CInterface>
+        fromJSON(const nlohmann::json& element);
+
+    /** @brief Create the simulated devices in a JSON file
+     *
+     * @param[in] path - File containing an object with a "devices" array of
+     *                   elements in the format shown above
+     *
+     * @return the devices
+     *
+     * @throw std::exception if the file cannot be read or is not valid
+     */
+    static std::vector<std::unique_ptr<SimulatedI2CInterface>>
+        load(const std::filesystem::path& path);
+
+    /** @brief Get the number of transactions that were not acknowledged
+     *
+     * @return number of NACKs
+     */
+    uint64_t getNackCount() const
+    {
+        return nackCount;
+    }
+
+    /** @brief Get the number of transactions in which the device stretched
+     *         the clock
+     *
+     * @return number of clock stretches
+     */
+    uint64_t getClockStretchCount() const
+    {
+        return clockStretchCount;
+    }
+
+    /** @brief Get the contents of a register
+     *
+     * @param[in] addr - The register address
+     *
+     * @return bytes of the register; empty if it was never written
+     */
+    std::vector<uint8_t> getRegister(uint8_t addr) const;
+
+    /** @brief Set the contents of a register
+     *
+     * @param[in] addr - The register address
+     * @param[in] data - Bytes of the register
+     */
+    void setRegister(uint8_t addr, std::vector<uint8_t> data);
+
+    /** @brief Get the timing and failure model
+     *
+     * @return timing
+     */
+    const SimulatedTiming& getTiming() const
+    {
+        return timing;
+    }
+
+    /** @copydoc I2CInterface::open() */
+    void open() override;
+
+    /** @copydoc I2CInterface::isOpen() */
+    bool isOpen() const override
+    {
+        return opened;
+    }
+
+    /** @copydoc I2CInterface::close() */
+    void close() override;
+
+    /** @copydoc I2CInterface::read(uint8_t&) */
+    void read(uint8_t& data) override;
+
+    /** @copydoc I2CInterface::read(uint8_t,uint8_t&) */
+    void read(uint8_t addr, uint8_t& data) override;
+
+    /** @copydoc I2CInterface::read(uint8_t,uint16_t&) */
+    void read(uint8_t addr, uint16_t& data) override;
+
+    /** @copydoc I2CInterface::read(uint8_t,uint8_t&,uint8_t*,Mode) */
+    void read(uint8_t addr, uint8_t& size, uint8_t* data,
+              Mode mode = Mode::SMBUS) override;
+
+    /** @copydoc I2CInterface::readLarge() */
+    void readLarge(uint8_t addr, std::span<uint8_t> data) override;
+
+    /** @copydoc I2CInterface::write(uint8_t) */
+    void write(uint8_t data) override;
+
+    /** @copydoc I2CInterface::writeQuick() */
+    void writeQuick() override;
+
+    /** @copydoc I2CInterface::write(uint8_t,uint8_t) */
+    void write(uint8_t addr, uint8_t data) override;
+
+    /** @copydoc I2CInterface::write(uint8_t,uint16_t) */
+    void write(uint8_t addr, uint16_t data) override;
+
+    /** @copydoc I2CInterface::write(uint8_t,uint8_t,const uint8_t*,Mode) */
+    void write(uint8_t addr, uint8_t size, const uint8_t* data,
+               Mode mode = Mode::SMBUS) override;
+
+    /** @copydoc I2CInterface::transfer() */
+    void transfer(std::vector<Operation>& operations) override;
+
+    /** @copydoc I2CInterface::getBus() */
+    uint8_t getBus() const override
+    {
+        return busId;
+    }
+
+    /** @copydoc I2CInterface::getAddress() */
+    uint8_t getAddress() const override
+    {
+        return devAddr;
+    }
+
+    /** @copydoc I2CInterface::getRetryCount() */
+    uint64_t getRetryCount() const override
+    {
+        return 0;
+    }
+
+    /** @copydoc I2CInterface::getTransactionCount() */
+    uint64_t getTransactionCount() const override
+    {
+        return transactionCount;
+    }
+
+    /** @copydoc I2CInterface::setStatsEnabled() */
+    void setStatsEnabled(bool /*enable*/) override
+    {}
+
+    /** @copydoc I2CInterface::getStats() */
+    std::string getStats() const override
+    {
+        return std::string{};
+    }
+
+    /** @copydoc I2CInterface::getIdleStats() */
+    IdleStats getIdleStats() const override
+    {
+        return IdleStats{};
+    }
+
+  private:
+    /** @brief Perform a transaction on the simulated bus
+     *
+     * Holds the bus for the time of the transaction, then calls operation
+     * while still holding it unless the transaction is not acknowledged.
+     *
+     * @param[in] byteCount - Number of bytes after the device address
+     * @param[in] operation - Accesses the register file
+     *
+     * @throw I2CException if the device is not open or does not acknowledge
+     */
+    template <typename Func>
+    void transaction(size_t byteCount, Func operation);
+
+    /** @brief Get the bytes of a register, padded with zeros to a size
+     *
+     * @param[in] addr - The register address
+     * @param[in] size - Minimum number of bytes
+     *
+     * @return bytes of the register
+     */
+    std::vector<uint8_t> getBytes(uint8_t addr, size_t size) const;
+
+    /** @brief The I2C bus ID */
+    uint8_t busId;
+
+    /** @brief The i2c device address in the bus */
+    uint8_t devAddr;
+
+    /** @brief The i2c bus path in /dev, used in exceptions */
+    std::string busStr;
+
+    /** @brief Timing and failure model of the transactions */
+    SimulatedTiming timing;
+
+    /** @brief The register file */
+    Registers registers;
+
+    /** @brief Register last addressed by write(uint8_t) */
+    uint8_t currentRegister = 0;
+
+    /** @brief Random number generator of the timing model */
+    std::minstd_rand generator;
+
+    /** @brief Indicates whether the interface is open */
+    bool opened = true;
+
+    /** @brief Number of transactions performed, including failed ones */
+    uint64_t transactionCount = 0;
+
+    /** @brief Number of transactions that were not acknowledged */
+    uint64_t nackCount = 0;
+
+    /** @brief Number of transactions in which the clock was stretched */
+    uint64_t clockStretchCount = 0;
+};
+
+} // namespace i2c
@@ -0,0 +1,103 @@
+#include "stuck_bus.hpp"
+
+#include <cerrno>
+#include <chrono>
+
+#include <gtest/gtest.h>
+
+using namespace i2c;
+using namespace std::chrono_literals;
+
+TEST(StuckBusDetectorTests, Timeouts)
+{
+    StuckBusDetector detector{};
+    auto now = StuckBusDetector::Clock::now();
+    EXPECT_TRUE(detector.startTransaction(now));
+
+    // Only consecutive timeouts count
+    detector.recordFailure(ETIMEDOUT, now);
+    detector.recordFailure(EBUSY, now);
+    detector.recordSuccess();
+    detector.recordFailure(ETIMEDOUT, now);
+    detector.recordFailure(ETIMEDOUT, now);
+    EXPECT_FALSE(detector.isStuck());
+    EXPECT_TRUE(detector.startTransaction(now));
+
+    detector.recordFailure(EBUSY, now);
+    EXPECT_TRUE(detector.isStuck());
+    EXPECT_EQ(detector.getStats().stuckCount, 1);
+    EXPECT_EQ(detector.getStats().recoveryCount, 0);
+}
+
+TEST(StuckBusDetectorTests, RecoveryAttempts)
+{
+    StuckBusDetector detector{StuckBusPolicy{2, 1000ms}};
+    auto now = StuckBusDetector::Clock::now();
+    detector.recordFailure(ETIMEDOUT, now);
+    detector.recordFailure(ETIMEDOUT, now);
+    ASSERT_TRUE(detector.isStuck());
+
+    // One recovery attempt per interval
+    EXPECT_FALSE(detector.startTransaction(now + 999ms));
+    EXPECT_TRUE(detector.startTransaction(now + 1000ms));
+    EXPECT_FALSE(detector.startTransaction(now + 1001ms));
+
+    // A recovery attempt that times out waits for another interval
+    detector.recordFailure(ETIMEDOUT, now + 1100ms);
+    EXPECT_TRUE(detector.isStuck());
+    EXPECT_FALSE(detector.startTransaction(now + 1999ms));
+    EXPECT_TRUE(detector.startTransaction(now + 2000ms));
+    EXPECT_EQ(detector.getStats().fastFailCount, 3);
+    EXPECT_EQ(detector.getStats().stuckCount, 1);
+}
+
+TEST(StuckBusDetectorTests, Recovery)
+{
+    auto now = StuckBusDetector::Clock::now();
+
+    // A success ends the stuck state
+    StuckBusDetector detector{StuckBusPolicy{1, 1000ms}};
+    detector.recordFailure(ETIMEDOUT, now);
+    ASSERT_TRUE(detector.isStuck());
+    detector.recordSuccess();
+    EXPECT_FALSE(detector.isStuck());
+    EXPECT_TRUE(detector.startTransaction(now));
+    EXPECT_EQ(detector.getStats().recoveryCount, 1);
+
+    // So does a device that does not acknowledge its address, since the bus
+    // responded
+    detector.recordFailure(ETIMEDOUT, now);
+    ASSERT_TRUE(detector.isStuck());
+    detector.recordFailure(ENXIO, now);
+    EXPECT_FALSE(detector.isStuck());
+    EXPECT_EQ(detector.getStats().stuckCount, 2);
+    EXPECT_EQ(detector.getStats().recoveryCount, 2);
+
+    // The timeouts count again from zero
+    detector = StuckBusDetector{StuckBusPolicy{2, 1000ms}};
+    detector.recordFailure(ETIMEDOUT, now);
+    detector.recordFailure(ENXIO, now);
+    detector.recordFailure(ETIMEDOUT, now);
+    EXPECT_FALSE(detector.isStuck());
+}
+
+TEST(StuckBusDetectorTests, Disabled)
+{
+    StuckBusDetector detector{StuckBusPolicy{0, 1000ms}};
+    auto now = StuckBusDetector::Clock::now();
+    for (int i = 0; i < 10; ++i)
+    {
+        detector.recordFailure(ETIMEDOUT, now);
+    }
+    EXPECT_FALSE(detector.isStuck());
+    EXPECT_TRUE(detector.startTransaction(now));
+}
+
+TEST(StuckBusDetectorTests, IsBusTimeout)
+{
+    EXPECT_TRUE(isBusTimeout(ETIMEDOUT));
+    EXPECT_TRUE(isBusTimeout(EBUSY));
+    EXPECT_FALSE(isBusTimeout(ENXIO));
+    EXPECT_FALSE(isBusTimeout(EIO));
+    EXPECT_FALSE(isBusTimeout(0));
+}
@@ -0,0 +1,208 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "pmbus.hpp"
+#include "pmbus_broker.hpp"
+#include "sensor_telemetry.hpp"
+#include "utility.hpp"
+
+#include <CLI/CLI.hpp>
+#include <nlohmann/json.hpp>
+#include <phosphor-logging/log.hpp>
+#include <sdeventplus/clock.hpp>
+#include <sdeventplus/event.hpp>
+#include <sdeventplus/utility/timer.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace phosphor::logging;
+using namespace phosphor::pmbus;
+using namespace phosphor::power::util;
+using json = nlohmann::json;
+
+namespace
+{
+
+/**
+ * The default configuration file.
+ */
+constexpr auto configFile = "/usr/share/phosphor-power/pmbus-broker.json";
+
+/**
+ * The name of the shared memory segment containing the register values.
+ */
+constexpr auto telemetryName = "/phosphor-pmbus-broker";
+
+/**
+ * The maximum number of registers in the shared memory segment.
+ */
+constexpr size_t telemetryCapacity = 1024;
+
+/**
+ * The default interval between polls in milliseconds.
+ */
+constexpr uint64_t defaultPollInterval = 1000;
+
+/**
+ * Returns the path type with the specified name.
+ *
+ * @param[in] name - the type name, such as "Hwmon"
+ *
+ * @return Type - the path type
+ */
+Type getType(const std::string& name)
+{
+    if (name == "Base")
+    {
+        return Type::Base;
+    }
+    if (name == "Hwmon")
+    {
+        return Type::Hwmon;
+    }
+    if (name == "Debug")
+    {
+        return Type::Debug;
+    }
+    if (name == "DeviceDebug")
+    {
+        return Type::DeviceDebug;
+    }
+    if (name == "HwmonDeviceDebug")
+    {
+        return Type::HwmonDeviceDebug;
+    }
+    throw std::invalid_argument{"Invalid PMBus access type: " + name};
+}
+
+/**
+ * Adds the devices in the configuration file to the broker and subscribes
+ * to their registers.
+ *
+ * Each register value is written to the shared memory segment after every
+ * poll, using the ID "<bus>-<address>/<type>/<name>".
+ *
+ * If the broker batches its reads, the devices keep their files open so
+ * they can be read together.
+ *
+ * @param[in] config - the configuration file contents
+ * @param[in] broker - the broker
+ * @param[in] telemetry - the shared memory segment writer
+ *
+ * @return vector<Subscription> - the subscriptions
+ */
+std::vector<PMBusBroker::Subscription>
+    subscribe(const json& config, PMBusBroker& broker,
+              sensor_telemetry::Writer& telemetry)
+{
+    std::vector<PMBusBroker::Subscription> subscriptions;
+    for (const auto& deviceConfig : config.at("devices"))
+    {
+        auto bus = deviceConfig.at("bus").get<uint8_t>();
+        auto address = deviceConfig.at("address").get<std::string>();
+        std::string device = std::to_string(bus) + "-" + address;
+        if (broker.isBatched())
+        {
+            auto pmbus =
+                std::make_unique<PMBus>("/sys/bus/i2c/devices/" + device);
+            pmbus->setFileCacheEnabled(true);
+            broker.addDevice(device, std::move(pmbus));
+        }
+        else
+        {
+            broker.addDevice(device, createPMBus(bus, address));
+        }
+
+        for (const auto& registerConfig : deviceConfig.at("registers"))
+        {
+            auto name = registerConfig.at("name").get<std::string>();
+            auto typeName = registerConfig.value("type", "Hwmon");
+            Type type = getType(typeName);
+
+            std::optional<size_t> index =
+                telemetry.addSensor(device + "/" + typeName + "/" + name);
+            if (!index)
+            {
+                log<level::ERR>(
+                    "Too many PMBus registers",
+                    entry("DEVICE=%s", device.c_str()),
+                    entry("REGISTER=%s", name.c_str()));
+                continue;
+            }
+
+            subscriptions.emplace_back(broker.subscribe(
+                device, name, type,
+                [&telemetry, index = *index](const Reading& reading) {
+                    if (reading.valid)
+                    {
+                        telemetry.write(index,
+                                        static_cast<double>(reading.value),
+                                        sensor_telemetry::Status::ok);
+                    }
+                    else
+                    {
+                        telemetry.write(index, NAN,
+                                        sensor_telemetry::Status::error);
+                    }
+                }));
+        }
+    }
+    return subscriptions;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        CLI::App app{"OpenBMC PMBus Broker"};
+        std::string configPath{configFile};
+        app.add_option("-c,--config", configPath, "Configuration file");
+        CLI11_PARSE(app, argc, argv);
+
+        json config = loadJSONFromFile(configPath.c_str());
+        if (config == nullptr)
+        {
+            return -1;
+        }
+        std::chrono::milliseconds interval{
+            config.value("poll_interval_ms", defaultPollInterval)};
+
+        PMBusBroker broker{config.value("batch_reads", false)};
+        sensor_telemetry::Writer telemetry{telemetryName, telemetryCapacity};
+        auto subscriptions = subscribe(config, broker, telemetry);
+
+        auto event = sdeventplus::Event::get_default();
+        sdeventplus::utility::Timer<sdeventplus::ClockId::Monotonic> timer{
+            event, [&broker](auto&) { broker.poll(); }, interval};
+        broker.poll();
+
+        return event.loop();
+    }
+    catch (const std::exception& e)
+    {
+        log<level::ERR>(e.what());
+        return -2;
+    }
+}
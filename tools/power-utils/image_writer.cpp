@@ -0,0 +1,146 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "image_writer.hpp"
+
+#include "file_descriptor.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <phosphor-logging/log.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace phosphor::logging;
+
+namespace updater
+{
+
+ImageWriter::ImageWriter(const fs::path& imagePath)
+{
+    phosphor::power::util::FileDescriptor fd{
+        ::open(imagePath.c_str(), O_RDONLY)};
+    if (fd() == -1)
+    {
+        throw std::runtime_error{"Unable to open image " + imagePath.string() +
+                                 ": " + strerror(errno)};
+    }
+
+    struct stat st;
+    if (fstat(fd(), &st) == -1)
+    {
+        throw std::runtime_error{"Unable to get size of image " +
+                                 imagePath.string() + ": " + strerror(errno)};
+    }
+    imageSize = st.st_size;
+
+    // An empty file can't be mapped, and there is nothing to write
+    if (imageSize == 0)
+    {
+        return;
+    }
+
+    // The mapping stays valid after the file descriptor is closed
+    void* addr = mmap(nullptr, imageSize, PROT_READ, MAP_PRIVATE, fd(), 0);
+    if (addr == MAP_FAILED)
+    {
+        throw std::runtime_error{"Unable to map image " + imagePath.string() +
+                                 ": " + strerror(errno)};
+    }
+    image = static_cast<const uint8_t*>(addr);
+}
+
+ImageWriter::~ImageWriter()
+{
+    if (image != nullptr)
+    {
+        munmap(const_cast<uint8_t*>(image), imageSize);
+    }
+}
+
+bool ImageWriter::write(i2c::I2CInterface& i2c, const ImageProtocol& protocol,
+                        const Progress& progress) const
+{
+    using Operation = i2c::I2CInterface::Operation;
+
+    std::vector<Operation> operations;
+    operations.reserve(blocksPerTransfer + 1);
+
+    // The SMBus block writes start with the byte count, so their blocks are
+    // copied after it
+    std::vector<uint8_t> blocks;
+    if (protocol.blockCount)
+    {
+        blocks.resize(blocksPerTransfer * (maxBlockSize + 1));
+    }
+
+    size_t offset = 0;
+    while (offset < imageSize)
+    {
+        operations.clear();
+
+        for (size_t i = 0; (i < blocksPerTransfer) && (offset < imageSize);
+             ++i)
+        {
+            auto size = static_cast<uint8_t>(
+                std::min<size_t>(maxBlockSize, imageSize - offset));
+            if (protocol.blockCount)
+            {
+                uint8_t* block = blocks.data() + i * (maxBlockSize + 1);
+                block[0] = size;
+                std::memcpy(block + 1, image + offset, size);
+                operations.push_back(Operation{
+                    false, protocol.dataCmd, static_cast<uint8_t>(size + 1),
+                    block});
+            }
+            else
+            {
+                // The write operations only read from the data buffer
+                operations.push_back(
+                    Operation{false, protocol.dataCmd, size,
+                              const_cast<uint8_t*>(image + offset)});
+            }
+            offset += size;
+        }
+
+        uint8_t status = 0;
+        operations.push_back(Operation{true, protocol.statusCmd, 1, &status});
+
+        i2c.transfer(operations);
+
+        if (status != protocol.statusOK)
+        {
+            log<level::ERR>("PSU rejected image data",
+                            entry("OFFSET=%zu", offset),
+                            entry("STATUS=0x%02x", status));
+            return false;
+        }
+
+        if (progress)
+        {
+            progress(offset, imageSize);
+        }
+    }
+    return true;
+}
+
+} // namespace updater
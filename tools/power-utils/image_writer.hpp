@@ -0,0 +1,137 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "i2c_interface.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <string>
+
+namespace updater
+{
+
+namespace fs = std::filesystem;
+
+/**
+ * @struct ImageProtocol
+ *
+ * How the firmware image is written to a PSU model, from the imageProtocols
+ * of the PSU JSON file.  The command codes are defined by the PSU, so there
+ * are no defaults for them.
+ */
+struct ImageProtocol
+{
+    /** @brief The image file name in the image directory */
+    std::string imageFile;
+
+    /** @brief The register the image blocks are written to */
+    uint8_t dataCmd = 0;
+
+    /** @brief The register read to verify the blocks */
+    uint8_t statusCmd = 0;
+
+    /** @brief Status register value when the blocks were accepted */
+    uint8_t statusOK = 0x00;
+
+    /** @brief Indicates whether the blocks are SMBus block writes, where the
+     *         data starts with its byte count, rather than plain I2C writes
+     */
+    bool blockCount = true;
+};
+
+/**
+ * @class ImageWriter
+ *
+ * Writes a PSU firmware image to the device.
+ *
+ * The image file is memory-mapped, so it is not read into a buffer.  The
+ * image is sent in maximum size block writes, and several blocks are sent in
+ * one combined I2C transaction.  Each transaction ends with a read of the
+ * status register to verify that the device accepted the blocks, so the
+ * verification doesn't cost a transaction of its own.
+ */
+class ImageWriter
+{
+  public:
+    ImageWriter() = delete;
+    ImageWriter(const ImageWriter&) = delete;
+    ImageWriter& operator=(const ImageWriter&) = delete;
+    ImageWriter(ImageWriter&&) = delete;
+    ImageWriter& operator=(ImageWriter&&) = delete;
+
+    /** @brief Progress callback
+     *
+     * Called with the number of bytes written so far and the image size.
+     */
+    using Progress = std::function<void(size_t written, size_t total)>;
+
+    /** @brief Maximum number of bytes in one block write */
+    static constexpr uint8_t maxBlockSize = 32;
+
+    /** @brief Number of block writes in one combined transaction */
+    static constexpr size_t blocksPerTransfer = 8;
+
+    /**
+     * @brief Constructor
+     *
+     * Memory-maps the image file.
+     *
+     * @param imagePath - The PSU image file
+     *
+     * @throw std::runtime_error if the file cannot be mapped
+     */
+    explicit ImageWriter(const fs::path& imagePath);
+
+    /** @brief Destructor
+     *
+     * Unmaps the image file.
+     */
+    ~ImageWriter();
+
+    /** @brief Get the image size
+     *
+     * @return size in bytes
+     */
+    size_t size() const
+    {
+        return imageSize;
+    }
+
+    /** @brief Write the image to the device
+     *
+     * @param i2c - The i2c device interface
+     * @param protocol - How the image is written to the device
+     * @param progress - Optional progress callback
+     *
+     * @return true if the device accepted the whole image, otherwise false
+     *
+     * @throw I2CException on error
+     */
+    bool write(i2c::I2CInterface& i2c, const ImageProtocol& protocol,
+               const Progress& progress = nullptr) const;
+
+  private:
+    /** @brief The mapped image */
+    const uint8_t* image = nullptr;
+
+    /** @brief The image size in bytes */
+    size_t imageSize = 0;
+};
+
+} // namespace updater
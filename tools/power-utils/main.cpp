@@ -13,11 +13,13 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include "service.hpp"
 #include "updater.hpp"
 #include "version.hpp"
 
 #include <CLI/CLI.hpp>
 #include <phosphor-logging/log.hpp>
+#include <sdbusplus/bus.hpp>
 
 #include <cassert>
 
@@ -29,7 +31,9 @@ int main(int argc, char** argv)
     std::string psuPath;
     std::vector<std::string> versions;
     bool rawOutput = false;
+    bool daemon = false;
     std::vector<std::string> updateArguments;
+    std::vector<std::string> batchUpdateArguments;
 
     CLI::App app{"PSU utils app for OpenBMC"};
     auto action = app.add_option_group("Action");
@@ -42,24 +46,61 @@ int main(int argc, char** argv)
                      "Update PSU firmware, expecting two arguments: "
                      "<PSU inventory path> <image-dir>")
         ->expected(2);
+    action
+        ->add_option("-b,--batch-update", batchUpdateArguments,
+                     "Update the firmware of several PSUs in waves, "
+                     "expecting: <image-dir> <PSU inventory path>...")
+        ->expected(2, CLI::detail::expected_max_vector_size);
+    action->add_flag("-d,--daemon", daemon,
+                     "Serve the other actions as D-Bus methods");
     action->require_option(1); // Only one option is supported
     app.add_flag("--raw", rawOutput, "Output raw text without linefeed");
     CLI11_PARSE(app, argc, argv);
 
+    auto bus = sdbusplus::bus::new_default();
+
+    if (daemon)
+    {
+        service::Service service{bus};
+        bus.request_name(service::busName);
+        while (true)
+        {
+            bus.process_discard();
+            bus.wait();
+        }
+    }
+
+    // The actions are done by the service when it is running, so the PSU
+    // config file doesn't need to be parsed again
     std::string ret;
 
     if (!psuPath.empty())
     {
-        ret = version::getVersion(psuPath);
+        auto version = service::getVersion(bus, psuPath);
+        ret = version ? *version : version::getVersion(psuPath);
     }
     if (!versions.empty())
     {
-        ret = version::getLatest(versions);
+        auto latest = service::getLatest(bus, versions);
+        ret = latest ? *latest : version::getLatest(versions);
     }
     if (!updateArguments.empty())
     {
         assert(updateArguments.size() == 2);
-        if (updater::update(updateArguments[0], updateArguments[1]))
+        auto success =
+            service::update(bus, updateArguments[0], updateArguments[1]);
+        if (success ? *success
+                    : updater::update(updateArguments[0], updateArguments[1]))
+        {
+            ret = "Update successful";
+        }
+    }
+    if (!batchUpdateArguments.empty())
+    {
+        assert(batchUpdateArguments.size() >= 2);
+        std::vector<std::string> paths(batchUpdateArguments.begin() + 1,
+                                       batchUpdateArguments.end());
+        if (updater::update(paths, batchUpdateArguments[0]))
         {
             ret = "Update successful";
         }
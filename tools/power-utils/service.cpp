@@ -0,0 +1,221 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "service.hpp"
+
+#include "updater.hpp"
+#include "version.hpp"
+
+#include <phosphor-logging/log.hpp>
+#include <sdbusplus/exception.hpp>
+#include <sdbusplus/server.hpp>
+
+#include <chrono>
+#include <cstring>
+
+using namespace phosphor::logging;
+
+namespace service
+{
+
+namespace
+{
+
+/**
+ * The longest a client waits for a method, which is as long as an update
+ */
+constexpr sdbusplus::SdBusDuration callTimeout{std::chrono::minutes(10)};
+
+/**
+ * Call a method of the psutils service
+ *
+ * @param[in] bus - The D-Bus bus object
+ * @param[in] method - The method name
+ * @param[in] args - The method arguments
+ *
+ * @return The value returned by the method, or no value if the service is
+ *         not running.  Other errors are thrown.
+ */
+template <typename T, typename... Args>
+std::optional<T> callMethod(sdbusplus::bus::bus& bus, const char* method,
+                            const Args&... args)
+{
+    try
+    {
+        auto msg =
+            bus.new_method_call(busName, objectPath, interfaceName, method);
+        msg.append(args...);
+        auto reply = bus.call(msg, callTimeout);
+        T value{};
+        reply.read(value);
+        return value;
+    }
+    catch (const sdbusplus::exception_t& e)
+    {
+        if ((std::strcmp(e.name(), SD_BUS_ERROR_SERVICE_UNKNOWN) == 0) ||
+            (std::strcmp(e.name(), SD_BUS_ERROR_NAME_HAS_NO_OWNER) == 0))
+        {
+            return std::nullopt;
+        }
+        throw;
+    }
+}
+
+} // namespace
+
+Service::Service(sdbusplus::bus::bus& bus) :
+    _serverInterface(bus, objectPath, interfaceName, _vtable, this)
+{}
+
+int Service::callbackGetLatest(sd_bus_message* msg, void* context,
+                               sd_bus_error* error)
+{
+    if (msg != nullptr && context != nullptr)
+    {
+        try
+        {
+            std::vector<std::string> versions;
+            auto m = sdbusplus::message::message(msg);
+
+            m.read(versions);
+
+            auto reply = m.new_method_return();
+            reply.append(version::getLatest(versions));
+
+            reply.method_return();
+        }
+        catch (const sdbusplus::exception_t& e)
+        {
+            return sd_bus_error_set(error, e.name(), e.description());
+        }
+    }
+    else
+    {
+        // The message or context were null
+        log<level::ERR>("Unable to service GetLatest method callback");
+        return -1;
+    }
+
+    return 1;
+}
+
+int Service::callbackGetVersion(sd_bus_message* msg, void* context,
+                                sd_bus_error* error)
+{
+    if (msg != nullptr && context != nullptr)
+    {
+        try
+        {
+            std::string psuInventoryPath;
+            auto m = sdbusplus::message::message(msg);
+
+            m.read(psuInventoryPath);
+
+            auto reply = m.new_method_return();
+            reply.append(version::getVersion(psuInventoryPath));
+
+            reply.method_return();
+        }
+        catch (const sdbusplus::exception_t& e)
+        {
+            return sd_bus_error_set(error, e.name(), e.description());
+        }
+    }
+    else
+    {
+        // The message or context were null
+        log<level::ERR>("Unable to service GetVersion method callback");
+        return -1;
+    }
+
+    return 1;
+}
+
+int Service::callbackUpdate(sd_bus_message* msg, void* context,
+                            sd_bus_error* error)
+{
+    if (msg != nullptr && context != nullptr)
+    {
+        try
+        {
+            std::string psuInventoryPath;
+            std::string imageDir;
+            auto m = sdbusplus::message::message(msg);
+
+            m.read(psuInventoryPath, imageDir);
+
+            bool success = false;
+            try
+            {
+                success = updater::update(psuInventoryPath, imageDir);
+            }
+            catch (const std::exception& e)
+            {
+                log<level::ERR>("PSU update failed",
+                                entry("PSU=%s", psuInventoryPath.c_str()),
+                                entry("ERROR=%s", e.what()));
+            }
+
+            auto reply = m.new_method_return();
+            reply.append(success);
+
+            reply.method_return();
+        }
+        catch (const sdbusplus::exception_t& e)
+        {
+            return sd_bus_error_set(error, e.name(), e.description());
+        }
+    }
+    else
+    {
+        // The message or context were null
+        log<level::ERR>("Unable to service Update method callback");
+        return -1;
+    }
+
+    return 1;
+}
+
+const sdbusplus::vtable::vtable_t Service::_vtable[] = {
+    sdbusplus::vtable::start(),
+    // GetLatest method takes a list of versions and returns the latest one
+    sdbusplus::vtable::method("GetLatest", "as", "s", callbackGetLatest),
+    // GetVersion method takes a PSU inventory path and returns its version
+    sdbusplus::vtable::method("GetVersion", "s", "s", callbackGetVersion),
+    // Update method takes a PSU inventory path and an image directory and
+    // returns if the update was successful
+    sdbusplus::vtable::method("Update", "ss", "b", callbackUpdate),
+    sdbusplus::vtable::end()};
+
+std::optional<std::string> getLatest(sdbusplus::bus::bus& bus,
+                                     const std::vector<std::string>& versions)
+{
+    return callMethod<std::string>(bus, "GetLatest", versions);
+}
+
+std::optional<std::string> getVersion(sdbusplus::bus::bus& bus,
+                                      const std::string& psuInventoryPath)
+{
+    return callMethod<std::string>(bus, "GetVersion", psuInventoryPath);
+}
+
+std::optional<bool> update(sdbusplus::bus::bus& bus,
+                           const std::string& psuInventoryPath,
+                           const std::string& imageDir)
+{
+    return callMethod<bool>(bus, "Update", psuInventoryPath, imageDir);
+}
+
+} // namespace service
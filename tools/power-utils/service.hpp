@@ -0,0 +1,121 @@
+#pragma once
+
+#include <systemd/sd-bus.h>
+
+#include <sdbusplus/bus.hpp>
+#include <sdbusplus/sdbus.hpp>
+#include <sdbusplus/server/interface.hpp>
+#include <sdbusplus/vtable.hpp>
+
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace service
+{
+
+/**
+ * The D-Bus name, path and interface of the psutils service
+ */
+constexpr auto busName = "xyz.openbmc_project.Power.PSUUtils";
+constexpr auto objectPath = "/xyz/openbmc_project/power/psu_utils";
+constexpr auto interfaceName = "xyz.openbmc_project.Power.PSUUtils";
+
+/**
+ * @class Service
+ *
+ * The psutils actions as D-Bus methods, served by a long-lived process so
+ * the PSU config file is only parsed again when it changes.
+ *
+ * Methods:
+ * - GetVersion: takes a PSU inventory path and returns its version
+ * - GetLatest: takes a list of versions and returns the latest one
+ * - Update: takes a PSU inventory path and an image directory and returns
+ *   if the update was successful.  Other methods are not serviced until
+ *   the update is complete.
+ */
+class Service
+{
+  public:
+    Service() = delete;
+    Service(const Service&) = delete;
+    Service& operator=(const Service&) = delete;
+    Service(Service&&) = delete;
+    Service& operator=(Service&&) = delete;
+    ~Service() = default;
+
+    /**
+     * @brief Constructor to put the interface onto the bus
+     *
+     * @param[in] bus - Bus to attach to.
+     */
+    explicit Service(sdbusplus::bus::bus& bus);
+
+  private:
+    /**
+     * @brief Systemd bus callback for the GetLatest method
+     */
+    static int callbackGetLatest(sd_bus_message* msg, void* context,
+                                 sd_bus_error* error);
+
+    /**
+     * @brief Systemd bus callback for the GetVersion method
+     */
+    static int callbackGetVersion(sd_bus_message* msg, void* context,
+                                  sd_bus_error* error);
+
+    /**
+     * @brief Systemd bus callback for the Update method
+     */
+    static int callbackUpdate(sd_bus_message* msg, void* context,
+                              sd_bus_error* error);
+
+    /**
+     * @brief Systemd vtable structure that contains all the
+     * methods of this interface with their respective systemd attributes
+     */
+    static const sdbusplus::vtable::vtable_t _vtable[];
+
+    /**
+     * @brief Holds the interface on D-Bus
+     */
+    sdbusplus::server::interface::interface _serverInterface;
+};
+
+/**
+ * Get the software version of the PSU from the psutils service
+ *
+ * @param[in] bus - The D-Bus bus object
+ * @param[in] psuInventoryPath - The inventory path of the PSU
+ *
+ * @return The version of the PSU, or no value if the service is not running
+ */
+std::optional<std::string> getVersion(sdbusplus::bus::bus& bus,
+                                      const std::string& psuInventoryPath);
+
+/**
+ * Get the latest version from a list of versions from the psutils service
+ *
+ * @param[in] bus - The D-Bus bus object
+ * @param[in] versions - The list of PSU version strings
+ *
+ * @return The latest version, or no value if the service is not running
+ */
+std::optional<std::string> getLatest(sdbusplus::bus::bus& bus,
+                                     const std::vector<std::string>& versions);
+
+/**
+ * Update PSU firmware with the psutils service
+ *
+ * @param[in] bus - The D-Bus bus object
+ * @param[in] psuInventoryPath - The inventory path of the PSU
+ * @param[in] imageDir - The directory containing the PSU image
+ *
+ * @return If the update was successful, or no value if the service is not
+ *         running
+ */
+std::optional<bool> update(sdbusplus::bus::bus& bus,
+                           const std::string& psuInventoryPath,
+                           const std::string& imageDir);
+
+} // namespace service
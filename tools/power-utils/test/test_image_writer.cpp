@@ -0,0 +1,171 @@
+/**
+ * Copyright © 2021 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "../image_writer.hpp"
+#include "mocked_i2c_interface.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace fs = std::filesystem;
+
+using ::testing::_;
+using ::testing::Invoke;
+
+using namespace updater;
+
+using Operation = i2c::I2CInterface::Operation;
+
+class TestImageWriter : public ::testing::Test
+{
+  public:
+    TestImageWriter()
+    {
+        auto tmpPath = fs::temp_directory_path();
+        tmpDir = (tmpPath / "test_XXXXXX");
+        if (!mkdtemp(tmpDir.data()))
+        {
+            throw "Failed to create temp dir";
+        }
+        imagePath = fs::path(tmpDir) / "image.bin";
+    }
+    ~TestImageWriter()
+    {
+        fs::remove_all(tmpDir);
+    }
+
+    void createImage(size_t size)
+    {
+        image.resize(size);
+        for (size_t i = 0; i < size; ++i)
+        {
+            image[i] = static_cast<uint8_t>(i);
+        }
+        std::ofstream out{imagePath, std::ios::binary};
+        out.write(reinterpret_cast<const char*>(image.data()), image.size());
+    }
+
+    std::string tmpDir;
+    fs::path imagePath;
+    std::vector<uint8_t> image;
+    i2c::MockedI2CInterface i2c;
+};
+
+TEST_F(TestImageWriter, Constructor)
+{
+    createImage(100);
+    ImageWriter writer{imagePath};
+    EXPECT_EQ(writer.size(), 100);
+
+    EXPECT_THROW(ImageWriter{fs::path(tmpDir) / "missing.bin"},
+                 std::runtime_error);
+}
+
+TEST_F(TestImageWriter, Write)
+{
+    // 10 blocks: 9 of 32 bytes and one of 12 bytes, sent in 2 transfers
+    createImage(300);
+    ImageWriter writer{imagePath};
+    ImageProtocol protocol{"image.bin", 0x10, 0x11, 0x00, false};
+
+    std::vector<uint8_t> written;
+    std::vector<size_t> transferSizes;
+    EXPECT_CALL(i2c, transfer(_))
+        .Times(2)
+        .WillRepeatedly(Invoke([&](std::vector<Operation>& operations) {
+            transferSizes.push_back(operations.size());
+            for (size_t i = 0; i + 1 < operations.size(); ++i)
+            {
+                EXPECT_FALSE(operations[i].isRead);
+                EXPECT_EQ(operations[i].addr, 0x10);
+                written.insert(written.end(), operations[i].data,
+                               operations[i].data + operations[i].size);
+            }
+
+            // The last operation verifies the blocks
+            auto& status = operations.back();
+            EXPECT_TRUE(status.isRead);
+            EXPECT_EQ(status.addr, 0x11);
+            EXPECT_EQ(status.size, 1);
+            status.data[0] = 0x00;
+        }));
+
+    std::vector<size_t> progress;
+    EXPECT_TRUE(writer.write(i2c, protocol,
+                             [&progress](size_t offset, size_t total) {
+                                 EXPECT_EQ(total, 300);
+                                 progress.push_back(offset);
+                             }));
+    EXPECT_EQ(written, image);
+    EXPECT_EQ(transferSizes, (std::vector<size_t>{9, 3}));
+    EXPECT_EQ(progress, (std::vector<size_t>{256, 300}));
+}
+
+TEST_F(TestImageWriter, WriteBlockCount)
+{
+    // Each SMBus block write starts with its byte count
+    createImage(40);
+    ImageWriter writer{imagePath};
+    ImageProtocol protocol{"image.bin", 0x10, 0x11, 0x5a, true};
+
+    std::vector<uint8_t> written;
+    std::vector<uint8_t> counts;
+    EXPECT_CALL(i2c, transfer(_))
+        .Times(1)
+        .WillOnce(Invoke([&](std::vector<Operation>& operations) {
+            ASSERT_EQ(operations.size(), 3);
+            for (size_t i = 0; i + 1 < operations.size(); ++i)
+            {
+                EXPECT_EQ(operations[i].size, operations[i].data[0] + 1);
+                counts.push_back(operations[i].data[0]);
+                written.insert(written.end(), operations[i].data + 1,
+                               operations[i].data + operations[i].size);
+            }
+            operations.back().data[0] = 0x5a;
+        }));
+    EXPECT_TRUE(writer.write(i2c, protocol));
+    EXPECT_EQ(written, image);
+    EXPECT_EQ(counts, (std::vector<uint8_t>{32, 8}));
+}
+
+TEST_F(TestImageWriter, WriteRejected)
+{
+    createImage(300);
+    ImageWriter writer{imagePath};
+    ImageProtocol protocol{"image.bin", 0x10, 0x11};
+
+    // Stops at the first transfer the device rejects
+    EXPECT_CALL(i2c, transfer(_))
+        .Times(1)
+        .WillOnce(Invoke([](std::vector<Operation>& operations) {
+            operations.back().data[0] = 0x01;
+        }));
+    EXPECT_FALSE(writer.write(i2c, protocol));
+}
+
+TEST_F(TestImageWriter, WriteEmpty)
+{
+    createImage(0);
+    ImageWriter writer{imagePath};
+    ImageProtocol protocol{"image.bin", 0x10, 0x11};
+
+    EXPECT_CALL(i2c, transfer(_)).Times(0);
+    EXPECT_TRUE(writer.write(i2c, protocol));
+}
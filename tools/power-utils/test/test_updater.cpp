@@ -16,7 +16,10 @@
 #include "../updater.hpp"
 #include "mocked_i2c_interface.hpp"
 
+#include <nlohmann/json.hpp>
+
 #include <filesystem>
+#include <fstream>
 
 #include <gtest/gtest.h>
 
@@ -25,6 +28,7 @@ namespace fs = std::filesystem;
 using ::testing::_;
 using ::testing::An;
 using ::testing::Pointee;
+using ::testing::SetArgReferee;
 
 namespace updater
 {
@@ -33,6 +37,12 @@ namespace internal
 
 std::string getDeviceName(std::string devPath);
 std::pair<uint8_t, uint8_t> parseDeviceName(const std::string& devName);
+std::vector<std::string> getUpdateWave(std::vector<std::string>& pending,
+                                       const std::vector<std::string>& present);
+std::optional<ImageProtocol> getImageProtocol(const nlohmann::json& config,
+                                              const std::string& model);
+fs::path getImagePath(const std::string& imageDir,
+                      const std::string& imageFile);
 
 } // namespace internal
 } // namespace updater
@@ -99,10 +109,39 @@ TEST_F(TestUpdater, doUpdate)
 
     EXPECT_CALL(i2c, write(0xf0, 12, _, I2CInterface::Mode::SMBUS));
     EXPECT_CALL(i2c, write(0xf1, An<uint8_t>()));
-    EXPECT_CALL(i2c, read(0xf1, An<uint8_t&>()));
+    EXPECT_CALL(i2c, read(0xf1, An<uint8_t&>()))
+        .WillOnce(SetArgReferee<1>(0x01));
     updater->doUpdate();
 }
 
+TEST_F(TestUpdater, getUpdateWave)
+{
+    std::vector<std::string> present{"/psu0", "/psu1", "/psu2"};
+
+    // Another PSU stays up, so all are updated at once
+    std::vector<std::string> pending{"/psu0", "/psu1"};
+    auto wave = internal::getUpdateWave(pending, present);
+    EXPECT_EQ(wave, (std::vector<std::string>{"/psu0", "/psu1"}));
+    EXPECT_TRUE(pending.empty());
+
+    // All present PSUs need an update, so the last one waits
+    pending = present;
+    wave = internal::getUpdateWave(pending, present);
+    EXPECT_EQ(wave, (std::vector<std::string>{"/psu0", "/psu1"}));
+    EXPECT_EQ(pending, (std::vector<std::string>{"/psu2"}));
+
+    // The updated PSUs stay up for the last one
+    wave = internal::getUpdateWave(pending, present);
+    EXPECT_EQ(wave, (std::vector<std::string>{"/psu2"}));
+    EXPECT_TRUE(pending.empty());
+
+    // The only PSU can't be updated
+    pending = {"/psu0"};
+    wave = internal::getUpdateWave(pending, {"/psu0"});
+    EXPECT_TRUE(wave.empty());
+    EXPECT_EQ(pending, (std::vector<std::string>{"/psu0"}));
+}
+
 TEST_F(TestUpdater, getDeviceName)
 {
     auto ret = internal::getDeviceName("");
@@ -129,3 +168,76 @@ TEST_F(TestUpdater, parseDeviceName)
 
     EXPECT_DEATH(internal::parseDeviceName("invalid"), "");
 }
+
+TEST_F(TestUpdater, getImageProtocol)
+{
+    auto config = nlohmann::json::parse(R"(
+        {
+            "imageProtocols": {
+                "51E9": {
+                    "imageFile": "51E9.bin",
+                    "dataCommand": "0x10",
+                    "statusCommand": "0x11"
+                },
+                "51DA": {
+                    "imageFile": "51DA.bin",
+                    "dataCommand": "0x20",
+                    "statusCommand": "0x21",
+                    "statusOK": "0x5a",
+                    "blockCount": false
+                },
+                "bad1": {
+                    "imageFile": "bad.bin",
+                    "dataCommand": "0x100",
+                    "statusCommand": "0x11"
+                },
+                "bad2": {
+                    "imageFile": "../bad.bin",
+                    "dataCommand": "0x10",
+                    "statusCommand": "0x11"
+                },
+                "bad3": {
+                    "imageFile": "bad.bin",
+                    "dataCommand": "0x10"
+                }
+            }
+        }
+    )");
+
+    auto protocol = internal::getImageProtocol(config, "51E9");
+    ASSERT_TRUE(protocol.has_value());
+    EXPECT_EQ(protocol->imageFile, "51E9.bin");
+    EXPECT_EQ(protocol->dataCmd, 0x10);
+    EXPECT_EQ(protocol->statusCmd, 0x11);
+    EXPECT_EQ(protocol->statusOK, 0x00);
+    EXPECT_TRUE(protocol->blockCount);
+
+    protocol = internal::getImageProtocol(config, "51DA");
+    ASSERT_TRUE(protocol.has_value());
+    EXPECT_EQ(protocol->dataCmd, 0x20);
+    EXPECT_EQ(protocol->statusCmd, 0x21);
+    EXPECT_EQ(protocol->statusOK, 0x5a);
+    EXPECT_FALSE(protocol->blockCount);
+
+    // Models without a valid protocol only get the boot flag
+    EXPECT_FALSE(internal::getImageProtocol(config, "bad1").has_value());
+    EXPECT_FALSE(internal::getImageProtocol(config, "bad2").has_value());
+    EXPECT_FALSE(internal::getImageProtocol(config, "bad3").has_value());
+    EXPECT_FALSE(internal::getImageProtocol(config, "other").has_value());
+    EXPECT_FALSE(
+        internal::getImageProtocol(nlohmann::json::object(), "51E9")
+            .has_value());
+}
+
+TEST_F(TestUpdater, getImagePath)
+{
+    // Only the named image is used, whatever else is in the directory
+    auto dir = fs::path(tmpDir) / "image";
+    fs::create_directories(dir);
+    std::ofstream{dir / "MANIFEST"} << "version=1\n";
+    std::ofstream{dir / "other.bin"} << "other";
+    EXPECT_TRUE(internal::getImagePath(dir, "51E9.bin").empty());
+
+    std::ofstream{dir / "51E9.bin"} << "image";
+    EXPECT_EQ(internal::getImagePath(dir, "51E9.bin"), dir / "51E9.bin");
+}
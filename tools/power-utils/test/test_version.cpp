@@ -43,3 +43,32 @@ TEST(Version, GetLatest)
     input = {};
     EXPECT_EQ("", version::getLatest(input));
 }
+
+TEST(Version, GetVersionFromConfig)
+{
+    auto data = nlohmann::json::parse(R"(
+        {
+            "inventoryPMBusAccessType": "Hwmon",
+            "fruConfigs": [
+                {"propertyName": "Version", "fileName": "fw_version"}
+            ],
+            "psuDevices": {
+                "/xyz/openbmc_project/inventory/powersupply0":
+                    "/sys/bus/i2c/devices/3-0068"
+            }
+        }
+    )");
+
+    // PSU not in the config
+    EXPECT_EQ("", version::getVersion("/unknown", data));
+
+    // No version file in the config
+    auto noVersion = data;
+    noVersion.erase("fruConfigs");
+    EXPECT_EQ("",
+              version::getVersion("/xyz/openbmc_project/inventory/powersupply0",
+                                  noVersion));
+
+    // Empty config
+    EXPECT_EQ("", version::getVersion("/unknown", nlohmann::json{}));
+}
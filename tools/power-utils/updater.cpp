@@ -17,14 +17,22 @@
 
 #include "updater.hpp"
 
+#include "config_cache.hpp"
+#include "image_writer.hpp"
 #include "pmbus.hpp"
 #include "types.hpp"
 #include "utility.hpp"
 
+#include <nlohmann/json.hpp>
 #include <phosphor-logging/log.hpp>
 
+#include <algorithm>
 #include <chrono>
 #include <fstream>
+#include <functional>
+#include <future>
+#include <optional>
+#include <stdexcept>
 #include <thread>
 
 using namespace phosphor::logging;
@@ -33,6 +41,39 @@ namespace util = phosphor::power::util;
 namespace updater
 {
 
+namespace
+{
+
+/** @brief Maximum time for the PSU to accept the boot flag after unlock */
+constexpr std::chrono::milliseconds unlockTimeout{100};
+
+/** @brief Maximum time for the PSU to enter the boot loader */
+constexpr std::chrono::milliseconds bootTimeout{3000};
+
+/** @brief Maximum time for an updated PSU to be working again */
+constexpr std::chrono::milliseconds readyTimeout{30000};
+
+/** @brief Interval between PSU status checks while waiting */
+constexpr std::chrono::milliseconds readyInterval{500};
+
+/** @brief The inventory property the image protocols are keyed by */
+constexpr auto modelProp = "Model";
+
+/* Parse a byte written as a hexadecimal string, like "0xf2" */
+uint8_t parseByte(const nlohmann::json& element)
+{
+    const auto& value = element.get_ref<const std::string&>();
+    size_t pos = 0;
+    auto byte = std::stoul(value, &pos, 16);
+    if ((pos != value.size()) || (byte > 0xff))
+    {
+        throw std::invalid_argument{"Invalid byte value " + value};
+    }
+    return static_cast<uint8_t>(byte);
+}
+
+} // namespace
+
 namespace internal
 {
 
@@ -48,19 +89,20 @@ std::string getDeviceName(std::string devPath)
 
 std::string getDevicePath(const std::string& psuInventoryPath)
 {
-    auto data = util::loadJSONFromFile(PSU_JSON_PATH);
+    auto config = util::loadConfigFile(PSU_JSON_PATH);
 
-    if (data == nullptr)
+    if (!config)
     {
         return {};
     }
 
-    auto devicePath = data["psuDevices"][psuInventoryPath];
-    if (devicePath.empty())
+    auto devicePath = config->getDevicePath(psuInventoryPath);
+    if (!devicePath)
     {
         log<level::WARNING>("Unable to find psu devices or path");
+        return {};
     }
-    return devicePath;
+    return *devicePath;
 }
 
 std::pair<uint8_t, uint8_t> parseDeviceName(const std::string& devName)
@@ -74,6 +116,198 @@ std::pair<uint8_t, uint8_t> parseDeviceName(const std::string& devName)
     return {busId, devAddr};
 }
 
+std::vector<bool> readPresent(sdbusplus::bus::bus& bus,
+                              const std::vector<std::string>& paths)
+{
+    // Read the Present property of all the PSUs at the same time
+    std::vector<bool> present(paths.size(), false);
+    std::vector<util::AsyncCallPtr> calls;
+    size_t pending = 0;
+    for (size_t i = 0; i < paths.size(); ++i)
+    {
+        const auto& p = paths[i];
+        try
+        {
+            auto service = util::getService(p, INVENTORY_IFACE, bus);
+            calls.emplace_back(util::getPropertyAsync<bool>(
+                INVENTORY_IFACE, PRESENT_PROP, p, service, bus,
+                [&present, &pending, &p, i](std::optional<bool> value) {
+                    if (!value)
+                    {
+                        log<level::ERR>("Failed to get present property",
+                                        entry("PSU=%s", p.c_str()));
+                    }
+                    present[i] = value.value_or(false);
+                    --pending;
+                }));
+            ++pending;
+        }
+        catch (const std::exception& e)
+        {
+            log<level::ERR>("Failed to get present property",
+                            entry("PSU=%s", p.c_str()));
+        }
+    }
+    while (pending > 0)
+    {
+        if (!bus.process_discard())
+        {
+            bus.wait();
+        }
+    }
+    return present;
+}
+
+bool isHealthy(const std::string& psuInventoryPath)
+{
+    using namespace phosphor::pmbus;
+
+    // Typically the driver is still bound here, so it is possible to
+    // directly read the debugfs to get the status.
+    try
+    {
+        auto devPath = getDevicePath(psuInventoryPath);
+        PMBus pmbus(devPath);
+        auto status0Vout = pmbus.insertPageNum(STATUS_VOUT, 0);
+        auto snapshot = pmbus.readStatusSnapshot({STATUS_WORD, status0Vout},
+                                                 Type::Debug);
+        if (!snapshot.isValid())
+        {
+            log<level::ERR>("Failed to read PSU status",
+                            entry("PSU=%s", psuInventoryPath.c_str()));
+            return false;
+        }
+        uint16_t statusWord = snapshot.values[0];
+        uint8_t voutStatus = snapshot.values[1];
+        if ((statusWord & status_word::VOUT_FAULT) ||
+            (statusWord & status_word::INPUT_FAULT_WARN) ||
+            (statusWord & status_word::VIN_UV_FAULT) ||
+            // For ibm-cffps PSUs, the MFR (0x80)'s OV (bit 2) and VAUX
+            // (bit 6) fault map to OV_FAULT, and UV (bit 3) fault maps to
+            // UV_FAULT in vout status.
+            (voutStatus & status_vout::UV_FAULT) ||
+            (voutStatus & status_vout::OV_FAULT))
+        {
+            log<level::WARNING>(
+                "Unable to update PSU when other PSU has input/ouput fault",
+                entry("PSU=%s", psuInventoryPath.c_str()),
+                entry("STATUS_WORD=0x%04x", statusWord),
+                entry("VOUT_BYTE=0x%02x", voutStatus));
+            return false;
+        }
+    }
+    catch (const std::exception& ex)
+    {
+        // If error occurs on accessing the debugfs, it means something went
+        // wrong, e.g. PSU is not present, and it's not ready to update.
+        log<level::ERR>(ex.what());
+        return false;
+    }
+    return true;
+}
+
+std::vector<std::string> getUpdateWave(std::vector<std::string>& pending,
+                                       const std::vector<std::string>& present)
+{
+    // If every present PSU still needs an update, hold one back so it
+    // keeps providing power while the others are updated.
+    bool otherPresent = std::any_of(
+        present.begin(), present.end(), [&pending](const auto& path) {
+            return std::find(pending.begin(), pending.end(), path) ==
+                   pending.end();
+        });
+
+    std::vector<std::string> wave;
+    if (otherPresent)
+    {
+        wave.swap(pending);
+    }
+    else if (pending.size() > 1)
+    {
+        wave.assign(pending.begin(), pending.end() - 1);
+        pending.erase(pending.begin(), pending.end() - 1);
+    }
+    return wave;
+}
+
+std::optional<ImageProtocol> getImageProtocol(const nlohmann::json& config,
+                                              const std::string& model)
+{
+    auto protocols = config.find("imageProtocols");
+    if ((protocols == config.end()) || !protocols->contains(model))
+    {
+        return std::nullopt;
+    }
+
+    try
+    {
+        const auto& element = protocols->at(model);
+        ImageProtocol protocol;
+        protocol.imageFile = element.at("imageFile").get<std::string>();
+        protocol.dataCmd = parseByte(element.at("dataCommand"));
+        protocol.statusCmd = parseByte(element.at("statusCommand"));
+        if (element.contains("statusOK"))
+        {
+            protocol.statusOK = parseByte(element.at("statusOK"));
+        }
+        protocol.blockCount = element.value("blockCount", true);
+
+        // Only a file in the image directory is written
+        if (protocol.imageFile.empty() ||
+            (fs::path(protocol.imageFile).filename() != protocol.imageFile))
+        {
+            throw std::invalid_argument{"Invalid image file " +
+                                        protocol.imageFile};
+        }
+        return protocol;
+    }
+    catch (const std::exception& e)
+    {
+        log<level::ERR>("Invalid PSU image protocol",
+                        entry("MODEL=%s", model.c_str()),
+                        entry("ERROR=%s", e.what()));
+        return std::nullopt;
+    }
+}
+
+fs::path getImagePath(const std::string& imageDir,
+                      const std::string& imageFile)
+{
+    std::error_code ec;
+    auto path = fs::path(imageDir) / imageFile;
+    return fs::is_regular_file(path, ec) ? path : fs::path{};
+}
+
+bool poll(std::chrono::milliseconds timeout, std::chrono::milliseconds interval,
+          const std::function<bool()>& check)
+{
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (true)
+    {
+        try
+        {
+            if (check())
+            {
+                return true;
+            }
+        }
+        catch (const i2c::I2CException&)
+        {
+            // The device doesn't respond while it is busy
+            if (std::chrono::steady_clock::now() >= deadline)
+            {
+                throw;
+            }
+        }
+
+        if (std::chrono::steady_clock::now() >= deadline)
+        {
+            return false;
+        }
+        std::this_thread::sleep_for(interval);
+    }
+}
+
 } // namespace internal
 
 bool update(const std::string& psuInventoryPath, const std::string& imageDir)
@@ -99,6 +333,126 @@ bool update(const std::string& psuInventoryPath, const std::string& imageDir)
     return ret == 0;
 }
 
+bool update(const std::vector<std::string>& psuInventoryPaths,
+            const std::string& imageDir)
+{
+    auto bus = sdbusplus::bus::new_default();
+    if (util::isPoweredOn(bus, true))
+    {
+        log<level::WARNING>("Unable to update PSU when host is on");
+        return false;
+    }
+
+    // Use one snapshot of the inventory for all of the waves
+    auto paths = util::getPSUInventoryPaths(bus);
+    auto present = internal::readPresent(bus, paths);
+    std::vector<std::string> presentPaths;
+    for (size_t i = 0; i < paths.size(); ++i)
+    {
+        if (present[i])
+        {
+            presentPaths.push_back(paths[i]);
+        }
+    }
+
+    std::vector<std::string> pending;
+    for (const auto& p : psuInventoryPaths)
+    {
+        if (std::find(presentPaths.begin(), presentPaths.end(), p) ==
+            presentPaths.end())
+        {
+            log<level::ERR>("PSU not present", entry("PSU=%s", p.c_str()));
+            return false;
+        }
+        if (std::find(pending.begin(), pending.end(), p) == pending.end())
+        {
+            pending.push_back(p);
+        }
+    }
+
+    std::vector<std::string> updated;
+    while (!pending.empty())
+    {
+        auto wave = internal::getUpdateWave(pending, presentPaths);
+        if (wave.empty())
+        {
+            log<level::ERR>("No other PSU present to update PSU");
+            return false;
+        }
+
+        // The PSUs that aren't updated in this wave must be working.  The
+        // ones updated in a previous wave may still be starting up.
+        for (const auto& p : presentPaths)
+        {
+            if (std::find(wave.begin(), wave.end(), p) != wave.end())
+            {
+                continue;
+            }
+
+            bool ready = false;
+            if (std::find(updated.begin(), updated.end(), p) != updated.end())
+            {
+                ready = internal::poll(readyTimeout, readyInterval, [&p]() {
+                    return internal::isHealthy(p);
+                });
+            }
+            else
+            {
+                ready = internal::isHealthy(p);
+            }
+
+            if (!ready)
+            {
+                log<level::ERR>("PSU not ready to update other PSUs",
+                                entry("PSU=%s", p.c_str()));
+                return false;
+            }
+        }
+
+        std::vector<std::unique_ptr<Updater>> updaters;
+        for (const auto& p : wave)
+        {
+            auto devPath = internal::getDevicePath(p);
+            if (devPath.empty())
+            {
+                return false;
+            }
+            updaters.push_back(std::make_unique<Updater>(p, devPath, imageDir));
+        }
+
+        // Update all of the PSUs in the wave at the same time
+        std::vector<std::future<int>> results;
+        for (auto& updater : updaters)
+        {
+            results.push_back(
+                std::async(std::launch::async, [&updater = *updater]() {
+                    updater.bindUnbind(false);
+                    updater.createI2CDevice();
+                    int ret = updater.doUpdate();
+                    updater.bindUnbind(true);
+                    return ret;
+                }));
+        }
+
+        bool success = true;
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            if (results[i].get() != 0)
+            {
+                log<level::ERR>("Failed to update PSU",
+                                entry("PSU=%s", wave[i].c_str()));
+                success = false;
+            }
+        }
+        if (!success)
+        {
+            return false;
+        }
+        updated.insert(updated.end(), wave.begin(), wave.end());
+    }
+    return true;
+}
+
 Updater::Updater(const std::string& psuInventoryPath,
                  const std::string& devPath, const std::string& imageDir) :
     bus(sdbusplus::bus::new_default()),
@@ -162,8 +516,6 @@ void Updater::setPresent(bool present)
 
 bool Updater::isReadyToUpdate()
 {
-    using namespace phosphor::pmbus;
-
     // Pre-condition for updating PSU:
     // * Host is powered off
     // * At least one other PSU is present
@@ -176,78 +528,80 @@ bool Updater::isReadyToUpdate()
         return false;
     }
 
-    bool hasOtherPresent = false;
+    // Skip check for itself
     auto paths = util::getPSUInventoryPaths(bus);
-    for (const auto& p : paths)
+    paths.erase(std::remove(paths.begin(), paths.end(), psuInventoryPath),
+                paths.end());
+
+    auto present = internal::readPresent(bus, paths);
+
+    bool hasOtherPresent = false;
+    for (size_t i = 0; i < paths.size(); ++i)
     {
-        if (p == psuInventoryPath)
-        {
-            // Skip check for itself
-            continue;
-        }
+        const auto& p = paths[i];
 
         // Check PSU present
-        bool present = false;
-        try
-        {
-            auto service = util::getService(p, INVENTORY_IFACE, bus);
-            util::getProperty(INVENTORY_IFACE, PRESENT_PROP, psuInventoryPath,
-                              service, bus, present);
-        }
-        catch (const std::exception& e)
-        {
-            log<level::ERR>("Failed to get present property",
-                            entry("PSU=%s", p.c_str()));
-        }
-        if (!present)
+        if (!present[i])
         {
             log<level::WARNING>("PSU not present", entry("PSU=%s", p.c_str()));
             continue;
         }
         hasOtherPresent = true;
 
-        // Typically the driver is still bound here, so it is possible to
-        // directly read the debugfs to get the status.
-        try
+        if (!internal::isHealthy(p))
         {
-            auto devPath = internal::getDevicePath(p);
-            PMBus pmbus(devPath);
-            uint16_t statusWord = pmbus.read(STATUS_WORD, Type::Debug);
-            auto status0Vout = pmbus.insertPageNum(STATUS_VOUT, 0);
-            uint8_t voutStatus = pmbus.read(status0Vout, Type::Debug);
-            if ((statusWord & status_word::VOUT_FAULT) ||
-                (statusWord & status_word::INPUT_FAULT_WARN) ||
-                (statusWord & status_word::VIN_UV_FAULT) ||
-                // For ibm-cffps PSUs, the MFR (0x80)'s OV (bit 2) and VAUX
-                // (bit 6) fault map to OV_FAULT, and UV (bit 3) fault maps to
-                // UV_FAULT in vout status.
-                (voutStatus & status_vout::UV_FAULT) ||
-                (voutStatus & status_vout::OV_FAULT))
-            {
-                log<level::WARNING>(
-                    "Unable to update PSU when other PSU has input/ouput fault",
-                    entry("PSU=%s", p.c_str()),
-                    entry("STATUS_WORD=0x%04x", statusWord),
-                    entry("VOUT_BYTE=0x%02x", voutStatus));
-                return false;
-            }
-        }
-        catch (const std::exception& ex)
-        {
-            // If error occurs on accessing the debugfs, it means something went
-            // wrong, e.g. PSU is not present, and it's not ready to update.
-            log<level::ERR>(ex.what());
             return false;
         }
     }
     return hasOtherPresent;
 }
 
+std::optional<ImageProtocol> Updater::getImageProtocol()
+{
+    auto config = util::loadConfigFile(PSU_JSON_PATH);
+    if (!config || !config->getJSON().contains("imageProtocols"))
+    {
+        return std::nullopt;
+    }
+
+    std::string model;
+    try
+    {
+        auto service = util::getService(psuInventoryPath, ASSET_IFACE, bus);
+        util::getProperty(ASSET_IFACE, modelProp, psuInventoryPath, service,
+                          bus, model);
+    }
+    catch (const std::exception& e)
+    {
+        log<level::ERR>("Failed to get PSU model",
+                        entry("PSU=%s", psuInventoryPath.c_str()),
+                        entry("ERROR=%s", e.what()));
+        return std::nullopt;
+    }
+    return internal::getImageProtocol(config->getJSON(), model);
+}
+
 int Updater::doUpdate()
 {
     using namespace std::chrono;
 
-    uint8_t data;
+    // The image is only written for the PSU models with an image protocol,
+    // so it is found before the PSU enters its boot loader
+    auto protocol = getImageProtocol();
+    fs::path imagePath;
+    if (protocol)
+    {
+        imagePath = internal::getImagePath(imageDir, protocol->imageFile);
+        if (imagePath.empty())
+        {
+            log<level::ERR>("PSU image not found",
+                            entry("DIR=%s", imageDir.c_str()),
+                            entry("IMAGE=%s", protocol->imageFile.c_str()));
+            return 1;
+        }
+    }
+
+    uint8_t data = 0;
     uint8_t unlockData[12] = {0x45, 0x43, 0x44, 0x31, 0x36, 0x30,
                               0x33, 0x30, 0x30, 0x30, 0x34, 0x01};
     uint8_t bootFlag = 0x01;
@@ -256,16 +610,47 @@ int Updater::doUpdate()
     i2c->write(0xf0, sizeof(unlockData), unlockData);
     printf("Unlock PSU\n");
 
-    std::this_thread::sleep_for(milliseconds(5));
-
-    i2c->write(0xf1, bootFlag);
+    // Retry the boot flag write until the PSU accepts it after the unlock
+    internal::poll(unlockTimeout, milliseconds(1), [this, bootFlag]() {
+        i2c->write(0xf1, bootFlag);
+        return true;
+    });
     printf("Set boot flag ret\n");
 
-    std::this_thread::sleep_for(seconds(3));
-
-    i2c->read(0xf1, data);
+    // The boot flag reads back once the PSU is in its boot loader
+    internal::poll(bootTimeout, milliseconds(100), [this, &data, bootFlag]() {
+        i2c->read(0xf1, data);
+        return data == bootFlag;
+    });
     printf("Read of 0x%02x, 0x%02x\n", 0xf1, data);
-    return 0;
+
+    if (!protocol)
+    {
+        return 0;
+    }
+
+    try
+    {
+        ImageWriter writer{imagePath};
+        int reported = -1;
+        bool written = writer.write(
+            *i2c, *protocol, [&reported](size_t offset, size_t total) {
+                // Report every 10 percent
+                int percent = static_cast<int>(offset * 100 / total);
+                if (percent / 10 != reported / 10)
+                {
+                    printf("Wrote %d%% of image\n", percent);
+                    reported = percent;
+                }
+            });
+        return written ? 0 : 1;
+    }
+    catch (const std::runtime_error& e)
+    {
+        log<level::ERR>("Failed to write PSU image",
+                        entry("ERROR=%s", e.what()));
+        return 1;
+    }
 }
 
 void Updater::createI2CDevice()
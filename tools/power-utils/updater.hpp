@@ -16,11 +16,14 @@
 #pragma once
 
 #include "i2c_interface.hpp"
+#include "image_writer.hpp"
 
 #include <sdbusplus/bus.hpp>
 
 #include <filesystem>
+#include <optional>
 #include <string>
+#include <vector>
 
 class TestUpdater;
 
@@ -39,6 +42,22 @@ namespace fs = std::filesystem;
  */
 bool update(const std::string& psuInventoryPath, const std::string& imageDir);
 
+/**
+ * Update the firmware of several PSUs
+ *
+ * The PSUs are updated in waves, with all of the PSUs in a wave updated at
+ * the same time.  Each wave leaves at least one working PSU that is not
+ * being updated, so if every present PSU is in the list, the last one is
+ * updated in a wave of its own.
+ *
+ * @param[in] psuInventoryPaths - The inventory paths of the PSUs
+ * @param[in] imageDir - The directory containing the PSU image
+ *
+ * @return true if successful, otherwise false
+ */
+bool update(const std::vector<std::string>& psuInventoryPaths,
+            const std::string& imageDir);
+
 class Updater
 {
   public:
@@ -81,6 +100,10 @@ class Updater
     bool isReadyToUpdate();
 
     /** @brief Do the PSU update
+     *
+     * Polls the PSU instead of waiting fixed times between the steps.  The
+     * image is written after the boot flag is set if the PSU model has an
+     * image protocol, see getImageProtocol().
      *
      * @return 0 if success, otherwise non-zero
      */
@@ -94,6 +117,17 @@ class Updater
     void createI2CDevice();
 
   private:
+    /** @brief Get how the image is written to the PSU
+     *
+     * The imageProtocols of the PSU JSON file define, for each PSU model
+     * (the Model inventory property), the image file and the boot loader
+     * commands it is written with.
+     *
+     * @return the image protocol, or nullopt if there is none for the PSU
+     *         model and only the boot flag is set
+     */
+    std::optional<ImageProtocol> getImageProtocol();
+
     /** @brief The sdbusplus DBus bus connection */
     sdbusplus::bus::bus bus;
 
@@ -17,6 +17,7 @@
 
 #include "version.hpp"
 
+#include "config_cache.hpp"
 #include "pmbus.hpp"
 #include "utility.hpp"
 
@@ -34,10 +35,9 @@ using PsuVersionInfo =
 
 namespace utils
 {
-PsuVersionInfo getVersionInfo(const std::string& psuInventoryPath)
+PsuVersionInfo getVersionInfo(const std::string& psuInventoryPath,
+                              const json& data)
 {
-    auto data = phosphor::power::util::loadJSONFromFile(PSU_JSON_PATH);
-
     if (data == nullptr)
     {
         return {};
@@ -60,7 +60,13 @@ PsuVersionInfo getVersionInfo(const std::string& psuInventoryPath)
     auto type = phosphor::power::util::getPMBusAccessType(data);
 
     std::string versionStr;
-    for (const auto& fru : data["fruConfigs"])
+    auto fruConfigs = data.find("fruConfigs");
+    if (fruConfigs == data.end())
+    {
+        log<level::WARNING>("Unable to find fruConfigs");
+        return {};
+    }
+    for (const auto& fru : *fruConfigs)
     {
         if (fru["propertyName"] == "Version")
         {
@@ -96,9 +102,19 @@ namespace version
 {
 
 std::string getVersion(const std::string& psuInventoryPath)
+{
+    auto config = phosphor::power::util::loadConfigFile(PSU_JSON_PATH);
+    if (!config)
+    {
+        return {};
+    }
+    return getVersion(psuInventoryPath, config->getJSON());
+}
+
+std::string getVersion(const std::string& psuInventoryPath, const json& data)
 {
     const auto& [devicePath, type, versionStr] =
-        utils::getVersionInfo(psuInventoryPath);
+        utils::getVersionInfo(psuInventoryPath, data);
     if (devicePath.empty() || versionStr.empty())
     {
         return {};
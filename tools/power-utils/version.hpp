@@ -15,6 +15,8 @@
  */
 #pragma once
 
+#include <nlohmann/json.hpp>
+
 #include <string>
 #include <vector>
 
@@ -30,6 +32,17 @@ namespace version
  */
 std::string getVersion(const std::string& psuInventoryPath);
 
+/**
+ * Get the software version of the PSU using an already loaded PSU config
+ *
+ * @param[in] psuInventoryPath - The inventory path of the PSU
+ * @param[in] data - The contents of the PSU config file
+ *
+ * @return The version of the PSU
+ */
+std::string getVersion(const std::string& psuInventoryPath,
+                       const nlohmann::json& data);
+
 /**
  * Get the latest version from a list of versions
  *
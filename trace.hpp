@@ -0,0 +1,253 @@
+#pragma once
+
+/**
+ * Tracing of the monitoring hot paths.
+ *
+ * POWER_TRACE_SCOPE(name, device, command) records a begin event when it is
+ * reached and an end event when the enclosing scope exits.  The events are
+ * written in the Chrome JSON trace format, which Perfetto and
+ * chrome://tracing can load.  The timestamps use CLOCK_MONOTONIC.
+ *
+ * Tracing is compiled out unless the tracing meson option is enabled, which
+ * defines POWER_TRACING.  When compiled in, events are only recorded if the
+ * PHOSPHOR_POWER_TRACE_FILE environment variable contains the path of the
+ * trace file to write.  The device and command arguments are not evaluated
+ * when tracing is compiled out or not enabled.
+ */
+#ifdef POWER_TRACING
+
+#include <sys/syscall.h> // for SYS_gettid
+#include <unistd.h>      // for getpid() and syscall()
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace phosphor::power::trace
+{
+
+/**
+ * Environment variable containing the path of the trace file.
+ */
+constexpr auto traceFileVariable = "PHOSPHOR_POWER_TRACE_FILE";
+
+/**
+ * @class Tracer
+ *
+ * Writes trace events to the trace file.  Safe to use from multiple threads.
+ */
+class Tracer
+{
+  public:
+    Tracer(const Tracer&) = delete;
+    Tracer& operator=(const Tracer&) = delete;
+    Tracer(Tracer&&) = delete;
+    Tracer& operator=(Tracer&&) = delete;
+
+    /**
+     * Returns the tracer of this process.
+     *
+     * The trace file is opened the first time this is called.
+     *
+     * @return Tracer& - the tracer
+     */
+    static Tracer& get()
+    {
+        static Tracer tracer;
+        return tracer;
+    }
+
+    /**
+     * Returns whether events are recorded.
+     *
+     * @return bool - true if the trace file is open, false otherwise
+     */
+    bool isEnabled() const
+    {
+        return file != nullptr;
+    }
+
+    /**
+     * Writes an event.
+     *
+     * @param[in] name - the name of the traced function
+     * @param[in] phase - 'B' for a begin event or 'E' for an end event
+     * @param[in] device - the device, or empty if none
+     * @param[in] command - the command or register, or empty if none
+     */
+    void write(std::string_view name, char phase, const std::string& device,
+               const std::string& command)
+    {
+        auto time = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch());
+        static thread_local long tid = syscall(SYS_gettid);
+
+        std::string event;
+        event.reserve(160);
+        event += "{\"name\":\"";
+        escape(event, name);
+        event += "\",\"cat\":\"phosphor-power\",\"ph\":\"";
+        event += phase;
+        event += "\",\"ts\":";
+        event += std::to_string(time.count());
+        event += ",\"pid\":";
+        event += std::to_string(pid);
+        event += ",\"tid\":";
+        event += std::to_string(tid);
+        if (phase == 'B')
+        {
+            event += ",\"args\":{\"device\":\"";
+            escape(event, device);
+            event += "\",\"command\":\"";
+            escape(event, command);
+            event += "\"}";
+        }
+        event += '}';
+
+        std::lock_guard<std::mutex> lock{mutex};
+        if (!first)
+        {
+            fputs(",\n", file);
+        }
+        first = false;
+        fwrite(event.data(), 1, event.size(), file);
+    }
+
+  private:
+    /**
+     * Constructor.  Opens the trace file if one is specified.
+     */
+    Tracer() : pid{getpid()}
+    {
+        const char* path = std::getenv(traceFileVariable);
+        if ((path != nullptr) && (*path != '\0'))
+        {
+            file = fopen(path, "w");
+            if (file != nullptr)
+            {
+                // The closing bracket is optional in the JSON array format,
+                // so the file can be loaded even if the process is killed
+                fputs("[\n", file);
+            }
+        }
+    }
+
+    /**
+     * Destructor.  Flushes and closes the trace file.
+     */
+    ~Tracer()
+    {
+        if (file != nullptr)
+        {
+            fputs("\n]\n", file);
+            fclose(file);
+        }
+    }
+
+    /**
+     * Appends a string to an event, escaping the JSON special characters.
+     *
+     * @param[in,out] event - the event
+     * @param[in] text - the string to append
+     */
+    static void escape(std::string& event, std::string_view text)
+    {
+        for (char c : text)
+        {
+            if ((c == '"') || (c == '\\'))
+            {
+                event += '\\';
+                event += c;
+            }
+            else if (static_cast<unsigned char>(c) < 0x20)
+            {
+                event += ' ';
+            }
+            else
+            {
+                event += c;
+            }
+        }
+    }
+
+    /**
+     * The process ID.
+     */
+    const pid_t pid;
+
+    /**
+     * The trace file, or nullptr if events are not recorded.
+     */
+    FILE* file{nullptr};
+
+    /**
+     * Whether no event has been written yet.
+     */
+    bool first{true};
+
+    /**
+     * Serializes the writes to the trace file.
+     */
+    std::mutex mutex{};
+};
+
+/**
+ * @class Scope
+ *
+ * Writes a begin event when created and an end event when destroyed.
+ */
+class Scope
+{
+  public:
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+    Scope(Scope&&) = delete;
+    Scope& operator=(Scope&&) = delete;
+
+    /**
+     * Constructor.  Writes the begin event.
+     *
+     * @param[in] name - the name of the traced function
+     * @param[in] device - the device, or empty if none
+     * @param[in] command - the command or register, or empty if none
+     */
+    Scope(std::string_view name, const std::string& device,
+          const std::string& command) :
+        name{name}
+    {
+        Tracer::get().write(name, 'B', device, command);
+    }
+
+    /**
+     * Destructor.  Writes the end event.
+     */
+    ~Scope()
+    {
+        Tracer::get().write(name, 'E', {}, {});
+    }
+
+  private:
+    /**
+     * The name of the traced function.
+     */
+    std::string_view name;
+};
+
+} // namespace phosphor::power::trace
+
+#define POWER_TRACE_SCOPE(name, device, command)                               \
+    std::optional<phosphor::power::trace::Scope> powerTraceScope;              \
+    if (phosphor::power::trace::Tracer::get().isEnabled())                     \
+    {                                                                          \
+        powerTraceScope.emplace(name, device, command);                        \
+    }
+
+#else
+
+#define POWER_TRACE_SCOPE(name, device, command)
+
+#endif
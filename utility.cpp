@@ -17,7 +17,14 @@
 
 #include "types.hpp"
 
+#include <sdbusplus/bus/match.hpp>
+#include <sdbusplus/exception.hpp>
+
+#include <chrono>
 #include <fstream>
+#include <memory>
+#include <mutex>
+#include <utility>
 
 namespace phosphor
 {
@@ -33,9 +40,93 @@ constexpr auto MAPPER_INTERFACE = "xyz.openbmc_project.ObjectMapper";
 using namespace phosphor::logging;
 using json = nlohmann::json;
 
+/**
+ * How long a service name found by the mapper is used before asking the
+ * mapper again.
+ */
+constexpr std::chrono::seconds serviceCacheTimeout{60};
+
+/**
+ * Service names found by the mapper on one D-Bus connection, keyed by object
+ * path and interface.
+ */
+struct ServiceCache
+{
+    using Key = std::pair<std::string, std::string>;
+    using Entry = std::pair<std::string, std::chrono::steady_clock::time_point>;
+
+    std::map<Key, Entry> entries;
+
+    /**
+     * Removes the entries for a service when its owner changes, since the
+     * service may have exited or been restarted.
+     */
+    std::unique_ptr<sdbusplus::bus::match_t> nameOwnerChangedMatch;
+};
+
+/**
+ * Service caches keyed by D-Bus connection.  The mutex protects the caches
+ * and their entries.
+ */
+static std::map<sd_bus*, ServiceCache> serviceCaches;
+static std::mutex serviceCachesMutex;
+
+/**
+ * Returns the service cache for the specified bus, creating it if needed.
+ *
+ * Must be called with serviceCachesMutex locked.
+ */
+static ServiceCache& getServiceCache(sdbusplus::bus::bus& bus)
+{
+    auto [it, inserted] = serviceCaches.try_emplace(bus.get_bus());
+    ServiceCache& cache = it->second;
+    if (inserted)
+    {
+        try
+        {
+            cache.nameOwnerChangedMatch =
+                std::make_unique<sdbusplus::bus::match_t>(
+                    bus, sdbusplus::bus::match::rules::nameOwnerChanged(),
+                    [&cache](sdbusplus::message::message& msg) {
+                        std::string name;
+                        msg.read(name);
+                        std::lock_guard<std::mutex> lock{serviceCachesMutex};
+                        std::erase_if(cache.entries, [&name](const auto& e) {
+                            return e.second.first == name;
+                        });
+                    });
+        }
+        catch (const std::exception& e)
+        {
+            // Entries still expire after serviceCacheTimeout
+            log<level::ERR>(
+                (std::string("Unable to watch for NameOwnerChanged: ") +
+                 e.what())
+                    .c_str());
+        }
+    }
+    return cache;
+}
+
 std::string getService(const std::string& path, const std::string& interface,
                        sdbusplus::bus::bus& bus, bool logError)
 {
+    auto key = std::make_pair(path, interface);
+    auto now = std::chrono::steady_clock::now();
+    {
+        std::lock_guard<std::mutex> lock{serviceCachesMutex};
+        ServiceCache& cache = getServiceCache(bus);
+        auto it = cache.entries.find(key);
+        if (it != cache.entries.end())
+        {
+            if ((now - it->second.second) < serviceCacheTimeout)
+            {
+                return it->second.first;
+            }
+            cache.entries.erase(it);
+        }
+    }
+
     auto method = bus.new_method_call(MAPPER_BUSNAME, MAPPER_PATH,
                                       MAPPER_INTERFACE, "GetObject");
 
@@ -60,7 +151,16 @@ std::string getService(const std::string& path, const std::string& interface,
         return std::string{};
     }
 
-    return response.begin()->first;
+    // Only found services are cached, since a missing one may start later
+    const std::string& service = response.begin()->first;
+    {
+        std::lock_guard<std::mutex> lock{serviceCachesMutex};
+        ServiceCache& cache = getServiceCache(bus);
+        cache.entries.insert_or_assign(std::move(key),
+                                       std::make_pair(service, now));
+    }
+
+    return service;
 }
 
 DbusPropertyMap getAllProperties(sdbusplus::bus::bus& bus,
@@ -104,6 +204,94 @@ DbusSubtree getSubTree(sdbusplus::bus::bus& bus, const std::string& path,
     return response;
 }
 
+AsyncCall::AsyncCall(sdbusplus::bus::bus& bus,
+                     sdbusplus::message::message& method, Handler handler) :
+    handler(std::move(handler))
+{
+    // Use the default timeout
+    int rc = sd_bus_call_async(bus.get_bus(), &slot, method.get(),
+                               replyCallback, this, 0);
+    if (rc < 0)
+    {
+        throw sdbusplus::exception::SdBusError(-rc, "sd_bus_call_async");
+    }
+}
+
+AsyncCall::~AsyncCall()
+{
+    // Cancels the call if the reply has not arrived
+    sd_bus_slot_unref(slot);
+}
+
+int AsyncCall::replyCallback(sd_bus_message* msg, void* context,
+                             sd_bus_error* /*error*/)
+{
+    auto call = static_cast<AsyncCall*>(context);
+    sdbusplus::message::message reply{msg};
+    try
+    {
+        call->handler(reply);
+    }
+    catch (const std::exception& e)
+    {
+        // Exceptions must not propagate into sd-bus
+        log<level::ERR>(
+            (std::string("Error handling D-Bus reply: ") + e.what()).c_str());
+    }
+    return 0;
+}
+
+AsyncCallPtr getAllPropertiesAsync(
+    sdbusplus::bus::bus& bus, const std::string& path,
+    const std::string& interface, const std::string& service,
+    std::function<void(std::optional<DbusPropertyMap> properties)> handler)
+{
+    auto method = bus.new_method_call(service.c_str(), path.c_str(),
+                                      PROPERTY_INTF, "GetAll");
+    method.append(interface);
+
+    return std::make_unique<AsyncCall>(
+        bus, method,
+        [handler = std::move(handler)](sdbusplus::message::message& reply) {
+            handler(readReply<DbusPropertyMap>(reply));
+        });
+}
+
+AsyncCallPtr
+    getSubTreeAsync(sdbusplus::bus::bus& bus, const std::string& path,
+                    const std::string& interface, int32_t depth,
+                    std::function<void(std::optional<DbusSubtree> subtree)>
+                        handler)
+{
+    auto mapperCall = bus.new_method_call(MAPPER_BUSNAME, MAPPER_PATH,
+                                          MAPPER_INTERFACE, "GetSubTree");
+    mapperCall.append(path);
+    mapperCall.append(depth);
+    mapperCall.append(std::vector<std::string>({interface}));
+
+    return std::make_unique<AsyncCall>(
+        bus, mapperCall,
+        [handler = std::move(handler)](sdbusplus::message::message& reply) {
+            handler(readReply<DbusSubtree>(reply));
+        });
+}
+
+AsyncCallPtr getManagedObjectsAsync(
+    sdbusplus::bus::bus& bus, const std::string& service,
+    const std::string& path,
+    std::function<void(std::optional<DbusManagedObjects> objects)> handler)
+{
+    auto method = bus.new_method_call(service.c_str(), path.c_str(),
+                                      "org.freedesktop.DBus.ObjectManager",
+                                      "GetManagedObjects");
+
+    return std::make_unique<AsyncCall>(
+        bus, method,
+        [handler = std::move(handler)](sdbusplus::message::message& reply) {
+            handler(readReply<DbusManagedObjects>(reply));
+        });
+}
+
 json loadJSONFromFile(const char* path)
 {
     std::ifstream ifs(path);
@@ -157,6 +345,24 @@ phosphor::pmbus::Type getPMBusAccessType(const json& json)
     return type;
 }
 
+phosphor::pmbus::Backend getPMBusBackend(const json& json,
+                                         const std::string& psuInventoryPath)
+{
+    using namespace phosphor::pmbus;
+    Backend backend = Backend::Sysfs;
+
+    auto backends = json.find("pmbusBackends");
+    if (backends != json.end())
+    {
+        auto backendStr = backends->find(psuInventoryPath);
+        if ((backendStr != backends->end()) && (*backendStr == "I2C"))
+        {
+            backend = Backend::I2C;
+        }
+    }
+    return backend;
+}
+
 bool isPoweredOn(sdbusplus::bus::bus& bus, bool defaultState)
 {
     int32_t state = defaultState;
@@ -7,6 +7,9 @@
 #include <phosphor-logging/log.hpp>
 #include <sdbusplus/bus.hpp>
 
+#include <functional>
+#include <memory>
+#include <optional>
 #include <string>
 
 namespace phosphor
@@ -32,10 +35,17 @@ using DbusSubtree =
 using DbusVariant =
     std::variant<bool, uint64_t, std::string, std::vector<uint64_t>>;
 using DbusPropertyMap = std::map<DbusProperty, DbusVariant>;
+using DbusInterfaceMap = std::map<DbusInterface, DbusPropertyMap>;
+using DbusManagedObjects =
+    std::map<sdbusplus::message::object_path, DbusInterfaceMap>;
 /**
  * @brief Get the service name from the mapper for the
  *        interface and path passed in.
  *
+ * Service names are cached for each D-Bus connection.  A cached name is
+ * used for up to a minute, and is dropped earlier if the owner of the
+ * name changes.  Empty results are not cached.
+ *
  * @param[in] path - the D-Bus path name
  * @param[in] interface - the D-Bus interface name
  * @param[in] bus - the D-Bus object
@@ -131,6 +141,219 @@ DbusPropertyMap getAllProperties(sdbusplus::bus::bus& bus,
 DbusSubtree getSubTree(sdbusplus::bus::bus& bus, const std::string& path,
                        const std::string& interface, int32_t depth);
 
+/**
+ * @class AsyncCall
+ *
+ * An asynchronous D-Bus method call.
+ *
+ * The reply handler is called from the event loop attached to the bus when
+ * the reply arrives.  Destroying the object cancels the call if the reply
+ * has not arrived yet, so the object must exist until the handler has run.
+ * Do not destroy the object from within its own handler.
+ */
+class AsyncCall
+{
+  public:
+    using Handler = std::function<void(sdbusplus::message::message& reply)>;
+
+    AsyncCall() = delete;
+    AsyncCall(const AsyncCall&) = delete;
+    AsyncCall(AsyncCall&&) = delete;
+    AsyncCall& operator=(const AsyncCall&) = delete;
+    AsyncCall& operator=(AsyncCall&&) = delete;
+
+    /**
+     * @brief Starts the method call.
+     *
+     * Throws an exception if the call cannot be sent.
+     *
+     * @param[in] bus - the D-Bus object
+     * @param[in] method - the method call message
+     * @param[in] handler - called with the reply, or with the error reply
+     *                      if the call fails or times out
+     */
+    AsyncCall(sdbusplus::bus::bus& bus, sdbusplus::message::message& method,
+              Handler handler);
+
+    ~AsyncCall();
+
+  private:
+    /**
+     * @brief Callback from sd-bus when the reply arrives.
+     */
+    static int replyCallback(sd_bus_message* msg, void* context,
+                             sd_bus_error* error);
+
+    /** @brief The sd-bus slot for the pending call. */
+    sd_bus_slot* slot = nullptr;
+
+    /** @brief The reply handler. */
+    Handler handler;
+};
+
+using AsyncCallPtr = std::unique_ptr<AsyncCall>;
+
+/**
+ * @brief Reads the value from a method reply.
+ *
+ * @param[in] reply - the method reply
+ *
+ * @return The value, or an empty value if the reply is an error or does not
+ *         contain the expected type.
+ */
+template <typename T>
+std::optional<T> readReply(sdbusplus::message::message& reply)
+{
+    std::optional<T> value;
+    try
+    {
+        if (!reply.is_method_error())
+        {
+            T result;
+            reply.read(result);
+            value = std::move(result);
+        }
+    }
+    catch (const std::exception& e)
+    {}
+    return value;
+}
+
+/**
+ * @brief Read a D-Bus property without blocking.
+ *
+ * See getProperty().  The handler is called from the event loop with the
+ * property value, or an empty value if the read failed.
+ *
+ * @param[in] interface - the interface the property is on
+ * @param[in] propertyName - the name of the property
+ * @param[in] path - the D-Bus path
+ * @param[in] service - the D-Bus service
+ * @param[in] bus - the D-Bus object
+ * @param[in] handler - called with the property value
+ *
+ * @return The pending call
+ */
+template <typename T>
+AsyncCallPtr
+    getPropertyAsync(const std::string& interface,
+                     const std::string& propertyName, const std::string& path,
+                     const std::string& service, sdbusplus::bus::bus& bus,
+                     std::function<void(std::optional<T> value)> handler)
+{
+    auto method = bus.new_method_call(service.c_str(), path.c_str(),
+                                      PROPERTY_INTF, "Get");
+    method.append(interface, propertyName);
+
+    return std::make_unique<AsyncCall>(
+        bus, method,
+        [handler = std::move(handler)](sdbusplus::message::message& reply) {
+            std::optional<T> value;
+            auto property = readReply<std::variant<T>>(reply);
+            if (property && std::holds_alternative<T>(*property))
+            {
+                value = std::get<T>(*property);
+            }
+            handler(std::move(value));
+        });
+}
+
+/**
+ * @brief Write a D-Bus property without blocking.
+ *
+ * See setProperty().  The handler is called from the event loop with true if
+ * the property was written.
+ *
+ * @param[in] interface - the interface the property is on
+ * @param[in] propertyName - the name of the property
+ * @param[in] path - the D-Bus path
+ * @param[in] service - the D-Bus service
+ * @param[in] bus - the D-Bus object
+ * @param[in] value - the value to set the property to
+ * @param[in] handler - called when the write completes
+ *
+ * @return The pending call
+ */
+template <typename T>
+AsyncCallPtr setPropertyAsync(const std::string& interface,
+                              const std::string& propertyName,
+                              const std::string& path,
+                              const std::string& service,
+                              sdbusplus::bus::bus& bus, const T& value,
+                              std::function<void(bool success)> handler)
+{
+    std::variant<T> propertyValue(value);
+
+    auto method = bus.new_method_call(service.c_str(), path.c_str(),
+                                      PROPERTY_INTF, "Set");
+    method.append(interface, propertyName, propertyValue);
+
+    return std::make_unique<AsyncCall>(
+        bus, method,
+        [handler = std::move(handler)](sdbusplus::message::message& reply) {
+            handler(!reply.is_method_error());
+        });
+}
+
+/**
+ * @brief Get all D-Bus properties without blocking.
+ *
+ * See getAllProperties().  The handler is called from the event loop with
+ * the properties, or an empty value if the read failed.
+ *
+ * @param[in] bus - the D-Bus object
+ * @param[in] path - the D-Bus object path
+ * @param[in] interface - the D-Bus interface name
+ * @param[in] service - the D-Bus service name
+ * @param[in] handler - called with the properties
+ *
+ * @return The pending call
+ */
+AsyncCallPtr getAllPropertiesAsync(
+    sdbusplus::bus::bus& bus, const std::string& path,
+    const std::string& interface, const std::string& service,
+    std::function<void(std::optional<DbusPropertyMap> properties)> handler);
+
+/**
+ * @brief Get subtree from the object mapper without blocking.
+ *
+ * See getSubTree().  The handler is called from the event loop with the
+ * subtree, or an empty value if the call failed.
+ *
+ * @param[in] bus - The D-Bus object.
+ * @param[in] path - The root of the tree to search.
+ * @param[in] interface - Interface in the subtree to search for
+ * @param[in] depth - The number of path elements to descend.
+ * @param[in] handler - called with the subtree
+ *
+ * @return The pending call
+ */
+AsyncCallPtr
+    getSubTreeAsync(sdbusplus::bus::bus& bus, const std::string& path,
+                    const std::string& interface, int32_t depth,
+                    std::function<void(std::optional<DbusSubtree> subtree)>
+                        handler);
+
+/**
+ * @brief Get all objects and properties from a service without blocking.
+ *
+ * Calls the GetManagedObjects method of the object manager at the specified
+ * path.  The handler is called from the event loop with the objects, or an
+ * empty value if the call failed.  Properties with types that are not in
+ * DbusVariant cause the call to fail.
+ *
+ * @param[in] bus - the D-Bus object
+ * @param[in] service - the D-Bus service name
+ * @param[in] path - the object path of the object manager
+ * @param[in] handler - called with the objects
+ *
+ * @return The pending call
+ */
+AsyncCallPtr getManagedObjectsAsync(
+    sdbusplus::bus::bus& bus, const std::string& service,
+    const std::string& path,
+    std::function<void(std::optional<DbusManagedObjects> objects)> handler);
+
 /**
  * Logs an error and powers off the system.
  *
@@ -169,9 +392,28 @@ nlohmann::json loadJSONFromFile(const char* path);
  */
 phosphor::pmbus::Type getPMBusAccessType(const nlohmann::json& json);
 
+/**
+ * Get the PMBus backend for a power supply from the json config
+ *
+ * The optional "pmbusBackends" object maps power supply inventory paths to
+ * the backend to use.  "I2C" selects direct I2C access.  Any other value, or
+ * a power supply that is not listed, uses the device driver sysfs files.
+ *
+ * @param[in] json - The json object
+ * @param[in] psuInventoryPath - The power supply inventory path
+ *
+ * @return The pmbus backend
+ */
+phosphor::pmbus::Backend getPMBusBackend(const nlohmann::json& json,
+                                         const std::string& psuInventoryPath);
+
 /**
  * Check if power is on
  *
+ * Gets the power state property from D-Bus each time.  A daemon that checks
+ * the power state repeatedly should use a PowerStateWatcher instead, which
+ * caches the state.
+ *
  * @param[in] bus - D-Bus object
  * @param[in] defaultState - The default state if the function fails to get
  *                           the power state.